@@ -0,0 +1,306 @@
+#!/usr/bin/env python3
+#===================================================
+#
+#    Copyright (c) 2024
+#      SMASH Team
+#
+#    GNU General Public License (GPLv3 or later)
+#
+#===================================================
+
+"""Structured SMASH run benchmarks.
+
+The 'run' command runs the setups of benchmark.bash a few times each and
+writes the wall time, cycles, peak RSS, events per second and the profile of
+the phases of every repetition to a JSON file. The 'scaling' command does the
+same for a sweep of the particle number, ensembles and threads of the box,
+collider and potentials setups. The 'compare' command compares such a file
+to a baseline and fails if a benchmark got significantly slower.
+"""
+
+import argparse
+import json
+import math
+import os
+import platform
+import shutil
+import statistics
+import subprocess
+import sys
+import tempfile
+import time
+
+SCRIPT_PATH = os.path.dirname(os.path.abspath(__file__))
+SMASH_ROOT = os.path.normpath(os.path.join(SCRIPT_PATH, '..', '..'))
+CONFIGS = os.path.join(SCRIPT_PATH, 'configs')
+INPUT = os.path.join(SMASH_ROOT, 'input')
+
+# Name: (config directory, decaymodes directory, particles directory, options)
+SETUPS = {
+    'collider': ('collider', INPUT, INPUT, []),
+    'timestepless': ('collider', INPUT, INPUT,
+                     ['General: {Time_Step_Mode: None}']),
+    'box': ('box', os.path.join(INPUT, 'box'), os.path.join(INPUT, 'box'), []),
+    'sphere': ('sphere', INPUT, INPUT, []),
+    'dileptons': ('dileptons', os.path.join(INPUT, 'dileptons'), INPUT, []),
+    'photons': ('photons', os.path.join(CONFIGS, 'photons'),
+                os.path.join(CONFIGS, 'photons'), []),
+    'testparticles': ('testparticles', INPUT, INPUT, []),
+    'potentials': ('potentials', INPUT, INPUT, []),
+    'high_energy': ('high_energy', INPUT, INPUT, []),
+}
+
+# Options swept by the scaling mode per setup. The particle number of the box
+# is changed by its length, since it is filled with thermal multiplicities.
+SCALING = {
+    'box': {
+        'particles': ('Modi: {{Box: {{Length: {}}}}}', [5.0, 10.0, 20.0]),
+        'ensembles': ('General: {{Ensembles: {}}}', [1, 4, 16]),
+        'threads': ('General: {{Threads: {}}}', [1, 2, 4, 8]),
+    },
+    'collider': {
+        'particles': ('General: {{Testparticles: {}}}', [1, 5, 20]),
+        'ensembles': ('General: {{Ensembles: {}}}', [1, 4, 16]),
+        'threads': ('General: {{Threads: {}}}', [1, 2, 4, 8]),
+    },
+    'potentials': {
+        'particles': ('General: {{Testparticles: {}}}', [5, 20, 50]),
+        'ensembles': ('General: {{Ensembles: {}}}', [1, 4, 16]),
+        'threads': ('General: {{Threads: {}}}', [1, 2, 4, 8]),
+    },
+}
+
+# Metrics compared to the baseline and whether larger values are better
+METRICS = {
+    'wall_time': False,
+    'cycles': False,
+    'peak_rss_kib': False,
+    'events_per_second': True,
+}
+
+# Two-sided 95% quantiles of Student's t distribution for 1 to 30 degrees of
+# freedom; the normal quantile is used beyond.
+T_95 = [12.706, 4.303, 3.182, 2.776, 2.571, 2.447, 2.365, 2.306, 2.262,
+        2.228, 2.201, 2.179, 2.160, 2.145, 2.131, 2.120, 2.110, 2.101, 2.093,
+        2.086, 2.080, 2.074, 2.069, 2.064, 2.060, 2.056, 2.052, 2.048, 2.045,
+        2.042]
+
+
+def t_quantile(dof):
+    """Two-sided 95% quantile of Student's t distribution."""
+    dof = max(1, int(dof))
+    return T_95[dof - 1] if dof <= len(T_95) else 1.960
+
+
+def fail(message):
+    print(message, file=sys.stderr)
+    sys.exit(1)
+
+
+def run_smash(build_dir, setup, extra_options):
+    """Runs SMASH once and returns the measured quantities of the run."""
+    config_dir, decaymodes_dir, particles_dir, options = setup
+    output_dir = tempfile.mkdtemp(prefix='smash-benchmark-')
+    command = [os.path.join(build_dir, 'smash'),
+               '-i', os.path.join(CONFIGS, config_dir, 'config.yaml'),
+               '-d', os.path.join(decaymodes_dir, 'decaymodes.txt'),
+               '-p', os.path.join(particles_dir, 'particles.txt'),
+               '-o', output_dir, '-f', '-c', 'General: {Profile: True}']
+    for option in options + extra_options:
+        command += ['-c', option]
+    perf_file = os.path.join(output_dir, 'perf.csv')
+    if shutil.which('perf'):
+        command = ['perf', 'stat', '-x,', '-e', 'cycles', '-o', perf_file,
+                   '--'] + command
+    start = time.perf_counter()
+    process = subprocess.Popen(command, stdout=subprocess.DEVNULL,
+                               stderr=subprocess.PIPE, cwd=build_dir)
+    _, status, usage = os.wait4(process.pid, 0)
+    wall_time = time.perf_counter() - start
+    stderr = process.stderr.read().decode(errors='replace')
+    process.stderr.close()
+    if os.waitstatus_to_exitcode(status) != 0:
+        shutil.rmtree(output_dir, ignore_errors=True)
+        fail('SMASH failed:\n' + ' '.join(command) + '\n' + stderr)
+    result = {
+        'wall_time': wall_time,
+        'cycles': None,
+        # ru_maxrss is given in KiB on Linux
+        'peak_rss_kib': usage.ru_maxrss,
+        'events_per_second': None,
+        'phases': None,
+    }
+    if os.path.isfile(perf_file):
+        with open(perf_file) as f:
+            for line in f:
+                fields = line.split(',')
+                if len(fields) > 2 and fields[2].startswith('cycles'):
+                    try:
+                        result['cycles'] = int(fields[0])
+                    except ValueError:
+                        pass  # e.g. '<not supported>' in virtual machines
+    profile_file = os.path.join(output_dir, 'profile.json')
+    if os.path.isfile(profile_file):
+        with open(profile_file) as f:
+            profile = json.load(f)
+        result['phases'] = profile['total']['phases']
+        result['events_per_second'] = len(profile['events']) / wall_time
+    shutil.rmtree(output_dir, ignore_errors=True)
+    return result
+
+
+def summarize(runs):
+    """Mean, standard deviation and 95% confidence interval of the metrics."""
+    summary = {}
+    for metric in METRICS:
+        values = [run[metric] for run in runs if run[metric] is not None]
+        if not values:
+            continue
+        mean = statistics.fmean(values)
+        std = statistics.stdev(values) if len(values) > 1 else 0.
+        half_width = (t_quantile(len(values) - 1) * std / math.sqrt(len(values))
+                      if len(values) > 1 else 0.)
+        summary[metric] = {'mean': mean, 'std': std, 'n': len(values),
+                           'ci95': [mean - half_width, mean + half_width]}
+    return summary
+
+
+def benchmark(build_dir, name, setup, repetitions, extra_options=()):
+    print('   Started benchmark for {} ...'.format(name), flush=True)
+    runs = [run_smash(build_dir, setup, list(extra_options))
+            for _ in range(repetitions)]
+    summary = summarize(runs)
+    wall = summary['wall_time']
+    print('      wall time {:.2f} s +- {:.2f} s'.format(wall['mean'],
+                                                        wall['std']))
+    return {'options': list(setup[3]) + list(extra_options), 'runs': runs,
+            'summary': summary}
+
+
+def system_information(build_dir):
+    version = subprocess.run([os.path.join(build_dir, 'smash'), '-v'],
+                             capture_output=True, text=True).stdout
+    smash_version = next((word for word in version.split()
+                          if word.startswith('SMASH-')), 'SMASH-unknown')
+    return {'smash_version': smash_version, 'smash_v': version,
+            'uname': ' '.join(platform.uname()), 'cpus': os.cpu_count(),
+            'date': time.strftime('%Y-%m-%dT%H:%M:%S')}
+
+
+def write_results(args, results):
+    output = args.output or os.path.join(
+        SCRIPT_PATH, 'bm-results-{}.json'.format(results['smash_version']))
+    with open(output, 'w') as f:
+        json.dump(results, f, indent=2)
+    print('Results are written to ' + output)
+
+
+def command_run(args):
+    results = system_information(args.build_dir)
+    results['repetitions'] = args.repetitions
+    names = args.setups or list(SETUPS)
+    for name in names:
+        if name not in SETUPS:
+            fail('Unknown setup "{}", known are: {}'.format(
+                name, ', '.join(SETUPS)))
+    results['benchmarks'] = {
+        name: benchmark(args.build_dir, name, SETUPS[name], args.repetitions)
+        for name in names}
+    write_results(args, results)
+
+
+def command_scaling(args):
+    results = system_information(args.build_dir)
+    results['repetitions'] = args.repetitions
+    results['benchmarks'] = {}
+    for name, sweeps in SCALING.items():
+        for quantity, (option, values) in sweeps.items():
+            for value in values:
+                label = '{}/{}={}'.format(name, quantity, value)
+                results['benchmarks'][label] = benchmark(
+                    args.build_dir, label, SETUPS[name], args.repetitions,
+                    [option.format(value)])
+    write_results(args, results)
+
+
+def command_compare(args):
+    with open(args.baseline) as f:
+        baseline = json.load(f)
+    with open(args.results) as f:
+        results = json.load(f)
+    print('Comparing {} (baseline) to {}, changes significant at 95% CL are '
+          'marked with *'.format(baseline['smash_version'],
+                                 results['smash_version']))
+    regressions = []
+    for name, new in results['benchmarks'].items():
+        if name not in baseline['benchmarks']:
+            print('{}: not in the baseline'.format(name))
+            continue
+        old = baseline['benchmarks'][name]
+        for metric, larger_is_better in METRICS.items():
+            if (metric not in old['summary'] or
+                    metric not in new['summary']):
+                continue
+            a, b = old['summary'][metric], new['summary'][metric]
+            change = (b['mean'] - a['mean']) / a['mean']
+            # Welch's t-test of the difference of the means
+            va, vb = a['std']**2 / a['n'], b['std']**2 / b['n']
+            significant = False
+            if va + vb > 0.:
+                dof_denominator = ((va**2 / (a['n'] - 1) if a['n'] > 1 else 0.)
+                                   + (vb**2 / (b['n'] - 1) if b['n'] > 1
+                                      else 0.))
+                dof = ((va + vb)**2 / dof_denominator
+                       if dof_denominator > 0. else 1)
+                t = abs(b['mean'] - a['mean']) / math.sqrt(va + vb)
+                significant = t > t_quantile(dof)
+            print('{:40s} {:18s} {:14.6g} -> {:14.6g} {:+7.1%}{}'.format(
+                name, metric, a['mean'], b['mean'], change,
+                ' *' if significant else ''))
+            worse = -change if larger_is_better else change
+            if significant and worse > args.threshold:
+                regressions.append('{} {}'.format(name, metric))
+    for name in baseline['benchmarks']:
+        if name not in results['benchmarks']:
+            print('{}: dismissed after the baseline'.format(name))
+    if regressions:
+        fail('Significant regressions by more than {:.0%}:\n  {}'.format(
+            args.threshold, '\n  '.join(regressions)))
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.split('\n')[0])
+    commands = parser.add_subparsers(dest='command', required=True)
+    for name, command in (('run', command_run), ('scaling', command_scaling)):
+        sub = commands.add_parser(name, help=(
+            'benchmark the setups of benchmark.bash' if name == 'run' else
+            'sweep particles, ensembles and threads of box, collider and '
+            'potentials'))
+        sub.add_argument('build_dir', help='prepared build directory')
+        sub.add_argument('-r', '--repetitions', type=int, default=5,
+                         help='runs per benchmark (default: 5)')
+        sub.add_argument('-o', '--output', help='JSON file to write '
+                         '(default: bm-results-SMASH-VERSION.json here)')
+        if name == 'run':
+            sub.add_argument('setups', nargs='*',
+                             help='setups to run (default: all)')
+        sub.set_defaults(function=command)
+    compare = commands.add_parser(
+        'compare', help='compare results to a baseline, failing on '
+        'significant regressions')
+    compare.add_argument('baseline', help='JSON file of the baseline')
+    compare.add_argument('results', help='JSON file to compare')
+    compare.add_argument('-t', '--threshold', type=float, default=0.05,
+                         help='relative slowdown tolerated even if it is '
+                         'significant (default: 0.05)')
+    compare.set_defaults(function=command_compare)
+    args = parser.parse_args()
+    if args.command != 'compare' and not os.path.isfile(
+            os.path.join(args.build_dir, 'smash')):
+        fail('Given build directory "{}" does not contain a smash '
+             'executable.'.format(args.build_dir))
+    args.function(args)
+
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,80 @@
+/*
+Example of how SMASH can be used as an afterburner for batches of particles
+sampled by another model, e.g. on the particlization hypersurface of a
+hydrodynamic evolution.
+
+Main steps are
+- Setup smash configuration object
+- Initialize particles, decay modes and tabulation for this config
+- Create a session, which sets up the experiment once
+- Evolve every batch of particles as an event of the session
+
+For more details have a look at session.h and library.h in the SMASH source.
+*/
+
+#include <cstdlib>
+#include <filesystem>
+#include <iostream>
+#include <string>
+#include <utility>
+
+#include "smash/config.h"
+#include "smash/library.h"
+#include "smash/particledata.h"
+#include "smash/particletype.h"
+#include "smash/random.h"
+#include "smash/session.h"
+#include "smash/spheremodus.h"
+
+int main() {
+  try {
+    std::cout << "\nAfterburner session\n-------------------" << '\n';
+
+    const std::string config_file(SMASH_INPUT_DIR "/sphere/config.yaml");
+    const std::filesystem::path output_path("./data");
+    const std::string tabulations_path("./tabulations");
+    const std::string particles_file(SMASH_INPUT_DIR "/particles.txt");
+    const std::string decaymodes_file(SMASH_INPUT_DIR "/decaymodes.txt");
+    std::filesystem::create_directories(output_path);
+
+    auto config = smash::setup_config_and_logging(config_file, particles_file,
+                                                  decaymodes_file);
+    // The sphere is only used as a container without initial particles
+    config.remove_all_entries_in_section_but_one(
+        "211", {"Modi", "Sphere", "Init_Multiplicities"});
+    config.set_value({"Modi", "Sphere", "Init_Multiplicities", "211"}, 0);
+    // The final particles are handed back, so no output is written
+    config.extract_sub_configuration({"Output"}).clear();
+    const double end_time = config.read({"General", "End_Time"});
+
+    smash::initialize_particles_decays_and_tabulations(config, SMASH_VERSION,
+                                                       tabulations_path);
+
+    // The configuration is parsed and the experiment is set up only once
+    smash::Session<smash::SphereModus> session(config, output_path);
+
+    const smash::ParticleTypePtr pion = &smash::ParticleType::find(0x211);
+    for (int batch = 0; batch < 3; batch++) {
+      // Stand-in for the particles sampled by the other model
+      smash::ParticleList particles;
+      for (int i = 0; i < 50; i++) {
+        smash::ParticleData p{*pion};
+        p.set_4momentum(pion->mass(), smash::random::uniform(-0.5, 0.5),
+                        smash::random::uniform(-0.5, 0.5),
+                        smash::random::uniform(-0.5, 0.5));
+        p.set_4position(smash::FourVector(0., smash::random::uniform(-3., 3.),
+                                          smash::random::uniform(-3., 3.),
+                                          smash::random::uniform(-3., 3.)));
+        particles.push_back(p);
+      }
+      const smash::ParticleList &final_particles =
+          session.run_event(std::move(particles), end_time);
+      std::cout << "Batch " << batch << ": " << final_particles.size()
+                << " final particles\n";
+    }
+  } catch (std::exception &e) {
+    std::cout << "SMASH failed with the following error:\n" << e.what() << '\n';
+    return EXIT_FAILURE;
+  }
+  return 0;
+}
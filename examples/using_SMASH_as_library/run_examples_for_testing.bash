@@ -59,5 +59,6 @@ make -j$(nproc) || fail_and_rm_build 'Failed to build SMASH library examples'
 ./example || fail_and_rm_build 'Failed to run SMASH library example'
 ./example_rate_equations || fail_and_rm_build 'Failed to run SMASH rate equation library example'
 ./example_smash_wrapper || fail_and_rm_build 'Failed to execute SMASH wrapper library example'
+./example_session || fail_and_rm_build 'Failed to execute SMASH session library example'
 
 do_clean_up
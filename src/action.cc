@@ -116,16 +116,12 @@ std::pair<FourVector, FourVector> Action::get_potential_at_interaction_point()
   FourVector UI3 = FourVector();
   /* Check:
    * Lattice is turned on. */
-  if (UB_lat_pointer != nullptr) {
-    UB_lat_pointer->value_at(r, UB);
-  }
-  if (UI3_lat_pointer != nullptr) {
-    UI3_lat_pointer->value_at(r, UI3);
-  }
+  gather_potentials(r, UB, UI3);
   return std::make_pair(UB, UI3);
 }
 
-double Action::perform(Particles *particles, uint32_t id_process) {
+double Action::perform(Particles *particles, uint32_t id_process,
+                       bool check_conservation_laws) {
   assert(id_process != 0);
   double energy_violation = 0.;
   for (ParticleData &p : outgoing_particles_) {
@@ -149,7 +145,17 @@ double Action::perform(Particles *particles, uint32_t id_process) {
    * energy of the outgoing particles by the mean field potentials are not
    * taken into account. */
   if (UB_lat_pointer == nullptr && UI3_lat_pointer == nullptr) {
-    energy_violation = check_conservation(id_process);
+    if (check_conservation_laws) {
+      energy_violation = check_conservation(id_process);
+    } else if (is_string_soft_process(process_type_) ||
+               process_type_ == ProcessType::StringHard) {
+      for (const ParticleData &p : outgoing_particles_) {
+        energy_violation += p.momentum().x0();
+      }
+      for (const ParticleData &p : incoming_particles_) {
+        energy_violation -= p.momentum().x0();
+      }
+    }
   }
   return energy_violation;
 }
@@ -328,6 +334,9 @@ void Action::sample_manybody_phasespace_impl(
    *     ... x R2(M2, m1, m2) x (prod M_i). Maximum weight is estmated
    * heuristically, here I'm using an idea by Scott Pratt that maximum is close
    * to T12 = T123 = T1234 = ... = (sqrts - sum (m_i)) / (n - 1)
+   * For more than three particles, the maximum is searched from there by
+   * moving kinetic energy between the invariant masses, such that only a
+   * small safety factor is needed and fewer combinations are rejected.
    */
   const size_t n = m.size();
   assert(n > 1);
@@ -351,17 +360,54 @@ void Action::sample_manybody_phasespace_impl(
   double w, r01;
   std::vector<double> Minv(n);
 
-  double weight_sqr_max = 1;
-  const double Ekin_share = (sqrts - msum_all) / (n - 1);
-  for (size_t i = 1; i < n; i++) {
-    // This maximum estimate idea is due Scott Pratt: maximum should be
-    // roughly at equal kinetic energies
-    weight_sqr_max *= pCM_sqr(i * Ekin_share + msum[i],
-                              (i - 1) * Ekin_share + msum[i - 1], m[i]);
+  // Squared weight for the kinetic energies T12, T123 - T12, ...
+  auto weight_sqr_of = [&](const std::vector<double> &Ekin) {
+    double weight_sqr = 1;
+    double M = m[0];
+    for (size_t i = 1; i < n; i++) {
+      const double M_previous = M;
+      M += m[i] + Ekin[i - 1];
+      weight_sqr *= pCM_sqr(M, M_previous, m[i]);
+    }
+    return weight_sqr;
+  };
+  // This maximum estimate idea is due Scott Pratt: maximum should be
+  // roughly at equal kinetic energies
+  const double Ekin_total = sqrts - msum_all;
+  std::vector<double> Ekin(n - 1, Ekin_total / (n - 1));
+  double weight_sqr_max = weight_sqr_of(Ekin);
+  if (n > 3) {
+    /* Move a share of kinetic energy from one invariant mass to another as
+     * long as the weight grows, with shrinking shares. */
+    for (double share = 0.25 * Ekin_total / (n - 1);
+         share > 1e-3 * Ekin_total / (n - 1); share *= 0.5) {
+      bool improved = true;
+      while (improved) {
+        improved = false;
+        for (size_t i = 0; i < n - 1; i++) {
+          for (size_t j = 0; j < n - 1; j++) {
+            if (i == j || Ekin[j] < share) {
+              continue;
+            }
+            Ekin[i] += share;
+            Ekin[j] -= share;
+            const double weight_sqr = weight_sqr_of(Ekin);
+            if (weight_sqr > weight_sqr_max) {
+              weight_sqr_max = weight_sqr;
+              improved = true;
+            } else {
+              Ekin[i] -= share;
+              Ekin[j] += share;
+            }
+          }
+        }
+      }
+    }
   }
-  // Maximum estimate is rough and can be wrong. We multiply it by additional
-  // factor to be on the safer side.
-  const double safety_factor = 1.1 + (n - 2) * 0.2;
+  /* The maximum is only approximate, i.e. it can be missed by up to the last
+   * share, or is only the rough estimate for three particles. We multiply it
+   * by additional factor to be on the safer side. */
+  const double safety_factor = n > 3 ? 1.05 : 1.1 + (n - 2) * 0.2;
   weight_sqr_max *= (safety_factor * safety_factor);
   bool first_warning = true;
 
@@ -430,8 +476,9 @@ void Action::sample_manybody_phasespace_impl(
                           << std::endl;
 
     // Boost the first i+1 particles to the next CM frame
+    const LorentzBoost boost(beta[i]);
     for (size_t j = 0; j <= i + 1; j++) {
-      sampled_momenta[j] = sampled_momenta[j].lorentz_boost(beta[i]);
+      sampled_momenta[j] = boost(sampled_momenta[j]);
     }
   }
 
@@ -0,0 +1,147 @@
+/*
+ *
+ *    Copyright (c) 2024
+ *      SMASH Team
+ *
+ *    GNU General Public License (GPLv3 or later)
+ *
+ */
+
+#include "smash/asyncoutput.h"
+
+#include <stdexcept>
+#include <utility>
+
+#include "smash/logging.h"
+
+namespace smash {
+
+AsyncOutput::AsyncOutput(OutputPtr target, std::size_t capacity)
+    : DeferredOutput(*target), target_(std::move(target)), capacity_(capacity) {
+  if (capacity == 0) {
+    throw std::invalid_argument(
+        "The queue of an asynchronous output needs room for one call.");
+  }
+  writer_ = std::thread(&AsyncOutput::write, this);
+}
+
+AsyncOutput::~AsyncOutput() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stop_ = true;
+  }
+  changed_.notify_all();
+  writer_.join();
+  if (error_) {
+    try {
+      std::rethrow_exception(error_);
+    } catch (const std::exception &e) {
+      logg[LOutput].error("Writing the output failed: ", e.what());
+    } catch (...) {
+      logg[LOutput].error("Writing the output failed.");
+    }
+  }
+}
+
+void AsyncOutput::at_eventend(const int event_number,
+                              const ThermodynamicQuantity tq,
+                              const DensityType dens_type) {
+  DeferredOutput::at_eventend(event_number, tq, dens_type);
+  if (!overlap_events_) {
+    flush();
+  }
+}
+
+void AsyncOutput::at_eventend(const ThermodynamicQuantity tq) {
+  DeferredOutput::at_eventend(tq);
+  if (!overlap_events_) {
+    flush();
+  }
+}
+
+void AsyncOutput::at_eventend(const Particles &particles,
+                              const int event_number, const EventInfo &info) {
+  DeferredOutput::at_eventend(particles, event_number, info);
+  if (!overlap_events_) {
+    flush();
+  }
+}
+
+void AsyncOutput::at_eventend(const std::vector<Particles> &ensembles,
+                              const int event_number) {
+  DeferredOutput::at_eventend(ensembles, event_number);
+  if (!overlap_events_) {
+    flush();
+  }
+}
+
+void AsyncOutput::thermodynamics_output(const GrandCanThermalizer &gct) {
+  flush();
+  // the writer waits for the next call, so the output may be used here
+  target_->thermodynamics_output(gct);
+}
+
+void AsyncOutput::flush() {
+  std::unique_lock<std::mutex> lock(mutex_);
+  changed_.wait(lock, [this]() { return queue_.empty() && !writing_; });
+  rethrow_error();
+}
+
+void AsyncOutput::end_event() {
+  std::unique_lock<std::mutex> lock(mutex_);
+  if (overlap_events_) {
+    changed_.wait(lock,
+                  [this]() { return n_written_ >= previous_event_end_; });
+  }
+  previous_event_end_ = n_recorded_;
+  rethrow_error();
+}
+
+void AsyncOutput::record(Call call) {
+  {
+    std::unique_lock<std::mutex> lock(mutex_);
+    rethrow_error();
+    changed_.wait(lock, [this]() { return queue_.size() < capacity_; });
+    queue_.emplace_back(std::move(call));
+    n_recorded_++;
+  }
+  changed_.notify_all();
+}
+
+void AsyncOutput::write() {
+  std::unique_lock<std::mutex> lock(mutex_);
+  while (true) {
+    changed_.wait(lock, [this]() { return !queue_.empty() || stop_; });
+    if (queue_.empty()) {
+      return;
+    }
+    Call call = std::move(queue_.front());
+    queue_.pop_front();
+    // calls after a failure are dropped until it is passed on
+    const bool failed = static_cast<bool>(error_);
+    writing_ = true;
+    lock.unlock();
+    changed_.notify_all();
+    if (!failed) {
+      try {
+        call(*target_);
+      } catch (...) {
+        lock.lock();
+        error_ = std::current_exception();
+        lock.unlock();
+      }
+    }
+    lock.lock();
+    writing_ = false;
+    n_written_++;
+    changed_.notify_all();
+  }
+}
+
+void AsyncOutput::rethrow_error() {
+  if (error_) {
+    std::rethrow_exception(std::exchange(error_, nullptr));
+  }
+}
+
+}  // namespace smash
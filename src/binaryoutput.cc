@@ -10,6 +10,7 @@
 #include "smash/binaryoutput.h"
 
 #include <cstdint>
+#include <cstring>
 #include <filesystem>
 #include <string>
 
@@ -109,6 +110,29 @@ static constexpr int LHyperSurfaceCrossing = LogArea::HyperSurfaceCrossing::id;
  * \li \key empty: 0 if there was an interaction between the projectile
  * and the target, 1 otherwise. For non-collider setups, this is always 0.
  *
+ * **Event index**\n
+ * With the \key Binary_Event_Index option, an index of the particle blocks
+ * at the start and end of the events is appended to the particles and
+ * collisions files after the last event:
+ * \code
+ * char uint32_t
+ * 'x'  n_entries
+ * n_entries times:
+ * char   int32_t      uint64_t uint32_t
+ * stage  event_number offset   n_part_lines
+ * uint64_t     4*char
+ * index_offset "SMIX"
+ * \endcode
+ * \li \key stage: 's' for the particles at the start of the event, 'e' for
+ * those at the end.
+ * \li \key offset: Position of the 'p' of the particle block in the file in
+ * bytes. For compressed files, it refers to the decompressed data.
+ * \li \key index_offset: Position of the 'x' in the file, such that the index
+ * is found by reading the last 12 bytes of the file.
+ *
+ * The small `smash_binaryreader` library built with SMASH maps such
+ * a file into memory and gives direct access to the particles of any event.
+ *
  * Particles output
  * ----------------
  * The particles output is Written to the \c particles_binary.bin file.
@@ -136,32 +160,70 @@ static constexpr int LHyperSurfaceCrossing = LogArea::HyperSurfaceCrossing::id;
 BinaryOutputBase::BinaryOutputBase(const std::filesystem::path &path,
                                    const std::string &mode,
                                    const std::string &name,
-                                   bool extended_format)
-    : OutputInterface(name), file_{path, mode}, extended_(extended_format) {
-  std::fwrite("SMSH", 4, 1, file_.get());  // magic number
-  write(format_version_);                  // file format version number
+                                   bool extended_format, bool compressed,
+                                   bool event_index)
+    : OutputInterface(name),
+      file_{path, mode, compressed},
+      buffer_(buffer_size_),
+      extended_(extended_format),
+      event_index_(event_index) {
+  write_bytes("SMSH", 4);  // magic number
+  write(format_version_);  // file format version number
   std::uint16_t format_variant = static_cast<uint16_t>(extended_);
   write(format_variant);
   write(SMASH_VERSION);
 }
 
-// write functions:
-void BinaryOutputBase::write(const char c) {
-  std::fwrite(&c, sizeof(char), 1, file_.get());
+BinaryOutputBase::~BinaryOutputBase() {
+  if (event_index_) {
+    const std::uint64_t index_offset = position_;
+    write('x');
+    write(index_.size());
+    for (const IndexEntry &entry : index_) {
+      write(entry.stage);
+      write(entry.event_number);
+      write_bytes(&entry.offset, sizeof(entry.offset));
+      write(entry.n_particles);
+    }
+    write_bytes(&index_offset, sizeof(index_offset));
+    write_bytes("SMIX", 4);
+  }
+  write_buffer();
+}
+
+void BinaryOutputBase::write_buffer() {
+  if (buffer_used_ > 0) {
+    std::fwrite(buffer_.data(), buffer_used_, 1, file_.get());
+    buffer_used_ = 0;
+  }
+}
+
+void BinaryOutputBase::flush() {
+  write_buffer();
+  file_.flush();
 }
 
+void BinaryOutputBase::index_block(char stage, std::int32_t event_number,
+                                   std::size_t n_particles) {
+  if (event_index_) {
+    index_.push_back({stage, event_number, position_,
+                      smash::numeric_cast<std::uint32_t>(n_particles)});
+  }
+}
+
+// write functions:
+void BinaryOutputBase::write(const char c) { write_bytes(&c, sizeof(char)); }
+
 void BinaryOutputBase::write(const std::string &s) {
   const auto size = smash::numeric_cast<uint32_t>(s.size());
-  std::fwrite(&size, sizeof(std::uint32_t), 1, file_.get());
-  std::fwrite(s.c_str(), s.size(), 1, file_.get());
+  write_bytes(&size, sizeof(std::uint32_t));
+  write_bytes(s.c_str(), s.size());
 }
 
-void BinaryOutputBase::write(const double x) {
-  std::fwrite(&x, sizeof(x), 1, file_.get());
-}
+void BinaryOutputBase::write(const double x) { write_bytes(&x, sizeof(x)); }
 
 void BinaryOutputBase::write(const FourVector &v) {
-  std::fwrite(v.begin(), sizeof(*v.begin()), 4, file_.get());
+  write_bytes(v.begin(), 4 * sizeof(*v.begin()));
 }
 
 void BinaryOutputBase::write(const Particles &particles) {
@@ -176,27 +238,55 @@ void BinaryOutputBase::write(const ParticleList &particles) {
   }
 }
 
+namespace {
+/**
+ * Copy a value into a record.
+ *
+ * \param[in] value Value to be copied
+ * \param[inout] out Position in the record, which is advanced behind the value
+ */
+template <typename T>
+void pack(const T &value, char *&out) {
+  std::memcpy(out, &value, sizeof(T));
+  out += sizeof(T);
+}
+
+/// Size of a particle record in bytes
+constexpr std::size_t particle_record_size =
+    9 * sizeof(double) + 3 * sizeof(std::int32_t);
+/// Size of the extended part of a particle record in bytes
+constexpr std::size_t extended_record_size =
+    3 * sizeof(double) + 7 * sizeof(std::int32_t);
+}  // namespace
+
 void BinaryOutputBase::write_particledata(const ParticleData &p) {
-  write(p.position());
-  double mass = p.effective_mass();
-  std::fwrite(&mass, sizeof(mass), 1, file_.get());
-  write(p.momentum());
-  write(p.pdgcode().get_decimal());
-  write(p.id());
-  write(p.type().charge());
+  // The record is put together first and then written at once.
+  char record[particle_record_size + extended_record_size];
+  char *out = record;
+  const FourVector &position = p.position();
+  std::memcpy(out, position.begin(), 4 * sizeof(double));
+  out += 4 * sizeof(double);
+  pack(p.effective_mass(), out);
+  const FourVector &momentum = p.momentum();
+  std::memcpy(out, momentum.begin(), 4 * sizeof(double));
+  out += 4 * sizeof(double);
+  pack<std::int32_t>(p.pdgcode().get_decimal(), out);
+  pack<std::int32_t>(p.id(), out);
+  pack<std::int32_t>(p.type().charge(), out);
   if (extended_) {
-    const auto history = p.get_history();
-    write(history.collisions_per_particle);
-    write(p.formation_time());
-    write(p.xsec_scaling_factor());
-    write(history.id_process);
-    write(static_cast<int32_t>(history.process_type));
-    write(history.time_last_collision);
-    write(history.p1.get_decimal());
-    write(history.p2.get_decimal());
-    write(p.type().baryon_number());
-    write(p.type().strangeness());
+    const auto &history = p.get_history();
+    pack<std::int32_t>(history.collisions_per_particle, out);
+    pack<double>(p.formation_time(), out);
+    pack<double>(p.xsec_scaling_factor(), out);
+    pack<std::int32_t>(history.id_process, out);
+    pack(static_cast<std::int32_t>(history.process_type), out);
+    pack<double>(history.time_last_collision, out);
+    pack<std::int32_t>(history.p1.get_decimal(), out);
+    pack<std::int32_t>(history.p2.get_decimal(), out);
+    pack<std::int32_t>(p.type().baryon_number(), out);
+    pack<std::int32_t>(p.type().strangeness(), out);
   }
+  write_bytes(record, out - record);
 }
 
 BinaryOutputCollisions::BinaryOutputCollisions(
@@ -204,14 +294,17 @@ BinaryOutputCollisions::BinaryOutputCollisions(
     const OutputParameters &out_par)
     : BinaryOutputBase(
           path / ((name == "Collisions" ? "collisions_binary" : name) + ".bin"),
-          "wb", name, out_par.get_coll_extended(name)),
+          "wb", name, out_par.get_coll_extended(name), out_par.compress_files,
+          out_par.binary_event_index),
       print_start_end_(out_par.coll_printstartend) {}
 
 void BinaryOutputCollisions::at_eventstart(const Particles &particles,
-                                           const int, const EventInfo &) {
+                                           const int event_number,
+                                           const EventInfo &) {
   const char pchar = 'p';
   if (print_start_end_) {
-    std::fwrite(&pchar, sizeof(char), 1, file_.get());
+    index_block('s', event_number, particles.size());
+    write(pchar);
     write(particles.size());
     write(particles);
   }
@@ -222,36 +315,37 @@ void BinaryOutputCollisions::at_eventend(const Particles &particles,
                                          const EventInfo &event) {
   const char pchar = 'p';
   if (print_start_end_) {
-    std::fwrite(&pchar, sizeof(char), 1, file_.get());
+    index_block('e', event_number, particles.size());
+    write(pchar);
     write(particles.size());
     write(particles);
   }
 
   // Event end line
   const char fchar = 'f';
-  std::fwrite(&fchar, sizeof(char), 1, file_.get());
+  write(fchar);
   write(event_number);
   write(event.impact_parameter);
   const char empty = event.empty_event;
   write(empty);
 
   // Flush to disk
-  std::fflush(file_.get());
+  flush();
 }
 
 void BinaryOutputCollisions::at_interaction(const Action &action,
                                             const double density) {
   const char ichar = 'i';
-  std::fwrite(&ichar, sizeof(char), 1, file_.get());
+  write(ichar);
   write(action.incoming_particles().size());
   write(action.outgoing_particles().size());
-  std::fwrite(&density, sizeof(double), 1, file_.get());
+  write(density);
   const double weight = action.get_total_weight();
-  std::fwrite(&weight, sizeof(double), 1, file_.get());
+  write(weight);
   const double partial_weight = action.get_partial_weight();
-  std::fwrite(&partial_weight, sizeof(double), 1, file_.get());
+  write(partial_weight);
   const auto type = static_cast<uint32_t>(action.get_type());
-  std::fwrite(&type, sizeof(uint32_t), 1, file_.get());
+  write(type);
   write(action.incoming_particles());
   write(action.outgoing_particles());
 }
@@ -260,14 +354,17 @@ BinaryOutputParticles::BinaryOutputParticles(const std::filesystem::path &path,
                                              std::string name,
                                              const OutputParameters &out_par)
     : BinaryOutputBase(path / "particles_binary.bin", "wb", name,
-                       out_par.part_extended),
+                       out_par.part_extended, out_par.compress_files,
+                       out_par.binary_event_index),
       only_final_(out_par.part_only_final) {}
 
-void BinaryOutputParticles::at_eventstart(const Particles &particles, const int,
+void BinaryOutputParticles::at_eventstart(const Particles &particles,
+                                          const int event_number,
                                           const EventInfo &) {
   const char pchar = 'p';
   if (only_final_ == OutputOnlyFinal::No) {
-    std::fwrite(&pchar, sizeof(char), 1, file_.get());
+    index_block('s', event_number, particles.size());
+    write(pchar);
     write(particles.size());
     write(particles);
   }
@@ -278,21 +375,22 @@ void BinaryOutputParticles::at_eventend(const Particles &particles,
                                         const EventInfo &event) {
   const char pchar = 'p';
   if (!(event.empty_event && only_final_ == OutputOnlyFinal::IfNotEmpty)) {
-    std::fwrite(&pchar, sizeof(char), 1, file_.get());
+    index_block('e', event_number, particles.size());
+    write(pchar);
     write(particles.size());
     write(particles);
   }
 
   // Event end line
   const char fchar = 'f';
-  std::fwrite(&fchar, sizeof(char), 1, file_.get());
+  write(fchar);
   write(event_number);
   write(event.impact_parameter);
   const char empty = event.empty_event;
   write(empty);
 
   // Flush to disk
-  std::fflush(file_.get());
+  flush();
 }
 
 void BinaryOutputParticles::at_intermediate_time(const Particles &particles,
@@ -301,7 +399,7 @@ void BinaryOutputParticles::at_intermediate_time(const Particles &particles,
                                                  const EventInfo &) {
   const char pchar = 'p';
   if (only_final_ == OutputOnlyFinal::No) {
-    std::fwrite(&pchar, sizeof(char), 1, file_.get());
+    write(pchar);
     write(particles.size());
     write(particles);
   }
@@ -310,8 +408,8 @@ void BinaryOutputParticles::at_intermediate_time(const Particles &particles,
 BinaryOutputInitialConditions::BinaryOutputInitialConditions(
     const std::filesystem::path &path, std::string name,
     const OutputParameters &out_par)
-    : BinaryOutputBase(path / "SMASH_IC.bin", "wb", name, out_par.ic_extended) {
-}
+    : BinaryOutputBase(path / "SMASH_IC.bin", "wb", name, out_par.ic_extended,
+                       out_par.compress_files) {}
 
 void BinaryOutputInitialConditions::at_eventstart(const Particles &, const int,
                                                   const EventInfo &) {}
@@ -321,14 +419,14 @@ void BinaryOutputInitialConditions::at_eventend(const Particles &particles,
                                                 const EventInfo &event) {
   // Event end line
   const char fchar = 'f';
-  std::fwrite(&fchar, sizeof(char), 1, file_.get());
+  write(fchar);
   write(event_number);
   write(event.impact_parameter);
   const char empty = event.empty_event;
   write(empty);
 
   // Flush to disk
-  std::fflush(file_.get());
+  flush();
 
   // If the runtime is too short some particles might not yet have
   // reached the hypersurface. Warning is printed.
@@ -344,7 +442,7 @@ void BinaryOutputInitialConditions::at_interaction(const Action &action,
                                                    const double) {
   if (action.get_type() == ProcessType::HyperSurfaceCrossing) {
     const char pchar = 'p';
-    std::fwrite(&pchar, sizeof(char), 1, file_.get());
+    write(pchar);
     write(action.incoming_particles().size());
     write(action.incoming_particles());
   }
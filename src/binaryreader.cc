@@ -0,0 +1,181 @@
+/*
+ *
+ *    Copyright (c) 2024
+ *      SMASH Team
+ *
+ *    GNU General Public License (GPLv3 or later)
+ *
+ */
+
+#include "smash/binaryreader.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <fstream>
+#include <stdexcept>
+
+namespace smash {
+
+namespace {
+/// Size of a particle record in bytes
+constexpr std::size_t particle_record_size =
+    9 * sizeof(double) + 3 * sizeof(std::int32_t);
+/// Size of the extended part of a particle record in bytes
+constexpr std::size_t extended_record_size =
+    3 * sizeof(double) + 7 * sizeof(std::int32_t);
+/// Size of the end of the index with its offset and "SMIX"
+constexpr std::size_t index_tail_size = sizeof(std::uint64_t) + 4;
+
+/**
+ * Copy a value out of the mapped file.
+ *
+ * \param[in] data First byte of the mapped file
+ * \param[in] size Size of the file in bytes
+ * \param[inout] offset Position of the value, which is advanced behind it
+ * \throw std::runtime_error if the value is not within the file.
+ */
+template <typename T>
+T read(const char *data, std::size_t size, std::size_t &offset) {
+  if (offset + sizeof(T) > size) {
+    throw std::runtime_error("Binary file ends unexpectedly.");
+  }
+  T value;
+  std::memcpy(&value, data + offset, sizeof(T));
+  offset += sizeof(T);
+  return value;
+}
+}  // namespace
+
+BinaryReader::BinaryReader(const std::filesystem::path &path) {
+  try {
+    if (path.extension() != ".shards") {
+      map_file(path);
+      return;
+    }
+    std::ifstream manifest(path);
+    if (!manifest) {
+      throw std::runtime_error("Cannot open " + path.string());
+    }
+    std::string line;
+    while (std::getline(manifest, line)) {
+      if (!line.empty() && line.front() != '#') {
+        map_file(path.parent_path() / line);
+      }
+    }
+    if (mappings_.empty()) {
+      throw std::runtime_error(path.string() + " lists no shards.");
+    }
+    // the blocks of an event stay in the order of their shard
+    std::stable_sort(index_.begin(), index_.end(),
+                     [](const IndexEntry &a, const IndexEntry &b) {
+                       return a.event_number < b.event_number;
+                     });
+  } catch (...) {
+    for (const Mapping &mapping : mappings_) {
+      ::munmap(const_cast<char *>(mapping.data), mapping.size);
+    }
+    throw;
+  }
+}
+
+BinaryReader::~BinaryReader() {
+  for (const Mapping &mapping : mappings_) {
+    ::munmap(const_cast<char *>(mapping.data), mapping.size);
+  }
+}
+
+void BinaryReader::map_file(const std::filesystem::path &path) {
+  const int fd = ::open(path.c_str(), O_RDONLY);
+  if (fd < 0) {
+    throw std::runtime_error("Cannot open " + path.string());
+  }
+  struct stat status;
+  if (::fstat(fd, &status) != 0 || status.st_size == 0) {
+    ::close(fd);
+    throw std::runtime_error("Cannot read " + path.string());
+  }
+  const std::size_t size = status.st_size;
+  void *mapping = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+  // the mapping stays valid after the file is closed
+  ::close(fd);
+  if (mapping == MAP_FAILED) {
+    throw std::runtime_error("Cannot map " + path.string());
+  }
+  const char *data = static_cast<const char *>(mapping);
+  const auto shard = static_cast<std::uint32_t>(mappings_.size());
+  // unmapped by the constructor if anything fails
+  mappings_.push_back({data, size});
+
+  std::size_t offset = 0;
+  if (size < 4 || std::memcmp(data, "SMSH", 4) != 0) {
+    throw std::runtime_error(path.string() + " is no SMASH binary file.");
+  }
+  offset = 4;
+  const auto format_version = read<std::uint16_t>(data, size, offset);
+  const bool extended = read<std::uint16_t>(data, size, offset) != 0;
+  const auto length = read<std::uint32_t>(data, size, offset);
+  if (offset + length > size) {
+    throw std::runtime_error("Binary file ends unexpectedly.");
+  }
+  const std::string smash_version(data + offset, length);
+  if (shard == 0) {
+    format_version_ = format_version;
+    extended_ = extended;
+    smash_version_ = smash_version;
+  } else if (format_version != format_version_ || extended != extended_ ||
+             smash_version != smash_version_) {
+    throw std::runtime_error(path.string() +
+                             " differs in its format from the other shards.");
+  }
+
+  if (size < index_tail_size || std::memcmp(data + size - 4, "SMIX", 4) != 0) {
+    throw std::runtime_error(path.string() + " has no event index.");
+  }
+  std::size_t tail = size - index_tail_size;
+  offset = read<std::uint64_t>(data, size, tail);
+  if (read<char>(data, size, offset) != 'x') {
+    throw std::runtime_error(path.string() + " has an invalid event index.");
+  }
+  const auto n_entries = read<std::uint32_t>(data, size, offset);
+  index_.reserve(index_.size() + n_entries);
+  for (std::uint32_t i = 0; i < n_entries; i++) {
+    IndexEntry entry;
+    entry.stage = read<char>(data, size, offset);
+    entry.event_number = read<std::int32_t>(data, size, offset);
+    entry.offset = read<std::uint64_t>(data, size, offset);
+    entry.n_particles = read<std::uint32_t>(data, size, offset);
+    entry.shard = shard;
+    index_.push_back(entry);
+  }
+}
+
+BinaryParticleBlock BinaryReader::particles(const IndexEntry &entry) const {
+  const std::size_t record_size =
+      particle_record_size + (extended_ ? extended_record_size : 0);
+  // skip the 'p' and the number of particles of the block header
+  const std::size_t begin =
+      entry.offset + sizeof(char) + sizeof(std::uint32_t);
+  if (entry.shard >= mappings_.size() ||
+      begin + entry.n_particles * record_size > mappings_[entry.shard].size) {
+    throw std::runtime_error("Particle block is not within the binary file.");
+  }
+  return BinaryParticleBlock(mappings_[entry.shard].data + begin,
+                             entry.n_particles, record_size);
+}
+
+BinaryParticleBlock BinaryReader::particles(std::int32_t event_number,
+                                            char stage) const {
+  for (const IndexEntry &entry : index_) {
+    if (entry.event_number == event_number && entry.stage == stage) {
+      return particles(entry);
+    }
+  }
+  throw std::out_of_range("Event " + std::to_string(event_number) +
+                          " is not in the event index.");
+}
+
+}  // namespace smash
@@ -1,5 +1,5 @@
 /*
- *    Copyright (c) 2012-2020,2022-2023
+ *    Copyright (c) 2012-2020,2022-2024
  *      SMASH Team
  *
  *    GNU General Public License (GPLv3 or later)
@@ -28,6 +28,30 @@
 namespace smash {
 static constexpr int LBox = LogArea::Box::id;
 
+namespace {
+/**
+ * Take the criterion of the equilibrium from the box section.
+ *
+ * \param[in] modus_config The modus section
+ * \return The criterion, if the `Stop_At_Equilibrium` section is given
+ */
+std::optional<EquilibriumCriterion> take_equilibrium_criterion(
+    Configuration &modus_config) {
+  if (!modus_config.has_value({"Box", "Stop_At_Equilibrium"})) {
+    return std::nullopt;
+  }
+  EquilibriumCriterion criterion;
+  criterion.window = modus_config.take(
+      {"Box", "Stop_At_Equilibrium", "Window"}, criterion.window);
+  criterion.tolerance = modus_config.take(
+      {"Box", "Stop_At_Equilibrium", "Tolerance"}, criterion.tolerance);
+  criterion.measurement_time =
+      modus_config.take({"Box", "Stop_At_Equilibrium", "Measurement_Time"},
+                        criterion.measurement_time);
+  return criterion;
+}
+}  // namespace
+
 /* console output on startup of box specific parameters */
 std::ostream &operator<<(std::ostream &out, const BoxModus &m) {
   out << "-- Box Modus:\nSize of the box: (" << m.length_ << " fm)³\n";
@@ -59,6 +83,12 @@ std::ostream &operator<<(std::ostream &out, const BoxModus &m) {
     out << "Adding a " << ptype->name() << " as a jet in the middle "
         << "of the box with " << m.jet_mom_ << " GeV initial momentum.\n";
   }
+  if (m.equilibrium_criterion_) {
+    out << "Stopping at the equilibrium (window = "
+        << m.equilibrium_criterion_->window
+        << " fm, tolerance = " << m.equilibrium_criterion_->tolerance
+        << ") plus " << m.equilibrium_criterion_->measurement_time << " fm\n";
+  }
   return out;
 }
 
@@ -92,7 +122,9 @@ BoxModus::BoxModus(Configuration modus_config,
                          modus_config.take({"Box", "Jet", "Jet_PDG"}))
                    : std::nullopt),
 
-      jet_mom_(modus_config.take({"Box", "Jet", "Jet_Momentum"}, 20.)) {
+      jet_mom_(modus_config.take({"Box", "Jet", "Jet_Momentum"}, 20.)),
+      equilibrium_criterion_(take_equilibrium_criterion(modus_config)),
+      thermal_sampling_(temperature_, account_for_resonance_widths_) {
   if (parameters.res_lifetime_factor < 0.) {
     throw std::invalid_argument(
         "Resonance lifetime modifier cannot be negative!");
@@ -144,24 +176,25 @@ double BoxModus::initial_conditions(Particles *particles,
                        p.second);
     }
   }
-  std::unique_ptr<QuantumSampling> quantum_sampling;
-  if (this->initial_condition_ == BoxInitialCondition::ThermalMomentaQuantum) {
-    quantum_sampling = std::make_unique<QuantumSampling>(init_multipl_, V, T);
+  // The set up of the quantum sampling is the same for all events
+  if (this->initial_condition_ == BoxInitialCondition::ThermalMomentaQuantum &&
+      !quantum_sampling_) {
+    quantum_sampling_.emplace(init_multipl_, V, T);
+  }
+  if (this->initial_condition_ ==
+      BoxInitialCondition::ThermalMomentaBoltzmann) {
+    /* thermal momentum according Maxwell-Boltzmann distribution, sampled
+     * for all particles of a species at once */
+    thermal_sampling_.sample(particles, thread_pool_);
   }
   for (ParticleData &data : *particles) {
     /* Set MOMENTUM SPACE distribution */
-    if (this->initial_condition_ == BoxInitialCondition::PeakedMomenta) {
-      /* initial thermal momentum is the average 3T */
-      momentum_radial = 3.0 * T;
-      mass = data.pole_mass();
-    } else {
-      if (this->initial_condition_ ==
-          BoxInitialCondition::ThermalMomentaBoltzmann) {
-        /* thermal momentum according Maxwell-Boltzmann distribution */
-        mass = (!account_for_resonance_widths_)
-                   ? data.type().mass()
-                   : HadronGasEos::sample_mass_thermal(data.type(), 1.0 / T);
-        momentum_radial = sample_momenta_from_thermal(T, mass);
+    if (this->initial_condition_ !=
+        BoxInitialCondition::ThermalMomentaBoltzmann) {
+      if (this->initial_condition_ == BoxInitialCondition::PeakedMomenta) {
+        /* initial thermal momentum is the average 3T */
+        momentum_radial = 3.0 * T;
+        mass = data.pole_mass();
       } else if (this->initial_condition_ ==
                  BoxInitialCondition::ThermalMomentaQuantum) {
         /*
@@ -170,14 +203,13 @@ double BoxModus::initial_conditions(Particles *particles,
          * We take the pole mass as the mass.
          */
         mass = data.type().mass();
-        momentum_radial = quantum_sampling->sample(data.pdgcode());
+        momentum_radial = quantum_sampling_->sample(data.pdgcode());
       }
+      phitheta.distribute_isotropically();
+      data.set_4momentum(mass, phitheta.threevec() * momentum_radial);
     }
-    phitheta.distribute_isotropically();
-    logg[LBox].debug(data.type().name(), "(id ", data.id(),
-                     ") radial momentum ", momentum_radial, ", direction",
-                     phitheta);
-    data.set_4momentum(mass, phitheta.threevec() * momentum_radial);
+    logg[LBox].debug(data.type().name(), "(id ", data.id(), ") momentum ",
+                     data.momentum());
     momentum_total += data.momentum();
 
     /* Set COORDINATE SPACE distribution */
@@ -1,6 +1,6 @@
 /*
  *
- *    Copyright (c) 2019-2020,2022
+ *    Copyright (c) 2019-2020,2022,2024
  *      SMASH Team
  *
  *    GNU General Public License (GPLv3 or later)
@@ -61,18 +61,29 @@ BremsstrahlungAction::bremsstrahlung_reaction_type(const ParticleList &in) {
 }
 
 void BremsstrahlungAction::perform_bremsstrahlung(const OutputsList &outputs) {
+  std::vector<OutputInterface *> photon_outputs;
+  for (const auto &output : outputs) {
+    if (output->is_photon_output()) {
+      photon_outputs.push_back(output.get());
+    }
+  }
+  // Like for ScatterActionPhoton::perform_photons
+  const FinalStateKinematics kin = prepare_final_state();
   for (int i = 0; i < number_of_fractional_photons_; i++) {
-    generate_final_state();
-    for (const auto &output : outputs) {
-      if (output->is_photon_output()) {
-        // we do not care about the local density
-        output->at_interaction(*this, 0.0);
-      }
+    sample_final_state(kin, i == 0);
+    for (OutputInterface *output : photon_outputs) {
+      // we do not care about the local density
+      output->at_interaction(*this, 0.0);
     }
   }
 }
 
 void BremsstrahlungAction::generate_final_state() {
+  sample_final_state(prepare_final_state(), true);
+}
+
+BremsstrahlungAction::FinalStateKinematics
+BremsstrahlungAction::prepare_final_state() {
   // we have only one reaction per incoming particle pair
   if (collision_processes_bremsstrahlung_.size() != 1) {
     logg[LScatterAction].fatal()
@@ -87,16 +98,25 @@ void BremsstrahlungAction::generate_final_state() {
 
   outgoing_particles_ = proc->particle_list();
   process_type_ = proc->get_type();
-  FourVector interaction_point = get_interaction_point();
+  FinalStateKinematics kin;
+  kin.interaction_point = get_interaction_point();
+  kin.velocity = total_momentum_of_outgoing_particles().velocity();
 
-  // Sample k and theta:
   // minimum cutoff for k to be in accordance with cross section calculations
-  double delta_k;  // k-range
-  double k_min = 0.001;
-  double k_max =
+  kin.k_min = 0.001;
+  kin.k_max =
       (sqrt_s() * sqrt_s() - 2 * outgoing_particles_[0].type().mass() * 2 *
                                  outgoing_particles_[1].type().mass()) /
       (2 * sqrt_s());
+  return kin;
+}
+
+void BremsstrahlungAction::sample_final_state(const FinalStateKinematics &kin,
+                                              bool check_conservation) {
+  // Sample k and theta:
+  double delta_k;  // k-range
+  const double k_min = kin.k_min;
+  const double k_max = kin.k_max;
 
   if ((k_max - k_min) < 0.0) {
     // Make sure it is kinematically even possible to create a photon that is
@@ -128,18 +148,20 @@ void BremsstrahlungAction::generate_final_state() {
              incoming_particles_[1].xsec_scaling_factor();
 
   // Set position and formation time and boost back to computational frame
+  const LorentzBoost to_computational_frame(-kin.velocity);
   for (auto &new_particle : outgoing_particles_) {
     // assuming decaying particles are always fully formed
     new_particle.set_formation_time(time_of_execution_);
-    new_particle.set_4position(interaction_point);
-    new_particle.boost_momentum(
-        -total_momentum_of_outgoing_particles().velocity());
+    new_particle.set_4position(kin.interaction_point);
+    new_particle.boost_momentum(to_computational_frame);
   }
 
-  // Photons are not really part of the normal processes, so we have to set a
-  // constant arbitrary number.
-  const auto id_process = ID_PROCESS_PHOTON;
-  Action::check_conservation(id_process);
+  if (check_conservation) {
+    // Photons are not really part of the normal processes, so we have to set a
+    // constant arbitrary number.
+    const auto id_process = ID_PROCESS_PHOTON;
+    Action::check_conservation(id_process);
+  }
 }
 
 void BremsstrahlungAction::sample_3body_phasespace() {
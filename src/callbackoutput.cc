@@ -0,0 +1,64 @@
+/*
+ *
+ *    Copyright (c) 2024
+ *      SMASH Team
+ *
+ *    GNU General Public License (GPLv3 or later)
+ *
+ */
+
+#include "smash/callbackoutput.h"
+
+#include <stdexcept>
+#include <utility>
+
+#include "smash/action.h"
+#include "smash/particles.h"
+
+namespace smash {
+
+namespace {
+/**
+ * Point to all given particles, reusing the storage of the pointers.
+ *
+ * \param[in] particles Particles to point to
+ * \param[out] pointers Pointers to the particles
+ * \return Span of the particles
+ */
+template <typename Container>
+ParticleSpan point_to(const Container &particles,
+                      std::vector<const ParticleData *> *pointers) {
+  pointers->clear();
+  for (const ParticleData &p : particles) {
+    pointers->push_back(&p);
+  }
+  return ParticleSpan(*pointers);
+}
+}  // namespace
+
+CallbackOutput::CallbackOutput(EventEndCallback at_eventend,
+                               InteractionCallback at_interaction)
+    : OutputInterface("Particles"),
+      at_eventend_(std::move(at_eventend)),
+      at_interaction_(std::move(at_interaction)) {
+  if (!at_eventend_) {
+    throw std::invalid_argument(
+        "The callback output needs a function for the end of the events.");
+  }
+}
+
+void CallbackOutput::at_eventend(const Particles &particles,
+                                 const int event_number,
+                                 const EventInfo &info) {
+  at_eventend_(event_number, info, point_to(particles, &particles_));
+}
+
+void CallbackOutput::at_interaction(const Action &action, const double) {
+  if (!at_interaction_) {
+    return;
+  }
+  at_interaction_(action, point_to(action.incoming_particles(), &incoming_),
+                  point_to(action.outgoing_particles(), &outgoing_));
+}
+
+}  // namespace smash
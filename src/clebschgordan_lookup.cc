@@ -1,5 +1,5 @@
 /*
- *    Copyright (c) 2023
+ *    Copyright (c) 2023-2024
  *      SMASH Team
  *
  *    GNU General Public License (GPLv3 or later)
@@ -7,13 +7,15 @@
 
 #include "smash/clebschgordan_lookup.h"
 
-#include <numeric>
-#include <unordered_map>
+#include <cassert>
+#include <cmath>
+#include <cstdlib>
+#include <utility>
+#include <vector>
 
 #include "gsl/gsl_sf_coupling.h"
 
 #include "smash/constants.h"
-#include "smash/iomanipulators.h"
 #include "smash/logging.h"
 
 namespace smash {
@@ -30,25 +32,45 @@ double ClebschGordan::calculate_coefficient(const int j_a, const int j_b,
   const int j = (j_a - j_b + m_c) / 2;
   double result = std::sqrt(j_c + 1) * wigner_3j;
   result *= (j % 2 == 0) * 2 - 1;  // == (-1)**j
-
-  logg[LResonances].debug("CG: ", result, " I1: ", j_a, " I2: ", j_b,
-                          " IR: ", j_c, " iz1: ", m_a, " iz2: ", m_b,
-                          " izR: ", m_c);
-
   return result;
 }
 
 double ClebschGordan::coefficient(const int j_a, const int j_b, const int j_c,
                                   const int m_a, const int m_b, const int m_c) {
-  const ThreeSpins spin_information = {j_a, j_b, j_c, m_a, m_b, m_c};
-  if (auto search = lookup_table.find(spin_information);
-      search != lookup_table.end()) {
-    return search->second;
-  } else {
-    double result = calculate_coefficient(j_a, j_b, j_c, m_a, m_b, m_c);
-    lookup_table.insert({spin_information, result});
-    return result;
+  if (j_a < 0 || j_b < 0 || j_c < 0 || j_a >= n_isospins_ ||
+      j_b >= n_isospins_ || j_c >= n_isospins_) {
+    return calculate_coefficient(j_a, j_b, j_c, m_a, m_b, m_c);
+  }
+  // The 3j symbol vanishes for these, which are not in the table
+  if (m_a + m_b != m_c || std::abs(m_a) > j_a || std::abs(m_b) > j_b ||
+      (j_a + m_a) % 2 != 0 || (j_b + m_b) % 2 != 0) {
+    return 0.;
+  }
+  return table_[index(j_a, j_b, j_c, m_a, m_b)];
+}
+
+void ClebschGordan::tabulate(const int max_j) {
+  assert(max_j >= 0);
+  std::vector<double> table(static_cast<std::size_t>(max_j + 1) * (max_j + 1) *
+                                (max_j + 1) * (max_j + 1) * (max_j + 1),
+                            0.);
+  n_isospins_ = max_j + 1;
+  for (int j_a = 0; j_a <= max_j; j_a++) {
+    for (int j_b = 0; j_b <= max_j; j_b++) {
+      for (int j_c = 0; j_c <= max_j; j_c++) {
+        for (int m_a = -j_a; m_a <= j_a; m_a += 2) {
+          for (int m_b = -j_b; m_b <= j_b; m_b += 2) {
+            table[index(j_a, j_b, j_c, m_a, m_b)] =
+                calculate_coefficient(j_a, j_b, j_c, m_a, m_b, m_a + m_b);
+          }
+        }
+      }
+    }
   }
+  table_ = std::move(table);
+  logg[LResonances].debug("Tabulated ", table_.size(),
+                          " Clebsch-Gordan coefficients up to isospin ",
+                          max_j, "/2.");
 }
 
 }  // namespace smash
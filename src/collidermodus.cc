@@ -1,5 +1,5 @@
 /*
- *    Copyright (c) 2012-2023
+ *    Copyright (c) 2012-2024
  *      SMASH Team
  *
  *    GNU General Public License (GPLv3 or later)
@@ -9,11 +9,17 @@
 
 #include <algorithm>
 #include <cmath>
+#include <condition_variable>
 #include <cstdlib>
 #include <cstring>
+#include <deque>
+#include <exception>
+#include <limits>
 #include <memory>
+#include <mutex>
 #include <stdexcept>
 #include <string>
+#include <thread>
 #include <tuple>
 #include <utility>
 #include <vector>
@@ -23,13 +29,171 @@
 #include "smash/experimentparameters.h"
 #include "smash/fourvector.h"
 #include "smash/logging.h"
+#include "smash/particles.h"
+#include "smash/particletype.h"
 #include "smash/random.h"
 
 namespace smash {
 static constexpr int LCollider = LogArea::Collider::id;
 
+/// Random stream of each event seed reserved for generating initial states
+static constexpr random::Engine::result_type pregeneration_stream =
+    std::numeric_limits<random::Engine::result_type>::max();
+
+/**
+ * \return The seed of the event following the one with the given seed, as
+ *         drawn by Experiment::draw_next_event_seed
+ * \param[in] seed Random seed of an event
+ */
+static int64_t next_event_seed(int64_t seed) {
+  random::Engine engine(seed);
+  int64_t r = engine();
+  while (r == INT64_MIN) {
+    r = engine();
+  }
+  return std::abs(r);
+}
+
+/**
+ * Generates the initial states of the events following the current one in a
+ * thread and keeps them in a queue of limited size, which is refilled as
+ * the events are taken.
+ */
+class ColliderModus::Pregenerator {
+ public:
+  /**
+   * Set up the generation without starting it yet.
+   *
+   * \param[in] generator Modus with its own nuclei, which is only used by
+   *                      the thread
+   * \param[in] capacity Number of events generated in advance at most
+   */
+  Pregenerator(std::unique_ptr<ColliderModus> generator, size_t capacity)
+      : generator_(std::move(generator)), capacity_(capacity) {}
+
+  /// Stop the thread.
+  ~Pregenerator() { stop(); }
+
+  /**
+   * Take the initial state of the event with the given seed, waiting until
+   * it is generated. The generation starts over from the given event, if it
+   * does not follow the previous one.
+   *
+   * \param[in] seed Random seed of the event
+   * \param[in] n_ensembles Number of ensembles
+   * \return The initial state
+   * \throw Any exception thrown while generating the initial state
+   */
+  PregeneratedEvent take(int64_t seed, int n_ensembles) {
+    if (!thread_.joinable() || seed != expected_seed_ ||
+        n_ensembles != n_ensembles_) {
+      stop();
+      queue_.clear();
+      error_ = nullptr;
+      stop_ = false;
+      n_ensembles_ = n_ensembles;
+      // All lazily evaluated quantities must be ready before the thread starts
+      ParticleType::initialize_lazy_members();
+      thread_ = std::thread(&Pregenerator::generate, this, seed);
+    }
+    std::unique_lock<std::mutex> lock(mutex_);
+    changed_.wait(lock, [this]() { return !queue_.empty() || error_; });
+    if (queue_.empty()) {
+      std::rethrow_exception(error_);
+    }
+    PregeneratedEvent event = std::move(queue_.front());
+    queue_.pop_front();
+    lock.unlock();
+    changed_.notify_all();
+    expected_seed_ = next_event_seed(seed);
+    return event;
+  }
+
+ private:
+  /// Stop the thread and wait for it.
+  void stop() {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      stop_ = true;
+    }
+    changed_.notify_all();
+    if (thread_.joinable()) {
+      thread_.join();
+    }
+  }
+
+  /**
+   * Generate the initial states until stopped.
+   *
+   * \param[in] seed Random seed of the first event
+   */
+  void generate(int64_t seed) {
+    try {
+      while (true) {
+        {
+          std::unique_lock<std::mutex> lock(mutex_);
+          changed_.wait(
+              lock, [this]() { return queue_.size() < capacity_ || stop_; });
+          if (stop_) {
+            return;
+          }
+        }
+        PregeneratedEvent event =
+            generator_->generate_event(seed, n_ensembles_);
+        seed = next_event_seed(seed);
+        {
+          std::lock_guard<std::mutex> lock(mutex_);
+          queue_.push_back(std::move(event));
+        }
+        changed_.notify_all();
+      }
+    } catch (...) {
+      {
+        std::lock_guard<std::mutex> lock(mutex_);
+        error_ = std::current_exception();
+      }
+      changed_.notify_all();
+    }
+  }
+
+  /// Modus with its own nuclei, which is only used by the thread
+  std::unique_ptr<ColliderModus> generator_;
+  /// Number of events generated in advance at most
+  const size_t capacity_;
+  /// Number of ensembles of each event
+  int n_ensembles_ = 0;
+  /// Seed of the event expected to be taken next
+  int64_t expected_seed_ = 0;
+  /// Guards all members below
+  std::mutex mutex_;
+  /// Notified whenever the queue changes
+  std::condition_variable changed_;
+  /// Initial states of the following events in order
+  std::deque<PregeneratedEvent> queue_;
+  /// Exception thrown by the thread, after which it stopped
+  std::exception_ptr error_;
+  /// Whether the thread is asked to stop
+  bool stop_ = false;
+  /// Thread generating the initial states
+  std::thread thread_;
+};
+
 ColliderModus::ColliderModus(Configuration modus_config,
                              const ExperimentParameters &params) {
+  const int pregenerated_events =
+      modus_config.take({"Collider", "Pregenerated_Events"}, 0);
+  if (pregenerated_events < 0) {
+    throw std::invalid_argument(
+        "The number of pregenerated events must not be negative.");
+  }
+  if (pregenerated_events > 0) {
+    // The generating thread uses its own nuclei, set up from the same input
+    Configuration generator_config(modus_config.to_string().c_str(),
+                                   Configuration::InitializeFromYAMLString);
+    pregenerator_ = std::make_unique<Pregenerator>(
+        std::make_unique<ColliderModus>(std::move(generator_config), params),
+        pregenerated_events);
+  }
   Configuration modus_cfg =
       modus_config.extract_sub_configuration({"Collider"});
   // Get the reference frame for the collision calculation.
@@ -211,6 +375,7 @@ ColliderModus::ColliderModus(Configuration modus_config,
     imp_max_ = impact_;
   } else {
     // If impact is not supplied by value, inspect sampling parameters:
+    std::vector<double> impacts;
     if (modus_cfg.has_value({"Impact", "Sample"})) {
       sampling_ = modus_cfg.take({"Impact", "Sample"});
       if (sampling_ == Sampling::Custom) {
@@ -221,8 +386,7 @@ ColliderModus::ColliderModus(Configuration modus_config,
               "sampling. "
               "Please provide Values and Yields.");
         }
-        const std::vector<double> impacts =
-            modus_cfg.take({"Impact", "Values"});
+        impacts = modus_cfg.take({"Impact", "Values"}).convert_for(impacts);
         const std::vector<double> yields = modus_cfg.take({"Impact", "Yields"});
         if (impacts.size() != yields.size()) {
           throw std::domain_error(
@@ -248,6 +412,30 @@ ColliderModus::ColliderModus(Configuration modus_config,
       imp_min_ = 0.0;
       imp_max_ = modus_cfg.take({"Impact", "Max"});
     }
+    weighted_impact_ = modus_cfg.take({"Impact", "Weighted"}, false);
+    if (weighted_impact_ && imp_min_ == imp_max_) {
+      throw std::domain_error(
+          "Input Error: Weighted events need a range of impact parameters. "
+          "Please provide Range, Max or custom Values.");
+    }
+    if (weighted_impact_ && sampling_ == Sampling::Custom) {
+      /* The interpolation is linear between the values, so the trapezoidal
+       * rule with them as nodes is exact. */
+      const double b_low = std::min(imp_min_, imp_max_);
+      const double b_high = std::max(imp_min_, imp_max_);
+      std::vector<double> nodes{b_low, b_high};
+      for (const double b : impacts) {
+        if (b > b_low && b < b_high) {
+          nodes.push_back(b);
+        }
+      }
+      std::sort(nodes.begin(), nodes.end());
+      for (std::size_t i = 1; i < nodes.size(); i++) {
+        yield_integral_ += 0.5 * (nodes[i] - nodes[i - 1]) *
+                           ((*impact_interpolation_)(nodes[i - 1]) +
+                            (*impact_interpolation_)(nodes[i]));
+      }
+    }
   }
   /// \todo include a check that only one method of specifying impact is used
   // whether the direction of separation should be ramdomly smapled
@@ -314,8 +502,50 @@ std::unique_ptr<DeformedNucleus> ColliderModus::create_deformed_nucleus(
   }
 }
 
+ColliderModus::~ColliderModus() = default;
+
 double ColliderModus::initial_conditions(Particles *particles,
                                          const ExperimentParameters &) {
+  if (pregenerator_) {
+    for (const ParticleData &p :
+         pregenerated_event_.ensembles.at(next_ensemble_++)) {
+      particles->insert(p);
+    }
+    return pregenerated_event_.start_time;
+  }
+  return sample_initial_state(particles);
+}
+
+void ColliderModus::prepare_event(int64_t seed, int n_ensembles) {
+  if (!pregenerator_) {
+    return;
+  }
+  pregenerated_event_ = pregenerator_->take(seed, n_ensembles);
+  next_ensemble_ = 0;
+  impact_ = pregenerated_event_.impact;
+  velocity_projectile_ = pregenerated_event_.velocity_projectile;
+  velocity_target_ = pregenerated_event_.velocity_target;
+}
+
+ColliderModus::PregeneratedEvent ColliderModus::generate_event(
+    int64_t seed, int n_ensembles) {
+  // The engine of the generating thread is only used for the initial states
+  random::engine.seed(seed, pregeneration_stream);
+  sample_impact();
+  PregeneratedEvent event;
+  event.ensembles.resize(n_ensembles);
+  for (ParticleList &nucleons : event.ensembles) {
+    Particles particles;
+    event.start_time = sample_initial_state(&particles);
+    nucleons = particles.copy_to_vector();
+  }
+  event.impact = impact_;
+  event.velocity_projectile = velocity_projectile_;
+  event.velocity_target = velocity_target_;
+  return event;
+}
+
+double ColliderModus::sample_initial_state(Particles *particles) {
   // Populate the nuclei with appropriately distributed nucleons.
   // If deformed, this includes rotating the nucleus.
   projectile_->arrange_nucleons();
@@ -397,6 +627,10 @@ void ColliderModus::rotate_reaction_plane(double phi, Particles *particles) {
 }
 
 void ColliderModus::sample_impact() {
+  if (pregenerator_) {
+    // Taken from the initial state generated in advance
+    return;
+  }
   switch (sampling_) {
     case Sampling::Quadratic: {
       // quadratic sampling: Note that for bmin > bmax, this still yields
@@ -427,6 +661,24 @@ void ColliderModus::sample_impact() {
   }
 }
 
+double ColliderModus::event_weight() const {
+  if (!weighted_impact_) {
+    return 1.;
+  }
+  // Quadratic distribution within the range, which may be inverted
+  const double minimum_bias =
+      2. * impact_ / std::abs(imp_max_ * imp_max_ - imp_min_ * imp_min_);
+  switch (sampling_) {
+    case Sampling::Uniform:
+      return minimum_bias * std::abs(imp_max_ - imp_min_);
+    case Sampling::Custom:
+      return minimum_bias * yield_integral_ / (*impact_interpolation_)(impact_);
+    case Sampling::Quadratic:
+      break;
+  }
+  return 1.;
+}
+
 std::pair<double, double> ColliderModus::get_velocities(double s, double m_a,
                                                         double m_b) {
   double v_a = 0.0;
@@ -0,0 +1,208 @@
+/*
+ *
+ *    Copyright (c) 2024
+ *      SMASH Team
+ *
+ *    GNU General Public License (GPLv3 or later)
+ *
+ */
+
+#include "smash/collisionprefilter.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <stdexcept>
+
+#include "smash/constants.h"
+#include "smash/particledata.h"
+
+namespace smash {
+
+namespace {
+/**
+ * Relative margin for rounding, by which the filter may accept more pairs
+ * than the detailed check. The quantities are computed in a different order
+ * than there, and possibly with fused multiply-adds.
+ */
+constexpr double rounding_margin = 1e-9;
+
+/**
+ * \return the group of the particle, like the check of the nucleus in
+ *         ScatterActionsFinder::check_collision_two_part
+ */
+KinematicsSnapshot::Group group_of(const ParticleData &p) {
+  if (p.get_history().collisions_per_particle != 0) {
+    return KinematicsSnapshot::Participant;
+  }
+  switch (p.belongs_to()) {
+    case BelongsTo::Projectile:
+      return KinematicsSnapshot::ProjectileSpectator;
+    case BelongsTo::Target:
+      return KinematicsSnapshot::TargetSpectator;
+    default:
+      return KinematicsSnapshot::Participant;
+  }
+}
+}  // namespace
+
+void KinematicsSnapshot::assign(const ParticleSpan &particles,
+                                const std::vector<FourVector> &beam_momentum) {
+  const std::size_t n = particles.size();
+  id.resize(n);
+  group.resize(n);
+  index.resize(n);
+  slot.resize(n);
+  for (auto *v : {&t, &x, &y, &z, &e, &px, &py, &pz, &e_time, &px_time,
+                  &py_time, &pz_time}) {
+    v->resize(n);
+  }
+  // Counting sort by the groups, keeping the order within the groups
+  std::array<std::size_t, n_groups> next{};
+  for (std::size_t i = 0; i < n; i++) {
+    slot[i] = group_of(particles[i]);
+    next[slot[i]]++;
+  }
+  group_begin[0] = 0;
+  for (int g = 0; g < n_groups; g++) {
+    group_begin[g + 1] = group_begin[g] + next[g];
+    next[g] = group_begin[g];
+  }
+  for (std::size_t i = 0; i < n; i++) {
+    const ParticleData &p = particles[i];
+    if (p.id() < 0) {
+      throw std::runtime_error("Invalid particle ID for Fermi motion");
+    }
+    /* Same as in ScatterActionsFinder::collision_time: particles of the
+     * initial nuclei are propagated with the beam momentum until they
+     * interact. */
+    const bool has_no_prior_interactions =
+        (static_cast<uint64_t>(p.id()) <
+         static_cast<uint64_t>(beam_momentum.size())) &&
+        (p.get_history().collisions_per_particle == 0);
+    const FourVector &mom = p.momentum();
+    const FourVector &mom_time =
+        has_no_prior_interactions ? beam_momentum[p.id()] : mom;
+    const std::size_t k = next[slot[i]]++;
+    group[k] = slot[i];
+    slot[i] = k;
+    index[k] = i;
+    id[k] = p.id();
+    t[k] = p.position().x0();
+    x[k] = p.position().x1();
+    y[k] = p.position().x2();
+    z[k] = p.position().x3();
+    e[k] = mom.x0();
+    px[k] = mom.x1();
+    py[k] = mom.x2();
+    pz[k] = mom.x3();
+    e_time[k] = mom_time.x0();
+    px_time[k] = mom_time.x1();
+    py_time[k] = mom_time.x2();
+    pz_time[k] = mom_time.x3();
+  }
+}
+
+const std::vector<std::size_t> &CollisionPrefilter::select(
+    const KinematicsSnapshot &a, std::size_t i, const KinematicsSnapshot &b,
+    double dt, double max_transverse_distance_sqr, bool only_larger_ids,
+    bool separate_spectators) {
+  keep_.resize(b.size());
+  min_distance_sqr_.resize(b.size());
+  selected_.clear();
+
+  // Entry of the given particle in the snapshot
+  const std::size_t k = a.slot[i];
+  const int id_a = a.id[k];
+  const double t_a = a.t[k], x_a = a.x[k], y_a = a.y[k], z_a = a.z[k];
+  const double e_a = a.e[k], px_a = a.px[k], py_a = a.py[k], pz_a = a.pz[k];
+  const double et_a = a.e_time[k], pxt_a = a.px_time[k],
+               pyt_a = a.py_time[k], pzt_a = a.pz_time[k];
+  const double parallel_lower = really_small * (1. - rounding_margin);
+  const double parallel_upper = really_small * (1. + rounding_margin);
+
+  for (int g = 0; g < KinematicsSnapshot::n_groups; g++) {
+    // The spectators of the own nucleus are not looked at
+    if (separate_spectators && g != KinematicsSnapshot::Participant &&
+        g == a.group[k]) {
+      continue;
+    }
+    const std::size_t begin = b.group_begin[g], end = b.group_begin[g + 1];
+    // Branch-free, such that the loop over the partners can be vectorized
+    for (std::size_t j = begin; j < end; j++) {
+      // Collision time in the computational frame, see collision_time
+      const double dvx = pxt_a * b.e_time[j] - b.px_time[j] * et_a;
+      const double dvy = pyt_a * b.e_time[j] - b.py_time[j] * et_a;
+      const double dvz = pzt_a * b.e_time[j] - b.pz_time[j] * et_a;
+      const double dv_sqr = dvx * dvx + dvy * dvy + dvz * dvz;
+      const double drx = x_a - b.x[j];
+      const double dry = y_a - b.y[j];
+      const double drz = z_a - b.z[j];
+      const double energies = et_a * b.e_time[j] / dv_sqr;
+      const double time = -(drx * dvx + dry * dvy + drz * dvz) * energies;
+      const double time_margin =
+          rounding_margin * ((std::abs(drx * dvx) + std::abs(dry * dvy) +
+                              std::abs(drz * dvz)) *
+                                 std::abs(energies) +
+                             dt);
+      /* Particles moving parallel never collide. Close to the threshold the
+       * detailed check has to decide. */
+      const bool in_time = dv_sqr >= parallel_lower &&
+                           (dv_sqr < parallel_upper ||
+                            (time > -time_margin && time < dt + time_margin));
+
+      // Transverse distance in the center of momentum frame, see
+      // ScatterAction::transverse_distance_sqr
+      const double e_tot = e_a + b.e[j];
+      const double vx = (px_a + b.px[j]) / e_tot;
+      const double vy = (py_a + b.py[j]) / e_tot;
+      const double vz = (pz_a + b.pz[j]) / e_tot;
+      const double v_sqr = vx * vx + vy * vy + vz * vz;
+      const double gamma = v_sqr < 1. ? 1. / std::sqrt(1. - v_sqr) : 0.;
+      const double boost_factor = gamma / (gamma + 1);
+      // The boost is linear, so the differences can be boosted
+      const double dt_pos = t_a - b.t[j];
+      const double dt_pos_cm =
+          gamma * (dt_pos - (drx * vx + dry * vy + drz * vz));
+      const double c_pos = boost_factor * (dt_pos_cm + dt_pos);
+      const double rx = drx - vx * c_pos;
+      const double ry = dry - vy * c_pos;
+      const double rz = drz - vz * c_pos;
+      const double dpx = px_a - b.px[j];
+      const double dpy = py_a - b.py[j];
+      const double dpz = pz_a - b.pz[j];
+      const double de = e_a - b.e[j];
+      const double de_cm = gamma * (de - (dpx * vx + dpy * vy + dpz * vz));
+      const double c_mom = boost_factor * (de_cm + de);
+      const double qx = dpx - vx * c_mom;
+      const double qy = dpy - vy * c_mom;
+      const double qz = dpz - vz * c_mom;
+      const double dr_sqr = rx * rx + ry * ry + rz * rz;
+      const double dp_sqr = qx * qx + qy * qy + qz * qz;
+      const double dpdr = rx * qx + ry * qy + rz * qz;
+      /* Zero momentum leads to the full distance. Close to the threshold the
+       * smaller of both alternatives is taken. */
+      const double projected =
+          dr_sqr - dpdr * dpdr / (dp_sqr > 0. ? dp_sqr : 1.);
+      const double distance_sqr = dp_sqr < parallel_lower ? dr_sqr : projected;
+      const bool close =
+          distance_sqr < max_transverse_distance_sqr +
+                             rounding_margin *
+                                 (dr_sqr + max_transverse_distance_sqr);
+
+      keep_[j] = in_time && close && (!only_larger_ids || id_a < b.id[j]);
+      min_distance_sqr_[j] = distance_sqr - rounding_margin * dr_sqr;
+    }
+
+    for (std::size_t j = begin; j < end; j++) {
+      if (keep_[j]) {
+        selected_.push_back(b.index[j]);
+      }
+    }
+  }
+  // The groups are not in the order of the particles
+  std::sort(selected_.begin(), selected_.end());
+  return selected_;
+}
+
+}  // namespace smash
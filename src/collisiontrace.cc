@@ -0,0 +1,226 @@
+/*
+ *
+ *    Copyright (c) 2024
+ *      SMASH Team
+ *
+ *    GNU General Public License (GPLv3 or later)
+ *
+ */
+
+#include "smash/collisiontrace.h"
+
+#include <array>
+#include <cstring>
+#include <iterator>
+#include <stdexcept>
+#include <string>
+
+#include "smash/particletype.h"
+
+namespace smash {
+
+namespace {
+/// Magic number at the start of a trace
+constexpr char magic_number[8] = {'S', 'M', 'S', 'H', 'T', 'R', 'C', 'E'};
+
+/// Size of an encoded particle in bytes
+constexpr std::size_t particle_size = 4 * sizeof(std::int32_t) + 1 +
+                                      11 * sizeof(double);
+
+/// Size of an encoded record in bytes
+constexpr std::size_t record_size = 2 + 3 * sizeof(double) + 2 * particle_size;
+
+/// Buffered bytes, from which on the records are written
+constexpr std::size_t flush_size = 1 << 22;
+
+/**
+ * Copy a value into an encoded record.
+ *
+ * \param[inout] out Position in the record, which is advanced
+ * \param[in] value Value to be written
+ */
+template <typename T>
+void put(char *&out, T value) {
+  std::memcpy(out, &value, sizeof(T));
+  out += sizeof(T);
+}
+
+/**
+ * Copy a value out of an encoded record.
+ *
+ * \param[inout] in Position in the record, which is advanced
+ * \return The value
+ */
+template <typename T>
+T get(const char *&in) {
+  T value;
+  std::memcpy(&value, in, sizeof(T));
+  in += sizeof(T);
+  return value;
+}
+
+/**
+ * Encode a particle.
+ *
+ * \param[inout] out Position in the record, which is advanced
+ * \param[in] p The particle
+ */
+void put_particle(char *&out, const ParticleData &p) {
+  put<std::int32_t>(out, p.pdgcode().get_decimal());
+  put<std::int32_t>(out, p.id());
+  put<std::int32_t>(out, p.id_process());
+  put<std::int32_t>(out, p.get_history().collisions_per_particle);
+  put<char>(out, static_cast<char>(p.belongs_to()));
+  for (int i = 0; i < 4; i++) {
+    put<double>(out, p.position()[i]);
+  }
+  for (int i = 0; i < 4; i++) {
+    put<double>(out, p.momentum()[i]);
+  }
+  put<double>(out, p.begin_formation_time());
+  put<double>(out, p.formation_time());
+  put<double>(out, p.initial_xsec_scaling_factor());
+}
+
+/**
+ * Decode a particle.
+ *
+ * \param[inout] in Position in the record, which is advanced
+ * \return The particle
+ * \throw std::invalid_argument if the particle type is unknown
+ */
+ParticleData get_particle(const char *&in) {
+  const PdgCode pdg = PdgCode::from_decimal(get<std::int32_t>(in));
+  ParticleData p(ParticleType::find(pdg), get<std::int32_t>(in));
+  const auto id_process = get<std::int32_t>(in);
+  const auto n_collisions = get<std::int32_t>(in);
+  p.set_history(n_collisions, id_process, ProcessType::None, 0., {});
+  p.set_belongs_to(static_cast<BelongsTo>(get<char>(in)));
+  std::array<double, 8> x;
+  for (double &value : x) {
+    value = get<double>(in);
+  }
+  p.set_4position(FourVector(x[0], x[1], x[2], x[3]));
+  p.set_4momentum(FourVector(x[4], x[5], x[6], x[7]));
+  const double begin_formation_time = get<double>(in);
+  p.set_slow_formation_times(begin_formation_time, get<double>(in));
+  p.set_cross_section_scaling_factor(get<double>(in));
+  return p;
+}
+}  // namespace
+
+CollisionTrace::CollisionTrace(const std::filesystem::path &path,
+                               double formation_power,
+                               bool use_monash_tune_default)
+    : file_(path, std::ios::binary) {
+  if (!file_) {
+    throw std::runtime_error("Could not write the collision trace to " +
+                             path.string());
+  }
+  file_.write(magic_number, sizeof(magic_number));
+  file_.write(reinterpret_cast<const char *>(&format_version),
+              sizeof(format_version));
+  file_.write(reinterpret_cast<const char *>(&formation_power),
+              sizeof(formation_power));
+  file_.put(use_monash_tune_default);
+  buffer_.reserve(flush_size + record_size);
+}
+
+CollisionTrace::~CollisionTrace() {
+  try {
+    flush();
+  } catch (const std::runtime_error &) {
+    // Nothing can be done about it while destructing
+  }
+}
+
+void CollisionTrace::add_pair(CollisionCriterion criterion,
+                              const ParticleData &data_a,
+                              const ParticleData &data_b, double dt,
+                              double gcell_vol, double majorant) {
+  append(CollisionTraceRecord::Kind::Pair, criterion, dt, gcell_vol, majorant,
+         data_a, data_b);
+}
+
+void CollisionTrace::add_collision(CollisionCriterion criterion,
+                                   const ParticleData &data_a,
+                                   const ParticleData &data_b,
+                                   double time_until_collision) {
+  append(CollisionTraceRecord::Kind::Collision, criterion,
+         time_until_collision, 0., 1., data_a, data_b);
+}
+
+void CollisionTrace::append(CollisionTraceRecord::Kind kind,
+                            CollisionCriterion criterion, double time,
+                            double gcell_vol, double majorant,
+                            const ParticleData &data_a,
+                            const ParticleData &data_b) {
+  // Encoded outside of the lock, which is only taken for the copy
+  std::array<char, record_size> record;
+  char *out = record.data();
+  put<char>(out, static_cast<char>(kind));
+  put<char>(out, static_cast<char>(criterion));
+  put<double>(out, time);
+  put<double>(out, gcell_vol);
+  put<double>(out, majorant);
+  put_particle(out, data_a);
+  put_particle(out, data_b);
+  std::lock_guard<std::mutex> lock(mutex_);
+  buffer_.insert(buffer_.end(), record.begin(), record.end());
+  if (buffer_.size() >= flush_size) {
+    file_.write(buffer_.data(), buffer_.size());
+    buffer_.clear();
+  }
+}
+
+void CollisionTrace::flush() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  file_.write(buffer_.data(), buffer_.size());
+  file_.flush();
+  buffer_.clear();
+  if (!file_) {
+    throw std::runtime_error("Could not write the collision trace.");
+  }
+}
+
+CollisionTraceContent read_collision_trace(const std::filesystem::path &path) {
+  std::ifstream file(path, std::ios::binary);
+  if (!file) {
+    throw std::runtime_error("Could not read the collision trace " +
+                             path.string());
+  }
+  const std::string bytes((std::istreambuf_iterator<char>(file)),
+                          std::istreambuf_iterator<char>());
+  constexpr std::size_t header_size =
+      sizeof(magic_number) + sizeof(std::uint32_t) + sizeof(double) + 1;
+  if (bytes.size() < header_size ||
+      bytes.compare(0, sizeof(magic_number), magic_number,
+                    sizeof(magic_number)) != 0) {
+    throw std::runtime_error(path.string() + " is no collision trace.");
+  }
+  const char *in = bytes.data() + sizeof(magic_number);
+  if (get<std::uint32_t>(in) != CollisionTrace::format_version) {
+    throw std::runtime_error("The collision trace " + path.string() +
+                             " has an unsupported format version.");
+  }
+  CollisionTraceContent content;
+  content.formation_power = get<double>(in);
+  content.use_monash_tune_default = get<char>(in);
+  if ((bytes.size() - header_size) % record_size != 0) {
+    throw std::runtime_error("The collision trace " + path.string() +
+                             " is truncated.");
+  }
+  content.records.resize((bytes.size() - header_size) / record_size);
+  for (CollisionTraceRecord &record : content.records) {
+    record.kind = static_cast<CollisionTraceRecord::Kind>(get<char>(in));
+    record.criterion = static_cast<CollisionCriterion>(get<char>(in));
+    record.time = get<double>(in);
+    record.gcell_vol = get<double>(in);
+    record.majorant = get<double>(in);
+    record.incoming.push_back(get_particle(in));
+    record.incoming.push_back(get_particle(in));
+  }
+  return content;
+}
+
+}  // namespace smash
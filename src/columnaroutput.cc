@@ -0,0 +1,283 @@
+/*
+ *
+ *    Copyright (c) 2024
+ *      SMASH Team
+ *
+ *    GNU General Public License (GPLv3 or later)
+ *
+ */
+
+#include "smash/columnaroutput.h"
+
+#include <cstdio>
+#include <cstring>
+#include <iterator>
+
+#include "smash/config.h"
+#include "smash/numeric_cast.h"
+#include "smash/particles.h"
+
+namespace smash {
+
+/*!\Userguide
+ * \page doxypage_output_columnar
+ * The columnar particles output is written to `particles_columnar.bin` for
+ * analyses which only need a few quantities of the particles, e.g. the PDG
+ * codes and the momenta. Like in the \ref doxypage_output_binary, 4 bytes
+ * signed integers, 8 bytes doubles and 1 byte chars are used, strings are
+ * preceded by their length as 4 bytes unsigned integer and all numbers are
+ * written in the byte order of the machine. Offsets are 8 bytes unsigned
+ * integers.
+ *
+ * The file starts with a header:
+ * \code
+ * 4*char        uint16_t        uint32_t  len*char
+ * magic_number, format_version, len,      smash_version
+ * uint32_t   then n_columns times: uint32_t  len*char  char
+ * n_columns,                       len,      name,     type
+ * \endcode
+ * - \c magic_number - 4 bytes, that in ASCII read as "SMCL".
+ * - \c format_version - version of the columnar format, currently 3.
+ * - \c type - 'd' for a column of doubles, 'f' for 4 bytes floats, 'i' for
+ *   4 bytes integers.
+ *
+ * The columns are t, x, y, z, mass, p0, px, py, pz (doubles) and pdg, ID,
+ * charge (integers). With the \key Extended option the columns ncoll,
+ * form_time, xsecfac, proc_id_origin, proc_type_origin, time_last_coll,
+ * pdg_mother1, pdg_mother2, baryon_number and strangeness follow with the same
+ * meaning as in the \ref doxypage_output_oscar_particles "OSCAR output". With
+ * the \key Single_Precision option, the columns of doubles are written as
+ * floats instead, which halves their size.
+ *
+ * Every particle list, i.e. the initial, intermediate and final particles of
+ * an event, is written as chunk:
+ * \code
+ * char  int32_t       double  double            double
+ * kind, event_number, time,   impact_parameter, event_weight,
+ * char         uint32_t
+ * empty_event, n_particles
+ * \endcode
+ * where \c kind is 'i' for the initial, 'm' for intermediate and 'f' for the
+ * final particles. The \c event_weight is 1 unless the impact parameter is
+ * sampled with weights, see \ref key_MC_impact_weighted_. The header of the
+ * chunk is followed by the columns in the order of the file header, each with
+ * the values of all \c n_particles particles. The \key Only_Final option
+ * decides which lists are written like for the other particles outputs.
+ *
+ * At the end of the file an index of all chunks follows:
+ * \code
+ * n_chunks times: uint64_t  char  int32_t       double  uint32_t
+ *                 offset,   kind, event_number, time,   n_particles
+ * uint32_t  uint64_t       4*char
+ * n_chunks, index_offset,  magic_number
+ * \endcode
+ * The \c offset of a chunk is the position of its header in the file. A
+ * reader finds the index by reading the last 16 bytes of the file and can
+ * then seek to the column it needs in any chunk, since the size of each column
+ * is known from its type and the number of particles.
+ */
+
+namespace {
+/// Column of the particle lists
+struct Column {
+  /// Name in the file header
+  const char *name;
+  /// Value of a particle for a column of doubles
+  double (*real)(const ParticleData &);
+  /// Value of a particle for a column of integers
+  std::int32_t (*integer)(const ParticleData &);
+};
+
+/// Columns, which are always written
+const Column base_columns[] = {
+    {"t", [](const ParticleData &p) { return p.position().x0(); }, nullptr},
+    {"x", [](const ParticleData &p) { return p.position().x1(); }, nullptr},
+    {"y", [](const ParticleData &p) { return p.position().x2(); }, nullptr},
+    {"z", [](const ParticleData &p) { return p.position().x3(); }, nullptr},
+    {"mass", [](const ParticleData &p) { return p.effective_mass(); },
+     nullptr},
+    {"p0", [](const ParticleData &p) { return p.momentum().x0(); }, nullptr},
+    {"px", [](const ParticleData &p) { return p.momentum().x1(); }, nullptr},
+    {"py", [](const ParticleData &p) { return p.momentum().x2(); }, nullptr},
+    {"pz", [](const ParticleData &p) { return p.momentum().x3(); }, nullptr},
+    {"pdg", nullptr,
+     [](const ParticleData &p) -> std::int32_t {
+       return p.pdgcode().get_decimal();
+     }},
+    {"ID", nullptr,
+     [](const ParticleData &p) -> std::int32_t { return p.id(); }},
+    {"charge", nullptr,
+     [](const ParticleData &p) -> std::int32_t { return p.type().charge(); }}};
+
+/// Columns, which are written in addition for the extended output
+const Column extended_columns[] = {
+    {"ncoll", nullptr,
+     [](const ParticleData &p) -> std::int32_t {
+       return p.get_history().collisions_per_particle;
+     }},
+    {"form_time", [](const ParticleData &p) { return p.formation_time(); },
+     nullptr},
+    {"xsecfac", [](const ParticleData &p) { return p.xsec_scaling_factor(); },
+     nullptr},
+    {"proc_id_origin", nullptr,
+     [](const ParticleData &p) -> std::int32_t {
+       return p.get_history().id_process;
+     }},
+    {"proc_type_origin", nullptr,
+     [](const ParticleData &p) {
+       return static_cast<std::int32_t>(p.get_history().process_type);
+     }},
+    {"time_last_coll",
+     [](const ParticleData &p) { return p.get_history().time_last_collision; },
+     nullptr},
+    {"pdg_mother1", nullptr,
+     [](const ParticleData &p) -> std::int32_t {
+       return p.get_history().p1.get_decimal();
+     }},
+    {"pdg_mother2", nullptr,
+     [](const ParticleData &p) -> std::int32_t {
+       return p.get_history().p2.get_decimal();
+     }},
+    {"baryon_number", nullptr,
+     [](const ParticleData &p) -> std::int32_t {
+       return p.type().baryon_number();
+     }},
+    {"strangeness", nullptr,
+     [](const ParticleData &p) -> std::int32_t {
+       return p.type().strangeness();
+     }}};
+
+/**
+ * Append the values of a column for all particles to a buffer.
+ *
+ * \tparam T Type of the values
+ * \tparam Stored Type of the written values, to which the values are
+ *         converted
+ * \param[in] particles Particle list
+ * \param[in] value Value of a particle
+ * \param[inout] buffer Buffer, to which the values are appended
+ */
+template <typename T, typename Stored = T>
+void append_column(const Particles &particles, T (*value)(const ParticleData &),
+                   std::vector<char> &buffer) {
+  std::size_t position = buffer.size();
+  buffer.resize(position + particles.size() * sizeof(Stored));
+  for (const ParticleData &p : particles) {
+    const Stored v = static_cast<Stored>(value(p));
+    std::memcpy(buffer.data() + position, &v, sizeof(Stored));
+    position += sizeof(Stored);
+  }
+}
+}  // namespace
+
+ColumnarOutput::ColumnarOutput(const std::filesystem::path &path,
+                               std::string name,
+                               const OutputParameters &out_par)
+    : OutputInterface(name),
+      file_{path / "particles_columnar.bin", "wb"},
+      extended_(out_par.part_extended),
+      single_precision_(out_par.part_single_precision),
+      only_final_(out_par.part_only_final) {
+  write_bytes("SMCL", 4);
+  write(format_version);
+  write(std::string(SMASH_VERSION));
+  const std::uint32_t n_columns =
+      std::size(base_columns) + (extended_ ? std::size(extended_columns) : 0);
+  write(n_columns);
+  auto write_columns = [this](const auto &columns) {
+    for (const Column &column : columns) {
+      write(std::string(column.name));
+      write(column.real ? (single_precision_ ? 'f' : 'd') : 'i');
+    }
+  };
+  write_columns(base_columns);
+  if (extended_) {
+    write_columns(extended_columns);
+  }
+}
+
+ColumnarOutput::~ColumnarOutput() {
+  const std::uint64_t index_offset = position_;
+  for (const Chunk &chunk : chunks_) {
+    write(chunk.offset);
+    write(chunk.kind);
+    write(chunk.event_number);
+    write(chunk.time);
+    write(chunk.n_particles);
+  }
+  write(numeric_cast<std::uint32_t>(chunks_.size()));
+  write(index_offset);
+  write_bytes("SMCL", 4);
+}
+
+void ColumnarOutput::at_eventstart(const Particles &particles,
+                                   const int event_number,
+                                   const EventInfo &event) {
+  event_number_ = event_number;
+  if (only_final_ == OutputOnlyFinal::No) {
+    write_chunk('i', particles, event_number, event);
+  }
+}
+
+void ColumnarOutput::at_eventend(const Particles &particles,
+                                 const int event_number,
+                                 const EventInfo &event) {
+  if (!(event.empty_event && only_final_ == OutputOnlyFinal::IfNotEmpty)) {
+    write_chunk('f', particles, event_number, event);
+  }
+  std::fflush(file_.get());
+}
+
+void ColumnarOutput::at_intermediate_time(const Particles &particles,
+                                          const std::unique_ptr<Clock> &,
+                                          const DensityParameters &,
+                                          const EventInfo &event) {
+  if (only_final_ == OutputOnlyFinal::No) {
+    write_chunk('m', particles, event_number_, event);
+  }
+}
+
+void ColumnarOutput::write_chunk(char kind, const Particles &particles,
+                                 int event_number, const EventInfo &event) {
+  const Chunk chunk{position_, kind, event_number, event.current_time,
+                    numeric_cast<std::uint32_t>(particles.size())};
+  chunks_.push_back(chunk);
+  write(kind);
+  write<std::int32_t>(event_number);
+  write(chunk.time);
+  write(event.impact_parameter);
+  write(event.event_weight);
+  write<char>(event.empty_event);
+  write(chunk.n_particles);
+
+  // The columns are put together first and then written at once.
+  buffer_.clear();
+  auto append_columns = [&](const auto &columns) {
+    for (const Column &column : columns) {
+      if (column.real && single_precision_) {
+        append_column<double, float>(particles, column.real, buffer_);
+      } else if (column.real) {
+        append_column(particles, column.real, buffer_);
+      } else {
+        append_column(particles, column.integer, buffer_);
+      }
+    }
+  };
+  append_columns(base_columns);
+  if (extended_) {
+    append_columns(extended_columns);
+  }
+  write_bytes(buffer_.data(), buffer_.size());
+}
+
+void ColumnarOutput::write_bytes(const void *data, std::size_t size) {
+  std::fwrite(data, size, 1, file_.get());
+  position_ += size;
+}
+
+void ColumnarOutput::write(const std::string &s) {
+  write(numeric_cast<std::uint32_t>(s.size()));
+  write_bytes(s.c_str(), s.size());
+}
+
+}  // namespace smash
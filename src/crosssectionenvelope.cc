@@ -0,0 +1,131 @@
+/*
+ *
+ *    Copyright (c) 2024
+ *      SMASH Team
+ *
+ *    GNU General Public License (GPLv3 or later)
+ *
+ */
+
+#include "smash/crosssectionenvelope.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <memory>
+#include <utility>
+
+#include "smash/kinematics.h"
+#include "smash/particledata.h"
+#include "smash/particletype.h"
+
+namespace smash {
+
+namespace {
+/**
+ * Relative deviation of the mass from the pole mass, up to which a stable
+ * particle is considered to be on its mass shell.
+ */
+constexpr double mass_shell_tolerance = 1e-6;
+
+/**
+ * \param[in] p Particle
+ * \return whether the mass of the particle is its pole mass
+ */
+bool on_mass_shell(const ParticleData &p) {
+  return std::abs(p.effective_mass() - p.pole_mass()) <=
+         mass_shell_tolerance * p.pole_mass();
+}
+}  // namespace
+
+CrossSectionEnvelope::CrossSectionEnvelope(ExactCrossSection exact)
+    : exact_(std::move(exact)) {
+  const ParticleTypeList &types = ParticleType::list_all();
+  stable_index_.reserve(types.size());
+  for (const ParticleType &type : types) {
+    if (type.is_stable()) {
+      stable_index_.push_back(static_cast<int>(n_stable_++));
+    } else {
+      stable_index_.push_back(-1);
+      poles_.push_back(type.mass());
+    }
+  }
+  std::sort(poles_.begin(), poles_.end());
+  poles_.erase(std::unique(poles_.begin(), poles_.end()), poles_.end());
+  tables_ = std::make_unique<std::atomic<const Table *>[]>(n_stable_ *
+                                                           n_stable_);
+  for (std::size_t i = 0; i < n_stable_ * n_stable_; i++) {
+    tables_[i].store(nullptr, std::memory_order_relaxed);
+  }
+}
+
+CrossSectionEnvelope::~CrossSectionEnvelope() {
+  for (std::size_t i = 0; i < n_stable_ * n_stable_; i++) {
+    delete tables_[i].load(std::memory_order_relaxed);
+  }
+}
+
+double CrossSectionEnvelope::max_cross_section(const ParticleData &a,
+                                               const ParticleData &b,
+                                               double sqrt_s) const {
+  constexpr double unbounded = std::numeric_limits<double>::infinity();
+  const ParticleType *first = std::addressof(ParticleType::list_all()[0]);
+  const int index_a = stable_index_[std::addressof(a.type()) - first];
+  const int index_b = stable_index_[std::addressof(b.type()) - first];
+  if (index_a < 0 || index_b < 0 || !on_mass_shell(a) || !on_mass_shell(b)) {
+    return unbounded;
+  }
+  std::atomic<const Table *> &slot = tables_[index_a * n_stable_ + index_b];
+  const Table *table = slot.load(std::memory_order_acquire);
+  if (table == nullptr) {
+    std::unique_ptr<Table> created = tabulate(a.type(), b.type());
+    // Another thread may have been faster, then its identical table is used
+    if (slot.compare_exchange_strong(table, created.get(),
+                                     std::memory_order_acq_rel)) {
+      table = created.release();
+    }
+  }
+  const double bin = (sqrt_s - table->threshold) / bin_width;
+  if (!(bin >= 0.) || bin >= static_cast<double>(n_bins)) {
+    return unbounded;
+  }
+  return table->max_xs[static_cast<std::size_t>(bin)];
+}
+
+std::unique_ptr<CrossSectionEnvelope::Table> CrossSectionEnvelope::tabulate(
+    const ParticleType &type_a, const ParticleType &type_b) const {
+  auto table = std::make_unique<Table>();
+  const double m_a = type_a.mass(), m_b = type_b.mass();
+  table->threshold = m_a + m_b;
+  ParticleData a{type_a}, b{type_b};
+  auto exact = [&](double sqrt_s) {
+    const double p = pCM(sqrt_s, m_a, m_b);
+    a.set_4momentum(m_a, 0., 0., p);
+    b.set_4momentum(m_b, 0., 0., -p);
+    return exact_(a, b);
+  };
+
+  table->max_xs.resize(n_bins);
+  table->max_xs[0] = std::numeric_limits<double>::infinity();
+  double lower_edge = exact(table->threshold + bin_width);
+  auto pole = std::upper_bound(poles_.begin(), poles_.end(),
+                               table->threshold + bin_width);
+  for (std::size_t i = 1; i < n_bins; i++) {
+    const double upper = table->threshold + (i + 1) * bin_width;
+    const double upper_edge = exact(upper);
+    double max_xs = std::max(lower_edge, upper_edge);
+    bool finite = std::isfinite(lower_edge) && std::isfinite(upper_edge);
+    for (; pole != poles_.end() && *pole < upper; ++pole) {
+      const double at_pole = exact(*pole);
+      max_xs = std::max(max_xs, at_pole);
+      finite = finite && std::isfinite(at_pole);
+    }
+    // Diverging or undefined cross sections are not bounded
+    table->max_xs[i] = finite ? safety_factor * max_xs
+                              : std::numeric_limits<double>::infinity();
+    lower_edge = upper_edge;
+  }
+  return table;
+}
+
+}  // namespace smash
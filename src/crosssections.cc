@@ -9,6 +9,11 @@
 
 #include "smash/crosssections.h"
 
+#include <algorithm>
+#include <map>
+#include <shared_mutex>
+#include <tuple>
+
 #include "smash/clebschgordan.h"
 #include "smash/constants.h"
 #include "smash/logging.h"
@@ -202,23 +207,174 @@ CollisionBranchList CrossSections::generate_collision_list(
   return process_list;
 }
 
+double CrossSections::sum_of_collision_list(
+    const ScatterActionsFinderParameters& finder_parameters,
+    StringProcess* string_process) const {
+  /* The sums follow generate_collision_list: the total only contains the
+   * positive cross sections, like the sum of partial cross sections of a
+   * ScatterAction, while all of them enter the sums computed there. */
+  double total = 0., listed = 0.;
+  auto add = [&](double xs) {
+    listed += xs;
+    if (xs > 0.) {
+      total += xs;
+    }
+  };
+  auto add_list = [&](const CollisionBranchList& list, double weight) {
+    for (const CollisionBranchPtr& proc : list) {
+      add(proc->weight() * weight);
+    }
+  };
+  const ParticleType& t1 = incoming_particles_[0].type();
+  const ParticleType& t2 = incoming_particles_[1].type();
+
+  double p_pythia = 0.;
+  if (finder_parameters.strings_with_probability) {
+    p_pythia = string_probability(finder_parameters);
+  }
+
+  const bool reject_by_nucleon_elastic_cutoff =
+      t1.is_nucleon() && t2.is_nucleon() &&
+      t1.antiparticle_sign() == t2.antiparticle_sign() &&
+      sqrt_s_ < finder_parameters.low_snn_cut;
+  bool incl_elastic =
+      finder_parameters.included_2to2[IncludedReactions::Elastic];
+  if (incl_elastic && !reject_by_nucleon_elastic_cutoff) {
+    add(elastic_cross_section(finder_parameters));
+  }
+  if (p_pythia > 0.) {
+    const double sig_string = std::max(
+        0., finder_parameters.scale_xs *
+                    high_energy(finder_parameters.transition_high_energy) -
+                listed);
+    add_list(string_excitation(sig_string, string_process,
+                               finder_parameters.use_AQM),
+             p_pythia);
+    add_list(rare_two_to_two(), p_pythia * finder_parameters.scale_xs);
+  }
+  if (p_pythia < 1.) {
+    if (finder_parameters.two_to_one) {
+      const double weight = (1. - p_pythia) * finder_parameters.scale_xs;
+      find_resonances([&](const ParticleType&, double resonance_xsection) {
+        add(resonance_xsection * weight);
+      });
+    }
+    if (finder_parameters.included_2to2.any()) {
+      add_list(two_to_two(finder_parameters.included_2to2,
+                          finder_parameters.transition_high_energy.KN_offset),
+               (1. - p_pythia) * finder_parameters.scale_xs);
+    }
+    if (finder_parameters
+            .included_multi[IncludedMultiParticleReactions::Deuteron_3to2] ==
+        1) {
+      add_list(two_to_three(), (1. - p_pythia) * finder_parameters.scale_xs);
+    }
+    if (finder_parameters
+            .included_multi[IncludedMultiParticleReactions::A3_Nuclei_4to2] ==
+        1) {
+      add_list(two_to_four(), (1. - p_pythia) * finder_parameters.scale_xs);
+    }
+  }
+  if (finder_parameters.nnbar_treatment == NNbarTreatment::TwoToFive &&
+      is_NNbar_pair_) {
+    add(NNbar_to_5pi(finder_parameters.scale_xs)->weight());
+  }
+  if (finder_parameters.nnbar_treatment == NNbarTreatment::Resonances) {
+    if (is_NNbar_pair_) {
+      add(NNbar_annihilation(listed, finder_parameters.scale_xs)->weight());
+    } else {
+      add_list(NNbar_creation(), finder_parameters.scale_xs);
+    }
+  }
+  return total;
+}
+
 double CrossSections::parametrized_total(
     const ScatterActionsFinderParameters& finder_parameters) const {
-  const PdgCode& pdg_a = incoming_particles_[0].type().pdgcode();
-  const PdgCode& pdg_b = incoming_particles_[1].type().pdgcode();
-  double total_xs = 0.;
-  if (pdg_a.is_baryon() && pdg_b.is_baryon() &&
-      sqrt_s_ > finder_parameters.low_snn_cut) {
+  double total_xs;
+  parametrized_total(incoming_particles_[0].type().pdgcode(),
+                     incoming_particles_[1].type().pdgcode(), &sqrt_s_, 1,
+                     &total_xs, finder_parameters);
+  return total_xs;
+}
+
+/// A parametrization evaluated for several arguments at once
+using BatchParametrization = void (*)(const double*, std::size_t, double*);
+
+/**
+ * Evaluate a parametrization of Mandelstam s for several center-of-mass
+ * energies. The squares are gathered on the stack in chunks, such that no
+ * memory is allocated.
+ *
+ * \param[in] parametrization Parametrization of Mandelstam s
+ * \param[in] sqrts Center-of-mass energies [GeV]
+ * \param[in] n Number of energies
+ * \param[out] xs Cross sections [mb]
+ * \param[in] min_sqrts Energies up to this one are not evaluated, but get a
+ *            vanishing cross section [GeV]
+ */
+static void evaluate_of_s(BatchParametrization parametrization,
+                          const double* sqrts, std::size_t n, double* xs,
+                          double min_sqrts = -1.) {
+  constexpr std::size_t chunk = 64;
+  double s[chunk], values[chunk];
+  std::size_t index[chunk];
+  std::size_t m = 0;
+  auto flush = [&]() {
+    parametrization(s, m, values);
+    for (std::size_t j = 0; j < m; j++) {
+      xs[index[j]] = values[j];
+    }
+    m = 0;
+  };
+  for (std::size_t i = 0; i < n; i++) {
+    if (sqrts[i] > min_sqrts) {
+      s[m] = sqrts[i] * sqrts[i];
+      index[m++] = i;
+      if (m == chunk) {
+        flush();
+      }
+    } else {
+      xs[i] = 0.;
+    }
+  }
+  flush();
+}
+
+/**
+ * Multiply cross sections by a factor.
+ *
+ * \param[in] factor Factor
+ * \param[in] n Number of cross sections
+ * \param[inout] xs Cross sections [mb]
+ */
+static void scale(double factor, std::size_t n, double* xs) {
+  for (std::size_t i = 0; i < n; i++) {
+    xs[i] *= factor;
+  }
+}
+
+void CrossSections::parametrized_total(
+    const PdgCode& pdg_a, const PdgCode& pdg_b, const double* sqrts,
+    std::size_t n, double* xs,
+    const ScatterActionsFinderParameters& finder_parameters) {
+  const double strange_factor =
+      (1 - 0.4 * pdg_a.frac_strange()) * (1 - 0.4 * pdg_b.frac_strange());
+  std::fill(xs, xs + n, 0.);
+  if (pdg_a.is_baryon() && pdg_b.is_baryon()) {
+    const double cut = finder_parameters.low_snn_cut;
     if (pdg_a.antiparticle_sign() == pdg_b.antiparticle_sign()) {
       // NN
-      total_xs = (pdg_a == pdg_b) ? pp_total(sqrt_s_ * sqrt_s_)
-                                  : np_total(sqrt_s_ * sqrt_s_);
+      if (pdg_a == pdg_b) {
+        evaluate_of_s(pp_total, sqrts, n, xs, cut);
+      } else {
+        evaluate_of_s(np_total, sqrts, n, xs, cut);
+      }
     } else {
       // NNbar
-      total_xs = ppbar_total(sqrt_s_ * sqrt_s_);
+      evaluate_of_s(ppbar_total, sqrts, n, xs, cut);
     }
-    total_xs *=
-        (1 - 0.4 * pdg_a.frac_strange()) * (1 - 0.4 * pdg_b.frac_strange());
+    scale(strange_factor, n, xs);
   } else if ((pdg_a.is_baryon() && pdg_b.is_meson()) ||
              (pdg_a.is_meson() && pdg_b.is_baryon())) {
     const PdgCode& meson = pdg_a.is_meson() ? pdg_a : pdg_b;
@@ -229,25 +385,25 @@ double CrossSections::parametrized_total(
           (meson.code() == pdg::K_m && baryon.code() == -pdg::p) ||
           (meson.code() == pdg::Kbar_z && baryon.code() == -pdg::n)) {
         // K⁺p, K⁰n, and anti-processes
-        total_xs = kplusp_total(sqrt_s_ * sqrt_s_);
+        evaluate_of_s(kplusp_total, sqrts, n, xs);
       } else if ((meson.code() == pdg::K_p && baryon.code() == -pdg::p) ||
                  (meson.code() == pdg::K_z && baryon.code() == -pdg::n) ||
                  (meson.code() == pdg::K_m && baryon.code() == pdg::p) ||
                  (meson.code() == pdg::Kbar_z && baryon.code() == pdg::n)) {
         // K⁻p, K̅⁰n, and anti-processes
-        total_xs = kminusp_total(sqrt_s_ * sqrt_s_);
+        evaluate_of_s(kminusp_total, sqrts, n, xs);
       } else if ((meson.code() == pdg::K_p && baryon.code() == pdg::n) ||
                  (meson.code() == pdg::K_z && baryon.code() == pdg::p) ||
                  (meson.code() == pdg::K_m && baryon.code() == -pdg::n) ||
                  (meson.code() == pdg::Kbar_z && baryon.code() == -pdg::p)) {
         // K⁺n, K⁰p, and anti-processes
-        total_xs = kplusn_total(sqrt_s_ * sqrt_s_);
+        evaluate_of_s(kplusn_total, sqrts, n, xs);
       } else if ((meson.code() == pdg::K_p && baryon.code() == -pdg::n) ||
                  (meson.code() == pdg::K_z && baryon.code() == -pdg::p) ||
                  (meson.code() == pdg::K_m && baryon.code() == pdg::n) ||
                  (meson.code() == pdg::Kbar_z && baryon.code() == pdg::p)) {
         // K⁻n, K̅⁰p and anti-processes
-        total_xs = kminusn_total(sqrt_s_ * sqrt_s_);
+        evaluate_of_s(kminusn_total, sqrts, n, xs);
       }
     } else if (meson.is_pion() && baryon.is_nucleon()) {
       // π⁺(p,nbar), π⁻(n,pbar)
@@ -255,56 +411,73 @@ double CrossSections::parametrized_total(
            (baryon.code() == pdg::p || baryon.code() == -pdg::n)) ||
           (meson.code() == pdg::pi_m &&
            (baryon.code() == pdg::n || baryon.code() == -pdg::p))) {
-        total_xs = piplusp_total(sqrt_s_);
+        piplusp_total(sqrts, n, xs);
       } else if (meson.code() == pdg::pi_z) {
         // π⁰N
-        total_xs = 0.5 * (piplusp_total(sqrt_s_) + piminusp_total(sqrt_s_));
+        constexpr std::size_t chunk = 64;
+        double piminusp[chunk];
+        piplusp_total(sqrts, n, xs);
+        for (std::size_t first = 0; first < n; first += chunk) {
+          const std::size_t m = std::min(chunk, n - first);
+          piminusp_total(sqrts + first, m, piminusp);
+          for (std::size_t i = 0; i < m; i++) {
+            xs[first + i] = 0.5 * (xs[first + i] + piminusp[i]);
+          }
+        }
       } else {
         // π⁻(p,nbar), π⁺(n,pbar)
-        total_xs = piminusp_total(sqrt_s_);
+        piminusp_total(sqrts, n, xs);
       }
     } else {
       // M*+B* goes to AQM high energy π⁻p
-      total_xs = piminusp_high_energy(sqrt_s_ * sqrt_s_) *
-                 (1 - 0.4 * pdg_a.frac_strange()) *
-                 (1 - 0.4 * pdg_b.frac_strange());
+      evaluate_of_s(piminusp_high_energy, sqrts, n, xs);
+      scale(strange_factor, n, xs);
     }
   } else if (pdg_a.is_meson() && pdg_b.is_meson()) {
     if (pdg_a.is_pion() && pdg_b.is_pion()) {
       switch (pdg_a.isospin3() * pdg_b.isospin3() / 4) {
         // π⁺π⁻
         case -1:
-          total_xs = pipluspiminus_total(sqrt_s_);
+          pipluspiminus_total(sqrts, n, xs);
           break;
         case 0:
           // π⁰π⁰
           if (pdg_a.isospin3() + pdg_b.isospin3() == 0) {
-            total_xs = pizeropizero_total(sqrt_s_);
+            pizeropizero_total(sqrts, n, xs);
           } else {
             // π⁺π⁰: similar to π⁺π⁻
-            total_xs = pipluspiminus_total(sqrt_s_);
+            pipluspiminus_total(sqrts, n, xs);
           }
           break;
         // π⁺π⁺ goes to π⁻p AQM
         case 1:
-          total_xs = (2. / 3.) * piminusp_high_energy(sqrt_s_ * sqrt_s_);
+          evaluate_of_s(piminusp_high_energy, sqrts, n, xs);
+          scale(2. / 3., n, xs);
           break;
         default:
           throw std::runtime_error("wrong isospin in ππ scattering");
       }
     } else {
       // M*+M* goes to AQM high energy π⁻p
-      total_xs = (2. / 3.) * piminusp_high_energy(sqrt_s_ * sqrt_s_) *
-                 (1 - 0.4 * pdg_a.frac_strange()) *
-                 (1 - 0.4 * pdg_b.frac_strange());
+      evaluate_of_s(piminusp_high_energy, sqrts, n, xs);
+      scale((2. / 3.) * strange_factor, n, xs);
     }
   }
-  return (total_xs + finder_parameters.additional_el_xs) *
-         finder_parameters.scale_xs;
+  for (std::size_t i = 0; i < n; i++) {
+    xs[i] = (xs[i] + finder_parameters.additional_el_xs) *
+            finder_parameters.scale_xs;
+  }
 }
 
 CollisionBranchPtr CrossSections::elastic(
     const ScatterActionsFinderParameters& finder_parameters) const {
+  return std::make_unique<CollisionBranch>(
+      incoming_particles_[0].type(), incoming_particles_[1].type(),
+      elastic_cross_section(finder_parameters), ProcessType::Elastic);
+}
+
+double CrossSections::elastic_cross_section(
+    const ScatterActionsFinderParameters& finder_parameters) const {
   double elastic_xs = 0.;
   if (finder_parameters.elastic_parameter >= 0.) {
     // use constant elastic cross section from config file
@@ -318,11 +491,8 @@ CollisionBranchPtr CrossSections::elastic(
   /* when using a factor to scale the cross section and an additional
    * contribution to the elastic cross section, the contribution is added first
    * and then everything is scaled */
-  return std::make_unique<CollisionBranch>(
-      incoming_particles_[0].type(), incoming_particles_[1].type(),
-      (elastic_xs + finder_parameters.additional_el_xs) *
-          finder_parameters.scale_xs,
-      ProcessType::Elastic);
+  return (elastic_xs + finder_parameters.additional_el_xs) *
+         finder_parameters.scale_xs;
 }
 
 CollisionBranchList CrossSections::rare_two_to_two() const {
@@ -840,6 +1010,16 @@ double CrossSections::nk_el() const {
 
 CollisionBranchList CrossSections::two_to_one() const {
   CollisionBranchList resonance_process_list;
+  find_resonances([&](const ParticleType& type_resonance,
+                      double resonance_xsection) {
+    resonance_process_list.push_back(std::make_unique<CollisionBranch>(
+        type_resonance, resonance_xsection, ProcessType::TwoToOne));
+  });
+  return resonance_process_list;
+}
+
+template <typename Found>
+void CrossSections::find_resonances(Found&& found) const {
   const ParticleType& type_particle_a = incoming_particles_[0].type();
   const ParticleType& type_particle_b = incoming_particles_[1].type();
 
@@ -847,54 +1027,60 @@ CollisionBranchList CrossSections::two_to_one() const {
   const double m2 = incoming_particles_[1].effective_mass();
   const double p_cm_sqr = pCM_sqr(sqrt_s_, m1, m2);
 
-  ParticleTypePtrList possible_resonances =
-      list_possible_resonances(&type_particle_a, &type_particle_b);
-
   // Find all the possible resonances
-  for (const ParticleTypePtr type_resonance : possible_resonances) {
-    double resonance_xsection = formation(*type_resonance, p_cm_sqr);
+  for (const ResonanceFormation& resonance :
+       resonance_formations(type_particle_a, type_particle_b)) {
+    if (sqrt_s_ <= resonance.threshold) {
+      continue;
+    }
+    const ParticleType& type_resonance = *resonance.resonance;
+    double resonance_xsection = formation(resonance, p_cm_sqr);
 
     // If cross section is non-negligible, add resonance to the list
     if (resonance_xsection > really_small) {
-      resonance_process_list.push_back(std::make_unique<CollisionBranch>(
-          *type_resonance, resonance_xsection, ProcessType::TwoToOne));
-      logg[LCrossSections].debug("Found resonance: ", *type_resonance);
-      logg[LCrossSections].debug(type_particle_a.name(), type_particle_b.name(),
-                                 "->", type_resonance->name(),
-                                 " at sqrt(s)[GeV] = ", sqrt_s_,
-                                 " with xs[mb] = ", resonance_xsection);
+      found(type_resonance, resonance_xsection);
+      SMASH_LOG_DEBUG(LCrossSections, "Found resonance: ", type_resonance);
+      SMASH_LOG_DEBUG(LCrossSections, type_particle_a.name(),
+                      type_particle_b.name(), "->", type_resonance.name(),
+                      " at sqrt(s)[GeV] = ", sqrt_s_,
+                      " with xs[mb] = ", resonance_xsection);
     }
   }
-  return resonance_process_list;
 }
 
 double CrossSections::formation(const ParticleType& type_resonance,
                                 double cm_momentum_sqr) const {
-  const ParticleType& type_particle_a = incoming_particles_[0].type();
-  const ParticleType& type_particle_b = incoming_particles_[1].type();
+  for (const ResonanceFormation& resonance :
+       resonance_formations(incoming_particles_[0].type(),
+                            incoming_particles_[1].type())) {
+    if (resonance.resonance == &type_resonance) {
+      return formation(resonance, cm_momentum_sqr);
+    }
+  }
+  return 0.;
+}
+
+double CrossSections::formation(const ResonanceFormation& resonance,
+                                double cm_momentum_sqr) const {
+  const ParticleType& type_resonance = *resonance.resonance;
 
   // Calculate partial in-width.
-  const double partial_width = type_resonance.get_partial_in_width(
-      sqrt_s_, incoming_particles_[0], incoming_particles_[1]);
+  const double m1 = incoming_particles_[0].effective_mass();
+  const double m2 = incoming_particles_[1].effective_mass();
+  double partial_width = 0.;
+  for (std::size_t i = 0; i < resonance.n_channels; i++) {
+    const FormationChannel& channel = resonance.channels[i];
+    partial_width += channel.type->in_width(
+        type_resonance.mass(), channel.width_at_pole, sqrt_s_, m1, m2);
+  }
   if (partial_width <= 0.) {
     return 0.;
   }
 
-  assert(type_resonance.charge() ==
-         type_particle_a.charge() + type_particle_b.charge());
-  assert(type_resonance.baryon_number() ==
-         type_particle_a.baryon_number() + type_particle_b.baryon_number());
-
-  // Calculate spin factor
-  const double spinfactor =
-      static_cast<double>(type_resonance.spin() + 1) /
-      ((type_particle_a.spin() + 1) * (type_particle_b.spin() + 1));
-  const int sym_factor =
-      (type_particle_a.pdgcode() == type_particle_b.pdgcode()) ? 2 : 1;
   /** Calculate resonance production cross section
    * using the Breit-Wigner distribution as probability amplitude.
    * See Eq. (176) in \iref{Buss:2011mx}. */
-  return spinfactor * sym_factor * 2. * M_PI * M_PI / cm_momentum_sqr *
+  return resonance.spin_factor * 2. * M_PI * M_PI / cm_momentum_sqr *
          type_resonance.spectral_function(sqrt_s_) * partial_width * hbarc *
          hbarc / fm2_mb;
 }
@@ -1183,19 +1369,14 @@ CollisionBranchList CrossSections::nn_xx(
 
   /* Find whether colliding particles are nucleons or anti-nucleons;
    * adjust lists of produced particles. */
+  const ParticleType& type_a = incoming_particles_[0].type();
+  const ParticleType& type_b = incoming_particles_[1].type();
   bool both_antinucleons =
-      (incoming_particles_[0].type().antiparticle_sign() == -1) &&
-      (incoming_particles_[1].type().antiparticle_sign() == -1);
-  const ParticleTypePtrList& nuc_or_anti_nuc =
-      both_antinucleons ? ParticleType::list_anti_nucleons()
-                        : ParticleType::list_nucleons();
-  const ParticleTypePtrList& delta_or_anti_delta =
-      both_antinucleons ? ParticleType::list_anti_Deltas()
-                        : ParticleType::list_Deltas();
+      (type_a.antiparticle_sign() == -1) && (type_b.antiparticle_sign() == -1);
   // Find N N → N R channels.
   if (included_2to2[IncludedReactions::NN_to_NR] == 1) {
-    channel_list = find_nn_xsection_from_type(
-        ParticleType::list_baryon_resonances(), nuc_or_anti_nuc,
+    channel_list = nn_xsections_from_channels(
+        cached_nn_channels(type_a, type_b, false),
         [&sqrts](const ParticleType& type_res_1, const ParticleType&) {
           return type_res_1.iso_multiplet()->get_integral_NR(sqrts);
         });
@@ -1207,8 +1388,8 @@ CollisionBranchList CrossSections::nn_xx(
 
   // Find N N → Δ R channels.
   if (included_2to2[IncludedReactions::NN_to_DR] == 1) {
-    channel_list = find_nn_xsection_from_type(
-        ParticleType::list_baryon_resonances(), delta_or_anti_delta,
+    channel_list = nn_xsections_from_channels(
+        cached_nn_channels(type_a, type_b, true),
         [&sqrts](const ParticleType& type_res_1,
                  const ParticleType& type_res_2) {
           return type_res_1.iso_multiplet()->get_integral_RR(
@@ -2510,7 +2691,8 @@ CollisionBranchList CrossSections::string_excitation(
    * collision this is not an issue, but at sqrt_s < 10 GeV it may
    * matter. */
   std::array<double, 3> xs =
-      string_process->cross_sections_diffractive(pdgid[0], pdgid[1], sqrt_s_);
+      string_process->for_this_thread().cross_sections_diffractive(
+          pdgid[0], pdgid[1], sqrt_s_);
   if (use_AQM) {
     for (int ip = 0; ip < 3; ip++) {
       xs[ip] *= AQM_factor;
@@ -2898,12 +3080,17 @@ CollisionBranchList CrossSections::find_nn_xsection_from_type(
     const ParticleTypePtrList& list_res_1,
     const ParticleTypePtrList& list_res_2,
     const IntegrationMethod integrator) const {
-  const ParticleType& type_particle_a = incoming_particles_[0].type();
-  const ParticleType& type_particle_b = incoming_particles_[1].type();
-
-  CollisionBranchList channel_list;
-  const double s = sqrt_s_ * sqrt_s_;
+  return nn_xsections_from_channels(
+      find_nn_channels(incoming_particles_[0].type(),
+                       incoming_particles_[1].type(), list_res_1, list_res_2),
+      integrator);
+}
 
+std::vector<CrossSections::NNChannel> CrossSections::find_nn_channels(
+    const ParticleType& type_particle_a, const ParticleType& type_particle_b,
+    const ParticleTypePtrList& list_res_1,
+    const ParticleTypePtrList& list_res_2) {
+  std::vector<NNChannel> channels;
   // Loop over specified first resonance list
   for (ParticleTypePtr type_res_1 : list_res_1) {
     // Loop over specified second resonance list
@@ -2922,47 +3109,94 @@ CollisionBranchList CrossSections::find_nn_xsection_from_type(
         if (std::abs(isospin_factor) < really_small) {
           continue;
         }
+        const double spin_factor =
+            (type_res_1->spin() + 1) * (type_res_2->spin() + 1);
+        channels.push_back(
+            {type_res_1, type_res_2, twoI, isospin_factor * spin_factor});
+      }
+    }
+  }
+  return channels;
+}
 
-        // Integration limits.
-        const double lower_limit = type_res_1->min_mass_kinematic();
-        const double upper_limit = sqrt_s_ - type_res_2->mass();
-        /* Check the available energy (requiring it to be a little above the
-         * threshold, because the integration will not work if it's too close).
-         */
-        if (upper_limit - lower_limit < 1E-3) {
-          continue;
-        }
+const std::vector<CrossSections::NNChannel>& CrossSections::cached_nn_channels(
+    const ParticleType& type_a, const ParticleType& type_b, bool delta) {
+  /* The particle types never change once they are created, so the channels
+   * are kept until the end of the program. Collisions are searched
+   * concurrently, hence the cache is guarded. */
+  static std::shared_mutex mutex;
+  static std::map<std::tuple<PdgCode, PdgCode, bool>, std::vector<NNChannel>>
+      cache;
+  const auto key = std::make_tuple(type_a.pdgcode(), type_b.pdgcode(), delta);
+  {
+    std::shared_lock<std::shared_mutex> lock(mutex);
+    const auto found = cache.find(key);
+    if (found != cache.end()) {
+      return found->second;
+    }
+  }
+  const bool antinucleons =
+      type_a.antiparticle_sign() == -1 && type_b.antiparticle_sign() == -1;
+  const ParticleTypePtrList& list_res_2 =
+      delta ? (antinucleons ? ParticleType::list_anti_Deltas()
+                            : ParticleType::list_Deltas())
+            : (antinucleons ? ParticleType::list_anti_nucleons()
+                            : ParticleType::list_nucleons());
+  std::vector<NNChannel> channels = find_nn_channels(
+      type_a, type_b, ParticleType::list_baryon_resonances(), list_res_2);
+  std::unique_lock<std::shared_mutex> lock(mutex);
+  // Map elements stay in place, even if other threads insert meanwhile
+  return cache.emplace(key, std::move(channels)).first->second;
+}
 
-        // Calculate matrix element.
-        const double matrix_element = nn_to_resonance_matrix_element(
-            sqrt_s_, *type_res_1, *type_res_2, twoI);
-        if (matrix_element <= 0.) {
-          continue;
-        }
+template <class IntegrationMethod>
+CollisionBranchList CrossSections::nn_xsections_from_channels(
+    const std::vector<NNChannel>& channels,
+    const IntegrationMethod integrator) const {
+  const ParticleType& type_particle_a = incoming_particles_[0].type();
+  const ParticleType& type_particle_b = incoming_particles_[1].type();
 
-        /* Calculate resonance production cross section
-         * using the Breit-Wigner distribution as probability amplitude.
-         * Integrate over the allowed resonance mass range. */
-        const double resonance_integral = integrator(*type_res_1, *type_res_2);
+  CollisionBranchList channel_list;
+  const double s = sqrt_s_ * sqrt_s_;
 
-        /** Cross section for 2->2 process with 1/2 resonance(s) in final state.
-         * Based on Eq. (46) in \iref{Weil:2013mya} and Eq. (3.29) in
-         * \iref{Bass:1998ca} */
-        const double spin_factor =
-            (type_res_1->spin() + 1) * (type_res_2->spin() + 1);
-        const double xsection = isospin_factor * spin_factor * matrix_element *
-                                resonance_integral / (s * cm_momentum());
+  for (const NNChannel& channel : channels) {
+    const ParticleType& type_res_1 = *channel.type_res_1;
+    const ParticleType& type_res_2 = *channel.type_res_2;
+    // Integration limits.
+    const double lower_limit = type_res_1.min_mass_kinematic();
+    const double upper_limit = sqrt_s_ - type_res_2.mass();
+    /* Check the available energy (requiring it to be a little above the
+     * threshold, because the integration will not work if it's too close).
+     */
+    if (upper_limit - lower_limit < 1E-3) {
+      continue;
+    }
 
-        if (xsection > really_small) {
-          channel_list.push_back(std::make_unique<CollisionBranch>(
-              *type_res_1, *type_res_2, xsection, ProcessType::TwoToTwo));
-          logg[LCrossSections].debug(
-              "Found 2->2 creation process for resonance ", type_res_1, ", ",
-              type_res_2);
-          logg[LCrossSections].debug("2->2 with original particles: ",
-                                     type_particle_a, type_particle_b);
-        }
-      }
+    // Calculate matrix element.
+    const double matrix_element = nn_to_resonance_matrix_element(
+        sqrt_s_, type_res_1, type_res_2, channel.twoI);
+    if (matrix_element <= 0.) {
+      continue;
+    }
+
+    /* Calculate resonance production cross section
+     * using the Breit-Wigner distribution as probability amplitude.
+     * Integrate over the allowed resonance mass range. */
+    const double resonance_integral = integrator(type_res_1, type_res_2);
+
+    /** Cross section for 2->2 process with 1/2 resonance(s) in final state.
+     * Based on Eq. (46) in \iref{Weil:2013mya} and Eq. (3.29) in
+     * \iref{Bass:1998ca} */
+    const double xsection = channel.factor * matrix_element *
+                            resonance_integral / (s * cm_momentum());
+
+    if (xsection > really_small) {
+      channel_list.push_back(std::make_unique<CollisionBranch>(
+          type_res_1, type_res_2, xsection, ProcessType::TwoToTwo));
+      logg[LCrossSections].debug("Found 2->2 creation process for resonance ",
+                                 type_res_1, ", ", type_res_2);
+      logg[LCrossSections].debug("2->2 with original particles: ",
+                                 type_particle_a, type_particle_b);
     }
   }
   return channel_list;
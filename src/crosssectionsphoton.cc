@@ -9,9 +9,18 @@
 
 #include "smash/crosssectionsphoton.h"
 
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <iterator>
 #include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
 
 #include "smash/logging.h"
+#include "smash/tabulation.h"
+#include "smash/threadpool.h"
 
 namespace {
 
@@ -8791,4 +8800,407 @@ double CrosssectionsPhoton<ComputationMethod::Analytic>::xs_diff_pi_pi0_rho(
   return cut_off(gev2_mb * diff_xs / spin_deg_factor);
 }
 
+/*----------------------------------------------------------------------------*/
+/*                                       Tabulated cross sections (Lookup)    */
+/*----------------------------------------------------------------------------*/
+
+namespace {
+/// Analytic cross sections, which are tabulated
+using Analytic = CrosssectionsPhoton<ComputationMethod::Analytic>;
+
+/// Photon channel with its analytic cross sections
+struct PhotonChannel {
+  /// Name, which identifies the cached tables
+  const char *name;
+  /// Whether the rho meson is incoming, otherwise it is outgoing
+  bool rho_incoming;
+  /// Whether an omega meson is exchanged in the s-channel
+  bool omega_s_channel;
+  /// Total cross section
+  double (*total)(double s, double m_rho);
+  /// Differential cross section
+  double (*diff)(double s, double t, double m_rho);
+};
+
+/// Indices of the tabulated channels
+enum PhotonChannelIndex : std::size_t {
+  PiPiRho0,
+  PiPi0Rho,
+  Pi0Rho0Pi0,
+  PiRho0Pi,
+  PiRhoPi0RhoMediated,
+  PiRhoPi0OmegaMediated,
+  Pi0RhoPiRhoMediated,
+  Pi0RhoPiOmegaMediated,
+  NumberOfPhotonChannels
+};
+
+/// All tabulated channels, in the order of their indices
+const std::array<PhotonChannel, NumberOfPhotonChannels> photon_channels = {{
+    {"pi_pi_rho0", false, false, &Analytic::xs_pi_pi_rho0,
+     &Analytic::xs_diff_pi_pi_rho0},
+    {"pi_pi0_rho", false, false, &Analytic::xs_pi_pi0_rho,
+     &Analytic::xs_diff_pi_pi0_rho},
+    {"pi0_rho0_pi0", true, true, &Analytic::xs_pi0_rho0_pi0,
+     &Analytic::xs_diff_pi0_rho0_pi0},
+    {"pi_rho0_pi", true, false, &Analytic::xs_pi_rho0_pi,
+     &Analytic::xs_diff_pi_rho0_pi},
+    {"pi_rho_pi0_rho_mediated", true, false,
+     &Analytic::xs_pi_rho_pi0_rho_mediated,
+     &Analytic::xs_diff_pi_rho_pi0_rho_mediated},
+    {"pi_rho_pi0_omega_mediated", true, false,
+     &Analytic::xs_pi_rho_pi0_omega_mediated,
+     &Analytic::xs_diff_pi_rho_pi0_omega_mediated},
+    {"pi0_rho_pi_rho_mediated", true, false,
+     &Analytic::xs_pi0_rho_pi_rho_mediated,
+     &Analytic::xs_diff_pi0_rho_pi_rho_mediated},
+    {"pi0_rho_pi_omega_mediated", true, false,
+     &Analytic::xs_pi0_rho_pi_omega_mediated,
+     &Analytic::xs_diff_pi0_rho_pi_omega_mediated},
+}};
+
+/// Smallest tabulated rho mass [GeV]
+constexpr double table_m_rho_min = 0.27;
+/// Range of the tabulated rho masses [GeV]
+constexpr double table_m_rho_range = 1.2;
+/// Smallest tabulated excess of sqrt(s) above the threshold [GeV]
+constexpr double table_excess_min = 0.02;
+/// Range of the tabulated excess of sqrt(s) above the threshold [GeV]
+constexpr double table_excess_range = 2.5;
+/**
+ * Distance of sqrt(s) from the omega mass, within which cross sections with an
+ * omega meson in the s-channel are not interpolated across its pole [GeV]
+ */
+constexpr double omega_pole_window = 0.05;
+/// Number of intervals of the rho mass for the total cross sections
+constexpr std::size_t total_n_m_rho = 120;
+/// Number of intervals of sqrt(s) for the total cross sections
+constexpr std::size_t total_n_sqrts = 1000;
+/// Number of intervals of the rho mass for the differential cross sections
+constexpr std::size_t diff_n_m_rho = 60;
+/// Number of intervals of sqrt(s) for the differential cross sections
+constexpr std::size_t diff_n_sqrts = 250;
+/// Number of intervals of t for the differential cross sections
+constexpr std::size_t diff_n_t = 30;
+
+/// Tables of a channel
+struct PhotonTables {
+  /// Total cross section, one row in sqrt(s) for each rho mass
+  std::vector<Tabulation> total;
+  /**
+   * Differential cross section, one row in sqrt(s) for each rho mass and
+   * relative position in the t range, with the latter running fastest
+   */
+  std::vector<Tabulation> diff;
+};
+
+/// Tables of all channels, which are empty until they are tabulated
+std::array<PhotonTables, NumberOfPhotonChannels> photon_tables;
+
+/**
+ * \param[in] channel Photon channel
+ * \param[in] m_rho Mass of the rho meson [GeV]
+ * \return Threshold of sqrt(s), from which the tables start [GeV]
+ */
+double threshold(const PhotonChannel &channel, double m_rho) {
+  return channel.rho_incoming ? pion_mass + m_rho
+                              : std::max(2 * pion_mass, m_rho);
+}
+
+/**
+ * \param[in] channel Photon channel
+ * \param[in] sqrts Center-of-mass energy [GeV]
+ * \param[in] m_rho Mass of the rho meson [GeV]
+ * \return Range of t as used by the analytic formulas, the smaller value
+ *         first [GeV^2]
+ */
+std::array<double, 2> t_range(const PhotonChannel &channel, double sqrts,
+                              double m_rho) {
+  const std::array<double, 2> t =
+      channel.rho_incoming
+          ? get_t_range(sqrts, pion_mass, m_rho, pion_mass, 0.)
+          : get_t_range(sqrts, pion_mass, pion_mass, m_rho, 0.);
+  return {t[1], t[0]};
+}
+
+/**
+ * The grid of the differential cross sections is uniform in a variable v,
+ * which maps to the relative position in the t range such that the grid is
+ * denser towards its ends, where the cross sections are peaked.
+ *
+ * \param[in] v Grid variable between 0 and 1
+ * \return Relative position in the t range between 0 and 1
+ */
+double t_position(double v) { return 0.5 * (1. - std::cos(M_PI * v)); }
+
+/**
+ * \param[in] channel Photon channel
+ * \param[in] sqrts Center-of-mass energy [GeV]
+ * \param[in] m_rho Mass of the rho meson [GeV]
+ * \return whether the tables of the channel are used at this point
+ */
+bool in_table_range(const PhotonChannel &channel, double sqrts, double m_rho) {
+  const double excess = sqrts - threshold(channel, m_rho);
+  return excess >= table_excess_min &&
+         excess <= table_excess_min + table_excess_range &&
+         !(channel.omega_s_channel &&
+           std::abs(sqrts - omega_mass) < omega_pole_window);
+}
+
+/**
+ * \param[in] n Number of intervals of the rho mass
+ * \param[in] j Index of the rho mass
+ * \return Rho mass [GeV]
+ */
+double grid_m_rho(std::size_t n, std::size_t j) {
+  return table_m_rho_min + table_m_rho_range * j / n;
+}
+
+/**
+ * Tabulate both cross sections of a channel.
+ *
+ * \param[in] channel Photon channel
+ * \return Tables of the channel
+ */
+PhotonTables compute_tables(const PhotonChannel &channel) {
+  PhotonTables tables;
+  tables.total.reserve(total_n_m_rho + 1);
+  for (std::size_t j = 0; j <= total_n_m_rho; j++) {
+    const double m_rho = grid_m_rho(total_n_m_rho, j);
+    const double sqrts_threshold = threshold(channel, m_rho);
+    tables.total.emplace_back(table_excess_min, table_excess_range,
+                              total_n_sqrts, [&](double excess) {
+                                const double sqrts = sqrts_threshold + excess;
+                                return channel.total(sqrts * sqrts, m_rho);
+                              });
+  }
+  tables.diff.reserve((diff_n_m_rho + 1) * (diff_n_t + 1));
+  for (std::size_t j = 0; j <= diff_n_m_rho; j++) {
+    const double m_rho = grid_m_rho(diff_n_m_rho, j);
+    const double sqrts_threshold = threshold(channel, m_rho);
+    for (std::size_t k = 0; k <= diff_n_t; k++) {
+      const double u = t_position(static_cast<double>(k) / diff_n_t);
+      tables.diff.emplace_back(
+          table_excess_min, table_excess_range, diff_n_sqrts,
+          [&](double excess) {
+            const double sqrts = sqrts_threshold + excess;
+            const std::array<double, 2> t = t_range(channel, sqrts, m_rho);
+            return channel.diff(sqrts * sqrts, t[0] + u * (t[1] - t[0]),
+                                m_rho);
+          });
+    }
+  }
+  return tables;
+}
+
+/**
+ * Interpolate the total cross section of a channel.
+ *
+ * \param[in] index Index of the channel
+ * \param[in] s Mandelstam-s [GeV^2]
+ * \param[in] m_rho Mass of the rho meson [GeV]
+ * \return Cross section [mb]
+ */
+double lookup_total(PhotonChannelIndex index, double s, double m_rho) {
+  const PhotonChannel &channel = photon_channels[index];
+  const std::vector<Tabulation> &rows = photon_tables[index].total;
+  const double x = (m_rho - table_m_rho_min) / table_m_rho_range *
+                   total_n_m_rho;
+  const double sqrts = std::sqrt(s);
+  if (rows.empty() || !(x >= 0.) || x >= total_n_m_rho ||
+      !in_table_range(channel, sqrts, m_rho)) {
+    return channel.total(s, m_rho);
+  }
+  const double excess = sqrts - threshold(channel, m_rho);
+  const std::size_t j = static_cast<std::size_t>(x);
+  const double f = x - j;
+  // The rows are compared at the same excess above their thresholds
+  const double xs = (1. - f) * rows[j].get_value_linear(excess) +
+                    f * rows[j + 1].get_value_linear(excess);
+  return std::isfinite(xs) ? xs : channel.total(s, m_rho);
+}
+
+/**
+ * Interpolate the differential cross section of a channel.
+ *
+ * \param[in] index Index of the channel
+ * \param[in] s Mandelstam-s [GeV^2]
+ * \param[in] t Mandelstam-t [GeV^2]
+ * \param[in] m_rho Mass of the rho meson [GeV]
+ * \return Cross section [mb/GeV^2]
+ */
+double lookup_diff(PhotonChannelIndex index, double s, double t,
+                   double m_rho) {
+  const PhotonChannel &channel = photon_channels[index];
+  const std::vector<Tabulation> &rows = photon_tables[index].diff;
+  const double x = (m_rho - table_m_rho_min) / table_m_rho_range *
+                   diff_n_m_rho;
+  const double sqrts = std::sqrt(s);
+  if (rows.empty() || !(x >= 0.) || x >= diff_n_m_rho ||
+      !in_table_range(channel, sqrts, m_rho)) {
+    return channel.diff(s, t, m_rho);
+  }
+  const double excess = sqrts - threshold(channel, m_rho);
+  const std::array<double, 2> range = t_range(channel, sqrts, m_rho);
+  const double u = (t - range[0]) / (range[1] - range[0]);
+  if (!(u >= 0. && u <= 1.)) {
+    return channel.diff(s, t, m_rho);
+  }
+  const double y = std::acos(1. - 2. * u) * M_1_PI * diff_n_t;
+  const std::size_t j = static_cast<std::size_t>(x);
+  const std::size_t k = std::min(static_cast<std::size_t>(y), diff_n_t - 1);
+  const double f = x - j, g = y - k;
+  auto row = [&](std::size_t jj, std::size_t kk) {
+    return rows[jj * (diff_n_t + 1) + kk].get_value_linear(excess);
+  };
+  const double xs = (1. - f) * ((1. - g) * row(j, k) + g * row(j, k + 1)) +
+                    f * ((1. - g) * row(j + 1, k) + g * row(j + 1, k + 1));
+  return std::isfinite(xs) ? xs : channel.diff(s, t, m_rho);
+}
+}  // namespace
+
+void CrosssectionsPhoton<ComputationMethod::Lookup>::tabulate(
+    ThreadPool *pool) {
+  // The grid is part of the parameters, such that changed grids are not read
+  std::stringstream grid;
+  grid << table_m_rho_min << table_m_rho_range << table_excess_min
+       << table_excess_range << omega_pole_window << total_n_m_rho
+       << total_n_sqrts << diff_n_m_rho << diff_n_sqrts << diff_n_t;
+  const std::size_t n_total = total_n_m_rho + 1;
+  const std::size_t n_diff = (diff_n_m_rho + 1) * (diff_n_t + 1);
+  auto tabulate_channel = [&](int i) {
+    const PhotonChannel &channel = photon_channels[i];
+    // The rows of the total cross section come first
+    std::vector<Tabulation> rows = TabulationCache::get(
+        "photons_" + std::string(channel.name), grid.str(), [&]() {
+          PhotonTables computed = compute_tables(channel);
+          std::vector<Tabulation> result = std::move(computed.total);
+          std::move(computed.diff.begin(), computed.diff.end(),
+                    std::back_inserter(result));
+          return result;
+        });
+    if (rows.size() != n_total + n_diff) {
+      throw std::runtime_error("Unexpected number of photon tables for " +
+                               std::string(channel.name));
+    }
+    PhotonTables tables;
+    tables.total.assign(std::make_move_iterator(rows.begin()),
+                        std::make_move_iterator(rows.begin() + n_total));
+    tables.diff.assign(std::make_move_iterator(rows.begin() + n_total),
+                       std::make_move_iterator(rows.end()));
+    photon_tables[i] = std::move(tables);
+  };
+  if (pool) {
+    pool->parallel_for(NumberOfPhotonChannels, tabulate_channel);
+  } else {
+    for (std::size_t i = 0; i < NumberOfPhotonChannels; i++) {
+      tabulate_channel(i);
+    }
+  }
+}
+
+bool CrosssectionsPhoton<ComputationMethod::Lookup>::is_tabulated() {
+  return !photon_tables[0].total.empty();
+}
+
+double CrosssectionsPhoton<ComputationMethod::Lookup>::xs_pi_pi_rho0(
+    const double s, const double m_rho) {
+  return lookup_total(PiPiRho0, s, m_rho);
+}
+
+double CrosssectionsPhoton<ComputationMethod::Lookup>::xs_pi_pi0_rho(
+    const double s, const double m_rho) {
+  return lookup_total(PiPi0Rho, s, m_rho);
+}
+
+double CrosssectionsPhoton<ComputationMethod::Lookup>::xs_pi0_rho0_pi0(
+    const double s, const double m_rho) {
+  return lookup_total(Pi0Rho0Pi0, s, m_rho);
+}
+
+double CrosssectionsPhoton<ComputationMethod::Lookup>::xs_pi_rho0_pi(
+    const double s, const double m_rho) {
+  return lookup_total(PiRho0Pi, s, m_rho);
+}
+
+double CrosssectionsPhoton<ComputationMethod::Lookup>::xs_pi_rho_pi0(
+    const double s, const double m_rho) {
+  return cut_off(xs_pi_rho_pi0_rho_mediated(s, m_rho) +
+                 xs_pi_rho_pi0_omega_mediated(s, m_rho));
+}
+
+double
+CrosssectionsPhoton<ComputationMethod::Lookup>::xs_pi_rho_pi0_rho_mediated(
+    const double s, const double m_rho) {
+  return lookup_total(PiRhoPi0RhoMediated, s, m_rho);
+}
+
+double
+CrosssectionsPhoton<ComputationMethod::Lookup>::xs_pi_rho_pi0_omega_mediated(
+    const double s, const double m_rho) {
+  return lookup_total(PiRhoPi0OmegaMediated, s, m_rho);
+}
+
+double CrosssectionsPhoton<ComputationMethod::Lookup>::xs_pi0_rho_pi(
+    const double s, const double m_rho) {
+  return cut_off(xs_pi0_rho_pi_rho_mediated(s, m_rho) +
+                 xs_pi0_rho_pi_omega_mediated(s, m_rho));
+}
+
+double
+CrosssectionsPhoton<ComputationMethod::Lookup>::xs_pi0_rho_pi_rho_mediated(
+    const double s, const double m_rho) {
+  return lookup_total(Pi0RhoPiRhoMediated, s, m_rho);
+}
+
+double
+CrosssectionsPhoton<ComputationMethod::Lookup>::xs_pi0_rho_pi_omega_mediated(
+    const double s, const double m_rho) {
+  return lookup_total(Pi0RhoPiOmegaMediated, s, m_rho);
+}
+
+double CrosssectionsPhoton<ComputationMethod::Lookup>::xs_diff_pi_pi_rho0(
+    const double s, const double t, const double m_rho) {
+  return lookup_diff(PiPiRho0, s, t, m_rho);
+}
+
+double CrosssectionsPhoton<ComputationMethod::Lookup>::xs_diff_pi_pi0_rho(
+    const double s, const double t, const double m_rho) {
+  return lookup_diff(PiPi0Rho, s, t, m_rho);
+}
+
+double CrosssectionsPhoton<ComputationMethod::Lookup>::xs_diff_pi0_rho0_pi0(
+    const double s, const double t, const double m_rho) {
+  return lookup_diff(Pi0Rho0Pi0, s, t, m_rho);
+}
+
+double CrosssectionsPhoton<ComputationMethod::Lookup>::xs_diff_pi_rho0_pi(
+    const double s, const double t, const double m_rho) {
+  return lookup_diff(PiRho0Pi, s, t, m_rho);
+}
+
+double CrosssectionsPhoton<ComputationMethod::Lookup>::
+    xs_diff_pi_rho_pi0_rho_mediated(const double s, const double t,
+                                    const double m_rho) {
+  return lookup_diff(PiRhoPi0RhoMediated, s, t, m_rho);
+}
+
+double CrosssectionsPhoton<ComputationMethod::Lookup>::
+    xs_diff_pi_rho_pi0_omega_mediated(const double s, const double t,
+                                      const double m_rho) {
+  return lookup_diff(PiRhoPi0OmegaMediated, s, t, m_rho);
+}
+
+double CrosssectionsPhoton<ComputationMethod::Lookup>::
+    xs_diff_pi0_rho_pi_rho_mediated(const double s, const double t,
+                                    const double m_rho) {
+  return lookup_diff(Pi0RhoPiRhoMediated, s, t, m_rho);
+}
+
+double CrosssectionsPhoton<ComputationMethod::Lookup>::
+    xs_diff_pi0_rho_pi_omega_mediated(const double s, const double t,
+                                      const double m_rho) {
+  return lookup_diff(Pi0RhoPiOmegaMediated, s, t, m_rho);
+}
+
 }  //  namespace smash
@@ -0,0 +1,160 @@
+/*
+ *
+ *    Copyright (c) 2024
+ *      SMASH Team
+ *
+ *    GNU General Public License (GPLv3 or later)
+ *
+ */
+
+#include "smash/crosssectiontable.h"
+
+#include <cmath>
+#include <memory>
+#include <utility>
+
+#include "smash/kinematics.h"
+#include "smash/particledata.h"
+#include "smash/particletype.h"
+
+namespace smash {
+
+namespace {
+/**
+ * Relative deviation of the mass from the pole mass, up to which a stable
+ * particle is considered to be on its mass shell.
+ */
+constexpr double mass_shell_tolerance = 1e-6;
+
+/**
+ * \param[in] p Particle
+ * \return whether the mass of the particle is its pole mass
+ */
+bool on_mass_shell(const ParticleData &p) {
+  return std::abs(p.effective_mass() - p.pole_mass()) <=
+         mass_shell_tolerance * p.pole_mass();
+}
+
+/**
+ * \param[in] a First branch
+ * \param[in] b Second branch
+ * \return whether both branches lead to the same final state
+ */
+bool same_channel(const CollisionBranch &a, const CollisionBranch &b) {
+  return a.get_type() == b.get_type() &&
+         a.particle_types() == b.particle_types();
+}
+}  // namespace
+
+CrossSectionTable::CrossSectionTable(ExactCollisionList exact)
+    : exact_(std::move(exact)) {
+  const ParticleTypeList &types = ParticleType::list_all();
+  stable_index_.reserve(types.size());
+  for (const ParticleType &type : types) {
+    stable_index_.push_back(type.is_stable() ? static_cast<int>(n_stable_++)
+                                             : -1);
+  }
+  tables_ = std::make_unique<std::atomic<const Table *>[]>(n_stable_ *
+                                                           n_stable_);
+  for (std::size_t i = 0; i < n_stable_ * n_stable_; i++) {
+    tables_[i].store(nullptr, std::memory_order_relaxed);
+  }
+}
+
+CrossSectionTable::~CrossSectionTable() {
+  for (std::size_t i = 0; i < n_stable_ * n_stable_; i++) {
+    const Table *table = tables_[i].load(std::memory_order_relaxed);
+    if (table == nullptr) {
+      continue;
+    }
+    for (std::size_t k = 0; k < n_points; k++) {
+      delete table->points[k].load(std::memory_order_relaxed);
+    }
+    delete table;
+  }
+}
+
+std::optional<CollisionBranchList> CrossSectionTable::collision_list(
+    const ParticleData &a, const ParticleData &b, double sqrt_s) const {
+  const ParticleType *first = std::addressof(ParticleType::list_all()[0]);
+  const int index_a = stable_index_[std::addressof(a.type()) - first];
+  const int index_b = stable_index_[std::addressof(b.type()) - first];
+  if (index_a < 0 || index_b < 0 || !on_mass_shell(a) || !on_mass_shell(b)) {
+    return std::nullopt;
+  }
+  const Table &table = pair_table(a.type(), b.type(), index_a, index_b);
+  // Grid point k lies k + 1 spacings above the threshold
+  const double x = (sqrt_s - table.threshold) / grid_spacing - 1.;
+  if (!(x >= 0.) || x >= static_cast<double>(n_points - 1)) {
+    return std::nullopt;
+  }
+  const std::size_t k = static_cast<std::size_t>(x);
+  const double f = x - k;
+  const CollisionBranchList &lower = point(table, a.type(), b.type(), k);
+  const CollisionBranchList &upper = point(table, a.type(), b.type(), k + 1);
+
+  CollisionBranchList branches;
+  branches.reserve(lower.size());
+  for (std::size_t i = 0; i < lower.size(); i++) {
+    const CollisionBranch &branch = *lower[i];
+    /* The branches are usually in the same order at both points, hence the
+     * search starts at the same position. */
+    double upper_weight = 0.;
+    for (std::size_t n = 0; n < upper.size(); n++) {
+      const CollisionBranch &candidate = *upper[(i + n) % upper.size()];
+      if (same_channel(branch, candidate)) {
+        upper_weight = candidate.weight();
+        break;
+      }
+    }
+    branches.push_back(std::make_unique<CollisionBranch>(
+        branch.particle_types(),
+        (1. - f) * branch.weight() + f * upper_weight, branch.get_type()));
+  }
+  return branches;
+}
+
+const CrossSectionTable::Table &CrossSectionTable::pair_table(
+    const ParticleType &type_a, const ParticleType &type_b, int index_a,
+    int index_b) const {
+  std::atomic<const Table *> &slot = tables_[index_a * n_stable_ + index_b];
+  const Table *table = slot.load(std::memory_order_acquire);
+  if (table == nullptr) {
+    auto created = std::make_unique<Table>();
+    created->threshold = type_a.mass() + type_b.mass();
+    created->points =
+        std::make_unique<std::atomic<const CollisionBranchList *>[]>(n_points);
+    for (std::size_t k = 0; k < n_points; k++) {
+      created->points[k].store(nullptr, std::memory_order_relaxed);
+    }
+    // Another thread may have been faster, then its table is used
+    if (slot.compare_exchange_strong(table, created.get(),
+                                     std::memory_order_acq_rel)) {
+      table = created.release();
+    }
+  }
+  return *table;
+}
+
+const CollisionBranchList &CrossSectionTable::point(
+    const Table &table, const ParticleType &type_a, const ParticleType &type_b,
+    std::size_t k) const {
+  std::atomic<const CollisionBranchList *> &slot = table.points[k];
+  const CollisionBranchList *branches = slot.load(std::memory_order_acquire);
+  if (branches == nullptr) {
+    const double m_a = type_a.mass(), m_b = type_b.mass();
+    const double p = pCM(table.threshold + (k + 1) * grid_spacing, m_a, m_b);
+    ParticleData a{type_a}, b{type_b};
+    a.set_4momentum(m_a, 0., 0., p);
+    b.set_4momentum(m_b, 0., 0., -p);
+    auto created = std::make_unique<CollisionBranchList>(exact_(a, b));
+    // Another thread may have been faster, then its identical branches are used
+    if (slot.compare_exchange_strong(branches, created.get(),
+                                     std::memory_order_acq_rel)) {
+      branches = created.release();
+    }
+  }
+  return *branches;
+}
+
+}  // namespace smash
@@ -1,5 +1,5 @@
 /*
- *    Copyright (c) 2019-2022
+ *    Copyright (c) 2019-2022,2024
  *      SMASH Team
  *
  *    GNU General Public License (GPLv3 or later)
@@ -9,6 +9,8 @@
 #include <cmath>
 #include <fstream>
 #include <map>
+#include <memory>
+#include <sstream>
 #include <string>
 #include <vector>
 
@@ -19,7 +21,7 @@
 namespace smash {
 static constexpr int LCollider = LogArea::Collider::id;
 
-std::unique_ptr<std::ifstream> CustomNucleus::filestream_shared_ = nullptr;
+std::shared_ptr<CustomNucleusFile> CustomNucleus::file_shared_ = nullptr;
 
 CustomNucleus::CustomNucleus(Configuration& config, int testparticles,
                              bool same_file) {
@@ -57,22 +59,21 @@ CustomNucleus::CustomNucleus(Configuration& config, int testparticles,
     number_of_nucleons_ = number_of_protons_ + number_of_neutrons_;
   }
   /*
-   * "if" statement makes sure the streams to the file are initialized
-   * properly.
+   * "if" statement makes sure the list is read only once and shared, if
+   * projectile and target are read from the same file.
    */
   const std::string path =
       file_path(particle_list_file_directory, particle_list_file_name);
-  if (same_file && !filestream_shared_) {
-    filestream_shared_ = std::make_unique<std::ifstream>(path);
-    used_filestream_ = &filestream_shared_;
-  } else if (!same_file) {
-    filestream_ = std::make_unique<std::ifstream>(path);
-    used_filestream_ = &filestream_;
+  if (same_file && file_shared_) {
+    file_ = file_shared_;
   } else {
-    used_filestream_ = &filestream_shared_;
+    file_ = loadfile(path);
+    if (same_file) {
+      file_shared_ = file_;
+    }
   }
 
-  custom_nucleus_ = readfile(**used_filestream_);
+  custom_nucleus_ = readfile(*file_);
   fill_from_list(custom_nucleus_);
   // Inherited from nucleus class (see nucleus.h)
   set_parameters_automatic();
@@ -110,7 +111,7 @@ ThreeVector CustomNucleus::distribute_nucleon() {
    * Therefore this if statement is implemented.
    */
   if (index_ >= custom_nucleus_.size()) {
-    custom_nucleus_ = readfile(**used_filestream_);
+    custom_nucleus_ = readfile(*file_);
     fill_from_list(custom_nucleus_);
   }
   const auto& pos = custom_nucleus_.at(index_);
@@ -159,20 +160,14 @@ std::string CustomNucleus::file_path(const std::string& file_directory,
   }
 }
 
-std::vector<Nucleoncustom> CustomNucleus::readfile(
-    std::ifstream& infile) const {
-  int proton_counter = 0;
-  int neutron_counter = 0;
+std::shared_ptr<CustomNucleusFile> CustomNucleus::loadfile(
+    const std::string& path) {
+  std::ifstream infile(path);
+  auto file = std::make_shared<CustomNucleusFile>();
   std::string line;
-  std::vector<Nucleoncustom> custom_nucleus;
-  // read in only A particles for one nucleus
-  for (int i = 0; i < number_of_nucleons_; ++i) {
-    std::getline(infile, line);
-    // make sure the stream goes back to the beginning when it hits end of file
-    if (infile.eof()) {
-      infile.clear();
-      infile.seekg(0, infile.beg);
-      std::getline(infile, line);
+  while (std::getline(infile, line)) {
+    if (line.find_first_not_of(" \t\r") == std::string::npos) {
+      continue;
     }
     Nucleoncustom nucleon;
     std::istringstream iss(line);
@@ -183,6 +178,29 @@ std::vector<Nucleoncustom> CustomNucleus::readfile(
           "\nCheck if your file has the following format: x y z "
           "spinprojection isospin");
     }
+    file->nucleons.push_back(nucleon);
+  }
+  if (file->nucleons.empty()) {
+    throw std::runtime_error("SMASH could not read any nucleon from " + path +
+                             ".\nCheck if your initial nuclei input file "
+                             "exists and is not empty.");
+  }
+  return file;
+}
+
+std::vector<Nucleoncustom> CustomNucleus::readfile(
+    CustomNucleusFile& file) const {
+  int proton_counter = 0;
+  int neutron_counter = 0;
+  std::vector<Nucleoncustom> custom_nucleus;
+  custom_nucleus.reserve(number_of_nucleons_);
+  // read in only A particles for one nucleus
+  for (int i = 0; i < number_of_nucleons_; ++i) {
+    // make sure the list starts over when its end is reached
+    if (file.position >= file.nucleons.size()) {
+      file.position = 0;
+    }
+    const Nucleoncustom& nucleon = file.nucleons[file.position++];
     if (nucleon.isospin == 1) {
       proton_counter++;
     } else if (nucleon.isospin == 0) {
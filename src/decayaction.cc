@@ -1,6 +1,6 @@
 /*
  *
- *    Copyright (c) 2013-2021
+ *    Copyright (c) 2013-2021,2024
  *      SMASH Team
  *
  *    GNU General Public License (GPLv3 or later)
@@ -27,7 +27,16 @@ void DecayAction::add_decay(DecayBranchPtr p) {
   add_process<DecayBranch>(p, decay_channels_, total_width_);
 }
 
+void DecayAction::generate_final_state_in_advance() {
+  generate_final_state();
+  final_state_generated_ = true;
+}
+
 void DecayAction::generate_final_state() {
+  if (final_state_generated_) {
+    final_state_generated_ = false;
+    return;
+  }
   logg[LDecayModes].debug("Process: Resonance decay. ");
   /* Execute a decay process for the selected particle.
    *
@@ -63,13 +72,15 @@ void DecayAction::generate_final_state() {
           std::to_string(incoming_particles_[0].effective_mass()) + ")");
   }
 
+  // Boost to the computational frame
+  const LorentzBoost to_computational_frame(
+      -total_momentum_of_outgoing_particles().velocity());
   // Set formation time.
   for (auto &p : outgoing_particles_) {
     logg[LDecayModes].debug("particle momenta in lrf ", p);
     // assuming decaying particles are always fully formed
     p.set_formation_time(time_of_execution_);
-    // Boost to the computational frame
-    p.boost_momentum(-total_momentum_of_outgoing_particles().velocity());
+    p.boost_momentum(to_computational_frame);
     logg[LDecayModes].debug("particle momenta in comp ", p);
   }
 }
@@ -1,6 +1,6 @@
 /*
  *
- *    Copyright (c) 2014-2020,2022-2023
+ *    Copyright (c) 2014-2020,2022-2024
  *      SMASH Team
  *
  *    GNU General Public License (GPLv3 or later)
@@ -9,16 +9,20 @@
 
 #include "smash/decayactionsfinder.h"
 
+#include <cmath>
+#include <limits>
+
 #include "smash/constants.h"
 #include "smash/decayaction.h"
 #include "smash/decaymodes.h"
 #include "smash/fourvector.h"
+#include "smash/potential_globals.h"
 #include "smash/random.h"
 
 namespace smash {
 
 ActionList DecayActionsFinder::find_actions_in_cell(
-    const ParticleList &search_list, double dt, const double,
+    const ParticleSpan &search_list, double dt, const double,
     const std::vector<FourVector> &) const {
   ActionList actions;
   /* for short time steps this seems reasonable to expect
@@ -35,36 +39,38 @@ ActionList DecayActionsFinder::find_actions_in_cell(
       continue;
     }
 
-    DecayBranchList processes = p.type().get_partial_widths(
-        p.momentum(), p.position().threevec(), WhichDecaymodes::Hadronic);
-    // total decay width (mass-dependent)
-    const double width = total_weight<DecayBranch>(processes);
-
-    // check if there are any (hadronic) decays
-    if (!(width > 0.0)) {
-      continue;
-    }
-
-    constexpr double one_over_hbarc = 1. / hbarc;
-
-    /* The decay_time is sampled from an exponential distribution.
-     * Even though it may seem suspicious that it is sampled every
-     * timestep, it can be proven that this still overall obeys
-     * the exponential decay law.
-     */
-    double decay_time =
-        res_lifetime_factor_ * random::exponential<double>(
-                                   /* The clock goes slower in the rest
-                                    * frame of the resonance */
-                                   one_over_hbarc * p.inverse_gamma() * width);
-    /* If the particle is not yet formed, shift the decay time by the time it
-     * takes the particle to form */
-    if (p.xsec_scaling_factor() < 1.0) {
-      decay_time += p.formation_time() - p.position().x0();
+    /* Without potentials, the width and the time dilation of a particle
+     * only change with its momentum. Therefore its decay time is sampled
+     * once and stored with the particle, and resampled only after its
+     * momentum changed or a decay at the stored time did not happen. This is
+     * exact, since the decay law has no memory. The total decay width
+     * (mass-dependent) is looked up in the width table, and the partial
+     * widths are only calculated if the particle decays. */
+    const double time = p.position().x0();
+    DecayBranchList processes;
+    if (pot_pointer != nullptr) {
+      processes = p.type().get_partial_widths(
+          p.momentum(), p.position().threevec(), WhichDecaymodes::Hadronic);
+      p.set_decay_time(time + sample_decay_time(
+                                  p, total_weight<DecayBranch>(processes)));
+    } else if (std::isnan(p.decay_time()) || p.decay_time() < time) {
+      p.set_decay_time(
+          time + sample_decay_time(
+                     p, p.type().tabulated_width(p.effective_mass(),
+                                                 WhichDecaymodes::Hadronic)));
     }
+    const double decay_time = p.decay_time() - time;
     if (decay_time < dt) {
       /* => decay_time ∈ [0, dt[
        * => the particle decays in this timestep. */
+      if (pot_pointer == nullptr) {
+        processes = p.type().get_partial_widths(
+            p.momentum(), p.position().threevec(), WhichDecaymodes::Hadronic);
+        if (processes.empty()) {
+          // the interpolated width is finite just below a threshold
+          continue;
+        }
+      }
       auto act = std::make_unique<DecayAction>(p, decay_time);
       act->add_decays(std::move(processes));
       actions.emplace_back(std::move(act));
@@ -73,6 +79,33 @@ ActionList DecayActionsFinder::find_actions_in_cell(
   return actions;
 }
 
+double DecayActionsFinder::sample_decay_time(const ParticleData &p,
+                                             double width) const {
+  // check if there are any (hadronic) decays
+  if (!(width > 0.0)) {
+    return std::numeric_limits<double>::infinity();
+  }
+
+  constexpr double one_over_hbarc = 1. / hbarc;
+
+  /* The decay_time is sampled from an exponential distribution.
+   * Even though it may seem suspicious that it is sampled again when the
+   * momentum changes, it can be proven that this still overall obeys
+   * the exponential decay law.
+   */
+  double decay_time =
+      res_lifetime_factor_ * random::exponential<double>(
+                                 /* The clock goes slower in the rest
+                                  * frame of the resonance */
+                                 one_over_hbarc * p.inverse_gamma() * width);
+  /* If the particle is not yet formed, shift the decay time by the time it
+   * takes the particle to form */
+  if (p.xsec_scaling_factor() < 1.0) {
+    decay_time += p.formation_time() - p.position().x0();
+  }
+  return decay_time;
+}
+
 ActionList DecayActionsFinder::find_final_actions(const Particles &search_list,
                                                   bool /*only_res*/) const {
   ActionList actions;
@@ -1,6 +1,6 @@
 /*
  *
- *    Copyright (c) 2015-2020,2022
+ *    Copyright (c) 2015-2020,2022,2024
  *      SMASH Team
  *
  *    GNU General Public License (GPLv3 or later)
@@ -9,85 +9,128 @@
 
 #include "smash/decayactionsfinderdilepton.h"
 
+#include <algorithm>
+#include <memory>
+#include <utility>
+
 #include "smash/constants.h"
 #include "smash/decayactiondilepton.h"
 #include "smash/decaymodes.h"
 
 namespace smash {
 
-void DecayActionsFinderDilepton::shine(const Particles &search_list,
-                                       OutputInterface *output,
-                                       double dt) const {
-  if (!output->is_dilepton_output()) {
-    return;
+DecayActionsFinderDilepton::DecayActionsFinderDilepton() {
+  const ParticleTypeList &types = ParticleType::list_all();
+  is_emitter_.reserve(types.size());
+  for (const ParticleType &type : types) {
+    const auto &modes = type.decay_modes().decay_mode_list();
+    is_emitter_.push_back(
+        std::any_of(modes.begin(), modes.end(), [](const auto &mode) {
+          return mode->type().is_dilepton_decay();
+        }));
   }
+}
+
+bool DecayActionsFinderDilepton::is_emitter(const ParticleType &type) const {
+  const auto index =
+      std::addressof(type) - std::addressof(ParticleType::list_all()[0]);
+  return is_emitter_[index];
+}
+
+ActionList DecayActionsFinderDilepton::shining_actions(
+    const Particles &search_list, double dt) const {
+  ActionList actions;
   for (const auto &p : search_list) {
-    const auto n_all_modes =
-        p.type()
-            .get_partial_widths(p.momentum(), p.position().threevec(),
-                                WhichDecaymodes::All)
-            .size();
-    if (n_all_modes == 0) {
+    /* If particle is stable, use shining only in find_final_actions and
+     * ignore it here, also unformed resonances cannot decay */
+    if (!is_emitter(p.type()) || p.type().is_stable() ||
+        (p.formation_time() > p.position().x0())) {
       continue;
     }
 
-    const double inv_gamma = p.inverse_gamma();
     DecayBranchList dil_modes = p.type().get_partial_widths(
         p.momentum(), p.position().threevec(), WhichDecaymodes::Dileptons);
-
-    /* If particle can only decay into dileptons or is stable, use shining only
-     * in find_final_actions and ignore them here, also unformed
-     * resonances cannot decay */
-    if (dil_modes.size() == n_all_modes || p.type().is_stable() ||
-        (p.formation_time() > p.position().x0())) {
+    /* If particle can only decay into dileptons, it is treated like a stable
+     * one */
+    if (dil_modes.empty() ||
+        p.type()
+            .get_partial_widths(p.momentum(), p.position().threevec(),
+                                WhichDecaymodes::Hadronic)
+            .empty()) {
       continue;
     }
 
+    const double inv_gamma = p.inverse_gamma();
     for (DecayBranchPtr &mode : dil_modes) {
       // SHINING as described in \iref{Schmidt:2008hm}, chapter 2D
       const double shining_weight = dt * inv_gamma * mode->weight() / hbarc;
 
       if (shining_weight > 0.0) {  // decays that can happen
-        DecayActionDilepton act(p, 0., shining_weight);
-        act.add_decay(std::move(mode));
-        act.generate_final_state();
-        output->at_interaction(act, 0.0);
+        auto act = std::make_unique<DecayActionDilepton>(p, 0., shining_weight);
+        act->add_decay(std::move(mode));
+        act->generate_final_state();
+        actions.emplace_back(std::move(act));
       }
     }
   }
+  return actions;
 }
 
-void DecayActionsFinderDilepton::shine_final(const Particles &search_list,
-                                             OutputInterface *output,
-                                             bool only_res) const {
-  if (!output->is_dilepton_output()) {
-    return;
-  }
+ActionList DecayActionsFinderDilepton::final_shining_actions(
+    const Particles &search_list, bool only_res) const {
+  ActionList actions;
   for (const auto &p : search_list) {
     const ParticleType &t = p.type();
-    if (t.decay_modes().decay_mode_list().empty() ||
-        (only_res && t.is_stable())) {
+    if (!is_emitter(t) || (only_res && t.is_stable())) {
       continue;
     }
 
     DecayBranchList dil_modes = t.get_partial_widths(
         p.momentum(), p.position().threevec(), WhichDecaymodes::Dileptons);
+    if (dil_modes.empty()) {
+      continue;
+    }
 
     // total decay width, also hadronic decays
-    const double width_tot = total_weight<DecayBranch>(t.get_partial_widths(
-        p.momentum(), p.position().threevec(), WhichDecaymodes::All));
+    const double width_tot =
+        total_weight<DecayBranch>(dil_modes) +
+        total_weight<DecayBranch>(t.get_partial_widths(
+            p.momentum(), p.position().threevec(), WhichDecaymodes::Hadronic));
 
     for (DecayBranchPtr &mode : dil_modes) {
       const double shining_weight = mode->weight() / width_tot;
 
       if (shining_weight > 0.0) {  // decays that can happen
-        DecayActionDilepton act(p, 0., shining_weight);
-        act.add_decay(std::move(mode));
-        act.generate_final_state();
-        output->at_interaction(act, 0.0);
+        auto act = std::make_unique<DecayActionDilepton>(p, 0., shining_weight);
+        act->add_decay(std::move(mode));
+        act->generate_final_state();
+        actions.emplace_back(std::move(act));
       }
     }
   }
+  return actions;
+}
+
+void DecayActionsFinderDilepton::shine(const Particles &search_list,
+                                       OutputInterface *output,
+                                       double dt) const {
+  if (!output->is_dilepton_output()) {
+    return;
+  }
+  for (const ActionPtr &act : shining_actions(search_list, dt)) {
+    output->at_interaction(*act, 0.0);
+  }
+}
+
+void DecayActionsFinderDilepton::shine_final(const Particles &search_list,
+                                             OutputInterface *output,
+                                             bool only_res) const {
+  if (!output->is_dilepton_output()) {
+    return;
+  }
+  for (const ActionPtr &act : final_shining_actions(search_list, only_res)) {
+    output->at_interaction(*act, 0.0);
+  }
 }
 
 }  // namespace smash
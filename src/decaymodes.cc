@@ -1,6 +1,6 @@
 /*
  *
- *    Copyright (c) 2014-2020,2022
+ *    Copyright (c) 2014-2020,2022,2024
  *      SMASH Team
  *
  *    GNU General Public License (GPLv3 or later)
@@ -160,7 +160,7 @@ static int min_angular_momentum(int s0, int s1, int s2, int s3) {
   return min_L / 2.;
 }
 
-void DecayModes::load_decaymodes(const std::string &input) {
+std::vector<DecayModes> &DecayModes::create_empty_decaymodes() {
   // create the DecayType vector first, then it outlives the DecayModes vector,
   // which references the DecayType objects.
   static std::vector<DecayTypePtr> decaytypes;
@@ -173,6 +173,11 @@ void DecayModes::load_decaymodes(const std::string &input) {
   decaymodes.clear();  // in case an exception was thrown and should try again
   decaymodes.resize(ParticleType::list_all().size());
   all_decay_modes = &decaymodes;
+  return decaymodes;
+}
+
+void DecayModes::load_decaymodes(const std::string &input) {
+  std::vector<DecayModes> &decaymodes = create_empty_decaymodes();
 
   const IsoParticleType *isotype_mother = nullptr;
   ParticleTypePtrList mother_states;
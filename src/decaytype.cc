@@ -46,6 +46,16 @@ static double integrand_rho_Manley_2res(double sqrts, double m1, double m2,
          t2->spectral_function(m2);
 }
 
+// DecayType
+
+std::string DecayType::tabulation_name(const std::string &prefix) const {
+  std::string name = prefix;
+  for (const ParticleTypePtr type : particle_types_) {
+    name += "_" + type->pdgcode().string();
+  }
+  return name + "_L" + std::to_string(L_);
+}
+
 // TwoBodyDecay
 
 TwoBodyDecay::TwoBodyDecay(ParticleTypePtrList part_types, int l)
@@ -140,7 +150,12 @@ double TwoBodyDecaySemistable::get_Lambda() {
 
 /// Number of tabulation points.
 constexpr size_t num_tab_pts = 200;
-static /*thread_local (see #3075)*/ Integrator integrate;
+/**
+ * Relative tolerance of the adaptive tabulations, which is above the accuracy
+ * of the integrals.
+ */
+constexpr double tab_tolerance = 1e-3;
+static thread_local Integrator integrate;
 
 double TwoBodyDecaySemistable::rho(double mass) const {
   if (tabulation_ == nullptr) {
@@ -151,15 +166,20 @@ double TwoBodyDecaySemistable::rho(double mass) const {
     const double m_stable = particle_types_[0]->mass();
     const double mres_min = res->min_mass_kinematic();
 
-    tabulation_ = std::make_unique<Tabulation>(
-        threshold(), tabulation_interval, num_tab_pts, [&](double sqrts) {
-          const double mres_max = sqrts - m_stable;
-          return integrate(mres_min, mres_max, [&](double m) {
-            return integrand_rho_Manley_1res(sqrts, m, m_stable, res, L_);
-          });
-        });
+    tabulation_ = std::make_unique<AdaptiveTabulation>(TabulationCache::get(
+        tabulation_name("rho_semistable"), [&]() {
+          return AdaptiveTabulation(
+              threshold(), threshold() + tabulation_interval,
+              [&](double sqrts) {
+                const double mres_max = sqrts - m_stable;
+                return integrate(mres_min, mres_max, [&](double m) {
+                  return integrand_rho_Manley_1res(sqrts, m, m_stable, res, L_);
+                });
+              },
+              tab_tolerance);
+        }));
   }
-  return tabulation_->get_value_linear(mass);
+  return tabulation_->get_value(mass);
 }
 
 double TwoBodyDecaySemistable::width(double m0, double G0, double m) const {
@@ -194,7 +214,7 @@ double TwoBodyDecayUnstable::get_Lambda() {
   return 0.6;
 }
 
-static /*thread_local*/ Integrator2d integrate2d(1E7);
+static thread_local Integrator2d integrate2d(1E7);
 
 double TwoBodyDecayUnstable::rho(double mass) const {
   if (tabulation_ == nullptr) {
@@ -207,21 +227,27 @@ double TwoBodyDecayUnstable::rho(double mass) const {
     const double sum_gamma = r1->width_at_pole() + r2->width_at_pole();
     const double tab_interval = std::max(2., 10. * sum_gamma);
 
-    tabulation_ = std::make_unique<Tabulation>(
-        m1_min + m2_min, tab_interval, num_tab_pts, [&](double sqrts) {
-          const double m1_max = sqrts - m2_min;
-          const double m2_max = sqrts - m1_min;
-
-          const double result = integrate2d(m1_min, m1_max, m2_min, m2_max,
-                                            [&](double m1, double m2) {
-                                              return integrand_rho_Manley_2res(
-                                                  sqrts, m1, m2, r1, r2, L_);
-                                            })
-                                    .value();
-          return result;
-        });
+    tabulation_ = std::make_unique<AdaptiveTabulation>(TabulationCache::get(
+        tabulation_name("rho_unstable"), [&]() {
+          return AdaptiveTabulation(
+              m1_min + m2_min, m1_min + m2_min + tab_interval,
+              [&](double sqrts) {
+                const double m1_max = sqrts - m2_min;
+                const double m2_max = sqrts - m1_min;
+
+                const double result =
+                    integrate2d(m1_min, m1_max, m2_min, m2_max,
+                                [&](double m1, double m2) {
+                                  return integrand_rho_Manley_2res(
+                                      sqrts, m1, m2, r1, r2, L_);
+                                })
+                        .value();
+                return result;
+              },
+              tab_tolerance);
+        }));
   }
-  return tabulation_->get_value_linear(mass);
+  return tabulation_->get_value(mass);
 }
 
 double TwoBodyDecayUnstable::width(double m0, double G0, double m) const {
@@ -466,21 +492,27 @@ double ThreeBodyDecayDilepton::width(double, double G0, double m) const {
     // integrate differential width to obtain partial width
     double M0 = mother_->mass();
     double G0tot = mother_->width_at_pole();
-    tabulation_ = std::make_unique<Tabulation>(
-        m_other + 2 * m_l, M0 + 10 * G0tot, num_tab_pts, [&](double m_parent) {
-          const double bottom = 2 * m_l;
-          const double top = m_parent - m_other;
-          if (top < bottom) {  // numerical problems at lower bound
-            return 0.;
-          }
-          return integrate(bottom, top,
-                           [&](double m_dil) {
-                             return diff_width(
-                                 m_parent, m_l, m_dil, m_other,
-                                 particle_types_[non_lepton_position], mother_);
-                           })
-              .value();
-        });
+    tabulation_ = std::make_unique<Tabulation>(TabulationCache::get(
+        tabulation_name("width_dilepton_" + mother_->pdgcode().string()),
+        [&]() {
+          return Tabulation(
+              m_other + 2 * m_l, M0 + 10 * G0tot, num_tab_pts,
+              [&](double m_parent) {
+                const double bottom = 2 * m_l;
+                const double top = m_parent - m_other;
+                if (top < bottom) {  // numerical problems at lower bound
+                  return 0.;
+                }
+                return integrate(bottom, top,
+                                 [&](double m_dil) {
+                                   return diff_width(
+                                       m_parent, m_l, m_dil, m_other,
+                                       particle_types_[non_lepton_position],
+                                       mother_);
+                                 })
+                    .value();
+              });
+        }));
   }
 
   return tabulation_->get_value_linear(m, Extrapolation::Const);
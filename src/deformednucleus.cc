@@ -1,11 +1,13 @@
 /*
- *    Copyright (c) 2014-2022
+ *    Copyright (c) 2014-2022,2024
  *      SMASH Team
  *
  *    GNU General Public License (GPLv3 or later)
  */
 #include "smash/deformednucleus.h"
 
+#include <algorithm>
+#include <array>
 #include <cmath>
 #include <map>
 #include <stdexcept>
@@ -46,15 +48,53 @@ ThreeVector DeformedNucleus::distribute_nucleon() {
       Nucleus::get_nuclear_radius() / Nucleus::get_diffusiveness() +
       Nucleus::get_nuclear_radius() * Nucleus::get_diffusiveness();
 
-  // Sample the distribution.
-  do {
-    a_direction.distribute_isotropically();
-    // sample r**2 dr
-    a_radius = radius_max * std::cbrt(random::canonical());
-  } while (random::canonical() > nucleon_density(a_radius,
-                                                 a_direction.costheta(),
-                                                 a_direction.phi()) /
-                                     Nucleus::get_saturation_density());
+  if (gamma_ != 0.) {
+    // The density depends on phi, sample the distribution by rejection.
+    do {
+      a_direction.distribute_isotropically();
+      // sample r**2 dr
+      a_radius = radius_max * std::cbrt(random::canonical());
+    } while (random::canonical() > nucleon_density(a_radius,
+                                                   a_direction.costheta(),
+                                                   a_direction.phi()) /
+                                       Nucleus::get_saturation_density());
+    return a_direction.threevec() * a_radius;
+  }
+
+  /* Without triaxiality, the density does not depend on phi. Tabulate the
+   * radial distribution for bins in cos(theta) and the distribution of
+   * cos(theta) from their integrals, so that the position is sampled without
+   * rejection. */
+  constexpr std::size_t n_costheta_bins = 100;
+  const std::array<double, 5> parameters{Nucleus::get_nuclear_radius(),
+                                         Nucleus::get_diffusiveness(), beta2_,
+                                         beta3_, beta4_};
+  auto costheta_bin = [](double costheta) {
+    return std::min(
+        static_cast<std::size_t>((costheta + 1.) / 2. * n_costheta_bins),
+        n_costheta_bins - 1);
+  };
+  if (costheta_distribution_.empty() || tabulated_parameters_ != parameters) {
+    constexpr std::size_t n_radial_bins = 1000;
+    radial_distributions_.clear();
+    radial_distributions_.reserve(n_costheta_bins);
+    for (std::size_t k = 0; k < n_costheta_bins; k++) {
+      const double costheta = -1. + (k + 0.5) * 2. / n_costheta_bins;
+      radial_distributions_.emplace_back(
+          0., radius_max, n_radial_bins, [&](double r) {
+            return r * r * nucleon_density_unnormalized(r, costheta, 0.);
+          });
+    }
+    costheta_distribution_ = random::piecewise_constant_dist(
+        -1., 1., n_costheta_bins, [&](double costheta) {
+          return radial_distributions_[costheta_bin(costheta)].integral();
+        });
+    tabulated_parameters_ = parameters;
+  }
+  const double costheta = costheta_distribution_();
+  a_radius = radial_distributions_[costheta_bin(costheta)]();
+  a_direction.set_costheta(costheta);
+  a_direction.set_phi(random::uniform(0., twopi));
 
   // Update (x, y, z) positions.
   return a_direction.threevec() * a_radius;
@@ -287,42 +327,52 @@ double DeformedNucleus::nucleon_density_unnormalized(double r, double cosx,
 
 double DeformedNucleus::integrant_nucleon_density_phi(double r,
                                                       double cosx) const {
-  Integrator integrate;
   // Perform the phi integration. This is needed if the triaxiality coefficient
   // gamma is included, which includes a dependency around the phi axis.
   // Unfortunately the Integrator class does not support 3d integration which is
   // why this intermediate integral is needed. It has been checked that the
-  // integral factorizes.
-  const auto result = integrate(0.0, 2.0 * M_PI, [&](double phi) {
+  // integral factorizes. The density is smooth and periodic in phi, so a
+  // fixed quadrature is accurate and needs no workspace for each of the many
+  // calls by the outer integration.
+  static const GaussLegendre integrate(32);
+  return integrate(0.0, 2.0 * M_PI, [&](double phi) {
     return nucleon_density_unnormalized(r, cosx, phi);
   });
-  return result.value();
 }
 
 double DeformedNucleus::calculate_saturation_density() const {
-  Integrator2d integrate;
-  // Transform integral from (0, oo) to (0, 1) via r = (1 - t) / t.
-  // To prevent overflow, the integration is only performed to t = 0.01 which
-  // corresponds to r = 99fm. Additionally the precision settings in the
-  // Integrator2d scheme are equally important. However both these point affect
-  // the result only after the seventh digit which should not be relevant here.
-  if (gamma_ == 0.0) {
-    const auto result = integrate(0.01, 1, -1, 1, [&](double t, double cosx) {
-      const double r = (1 - t) / t;
-      return twopi * std::pow(r, 2.0) *
-             nucleon_density_unnormalized(r, cosx, 0.0) / std::pow(t, 2.0);
-    });
-    const auto rho0 = number_of_particles() / result.value();
-    return rho0;
-  } else {
-    const auto result = integrate(0.01, 1, -1, 1, [&](double t, double cosx) {
-      const double r = (1 - t) / t;
-      return std::pow(r, 2.0) * integrant_nucleon_density_phi(r, cosx) /
-             std::pow(t, 2.0);
-    });
-    const auto rho0 = number_of_particles() / result.value();
-    return rho0;
-  }
+  const std::vector<double> parameters = {get_nuclear_radius(),
+                                          get_diffusiveness(), beta2_, beta3_,
+                                          beta4_, gamma_};
+  const double integral =
+      density_integral("deformed Woods-Saxon", parameters, [this]() {
+        Integrator2d integrate;
+        // Transform integral from (0, oo) to (0, 1) via r = (1 - t) / t.
+        // To prevent overflow, the integration is only performed to t = 0.01
+        // which corresponds to r = 99fm. Additionally the precision settings
+        // in the Integrator2d scheme are equally important. However both
+        // these point affect the result only after the seventh digit which
+        // should not be relevant here.
+        if (gamma_ == 0.0) {
+          return integrate(0.01, 1, -1, 1, [&](double t, double cosx) {
+                   const double r = (1 - t) / t;
+                   return twopi * std::pow(r, 2.0) *
+                          nucleon_density_unnormalized(r, cosx, 0.0) /
+                          std::pow(t, 2.0);
+                 })
+              .value();
+        } else {
+          return integrate(0.01, 1, -1, 1, [&](double t, double cosx) {
+                   const double r = (1 - t) / t;
+                   return std::pow(r, 2.0) *
+                          integrant_nucleon_density_phi(r, cosx) /
+                          std::pow(t, 2.0);
+                 })
+              .value();
+        }
+      });
+  const auto rho0 = number_of_particles() / integral;
+  return rho0;
 }
 
 }  // namespace smash
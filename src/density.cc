@@ -1,6 +1,6 @@
 /*
  *
- *    Copyright (c) 2013-2022
+ *    Copyright (c) 2013-2022,2024
  *      SMASH Team
  *
  *    GNU General Public License (GPLv3 or later)
@@ -9,11 +9,18 @@
 
 #include "smash/density.h"
 
+#include <memory>
+
 #include "smash/constants.h"
 #include "smash/logging.h"
+#include "smash/particlecelllist.h"
+#include "smash/smearingconvolution.h"
 
 namespace smash {
 
+RateLimitedWarning undefined_smearing_warning(
+    LDensity, "Gaussian smearing undefined for a momentum");
+
 double density_factor(const ParticleType &type, DensityType dens_type) {
   switch (dens_type) {
     case DensityType::Hadron:
@@ -61,6 +68,18 @@ std::pair<double, ThreeVector> unnormalized_smearing_factor(
   return std::make_pair(sf, sf_grad);
 }
 
+/**
+ * \param[in] p A particle
+ * \return The particle
+ */
+static const ParticleData &particle_of(const ParticleData &p) { return p; }
+
+/**
+ * \param[in] p Pointer to a particle
+ * \return The particle
+ */
+static const ParticleData &particle_of(const ParticleData *p) { return *p; }
+
 /// \copydoc smash::current_eckart
 template <typename /*ParticlesContainer*/ T>
 std::tuple<double, FourVector, ThreeVector, ThreeVector, FourVector, FourVector,
@@ -83,7 +102,8 @@ current_eckart_impl(const ThreeVector &r, const T &plist,
    * while the next 3 ones are spacial derivatives. */
   std::array<FourVector, 4> djmu_dxnu;
 
-  for (const auto &p : plist) {
+  for (const auto &entry : plist) {
+    const ParticleData &p = particle_of(entry);
     if (par.only_participants()) {
       // if this conditions holds, the hadron is a spectator
       if (p.get_history().collisions_per_particle == 0) {
@@ -182,6 +202,192 @@ current_eckart(const ThreeVector &r, const Particles &plist,
   return current_eckart_impl(r, plist, par, dens_type, compute_gradient,
                              smearing);
 }
+std::tuple<double, FourVector, ThreeVector, ThreeVector, FourVector, FourVector,
+           FourVector, FourVector>
+current_eckart(const ThreeVector &r, const ParticleCellList &cells,
+               const DensityParameters &par, DensityType dens_type,
+               bool compute_gradient, bool smearing) {
+  if (!smearing) {
+    return current_eckart_impl(r, cells.particles(), par, dens_type,
+                               compute_gradient, smearing);
+  }
+  // reused from call to call by every thread
+  static thread_local std::vector<const ParticleData *> neighbors;
+  cells.find_neighbors(r, neighbors);
+  return current_eckart_impl(r, neighbors, par, dens_type, compute_gradient,
+                             smearing);
+}
+std::tuple<double, FourVector, ThreeVector, ThreeVector, FourVector, FourVector,
+           FourVector, FourVector>
+current_eckart(const ThreeVector &r,
+               const std::vector<const ParticleData *> &plist,
+               const DensityParameters &par, DensityType dens_type,
+               bool compute_gradient, bool smearing) {
+  return current_eckart_impl(r, plist, par, dens_type, compute_gradient,
+                             smearing);
+}
+
+/**
+ * \param[in] lat Lattice to be smeared on
+ * \param[in] par Smearing parameters, with Gaussian or triangular smearing
+ * \return Smearing by Fourier transforms for the geometry of the lattice and
+ *         the kernel given by the parameters
+ */
+static SmearingConvolution &smearing_convolution(
+    const RectangularLattice<DensityOnLattice> &lat,
+    const DensityParameters &par) {
+  const auto key = std::make_tuple(
+      lat.n_cells(), lat.cell_sizes(), lat.origin(), lat.periodic(),
+      par.smearing(), par.r_cut_sqr(), par.two_sig_sqr_inv(),
+      par.norm_factor_sf(), par.triangular_range(), par.ntest(),
+      par.nensembles());
+  // setting up the transforms is costly, so they are kept for the next time
+  static thread_local std::vector<
+      std::pair<decltype(key), std::unique_ptr<SmearingConvolution>>>
+      cache;
+  for (const auto &[cached_key, convolution] : cache) {
+    if (cached_key == key) {
+      return *convolution;
+    }
+  }
+
+  const std::array<double, 3> &cell_sizes = lat.cell_sizes();
+  std::array<int, 3> range;
+  std::function<double(int, int, int)> kernel;
+  if (par.smearing() == SmearingMode::CovariantGaussian) {
+    // the Gaussian of a particle at rest
+    for (int i = 0; i < 3; i++) {
+      range[i] = static_cast<int>(std::ceil(par.r_cut() / cell_sizes[i]));
+    }
+    kernel = [&](int mx, int my, int mz) {
+      const double r_sqr = mx * mx * cell_sizes[0] * cell_sizes[0] +
+                           my * my * cell_sizes[1] * cell_sizes[1] +
+                           mz * mz * cell_sizes[2] * cell_sizes[2];
+      return r_sqr > par.r_cut_sqr()
+                 ? 0.
+                 : par.norm_factor_sf() *
+                       std::exp(-r_sqr * par.two_sig_sqr_inv());
+    };
+  } else if (par.smearing() == SmearingMode::Triangular) {
+    // the triangles of a particle on a node, normalized as in
+    // update_lattices
+    std::array<double, 3> radius;
+    double prefactor = 1.0 / (par.ntest() * par.nensembles());
+    for (int i = 0; i < 3; i++) {
+      radius[i] = par.triangular_range() * cell_sizes[i];
+      range[i] = static_cast<int>(std::ceil(par.triangular_range()));
+      prefactor /= radius[i] * radius[i];
+    }
+    kernel = [&](int mx, int my, int mz) {
+      return prefactor *
+             std::max(0., radius[0] - std::abs(mx) * cell_sizes[0]) *
+             std::max(0., radius[1] - std::abs(my) * cell_sizes[1]) *
+             std::max(0., radius[2] - std::abs(mz) * cell_sizes[2]);
+    };
+  } else {
+    throw std::invalid_argument(
+        "Smearing by Fourier transforms needs Gaussian or triangular "
+        "smearing.");
+  }
+  cache.emplace_back(key, std::make_unique<SmearingConvolution>(
+                              lat.n_cells(), cell_sizes, lat.origin(),
+                              lat.periodic(), range, kernel));
+  return *cache.back().second;
+}
+
+void convolve_density(RectangularLattice<DensityOnLattice> &lat,
+                      DensityType dens_type, const DensityParameters &par,
+                      const ParticlesSoA &particles, bool compute_gradient) {
+  SmearingConvolution &convolution = smearing_convolution(lat, par);
+  convolution.clear();
+  for (std::size_t i = 0; i < particles.size(); i++) {
+    if (par.only_participants() &&
+        particles.particle[i]->get_history().collisions_per_particle == 0) {
+      continue;
+    }
+    const double factor = density_factor(*particles.type[i], dens_type);
+    if (std::abs(factor) < really_small) {
+      continue;
+    }
+    const double e_inv = 1.0 / particles.e[i];
+    convolution.deposit(
+        ThreeVector(particles.x[i], particles.y[i], particles.z[i]),
+        FourVector(1.0, particles.px[i] * e_inv, particles.py[i] * e_inv,
+                   particles.pz[i] * e_inv) *
+            factor);
+  }
+  const bool with_derivatives =
+      compute_gradient &&
+      par.derivatives() == DerivativesMode::FiniteDifference;
+  convolution.convolve(with_derivatives);
+
+  const std::array<int, 3> &n_cells = lat.n_cells();
+  // the convolution reaches every node
+  lat.mark_occupied({0, 0, 0}, n_cells);
+  for (int iz = 0; iz < n_cells[2]; iz++) {
+    for (int iy = 0; iy < n_cells[1]; iy++) {
+      for (int ix = 0; ix < n_cells[0]; ix++) {
+        DensityOnLattice &node = lat[lat.index1d(ix, iy, iz)];
+        node.add_to_jmu_pos(convolution.jmu_pos(ix, iy, iz));
+        node.add_to_jmu_neg(convolution.jmu_neg(ix, iy, iz));
+        if (with_derivatives) {
+          const std::array<FourVector, 3> d = convolution.djmu_dx(ix, iy, iz);
+          node.overwrite_djmu_dxnu(FourVector(), d[0], d[1], d[2]);
+        }
+      }
+    }
+  }
+}
+
+void update_rest_frame_derivatives(RectangularLattice<DensityOnLattice> *lat,
+                                   const LatticeUpdate update,
+                                   const DensityParameters &par) {
+  // Do not proceed if lattice does not exists/update or derivatives not
+  // required
+  if (lat == nullptr || lat->when_update() != update ||
+      par.rho_derivatives() != RestFrameDensityDerivativesMode::On) {
+    return;
+  }
+  // the derivatives vanish on the nodes, which no particle reaches
+  lat->iterate_occupied_indices([&](int index) {
+    DensityOnLattice &node = (*lat)[index];
+    // the rest frame density
+    double rho = node.rho();
+    const int sgn = rho > 0 ? 1 : -1;
+    if (std::abs(rho) < very_small_double) {
+      rho = sgn * very_small_double;
+    }
+
+    // the computational frame j^mu
+    const FourVector jmu = node.jmu_net();
+    // computational frame array of derivatives of j^mu
+    const std::array<FourVector, 4> djmu_dxnu = node.djmu_dxnu();
+
+    const double drho_dt =
+        (1 / rho) *
+        (jmu.x0() * djmu_dxnu[0].x0() - jmu.x1() * djmu_dxnu[0].x1() -
+         jmu.x2() * djmu_dxnu[0].x2() - jmu.x3() * djmu_dxnu[0].x3());
+
+    const double drho_dx =
+        (1 / rho) *
+        (jmu.x0() * djmu_dxnu[1].x0() - jmu.x1() * djmu_dxnu[1].x1() -
+         jmu.x2() * djmu_dxnu[1].x2() - jmu.x3() * djmu_dxnu[1].x3());
+
+    const double drho_dy =
+        (1 / rho) *
+        (jmu.x0() * djmu_dxnu[2].x0() - jmu.x1() * djmu_dxnu[2].x1() -
+         jmu.x2() * djmu_dxnu[2].x2() - jmu.x3() * djmu_dxnu[2].x3());
+
+    const double drho_dz =
+        (1 / rho) *
+        (jmu.x0() * djmu_dxnu[3].x0() - jmu.x1() * djmu_dxnu[3].x1() -
+         jmu.x2() * djmu_dxnu[3].x2() - jmu.x3() * djmu_dxnu[3].x3());
+
+    const FourVector drho_dxnu = {drho_dt, drho_dx, drho_dy, drho_dz};
+
+    node.overwrite_drho_dxnu(drho_dxnu);
+  });
+}
 
 void update_lattice(
     RectangularLattice<DensityOnLattice> *lat,
@@ -189,8 +395,8 @@ void update_lattice(
     RectangularLattice<FourVector> *new_jmu,
     RectangularLattice<std::array<FourVector, 4>> *four_grad_lattice,
     const LatticeUpdate update, const DensityType dens_type,
-    const DensityParameters &par, const std::vector<Particles> &ensembles,
-    const double time_step, const bool compute_gradient) {
+    const DensityParameters &par, const ParticlesSoA &particles,
+    const double time_step, const bool compute_gradient, ThreadPool *pool) {
   // Do not proceed if lattice does not exists/update not required
   if (lat == nullptr || lat->when_update() != update) {
     return;
@@ -213,10 +419,23 @@ void update_lattice(
     }
   }
 
-  update_lattice(lat, update, dens_type, par, ensembles, compute_gradient);
+  update_lattice(lat, update, dens_type, par, particles, compute_gradient,
+                 pool);
 
-  // calculate the gradients for finite difference derivatives
-  if (par.derivatives() == DerivativesMode::FiniteDifference) {
+  if (par.derivatives() == DerivativesMode::FiniteDifference &&
+      par.fft_smearing()) {
+    // the spatial derivatives come with the convolution, see
+    // convolve_density
+    const double inv_time_step = 1.0 / time_step;
+    for (int i = 0; i < number_of_nodes; i++) {
+      DensityOnLattice &node = (*lat)[i];
+      const std::array<FourVector, 4> djmu_dxnu = node.djmu_dxnu();
+      node.overwrite_djmu_dxnu(
+          (node.jmu_net() - (*old_jmu)[i]) * inv_time_step, djmu_dxnu[1],
+          djmu_dxnu[2], djmu_dxnu[3]);
+    }
+  } else if (par.derivatives() == DerivativesMode::FiniteDifference) {
+    // calculate the gradients for finite difference derivatives
     // copy values of jmu FourVectors at t_0 + time_step onto new_jmu
     for (int i = 0; i < number_of_nodes; i++) {
       new_jmu->assign_value(i, ((*lat)[i]).jmu_net());
@@ -224,7 +443,7 @@ void update_lattice(
 
     // compute time derivatives and gradients of all components of jmu
     new_jmu->compute_four_gradient_lattice(*old_jmu, time_step,
-                                           *four_grad_lattice);
+                                           *four_grad_lattice, pool);
 
     // substitute new derivatives
     int node_number = 0;
@@ -235,48 +454,26 @@ void update_lattice(
     }
   }  // if (par.derivatives() == DerivativesMode::FiniteDifference)
 
-  // calculate gradients of rest frame density
-  if (par.rho_derivatives() == RestFrameDensityDerivativesMode::On) {
-    for (auto &node : *lat) {
-      // the rest frame density
-      double rho = node.rho();
-      const int sgn = rho > 0 ? 1 : -1;
-      if (std::abs(rho) < very_small_double) {
-        rho = sgn * very_small_double;
-      }
-
-      // the computational frame j^mu
-      const FourVector jmu = node.jmu_net();
-      // computational frame array of derivatives of j^mu
-      const std::array<FourVector, 4> djmu_dxnu = node.djmu_dxnu();
-
-      const double drho_dt =
-          (1 / rho) *
-          (jmu.x0() * djmu_dxnu[0].x0() - jmu.x1() * djmu_dxnu[0].x1() -
-           jmu.x2() * djmu_dxnu[0].x2() - jmu.x3() * djmu_dxnu[0].x3());
-
-      const double drho_dx =
-          (1 / rho) *
-          (jmu.x0() * djmu_dxnu[1].x0() - jmu.x1() * djmu_dxnu[1].x1() -
-           jmu.x2() * djmu_dxnu[1].x2() - jmu.x3() * djmu_dxnu[1].x3());
-
-      const double drho_dy =
-          (1 / rho) *
-          (jmu.x0() * djmu_dxnu[2].x0() - jmu.x1() * djmu_dxnu[2].x1() -
-           jmu.x2() * djmu_dxnu[2].x2() - jmu.x3() * djmu_dxnu[2].x3());
-
-      const double drho_dz =
-          (1 / rho) *
-          (jmu.x0() * djmu_dxnu[3].x0() - jmu.x1() * djmu_dxnu[3].x1() -
-           jmu.x2() * djmu_dxnu[3].x2() - jmu.x3() * djmu_dxnu[3].x3());
-
-      const FourVector drho_dxnu = {drho_dt, drho_dx, drho_dy, drho_dz};
-
-      node.overwrite_drho_dxnu(drho_dxnu);
-    }
-  }  // if (par.rho_derivatives() == RestFrameDensityDerivatives::On){
+  update_rest_frame_derivatives(lat, update, par);
 }  // void update_lattice()
 
+void update_lattice(
+    RectangularLattice<DensityOnLattice> *lat,
+    RectangularLattice<FourVector> *old_jmu,
+    RectangularLattice<FourVector> *new_jmu,
+    RectangularLattice<std::array<FourVector, 4>> *four_grad_lattice,
+    const LatticeUpdate update, const DensityType dens_type,
+    const DensityParameters &par, const std::vector<Particles> &ensembles,
+    const double time_step, const bool compute_gradient, ThreadPool *pool) {
+  // Do not proceed if lattice does not exists/update not required
+  if (lat == nullptr || lat->when_update() != update) {
+    return;
+  }
+  update_lattice(lat, old_jmu, new_jmu, four_grad_lattice, update, dens_type,
+                 par, ParticlesSoA(ensembles), time_step, compute_gradient,
+                 pool);
+}
+
 std::ostream &operator<<(std::ostream &os, DensityType dens_type) {
   switch (dens_type) {
     case DensityType::Hadron:
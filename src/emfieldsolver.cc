@@ -0,0 +1,151 @@
+/*
+ *
+ *    Copyright (c) 2024
+ *      SMASH Team
+ *
+ *    GNU General Public License (GPLv3 or later)
+ *
+ */
+
+#include "smash/emfieldsolver.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <complex>
+
+#include "smash/constants.h"
+
+namespace smash {
+
+/**
+ * \param[in] cell_sizes Sizes of the lattice cells [fm]
+ * \param[in] r_cut Half of the side length of the integration cube [fm]
+ * \param[out] m_min Smallest distances of the nodes of the integration cube
+ *             from its centre in every direction [cells], as in
+ *             RectangularLattice::rectangle_bounds
+ * \param[out] m_max Largest distances
+ */
+static void cube_bounds(const std::array<double, 3> &cell_sizes, double r_cut,
+                        std::array<int, 3> &m_min, std::array<int, 3> &m_max) {
+  for (int i = 0; i < 3; i++) {
+    m_min[i] = 1 - static_cast<int>(std::ceil(r_cut / cell_sizes[i]));
+    m_max[i] = -static_cast<int>(std::ceil(-r_cut / cell_sizes[i]));
+  }
+}
+
+/**
+ * \param[in] cell_sizes Sizes of the lattice cells [fm]
+ * \param[in] r_cut Half of the side length of the integration cube [fm]
+ * \return Largest distance of a node of the integration cube from its centre
+ *         in every direction [cells]
+ */
+static std::array<int, 3> cube_range(const std::array<double, 3> &cell_sizes,
+                                     double r_cut) {
+  std::array<int, 3> m_min, m_max, range;
+  cube_bounds(cell_sizes, r_cut, m_min, m_max);
+  for (int i = 0; i < 3; i++) {
+    range[i] = std::max(m_max[i], -m_min[i]);
+  }
+  return range;
+}
+
+EMFieldSolver::EMFieldSolver(const RectangularLattice<DensityOnLattice> &lat,
+                             double r_cut)
+    : fft_(lat.n_cells(), cube_range(lat.cell_sizes(), r_cut),
+           lat.periodic()) {
+  const std::array<double, 3> &cell_sizes = lat.cell_sizes();
+  const double cell_volume = cell_sizes[0] * cell_sizes[1] * cell_sizes[2];
+  /* The Green's function at the distance m is the contribution of the node
+   * i - m to the node i. For periodic lattices, the integration cube wraps
+   * around, possibly several times. */
+  std::array<int, 3> m_min, m_max;
+  cube_bounds(cell_sizes, r_cut, m_min, m_max);
+  for (LatticeFFT::Grid &g : green_) {
+    g.assign(fft_.grid_size(), 0.);
+  }
+  for (int mz = m_min[2]; mz <= m_max[2]; mz++) {
+    for (int my = m_min[1]; my <= m_max[1]; my++) {
+      for (int mx = m_min[0]; mx <= m_max[0]; mx++) {
+        const std::optional<std::size_t> index = fft_.offset_index(mx, my, mz);
+        const ThreeVector dr(mx * cell_sizes[0], my * cell_sizes[1],
+                             mz * cell_sizes[2]);
+        if (!index || dr.abs() < really_small) {
+          continue;
+        }
+        const ThreeVector g =
+            elementary_charge * cell_volume * dr / std::pow(dr.abs(), 3);
+        for (int i = 0; i < 3; i++) {
+          green_[i][*index] += g[i];
+        }
+      }
+    }
+  }
+  for (LatticeFFT::Grid &g : green_) {
+    fft_.forward(g, false);
+  }
+}
+
+void EMFieldSolver::compute(RectangularLattice<DensityOnLattice> &jmu_el,
+                            ForceLattice &em_lat) {
+  const std::array<int, 3> &n_cells = fft_.n_cells();
+  assert(jmu_el.n_cells() == n_cells && em_lat.n_cells() == n_cells);
+  for (LatticeFFT::Grid &s : sources_) {
+    s.assign(fft_.grid_size(), 0.);
+  }
+  for (int iz = 0; iz < n_cells[2]; iz++) {
+    for (int iy = 0; iy < n_cells[1]; iy++) {
+      for (int ix = 0; ix < n_cells[0]; ix++) {
+        DensityOnLattice &node = jmu_el[jmu_el.index1d(ix, iy, iz)];
+        const std::size_t index = fft_.grid_index(ix, iy, iz);
+        const ThreeVector j = node.jmu_net().threevec();
+        sources_[0][index] = node.rho();
+        for (int i = 0; i < 3; i++) {
+          sources_[i + 1][index] = j[i];
+        }
+      }
+    }
+  }
+  for (LatticeFFT::Grid &s : sources_) {
+    fft_.forward(s, true);
+  }
+
+  /* E = rho * G and B = j x G in Fourier space. Since the fields are real,
+   * two components are transformed back at once as real and imaginary part
+   * of one grid. */
+  using complex = std::complex<double>;
+  const LatticeFFT::Grid &gx = green_[0], &gy = green_[1], &gz = green_[2];
+  LatticeFFT::Grid &rho = sources_[0], &jx = sources_[1], &jy = sources_[2],
+                   &jz = sources_[3];
+  const complex i_unit(0., 1.);
+  for (std::size_t k = 0; k < fft_.grid_size(); k++) {
+    const complex e_x = rho[k] * gx[k], e_y = rho[k] * gy[k],
+                  e_z = rho[k] * gz[k];
+    const complex b_x = jy[k] * gz[k] - jz[k] * gy[k];
+    const complex b_y = jz[k] * gx[k] - jx[k] * gz[k];
+    const complex b_z = jx[k] * gy[k] - jy[k] * gx[k];
+    rho[k] = e_x + i_unit * e_y;
+    jx[k] = e_z + i_unit * b_x;
+    jy[k] = b_y + i_unit * b_z;
+  }
+  for (int i = 0; i < 3; i++) {
+    fft_.inverse(sources_[i], true);
+  }
+
+  for (int iz = 0; iz < n_cells[2]; iz++) {
+    for (int iy = 0; iy < n_cells[1]; iy++) {
+      for (int ix = 0; ix < n_cells[0]; ix++) {
+        const std::size_t index = fft_.grid_index(ix, iy, iz);
+        em_lat.set(em_lat.index1d(ix, iy, iz),
+                   std::make_pair(ThreeVector(rho[index].real(),
+                                              rho[index].imag(),
+                                              jx[index].real()),
+                                  ThreeVector(jx[index].imag(),
+                                              jy[index].real(),
+                                              jy[index].imag())));
+      }
+    }
+  }
+}
+
+}  // namespace smash
@@ -1,6 +1,6 @@
 /*
  *
- *    Copyright (c) 2015-2019,2021-2022
+ *    Copyright (c) 2015-2019,2021-2022,2024
  *      SMASH Team
  *
  *    GNU General Public License (GPLv3 or later)
@@ -9,8 +9,12 @@
 
 #include "smash/energymomentumtensor.h"
 
+#include <algorithm>
+#include <array>
+#include <cmath>
 #include <iomanip>
 #include <iostream>
+#include <limits>
 
 #include "Eigen/Dense"
 
@@ -20,9 +24,67 @@
 namespace smash {
 static constexpr int LTmn = LogArea::Tmn::id;
 
+namespace {
+/**
+ * Find the Landau frame 4-velocity by power iteration with
+ * \f$T_{\mu}^{\nu} + s \delta_{\mu}^{\nu}\f$, whose eigenvalues are the
+ * energy density and the negative pressures shifted by s. For s, half of the
+ * mean of the diagonal spatial components is taken, which is about half of
+ * the pressure. The eigenvector of the energy density dominates, if the
+ * energy density exceeds the pressures, which holds for the tensors of
+ * massive particles. The iteration stops once the changes are at the level of
+ * rounding.
+ *
+ * \param[in] T Components of \f$T^{\mu \nu}\f$
+ * \param[out] u Landau frame 4-velocity with lower index
+ * \return Whether the iteration converged to a time-like vector
+ */
+bool landau_frame_by_iteration(const EnergyMomentumTensor::tmn_type &T,
+                               FourVector &u) {
+  constexpr int max_iterations = 200;
+  if (!(T[0] > 0.)) {
+    return false;
+  }
+  const double s = (T[4] + T[7] + T[9]) / 6.;
+  std::array<double, 4> h = {1., 0., 0., 0.};
+  double last_change = std::numeric_limits<double>::infinity();
+  for (int iteration = 0; iteration < max_iterations; iteration++) {
+    const std::array<double, 4> w = {
+        T[0] * h[0] + T[1] * h[1] + T[2] * h[2] + T[3] * h[3] + s * h[0],
+        -(T[1] * h[0] + T[4] * h[1] + T[5] * h[2] + T[6] * h[3]) + s * h[1],
+        -(T[2] * h[0] + T[5] * h[1] + T[7] * h[2] + T[8] * h[3]) + s * h[2],
+        -(T[3] * h[0] + T[6] * h[1] + T[8] * h[2] + T[9] * h[3]) + s * h[3]};
+    const double w_sqr = w[0] * w[0] - w[1] * w[1] - w[2] * w[2] - w[3] * w[3];
+    if (!(w_sqr > 0.) || !(w[0] > 0.)) {
+      return false;
+    }
+    const double norm = 1. / std::sqrt(w_sqr);
+    double change = 0.;
+    for (int i = 0; i < 4; i++) {
+      const double next = w[i] * norm;
+      change = std::max(change, std::abs(next - h[i]));
+      h[i] = next;
+    }
+    // The changes stop decreasing, once they are rounding errors
+    if (change == 0. || (change < 1e-12 * h[0] && change >= last_change)) {
+      u = FourVector(h[0], h[1], h[2], h[3]);
+      return true;
+    }
+    last_change = change;
+  }
+  return false;
+}
+}  // namespace
+
 FourVector EnergyMomentumTensor::landau_frame_4velocity() const {
   using Eigen::Matrix4d;
   using Eigen::Vector4d;
+  /* For most tensors, the power iteration finds the 4-velocity much faster
+   * than the general eigenvalue solver below, which is kept for the others. */
+  FourVector u_iterated;
+  if (landau_frame_by_iteration(Tmn_, u_iterated)) {
+    return u_iterated;
+  }
   /* We want to solve the generalized eigenvalue problem
      T^{\mu \nu} h_{nu} = \lambda g^{\mu \nu} h_{nu}, or in the other way
      T_{\mu}^{\nu} h_{nu} = \lambda h_{mu}. The eigenvector
@@ -151,6 +213,14 @@ void EnergyMomentumTensor::add_particle(const FourVector &mom) {
   Tmn_[9] += mom[3] * tmp.x3();
 }
 
+EnergyMomentumTensor::tmn_type EnergyMomentumTensor::particle_contribution(
+    const FourVector &mom) {
+  const double e_inv = 1.0 / mom[0];
+  const double vx = mom[1] * e_inv, vy = mom[2] * e_inv, vz = mom[3] * e_inv;
+  return {mom[0],      mom[1],      mom[2],      mom[3],      mom[1] * vx,
+          mom[1] * vy, mom[1] * vz, mom[2] * vy, mom[2] * vz, mom[3] * vz};
+}
+
 void EnergyMomentumTensor::add_particle(const ParticleData &p, double factor) {
   if (factor != 0) {
     add_particle(p.momentum() * factor);
@@ -0,0 +1,95 @@
+/*
+ *
+ *    Copyright (c) 2024
+ *      SMASH Team
+ *
+ *    GNU General Public License (GPLv3 or later)
+ *
+ */
+
+#include "smash/equilibrationmonitor.h"
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#include <utility>
+
+#include "smash/particles.h"
+
+namespace smash {
+
+EquilibrationMonitor::EquilibrationMonitor(
+    const EquilibriumCriterion &criterion)
+    : criterion_(criterion) {
+  if (!(criterion_.window > 0.) || !(criterion_.tolerance > 0.)) {
+    throw std::invalid_argument(
+        "The window and the tolerance of the equilibrium must be positive.");
+  }
+  if (criterion_.measurement_time < 0.) {
+    throw std::invalid_argument(
+        "The measurement time after the equilibrium must not be negative.");
+  }
+}
+
+bool EquilibrationMonitor::add(double time,
+                               const std::vector<Particles> &ensembles) {
+  Sample sample{time, {}};
+  for (const Particles &particles : ensembles) {
+    for (const ParticleData &p : particles) {
+      Sums &sums = sample.species[p.pdgcode()];
+      const double p_sqr = p.momentum().threevec().sqr();
+      sums[0] += 1.;
+      sums[1] += std::sqrt(p_sqr);
+      sums[2] += p_sqr;
+    }
+  }
+  samples_.push_back(std::move(sample));
+  // Only the samples of the last window are needed
+  const double start = time - criterion_.window;
+  while (samples_.size() > 1 && samples_[1].time <= start) {
+    samples_.pop_front();
+  }
+  if (samples_.front().time > start) {
+    return false;
+  }
+
+  // Sums over the earlier and the later half of the window
+  const double middle = time - 0.5 * criterion_.window;
+  std::map<PdgCode, std::array<Sums, 2>> halves;
+  std::array<int, 2> n_samples = {0, 0};
+  for (const Sample &s : samples_) {
+    const int half = s.time < middle ? 0 : 1;
+    n_samples[half]++;
+    for (const auto &[pdg, sums] : s.species) {
+      Sums &total = halves[pdg][half];
+      for (int i = 0; i < 3; i++) {
+        total[i] += sums[i];
+      }
+    }
+  }
+  if (n_samples[0] == 0 || n_samples[1] == 0) {
+    return false;
+  }
+  const double tolerance = criterion_.tolerance;
+  const auto agree = [tolerance](double a, double b) {
+    return std::abs(a - b) <= tolerance * std::max(std::abs(a), std::abs(b));
+  };
+  for (const auto &[pdg, sums] : halves) {
+    const double multiplicity_early = sums[0][0] / n_samples[0];
+    const double multiplicity_late = sums[1][0] / n_samples[1];
+    if (0.5 * (multiplicity_early + multiplicity_late) < 1. / tolerance) {
+      continue;
+    }
+    if (!agree(multiplicity_early, multiplicity_late)) {
+      return false;
+    }
+    for (int i = 1; i < 3; i++) {
+      if (!agree(sums[0][i] / sums[0][0], sums[1][i] / sums[1][0])) {
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+}  // namespace smash
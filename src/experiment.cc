@@ -1,6 +1,6 @@
 /*
  *
- *    Copyright (c) 2013-2023
+ *    Copyright (c) 2013-2024
  *      SMASH Team
  *
  *    GNU General Public License (GPLv3 or later)
@@ -9,18 +9,48 @@
 
 #include "smash/experiment.h"
 
+#include <algorithm>
 #include <cstdint>
+#include <string>
+#include <unordered_set>
+#include <utility>
 
 #include "smash/boxmodus.h"
 #include "smash/collidermodus.h"
+#include "smash/ensemblecommunicator.h"
 #include "smash/listmodus.h"
 #include "smash/spheremodus.h"
 
 namespace smash {
 
 /* ExperimentBase carries everything that is needed for the evolution */
+template <typename Modus>
+ExperimentPtr ExperimentBase::create_with_event_workers(
+    Configuration &config, const std::filesystem::path &output_path,
+    EnsembleCommunicator *communicator) {
+  // The workers are set up from copies of the configuration before it is used
+  const std::string config_yaml = config.to_string();
+  auto experiment = std::unique_ptr<Experiment<Modus>>(
+      new Experiment<Modus>(config, output_path, nullptr, communicator));
+  if (experiment->n_event_workers_ > 1) {
+    experiment->output_merger_ =
+        std::make_unique<OutputMerger>(std::move(experiment->outputs_));
+    experiment->outputs_ = experiment->output_merger_->make_deferred_outputs();
+    for (int i = 1; i < experiment->n_event_workers_; i++) {
+      Configuration worker_config(config_yaml.c_str(),
+                                  Configuration::InitializeFromYAMLString);
+      experiment->event_workers_.emplace_back(new Experiment<Modus>(
+          worker_config, output_path, experiment->output_merger_.get()));
+      // Unused values are reported for the configuration of the experiment
+      worker_config.clear();
+    }
+  }
+  return experiment;
+}
+
 ExperimentPtr ExperimentBase::create(Configuration &config,
-                                     const std::filesystem::path &output_path) {
+                                     const std::filesystem::path &output_path,
+                                     EnsembleCommunicator *communicator) {
   if (!std::filesystem::exists(output_path)) {
     throw NonExistingOutputPathRequest("The requested output path (" +
                                        output_path.string() +
@@ -32,15 +62,20 @@ ExperimentPtr ExperimentBase::create(Configuration &config,
   logg[LExperiment].debug() << "Modus for this calculation: " << modus_chooser;
 
   if (modus_chooser == "Box") {
-    return std::make_unique<Experiment<BoxModus>>(config, output_path);
+    return create_with_event_workers<BoxModus>(config, output_path,
+                                               communicator);
   } else if (modus_chooser == "List") {
-    return std::make_unique<Experiment<ListModus>>(config, output_path);
+    return create_with_event_workers<ListModus>(config, output_path,
+                                                communicator);
   } else if (modus_chooser == "ListBox") {
-    return std::make_unique<Experiment<ListBoxModus>>(config, output_path);
+    return create_with_event_workers<ListBoxModus>(config, output_path,
+                                                   communicator);
   } else if (modus_chooser == "Collider") {
-    return std::make_unique<Experiment<ColliderModus>>(config, output_path);
+    return create_with_event_workers<ColliderModus>(config, output_path,
+                                                    communicator);
   } else if (modus_chooser == "Sphere") {
-    return std::make_unique<Experiment<SphereModus>>(config, output_path);
+    return create_with_event_workers<SphereModus>(config, output_path,
+                                                  communicator);
   } else {
     throw InvalidModusRequest("Invalid Modus (" + modus_chooser +
                               ") requested from ExperimentBase::create.");
@@ -129,7 +164,8 @@ ExperimentPtr ExperimentBase::create(Configuration &config,
  \endverbatim
  */
 
-ExperimentParameters create_experiment_parameters(Configuration &config) {
+ExperimentParameters create_experiment_parameters(
+    Configuration &config, EnsembleCommunicator *communicator) {
   logg[LExperiment].trace() << SMASH_SOURCE_LOCATION;
 
   const int ntest = config.take({"General", "Testparticles"}, 1);
@@ -305,10 +341,26 @@ ExperimentParameters create_experiment_parameters(Configuration &config) {
       config.take({"Collision_Term", "Maximum_Cross_Section"},
                   maximum_cross_section_default);
   maximum_cross_section *= scale_xs;
+
+  const int n_ensembles_total = config.take({"General", "Ensembles"}, 1);
+  int n_ensembles = n_ensembles_total, first_ensemble = 0;
+  if (communicator) {
+    // the first processes take one ensemble more than the others
+    const int share = n_ensembles_total / communicator->size();
+    const int remainder = n_ensembles_total % communicator->size();
+    const int rank = communicator->rank();
+    n_ensembles = share + (rank < remainder ? 1 : 0);
+    first_ensemble = rank * share + std::min(rank, remainder);
+    if (n_ensembles < 1) {
+      throw std::invalid_argument(
+          "Every process needs at least one ensemble, please use more "
+          "ensembles or fewer processes.");
+    }
+  }
   return {
       std::make_unique<UniformClock>(0.0, dt, t_end),
       std::move(output_clock),
-      config.take({"General", "Ensembles"}, 1),
+      n_ensembles,
       ntest,
       config.take({"General", "Derivatives_Mode"},
                   DerivativesMode::CovariantGaussian),
@@ -323,6 +375,8 @@ ExperimentParameters create_experiment_parameters(Configuration &config) {
       config.take({"General", "Gauss_Cutoff_In_Sigma"}, 4.),
       config.take({"General", "Discrete_Weight"}, 1. / 3.0),
       config.take({"General", "Triangular_Range"}, 2.0),
+      config.take({"General", "FFT_Smearing"},
+                  InputKeys::gen_fftSmearing.default_value()),
       criterion,
       config.take({"Collision_Term", "Two_to_One"}, true),
       config.take({"Collision_Term", "Included_2to2"}, ReactionsBitSet().set()),
@@ -343,10 +397,14 @@ ExperimentParameters create_experiment_parameters(Configuration &config) {
                   false),
       config.take({"Collision_Term", "Decay_Initial_Particles"},
                   InputKeys::collTerm_decayInitial.default_value()),
-      std::nullopt};
+      std::nullopt,
+      communicator,
+      first_ensemble,
+      n_ensembles_total};
 }
 
-std::string format_measurements(const std::vector<Particles> &ensembles,
+std::string format_measurements(const QuantumNumbers &current_values,
+                                int total_particles,
                                 uint64_t scatterings_this_interval,
                                 const QuantumNumbers &conserved_initial,
                                 SystemTimePoint time_start, double time,
@@ -354,12 +412,7 @@ std::string format_measurements(const std::vector<Particles> &ensembles,
                                 double E_mean_field_initial) {
   const SystemTimeSpan elapsed_seconds = SystemClock::now() - time_start;
 
-  const QuantumNumbers current_values(ensembles);
   const QuantumNumbers difference = current_values - conserved_initial;
-  int total_particles = 0;
-  for (const Particles &particles : ensembles) {
-    total_particles += particles.size();
-  }
 
   // Make sure there are no FPEs in case of IC output, were there will
   // eventually be no more particles in the system
@@ -397,8 +450,7 @@ std::string format_measurements(const std::vector<Particles> &ensembles,
 double calculate_mean_field_energy(
     const Potentials &potentials,
     RectangularLattice<smash::DensityOnLattice> &jmuB_lat,
-    RectangularLattice<std::pair<ThreeVector, ThreeVector>> *em_lattice,
-    const ExperimentParameters &parameters) {
+    ForceLattice *em_lattice, const ExperimentParameters &parameters) {
   // basic parameters and variables
   const double V_cell = (jmuB_lat.cell_sizes())[0] *
                         (jmuB_lat.cell_sizes())[1] * (jmuB_lat.cell_sizes())[2];
@@ -425,23 +477,12 @@ double calculate_mean_field_energy(
     }
 
     /*
-     * Skyrme potential parameters:
-     * C1GeV are the Skyrme coefficients converted to GeV,
-     * b1 are the powers of the baryon number density entering the expression
-     * for the energy density of the system. Note that these exponents are
-     * larger by 1 than those for the energy of a particle (which are used in
-     * Potentials class). The formula for a total mean field energy due to a
-     * Skyrme potential is E_MF = \sum_i (C_i/b_i) ( n_B^b_i )/( n_0^(b_i - 1) )
-     * where nB is the local rest frame baryon number density and n_0 is the
-     * saturation density. Then the single particle potential follows from
-     * V = d E_MF / d n_B .
-     */
-    double C1GeV = (potentials.skyrme_a()) / 1000.0;
-    double C2GeV = (potentials.skyrme_b()) / 1000.0;
-    double b1 = 2.0;
-    double b2 = (potentials.skyrme_tau()) + 1.0;
-
-    /*
+     * The formula for a total mean field energy due to a Skyrme potential is
+     * E_MF = \sum_i (C_i/b_i) ( n_B^b_i )/( n_0^(b_i - 1) ) where nB is the
+     * local rest frame baryon number density and n_0 is the saturation
+     * density, see Potentials::skyrme_energy_density. Then the single
+     * particle potential follows from V = d E_MF / d n_B .
+     *
      * Note: calculating the mean field only works if lattice is used.
      * We iterate over the nodes of the baryon density lattice to sum their
      * contributions to the total mean field.
@@ -471,13 +512,8 @@ double calculate_mean_field_energy(
        *
        * TODO: Add symmetry energy.
        */
-      double mean_field_contribution_1 = (C1GeV / b1) * std::pow(abs_rhoB, b1) /
-                                         std::pow(nuclear_density, b1 - 1);
-      double mean_field_contribution_2 = (C2GeV / b2) * std::pow(abs_rhoB, b2) /
-                                         std::pow(nuclear_density, b2 - 1);
-
       lattice_mean_field_total +=
-          V_cell * (mean_field_contribution_1 + mean_field_contribution_2);
+          V_cell * potentials.skyrme_energy_density(rhoB);
     }
 
     // logging statistical properties of the density calculation
@@ -523,9 +559,6 @@ double calculate_mean_field_energy(
      * local rest frame baryon density, and rho_0 is the saturation density.
      */
 
-    // saturation density of nuclear matter specified in the VDF parameters
-    double rhoB_0 = potentials.saturation_density();
-
     /*
      * Note: calculating the mean field only works if lattice is used.
      * We iterate over the nodes of the baryon density lattice to sum their
@@ -540,7 +573,6 @@ double calculate_mean_field_energy(
       double rhoB = node.rho();
       // the computational frame density
       const double j0B = node.jmu_net().x0();
-      double abs_rhoB = std::abs(rhoB);
       density_mean += j0B;
       density_variance += j0B * j0B;
 
@@ -549,21 +581,8 @@ double calculate_mean_field_energy(
        * in any frame, and in the rest frame conforms to the Skyrme mean-field
        * energy (if same coefficients and powers are used).
        */
-      // in order to prevent dividing by zero in case any b_i < 2.0
-      if (abs_rhoB < very_small_double) {
-        abs_rhoB = very_small_double;
-      }
-      double mean_field_contribution = 0.0;
-      for (int i = 0; i < potentials.number_of_terms(); i++) {
-        mean_field_contribution +=
-            potentials.coeffs()[i] *
-            std::pow(abs_rhoB, potentials.powers()[i] - 2.0) *
-            (j0B * j0B -
-             ((potentials.powers()[i] - 1.0) / potentials.powers()[i]) *
-                 abs_rhoB * abs_rhoB) /
-            std::pow(rhoB_0, potentials.powers()[i] - 1.0);
-      }
-      lattice_mean_field_total += V_cell * mean_field_contribution;
+      lattice_mean_field_total +=
+          V_cell * potentials.vdf_energy_density(rhoB, j0B);
     }
 
     // logging statistical properties of the density calculation
@@ -593,7 +612,8 @@ double calculate_mean_field_energy(
     double V_cell_em = em_lattice->cell_sizes()[0] *
                        em_lattice->cell_sizes()[1] *
                        em_lattice->cell_sizes()[2];
-    for (auto &fields : *em_lattice) {
+    for (std::size_t i = 0; i < em_lattice->size(); i++) {
+      const std::pair<ThreeVector, ThreeVector> fields = em_lattice->get(i);
       // Energy is 0.5 * int E^2 + B^2 dV
       electromagnetic_potential +=
           hbarc * 0.5 * V_cell_em * (fields.first.sqr() + fields.second.sqr());
@@ -616,6 +636,7 @@ double calculate_mean_field_energy(
 
 EventInfo fill_event_info(const std::vector<Particles> &ensembles,
                           double E_mean_field, double modus_impact_parameter,
+                          double event_weight,
                           const ExperimentParameters &parameters,
                           bool projectile_target_interact,
                           bool kinematic_cut_for_SMASH_IC) {
@@ -632,7 +653,8 @@ EventInfo fill_event_info(const std::vector<Particles> &ensembles,
                        parameters.testparticles,
                        parameters.n_ensembles,
                        !projectile_target_interact,
-                       kinematic_cut_for_SMASH_IC};
+                       kinematic_cut_for_SMASH_IC,
+                       event_weight};
   return event_info;
 }
 
@@ -673,4 +695,69 @@ void validate_and_adjust_particle_list(ParticleList &particle_list) {
   }
 }
 
+ParticleList find_particles_to_remove(const Particles &particles,
+                                      const ParticleList &to_remove,
+                                      double time) {
+  ParticleList found;
+  found.reserve(to_remove.size());
+  std::unordered_set<int> found_ids;
+  // Particles sorted by energy, only built once a particle is not in its slot
+  std::vector<const ParticleData *> by_energy;
+  for (const ParticleData &wanted : to_remove) {
+    const ParticleData *match = nullptr;
+    bool found_before = false;
+    // A valid copy of a particle is found in its slot directly
+    if (particles.is_valid(wanted) && found_ids.count(wanted.id()) == 0 &&
+        are_particles_identical_at_given_time(
+            wanted, particles.lookup(wanted), time)) {
+      match = &particles.lookup(wanted);
+    }
+    if (!match) {
+      if (by_energy.empty()) {
+        by_energy.reserve(particles.size());
+        for (const ParticleData &p : particles) {
+          by_energy.push_back(&p);
+        }
+        std::sort(by_energy.begin(), by_energy.end(),
+                  [](const ParticleData *a, const ParticleData *b) {
+                    return a->momentum().x0() < b->momentum().x0();
+                  });
+      }
+      /* Only the particles within the energies, which FourVector::operator==
+       * still considers equal, can be identical. */
+      const double energy = wanted.momentum().x0();
+      const double width = small_number * std::max(1., std::abs(energy)) /
+                           (1. - 0.5 * small_number);
+      auto candidate =
+          std::lower_bound(by_energy.begin(), by_energy.end(), energy - width,
+                           [](const ParticleData *p, double e) {
+                             return p->momentum().x0() < e;
+                           });
+      for (; candidate != by_energy.end() &&
+             (*candidate)->momentum().x0() <= energy + width;
+           ++candidate) {
+        if (!are_particles_identical_at_given_time(wanted, **candidate, time)) {
+          continue;
+        }
+        if (found_ids.count((*candidate)->id()) > 0) {
+          found_before = true;
+        } else {
+          match = *candidate;
+          break;
+        }
+      }
+    }
+    if (match) {
+      found_ids.insert(match->id());
+      found.push_back(*match);
+    } else if (found_before) {
+      logg[LExperiment].error() << "The same particle has been asked to be "
+                                   "removed multiple times:\n"
+                                << wanted;
+      throw std::logic_error("Particle cannot be removed twice!");
+    }
+  }
+  return found;
+}
+
 }  // namespace smash
@@ -9,6 +9,10 @@
 
 #include "smash/fields.h"
 
+#include <algorithm>
+
+#include "smash/threadpool.h"
+
 namespace smash {
 
 void update_fields_lattice(
@@ -17,7 +21,7 @@ void update_fields_lattice(
     RectangularLattice<FourVector> *new_fields,
     RectangularLattice<std::array<FourVector, 4>> *fields_four_grad_lattice,
     DensityLattice *jmuB_lat, const LatticeUpdate fields_lat_update,
-    const Potentials &potentials, const double time_step) {
+    const Potentials &potentials, const double time_step, ThreadPool *pool) {
   // Do not proceed if lattice does not exists/update not required
   if (fields_lat == nullptr || fields_lat->when_update() != fields_lat_update) {
     return;
@@ -41,37 +45,33 @@ void update_fields_lattice(
    */
   fields_lat->reset();
 
-  // Get the potential parameters
-  const double rhoB_0 = potentials.saturation_density();
-
   // update the fields lattice
-  for (int i = 0; i < number_of_nodes; i++) {
+  auto update_node = [&](int i) {
     // read values off the jmu_B lattice (which holds values at t0 + Delta t)
-    double rhoB_at_i = ((*jmuB_lat)[i]).rho();
-    FourVector jmuB_at_i = ((*jmuB_lat)[i]).jmu_net();
-
-    double abs_rhoB_at_i = std::abs(rhoB_at_i);
-    // this is to prevent nan expressions
-    if (abs_rhoB_at_i < very_small_double) {
-      abs_rhoB_at_i = very_small_double;
-    }
-
-    // this needs to be used in order to prevent trying to calculate something
-    // an expression like (-rhoB)^{3.4}
-    const int sgn = rhoB_at_i > 0 ? 1 : -1;
+    const DensityOnLattice &jmuB_at_i = (*jmuB_lat)[i];
 
     // field contributions as obtained in the VDF model
-    double field_contribution = 0.0;
-    for (int j = 0; j < potentials.number_of_terms(); j++) {
-      field_contribution +=
-          sgn * potentials.coeffs()[j] *
-          std::pow(abs_rhoB_at_i / rhoB_0, potentials.powers()[j] - 2.0) /
-          rhoB_0;
-    }
-    FourVector field_at_i = field_contribution * jmuB_at_i;
+    const double field_contribution =
+        potentials.vdf_factors(jmuB_at_i.rho()).second;
+    FourVector field_at_i = field_contribution * jmuB_at_i.jmu_net();
 
     // fill the A_mu lattice
     ((*fields_lat)[i]).overwrite_A_mu(field_at_i);
+  };
+  if (pool == nullptr || pool->size() < 2) {
+    for (int i = 0; i < number_of_nodes; i++) {
+      update_node(i);
+    }
+  } else {
+    // the nodes are independent, give each thread a few contiguous chunks
+    const int n_chunks = std::min(number_of_nodes, 4 * pool->size());
+    const int chunk_size = (number_of_nodes + n_chunks - 1) / n_chunks;
+    pool->parallel_for(n_chunks, [&](int chunk) {
+      const int end = std::min(number_of_nodes, (chunk + 1) * chunk_size);
+      for (int i = chunk * chunk_size; i < end; i++) {
+        update_node(i);
+      }
+    });
   }
 
   /*
@@ -86,7 +86,7 @@ void update_fields_lattice(
    * Compute time derivatives and gradients of all components of A^mu
    */
   new_fields->compute_four_gradient_lattice(*old_fields, time_step,
-                                            *fields_four_grad_lattice);
+                                            *fields_four_grad_lattice, pool);
 
   // substitute new derivatives
   for (int i = 0; i < number_of_nodes; i++) {
@@ -1,6 +1,6 @@
 /*
  *
- *    Copyright (c) 2018,2022
+ *    Copyright (c) 2018,2022,2024
  *      SMASH Team
  *
  *    GNU General Public License (GPLv3 or later)
@@ -9,24 +9,260 @@
 
 #include "smash/file.h"
 
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#ifdef SMASH_USE_ZLIB
+#include <zlib.h>
+
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+#endif
+
 namespace smash {
 
+#ifdef SMASH_USE_ZLIB
+/**
+ * Receives the data written to a compressed file and passes it in blocks to
+ * a thread, which compresses them into gzip members and writes them to the
+ * actual file.
+ */
+class RenamingFilePtr::Compressor {
+ public:
+  /**
+   * Start the compression thread.
+   *
+   * \param[in] file Actual file, which is closed by close().
+   */
+  explicit Compressor(FILE* file) : file_(file) {
+    pending_.reserve(block_size);
+    thread_ = std::thread(&Compressor::compress, this);
+  }
+
+  /**
+   * Collect data for compression.
+   *
+   * \param[in] data Bytes to be written.
+   * \param[in] size Number of bytes.
+   * \return Whether everything was compressed and written so far.
+   */
+  bool write(const char* data, std::size_t size) {
+    pending_.insert(pending_.end(), data, data + size);
+    return pending_.size() < block_size || hand_over(false);
+  }
+
+  /**
+   * End the current gzip member after the data collected so far.
+   *
+   * \return Whether everything was compressed and written so far.
+   */
+  bool end_member() { return hand_over(true); }
+
+  /**
+   * Compress the remaining data, stop the thread and close the actual file.
+   *
+   * \return Zero, if everything was written and the file was closed.
+   */
+  int close() {
+    hand_over(true);
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      stop_ = true;
+    }
+    changed_.notify_all();
+    thread_.join();
+    const int status = std::fclose(file_);
+    return failed_ ? EOF : status;
+  }
+
+ private:
+  /// Size of the blocks handed over to the compression thread
+  static constexpr std::size_t block_size = 1 << 20;
+  /// Number of blocks waiting for compression at most
+  static constexpr std::size_t max_blocks = 8;
+
+  /// Data to be compressed
+  struct Block {
+    /// Uncompressed bytes
+    std::vector<char> data;
+    /// Whether the gzip member ends after the data
+    bool end_of_member;
+  };
+
+  /**
+   * Pass the collected data to the compression thread, waiting if it is
+   * behind.
+   *
+   * \param[in] end_of_member Whether the gzip member ends after the data
+   * \return Whether everything was compressed and written so far.
+   */
+  bool hand_over(bool end_of_member) {
+    bool written;
+    {
+      std::unique_lock<std::mutex> lock(mutex_);
+      changed_.wait(lock, [this]() { return queue_.size() < max_blocks; });
+      queue_.push_back({std::move(pending_), end_of_member});
+      written = !failed_;
+    }
+    changed_.notify_all();
+    pending_ = {};
+    pending_.reserve(block_size);
+    return written;
+  }
+
+  /// Compress the blocks from the queue until stopped.
+  void compress() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (true) {
+      changed_.wait(lock, [this]() { return !queue_.empty() || stop_; });
+      if (queue_.empty()) {
+        return;
+      }
+      Block block = std::move(queue_.front());
+      queue_.pop_front();
+      lock.unlock();
+      changed_.notify_all();
+      const bool written = deflate_block(block);
+      lock.lock();
+      failed_ |= !written;
+    }
+  }
+
+  /**
+   * Compress a block and write it to the actual file.
+   *
+   * \param[in] block Data to be compressed
+   * \return Whether it was written successfully.
+   */
+  bool deflate_block(Block& block) {
+    if (!block.data.empty() && !in_member_) {
+      stream_ = z_stream{};
+      // 16 added to the window bits selects the gzip format
+      if (deflateInit2(&stream_, Z_DEFAULT_COMPRESSION, Z_DEFLATED, 15 + 16, 8,
+                       Z_DEFAULT_STRATEGY) != Z_OK) {
+        return false;
+      }
+      in_member_ = true;
+    }
+    if (!in_member_) {
+      return true;
+    }
+    const int flush = block.end_of_member ? Z_FINISH : Z_NO_FLUSH;
+    stream_.next_in = reinterpret_cast<Bytef*>(block.data.data());
+    stream_.avail_in = block.data.size();
+    bool written = true;
+    do {
+      stream_.next_out = out_;
+      stream_.avail_out = sizeof(out_);
+      deflate(&stream_, flush);
+      const std::size_t size = sizeof(out_) - stream_.avail_out;
+      written &= std::fwrite(out_, 1, size, file_) == size;
+    } while (stream_.avail_out == 0);
+    if (block.end_of_member) {
+      deflateEnd(&stream_);
+      in_member_ = false;
+      written &= std::fflush(file_) == 0;
+    }
+    return written;
+  }
+
+  /// Actual file
+  FILE* file_;
+  /// Data collected for the next block
+  std::vector<char> pending_;
+  /// State of the compression, used by the thread only
+  z_stream stream_{};
+  /// Whether a gzip member was started, used by the thread only
+  bool in_member_ = false;
+  /// Compressed data, used by the thread only
+  Bytef out_[1 << 16];
+  /// Guards all members below
+  std::mutex mutex_;
+  /// Notified whenever the queue changes
+  std::condition_variable changed_;
+  /// Blocks waiting for compression
+  std::deque<Block> queue_;
+  /// Whether compressing or writing failed
+  bool failed_ = false;
+  /// Whether the thread is asked to stop
+  bool stop_ = false;
+  /// Compression thread, started last
+  std::thread thread_;
+};
+#else
+/// Compressed files are not supported without zlib.
+class RenamingFilePtr::Compressor {};
+#endif
+
 FilePtr fopen(const std::filesystem::path& filename, const std::string& mode) {
   FilePtr f{std::fopen(filename.c_str(), mode.c_str())};
   return f;
 }
 
 RenamingFilePtr::RenamingFilePtr(const std::filesystem::path& filename,
-                                 const std::string& mode) {
+                                 const std::string& mode, bool compressed) {
+  if (compressed && !compression_supported()) {
+    throw std::invalid_argument(
+        "Compressed files are not supported, SMASH was built without zlib.");
+  }
   filename_ = filename;
-  filename_unfinished_ = filename;
+  if (compressed) {
+    filename_ += ".gz";
+  }
+  filename_unfinished_ = filename_;
   filename_unfinished_ += ".unfinished";
   file_ = std::fopen(filename_unfinished_.c_str(), mode.c_str());
+#ifdef SMASH_USE_ZLIB
+  if (compressed && file_) {
+    cookie_io_functions_t functions{};
+    functions.write = [](void* cookie, const char* data,
+                         std::size_t size) -> ssize_t {
+      const bool written = static_cast<Compressor*>(cookie)->write(data, size);
+      return written ? size : 0;
+    };
+    functions.close = [](void* cookie) {
+      auto* compressor = static_cast<Compressor*>(cookie);
+      const int status = compressor->close();
+      delete compressor;
+      return status;
+    };
+    compressor_ = new Compressor(file_);
+    file_ = fopencookie(compressor_, mode.c_str(), functions);
+    if (!file_) {
+      functions.close(compressor_);
+      compressor_ = nullptr;
+    }
+  }
+#endif
 }
 
 FILE* RenamingFilePtr::get() { return file_; }
 
+void RenamingFilePtr::flush() {
+  std::fflush(file_);
+#ifdef SMASH_USE_ZLIB
+  if (compressor_) {
+    compressor_->end_member();
+  }
+#endif
+}
+
+bool RenamingFilePtr::compression_supported() {
+#ifdef SMASH_USE_ZLIB
+  return true;
+#else
+  return false;
+#endif
+}
+
 RenamingFilePtr::~RenamingFilePtr() {
+  // a compressed file is finished by closing it
   std::fclose(file_);
   // we rename the output file only if we are not unwinding the stack
   // because of an exception
@@ -35,4 +271,36 @@ RenamingFilePtr::~RenamingFilePtr() {
   }
 }
 
+MappedFile::MappedFile(const std::filesystem::path& filename) {
+  const int fd = ::open(filename.c_str(), O_RDONLY);
+  if (fd < 0) {
+    throw std::runtime_error("Cannot open " + filename.string() + ": " +
+                             std::strerror(errno));
+  }
+  struct stat status;
+  if (::fstat(fd, &status) != 0) {
+    ::close(fd);
+    throw std::runtime_error("Cannot read " + filename.string());
+  }
+  size_ = status.st_size;
+  if (size_ > 0) {
+    void* mapping = ::mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (mapping == MAP_FAILED) {
+      ::close(fd);
+      throw std::runtime_error("Cannot map " + filename.string());
+    }
+    // the file is read front to back
+    ::madvise(mapping, size_, MADV_SEQUENTIAL);
+    data_ = static_cast<const char*>(mapping);
+  }
+  // the mapping stays valid after the file is closed
+  ::close(fd);
+}
+
+MappedFile::~MappedFile() {
+  if (data_) {
+    ::munmap(const_cast<char*>(data_), size_);
+  }
+}
+
 }  // namespace smash
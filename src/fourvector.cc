@@ -1,5 +1,5 @@
 /*
- *    Copyright (c) 2013-2019,2022
+ *    Copyright (c) 2013-2019,2022,2024
  *      SMASH Team
  *
  *    GNU General Public License (GPLv3 or later)
@@ -15,16 +15,7 @@
 namespace smash {
 
 FourVector FourVector::lorentz_boost(const ThreeVector& v) const {
-  const double velocity_squared = v.sqr();
-
-  const double gamma =
-      velocity_squared < 1. ? 1. / std::sqrt(1. - velocity_squared) : 0;
-
-  // this is used four times in the Vector:
-  const double xprime_0 = gamma * (this->x0() - this->threevec() * v);
-  // this is the part of the space-like components that is always the same:
-  const double constantpart = gamma / (gamma + 1) * (xprime_0 + this->x0());
-  return FourVector(xprime_0, this->threevec() - v * constantpart);
+  return LorentzBoost(v)(*this);
 }
 
 bool FourVector::operator==(const FourVector& a) const {
@@ -0,0 +1,193 @@
+/*
+ *
+ *    Copyright (c) 2024
+ *      SMASH Team
+ *
+ *    GNU General Public License (GPLv3 or later)
+ *
+ */
+
+#include "smash/frozenspectators.h"
+
+#include <algorithm>
+#include <array>
+#include <limits>
+#include <utility>
+
+#include "smash/particles.h"
+
+namespace smash {
+
+namespace {
+/// Box enclosing the positions of a group of particles
+struct Box {
+  /// Smallest coordinates [fm]
+  std::array<double, 3> min = {std::numeric_limits<double>::infinity(),
+                               std::numeric_limits<double>::infinity(),
+                               std::numeric_limits<double>::infinity()};
+  /// Largest coordinates [fm]
+  std::array<double, 3> max = {-std::numeric_limits<double>::infinity(),
+                               -std::numeric_limits<double>::infinity(),
+                               -std::numeric_limits<double>::infinity()};
+
+  /// Enlarge the box to enclose the given position.
+  void add(const FourVector &pos) {
+    for (int i = 0; i < 3; i++) {
+      min[i] = std::min(min[i], pos[i + 1]);
+      max[i] = std::max(max[i], pos[i + 1]);
+    }
+  }
+
+  /**
+   * \return Whether the given position is closer to the box than the reach.
+   *         An empty box is never in reach.
+   */
+  bool in_reach(const FourVector &pos, double reach) const {
+    double distance_sqr = 0.;
+    for (int i = 0; i < 3; i++) {
+      const double d =
+          std::max({min[i] - pos[i + 1], pos[i + 1] - max[i], 0.});
+      distance_sqr += d * d;
+    }
+    return distance_sqr <= reach * reach;
+  }
+};
+
+/// \return Index of the nucleus of a spectator, or -1 for other particles
+int nucleus(const ParticleData &p) {
+  if (p.get_history().collisions_per_particle != 0) {
+    return -1;
+  }
+  switch (p.belongs_to()) {
+    case BelongsTo::Projectile:
+      return 0;
+    case BelongsTo::Target:
+      return 1;
+    default:
+      return -1;
+  }
+}
+}  // namespace
+
+void FrozenSpectators::update(const Particles &particles, double reach) {
+  Box others;
+  std::array<Box, 2> nuclei;
+  int max_id = -1;
+  for (const ParticleData &p : particles) {
+    const int n = nucleus(p);
+    (n < 0 ? others : nuclei[n]).add(p.position());
+    max_id = std::max(max_id, p.id());
+  }
+
+  frozen_.assign(max_id + 1, false);
+  n_frozen_ = 0;
+  for (const ParticleData &p : particles) {
+    const int n = nucleus(p);
+    if (n < 0) {
+      continue;
+    }
+    const FourVector &pos = p.position();
+    const bool partner_in_reach =
+        others.in_reach(pos, reach) || nuclei[1 - n].in_reach(pos, reach) ||
+        (collisions_within_nucleus_ && nuclei[n].in_reach(pos, reach));
+    if (!partner_in_reach) {
+      frozen_[p.id()] = true;
+      n_frozen_++;
+    }
+  }
+}
+
+void EscapedParticles::update(const Particles &particles, double reach,
+                              double since) {
+  Box core;
+  int max_id = -1;
+  for (const ParticleData &p : particles) {
+    if (p.get_history().time_last_collision >= since) {
+      core.add(p.position());
+    }
+    max_id = std::max(max_id, p.id());
+  }
+
+  // Without a core every particle is outside of it
+  Box outside;
+  outside_.clear();
+  for (const ParticleData &p : particles) {
+    if (!core.in_reach(p.position(), 0.)) {
+      outside.add(p.position());
+      outside_.emplace_back(0., &p);
+    }
+  }
+  int axis = 0;
+  for (int i = 1; i < 3; i++) {
+    if (outside.max[i] - outside.min[i] >
+        outside.max[axis] - outside.min[axis]) {
+      axis = i;
+    }
+  }
+  for (auto &entry : outside_) {
+    entry.first = entry.second->position()[axis + 1];
+  }
+  std::sort(outside_.begin(), outside_.end(),
+            [](const auto &a, const auto &b) { return a.first < b.first; });
+
+  /* Particles beyond the reach of the core, which escape unless another
+   * particle is within reach */
+  const std::size_t n = outside_.size();
+  std::vector<bool> escapes(n);
+  for (std::size_t i = 0; i < n; i++) {
+    escapes[i] = !core.in_reach(outside_[i].second->position(), reach);
+  }
+  for (std::size_t i = 0; i < n; i++) {
+    const ThreeVector r_i = outside_[i].second->position().threevec();
+    for (std::size_t j = i + 1;
+         j < n && outside_[j].first - outside_[i].first <= reach; j++) {
+      if ((escapes[i] || escapes[j]) &&
+          (outside_[j].second->position().threevec() - r_i).sqr() <=
+              reach * reach) {
+        escapes[i] = false;
+        escapes[j] = false;
+      }
+    }
+  }
+
+  is_escaped_.assign(max_id + 1, false);
+  escaped_.clear();
+  for (std::size_t i = 0; i < n; i++) {
+    if (escapes[i]) {
+      is_escaped_[outside_[i].second->id()] = true;
+      escaped_.push_back(outside_[i].second);
+    }
+  }
+}
+
+bool nuclei_separate_without_interaction(
+    const Particles &particles, double reach, bool collisions_within_nucleus,
+    const std::vector<FourVector> &beam_momentum) {
+  if (collisions_within_nucleus) {
+    return false;
+  }
+  // Extent of the positions and the velocities of both nuclei
+  std::array<Box, 2> positions, velocities;
+  for (const ParticleData &p : particles) {
+    const int n = nucleus(p);
+    if (n < 0 || !p.type().is_stable()) {
+      return false;
+    }
+    positions[n].add(p.position());
+    const FourVector &momentum =
+        beam_momentum.empty() ? p.momentum() : beam_momentum[p.id()];
+    velocities[n].add(FourVector(0., momentum.velocity()));
+  }
+  for (int i = 0; i < 3; i++) {
+    for (int front = 0; front < 2; front++) {
+      const int back = 1 - front;
+      if (positions[front].min[i] - positions[back].max[i] > reach &&
+          velocities[front].min[i] >= velocities[back].max[i]) {
+        return true;
+      }
+    }
+  }
+  return false;
+}
+
+}  // namespace smash
@@ -1,5 +1,5 @@
 /*
- *    Copyright (c) 2016-2022
+ *    Copyright (c) 2016-2022,2024
  *      SMASH Team
  *
  *    GNU General Public License (GPLv3 or later)
@@ -9,16 +9,95 @@
 
 #include <time.h>
 
+#include <algorithm>
+#include <functional>
+#include <utility>
+
 #include "smash/angles.h"
 #include "smash/forwarddeclarations.h"
 #include "smash/logging.h"
 #include "smash/particles.h"
 #include "smash/quantumnumbers.h"
 #include "smash/random.h"
+#include "smash/threadpool.h"
 
 namespace smash {
 static constexpr int LGrandcanThermalizer = LogArea::GrandcanThermalizer::id;
 
+namespace {
+/**
+ * Call a function for all indices below n, concurrently if a pool is given.
+ *
+ * \param[in] pool Thread pool, may be null
+ * \param[in] n Number of indices
+ * \param[in] f Function of the index
+ */
+void for_each(ThreadPool *pool, int n, const std::function<void(int)> &f) {
+  if (!pool) {
+    for (int i = 0; i < n; i++) {
+      f(i);
+    }
+    return;
+  }
+  pool->parallel_for(n, f);
+}
+
+/// Number of particles per chunk in the loops over the sampled particles
+constexpr std::size_t chunk_size = 1000;
+
+/// \return Number of chunks of n indices
+int n_chunks(std::size_t n) {
+  return static_cast<int>((n + chunk_size - 1) / chunk_size);
+}
+
+/**
+ * Call a function for all indices below n, in chunks of fixed size which are
+ * processed concurrently if a pool is given.
+ *
+ * \param[in] pool Thread pool, may be null
+ * \param[in] n Number of indices
+ * \param[in] f Function of the index
+ */
+template <typename F>
+void chunked_for_each(ThreadPool *pool, std::size_t n, F &&f) {
+  for_each(pool, n_chunks(n), [&](int chunk) {
+    const std::size_t end = std::min(n, (chunk + 1) * chunk_size);
+    for (std::size_t i = chunk * chunk_size; i < end; i++) {
+      f(i);
+    }
+  });
+}
+
+/**
+ * Sum a function over all indices below n. The sums over chunks of fixed size
+ * are computed concurrently and added in order, such that the result does not
+ * depend on the number of threads.
+ *
+ * \param[in] pool Thread pool, may be null
+ * \param[in] n Number of indices
+ * \param[in] f Function of the index, called once for every index
+ * \return Sum over all indices
+ */
+template <typename T, typename F>
+T chunked_sum(ThreadPool *pool, std::size_t n, F &&f) {
+  std::vector<T> partial_sums(n_chunks(n), T());
+  for_each(pool, n_chunks(n), [&](int chunk) {
+    const std::size_t end = std::min(n, (chunk + 1) * chunk_size);
+    for (std::size_t i = chunk * chunk_size; i < end; i++) {
+      partial_sums[chunk] += f(i);
+    }
+  });
+  T sum = T();
+  for (const T &partial_sum : partial_sums) {
+    sum += partial_sum;
+  }
+  return sum;
+}
+
+/// Number of candidates of the mode algorithm which are sampled at once
+constexpr int mode_algo_batch_size = 256;
+}  // namespace
+
 ThermLatticeNode::ThermLatticeNode()
     : Tmu0_(FourVector()),
       nb_(0.0),
@@ -40,6 +119,50 @@ void ThermLatticeNode::add_particle(const ParticleData &part, double factor) {
 }
 
 void ThermLatticeNode::compute_rest_frame_quantities(HadronGasEos &eos) {
+  iterate_rest_frame_quantities(eos, &eos);
+}
+
+void ThermLatticeNode::compute_rest_frame_quantities(
+    const std::vector<ThermLatticeNode *> &nodes, HadronGasEos &eos,
+    ThreadPool *pool) {
+  // Nodes leaving the table are solved again from their initial state
+  std::vector<ThermLatticeNode *> to_solve;
+  if (!eos.is_tabulated()) {
+    to_solve = nodes;
+  } else {
+    std::vector<char> left_table(nodes.size(), false);
+    for_each(pool, static_cast<int>(nodes.size()), [&](int i) {
+      const ThermLatticeNode initial = *nodes[i];
+      if (!nodes[i]->iterate_rest_frame_quantities(eos, nullptr)) {
+        *nodes[i] = initial;
+        left_table[i] = true;
+      }
+    });
+    for (std::size_t i = 0; i < nodes.size(); i++) {
+      if (left_table[i]) {
+        to_solve.push_back(nodes[i]);
+      }
+    }
+  }
+  if (to_solve.empty()) {
+    return;
+  }
+  if (!pool) {
+    for (ThermLatticeNode *node : to_solve) {
+      node->iterate_rest_frame_quantities(eos, &eos);
+    }
+    return;
+  }
+  // The solver is not thread-safe, so every node gets its own
+  const bool w = eos.account_for_resonance_widths();
+  pool->parallel_for(static_cast<int>(to_solve.size()), [&](int i) {
+    HadronGasEos solver(false, w);
+    to_solve[i]->iterate_rest_frame_quantities(eos, &solver);
+  });
+}
+
+bool ThermLatticeNode::iterate_rest_frame_quantities(const HadronGasEos &eos,
+                                                     HadronGasEos *solver) {
   /// \todo(oliiny): use Newton's method instead of these iterations
   const int max_iter = 50;
   v_ = ThreeVector(0.0, 0.0, 0.0);
@@ -56,8 +179,11 @@ void ThermLatticeNode::compute_rest_frame_quantities(HadronGasEos &eos) {
     EosTable::table_element tabulated;
     eos.from_table(tabulated, e_, gamma_inv * nb_, nq_);
     if (!eos.is_tabulated() || tabulated.p < 0.0) {
+      if (!solver) {
+        return false;
+      }
       auto T_mub_mus_muq =
-          eos.solve_eos(e_, gamma_inv * nb_, gamma_inv * ns_, nq_);
+          solver->solve_eos(e_, gamma_inv * nb_, gamma_inv * ns_, nq_);
       T_ = T_mub_mus_muq[0];
       mub_ = T_mub_mus_muq[1];
       mus_ = T_mub_mus_muq[2];
@@ -77,6 +203,7 @@ void ThermLatticeNode::compute_rest_frame_quantities(HadronGasEos &eos) {
               << " Accuracy: " << std::abs(e_ - e_previous_step)
               << " is less than tolerance " << tolerance << std::endl;
   }
+  return true;
 }
 
 void ThermLatticeNode::set_rest_frame_quantities(double T0, double mub0,
@@ -128,10 +255,12 @@ GrandCanThermalizer::GrandCanThermalizer(const std::array<double, 3> lat_sizes,
 
 void GrandCanThermalizer::update_thermalizer_lattice(
     const std::vector<Particles> &ensembles, const DensityParameters &dens_par,
-    bool ignore_cells_under_treshold) {
+    bool ignore_cells_under_treshold, ThreadPool *pool) {
   const DensityType dens_type = DensityType::Hadron;
   const LatticeUpdate update = LatticeUpdate::EveryFixedInterval;
-  update_lattice(lat_.get(), update, dens_type, dens_par, ensembles, false);
+  update_lattice(lat_.get(), update, dens_type, dens_par, ensembles, false,
+                 pool);
+  std::vector<ThermLatticeNode *> nodes;
   for (auto &node : *lat_) {
     /* If energy density is definitely below e_crit -
        no need to find T, mu, etc. So if e = T00 - T0i*vi <=
@@ -140,11 +269,12 @@ void GrandCanThermalizer::update_thermalizer_lattice(
         node.Tmu0().x0() + std::abs(node.Tmu0().x1()) +
                 std::abs(node.Tmu0().x2()) + std::abs(node.Tmu0().x3()) >=
             e_crit_) {
-      node.compute_rest_frame_quantities(eos_);
+      nodes.push_back(&node);
     } else {
       node = ThermLatticeNode();
     }
   }
+  ThermLatticeNode::compute_rest_frame_quantities(nodes, eos_, pool);
 }
 
 ThreeVector GrandCanThermalizer::uniform_in_cell() const {
@@ -157,32 +287,46 @@ ThreeVector GrandCanThermalizer::uniform_in_cell() const {
 }
 
 void GrandCanThermalizer::renormalize_momenta(
-    ParticleList &plist, const FourVector required_total_momentum) {
+    ParticleList &plist, const FourVector required_total_momentum,
+    ThreadPool *pool) {
+  const std::size_t n = plist.size();
+  auto total_momentum = [&]() {
+    return chunked_sum<FourVector>(
+        pool, n, [&](std::size_t i) { return plist[i].momentum(); });
+  };
+  auto for_each_particle = [&](const std::function<void(ParticleData &)> &f) {
+    chunked_for_each(pool, n, [&](std::size_t i) { f(plist[i]); });
+  };
+
   // Centralize momenta
-  QuantumNumbers conserved = QuantumNumbers(plist);
+  const FourVector sampled_total_momentum = total_momentum();
   logg[LGrandcanThermalizer].info("Required 4-momentum: ",
                                   required_total_momentum);
-  logg[LGrandcanThermalizer].info("Sampled 4-momentum: ", conserved.momentum());
-  const ThreeVector mom_to_add =
-      (required_total_momentum.threevec() - conserved.momentum().threevec()) /
-      plist.size();
+  logg[LGrandcanThermalizer].info("Sampled 4-momentum: ",
+                                  sampled_total_momentum);
+  const ThreeVector mom_to_add = (required_total_momentum.threevec() -
+                                  sampled_total_momentum.threevec()) /
+                                 n;
   logg[LGrandcanThermalizer].info("Adjusting momenta by ", mom_to_add);
-  for (auto &particle : plist) {
+  for_each_particle([&](ParticleData &particle) {
     particle.set_4momentum(particle.type().mass(),
                            particle.momentum().threevec() + mom_to_add);
-  }
+  });
 
   // Boost every particle to the common center of mass frame
-  conserved = QuantumNumbers(plist);
-  const ThreeVector beta_CM_generated = conserved.momentum().velocity();
-  const ThreeVector beta_CM_required = required_total_momentum.velocity();
-
-  double E = 0.0;
+  const LorentzBoost to_generated_cm(total_momentum().velocity());
+  const LorentzBoost from_required_cm(-required_total_momentum.velocity());
+
+  // Squared energies and momenta in this frame, for the search below
+  std::vector<double> E2(n), p2(n);
+  double E = chunked_sum<double>(pool, n, [&](std::size_t i) {
+    ParticleData &particle = plist[i];
+    particle.boost_momentum(to_generated_cm);
+    E2[i] = particle.momentum().x0() * particle.momentum().x0();
+    p2[i] = particle.momentum().threevec().sqr();
+    return particle.momentum().x0();
+  });
   double E_expected = required_total_momentum.abs();
-  for (auto &particle : plist) {
-    particle.boost_momentum(beta_CM_generated);
-    E += particle.momentum().x0();
-  }
   // Renorm. momenta by factor (1+a) to get the right energy, binary search
   const double tolerance = really_small;
   double a, a_min, a_max, er;
@@ -197,12 +341,9 @@ void GrandCanThermalizer::renormalize_momenta(
   }
   do {
     a = 0.5 * (a_min + a_max);
-    E = 0.0;
-    for (const auto &particle : plist) {
-      const double p2 = particle.momentum().threevec().sqr();
-      const double E2 = particle.momentum().x0() * particle.momentum().x0();
-      E += std::sqrt(E2 + a * (a + 2.0) * p2);
-    }
+    E = chunked_sum<double>(pool, n, [&](std::size_t i) {
+      return std::sqrt(E2[i] + a * (a + 2.0) * p2[i]);
+    });
     er = E - E_expected;
     if (er >= 0.0) {
       a_max = a;
@@ -216,11 +357,11 @@ void GrandCanThermalizer::renormalize_momenta(
 
   logg[LGrandcanThermalizer].info("Renormalizing momenta by factor 1+a, a = ",
                                   a);
-  for (auto &particle : plist) {
+  for_each_particle([&](ParticleData &particle) {
     particle.set_4momentum(particle.type().mass(),
                            (1 + a) * particle.momentum().threevec());
-    particle.boost_momentum(-beta_CM_required);
-  }
+    particle.boost_momentum(from_required_cm);
+  });
 }
 
 void GrandCanThermalizer::sample_multinomial(HadronClass particle_class,
@@ -248,80 +389,110 @@ void GrandCanThermalizer::sample_multinomial(HadronClass particle_class,
   }
 }
 
-void GrandCanThermalizer::sample_in_random_cell_BF_algo(ParticleList &plist,
-                                                        const double time,
-                                                        size_t type_index) {
-  N_in_cells_.clear();
-  N_total_in_cells_ = 0.0;
-  for (auto cell_index : cells_to_sample_) {
-    const ThermLatticeNode cell = (*lat_)[cell_index];
-    const double gamma = 1.0 / std::sqrt(1.0 - cell.v().sqr());
-    const double N_this_cell =
-        lat_cell_volume_ * gamma *
-        HadronGasEos::partial_density(*eos_typelist_[type_index], cell.T(),
-                                      cell.mub(), cell.mus(), cell.muq());
-    N_in_cells_.push_back(N_this_cell);
-    N_total_in_cells_ += N_this_cell;
-  }
-
-  for (int i = 0; i < mult_int_[type_index]; i++) {
-    // Choose random cell, probability = N_in_cell/N_total
-    double r = random::uniform(0.0, N_total_in_cells_);
-    double partial_sum = 0.0;
-    int index_only_thermalized = -1;
-    while (partial_sum < r) {
-      index_only_thermalized++;
-      partial_sum += N_in_cells_[index_only_thermalized];
-    }
-    const int cell_index = cells_to_sample_[index_only_thermalized];
-    const ThermLatticeNode cell = (*lat_)[cell_index];
-    const ThreeVector cell_center = lat_->cell_center(cell_index);
-
-    ParticleData particle(*eos_typelist_[type_index]);
-    // Note: it's pole mass for resonances!
-    const double m = eos_typelist_[type_index]->mass();
-    // Position
-    particle.set_4position(FourVector(time, cell_center + uniform_in_cell()));
-    // Momentum
-    double momentum_radial = sample_momenta_from_thermal(cell.T(), m);
-    Angles phitheta;
-    phitheta.distribute_isotropically();
-    particle.set_4momentum(m, phitheta.threevec() * momentum_radial);
-    particle.boost_momentum(-cell.v());
-    particle.set_formation_time(time);
-
-    plist.push_back(particle);
-  }
-}
-
-void GrandCanThermalizer::thermalize_BF_algo(QuantumNumbers &conserved_initial,
-                                             double time, int ntest) {
-  std::fill(mult_sort_.begin(), mult_sort_.end(), 0.0);
-  for (auto cell_index : cells_to_sample_) {
-    const ThermLatticeNode cell = (*lat_)[cell_index];
+void GrandCanThermalizer::compute_N_in_cells_BF_algo(int ntest,
+                                                     ThreadPool *pool) {
+  const std::size_t n_cells = cells_to_sample_.size();
+  N_sorts_in_cells_.resize(n_cells * N_sorts_);
+  for_each(pool, static_cast<int>(n_cells), [&](int k) {
+    const ThermLatticeNode &cell = (*lat_)[cells_to_sample_[k]];
     const double gamma = 1.0 / std::sqrt(1.0 - cell.v().sqr());
     for (size_t i = 0; i < N_sorts_; i++) {
       // N_i = n u^mu dsigma_mu = (isochronous hypersurface) n * V * gamma
-      mult_sort_[i] +=
-          lat_cell_volume_ * gamma * ntest *
+      N_sorts_in_cells_[k * N_sorts_ + i] =
+          lat_cell_volume_ * gamma *
           HadronGasEos::partial_density(*eos_typelist_[i], cell.T(), cell.mub(),
                                         cell.mus(), cell.muq());
     }
+  });
+  // Sum over the cells in a fixed order
+  for_each(pool, static_cast<int>(N_sorts_), [&](int i) {
+    double N_sort = 0.0;
+    for (std::size_t k = 0; k < n_cells; k++) {
+      N_sort += N_sorts_in_cells_[k * N_sorts_ + i];
+    }
+    mult_sort_[i] = ntest * N_sort;
+  });
+}
+
+void GrandCanThermalizer::sample_in_cells_BF_algo(ParticleList &plist,
+                                                  const double time,
+                                                  ThreadPool *pool) {
+  const std::size_t n_cells = cells_to_sample_.size();
+  // Choose random cell of every particle, probability = N_in_cell/N_total
+  std::vector<std::vector<size_t>> types_in_cells(n_cells);
+  std::vector<double> partial_sums(n_cells);
+  for (size_t type_index = 0; type_index < N_sorts_; type_index++) {
+    if (mult_int_[type_index] == 0) {
+      continue;
+    }
+    double N_total = 0.0;
+    for (std::size_t k = 0; k < n_cells; k++) {
+      N_total += N_sorts_in_cells_[k * N_sorts_ + type_index];
+      partial_sums[k] = N_total;
+    }
+    for (int i = 0; i < mult_int_[type_index]; i++) {
+      const double r = random::uniform(0.0, N_total);
+      const std::size_t k = std::upper_bound(partial_sums.begin(),
+                                             partial_sums.end(), r) -
+                            partial_sums.begin();
+      types_in_cells[std::min(k, n_cells - 1)].push_back(type_index);
+    }
+  }
+
+  /* Every cell has its own stream, numbered by the index of the cell on the
+   * lattice, such that the result does not depend on the threads. */
+  const random::Engine::result_type seed = random::advance();
+  std::vector<ParticleList> sampled_in_cells(n_cells);
+  for_each(pool, static_cast<int>(n_cells), [&](int k) {
+    if (types_in_cells[k].empty()) {
+      return;
+    }
+    const size_t cell_index = cells_to_sample_[k];
+    const ThermLatticeNode &cell = (*lat_)[cell_index];
+    const ThreeVector cell_center = lat_->cell_center(cell_index);
+    const LorentzBoost from_cell_frame(-cell.v());
+    random::Engine engine(seed, cell_index + 1);
+    random::EngineGuard guard(engine);
+    for (size_t type_index : types_in_cells[k]) {
+      ParticleData particle(*eos_typelist_[type_index]);
+      // Note: it's pole mass for resonances!
+      const double m = eos_typelist_[type_index]->mass();
+      // Position
+      particle.set_4position(FourVector(time, cell_center + uniform_in_cell()));
+      // Momentum
+      double momentum_radial = sample_momenta_from_thermal(cell.T(), m);
+      Angles phitheta;
+      phitheta.distribute_isotropically();
+      particle.set_4momentum(m, phitheta.threevec() * momentum_radial);
+      particle.boost_momentum(from_cell_frame);
+      particle.set_formation_time(time);
+      sampled_in_cells[k].push_back(particle);
+    }
+  });
+  for (const ParticleList &sampled : sampled_in_cells) {
+    plist.insert(plist.end(), sampled.begin(), sampled.end());
   }
+}
+
+void GrandCanThermalizer::thermalize_BF_algo(QuantumNumbers &conserved_initial,
+                                             double time, int ntest,
+                                             ThreadPool *pool) {
+  compute_N_in_cells_BF_algo(ntest, pool);
 
   std::fill(mult_classes_.begin(), mult_classes_.end(), 0.0);
   for (size_t i = 0; i < N_sorts_; i++) {
     mult_classes_[static_cast<size_t>(get_class(i))] += mult_sort_[i];
   }
 
-  random::BesselSampler bessel_sampler_B(mult_class(HadronClass::Baryon),
-                                         mult_class(HadronClass::Antibaryon),
-                                         conserved_initial.baryon_number());
+  // The Bessel samplers are reused by repeated samplings with similar means
+  const auto bessel_sampler_B = random::BesselSampler::cached(
+      mult_class(HadronClass::Baryon), mult_class(HadronClass::Antibaryon),
+      conserved_initial.baryon_number());
 
   while (true) {
     sampled_list_.clear();
     std::fill(mult_int_.begin(), mult_int_.end(), 0);
-    const auto Nbar_antibar = bessel_sampler_B.sample();
+    const auto Nbar_antibar = bessel_sampler_B->sample();
 
     sample_multinomial(HadronClass::Baryon, Nbar_antibar.first);
     sample_multinomial(HadronClass::Antibaryon, Nbar_antibar.second);
@@ -334,11 +505,11 @@ void GrandCanThermalizer::thermalize_BF_algo(QuantumNumbers &conserved_initial,
 
     std::pair<int, int> NS_antiS;
     if (algorithm_ == ThermalizationAlgorithm::BiasedBF) {
-      random::BesselSampler bessel_sampler_S(
-          mult_class(HadronClass::PositiveSMeson),
-          mult_class(HadronClass::NegativeSMeson),
-          conserved_initial.strangeness() - S_sampled);
-      NS_antiS = bessel_sampler_S.sample();
+      NS_antiS = random::BesselSampler::cached(
+                     mult_class(HadronClass::PositiveSMeson),
+                     mult_class(HadronClass::NegativeSMeson),
+                     conserved_initial.strangeness() - S_sampled)
+                     ->sample();
     } else if (algorithm_ == ThermalizationAlgorithm::UnbiasedBF) {
       NS_antiS = std::make_pair(
           random::poisson(mult_class(HadronClass::PositiveSMeson)),
@@ -359,11 +530,11 @@ void GrandCanThermalizer::thermalize_BF_algo(QuantumNumbers &conserved_initial,
 
     std::pair<int, int> NC_antiC;
     if (algorithm_ == ThermalizationAlgorithm::BiasedBF) {
-      random::BesselSampler bessel_sampler_C(
-          mult_class(HadronClass::PositiveQZeroSMeson),
-          mult_class(HadronClass::NegativeQZeroSMeson),
-          conserved_initial.charge() - ch_sampled);
-      NC_antiC = bessel_sampler_C.sample();
+      NC_antiC = random::BesselSampler::cached(
+                     mult_class(HadronClass::PositiveQZeroSMeson),
+                     mult_class(HadronClass::NegativeQZeroSMeson),
+                     conserved_initial.charge() - ch_sampled)
+                     ->sample();
     } else if (algorithm_ == ThermalizationAlgorithm::UnbiasedBF) {
       NC_antiC = std::make_pair(
           random::poisson(mult_class(HadronClass::PositiveQZeroSMeson)),
@@ -380,16 +551,12 @@ void GrandCanThermalizer::thermalize_BF_algo(QuantumNumbers &conserved_initial,
         HadronClass::ZeroQZeroSMeson,
         random::poisson(mult_class(HadronClass::ZeroQZeroSMeson)));
 
-    for (size_t itype = 0; itype < N_sorts_; itype++) {
-      sample_in_random_cell_BF_algo(sampled_list_, time, itype);
-    }
+    sample_in_cells_BF_algo(sampled_list_, time, pool);
     if (BF_enforce_microcanonical_) {
-      double e_tot;
       const double e_init = conserved_initial.momentum().x0();
-      e_tot = 0.0;
-      for (auto &particle : sampled_list_) {
-        e_tot += particle.momentum().x0();
-      }
+      const double e_tot = chunked_sum<double>(
+          pool, sampled_list_.size(),
+          [&](std::size_t i) { return sampled_list_[i].momentum().x0(); });
       if (std::abs(e_tot - e_init) > 0.01 * e_init) {
         logg[LGrandcanThermalizer].info("Rejecting: energy ", e_tot,
                                         " too far from ", e_init);
@@ -400,16 +567,116 @@ void GrandCanThermalizer::thermalize_BF_algo(QuantumNumbers &conserved_initial,
   }
 }
 
+void GrandCanThermalizer::compute_N_in_cells_mode_algo(
+    const ModeCondition &condition, ThreadPool *pool) {
+  const std::size_t n_cells = cells_to_sample_.size();
+  N_in_cells_.resize(n_cells);
+  for_each(pool, static_cast<int>(n_cells), [&](int k) {
+    const ThermLatticeNode &cell = (*lat_)[cells_to_sample_[k]];
+    const double gamma = 1.0 / std::sqrt(1.0 - cell.v().sqr());
+    double N_tot = 0.0;
+    for (ParticleTypePtr i : eos_typelist_) {
+      if (condition(i->strangeness(), i->baryon_number(), i->charge())) {
+        // N_i = n u^mu dsigma_mu = (isochronous hypersurface) n * V * gamma
+        N_tot += lat_cell_volume_ * gamma *
+                 HadronGasEos::partial_density(*i, cell.T(), cell.mub(),
+                                               cell.mus(), 0.0);
+      }
+    }
+    N_in_cells_[k] = N_tot;
+  });
+  N_total_in_cells_ = 0.0;
+  for (double N_in_cell : N_in_cells_) {
+    N_total_in_cells_ += N_in_cell;
+  }
+}
+
+ParticleData GrandCanThermalizer::sample_in_random_cell_mode_algo(
+    const double time, const ModeCondition &condition) {
+  // Choose random cell, probability = N_in_cell/N_total
+  double r = random::uniform(0.0, N_total_in_cells_);
+  double partial_sum = 0.0;
+  int index_only_thermalized = -1;
+  while (partial_sum < r) {
+    index_only_thermalized++;
+    partial_sum += N_in_cells_[index_only_thermalized];
+  }
+  const int cell_index = cells_to_sample_[index_only_thermalized];
+  const ThermLatticeNode &cell = (*lat_)[cell_index];
+  const ThreeVector cell_center = lat_->cell_center(cell_index);
+  const double gamma = 1.0 / std::sqrt(1.0 - cell.v().sqr());
+  const double N_in_cell = N_in_cells_[index_only_thermalized];
+  // Which sort to sample - probability N_i/N_tot
+  r = random::uniform(0.0, N_in_cell);
+  double N_sum = 0.0;
+  ParticleTypePtr type_to_sample;
+  for (ParticleTypePtr i : eos_typelist_) {
+    if (!condition(i->strangeness(), i->baryon_number(), i->charge())) {
+      continue;
+    }
+    N_sum += lat_cell_volume_ * gamma *
+             HadronGasEos::partial_density(*i, cell.T(), cell.mub(),
+                                           cell.mus(), 0.0);
+    if (N_sum >= r) {
+      type_to_sample = i;
+      break;
+    }
+  }
+  ParticleData particle(*type_to_sample);
+  // Note: it's pole mass for resonances!
+  const double m = type_to_sample->mass();
+  // Position
+  particle.set_4position(FourVector(time, cell_center + uniform_in_cell()));
+  // Momentum
+  double momentum_radial = sample_momenta_from_thermal(cell.T(), m);
+  Angles phitheta;
+  phitheta.distribute_isotropically();
+  particle.set_4momentum(m, phitheta.threevec() * momentum_radial);
+  particle.boost_momentum(-cell.v());
+  particle.set_formation_time(time);
+  return particle;
+}
+
+ParticleList GrandCanThermalizer::sample_batch_mode_algo(
+    const double time, const ModeCondition &condition, ThreadPool *pool) {
+  // Every candidate has its own stream, numbered by its position in the batch
+  const random::Engine::result_type seed = random::advance();
+  ParticleList batch(mode_algo_batch_size, ParticleData(*eos_typelist_[0]));
+  for_each(pool, mode_algo_batch_size, [&](int i) {
+    random::Engine engine(seed, i + 1);
+    random::EngineGuard guard(engine);
+    batch[i] = sample_in_random_cell_mode_algo(time, condition);
+  });
+  return batch;
+}
+
 void GrandCanThermalizer::thermalize_mode_algo(
-    QuantumNumbers &conserved_initial, double time) {
+    QuantumNumbers &conserved_initial, double time, ThreadPool *pool) {
   double energy = 0.0;
   int S_plus = 0, S_minus = 0, B_plus = 0, B_minus = 0, E_plus = 0, E_minus = 0;
+  // Candidates of the current mode, which are taken one after another
+  ModeCondition condition;
+  ParticleList candidates;
+  std::size_t next_candidate = 0;
+  auto start_mode = [&](ModeCondition mode_condition) {
+    condition = std::move(mode_condition);
+    compute_N_in_cells_mode_algo(condition, pool);
+    candidates.clear();
+    next_candidate = 0;
+  };
+  auto sample_candidate = [&]() {
+    if (next_candidate == candidates.size()) {
+      candidates = sample_batch_mode_algo(time, condition, pool);
+      next_candidate = 0;
+    }
+    return candidates[next_candidate++];
+  };
   // Mode 1: sample until energy is conserved, take only strangeness < 0
   auto condition1 = [](int, int, int) { return true; };
-  compute_N_in_cells_mode_algo(condition1);
+  start_mode(condition1);
   while (conserved_initial.momentum().x0() > energy ||
          S_plus < conserved_initial.strangeness()) {
-    ParticleData p = sample_in_random_cell_mode_algo(time, condition1);
+    ParticleData p = sample_candidate();
     energy += p.momentum().x0();
     if (p.pdgcode().strangeness() > 0) {
       sampled_list_.push_back(p);
@@ -419,9 +686,9 @@ void GrandCanThermalizer::thermalize_mode_algo(
 
   // Mode 2: sample until strangeness is conserved
   auto condition2 = [](int S, int, int) { return (S < 0); };
-  compute_N_in_cells_mode_algo(condition2);
+  start_mode(condition2);
   while (S_plus + S_minus > conserved_initial.strangeness()) {
-    ParticleData p = sample_in_random_cell_mode_algo(time, condition2);
+    ParticleData p = sample_candidate();
     const int s_part = p.pdgcode().strangeness();
     // Do not allow particles with S = -2 or -3 spoil the total sum
     if (S_plus + S_minus + s_part >= conserved_initial.strangeness()) {
@@ -435,10 +702,10 @@ void GrandCanThermalizer::thermalize_mode_algo(
   QuantumNumbers conserved_remaining =
       conserved_initial - QuantumNumbers(sampled_list_);
   energy = 0.0;
-  compute_N_in_cells_mode_algo(condition3);
+  start_mode(condition3);
   while (conserved_remaining.momentum().x0() > energy ||
          B_plus < conserved_remaining.baryon_number()) {
-    ParticleData p = sample_in_random_cell_mode_algo(time, condition3);
+    ParticleData p = sample_candidate();
     energy += p.momentum().x0();
     if (p.pdgcode().baryon_number() > 0) {
       sampled_list_.push_back(p);
@@ -448,9 +715,9 @@ void GrandCanThermalizer::thermalize_mode_algo(
 
   // Mode 4: sample non-strange anti-baryons
   auto condition4 = [](int S, int B, int) { return (S == 0) && (B < 0); };
-  compute_N_in_cells_mode_algo(condition4);
+  start_mode(condition4);
   while (B_plus + B_minus > conserved_remaining.baryon_number()) {
-    ParticleData p = sample_in_random_cell_mode_algo(time, condition4);
+    ParticleData p = sample_candidate();
     const int bar = p.pdgcode().baryon_number();
     if (B_plus + B_minus + bar >= conserved_remaining.baryon_number()) {
       sampled_list_.push_back(p);
@@ -462,10 +729,10 @@ void GrandCanThermalizer::thermalize_mode_algo(
   auto condition5 = [](int S, int B, int) { return (S == 0) && (B == 0); };
   conserved_remaining = conserved_initial - QuantumNumbers(sampled_list_);
   energy = 0.0;
-  compute_N_in_cells_mode_algo(condition5);
+  start_mode(condition5);
   while (conserved_remaining.momentum().x0() > energy ||
          E_plus < conserved_remaining.charge()) {
-    ParticleData p = sample_in_random_cell_mode_algo(time, condition5);
+    ParticleData p = sample_candidate();
     energy += p.momentum().x0();
     if (p.pdgcode().charge() > 0) {
       sampled_list_.push_back(p);
@@ -477,9 +744,9 @@ void GrandCanThermalizer::thermalize_mode_algo(
   auto condition6 = [](int S, int B, int C) {
     return (S == 0) && (B == 0) && (C < 0);
   };
-  compute_N_in_cells_mode_algo(condition6);
+  start_mode(condition6);
   while (E_plus + E_minus > conserved_remaining.charge()) {
-    ParticleData p = sample_in_random_cell_mode_algo(time, condition6);
+    ParticleData p = sample_candidate();
     const int charge = p.pdgcode().charge();
     if (E_plus + E_minus + charge >= conserved_remaining.charge()) {
       sampled_list_.push_back(p);
@@ -493,28 +760,36 @@ void GrandCanThermalizer::thermalize_mode_algo(
   };
   conserved_remaining = conserved_initial - QuantumNumbers(sampled_list_);
   energy = 0.0;
-  compute_N_in_cells_mode_algo(condition7);
+  start_mode(condition7);
   while (conserved_remaining.momentum().x0() > energy) {
-    ParticleData p = sample_in_random_cell_mode_algo(time, condition7);
+    ParticleData p = sample_candidate();
     sampled_list_.push_back(p);
     energy += p.momentum().x0();
   }
 }
 
 void GrandCanThermalizer::thermalize(const Particles &particles, double time,
-                                     int ntest) {
+                                     int ntest, ThreadPool *pool) {
   logg[LGrandcanThermalizer].info("Starting forced thermalization, time ", time,
                                   " fm");
   to_remove_.clear();
   sampled_list_.clear();
-  /* Remove particles from the cells with e > e_crit_,
+  // Mark the cells with e > e_crit_ and save their indices
+  const size_t lattice_total_cells = lat_->size();
+  cells_to_sample_.clear();
+  is_cell_to_sample_.assign(lattice_total_cells, false);
+  for (size_t i = 0; i < lattice_total_cells; i++) {
+    if ((*lat_)[i].e() > e_crit_) {
+      cells_to_sample_.push_back(i);
+      is_cell_to_sample_[i] = true;
+    }
+  }
+  /* Remove particles from the marked cells,
    * sum up their conserved quantities */
   QuantumNumbers conserved_initial = QuantumNumbers();
-  ThermLatticeNode node;
-  for (auto &particle : particles) {
-    const bool is_on_lattice =
-        lat_->value_at(particle.position().threevec(), node);
-    if (is_on_lattice && node.e() > e_crit_) {
+  for (const ParticleData &particle : particles) {
+    const int cell_index = lat_->index_at(particle.position().threevec());
+    if (cell_index >= 0 && is_cell_to_sample_[cell_index]) {
       to_remove_.push_back(particle);
     }
   }
@@ -534,14 +809,6 @@ void GrandCanThermalizer::thermalize(const Particles &particles, double time,
   if (conserved_initial == QuantumNumbers()) {
     return;
   }
-  // Save the indices of cells inside the volume with e > e_crit_
-  cells_to_sample_.clear();
-  const size_t lattice_total_cells = lat_->size();
-  for (size_t i = 0; i < lattice_total_cells; i++) {
-    if ((*lat_)[i].e() > e_crit_) {
-      cells_to_sample_.push_back(i);
-    }
-  }
   logg[LGrandcanThermalizer].info(
       "Number of cells in the thermalization region = ",
       cells_to_sample_.size(),
@@ -552,10 +819,10 @@ void GrandCanThermalizer::thermalize(const Particles &particles, double time,
   switch (algorithm_) {
     case ThermalizationAlgorithm::BiasedBF:
     case ThermalizationAlgorithm::UnbiasedBF:
-      thermalize_BF_algo(conserved_initial, time, ntest);
+      thermalize_BF_algo(conserved_initial, time, ntest, pool);
       break;
     case ThermalizationAlgorithm::ModeSampling:
-      thermalize_mode_algo(conserved_initial, time);
+      thermalize_mode_algo(conserved_initial, time, pool);
       break;
     default:
       throw std::invalid_argument(
@@ -566,7 +833,7 @@ void GrandCanThermalizer::thermalize(const Particles &particles, double time,
                                   " particles.");
 
   // Adjust momenta
-  renormalize_momenta(sampled_list_, conserved_initial.momentum());
+  renormalize_momenta(sampled_list_, conserved_initial.momentum(), pool);
 }
 
 void GrandCanThermalizer::print_statistics(const Clock &clock) const {
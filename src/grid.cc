@@ -1,6 +1,6 @@
 /*
  *
- *    Copyright (c) 2014-2015,2017-2023
+ *    Copyright (c) 2014-2015,2017-2024
  *      SMASH Team
  *
  *    GNU General Public License (GPLv3 or later)
@@ -9,6 +9,9 @@
 
 #include "smash/grid.h"
 
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
 #include <stdexcept>
 
 #include "smash/algorithms.h"
@@ -83,9 +86,10 @@ static constexpr int LGrid = LogArea::Grid::id;
 ////////////////////////////////////////////////////////////////////////////////
 // GridBase
 
-std::pair<std::array<double, 3>, std::array<double, 3>>
-GridBase::find_min_and_length(const Particles &particles) {
-  std::pair<std::array<double, 3>, std::array<double, 3>> r;
+GridBase::MinAndLength GridBase::find_min_and_length(const Particles &particles,
+                                                     double margin,
+                                                     double min_margin) {
+  MinAndLength r;
   auto &min_position = r.first;
   auto &length = r.second;
 
@@ -106,7 +110,52 @@ GridBase::find_min_and_length(const Particles &particles) {
   length[0] = max_position[0] - min_position[0];
   length[1] = max_position[1] - min_position[1];
   length[2] = max_position[2] - min_position[2];
-  return r;
+  return with_margin(r, margin, min_margin);
+}
+
+GridBase::MinAndLength GridBase::with_margin(MinAndLength min_and_length,
+                                             double margin, double min_margin) {
+  auto &[min_position, length] = min_and_length;
+  if (margin > 0.) {
+    for (int i = 0; i < 3; i++) {
+      const double extension = std::max(margin * length[i], min_margin);
+      min_position[i] -= extension;
+      length[i] += 2 * extension;
+    }
+  }
+  return min_and_length;
+}
+
+/**
+ * Spread the lower 21 bits of \p x, such that two zero bits follow each of
+ * them.
+ *
+ * \param[in] x Bits to spread
+ * \return Spread bits
+ */
+static std::uint64_t spread_bits(std::uint64_t x) {
+  x &= 0x1fffff;
+  x = (x | x << 32) & 0x1f00000000ffff;
+  x = (x | x << 16) & 0x1f0000ff0000ff;
+  x = (x | x << 8) & 0x100f00f00f00f00f;
+  x = (x | x << 4) & 0x10c30c30c30c30c3;
+  x = (x | x << 2) & 0x1249249249249249;
+  return x;
+}
+
+std::uint64_t GridBase::morton_key(const FourVector &position,
+                                   const MinAndLength &box,
+                                   double cell_length) {
+  constexpr double max_index = (1 << 21) - 1;
+  std::uint64_t key = 0;
+  for (int i = 0; i < 3; i++) {
+    const double index =
+        std::floor((position[i + 1] - box.first[i]) / cell_length);
+    key |= spread_bits(static_cast<std::uint64_t>(
+               std::clamp(index, 0., max_index)))
+           << i;
+  }
+  return key;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -118,17 +167,21 @@ Grid<O>::Grid(const std::pair<std::array<double, 3>, std::array<double, 3>>
               const Particles &particles, double max_interaction_length,
               double timestep_duration, CellNumberLimitation limit,
               const bool include_unformed_particles, CellSizeStrategy strategy)
-    : length_(min_and_length.second) {
-  const auto min_position = min_and_length.first;
+    : length_(min_and_length.second),
+      min_position_(min_and_length.first),
+      min_cell_length_(max_interaction_length),
+      include_unformed_particles_(include_unformed_particles ||
+                                  (O == GridOptions::Normal &&
+                                   strategy == CellSizeStrategy::Largest)) {
+  const auto &min_position = min_position_;
   const SizeType particle_count = particles.size();
 
   // very simple setup for non-periodic boundaries and largest cellsize strategy
   if (O == GridOptions::Normal && strategy == CellSizeStrategy::Largest) {
     number_of_cells_ = {1, 1, 1};
     cell_volume_ = length_[0] * length_[1] * length_[2];
-    cells_.clear();
-    cells_.reserve(1);
-    cells_.emplace_back(particles.copy_to_vector());
+    // All particles are placed in the single cell, also the unformed ones
+    sort_into_cells(particles, timestep_duration);
     return;
   }
 
@@ -218,20 +271,7 @@ Grid<O>::Grid(const std::pair<std::array<double, 3>, std::array<double, 3>>
         "particle list.");
     number_of_cells_ = {1, 1, 1};
     cell_volume_ = length_[0] * length_[1] * length_[2];
-    if (include_unformed_particles) {
-      cells_.clear();
-      cells_.reserve(1);
-      cells_.emplace_back(particles.copy_to_vector());
-    } else {
-      // filter out the particles that can not interact
-      cells_.resize(1);
-      cells_.front().reserve(particles.size());
-      std::copy_if(particles.begin(), particles.end(),
-                   std::back_inserter(cells_.front()),
-                   [&](const ParticleData &p) {
-                     return p.xsec_scaling_factor(timestep_duration) > 0.0;
-                   });
-    }
+    sort_into_cells(particles, timestep_duration);
   } else {
     // construct a normal grid
 
@@ -246,44 +286,85 @@ Grid<O>::Grid(const std::pair<std::array<double, 3>, std::array<double, 3>>
 
     // After the grid parameters are determined, we can start placing the
     // particles in cells.
-    cells_.resize(number_of_cells_[0] * number_of_cells_[1] *
-                  number_of_cells_[2]);
-
-    // Returns the one-dimensional cell-index from the position vector inside
-    // the grid.
-    // This simply calculates the distance to min_position and multiplies it
-    // with index_factor to determine the 3 x,y,z indexes to pass to make_index.
-    auto &&cell_index_for = [&](const ParticleData &p) {
-      return make_index(
-          std::floor((p.position()[1] - min_position[0]) * index_factor[0]),
-          std::floor((p.position()[2] - min_position[1]) * index_factor[1]),
-          std::floor((p.position()[3] - min_position[2]) * index_factor[2]));
-    };
-    for (const auto &p : particles) {
-      if (!include_unformed_particles &&
-          (p.xsec_scaling_factor(timestep_duration) <= 0.0)) {
-        continue;
-      }
-      const auto idx = cell_index_for(p);
-#ifndef NDEBUG
-      if (idx >= SizeType(cells_.size())) {
-        logg[LGrid].fatal(
-            SMASH_SOURCE_LOCATION,
-            "\nan out-of-bounds access would be necessary for the "
-            "particle ",
-            p,
-            "\nfor a grid with the following parameters:\nmin: ", min_position,
-            "\nlength: ", length_, "\ncells: ", number_of_cells_,
-            "\nindex_factor: ", index_factor, "\ncells_.size: ", cells_.size(),
-            "\nrequested index: ", idx);
-        throw std::runtime_error("out-of-bounds grid access on construction");
+    index_factor_ = index_factor;
+    if (!sort_into_cells(particles, timestep_duration)) {
+      logg[LGrid].fatal(
+          SMASH_SOURCE_LOCATION,
+          "\nan out-of-bounds access would be necessary for a particle "
+          "for a grid with the following parameters:\nmin: ",
+          min_position, "\nlength: ", length_, "\ncells: ", number_of_cells_,
+          "\nindex_factor: ", index_factor);
+      throw std::runtime_error("out-of-bounds grid access on construction");
+    }
+  }
+
+  logg[LGrid].debug("particles on the grid: ", cell_particles_.size(),
+                    ", cells: ", cell_offsets_.size() - 1);
+}
+
+template <GridOptions O>
+bool Grid<O>::sort_into_cells(
+    const Particles &particles, double timestep_duration,
+    const std::function<bool(const ParticleData &)> &skip) {
+  // This simply calculates the distance to min_position_ and multiplies it
+  // with index_factor_ to determine the 3 x,y,z indexes. For a single cell,
+  // index_factor_ is zero.
+  placing_.clear();
+  placing_.reserve(particles.size());
+  for (const auto &p : particles) {
+    if (!include_unformed_particles_ &&
+        (p.xsec_scaling_factor(timestep_duration) <= 0.0)) {
+      continue;
+    }
+    if (skip && skip(p)) {
+      continue;
+    }
+    std::array<SizeType, 3> idx;
+    for (int i = 0; i < 3; i++) {
+      idx[i] = static_cast<SizeType>(std::floor(
+          (p.position()[i + 1] - min_position_[i]) * index_factor_[i]));
+      if (idx[i] < 0 || idx[i] >= number_of_cells_[i]) {
+        return false;
       }
-#endif
-      cells_[idx].push_back(p);
     }
+    placing_.emplace_back(&p, make_index(idx));
+  }
+
+  const std::size_t n_cells =
+      number_of_cells_[0] * number_of_cells_[1] * number_of_cells_[2];
+  if (placing_ == placed_ && cell_offsets_.size() == n_cells + 1) {
+    // No particle changed its cell, so the cells are still up to date.
+    return true;
   }
+  placed_.swap(placing_);
+
+  // The particles are sorted into the cells by a stable counting sort:
+  // first count the particles per cell, then place the pointers behind the
+  // offsets of their cell, keeping the order of the particles within a cell.
+  cell_offsets_.assign(n_cells + 1, 0);
+  for (const auto &entry : placed_) {
+    cell_offsets_[entry.second + 1]++;
+  }
+  for (std::size_t i = 0; i < n_cells; i++) {
+    cell_offsets_[i + 1] += cell_offsets_[i];
+  }
+  cell_particles_.resize(placed_.size());
+  // next free position in every cell
+  std::vector<std::size_t> next(cell_offsets_.begin(), cell_offsets_.end() - 1);
+  for (const auto &entry : placed_) {
+    cell_particles_[next[entry.second]++] = entry.first;
+  }
+  return true;
+}
 
-  logg[LGrid].debug(cells_);
+template <GridOptions O>
+bool Grid<O>::update(const Particles &particles, double min_cell_length,
+                     double timestep_duration,
+                     const std::function<bool(const ParticleData &)> &skip) {
+  if (min_cell_length != min_cell_length_) {
+    return false;
+  }
+  return sort_into_cells(particles, timestep_duration, skip);
 }
 
 template <GridOptions Options>
@@ -292,6 +373,96 @@ inline typename Grid<Options>::SizeType Grid<Options>::make_index(
   return (z * number_of_cells_[1] + y) * number_of_cells_[0] + x;
 }
 
+template <GridOptions O>
+void Grid<O>::iterate_refined_cells(
+    std::size_t max_occupancy, double min_length,
+    const std::function<void(const ParticleSpan &, double)>
+        &search_cell_callback) const {
+  const std::array<double, 3> cell_length = {
+      length_[0] / number_of_cells_[0], length_[1] / number_of_cells_[1],
+      length_[2] / number_of_cells_[2]};
+  // Pointers to the particles of a crowded cell, reordered by the octants
+  std::vector<const ParticleData *> pointers;
+  std::vector<const ParticleData *> buffer;
+
+  /* Passes the particles pointers[first, first + size), which are inside the
+   * box with the given corner and lengths, to the callback or divides the box
+   * into octants. */
+  const auto refine = [&](const auto &self, std::size_t first,
+                          std::size_t size, const std::array<double, 3> &corner,
+                          const std::array<double, 3> &length) -> void {
+    const std::array<double, 3> half = {0.5 * length[0], 0.5 * length[1],
+                                        0.5 * length[2]};
+    if (size <= max_occupancy ||
+        std::min({half[0], half[1], half[2]}) < min_length) {
+      search_cell_callback(ParticleSpan(pointers.data() + first, size),
+                           length[0] * length[1] * length[2]);
+      return;
+    }
+    const auto octant = [&](const ParticleData *p) {
+      int index = 0;
+      for (int i = 0; i < 3; i++) {
+        if (p->position()[i + 1] >= corner[i] + half[i]) {
+          index |= 1 << i;
+        }
+      }
+      return index;
+    };
+    // stable counting sort by the octants, like sort_into_cells
+    std::array<std::size_t, 9> offsets{};
+    for (std::size_t k = first; k < first + size; k++) {
+      offsets[octant(pointers[k]) + 1]++;
+    }
+    for (int o = 0; o < 8; o++) {
+      offsets[o + 1] += offsets[o];
+    }
+    std::copy(pointers.begin() + first, pointers.begin() + first + size,
+              buffer.begin() + first);
+    std::array<std::size_t, 8> next;
+    std::copy(offsets.begin(), offsets.end() - 1, next.begin());
+    for (std::size_t k = first; k < first + size; k++) {
+      pointers[first + next[octant(buffer[k])]++] = buffer[k];
+    }
+    for (int o = 0; o < 8; o++) {
+      if (offsets[o + 1] == offsets[o]) {
+        continue;
+      }
+      std::array<double, 3> octant_corner = corner;
+      for (int i = 0; i < 3; i++) {
+        if (o & (1 << i)) {
+          octant_corner[i] += half[i];
+        }
+      }
+      self(self, first + offsets[o], offsets[o + 1] - offsets[o],
+           octant_corner, half);
+    }
+  };
+
+  SizeType index = 0;
+  for (SizeType z = 0; z < number_of_cells_[2]; ++z) {
+    for (SizeType y = 0; y < number_of_cells_[1]; ++y) {
+      for (SizeType x = 0; x < number_of_cells_[0]; ++x, ++index) {
+        assert(index == make_index(x, y, z));
+        const ParticleSpan search = cell(index);
+        if (search.empty()) {
+          continue;
+        } else if (search.size() <= max_occupancy) {
+          search_cell_callback(search, cell_volume_);
+          continue;
+        }
+        pointers.assign(cell_particles_.begin() + cell_offsets_[index],
+                        cell_particles_.begin() + cell_offsets_[index + 1]);
+        buffer.resize(pointers.size());
+        const std::array<double, 3> corner = {
+            min_position_[0] + x * cell_length[0],
+            min_position_[1] + y * cell_length[1],
+            min_position_[2] + z * cell_length[2]};
+        refine(refine, 0, pointers.size(), corner, cell_length);
+      }
+    }
+  }
+}
+
 static const std::initializer_list<GridBase::SizeType> ZERO{0};
 static const std::initializer_list<GridBase::SizeType> ZERO_ONE{0, 1};
 static const std::initializer_list<GridBase::SizeType> MINUS_ONE_ZERO{-1, 0};
@@ -301,21 +472,22 @@ static const std::initializer_list<GridBase::SizeType> MINUS_ONE_ZERO_ONE{-1, 0,
 template <>
 /// Specialization of iterate_cells
 void Grid<GridOptions::Normal>::iterate_cells(
-    const std::function<void(const ParticleList &)> &search_cell_callback,
-    const std::function<void(const ParticleList &, const ParticleList &)>
-        &neighbor_cell_callback) const {
+    const std::function<void(const ParticleSpan &)> &search_cell_callback,
+    const std::function<void(const ParticleSpan &, const ParticleSpan &)>
+        &neighbor_cell_callback,
+    SizeType first_layer, SizeType end_layer) const {
   std::array<SizeType, 3> search_index;
   SizeType &x = search_index[0];
   SizeType &y = search_index[1];
   SizeType &z = search_index[2];
-  SizeType search_cell_index = 0;
-  for (z = 0; z < number_of_cells_[2]; ++z) {
+  SizeType search_cell_index = make_index(0, 0, first_layer);
+  for (z = first_layer; z < end_layer; ++z) {
     for (y = 0; y < number_of_cells_[1]; ++y) {
       for (x = 0; x < number_of_cells_[0]; ++x, ++search_cell_index) {
         assert(search_cell_index == make_index(search_index));
         assert(search_cell_index >= 0);
-        assert(search_cell_index < SizeType(cells_.size()));
-        const ParticleList &search = cells_[search_cell_index];
+        assert(search_cell_index < SizeType(cell_offsets_.size() - 1));
+        const ParticleSpan search = cell(search_cell_index);
         search_cell_callback(search);
 
         const auto &dz_list = z == number_of_cells_[2] - 1 ? ZERO : ZERO_ONE;
@@ -334,7 +506,7 @@ void Grid<GridOptions::Normal>::iterate_cells(
             for (SizeType dx : dx_list) {
               const auto di = make_index(dx, dy, dz);
               if (di > 0) {
-                neighbor_cell_callback(search, cells_[search_cell_index + di]);
+                neighbor_cell_callback(search, cell(search_cell_index + di));
               }
             }
           }
@@ -365,14 +537,15 @@ struct NeighborLookup {
 template <>
 /// Specialization of iterate_cells
 void Grid<GridOptions::PeriodicBoundaries>::iterate_cells(
-    const std::function<void(const ParticleList &)> &search_cell_callback,
-    const std::function<void(const ParticleList &, const ParticleList &)>
-        &neighbor_cell_callback) const {
+    const std::function<void(const ParticleSpan &)> &search_cell_callback,
+    const std::function<void(const ParticleSpan &, const ParticleSpan &)>
+        &neighbor_cell_callback,
+    SizeType first_layer, SizeType end_layer) const {
   std::array<SizeType, 3> search_index;
   SizeType &x = search_index[0];
   SizeType &y = search_index[1];
   SizeType &z = search_index[2];
-  SizeType search_cell_index = 0;
+  SizeType search_cell_index = make_index(0, 0, first_layer);
 
   // defaults:
   std::array<NeighborLookup, 2> dz_list;
@@ -383,7 +556,13 @@ void Grid<GridOptions::PeriodicBoundaries>::iterate_cells(
   assert(number_of_cells_[1] >= 2);
   assert(number_of_cells_[0] >= 2);
 
-  for (z = 0; z < number_of_cells_[2]; ++z) {
+  /* The search cell is translated when wrapping around the grid, so only
+   * then its particles are copied. The copies are kept for all cells, such
+   * that the memory is only allocated for the largest boundary cell. */
+  ParticleList search_particles;
+  std::vector<const ParticleData *> search_pointers;
+
+  for (z = first_layer; z < end_layer; ++z) {
     dz_list[0].index = z;
     dz_list[1].index = z + 1;
     if (dz_list[1].index == number_of_cells_[2]) {
@@ -420,9 +599,12 @@ void Grid<GridOptions::PeriodicBoundaries>::iterate_cells(
 
         assert(search_cell_index == make_index(search_index));
         assert(search_cell_index >= 0);
-        assert(search_cell_index < SizeType(cells_.size()));
-        ParticleList search = cells_[search_cell_index];
-        search_cell_callback(search);
+        assert(search_cell_index < SizeType(cell_offsets_.size() - 1));
+        const ParticleSpan original = cell(search_cell_index);
+        search_cell_callback(original);
+
+        ParticleSpan search = original;
+        bool copied = false;
 
         auto virtual_search_index = search_index;
         ThreeVector wrap_vector = {};  // no change
@@ -461,7 +643,7 @@ void Grid<GridOptions::PeriodicBoundaries>::iterate_cells(
               const auto neighbor_cell_index =
                   make_index(dx.index, dy.index, dz.index);
               assert(neighbor_cell_index >= 0);
-              assert(neighbor_cell_index < SizeType(cells_.size()));
+              assert(neighbor_cell_index < SizeType(cell_offsets_.size() - 1));
               if (neighbor_cell_index <= make_index(virtual_search_index)) {
                 continue;
               }
@@ -469,12 +651,22 @@ void Grid<GridOptions::PeriodicBoundaries>::iterate_cells(
               if (wrap_vector != current_wrap_vector) {
                 logg[LGrid].debug("translating search cell by ",
                                   wrap_vector - current_wrap_vector);
-                for_each(search, [&](ParticleData &p) {
-                  p = p.translated(wrap_vector - current_wrap_vector);
-                });
+                if (!copied) {
+                  search_particles.assign(original.begin(), original.end());
+                  search_pointers.clear();
+                  for (const ParticleData &p : search_particles) {
+                    search_pointers.push_back(&p);
+                  }
+                  search = ParticleSpan(search_pointers);
+                  copied = true;
+                }
+                // Translated from the cell, such that no rounding errors add up
+                for (std::size_t i = 0; i < original.size(); i++) {
+                  search_particles[i] = original[i].translated(wrap_vector);
+                }
                 current_wrap_vector = wrap_vector;
               }
-              neighbor_cell_callback(search, cells_[neighbor_cell_index]);
+              neighbor_cell_callback(search, cell(neighbor_cell_index));
             }
             virtual_search_index[0] = search_index[0];
             wrap_vector[0] = 0;
@@ -499,4 +691,20 @@ template Grid<GridOptions::PeriodicBoundaries>::Grid(
     const Particles &particles, double max_interaction_length,
     double timestep_duration, CellNumberLimitation limit,
     const bool include_unformed_particles, CellSizeStrategy strategy);
+template void Grid<GridOptions::Normal>::iterate_refined_cells(
+    std::size_t max_occupancy, double min_length,
+    const std::function<void(const ParticleSpan &, double)>
+        &search_cell_callback) const;
+template void Grid<GridOptions::PeriodicBoundaries>::iterate_refined_cells(
+    std::size_t max_occupancy, double min_length,
+    const std::function<void(const ParticleSpan &, double)>
+        &search_cell_callback) const;
+template bool Grid<GridOptions::Normal>::update(
+    const Particles &particles, double min_cell_length,
+    double timestep_duration,
+    const std::function<bool(const ParticleData &)> &skip);
+template bool Grid<GridOptions::PeriodicBoundaries>::update(
+    const Particles &particles, double min_cell_length,
+    double timestep_duration,
+    const std::function<bool(const ParticleData &)> &skip);
 }  // namespace smash
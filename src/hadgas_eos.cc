@@ -1,6 +1,6 @@
 /*
  *
- *    Copyright (c) 2016-2020,2022
+ *    Copyright (c) 2016-2020,2022,2024
  *      SMASH Team
  *
  *    GNU General Public License (GPLv3 or later)
@@ -9,18 +9,24 @@
 
 #include "smash/hadgas_eos.h"
 
+#include <unistd.h>
+
+#include <algorithm>
+#include <cstring>
 #include <filesystem>
 #include <fstream>
-#include <iomanip>
 #include <iostream>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
 
 #include "gsl/gsl_sf_bessel.h"
 
 #include "smash/constants.h"
 #include "smash/integrate.h"
-#include "smash/interpolation.h"
 #include "smash/logging.h"
 #include "smash/random.h"
+#include "smash/threadpool.h"
 
 namespace smash {
 static constexpr int LResonances = LogArea::Resonances::id;
@@ -31,134 +37,160 @@ EosTable::EosTable(double de, double dnb, double dq, size_t n_e, size_t n_nb,
   table_.resize(n_e_ * n_nb_ * n_q_);
 }
 
-void EosTable::compile_table(HadronGasEos &eos,
-                             const std::string &eos_savefile_name) {
-  bool table_read_success = false, table_consistency = true;
-  if (std::filesystem::exists(eos_savefile_name)) {
-    std::cout << "Reading table from file " << eos_savefile_name << std::endl;
-    std::ifstream file;
-    file.open(eos_savefile_name, std::ios::in);
-    file >> de_ >> dnb_ >> dq_;
-    file >> n_e_ >> n_nb_ >> n_q_;
-    table_.resize(n_e_ * n_nb_ * n_q_);
-    for (size_t ie = 0; ie < n_e_; ie++) {
-      for (size_t inb = 0; inb < n_nb_; inb++) {
-        for (size_t iq = 0; iq < n_q_; iq++) {
-          double p, T, mub, mus, muq;
-          file >> p >> T >> mub >> mus >> muq;
-          table_[index(ie, inb, iq)] = {p, T, mub, mus, muq};
-        }
-      }
+sha256::Hash EosTable::hash(bool account_for_widths) const {
+  sha256::Context context;
+  auto add = [&context](const auto &x) {
+    context.update(reinterpret_cast<const uint8_t *>(&x), sizeof(x));
+  };
+  add(de_);
+  add(dnb_);
+  add(dq_);
+  add(static_cast<std::uint64_t>(n_e_));
+  add(static_cast<std::uint64_t>(n_nb_));
+  add(static_cast<std::uint64_t>(n_q_));
+  add(static_cast<std::uint8_t>(account_for_widths));
+  for (const ParticleType &ptype : ParticleType::list_all()) {
+    if (HadronGasEos::is_eos_particle(ptype)) {
+      add(ptype.pdgcode().get_decimal());
+      add(ptype.mass());
+      add(ptype.width_at_pole());
     }
-    table_read_success = true;
-    std::cout << "Table consumed successfully." << std::endl;
   }
+  return context.finalize();
+}
 
-  if (table_read_success) {
-    // Check if the saved table is consistent with the current particle table
-    std::cout << "Checking consistency of the table... " << std::endl;
-    constexpr size_t number_of_steps = 50;
-    const size_t ie_step = 1 + n_e_ / number_of_steps;
-    const size_t inb_step = 1 + n_nb_ / number_of_steps;
-    const size_t iq_step = 1 + n_q_ / number_of_steps;
-    for (size_t ie = 0; ie < n_e_; ie += ie_step) {
-      for (size_t inb = 0; inb < n_nb_; inb += inb_step) {
-        for (size_t iq = 0; iq < n_q_; iq += iq_step) {
-          const table_element x = table_[index(ie, inb, iq)];
-          const bool w = eos.account_for_resonance_widths();
-          const double e_comp = eos.energy_density(x.T, x.mub, x.mus, x.muq);
-          const double nb_comp =
-              eos.net_baryon_density(x.T, x.mub, x.mus, x.muq, w);
-          const double ns_comp =
-              eos.net_strange_density(x.T, x.mub, x.mus, x.muq, w);
-          const double p_comp = eos.pressure(x.T, x.mub, x.mus, x.muq, w);
-          const double nq_comp =
-              eos.net_charge_density(x.T, x.mub, x.mus, x.muq, w);
-          // Precision is just 10^-3, this is precision of saved data in the
-          // file
-          const double eps = 1.e-3;
-          // Only check the physical region, hence T > 0 condition
-          if ((std::abs(de_ * ie - e_comp) > eps ||
-               std::abs(dnb_ * inb - nb_comp) > eps ||
-               std::abs(ns_comp) > eps || std::abs(x.p - p_comp) > eps ||
-               std::abs(dq_ * iq - nq_comp) > eps) &&
-              (x.T > 0.0)) {
-            std::cout << "discrepancy: " << de_ * ie << " = " << e_comp << ", "
-                      << dnb_ * inb << " = " << nb_comp << ", " << x.p << " = "
-                      << p_comp << ", 0 = " << ns_comp << ", " << dq_ * iq
-                      << " = " << nq_comp << std::endl;
-            table_consistency = false;
-            goto finish_consistency_check;
-          }
-        }
-      }
+bool EosTable::read(const std::string &path, const sha256::Hash &hash) {
+  static_assert(sizeof(table_element) == 5 * sizeof(double),
+                "The table elements are stored as five doubles.");
+  std::ifstream file(path, std::ios::binary | std::ios::ate);
+  if (!file) {
+    return false;
+  }
+  const std::size_t table_size = table_.size() * sizeof(table_element);
+  const std::size_t header_size =
+      sizeof(magic) + sizeof(version) + sizeof(sha256::Hash);
+  if (static_cast<std::size_t>(file.tellg()) != header_size + table_size) {
+    return false;
+  }
+  file.seekg(0);
+  char file_magic[sizeof(magic)];
+  std::uint64_t file_version = 0;
+  sha256::Hash file_hash;
+  file.read(file_magic, sizeof(file_magic));
+  file.read(reinterpret_cast<char *>(&file_version), sizeof(file_version));
+  file.read(reinterpret_cast<char *>(file_hash.data()), file_hash.size());
+  if (!file || std::memcmp(file_magic, magic, sizeof(magic)) != 0 ||
+      file_version != version || file_hash != hash) {
+    return false;
+  }
+  return static_cast<bool>(
+      file.read(reinterpret_cast<char *>(table_.data()), table_size));
+}
+
+void EosTable::write(const std::string &path, const sha256::Hash &hash) const {
+  // Concurrent jobs may write the same table
+  const std::string temporary = path + ".tmp" + std::to_string(::getpid());
+  {
+    std::ofstream file(temporary, std::ios::binary);
+    file.write(magic, sizeof(magic));
+    file.write(reinterpret_cast<const char *>(&version), sizeof(version));
+    file.write(reinterpret_cast<const char *>(hash.data()), hash.size());
+    file.write(reinterpret_cast<const char *>(table_.data()),
+               table_.size() * sizeof(table_element));
+    if (!file) {
+      throw std::runtime_error("Could not write EoS table to " + temporary);
     }
   }
-finish_consistency_check:
-
-  if (!table_read_success || !table_consistency) {
-    std::cout << "Compiling an EoS table..." << std::endl;
-    const double ns = 0.0;
-    for (size_t ie = 0; ie < n_e_; ie++) {
-      std::cout << ie << "/" << n_e_ << "\r" << std::flush;
-      const double e = de_ * ie;
-      for (size_t inb = 0; inb < n_nb_; inb++) {
-        const double nb = dnb_ * inb;
-        for (size_t iq = 0; iq < n_q_; iq++) {
-          const double q = dq_ * iq;
-          // It is physically impossible to have energy density > nucleon
-          // mass*nb, therefore eqns have no solutions.
-          if (nb >= e || q >= e) {
-            table_[index(ie, inb, iq)] = {0.0, 0.0, 0.0, 0.0, 0.0};
-            continue;
-          }
-          // Take extrapolated (T, mub, mus, muq) as initial approximation
-          std::array<double, 4> init_approx;
-          if (inb >= 2) {
-            const table_element y = table_[index(ie, inb - 2, iq)];
-            const table_element x = table_[index(ie, inb - 1, iq)];
-            init_approx = {2.0 * x.T - y.T, 2.0 * x.mub - y.mub,
-                           2.0 * x.mus - y.mus, 2.0 * x.muq - y.muq};
-          } else if (iq >= 2) {
-            const table_element y = table_[index(ie, inb, iq - 2)];
-            const table_element x = table_[index(ie, inb, iq - 1)];
-            init_approx = {2.0 * x.T - y.T, 2.0 * x.mub - y.mub,
-                           2.0 * x.mus - y.mus, 2.0 * x.muq - y.muq};
-          } else {
-            init_approx = eos.solve_eos_initial_approximation(e, nb, q);
-          }
-          const std::array<double, 4> res =
-              eos.solve_eos(e, nb, ns, q, init_approx);
-          const double T = res[0];
-          const double mub = res[1];
-          const double mus = res[2];
-          const double muq = res[3];
-          const bool w = eos.account_for_resonance_widths();
-          table_[index(ie, inb, iq)] = {eos.pressure(T, mub, mus, muq, w), T,
-                                        mub, mus, muq};
-        }
+  std::filesystem::rename(temporary, path);
+}
+
+void EosTable::compile_slice(size_t ie, HadronGasEos &eos) {
+  const double ns = 0.0;
+  const double e = de_ * ie;
+  const bool w = eos.account_for_resonance_widths();
+  // Only nodes with a solution, i.e. T > 0, are used as starting points
+  auto solved = [this, ie](size_t inb, size_t iq) {
+    return table_[index(ie, inb, iq)].T > 0.0;
+  };
+  auto extrapolate = [](const table_element &x, const table_element &y) {
+    return std::array<double, 4>{2.0 * x.T - y.T, 2.0 * x.mub - y.mub,
+                                 2.0 * x.mus - y.mus, 2.0 * x.muq - y.muq};
+  };
+  auto take = [](const table_element &x) {
+    return std::array<double, 4>{x.T, x.mub, x.mus, x.muq};
+  };
+  for (size_t inb = 0; inb < n_nb_; inb++) {
+    const double nb = dnb_ * inb;
+    for (size_t iq = 0; iq < n_q_; iq++) {
+      const double q = dq_ * iq;
+      // It is physically impossible to have energy density > nucleon
+      // mass*nb, therefore eqns have no solutions.
+      if (nb >= e || q >= e) {
+        table_[index(ie, inb, iq)] = {0.0, 0.0, 0.0, 0.0, 0.0};
+        continue;
       }
-    }
-    // Save table to file
-    std::cout << "Saving table to file " << eos_savefile_name << std::endl;
-    std::ofstream file;
-    file.open(eos_savefile_name, std::ios::out);
-    file << de_ << " " << dnb_ << " " << dq_ << std::endl;
-    file << n_e_ << " " << n_nb_ << " " << n_q_ << std::endl;
-    file << std::setprecision(7);
-    file << std::fixed;
-    for (size_t ie = 0; ie < n_e_; ie++) {
-      for (size_t inb = 0; inb < n_nb_; inb++) {
-        for (size_t iq = 0; iq < n_q_; iq++) {
-          const EosTable::table_element x = table_[index(ie, inb, iq)];
-          file << x.p << " " << x.T << " " << x.mub << " " << x.mus << " "
-               << x.muq << std::endl;
-        }
+      // Start from the solved neighbours, extrapolated if possible
+      std::array<double, 4> init_approx;
+      bool from_neighbours = true;
+      if (inb >= 2 && solved(inb - 1, iq) && solved(inb - 2, iq)) {
+        init_approx = extrapolate(table_[index(ie, inb - 1, iq)],
+                                  table_[index(ie, inb - 2, iq)]);
+      } else if (iq >= 2 && solved(inb, iq - 1) && solved(inb, iq - 2)) {
+        init_approx = extrapolate(table_[index(ie, inb, iq - 1)],
+                                  table_[index(ie, inb, iq - 2)]);
+      } else if (inb >= 1 && solved(inb - 1, iq)) {
+        init_approx = take(table_[index(ie, inb - 1, iq)]);
+      } else if (iq >= 1 && solved(inb, iq - 1)) {
+        init_approx = take(table_[index(ie, inb, iq - 1)]);
+      } else {
+        init_approx = eos.solve_eos_initial_approximation(e, nb, q);
+        from_neighbours = false;
       }
+      std::array<double, 4> res = eos.solve_eos(e, nb, ns, q, init_approx);
+      if (res[0] <= 0.0 && from_neighbours) {
+        // The neighbours were not close enough, start over
+        res = eos.solve_eos(e, nb, ns, q,
+                            eos.solve_eos_initial_approximation(e, nb, q));
+      }
+      const double T = res[0];
+      const double mub = res[1];
+      const double mus = res[2];
+      const double muq = res[3];
+      table_[index(ie, inb, iq)] = {eos.pressure(T, mub, mus, muq, w), T, mub,
+                                    mus, muq};
     }
   }
 }
 
+void EosTable::compile_table(HadronGasEos &eos,
+                             const std::string &eos_savefile_name) {
+  const bool w = eos.account_for_resonance_widths();
+  const sha256::Hash table_hash = hash(w);
+  if (read(eos_savefile_name, table_hash)) {
+    std::cout << "Read EoS table from file " << eos_savefile_name << std::endl;
+    return;
+  }
+
+  const int n_threads =
+      std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
+  std::cout << "Compiling an EoS table with " << n_threads << " threads..."
+            << std::endl;
+  // All lazily evaluated quantities must be ready before threads start
+  ParticleType::initialize_lazy_members();
+  ThreadPool pool(n_threads);
+  std::mutex progress_mutex;
+  size_t n_done = 0;
+  pool.parallel_for(static_cast<int>(n_e_), [&](int ie) {
+    // Every thread needs its own solver
+    HadronGasEos slice_eos(false, w);
+    compile_slice(ie, slice_eos);
+    std::lock_guard<std::mutex> lock(progress_mutex);
+    std::cout << ++n_done << "/" << n_e_ << "\r" << std::flush;
+  });
+  std::cout << "Saving table to file " << eos_savefile_name << std::endl;
+  write(eos_savefile_name, table_hash);
+}
+
 void EosTable::get(EosTable::table_element &res, double e, double nb,
                    double q) const {
   const size_t ie = static_cast<size_t>(std::floor(e / de_));
@@ -172,25 +204,27 @@ void EosTable::get(EosTable::table_element &res, double e, double nb,
     const double ae = e / de_ - ie;
     const double an = nb / dnb_ - inb;
     const double aq = q / dq_ - iq;
-    const EosTable::table_element s1 = table_[index(ie, inb, iq)];
-    const EosTable::table_element s2 = table_[index(ie + 1, inb, iq)];
-    const EosTable::table_element s3 = table_[index(ie, inb + 1, iq)];
-    const EosTable::table_element s4 = table_[index(ie + 1, inb + 1, iq)];
-    const EosTable::table_element s5 = table_[index(ie, inb, iq + 1)];
-    const EosTable::table_element s6 = table_[index(ie + 1, inb, iq + 1)];
-    const EosTable::table_element s7 = table_[index(ie, inb + 1, iq + 1)];
-    const EosTable::table_element s8 = table_[index(ie + 1, inb + 1, iq + 1)];
-
-    res.p = interpolate_trilinear(ae, an, aq, s1.p, s2.p, s3.p, s4.p, s5.p,
-                                  s6.p, s7.p, s8.p);
-    res.T = interpolate_trilinear(ae, an, aq, s1.T, s2.T, s3.T, s4.T, s5.T,
-                                  s6.T, s7.T, s8.T);
-    res.mub = interpolate_trilinear(ae, an, aq, s1.mub, s2.mub, s3.mub, s4.mub,
-                                    s5.mub, s6.mub, s7.mub, s8.mub);
-    res.mus = interpolate_trilinear(ae, an, aq, s1.mus, s2.mus, s3.mus, s4.mus,
-                                    s5.mus, s6.mus, s7.mus, s8.mus);
-    res.muq = interpolate_trilinear(ae, an, aq, s1.muq, s2.muq, s3.muq, s4.muq,
-                                    s5.muq, s6.muq, s7.muq, s8.muq);
+    /* The weights of the corners are shared by all quantities, which are
+     * accumulated together corner by corner. */
+    const double weights[8] = {
+        (1.0 - ae) * (1.0 - an) * (1.0 - aq), ae * (1.0 - an) * (1.0 - aq),
+        (1.0 - ae) * an * (1.0 - aq),         ae * an * (1.0 - aq),
+        (1.0 - ae) * (1.0 - an) * aq,         ae * (1.0 - an) * aq,
+        (1.0 - ae) * an * aq,                 ae * an * aq};
+    const size_t corners[8] = {
+        index(ie, inb, iq),         index(ie + 1, inb, iq),
+        index(ie, inb + 1, iq),     index(ie + 1, inb + 1, iq),
+        index(ie, inb, iq + 1),     index(ie + 1, inb, iq + 1),
+        index(ie, inb + 1, iq + 1), index(ie + 1, inb + 1, iq + 1)};
+    res = {0.0, 0.0, 0.0, 0.0, 0.0};
+    for (int k = 0; k < 8; k++) {
+      const EosTable::table_element &s = table_[corners[k]];
+      res.p += weights[k] * s.p;
+      res.T += weights[k] * s.T;
+      res.mub += weights[k] * s.mub;
+      res.mus += weights[k] * s.mus;
+      res.muq += weights[k] * s.muq;
+    }
   }
 }
 
@@ -252,7 +286,8 @@ double HadronGasEos::scaled_partial_density(const ParticleType &ptype,
     const double mth = ptype.min_mass_spectral();
     const double u_min = std::atan(2.0 * (mth - m0) / w0);
     const double u_max = 0.5 * M_PI;
-    Integrator integrate;
+    // The workspace is kept for the many densities needed by the EoS table
+    static thread_local Integrator integrate;
     const double result =
         g * integrate(u_min, u_max, [&](double u) {
           // One of many possible variable substitutions. Not clear if it has
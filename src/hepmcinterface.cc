@@ -1,7 +1,7 @@
 /*
  *
  *    Copyright (c) 2021 Christian Holm Christensen
- *    Copyright (c) 2021-2022
+ *    Copyright (c) 2021-2022,2024
  *      SMASH Team
  *
  *    GNU General Public License (GPLv3 or later)
@@ -57,18 +57,11 @@ HepMcInterface::HepMcInterface(const std::string& name, const bool full_event)
 void HepMcInterface::at_eventstart(const Particles& particles,
                                    const int event_number,
                                    const EventInfo& event) {
-  // Clear event and mapping and set event number
-  clear();
-
-  // Set header stuff on event
-  ion_->impact_parameter = event.impact_parameter;
-  xs_->set_cross_section(1, 1);  // Dummy values
-  event_.set_event_number(event_number);
-  event_.set_heavy_ion(ion_);
-
-  // Create IP only if final state
-  ip_ = std::make_shared<HepMC3::GenVertex>();
-  event_.add_vertex(ip_);
+  log_.clear();
+  log_.event_number = event_number;
+  log_.impact_parameter = event.impact_parameter;
+  log_.event_weight = event.event_weight;
+  log_.particles.reserve(particles.size());
 
   // Count up projectile and target
   smash::FourVector p_proj;
@@ -106,72 +99,125 @@ void HepMcInterface::at_eventstart(const Particles& particles,
     // modus) of the vertex.  In that way, we will keep track of
     // participants and spectators as well as make the event
     // structure consistent.
-    auto op = make_register(data, Status::fnal);
-    if (is_coll) {
-      ip_->add_particle_out(op);
-    } else {
-      ip_->add_particle_in(op);
-    }
+    log_particle(data);
   }
+  log_.n_initial = log_.particles.size();
 
-  coll_.resize(az_proj.first + az_targ.first);
-  // Make beam particles
+  log_.n_nucleons = az_proj.first + az_targ.first;
   if (is_coll) {
-    auto proj = make_gen(ion_pdg(az_proj), Status::beam, p_proj);
-    auto targ = make_gen(ion_pdg(az_targ), Status::beam, p_targ);
-
-    // Add to interaction point if we need to
-    ip_->add_particle_in(proj);
-    ip_->add_particle_in(targ);
+    log_.beams[0] = {ion_pdg(az_proj), p_proj};
+    log_.beams[1] = {ion_pdg(az_targ), p_targ};
   }
 }
 
 void HepMcInterface::at_interaction(const Action& action,
                                     const double /* density */) {
-  HepMC3::GenVertexPtr vp;
-  auto type = action.get_type();
-  int status = get_status(type);
-
-  if (full_event_) {
-    FourVector v = action.get_interaction_point();
-    vp = std::make_shared<HepMC3::GenVertex>(
-        HepMC3::FourVector(v.x1(), v.x2(), v.x3(), v.x0()));
-    event_.add_vertex(vp);
-    vp->add_attribute("weight", std::make_shared<HepMC3::FloatAttribute>(
-                                    action.get_total_weight()));
-    vp->add_attribute(
-        "partial_weight",
-        std::make_shared<HepMC3::FloatAttribute>(action.get_partial_weight()));
-  }
-
-  // Now mark participants
-  if (full_event_) {
-    for (auto& i : action.incoming_particles()) {
-      // Create tree
-      HepMC3::GenParticlePtr ip = find_or_make(i, status);
-      ip->set_status(status);
-      vp->add_particle_in(ip);
-    }
-  } else {
+  if (!full_event_) {
     return;
   }
-
-  // Add outgoing particles
-  for (auto& o : action.outgoing_particles()) {
-    vp->add_particle_out(make_register(o, Status::fnal));
+  const ParticleList& incoming = action.incoming_particles();
+  const ParticleList& outgoing = action.outgoing_particles();
+  log_.interactions.push_back({action.get_interaction_point(),
+                               get_status(action.get_type()),
+                               action.get_total_weight(),
+                               action.get_partial_weight(),
+                               static_cast<std::uint32_t>(incoming.size()),
+                               static_cast<std::uint32_t>(outgoing.size())});
+  for (auto& i : incoming) {
+    log_particle(i);
+  }
+  for (auto& o : outgoing) {
+    log_particle(o);
   }
 }
 
 void HepMcInterface::at_eventend(const Particles& particles,
                                  const int32_t /*event_number*/,
                                  const EventInfo& event) {
-  // We evaluate if it is a heavy ion collision event
-  bool is_coll = (event.impact_parameter >= 0.0);
+  log_eventend(particles, event);
+  build_event(log_);
+}
+
+void HepMcInterface::log_eventend(const Particles& particles,
+                                  const EventInfo& event) {
+  log_.empty_event = event.empty_event;
+  // Note, we should already have the particles if not only final state
+  for (auto& p : particles) {
+    log_particle(p);
+  }
+}
+
+void HepMcInterface::log_particle(const ParticleData& p) {
+  log_.particles.push_back({p.id(), p.pdgcode().get_decimal(), p.momentum(),
+                            p.type().mass()});
+}
+
+void HepMcInterface::build_event(const EventLog& log) {
+  // Clear event and mapping and set event number
+  clear();
+  bool is_coll = (log.impact_parameter >= 0.0);
   // In case this was an empty event
-  if (event.empty_event && is_coll) {
-    clear();
+  if (log.empty_event && is_coll) {
     return;
   }
+  // The beam particles and the interaction point are not in the log
+  event_.reserve(log.particles.size() + 2, log.interactions.size() + 1);
+  map_.reserve(log.particles.size());
+
+  // Set header stuff on event
+  ion_->impact_parameter = log.impact_parameter;
+  xs_->set_cross_section(1, 1);  // Dummy values
+  event_.set_event_number(log.event_number);
+  event_.weights() = {log.event_weight};
+  event_.set_heavy_ion(ion_);
+
+  // Create IP only if final state
+  ip_ = std::make_shared<HepMC3::GenVertex>();
+  event_.add_vertex(ip_);
+
+  auto p = log.particles.begin();
+  for (std::size_t i = 0; i < log.n_initial; i++, p++) {
+    auto op = make_register(*p, Status::fnal);
+    if (is_coll) {
+      ip_->add_particle_out(op);
+    } else {
+      ip_->add_particle_in(op);
+    }
+  }
+
+  coll_.resize(log.n_nucleons);
+  // Make beam particles
+  if (is_coll) {
+    for (const auto& nucleus : log.beams) {
+      // Add to interaction point if we need to
+      ip_->add_particle_in(
+          make_gen(nucleus.first, Status::beam, nucleus.second));
+    }
+  }
+
+  for (const LoggedInteraction& interaction : log.interactions) {
+    const FourVector& v = interaction.point;
+    auto vp = std::make_shared<HepMC3::GenVertex>(
+        HepMC3::FourVector(v.x1(), v.x2(), v.x3(), v.x0()));
+    event_.add_vertex(vp);
+    vp->add_attribute("weight", std::make_shared<HepMC3::FloatAttribute>(
+                                    interaction.weight));
+    vp->add_attribute("partial_weight",
+                      std::make_shared<HepMC3::FloatAttribute>(
+                          interaction.partial_weight));
+    // Now mark participants
+    for (std::uint32_t i = 0; i < interaction.n_in; i++, p++) {
+      // Create tree
+      HepMC3::GenParticlePtr ip = find_or_make(*p, interaction.status);
+      ip->set_status(interaction.status);
+      vp->add_particle_in(ip);
+    }
+    // Add outgoing particles
+    for (std::uint32_t i = 0; i < interaction.n_out; i++, p++) {
+      vp->add_particle_out(make_register(*p, Status::fnal));
+    }
+  }
+
   // Set the weights
   event_.weights() = std::vector<double>(1, 1);
   /* since the number of collisions is not an experimental obervable, we set it
@@ -191,12 +237,12 @@ void HepMcInterface::at_eventend(const Particles& particles,
   // Note, we should already have the particles if not only final
   // state
   // Take all passed particles and add as outgoing particles to event
-  for (auto& p : particles) {
+  for (; p != log.particles.end(); p++) {
     if (!full_event_) {
-      auto h = make_register(p, Status::fnal);
+      auto h = make_register(*p, Status::fnal);
       ip_->add_particle_out(h);
-    } else if (map_.find(p.id()) == map_.end()) {
-      throw std::runtime_error("Dangling particle " + std::to_string(p.id()));
+    } else if (map_.find(p->id) == map_.end()) {
+      throw std::runtime_error("Dangling particle " + std::to_string(p->id));
     }
   }
 }
@@ -228,22 +274,19 @@ HepMC3::GenParticlePtr HepMcInterface::make_gen(int pid, int status,
   return p;
 }
 
-HepMC3::GenParticlePtr HepMcInterface::make_register(const ParticleData& p,
+HepMC3::GenParticlePtr HepMcInterface::make_register(const LoggedParticle& p,
                                                      int status) {
-  int id = p.id();
-  auto h = make_gen(p.pdgcode().get_decimal(), status, p.momentum(),
-                    p.type().mass());
-  map_[id] = h;
+  auto h = make_gen(p.pdg, status, p.momentum, p.mass);
+  map_[p.id] = h;
 
   return h;
 }
 
-HepMC3::GenParticlePtr HepMcInterface::find_or_make(const ParticleData& p,
+HepMC3::GenParticlePtr HepMcInterface::find_or_make(const LoggedParticle& p,
                                                     int status,
                                                     bool force_new) {
-  int id = p.id();
   if (!force_new) {
-    auto it = map_.find(id);
+    auto it = map_.find(p.id);
     if (it != map_.end()) {
       return it->second;
     }
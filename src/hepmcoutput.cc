@@ -1,6 +1,6 @@
 /*
  *
- *    Copyright (c) 2020-2023
+ *    Copyright (c) 2020-2024
  *      SMASH Team
  *
  *    GNU General Public License (GPLv3 or later)
@@ -9,6 +9,8 @@
 
 #include "smash/hepmcoutput.h"
 
+#include <utility>
+
 #include "HepMC3/Print.h"
 #include "HepMC3/WriterAscii.h"
 
@@ -268,6 +270,12 @@ HepMcOutput::HepMcOutput(const std::filesystem::path &path, std::string name,
 #endif
 }
 HepMcOutput::~HepMcOutput() {
+  try {
+    finish_writing();
+  } catch (const std::exception &e) {
+    logg[LOutput].error() << "Writing the last event failed: " << e.what()
+                          << std::endl;
+  }
   logg[LOutput].debug() << "Renaming file " << filename_unfinished_ << " to "
                         << filename_ << std::endl;
   output_file_->close();
@@ -277,12 +285,24 @@ HepMcOutput::~HepMcOutput() {
 void HepMcOutput::at_eventend(const Particles &particles,
                               const int32_t event_number,
                               const EventInfo &event) {
-  HepMcInterface::at_eventend(particles, event_number, event);
+  log_eventend(particles, event);
+  finish_writing();
   logg[LOutput].debug() << "Writing event " << event_number << " with "
-                        << event_.particles().size() << " particles and "
-                        << event_.vertices().size() << " vertices to output "
-                        << std::endl;
-  output_file_->write_event(event_);
+                        << log_.particles.size() << " logged particles and "
+                        << log_.interactions.size()
+                        << " interactions to output " << std::endl;
+  // the buffers of both logs are kept for the next events
+  std::swap(log_, written_log_);
+  writing_ = std::async(std::launch::async, [this]() {
+    build_event(written_log_);
+    output_file_->write_event(event_);
+  });
+}
+
+void HepMcOutput::finish_writing() {
+  if (writing_.valid()) {
+    writing_.get();
+  }
 }
 
 }  // namespace smash
@@ -0,0 +1,323 @@
+/*
+ *
+ *    Copyright (c) 2024
+ *      SMASH Team
+ *
+ *    GNU General Public License (GPLv3 or later)
+ *
+ */
+
+#include "smash/histogramoutput.h"
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <ios>
+#include <stdexcept>
+
+#include "smash/action.h"
+#include "smash/particles.h"
+
+namespace smash {
+
+/*!\Userguide
+ * \page doxypage_output_histograms
+ *
+ * The `Histograms` content with the `YODA` format fills histograms of the
+ * final particles and of the interactions directly during the run and writes
+ * them to the file `Histograms.yoda` at its end. Nothing is written per event,
+ * which saves the particles output and its analysis, if only these
+ * distributions are needed. The file is written in the text format of YODA
+ * (https://yoda.hepforge.org/) and can be read and converted e.g. to ROOT
+ * files with the YODA tools.
+ *
+ * Every ensemble counts as an event. The histograms are divided by the number
+ * of events, such that YODA shows the distributions per event. Events with a
+ * weight, see \ref key_MC_impact_weighted_, enter the histograms and the
+ * number of events with their weight. The histogrammed
+ * quantities are chosen with \key Quantities, see
+ * \ref input_output_histograms_ for all options:
+ * - `"Rapidity"` &rarr; `/SMASH/dN_dy`: rapidity distribution of the final
+ *   particles
+ * - `"Transverse_Momentum"` &rarr; `/SMASH/dN_dpT`: transverse momentum
+ *   distribution of the final particles within the rapidity range
+ * - `"Rapidity_Transverse_Momentum"` &rarr; `/SMASH/d2N_dy_dpT`: distribution
+ *   of the final particles in rapidity and transverse momentum
+ * - `"Elliptic_Flow"` &rarr; `/SMASH/v2_pT`: profile of
+ *   \f$v_2 = \langle\cos 2\phi\rangle\f$ of the final particles within the
+ *   rapidity range versus their transverse momentum. The azimuthal angle is
+ *   measured from the \f$x\f$ axis, which is the direction of the impact
+ *   parameter of a collider run, unless its reaction plane is randomized.
+ * - `"Interaction_Rate"` &rarr; `/SMASH/dN_int_dt`: times of the
+ *   interactions, except for the crossings of the box walls and of the
+ *   hypersurface of the initial conditions output
+ */
+
+HistogramAxis::HistogramAxis(int n_bins, const std::array<double, 2> &range)
+    : n_bins_(n_bins), range_(range), width_((range[1] - range[0]) / n_bins) {
+  if (n_bins < 1 || !(range[0] < range[1])) {
+    throw std::invalid_argument(
+        "A histogram needs at least one bin and an increasing range.");
+  }
+}
+
+int HistogramAxis::bin(double x) const {
+  if (!(x >= range_[0])) {
+    return -1;
+  }
+  if (x >= range_[1]) {
+    return n_bins_;
+  }
+  // Rounding must not put a value below the upper limit above the last bin
+  return std::min(static_cast<int>((x - range_[0]) / width_), n_bins_ - 1);
+}
+
+void Histogram1D::fill(double x, double y, double w) {
+  total_.fill(x, y, w);
+  const int i = axis_.bin(x);
+  if (i < 0) {
+    underflow_.fill(x, y, w);
+  } else if (i >= axis_.n_bins()) {
+    overflow_.fill(x, y, w);
+  } else {
+    bins_[i].fill(x, y, w);
+  }
+}
+
+void Histogram2D::fill(double x, double y, double w) {
+  total_.fill(x, y, w);
+  const int ix = x_axis_.bin(x), iy = y_axis_.bin(y);
+  if (ix >= 0 && ix < x_axis_.n_bins() && iy >= 0 && iy < y_axis_.n_bins()) {
+    bins_[static_cast<std::size_t>(ix) * y_axis_.n_bins() + iy].fill(x, y, w);
+  }
+}
+
+namespace {
+/**
+ * Write the first lines of a YODA object.
+ *
+ * \param[in] out Stream to write to
+ * \param[in] kind Kind of the object in the BEGIN line
+ * \param[in] type Type of the object
+ * \param[in] path YODA path of the object
+ * \param[in] title Title of the object
+ * \param[in] scale Factor, which the weights were scaled by
+ */
+void write_yoda_begin(std::ostream &out, const std::string &kind,
+                      const std::string &type, const std::string &path,
+                      const std::string &title, double scale) {
+  out << "BEGIN YODA_" << kind << "_V2 " << path << "\nPath: " << path
+      << "\nScaledBy: " << scale << "\nTitle: " << title << "\nType: " << type
+      << "\n---\n";
+}
+
+/**
+ * Write the sums of a bin separated by tabs, scaling the weights.
+ *
+ * \param[in] out Stream to write to
+ * \param[in] bin Sums of the bin
+ * \param[in] scale Factor, which the weights are scaled by
+ * \param[in] y_moments Whether the moments of the second value are written
+ * \param[in] xy_moment Whether the mixed moment is written
+ */
+void write_sums(std::ostream &out, const HistogramBin &bin, double scale,
+                bool y_moments, bool xy_moment) {
+  out << bin.sumw * scale << '\t' << bin.sumw2 * scale * scale << '\t'
+      << bin.sumwx * scale << '\t' << bin.sumwx2 * scale;
+  if (y_moments) {
+    out << '\t' << bin.sumwy * scale << '\t' << bin.sumwy2 * scale;
+  }
+  if (xy_moment) {
+    out << '\t' << bin.sumwxy * scale;
+  }
+  out << '\t' << bin.entries << '\n';
+}
+
+/**
+ * Write the totals, underflow, overflow and bins of a histogram or profile.
+ *
+ * \param[in] out Stream to write to
+ * \param[in] histogram The histogram
+ * \param[in] scale Factor, which the weights are scaled by
+ * \param[in] profile Whether the histogram is a profile
+ */
+void write_yoda_1d_sums(std::ostream &out, const Histogram1D &histogram,
+                        double scale, bool profile) {
+  const std::string columns = profile
+                                  ? "\t sumw\t sumw2\t sumwx\t sumwx2\t sumwy"
+                                    "\t sumwy2\t numEntries\n"
+                                  : "\t sumw\t sumw2\t sumwx\t sumwx2"
+                                    "\t numEntries\n";
+  out << "# ID\t ID" << columns << "Total   \tTotal   \t";
+  write_sums(out, histogram.total(), scale, profile, false);
+  out << "Underflow\tUnderflow\t";
+  write_sums(out, histogram.underflow(), scale, profile, false);
+  out << "Overflow\tOverflow\t";
+  write_sums(out, histogram.overflow(), scale, profile, false);
+  out << "# xlow\t xhigh" << columns;
+  const HistogramAxis &axis = histogram.axis();
+  for (int i = 0; i < axis.n_bins(); i++) {
+    out << axis.low_edge(i) << '\t' << axis.high_edge(i) << '\t';
+    write_sums(out, histogram.bin(i), scale, profile, false);
+  }
+}
+}  // namespace
+
+void write_yoda_histo1d(std::ostream &out, const std::string &path,
+                        const std::string &title, const Histogram1D &histogram,
+                        double scale) {
+  const HistogramBin &total = histogram.total();
+  write_yoda_begin(out, "HISTO1D", "Histo1D", path, title, scale);
+  out << "# Mean: " << (total.sumw != 0. ? total.sumwx / total.sumw : 0.)
+      << "\n# Area: " << total.sumw * scale << '\n';
+  write_yoda_1d_sums(out, histogram, scale, false);
+  out << "END YODA_HISTO1D_V2\n\n";
+}
+
+void write_yoda_profile1d(std::ostream &out, const std::string &path,
+                          const std::string &title,
+                          const Histogram1D &histogram) {
+  write_yoda_begin(out, "PROFILE1D", "Profile1D", path, title, 1.);
+  write_yoda_1d_sums(out, histogram, 1., true);
+  out << "END YODA_PROFILE1D_V2\n\n";
+}
+
+void write_yoda_histo2d(std::ostream &out, const std::string &path,
+                        const std::string &title, const Histogram2D &histogram,
+                        double scale) {
+  const HistogramBin &total = histogram.total();
+  const bool empty = total.sumw == 0.;
+  write_yoda_begin(out, "HISTO2D", "Histo2D", path, title, scale);
+  out << "# Mean: (" << (empty ? 0. : total.sumwx / total.sumw) << ", "
+      << (empty ? 0. : total.sumwy / total.sumw)
+      << ")\n# Volume: " << total.sumw * scale << '\n';
+  const std::string columns =
+      "\t sumw\t sumw2\t sumwx\t sumwx2\t sumwy\t sumwy2\t sumwxy"
+      "\t numEntries\n";
+  out << "# ID\t ID" << columns << "Total   \tTotal   \t";
+  write_sums(out, total, scale, true, true);
+  out << "# 2D outflow persistency not currently supported until API is "
+         "stable\n# xlow\t xhigh\t ylow\t yhigh"
+      << columns;
+  const HistogramAxis &x_axis = histogram.x_axis();
+  const HistogramAxis &y_axis = histogram.y_axis();
+  for (int ix = 0; ix < x_axis.n_bins(); ix++) {
+    for (int iy = 0; iy < y_axis.n_bins(); iy++) {
+      out << x_axis.low_edge(ix) << '\t' << x_axis.high_edge(ix) << '\t'
+          << y_axis.low_edge(iy) << '\t' << y_axis.high_edge(iy) << '\t';
+      write_sums(out, histogram.bin(ix, iy), scale, true, true);
+    }
+  }
+  out << "END YODA_HISTO2D_V2\n\n";
+}
+
+HistogramOutput::HistogramOutput(const std::filesystem::path &path,
+                                 const std::string &name,
+                                 const OutputParameters &out_par)
+    : OutputInterface(name),
+      filename_(path / (name + ".yoda")),
+      pdg_codes_(out_par.histogram_parameters.pdg_codes),
+      rapidity_axis_(out_par.histogram_parameters.rapidity_bins,
+                     out_par.histogram_parameters.rapidity_range),
+      pt_axis_(out_par.histogram_parameters.transverse_momentum_bins,
+               out_par.histogram_parameters.transverse_momentum_range) {
+  const HistogramOutputParameters &par = out_par.histogram_parameters;
+  std::sort(pdg_codes_.begin(), pdg_codes_.end());
+  for (const std::string &quantity : par.quantities) {
+    if (quantity == "Rapidity") {
+      rapidity_.emplace(rapidity_axis_);
+    } else if (quantity == "Transverse_Momentum") {
+      pt_.emplace(pt_axis_);
+    } else if (quantity == "Rapidity_Transverse_Momentum") {
+      rapidity_pt_.emplace(rapidity_axis_, pt_axis_);
+    } else if (quantity == "Elliptic_Flow") {
+      v2_pt_.emplace(pt_axis_);
+    } else if (quantity == "Interaction_Rate") {
+      interaction_times_.emplace(HistogramAxis(par.time_bins, par.time_range));
+    } else {
+      throw std::invalid_argument("Unknown quantity \"" + quantity +
+                                  "\" of the histogram output.");
+    }
+  }
+}
+
+void HistogramOutput::at_eventstart(const Particles &, const int,
+                                    const EventInfo &event) {
+  event_weight_ = event.event_weight;
+}
+
+void HistogramOutput::at_eventend(const Particles &particles, const int,
+                                  const EventInfo &event) {
+  const double w = event.event_weight;
+  n_events_ += w;
+  for (const ParticleData &p : particles) {
+    if (!pdg_codes_.empty() && !std::binary_search(pdg_codes_.begin(),
+                                                   pdg_codes_.end(),
+                                                   p.pdgcode())) {
+      continue;
+    }
+    const FourVector &momentum = p.momentum();
+    const double y = std::atanh(momentum.x3() / momentum.x0());
+    const double pt = std::hypot(momentum.x1(), momentum.x2());
+    if (rapidity_) {
+      rapidity_->fill(y, 0., w);
+    }
+    if (rapidity_pt_) {
+      rapidity_pt_->fill(y, pt, w);
+    }
+    const int y_bin = rapidity_axis_.bin(y);
+    if (y_bin < 0 || y_bin >= rapidity_axis_.n_bins()) {
+      continue;
+    }
+    if (pt_) {
+      pt_->fill(pt, 0., w);
+    }
+    if (v2_pt_ && pt > 0.) {
+      const double cos_2phi =
+          (momentum.x1() - momentum.x2()) * (momentum.x1() + momentum.x2()) /
+          (pt * pt);
+      v2_pt_->fill(pt, cos_2phi, w);
+    }
+  }
+}
+
+void HistogramOutput::at_interaction(const Action &action, const double) {
+  if (interaction_times_ && action.get_type() != ProcessType::Wall &&
+      action.get_type() != ProcessType::HyperSurfaceCrossing) {
+    interaction_times_->fill(action.time_of_execution(), 0., event_weight_);
+  }
+}
+
+void HistogramOutput::at_runend() {
+  std::ofstream file(filename_);
+  if (!file) {
+    throw std::runtime_error("Not possible to write the histograms to " +
+                             filename_.string() + ".");
+  }
+  file << std::scientific;
+  file.precision(6);
+  const double per_event = n_events_ > 0. ? 1. / n_events_ : 1.;
+  if (rapidity_) {
+    write_yoda_histo1d(file, "/SMASH/dN_dy", "dN/dy", *rapidity_, per_event);
+  }
+  if (pt_) {
+    write_yoda_histo1d(file, "/SMASH/dN_dpT", "dN/dpT", *pt_, per_event);
+  }
+  if (rapidity_pt_) {
+    write_yoda_histo2d(file, "/SMASH/d2N_dy_dpT", "d2N/dydpT", *rapidity_pt_,
+                       per_event);
+  }
+  if (v2_pt_) {
+    write_yoda_profile1d(file, "/SMASH/v2_pT", "v2(pT)", *v2_pt_);
+  }
+  if (interaction_times_) {
+    write_yoda_histo1d(file, "/SMASH/dN_int_dt", "dN_int/dt",
+                       *interaction_times_, per_event);
+  }
+  if (!file) {
+    throw std::runtime_error("Not possible to write the histograms to " +
+                             filename_.string() + ".");
+  }
+}
+
+}  // namespace smash
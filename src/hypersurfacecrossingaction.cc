@@ -1,6 +1,6 @@
 /*
  *
- *    Copyright (c) 2019-2020,2022-2023
+ *    Copyright (c) 2019-2020,2022-2024
  *      SMASH Team
  *
  *    GNU General Public License (GPLv3 or later)
@@ -9,7 +9,11 @@
 
 #include "smash/hypersurfacecrossingaction.h"
 
+#include <cmath>
+#include <memory>
+
 #include "smash/logging.h"
+#include "smash/particles.h"
 #include "smash/quantumnumbers.h"
 
 namespace smash {
@@ -48,16 +52,15 @@ double HypersurfacecrossingAction::check_conservation(
   return 0.;
 }
 
-ActionList HyperSurfaceCrossActionsFinder::find_actions_in_cell(
-    const ParticleList &plist, double dt, const double,
+template <typename Range>
+ActionList HyperSurfaceCrossActionsFinder::find_crossings_in_range(
+    const Range &particles, double dt,
     const std::vector<FourVector> &beam_momentum) const {
   std::vector<ActionPtr> actions;
 
-  for (const ParticleData &p : plist) {
-    ParticleData pdata_before_propagation = p;
-    ParticleData pdata_after_propagation = p;  // Will receive updated position
-    double t0 = p.position().x0();
-    double t_end = t0 + dt;  // Time at the end of timestep
+  for (const ParticleData &p : particles) {
+    const double t0 = p.position().x0();
+    const double t_end = t0 + dt;  // Time at the end of timestep
 
     // We don't want to remove particles before the nuclei have interacted
     // because those would not yet be part of the newly-created medium.
@@ -80,118 +83,96 @@ ActionList HyperSurfaceCrossActionsFinder::find_actions_in_cell(
         (static_cast<uint64_t>(p.id()) <                  // particle from
          static_cast<uint64_t>(beam_momentum.size())) &&  // initial nucleus
         (p.get_history().collisions_per_particle == 0);
-    ThreeVector v;
-    if (no_prior_interactions) {
-      const FourVector vbeam = beam_momentum[p.id()];
-      v = vbeam.velocity();
-    } else {
-      v = p.velocity();
-    }
-
-    // propagate particles to position where they would be at the end of the
-    // time step (after dt)
-    const FourVector distance = FourVector(0.0, v * dt);
-    FourVector position = p.position() + distance;
-    position.set_x0(t_end);
-    // update coordinates to the position corresponding to t_end
-    pdata_after_propagation.set_4position(position);
-
-    bool hypersurface_is_crossed = crosses_hypersurface(
-        pdata_before_propagation, pdata_after_propagation, prop_time_);
-
-    /*
-       If rapidity or transverse momentum cut is to be employed; check if
-       particles are within the relevant region
-       Implementation explanation: The default for both cuts is 0.0, as a cut at
-       0 implies that not a single particle contributes to the initial
-       conditions. If the user specifies a value of 0.0 in the config, SMASH
-       crashes with a corresponding error message. The same applies to negtive
-       values.
-    */
-    bool is_within_y_cut = true;
-    // Check whether particle is in desired rapidity range
-    if (rap_cut_ > 0.0) {
-      const double rapidity =
-          0.5 * std::log((p.momentum().x0() + p.momentum().x3()) /
-                         (p.momentum().x0() - p.momentum().x3()));
-      if (std::fabs(rapidity) > rap_cut_) {
-        is_within_y_cut = false;
-      }
+    const FourVector &momentum =
+        no_prior_interactions ? beam_momentum[p.id()] : p.momentum();
+
+    // Only the longitudinal motion matters for the proper time, the
+    // particles are propagated to the end of the time step along z
+    const double z0 = p.position().x3();
+    const double z_end = z0 + momentum.x3() / momentum.x0() * dt;
+    if (!crosses_hypersurface(t0, z0, t_end, z_end, prop_time_) ||
+        !is_within_cuts(p.momentum())) {
+      continue;
     }
 
-    bool is_within_pT_cut = true;
-    // Check whether particle is in desired pT range
-    if (pT_cut_ > 0.0) {
-      const double transverse_momentum =
-          std::sqrt(p.momentum().x1() * p.momentum().x1() +
-                    p.momentum().x2() * p.momentum().x2());
-      if (transverse_momentum > pT_cut_) {
-        is_within_pT_cut = false;
-      }
-    }
+    // Get exact coordinates where hypersurface is crossed
+    const double t_crossing = crossing_time(t0, z0, t_end, z_end, prop_time_);
+    const double time_until_crossing = t_crossing - t0;
+    FourVector crossing_position =
+        p.position() + FourVector(0.0, p.velocity() * time_until_crossing);
+    crossing_position.set_x0(t_crossing);
+
+    ParticleData outgoing_particle(p);
+    outgoing_particle.set_4position(crossing_position);
+    actions.emplace_back(std::make_unique<HypersurfacecrossingAction>(
+        p, outgoing_particle, time_until_crossing));
+  }
+  return actions;
+}
 
-    if (hypersurface_is_crossed && is_within_y_cut && is_within_pT_cut) {
-      // Get exact coordinates where hypersurface is crossed
-      FourVector crossing_position = coordinates_on_hypersurface(
-          pdata_before_propagation, pdata_after_propagation, prop_time_);
+ActionList HyperSurfaceCrossActionsFinder::find_actions_in_cell(
+    const ParticleSpan &plist, double dt, const double,
+    const std::vector<FourVector> &beam_momentum) const {
+  return find_crossings_in_range(plist, dt, beam_momentum);
+}
 
-      double time_until_crossing = crossing_position[0] - t0;
+ActionList HyperSurfaceCrossActionsFinder::find_crossings(
+    const Particles &particles, double dt,
+    const std::vector<FourVector> &beam_momentum) const {
+  return find_crossings_in_range(particles, dt, beam_momentum);
+}
 
-      ParticleData outgoing_particle(p);
-      outgoing_particle.set_4position(crossing_position);
-      ActionPtr action = std::make_unique<HypersurfacecrossingAction>(
-          p, outgoing_particle, time_until_crossing);
-      actions.emplace_back(std::move(action));
+bool HyperSurfaceCrossActionsFinder::is_within_cuts(const FourVector &p) const {
+  /*
+     If rapidity or transverse momentum cut is to be employed; check if
+     particles are within the relevant region
+     Implementation explanation: The default for both cuts is 0.0, as a cut at
+     0 implies that not a single particle contributes to the initial
+     conditions. If the user specifies a value of 0.0 in the config, SMASH
+     crashes with a corresponding error message. The same applies to negtive
+     values.
+  */
+  // Check whether particle is in desired rapidity range
+  if (rap_cut_ > 0.0) {
+    const double rapidity =
+        0.5 * std::log((p.x0() + p.x3()) / (p.x0() - p.x3()));
+    if (std::fabs(rapidity) > rap_cut_) {
+      return false;
     }
   }
-  return actions;
-}
 
-bool HyperSurfaceCrossActionsFinder::crosses_hypersurface(
-    ParticleData &pdata_before_propagation,
-    ParticleData &pdata_after_propagation, const double tau) const {
-  bool hypersurface_is_crossed = false;
-  const bool t_greater_z_before_prop =
-      (std::fabs(pdata_before_propagation.position().x0()) >
-               std::fabs(pdata_before_propagation.position().x3())
-           ? true
-           : false);
-  const bool t_greater_z_after_prop =
-      (std::fabs(pdata_after_propagation.position().x0()) >
-               std::fabs(pdata_after_propagation.position().x3())
-           ? true
-           : false);
-
-  if (t_greater_z_before_prop && t_greater_z_after_prop) {
-    // proper time before and after propagation
-    const double tau_before = pdata_before_propagation.position().tau();
-    const double tau_after = pdata_after_propagation.position().tau();
-
-    if (tau_before <= tau && tau <= tau_after) {
-      hypersurface_is_crossed = true;
-    }
-  } else if (!t_greater_z_before_prop && t_greater_z_after_prop) {
-    // proper time after propagation
-    const double tau_after = pdata_after_propagation.position().tau();
-    if (tau_after >= tau) {
-      hypersurface_is_crossed = true;
+  // Check whether particle is in desired pT range
+  if (pT_cut_ > 0.0) {
+    const double transverse_momentum =
+        std::sqrt(p.x1() * p.x1() + p.x2() * p.x2());
+    if (transverse_momentum > pT_cut_) {
+      return false;
     }
   }
-
-  return hypersurface_is_crossed;
+  return true;
 }
 
-FourVector HyperSurfaceCrossActionsFinder::coordinates_on_hypersurface(
-    ParticleData &pdata_before_propagation,
-    ParticleData &pdata_after_propagation, const double tau) const {
-  // find t and z at start of propagation
-  const double t1 = pdata_before_propagation.position().x0();
-  const double z1 = pdata_before_propagation.position().x3();
-
-  // find t and z after propagation
-  const double t2 = pdata_after_propagation.position().x0();
-  const double z2 = pdata_after_propagation.position().x3();
+bool HyperSurfaceCrossActionsFinder::crosses_hypersurface(double t1, double z1,
+                                                          double t2, double z2,
+                                                          double tau) {
+  const bool t_greater_z_before_prop = std::fabs(t1) > std::fabs(z1);
+  const bool t_greater_z_after_prop = std::fabs(t2) > std::fabs(z2);
+  if (!t_greater_z_after_prop) {
+    return false;
+  }
+  // proper time after propagation
+  const double tau_after = std::sqrt(t2 * t2 - z2 * z2);
+  if (t_greater_z_before_prop) {
+    // proper time before propagation
+    const double tau_before = std::sqrt(t1 * t1 - z1 * z1);
+    return tau_before <= tau && tau <= tau_after;
+  }
+  return tau_after >= tau;
+}
 
+double HyperSurfaceCrossActionsFinder::crossing_time(double t1, double z1,
+                                                     double t2, double z2,
+                                                     double tau) {
   // find slope and intercept of linear function that describes propagation on
   // straight line
   const double m = (z2 - z1) / (t2 - t1);
@@ -207,14 +188,7 @@ FourVector HyperSurfaceCrossActionsFinder::coordinates_on_hypersurface(
 
   assert((sol1 >= t1 && sol1 <= t2));
   assert(!(sol2 >= t1 && sol2 <= t2));
-
-  // Propagate to point where hypersurface is crossed
-  const ThreeVector v = pdata_before_propagation.velocity();
-  const FourVector distance = FourVector(0.0, v * (sol1 - t1));
-  FourVector crossing_position = pdata_before_propagation.position() + distance;
-  crossing_position.set_x0(sol1);
-
-  return crossing_position;
+  return sol1;
 }
 
 }  // namespace smash
@@ -1,6 +1,6 @@
 /*
  *
- *    Copyright (c) 2019-2020,2022-2023
+ *    Copyright (c) 2019-2020,2022-2024
  *      SMASH Team
  *
  *    GNU General Public License (GPLv3 or later)
@@ -147,7 +147,7 @@ void ICOutput::at_interaction(const Action &action, const double) {
   assert(action.get_type() == ProcessType::HyperSurfaceCrossing);
   assert(action.incoming_particles().size() == 1);
 
-  ParticleData particle = action.incoming_particles()[0];
+  const ParticleData &particle = action.incoming_particles()[0];
 
   // transverse mass
   const double m_trans =
@@ -169,7 +169,8 @@ void ICOutput::at_interaction(const Action &action, const double) {
                  particle.position().tau(), particle.position()[1],
                  particle.position()[2], particle.position().eta(), m_trans,
                  particle.momentum()[1], particle.momentum()[2], rapidity,
-                 particle.pdgcode().string().c_str(), particle.type().charge(),
+                 particle.type().pdgcode_string().c_str(),
+                 particle.type().charge(),
                  particle.type().baryon_number(),
                  particle.type().strangeness());
   }
@@ -17,6 +17,7 @@
 #include "lattice.h"
 #include "particles.h"
 #include "pauliblocking.h"
+#include "poolallocated.h"
 #include "potentials.h"
 #include "processbranch.h"
 #include "random.h"
@@ -31,8 +32,11 @@ static constexpr int LAction = LogArea::Action::id;
  * Currently such an action can be either a decay, a two-body collision, a
  * wallcrossing or a thermalization.
  * (see derived classes).
+ *
+ * Actions are created for every candidate interaction in every time step,
+ * hence their memory is recycled by PoolAllocated.
  */
-class Action {
+class Action : public PoolAllocated {
  public:
   /**
    * Construct an action object with incoming particles and relative time.
@@ -186,13 +190,17 @@ class Action {
    *
    * \param[in] id_process unique id of the performed process
    * \param[out] particles particle list that is updated
+   * \param[in] check_conservation_laws Whether the conservation laws are
+   *            checked, see check_conservation. The energy violated in Pythia
+   *            processes is determined in any case.
    *
    * \return the amount of energy violated in Pythia processes (if any)
    *
    * Note that you are required to increase id_process before the next call,
    * such that you get unique numbers.
    */
-  virtual double perform(Particles *particles, uint32_t id_process);
+  virtual double perform(Particles *particles, uint32_t id_process,
+                         bool check_conservation_laws = true);
 
   /**
    * Check whether the action still applies.
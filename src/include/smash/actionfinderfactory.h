@@ -15,6 +15,7 @@
 #include "clock.h"
 #include "forwarddeclarations.h"
 #include "lattice.h"
+#include "particlespan.h"
 #include "potentials.h"
 
 namespace smash {
@@ -31,8 +32,8 @@ class ActionFinderInterface {
   /**
    * Abstract function for finding actions, given a list of particles.
    *
-   * \param[in] search_list a list of particles where each pair needs to be
-   *                  tested for possible interaction
+   * \param[in] search_list a view of the particles where each pair needs to
+   *                  be tested for possible interaction
    * \param[in] dt duration of the current time step [fm]
    * \param[in] gcell_vol volume of searched grid cell [fm^3]
    * \param[in] beam_momentum [GeV] List of beam momenta for each particle;
@@ -41,15 +42,35 @@ class ActionFinderInterface {
    *         could possibly be executed in this time step.
    */
   virtual ActionList find_actions_in_cell(
-      const ParticleList &search_list, double dt, const double gcell_vol,
+      const ParticleSpan &search_list, double dt, const double gcell_vol,
       const std::vector<FourVector> &beam_momentum) const = 0;
+
+  /**
+   * Convenience overload of the above for a ParticleList.
+   *
+   * \param[in] search_list a list of particles where each pair needs to be
+   *                  tested for possible interaction
+   * \param[in] dt duration of the current time step [fm]
+   * \param[in] gcell_vol volume of searched grid cell [fm^3]
+   * \param[in] beam_momentum [GeV] List of beam momenta for each particle
+   * \return The function returns a list (std::vector) of Action objects that
+   *         could possibly be executed in this time step.
+   */
+  ActionList find_actions_in_cell(
+      const ParticleList &search_list, double dt, const double gcell_vol,
+      const std::vector<FourVector> &beam_momentum) const {
+    const auto pointers = particle_pointers(search_list);
+    return find_actions_in_cell(ParticleSpan(pointers), dt, gcell_vol,
+                                beam_momentum);
+  }
+
   /**
    * Abstract function for finding actions, given two lists of particles,
    * a search list and a neighbors list.
    *
-   * \param[in] search_list a list of particles where each particle needs to
-   *                  be tested for possible interactions with the neighbors
-   * \param[in] neighbors_list a list of particles that need to be tested
+   * \param[in] search_list a view of the particles where each particle needs
+   *                  to be tested for possible interactions with the neighbors
+   * \param[in] neighbors_list a view of the particles that need to be tested
    *                  against particles in search_list for possible interaction
    * \param[in] dt duration of the current time step [fm]
    * \param[in] beam_momentum [GeV] List of beam momenta for each particle;
@@ -58,9 +79,31 @@ class ActionFinderInterface {
    *         could possibly be executed in this time step.
    */
   virtual ActionList find_actions_with_neighbors(
-      const ParticleList &search_list, const ParticleList &neighbors_list,
+      const ParticleSpan &search_list, const ParticleSpan &neighbors_list,
       double dt, const std::vector<FourVector> &beam_momentum) const = 0;
 
+  /**
+   * Convenience overload of the above for two ParticleList objects.
+   *
+   * \param[in] search_list a list of particles where each particle needs to
+   *                  be tested for possible interactions with the neighbors
+   * \param[in] neighbors_list a list of particles that need to be tested
+   *                  against particles in search_list for possible interaction
+   * \param[in] dt duration of the current time step [fm]
+   * \param[in] beam_momentum [GeV] List of beam momenta for each particle
+   * \return The function returns a list (std::vector) of Action objects that
+   *         could possibly be executed in this time step.
+   */
+  ActionList find_actions_with_neighbors(
+      const ParticleList &search_list, const ParticleList &neighbors_list,
+      double dt, const std::vector<FourVector> &beam_momentum) const {
+    const auto search_pointers = particle_pointers(search_list);
+    const auto neighbors_pointers = particle_pointers(neighbors_list);
+    return find_actions_with_neighbors(ParticleSpan(search_pointers),
+                                       ParticleSpan(neighbors_pointers), dt,
+                                       beam_momentum);
+  }
+
   /**
    * Abstract function for finding actions between a list of particles and
    * the surrounding particles.
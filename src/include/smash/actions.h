@@ -1,5 +1,5 @@
 /*
- *    Copyright (c) 2015-2018,2020
+ *    Copyright (c) 2015-2018,2020,2024
  *      SMASH Team
  *
  *    GNU General Public License (GPLv3 or later)
@@ -8,6 +8,7 @@
 #define SRC_INCLUDE_SMASH_ACTIONS_H_
 
 #include <algorithm>
+#include <cmath>
 #include <stdexcept>
 #include <utility>
 #include <vector>
@@ -22,6 +23,12 @@ namespace smash {
  *
  * The Actions class abstracts the storage and manipulation of actions.
  *
+ * The actions are kept in a heap ordered by their time of execution. Inserted
+ * actions are only appended and the heap is restored when the earliest action
+ * is needed, at once for many actions. Actions of particles which interacted
+ * in the meantime remain stored until they are popped or the list is
+ * compacted.
+ *
  * \note
  * The Actions object cannot be copied, because it does not make sense
  * semantically. Move semantics make sense and can be implemented when needed.
@@ -41,6 +48,8 @@ class Actions {
    */
   explicit Actions(ActionList&& action_list) : data_(std::move(action_list)) {
     std::make_heap(data_.begin(), data_.end(), cmp);
+    heap_size_ = data_.size();
+    compacted_size_ = data_.size();
   }
 
   /// Cannot be copied
@@ -60,45 +69,101 @@ class Actions {
     if (data_.empty()) {
       throw std::runtime_error("Empty actions list!");
     }
+    restore_heap();
     std::pop_heap(data_.begin(), data_.end(), cmp);
     ActionPtr act = std::move(data_.back());
     data_.pop_back();
+    heap_size_ = data_.size();
     return act;
   }
 
   /// Return time of execution of earliest action
-  double earliest_time() const { return data_.front()->time_of_execution(); }
+  double earliest_time() {
+    restore_heap();
+    return data_.front()->time_of_execution();
+  }
 
   /**
    * Insert a list of actions into this object.
    *
-   * They're inserted at the right places to keep the complete list a heap.
+   * They're ordered into the heap when the earliest action is needed next.
    *
    * \param[in] new_acts The actions that will be inserted.
    */
   void insert(ActionList&& new_acts) {
+    data_.reserve(data_.size() + new_acts.size());
     for (auto& a : new_acts) {
-      insert(std::move(a));
+      data_.push_back(std::move(a));
     }
   }
 
   /**
    * Insert an action into this container.
    *
-   * The function makes sure that the action is inserted at the right place.
+   * The action is ordered into the heap when the earliest action is needed
+   * next.
    *
    * \param[in] action The action to insert.
    */
-  void insert(ActionPtr&& action) {
-    data_.push_back(std::move(action));
-    std::push_heap(data_.begin(), data_.end(), cmp);
+  void insert(ActionPtr&& action) { data_.push_back(std::move(action)); }
+
+  /**
+   * Remove the actions which are no longer valid, because some of their
+   * incoming particles interacted, if the number of actions at least doubled
+   * since the last compaction. Otherwise nothing is done, such that the
+   * actions are checked only a few times on average.
+   *
+   * \param[in] particles The particles the actions refer to
+   * \return The number of removed actions
+   */
+  ActionList::size_type compact(const Particles& particles) {
+    if (data_.size() < min_compaction_size ||
+        data_.size() < 2 * compacted_size_) {
+      return 0;
+    }
+    const auto valid_end = std::remove_if(
+        data_.begin(), data_.end(),
+        [&particles](const ActionPtr& a) { return !a->is_valid(particles); });
+    const ActionList::size_type removed = data_.end() - valid_end;
+    data_.erase(valid_end, data_.end());
+    std::make_heap(data_.begin(), data_.end(), cmp);
+    heap_size_ = data_.size();
+    compacted_size_ = data_.size();
+    return removed;
   }
 
   /// \return Number of actions.
   ActionList::size_type size() const { return data_.size(); }
 
+  /**
+   * Find the earliest actions without removing them.
+   *
+   * \param[in] n Maximum number of actions
+   * \param[in] end_time Time until which the actions are found
+   * \return Up to \p n of the earliest actions until \p end_time, in the
+   *         order in which they are popped
+   */
+  std::vector<Action*> earliest(std::size_t n, double end_time) const {
+    std::vector<Action*> found;
+    for (const ActionPtr& action : data_) {
+      if (action->time_of_execution() <= end_time) {
+        found.push_back(action.get());
+      }
+    }
+    const auto last = found.begin() + std::min(n, found.size());
+    std::partial_sort(
+        found.begin(), last, found.end(),
+        [](const Action* a, const Action* b) { return later(*b, *a); });
+    found.erase(last, found.end());
+    return found;
+  }
+
   /// Delete all actions.
-  void clear() { data_.clear(); }
+  void clear() {
+    data_.clear();
+    heap_size_ = 0;
+    compacted_size_ = 0;
+  }
 
   /// \return an iterator to the earliest action.
   std::vector<ActionPtr>::const_reverse_iterator begin() const {
@@ -110,17 +175,93 @@ class Actions {
     return data_.crend();
   }
 
+  /**
+   * \return the memory allocated for the pointers to the actions [bytes],
+   *         not including the actions themselves.
+   */
+  std::size_t memory_usage() const {
+    return data_.capacity() * sizeof(ActionPtr);
+  }
+
+  /// Number of actions below which the list is never compacted
+  static constexpr ActionList::size_type min_compaction_size = 1024;
+
  private:
   /**
-   * Compare two action pointer such that the maximum is the most recent
-   * action.
+   * \param[in] action An action
+   * \return Lowest and highest id of the incoming particles of the action
+   */
+  static std::pair<int, int> incoming_ids(const Action& action) {
+    const ParticleList& incoming = action.incoming_particles();
+    if (incoming.empty()) {
+      return {-1, -1};
+    }
+    const auto [lowest, highest] = std::minmax_element(
+        incoming.begin(), incoming.end(),
+        [](const ParticleData& p, const ParticleData& q) {
+          return p.id() < q.id();
+        });
+    return {lowest->id(), highest->id()};
+  }
+
+  /**
+   * Compare two actions such that the maximum is the most recent action.
+   * Actions at the same time are ordered by the lowest id of their incoming
+   * particles, their process type and the highest id. Thus the order of the
+   * actions does not depend on the order, in which they were inserted, nor
+   * on how the heap was built.
+   *
+   * \param[in] a First action
+   * \param[in] b Second action
+   * \return Whether the first action will be executed later than the second.
+   */
+  static bool later(const Action& a, const Action& b) {
+    const double time_a = a.time_of_execution();
+    const double time_b = b.time_of_execution();
+    if (time_a != time_b) {
+      return time_a > time_b;
+    }
+    const std::pair<int, int> ids_a = incoming_ids(a);
+    const std::pair<int, int> ids_b = incoming_ids(b);
+    if (ids_a.first != ids_b.first) {
+      return ids_a.first > ids_b.first;
+    }
+    if (a.get_type() != b.get_type()) {
+      return a.get_type() > b.get_type();
+    }
+    return ids_a.second > ids_b.second;
+  }
+
+  /**
+   * Compare two action pointers, see later.
    *
    * \param[in] a First action
    * \param[in] b Second action
    * \return Whether the first action will be executed later than the second.
    */
   static bool cmp(const ActionPtr& a, const ActionPtr& b) {
-    return a->time_of_execution() > b->time_of_execution();
+    return later(*a, *b);
+  }
+
+  /**
+   * Order the actions inserted since the last call into the heap.
+   *
+   * Few actions are pushed one by one, while the heap is rebuilt at once if
+   * this is cheaper.
+   */
+  void restore_heap() {
+    const ActionList::size_type pending = data_.size() - heap_size_;
+    if (pending == 0) {
+      return;
+    }
+    if (pending * std::log2(data_.size()) > data_.size()) {
+      std::make_heap(data_.begin(), data_.end(), cmp);
+    } else {
+      for (auto last = data_.begin() + heap_size_; last != data_.end();) {
+        std::push_heap(data_.begin(), ++last, cmp);
+      }
+    }
+    heap_size_ = data_.size();
   }
 
   /**
@@ -129,8 +270,14 @@ class Actions {
    * Vector is likely the best container type here. Because std::sort requires
    * random access iterators. Any linked data structure (e.g. list) thus
    * requires a less efficient sort algorithm.
+   *
+   * The first heap_size_ actions form a heap, the others were inserted after.
    */
   std::vector<ActionPtr> data_;
+  /// Number of actions at the beginning of data_ which form a heap
+  ActionList::size_type heap_size_ = 0;
+  /// Number of actions after the last compaction
+  ActionList::size_type compacted_size_ = 0;
 };
 
 }  // namespace smash
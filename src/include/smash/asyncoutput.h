@@ -0,0 +1,140 @@
+/*
+ *
+ *    Copyright (c) 2024
+ *      SMASH Team
+ *
+ *    GNU General Public License (GPLv3 or later)
+ *
+ */
+
+#ifndef SRC_INCLUDE_SMASH_ASYNCOUTPUT_H_
+#define SRC_INCLUDE_SMASH_ASYNCOUTPUT_H_
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "forwarddeclarations.h"
+#include "outputinterface.h"
+#include "outputmerger.h"
+
+namespace smash {
+
+/**
+ * \ingroup output
+ *
+ * Output that writes to another output in a thread of its own, such that
+ * formatting and writing the output does not hold up the time evolution.
+ *
+ * Every call is recorded with copies of its arguments like by a
+ * DeferredOutput and put into a queue, from which the writer thread passes
+ * the calls to the actual output in the order they were made. If the queue
+ * is full, the caller waits until the writer caught up. At the end of an
+ * event, the caller waits until everything has been written, such that the
+ * output files are complete between events. If the events overlap, the
+ * caller only waits at the end of the following event, see end_event.
+ * Exceptions thrown by the actual output are passed on to the caller at the
+ * next call.
+ */
+class AsyncOutput : public DeferredOutput {
+ public:
+  /// Number of calls waiting in the queue at most by default
+  static constexpr std::size_t default_capacity = 1024;
+
+  /**
+   * Start the writer thread.
+   *
+   * \param[in] target Output, which is written to by the writer thread
+   * \param[in] capacity Number of calls waiting in the queue at most
+   * \throw std::invalid_argument if the capacity is zero.
+   */
+  explicit AsyncOutput(OutputPtr target,
+                       std::size_t capacity = default_capacity);
+
+  /// Write all calls in the queue and stop the writer thread.
+  ~AsyncOutput() override;
+
+  void at_eventend(const int event_number, const ThermodynamicQuantity tq,
+                   const DensityType dens_type) override;
+  void at_eventend(const ThermodynamicQuantity tq) override;
+  void at_eventend(const Particles &particles, const int event_number,
+                   const EventInfo &info) override;
+  void at_eventend(const std::vector<Particles> &ensembles,
+                   const int event_number) override;
+  /// The thermalizer is written right away, after the queue is written.
+  void thermodynamics_output(const GrandCanThermalizer &gct) override;
+
+  /**
+   * Let the output of an event be written while the next event evolves,
+   * instead of waiting for it at the end of the event. Must be set before
+   * the first call.
+   */
+  void overlap_events() { overlap_events_ = true; }
+
+  /**
+   * Mark the end of an event, after all its calls. If the events overlap,
+   * this waits until the previous event is written, such that at most one
+   * event is written alongside the evolution.
+   *
+   * \throw Whatever the actual output threw since the last call.
+   */
+  void end_event();
+
+  /**
+   * Wait until all calls so far are written.
+   *
+   * \throw Whatever the actual output threw since the last call.
+   */
+  void flush();
+
+ protected:
+  /**
+   * Put a call into the queue, waiting if it is full.
+   *
+   * \param[in] call Call with copies of all arguments
+   * \throw Whatever the actual output threw since the last call.
+   */
+  void record(Call call) override;
+
+ private:
+  /// Pass the calls from the queue to the actual output until stopped.
+  void write();
+
+  /// Rethrow an exception of the actual output, while holding the mutex.
+  void rethrow_error();
+
+  /// Actual output
+  OutputPtr target_;
+  /// Number of calls waiting in the queue at most
+  const std::size_t capacity_;
+  /// Whether the end of an event does not wait for its output
+  bool overlap_events_ = false;
+  /// Guards all members below
+  std::mutex mutex_;
+  /// Notified whenever the queue or the state of the writer changes
+  std::condition_variable changed_;
+  /// Calls waiting to be written
+  std::deque<Call> queue_;
+  /// Whether the writer is passing a call to the actual output
+  bool writing_ = false;
+  /// Number of calls recorded so far
+  std::size_t n_recorded_ = 0;
+  /// Number of calls written so far
+  std::size_t n_written_ = 0;
+  /// Number of calls recorded until the end of the previous event
+  std::size_t previous_event_end_ = 0;
+  /// Whether the writer thread is asked to stop
+  bool stop_ = false;
+  /// Exception thrown by the actual output, which was not passed on yet
+  std::exception_ptr error_;
+  /// Writer thread, started last
+  std::thread writer_;
+};
+
+}  // namespace smash
+
+#endif  // SRC_INCLUDE_SMASH_ASYNCOUTPUT_H_
@@ -11,8 +11,11 @@
 #define SRC_INCLUDE_SMASH_BINARYOUTPUT_H_
 
 #include <cstdint>
+#include <cstdio>
+#include <cstring>
 #include <memory>
 #include <string>
+#include <vector>
 
 #include "file.h"
 #include "forwarddeclarations.h"
@@ -27,6 +30,13 @@ namespace smash {
  * Base class for SMASH binary output.
  */
 class BinaryOutputBase : public OutputInterface {
+ public:
+  /// Write the buffered data to the file before it is closed.
+  ~BinaryOutputBase() override;
+
+  /// \return Memory allocated for the buffer [bytes]
+  std::size_t buffer_size() const override { return buffer_.capacity(); }
+
  protected:
   /**
    * Create binary output base.
@@ -35,10 +45,51 @@ class BinaryOutputBase : public OutputInterface {
    * \param[in] mode Is used to determine the file access mode.
    * \param[in] name Name of the output.
    * \param[in] extended_format Is the written output extended.
+   * \param[in] compressed Whether the file is compressed, see RenamingFilePtr.
+   * \param[in] event_index Whether an index of the particle blocks at the
+   *            start and end of the events is appended to the file.
    */
   explicit BinaryOutputBase(const std::filesystem::path &path,
                             const std::string &mode, const std::string &name,
-                            bool extended_format);
+                            bool extended_format, bool compressed = false,
+                            bool event_index = false);
+
+  /**
+   * Write raw bytes to binary output.
+   *
+   * The bytes are collected in a buffer, which is written to the file in one
+   * go when it is full or flush() is called.
+   *
+   * \param[in] data Bytes to be written.
+   * \param[in] size Number of bytes.
+   */
+  void write_bytes(const void *data, std::size_t size) {
+    position_ += size;
+    if (buffer_used_ + size > buffer_.size()) {
+      write_buffer();
+      if (size > buffer_.size()) {
+        std::fwrite(data, size, 1, file_.get());
+        return;
+      }
+    }
+    std::memcpy(buffer_.data() + buffer_used_, data, size);
+    buffer_used_ += size;
+  }
+
+  /// Write the buffered data to the file and flush it to disk.
+  void flush();
+
+  /**
+   * Add the particle block, which is written next, to the event index, if it
+   * is written.
+   *
+   * \param[in] stage 's' for the particles at the start of the event, 'e' for
+   *            those at the end
+   * \param[in] event_number Number of the event
+   * \param[in] n_particles Number of particles in the block
+   */
+  void index_block(char stage, std::int32_t event_number,
+                   std::size_t n_particles);
 
   /**
    * Write byte to binary output.
@@ -68,25 +119,19 @@ class BinaryOutputBase : public OutputInterface {
    * Write integer (32 bit) to binary output.
    * \param[in] x Value to be written.
    */
-  void write(const std::int32_t x) {
-    std::fwrite(&x, sizeof(x), 1, file_.get());
-  }
+  void write(const std::int32_t x) { write_bytes(&x, sizeof(x)); }
 
   /**
    * Write unsigned integer (32 bit) to binary output.
    * \param[in] x Value to be written.
    */
-  void write(const std::uint32_t x) {
-    std::fwrite(&x, sizeof(x), 1, file_.get());
-  }
+  void write(const std::uint32_t x) { write_bytes(&x, sizeof(x)); }
 
   /**
    * Write unsigned integer (16 bit) to binary output.
    * \param[in] x Value to be written.
    */
-  void write(const std::uint16_t x) {
-    std::fwrite(&x, sizeof(x), 1, file_.get());
-  }
+  void write(const std::uint16_t x) { write_bytes(&x, sizeof(x)); }
 
   /**
    * Write a std::size_t to binary output.
@@ -116,10 +161,37 @@ class BinaryOutputBase : public OutputInterface {
   RenamingFilePtr file_;
 
  private:
+  /// Write the buffered data to the file.
+  void write_buffer();
+
+  /// Size of the buffer in bytes
+  static constexpr std::size_t buffer_size_ = 1 << 20;
+  /// Data waiting to be written to the file
+  std::vector<char> buffer_;
+  /// Number of bytes used in the buffer
+  std::size_t buffer_used_ = 0;
   /// Binary file format version number
   const uint16_t format_version_ = 9;
   /// Option for extended output
   bool extended_;
+
+  /// Entry of the event index
+  struct IndexEntry {
+    /// 's' for the start of an event, 'e' for the end
+    char stage;
+    /// Number of the event
+    std::int32_t event_number;
+    /// Position of the particle block in the file in bytes
+    std::uint64_t offset;
+    /// Number of particles in the block
+    std::uint32_t n_particles;
+  };
+  /// Whether the event index is appended to the file
+  bool event_index_;
+  /// Particle blocks at the start and end of the events written so far
+  std::vector<IndexEntry> index_;
+  /// Number of bytes written to the file so far, including the buffer
+  std::uint64_t position_ = 0;
 };
 
 /**
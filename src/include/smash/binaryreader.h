@@ -0,0 +1,223 @@
+/*
+ *
+ *    Copyright (c) 2024
+ *      SMASH Team
+ *
+ *    GNU General Public License (GPLv3 or later)
+ *
+ */
+
+#ifndef SRC_INCLUDE_SMASH_BINARYREADER_H_
+#define SRC_INCLUDE_SMASH_BINARYREADER_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+namespace smash {
+
+/**
+ * \ingroup output
+ *
+ * Particles of a block in a binary output file, which are read directly from
+ * the memory the file is mapped to.
+ *
+ * The particle records are packed in the file without alignment, so the
+ * values are copied out of the records by the accessors.
+ */
+class BinaryParticleBlock {
+ public:
+  /**
+   * \param[in] records First byte of the first particle record
+   * \param[in] n_particles Number of particle records
+   * \param[in] record_size Size of a particle record in bytes
+   */
+  BinaryParticleBlock(const char *records, std::size_t n_particles,
+                      std::size_t record_size)
+      : records_(records),
+        n_particles_(n_particles),
+        record_size_(record_size) {}
+
+  /// \return Number of particles in the block
+  std::size_t size() const { return n_particles_; }
+  /// \return Size of a particle record in bytes
+  std::size_t record_size() const { return record_size_; }
+  /// \return First byte of the particle records
+  const char *data() const { return records_; }
+
+  /**
+   * \param[in] i Index of the particle in the block
+   * \param[in] mu Component of the four-vector, 0 for the time
+   * \return Component of the position [fm]
+   */
+  double position(std::size_t i, int mu) const {
+    return value<double>(i, mu * sizeof(double));
+  }
+  /**
+   * \param[in] i Index of the particle in the block
+   * \return Effective mass [GeV]
+   */
+  double mass(std::size_t i) const {
+    return value<double>(i, 4 * sizeof(double));
+  }
+  /**
+   * \param[in] i Index of the particle in the block
+   * \param[in] mu Component of the four-vector, 0 for the energy
+   * \return Component of the momentum [GeV]
+   */
+  double momentum(std::size_t i, int mu) const {
+    return value<double>(i, (5 + mu) * sizeof(double));
+  }
+  /**
+   * \param[in] i Index of the particle in the block
+   * \return PDG code
+   */
+  std::int32_t pdg(std::size_t i) const {
+    return value<std::int32_t>(i, 9 * sizeof(double));
+  }
+  /**
+   * \param[in] i Index of the particle in the block
+   * \return ID of the particle
+   */
+  std::int32_t id(std::size_t i) const {
+    return value<std::int32_t>(i, 9 * sizeof(double) + sizeof(std::int32_t));
+  }
+  /**
+   * \param[in] i Index of the particle in the block
+   * \return Electric charge
+   */
+  std::int32_t charge(std::size_t i) const {
+    return value<std::int32_t>(i,
+                               9 * sizeof(double) + 2 * sizeof(std::int32_t));
+  }
+
+ private:
+  /**
+   * Copy a value out of a particle record.
+   *
+   * \param[in] i Index of the particle in the block
+   * \param[in] offset Position of the value in the record in bytes
+   */
+  template <typename T>
+  T value(std::size_t i, std::size_t offset) const {
+    T result;
+    std::memcpy(&result, records_ + i * record_size_ + offset, sizeof(T));
+    return result;
+  }
+
+  /// First byte of the first particle record
+  const char *records_;
+  /// Number of particle records
+  std::size_t n_particles_;
+  /// Size of a particle record in bytes
+  std::size_t record_size_;
+};
+
+/**
+ * \ingroup output
+ *
+ * Reader of binary particles and collisions files with an event index, see
+ * \ref doxypage_output_binary, which maps the file into memory and gives
+ * access to the particles at the start and end of any event without reading
+ * the rest of the file. It is built as library of its own, which does not
+ * depend on the rest of SMASH, such that analysis programs can use it.
+ *
+ * The shards of a sharded output, see ShardedOutput, are read as a single
+ * file by passing their manifest `<file>.shards`. The events of all shards
+ * are then in one index, ordered by their number.
+ */
+class BinaryReader {
+ public:
+  /// Entry of the event index
+  struct IndexEntry {
+    /// 's' for the particles at the start of the event, 'e' for the end
+    char stage;
+    /// Number of the event
+    std::int32_t event_number;
+    /// Position of the particle block in the file in bytes
+    std::uint64_t offset;
+    /// Number of particles in the block
+    std::uint32_t n_particles;
+    /// Shard of the file the block is in, 0 unless a manifest is read
+    std::uint32_t shard;
+  };
+
+  /**
+   * Map the file into memory and read its header and event index.
+   *
+   * \param[in] path Binary output file, which is not compressed, or manifest
+   *            of its shards with the extension `.shards`
+   * \throw std::runtime_error if a file cannot be mapped or is not a binary
+   *        output file with an event index, or if the shards differ in their
+   *        format.
+   */
+  explicit BinaryReader(const std::filesystem::path &path);
+  /// Unmap the files.
+  ~BinaryReader();
+  /// Cannot be copied, since the mapping is unique.
+  BinaryReader(const BinaryReader &) = delete;
+  /// Cannot be assigned, since the mapping is unique.
+  BinaryReader &operator=(const BinaryReader &) = delete;
+
+  /// \return Version of the binary format
+  std::uint16_t format_version() const { return format_version_; }
+  /// \return Whether the particle records are extended
+  bool extended() const { return extended_; }
+  /// \return Version of SMASH, which wrote the file
+  const std::string &smash_version() const { return smash_version_; }
+  /// \return Particle blocks at the start and end of the events
+  const std::vector<IndexEntry> &index() const { return index_; }
+
+  /**
+   * \param[in] entry Entry of the event index
+   * \return Particles of the block
+   */
+  BinaryParticleBlock particles(const IndexEntry &entry) const;
+
+  /**
+   * \param[in] event_number Number of the event
+   * \param[in] stage 's' for the particles at the start of the event, 'e' for
+   *            those at the end
+   * \return Particles of the event
+   * \throw std::out_of_range if the block is not in the index.
+   */
+  BinaryParticleBlock particles(std::int32_t event_number,
+                                char stage = 'e') const;
+
+ private:
+  /// A file mapped into memory
+  struct Mapping {
+    /// First byte of the mapped file
+    const char *data;
+    /// Size of the file in bytes
+    std::size_t size;
+  };
+
+  /**
+   * Map a file or shard into memory and read its header and event index.
+   *
+   * \param[in] path Binary output file
+   * \throw std::runtime_error if the file cannot be mapped, is not a binary
+   *        output file with an event index or differs in its format from the
+   *        shards read before.
+   */
+  void map_file(const std::filesystem::path &path);
+
+  /// Mapped files, one per shard
+  std::vector<Mapping> mappings_;
+  /// Version of the binary format
+  std::uint16_t format_version_ = 0;
+  /// Whether the particle records are extended
+  bool extended_ = false;
+  /// Version of SMASH, which wrote the file
+  std::string smash_version_;
+  /// Particle blocks at the start and end of the events
+  std::vector<IndexEntry> index_;
+};
+
+}  // namespace smash
+
+#endif  // SRC_INCLUDE_SMASH_BINARYREADER_H_
@@ -1,5 +1,5 @@
 /*
- *    Copyright (c) 2012-2023
+ *    Copyright (c) 2012-2024
  *      SMASH Team
  *
  *    GNU General Public License (GPLv3 or later)
@@ -9,9 +9,12 @@
 
 #include <map>
 #include <memory>
+#include <optional>
 
 #include "forwarddeclarations.h"
 #include "modusdefault.h"
+#include "quantumsampling.h"
+#include "thermalsampling.h"
 
 namespace smash {
 
@@ -95,7 +98,8 @@ class BoxModus : public ModusDefault {
       const Particles &particles, double min_cell_length,
       double timestep_duration, CollisionCriterion crit,
       const bool include_unformed_particles,
-      CellSizeStrategy strategy = CellSizeStrategy::Optimal) const {
+      CellSizeStrategy strategy = CellSizeStrategy::Optimal, double = 0.,
+      const std::optional<GridBase::MinAndLength> & = std::nullopt) const {
     CellNumberLimitation limit = CellNumberLimitation::ParticleNumber;
     if (crit == CollisionCriterion::Stochastic) {
       limit = CellNumberLimitation::None;
@@ -131,11 +135,22 @@ class BoxModus : public ModusDefault {
 
   /// \return equilibration time of the box
   double equilibration_time() const { return equilibration_time_; }
+  /// \copydoc smash::ModusDefault::equilibrium_criterion()
+  std::optional<EquilibriumCriterion> equilibrium_criterion() const {
+    return equilibrium_criterion_;
+  }
   /// \return whether the modus is box (also, trivially true)
   bool is_box() const { return true; }
   /// \return length of the box
   double length() const { return length_; }
 
+  /**
+   * Use the given threads to sample the initial thermal momenta.
+   *
+   * \param[in] thread_pool Threads of the experiment, or nullptr
+   */
+  void set_thread_pool(ThreadPool *thread_pool) { thread_pool_ = thread_pool; }
+
  private:
   /// Initial momenta distribution: thermal or peaked momenta
   const BoxInitialCondition initial_condition_;
@@ -192,6 +207,14 @@ class BoxModus : public ModusDefault {
    * Initial momentum of the jet particle; only used if insert_jet_ is true
    */
   const double jet_mom_;
+  /// When the evolution stops at the equilibrium, if it does
+  const std::optional<EquilibriumCriterion> equilibrium_criterion_;
+  /// Tabulated thermal distributions of the particle species
+  ThermalSampling thermal_sampling_;
+  /// Quantum statistical distributions, set up in the first event using them
+  std::optional<QuantumSampling> quantum_sampling_;
+  /// Threads used for the thermal sampling, if any
+  ThreadPool *thread_pool_ = nullptr;
 
   /**
    * \ingroup logging
@@ -1,6 +1,6 @@
 /*
  *
- *    Copyright (c) 2019-2022
+ *    Copyright (c) 2019-2022,2024
  *      SMASH Team
  *
  *    GNU General Public License (GPLv3 or later)
@@ -167,6 +167,36 @@ class BremsstrahlungAction : public ScatterAction {
   /// Sampled value of theta (angle of the photon)
   double theta_;
 
+  /**
+   * Kinematics of the final state, which are the same for all fractional
+   * photons of a scattering.
+   */
+  struct FinalStateKinematics {
+    /// Point of the scattering
+    FourVector interaction_point;
+    /// Velocity of the center of mass frame in the computational frame
+    ThreeVector velocity;
+    /// Range of the photon momentum k [GeV]
+    double k_min, k_max;
+  };
+
+  /**
+   * Set up the outgoing particles and compute the kinematics of the final
+   * state, which only depend on the incoming particles.
+   *
+   * \return Kinematics shared by the fractional photons
+   */
+  FinalStateKinematics prepare_final_state();
+
+  /**
+   * Sample one 3-body final state set up by prepare_final_state.
+   *
+   * \param[in] kin Kinematics of the final state
+   * \param[in] check_conservation Whether the conservation laws are checked
+   */
+  void sample_final_state(const FinalStateKinematics &kin,
+                          bool check_conservation);
+
   /**
    * Create interpolation objects for tabularized cross sections:
    * total cross section, differential dSigma/dk, differential dSigma/dtheta
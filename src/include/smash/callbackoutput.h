@@ -0,0 +1,107 @@
+/*
+ *
+ *    Copyright (c) 2024
+ *      SMASH Team
+ *
+ *    GNU General Public License (GPLv3 or later)
+ *
+ */
+
+#ifndef SRC_INCLUDE_SMASH_CALLBACKOUTPUT_H_
+#define SRC_INCLUDE_SMASH_CALLBACKOUTPUT_H_
+
+#include <functional>
+#include <vector>
+
+#include "forwarddeclarations.h"
+#include "outputinterface.h"
+#include "particlespan.h"
+
+namespace smash {
+
+/**
+ * \ingroup output
+ *
+ * Output which hands the particles to functions given by the user instead of
+ * writing them anywhere. It is meant for using SMASH as a library, where the
+ * events are analyzed in the same process.
+ *
+ * The particles are passed as spans, which refer directly to the particles of
+ * SMASH, so nothing is copied or formatted. The spans are therefore only valid
+ * during the call of the function; particles which are needed later have to be
+ * copied, e.g. with ParticleSpan::copy_to_vector. The pointers viewed by the
+ * spans are stored in buffers reused for all calls.
+ *
+ * The output can be added to an experiment with Experiment::add_output. Like
+ * for all other outputs, every ensemble is passed on as an event of its own.
+ */
+class CallbackOutput : public OutputInterface {
+ public:
+  /**
+   * Function called at the end of every event.
+   *
+   * \param[in] event_number Number of the event
+   * \param[in] info Information about the event
+   * \param[in] particles Particles at the end of the event
+   */
+  using EventEndCallback = std::function<void(
+      int event_number, const EventInfo &info, ParticleSpan particles)>;
+
+  /**
+   * Function called for every interaction.
+   *
+   * \param[in] action Action that was performed
+   * \param[in] incoming Particles before the action
+   * \param[in] outgoing Particles after the action
+   */
+  using InteractionCallback = std::function<void(
+      const Action &action, ParticleSpan incoming, ParticleSpan outgoing)>;
+
+  /**
+   * Create the output.
+   *
+   * \param[in] at_eventend Function called at the end of every event
+   * \param[in] at_interaction Function called for every interaction, if any.
+   *            Without it, the interactions are not looked at at all.
+   */
+  explicit CallbackOutput(EventEndCallback at_eventend,
+                          InteractionCallback at_interaction = nullptr);
+
+  /**
+   * Pass the particles at the end of an event to the event end function.
+   *
+   * \param[in] particles Particles at the end of the event
+   * \param[in] event_number Number of the event
+   * \param[in] info Information about the event
+   */
+  void at_eventend(const Particles &particles, const int event_number,
+                   const EventInfo &info) override;
+
+  /**
+   * Pass an interaction to the interaction function, if there is one.
+   *
+   * \param[in] action Action that was performed
+   * \param[in] density Density at the interaction point, which is not used
+   */
+  void at_interaction(const Action &action, const double density) override;
+
+ private:
+  /// Function called at the end of every event
+  EventEndCallback at_eventend_;
+
+  /// Function called for every interaction
+  InteractionCallback at_interaction_;
+
+  /// Pointers to the particles at the end of the event
+  std::vector<const ParticleData *> particles_;
+
+  /// Pointers to the incoming particles of the interaction
+  std::vector<const ParticleData *> incoming_;
+
+  /// Pointers to the outgoing particles of the interaction
+  std::vector<const ParticleData *> outgoing_;
+};
+
+}  // namespace smash
+
+#endif  // SRC_INCLUDE_SMASH_CALLBACKOUTPUT_H_
@@ -0,0 +1,121 @@
+/*
+ *
+ *    Copyright (c) 2024
+ *      SMASH Team
+ *
+ *    GNU General Public License (GPLv3 or later)
+ *
+ */
+
+#ifndef SRC_INCLUDE_SMASH_CHECKPOINT_H_
+#define SRC_INCLUDE_SMASH_CHECKPOINT_H_
+
+#include <cstdint>
+#include <istream>
+#include <ostream>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace smash {
+
+/**
+ * \ingroup data
+ *
+ * Binary serialization of the state of the time evolution, from which an
+ * event is resumed, see Experiment::write_checkpoint.
+ *
+ * The values are written in their memory representation, hence a checkpoint
+ * can only be read by the same build of SMASH on the same kind of machine,
+ * with the same particles and decay modes.
+ */
+namespace checkpoint {
+
+/// Identifies a checkpoint of SMASH
+inline constexpr char magic[8] = "SMASHCP";
+
+/// Version of the layout of the checkpoint
+inline constexpr std::uint32_t version = 4;
+
+/**
+ * Write a value in its memory representation.
+ *
+ * \param[out] out Stream to write to
+ * \param[in] value Value to be written
+ */
+template <typename T>
+void write(std::ostream &out, const T &value) {
+  static_assert(std::is_trivially_copyable_v<T>,
+                "Only trivially copyable values can be written as bytes.");
+  out.write(reinterpret_cast<const char *>(&value), sizeof(T));
+}
+
+/**
+ * Read a value written by write.
+ *
+ * \param[in] in Stream to read from
+ * \param[out] value Value to be read
+ * \throw std::runtime_error if the stream ends before
+ */
+template <typename T>
+void read(std::istream &in, T &value) {
+  static_assert(std::is_trivially_copyable_v<T>,
+                "Only trivially copyable values can be read as bytes.");
+  if (!in.read(reinterpret_cast<char *>(&value), sizeof(T))) {
+    throw std::runtime_error("The checkpoint ends unexpectedly.");
+  }
+}
+
+/// Write both values of a pair, see write.
+template <typename T, typename U>
+void write(std::ostream &out, const std::pair<T, U> &value) {
+  write(out, value.first);
+  write(out, value.second);
+}
+
+/// Read both values of a pair, see read.
+template <typename T, typename U>
+void read(std::istream &in, std::pair<T, U> &value) {
+  read(in, value.first);
+  read(in, value.second);
+}
+
+/// Write the size and the elements of a vector, see write.
+template <typename T, typename Allocator>
+void write(std::ostream &out, const std::vector<T, Allocator> &values) {
+  write(out, static_cast<std::uint64_t>(values.size()));
+  if constexpr (std::is_trivially_copyable_v<T> && !std::is_same_v<T, bool>) {
+    out.write(reinterpret_cast<const char *>(values.data()),
+              values.size() * sizeof(T));
+  } else {
+    for (const T &value : values) {
+      write(out, static_cast<const T &>(value));
+    }
+  }
+}
+
+/// Read the size and the elements of a vector, see read.
+template <typename T, typename Allocator>
+void read(std::istream &in, std::vector<T, Allocator> &values) {
+  std::uint64_t size = 0;
+  read(in, size);
+  values.resize(size);
+  if constexpr (std::is_trivially_copyable_v<T> && !std::is_same_v<T, bool>) {
+    if (!in.read(reinterpret_cast<char *>(values.data()), size * sizeof(T))) {
+      throw std::runtime_error("The checkpoint ends unexpectedly.");
+    }
+  } else {
+    for (std::uint64_t i = 0; i < size; i++) {
+      T value;
+      read(in, value);
+      values[i] = value;
+    }
+  }
+}
+
+}  // namespace checkpoint
+
+}  // namespace smash
+
+#endif  // SRC_INCLUDE_SMASH_CHECKPOINT_H_
@@ -1,6 +1,6 @@
 /*
  *
- *    Copyright (c) 2014-2020,2022-2023
+ *    Copyright (c) 2014-2020,2022-2024
  *      SMASH Team
  *
  *    GNU General Public License (GPLv3 or later)
@@ -108,6 +108,8 @@ class Clock {
    * \param[in] start_time starting time of the simulation
    */
   virtual void remove_times_in_past(double start_time) = 0;
+  /// \return the number of ticks since the clock was reset
+  Representation ticks() const { return counter_; }
   /**
    * Advances the clock by one tick.
    *
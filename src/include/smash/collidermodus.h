@@ -1,5 +1,5 @@
 /*
- *    Copyright (c) 2012-2020,2022-2023
+ *    Copyright (c) 2012-2020,2022-2024
  *      SMASH Team
  *
  *    GNU General Public License (GPLv3 or later)
@@ -7,10 +7,12 @@
 #ifndef SRC_INCLUDE_SMASH_COLLIDERMODUS_H_
 #define SRC_INCLUDE_SMASH_COLLIDERMODUS_H_
 
+#include <cstdint>
 #include <cstring>
 #include <memory>
 #include <string>
 #include <utility>
+#include <vector>
 
 #include "deformednucleus.h"
 #include "forwarddeclarations.h"
@@ -18,6 +20,7 @@
 #include "interpolation.h"
 #include "modusdefault.h"
 #include "nucleus.h"
+#include "particledata.h"
 #include "pdgcode.h"
 
 namespace smash {
@@ -65,6 +68,8 @@ class ColliderModus : public ModusDefault {
    **/
   explicit ColliderModus(Configuration modus_config,
                          const ExperimentParameters &parameters);
+  /// Stops generating initial states in advance.
+  ~ColliderModus();
   /**
    * Creates full path string consisting of file_directory and file_name
    * Needed to initialize a customnucleus.
@@ -100,6 +105,27 @@ class ColliderModus : public ModusDefault {
    **/
   void sample_impact();
 
+  /**
+   * Take the initial state of the event with the given seed from the ones
+   * generated in advance, if this is enabled. The following calls of
+   * sample_impact and initial_conditions then use it instead of sampling.
+   *
+   * The initial states are generated in a background thread, while the
+   * current event evolves, each from the random stream of its event seed
+   * reserved for that purpose. They only depend on the event seed, but
+   * differ from the ones sampled without generating them in advance. The
+   * generation starts over if the seed does not belong to the event after
+   * the previous one.
+   *
+   * \param[in] seed Random seed of the event
+   * \param[in] n_ensembles Number of ensembles, each of which is filled
+   *                        with its own initial state
+   */
+  void prepare_event(int64_t seed, int n_ensembles);
+
+  /// \return Whether the initial states are generated in advance
+  bool pregenerates_events() const { return pregenerator_ != nullptr; }
+
   /// Time until nuclei have passed through each other
   double nuclei_passing_time() const {
     const double passing_distance =
@@ -130,6 +156,13 @@ class ColliderModus : public ModusDefault {
   double sqrt_s_NN() const { return sqrt_s_NN_; }
   /// \return impact parameter of the collision
   double impact_parameter() const { return impact_; }
+  /**
+   * \return Weight of the event, which is the ratio of the quadratic
+   *         distribution of minimum bias events to the distribution from
+   *         which the impact parameter is sampled, if the events are
+   *         weighted, otherwise 1
+   */
+  double event_weight() const;
   /// \return Whether the calculation frame is the fixed target frame
   bool calculation_frame_is_fixed_target() const {
     return frame_ == CalculationFrame::FixedTarget ? true : false;
@@ -144,6 +177,51 @@ class ColliderModus : public ModusDefault {
   };
 
  private:
+  /// Initial state of an event generated in advance
+  struct PregeneratedEvent {
+    /// Impact parameter
+    double impact;
+    /// Beam velocity of the projectile
+    double velocity_projectile;
+    /// Beam velocity of the target
+    double velocity_target;
+    /// Starting time of the simulation
+    double start_time;
+    /// Nucleons of each ensemble
+    std::vector<ParticleList> ensembles;
+  };
+  /// Generates the initial states of the following events in a thread
+  class Pregenerator;
+
+  /**
+   * Generates the initial states in advance, if this is enabled, nullptr
+   * otherwise.
+   */
+  std::unique_ptr<Pregenerator> pregenerator_;
+  /// Initial state of the current event, if generated in advance
+  PregeneratedEvent pregenerated_event_;
+  /// Ensemble of the current event to be filled next
+  size_t next_ensemble_ = 0;
+
+  /**
+   * Sample the initial state of the current event from the random stream
+   * reserved for generating them in advance.
+   *
+   * \param[in] seed Random seed of the event
+   * \param[in] n_ensembles Number of ensembles
+   * \return The initial state
+   */
+  PregeneratedEvent generate_event(int64_t seed, int n_ensembles);
+
+  /**
+   * Arrange the nucleons of both nuclei, boost them and shift them into
+   * their starting positions.
+   *
+   * \param[out] particles An empty list that gets filled up by this function
+   * \return The starting time of the simulation
+   */
+  double sample_initial_state(Particles *particles);
+
   /**
    * Projectile.
    *
@@ -211,6 +289,13 @@ class ColliderModus : public ModusDefault {
   double imp_max_ = 0.0;
   /// Maximum value of yield. Needed for custom impact parameter sampling.
   double yield_max_ = 0.0;
+  /**
+   * Integral of the custom impact parameter distribution between imp_min_ and
+   * imp_max_, which normalizes the weights of the events.
+   */
+  double yield_integral_ = 0.0;
+  /// Whether the events are weighted, see event_weight
+  bool weighted_impact_ = false;
   /// Pointer to the impact parameter interpolation.
   std::unique_ptr<InterpolateDataLinear<double>> impact_interpolation_ =
       nullptr;
@@ -0,0 +1,151 @@
+/*
+ *
+ *    Copyright (c) 2024
+ *      SMASH Team
+ *
+ *    GNU General Public License (GPLv3 or later)
+ *
+ */
+
+#ifndef SRC_INCLUDE_SMASH_COLLISIONPREFILTER_H_
+#define SRC_INCLUDE_SMASH_COLLISIONPREFILTER_H_
+
+#include <array>
+#include <cstddef>
+#include <vector>
+
+#include "forwarddeclarations.h"
+#include "fourvector.h"
+#include "particlespan.h"
+
+namespace smash {
+
+/**
+ * \ingroup action
+ *
+ * Positions and momenta of particles laid out as a structure of arrays, such
+ * that the geometric collision criterion can be evaluated for many pairs of
+ * particles by loops the compiler vectorizes.
+ *
+ * The particles are ordered by their Group, keeping their order within a
+ * group, such that the spectators of one nucleus can be skipped as a whole.
+ */
+struct KinematicsSnapshot {
+  /// Groups of particles, by which the snapshot is ordered
+  enum Group : unsigned char {
+    /// Particles which interacted or do not belong to a nucleus
+    Participant,
+    /// Particles of the projectile which did not interact yet
+    ProjectileSpectator,
+    /// Particles of the target which did not interact yet
+    TargetSpectator
+  };
+
+  /// Number of groups
+  static constexpr int n_groups = 3;
+
+  /**
+   * Copy the kinematics of the given particles.
+   *
+   * \param[in] particles Particles to be copied
+   * \param[in] beam_momentum [GeV] List of beam momenta for each particle;
+   *            they are used for the collision time of particles from the
+   *            initial nuclei which did not interact yet (frozen Fermi motion)
+   * \throw std::runtime_error if a particle has a negative id
+   */
+  void assign(const ParticleSpan &particles,
+              const std::vector<FourVector> &beam_momentum);
+
+  /// \return number of particles
+  std::size_t size() const { return id.size(); }
+
+  /// Ids of the particles
+  std::vector<int> id;
+  /// Group of the particles
+  std::vector<unsigned char> group;
+  /// Position of the particles in the copied span
+  std::vector<std::size_t> index;
+  /// Entry in the snapshot of the particle at a position in the copied span
+  std::vector<std::size_t> slot;
+  /// The particles of group g are the entries group_begin[g] to
+  /// group_begin[g + 1] (excluding)
+  std::array<std::size_t, n_groups + 1> group_begin{};
+  /// Time, x, y and z components of the positions [fm]
+  std::vector<double> t, x, y, z;
+  /// Energy, x, y and z components of the momenta [GeV]
+  std::vector<double> e, px, py, pz;
+  /**
+   * Energy, x, y and z components of the momenta used for the collision time,
+   * which differ from the momenta only for frozen Fermi motion [GeV]
+   */
+  std::vector<double> e_time, px_time, py_time, pz_time;
+};
+
+/**
+ * \ingroup action
+ *
+ * Quickly rejects pairs of particles which cannot collide in a time step
+ * according to the geometric collision criterion.
+ *
+ * For every pair, the collision time and the transverse distance are
+ * evaluated like by ScatterActionsFinder::collision_time and
+ * ScatterAction::transverse_distance_sqr. A pair is only rejected if it is
+ * outside of the time step or farther apart than the maximal transverse
+ * distance with a margin for rounding, such that all pairs which pass the
+ * detailed check also pass the filter. Optionally, the spectators of the
+ * nucleus of a particle, which is a spectator itself, are not looked at, as
+ * they are not allowed to collide. It does not allocate memory once its
+ * buffers are large enough.
+ */
+class CollisionPrefilter {
+ public:
+  /**
+   * Select the particles which may collide with a given particle.
+   *
+   * \param[in] a Snapshot holding the given particle
+   * \param[in] i Position of the given particle in the span copied to \p a
+   * \param[in] b Snapshot of the possible collision partners
+   * \param[in] dt Duration of the time step [fm]
+   * \param[in] max_transverse_distance_sqr Largest squared transverse distance
+   *            of colliding particles [fm^2]
+   * \param[in] only_larger_ids Whether only partners with a larger id than the
+   *            given particle are selected
+   * \param[in] separate_spectators Whether spectators of the same nucleus
+   *            are rejected
+   * \return Positions of the selected particles in the span copied to \p b,
+   *         in increasing order. They are valid until the next call.
+   */
+  const std::vector<std::size_t> &select(const KinematicsSnapshot &a,
+                                         std::size_t i,
+                                         const KinematicsSnapshot &b, double dt,
+                                         double max_transverse_distance_sqr,
+                                         bool only_larger_ids = false,
+                                         bool separate_spectators = false);
+
+  /**
+   * Look up the transverse distance of a partner selected by the last call of
+   * select, such that the pair can be rejected by its cross section before
+   * the detailed check.
+   *
+   * \param[in] b Snapshot of the partners passed to select
+   * \param[in] j Position of the selected partner in the span copied to \p b
+   * \return Lower bound of the squared transverse distance of the given
+   *         particle and the partner, allowing for rounding [fm^2]
+   */
+  double min_transverse_distance_sqr(const KinematicsSnapshot &b,
+                                     std::size_t j) const {
+    return min_distance_sqr_[b.slot[j]];
+  }
+
+ private:
+  /// Whether a partner is selected, computed for all partners at once
+  std::vector<char> keep_;
+  /// Lower bound of the squared transverse distance to every partner [fm^2]
+  std::vector<double> min_distance_sqr_;
+  /// Indices of the selected partners
+  std::vector<std::size_t> selected_;
+};
+
+}  // namespace smash
+
+#endif  // SRC_INCLUDE_SMASH_COLLISIONPREFILTER_H_
@@ -0,0 +1,183 @@
+/*
+ *
+ *    Copyright (c) 2024
+ *      SMASH Team
+ *
+ *    GNU General Public License (GPLv3 or later)
+ *
+ */
+
+#ifndef SRC_INCLUDE_SMASH_COLLISIONTRACE_H_
+#define SRC_INCLUDE_SMASH_COLLISIONTRACE_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <mutex>
+#include <vector>
+
+#include "forwarddeclarations.h"
+#include "particledata.h"
+
+namespace smash {
+
+/**
+ * \ingroup action
+ *
+ * A pair of particles as captured in a CollisionTrace.
+ */
+struct CollisionTraceRecord {
+  /// What was captured
+  enum class Kind : char {
+    /// Candidate pair, which was checked for a collision
+    Pair = 'p',
+    /// Collision, whose final state was generated
+    Collision = 'c'
+  };
+
+  /// What was captured
+  Kind kind = Kind::Pair;
+  /// Collision criterion of the run
+  CollisionCriterion criterion = CollisionCriterion::Geometric;
+  /**
+   * Time step within which the pair was checked for a pair, time until the
+   * collision for a collision [fm]
+   */
+  double time = 0.;
+  /// Volume of the grid cell of the stochastic criterion [fm^3]
+  double gcell_vol = 0.;
+  /// Probability with which a sampled pair was picked
+  double majorant = 1.;
+  /// The two particles
+  ParticleList incoming;
+};
+
+/**
+ * \ingroup action
+ *
+ * Binary trace of the candidate pairs checked by
+ * ScatterActionsFinder::check_collision_two_part and of the collisions whose
+ * final state is generated, which can be fed into the collision finder again
+ * with `smash_replay`, see \ref key_gen_capture_collisions_.
+ *
+ * The trace starts with the magic number "SMSHTRCE", the `uint32_t` format
+ * version, the `double` formation power of the particles and the `char`
+ * default of `Use_Monash_Tune`. Every record consists of its `char` kind
+ * (see CollisionTraceRecord::Kind), the `char` collision criterion, the
+ * `double` time, cell volume and majorant, and the two particles. Every
+ * particle is written as `int32_t` PDG code, ID, ID of the last process,
+ * number of collisions, `char` BelongsTo, and `double` position,
+ * momentum, begin and end of the formation and cross section scaling
+ * factor. All values are written with the byte order of the machine.
+ *
+ * Records are added by all threads. They are collected in a buffer, which is
+ * written once it is large.
+ */
+class CollisionTrace {
+ public:
+  /// Version of the format
+  static constexpr std::uint32_t format_version = 1;
+
+  /**
+   * Create the trace file and write its header.
+   *
+   * \param[in] path Path of the trace file
+   * \param[in] formation_power Power with which the cross section scaling
+   *            factors grow, see ParticleData::formation_power_
+   * \param[in] use_monash_tune_default Default of `Use_Monash_Tune` of the
+   *            strings in the captured run
+   * \throw std::runtime_error if the file cannot be written
+   */
+  CollisionTrace(const std::filesystem::path &path, double formation_power,
+                 bool use_monash_tune_default);
+
+  /// Write the remaining records.
+  ~CollisionTrace();
+
+  /// Cannot be copied
+  CollisionTrace(const CollisionTrace &) = delete;
+  /// Cannot be copied
+  CollisionTrace &operator=(const CollisionTrace &) = delete;
+
+  /**
+   * Capture a pair checked for a collision, see
+   * ScatterActionsFinder::check_collision_two_part.
+   *
+   * \param[in] criterion Collision criterion
+   * \param[in] data_a First particle
+   * \param[in] data_b Second particle
+   * \param[in] dt Time step [fm]
+   * \param[in] gcell_vol Volume of the grid cell [fm^3]
+   * \param[in] majorant Probability with which the pair was picked
+   */
+  void add_pair(CollisionCriterion criterion, const ParticleData &data_a,
+                const ParticleData &data_b, double dt, double gcell_vol,
+                double majorant);
+
+  /**
+   * Capture a collision, whose final state is generated.
+   *
+   * \param[in] criterion Collision criterion
+   * \param[in] data_a First incoming particle
+   * \param[in] data_b Second incoming particle
+   * \param[in] time_until_collision Time from the particles to the
+   *            collision [fm]
+   */
+  void add_collision(CollisionCriterion criterion, const ParticleData &data_a,
+                     const ParticleData &data_b, double time_until_collision);
+
+  /**
+   * Write the collected records.
+   *
+   * \throw std::runtime_error if the file cannot be written
+   */
+  void flush();
+
+ private:
+  /**
+   * Encode a record and add it to the buffer, see CollisionTraceRecord for
+   * the parameters.
+   */
+  void append(CollisionTraceRecord::Kind kind, CollisionCriterion criterion,
+              double time, double gcell_vol, double majorant,
+              const ParticleData &data_a, const ParticleData &data_b);
+
+  /// The trace file
+  std::ofstream file_;
+  /// Guards the buffer
+  std::mutex mutex_;
+  /// Records which are not written yet
+  std::vector<char> buffer_;
+};
+
+/**
+ * \ingroup action
+ *
+ * Content of a CollisionTrace as read back.
+ */
+struct CollisionTraceContent {
+  /// Power with which the cross section scaling factors grow
+  double formation_power = 1.;
+  /// Default of `Use_Monash_Tune` in the captured run
+  bool use_monash_tune_default = false;
+  /// The records in the order in which they were captured
+  std::vector<CollisionTraceRecord> records;
+};
+
+/**
+ * \ingroup action
+ *
+ * Read a trace written by CollisionTrace. The particle types have to be
+ * initialized with the same particles as in the captured run.
+ *
+ * \param[in] path Path of the trace file
+ * \return The content of the trace
+ * \throw std::runtime_error if the file cannot be read, is no trace of this
+ *        format version or is truncated
+ */
+CollisionTraceContent read_collision_trace(const std::filesystem::path &path);
+
+}  // namespace smash
+
+#endif  // SRC_INCLUDE_SMASH_COLLISIONTRACE_H_
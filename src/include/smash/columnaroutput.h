@@ -0,0 +1,153 @@
+/*
+ *
+ *    Copyright (c) 2024
+ *      SMASH Team
+ *
+ *    GNU General Public License (GPLv3 or later)
+ *
+ */
+
+#ifndef SRC_INCLUDE_SMASH_COLUMNAROUTPUT_H_
+#define SRC_INCLUDE_SMASH_COLUMNAROUTPUT_H_
+
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "file.h"
+#include "forwarddeclarations.h"
+#include "outputinterface.h"
+#include "outputparameters.h"
+
+namespace smash {
+
+/**
+ * \ingroup output
+ *
+ * Writes the particle lists column by column into a binary file, such that
+ * single quantities like the momenta can be read without reading the whole
+ * particle records.
+ *
+ * Every particle list is written as one chunk, in which the values of each
+ * column follow each other. An index of all chunks is appended as footer when
+ * the file is closed. See \ref doxypage_output_columnar for the layout.
+ */
+class ColumnarOutput : public OutputInterface {
+ public:
+  /// Version of the file format
+  static constexpr std::uint16_t format_version = 3;
+
+  /**
+   * Create the columnar particle output.
+   *
+   * \param[in] path Output path.
+   * \param[in] name Name of the output.
+   * \param[in] out_par A structure containing the parameters of the output.
+   */
+  ColumnarOutput(const std::filesystem::path &path, std::string name,
+                 const OutputParameters &out_par);
+
+  /// Append the index of the chunks, before the file is closed.
+  ~ColumnarOutput() override;
+
+  /**
+   * Writes the initial particles of an event as chunk.
+   * \param[in] particles Current list of all particles.
+   * \param[in] event_number Number of the event.
+   * \param[in] event Event info, see \ref event_info
+   */
+  void at_eventstart(const Particles &particles, const int event_number,
+                     const EventInfo &event) override;
+
+  /**
+   * Writes the final particles of an event as chunk.
+   * \param[in] particles Current list of particles.
+   * \param[in] event_number Number of the event.
+   * \param[in] event Event info, see \ref event_info
+   */
+  void at_eventend(const Particles &particles, const int event_number,
+                   const EventInfo &event) override;
+
+  /**
+   * Writes the particles at an intermediate time as chunk.
+   * \param[in] particles Current list of particles.
+   * \param[in] clock Unused, needed since inherited.
+   * \param[in] dens_param Unused, needed since inherited.
+   * \param[in] event Event info, see \ref event_info
+   */
+  void at_intermediate_time(const Particles &particles,
+                            const std::unique_ptr<Clock> &clock,
+                            const DensityParameters &dens_param,
+                            const EventInfo &event) override;
+
+  /// \return Memory allocated for the chunk buffer and the index [bytes]
+  std::size_t buffer_size() const override {
+    return buffer_.capacity() + chunks_.capacity() * sizeof(Chunk);
+  }
+
+ private:
+  /// Entry of the index in the footer
+  struct Chunk {
+    /// Position of the chunk in the file in bytes
+    std::uint64_t offset;
+    /// Kind of the particle list: 'i'nitial, inter'm'ediate or 'f'inal
+    char kind;
+    /// Number of the event
+    std::int32_t event_number;
+    /// Time of the particle list
+    double time;
+    /// Number of particles
+    std::uint32_t n_particles;
+  };
+
+  /**
+   * Write a particle list as chunk and add it to the index.
+   *
+   * \param[in] kind Kind of the particle list, see Chunk::kind
+   * \param[in] particles Particle list
+   * \param[in] event_number Number of the event
+   * \param[in] event Event info, see \ref event_info
+   */
+  void write_chunk(char kind, const Particles &particles, int event_number,
+                   const EventInfo &event);
+
+  /**
+   * Write bytes to the file and advance the position.
+   *
+   * \param[in] data Bytes to be written.
+   * \param[in] size Number of bytes.
+   */
+  void write_bytes(const void *data, std::size_t size);
+
+  /// Write a value to the file.
+  template <typename T>
+  void write(const T &value) {
+    write_bytes(&value, sizeof(T));
+  }
+
+  /// Write a string with its length to the file.
+  void write(const std::string &s);
+
+  /// Binary particles output
+  RenamingFilePtr file_;
+  /// Position in the file in bytes
+  std::uint64_t position_ = 0;
+  /// Whether the extended columns are written
+  bool extended_;
+  /// Whether the columns of doubles are written as floats
+  bool single_precision_;
+  /// Whether only final particles are written
+  OutputOnlyFinal only_final_;
+  /// Number of the current event
+  int event_number_ = 0;
+  /// Index of the chunks written so far
+  std::vector<Chunk> chunks_;
+  /// Chunk put together before it is written
+  std::vector<char> buffer_;
+};
+
+}  // namespace smash
+
+#endif  // SRC_INCLUDE_SMASH_COLUMNAROUTPUT_H_
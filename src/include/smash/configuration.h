@@ -1,6 +1,6 @@
 /*
  *
- *    Copyright (c) 2014-2023
+ *    Copyright (c) 2014-2024
  *      SMASH Team
  *
  *    GNU General Public License (GPLv3 or later)
@@ -724,9 +724,35 @@ class Configuration {
       if (s == "Fixed") {
         return TimeStepMode::Fixed;
       }
-      throw IncorrectTypeInAssignment("The value for key \"" +
-                                      std::string(key_) +
-                                      "\" should be \"None\" or \"Fixed\".");
+      if (s == "Adaptive") {
+        return TimeStepMode::Adaptive;
+      }
+      throw IncorrectTypeInAssignment(
+          "The value for key \"" + std::string(key_) +
+          "\" should be \"None\", \"Fixed\" or \"Adaptive\".");
+    }
+
+    /**
+     * Set the conservation check from configuration values.
+     *
+     * \return Conservation check.
+     * \throw IncorrectTypeInAssignment in case a conservation check that is
+     * not available is provided as a configuration value.
+     */
+    operator ConservationCheck() const {
+      const std::string s = operator std::string();
+      if (s == "Off") {
+        return ConservationCheck::Off;
+      }
+      if (s == "Sampled") {
+        return ConservationCheck::Sampled;
+      }
+      if (s == "Full") {
+        return ConservationCheck::Full;
+      }
+      throw IncorrectTypeInAssignment(
+          "The value for key \"" + std::string(key_) +
+          "\" should be \"Off\", \"Sampled\" or \"Full\".");
     }
 
     /**
@@ -882,6 +908,29 @@ class Configuration {
           "\"Geometric\", \"Stochastic\" " + "or \"Covariant\".");
     }
 
+    /**
+     * Set the collision search from configuration values.
+     *
+     * \return CollisionSearch.
+     * \throw IncorrectTypeInAssignment in case a collision search that is
+     * not available is provided as a configuration value.
+     */
+    operator CollisionSearch() const {
+      const std::string s = operator std::string();
+      if (s == "Grid") {
+        return CollisionSearch::Grid;
+      }
+      if (s == "Sweep") {
+        return CollisionSearch::Sweep;
+      }
+      if (s == "Auto") {
+        return CollisionSearch::Auto;
+      }
+      throw IncorrectTypeInAssignment(
+          "The value for key \"" + std::string(key_) +
+          "\" should be \"Grid\", \"Sweep\" or \"Auto\".");
+    }
+
     /**
      * Set total cross section strategy from configuration values.
      *
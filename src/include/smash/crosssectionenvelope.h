@@ -0,0 +1,130 @@
+/*
+ *
+ *    Copyright (c) 2024
+ *      SMASH Team
+ *
+ *    GNU General Public License (GPLv3 or later)
+ *
+ */
+
+#ifndef SRC_INCLUDE_SMASH_CROSSSECTIONENVELOPE_H_
+#define SRC_INCLUDE_SMASH_CROSSSECTIONENVELOPE_H_
+
+#include <atomic>
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <vector>
+
+#include "forwarddeclarations.h"
+
+namespace smash {
+
+/**
+ * \ingroup action
+ *
+ * Upper bound of the total cross section of two particles, which is tabulated
+ * for each pair of particle types in bins of the center-of-mass energy.
+ *
+ * The action finder compares the distance of two particles with the bound
+ * first, such that the exact cross section, which requires to set up all
+ * collision branches, is only computed for pairs which may collide.
+ *
+ * The bound is only available for pairs of stable particles on their mass
+ * shell. Their cross section depends on the center-of-mass energy only, as
+ * long as the thresholds are not shifted by potentials. The table of a pair
+ * is filled on its first use, by evaluating the exact cross section at the
+ * edges of every bin and at all pole masses of resonances inside. The
+ * largest value is multiplied by a safety factor. The first bin above the
+ * threshold is not bounded, because cross sections of exothermic reactions
+ * diverge there. Debug builds check that the bound holds for every pair for
+ * which the exact cross section is computed.
+ *
+ * The tables can be filled concurrently by several threads. The exact cross
+ * section has to be a deterministic function, then all threads agree on the
+ * tables.
+ */
+class CrossSectionEnvelope {
+ public:
+  /**
+   * Function returning the exact total cross section of two particles [mb],
+   * which is tabulated.
+   */
+  using ExactCrossSection =
+      std::function<double(const ParticleData &, const ParticleData &)>;
+
+  /**
+   * Construct the envelope for the particle types, which have to be
+   * initialized.
+   *
+   * \param[in] exact Exact cross section
+   */
+  explicit CrossSectionEnvelope(ExactCrossSection exact);
+
+  /// Cannot be copied, the tables are owned
+  CrossSectionEnvelope(const CrossSectionEnvelope &) = delete;
+  /// Cannot be copied, the tables are owned
+  CrossSectionEnvelope &operator=(const CrossSectionEnvelope &) = delete;
+
+  /// Destroy the tables.
+  ~CrossSectionEnvelope();
+
+  /**
+   * Look up the upper bound of the total cross section.
+   *
+   * \param[in] a First particle
+   * \param[in] b Second particle
+   * \param[in] sqrt_s Center-of-mass energy of both [GeV]
+   * \return Upper bound of the exact cross section of \p a and \p b [mb], or
+   *         infinity if there is no bound
+   */
+  double max_cross_section(const ParticleData &a, const ParticleData &b,
+                           double sqrt_s) const;
+
+  /// Width of the bins of the center-of-mass energy [GeV]
+  static constexpr double bin_width = 0.025;
+  /// Number of bins above the threshold, beyond there is no bound
+  static constexpr std::size_t n_bins = 200;
+  /// Factor by which the tabulated values exceed the sampled cross sections
+  static constexpr double safety_factor = 1.25;
+
+ private:
+  /// Upper bounds of the cross section of a pair of types [mb]
+  struct Table {
+    /// Sum of the masses of both types [GeV]
+    double threshold;
+    /// Upper bound in every bin, starting at the threshold [mb]
+    std::vector<double> max_xs;
+  };
+
+  /**
+   * Tabulate the cross section of two types.
+   *
+   * \param[in] type_a First type
+   * \param[in] type_b Second type
+   * \return Table for the pair
+   */
+  std::unique_ptr<Table> tabulate(const ParticleType &type_a,
+                                  const ParticleType &type_b) const;
+
+  /// Exact cross section, which is tabulated
+  const ExactCrossSection exact_;
+  /**
+   * Index of each particle type among the stable types, or -1 if it is not
+   * stable
+   */
+  std::vector<int> stable_index_;
+  /// Number of stable types
+  std::size_t n_stable_ = 0;
+  /// Pole masses of all unstable types in increasing order [GeV]
+  std::vector<double> poles_;
+  /**
+   * Table of each ordered pair of stable types, which is null until it is
+   * used first
+   */
+  std::unique_ptr<std::atomic<const Table *>[]> tables_;
+};
+
+}  // namespace smash
+
+#endif  // SRC_INCLUDE_SMASH_CROSSSECTIONENVELOPE_H_
@@ -1,6 +1,6 @@
 /*
  *
- *    Copyright (c) 2013-2014,2018-2023
+ *    Copyright (c) 2013-2014,2018-2024
  *      SMASH Team
  *
  *    GNU General Public License (GPLv3 or later)
@@ -12,6 +12,7 @@
 
 #include <memory>
 #include <utility>
+#include <vector>
 
 #include "forwarddeclarations.h"
 #include "isoparticletype.h"
@@ -58,6 +59,22 @@ class CrossSections {
       const ScatterActionsFinderParameters& finder_parameters,
       StringProcess* string_process) const;
 
+  /**
+   * Sum the cross sections of all collisions, which generate_collision_list
+   * returns, in the same order. The elastic collision and the resonance
+   * formations, which are possible for most pairs, are summed without setting
+   * up their collision branches.
+   *
+   * \param[in] finder_parameters parameters for collision finding.
+   * \param[in] string_process a pointer to the StringProcess object,
+   * which is used for string excitation and fragmentation.
+   *
+   * \return Sum of the positive partial cross sections [mb].
+   */
+  double sum_of_collision_list(
+      const ScatterActionsFinderParameters& finder_parameters,
+      StringProcess* string_process) const;
+
   /**
    * Select the parametrization for the total cross section, given the types of
    * incoming particles.
@@ -69,6 +86,29 @@ class CrossSections {
   double parametrized_total(
       const ScatterActionsFinderParameters& finder_parameters) const;
 
+  /**
+   * Evaluate the parametrized total cross section for several pairs of
+   * particles of the same types at once.
+   *
+   * The parametrization is selected once for all pairs and evaluated with
+   * the batch versions of the parametrizations, without allocating memory.
+   * For a single pair, the result equals parametrized_total of its
+   * CrossSections object.
+   *
+   * \param[in] pdg_a PDG code of the first particle of every pair
+   * \param[in] pdg_b PDG code of the second particle of every pair
+   * \param[in] sqrts Center-of-mass energies of the pairs [GeV]
+   * \param[in] n Number of pairs
+   * \param[out] xs Total cross sections of the pairs [mb], which must not
+   *             overlap with \p sqrts
+   * \param[in] finder_parameters Parameters for collision finding, containing
+   * cut for low energy NN interactions.
+   */
+  static void parametrized_total(
+      const PdgCode& pdg_a, const PdgCode& pdg_b, const double* sqrts,
+      std::size_t n, double* xs,
+      const ScatterActionsFinderParameters& finder_parameters);
+
   /**
    * Helper function:
    * Sum all cross sections of the given process list.
@@ -128,6 +168,21 @@ class CrossSections {
   double formation(const ParticleType& type_resonance,
                    double cm_momentum_sqr) const;
 
+  /**
+   * Return the 2-to-1 resonance production cross section for a resonance
+   * that can be formed from the incoming particles.
+   *
+   * \param[in] resonance The resonance, as listed by resonance_formations
+   * for the incoming particles.
+   * \param[in] cm_momentum_sqr Square of the center-of-mass momentum of the
+   * two initial particles.
+   *
+   * \return The cross section for the process
+   * [initial particle a] + [initial particle b] -> resonance.
+   */
+  double formation(const ResonanceFormation& resonance,
+                   double cm_momentum_sqr) const;
+
   /**
    * Find all 2->2 processes which are suppressed at high energies when
    * strings are turned on with probabilites, but important for the
@@ -357,6 +412,28 @@ class CrossSections {
                                   double region_upper) const;
 
  private:
+  /**
+   * Determine the elastic cross section, which the collision branch created
+   * by elastic() carries.
+   *
+   * \param[in] finder_parameters parameters for collision finding, including
+   * cross section modifications from config file.
+   *
+   * \return Elastic cross section [mb]
+   */
+  double elastic_cross_section(
+      const ScatterActionsFinderParameters& finder_parameters) const;
+
+  /**
+   * Find all resonances that can be produced in a 2->1 collision of the two
+   * input particles with a non-negligible cross section.
+   *
+   * \param[in] found Function called with the type of each resonance and its
+   * production cross section [mb], in the order of two_to_one()
+   */
+  template <typename Found>
+  void find_resonances(Found&& found) const;
+
   /**
    * Choose the appropriate parametrizations for given incoming particles and
    * return the (parametrized) elastic cross section.
@@ -567,6 +644,59 @@ class CrossSections {
       const ParticleTypePtrList& type_res_2,
       const IntegrationMethod integrator) const;
 
+  /// Final state of an NN reaction, which conserves charge and isospin
+  struct NNChannel {
+    /// First final-state particle
+    ParticleTypePtr type_res_1;
+    /// Second final-state particle
+    ParticleTypePtr type_res_2;
+    /// Twice the total isospin
+    int twoI;
+    /// Product of the isospin and the spin factor
+    double factor;
+  };
+
+  /**
+   * Find the final states of NN reactions, which conserve charge and
+   * isospin, in the order in which find_nn_xsection_from_type lists them.
+   *
+   * \param[in] type_a First incoming particle
+   * \param[in] type_b Second incoming particle
+   * \param[in] type_res_1 List of possible first final resonance types
+   * \param[in] type_res_2 List of possible second final resonance types
+   * \return The final states with their spin and isospin factors
+   */
+  static std::vector<NNChannel> find_nn_channels(
+      const ParticleType& type_a, const ParticleType& type_b,
+      const ParticleTypePtrList& type_res_1,
+      const ParticleTypePtrList& type_res_2);
+
+  /**
+   * The final states of NN → NR or NN → ΔR of the incoming particles. They
+   * only depend on the types of the incoming particles, hence they are found
+   * once per pair of types and kept for all later collisions.
+   *
+   * \param[in] type_a First incoming particle
+   * \param[in] type_b Second incoming particle
+   * \param[in] delta Whether the channels of NN → ΔR are asked for
+   * \return The final states with their spin and isospin factors
+   */
+  static const std::vector<NNChannel>& cached_nn_channels(
+      const ParticleType& type_a, const ParticleType& type_b, bool delta);
+
+  /**
+   * Calculate the cross sections of given NN final states.
+   *
+   * \param[in] channels Final states with their spin and isospin factors
+   * \param[in] integrator Used to integrate over the kinematically allowed
+   * mass range of the Breit-Wigner distribution
+   * \return List of the NN reactions with a non-vanishing cross section
+   */
+  template <class IntegrationMethod>
+  CollisionBranchList nn_xsections_from_channels(
+      const std::vector<NNChannel>& channels,
+      const IntegrationMethod integrator) const;
+
   /**
    * Determine the momenta of the incoming particles in the
    * center-of-mass system.
@@ -10,6 +10,7 @@
 #ifndef SRC_INCLUDE_SMASH_CROSSSECTIONSPHOTON_H_
 #define SRC_INCLUDE_SMASH_CROSSSECTIONSPHOTON_H_
 
+#include "forwarddeclarations.h"
 #include "kinematics.h"
 
 namespace smash {
@@ -30,11 +31,13 @@ namespace smash {
  */
 double cut_off(const double sigma_mb);
 
-/**
- * Calculation method for the cross sections. It has only one member at the
- * moment. In the future there will be more options.
- */
-enum class ComputationMethod { Analytic };
+/// Calculation method for the cross sections.
+enum class ComputationMethod {
+  /// Evaluate the analytic formulas
+  Analytic,
+  /// Interpolate tables of the analytic formulas
+  Lookup
+};
 
 template <ComputationMethod method>
 class CrosssectionsPhoton {};
@@ -152,6 +155,100 @@ class CrosssectionsPhoton<ComputationMethod::Analytic> {
   constexpr static double a1_mass = 1.26;
 };
 
+/**
+ * Class to look up the cross-section of a meson-meson to meson-photon process
+ * in tables of the analytic formulas, which are expensive to evaluate.
+ *
+ * The total cross sections are tabulated as a function of the excess of
+ * \f$\sqrt{s}\f$ above the threshold for rho masses between 0.27 and
+ * 1.47 GeV, with a spacing of 2.5 MeV in the energy and 10 MeV in the rho
+ * mass. For the differential cross sections, the Mandelstam t is mapped to
+ * its kinematic range, which is covered by 30 intervals that are denser
+ * towards its ends, and the spacing is 10 MeV in the energy and 20 MeV in the
+ * rho mass. In between, the tables are linearly interpolated. The tables
+ * reach from 20 MeV to 2.52 GeV above the threshold. Outside of them, within
+ * 50 MeV of the omega pole for channels with an omega in the s-channel, and
+ * as long as nothing is tabulated, the analytic formulas are evaluated.
+ */
+template <>
+class CrosssectionsPhoton<ComputationMethod::Lookup> {
+ public:
+  /**
+   * Tabulate the cross sections of all channels, or read them from the
+   * currently existing TabulationCache. This has to be done before the tables
+   * are used, because it is not thread-safe.
+   *
+   * \param[in] pool Threads to tabulate the channels concurrently (optional)
+   */
+  static void tabulate(ThreadPool *pool = nullptr);
+
+  /// \return Whether the cross sections are tabulated
+  static bool is_tabulated();
+
+  /** @name Total cross-section
+   * The functions in this group look up the total cross-section for a photon
+   * process.
+   */
+  ///@{
+  /**
+   * Total cross sections for given photon process:
+   *
+   * \param[in] s Mandelstam-s [GeV^2]
+   * \param[in] m_rho Mass of participating rho-meson [GeV]
+   * \returns photon cross-section [mb]
+   */
+  static double xs_pi_pi_rho0(const double s, const double m_rho);
+  static double xs_pi_pi0_rho(const double s, const double m_rho);
+  static double xs_pi0_rho0_pi0(const double s, const double m_rho);
+  static double xs_pi_rho0_pi(const double s, const double m_rho);
+
+  static double xs_pi_rho_pi0(const double s, const double m_rho);
+  static double xs_pi_rho_pi0_rho_mediated(const double s, const double m_rho);
+  static double xs_pi_rho_pi0_omega_mediated(const double s,
+                                             const double m_rho);
+
+  static double xs_pi0_rho_pi(const double s, const double m_rho);
+  static double xs_pi0_rho_pi_rho_mediated(const double s, const double m_rho);
+  static double xs_pi0_rho_pi_omega_mediated(const double s,
+                                             const double m_rho);
+  ///@}
+
+  /** @name Differential cross-section
+   * The functions in this group look up the differential cross-section for a
+   * photon process.
+   */
+  ///@{
+  /**
+   * Differential cross section for given photon process.
+   *
+   * \param[in] s Mandelstam-s [GeV^2]
+   * \param[in] t Mandelstam-t [GeV^2]
+   * \param[in] m_rho Mass of participating rho-meson [GeV]
+   * \returns photon cross-section [mb]
+   */
+  static double xs_diff_pi_pi_rho0(const double s, const double t,
+                                   const double m_rho);
+  static double xs_diff_pi_pi0_rho(const double s, const double t,
+                                   const double m_rho);
+  static double xs_diff_pi0_rho0_pi0(const double s, const double t,
+                                     const double m_rho);
+  static double xs_diff_pi_rho0_pi(const double s, const double t,
+                                   const double m_rho);
+
+  static double xs_diff_pi_rho_pi0_rho_mediated(const double s, const double t,
+                                                const double m_rho);
+  static double xs_diff_pi_rho_pi0_omega_mediated(const double s,
+                                                  const double t,
+                                                  const double m_rho);
+
+  static double xs_diff_pi0_rho_pi_rho_mediated(const double s, const double t,
+                                                const double m_rho);
+  static double xs_diff_pi0_rho_pi_omega_mediated(const double s,
+                                                  const double t,
+                                                  const double m_rho);
+  ///@}
+};
+
 }  // namespace smash
 
 #endif  // SRC_INCLUDE_SMASH_CROSSSECTIONSPHOTON_H_
@@ -0,0 +1,143 @@
+/*
+ *
+ *    Copyright (c) 2024
+ *      SMASH Team
+ *
+ *    GNU General Public License (GPLv3 or later)
+ *
+ */
+
+#ifndef SRC_INCLUDE_SMASH_CROSSSECTIONTABLE_H_
+#define SRC_INCLUDE_SMASH_CROSSSECTIONTABLE_H_
+
+#include <atomic>
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <vector>
+
+#include "forwarddeclarations.h"
+#include "processbranch.h"
+
+namespace smash {
+
+/**
+ * \ingroup action
+ *
+ * Collision branches of two particles, which are tabulated for each pair of
+ * particle types on a fine grid of the center-of-mass energy and linearly
+ * interpolated in between.
+ *
+ * Setting up the collision branches of a pair requires to evaluate all
+ * partial cross sections, although the same pairs collide again and again at
+ * similar energies. With the table, the branches at a grid point are computed
+ * once, on its first use, and the branches of a pair are obtained from the
+ * two grid points around its center-of-mass energy. A branch is taken from
+ * the lower grid point and its weight is interpolated to zero, if it is
+ * missing at the upper one. Branches which open between two grid points are
+ * missed until the upper one, such that no branch below its threshold is
+ * chosen.
+ *
+ * Like CrossSectionEnvelope, the table only applies to pairs of stable
+ * particles on their mass shell, whose cross sections depend on the
+ * center-of-mass energy only, and the first grid point is one spacing above
+ * the threshold. Other pairs are evaluated exactly. The interpolation is an
+ * approximation, hence the table has to be enabled explicitly.
+ *
+ * The table can be filled concurrently by several threads. The collision
+ * branches have to be a deterministic function of the incoming particles,
+ * then all threads agree on the table.
+ */
+class CrossSectionTable {
+ public:
+  /// Function returning the exact collision branches of two particles
+  using ExactCollisionList =
+      std::function<CollisionBranchList(const ParticleData &,
+                                        const ParticleData &)>;
+
+  /**
+   * Construct the table for the particle types, which have to be initialized.
+   *
+   * \param[in] exact Exact collision branches
+   */
+  explicit CrossSectionTable(ExactCollisionList exact);
+
+  /// Cannot be copied, the tables are owned
+  CrossSectionTable(const CrossSectionTable &) = delete;
+  /// Cannot be copied, the tables are owned
+  CrossSectionTable &operator=(const CrossSectionTable &) = delete;
+
+  /// Destroy the tables.
+  ~CrossSectionTable();
+
+  /**
+   * Interpolate the collision branches.
+   *
+   * \param[in] a First particle
+   * \param[in] b Second particle
+   * \param[in] sqrt_s Center-of-mass energy of both [GeV]
+   * \return Collision branches of \p a and \p b, or nothing if they are not
+   *         tabulated
+   */
+  std::optional<CollisionBranchList> collision_list(const ParticleData &a,
+                                                    const ParticleData &b,
+                                                    double sqrt_s) const;
+
+  /// Distance of the grid points in the center-of-mass energy [GeV]
+  static constexpr double grid_spacing = 0.002;
+  /// Number of grid points above the threshold, beyond there is no table
+  static constexpr std::size_t n_points = 2500;
+
+ private:
+  /// Collision branches of a pair of types at the grid points
+  struct Table {
+    /// Sum of the masses of both types [GeV]
+    double threshold;
+    /// Branches at every grid point, which are null until they are used first
+    std::unique_ptr<std::atomic<const CollisionBranchList *>[]> points;
+  };
+
+  /**
+   * \param[in] type_a First type
+   * \param[in] type_b Second type
+   * \param[in] index_a Index of the first type among the stable ones
+   * \param[in] index_b Index of the second type among the stable ones
+   * \return Table of the pair, which is created if it does not exist yet
+   */
+  const Table &pair_table(const ParticleType &type_a,
+                          const ParticleType &type_b, int index_a,
+                          int index_b) const;
+
+  /**
+   * \param[in] table Table of a pair of types
+   * \param[in] type_a First type
+   * \param[in] type_b Second type
+   * \param[in] k Index of the grid point
+   * \return Branches at the grid point, which are computed if they do not
+   *         exist yet
+   */
+  const CollisionBranchList &point(const Table &table,
+                                   const ParticleType &type_a,
+                                   const ParticleType &type_b,
+                                   std::size_t k) const;
+
+  /// Exact collision branches, which are tabulated
+  const ExactCollisionList exact_;
+  /**
+   * Index of each particle type among the stable types, or -1 if it is not
+   * stable
+   */
+  std::vector<int> stable_index_;
+  /// Number of stable types
+  std::size_t n_stable_ = 0;
+  /**
+   * Table of each ordered pair of stable types, which is null until it is
+   * used first
+   */
+  std::unique_ptr<std::atomic<const Table *>[]> tables_;
+};
+
+}  // namespace smash
+
+#endif  // SRC_INCLUDE_SMASH_CROSSSECTIONTABLE_H_
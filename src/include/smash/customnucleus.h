@@ -1,5 +1,5 @@
 /*
- *    Copyright (c) 2019-2020
+ *    Copyright (c) 2019-2020,2024
  *      SMASH Team
  *
  *    GNU General Public License (GPLv3 or later)
@@ -7,7 +7,6 @@
 #ifndef SRC_INCLUDE_SMASH_CUSTOMNUCLEUS_H_
 #define SRC_INCLUDE_SMASH_CUSTOMNUCLEUS_H_
 
-#include <fstream>
 #include <map>
 #include <memory>
 #include <string>
@@ -34,6 +33,17 @@ struct Nucleoncustom {
   bool isospin;
 };
 
+/**
+ * Contains all nucleons of an external list, which is read only once, and
+ * the position up to which they were used for nuclei.
+ */
+struct CustomNucleusFile {
+  /// Nucleons of all configurations in the list
+  std::vector<Nucleoncustom> nucleons;
+  /// Index of the next nucleon to be used
+  size_t position = 0;
+};
+
 /**
  * Inheriting from Nucleus-Class using modified Nucleon configurations.
  * Configurations are read in from external lists.
@@ -49,7 +59,8 @@ class CustomNucleus : public Nucleus {
    * the external particle list is located
    * \param[in] testparticles represents the number of testparticles
    * \param[in] same_file specifies if target and projectile nucleus are
-   * read in from the same file, which is important for the ifstream
+   * read in from the same file, in which case they take turns in using its
+   * configurations
    */
   CustomNucleus(Configuration& config, int testparticles, bool same_file);
   /**
@@ -63,13 +74,21 @@ class CustomNucleus : public Nucleus {
   ThreeVector distribute_nucleon() override;
   /// Sets the positions of the nucleons inside a nucleus.
   void arrange_nucleons() override;
+  /**
+   * Reads all nucleons of an external list.
+   *
+   * \param[in] path is the path to the external file
+   * \throw std::runtime_error if a line cannot be read or the file contains
+   *        no nucleons
+   */
+  static std::shared_ptr<CustomNucleusFile> loadfile(const std::string& path);
   /**
    * The returned vector contains Data for one nucleus given in the
-   * particlelist.
+   * particlelist. After the last configuration, the list starts over.
    *
-   * \param[in] infile is needed to read in from the external file
+   * \param[in] file is the external list the nucleus is taken from
    */
-  std::vector<Nucleoncustom> readfile(std::ifstream& infile) const;
+  std::vector<Nucleoncustom> readfile(CustomNucleusFile& file) const;
   /**
    * Generates the name of the stream file.
    * \param[in] file_directory is the path to the external file
@@ -86,23 +105,12 @@ class CustomNucleus : public Nucleus {
 
  private:
   /**
-   * Filestream variable used if projectile and target are read in from the
-   * same file and they use the same static stream.
-   */
-  /*
-   * The unique_ptr is only required to work around a bug in GCC 4.8, because it
-   * seems to be trying to use the non-existing copy-constructor of
-   * `std::ifstream`. Newer compilers don't require this unneccessary
-   * indirection.
-   */
-  static std::unique_ptr<std::ifstream> filestream_shared_;
-  /**
-   * Filestream variable used if projectile and target are read in from
-   * different files and they therefore use different streams.
+   * External list used if projectile and target are read in from the same
+   * file, such that they share the position in it.
    */
-  std::unique_ptr<std::ifstream> filestream_;
-  /// Pointer to the used filestream pointer
-  std::unique_ptr<std::ifstream>* used_filestream_;
+  static std::shared_ptr<CustomNucleusFile> file_shared_;
+  /// External list used by this nucleus, which is read only once
+  std::shared_ptr<CustomNucleusFile> file_;
   /**
    * Number of nucleons per nucleus
    * Set initally to zero to be modified in the constructor.
@@ -1,6 +1,6 @@
 /*
  *
- *    Copyright (c) 2015-2020
+ *    Copyright (c) 2015-2020,2024
  *      SMASH Team
  *
  *    GNU General Public License (GPLv3 or later)
@@ -55,6 +55,15 @@ class DecayAction : public Action {
    */
   void generate_final_state() override;
 
+  /**
+   * Generate the final state in advance, e.g. concurrently with other decays.
+   * It is kept by the next call of generate_final_state, when the action is
+   * performed.
+   *
+   * \throws InvalidDecay
+   */
+  void generate_final_state_in_advance();
+
   /**
    * Sample the masses of the final particles
    * \returns Pair of sampled masses of particle 1 and 2
@@ -104,6 +113,9 @@ class DecayAction : public Action {
 
   /// Angular momentum of the decay
   int L_ = 0;
+
+  /// Whether the final state was generated in advance
+  bool final_state_generated_ = false;
 };
 
 }  // namespace smash
@@ -1,6 +1,6 @@
 /*
  *
- *    Copyright (c) 2014-2020,2022-2023
+ *    Copyright (c) 2014-2020,2022-2024
  *      SMASH Team
  *
  *    GNU General Public License (GPLv3 or later)
@@ -22,6 +22,10 @@ namespace smash {
  * A simple decay finder:
  * Just loops through all particles and checks if they can decay during the next
  * timestep.
+ *
+ * Without potentials, the decay time of a particle is sampled once and stored
+ * with it (see ParticleData::decay_time), such that the particles which do not
+ * decay in a time step are skipped without calculating their widths again.
  */
 class DecayActionsFinder : public ActionFinderInterface {
  public:
@@ -36,6 +40,10 @@ class DecayActionsFinder : public ActionFinderInterface {
       : res_lifetime_factor_(res_lifetime_factor),
         do_final_weak_decays_(do_weak_decays) {}
 
+  // The convenience overloads for a ParticleList are kept visible
+  using ActionFinderInterface::find_actions_in_cell;
+  using ActionFinderInterface::find_actions_with_neighbors;
+
   /**
    * Check the whole particle list for decays.
    *
@@ -44,12 +52,12 @@ class DecayActionsFinder : public ActionFinderInterface {
    * \return List with the found (Decay)Action objects.
    */
   ActionList find_actions_in_cell(
-      const ParticleList &search_list, double dt, const double,
+      const ParticleSpan &search_list, double dt, const double,
       const std::vector<FourVector> &) const override;
 
   /// Ignore the neighbor searches for decays
   ActionList find_actions_with_neighbors(
-      const ParticleList &, const ParticleList &, double,
+      const ParticleSpan &, const ParticleSpan &, double,
       const std::vector<FourVector> &) const override {
     return {};
   }
@@ -88,6 +96,17 @@ class DecayActionsFinder : public ActionFinderInterface {
    */
   const bool decay_initial_particles_ =
       InputKeys::collTerm_decayInitial.default_value();
+
+ private:
+  /**
+   * Sample the time until a particle decays.
+   *
+   * \param[in] p Decaying particle
+   * \param[in] width Total width of its decays at its mass [GeV]
+   * \return Time until the decay in the computational frame [fm], infinite
+   *         if the width vanishes
+   */
+  double sample_decay_time(const ParticleData &p, double width) const;
 };
 
 }  // namespace smash
@@ -1,6 +1,6 @@
 /*
  *
- *    Copyright (c) 2014-2018,2020
+ *    Copyright (c) 2014-2018,2020,2024
  *      SMASH Team
  *
  *    GNU General Public License (GPLv3 or later)
@@ -10,6 +10,9 @@
 #ifndef SRC_INCLUDE_SMASH_DECAYACTIONSFINDERDILEPTON_H_
 #define SRC_INCLUDE_SMASH_DECAYACTIONSFINDERDILEPTON_H_
 
+#include <vector>
+
+#include "forwarddeclarations.h"
 #include "outputinterface.h"
 
 namespace smash {
@@ -29,8 +32,35 @@ namespace smash {
  */
 class DecayActionsFinderDilepton {
  public:
-  /// Initialize the finder
-  DecayActionsFinderDilepton() {}
+  /// Initialize the finder, the particle types must be known
+  DecayActionsFinderDilepton();
+
+  /**
+   * Find the dilepton decays of all particles during a time step, which are
+   * treated with the shining method, and generate their final states.
+   *
+   * Only particles of the types with dilepton decay modes are considered.
+   * The actions are independent of the output, such that they can be found
+   * before the output is locked and written to several outputs.
+   *
+   * \param[in] search_list List of all particles.
+   * \param[in] dt Length of timestep [fm]
+   * \return List of DecayActionDilepton objects with generated final states
+   */
+  ActionList shining_actions(const Particles& search_list, double dt) const;
+
+  /**
+   * Find the dilepton decays of the resonances at the end of the simulation,
+   * like shining_actions, see shine_final.
+   *
+   * \param[in] search_list List of all particles.
+   * \param[in] only_res optional parameter that requests that only actions
+   *                     regarding resonances are considered (disregarding
+   *                     stable particles)
+   * \return List of DecayActionDilepton objects with generated final states
+   */
+  ActionList final_shining_actions(const Particles& search_list,
+                                   bool only_res = false) const;
 
   /**
    * Check the whole particles list and print out possible dilepton decays.
@@ -56,6 +86,16 @@ class DecayActionsFinderDilepton {
    */
   void shine_final(const Particles& search_list, OutputInterface* output,
                    bool only_res = false) const;
+
+ private:
+  /**
+   * \param[in] type Particle type
+   * \return Whether the type has dilepton decay modes
+   */
+  bool is_emitter(const ParticleType& type) const;
+
+  /// Whether the types have dilepton decay modes, in the order of list_all
+  std::vector<bool> is_emitter_;
 };
 
 }  // namespace smash
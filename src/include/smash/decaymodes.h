@@ -1,5 +1,5 @@
 /*
- *    Copyright (c) 2013-2018,2020
+ *    Copyright (c) 2013-2018,2020,2024
  *      SMASH Team
  *
  *    GNU General Public License (GPLv3 or later)
@@ -85,6 +85,17 @@ class DecayModes {
    */
   static void load_decaymodes(const std::string &input);
 
+  /**
+   * Set up empty decay modes for all particle types, which are then filled
+   * with add_mode, e.g. from a snapshot of the decay modes loaded before.
+   * Neither the branching ratios are renormalized nor are the decay modes of
+   * the antiparticles generated.
+   *
+   * \return The decay modes of all particle types, in the order of
+   *         ParticleType::list_all()
+   */
+  static std::vector<DecayModes> &create_empty_decaymodes();
+
   /**
    * Retrieve a decay type.
    *
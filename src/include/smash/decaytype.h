@@ -9,6 +9,7 @@
 #define SRC_INCLUDE_SMASH_DECAYTYPE_H_
 
 #include <memory>
+#include <string>
 #include <vector>
 
 #include "forwarddeclarations.h"
@@ -82,6 +83,12 @@ class DecayType {
   virtual bool is_dilepton_decay() const { return false; }
 
  protected:
+  /**
+   * \param[in] prefix Kind of the tabulated quantity.
+   * \return Name under which a tabulation for this decay type is cached.
+   */
+  std::string tabulation_name(const std::string &prefix) const;
+
   /// final-state particles of the decay
   ParticleTypePtrList particle_types_;
   /// angular momentum of the decay
@@ -231,7 +238,7 @@ class TwoBodyDecaySemistable : public TwoBodyDecay {
   double Lambda_;
 
   /// Tabulation of the resonance integrals.
-  mutable std::unique_ptr<Tabulation> tabulation_;
+  mutable std::unique_ptr<AdaptiveTabulation> tabulation_;
 };
 
 /**
@@ -267,7 +274,7 @@ class TwoBodyDecayUnstable : public TwoBodyDecay {
   double Lambda_;
 
   /// Tabulation of the resonance integrals.
-  mutable std::unique_ptr<Tabulation> tabulation_;
+  mutable std::unique_ptr<AdaptiveTabulation> tabulation_;
 };
 
 /**
@@ -1,5 +1,5 @@
 /*
- *    Copyright (c) 2014-2022
+ *    Copyright (c) 2014-2022,2024
  *      SMASH Team
  *
  *    GNU General Public License (GPLv3 or later)
@@ -7,12 +7,15 @@
 #ifndef SRC_INCLUDE_SMASH_DEFORMEDNUCLEUS_H_
 #define SRC_INCLUDE_SMASH_DEFORMEDNUCLEUS_H_
 
+#include <array>
 #include <map>
+#include <vector>
 
 #include "angles.h"
 #include "configuration.h"
 #include "forwarddeclarations.h"
 #include "nucleus.h"
+#include "random.h"
 #include "threevector.h"
 
 namespace smash {
@@ -57,6 +60,11 @@ class DeformedNucleus : public Nucleus {
   /**
    * Deformed Woods-Saxon sampling routine.
    *
+   * Without triaxiality, the distributions of the polar angle and of the
+   * radius in each polar angle bin are tabulated at the first call and
+   * whenever the parameters changed since, and are then sampled without
+   * rejection. With triaxiality, the positions are sampled by rejection.
+   *
    * \return Spatial position from uniformly sampling
    * the deformed woods-saxon distribution
    */
@@ -208,6 +216,12 @@ class DeformedNucleus : public Nucleus {
    * Whether the nuclei should be rotated randomly.
    */
   bool random_rotation_ = false;
+  /// Tabulated distribution of the cosine of the polar angle
+  random::piecewise_constant_dist costheta_distribution_;
+  /// Tabulated radial distribution for each bin of the polar angle cosine
+  std::vector<random::piecewise_constant_dist> radial_distributions_;
+  /// Radius, diffusiveness, beta2, beta3 and beta4 the distributions are for
+  std::array<double, 5> tabulated_parameters_{};
 };
 
 }  // namespace smash
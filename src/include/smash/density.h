@@ -1,6 +1,6 @@
 /*
  *
- *    Copyright (c) 2014-2022
+ *    Copyright (c) 2014-2022,2024
  *      SMASH Team
  *
  *    GNU General Public License (GPLv3 or later)
@@ -9,8 +9,13 @@
 #ifndef SRC_INCLUDE_SMASH_DENSITY_H_
 #define SRC_INCLUDE_SMASH_DENSITY_H_
 
+#include <algorithm>
+#include <array>
+#include <cmath>
 #include <iostream>
+#include <stdexcept>
 #include <tuple>
+#include <type_traits>
 #include <typeinfo>
 #include <utility>
 #include <vector>
@@ -20,14 +25,21 @@
 #include "forwarddeclarations.h"
 #include "fourvector.h"
 #include "lattice.h"
+#include "logging.h"
 #include "particledata.h"
 #include "particles.h"
+#include "particlessoa.h"
 #include "pdgcode.h"
+#include "smearingstencil.h"
+#include "threadpool.h"
 #include "threevector.h"
 
 namespace smash {
 static constexpr int LDensity = LogArea::Density::id;
 
+/// Written for particles, which cannot be smeared with a covariant Gaussian
+extern RateLimitedWarning undefined_smearing_warning;
+
 /**
  * Allows to choose which kind of density to calculate.
  * The baryon density is necessary for the Skyrme potential.
@@ -115,20 +127,25 @@ class DensityParameters {
    *            \f$r_{\rm cut}=a\sigma\f$, the test-particle number, the number
    *            of ensembles, the mode of calculating the derivatives, the
    *            smearing mode, the central weight for Discrete smearing, the
-   *            range (in units of lattice spacing) for Triangular smearing
-   *            and the flag about using only participants or also spectators
+   *            range (in units of lattice spacing) for Triangular smearing,
+   *            whether to smear on the lattice by Fourier transforms, the
+   *            flag about using only participants or also spectators and the
+   *            processes the ensembles are distributed over
    */
   DensityParameters(const ExperimentParameters &par)  // NOLINT
       : sig_(par.gaussian_sigma),
         r_cut_(par.gauss_cutoff_in_sigma * par.gaussian_sigma),
         ntest_(par.testparticles),
-        nensembles_(par.n_ensembles),
+        nensembles_(par.ensemble_communicator ? par.n_ensembles_total
+                                              : par.n_ensembles),
         derivatives_(par.derivatives_mode),
         rho_derivatives_(par.rho_derivatives_mode),
         smearing_(par.smearing_mode),
         central_weight_(par.discrete_weight),
         triangular_range_(par.triangular_range),
-        only_participants_(par.only_participants) {
+        fft_smearing_(par.fft_smearing),
+        only_participants_(par.only_participants),
+        communicator_(par.ensemble_communicator) {
     r_cut_sqr_ = r_cut_ * r_cut_;
     const double two_sig_sqr = 2 * sig_ * sig_;
     two_sig_sqr_inv_ = 1. / two_sig_sqr;
@@ -139,7 +156,7 @@ class DensityParameters {
   }
   /// \return Testparticle number
   int ntest() const { return ntest_; }
-  /// \return Number of ensembles
+  /// \return Number of ensembles, including those of other processes
   int nensembles() const { return nensembles_; }
   /// \return Mode of gradient calculation
   DerivativesMode derivatives() const { return derivatives_; }
@@ -153,6 +170,11 @@ class DensityParameters {
   double central_weight() const { return central_weight_; }
   /// \return Range of the triangular smearing, in units of lattice spacing
   double triangular_range() const { return triangular_range_; }
+  /**
+   * \return Whether densities on the lattice are smeared by Fourier
+   *         transforms, see convolve_density
+   */
+  bool fft_smearing() const { return fft_smearing_; }
   /// \return Cut-off radius [fm]
   double r_cut() const { return r_cut_; }
   /// \return Squared cut-off radius [fm\f$^2\f$]
@@ -167,6 +189,11 @@ class DensityParameters {
   double norm_factor_sf() const { return norm_factor_sf_; }
   /// \return counting only participants (true) or also spectators (false)
   bool only_participants() const { return only_participants_; }
+  /**
+   * \return Processes, over which the ensembles are distributed and the
+   *         lattices are summed, or nullptr
+   */
+  EnsembleCommunicator *communicator() const { return communicator_; }
 
  private:
   /// Gaussian smearing width [fm]
@@ -193,8 +220,12 @@ class DensityParameters {
   const double central_weight_;
   /// Range of the triangular smearing
   const double triangular_range_;
+  /// Whether to smear densities on the lattice by Fourier transforms
+  const bool fft_smearing_;
   /// Flag to take into account only participants
   bool only_participants_;
+  /// Processes the ensembles are distributed over, if any
+  EnsembleCommunicator *communicator_;
 };
 
 /**
@@ -283,6 +314,26 @@ std::tuple<double, FourVector, ThreeVector, ThreeVector, FourVector, FourVector,
 current_eckart(const ThreeVector &r, const Particles &plist,
                const DensityParameters &par, DensityType dens_type,
                bool compute_gradient, bool smearing);
+/**
+ * Overload of the above, which only sums over the particles in the cells
+ * around r. With smearing, the result is the same as for all particles of
+ * the list, as long as the cells are at least r_cut large.
+ */
+std::tuple<double, FourVector, ThreeVector, ThreeVector, FourVector, FourVector,
+           FourVector, FourVector>
+current_eckart(const ThreeVector &r, const ParticleCellList &cells,
+               const DensityParameters &par, DensityType dens_type,
+               bool compute_gradient, bool smearing);
+/**
+ * Overload of the above for a selection of particles, e.g. those close to r,
+ * which several quantities at the same point are calculated from.
+ */
+std::tuple<double, FourVector, ThreeVector, ThreeVector, FourVector, FourVector,
+           FourVector, FourVector>
+current_eckart(const ThreeVector &r,
+               const std::vector<const ParticleData *> &plist,
+               const DensityParameters &par, DensityType dens_type,
+               bool compute_gradient, bool smearing);
 
 /**
  * A class for time-efficient (time-memory trade-off) calculation of density
@@ -381,7 +432,7 @@ class DensityOnLattice {
    * \param[in] norm_factor Normalization factor
    * \return Net Eckart density on the local lattice \f$\rho\f$ [fm\f$^{-3}\f$]
    */
-  double rho(const double norm_factor = 1.0) {
+  double rho(const double norm_factor = 1.0) const {
     return (jmu_pos_.abs() - jmu_neg_.abs()) * norm_factor;
   }
 
@@ -391,7 +442,7 @@ class DensityOnLattice {
    * \param[in] norm_factor Normalization factor
    * \return \f$\boldsymbol{\nabla}\times\mathbf{j}\f$ [fm \f$^{-4}\f$]
    */
-  ThreeVector curl_vecj(const double norm_factor = 1.0) {
+  ThreeVector curl_vecj(const double norm_factor = 1.0) const {
     ThreeVector curl_vec_j = ThreeVector();
     curl_vec_j.set_x1(djmu_dxnu_[2].x3() - djmu_dxnu_[3].x2());
     curl_vec_j.set_x2(djmu_dxnu_[3].x1() - djmu_dxnu_[1].x3());
@@ -407,7 +458,7 @@ class DensityOnLattice {
    * \param[in] norm_factor Normalization factor
    * \return \f$\boldsymbol{\nabla} j^0\f$ [fm \f$^{-4}\f$]
    */
-  ThreeVector grad_j0(const double norm_factor = 1.0) {
+  ThreeVector grad_j0(const double norm_factor = 1.0) const {
     ThreeVector j0_grad = ThreeVector();
     for (int i = 1; i < 4; i++) {
       j0_grad[i - 1] = djmu_dxnu_[i].x0() * norm_factor;
@@ -421,7 +472,7 @@ class DensityOnLattice {
    * \param[in] norm_factor Normalization factor
    * \return \f$\partial_t \mathbf{j}\f$ [fm \f$^{-4}\f$]
    */
-  ThreeVector dvecj_dt(const double norm_factor = 1.0) {
+  ThreeVector dvecj_dt(const double norm_factor = 1.0) const {
     return djmu_dxnu_[0].threevec() * norm_factor;
   }
 
@@ -527,121 +578,482 @@ class DensityOnLattice {
 typedef RectangularLattice<DensityOnLattice> DensityLattice;
 
 /**
- * Updates the contents on the lattice.
+ * Call a function for all particles, which add quantities to the nodes of a
+ * lattice close to them, using the threads of a pool.
  *
- * \param[out] lat The lattice on which the content will be updated
- * \param[in] update tells if called for update at printout or at timestep
- * \param[in] dens_type density type to be computed on the lattice
- * \param[in] par a structure containing testparticles number and gaussian
- *            smearing parameters.
- * \param[in] ensembles the particles vector for each ensemble
+ * The lattice is divided into slabs of whole xy planes, which are thicker
+ * than the distance in z direction up to which a particle reaches. The
+ * particles of a slab thus only reach the neighbouring slabs, and every third
+ * slab is processed concurrently, in three rounds. Within a slab, the
+ * particles are processed in their original order. The same order is kept
+ * without threads, such that every node gets its contributions in the same
+ * order and the result does not depend on the number of threads. Only
+ * lattices too thin for three slabs are processed in the order of the
+ * particles.
+ *
+ * \param[in] lat Lattice to which the particles contribute
+ * \param[in] particles Snapshot of the particles
+ * \param[in] reach Largest distance in z direction between a particle and
+ *            the center of a cell it contributes to [fm]
+ * \param[in] pool Threads to be used, or nullptr to run serially
+ * \param[in] deposit Function taking the index of a particle
+ * \tparam T LatticeType
+ */
+template <typename T, typename F>
+void for_each_particle_in_slabs(const RectangularLattice<T> &lat,
+                                const ParticlesSoA &particles, double reach,
+                                ThreadPool *pool, F &&deposit) {
+  const int n_z = lat.n_cells()[2];
+  const double dz = lat.cell_sizes()[2];
+  // Thickness of a slab in cells, with a margin for the rounding of positions
+  const int width = static_cast<int>(std::ceil(reach / dz)) + 2;
+  int n_slabs = n_z / width;
+  if (lat.periodic()) {
+    // Slabs of the same round must not be neighbours across the boundary
+    n_slabs -= n_slabs % 3;
+  }
+  if (n_slabs < 3) {
+    for (std::size_t i = 0; i < particles.size(); i++) {
+      deposit(i);
+    }
+    return;
+  }
+
+  // Sort the particles by slab, keeping their order within a slab
+  std::vector<int> slab_of(particles.size());
+  std::vector<std::size_t> slab_begin(n_slabs + 1, 0);
+  for (std::size_t i = 0; i < particles.size(); i++) {
+    double cell = std::floor((particles.z[i] - lat.origin()[2]) / dz);
+    if (lat.periodic()) {
+      cell -= n_z * std::floor(cell / n_z);
+    }
+    cell = std::clamp(cell, 0., n_z - 1.);
+    slab_of[i] = static_cast<int>(cell) * n_slabs / n_z;
+    slab_begin[slab_of[i] + 1]++;
+  }
+  for (int slab = 0; slab < n_slabs; slab++) {
+    slab_begin[slab + 1] += slab_begin[slab];
+  }
+  std::vector<std::size_t> order(particles.size());
+  std::vector<std::size_t> next(slab_begin.begin(), slab_begin.end() - 1);
+  for (std::size_t i = 0; i < particles.size(); i++) {
+    order[next[slab_of[i]]++] = i;
+  }
+
+  for (int round = 0; round < 3; round++) {
+    const int n_tasks = (n_slabs - round + 2) / 3;
+    auto deposit_slab = [&](int task) {
+      const int slab = round + 3 * task;
+      for (std::size_t k = slab_begin[slab]; k < slab_begin[slab + 1]; k++) {
+        deposit(order[k]);
+      }
+    };
+    if (pool == nullptr || pool->size() < 2) {
+      for (int task = 0; task < n_tasks; task++) {
+        deposit_slab(task);
+      }
+    } else {
+      pool->parallel_for(n_tasks, deposit_slab);
+    }
+  }
+}
+
+/**
+ * Smear a density on the lattice by depositing the particles on the nodes
+ * and convolving them with the smearing kernel by Fourier transforms, see
+ * SmearingConvolution. The Gaussian kernel is the one of particles at rest,
+ * and the triangular one that of particles on a node. For finite difference
+ * derivatives, the spatial derivatives of the current are computed by the
+ * convolution as well, while the time derivatives are left to the caller.
+ * The transforms of the kernel are kept by every thread for the lattice
+ * geometries and smearing parameters it has seen.
+ *
+ * \param[out] lat The lattice on which the density will be updated, which
+ *             has been reset
+ * \param[in] dens_type Density type to be computed on the lattice
+ * \param[in] par Smearing parameters, with Gaussian or triangular smearing
+ * \param[in] particles Snapshot of the particles of all ensembles
  * \param[in] compute_gradient Whether to compute the gradients
+ */
+void convolve_density(RectangularLattice<DensityOnLattice> &lat,
+                      DensityType dens_type, const DensityParameters &par,
+                      const ParticlesSoA &particles, bool compute_gradient);
+
+/**
+ * A lattice, which update_lattices fills with a density of the given type
+ * together with other lattices.
+ *
  * \tparam T LatticeType
  */
 template <typename T>
-void update_lattice(RectangularLattice<T> *lat, const LatticeUpdate update,
-                    const DensityType dens_type, const DensityParameters &par,
-                    const std::vector<Particles> &ensembles,
-                    const bool compute_gradient) {
-  // Do not proceed if lattice does not exists/update not required
-  if (lat == nullptr || lat->when_update() != update) {
+struct DensityTarget {
+  /// The lattice, which is skipped if it is nullptr
+  RectangularLattice<T> *lattice;
+  /// Density type to be computed on the lattice
+  DensityType type;
+};
+
+/**
+ * Fills the lattices with the particles of this process only, see
+ * update_lattices, which takes the same arguments.
+ */
+template <typename... T>
+void smear_onto_lattices(const LatticeUpdate update,
+                         const DensityParameters &par,
+                         const ParticlesSoA &particles,
+                         const bool compute_gradient, ThreadPool *pool,
+                         const DensityTarget<T>... targets) {
+  constexpr std::size_t n_targets = sizeof...(T);
+  constexpr bool any_tmn = (std::is_same_v<T, EnergyMomentumTensor> || ...);
+  std::array<bool, n_targets> active = {
+      (targets.lattice != nullptr &&
+       targets.lattice->when_update() == update)...};
+  const std::array<DensityType, n_targets> dens_types = {targets.type...};
+  // apply a function to the lattices to be updated, in the given order
+  auto for_each_active = [&](auto &&func) {
+    std::size_t k = 0;
+    ((active[k] ? func(*targets.lattice, k) : void(), ++k), ...);
+  };
+
+  // Do not proceed if no lattice exists/update not required
+  bool any_active = false, any_sparse = false;
+  std::array<int, 3> n_cells{};
+  std::array<double, 3> cell_sizes{}, origin{};
+  for_each_active([&](auto &lat, std::size_t) {
+    if (!any_active) {
+      any_active = true;
+      n_cells = lat.n_cells();
+      cell_sizes = lat.cell_sizes();
+      origin = lat.origin();
+    } else if (lat.n_cells() != n_cells || lat.cell_sizes() != cell_sizes ||
+               lat.origin() != origin) {
+      throw std::invalid_argument(
+          "Lattices updated together must have the same geometry.");
+    }
+    lat.reset();
+    any_sparse = any_sparse || lat.sparse();
+  });
+  if (!any_active) {
     return;
   }
 
-  lat->reset();
+  if (par.fft_smearing()) {
+    any_active = false;
+    for_each_active([&](auto &lat, std::size_t k) {
+      if constexpr (std::is_same_v<std::decay_t<decltype(lat)>,
+                                   DensityLattice>) {
+        convolve_density(lat, dens_types[k], par, particles, compute_gradient);
+        active[k] = false;
+      } else {
+        any_active = true;
+      }
+    });
+    if (!any_active) {
+      return;
+    }
+  }
+
   // get the normalization factor for the covariant Gaussian smearing
   const double norm_factor_gaus = par.norm_factor_sf();
   // get the volume of the cell and weights for discrete smearing
-  const double V_cell =
-      (lat->cell_sizes())[0] * (lat->cell_sizes())[1] * (lat->cell_sizes())[2];
+  const double V_cell = cell_sizes[0] * cell_sizes[1] * cell_sizes[2];
   // weights for coarse smearing
   const double big = par.central_weight();
   const double small = (1.0 - big) / 6.0;
   // get the radii for triangular smearing
   const std::array<double, 3> triangular_radius = {
-      par.triangular_range() * (lat->cell_sizes())[0],
-      par.triangular_range() * (lat->cell_sizes())[1],
-      par.triangular_range() * (lat->cell_sizes())[2]};
+      par.triangular_range() * cell_sizes[0],
+      par.triangular_range() * cell_sizes[1],
+      par.triangular_range() * cell_sizes[2]};
   const double prefactor_triangular =
       1.0 /
       (par.ntest() * par.nensembles() * triangular_radius[0] *
        triangular_radius[0] * triangular_radius[1] * triangular_radius[1] *
        triangular_radius[2] * triangular_radius[2]);
 
-  for (const Particles &particles : ensembles) {
-    for (const ParticleData &part : particles) {
+  // gradients of the Gaussian smearing are only needed for the derivatives
+  const bool with_derivatives =
+      compute_gradient &&
+      par.derivatives() == DerivativesMode::CovariantGaussian;
+
+  // the first lattice to be updated provides the geometry for all of them
+  auto add_particles = [&](auto &geometry) {
+    auto deposit = [&](std::size_t i) {
+      // weights of the smearing, kept by every thread from particle to
+      // particle
+      static thread_local SmearingStencil stencil;
+      const ParticleData &part = *particles.particle[i];
       if (par.only_participants()) {
         // if this conditions holds, the hadron is a spectator
         if (part.get_history().collisions_per_particle == 0) {
-          continue;
+          return;
         }
       }
-      const double dens_factor = density_factor(part.type(), dens_type);
-      if (std::abs(dens_factor) < really_small) {
-        continue;
+      std::array<double, n_targets> dens_factor{};
+      bool contributes = false;
+      for_each_active([&](auto &, std::size_t k) {
+        dens_factor[k] = density_factor(*particles.type[i], dens_types[k]);
+        if (std::abs(dens_factor[k]) < really_small) {
+          dens_factor[k] = 0.;
+        } else {
+          contributes = true;
+        }
+      });
+      if (!contributes) {
+        return;
       }
-      const FourVector p_mu = part.momentum();
-      const ThreeVector pos = part.position().threevec();
+      // add a weighted contribution to the node of all lattices
+      auto add_to_nodes = [&](int index, auto &&add) {
+        for_each_active([&](auto &lat, std::size_t k) {
+          if (dens_factor[k] != 0.) {
+            add(lat[index], k);
+          }
+        });
+      };
+      const FourVector p_mu(particles.e[i], particles.px[i], particles.py[i],
+                            particles.pz[i]);
+      const ThreeVector pos(particles.x[i], particles.y[i], particles.z[i]);
+      EnergyMomentumTensor::tmn_type tmn_contribution{};
+      if constexpr (any_tmn) {
+        tmn_contribution = EnergyMomentumTensor::particle_contribution(p_mu);
+      }
+      // add the particle with a weight to a node of any type
+      auto add_particle = [&](auto &node, double weight) {
+        if constexpr (std::is_same_v<std::decay_t<decltype(node)>,
+                                     EnergyMomentumTensor>) {
+          node.add_weighted(tmn_contribution, weight);
+        } else {
+          node.add_particle(part, weight);
+        }
+      };
 
       // act accordingly to which smearing is used
       if (par.smearing() == SmearingMode::CovariantGaussian) {
         const double m = p_mu.abs();
         if (unlikely(m < really_small)) {
-          logg[LDensity].warn("Gaussian smearing is undefined for momentum ",
-                              p_mu);
-          continue;
+          undefined_smearing_warning.warn(
+              "Gaussian smearing is undefined for momentum ", p_mu);
+          return;
         }
         const double m_inv = 1.0 / m;
 
         // unweighted contribution to density
-        const double common_weight = dens_factor * norm_factor_gaus;
-        lat->iterate_in_cube(
-            pos, par.r_cut(), [&](T &node, int ix, int iy, int iz) {
-              // find the weight for smearing
-              const ThreeVector r = lat->cell_center(ix, iy, iz);
-              const auto sf = unnormalized_smearing_factor(
-                  pos - r, p_mu, m_inv, par, compute_gradient);
-              node.add_particle(part, sf.first * common_weight);
-              if (par.derivatives() == DerivativesMode::CovariantGaussian) {
-                node.add_particle_for_derivatives(part, dens_factor,
-                                                  sf.second * norm_factor_gaus);
+        std::array<double, n_targets> common_weight;
+        for (std::size_t k = 0; k < n_targets; k++) {
+          common_weight[k] = dens_factor[k] * norm_factor_gaus;
+        }
+        // find the weights for smearing in the cube around the particle
+        const double r_cut = par.r_cut();
+        const std::array<double, 3> cube = {r_cut, r_cut, r_cut};
+        std::array<int, 3> l_bounds, u_bounds;
+        geometry.rectangle_bounds(pos, cube, l_bounds, u_bounds);
+        stencil.covariant_gaussian(l_bounds, u_bounds, origin, cell_sizes, pos,
+                                   p_mu * m_inv, par.r_cut_sqr(),
+                                   par.two_sig_sqr_inv(), with_derivatives);
+        geometry.iterate_indices_in_rectangle(
+            pos, cube, [&](int index, int ix, int iy, int iz) {
+              const std::size_t s = stencil.index(ix, iy, iz);
+              const double sf = stencil.weights()[s];
+              if (sf == 0.) {
+                return;
               }
+              add_to_nodes(index, [&](auto &node, std::size_t k) {
+                add_particle(node, sf * common_weight[k]);
+                if (with_derivatives) {
+                  node.add_particle_for_derivatives(
+                      part, dens_factor[k],
+                      stencil.gradients()[s] * norm_factor_gaus);
+                }
+              });
             });
       } else if (par.smearing() == SmearingMode::Discrete) {
-        // unweighted contribution to density
-        const double common_weight =
-            dens_factor / (par.ntest() * par.nensembles() * V_cell);
-        lat->iterate_nearest_neighbors(
-            pos, [&](T &node, int iterated_index, int center_index) {
-              node.add_particle(
-                  part, common_weight *
-                            // the contribution to density is weighted depending
-                            // on what node it is added to
-                            (iterated_index == center_index ? big : small));
+        geometry.iterate_nearest_neighbors(
+            pos, [&](auto &, int iterated_index, int center_index) {
+              add_to_nodes(iterated_index, [&](auto &node, std::size_t k) {
+                // unweighted contribution to density
+                const double common_weight =
+                    dens_factor[k] / (par.ntest() * par.nensembles() * V_cell);
+                add_particle(
+                    node,
+                    common_weight *
+                        // the contribution to density is weighted depending
+                        // on what node it is added to
+                        (iterated_index == center_index ? big : small));
+              });
             });
       } else if (par.smearing() == SmearingMode::Triangular) {
-        // unweighted contribution to density
-        const double common_weight = dens_factor * prefactor_triangular;
-        lat->iterate_in_rectangle(
-            pos, triangular_radius, [&](T &node, int ix, int iy, int iz) {
-              // compute the position of the node
-              const ThreeVector cell_center = lat->cell_center(ix, iy, iz);
-              // compute smearing weight
-              const double weight_x =
-                  triangular_radius[0] - std::abs(cell_center[0] - pos[0]);
-              const double weight_y =
-                  triangular_radius[1] - std::abs(cell_center[1] - pos[1]);
-              const double weight_z =
-                  triangular_radius[2] - std::abs(cell_center[2] - pos[2]);
-              // add the contribution to the node
-              node.add_particle(part,
-                                common_weight * weight_x * weight_y * weight_z);
+        // compute smearing weights in every direction
+        std::array<int, 3> l_bounds, u_bounds;
+        geometry.rectangle_bounds(pos, triangular_radius, l_bounds, u_bounds);
+        stencil.triangular(l_bounds, u_bounds, origin, cell_sizes, pos,
+                           triangular_radius);
+        geometry.iterate_indices_in_rectangle(
+            pos, triangular_radius, [&](int index, int ix, int iy, int iz) {
+              add_to_nodes(index, [&](auto &node, std::size_t k) {
+                // unweighted contribution to density
+                const double common_weight =
+                    dens_factor[k] * prefactor_triangular;
+                // add the contribution to the node
+                add_particle(node, common_weight *
+                                       stencil.triangular_weight(0, ix) *
+                                       stencil.triangular_weight(1, iy) *
+                                       stencil.triangular_weight(2, iz));
+              });
             });
       }
-    }  // end of for (const ParticleData &part : particles)
-  }    // end of for (const Particles &particles : ensembles)
+    };
+
+    // mark the cells, which the particles reach, on sparse lattices
+    if (any_sparse) {
+      const double r_cut = par.r_cut();
+      const std::array<double, 3> range =
+          par.smearing() == SmearingMode::Triangular
+              ? triangular_radius
+              : std::array<double, 3>{r_cut, r_cut, r_cut};
+      for (std::size_t i = 0; i < particles.size(); i++) {
+        const ThreeVector pos(particles.x[i], particles.y[i], particles.z[i]);
+        auto mark = [&](const std::array<int, 3> &l_bounds,
+                        const std::array<int, 3> &u_bounds) {
+          for_each_active([&](auto &lat, std::size_t) {
+            lat.mark_occupied(l_bounds, u_bounds);
+          });
+        };
+        if (par.smearing() == SmearingMode::Discrete) {
+          geometry.iterate_nearest_neighbors(pos, [&](auto &, int index, int) {
+            const int ix = index % n_cells[0];
+            const int iy = (index / n_cells[0]) % n_cells[1];
+            const int iz = index / (n_cells[0] * n_cells[1]);
+            mark({ix, iy, iz}, {ix + 1, iy + 1, iz + 1});
+          });
+        } else {
+          std::array<int, 3> l_bounds, u_bounds;
+          geometry.rectangle_bounds(pos, range, l_bounds, u_bounds);
+          mark(l_bounds, u_bounds);
+        }
+      }
+    }
+
+    // distance in z direction up to which a particle is smeared
+    double reach = cell_sizes[2];
+    if (par.smearing() == SmearingMode::CovariantGaussian) {
+      reach = par.r_cut();
+    } else if (par.smearing() == SmearingMode::Triangular) {
+      reach = triangular_radius[2];
+    }
+    for_each_particle_in_slabs(geometry, particles, reach, pool, deposit);
+  };
+  bool added = false;
+  for_each_active([&](auto &lat, std::size_t) {
+    if (!added) {
+      added = true;
+      add_particles(lat);
+    }
+  });
 }
 
+/**
+ * Updates the contents on several lattices of the same geometry in one pass
+ * over the particles. The smearing weights of a particle are computed once
+ * and added to all lattices, weighted with the density factor of their
+ * density types. Lattices which do not exist or do not need to be updated
+ * are skipped. On sparse lattices, the cells within reach of the particles
+ * are marked as occupied, see RectangularLattice::set_sparse. With smearing
+ * by Fourier transforms, the densities are convolved by convolve_density
+ * instead, while the other lattices are still smeared particle by particle.
+ * The components of the energy-momentum tensor of a particle are computed
+ * once and added to all nodes with the smearing weights. If the ensembles
+ * are distributed over several processes, the lattices are summed over them
+ * afterwards, see RectangularLattice::sum_over.
+ *
+ * \param[in] update tells if called for update at printout or at timestep
+ * \param[in] par a structure containing testparticles number and gaussian
+ *            smearing parameters.
+ * \param[in] particles snapshot of the particles of all ensembles
+ * \param[in] compute_gradient Whether to compute the gradients
+ * \param[in] pool Threads used to add the particles to the lattices, see
+ *            for_each_particle_in_slabs. Serial if nullptr.
+ * \param[out] targets The lattices on which the content will be updated
+ * \tparam T LatticeTypes
+ * \throw std::invalid_argument if the lattices differ in their geometry
+ */
+template <typename... T>
+void update_lattices(const LatticeUpdate update, const DensityParameters &par,
+                     const ParticlesSoA &particles, const bool compute_gradient,
+                     ThreadPool *pool, const DensityTarget<T>... targets) {
+  smear_onto_lattices(update, par, particles, compute_gradient, pool,
+                      targets...);
+  if (EnsembleCommunicator *communicator = par.communicator()) {
+    // all contributions are linear in the particles
+    ((targets.lattice != nullptr && targets.lattice->when_update() == update
+          ? targets.lattice->sum_over(*communicator)
+          : void()),
+     ...);
+  }
+}
+
+/**
+ * Updates the contents on the lattice.
+ *
+ * \param[out] lat The lattice on which the content will be updated
+ * \param[in] update tells if called for update at printout or at timestep
+ * \param[in] dens_type density type to be computed on the lattice
+ * \param[in] par a structure containing testparticles number and gaussian
+ *            smearing parameters.
+ * \param[in] particles snapshot of the particles of all ensembles
+ * \param[in] compute_gradient Whether to compute the gradients
+ * \param[in] pool Threads used to add the particles to the lattice, see
+ *            for_each_particle_in_slabs. Serial if nullptr.
+ * \tparam T LatticeType
+ */
+template <typename T>
+void update_lattice(RectangularLattice<T> *lat, const LatticeUpdate update,
+                    const DensityType dens_type, const DensityParameters &par,
+                    const ParticlesSoA &particles, const bool compute_gradient,
+                    ThreadPool *pool = nullptr) {
+  update_lattices(update, par, particles, compute_gradient, pool,
+                  DensityTarget<T>{lat, dens_type});
+}
+
+/**
+ * Updates the contents on the lattice.
+ *
+ * \param[out] lat The lattice on which the content will be updated
+ * \param[in] update tells if called for update at printout or at timestep
+ * \param[in] dens_type density type to be computed on the lattice
+ * \param[in] par a structure containing testparticles number and gaussian
+ *            smearing parameters.
+ * \param[in] ensembles the particles vector for each ensemble
+ * \param[in] compute_gradient Whether to compute the gradients
+ * \param[in] pool Threads used to add the particles to the lattice
+ * \tparam T LatticeType
+ */
+template <typename T>
+void update_lattice(RectangularLattice<T> *lat, const LatticeUpdate update,
+                    const DensityType dens_type, const DensityParameters &par,
+                    const std::vector<Particles> &ensembles,
+                    const bool compute_gradient, ThreadPool *pool = nullptr) {
+  // Do not proceed if lattice does not exists/update not required
+  if (lat == nullptr || lat->when_update() != update) {
+    return;
+  }
+  update_lattice(lat, update, dens_type, par, ParticlesSoA(ensembles),
+                 compute_gradient, pool);
+}
+
+/**
+ * Compute the derivatives of the rest frame density from the current and its
+ * derivatives on the lattice, if they are required by the density
+ * parameters. This is part of the update of a lattice of DensityOnLattice
+ * type, but needs to be called separately after update_lattices.
+ *
+ * \param[in,out] lat The lattice of DensityOnLattice type
+ * \param[in] update Tells if called for update at printout or at timestep
+ * \param[in] par Set of parameters packed in one structure
+ */
+void update_rest_frame_derivatives(RectangularLattice<DensityOnLattice> *lat,
+                                   const LatticeUpdate update,
+                                   const DensityParameters &par);
+
 /**
  * Updates the contents on the lattice of DensityOnLattice type.
  *
@@ -657,9 +1069,42 @@ void update_lattice(RectangularLattice<T> *lat, const LatticeUpdate update,
  * \param[in] dens_type Density type to be computed on the lattice
  * \param[in] par a structure containing testparticles number and gaussian
  *            smearing parameters.
+ * \param[in] particles Snapshot of the particles of all ensembles
+ * \param[in] time_step Time step used in the simulation
+ * \param[in] compute_gradient Whether to compute the gradients
+ * \param[in] pool Threads used to add the particles to the lattice
+ */
+void update_lattice(
+    RectangularLattice<DensityOnLattice> *lat,
+    RectangularLattice<FourVector> *old_jmu,
+    RectangularLattice<FourVector> *new_jmu,
+    RectangularLattice<std::array<FourVector, 4>> *four_grad_lattice,
+    const LatticeUpdate update, const DensityType dens_type,
+    const DensityParameters &par, const ParticlesSoA &particles,
+    const double time_step, const bool compute_gradient,
+    ThreadPool *pool = nullptr);
+
+/**
+ * Updates the contents on the lattice of DensityOnLattice type.
+ *
+ * Same as the function above, but taking a snapshot of the particles first.
+ *
+ * \param[out] lat The lattice of DensityOnLattice type on which the content
+ *             will be updated
+ * \param[in] old_jmu Auxiliary lattice, filled with current values at t0,
+ *            needed for calculating time derivatives
+ * \param[in] new_jmu Auxiliary lattice,filled with current values at t0 + dt,
+ *            needed for calculating time derivatives
+ * \param[in] four_grad_lattice Auxiliary lattice for calculating the
+ *            fourgradient of the current
+ * \param[in] update Tells if called for update at printout or at timestep
+ * \param[in] dens_type Density type to be computed on the lattice
+ * \param[in] par a structure containing testparticles number and gaussian
+ *            smearing parameters.
  * \param[in] ensembles The particles vector for each ensemble
  * \param[in] time_step Time step used in the simulation
  * \param[in] compute_gradient Whether to compute the gradients
+ * \param[in] pool Threads used to add the particles to the lattice
  */
 void update_lattice(
     RectangularLattice<DensityOnLattice> *lat,
@@ -668,7 +1113,8 @@ void update_lattice(
     RectangularLattice<std::array<FourVector, 4>> *four_grad_lattice,
     const LatticeUpdate update, const DensityType dens_type,
     const DensityParameters &par, const std::vector<Particles> &ensembles,
-    const double time_step, const bool compute_gradient);
+    const double time_step, const bool compute_gradient,
+    ThreadPool *pool = nullptr);
 }  // namespace smash
 
 #endif  // SRC_INCLUDE_SMASH_DENSITY_H_
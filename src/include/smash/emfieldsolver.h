@@ -0,0 +1,70 @@
+/*
+ *
+ *    Copyright (c) 2024
+ *      SMASH Team
+ *
+ *    GNU General Public License (GPLv3 or later)
+ *
+ */
+
+#ifndef SRC_INCLUDE_SMASH_EMFIELDSOLVER_H_
+#define SRC_INCLUDE_SMASH_EMFIELDSOLVER_H_
+
+#include <array>
+#include <utility>
+
+#include "density.h"
+#include "lattice.h"
+#include "latticefft.h"
+#include "threevector.h"
+
+namespace smash {
+
+/**
+ * Calculates the electric and magnetic fields of the Coulomb potential on
+ * the whole lattice by fast Fourier transforms.
+ *
+ * The fields at a node are the sums over the nodes of the integration cube
+ * around it, see Potentials::E_field_integrand and
+ * Potentials::B_field_integrand. Both are convolutions of the charge density
+ * and current with the Green's function
+ * \f$ e\,\Delta V\,\mathbf{r}/|\mathbf{r}|^3 \f$ cut at the integration
+ * cube, such that they are products in Fourier space. Instead of summing
+ * over the cube for every node, the fields are obtained from seven
+ * transforms of the lattice, whose cost grows like \f$ N \log N \f$ with the
+ * number of nodes \f$ N \f$. For periodic lattices, the transforms have the
+ * size of the lattice. Otherwise, the lattice is padded with zeros by the
+ * range of the Green's function, such that the charges do not wrap around.
+ */
+class EMFieldSolver {
+ public:
+  /**
+   * Set up the transforms for a lattice and transform the Green's function.
+   *
+   * \param[in] lat Lattice of the charge density, only its geometry is used
+   * \param[in] r_cut Half of the side length of the integration cube [fm]
+   */
+  EMFieldSolver(const RectangularLattice<DensityOnLattice> &lat, double r_cut);
+
+  /**
+   * Calculate the fields from the charge density and current.
+   *
+   * \param[in] jmu_el Electric charge density on the lattice
+   * \param[out] em_lat Electric and magnetic fields on the lattice of the same
+   *             geometry
+   */
+  void compute(RectangularLattice<DensityOnLattice> &jmu_el,
+               ForceLattice &em_lat);
+
+ private:
+  /// Transforms of the lattice
+  LatticeFFT fft_;
+  /// Transformed components of the Green's function
+  std::array<LatticeFFT::Grid, 3> green_;
+  /// Transformed charge density and current components
+  std::array<LatticeFFT::Grid, 4> sources_;
+};
+
+}  // namespace smash
+
+#endif  // SRC_INCLUDE_SMASH_EMFIELDSOLVER_H_
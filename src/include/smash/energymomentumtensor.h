@@ -107,6 +107,23 @@ class EnergyMomentumTensor {
    * \param[in] factor Usually a smearing factor
    */
   void add_particle(const ParticleData &p, double factor);
+  /**
+   * \param[in] mom Momentum 4-vector of a particle
+   * \return The independent components of \f$p^{\mu}p^{\nu}/p^0\f$ in the
+   *         order of the tensor, which a particle adds to several tensors
+   *         with different weights, see add_weighted
+   */
+  static tmn_type particle_contribution(const FourVector &mom);
+  /**
+   * Adds the contribution of a particle times a weight.
+   * \param[in] contribution Contribution given by particle_contribution
+   * \param[in] weight Usually a smearing factor
+   */
+  void add_weighted(const tmn_type &contribution, double weight) {
+    for (std::size_t i = 0; i < Tmn_.size(); i++) {
+      Tmn_[i] += weight * contribution[i];
+    }
+  }
   /// Dummy function need for update_general_lattice
   void add_particle_for_derivatives(const ParticleData &, double, ThreeVector) {
   }
@@ -0,0 +1,58 @@
+/*
+ *
+ *    Copyright (c) 2024
+ *      SMASH Team
+ *
+ *    GNU General Public License (GPLv3 or later)
+ *
+ */
+
+#ifndef SRC_INCLUDE_SMASH_ENSEMBLECOMMUNICATOR_H_
+#define SRC_INCLUDE_SMASH_ENSEMBLECOMMUNICATOR_H_
+
+#include <cstddef>
+
+namespace smash {
+
+/**
+ * Connects the processes, over which the parallel ensembles of one event are
+ * distributed.
+ *
+ * The ensembles only couple through the densities on the lattices. Every
+ * process smears the particles of its ensembles onto its lattices, which are
+ * then summed over all processes, such that every process holds the
+ * densities of all ensembles and computes the same potentials from them.
+ */
+class EnsembleCommunicator {
+ public:
+  /// Default virtual destructor of the interface
+  virtual ~EnsembleCommunicator() = default;
+
+  /// \return Rank of this process, counting from zero
+  virtual int rank() const = 0;
+
+  /// \return Number of processes
+  virtual int size() const = 0;
+
+  /**
+   * Replace values by their sums over all processes. This is collective, all
+   * processes have to call it with the same number of values.
+   *
+   * \param[in,out] values Values of this process, then the sums
+   * \param[in] n Number of values
+   */
+  virtual void sum(double *values, std::size_t n) = 0;
+
+  /**
+   * Replace flags by whether they are set in any process. This is
+   * collective like sum.
+   *
+   * \param[in,out] flags Flags of this process, then the combined ones
+   * \param[in] n Number of flags
+   */
+  virtual void combine_or(char *flags, std::size_t n) = 0;
+};
+
+}  // namespace smash
+
+#endif  // SRC_INCLUDE_SMASH_ENSEMBLECOMMUNICATOR_H_
@@ -0,0 +1,94 @@
+/*
+ *
+ *    Copyright (c) 2024
+ *      SMASH Team
+ *
+ *    GNU General Public License (GPLv3 or later)
+ *
+ */
+
+#ifndef SRC_INCLUDE_SMASH_EQUILIBRATIONMONITOR_H_
+#define SRC_INCLUDE_SMASH_EQUILIBRATIONMONITOR_H_
+
+#include <array>
+#include <deque>
+#include <map>
+#include <vector>
+
+#include "forwarddeclarations.h"
+#include "pdgcode.h"
+
+namespace smash {
+
+/**
+ * \ingroup modus
+ *
+ * When a box counts as equilibrated and how long it is evolved afterwards,
+ * see \ref doxypage_input_conf_modi_box.
+ */
+struct EquilibriumCriterion {
+  /// Time over which the observables have to be stationary [fm]
+  double window = 10.;
+  /// Relative change of an observable within the window, which is allowed
+  double tolerance = 0.02;
+  /// Time the box is evolved after it reached the equilibrium [fm]
+  double measurement_time = 0.;
+};
+
+/**
+ * \ingroup modus
+ *
+ * Decides whether a box reached its equilibrium by the multiplicities of all
+ * species and the first two moments of their momentum distributions.
+ *
+ * The observables are sampled at the end of every time step. The samples of
+ * the last window are split into an earlier and a later half. Every
+ * observable averaged over the later half has to agree with the one averaged
+ * over the earlier half within the tolerance. Species whose average
+ * multiplicity is below the inverse of the tolerance are not taken into
+ * account, as they fluctuate more than the tolerance anyway.
+ */
+class EquilibrationMonitor {
+ public:
+  /**
+   * \param[in] criterion Window and tolerance of the stationarity
+   * \throw std::invalid_argument if the window or the tolerance is not
+   *        positive or the measurement time is negative.
+   */
+  explicit EquilibrationMonitor(const EquilibriumCriterion &criterion);
+
+  /**
+   * Add the observables of all particles at the given time.
+   *
+   * \param[in] time Time of the sample [fm]
+   * \param[in] ensembles All particles of the event
+   * \return Whether the observables are stationary over the last window
+   */
+  bool add(double time, const std::vector<Particles> &ensembles);
+
+  /// Forget all samples, e.g. at the beginning of an event
+  void reset() { samples_.clear(); }
+
+  /// \return The criterion of the equilibrium
+  const EquilibriumCriterion &criterion() const { return criterion_; }
+
+ private:
+  /// Number of particles and sums of their momenta and squared momenta
+  using Sums = std::array<double, 3>;
+  /// Observables at one time
+  struct Sample {
+    /// Time of the sample [fm]
+    double time;
+    /// Sums of every species
+    std::map<PdgCode, Sums> species;
+  };
+
+  /// Window and tolerance of the stationarity
+  const EquilibriumCriterion criterion_;
+  /// Samples of the last window, the oldest first
+  std::deque<Sample> samples_;
+};
+
+}  // namespace smash
+
+#endif  // SRC_INCLUDE_SMASH_EQUILIBRATIONMONITOR_H_
@@ -0,0 +1,42 @@
+/*
+ *
+ *    Copyright (c) 2024
+ *      SMASH Team
+ *
+ *    GNU General Public License (GPLv3 or later)
+ *
+ */
+
+#ifndef SRC_INCLUDE_SMASH_EVENTDISPATCHER_H_
+#define SRC_INCLUDE_SMASH_EVENTDISPATCHER_H_
+
+namespace smash {
+
+/**
+ * Hands out the events of a run, which are generated by several processes
+ * sharing one configuration.
+ *
+ * Every process takes the next event whenever it finished the previous one,
+ * such that faster processes generate more events. The numbers of the events
+ * count up from zero over all processes.
+ */
+class EventDispatcher {
+ public:
+  /// Default virtual destructor of the interface
+  virtual ~EventDispatcher() = default;
+
+  /**
+   * Take the next event to be generated.
+   *
+   * \param[in] nonempty_ensembles Number of ensembles with interactions in
+   *            the events finished by this process since the last call
+   * \param[out] nonempty_total Number of ensembles with interactions in all
+   *             events reported by all processes so far, including these
+   * \return Number of the event
+   */
+  virtual int take_event(int nonempty_ensembles, int &nonempty_total) = 0;
+};
+
+}  // namespace smash
+
+#endif  // SRC_INCLUDE_SMASH_EVENTDISPATCHER_H_
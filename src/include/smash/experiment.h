@@ -8,45 +8,79 @@
 #define SRC_INCLUDE_SMASH_EXPERIMENT_H_
 
 #include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
 #include <limits>
+#include <map>
 #include <memory>
+#include <mutex>
+#include <numeric>
+#include <optional>
 #include <set>
+#include <stdexcept>
 #include <string>
+#include <type_traits>
+#include <typeinfo>
+#include <unordered_set>
 #include <utility>
 #include <vector>
 
 #include "actionfinderfactory.h"
 #include "actions.h"
+#include "algorithms.h"
+#include "asyncoutput.h"
 #include "bremsstrahlungaction.h"
+#include "checkpoint.h"
 #include "chrono.h"
+#include "collisiontrace.h"
+#include "decayaction.h"
 #include "decayactionsfinder.h"
 #include "decayactionsfinderdilepton.h"
+#include "emfieldsolver.h"
 #include "energymomentumtensor.h"
+#include "ensemblecommunicator.h"
+#include "equilibrationmonitor.h"
+#include "eventdispatcher.h"
 #include "fields.h"
 #include "fourvector.h"
+#include "frozenspectators.h"
 #include "grandcan_thermalizer.h"
 #include "grid.h"
 #include "hypersurfacecrossingaction.h"
+#include "memoryusage.h"
 #include "outputparameters.h"
+#include "particlessoa.h"
 #include "pauliblocking.h"
+#include "photonchannels.h"
 #include "potential_globals.h"
 #include "potentials.h"
+#include "potentialsrefresh.h"
+#include "profiler.h"
 #include "propagation.h"
 #include "quantumnumbers.h"
 #include "scatteractionphoton.h"
 #include "scatteractionsfinder.h"
 #include "stringprocess.h"
+#include "sweepandprune.h"
 #include "thermalizationaction.h"
+#include "threadpool.h"
+#include "timesteplessgrid.h"
 // Output
 #include "binaryoutput.h"
+#include "columnaroutput.h"
 #ifdef SMASH_USE_HEPMC
 #include "hepmcoutput.h"
 #endif
+#include "histogramoutput.h"
 #ifdef SMASH_USE_RIVET
 #include "rivetoutput.h"
 #endif
 #include "icoutput.h"
 #include "oscaroutput.h"
+#include "outputfilter.h"
+#include "outputmerger.h"
+#include "shardedoutput.h"
 #include "thermodynamiclatticeoutput.h"
 #include "thermodynamicoutput.h"
 #ifdef SMASH_USE_ROOT
@@ -114,6 +148,9 @@ class ExperimentBase {
    * \param[inout] config The configuration object that sets all initial
    * conditions of the experiment. \param[in] output_path The directory where
    * the output files are written.
+   * \param[in] communicator If given, the ensembles of every event are
+   *            distributed over its processes, each of which creates an
+   *            experiment evolving its share of them.
    *
    * \return An owning pointer to the Experiment object, using the
    *         ExperimentBase interface.
@@ -126,7 +163,8 @@ class ExperimentBase {
    * configuration itself is documented in \ref doxypage_input_conf_general
    */
   static std::unique_ptr<ExperimentBase> create(
-      Configuration &config, const std::filesystem::path &output_path);
+      Configuration &config, const std::filesystem::path &output_path,
+      EnsembleCommunicator *communicator = nullptr);
 
   /**
    * Runs the experiment.
@@ -136,6 +174,20 @@ class ExperimentBase {
    */
   virtual void run() = 0;
 
+  /**
+   * Runs the events handed out by a dispatcher, which distributes the events
+   * of one run over several processes.
+   *
+   * Every event has the random seed it would have in a sequential run, so
+   * the events do not depend on which process generates them.
+   *
+   * \param[in] dispatcher Hands out the events
+   * \return The events generated by this process
+   * \throw std::invalid_argument if the experiment has event workers, reads
+   *        the events from files or resumes a checkpoint.
+   */
+  virtual std::vector<int> run(EventDispatcher &dispatcher) = 0;
+
   /**
    * \ingroup exception
    * Exception class that is thrown if an invalid modus is requested from the
@@ -153,6 +205,22 @@ class ExperimentBase {
   struct NonExistingOutputPathRequest : public std::invalid_argument {
     using std::invalid_argument::invalid_argument;
   };
+
+ private:
+  /**
+   * Create an Experiment<Modus> together with the additional event workers
+   * requested in the \p config.
+   *
+   * \param[inout] config The configuration object, see create.
+   * \param[in] output_path The directory where the output files are written.
+   * \param[in] communicator Processes the ensembles are distributed over,
+   *            see create.
+   * \return An owning pointer to the Experiment object.
+   */
+  template <typename Modus>
+  static std::unique_ptr<ExperimentBase> create_with_event_workers(
+      Configuration &config, const std::filesystem::path &output_path,
+      EnsembleCommunicator *communicator);
 };
 
 template <typename Modus>
@@ -197,6 +265,9 @@ class Experiment : public ExperimentBase {
    */
   void run() override;
 
+  /// \copydoc ExperimentBase::run(EventDispatcher &)
+  std::vector<int> run(EventDispatcher &dispatcher) override;
+
   /**
    * Create a new Experiment.
    *
@@ -211,7 +282,8 @@ class Experiment : public ExperimentBase {
    * \param[in] output_path The directory where the output files are written.
    */
   explicit Experiment(Configuration &config,
-                      const std::filesystem::path &output_path);
+                      const std::filesystem::path &output_path)
+      : Experiment(config, output_path, nullptr) {}
 
   /**
    * This is called in the beginning of each event. It initializes particles
@@ -270,7 +342,55 @@ class Experiment : public ExperimentBase {
    */
   void increase_event_number();
 
+  /**
+   * Adds an output in addition to the configured ones, e.g. a CallbackOutput
+   * to analyze the events without writing them. This function is helpful if
+   * SMASH is used as a 3rd-party library.
+   *
+   * \param[in] output Output to be added
+   * \throw std::logic_error if there are event workers, whose outputs are
+   *        set up together with the configured outputs.
+   */
+  void add_output(OutputPtr output) {
+    if (!event_workers_.empty()) {
+      throw std::logic_error(
+          "Outputs cannot be added to an experiment with event workers.");
+    }
+    outputs_.emplace_back(std::move(output));
+  }
+
  private:
+  /**
+   * Create a new Experiment, which is either independent or an additional
+   * event worker of another experiment.
+   *
+   * \param[inout] config The Configuration object, see the public constructor.
+   * \param[in] output_path The directory where the output files are written.
+   * \param[in] output_merger If given, the experiment is an event worker which
+   *            does not create any output files, but defers its output to be
+   *            written by this merger.
+   * \param[in] communicator If given, the experiment only evolves its share
+   *            of the ensembles of the processes, see ExperimentBase::create.
+   */
+  Experiment(Configuration &config, const std::filesystem::path &output_path,
+             const OutputMerger *output_merger,
+             EnsembleCommunicator *communicator = nullptr);
+
+  /**
+   * Generate the events with all event workers concurrently. The output is
+   * written in the order of the events, hence it is the same as for generating
+   * them one after another.
+   */
+  void run_with_event_workers();
+
+  /**
+   * Draw the random seed of the next event from the current random number
+   * engine.
+   *
+   * \return A positive random seed
+   */
+  static int64_t draw_next_event_seed();
+
   /**
    * Perform the given action.
    *
@@ -299,12 +419,43 @@ class Experiment : public ExperimentBase {
 
   /**
    * Propagate all particles until time to_time without any interactions
-   * and shine dileptons.
+   * and shine dileptons. With batched wall crossings, the particles which
+   * left the box are moved back into it afterwards.
    *
    * \param[in] to_time Time at the end of propagation [fm]
    * \param[in, out] particles Particles to be propagated
+   * \param[in] i_ensemble Index of the ensemble of the particles
+   */
+  void propagate_and_shine(double to_time, Particles &particles,
+                           int i_ensemble);
+
+  /**
+   * Propagate the particles of an event which froze out without any
+   * interactions until \p t_end, writing the intermediate output at the
+   * output times on the way, and advance the clock to \p t_end. Decays which
+   * are still pending are left for do_final_decays.
+   *
+   * \param[in] t_end Time at the end of the evolution [fm]
+   */
+  void propagate_frozen_out(double t_end);
+
+  /**
+   * Move the particles which left the box back into it from the opposite
+   * side. The wall crossings are written to the outputs and counted like
+   * the wall crossing actions they replace.
+   *
+   * \param[in, out] particles Particles of the ensemble
+   * \param[in] i_ensemble Index of the ensemble
+   */
+  void wrap_into_box(Particles &particles, int i_ensemble);
+
+  /**
+   * Write the dilepton decays found by the shining method to all dilepton
+   * outputs.
+   *
+   * \param[in] actions Dilepton decays with generated final states
    */
-  void propagate_and_shine(double to_time, Particles &particles);
+  void write_dilepton_actions(const ActionList &actions);
 
   /**
    * Performs all the propagations and actions during a certain time interval
@@ -321,12 +472,147 @@ class Experiment : public ExperimentBase {
   void run_time_evolution_timestepless(Actions &actions, int i_ensemble,
                                        const double end_time_propagation);
 
+  /**
+   * Fragment the strings of the found actions in parallel, before the actions
+   * are performed one by one. The actions draw their final states from random
+   * streams of their own, such that the results do not depend on whether
+   * their strings were fragmented ahead.
+   *
+   * \param[in, out] actions Found actions of all ensembles
+   * \param[in]      end_time Only actions up to this time are considered
+   */
+  void prefragment_strings(std::vector<Actions> &actions, double end_time);
+
+  /**
+   * Generate the final states of the upcoming collisions of an ensemble in
+   * parallel, before the actions are performed one by one, see
+   * \ref key_CT_speculation_window_.
+   *
+   * The window holds the next actions in the order in which they are
+   * performed. A collision is skipped if it shares an incoming particle with
+   * an earlier action of the window, or if the particles produced by an
+   * earlier action could reach it: they move at most at the speed of light
+   * and collide within the largest interaction distance. Skipped collisions
+   * generate their final state when they are performed, if they are still
+   * valid then. The periodic images of a box are not considered, which only
+   * affects how much is sampled in vain.
+   *
+   * \param[in] actions Found actions of the ensemble
+   * \param[in] i_ensemble Index of the ensemble
+   * \param[in] end_time Only actions up to this time are considered
+   * \return Number of actions in the window
+   */
+  std::size_t prepare_upcoming_collisions(const Actions &actions,
+                                          int i_ensemble, double end_time);
+
   /// Intermediate output during an event
   void intermediate_output();
 
+  /**
+   * \return Current conserved quantities of all ensembles, which are only
+   *         summed over all particles if these changed outside of the
+   *         actions since the last time
+   */
+  const QuantumNumbers &current_conserved_quantities() {
+    if (conserved_current_outdated_) {
+      conserved_current_ = QuantumNumbers(ensembles_);
+      conserved_current_outdated_ = false;
+    }
+    return conserved_current_;
+  }
+
+  /// \return Current number of particles in all ensembles
+  int total_particle_number() const {
+    int total_particles = 0;
+    for (const Particles &particles : ensembles_) {
+      total_particles += particles.size();
+    }
+    return total_particles;
+  }
+
   /// Recompute potentials on lattices if necessary.
   void update_potentials();
 
+  /**
+   * Call a function with every lattice of the potentials, which is used,
+   * together with its history for the extrapolation.
+   *
+   * \tparam F Type of the function. Arguments are the lattice and its
+   * LatticeHistory.
+   * \param[in] func Function acting on the lattices.
+   */
+  template <typename F>
+  void for_each_potentials_history(F &&func) {
+    if (UB_lat_) {
+      func(*UB_lat_, UB_history_);
+    }
+    if (UI3_lat_) {
+      func(*UI3_lat_, UI3_history_);
+    }
+    if (FB_lat_) {
+      func(*FB_lat_, FB_history_);
+    }
+    if (FI3_lat_) {
+      func(*FI3_lat_, FI3_history_);
+    }
+    if (EM_lat_) {
+      func(*EM_lat_, EM_history_);
+    }
+  }
+
+  /**
+   * Call a function with every lattice of the baryon and isospin potentials
+   * and forces, which is used.
+   *
+   * \tparam F Type of the function, which is called with the lattice.
+   * \param[in] func Function acting on the lattices.
+   */
+  template <typename F>
+  void for_each_potential_lattice(F &&func) {
+    if (UB_lat_) {
+      func(*UB_lat_);
+    }
+    if (UI3_lat_) {
+      func(*UI3_lat_);
+    }
+    if (FB_lat_) {
+      func(*FB_lat_);
+    }
+    if (FI3_lat_) {
+      func(*FI3_lat_);
+    }
+  }
+
+  /**
+   * Call a function with the pointer of every lattice, whether it is used or
+   * not.
+   *
+   * \tparam F Type of the function, which is called with a reference to the
+   * std::unique_ptr of the lattice.
+   * \param[in] func Function acting on the lattices.
+   */
+  template <typename F>
+  void for_each_lattice(F &&func) {
+    func(j_QBS_lat_);
+    func(jmu_B_lat_);
+    func(jmu_I3_lat_);
+    func(jmu_el_lat_);
+    func(fields_lat_);
+    func(jmu_custom_lat_);
+    func(UB_lat_);
+    func(UI3_lat_);
+    func(FB_lat_);
+    func(FI3_lat_);
+    func(EM_lat_);
+    func(Tmn_);
+    func(old_jmu_auxiliary_);
+    func(new_jmu_auxiliary_);
+    func(four_gradient_auxiliary_);
+    func(old_fields_auxiliary_);
+    func(new_fields_auxiliary_);
+    func(fields_four_gradient_auxiliary_);
+  }
+
   /**
    * Calculate the minimal size for the grid cells such that the
    * ScatterActionsFinder will find all collisions within the maximal
@@ -347,12 +633,152 @@ class Experiment : public ExperimentBase {
     return parameters_.outputclock->next_time();
   }
 
+  /**
+   * Call the given function for the index of every ensemble.
+   *
+   * The random number engine adopts the random stream of the ensemble while
+   * its function call is executed. If a thread pool is present, the ensembles
+   * are processed concurrently, which yields the same result thanks to the
+   * independent streams.
+   *
+   * \param[in] function Function to be called with the ensemble index, which
+   *                     must only modify the given ensemble or lock the shared
+   *                     state.
+   */
+  template <typename F>
+  void for_each_ensemble(F &&function) {
+    auto evolve_ensemble = [&](int i_ens) {
+      random::EngineGuard guard(ensemble_engines_[i_ens]);
+      function(i_ens);
+    };
+    if (!thread_pool_) {
+      for (int i_ens = 0; i_ens < parameters_.n_ensembles; i_ens++) {
+        evolve_ensemble(i_ens);
+      }
+      return;
+    }
+    thread_pool_->parallel_for(parameters_.n_ensembles, evolve_ensemble);
+  }
+
+  /**
+   * Lock the state that is shared among the ensembles (counters and outputs).
+   *
+   * \return Lock owning the mutex if ensembles are evolved concurrently, an
+   *         empty lock otherwise
+   */
+  std::unique_lock<std::mutex> lock_shared_state() {
+    return thread_pool_ ? std::unique_lock<std::mutex>(shared_state_mutex_)
+                        : std::unique_lock<std::mutex>();
+  }
+
   /**
    * Counts the number of ensembles in wich interactions took place at the end
    * of an event
    */
   void count_nonempty_ensembles();
 
+  /**
+   * \param[in] i_ens Index of an ensemble of this process
+   * \return Number of the ensemble in the output, where every ensemble of
+   *         every process counts as an event of its own
+   */
+  int global_ensemble_number(int i_ens) const {
+    return event_ * parameters_.n_ensembles_total +
+           parameters_.first_ensemble + i_ens;
+  }
+
+  /// Print the profile of the finished event, if profiling is enabled.
+  void end_profiled_event();
+
+  /**
+   * Print the profile summed over the events of all workers and write it to
+   * profile.json in the output directory, if profiling is enabled, and write
+   * the trace to trace.json, if tracing is enabled.
+   */
+  void report_profile();
+
+  /**
+   * Choose the duration of the next time steps with TimeStepMode::Adaptive.
+   *
+   * The time step is at most a tenth of the time scale, in which the forces
+   * change the momenta, and of the time, in which as many scatterings as
+   * there are particles happen at the scattering rate of the last time step.
+   * It grows by at most a factor of two per time step and stays within
+   * min_delta_time_ and max_delta_time_. The output times are not affected,
+   * since the time steps are split at the output times anyway.
+   *
+   * \param[in] dt Duration of the last time step [fm]
+   * \param[in] scatterings Scatterings performed in the last time step
+   * \param[in] force_time_scale Smallest time scale of the change of the
+   *            momenta by the potentials, see update_momenta [fm]
+   */
+  void adapt_time_step(double dt, std::uint64_t scatterings,
+                       double force_time_scale);
+
+  /**
+   * Choose the collision search of the next time step with
+   * CollisionSearch::Auto.
+   *
+   * Every search_probe_interval time steps, the search not in use is tried
+   * for one time step. Afterwards, the one which examined fewer pairs in its
+   * last time step is used.
+   *
+   * \param[in] pairs Pairs examined in the current time step
+   */
+  void choose_collision_search(std::uint64_t pairs);
+
+  /**
+   * Update the memory used by the particles, grids, actions, lattices,
+   * tabulations and output buffers, and check the memory limit.
+   *
+   * \throw std::runtime_error if the memory limit is exceeded
+   */
+  void update_memory_usage();
+
+  /// Print the memory usage at the end of an event, if requested.
+  void report_memory_usage();
+
+  /**
+   * Write the state of the time evolution to checkpoint.bin in the output
+   * directory, from which the event is resumed with General: Restart_From.
+   *
+   * The file is written under a temporary name and renamed afterwards, such
+   * that an interrupted run never leaves a truncated checkpoint behind. The
+   * grids are discarded, such that the resumed and the uninterrupted run
+   * build them anew in the next time step.
+   *
+   * \throw std::runtime_error if the checkpoint cannot be written
+   */
+  void write_checkpoint();
+
+  /**
+   * Initialize the event of the checkpoint given by General: Restart_From
+   * and replace its state with the one of the checkpoint.
+   *
+   * The event is initialized with its seed first, which recreates the state
+   * of the modus and writes the event start to the outputs.
+   *
+   * \throw std::runtime_error if the checkpoint cannot be read or was written
+   *        with another number of ensembles, test particles or particle types
+   */
+  void resume_from_checkpoint();
+
+  /**
+   * Replace the ensembles after the first one by copies of it and restart
+   * their random streams, see General: Ensemble_Fork_Time.
+   */
+  void fork_ensembles();
+
+  /**
+   * Let the pinned threads copy the particles of the ensembles they evolve,
+   * such that the particles lie in the memory of their NUMA node.
+   */
+  void relocate_ensembles() {
+    if (thread_pool_ && thread_pool_->pinned()) {
+      for_each_ensemble([this](int i_ens) { ensembles_[i_ens].relocate(); });
+    }
+  }
+
   /**
    * Checks wether the desired number events have been calculated
    *
@@ -397,6 +823,12 @@ class Experiment : public ExperimentBase {
    */
   OutputsList outputs_;
 
+  /**
+   * Outputs writing an event while the next one evolves, which are also
+   * contained in outputs_
+   */
+  std::vector<AsyncOutput *> overlapping_outputs_;
+
   /// The Dilepton output
   OutputPtr dilepton_output_;
 
@@ -431,6 +863,16 @@ class Experiment : public ExperimentBase {
   /// 4-current for j_QBS lattice output
   std::unique_ptr<DensityLattice> j_QBS_lat_;
 
+  /**
+   * Snapshot of the particles of all ensembles, taken once per time step for
+   * the lattices of the potentials and at every output for the lattices of
+   * the thermodynamic output
+   */
+  ParticlesSoA particles_soa_;
+
+  /// Nodes, on which the potentials are evaluated, reused over time steps
+  std::vector<int> potential_nodes_;
+
   /// Baryon density on the lattice
   std::unique_ptr<DensityLattice> jmu_B_lat_;
 
@@ -471,16 +913,32 @@ class Experiment : public ExperimentBase {
    * Lattices for the electric and magnetic components of the Skyrme or VDF
    * force
    */
-  std::unique_ptr<RectangularLattice<std::pair<ThreeVector, ThreeVector>>>
-      FB_lat_;
+  std::unique_ptr<ForceLattice> FB_lat_;
 
   /// Lattices for the electric and magnetic component of the symmetry force
-  std::unique_ptr<RectangularLattice<std::pair<ThreeVector, ThreeVector>>>
-      FI3_lat_;
+  std::unique_ptr<ForceLattice> FI3_lat_;
 
   /// Lattices for electric and magnetic field in fm^-2
-  std::unique_ptr<RectangularLattice<std::pair<ThreeVector, ThreeVector>>>
-      EM_lat_;
+  std::unique_ptr<ForceLattice> EM_lat_;
+
+  /// Solver for the electric and magnetic fields by Fourier transforms
+  std::unique_ptr<EMFieldSolver> em_field_solver_;
+
+  /**
+   * Decides when the potentials are updated, if they may be extrapolated in
+   * between, see PotentialsRefresh
+   */
+  std::unique_ptr<PotentialsRefresh> potentials_refresh_;
+  /// Last updates of UB_lat_ for the extrapolation
+  LatticeHistory<FourVector> UB_history_;
+  /// Last updates of UI3_lat_ for the extrapolation
+  LatticeHistory<FourVector> UI3_history_;
+  /// Last updates of FB_lat_ for the extrapolation
+  LatticeHistory<std::pair<ThreeVector, ThreeVector>> FB_history_;
+  /// Last updates of FI3_lat_ for the extrapolation
+  LatticeHistory<std::pair<ThreeVector, ThreeVector>> FI3_history_;
+  /// Last updates of EM_lat_ for the extrapolation
+  LatticeHistory<std::pair<ThreeVector, ThreeVector>> EM_history_;
 
   /// Lattices of energy-momentum tensors for printout
   std::unique_ptr<RectangularLattice<EnergyMomentumTensor>> Tmn_;
@@ -597,6 +1055,89 @@ class Experiment : public ExperimentBase {
   /// This indicates whether to use the grid.
   const bool use_grid_;
 
+  /// Type of the grid created by the modus
+  using ModusGrid = decltype(std::declval<const Modus &>().create_grid(
+      std::declval<const Particles &>(), 0., 0., CollisionCriterion::Geometric,
+      false));
+
+  /**
+   * The grid of every ensemble. It is kept from one time step to the next and
+   * updated instead of being constructed anew, as long as the particles stay
+   * inside of it (see Grid::update).
+   */
+  std::vector<std::unique_ptr<ModusGrid>> grids_;
+
+  /// How pairs of particles are searched for collisions
+  CollisionSearch collision_search_ = CollisionSearch::Grid;
+
+  /// Search used in the current time step, either the grid or the sweep
+  CollisionSearch step_search_ = CollisionSearch::Grid;
+
+  /**
+   * Pairs examined in the last time step searched with the grid and with the
+   * sweep, from which CollisionSearch::Auto chooses the search
+   */
+  std::array<std::uint64_t, 2> search_pairs_ = {0, 0};
+
+  /// Time steps since the other search was tried with CollisionSearch::Auto
+  int steps_since_search_probe_ = 0;
+
+  /// Whether the current time step tries the other search
+  bool search_probe_ = false;
+
+  /// Every how many time steps the other search is tried with Auto
+  static constexpr int search_probe_interval = 10;
+
+  /// The sweep-and-prune search of every ensemble
+  std::vector<SweepAndPrune> sweeps_;
+
+  /**
+   * Cells of every ensemble, in which the collision partners of the particles
+   * produced during the timestepless propagation are searched
+   */
+  std::vector<TimesteplessGrid> timestepless_grids_;
+
+  /**
+   * Box around the particles of every ensemble, which is found while they are
+   * propagated, such that a new grid need not look at all particles again.
+   * It is reset whenever the positions change otherwise.
+   */
+  std::vector<std::optional<GridBase::MinAndLength>> particle_extents_;
+
+  /**
+   * Space left free around the particles on every side of a grid with normal
+   * boundaries, relative to their extent, such that the grid can be kept while
+   * the system expands.
+   */
+  static constexpr double grid_margin_ = 0.1;
+
+  /**
+   * Spectators of every ensemble, which are left out of the grid in the
+   * current time step. Empty unless spectators are frozen.
+   */
+  std::vector<FrozenSpectators> frozen_spectators_;
+
+  /**
+   * Particles of every ensemble, which escaped from the interacting core and
+   * are left out of the grid in the current time step. Empty unless escaping
+   * particles are frozen.
+   */
+  std::vector<EscapedParticles> escaped_particles_;
+
+  /**
+   * Whether the projectile and the target of a collider run are checked for
+   * having separated without interacting, see nuclei_separated_.
+   */
+  bool detect_separated_nuclei_ = false;
+
+  /**
+   * Whether the projectile and the target of every ensemble separated without
+   * interacting, after which no actions are searched anymore and the event
+   * is only propagated to its end. The values are chars instead of bools,
+   * such that the ensembles can set them concurrently.
+   */
+  std::vector<char> nuclei_separated_;
+
   /// This struct contains information on the metric to be used
   const ExpansionProperties metric_;
 
@@ -609,101 +1150,337 @@ class Experiment : public ExperimentBase {
   /// This indicates whether bremsstrahlung is switched on.
   const bool bremsstrahlung_switch_;
 
+  /**
+   * Photon channels of all pairs of particle types, if photons or
+   * bremsstrahlung are switched on
+   */
+  std::unique_ptr<PhotonChannels> photon_channels_;
+
   /// This indicates whether the IC output is enabled.
   const bool IC_output_switch_;
 
   /// This indicates whether to use time steps.
   const TimeStepMode time_step_mode_;
 
+  /// Smallest time step with TimeStepMode::Adaptive [fm]
+  double min_delta_time_ = 0.;
+
+  /// Largest time step with TimeStepMode::Adaptive [fm]
+  double max_delta_time_ = 0.;
+
+  /// Duration of the following time steps with TimeStepMode::Adaptive [fm]
+  double adaptive_delta_time_ = 0.;
+
+  /// Number of threads to evolve the ensembles
+  const int n_threads_;
+
+  /// Whether the threads are bound to CPUs, see ThreadPool
+  const bool pin_threads_;
+
   /**
-   * Maximal distance at which particles can interact in case of the geometric
-   * criterion, squared
+   * Whether the strings of the collisions found in a time step are fragmented
+   * in parallel before the collisions are performed
    */
-  double max_transverse_distance_sqr_ = std::numeric_limits<double>::max();
+  const bool batch_string_fragmentation_;
 
   /**
-   * The conserved quantities of the system.
-   *
-   * This struct carries the sums of the single particle's various
-   * quantities as measured at the beginning of the evolution and can be
-   * used to regularly check if they are still good.
+   * Pool of threads to evolve the ensembles concurrently and to fragment
+   * strings in parallel, only present if more than one thread is used.
    */
-  QuantumNumbers conserved_initial_;
+  std::unique_ptr<ThreadPool> thread_pool_;
 
   /**
-   * The initial total mean field energy in the system.
-   * Note: will only be calculated if lattice is on.
+   * Random number streams of the ensembles, used for their evolution within
+   * the timesteps.
    */
-  double initial_mean_field_energy_;
+  std::vector<random::Engine> ensemble_engines_;
 
-  /// system starting time of the simulation
-  SystemTimePoint time_start_ = SystemClock::now();
-
-  /// Type of density to be written to collision headers
-  DensityType dens_type_ = DensityType::None;
+  /**
+   * Number of interactions of each ensemble in the current event, from which
+   * the process ids are assigned independently of the other ensembles.
+   */
+  std::vector<uint64_t> ensemble_interactions_;
 
   /**
-   *  Total number of interactions for current timestep.
-   *  For timestepless mode the whole run time is considered as one timestep.
+   * Actions found in the current time step for each ensemble. Their storage
+   * is kept for all time steps and events.
    */
-  uint64_t interactions_total_ = 0;
+  std::vector<Actions> actions_;
 
   /**
-   *  Total number of interactions for previous timestep.
-   *  For timestepless mode the whole run time is considered as one timestep.
+   * Guards the state shared by all ensembles while they are evolved
+   * concurrently.
    */
-  uint64_t previous_interactions_total_ = 0;
+  std::mutex shared_state_mutex_;
+
+  /// Number of workers generating events concurrently
+  const int n_event_workers_;
 
   /**
-   *  Total number of wall-crossings for current timestep.
-   *  For timestepless mode the whole run time is considered as one timestep.
+   * Measures the time spent in the phases of the evolution, if profiling or
+   * tracing is enabled
    */
-  uint64_t wall_actions_total_ = 0;
+  std::unique_ptr<Profiler> profiler_;
+
+  /// Whether the profile of the phases is printed and written
+  bool profile_phases_ = false;
 
   /**
-   *  Total number of wall-crossings for previous timestep.
-   *  For timestepless mode the whole run time is considered as one timestep.
+   * Memory used by the subsystems, if it is reported or limited, see
+   * update_memory_usage
    */
-  uint64_t previous_wall_actions_total_ = 0;
+  std::unique_ptr<MemoryUsage> memory_usage_;
+
+  /// Whether the memory usage is printed at the end of every event
+  bool report_memory_ = false;
 
   /**
-   *  Total number of Pauli-blockings for current timestep.
-   *  For timestepless mode the whole run time is considered as one timestep.
+   * Fraction of the slots of the particles which may be holes left by removed
+   * particles, above which the particles are compacted at the beginning of a
+   * time step
    */
-  uint64_t total_pauli_blocked_ = 0;
+  double max_hole_fraction_ = 1.;
 
   /**
-   *  Total number of particles removed from the evolution in
-   *  hypersurface crossing actions.
+   * Number of time steps after which the particles are sorted by their
+   * position, or 0 if they are never sorted
    */
-  uint64_t total_hypersurface_crossing_actions_ = 0;
+  int particle_sort_interval_ = 0;
+
+  /// Time steps of the current event since the particles were sorted
+  int steps_since_particle_sort_ = 0;
 
   /**
-   *  Total number of discarded interactions, because they were invalidated
-   *  before they could be performed.
+   * Time without any pair of particles within reach of a collision, after
+   * which an event is frozen out and propagated freely to the end time, or 0
+   * if the evolution always runs until the end time
    */
-  uint64_t discarded_interactions_total_ = 0;
+  double freeze_out_window_ = 0.;
+
+  /// End of the last time step of the current event with possible collisions
+  double last_collision_time_ = 0.;
+
+  /// Decides when a box reached its equilibrium, if it stops there
+  std::optional<EquilibrationMonitor> equilibration_monitor_;
+
+  /// Time the current event reached its equilibrium, if it did
+  std::optional<double> equilibrium_time_;
 
   /**
-   * Total energy removed from the system in hypersurface crossing actions.
+   * Whether the particles are moved back into the box in the propagation
+   * instead of by wall crossing actions
    */
-  double total_energy_removed_ = 0.0;
+  bool batch_wall_crossings_ = false;
 
   /**
-   * Total energy violation introduced by Pythia.
+   * Number of upcoming collisions whose final states are generated in
+   * parallel, or 0 if they are generated when the collisions are performed,
+   * see prepare_upcoming_collisions
    */
-  double total_energy_violated_by_Pythia_ = 0.0;
+  int speculation_window_ = 0;
 
-  /// This indicates whether kinematic cuts are enabled for the IC output
-  bool kinematic_cuts_for_IC_output_ = false;
+  /// Time between two checkpoints [fm], 0 if no checkpoints are written
+  double checkpoint_interval_ = 0.;
 
-  /// random seed for the next event.
-  int64_t seed_ = -1;
+  /// Time of the next checkpoint in the event [fm]
+  double next_checkpoint_time_ = 0.;
+
+  /// Path of the checkpoint written in the output directory
+  std::filesystem::path checkpoint_path_;
+
+  /// Path of the checkpoint the run is resumed from, empty if none
+  std::filesystem::path restart_path_;
 
   /**
-   * \ingroup logging
-   * Writes the initial state for the Experiment to the output stream.
-   * It automatically appends the output of the current Modus.
+   * Time at which the first ensemble is forked into all ensembles [fm],
+   * infinite if the ensembles are sampled independently
+   */
+  double ensemble_fork_time_ = std::numeric_limits<double>::infinity();
+
+  /// Whether the ensembles of the current event are forked already
+  bool ensembles_forked_ = false;
+
+  /// How thoroughly the conservation laws are checked
+  ConservationCheck conservation_check_ = ConservationCheck::Full;
+
+  /// Every how many actions one is checked with ConservationCheck::Sampled
+  int conservation_check_interval_ = 100;
+
+  /**
+   * Number of particles, above which the grid cells of the stochastic
+   * criterion are divided for the collision search, 0 for never
+   */
+  std::size_t max_cell_occupancy_ = 0;
+
+  /// Minimal length of the divided grid cells [fm]
+  double min_subcell_length_ = 0.5;
+
+  /**
+   * Conserved quantities of all ensembles, which are updated by every action
+   * instead of summing over all particles, see current_conserved_quantities
+   */
+  QuantumNumbers conserved_current_;
+
+  /**
+   * Whether the particles changed outside of the actions since
+   * conserved_current_ was summed up, i.e. by the potentials or by the
+   * expansion of the universe
+   */
+  bool conserved_current_outdated_ = false;
+
+  /**
+   * Merger writing the output of all event workers, which owns the actual
+   * outputs. It is only present in the experiment coordinating the workers.
+   */
+  std::unique_ptr<OutputMerger> output_merger_;
+
+  /**
+   * Additional event workers, which are set up from the same configuration
+   * and generate events concurrently with this experiment.
+   */
+  std::vector<std::unique_ptr<Experiment<Modus>>> event_workers_;
+
+  /**
+   * Merger to which the output is deferred if this is an additional event
+   * worker, nullptr otherwise
+   */
+  const OutputMerger *const deferring_output_to_ = nullptr;
+
+  /**
+   * Maximal distance at which particles can interact in case of the geometric
+   * criterion, squared
+   */
+  double max_transverse_distance_sqr_ = std::numeric_limits<double>::max();
+
+  /**
+   * The conserved quantities of the system.
+   *
+   * This struct carries the sums of the single particle's various
+   * quantities as measured at the beginning of the evolution and can be
+   * used to regularly check if they are still good.
+   */
+  QuantumNumbers conserved_initial_;
+
+  /**
+   * The initial total mean field energy in the system.
+   * Note: will only be calculated if lattice is on.
+   */
+  double initial_mean_field_energy_;
+
+  /**
+   * The current total mean field energy in the system, which is summed up
+   * along with the potentials on the lattice.
+   * Note: will only be calculated if lattice is on.
+   */
+  double mean_field_energy_ = 0.0;
+
+  /// system starting time of the simulation
+  SystemTimePoint time_start_ = SystemClock::now();
+
+  /// Type of density to be written to collision headers
+  DensityType dens_type_ = DensityType::None;
+
+  /**
+   *  Total number of interactions for current timestep.
+   *  For timestepless mode the whole run time is considered as one timestep.
+   */
+  uint64_t interactions_total_ = 0;
+
+  /**
+   *  Total number of interactions for previous timestep.
+   *  For timestepless mode the whole run time is considered as one timestep.
+   */
+  uint64_t previous_interactions_total_ = 0;
+
+  /**
+   *  Total number of wall-crossings for current timestep.
+   *  For timestepless mode the whole run time is considered as one timestep.
+   */
+  uint64_t wall_actions_total_ = 0;
+
+  /**
+   *  Total number of wall-crossings for previous timestep.
+   *  For timestepless mode the whole run time is considered as one timestep.
+   */
+  uint64_t previous_wall_actions_total_ = 0;
+
+  /**
+   *  Total number of Pauli-blockings for current timestep.
+   *  For timestepless mode the whole run time is considered as one timestep.
+   */
+  uint64_t total_pauli_blocked_ = 0;
+
+  /**
+   * Scattering finder, which is also in action_finders_, or null if
+   * collisions are disabled
+   */
+  ScatterActionsFinder *scatter_finder_ = nullptr;
+
+  /**
+   * Trace of the pairs checked for collisions and of the performed
+   * collisions, if they are captured
+   */
+  std::unique_ptr<CollisionTrace> collision_trace_;
+
+  /**
+   * Decay finder, which is also in action_finders_, or null if decays are
+   * disabled
+   */
+  const DecayActionsFinder *decay_finder_ = nullptr;
+
+  /**
+   * Finder of the hypersurface crossings for the initial conditions, or null
+   * if they are not extracted. It is not in action_finders_, since the
+   * crossings are found in a single pass over all particles instead of the
+   * cells of the grid.
+   */
+  std::unique_ptr<HyperSurfaceCrossActionsFinder> hypersurface_finder_;
+
+  /**
+   * Counts of the scatterings performed, invalidated or Pauli-blocked in the
+   * current time step. The pairs examined by the finder are added at the end
+   * of the time step.
+   */
+  CollisionFinderStatistics step_collisions_;
+
+  /// Counts of the collision finder summed over the time steps of the event
+  CollisionFinderStatistics event_collisions_;
+
+  /**
+   *  Total number of particles removed from the evolution in
+   *  hypersurface crossing actions.
+   */
+  uint64_t total_hypersurface_crossing_actions_ = 0;
+
+  /**
+   *  Total number of discarded interactions, because they were invalidated
+   *  before they could be performed.
+   */
+  uint64_t discarded_interactions_total_ = 0;
+
+  /**
+   * Total energy removed from the system in hypersurface crossing actions.
+   */
+  double total_energy_removed_ = 0.0;
+
+  /**
+   * Total energy violation introduced by Pythia.
+   */
+  double total_energy_violated_by_Pythia_ = 0.0;
+
+  /// This indicates whether kinematic cuts are enabled for the IC output
+  bool kinematic_cuts_for_IC_output_ = false;
+
+  /// random seed for the next event.
+  int64_t seed_ = -1;
+
+  /// random seed of the current event.
+  int64_t event_seed_ = -1;
+
+  /**
+   * \ingroup logging
+   * Writes the initial state for the Experiment to the output stream.
+   * It automatically appends the output of the current Modus.
    */
   friend std::ostream &operator<<<>(std::ostream &out, const Experiment &e);
 };
@@ -721,21 +1498,63 @@ void Experiment<Modus>::create_output(const std::string &format,
                                       const std::string &content,
                                       const std::filesystem::path &output_path,
                                       const OutputParameters &out_par) {
+  if (deferring_output_to_) {
+    /* An event worker only defers its output, which is then written by the
+     * merger to the output of the coordinating experiment created at the same
+     * position. */
+    outputs_.emplace_back(
+        deferring_output_to_->make_deferred_output(outputs_.size()));
+    if (content == "Thermodynamics") {
+      printout_full_lattice_any_td_ |= format == "Lattice_ASCII" ||
+                                       format == "Lattice_Binary" ||
+                                       format == "Lattice_Chunked" ||
+                                       format == "Lattice_Averaged";
+      printout_lattice_td_ |= format == "VTK" || format == "VTK_XML";
+    }
+    return;
+  }
+  if (content == "Particles" && out_par.part_shards > 1 &&
+      (format == "Oscar1999" || format == "Oscar2013" || format == "Binary" ||
+       format == "Columnar")) {
+    logg[LExperiment].info() << "Adding output " << content << " of format "
+                             << format << " in " << out_par.part_shards
+                             << " shards" << std::endl;
+    OutputsList shards;
+    std::vector<std::filesystem::path> directories;
+    for (int i = 0; i < out_par.part_shards; i++) {
+      directories.push_back(output_path / "Shards" /
+                            (format + "_" + std::to_string(i)));
+      std::filesystem::create_directories(directories.back());
+      if (format == "Binary") {
+        shards.emplace_back(std::make_unique<BinaryOutputParticles>(
+            directories.back(), content, out_par));
+      } else if (format == "Columnar") {
+        shards.emplace_back(std::make_unique<ColumnarOutput>(
+            directories.back(), content, out_par));
+      } else {
+        shards.emplace_back(create_oscar_output(format, content,
+                                                directories.back(), out_par));
+      }
+    }
+    outputs_.emplace_back(std::make_unique<ShardedOutput>(
+        output_path, std::move(shards), std::move(directories)));
+    return;
+  }
   logg[LExperiment].info() << "Adding output " << content << " of format "
                            << format << std::endl;
 
-  if (format == "VTK" && content == "Particles") {
-    outputs_.emplace_back(
-        std::make_unique<VtkOutput>(output_path, content, out_par));
+  if ((format == "VTK" || format == "VTK_XML") && content == "Particles") {
+    outputs_.emplace_back(std::make_unique<VtkOutput>(
+        output_path, content, out_par, format == "VTK_XML"));
   } else if (format == "Root") {
 #ifdef SMASH_USE_ROOT
-    if (content == "Initial_Conditions") {
-      outputs_.emplace_back(
-          std::make_unique<RootOutput>(output_path, "SMASH_IC", out_par));
-    } else {
-      outputs_.emplace_back(
-          std::make_unique<RootOutput>(output_path, content, out_par));
+    OutputPtr output = std::make_unique<RootOutput>(
+        output_path, content == "Initial_Conditions" ? "SMASH_IC" : content,
+        out_par);
+    if (out_par.root_parameters.writer_thread) {
+      output = std::make_unique<AsyncOutput>(std::move(output));
     }
+    outputs_.emplace_back(std::move(output));
 #else
     logg[LExperiment].error(
         "Root output requested, but Root support not compiled in");
@@ -752,6 +1571,9 @@ void Experiment<Modus>::create_output(const std::string &format,
       outputs_.emplace_back(std::make_unique<BinaryOutputInitialConditions>(
           output_path, content, out_par));
     }
+  } else if (format == "Columnar" && content == "Particles") {
+    outputs_.emplace_back(
+        std::make_unique<ColumnarOutput>(output_path, content, out_par));
   } else if (format == "Oscar1999" || format == "Oscar2013") {
     outputs_.emplace_back(
         create_oscar_output(format, content, output_path, out_par));
@@ -759,15 +1581,18 @@ void Experiment<Modus>::create_output(const std::string &format,
     outputs_.emplace_back(
         std::make_unique<ThermodynamicOutput>(output_path, content, out_par));
   } else if (content == "Thermodynamics" &&
-             (format == "Lattice_ASCII" || format == "Lattice_Binary")) {
+             (format == "Lattice_ASCII" || format == "Lattice_Binary" ||
+              format == "Lattice_Chunked" || format == "Lattice_Averaged")) {
     printout_full_lattice_any_td_ = true;
     outputs_.emplace_back(std::make_unique<ThermodynamicLatticeOutput>(
         output_path, content, out_par, format == "Lattice_ASCII",
-        format == "Lattice_Binary"));
-  } else if (content == "Thermodynamics" && format == "VTK") {
+        format == "Lattice_Binary", format == "Lattice_Chunked",
+        format == "Lattice_Averaged"));
+  } else if (content == "Thermodynamics" &&
+             (format == "VTK" || format == "VTK_XML")) {
     printout_lattice_td_ = true;
-    outputs_.emplace_back(
-        std::make_unique<VtkOutput>(output_path, content, out_par));
+    outputs_.emplace_back(std::make_unique<VtkOutput>(
+        output_path, content, out_par, format == "VTK_XML"));
   } else if (content == "Initial_Conditions" && format == "ASCII") {
     outputs_.emplace_back(
         std::make_unique<ICOutput>(output_path, "SMASH_IC", out_par));
@@ -812,9 +1637,13 @@ void Experiment<Modus>::create_output(const std::string &format,
     logg[LExperiment].error(
         "HepMC output requested, but HepMC support not compiled in");
 #endif
-  } else if (content == "Coulomb" && format == "VTK") {
+  } else if (content == "Coulomb" &&
+             (format == "VTK" || format == "VTK_XML")) {
+    outputs_.emplace_back(std::make_unique<VtkOutput>(
+        output_path, "Fields", out_par, format == "VTK_XML"));
+  } else if (content == "Histograms" && format == "YODA") {
     outputs_.emplace_back(
-        std::make_unique<VtkOutput>(output_path, "Fields", out_par));
+        std::make_unique<HistogramOutput>(output_path, content, out_par));
   } else if (content == "Rivet") {
 #ifdef SMASH_USE_RIVET
     // flag to ensure that the Rivet format has not been already assigned
@@ -853,15 +1682,22 @@ void Experiment<Modus>::create_output(const std::string &format,
  * Gathers all general Experiment parameters.
  *
  * \param[inout] config Configuration element
+ * \param[in] communicator If given, the ensembles are distributed over its
+ *            processes as evenly as possible and the parameters hold the
+ *            share of this process.
  * \return The ExperimentParameters struct filled with values from the
  *         Configuration
+ * \throw std::invalid_argument if a process would get no ensemble
  */
-ExperimentParameters create_experiment_parameters(Configuration &config);
+ExperimentParameters create_experiment_parameters(
+    Configuration &config, EnsembleCommunicator *communicator = nullptr);
 
 template <typename Modus>
 Experiment<Modus>::Experiment(Configuration &config,
-                              const std::filesystem::path &output_path)
-    : parameters_(create_experiment_parameters(config)),
+                              const std::filesystem::path &output_path,
+                              const OutputMerger *output_merger,
+                              EnsembleCommunicator *communicator)
+    : parameters_(create_experiment_parameters(config, communicator)),
       density_param_(DensityParameters(parameters_)),
       modus_(std::invoke([&]() {
         /* This immediately invoked lambda is a work-around to cope with the
@@ -900,9 +1736,170 @@ Experiment<Modus>::Experiment(Configuration &config,
           config.take({"Collision_Term", "Photons", "Bremsstrahlung"}, false)),
       IC_output_switch_(config.has_value({"Output", "Initial_Conditions"})),
       time_step_mode_(
-          config.take({"General", "Time_Step_Mode"}, TimeStepMode::Fixed)) {
+          config.take({"General", "Time_Step_Mode"}, TimeStepMode::Fixed)),
+      n_threads_(config.take({"General", "Threads"}, 1)),
+      pin_threads_(config.take({"General", "Pin_Threads"},
+                               InputKeys::gen_pinThreads.default_value())),
+      batch_string_fragmentation_(config.take(
+          {"Collision_Term", "String_Parameters", "Batch_Fragmentation"},
+          false)),
+      ensemble_engines_(parameters_.n_ensembles),
+      ensemble_interactions_(parameters_.n_ensembles),
+      actions_(parameters_.n_ensembles),
+      n_event_workers_(config.take({"General", "Event_Workers"}, 1)),
+      deferring_output_to_(output_merger) {
   logg[LExperiment].info() << *this;
 
+  profile_phases_ = config.take({"General", "Profile"}, false);
+  const bool profile_counters =
+      config.take({"General", "Profile_Counters"}, false);
+  const int trace_events = config.take({"General", "Trace_Events"}, 0);
+  const int trace_max_spans =
+      config.take({"General", "Trace_Max_Spans"}, 1000000);
+  if (trace_events < 0 || trace_max_spans < 0) {
+    throw std::invalid_argument(
+        "The number of traced events and spans must not be negative.");
+  }
+  if (profile_phases_ || trace_events > 0) {
+    profiler_ = std::make_unique<Profiler>(output_path / "profile.json");
+    if (trace_events > 0) {
+      profiler_->enable_trace(output_path / "trace.json", trace_events,
+                              trace_max_spans);
+    }
+    if (profile_phases_ && profile_counters &&
+        !profiler_->enable_counters()) {
+      logg[LExperiment].warn(
+          "The hardware counters of the profiler are not available, e.g. "
+          "because /proc/sys/kernel/perf_event_paranoid does not permit them "
+          "or SMASH was built without perf_event_open. Only the times are "
+          "measured.");
+    }
+  }
+
+  report_memory_ = config.take({"General", "Memory_Report"}, false);
+  const double memory_limit = config.take({"General", "Memory_Limit"}, 0.);
+  if (memory_limit < 0.) {
+    throw std::invalid_argument("The memory limit must not be negative.");
+  }
+  if (report_memory_ || memory_limit > 0.) {
+    // The limit is given in MiB
+    memory_usage_ = std::make_unique<MemoryUsage>(
+        static_cast<std::size_t>(memory_limit * 1024 * 1024));
+  }
+  max_hole_fraction_ = config.take({"General", "Max_Hole_Fraction"}, 1.);
+  if (max_hole_fraction_ < 0. || max_hole_fraction_ > 1.) {
+    throw std::invalid_argument(
+        "The maximal hole fraction must be between 0 and 1.");
+  }
+  particle_sort_interval_ =
+      config.take({"General", "Particle_Sort_Interval"},
+                  InputKeys::gen_particleSortInterval.default_value());
+  if (particle_sort_interval_ < 0) {
+    throw std::invalid_argument(
+        "The particle sort interval must not be negative.");
+  }
+  freeze_out_window_ =
+      config.take({"General", "Freeze_Out_Window"},
+                  InputKeys::gen_freezeOutWindow.default_value());
+  if (freeze_out_window_ < 0.) {
+    throw std::invalid_argument("The freeze-out window must not be negative.");
+  }
+  batch_wall_crossings_ =
+      config.take({"General", "Batch_Wall_Crossings"}, false);
+  speculation_window_ =
+      config.take({"Collision_Term", "Speculation_Window"},
+                  InputKeys::collTerm_speculationWindow.default_value());
+  if (speculation_window_ < 0) {
+    throw std::invalid_argument(
+        "The speculation window must not be negative.");
+  }
+
+  checkpoint_interval_ = config.take({"General", "Checkpoint_Interval"}, 0.);
+  if (checkpoint_interval_ < 0.) {
+    throw std::invalid_argument(
+        "The checkpoint interval must not be negative.");
+  }
+  checkpoint_path_ = output_path / "checkpoint.bin";
+  if (config.has_value({"General", "Restart_From"})) {
+    const std::string restart_from = config.take({"General", "Restart_From"});
+    restart_path_ = restart_from;
+  }
+  if ((checkpoint_interval_ > 0. || !restart_path_.empty()) &&
+      n_event_workers_ > 1) {
+    throw std::invalid_argument(
+        "Checkpoints cannot be used with more than one event worker.");
+  }
+  if (!restart_path_.empty() && modus_.is_list()) {
+    throw std::invalid_argument(
+        "The list modus reads its events from the input files and cannot be "
+        "resumed from a checkpoint.");
+  }
+
+  if (config.has_value({"General", "Ensemble_Fork_Time"})) {
+    ensemble_fork_time_ = config.take({"General", "Ensemble_Fork_Time"});
+    if (!modus_.is_box()) {
+      throw std::invalid_argument(
+          "Only the ensembles of the box modus can be forked.");
+    }
+    if (parameters_.n_ensembles < 2) {
+      throw std::invalid_argument(
+          "Forking the ensembles requires more than one ensemble.");
+    }
+    // The mean field of all ensembles would be missing before the fork
+    if (config.has_value({"Potentials"})) {
+      throw std::invalid_argument(
+          "The ensembles cannot be forked with potentials.");
+    }
+  }
+
+  conservation_check_ = config.take({"General", "Conservation_Check"},
+                                    ConservationCheck::Full);
+  conservation_check_interval_ =
+      config.take({"General", "Conservation_Check_Interval"}, 100);
+  if (conservation_check_interval_ < 1) {
+    throw std::invalid_argument(
+        "The conservation check interval must be positive.");
+  }
+
+  const int max_cell_occupancy =
+      config.take({"Collision_Term", "Max_Cell_Occupancy"},
+                  InputKeys::collTerm_maxCellOccupancy.default_value());
+  min_subcell_length_ =
+      config.take({"Collision_Term", "Min_Subcell_Length"},
+                  InputKeys::collTerm_minSubcellLength.default_value());
+  if (max_cell_occupancy < 0 || min_subcell_length_ <= 0.) {
+    throw std::invalid_argument(
+        "The maximal cell occupancy must not be negative and the minimal "
+        "subcell length must be positive.");
+  }
+  if (max_cell_occupancy > 0 &&
+      parameters_.coll_crit != CollisionCriterion::Stochastic) {
+    throw std::invalid_argument(
+        "Only divide crowded grid cells with the stochastic collision "
+        "criterion.");
+  }
+  max_cell_occupancy_ = max_cell_occupancy;
+
+  collision_search_ =
+      config.take({"Collision_Term", "Collision_Search"},
+                  InputKeys::collTerm_collisionSearch.default_value());
+  const bool sweep_possible =
+      std::is_same_v<ModusGrid, Grid<GridOptions::Normal>> &&
+      parameters_.coll_crit != CollisionCriterion::Stochastic;
+  if (!sweep_possible) {
+    if (collision_search_ == CollisionSearch::Sweep) {
+      throw std::invalid_argument(
+          "The sweep collision search is not possible with periodic "
+          "boundaries or the stochastic collision criterion.");
+    }
+    collision_search_ = CollisionSearch::Grid;
+  }
+  if (collision_search_ != CollisionSearch::Grid) {
+    sweeps_.resize(parameters_.n_ensembles);
+  }
+  timestepless_grids_.resize(parameters_.n_ensembles);
+  particle_extents_.resize(parameters_.n_ensembles);
+
   if (config.has_value({"General", "Minimum_Nonempty_Ensembles"})) {
     if (config.has_value({"General", "Nevents"})) {
       throw std::invalid_argument(
@@ -927,6 +1924,16 @@ Experiment<Modus>::Experiment(Configuration &config,
         "smearing!");
   }
 
+  // smearing by Fourier transforms needs a kernel of fixed shape and takes
+  // the spatial derivatives as finite differences
+  if (parameters_.fft_smearing &&
+      (parameters_.smearing_mode == SmearingMode::Discrete ||
+       parameters_.derivatives_mode == DerivativesMode::CovariantGaussian)) {
+    throw std::invalid_argument(
+        "FFT_Smearing only works with Covariant Gaussian or Triangular "
+        "smearing and Finite difference derivatives!");
+  }
+
   // for triangular smearing:
   // the weight needs to be larger than 1./7. for the center cell to contribute
   // more than the surrounding cells
@@ -948,6 +1955,23 @@ Experiment<Modus>::Experiment(Configuration &config,
         "The box modus can only be used with the fixed time step mode!");
   }
 
+  if (time_step_mode_ == TimeStepMode::Adaptive) {
+    min_delta_time_ =
+        config.take({"General", "Min_Delta_Time"}, delta_time_startup_);
+    max_delta_time_ =
+        config.take({"General", "Max_Delta_Time"}, 10. * delta_time_startup_);
+    if (min_delta_time_ <= 0. || max_delta_time_ < min_delta_time_) {
+      throw std::invalid_argument(
+          "The smallest time step must be positive and not larger than the "
+          "largest one.");
+    }
+  } else if (config.has_value({"General", "Min_Delta_Time"}) ||
+             config.has_value({"General", "Max_Delta_Time"})) {
+    throw std::invalid_argument(
+        "Only use Min_Delta_Time and Max_Delta_Time with the adaptive time "
+        "step mode.");
+  }
+
   logg[LExperiment].info("Using ", parameters_.testparticles,
                          " testparticles per particle.");
   logg[LExperiment].info("Using ", parameters_.n_ensembles,
@@ -995,6 +2019,7 @@ Experiment<Modus>::Experiment(Configuration &config,
   if (photons_switch_ || bremsstrahlung_switch_) {
     n_fractional_photons_ =
         config.take({"Collision_Term", "Photons", "Fractional_Photons"}, 100);
+    photon_channels_ = std::make_unique<PhotonChannels>();
   }
   if (parameters_.two_to_one) {
     if (parameters_.res_lifetime_factor < 0.) {
@@ -1008,27 +2033,79 @@ Experiment<Modus>::Experiment(Configuration &config,
           "inelastically (e.g. resonance chains), else SMASH is known to "
           "hang.");
     }
-    action_finders_.emplace_back(std::make_unique<DecayActionsFinder>(
-        parameters_.res_lifetime_factor, parameters_.do_weak_decays));
+    auto decay_finder = std::make_unique<DecayActionsFinder>(
+        parameters_.res_lifetime_factor, parameters_.do_weak_decays);
+    decay_finder_ = decay_finder.get();
+    action_finders_.emplace_back(std::move(decay_finder));
   }
+  const bool freeze_spectators =
+      config.take({"Collision_Term", "Freeze_Spectators"},
+                  InputKeys::collTerm_freezeSpectators.default_value());
+  const bool freeze_escaping_particles =
+      config.take({"Collision_Term", "Freeze_Escaping_Particles"},
+                  InputKeys::collTerm_freezeEscapingParticles.default_value());
   bool no_coll = config.take({"Collision_Term", "No_Collisions"}, false);
   if ((parameters_.two_to_one || parameters_.included_2to2.any() ||
        parameters_.included_multi.any() || parameters_.strings_switch) &&
       !no_coll) {
     parameters_.use_monash_tune_default =
         (modus_.is_collider() && modus_.sqrt_s_NN() >= 200.);
+    if (freeze_spectators && modus_.is_collider()) {
+      if (parameters_.coll_crit == CollisionCriterion::Stochastic) {
+        logg[LExperiment].warn(
+            "Spectators are not frozen with the stochastic collision "
+            "criterion, which does not limit the distance of colliding "
+            "particles within a cell.");
+      } else {
+        const bool collisions_within_nucleus = config.read(
+            {"Modi", "Collider", "Collisions_Within_Nucleus"},
+            InputKeys::modi_collider_collisionWithinNucleus.default_value());
+        frozen_spectators_.assign(parameters_.n_ensembles,
+                                  FrozenSpectators(collisions_within_nucleus));
+      }
+    }
+    if (freeze_escaping_particles && modus_.is_collider()) {
+      if (parameters_.coll_crit == CollisionCriterion::Stochastic) {
+        logg[LExperiment].warn(
+            "Escaping particles are not frozen with the stochastic collision "
+            "criterion, which does not limit the distance of colliding "
+            "particles within a cell.");
+      } else {
+        escaped_particles_.resize(parameters_.n_ensembles);
+      }
+    }
+    /* With the stochastic criterion, particles in a cell of any size may
+     * collide, hence they are never out of reach. */
+    detect_separated_nuclei_ =
+        modus_.is_collider() &&
+        parameters_.coll_crit != CollisionCriterion::Stochastic &&
+        !config.read(
+            {"Modi", "Collider", "Collisions_Within_Nucleus"},
+            InputKeys::modi_collider_collisionWithinNucleus.default_value());
     auto scat_finder =
         std::make_unique<ScatterActionsFinder>(config, parameters_);
     max_transverse_distance_sqr_ =
         scat_finder->max_transverse_distance_sqr(parameters_.testparticles);
     process_string_ptr_ = scat_finder->get_process_string_ptr();
+    scatter_finder_ = scat_finder.get();
     action_finders_.emplace_back(std::move(scat_finder));
   } else {
     max_transverse_distance_sqr_ =
         parameters_.maximum_cross_section / M_PI * fm2_mb;
     process_string_ptr_ = NULL;
   }
-  if (modus_.is_box()) {
+  if (config.take({"General", "Capture_Collisions"}, false)) {
+    if (!scatter_finder_ || n_event_workers_ > 1) {
+      throw std::invalid_argument(
+          "Collisions can only be captured if they are enabled and with a "
+          "single event worker.");
+    }
+    collision_trace_ = std::make_unique<CollisionTrace>(
+        output_path / "collisions.trace", ParticleData::formation_power_,
+        parameters_.use_monash_tune_default.value_or(false));
+    scatter_finder_->set_collision_trace(collision_trace_.get());
+  }
+  if (modus_.is_box() && !batch_wall_crossings_) {
     action_finders_.emplace_back(
         std::make_unique<WallCrossActionsFinder>(parameters_.box_length));
   }
@@ -1117,9 +2194,8 @@ Experiment<Modus>::Experiment(Configuration &config,
           << "Extracting initial conditions without kinematic cuts.";
     }
 
-    action_finders_.emplace_back(
-        std::make_unique<HyperSurfaceCrossActionsFinder>(
-            proper_time, rapidity_cut, transverse_momentum_cut));
+    hypersurface_finder_ = std::make_unique<HyperSurfaceCrossActionsFinder>(
+        proper_time, rapidity_cut, transverse_momentum_cut);
   }
 
   if (config.has_value({"Collision_Term", "Pauli_Blocking"})) {
@@ -1129,6 +2205,54 @@ Experiment<Modus>::Experiment(Configuration &config,
         parameters_);
   }
 
+  if (n_threads_ < 1) {
+    throw std::invalid_argument("The number of threads must be positive.");
+  }
+  if (n_threads_ > 1) {
+    if (pauli_blocker_ && parameters_.n_ensembles > 1) {
+      throw std::invalid_argument(
+          "Pauli blocking couples the ensembles at every action and cannot be "
+          "used with more than one thread.");
+    }
+    /* The same threads evolve the ensembles, search the cells of a single
+     * ensemble, fragment strings, sample thermal momenta, update the
+     * lattices and compute the lattice outputs, so all of them are used even
+     * with fewer ensembles. */
+    logg[LExperiment].info("Using ", n_threads_,
+                           " threads to evolve the ensembles.");
+    // All lazily evaluated quantities must be ready before threads start
+    ParticleType::initialize_lazy_members();
+    thread_pool_ = std::make_unique<ThreadPool>(n_threads_, pin_threads_);
+    modus_.set_thread_pool(thread_pool_.get());
+  }
+
+  if (n_event_workers_ < 1) {
+    throw std::invalid_argument("The number of event workers must be positive.");
+  }
+  if (n_event_workers_ > 1) {
+    if (modus_.is_list()) {
+      throw std::invalid_argument(
+          "The events of the list modus are read one after another from the "
+          "input files and cannot be generated by more than one event worker.");
+    }
+    if (config.has_value({"Forced_Thermalization"})) {
+      throw std::invalid_argument(
+          "Forced thermalization cannot be used with more than one event "
+          "worker.");
+    }
+    if (pin_threads_) {
+      // The pools of all workers would bind their threads to the same CPUs
+      throw std::invalid_argument(
+          "Pinned threads cannot be used with more than one event worker.");
+    }
+    if (!deferring_output_to_) {
+      logg[LExperiment].info("Using ", n_event_workers_,
+                             " workers to generate events concurrently.");
+      // All lazily evaluated quantities must be ready before workers start
+      ParticleType::initialize_lazy_members();
+    }
+  }
+
   /*!\Userguide
    * \page doxypage_output
    *
@@ -1165,7 +2289,8 @@ Experiment<Modus>::Experiment(Configuration &config,
    *   - Available formats: \ref doxypage_output_oscar_particles,
    *                        \ref doxypage_output_binary, \ref
    *                        doxypage_output_root, \ref doxypage_output_vtk, \ref
-   *                        doxypage_output_hepmc
+   *                        doxypage_output_hepmc, \ref
+   *                        doxypage_output_columnar
    * - \b Collisions List of interactions: collisions, decays, box wall
    *                 crossings and forced thermalizations. Information about
    *                 incoming, outgoing particles and the interaction itself
@@ -1197,6 +2322,10 @@ Experiment<Modus>::Experiment(Configuration &config,
    *            results, see \ref doxypage_output_rivet for
    *            details.
    *    - Available formats: \ref doxypage_output_rivet
+   * - \b Histograms Histograms of the final particles and of the
+   *                 interactions over all events, see
+   *                 \ref doxypage_output_histograms for details.
+   *    - Available formats: \ref doxypage_output_histograms
    *
    *
    * \n
@@ -1216,6 +2345,11 @@ Experiment<Modus>::Experiment(Configuration &config,
    *   - Saves coordinates and momenta with the full double precision
    *   - General file structure is similar to \ref doxypage_output_oscar
    *   - Detailed description: \ref doxypage_output_binary
+   * - \b "Columnar" - binary output of the "Particles" content, which is
+   *     written column by column
+   *   - Single quantities like the momenta can be read without reading the
+   *     whole particle records
+   *   - Format description: \ref doxypage_output_columnar
    * - \b "Root" - binary output in the format used by ROOT software
    *     (http://root.cern.ch)
    *   - Even faster to read and write, requires less disk space
@@ -1225,6 +2359,18 @@ Experiment<Modus>::Experiment(Configuration &config,
    *   - This output can be opened by paraview to see the visulalization.
    *   - For "Particles" content \ref doxypage_output_vtk
    *   - For "Thermodynamics" content \ref doxypage_output_vtk_lattice
+   * - \b "VTK_XML" - binary output of the same contents as "VTK" in the VTK
+   *     XML format
+   *   - Much faster to write and read for paraview than "VTK"
+   *   - Optionally compressed with \key Compress_Files
+   *   - A `.pvd` file per event lists the files of the event as time series
+   *   - Format description: \ref doxypage_output_vtk
+   * - \b "Lattice_ASCII", \b "Lattice_Binary", \b "Lattice_Chunked",
+   *   \b "Lattice_Averaged" - "Thermodynamics" content on the whole lattice,
+   *     where the chunked binary format only stores the nodes changed since
+   *     the previous output and the averaged format only writes the average
+   *     over all events at the end of the run,
+   *     see \ref doxypage_output_thermodyn_lattice
    * - \b "ASCII" - a human-readable text-format table of values
    *   - Used for "Thermodynamics" and "Initial_Conditions", see
    * \ref doxypage_output_thermodyn
@@ -1233,7 +2379,8 @@ Experiment<Modus>::Experiment(Configuration &config,
    * - \b "HepMC_asciiv3", \b "HepMC_treeroot" - HepMC3 human-readble asciiv3 or
    *   Tree ROOT format see \ref doxypage_output_hepmc for details
    * - \b "YODA", \b "YODA-full" - compact ASCII text format used by the
-   *   Rivet output, see \ref doxypage_output_rivet for details
+   *   Rivet output, see \ref doxypage_output_rivet for details, and by the
+   *   histogram output, see \ref doxypage_output_histograms
    *
    * \note Output of coordinates for the "Collisions" content in
    *       the periodic box has a feature:
@@ -1374,6 +2521,64 @@ Experiment<Modus>::Experiment(Configuration &config,
   dens_type_ = config.take({"Output", "Density_Type"}, DensityType::None);
   logg[LExperiment].debug()
       << "Density type printed to headers: " << dens_type_;
+  const bool asynchronous_writing =
+      config.take({"Output", "Asynchronous_Writing"},
+                  InputKeys::output_asynchronousWriting.default_value());
+  const bool overlap_events =
+      config.take({"Output", "Overlap_Events"},
+                  InputKeys::output_overlapEvents.default_value());
+  if (overlap_events && !asynchronous_writing) {
+    throw std::invalid_argument(
+        "Overlapping the output of the events needs asynchronous writing.");
+  }
+  bool compress_files =
+      config.take({"Output", "Compress_Files"},
+                  InputKeys::output_compressFiles.default_value());
+  if (compress_files && !RenamingFilePtr::compression_supported()) {
+    logg[LExperiment].error(
+        "Compressed output files requested, but zlib support not compiled in. "
+        "The files are written uncompressed.");
+    compress_files = false;
+  }
+  const bool binary_event_index =
+      config.take({"Output", "Binary_Event_Index"},
+                  InputKeys::output_binaryEventIndex.default_value());
+  RootOutputParameters root_parameters;
+  root_parameters.basket_size =
+      config.take({"Output", "Root_Basket_Size"},
+                  InputKeys::output_rootBasketSize.default_value());
+  root_parameters.auto_flush =
+      config.take({"Output", "Root_Auto_Flush"},
+                  InputKeys::output_rootAutoFlush.default_value());
+  const std::string root_compression =
+      config.take({"Output", "Root_Compression"},
+                  InputKeys::output_rootCompression.default_value());
+  const int root_compression_level =
+      config.take({"Output", "Root_Compression_Level"},
+                  InputKeys::output_rootCompressionLevel.default_value());
+  // numbers of the algorithms in the compression settings of ROOT
+  const std::map<std::string, int> root_algorithms = {
+      {"ZLIB", 1}, {"LZMA", 2}, {"LZ4", 4}, {"ZSTD", 5}};
+  const auto root_algorithm = root_algorithms.find(root_compression);
+  if (root_algorithm == root_algorithms.end()) {
+    throw std::invalid_argument("Unknown compression algorithm \"" +
+                                root_compression + "\" for the ROOT output.");
+  }
+  if (root_compression_level < 0 || root_compression_level > 9) {
+    throw std::invalid_argument(
+        "The compression level of the ROOT output must be between 0 and 9.");
+  }
+  root_parameters.compression_settings =
+      100 * root_algorithm->second + root_compression_level;
+  root_parameters.implicit_mt_threads =
+      config.take({"Output", "Root_Implicit_MT"},
+                  InputKeys::output_rootImplicitMT.default_value());
+  /* The ROOT outputs need to know whether they are used from other threads
+   * than the one they were created in. */
+  root_parameters.writer_thread =
+      asynchronous_writing ||
+      config.take({"Output", "Root_Writer_Thread"},
+                  InputKeys::output_rootWriterThread.default_value());
 
   /* Parse configuration about output contents and formats, doing all logical
    * checks about specified formats, creating all needed output objects. */
@@ -1409,8 +2614,14 @@ Experiment<Modus>::Experiment(Configuration &config,
         return output_conf.take({content.c_str(), "Format"},
                                 std::vector<std::string>{});
       });
-  const OutputParameters output_parameters(std::move(output_conf));
+  OutputParameters output_parameters(std::move(output_conf));
+  output_parameters.compress_files = compress_files;
+  output_parameters.binary_event_index = binary_event_index;
+  output_parameters.thread_pool = thread_pool_.get();
+  output_parameters.root_parameters = root_parameters;
   std::size_t total_number_of_requested_formats = 0;
+  // Content of every output, in the order they are created
+  std::vector<std::string> content_of_outputs;
   auto abort_because_of_invalid_input_file = []() {
     throw std::invalid_argument("Invalid configuration input file.");
   };
@@ -1454,6 +2665,7 @@ Experiment<Modus>::Experiment(Configuration &config,
     }
     for (const auto &format : list_of_formats[i]) {
       create_output(format, output_contents[i], output_path, output_parameters);
+      content_of_outputs.push_back(output_contents[i]);
       ++total_number_of_requested_formats;
     }
   }
@@ -1462,6 +2674,39 @@ Experiment<Modus>::Experiment(Configuration &config,
         << "At least one invalid output format has been provided.";
     abort_because_of_invalid_input_file();
   }
+  /* Event workers only record their output, which is written by the outputs
+   * of the coordinating experiment. */
+  if (asynchronous_writing && !deferring_output_to_) {
+    for (OutputPtr &output : outputs_) {
+      // the ROOT outputs might have a writer thread already
+      if (!dynamic_cast<AsyncOutput *>(output.get())) {
+        output = std::make_unique<AsyncOutput>(std::move(output));
+      }
+      if (overlap_events) {
+        auto *async_output = static_cast<AsyncOutput *>(output.get());
+        async_output->overlap_events();
+        overlapping_outputs_.push_back(async_output);
+      }
+    }
+  }
+  /* The filters come first, such that the other outputs do not even copy
+   * what is filtered out. Event workers pass everything on to the filters of
+   * the coordinating experiment. */
+  if (!deferring_output_to_) {
+    for (std::size_t i = 0; i < outputs_.size(); i++) {
+      const std::string &content = content_of_outputs[i];
+      if (content != "Particles" && content != "Collisions") {
+        continue;
+      }
+      const OutputFilter &filter = content == "Particles"
+                                       ? output_parameters.part_filter
+                                       : output_parameters.coll_filter;
+      if (filter.is_active()) {
+        outputs_[i] = std::make_unique<FilteredOutput>(
+            std::move(outputs_[i]), filter, parameters_.n_ensembles_total);
+      }
+    }
+  }
 
   /* We can take away the Fermi motion flag, because the collider modus is
    * already initialized. We only need it when potentials are enabled, but we
@@ -1610,6 +2855,10 @@ Experiment<Modus>::Experiment(Configuration &config,
                                << parameters_.triangular_range;
       break;
   }
+  if (parameters_.fft_smearing) {
+    logg[LExperiment].info()
+        << "Densities on the lattice are smeared by Fourier transforms";
+  }
 
   // Create lattices
   if (config.has_value({"Lattice"})) {
@@ -1696,6 +2945,38 @@ Experiment<Modus>::Experiment(Configuration &config,
         << "), number of cells = (" << n[0] << "," << n[1] << "," << n[2]
         << "), periodic = " << std::boolalpha << periodic;
 
+    const int potentials_update_interval = config.take(
+        {"Lattice", "Potentials_Update_Interval"},
+        InputKeys::lattice_potentialsUpdateInterval.default_value());
+    const double potentials_update_threshold = config.take(
+        {"Lattice", "Potentials_Update_Threshold"},
+        InputKeys::lattice_potentialsUpdateThreshold.default_value());
+    const bool interpolate_potentials =
+        config.take({"Lattice", "Interpolate_Potentials"},
+                    InputKeys::lattice_interpolatePotentials.default_value());
+    const bool potentials_update_single_precision = config.take(
+        {"Lattice", "Potentials_Update_Single_Precision"},
+        InputKeys::lattice_potentialsUpdateSinglePrecision.default_value());
+    if (potentials_ && potentials_update_interval != 1 &&
+        (potentials_->use_skyrme() || potentials_->use_symmetry() ||
+         potentials_->use_vdf() || potentials_->use_coulomb())) {
+      potentials_refresh_ = std::make_unique<PotentialsRefresh>(
+          potentials_update_interval, potentials_update_threshold);
+      // The histories are only filled if the potentials are extrapolated
+      auto use_precision = [&](auto &history) {
+        history = std::decay_t<decltype(history)>(
+            potentials_update_single_precision);
+      };
+      use_precision(UB_history_);
+      use_precision(UI3_history_);
+      use_precision(FB_history_);
+      use_precision(FI3_history_);
+      use_precision(EM_history_);
+      logg[LExperiment].info()
+          << "Potentials are updated at least every "
+          << potentials_update_interval << " time steps";
+    }
+
     if (printout_lattice_td_ || printout_full_lattice_any_td_) {
       dens_type_lattice_printout_ = output_parameters.td_dens_type;
       printout_rho_eckart_ = output_parameters.td_rho_eckart;
@@ -1704,6 +2985,9 @@ Experiment<Modus>::Experiment(Configuration &config,
       printout_v_landau_ = output_parameters.td_v_landau;
       printout_j_QBS_ = output_parameters.td_jQBS;
     }
+    if (pauli_blocker_ && pauli_blocker_->uses_lattice()) {
+      pauli_blocker_->create_lattice(l, n, origin, periodic);
+    }
     if (printout_tmn_ || printout_tmn_landau_ || printout_v_landau_) {
       Tmn_ = std::make_unique<RectangularLattice<EnergyMomentumTensor>>(
           l, n, origin, periodic, LatticeUpdate::AtOutput);
@@ -1730,8 +3014,7 @@ Experiment<Modus>::Experiment(Configuration &config,
             l, n, origin, periodic, LatticeUpdate::EveryTimestep);
         UB_lat_ = std::make_unique<RectangularLattice<FourVector>>(
             l, n, origin, periodic, LatticeUpdate::EveryTimestep);
-        FB_lat_ = std::make_unique<
-            RectangularLattice<std::pair<ThreeVector, ThreeVector>>>(
+        FB_lat_ = std::make_unique<ForceLattice>(
             l, n, origin, periodic, LatticeUpdate::EveryTimestep);
       }
       if (potentials_->use_symmetry()) {
@@ -1739,24 +3022,25 @@ Experiment<Modus>::Experiment(Configuration &config,
             l, n, origin, periodic, LatticeUpdate::EveryTimestep);
         UI3_lat_ = std::make_unique<RectangularLattice<FourVector>>(
             l, n, origin, periodic, LatticeUpdate::EveryTimestep);
-        FI3_lat_ = std::make_unique<
-            RectangularLattice<std::pair<ThreeVector, ThreeVector>>>(
+        FI3_lat_ = std::make_unique<ForceLattice>(
             l, n, origin, periodic, LatticeUpdate::EveryTimestep);
       }
       if (potentials_->use_coulomb()) {
         jmu_el_lat_ = std::make_unique<DensityLattice>(
             l, n, origin, periodic, LatticeUpdate::EveryTimestep);
-        EM_lat_ = std::make_unique<
-            RectangularLattice<std::pair<ThreeVector, ThreeVector>>>(
+        EM_lat_ = std::make_unique<ForceLattice>(
             l, n, origin, periodic, LatticeUpdate::EveryTimestep);
+        if (potentials_->coulomb_use_fft()) {
+          em_field_solver_ = std::make_unique<EMFieldSolver>(
+              *jmu_el_lat_, potentials_->coulomb_r_cut());
+        }
       }
       if (potentials_->use_vdf()) {
         jmu_B_lat_ = std::make_unique<DensityLattice>(
             l, n, origin, periodic, LatticeUpdate::EveryTimestep);
         UB_lat_ = std::make_unique<RectangularLattice<FourVector>>(
             l, n, origin, periodic, LatticeUpdate::EveryTimestep);
-        FB_lat_ = std::make_unique<
-            RectangularLattice<std::pair<ThreeVector, ThreeVector>>>(
+        FB_lat_ = std::make_unique<ForceLattice>(
             l, n, origin, periodic, LatticeUpdate::EveryTimestep);
       }
       if (parameters_.field_derivatives_mode == FieldDerivativesMode::Direct) {
@@ -1775,6 +3059,17 @@ Experiment<Modus>::Experiment(Configuration &config,
         fields_lat_ = std::make_unique<FieldsLattice>(
             l, n, origin, periodic, LatticeUpdate::EveryTimestep);
       }
+      // the potentials and forces at a position share their nodes
+      auto interpolate = [interpolate_potentials](auto &lat) {
+        if (lat) {
+          lat->set_interpolated(interpolate_potentials);
+        }
+      };
+      interpolate(UB_lat_);
+      interpolate(UI3_lat_);
+      interpolate(FB_lat_);
+      interpolate(FI3_lat_);
+      interpolate(EM_lat_);
     }
     if (dens_type_lattice_printout_ == DensityType::Baryon && !jmu_B_lat_) {
       jmu_B_lat_ = std::make_unique<DensityLattice>(l, n, origin, periodic,
@@ -1791,6 +3086,29 @@ Experiment<Modus>::Experiment(Configuration &config,
       jmu_custom_lat_ = std::make_unique<DensityLattice>(
           l, n, origin, periodic, LatticeUpdate::AtOutput);
     }
+    /* Only the particles fill the density lattices, which thus only need to
+     * be reset where they reach. The finite difference derivatives are
+     * written to all nodes of the lattices of the potentials, though. */
+    const bool finite_differences =
+        parameters_.derivatives_mode == DerivativesMode::FiniteDifference;
+    for (DensityLattice *lat : {jmu_B_lat_.get(), jmu_I3_lat_.get(),
+                                jmu_el_lat_.get(), jmu_custom_lat_.get()}) {
+      if (lat && !(finite_differences && lat != jmu_el_lat_.get() &&
+                   lat->when_update() == LatticeUpdate::EveryTimestep)) {
+        lat->set_sparse(true);
+      }
+    }
+    if (Tmn_) {
+      Tmn_->set_sparse(true);
+    }
+    /* The potentials vanish with the densities, so they are only evaluated
+     * on the tiles, which the particles reach. The extrapolation of the
+     * potentials between their updates and the fields of the direct VDF
+     * derivatives reach beyond them, though. */
+    if (jmu_B_lat_ && jmu_B_lat_->sparse() && !potentials_refresh_ &&
+        parameters_.field_derivatives_mode != FieldDerivativesMode::Direct) {
+      for_each_potential_lattice([](auto &lat) { lat.set_sparse(true); });
+    }
   } else if (printout_lattice_td_ || printout_full_lattice_any_td_) {
     logg[LExperiment].error(
         "If you want Therm. VTK or Lattice output, configure a lattice for "
@@ -1800,6 +3118,12 @@ Experiment<Modus>::Experiment(Configuration &config,
         "Coulomb potential requires a lattice. Please add one to the "
         "configuration");
   }
+  if (pauli_blocker_ && pauli_blocker_->uses_lattice() &&
+      !pauli_blocker_->has_lattice()) {
+    throw std::invalid_argument(
+        "Pauli blocking on the lattice requires a lattice. Please add one to "
+        "the configuration.");
+  }
 
   // Warning for the mean field calculation if lattice is not on.
   if ((potentials_ != nullptr) && (jmu_B_lat_ == nullptr)) {
@@ -1828,6 +3152,63 @@ Experiment<Modus>::Experiment(Configuration &config,
     thermalizer_ = modus_.create_grandcan_thermalizer(th_conf);
   }
 
+  if (parameters_.ensemble_communicator) {
+    /* The processes evolve their ensembles in lockstep and only share the
+     * densities on the lattices. */
+    if (n_event_workers_ > 1 || thermalizer_ || pauli_blocker_ ||
+        modus_.pregenerates_events()) {
+      throw std::invalid_argument(
+          "Event workers, forced thermalization, Pauli blocking and "
+          "pregenerated events cannot be used with the ensembles distributed "
+          "over several processes.");
+    }
+    if (event_counting_ != EventCounting::FixedNumber ||
+        time_step_mode_ == TimeStepMode::Adaptive ||
+        std::isfinite(ensemble_fork_time_)) {
+      throw std::invalid_argument(
+          "A minimum number of non-empty ensembles, adaptive time steps and "
+          "forking the ensembles need all ensembles in one process.");
+    }
+    if (checkpoint_interval_ > 0. || !restart_path_.empty()) {
+      throw std::invalid_argument(
+          "Checkpoints cannot be used with the ensembles distributed over "
+          "several processes.");
+    }
+    if (potentials_ && !jmu_B_lat_) {
+      throw std::invalid_argument(
+          "Potentials need a lattice to couple ensembles in different "
+          "processes. Please add one to the configuration.");
+    }
+    logg[LExperiment].info("Evolving the ensembles ",
+                           parameters_.first_ensemble, " to ",
+                           parameters_.first_ensemble +
+                               parameters_.n_ensembles - 1,
+                           " of ", parameters_.n_ensembles_total,
+                           " in this process.");
+  }
+
+  /* After the freeze-out the particles only stream freely, which nothing else
+   * may change until the end time. */
+  if (freeze_out_window_ > 0. &&
+      (potentials_ || thermalizer_ || modus_.is_box() || IC_output_switch_ ||
+       metric_.mode_ != ExpansionMode::NoExpansion || !force_decays_ ||
+       parameters_.ensemble_communicator)) {
+    throw std::invalid_argument(
+        "A freeze-out window cannot be used with potentials, forced "
+        "thermalization, a box, the initial conditions output, an expanding "
+        "metric or ensembles distributed over several processes, and needs "
+        "the decays forced at the end.");
+  }
+
+  if (const auto criterion = modus_.equilibrium_criterion()) {
+    if (parameters_.ensemble_communicator) {
+      throw std::invalid_argument(
+          "Stopping at the equilibrium cannot be used with ensembles "
+          "distributed over several processes.");
+    }
+    equilibration_monitor_.emplace(*criterion);
+  }
+
   /* Take the seed setting only after the configuration was stored to a file
    * in smash.cc */
   seed_ = config.take({"General", "Randomseed"});
@@ -1839,10 +3220,10 @@ const std::string hline(113, '-');
 /**
  * Generate a string which will be printed to the screen when SMASH is running
  *
- * \param[in] ensembles The simulated particles: one Particles object per
- *            ensemble. The information about particles is used to check the
- *            conservation of the total energy and momentum as well as print
- *            other useful information.
+ * \param[in] current_values Current quantum numbers of all ensembles, which
+ *            are compared to the initial ones to check the conservation of the
+ *            total energy and momentum.
+ * \param[in] total_particles Current number of particles in all ensembles.
  * \param[in] scatterings_this_interval Number of the scatterings occur within
  *            the current timestep.
  * \param[in] conserved_initial Initial quantum numbers needed to check the
@@ -1860,7 +3241,8 @@ const std::string hline(113, '-');
  *         scatterings that occurred within the timestep', 'Total particle
  *         number', 'Computing time consumed'.
  */
-std::string format_measurements(const std::vector<Particles> &ensembles,
+std::string format_measurements(const QuantumNumbers &current_values,
+                                int total_particles,
                                 uint64_t scatterings_this_interval,
                                 const QuantumNumbers &conserved_initial,
                                 SystemTimePoint time_start, double time,
@@ -1882,8 +3264,7 @@ std::string format_measurements(const std::vector<Particles> &ensembles,
 double calculate_mean_field_energy(
     const Potentials &potentials,
     RectangularLattice<smash::DensityOnLattice> &jmu_B_lat,
-    RectangularLattice<std::pair<ThreeVector, ThreeVector>> *em_lattice,
-    const ExperimentParameters &parameters);
+    ForceLattice *em_lattice, const ExperimentParameters &parameters);
 
 /**
  * Generate the EventInfo object which is passed to outputs_.
@@ -1894,6 +3275,7 @@ double calculate_mean_field_energy(
  * \param[in] E_mean_field Value of the mean-field contribution to the total
  *            energy of the system at the current time.
  * \param[in] modus_impact_parameter The impact parameter
+ * \param[in] event_weight Weight of the event
  * \param[in] parameters structure that holds various global parameters
  *            such as testparticle number, see \ref ExperimentParameters
  * \param[in] projectile_target_interact true if there was at least one
@@ -1903,28 +3285,38 @@ double calculate_mean_field_energy(
  */
 EventInfo fill_event_info(const std::vector<Particles> &ensembles,
                           double E_mean_field, double modus_impact_parameter,
+                          double event_weight,
                           const ExperimentParameters &parameters,
                           bool projectile_target_interact,
                           bool kinematic_cut_for_SMASH_IC);
 
 template <typename Modus>
 void Experiment<Modus>::initialize_new_event() {
+  if (profiler_) {
+    profiler_->start_event(event_);
+  }
+  const Profiler::ScopedTimer timer(profiler_.get(),
+                                    Profiler::Phase::Initialization);
+  event_seed_ = seed_;
   random::set_seed(seed_);
   logg[LExperiment].info() << "random number seed: " << seed_;
+  /* Every ensemble evolves with its own random stream such that the results
+   * do not depend on the number of threads. Stream 0 is the main one. */
+  for (int i_ens = 0; i_ens < parameters_.n_ensembles; i_ens++) {
+    ensemble_engines_[i_ens].seed(seed_,
+                                  parameters_.first_ensemble + i_ens + 1);
+  }
   /* Set seed for the next event. It has to be positive, so it can be entered
    * in the config.
    *
    * We have to be careful about the minimal integer, whose absolute value
    * cannot be represented. */
-  int64_t r = random::advance();
-  while (r == INT64_MIN) {
-    r = random::advance();
-  }
-  seed_ = std::abs(r);
+  seed_ = draw_next_event_seed();
   /* Set the random seed used in PYTHIA hadronization
    * to be same with the SMASH one.
    * In this way we ensure that the results are reproducible
-   * for every event if one knows SMASH random seed. */
+   * for every event if one knows SMASH random seed. Note that it is set again
+   * from the current random stream for every string process. */
   if (process_string_ptr_ != NULL) {
     process_string_ptr_->init_pythia_hadron_rndm();
   }
@@ -1932,6 +3324,30 @@ void Experiment<Modus>::initialize_new_event() {
   for (Particles &particles : ensembles_) {
     particles.reset();
   }
+  if (pauli_blocker_) {
+    pauli_blocker_->clear_index();
+  }
+  if (potentials_refresh_) {
+    potentials_refresh_->reset();
+    for_each_potentials_history(
+        [](auto &, auto &history) { history.clear(); });
+  }
+  // Grids of the last event do not fit the new one
+  grids_.clear();
+  grids_.resize(parameters_.n_ensembles);
+  particle_extents_.assign(parameters_.n_ensembles, std::nullopt);
+  steps_since_particle_sort_ = 0;
+  last_collision_time_ = 0.;
+  if (equilibration_monitor_) {
+    equilibration_monitor_->reset();
+  }
+  equilibrium_time_.reset();
+  // The automatic search starts with the grid and tries the sweep next
+  step_search_ = collision_search_ == CollisionSearch::Sweep
+                     ? CollisionSearch::Sweep
+                     : CollisionSearch::Grid;
+  search_probe_ = false;
+  steps_since_search_probe_ = search_probe_interval - 1;
 
   // Sample particles according to the initial conditions
   double start_time = -1.0;
@@ -1939,13 +3355,28 @@ void Experiment<Modus>::initialize_new_event() {
   // Sample impact parameter only once per all ensembles
   // It should be the same for all ensembles
   if (modus_.is_collider()) {
+    modus_.prepare_event(event_seed_, parameters_.n_ensembles);
     modus_.sample_impact();
     logg[LExperiment].info("Impact parameter = ", modus_.impact_parameter(),
                            " fm");
   }
-  for (Particles &particles : ensembles_) {
-    start_time = modus_.initial_conditions(&particles, parameters_);
+  /* The impact parameter is shared, but the other processes, over which the
+   * ensembles are distributed, sample their initial states from main streams
+   * of their own after the ones of the ensembles. */
+  if (parameters_.ensemble_communicator &&
+      parameters_.ensemble_communicator->rank() > 0) {
+    random::engine.seed(event_seed_,
+                        parameters_.n_ensembles_total +
+                            parameters_.ensemble_communicator->rank());
   }
+  /* Until the ensembles are forked, only the first one is sampled and
+   * evolved, the others stay empty. */
+  ensembles_forked_ = std::isinf(ensemble_fork_time_);
+  const int n_sampled = ensembles_forked_ ? parameters_.n_ensembles : 1;
+  for (int i_ens = 0; i_ens < n_sampled; i_ens++) {
+    start_time = modus_.initial_conditions(&ensembles_[i_ens], parameters_);
+  }
+  relocate_ensembles();
   /* For box modus make sure that particles are in the box. In principle, after
    * a correct initialization they should be, so this is just playing it safe.
    */
@@ -1958,6 +3389,11 @@ void Experiment<Modus>::initialize_new_event() {
   switch (time_step_mode_) {
     case TimeStepMode::Fixed:
       break;
+    case TimeStepMode::Adaptive:
+      timestep =
+          std::clamp(delta_time_startup_, min_delta_time_, max_delta_time_);
+      adaptive_delta_time_ = timestep;
+      break;
     case TimeStepMode::None:
       timestep = end_time_ - start_time;
       // Take care of the box modus + timestepless propagation
@@ -1986,17 +3422,27 @@ void Experiment<Modus>::initialize_new_event() {
   logg[LExperiment].debug(
       "Lab clock: t_start = ", parameters_.labclock->current_time(),
       ", dt = ", parameters_.labclock->timestep_duration());
+  next_checkpoint_time_ = start_time + checkpoint_interval_;
 
   /* Save the initial conserved quantum numbers and total momentum in
    * the system for conservation checks */
   conserved_initial_ = QuantumNumbers(ensembles_);
+  conserved_current_ = conserved_initial_;
+  conserved_current_outdated_ = false;
   wall_actions_total_ = 0;
   previous_wall_actions_total_ = 0;
   interactions_total_ = 0;
+  ensemble_interactions_.assign(parameters_.n_ensembles, 0);
   previous_interactions_total_ = 0;
   discarded_interactions_total_ = 0;
   total_pauli_blocked_ = 0;
+  if (scatter_finder_) {
+    scatter_finder_->take_statistics();
+  }
+  step_collisions_ = CollisionFinderStatistics();
+  event_collisions_ = CollisionFinderStatistics();
   projectile_target_interact_.assign(parameters_.n_ensembles, false);
+  nuclei_separated_.assign(parameters_.n_ensembles, false);
   total_hypersurface_crossing_actions_ = 0;
   total_energy_removed_ = 0.0;
   total_energy_violated_by_Pythia_ = 0.0;
@@ -2029,8 +3475,10 @@ void Experiment<Modus>::initialize_new_event() {
     }
   }
   initial_mean_field_energy_ = E_mean_field;
+  mean_field_energy_ = E_mean_field;
   logg[LExperiment].info() << format_measurements(
-      ensembles_, 0u, conserved_initial_, time_start_,
+      conserved_initial_, total_particle_number(), 0u, conserved_initial_,
+      time_start_,
       parameters_.labclock->current_time(), E_mean_field,
       initial_mean_field_energy_);
 
@@ -2038,12 +3486,12 @@ void Experiment<Modus>::initialize_new_event() {
   for (const auto &output : outputs_) {
     for (int i_ens = 0; i_ens < parameters_.n_ensembles; i_ens++) {
       auto event_info = fill_event_info(
-          ensembles_, E_mean_field, modus_.impact_parameter(), parameters_,
+          ensembles_, E_mean_field, modus_.impact_parameter(),
+          modus_.event_weight(), parameters_,
           projectile_target_interact_[i_ens], kinematic_cuts_for_IC_output_);
       output->at_eventstart(ensembles_[i_ens],
                             // Pretend each ensemble is an independent event
-                            event_ * parameters_.n_ensembles + i_ens,
-                            event_info);
+                            global_ensemble_number(i_ens), event_info);
     }
     // For thermodynamic output
     output->at_eventstart(ensembles_, event_);
@@ -2107,29 +3555,93 @@ void Experiment<Modus>::initialize_new_event() {
   }
 }
 
+/**
+ * Make sure `interactions_total` can be represented as a 32-bit integer.
+ * This is necessary for converting to a `id_process`. The latter is 32-bit
+ * integer, because it is written like this to binary output.
+ *
+ * \param[in] interactions_total Total interaction number
+ */
+inline void check_interactions_total(uint64_t interactions_total) {
+  constexpr uint64_t max_uint32 = std::numeric_limits<uint32_t>::max();
+  if (interactions_total >= max_uint32) {
+    throw std::runtime_error("Integer overflow in total interaction number!");
+  }
+}
+
 template <typename Modus>
 bool Experiment<Modus>::perform_action(Action &action, int i_ensemble,
                                        bool include_pauli_blocking) {
+  const Profiler::ScopedTimer timer(profiler_.get(), Profiler::Phase::Actions);
   Particles &particles = ensembles_[i_ensemble];
+  const bool is_scattering = dynamic_cast<ScatterAction *>(&action) != nullptr;
   // Make sure to skip invalid and Pauli-blocked actions.
   if (!action.is_valid(particles)) {
+    auto lock = lock_shared_state();
     discarded_interactions_total_++;
-    logg[LExperiment].debug(~einhard::DRed(), "✘ ", action,
-                            " (discarded: invalid)");
+    step_collisions_.actions_invalid += is_scattering;
+    SMASH_LOG_DEBUG(LExperiment, ~einhard::DRed(), "✘ ", action,
+                    " (discarded: invalid)");
     return false;
   }
+  if ((batch_string_fragmentation_ && parameters_.strings_switch) ||
+      speculation_window_ > 0) {
+    /* Like in prefragment_strings and prepare_upcoming_collisions, which may
+     * have generated the final state */
+    if (auto *scatter = dynamic_cast<ScatterAction *>(&action)) {
+      scatter->set_random_stream(seed_,
+                                 parameters_.first_ensemble + i_ensemble);
+    }
+  }
+  // Collisions of other kinds cannot be replayed by the finder
+  if (collision_trace_ && typeid(action) == typeid(ScatterAction)) {
+    const ParticleList &incoming = action.incoming_particles();
+    collision_trace_->add_collision(
+        parameters_.coll_crit, incoming[0], incoming[1],
+        action.time_of_execution() - incoming[0].position().x0());
+  }
   try {
     action.generate_final_state();
   } catch (Action::StochasticBelowEnergyThreshold &) {
     return false;
   }
-  logg[LExperiment].debug("Process Type is: ", action.get_type());
+  SMASH_LOG_DEBUG(LExperiment, "Process Type is: ", action.get_type());
   if (include_pauli_blocking && pauli_blocker_ &&
       action.is_pauli_blocked(ensembles_, *pauli_blocker_)) {
     total_pauli_blocked_++;
+    step_collisions_.actions_pauli_blocked += is_scattering;
     return false;
   }
 
+  /* The process id only depends on the history of the own ensemble, so that
+   * it does not change with the number of threads. Make sure to pick a
+   * non-zero integer, because 0 is reserved for "no interaction yet". */
+  const uint64_t interactions_ensemble = ++ensemble_interactions_[i_ensemble];
+  const uint64_t id_process =
+      (interactions_ensemble - 1) * parameters_.n_ensembles + i_ensemble + 1;
+  check_interactions_total(id_process);
+  const bool check_conservation =
+      conservation_check_ == ConservationCheck::Full ||
+      (conservation_check_ == ConservationCheck::Sampled &&
+       interactions_ensemble % conservation_check_interval_ == 0);
+  // we perform the action and collect possible energy violations by Pythia
+  const double energy_violation = action.perform(
+      &particles, static_cast<uint32_t>(id_process), check_conservation);
+  // Calculate Eckart rest frame density at the interaction point
+  double rho = 0.0;
+  if (dens_type_ != DensityType::None) {
+    const FourVector r_interaction = action.get_interaction_point();
+    constexpr bool compute_grad = false;
+    const bool smearing = true;
+    // todo(oliiny): it's a rough density estimate from a single ensemble.
+    // It might actually be appropriate for output. Discuss.
+    rho = std::get<0>(current_eckart(r_interaction.threevec(), particles,
+                                     density_param_, dens_type_, compute_grad,
+                                     smearing));
+  }
+
+  // Only the counters and outputs are shared with the other ensembles
+  auto lock = lock_shared_state();
   // Prepare projectile_target_interact_, it's used for output
   // to signal that there was some interaction in this event
   if (modus_.is_collider()) {
@@ -2146,13 +3658,17 @@ bool Experiment<Modus>::perform_action(Action &action, int i_ensemble,
     }
   }
 
-  /* Make sure to pick a non-zero integer, because 0 is reserved for "no
-   * interaction yet". */
-  const auto id_process = static_cast<uint32_t>(interactions_total_ + 1);
-  // we perform the action and collect possible energy violations by Pythia
-  total_energy_violated_by_Pythia_ += action.perform(&particles, id_process);
+  total_energy_violated_by_Pythia_ += energy_violation;
+  conserved_current_ =
+      conserved_current_ - (QuantumNumbers(action.incoming_particles()) -
+                            QuantumNumbers(action.outgoing_particles()));
+  if (pauli_blocker_) {
+    pauli_blocker_->update_index(i_ensemble, action.incoming_particles(),
+                                 action.outgoing_particles());
+  }
 
   interactions_total_++;
+  step_collisions_.actions_performed += is_scattering;
   if (action.get_type() == ProcessType::Wall) {
     wall_actions_total_++;
   }
@@ -2160,18 +3676,6 @@ bool Experiment<Modus>::perform_action(Action &action, int i_ensemble,
     total_hypersurface_crossing_actions_++;
     total_energy_removed_ += action.incoming_particles()[0].momentum().x0();
   }
-  // Calculate Eckart rest frame density at the interaction point
-  double rho = 0.0;
-  if (dens_type_ != DensityType::None) {
-    const FourVector r_interaction = action.get_interaction_point();
-    constexpr bool compute_grad = false;
-    const bool smearing = true;
-    // todo(oliiny): it's a rough density estimate from a single ensemble.
-    // It might actually be appropriate for output. Discuss.
-    rho = std::get<0>(current_eckart(r_interaction.threevec(), particles,
-                                     density_param_, dens_type_, compute_grad,
-                                     smearing));
-  }
   /*!\Userguide
    * \page doxypage_output_collisions_box_modus
    * \note When SMASH is running in the box modus, particle coordinates
@@ -2204,7 +3708,7 @@ bool Experiment<Modus>::perform_action(Action &action, int i_ensemble,
   // Therefore we first have to check if the incoming particles can undergo
   // an em-interaction.
   if (photons_switch_ &&
-      ScatterActionPhoton::is_photon_reaction(action.incoming_particles()) &&
+      photon_channels_->is_photon_reaction(action.incoming_particles()) &&
       ScatterActionPhoton::is_kinematically_possible(
           action.sqrt_s(), action.incoming_particles())) {
     /* Time in the action constructor is relative to
@@ -2233,7 +3737,7 @@ bool Experiment<Modus>::perform_action(Action &action, int i_ensemble,
   }
 
   if (bremsstrahlung_switch_ &&
-      BremsstrahlungAction::is_bremsstrahlung_reaction(
+      photon_channels_->is_bremsstrahlung_reaction(
           action.incoming_particles())) {
     /* Time in the action constructor is relative to
      * current time of incoming */
@@ -2262,7 +3766,7 @@ bool Experiment<Modus>::perform_action(Action &action, int i_ensemble,
     brems_act.perform_bremsstrahlung(outputs_);
   }
 
-  logg[LExperiment].debug(~einhard::Green(), "✔ ", action);
+  SMASH_LOG_DEBUG(LExperiment, ~einhard::Green(), "✔ ", action);
   return true;
 }
 
@@ -2278,6 +3782,25 @@ bool Experiment<Modus>::perform_action(Action &action, int i_ensemble,
  */
 void validate_and_adjust_particle_list(ParticleList &particle_list);
 
+/**
+ * Find the particles, which are asked to be removed from the evolution. A
+ * valid copy of a particle is found in its slot, any other particle by its
+ * PDG code, momentum and position among the particles of about the same
+ * energy. Hence the costs grow only with the number of particles and not
+ * with the product of both numbers, as for a linear search.
+ *
+ * \param[in] particles The current particles
+ * \param[in] to_remove Particles to be removed
+ * \param[in] time Time at which the particles are compared
+ * \return Valid copies of the found particles, which are not found are
+ *         left out
+ * \throw std::logic_error if the same particle is asked to be removed twice
+ * \see are_particles_identical_at_given_time
+ */
+ParticleList find_particles_to_remove(const Particles &particles,
+                                      const ParticleList &to_remove,
+                                      double time);
+
 template <typename Modus>
 void Experiment<Modus>::run_time_evolution(const double t_end,
                                            ParticleList &&add_plist,
@@ -2288,6 +3811,7 @@ void Experiment<Modus>::run_time_evolution(const double t_end,
           "Adding or removing particles from SMASH is only possible when one "
           "ensemble is used.");
     }
+    particle_extents_[0].reset();
     const double action_time = parameters_.labclock->current_time();
     /* Use two if statements. The first one is to check if the particles are
      * valid. Since this might remove all particles, a second if statement is
@@ -2306,38 +3830,8 @@ void Experiment<Modus>::run_time_evolution(const double t_end,
       validate_and_adjust_particle_list(remove_plist);
     }
     if (!remove_plist.empty()) {
-      ParticleList found_particles_to_remove;
-      for (const auto &particle_to_remove : remove_plist) {
-        const auto iterator_to_particle_to_be_removed_in_ensemble =
-            std::find_if(
-                ensembles_[0].begin(), ensembles_[0].end(),
-                [&particle_to_remove, &action_time](const ParticleData &p) {
-                  return are_particles_identical_at_given_time(
-                      particle_to_remove, p, action_time);
-                });
-        if (iterator_to_particle_to_be_removed_in_ensemble !=
-            ensembles_[0].end())
-          found_particles_to_remove.push_back(
-              *iterator_to_particle_to_be_removed_in_ensemble);
-      }
-      // Sort the particles found to be removed according to their id and look
-      // for duplicates (sorting is needed to call std::adjacent_find).
-      std::sort(found_particles_to_remove.begin(),
-                found_particles_to_remove.end(),
-                [](const ParticleData &p1, const ParticleData &p2) {
-                  return p1.id() < p2.id();
-                });
-      const auto iterator_to_first_duplicate = std::adjacent_find(
-          found_particles_to_remove.begin(), found_particles_to_remove.end(),
-          [](const ParticleData &p1, const ParticleData &p2) {
-            return p1.id() == p2.id();
-          });
-      if (iterator_to_first_duplicate != found_particles_to_remove.end()) {
-        logg[LExperiment].error() << "The same particle has been asked to be "
-                                     "removed multiple times:\n"
-                                  << *iterator_to_first_duplicate;
-        throw std::logic_error("Particle cannot be removed twice!");
-      }
+      const ParticleList found_particles_to_remove =
+          find_particles_to_remove(ensembles_[0], remove_plist, action_time);
       if (auto delta = remove_plist.size() - found_particles_to_remove.size();
           delta > 0) {
         logg[LExperiment].warn(
@@ -2368,9 +3862,49 @@ void Experiment<Modus>::run_time_evolution(const double t_end,
         "Experiment cannot evolve the system beyond End_Time.");
   }
   while (*(parameters_.labclock) < t_end) {
+    const Profiler::ScopedSpan step_span(profiler_.get(), "Time step");
+    if (!ensembles_forked_ &&
+        parameters_.labclock->current_time() >= ensemble_fork_time_) {
+      fork_ensembles();
+    }
     const double dt = parameters_.labclock->timestep_duration();
     logg[LExperiment].debug("Timestepless propagation for next ", dt, " fm.");
 
+    /* Holes left by removed particles are closed, while no copies of the
+     * particles are kept. The grid notices the moved particles. */
+    for (Particles &particles : ensembles_) {
+      if (particles.hole_fraction() > max_hole_fraction_) {
+        particles.compact();
+      }
+    }
+    /* Every few time steps the particles are sorted by the Morton keys of
+     * their cells, such that the particles of a cell lie next to each other
+     * in memory. */
+    if (particle_sort_interval_ > 0 &&
+        ++steps_since_particle_sort_ >= particle_sort_interval_) {
+      steps_since_particle_sort_ = 0;
+      const double cell_length = compute_min_cell_length(dt);
+      for_each_ensemble([&](int i_ens) {
+        Particles &particles = ensembles_[i_ens];
+        if (particles.size() == 0) {
+          return;
+        }
+        const GridBase::MinAndLength box =
+            particle_extents_[i_ens]
+                ? *particle_extents_[i_ens]
+                : GridBase::find_min_and_length(particles);
+        particles.sort([&](const ParticleData &p) {
+          return GridBase::morton_key(p.position(), box, cell_length);
+        });
+      });
+    }
+
+    /* The particles move at most by dt until the potentials are updated and
+     * the index has to be built anew. */
+    if (pauli_blocker_) {
+      pauli_blocker_->build_index(ensembles_, dt);
+    }
+
     // Perform forced thermalization if required
     if (thermalizer_ &&
         thermalizer_->is_time_to_thermalize(parameters_.labclock)) {
@@ -2378,11 +3912,14 @@ void Experiment<Modus>::run_time_evolution(const double t_end,
       // Thermodynamics in thermalizer is computed from all ensembles,
       // but thermalization actions act on each ensemble independently
       thermalizer_->update_thermalizer_lattice(ensembles_, density_param_,
-                                               ignore_cells_under_treshold);
+                                               ignore_cells_under_treshold,
+                                               thread_pool_.get());
       const double current_t = parameters_.labclock->current_time();
       for (int i_ens = 0; i_ens < parameters_.n_ensembles; i_ens++) {
+        particle_extents_[i_ens].reset();
         thermalizer_->thermalize(ensembles_[i_ens], current_t,
-                                 parameters_.testparticles);
+                                 parameters_.testparticles,
+                                 thread_pool_.get());
         ThermalizationAction th_act(*thermalizer_, current_t);
         if (th_act.any_particles_thermalized()) {
           perform_action(th_act, i_ens);
@@ -2390,69 +3927,242 @@ void Experiment<Modus>::run_time_evolution(const double t_end,
       }
     }
 
-    std::vector<Actions> actions(parameters_.n_ensembles);
-    for (int i_ens = 0; i_ens < parameters_.n_ensembles; i_ens++) {
-      actions[i_ens].clear();
+    for_each_ensemble([&](int i_ens) {
+      actions_[i_ens].clear();
+      if (hypersurface_finder_) {
+        const Profiler::ScopedTimer finding_timer(
+            profiler_.get(), Profiler::Phase::ActionFinding, i_ens);
+        actions_[i_ens].insert(hypersurface_finder_->find_crossings(
+            ensembles_[i_ens], dt, beam_momentum_));
+      }
+      /* Nuclei which passed or missed each other without interacting stay
+       * apart, so the event is empty and nothing has to be searched. The
+       * potentials could still change the velocities. */
+      if (detect_separated_nuclei_ && !potentials_ &&
+          !nuclei_separated_[i_ens]) {
+        nuclei_separated_[i_ens] = nuclei_separate_without_interaction(
+            ensembles_[i_ens], compute_min_cell_length(dt), false,
+            beam_momentum_);
+        if (nuclei_separated_[i_ens]) {
+          logg[LExperiment].debug("Projectile and target of ensemble ", i_ens,
+                                  " separated without interaction at t = ",
+                                  parameters_.labclock->current_time(), " fm");
+        }
+      }
+      if (nuclei_separated_[i_ens]) {
+        return;
+      }
       if (ensembles_[i_ens].size() > 0 && action_finders_.size() > 0) {
         /* (1.a) Create grid. */
+        const Profiler::ScopedTimer grid_timer(profiler_.get(),
+                                               Profiler::Phase::Grid, i_ens);
         const double min_cell_length = compute_min_cell_length(dt);
         logg[LExperiment].debug("Creating grid with minimal cell length ",
                                 min_cell_length);
-        /* For the hyper-surface-crossing actions also unformed particles are
-         * searched and therefore needed on the grid. */
-        const bool include_unformed_particles = IC_output_switch_;
-        const auto &grid =
-            use_grid_ ? modus_.create_grid(ensembles_[i_ens], min_cell_length,
-                                           dt, parameters_.coll_crit,
-                                           include_unformed_particles)
-                      : modus_.create_grid(ensembles_[i_ens], min_cell_length,
-                                           dt, parameters_.coll_crit,
-                                           include_unformed_particles,
-                                           CellSizeStrategy::Largest);
-
-        const double gcell_vol = grid.cell_volume();
-        /* (1.b) Iterate over cells and find actions. */
-        grid.iterate_cells(
-            [&](const ParticleList &search_list) {
-              for (const auto &finder : action_finders_) {
-                actions[i_ens].insert(finder->find_actions_in_cell(
-                    search_list, dt, gcell_vol, beam_momentum_));
-              }
-            },
-            [&](const ParticleList &search_list,
-                const ParticleList &neighbors_list) {
-              for (const auto &finder : action_finders_) {
-                actions[i_ens].insert(finder->find_actions_with_neighbors(
-                    search_list, neighbors_list, dt, beam_momentum_));
-              }
-            });
-      }
-    }
-
-    /* \todo (optimizations) Adapt timestep size here */
+        /* The hypersurface crossings, for which also unformed particles are
+         * searched, are found without the grid. */
+        constexpr bool include_unformed_particles = false;
+        /* The grid of the last time step is updated, unless a particle left
+         * it. For the stochastic criterion the cell volume enters the
+         * collision probability, hence a grid with normal boundaries, which
+         * follows the extent of the particles, is always constructed anew. */
+        const bool keep_grid =
+            std::is_same_v<ModusGrid, Grid<GridOptions::PeriodicBoundaries>> ||
+            parameters_.coll_crit != CollisionCriterion::Stochastic;
+        /* Spectators, which cannot reach a collision partner within this
+         * time step, are left out of the cells. */
+        std::function<bool(const ParticleData &)> skip_frozen;
+        if (!frozen_spectators_.empty()) {
+          FrozenSpectators &frozen = frozen_spectators_[i_ens];
+          frozen.update(ensembles_[i_ens], min_cell_length + 2 * dt);
+          logg[LExperiment].debug("Frozen spectators: ", frozen.n_frozen());
+          skip_frozen = [&frozen](const ParticleData &p) {
+            return frozen.is_frozen(p);
+          };
+        }
+        /* Escaped particles are only searched for decays, which do not need
+         * the grid. */
+        if (!escaped_particles_.empty()) {
+          EscapedParticles &escaped = escaped_particles_[i_ens];
+          escaped.update(ensembles_[i_ens], min_cell_length + 2 * dt,
+                         parameters_.labclock->current_time() - dt);
+          logg[LExperiment].debug("Escaped particles: ", escaped.n_escaped());
+          if (decay_finder_ && escaped.n_escaped() > 0) {
+            actions_[i_ens].insert(decay_finder_->find_actions_in_cell(
+                escaped.particles(), dt, 0., beam_momentum_));
+          }
+          skip_frozen = [&escaped, frozen = std::move(skip_frozen)](
+                            const ParticleData &p) {
+            return escaped.is_escaped(p) || (frozen && frozen(p));
+          };
+        }
+        // The found actions are added to the given list
+        const auto add_actions = [](ActionList &found, ActionList &&actions) {
+          found.insert(found.end(), std::make_move_iterator(actions.begin()),
+                       std::make_move_iterator(actions.end()));
+        };
+        const auto find_in_cell = [&](const ParticleSpan &search_list,
+                                      double cell_volume, ActionList &found) {
+          for (const auto &finder : action_finders_) {
+            add_actions(found, finder->find_actions_in_cell(
+                                   search_list, dt, cell_volume,
+                                   beam_momentum_));
+          }
+        };
+        const auto find_with_neighbors = [&](const ParticleSpan &search_list,
+                                             const ParticleSpan &neighbors_list,
+                                             ActionList &found) {
+          for (const auto &finder : action_finders_) {
+            add_actions(found, finder->find_actions_with_neighbors(
+                                   search_list, neighbors_list, dt,
+                                   beam_momentum_));
+          }
+        };
+
+        if (step_search_ == CollisionSearch::Sweep) {
+          // The cell volume only matters for the stochastic criterion
+          SweepAndPrune &sweep = sweeps_[i_ens];
+          sweep.update(ensembles_[i_ens], min_cell_length, dt,
+                       include_unformed_particles, skip_frozen);
+          const Profiler::ScopedTimer finding_timer(
+              profiler_.get(), Profiler::Phase::ActionFinding, i_ens);
+          ActionList found;
+          sweep.iterate_cells(
+              [&](const ParticleSpan &search_list) {
+                find_in_cell(search_list, 0., found);
+              },
+              [&](const ParticleSpan &search_list,
+                  const ParticleSpan &neighbors_list) {
+                find_with_neighbors(search_list, neighbors_list, found);
+              });
+          actions_[i_ens].insert(std::move(found));
+          return;
+        }
+
+        std::unique_ptr<ModusGrid> &grid = grids_[i_ens];
+        if (!keep_grid || !grid ||
+            !grid->update(ensembles_[i_ens], min_cell_length, dt,
+                          skip_frozen)) {
+          const double margin = keep_grid ? grid_margin_ : 0.;
+          grid = std::make_unique<ModusGrid>(
+              use_grid_ ? modus_.create_grid(ensembles_[i_ens], min_cell_length,
+                                             dt, parameters_.coll_crit,
+                                             include_unformed_particles,
+                                             CellSizeStrategy::Optimal, margin,
+                                             particle_extents_[i_ens])
+                        : modus_.create_grid(ensembles_[i_ens], min_cell_length,
+                                             dt, parameters_.coll_crit,
+                                             include_unformed_particles,
+                                             CellSizeStrategy::Largest, margin,
+                                             particle_extents_[i_ens]));
+          // the layout of the new grid still follows all particles
+          if (skip_frozen) {
+            grid->update(ensembles_[i_ens], min_cell_length, dt, skip_frozen);
+          }
+        }
+
+        const double gcell_vol = grid->cell_volume();
+        /* (1.b) Iterate over cells and find actions. The grid timer is paused
+         * meanwhile. */
+        const Profiler::ScopedTimer finding_timer(
+            profiler_.get(), Profiler::Phase::ActionFinding, i_ens);
+        if (max_cell_occupancy_ > 0) {
+          /* Crowded cells of the stochastic criterion are searched in
+           * octants, the collision probabilities follow their volume. */
+          ActionList found;
+          grid->iterate_refined_cells(
+              max_cell_occupancy_, min_subcell_length_,
+              [&](const ParticleSpan &search_list, double cell_volume) {
+                find_in_cell(search_list, cell_volume, found);
+              });
+          actions_[i_ens].insert(std::move(found));
+        } else {
+          /* Every layer of cells is searched with a random stream of its
+           * own and collects its actions in a list of its own, which are
+           * merged in the order of the layers. Thus the actions do not depend
+           * on whether a single ensemble spreads its layers over the
+           * threads. */
+          const random::Engine::result_type seed = random::advance();
+          const int n_layers = grid->number_of_layers();
+          std::vector<ActionList> found(n_layers);
+          auto search_layer = [&](int layer) {
+            random::Engine engine(seed, layer + 1);
+            random::EngineGuard guard(engine);
+            grid->iterate_cells(
+                [&](const ParticleSpan &search_list) {
+                  find_in_cell(search_list, gcell_vol, found[layer]);
+                },
+                [&](const ParticleSpan &search_list,
+                    const ParticleSpan &neighbors_list) {
+                  find_with_neighbors(search_list, neighbors_list,
+                                      found[layer]);
+                },
+                layer, layer + 1);
+          };
+          if (thread_pool_ && parameters_.n_ensembles == 1) {
+            thread_pool_->parallel_for(n_layers, search_layer);
+          } else {
+            for (int layer = 0; layer < n_layers; layer++) {
+              search_layer(layer);
+            }
+          }
+          for (ActionList &layer_actions : found) {
+            actions_[i_ens].insert(std::move(layer_actions));
+          }
+        }
+      }
+    });
 
     /* (2) Propagate from action to action until next output or timestep end */
     const double end_timestep_time = parameters_.labclock->next_time();
+    if (batch_string_fragmentation_ && parameters_.strings_switch) {
+      prefragment_strings(actions_, end_timestep_time);
+    }
     while (next_output_time() < end_timestep_time) {
-      for (int i_ens = 0; i_ens < parameters_.n_ensembles; i_ens++) {
-        run_time_evolution_timestepless(actions[i_ens], i_ens,
-                                        next_output_time());
-      }
+      const double output_time = next_output_time();
+      for_each_ensemble([&](int i_ens) {
+        run_time_evolution_timestepless(actions_[i_ens], i_ens, output_time);
+      });
       ++(*parameters_.outputclock);
 
       intermediate_output();
     }
-    for (int i_ens = 0; i_ens < parameters_.n_ensembles; i_ens++) {
-      run_time_evolution_timestepless(actions[i_ens], i_ens, end_timestep_time);
+    for_each_ensemble([&](int i_ens) {
+      run_time_evolution_timestepless(actions_[i_ens], i_ens,
+                                      end_timestep_time);
+    });
+    if (pauli_blocker_) {
+      pauli_blocker_->clear_index();
+    }
+    std::uint64_t step_scatterings = 0;
+    if (scatter_finder_) {
+      step_collisions_.add(scatter_finder_->take_statistics());
+      step_scatterings = step_collisions_.actions_performed;
+      if (step_collisions_.actions_created > 0) {
+        last_collision_time_ = end_timestep_time;
+      }
+      logg[LExperiment].debug("Collision finder in time step: ",
+                              step_collisions_);
+      if (collision_search_ == CollisionSearch::Auto) {
+        choose_collision_search(step_collisions_.pairs_in_cells +
+                                step_collisions_.pairs_with_neighbors);
+      }
+      event_collisions_.add(step_collisions_);
+      step_collisions_ = CollisionFinderStatistics();
     }
 
     /* (3) Update potentials (if computed on the lattice) and
      *     compute new momenta according to equations of motion */
+    double force_time_scale = std::numeric_limits<double>::infinity();
     if (potentials_) {
+      const Profiler::ScopedTimer timer(profiler_.get(),
+                                        Profiler::Phase::Potentials);
       update_potentials();
-      update_momenta(ensembles_, parameters_.labclock->timestep_duration(),
-                     *potentials_, FB_lat_.get(), FI3_lat_.get(), EM_lat_.get(),
-                     jmu_B_lat_.get());
+      force_time_scale = update_momenta(
+          ensembles_, parameters_.labclock->timestep_duration(), *potentials_,
+          FB_lat_.get(), FI3_lat_.get(), EM_lat_.get(), jmu_B_lat_.get(),
+          thread_pool_.get());
+      conserved_current_outdated_ = true;
     }
 
     /* (4) Expand universe if non-minkowskian metric; updates
@@ -2461,24 +4171,72 @@ void Experiment<Modus>::run_time_evolution(const double t_end,
       for (Particles &particles : ensembles_) {
         expand_space_time(&particles, parameters_, metric_);
       }
+      particle_extents_.assign(parameters_.n_ensembles, std::nullopt);
+      conserved_current_outdated_ = true;
     }
 
     ++(*parameters_.labclock);
+    if (time_step_mode_ == TimeStepMode::Adaptive) {
+      adapt_time_step(dt, step_scatterings, force_time_scale);
+    }
 
     /* (5) Check conservation laws.
      *
      * Check conservation of conserved quantities if potentials and string
      * fragmentation are off.  If potentials are on then momentum is conserved
      * only in average.  If string fragmentation is on, then energy and
-     * momentum are only very roughly conserved in high-energy collisions. */
-    if (!potentials_ && !parameters_.strings_switch &&
+     * momentum are only very roughly conserved in high-energy collisions.
+     * Unless the check is full, the conserved quantities updated by the
+     * actions are compared instead of the sum over all particles. */
+    if (conservation_check_ != ConservationCheck::Off && !potentials_ &&
+        !parameters_.strings_switch &&
         metric_.mode_ == ExpansionMode::NoExpansion && !IC_output_switch_) {
-      std::string err_msg = conserved_initial_.report_deviations(ensembles_);
+      const std::string err_msg =
+          conservation_check_ == ConservationCheck::Full
+              ? conserved_initial_.report_deviations(ensembles_)
+              : conserved_initial_.report_deviations(conserved_current_);
       if (!err_msg.empty()) {
         logg[LExperiment].error() << err_msg;
         throw std::runtime_error("Violation of conserved quantities!");
       }
     }
+
+    if (memory_usage_) {
+      update_memory_usage();
+    }
+
+    const double now = parameters_.labclock->current_time();
+    if (checkpoint_interval_ > 0. && now >= next_checkpoint_time_ &&
+        *(parameters_.labclock) < t_end) {
+      while (next_checkpoint_time_ <= now) {
+        next_checkpoint_time_ += checkpoint_interval_;
+      }
+      write_checkpoint();
+    }
+
+    /* Once the event interacted and no pair came within reach of a collision
+     * for the freeze-out window, the rest of the evolution is free
+     * streaming. */
+    if (freeze_out_window_ > 0. && event_collisions_.actions_performed > 0 &&
+        now - last_collision_time_ >= freeze_out_window_ &&
+        *(parameters_.labclock) < t_end) {
+      logg[LExperiment].info("Frozen out at t = ", now,
+                             " fm, the particles stream freely until ", t_end,
+                             " fm.");
+      propagate_frozen_out(t_end);
+    }
+
+    // A box is evolved only for the measurement time after its equilibrium
+    if (equilibration_monitor_ && !equilibrium_time_ &&
+        equilibration_monitor_->add(now, ensembles_)) {
+      equilibrium_time_ = now;
+      logg[LExperiment].info("Equilibrium reached at t = ", now, " fm.");
+    }
+    if (equilibrium_time_ &&
+        now >= *equilibrium_time_ +
+                   equilibration_monitor_->criterion().measurement_time) {
+      break;
+    }
   }
 
   if (pauli_blocker_) {
@@ -2486,50 +4244,235 @@ void Experiment<Modus>::run_time_evolution(const double t_end,
         "Interactions: Pauli-blocked/performed = ", total_pauli_blocked_, "/",
         interactions_total_ - wall_actions_total_);
   }
+  if (scatter_finder_) {
+    logg[LExperiment].info("Collision finder: ", event_collisions_);
+  }
+  if (potentials_refresh_) {
+    logg[LExperiment].info(potentials_refresh_->report());
+  }
+  if (process_string_ptr_ != NULL) {
+    // Accumulated over all events so far, including all threads
+    const auto statistics = process_string_ptr_->statistics();
+    for (std::size_t i = 0; i < StringProcess::n_subprocesses; i++) {
+      if (statistics[i].calls == 0) {
+        continue;
+      }
+      logg[LExperiment].info(
+          "String subprocess ",
+          StringProcess::subprocess_name(
+              static_cast<StringProcess::Subprocess>(i)),
+          ": calls/failed = ", statistics[i].calls, "/",
+          statistics[i].failures, ", internal retries = ",
+          statistics[i].retries, ", time/failed [s] = ", statistics[i].time,
+          "/", statistics[i].failed_time);
+    }
+  }
+}
+
+template <typename Modus>
+void Experiment<Modus>::write_dilepton_actions(const ActionList &actions) {
+  auto lock = lock_shared_state();
+  for (const auto &output : outputs_) {
+    if (!output->is_dilepton_output()) {
+      continue;
+    }
+    for (const ActionPtr &action : actions) {
+      output->at_interaction(*action, 0.0);
+    }
+  }
 }
 
 template <typename Modus>
 void Experiment<Modus>::propagate_and_shine(double to_time,
-                                            Particles &particles) {
-  const double dt =
-      propagate_straight_line(&particles, to_time, beam_momentum_);
+                                            Particles &particles,
+                                            int i_ensemble) {
+  const Profiler::ScopedTimer timer(profiler_.get(),
+                                    Profiler::Phase::Propagation);
+  GridBase::MinAndLength extent;
+  const double dt = propagate_straight_line(&particles, to_time,
+                                            beam_momentum_, &extent);
+  particle_extents_[i_ensemble].reset();
+  if (batch_wall_crossings_ && modus_.is_box()) {
+    wrap_into_box(particles, i_ensemble);
+  } else if (!particles.is_empty()) {
+    particle_extents_[i_ensemble] = extent;
+  }
   if (dilepton_finder_ != nullptr) {
+    // The decays are sampled before the outputs are locked
+    const ActionList shining =
+        dilepton_finder_->shining_actions(particles, dt);
+    if (!shining.empty()) {
+      write_dilepton_actions(shining);
+    }
+  }
+}
+
+template <typename Modus>
+void Experiment<Modus>::propagate_frozen_out(double t_end) {
+  while (next_output_time() < t_end) {
+    const double output_time = next_output_time();
+    for_each_ensemble([&](int i_ens) {
+      propagate_and_shine(output_time, ensembles_[i_ens], i_ens);
+    });
+    ++(*parameters_.outputclock);
+    intermediate_output();
+  }
+  for_each_ensemble([&](int i_ens) {
+    propagate_and_shine(t_end, ensembles_[i_ens], i_ens);
+  });
+  while (*(parameters_.labclock) < t_end) {
+    ++(*parameters_.labclock);
+  }
+}
+
+template <typename Modus>
+void Experiment<Modus>::wrap_into_box(Particles &particles, int i_ensemble) {
+  std::unique_lock<std::mutex> lock;
+  for (ParticleData &data : particles) {
+    FourVector position = data.position();
+    if (!enforce_periodic_boundaries(position.begin() + 1, position.end(),
+                                     parameters_.box_length)) {
+      continue;
+    }
+    const ParticleData incoming_particle(data);
+    data.set_4position(position);
+    // The outputs and counters are shared, they are locked once per pass
+    if (!lock.owns_lock()) {
+      lock = lock_shared_state();
+    }
+    ensemble_interactions_[i_ensemble]++;
+    interactions_total_++;
+    wall_actions_total_++;
+    if (pauli_blocker_) {
+      pauli_blocker_->update_index(i_ensemble, {incoming_particle}, {data});
+    }
+    const WallcrossingAction action(incoming_particle, data);
     for (const auto &output : outputs_) {
-      dilepton_finder_->shine(particles, output.get(), dt);
+      if (!output->is_dilepton_output() && !output->is_photon_output() &&
+          !output->is_IC_output()) {
+        output->at_interaction(action, 0.);
+      }
     }
   }
 }
 
-/**
- * Make sure `interactions_total` can be represented as a 32-bit integer.
- * This is necessary for converting to a `id_process`. The latter is 32-bit
- * integer, because it is written like this to binary output.
- *
- * \param[in] interactions_total Total interaction number
- */
-inline void check_interactions_total(uint64_t interactions_total) {
-  constexpr uint64_t max_uint32 = std::numeric_limits<uint32_t>::max();
-  if (interactions_total >= max_uint32) {
-    throw std::runtime_error("Integer overflow in total interaction number!");
+template <typename Modus>
+void Experiment<Modus>::prefragment_strings(std::vector<Actions> &actions,
+                                            double end_time) {
+  const Profiler::ScopedTimer timer(profiler_.get(), Profiler::Phase::Strings);
+  std::vector<ScatterAction *> strings;
+  for (int i_ens = 0; i_ens < parameters_.n_ensembles; i_ens++) {
+    for (const ActionPtr &action : actions[i_ens]) {
+      if (action->time_of_execution() > end_time ||
+          !action->is_valid(ensembles_[i_ens])) {
+        continue;
+      }
+      auto *scatter = dynamic_cast<ScatterAction *>(action.get());
+      if (scatter && scatter->has_string_channel()) {
+        scatter->set_random_stream(seed_, parameters_.first_ensemble + i_ens);
+        strings.push_back(scatter);
+      }
+    }
+  }
+  auto fragment = [&](int i) {
+    const Profiler::ScopedSpan span(profiler_.get(), "String");
+    try {
+      strings[i]->prefragment_string();
+    } catch (const std::exception &) {
+      // The error is raised again when the action is performed
+    }
+  };
+  const int n_strings = strings.size();
+  if (!thread_pool_) {
+    for (int i = 0; i < n_strings; i++) {
+      fragment(i);
+    }
+    return;
+  }
+  thread_pool_->parallel_for(n_strings, fragment);
+}
+
+template <typename Modus>
+std::size_t Experiment<Modus>::prepare_upcoming_collisions(
+    const Actions &actions, int i_ensemble, double end_time) {
+  const Profiler::ScopedTimer timer(profiler_.get(), Profiler::Phase::Actions);
+  const Particles &particles = ensembles_[i_ensemble];
+  const std::vector<Action *> window =
+      actions.earliest(speculation_window_, end_time);
+  // Twice the largest distance at which two particles collide
+  const double reach =
+      2. * std::sqrt(parameters_.maximum_cross_section / M_PI * fm2_mb);
+  std::unordered_set<int> incoming_ids;
+  std::vector<FourVector> earlier_points;
+  std::vector<ScatterAction *> collisions;
+  for (Action *action : window) {
+    const Action &upcoming = *action;
+    const FourVector point = upcoming.get_interaction_point();
+    bool conflict = !action->is_valid(particles);
+    for (const ParticleData &incoming : action->incoming_particles()) {
+      conflict = !incoming_ids.insert(incoming.id()).second || conflict;
+    }
+    for (const FourVector &earlier : earlier_points) {
+      const double distance = point.x0() - earlier.x0() + reach;
+      conflict = conflict || (point.threevec() - earlier.threevec()).sqr() <=
+                                 distance * distance;
+    }
+    earlier_points.push_back(point);
+    // Other kinds of scatterings are not found in the time evolution
+    if (conflict || typeid(upcoming) != typeid(ScatterAction)) {
+      continue;
+    }
+    auto *collision = static_cast<ScatterAction *>(action);
+    if (!collision->has_prepared_final_state()) {
+      collision->set_random_stream(seed_,
+                                   parameters_.first_ensemble + i_ensemble);
+      collisions.push_back(collision);
+    }
   }
+  thread_pool_->parallel_for(collisions.size(), [&](int i) {
+    const Profiler::ScopedSpan span(profiler_.get(), "FinalState");
+    collisions[i]->prepare_final_state();
+  });
+  return window.size();
 }
 
 template <typename Modus>
 void Experiment<Modus>::run_time_evolution_timestepless(
     Actions &actions, int i_ensemble, const double end_time_propagation) {
+  const Profiler::ScopedSpan span(profiler_.get(), "Ensemble", i_ensemble);
   Particles &particles = ensembles_[i_ensemble];
   logg[LExperiment].debug(
       "Timestepless propagation: ", "Actions size = ", actions.size(),
       ", end time = ", end_time_propagation);
+  /* The collision partners of produced particles are searched in cells,
+   * which are built with the first performed action. The stochastic
+   * criterion only searches within the produced particles. */
+  const bool search_partners =
+      scatter_finder_ &&
+      parameters_.coll_crit != CollisionCriterion::Stochastic;
+  TimesteplessGrid &grid = timestepless_grids_[i_ensemble];
+  grid.clear();
+  std::vector<const ParticleData *> partners;
+  // Several ensembles keep the threads busy already
+  const bool speculate = speculation_window_ > 0 && thread_pool_ &&
+                         parameters_.n_ensembles == 1;
+  std::size_t window = 0, popped_in_window = 0;
 
   // iterate over all actions
   while (!actions.is_empty()) {
     if (actions.earliest_time() > end_time_propagation) {
       break;
     }
+    if (speculate && popped_in_window == window) {
+      window = prepare_upcoming_collisions(actions, i_ensemble,
+                                           end_time_propagation);
+      popped_in_window = 0;
+    }
     // get next action
     ActionPtr act = actions.pop();
+    popped_in_window++;
     if (!act->is_valid(particles)) {
+      auto lock = lock_shared_state();
       discarded_interactions_total_++;
       logg[LExperiment].debug(~einhard::DRed(), "✘ ", act,
                               " (discarded: invalid)");
@@ -2539,7 +4482,7 @@ void Experiment<Modus>::run_time_evolution_timestepless(
                             ", action time = ", act->time_of_execution());
 
     /* (1) Propagate to the next action. */
-    propagate_and_shine(act->time_of_execution(), particles);
+    propagate_and_shine(act->time_of_execution(), particles, i_ensemble);
 
     /* (2) Perform action.
      *
@@ -2563,23 +4506,48 @@ void Experiment<Modus>::run_time_evolution_timestepless(
     const ParticleList &outgoing_particles = act->outgoing_particles();
     // Grid cell volume set to zero, since there is no grid
     const double gcell_vol = 0.0;
+    const Profiler::ScopedTimer timer(profiler_.get(),
+                                      Profiler::Phase::ActionFinding);
+    if (search_partners) {
+      /* Only particles, which can come close enough within the time left,
+       * are collision partners, like for the grid of a time step. */
+      if (grid.is_built()) {
+        grid.insert(outgoing_particles);
+      } else {
+        grid.build(particles, compute_min_cell_length(0.));
+      }
+      grid.find_candidates(outgoing_particles,
+                           compute_min_cell_length(time_left), particles,
+                           partners);
+    }
+    const auto outgoing_pointers = particle_pointers(outgoing_particles);
     for (const auto &finder : action_finders_) {
       // Outgoing particles can still decay, cross walls...
       actions.insert(finder->find_actions_in_cell(outgoing_particles, time_left,
                                                   gcell_vol, beam_momentum_));
       // ... and collide with other particles.
-      actions.insert(finder->find_actions_with_surrounding_particles(
-          outgoing_particles, particles, time_left, beam_momentum_));
+      if (search_partners) {
+        actions.insert(finder->find_actions_with_neighbors(
+            ParticleSpan(outgoing_pointers), ParticleSpan(partners), time_left,
+            beam_momentum_));
+      }
     }
+    /* The actions of the incoming particles are invalid now. They are removed
+     * from time to time, before the heap grows too large. All of them would
+     * have been discarded within this time step. */
+    const auto removed_actions = actions.compact(particles);
 
+    auto lock = lock_shared_state();
+    discarded_interactions_total_ += removed_actions;
     check_interactions_total(interactions_total_);
   }
 
-  propagate_and_shine(end_time_propagation, particles);
+  propagate_and_shine(end_time_propagation, particles, i_ensemble);
 }
 
 template <typename Modus>
 void Experiment<Modus>::intermediate_output() {
+  const Profiler::ScopedTimer timer(profiler_.get(), Profiler::Phase::Output);
   const uint64_t wall_actions_this_interval =
       wall_actions_total_ - previous_wall_actions_total_;
   previous_wall_actions_total_ = wall_actions_total_;
@@ -2594,8 +4562,8 @@ void Experiment<Modus>::intermediate_output() {
   if (potentials_) {
     // using the lattice is necessary
     if ((jmu_B_lat_ != nullptr)) {
-      E_mean_field = calculate_mean_field_energy(*potentials_, *jmu_B_lat_,
-                                                 EM_lat_.get(), parameters_);
+      // The lattice did not change since the potentials were updated
+      E_mean_field = mean_field_energy_;
       /*
        * Mean field calculated in a box should remain approximately constant if
        * the system is in equilibrium, and so deviations from its original value
@@ -2627,14 +4595,51 @@ void Experiment<Modus>::intermediate_output() {
   }
 
   logg[LExperiment].info() << format_measurements(
-      ensembles_, interactions_this_interval, conserved_initial_, time_start_,
+      current_conserved_quantities(), total_particle_number(),
+      interactions_this_interval, conserved_initial_, time_start_,
       parameters_.outputclock->current_time(), E_mean_field,
       initial_mean_field_energy_);
   const LatticeUpdate lat_upd = LatticeUpdate::AtOutput;
 
   // save evolution data
-  if (!(modus_.is_box() && parameters_.outputclock->current_time() <
-                               modus_.equilibration_time())) {
+  const double output_time = parameters_.outputclock->current_time();
+  /* When the box stops after a measurement time, only this time is written
+   * out. */
+  const bool before_measurement =
+      equilibration_monitor_ &&
+      equilibration_monitor_->criterion().measurement_time > 0. &&
+      !(equilibrium_time_ && output_time >= *equilibrium_time_);
+  if (!(modus_.is_box() && output_time < modus_.equilibration_time()) &&
+      !before_measurement) {
+    // Fill the lattices for the thermodynamic output once for all outputs
+    DensityLattice *jmu_printout = nullptr;
+    if (printout_rho_eckart_) {
+      switch (dens_type_lattice_printout_) {
+        case DensityType::Baryon:
+          jmu_printout = jmu_B_lat_.get();
+          break;
+        case DensityType::BaryonicIsospin:
+          jmu_printout = jmu_I3_lat_.get();
+          break;
+        case DensityType::None:
+          break;
+        default:
+          jmu_printout = jmu_custom_lat_.get();
+      }
+    }
+    const bool printout_tmn =
+        printout_tmn_ || printout_tmn_landau_ || printout_v_landau_;
+    if (jmu_printout != nullptr || printout_tmn) {
+      // Smear every particle once onto both lattices
+      particles_soa_.assign(ensembles_);
+      update_lattices(lat_upd, density_param_, particles_soa_, false,
+                      thread_pool_.get(),
+                      DensityTarget<DensityOnLattice>{
+                          jmu_printout, dens_type_lattice_printout_},
+                      DensityTarget<EnergyMomentumTensor>{
+                          printout_tmn ? Tmn_.get() : nullptr,
+                          dens_type_lattice_printout_});
+    }
     for (const auto &output : outputs_) {
       if (output->is_dilepton_output() || output->is_photon_output() ||
           output->is_IC_output()) {
@@ -2642,7 +4647,8 @@ void Experiment<Modus>::intermediate_output() {
       }
       for (int i_ens = 0; i_ens < parameters_.n_ensembles; i_ens++) {
         auto event_info = fill_event_info(
-            ensembles_, E_mean_field, modus_.impact_parameter(), parameters_,
+            ensembles_, E_mean_field, modus_.impact_parameter(),
+            modus_.event_weight(), parameters_,
             projectile_target_interact_[i_ens], kinematic_cuts_for_IC_output_);
 
         output->at_intermediate_time(ensembles_[i_ens], parameters_.outputclock,
@@ -2657,17 +4663,12 @@ void Experiment<Modus>::intermediate_output() {
       if (printout_rho_eckart_) {
         switch (dens_type_lattice_printout_) {
           case DensityType::Baryon:
-            update_lattice(jmu_B_lat_.get(), lat_upd, DensityType::Baryon,
-                           density_param_, ensembles_, false);
             output->thermodynamics_output(ThermodynamicQuantity::EckartDensity,
                                           DensityType::Baryon, *jmu_B_lat_);
             output->thermodynamics_lattice_output(*jmu_B_lat_,
                                                   computational_frame_time);
             break;
           case DensityType::BaryonicIsospin:
-            update_lattice(jmu_I3_lat_.get(), lat_upd,
-                           DensityType::BaryonicIsospin, density_param_,
-                           ensembles_, false);
             output->thermodynamics_output(ThermodynamicQuantity::EckartDensity,
                                           DensityType::BaryonicIsospin,
                                           *jmu_I3_lat_);
@@ -2677,9 +4678,6 @@ void Experiment<Modus>::intermediate_output() {
           case DensityType::None:
             break;
           default:
-            update_lattice(jmu_custom_lat_.get(), lat_upd,
-                           dens_type_lattice_printout_, density_param_,
-                           ensembles_, false);
             output->thermodynamics_output(ThermodynamicQuantity::EckartDensity,
                                           dens_type_lattice_printout_,
                                           *jmu_custom_lat_);
@@ -2687,9 +4685,7 @@ void Experiment<Modus>::intermediate_output() {
                                                   computational_frame_time);
         }
       }
-      if (printout_tmn_ || printout_tmn_landau_ || printout_v_landau_) {
-        update_lattice(Tmn_.get(), lat_upd, dens_type_lattice_printout_,
-                       density_param_, ensembles_, false);
+      if (printout_tmn) {
         if (printout_tmn_) {
           output->thermodynamics_output(ThermodynamicQuantity::Tmn,
                                         dens_type_lattice_printout_, *Tmn_);
@@ -2728,106 +4724,245 @@ void Experiment<Modus>::intermediate_output() {
 
 template <typename Modus>
 void Experiment<Modus>::update_potentials() {
+  const Profiler::ScopedTimer timer(profiler_.get(),
+                                    Profiler::Phase::Potentials);
   if (potentials_) {
-    if (potentials_->use_symmetry() && jmu_I3_lat_ != nullptr) {
-      update_lattice(jmu_I3_lat_.get(), old_jmu_auxiliary_.get(),
-                     new_jmu_auxiliary_.get(), four_gradient_auxiliary_.get(),
-                     LatticeUpdate::EveryTimestep, DensityType::BaryonicIsospin,
-                     density_param_, ensembles_,
-                     parameters_.labclock->timestep_duration(), true);
+    // the potentials are calculated for the end of the time step
+    const double time = parameters_.labclock->next_time();
+    if (potentials_refresh_ && !potentials_refresh_->next_timestep()) {
+      for_each_potentials_history(
+          [time](auto &lat, auto &history) { history.extrapolate(lat, time); });
+      return;
     }
+    // time since the last update for the time derivatives
+    const double time_step =
+        potentials_refresh_ ? potentials_refresh_->steps_since_refresh() *
+                                  parameters_.labclock->timestep_duration()
+                            : parameters_.labclock->timestep_duration();
+    particles_soa_.assign(ensembles_);
+    DensityLattice *jmu_I3 =
+        potentials_->use_symmetry() ? jmu_I3_lat_.get() : nullptr;
+    DensityLattice *jmu_B = potentials_->use_skyrme() ||
+                                    potentials_->use_symmetry() ||
+                                    potentials_->use_vdf()
+                                ? jmu_B_lat_.get()
+                                : nullptr;
+    DensityLattice *jmu_el =
+        potentials_->use_coulomb() ? jmu_el_lat_.get() : nullptr;
+    {
+      const Profiler::ScopedSpan span(profiler_.get(), "Lattice update");
+      if (density_param_.derivatives() == DerivativesMode::FiniteDifference) {
+        /* The finite differences need the currents of the previous time step,
+         * for which all lattices share the auxiliary lattices, so they are
+         * updated one after the other. */
+        update_lattice(jmu_I3, old_jmu_auxiliary_.get(),
+                       new_jmu_auxiliary_.get(), four_gradient_auxiliary_.get(),
+                       LatticeUpdate::EveryTimestep,
+                       DensityType::BaryonicIsospin, density_param_,
+                       particles_soa_, time_step, true, thread_pool_.get());
+        update_lattice(jmu_B, old_jmu_auxiliary_.get(),
+                       new_jmu_auxiliary_.get(), four_gradient_auxiliary_.get(),
+                       LatticeUpdate::EveryTimestep, DensityType::Baryon,
+                       density_param_, particles_soa_, time_step, true,
+                       thread_pool_.get());
+        update_lattice(jmu_el, LatticeUpdate::EveryTimestep,
+                       DensityType::Charge, density_param_, particles_soa_,
+                       true, thread_pool_.get());
+      } else {
+        // Smear every particle once onto all lattices
+        update_lattices(
+            LatticeUpdate::EveryTimestep, density_param_, particles_soa_, true,
+            thread_pool_.get(),
+            DensityTarget<DensityOnLattice>{jmu_I3,
+                                            DensityType::BaryonicIsospin},
+            DensityTarget<DensityOnLattice>{jmu_B, DensityType::Baryon},
+            DensityTarget<DensityOnLattice>{jmu_el, DensityType::Charge});
+        update_rest_frame_derivatives(jmu_I3, LatticeUpdate::EveryTimestep,
+                                      density_param_);
+        update_rest_frame_derivatives(jmu_B, LatticeUpdate::EveryTimestep,
+                                      density_param_);
+      }
+    }
+
+    /* The potentials on a node only depend on the currents on the same node,
+     * so the threads process contiguous chunks of the nodes. Along the way,
+     * the mean-field energy of the nodes is summed up per chunk, so that the
+     * intermediate output does not need to go over the lattice again. */
+    auto sum_over_nodes = [this](int number_of_nodes, auto &&update_node) {
+      ThreadPool *pool = thread_pool_.get();
+      if (pool == nullptr || pool->size() < 2 || number_of_nodes < 2) {
+        double sum = 0.;
+        for (int i = 0; i < number_of_nodes; i++) {
+          sum += update_node(i);
+        }
+        return sum;
+      }
+      const int n_chunks = std::min(number_of_nodes, 4 * pool->size());
+      const int chunk_size = (number_of_nodes + n_chunks - 1) / n_chunks;
+      std::vector<double> chunk_sums(n_chunks, 0.);
+      pool->parallel_for(n_chunks, [&](int chunk) {
+        const int end = std::min(number_of_nodes, (chunk + 1) * chunk_size);
+        double sum = 0.;
+        for (int i = chunk * chunk_size; i < end; i++) {
+          sum += update_node(i);
+        }
+        chunk_sums[chunk] = sum;
+      });
+      return std::accumulate(chunk_sums.begin(), chunk_sums.end(), 0.);
+    };
+
+    /* On sparse lattices, the potentials are only evaluated on the tiles
+     * occupied by the currents and vanish everywhere else. */
+    if (UB_lat_ && UB_lat_->sparse()) {
+      for_each_potential_lattice([this](auto &lat) {
+        lat.reset();
+        lat.mark_occupied_like(*jmu_B_lat_);
+        if (jmu_I3_lat_) {
+          lat.mark_occupied_like(*jmu_I3_lat_);
+        }
+      });
+    }
+    potential_nodes_.clear();
+    if (UB_lat_) {
+      UB_lat_->iterate_occupied_indices(
+          [this](int i) { potential_nodes_.push_back(i); });
+    }
+    auto sum_over_potential_nodes = [&](auto &&update_node) {
+      return sum_over_nodes(static_cast<int>(potential_nodes_.size()),
+                            [&](int k) {
+                              return update_node(potential_nodes_[k]);
+                            });
+    };
+
+    // The mean-field energy is the same as of calculate_mean_field_energy
+    double mean_field_energy = 0.;
+    const double V_cell =
+        jmu_B_lat_ ? jmu_B_lat_->cell_sizes()[0] *
+                         jmu_B_lat_->cell_sizes()[1] *
+                         jmu_B_lat_->cell_sizes()[2]
+                   : 0.;
     if ((potentials_->use_skyrme() || potentials_->use_symmetry()) &&
         jmu_B_lat_ != nullptr) {
-      update_lattice(jmu_B_lat_.get(), old_jmu_auxiliary_.get(),
-                     new_jmu_auxiliary_.get(), four_gradient_auxiliary_.get(),
-                     LatticeUpdate::EveryTimestep, DensityType::Baryon,
-                     density_param_, ensembles_,
-                     parameters_.labclock->timestep_duration(), true);
-      const size_t UBlattice_size = UB_lat_->size();
-      for (size_t i = 0; i < UBlattice_size; i++) {
-        auto jB = (*jmu_B_lat_)[i];
+      mean_field_energy += sum_over_potential_nodes([&](int i) {
+        const DensityOnLattice &jB = (*jmu_B_lat_)[i];
         const FourVector flow_four_velocity_B =
             std::abs(jB.rho()) > very_small_double ? jB.jmu_net() / jB.rho()
                                                    : FourVector();
-        double baryon_density = jB.rho();
-        ThreeVector baryon_grad_j0 = jB.grad_j0();
-        ThreeVector baryon_dvecj_dt = jB.dvecj_dt();
-        ThreeVector baryon_curl_vecj = jB.curl_vecj();
+        const double baryon_density = jB.rho();
+        const ThreeVector baryon_grad_j0 = jB.grad_j0();
+        const ThreeVector baryon_dvecj_dt = jB.dvecj_dt();
+        const ThreeVector baryon_curl_vecj = jB.curl_vecj();
         if (potentials_->use_skyrme()) {
           (*UB_lat_)[i] =
               flow_four_velocity_B * potentials_->skyrme_pot(baryon_density);
-          (*FB_lat_)[i] =
-              potentials_->skyrme_force(baryon_density, baryon_grad_j0,
-                                        baryon_dvecj_dt, baryon_curl_vecj);
+          FB_lat_->set(i, potentials_->skyrme_force(
+                              baryon_density, baryon_grad_j0, baryon_dvecj_dt,
+                              baryon_curl_vecj));
         }
         if (potentials_->use_symmetry() && jmu_I3_lat_ != nullptr) {
-          auto jI3 = (*jmu_I3_lat_)[i];
+          const DensityOnLattice &jI3 = (*jmu_I3_lat_)[i];
           const FourVector flow_four_velocity_I3 =
               std::abs(jI3.rho()) > very_small_double
                   ? jI3.jmu_net() / jI3.rho()
                   : FourVector();
           (*UI3_lat_)[i] = flow_four_velocity_I3 *
                            potentials_->symmetry_pot(jI3.rho(), baryon_density);
-          (*FI3_lat_)[i] = potentials_->symmetry_force(
-              jI3.rho(), jI3.grad_j0(), jI3.dvecj_dt(), jI3.curl_vecj(),
-              baryon_density, baryon_grad_j0, baryon_dvecj_dt,
-              baryon_curl_vecj);
+          FI3_lat_->set(i, potentials_->symmetry_force(
+                               jI3.rho(), jI3.grad_j0(), jI3.dvecj_dt(),
+                               jI3.curl_vecj(), baryon_density, baryon_grad_j0,
+                               baryon_dvecj_dt, baryon_curl_vecj));
         }
-      }
+        // The symmetry energy is not included
+        return potentials_->use_skyrme()
+                   ? V_cell * potentials_->skyrme_energy_density(baryon_density)
+                   : 0.;
+      });
     }
     if (potentials_->use_coulomb()) {
-      update_lattice(jmu_el_lat_.get(), LatticeUpdate::EveryTimestep,
-                     DensityType::Charge, density_param_, ensembles_, true);
-      for (size_t i = 0; i < EM_lat_->size(); i++) {
-        ThreeVector electric_field = {0., 0., 0.};
-        ThreeVector position = jmu_el_lat_->cell_center(i);
-        jmu_el_lat_->integrate_volume(electric_field,
-                                      Potentials::E_field_integrand,
-                                      potentials_->coulomb_r_cut(), position);
-        ThreeVector magnetic_field = {0., 0., 0.};
-        jmu_el_lat_->integrate_volume(magnetic_field,
-                                      Potentials::B_field_integrand,
-                                      potentials_->coulomb_r_cut(), position);
-        (*EM_lat_)[i] = std::make_pair(electric_field, magnetic_field);
+      const double V_cell_em = EM_lat_->cell_sizes()[0] *
+                               EM_lat_->cell_sizes()[1] *
+                               EM_lat_->cell_sizes()[2];
+      // Energy is 0.5 * int E^2 + B^2 dV
+      auto field_energy = [&](int i) {
+        const std::pair<ThreeVector, ThreeVector> fields = EM_lat_->get(i);
+        return hbarc * 0.5 * V_cell_em *
+               (fields.first.sqr() + fields.second.sqr());
+      };
+      if (em_field_solver_) {
+        em_field_solver_->compute(*jmu_el_lat_, *EM_lat_);
+        mean_field_energy += sum_over_nodes(EM_lat_->size(), field_energy);
+      } else {
+        mean_field_energy += sum_over_nodes(EM_lat_->size(), [&](int i) {
+          ThreeVector electric_field = {0., 0., 0.};
+          ThreeVector position = jmu_el_lat_->cell_center(i);
+          jmu_el_lat_->integrate_volume(electric_field,
+                                        Potentials::E_field_integrand,
+                                        potentials_->coulomb_r_cut(), position);
+          ThreeVector magnetic_field = {0., 0., 0.};
+          jmu_el_lat_->integrate_volume(magnetic_field,
+                                        Potentials::B_field_integrand,
+                                        potentials_->coulomb_r_cut(), position);
+          EM_lat_->set(i, std::make_pair(electric_field, magnetic_field));
+          return field_energy(i);
+        });
       }
     }  // if ((potentials_->use_skyrme() || ...
     if (potentials_->use_vdf() && jmu_B_lat_ != nullptr) {
-      update_lattice(jmu_B_lat_.get(), old_jmu_auxiliary_.get(),
-                     new_jmu_auxiliary_.get(), four_gradient_auxiliary_.get(),
-                     LatticeUpdate::EveryTimestep, DensityType::Baryon,
-                     density_param_, ensembles_,
-                     parameters_.labclock->timestep_duration(), true);
       if (parameters_.field_derivatives_mode == FieldDerivativesMode::Direct) {
         update_fields_lattice(
             fields_lat_.get(), old_fields_auxiliary_.get(),
             new_fields_auxiliary_.get(), fields_four_gradient_auxiliary_.get(),
             jmu_B_lat_.get(), LatticeUpdate::EveryTimestep, *potentials_,
-            parameters_.labclock->timestep_duration());
+            time_step, thread_pool_.get());
       }
-      const size_t UBlattice_size = UB_lat_->size();
-      for (size_t i = 0; i < UBlattice_size; i++) {
-        auto jB = (*jmu_B_lat_)[i];
+      mean_field_energy += sum_over_potential_nodes([&](int i) {
+        const DensityOnLattice &jB = (*jmu_B_lat_)[i];
         (*UB_lat_)[i] = potentials_->vdf_pot(jB.rho(), jB.jmu_net());
         switch (parameters_.field_derivatives_mode) {
           case FieldDerivativesMode::ChainRule:
-            (*FB_lat_)[i] = potentials_->vdf_force(
-                jB.rho(), jB.drho_dxnu().x0(), jB.drho_dxnu().threevec(),
-                jB.grad_rho_cross_vecj(), jB.jmu_net().x0(), jB.grad_j0(),
-                jB.jmu_net().threevec(), jB.dvecj_dt(), jB.curl_vecj());
+            FB_lat_->set(
+                i, potentials_->vdf_force(
+                       jB.rho(), jB.drho_dxnu().x0(), jB.drho_dxnu().threevec(),
+                       jB.grad_rho_cross_vecj(), jB.jmu_net().x0(),
+                       jB.grad_j0(), jB.jmu_net().threevec(), jB.dvecj_dt(),
+                       jB.curl_vecj()));
             break;
           case FieldDerivativesMode::Direct:
-            auto Amu = (*fields_lat_)[i];
-            (*FB_lat_)[i] = potentials_->vdf_force(
-                Amu.grad_A0(), Amu.dvecA_dt(), Amu.curl_vecA());
+            const FieldsOnLattice &Amu = (*fields_lat_)[i];
+            FB_lat_->set(i, potentials_->vdf_force(Amu.grad_A0(),
+                                                   Amu.dvecA_dt(),
+                                                   Amu.curl_vecA()));
             break;
         }
-      }  // for (size_t i = 0; i < UBlattice_size; i++)
-    }    // if potentials_->use_vdf()
+        return V_cell *
+               potentials_->vdf_energy_density(jB.rho(), jB.jmu_net().x0());
+      });
+    }  // if potentials_->use_vdf()
+    mean_field_energy_ = mean_field_energy * parameters_.testparticles *
+                         parameters_.n_ensembles;
+
+    if (potentials_refresh_) {
+      if (UB_lat_ && potentials_refresh_->steps_since_refresh() > 1) {
+        const int n_nodes = UB_lat_->size();
+        double deviation = 0.;
+        for (int i = 0; i < n_nodes; i++) {
+          const double U = (*UB_lat_)[i].x0();
+          deviation = std::max(
+              deviation, std::abs(U - UB_history_.predict(i, time).x0()));
+        }
+        potentials_refresh_->add_deviation(deviation);
+      }
+      potentials_refresh_->refreshed(jmu_B ? *jmu_B : *jmu_el);
+      for_each_potentials_history(
+          [time](auto &lat, auto &history) { history.record(lat, time); });
+    }
   }
 }
 
 template <typename Modus>
 void Experiment<Modus>::do_final_decays() {
+  const Profiler::ScopedTimer timer(profiler_.get(),
+                                    Profiler::Phase::FinalDecays);
   /* At end of time evolution: Force all resonances to decay. In order to handle
    * decay chains, we need to loop until no further actions occur. */
   bool actions_performed, decays_found;
@@ -2835,26 +4970,56 @@ void Experiment<Modus>::do_final_decays() {
   do {
     decays_found = false;
     interactions_old = interactions_total_;
-    for (int i_ens = 0; i_ens < parameters_.n_ensembles; i_ens++) {
-      Actions actions;
-
-      // Dileptons: shining of remaining resonances
-      if (dilepton_finder_ != nullptr) {
-        for (const auto &output : outputs_) {
-          dilepton_finder_->shine_final(ensembles_[i_ens], output.get(), true);
-        }
+    // Dileptons: shining of remaining resonances
+    if (dilepton_finder_ != nullptr) {
+      for (Particles &particles : ensembles_) {
+        write_dilepton_actions(
+            dilepton_finder_->final_shining_actions(particles, true));
       }
-      // Find actions.
+    }
+    /* The decays of all ensembles are found and their final states are
+     * generated concurrently, every decay with its own random stream, such
+     * that the result does not depend on the threads. The decays are
+     * performed in the order of the ensembles, which keeps the output in a
+     * fixed order. */
+    std::vector<Actions> actions(parameters_.n_ensembles);
+    std::vector<random::Engine::result_type> seeds(parameters_.n_ensembles);
+    for_each_ensemble([&](int i_ens) {
+      seeds[i_ens] = random::advance();
       for (const auto &finder : action_finders_) {
-        auto found_actions = finder->find_final_actions(ensembles_[i_ens]);
-        if (!found_actions.empty()) {
-          actions.insert(std::move(found_actions));
-          decays_found = true;
+        actions[i_ens].insert(finder->find_final_actions(ensembles_[i_ens]));
+      }
+    });
+    std::vector<std::pair<DecayAction *, random::Engine>> decays;
+    for (int i_ens = 0; i_ens < parameters_.n_ensembles; i_ens++) {
+      std::uint64_t stream = 0;
+      for (const ActionPtr &action : actions[i_ens]) {
+        decays_found = true;
+        if (auto *decay = dynamic_cast<DecayAction *>(action.get())) {
+          decays.emplace_back(decay, random::Engine(seeds[i_ens], ++stream));
         }
       }
-      // Perform actions.
-      while (!actions.is_empty()) {
-        perform_action(*actions.pop(), i_ens, false);
+    }
+    auto generate = [&](int i) {
+      random::EngineGuard guard(decays[i].second);
+      try {
+        decays[i].first->generate_final_state_in_advance();
+      } catch (const std::exception &) {
+        // The error is raised again when the action is performed
+      }
+    };
+    const int n_decays = decays.size();
+    if (thread_pool_) {
+      thread_pool_->parallel_for(n_decays, generate);
+    } else {
+      for (int i = 0; i < n_decays; i++) {
+        generate(i);
+      }
+    }
+    for (int i_ens = 0; i_ens < parameters_.n_ensembles; i_ens++) {
+      random::EngineGuard guard(ensemble_engines_[i_ens]);
+      while (!actions[i_ens].is_empty()) {
+        perform_action(*actions[i_ens].pop(), i_ens, false);
       }
     }
     actions_performed = interactions_total_ > interactions_old;
@@ -2867,16 +5032,17 @@ void Experiment<Modus>::do_final_decays() {
 
   // Dileptons: shining of stable particles at the end
   if (dilepton_finder_ != nullptr) {
-    for (const auto &output : outputs_) {
-      for (Particles &particles : ensembles_) {
-        dilepton_finder_->shine_final(particles, output.get(), false);
-      }
+    for (Particles &particles : ensembles_) {
+      write_dilepton_actions(
+          dilepton_finder_->final_shining_actions(particles, false));
     }
   }
 }
 
 template <typename Modus>
 void Experiment<Modus>::final_output() {
+  const Profiler::ScopedTimer timer(profiler_.get(), Profiler::Phase::Output);
+  summarize_rate_limited_warnings();
   /* make sure the experiment actually ran (note: we should compare this
    * to the start time, but we don't know that. Therefore, we check that
    * the time is positive, which should heuristically be the same). */
@@ -2890,26 +5056,25 @@ void Experiment<Modus>::final_output() {
     if (potentials_) {
       // using the lattice is necessary
       if ((jmu_B_lat_ != nullptr)) {
-        E_mean_field = calculate_mean_field_energy(*potentials_, *jmu_B_lat_,
-                                                   EM_lat_.get(), parameters_);
+        E_mean_field = mean_field_energy_;
       }
     }
-    if (std::abs(parameters_.labclock->current_time() - end_time_) >
-        really_small) {
+    if (!equilibrium_time_ &&
+        std::abs(parameters_.labclock->current_time() - end_time_) >
+            really_small) {
       logg[LExperiment].warn()
           << "SMASH not propagated until configured end time. Current time = "
           << parameters_.labclock->current_time()
           << "fm. End time = " << end_time_ << "fm.";
     } else {
+      // A box stopped at its equilibrium ends before the end time
       logg[LExperiment].info() << format_measurements(
-          ensembles_, interactions_this_interval, conserved_initial_,
-          time_start_, end_time_, E_mean_field, initial_mean_field_energy_);
-    }
-    int total_particles = 0;
-    for (const Particles &particles : ensembles_) {
-      total_particles += particles.size();
+          current_conserved_quantities(), total_particle_number(),
+          interactions_this_interval, conserved_initial_, time_start_,
+          equilibrium_time_ ? parameters_.labclock->current_time() : end_time_,
+          E_mean_field, initial_mean_field_energy_);
     }
-    if (IC_output_switch_ && (total_particles == 0)) {
+    if (IC_output_switch_ && (total_particle_number() == 0)) {
       const double initial_system_energy_plus_Pythia_violations =
           conserved_initial_.momentum().x0() + total_energy_violated_by_Pythia_;
       const double fraction_of_total_system_energy_removed =
@@ -2991,11 +5156,12 @@ void Experiment<Modus>::final_output() {
   for (const auto &output : outputs_) {
     for (int i_ens = 0; i_ens < parameters_.n_ensembles; i_ens++) {
       auto event_info = fill_event_info(
-          ensembles_, E_mean_field, modus_.impact_parameter(), parameters_,
+          ensembles_, E_mean_field, modus_.impact_parameter(),
+          modus_.event_weight(), parameters_,
           projectile_target_interact_[i_ens], kinematic_cuts_for_IC_output_);
       output->at_eventend(ensembles_[i_ens],
                           // Pretend each ensemble is an independent event
-                          event_ * parameters_.n_ensembles + i_ens, event_info);
+                          global_ensemble_number(i_ens), event_info);
     }
     // For thermodynamic output
     output->at_eventend(ensembles_, event_);
@@ -3027,6 +5193,10 @@ void Experiment<Modus>::final_output() {
       output->at_eventend(ThermodynamicQuantity::j_QBS);
     }
   }
+  // The output of the previous event has to be written by now
+  for (AsyncOutput *output : overlapping_outputs_) {
+    output->end_event();
+  }
 }
 
 template <typename Modus>
@@ -3069,14 +5239,434 @@ void Experiment<Modus>::increase_event_number() {
   event_++;
 }
 
+template <typename Modus>
+int64_t Experiment<Modus>::draw_next_event_seed() {
+  int64_t r = random::advance();
+  while (r == INT64_MIN) {
+    r = random::advance();
+  }
+  return std::abs(r);
+}
+
+template <typename Modus>
+void Experiment<Modus>::run_with_event_workers() {
+  const int n_events = event_counting_ == EventCounting::FixedNumber
+                           ? nevents_
+                           : max_events_;
+  std::vector<Experiment<Modus> *> workers = {this};
+  for (const auto &worker : event_workers_) {
+    workers.push_back(worker.get());
+  }
+  // Events are handed out in order, together with their random seed
+  std::mutex dispatch_mutex;
+  int next_event = 0;
+  int64_t next_seed = seed_;
+  // Only modified in the bookkeeping of the merger, i.e. in order of events
+  int nonempty_ensembles = 0;
+
+  auto work = [&](int i_worker) {
+    Experiment<Modus> &worker = *workers[i_worker];
+    while (true) {
+      {
+        std::lock_guard<std::mutex> lock(dispatch_mutex);
+        if (next_event >= n_events || !output_merger_->accepts(next_event)) {
+          return;
+        }
+        worker.event_ = next_event++;
+        worker.seed_ = next_seed;
+        random::Engine event_engine(next_seed);
+        random::EngineGuard guard(event_engine);
+        next_seed = draw_next_event_seed();
+      }
+      try {
+        logg[LMain].info() << "Event " << worker.event_;
+        const int nonempty_before = worker.nonempty_ensembles_;
+        worker.initialize_new_event();
+        worker.run_time_evolution(end_time_);
+        if (force_decays_) {
+          worker.do_final_decays();
+        }
+        worker.final_output();
+        worker.end_profiled_event();
+        worker.report_memory_usage();
+        const int event = worker.event_;
+        const int nonempty = worker.nonempty_ensembles_ - nonempty_before;
+        output_merger_->submit(event, worker.outputs_, [&, event, nonempty]() {
+          nonempty_ensembles += nonempty;
+          if (event_counting_ == EventCounting::MinimumNonEmpty &&
+              nonempty_ensembles >= minimum_nonempty_ensembles_) {
+            output_merger_->set_last_event(event);
+          }
+        });
+      } catch (...) {
+        // Later events would never be written, stop all workers
+        output_merger_->set_last_event(-1);
+        throw;
+      }
+    }
+  };
+  ThreadPool pool(n_event_workers_);
+  pool.parallel_for(n_event_workers_, work);
+
+  event_ = output_merger_->written_events();
+  nonempty_ensembles_ = nonempty_ensembles;
+  if (event_counting_ == EventCounting::MinimumNonEmpty) {
+    // Warns if the maximum number of events was reached
+    is_finished();
+  }
+}
+
+template <typename Modus>
+void Experiment<Modus>::end_profiled_event() {
+  if (!profiler_) {
+    return;
+  }
+  std::int64_t n_particles = 0;
+  for (const Particles &particles : ensembles_) {
+    n_particles += particles.size();
+  }
+  const std::string table = profiler_->end_event(event_, n_particles);
+  if (profile_phases_) {
+    logg[LExperiment].info() << table;
+  }
+}
+
+template <typename Modus>
+void Experiment<Modus>::report_profile() {
+  if (!profiler_) {
+    return;
+  }
+  for (const auto &worker : event_workers_) {
+    profiler_->merge(*worker->profiler_);
+  }
+  if (profile_phases_) {
+    logg[LExperiment].info() << profiler_->run_table();
+    profiler_->write_json();
+  }
+  if (profiler_->is_tracing()) {
+    profiler_->write_trace();
+  }
+}
+
+template <typename Modus>
+void Experiment<Modus>::adapt_time_step(double dt, std::uint64_t scatterings,
+                                        double force_time_scale) {
+  // Fraction of the time scales covered by one time step
+  constexpr double safety_factor = 0.1;
+  double next_dt = std::min(2. * adaptive_delta_time_,
+                            safety_factor * force_time_scale);
+  std::size_t n_particles = 0;
+  for (const Particles &particles : ensembles_) {
+    n_particles += particles.size();
+  }
+  if (scatterings > 0 && n_particles > 0) {
+    const double scattering_time = n_particles * dt / scatterings;
+    next_dt = std::min(next_dt, safety_factor * scattering_time);
+  }
+  next_dt = std::clamp(next_dt, min_delta_time_, max_delta_time_);
+  if (next_dt != adaptive_delta_time_) {
+    logg[LExperiment].debug("Time step changes from ", adaptive_delta_time_,
+                            " fm to ", next_dt, " fm at ",
+                            parameters_.labclock->current_time(), " fm");
+    adaptive_delta_time_ = next_dt;
+    // The lab clock is always a UniformClock, see initialize_new_event
+    static_cast<UniformClock &>(*parameters_.labclock)
+        .set_timestep_duration(next_dt);
+  }
+}
+
+template <typename Modus>
+void Experiment<Modus>::choose_collision_search(std::uint64_t pairs) {
+  const bool sweep = step_search_ == CollisionSearch::Sweep;
+  search_pairs_[sweep] = pairs;
+  if (search_probe_) {
+    search_probe_ = false;
+    steps_since_search_probe_ = 0;
+    const CollisionSearch better = search_pairs_[1] < search_pairs_[0]
+                                       ? CollisionSearch::Sweep
+                                       : CollisionSearch::Grid;
+    if (better != step_search_) {
+      logg[LExperiment].debug("Continuing the collision search with the ",
+                              sweep ? "grid" : "sweep", ", pairs: ",
+                              search_pairs_[0], " (grid), ", search_pairs_[1],
+                              " (sweep)");
+    }
+    step_search_ = better;
+  } else if (++steps_since_search_probe_ >= search_probe_interval) {
+    search_probe_ = true;
+    step_search_ = sweep ? CollisionSearch::Grid : CollisionSearch::Sweep;
+  }
+}
+
+template <typename Modus>
+void Experiment<Modus>::update_memory_usage() {
+  using Subsystem = MemoryUsage::Subsystem;
+  std::size_t particles = 0, grids = 0, actions = 0;
+  for (const Particles &ensemble : ensembles_) {
+    particles += ensemble.memory_usage();
+  }
+  for (const auto &grid : grids_) {
+    if (grid) {
+      grids += grid->memory_usage();
+    }
+  }
+  for (const SweepAndPrune &sweep : sweeps_) {
+    grids += sweep.memory_usage();
+  }
+  for (const TimesteplessGrid &grid : timestepless_grids_) {
+    grids += grid.memory_usage();
+  }
+  for (const Actions &ensemble_actions : actions_) {
+    actions += ensemble_actions.memory_usage();
+  }
+  std::size_t lattices = 0;
+  for_each_lattice([&lattices](const auto &lattice) {
+    if (lattice) {
+      lattices += lattice->memory_usage();
+    }
+  });
+  std::size_t outputs = 0;
+  for (const auto &output : outputs_) {
+    outputs += output->buffer_size();
+  }
+  memory_usage_->set(Subsystem::Particles, particles);
+  memory_usage_->set(Subsystem::Grids, grids);
+  memory_usage_->set(Subsystem::Actions, actions);
+  memory_usage_->set(Subsystem::Lattices, lattices);
+  memory_usage_->set(Subsystem::Tabulations, Tabulation::allocated_bytes());
+  memory_usage_->set(Subsystem::Outputs, outputs);
+  if (process_string_ptr_ != NULL) {
+    memory_usage_->set_pythia_instances(
+        process_string_ptr_->n_pythia_instances());
+  }
+  memory_usage_->check_limit();
+}
+
+template <typename Modus>
+void Experiment<Modus>::report_memory_usage() {
+  if (!memory_usage_) {
+    return;
+  }
+  update_memory_usage();
+  if (report_memory_) {
+    logg[LExperiment].info() << memory_usage_->report();
+  }
+}
+
+template <typename Modus>
+void Experiment<Modus>::write_checkpoint() {
+  const Profiler::ScopedSpan span(profiler_.get(), "Checkpoint");
+  grids_.clear();
+  grids_.resize(parameters_.n_ensembles);
+
+  const std::filesystem::path temporary = checkpoint_path_.string() + ".tmp";
+  {
+    std::ofstream out(temporary, std::ios::binary);
+    checkpoint::write(out, checkpoint::magic);
+    checkpoint::write(out, checkpoint::version);
+    checkpoint::write(out, parameters_.n_ensembles);
+    checkpoint::write(out, parameters_.testparticles);
+    checkpoint::write(out, ParticleType::list_all().size());
+    checkpoint::write(out, event_);
+    checkpoint::write(out, event_seed_);
+
+    checkpoint::write(out, nonempty_ensembles_);
+    checkpoint::write(out, ensembles_forked_);
+    checkpoint::write(out, next_checkpoint_time_);
+    checkpoint::write(out, parameters_.labclock->ticks());
+    checkpoint::write(out, parameters_.outputclock->ticks());
+    checkpoint::write(out, parameters_.labclock->current_time());
+    checkpoint::write(out, adaptive_delta_time_);
+    checkpoint::write(out, random::engine);
+    checkpoint::write(out, ensemble_engines_);
+    checkpoint::write(out, interactions_total_);
+    checkpoint::write(out, ensemble_interactions_);
+    checkpoint::write(out, previous_interactions_total_);
+    checkpoint::write(out, wall_actions_total_);
+    checkpoint::write(out, previous_wall_actions_total_);
+    checkpoint::write(out, discarded_interactions_total_);
+    checkpoint::write(out, total_pauli_blocked_);
+    checkpoint::write(out, total_hypersurface_crossing_actions_);
+    checkpoint::write(out, total_energy_removed_);
+    checkpoint::write(out, total_energy_violated_by_Pythia_);
+    checkpoint::write(out, conserved_initial_);
+    checkpoint::write(out, current_conserved_quantities());
+    checkpoint::write(out, initial_mean_field_energy_);
+    checkpoint::write(out, event_collisions_);
+    checkpoint::write(out, projectile_target_interact_);
+    checkpoint::write(out, beam_momentum_);
+    for (const Particles &particles : ensembles_) {
+      particles.write_checkpoint(out);
+    }
+    for_each_lattice([&out](const auto &lattice) {
+      checkpoint::write(out, static_cast<bool>(lattice));
+      if (lattice) {
+        lattice->write_checkpoint(out);
+      }
+    });
+    for_each_potentials_history([&out](auto &, auto &history) {
+      history.write_checkpoint(out);
+    });
+    if (potentials_refresh_) {
+      potentials_refresh_->write_checkpoint(out);
+    }
+    if (!out) {
+      throw std::runtime_error("Could not write the checkpoint to " +
+                               temporary.string());
+    }
+  }
+  std::filesystem::rename(temporary, checkpoint_path_);
+  logg[LExperiment].info("Wrote checkpoint of event ", event_, " at t = ",
+                         parameters_.labclock->current_time(), " fm.");
+}
+
+template <typename Modus>
+void Experiment<Modus>::resume_from_checkpoint() {
+  std::ifstream in(restart_path_, std::ios::binary);
+  if (!in) {
+    throw std::runtime_error("Could not open the checkpoint " +
+                             restart_path_.string());
+  }
+  particle_extents_.assign(parameters_.n_ensembles, std::nullopt);
+  char magic[sizeof(checkpoint::magic)];
+  std::uint32_t version = 0;
+  checkpoint::read(in, magic);
+  checkpoint::read(in, version);
+  if (std::string(magic) != checkpoint::magic ||
+      version != checkpoint::version) {
+    throw std::runtime_error(restart_path_.string() +
+                             " is not a checkpoint of this version of SMASH.");
+  }
+  int n_ensembles = 0, testparticles = 0;
+  std::size_t n_types = 0;
+  checkpoint::read(in, n_ensembles);
+  checkpoint::read(in, testparticles);
+  checkpoint::read(in, n_types);
+  if (n_ensembles != parameters_.n_ensembles ||
+      testparticles != parameters_.testparticles ||
+      n_types != ParticleType::list_all().size()) {
+    throw std::runtime_error(
+        "The checkpoint was written with another number of ensembles, test "
+        "particles or particle types.");
+  }
+  checkpoint::read(in, event_);
+  checkpoint::read(in, seed_);
+  logg[LExperiment].info("Resuming event ", event_, " from ",
+                         restart_path_.string());
+  initialize_new_event();
+
+  Clock::Representation lab_ticks = 0, output_ticks = 0;
+  checkpoint::read(in, nonempty_ensembles_);
+  checkpoint::read(in, ensembles_forked_);
+  checkpoint::read(in, next_checkpoint_time_);
+  checkpoint::read(in, lab_ticks);
+  checkpoint::read(in, output_ticks);
+  double lab_time = 0.;
+  checkpoint::read(in, lab_time);
+  checkpoint::read(in, adaptive_delta_time_);
+  if (time_step_mode_ == TimeStepMode::Adaptive) {
+    // The ticks of the lab clock only count since the last change of dt
+    parameters_.labclock = std::make_unique<UniformClock>(
+        lab_time, adaptive_delta_time_, end_time_);
+  } else {
+    *parameters_.labclock += lab_ticks;
+  }
+  *parameters_.outputclock += output_ticks;
+  checkpoint::read(in, random::engine);
+  checkpoint::read(in, ensemble_engines_);
+  checkpoint::read(in, interactions_total_);
+  checkpoint::read(in, ensemble_interactions_);
+  checkpoint::read(in, previous_interactions_total_);
+  checkpoint::read(in, wall_actions_total_);
+  checkpoint::read(in, previous_wall_actions_total_);
+  checkpoint::read(in, discarded_interactions_total_);
+  checkpoint::read(in, total_pauli_blocked_);
+  checkpoint::read(in, total_hypersurface_crossing_actions_);
+  checkpoint::read(in, total_energy_removed_);
+  checkpoint::read(in, total_energy_violated_by_Pythia_);
+  checkpoint::read(in, conserved_initial_);
+  checkpoint::read(in, conserved_current_);
+  conserved_current_outdated_ = false;
+  checkpoint::read(in, initial_mean_field_energy_);
+  checkpoint::read(in, event_collisions_);
+  checkpoint::read(in, projectile_target_interact_);
+  // Separated nuclei are detected again in the next time step
+  nuclei_separated_.assign(parameters_.n_ensembles, false);
+  checkpoint::read(in, beam_momentum_);
+  for (Particles &particles : ensembles_) {
+    particles.read_checkpoint(in);
+  }
+  for_each_lattice([&in](auto &lattice) {
+    bool present = false;
+    checkpoint::read(in, present);
+    if (present != static_cast<bool>(lattice)) {
+      throw std::runtime_error(
+          "The lattices of the checkpoint do not match the configuration.");
+    }
+    if (lattice) {
+      lattice->read_checkpoint(in);
+    }
+  });
+  for_each_potentials_history(
+      [&in](auto &, auto &history) { history.read_checkpoint(in); });
+  if (potentials_refresh_) {
+    potentials_refresh_->read_checkpoint(in);
+  }
+  if (potentials_ && jmu_B_lat_) {
+    mean_field_energy_ = calculate_mean_field_energy(
+        *potentials_, *jmu_B_lat_, EM_lat_.get(), parameters_);
+  }
+  logg[LExperiment].info("Resumed at t = ",
+                         parameters_.labclock->current_time(), " fm.");
+}
+
+template <typename Modus>
+void Experiment<Modus>::fork_ensembles() {
+  for (int i_ens = 1; i_ens < parameters_.n_ensembles; i_ens++) {
+    ensembles_[i_ens].copy_from(ensembles_[0]);
+    particle_extents_[i_ens] = particle_extents_[0];
+    /* The forks only differ by their random streams, which start anew.
+     * The first ensemble continues with its stream. */
+    ensemble_engines_[i_ens].seed(event_seed_, i_ens + 1);
+  }
+  relocate_ensembles();
+  // The conserved quantities now refer to all ensembles
+  conserved_initial_ = QuantumNumbers(ensembles_);
+  conserved_current_ = conserved_initial_;
+  conserved_current_outdated_ = false;
+  ensembles_forked_ = true;
+  logg[LExperiment].info("Forked the first ensemble into ",
+                         parameters_.n_ensembles, " ensembles at t = ",
+                         parameters_.labclock->current_time(), " fm.");
+}
+
 template <typename Modus>
 void Experiment<Modus>::run() {
+  if (output_merger_) {
+    run_with_event_workers();
+    for (const auto &output : outputs_) {
+      output->at_runend();
+    }
+    report_profile();
+    return;
+  }
   const auto &mainlog = logg[LMain];
-  for (event_ = 0; !is_finished(); event_++) {
+  // The event of a checkpoint is already initialized when it is resumed
+  bool resumed_event = !restart_path_.empty();
+  if (resumed_event) {
+    resume_from_checkpoint();
+  } else {
+    event_ = 0;
+  }
+  for (; !is_finished(); event_++) {
     mainlog.info() << "Event " << event_;
 
-    // Sample initial particles, start clock, some printout and book-keeping
-    initialize_new_event();
+    if (resumed_event) {
+      resumed_event = false;
+    } else {
+      // Sample initial particles, start clock, some printout and book-keeping
+      initialize_new_event();
+    }
 
     run_time_evolution(end_time_);
 
@@ -3086,7 +5676,73 @@ void Experiment<Modus>::run() {
 
     // Output at event end
     final_output();
+    end_profiled_event();
+    report_memory_usage();
+  }
+  for (const auto &output : outputs_) {
+    output->at_runend();
+  }
+  report_profile();
+}
+
+template <typename Modus>
+std::vector<int> Experiment<Modus>::run(EventDispatcher &dispatcher) {
+  if (output_merger_) {
+    throw std::invalid_argument(
+        "Event workers cannot be used when the events are distributed over "
+        "several processes.");
+  }
+  if (modus_.is_list()) {
+    throw std::invalid_argument(
+        "The events of the list modus are read one after another from the "
+        "input files and cannot be distributed over several processes.");
+  }
+  if (!restart_path_.empty()) {
+    throw std::invalid_argument(
+        "A checkpoint cannot be resumed when the events are distributed over "
+        "several processes.");
+  }
+  const int n_events = event_counting_ == EventCounting::FixedNumber
+                           ? nevents_
+                           : max_events_;
+  std::vector<int> events;
+  // seed_ is the seed of this event, the seeds of later ones follow from it
+  int seed_event = 0;
+  int nonempty_reported = 0;
+  while (true) {
+    int nonempty_total = 0;
+    const int event = dispatcher.take_event(
+        nonempty_ensembles_ - nonempty_reported, nonempty_total);
+    nonempty_reported = nonempty_ensembles_;
+    if (event >= n_events ||
+        (event_counting_ == EventCounting::MinimumNonEmpty &&
+         nonempty_total >= minimum_nonempty_ensembles_)) {
+      break;
+    }
+    for (; seed_event < event; seed_event++) {
+      random::Engine event_engine(seed_);
+      random::EngineGuard guard(event_engine);
+      seed_ = draw_next_event_seed();
+    }
+    event_ = event;
+    logg[LMain].info() << "Event " << event_;
+    // This draws the seed of the following event
+    initialize_new_event();
+    seed_event = event + 1;
+    run_time_evolution(end_time_);
+    if (force_decays_) {
+      do_final_decays();
+    }
+    final_output();
+    end_profiled_event();
+    report_memory_usage();
+    events.push_back(event);
+  }
+  for (const auto &output : outputs_) {
+    output->at_runend();
   }
+  report_profile();
+  return events;
 }
 
 }  // namespace smash
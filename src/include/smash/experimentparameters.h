@@ -1,5 +1,5 @@
 /*
- *    Copyright (c) 2014-2023
+ *    Copyright (c) 2014-2024
  *      SMASH Team
  *
  *    GNU General Public License (GPLv3 or later)
@@ -12,6 +12,7 @@
 #include <set>
 
 #include "clock.h"
+#include "forwarddeclarations.h"
 
 namespace smash {
 
@@ -58,6 +59,9 @@ struct ExperimentParameters {
   /// triangular smearing uses
   double triangular_range;
 
+  /// Whether to smear densities on the lattice by Fourier transforms
+  bool fft_smearing;
+
   /// Employed collision criterion
   const CollisionCriterion coll_crit;
 
@@ -159,6 +163,19 @@ struct ExperimentParameters {
    * created.
    */
   std::optional<bool> use_monash_tune_default;
+
+  /**
+   * Processes, over which the ensembles of an event are distributed, or
+   * nullptr if this process evolves all of them. n_ensembles then counts the
+   * ensembles of this process.
+   */
+  EnsembleCommunicator *ensemble_communicator = nullptr;
+
+  /// Index of the first ensemble of this process among all ensembles
+  int first_ensemble = 0;
+
+  /// Number of the ensembles of all processes
+  int n_ensembles_total = 0;
 };
 
 }  // namespace smash
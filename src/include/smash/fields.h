@@ -50,14 +50,14 @@ class FieldsOnLattice {
    * \return The time derivative of the 3-vector part of A^mu on the local
    * lattice
    */
-  ThreeVector dvecA_dt() { return dAmu_dxnu_[0].threevec(); }
+  ThreeVector dvecA_dt() const { return dAmu_dxnu_[0].threevec(); }
 
   /**
    * Compute the gradient of A^0 on the local lattice
    *
    * \return \f$\nabla A^0\f$
    */
-  ThreeVector grad_A0() {
+  ThreeVector grad_A0() const {
     ThreeVector A_0_grad = ThreeVector();
     for (int i = 1; i < 4; i++) {
       A_0_grad[i - 1] = dAmu_dxnu_[i].x0();
@@ -70,7 +70,7 @@ class FieldsOnLattice {
    *
    * \return \f$\boldsymbol{\nabla}\times\mathbf{A}\f$
    */
-  ThreeVector curl_vecA() {
+  ThreeVector curl_vecA() const {
     ThreeVector curl_vec_A = ThreeVector();
     curl_vec_A.set_x1(dAmu_dxnu_[2].x3() - dAmu_dxnu_[3].x2());
     curl_vec_A.set_x2(dAmu_dxnu_[3].x1() - dAmu_dxnu_[1].x3());
@@ -137,6 +137,7 @@ typedef RectangularLattice<FieldsOnLattice> FieldsLattice;
  *            timestep
  * \param[in] potentials mean-field potentials used in the simulation
  * \param[in] time_step Time step used in the simulation
+ * \param[in] pool Threads used to update the nodes, serial if nullptr
  */
 
 void update_fields_lattice(
@@ -145,7 +146,8 @@ void update_fields_lattice(
     RectangularLattice<FourVector> *new_fields,
     RectangularLattice<std::array<FourVector, 4>> *fields_four_grad_lattice,
     DensityLattice *jmu_B_lat, const LatticeUpdate fields_lat_update,
-    const Potentials &potentials, const double time_step);
+    const Potentials &potentials, const double time_step,
+    ThreadPool *pool = nullptr);
 }  // namespace smash
 
 #endif  // SRC_INCLUDE_SMASH_FIELDS_H_
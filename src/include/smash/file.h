@@ -1,6 +1,6 @@
 /*
  *
- *    Copyright (c) 2014,2017-2018,2020,2022
+ *    Copyright (c) 2014,2017-2018,2020,2022,2024
  *      SMASH Team
  *
  *    GNU General Public License (GPLv3 or later)
@@ -17,6 +17,7 @@
 #include <memory>
 #include <stdexcept>
 #include <string>
+#include <string_view>
 
 #include "forwarddeclarations.h"
 
@@ -68,6 +69,12 @@ using FilePtr = std::unique_ptr<std::FILE, FileDeleter>;
  * Automatically closes and renames the file to the original when it goes out of
  * scope. If the object is destroyed because of stack unwinding, no renaming
  * is done.
+ *
+ * Optionally, everything written to the file is compressed in gzip format by
+ * a thread of its own, while the file is written through the usual `FILE*`.
+ * Every call of flush() closes a gzip member, such that e.g. each event can
+ * be decompressed on its own, starting from the offset after the previous
+ * one. Concatenated members are read as one stream by gzip tools and zlib.
  */
 class RenamingFilePtr {
  public:
@@ -77,18 +84,35 @@ class RenamingFilePtr {
    * \param[in] filename Path to the file.
    * \param[in] mode The mode in which the file should be opened (see
    *                 `std::fopen`).
+   * \param[in] compressed Whether the file is compressed in gzip format, in
+   *                       which case ".gz" is appended to the file name.
    * \return The constructed object.
+   * \throw std::invalid_argument if compression is not supported by this
+   *        build of SMASH.
    */
   RenamingFilePtr(const std::filesystem::path& filename,
-                  const std::string& mode);
+                  const std::string& mode, bool compressed = false);
   /// Get the underlying `FILE*` pointer.
   FILE* get();
+  /**
+   * Write the buffered data to the file and, if it is compressed, end the
+   * current gzip member.
+   */
+  void flush();
   /// Close the file and rename it.
   ~RenamingFilePtr();
 
+  /// \return Whether compressed files are supported by this build of SMASH.
+  static bool compression_supported();
+
  private:
+  /// Compresses the data written to the file in a thread of its own.
+  class Compressor;
+
   /// Internal file pointer.
   FILE* file_;
+  /// Compressor of a compressed file, owned by the file pointer.
+  Compressor* compressor_ = nullptr;
   /// Path of the finished file.
   std::filesystem::path filename_;
   /// Path of the unfinished file.
@@ -102,6 +126,38 @@ class RenamingFilePtr {
   int uncaught_exceptions_{std::uncaught_exceptions()};
 };
 
+/**
+ * A read-only file, which is mapped into memory.
+ *
+ * The content can be parsed in place without copying it into buffers. The
+ * mapping is removed, when the object goes out of scope.
+ */
+class MappedFile {
+ public:
+  /**
+   * Map a file into memory.
+   *
+   * \param[in] filename Path to the file.
+   * \throw std::runtime_error if the file cannot be opened or mapped.
+   */
+  explicit MappedFile(const std::filesystem::path& filename);
+  /// Unmap the file.
+  ~MappedFile();
+  /// Cannot be copied, since the mapping is unique.
+  MappedFile(const MappedFile&) = delete;
+  /// Cannot be assigned, since the mapping is unique.
+  MappedFile& operator=(const MappedFile&) = delete;
+
+  /// \return Content of the file, valid as long as the object exists.
+  std::string_view content() const { return {data_, size_}; }
+
+ private:
+  /// First byte of the mapping, `nullptr` for an empty file.
+  const char* data_ = nullptr;
+  /// Size of the file in bytes.
+  std::size_t size_ = 0;
+};
+
 /**
  * Open a file with given mode.
  *
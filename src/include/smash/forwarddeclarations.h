@@ -1,6 +1,6 @@
 /*
  *
- *    Copyright (c) 2014-2023
+ *    Copyright (c) 2014-2024
  *      SMASH Team
  *
  *    GNU General Public License (GPLv3 or later)
@@ -17,6 +17,8 @@
 #include <memory>
 #include <vector>
 
+#include "smallvector.h"
+
 #ifdef _LIBCPP_BEGIN_NAMESPACE_STD
 _LIBCPP_BEGIN_NAMESPACE_STD
 #else
@@ -63,6 +65,7 @@ class ThreeVector;
 class ModusDefault;
 class OutputInterface;
 class ParticleData;
+class ParticleCellList;
 class Particles;
 class ParticleType;
 class ParticleTypePtr;
@@ -71,6 +74,10 @@ class PdgCode;
 class DecayBranch;
 class CollisionBranch;
 class Tabulation;
+class TabulationArchive;
+class AdaptiveTabulation;
+class ThreadPool;
+class EnsembleCommunicator;
 class ExperimentBase;
 struct ExperimentParameters;
 struct ScatterActionsFinderParameters;
@@ -144,6 +151,21 @@ enum class TimeStepMode : char {
   None,
   /// Use fixed time step.
   Fixed,
+  /// Adapt the time step to the collision rate and the forces.
+  Adaptive,
+};
+
+/// How thoroughly the conservation laws are checked during the evolution.
+enum class ConservationCheck : char {
+  /// Don't check the conservation laws.
+  Off,
+  /**
+   * Check every n-th action, and the conserved quantities, which are updated
+   * by every action, after every time step.
+   */
+  Sampled,
+  /// Check every action and the sum over all particles after every time step.
+  Full,
 };
 
 /**
@@ -239,6 +261,16 @@ enum class CollisionCriterion {
   Covariant
 };
 
+/// How pairs of particles are searched for collisions.
+enum class CollisionSearch : char {
+  /// Search within and between neighboring cells of a grid.
+  Grid,
+  /// Search particles sorted along one axis (sweep and prune).
+  Sweep,
+  /// Choose the search with fewer examined pairs during the run.
+  Auto,
+};
+
 /// Whether and when only final state particles should be printed.
 enum class OutputOnlyFinal {
   /// Print only final-state particles.
@@ -349,7 +381,7 @@ using OutputsList = build_vector_<OutputPtr>;
 
 using ParticleList = build_vector_<ParticleData>;
 using ParticleTypeList = build_vector_<ParticleType>;
-using ParticleTypePtrList = build_vector_<ParticleTypePtr>;
+using ParticleTypePtrList = SmallVector<ParticleTypePtr, 4>;
 using IsoParticleTypeList = build_vector_<IsoParticleType>;
 
 template <typename T>
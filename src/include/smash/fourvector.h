@@ -1,5 +1,5 @@
 /*
- *    Copyright (c) 2013-2015,2017-2022
+ *    Copyright (c) 2013-2015,2017-2022,2024
  *      SMASH Team
  *
  *    GNU General Public License (GPLv3 or later)
@@ -490,6 +490,42 @@ void inline FourVector::reset() {
   this->x_[3] = 0.;
 }
 
+/**
+ * Lorentz boost by a fixed velocity, see FourVector::lorentz_boost. The
+ * factors, which only depend on the velocity, are computed once, such that
+ * many vectors are boosted by the same velocity for little more than the
+ * cost of the arithmetic.
+ */
+class LorentzBoost {
+ public:
+  /// \param[in] v boost 3-velocity
+  explicit LorentzBoost(const ThreeVector &v)
+      : v_(v),
+        gamma_(v.sqr() < 1. ? 1. / std::sqrt(1. - v.sqr()) : 0.),
+        factor_(gamma_ / (gamma_ + 1)) {}
+
+  /**
+   * Boost a vector.
+   *
+   * \param[in] x The vector to boost
+   * \return The boosted vector, which equals x.lorentz_boost(v)
+   */
+  FourVector operator()(const FourVector &x) const {
+    const double xprime_0 = gamma_ * (x.x0() - x.threevec() * v_);
+    // the part of the space-like components that is always the same
+    const double constantpart = factor_ * (xprime_0 + x.x0());
+    return FourVector(xprime_0, x.threevec() - v_ * constantpart);
+  }
+
+ private:
+  /// Boost 3-velocity
+  ThreeVector v_;
+  /// Gamma factor of the velocity, 0 if it is not below the speed of light
+  double gamma_;
+  /// \f$\gamma / (\gamma + 1)\f$, by which the space components are shifted
+  double factor_;
+};
+
 /**\ingroup logging
  * Writes the four components of the vector to the output stream.
  *
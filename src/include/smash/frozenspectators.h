@@ -0,0 +1,169 @@
+/*
+ *
+ *    Copyright (c) 2024
+ *      SMASH Team
+ *
+ *    GNU General Public License (GPLv3 or later)
+ *
+ */
+
+#ifndef SRC_INCLUDE_SMASH_FROZENSPECTATORS_H_
+#define SRC_INCLUDE_SMASH_FROZENSPECTATORS_H_
+
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+#include "forwarddeclarations.h"
+#include "particledata.h"
+#include "particlespan.h"
+
+namespace smash {
+
+/**
+ * \ingroup action
+ *
+ * Marks the spectators of a collider run, which cannot interact in the
+ * current time step, such that they are left out of the search for
+ * collisions.
+ *
+ * A spectator is a nucleon of the projectile or the target which did not
+ * collide yet. It can only collide with the particles which already
+ * interacted or were produced and, unless collisions within the same nucleus
+ * are allowed, with the spectators of the other nucleus. The positions of
+ * all these possible partners are enclosed in boxes. A spectator is frozen,
+ * if it is farther than the reach from each box of its possible partners.
+ * Within a time step, two particles approach each other by at most twice its
+ * duration, so the reach is chosen as the minimal cell length of the grid,
+ * which covers the interaction range, plus twice the duration of the time
+ * step. Frozen spectators keep being propagated, but are not put on the grid,
+ * and are released as soon as a partner comes into reach.
+ */
+class FrozenSpectators {
+ public:
+  /**
+   * \param[in] collisions_within_nucleus Whether the first collisions within
+   *            the same nucleus are allowed
+   */
+  explicit FrozenSpectators(bool collisions_within_nucleus)
+      : collisions_within_nucleus_(collisions_within_nucleus) {}
+
+  /**
+   * Decide which spectators are frozen at the beginning of a time step.
+   *
+   * \param[in] particles All particles of the ensemble
+   * \param[in] reach Distance from all possible partners, beyond which a
+   *            spectator is frozen [fm]
+   */
+  void update(const Particles &particles, double reach);
+
+  /**
+   * \param[in] p Particle of the ensemble passed to the last update
+   * \return Whether the particle is a frozen spectator
+   */
+  bool is_frozen(const ParticleData &p) const {
+    const std::size_t id = p.id();
+    return id < frozen_.size() && frozen_[id];
+  }
+
+  /// \return Number of frozen spectators since the last update
+  int n_frozen() const { return n_frozen_; }
+
+ private:
+  /// Whether first collisions within the same nucleus are allowed
+  bool collisions_within_nucleus_;
+  /// Whether the particle with the id of the index is frozen
+  std::vector<bool> frozen_;
+  /// Number of frozen spectators
+  int n_frozen_ = 0;
+};
+
+/**
+ * \ingroup action
+ *
+ * Marks the particles of a collider run, which escaped from the interacting
+ * core and cannot interact in the current time step, such that they are left
+ * out of the search for collisions. Only their decays are still searched.
+ *
+ * The core is enclosed by the box of the particles which interacted or were
+ * produced within the last time step. A particle escaped, if it is farther
+ * than the reach from the core box and no other particle is within reach.
+ * All particles within reach of such a particle are outside of the core box,
+ * hence only the particles outside of it are compared, sweeping along their
+ * longest extent. The reach is the same as for FrozenSpectators, so an
+ * escaped particle cannot interact in the time step. It is tested anew in
+ * the next one and returns to the search, once it comes into reach of
+ * another particle.
+ */
+class EscapedParticles {
+ public:
+  /**
+   * Decide which particles escaped at the beginning of a time step.
+   *
+   * \param[in] particles All particles of the ensemble
+   * \param[in] reach Distance from all other particles, beyond which a
+   *            particle escaped [fm]
+   * \param[in] since Time from which on interacting particles belong to the
+   *            core [fm]
+   */
+  void update(const Particles &particles, double reach, double since);
+
+  /**
+   * \param[in] p Particle of the ensemble passed to the last update
+   * \return Whether the particle escaped
+   */
+  bool is_escaped(const ParticleData &p) const {
+    const std::size_t id = p.id();
+    return id < is_escaped_.size() && is_escaped_[id];
+  }
+
+  /**
+   * \return The particles which escaped since the last update, valid until
+   *         the particles change
+   */
+  ParticleSpan particles() const { return ParticleSpan(escaped_); }
+
+  /// \return Number of escaped particles since the last update
+  int n_escaped() const { return static_cast<int>(escaped_.size()); }
+
+ private:
+  /// Whether the particle with the id of the index escaped
+  std::vector<bool> is_escaped_;
+  /// The escaped particles
+  std::vector<const ParticleData *> escaped_;
+  /**
+   * Particles outside of the core box with their coordinate along the sweep,
+   * kept to reuse the memory
+   */
+  std::vector<std::pair<double, const ParticleData *>> outside_;
+};
+
+/**
+ * \ingroup action
+ *
+ * Decide whether the projectile and the target of a collider run separate
+ * without having interacted, such that no particle can interact anymore.
+ *
+ * This is the case if all particles are stable spectators and the nuclei are
+ * farther apart than the reach along one axis, while every particle of the
+ * leading nucleus is at least as fast along it as every particle of the
+ * other one. The gap between the nuclei then never closes, which holds for
+ * nuclei which passed each other along the beam as well as for nuclei which
+ * miss each other at a large impact parameter. Forces are not taken into
+ * account, hence this must not be used with potentials.
+ *
+ * \param[in] particles All particles of the ensemble
+ * \param[in] reach Distance beyond which particles cannot interact [fm]
+ * \param[in] collisions_within_nucleus Whether the first collisions within
+ *            the same nucleus are allowed, which rules out separated nuclei
+ * \param[in] beam_momentum Momenta the nucleons are propagated with, if
+ *            their Fermi motion is frozen, else empty
+ * \return Whether no particle can interact anymore
+ */
+bool nuclei_separate_without_interaction(
+    const Particles &particles, double reach, bool collisions_within_nucleus,
+    const std::vector<FourVector> &beam_momentum);
+
+}  // namespace smash
+
+#endif  // SRC_INCLUDE_SMASH_FROZENSPECTATORS_H_
@@ -1,5 +1,5 @@
 /*
- *    Copyright (c) 2016-2020,2022
+ *    Copyright (c) 2016-2020,2022,2024
  *      SMASH Team
  *
  *    GNU General Public License (GPLv3 or later)
@@ -7,6 +7,7 @@
 #ifndef SRC_INCLUDE_SMASH_GRANDCAN_THERMALIZER_H_
 #define SRC_INCLUDE_SMASH_GRANDCAN_THERMALIZER_H_
 
+#include <functional>
 #include <memory>
 #include <vector>
 
@@ -79,6 +80,21 @@ class ThermLatticeNode {
    * though the dissipative part of the energy-momentum tensor is neglected.
    */
   void compute_rest_frame_quantities(HadronGasEos& eos);
+  /**
+   * Compute the rest frame quantities of many nodes at once, giving the same
+   * result as compute_rest_frame_quantities for every node.
+   *
+   * The nodes are first computed concurrently with the tabulated equation of
+   * state only. The nodes which leave the table are then solved in a second
+   * concurrent pass, with one solver per node.
+   *
+   * \param[inout] nodes Nodes to be computed
+   * \param[in] eos \see HadronGasEos, whose table is used
+   * \param[in] pool If given, the nodes are computed concurrently
+   */
+  static void compute_rest_frame_quantities(
+      const std::vector<ThermLatticeNode*>& nodes, HadronGasEos& eos,
+      ThreadPool* pool = nullptr);
   /**
    * Set all the rest frame quantities to some values, this is useful
    * for testing.
@@ -114,6 +130,16 @@ class ThermLatticeNode {
   double muq() const { return muq_; }
 
  private:
+  /**
+   * Iterate the rest frame quantities, see compute_rest_frame_quantities.
+   *
+   * \param[in] eos \see HadronGasEos, whose table is used if it exists
+   * \param[in] solver Equation of state used to solve the nodes outside the
+   *            table. Without it, the iteration stops there.
+   * \return Whether the iteration was completed
+   */
+  bool iterate_rest_frame_quantities(const HadronGasEos& eos,
+                                     HadronGasEos* solver);
   /// Four-momentum flow of the cell
   FourVector Tmu0_;
   /// Net baryon density of the cell in the computational frame
@@ -237,21 +263,29 @@ class GrandCanThermalizer {
    * \param[in] par Parameters necessary for density determination
    * \see DensityParameters
    * \param[in] ignore_cells_under_threshold Boolean that is true by default
+   * \param[in] pool If given, the particles are added to the lattice and the
+   *            nodes are computed concurrently
    */
   void update_thermalizer_lattice(const std::vector<Particles>& ensembles,
                                   const DensityParameters& par,
-                                  bool ignore_cells_under_threshold = true);
+                                  bool ignore_cells_under_threshold = true,
+                                  ThreadPool* pool = nullptr);
   /// \return 3 vector uniformly sampled from the rectangular cell.
   ThreeVector uniform_in_cell() const;
   /**
    * Changes energy and momenta of the particles in plist to match the
    *  required_total_momentum. The procedure is described in
    *  \iref{Oliinychenko:2016vkg}.
+   *
+   * The sums over the particles are carried out in chunks of fixed size, such
+   * that the result does not depend on the number of threads.
    * \param[in] plist List of particles \see ParticleList
    * \param[in] required_total_momentum The necessary total momentum of the cell
+   * \param[in] pool If given, the chunks are processed concurrently
    */
   void renormalize_momenta(ParticleList& plist,
-                           const FourVector required_total_momentum);
+                           const FourVector required_total_momentum,
+                           ThreadPool* pool = nullptr);
 
   // Functions for BF-sampling algorithm
 
@@ -265,59 +299,58 @@ class GrandCanThermalizer {
    */
   void sample_multinomial(HadronClass particle_class, int N);
   /**
-   * The total number of particles of species type_index is defined by mult_int_
+   * Computes the average number of particles of each species in each cell to
+   * be sampled and their sums over the cells, mult_sort_.
+   * \param[in] ntest Number of testparticles
+   * \param[in] pool If given, the cells are computed concurrently
+   */
+  void compute_N_in_cells_BF_algo(int ntest, ThreadPool* pool);
+  /**
+   * The total number of particles of each species is defined by mult_int_
    * array that is returned by \see sample_multinomial.
-   * This function samples mult_int_[type_index] particles. It chooses
-   * randomly the cell to sample and picks up momentum and coordinate from the
-   * corresponding distributions.
+   * This function samples these particles. It chooses randomly the cell of
+   * every particle and then picks up momenta and coordinates from the
+   * corresponding distributions, cell by cell. Every cell has its own random
+   * number stream, such that the cells can be sampled concurrently with the
+   * same result.
    * \param[out] plist \see ParticleList of newly produced particles
    * \param[in] time Current time in the simulation to become zero component of
    * sampled particles
-   * \param[in] type_index Species that should be sampled
+   * \param[in] pool If given, the cells are sampled concurrently
    */
-  void sample_in_random_cell_BF_algo(ParticleList& plist, const double time,
-                                     size_t type_index);
+  void sample_in_cells_BF_algo(ParticleList& plist, const double time,
+                               ThreadPool* pool);
   /**
    * Samples particles according to the BF algorithm by making use of the
-   * \see sample_in_random_cell_BF_algo.
+   * \see sample_in_cells_BF_algo.
    * Quantum numbers of the sampled particles are required to be equal to the
    * original particles in this region.
    * \param[in] conserved_initial The quantum numbers of the total ensemble of
    * of particles in the region to be thermalized
    * \param[in] time Current time of the simulation
    * \param[in] ntest Number of testparticles
+   * \param[in] pool If given, the cells are sampled concurrently
    * \return Particle list with newly sampled particles according to
    * Becattini-Feroni algorithm
    */
   void thermalize_BF_algo(QuantumNumbers& conserved_initial, double time,
-                          int ntest);
+                          int ntest, ThreadPool* pool = nullptr);
 
   // Functions for mode-sampling algorithm
 
+  /**
+   * Selects the species of the current mode by strangeness, baryon number and
+   * charge
+   */
+  using ModeCondition = std::function<bool(int, int, int)>;
+
   /**
    * Computes average number of particles in each cell for the mode algorithm.
    * \param[in] condition Specifies the current mode (1 to 7)
+   * \param[in] pool If given, the cells are computed concurrently
    */
-  template <typename F>
-  void compute_N_in_cells_mode_algo(F&& condition) {
-    N_in_cells_.clear();
-    N_total_in_cells_ = 0.0;
-    for (auto cell_index : cells_to_sample_) {
-      const ThermLatticeNode cell = (*lat_)[cell_index];
-      const double gamma = 1.0 / std::sqrt(1.0 - cell.v().sqr());
-      double N_tot = 0.0;
-      for (ParticleTypePtr i : eos_typelist_) {
-        if (condition(i->strangeness(), i->baryon_number(), i->charge())) {
-          // N_i = n u^mu dsigma_mu = (isochronous hypersurface) n * V * gamma
-          N_tot += lat_cell_volume_ * gamma *
-                   HadronGasEos::partial_density(*i, cell.T(), cell.mub(),
-                                                 cell.mus(), 0.0);
-        }
-      }
-      N_in_cells_.push_back(N_tot);
-      N_total_in_cells_ += N_tot;
-    }
-  }
+  void compute_N_in_cells_mode_algo(const ModeCondition& condition,
+                                    ThreadPool* pool = nullptr);
 
   /**
    * Samples one particle and the species, cell, momentum and coordinate
@@ -329,70 +362,47 @@ class GrandCanThermalizer {
    * \param[in] time Current time in simulation
    * \param[in] condition Specifies the actual mode (1 to 7)
    */
-  template <typename F>
   ParticleData sample_in_random_cell_mode_algo(const double time,
-                                               F&& condition) {
-    // Choose random cell, probability = N_in_cell/N_total
-    double r = random::uniform(0.0, N_total_in_cells_);
-    double partial_sum = 0.0;
-    int index_only_thermalized = -1;
-    while (partial_sum < r) {
-      index_only_thermalized++;
-      partial_sum += N_in_cells_[index_only_thermalized];
-    }
-    const int cell_index = cells_to_sample_[index_only_thermalized];
-    const ThermLatticeNode cell = (*lat_)[cell_index];
-    const ThreeVector cell_center = lat_->cell_center(cell_index);
-    const double gamma = 1.0 / std::sqrt(1.0 - cell.v().sqr());
-    const double N_in_cell = N_in_cells_[index_only_thermalized];
-    // Which sort to sample - probability N_i/N_tot
-    r = random::uniform(0.0, N_in_cell);
-    double N_sum = 0.0;
-    ParticleTypePtr type_to_sample;
-    for (ParticleTypePtr i : eos_typelist_) {
-      if (!condition(i->strangeness(), i->baryon_number(), i->charge())) {
-        continue;
-      }
-      N_sum += lat_cell_volume_ * gamma *
-               HadronGasEos::partial_density(*i, cell.T(), cell.mub(),
-                                             cell.mus(), 0.0);
-      if (N_sum >= r) {
-        type_to_sample = i;
-        break;
-      }
-    }
-    ParticleData particle(*type_to_sample);
-    // Note: it's pole mass for resonances!
-    const double m = type_to_sample->mass();
-    // Position
-    particle.set_4position(FourVector(time, cell_center + uniform_in_cell()));
-    // Momentum
-    double momentum_radial = sample_momenta_from_thermal(cell.T(), m);
-    Angles phitheta;
-    phitheta.distribute_isotropically();
-    particle.set_4momentum(m, phitheta.threevec() * momentum_radial);
-    particle.boost_momentum(-cell.v());
-    particle.set_formation_time(time);
-    return particle;
-  }
+                                               const ModeCondition& condition);
+
+  /**
+   * Samples a batch of independent particles like
+   * \see sample_in_random_cell_mode_algo. Every particle of the batch has its
+   * own random number stream, such that the batch can be sampled concurrently
+   * with the same result.
+   * \param[in] time Current time in simulation
+   * \param[in] condition Specifies the actual mode (1 to 7)
+   * \param[in] pool If given, the particles are sampled concurrently
+   * \return Sampled particles, to be taken in order
+   */
+  ParticleList sample_batch_mode_algo(const double time,
+                                      const ModeCondition& condition,
+                                      ThreadPool* pool);
 
   /**
    * Samples particles to the according to the mode algorithm.
    * Quantum numbers of the sampled particles are required to be as in
    * conserved_initial.
+   *
+   * The candidates of every mode are sampled in batches, of which the
+   * particles are taken one after another until the mode is complete.
    * \param[in] conserved_initial Quantum numbers of the original particles
    * in the region to be thermalized
    * \param[in] time Current time of the simulation
+   * \param[in] pool If given, the batches are sampled concurrently
    */
-  void thermalize_mode_algo(QuantumNumbers& conserved_initial, double time);
+  void thermalize_mode_algo(QuantumNumbers& conserved_initial, double time,
+                            ThreadPool* pool = nullptr);
   /**
    * Main thermalize function, that chooses the algorithm to follow
    * (BF or mode sampling).
    * \param[out] particles List of sampled particles in thermalized region
    * \param[in] time Current time of the simulation
    * \param[in] ntest number of testparticles
+   * \param[in] pool If given, the particles are sampled concurrently
    */
-  void thermalize(const Particles& particles, double time, int ntest);
+  void thermalize(const Particles& particles, double time, int ntest,
+                  ThreadPool* pool = nullptr);
 
   /**
    * Generates standard output with information about the thermodynamic
@@ -406,9 +416,9 @@ class GrandCanThermalizer {
   /// Get the critical energy density
   double e_crit() const { return e_crit_; }
   /// List of particles to be removed from the simulation
-  ParticleList particles_to_remove() const { return to_remove_; }
+  const ParticleList& particles_to_remove() const { return to_remove_; }
   /// List of newly created particles to be inserted in the simulation
-  ParticleList particles_to_insert() const { return sampled_list_; }
+  const ParticleList& particles_to_insert() const { return sampled_list_; }
 
  private:
   /**
@@ -448,8 +458,15 @@ class GrandCanThermalizer {
   }
   /// Number of particles to be sampled in one cell
   std::vector<double> N_in_cells_;
+  /**
+   * Number of particles of each species to be sampled in each cell by the BF
+   * algorithm, the species index runs fastest
+   */
+  std::vector<double> N_sorts_in_cells_;
   /// Cells above critical energy density
   std::vector<size_t> cells_to_sample_;
+  /// Whether a cell of the lattice is above the critical energy density
+  std::vector<bool> is_cell_to_sample_;
   /// Hadron gas equation of state
   HadronGasEos eos_ = HadronGasEos(true, false);
   /// The lattice on which the thermodynamic quantities are calculated
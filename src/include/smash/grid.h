@@ -1,6 +1,6 @@
 /*
  *
- *    Copyright (c) 2014-2015,2017-2022
+ *    Copyright (c) 2014-2015,2017-2022,2024
  *      SMASH Team
  *
  *    GNU General Public License (GPLv3 or later)
@@ -12,12 +12,14 @@
 
 #include <array>
 #include <cmath>
+#include <cstdint>
 #include <functional>
 #include <utility>
 #include <vector>
 
 #include "forwarddeclarations.h"
 #include "particles.h"
+#include "particlespan.h"
 
 namespace smash {
 
@@ -68,16 +70,49 @@ class GridBase {
  public:
   /// A type to store the sizes
   typedef int SizeType;
+  /// The minimum x,y,z coordinates and the lengths of a box
+  using MinAndLength = std::pair<std::array<double, 3>, std::array<double, 3>>;
 
- protected:
   /**
    * \return the minimum x,y,z coordinates and the largest dx,dy,dz distances of
-   * the particles in \p particles.
+   * the particles in \p particles, extended by \p margin on every side.
    *
    * \param[in] particles Particles in the system
+   * \param[in] margin Space added on every side, relative to the extent of
+   *            the particles in the respective direction.
+   * \param[in] min_margin Space added on every side at least, if \p margin is
+   *            positive [fm].
    */
-  static std::pair<std::array<double, 3>, std::array<double, 3>>
-  find_min_and_length(const Particles &particles);
+  static MinAndLength find_min_and_length(const Particles &particles,
+                                          double margin = 0.,
+                                          double min_margin = 0.);
+
+  /**
+   * \return the box \p min_and_length of the particles, extended by \p margin
+   * on every side like in find_min_and_length.
+   *
+   * \param[in] min_and_length Minimum coordinates and lengths of the particles,
+   *            e.g. as found while they were propagated
+   * \param[in] margin Space added on every side, relative to the length
+   * \param[in] min_margin Space added on every side at least, if \p margin is
+   *            positive [fm].
+   */
+  static MinAndLength with_margin(MinAndLength min_and_length, double margin,
+                                  double min_margin);
+
+  /**
+   * \return the Morton key of the cell of \p position, on a grid of cubic
+   * cells, which starts at the minimum coordinates of \p box. The bits of the
+   * cell indices are interleaved, such that sorting by the key places nearby
+   * cells next to each other. At most \f$2^{21}\f$ cells per direction are
+   * distinguished, indices beyond are clamped.
+   *
+   * \param[in] position Position, of which only the spatial part is used
+   * \param[in] box Minimum coordinates and lengths of the grid
+   * \param[in] cell_length Length of the cells [fm]
+   */
+  static std::uint64_t morton_key(const FourVector &position,
+                                  const MinAndLength &box, double cell_length);
 };
 
 /**
@@ -100,7 +135,8 @@ class Grid : public GridBase {
    * automatically determines the necessary size for the grid from the positions
    * of the particles.
    *
-   * \param[in] particles The particles to place onto the grid.
+   * \param[in] particles The particles to place onto the grid. The grid only
+   *            refers to them, so they must outlive the grid unchanged.
    * \param[in] min_cell_length The minimal length a cell must have.
    * \param[in] timestep_duration Duration of the timestep. It is necessary for
    * formation times treatment: if particle is fully or partially formed before
@@ -162,15 +198,97 @@ class Grid : public GridBase {
    *                              be adjusted to wrap around the grid.
    */
   void iterate_cells(
-      const std::function<void(const ParticleList &)> &search_cell_callback,
-      const std::function<void(const ParticleList &, const ParticleList &)>
-          &neighbor_cell_callback) const;
+      const std::function<void(const ParticleSpan &)> &search_cell_callback,
+      const std::function<void(const ParticleSpan &, const ParticleSpan &)>
+          &neighbor_cell_callback) const {
+    iterate_cells(search_cell_callback, neighbor_cell_callback, 0,
+                  number_of_layers());
+  }
+
+  /**
+   * Iterates over the search cells of some layers of the grid, see
+   * iterate_cells. Every pair of cells is passed with the search cell in one
+   * layer only, so the layers can be searched concurrently, and iterating
+   * over all layers one after the other makes the same calls as
+   * iterate_cells.
+   *
+   * \param[in] search_cell_callback A callable called for every cell.
+   * \param[in] neighbor_cell_callback A callable called for every search cell
+   *            in the layers and its neighbor cells.
+   * \param[in] first_layer First layer of search cells
+   * \param[in] end_layer Layer after the last one of search cells
+   */
+  void iterate_cells(
+      const std::function<void(const ParticleSpan &)> &search_cell_callback,
+      const std::function<void(const ParticleSpan &, const ParticleSpan &)>
+          &neighbor_cell_callback,
+      SizeType first_layer, SizeType end_layer) const;
+
+  /// \return Number of layers of cells along the z axis
+  SizeType number_of_layers() const { return number_of_cells_[2]; }
+
+  /**
+   * Iterates over the non-empty cells of the grid for the stochastic
+   * criterion, dividing crowded cells.
+   *
+   * A cell holding more than \p max_occupancy particles is divided into eight
+   * octants, which are divided in the same way as long as their halves are
+   * not shorter than \p min_length. The callback is called for every
+   * non-empty cell or octant, which is not divided further, with its volume.
+   * Since the octants partition the cell, every particle is passed exactly
+   * once. There are no neighbor cells, because the stochastic criterion only
+   * searches within cells.
+   *
+   * \param[in] max_occupancy Number of particles, above which a cell or
+   *            octant is divided
+   * \param[in] min_length Minimal length of the octants [fm]
+   * \param[in] search_cell_callback A callable called with the particles and
+   *            the volume [fm³] of every non-empty cell or octant.
+   */
+  void iterate_refined_cells(
+      std::size_t max_occupancy, double min_length,
+      const std::function<void(const ParticleSpan &, double)>
+          &search_cell_callback) const;
+
+  /**
+   * Updates the grid to the current positions of the particles, keeping the
+   * cell layout of the grid.
+   *
+   * Particles which left their cell, as well as inserted and removed
+   * particles, are sorted into the cells again. The cells keep the particles
+   * in the same order as a newly constructed grid with the same layout.
+   * Nothing has to be done if no particle changed its cell.
+   *
+   * \param[in] particles The particles to place onto the grid. They have to be
+   *            the particles the grid was constructed from, possibly changed.
+   * \param[in] min_cell_length The minimal length a cell must have.
+   * \param[in] timestep_duration Duration of the timestep in fm.
+   * \param[in] skip Optional predicate selecting particles, which are left
+   *            out of the cells, e.g. spectators which cannot interact.
+   *            They do not cause a reconstruction when leaving the grid.
+   * \return Whether the grid could be updated. If not, because a particle
+   *         left the grid or the minimal cell length changed, the grid has to
+   *         be constructed anew.
+   */
+  bool update(const Particles &particles, double min_cell_length,
+              double timestep_duration,
+              const std::function<bool(const ParticleData &)> &skip = {});
 
   /**
    * \return the volume of a single grid cell
    */
   double cell_volume() const { return cell_volume_; }
 
+  /**
+   * \return the memory allocated for the cells [bytes]
+   */
+  std::size_t memory_usage() const {
+    return cell_particles_.capacity() * sizeof(const ParticleData *) +
+           cell_offsets_.capacity() * sizeof(std::size_t) +
+           (placed_.capacity() + placing_.capacity()) *
+               sizeof(std::pair<const ParticleData *, SizeType>);
+  }
+
  private:
   /**
    * \return the one-dimensional cell-index from the 3-dim index \p x, \p y, \p
@@ -186,17 +304,71 @@ class Grid : public GridBase {
     return make_index(idx[0], idx[1], idx[2]);
   }
 
+  /**
+   * \return the particles in the cell with the one-dimensional index \p index.
+   */
+  ParticleSpan cell(SizeType index) const {
+    return ParticleSpan(cell_particles_.data() + cell_offsets_[index],
+                        cell_offsets_[index + 1] - cell_offsets_[index]);
+  }
+
+  /**
+   * Sorts the particles into the cells of the current cell layout.
+   *
+   * \param[in] particles The particles to place onto the grid.
+   * \param[in] timestep_duration Duration of the timestep in fm.
+   * \param[in] skip Optional predicate selecting particles, which are left
+   *            out of the cells
+   * \return Whether all particles are inside the grid. If not, the cells are
+   *         left unchanged.
+   */
+  bool sort_into_cells(
+      const Particles &particles, double timestep_duration,
+      const std::function<bool(const ParticleData &)> &skip = {});
+
   /// The 3 lengths of the complete grid. Used for periodic boundary wrapping.
   const std::array<double, 3> length_;
 
+  /// The minimum x,y,z coordinates of the grid.
+  std::array<double, 3> min_position_;
+
+  /// Factor translating a distance to min_position_ into a cell index.
+  std::array<double, 3> index_factor_ = {0., 0., 0.};
+
+  /// The minimal cell length the grid was constructed for.
+  const double min_cell_length_;
+
+  /// Whether particles, which cannot interact in the time step, are included.
+  const bool include_unformed_particles_;
+
   /// The volume of a single cell.
   double cell_volume_;
 
   /// The number of cells in x, y, and z direction.
   std::array<int, 3> number_of_cells_;
 
-  /// The cell storage.
-  std::vector<ParticleList> cells_;
+  /**
+   * Pointers to the particles on the grid, sorted by the cell they are in.
+   *
+   * The particles are not copied, hence the Particles object the grid was
+   * constructed from must not be modified while the grid is used.
+   */
+  std::vector<const ParticleData *> cell_particles_;
+
+  /**
+   * The cell with index i holds the particles cell_particles_[cell_offsets_[i]]
+   * up to (excluding) cell_particles_[cell_offsets_[i + 1]].
+   */
+  std::vector<std::size_t> cell_offsets_;
+
+  /**
+   * The particles on the grid together with the index of their cell, in the
+   * order of the particles.
+   */
+  std::vector<std::pair<const ParticleData *, SizeType>> placed_;
+
+  /// Buffer reused for sorting the particles into the cells.
+  std::vector<std::pair<const ParticleData *, SizeType>> placing_;
 };
 
 }  // namespace smash
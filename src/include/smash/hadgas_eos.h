@@ -1,6 +1,6 @@
 /*
  *
- *    Copyright (c) 2016-2020,2022
+ *    Copyright (c) 2016-2020,2022,2024
  *      SMASH Team
  *
  *    GNU General Public License (GPLv3 or later)
@@ -10,6 +10,7 @@
 #define SRC_INCLUDE_SMASH_HADGAS_EOS_H_
 
 #include <array>
+#include <cstdint>
 #include <string>
 #include <vector>
 
@@ -19,6 +20,7 @@
 
 #include "constants.h"
 #include "particletype.h"
+#include "sha256.h"
 
 namespace smash {
 
@@ -71,12 +73,22 @@ class EosTable {
    * Computes the actual content of the table (for EosTable description see
    * documentation of the constructor).
    *
+   * The table is read from the given file if it was saved there for the same
+   * table dimensions and hadrons, which is checked by the hash of both (see
+   * hash). Otherwise it is computed with all available threads, one slice of
+   * constant energy density per task, and saved to the file.
+   *
+   * The file is binary: it starts with the magic, the version of the format
+   * and the hash, followed by the table elements in the order of the 1d
+   * vector, each as five doubles. The table can therefore also be mapped
+   * into memory directly.
+   *
    * \param[in] eos equation of state
    * \param[in] eos_savefile_name name of the file to save tabulated equation
    *            of state
    */
   void compile_table(HadronGasEos& eos,
-                     const std::string& eos_savefile_name = "hadgas_eos.dat");
+                     const std::string& eos_savefile_name = "hadgas_eos.bin");
   /**
    * Obtain interpolated p/T/muB/muS/muQ from the tabulated equation of state
    * given energy density, net baryon density and net charge density
@@ -88,11 +100,53 @@ class EosTable {
    */
   void get(table_element& res, double e, double nb, double nq) const;
 
+  /**
+   * Hash identifying the table content: the dimensions of the table, whether
+   * resonance widths are accounted for and the properties of all hadrons in
+   * the equation of state.
+   *
+   * \param[in] account_for_widths Whether the equation of state accounts for
+   *            resonance spectral functions
+   * \return Hash of the table
+   */
+  sha256::Hash hash(bool account_for_widths) const;
+
+  /// Identifies the format at the beginning of the file
+  static constexpr char magic[8] = {'S', 'M', 'A', 'S', 'H', 'E', 'O', 'S'};
+
+  /// Version of the format, which is increased whenever it changes
+  static constexpr std::uint64_t version = 1;
+
  private:
   /// proper index in a 1d vector, where the 3d table is stored
   size_t index(size_t ie, size_t inb, size_t inq) const {
     return n_q_ * (ie * n_nb_ + inb) + inq;
   }
+  /**
+   * Read the table from a file with a single read.
+   *
+   * \param[in] path Name of the file
+   * \param[in] hash Hash the table has to be saved with
+   * \return Whether the file exists and contains the table for the hash
+   */
+  bool read(const std::string& path, const sha256::Hash& hash);
+  /**
+   * Save the table to a file, replacing an existing one atomically.
+   *
+   * \param[in] path Name of the file
+   * \param[in] hash Hash of the table
+   * \throws std::runtime_error if the file cannot be written
+   */
+  void write(const std::string& path, const sha256::Hash& hash) const;
+  /**
+   * Compute the table at constant energy density. Every node is solved
+   * starting from its already solved neighbours, extrapolating linearly if
+   * two are available.
+   *
+   * \param[in] ie index of the energy density
+   * \param[in] eos equation of state, whose solver is used
+   */
+  void compile_slice(size_t ie, HadronGasEos& eos);
   /// Storage for the tabulated equation of state
   std::vector<table_element> table_;
   /// Step in energy density
@@ -1,7 +1,7 @@
 /*
  *
  *    Copyright (c) 2021 Christian Holm Christensen
- *    Copyright (c) 2021-2023
+ *    Copyright (c) 2021-2024
  *      SMASH Team
  *
  *    GNU General Public License (GPLv3 or later)
@@ -11,11 +11,13 @@
 #ifndef SRC_INCLUDE_SMASH_HEPMCINTERFACE_H_
 #define SRC_INCLUDE_SMASH_HEPMCINTERFACE_H_
 
-#include <map>
+#include <cstdint>
 #include <memory>
 #include <string>
+#include <unordered_map>
 #include <utility>
 #include <valarray>
+#include <vector>
 
 #include "HepMC3/GenCrossSection.h"
 #include "HepMC3/GenEvent.h"
@@ -48,9 +50,14 @@ namespace smash {
  * We use that map to keep track of the particles and interaction
  * points.
 
+ * The particles and interactions are only recorded in a compact log while
+ * the event is running, see HepMcInterface::EventLog, and the HepMC event is
+ * built from the log at the end of the event. The event object and the
+ * buffers of the log are reused from event to event.
+ *
  * In case full event history:
  *
- * At each interaction we create a new vertex, and add the incoming
+ * For each interaction we create a new vertex, and add the incoming
  * particles as "in" particles to that vertex.  We also set the
  * appropriate "state" of the incoming particles.  That is, if the
  * interaction corresponded to a decay, then the HepMC state is set to
@@ -115,7 +122,7 @@ class HepMcInterface : public OutputInterface {
   void at_interaction(const Action& action, const double density) override;
   /**
    * Add the final particles information of an event to the central vertex.
-   * Store impact paramter and write event.
+   * Store impact paramter and build the HepMC event from the log.
    *
    * \param[in] particles Current list of particles.
    * \param[in] event_number Number of event.
@@ -132,14 +139,99 @@ class HepMcInterface : public OutputInterface {
     dcy = 2,   // Decay
     off = 100
   };
+  /** Particle as recorded in the event log */
+  struct LoggedParticle {
+    /// SMASH ID
+    int id;
+    /// PDG code
+    int pdg;
+    /// Four momentum
+    FourVector momentum;
+    /// Pole mass, which is the generator mass of the HepMC particle
+    double mass;
+  };
+  /** Interaction as recorded in the event log */
+  struct LoggedInteraction {
+    /// Interaction point
+    FourVector point;
+    /// HepMC status of the incoming particles
+    int status;
+    /// Total weight of the action
+    double weight;
+    /// Partial weight of the action
+    double partial_weight;
+    /// Number of incoming particles
+    std::uint32_t n_in;
+    /// Number of outgoing particles
+    std::uint32_t n_out;
+  };
+  /**
+   * Compact record of an event, from which the HepMC event is built at its
+   * end. The particles are stored one after the other: first those of the
+   * initial vertex, then the incoming and outgoing particles of each
+   * interaction and last the final particles, if only the final state is
+   * written.
+   */
+  struct EventLog {
+    /// Number of the event
+    int event_number = 0;
+    /// Impact parameter, negative if not a collision
+    double impact_parameter = -1.0;
+    /// Weight of the event
+    double event_weight = 1.0;
+    /// Whether the event was empty
+    bool empty_event = false;
+    /// Number of particles of the initial vertex
+    std::size_t n_initial = 0;
+    /// Projectile and target nuclei as PDG code and four momentum
+    std::pair<int, FourVector> beams[2];
+    /// Number of projectile and target nucleons
+    int n_nucleons = 0;
+    /// Particles of the initial vertex, interactions and final state
+    std::vector<LoggedParticle> particles;
+    /// Interactions in the order they were performed
+    std::vector<LoggedInteraction> interactions;
+    /// Clear the log, keeping the allocated memory.
+    void clear() {
+      n_initial = 0;
+      n_nucleons = 0;
+      empty_event = false;
+      particles.clear();
+      interactions.clear();
+    }
+  };
   /** Type of mapping from SMASH ID to HepMC ID */
-  using IdMap = std::map<int, HepMC3::GenParticlePtr>;
+  using IdMap = std::unordered_map<int, HepMC3::GenParticlePtr>;
   /** Counter of collitions per incoming particle */
   using CollCounter = std::valarray<int>;
   /** Clear before an event */
   void clear();
   /** Convert SMASH process type to HepMC status */
   int get_status(const ProcessType& t) const;
+  /**
+   * Record a particle in the event log.
+   *
+   * \param[in] p ParticleData object
+   */
+  void log_particle(const ParticleData& p);
+  /**
+   * Record the final particles in the event log.
+   *
+   * \param[in] particles Current list of particles.
+   * \param[in] event Event info, see \ref event_info
+   */
+  void log_eventend(const Particles& particles, const EventInfo& event);
+  /**
+   * Build the HepMC event from a log of the event.
+   *
+   * Only the event, the interaction point and the ID mapping are used, so
+   * that the event can be built in another thread, while the next event is
+   * logged.
+   *
+   * \param[in] log Record of the event
+   * \throw std::runtime_error if a final particle is not in the event
+   */
+  void build_event(const EventLog& log);
   /**
    * Make an HepMC particle
    *
@@ -156,23 +248,23 @@ class HepMcInterface : public OutputInterface {
   /**
    * Find particle in mapping or generate it.
    *
-   * \param[in] p         ParticleData object
+   * \param[in] p         Logged particle
    * \param[in] status    HepMC status code
    *
    * \return r The existing or generated particle
    */
-  HepMC3::GenParticlePtr make_register(const ParticleData& p,
+  HepMC3::GenParticlePtr make_register(const LoggedParticle& p,
                                        int status = Status::fnal);
   /**
    * Find particle in mapping or generate it.
    *
-   * \param[in] p         ParticleData object
+   * \param[in] p         Logged particle
    * \param[in] status    HepMC status code
    * \param[in] force_new Create new particle even if could found
    *
    * \return r The existing or generated particle
    */
-  HepMC3::GenParticlePtr find_or_make(const ParticleData& p,
+  HepMC3::GenParticlePtr find_or_make(const LoggedParticle& p,
                                       int status = Status::fnal,
                                       bool force_new = false);
   /**
@@ -183,7 +275,9 @@ class HepMcInterface : public OutputInterface {
    * \return PDG code of ion
    */
   int ion_pdg(const AZ& az) const;
-  /** The event */
+  /** Log of the current event */
+  EventLog log_;
+  /** The event, which is reused for all events */
   HepMC3::GenEvent event_;
   /** The heavy-ion structure */
   HepMC3::GenHeavyIonPtr ion_;
@@ -1,7 +1,7 @@
 
 /*
  *
- *    Copyright (c) 2020-2022
+ *    Copyright (c) 2020-2022,2024
  *      SMASH Team
  *
  *    GNU General Public License (GPLv3 or later)
@@ -12,6 +12,7 @@
 #define SRC_INCLUDE_SMASH_HEPMCOUTPUT_H_
 
 #include <filesystem>
+#include <future>
 #include <memory>
 #include <string>
 #include <vector>
@@ -32,6 +33,9 @@ namespace smash {
  * file can be a human-readable ASCII file or a ROOT Tree binary file.
  * HepMC version 3 is used.
  *
+ * The HepMC event is built from the log of the event and written in a
+ * separate thread, while the next event is simulated.
+ *
  * More details of the output format can be found in the User Guide.
  */
 class HepMcOutput : public HepMcInterface {
@@ -48,20 +52,29 @@ class HepMcOutput : public HepMcInterface {
   HepMcOutput(const std::filesystem::path &path, std::string name,
               const bool full_event, std::string HepMC3_output_type);
 
-  /// Destructor renames file
+  /// Destructor waits for the last event to be written and renames file
   ~HepMcOutput();
   /**
-   * Add the final particles information of an event to the central vertex.
-   * Store impact parameter and write event.
+   * Add the final particles information of an event to the log and start
+   * building and writing the event in a separate thread. The writing of the
+   * previous event is finished first.
+   *
    *
    * \param[in] particles Current list of particles.
    * \param[in] event_number Number of event.
    * \param[in] event Event info, see \ref event_info
+   * \throw std::runtime_error if building the previous event failed
    */
   void at_eventend(const Particles &particles, const int32_t event_number,
                    const EventInfo &event) override;
 
  private:
+  /// Wait until the previous event is written, rethrowing its errors.
+  void finish_writing();
+  /// Log of the event, which is built and written in the writing thread
+  EventLog written_log_;
+  /// Building and writing of the previous event
+  std::future<void> writing_;
   /// Filename of output
   const std::filesystem::path filename_;
   /// Filename of output as long as simulation is still running.
@@ -0,0 +1,316 @@
+/*
+ *
+ *    Copyright (c) 2024
+ *      SMASH Team
+ *
+ *    GNU General Public License (GPLv3 or later)
+ *
+ */
+
+#ifndef SRC_INCLUDE_SMASH_HISTOGRAMOUTPUT_H_
+#define SRC_INCLUDE_SMASH_HISTOGRAMOUTPUT_H_
+
+#include <array>
+#include <filesystem>
+#include <optional>
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include "forwarddeclarations.h"
+#include "outputinterface.h"
+#include "outputparameters.h"
+#include "pdgcode.h"
+
+namespace smash {
+
+/**
+ * \ingroup output
+ *
+ * Equally wide bins between a lower and an upper limit.
+ */
+class HistogramAxis {
+ public:
+  /**
+   * \param[in] n_bins Number of bins
+   * \param[in] range Lower and upper limit
+   * \throw std::invalid_argument if there are no bins or the range is empty.
+   */
+  HistogramAxis(int n_bins, const std::array<double, 2> &range);
+
+  /**
+   * \param[in] x Value to be binned
+   * \return Index of the bin of \p x, -1 below the lower limit and the number
+   *         of bins from the upper limit on.
+   */
+  int bin(double x) const;
+
+  /// \return Number of bins
+  int n_bins() const { return n_bins_; }
+
+  /// \return Lower edge of bin \p i
+  double low_edge(int i) const { return range_[0] + i * width_; }
+
+  /// \return Upper edge of bin \p i
+  double high_edge(int i) const { return low_edge(i + 1); }
+
+ private:
+  /// Number of bins
+  int n_bins_;
+  /// Lower and upper limit
+  std::array<double, 2> range_;
+  /// Width of every bin
+  double width_;
+};
+
+/**
+ * \ingroup output
+ *
+ * Sums over the entries of a bin, as they are kept by YODA: the weights and
+ * the weighted first and second moments of the binned values \f$x\f$,
+ * \f$y\f$, and of the profiled value \f$y\f$ of a profile.
+ */
+struct HistogramBin {
+  /// Sum of the weights
+  double sumw = 0.;
+  /// Sum of the squared weights
+  double sumw2 = 0.;
+  /// Weighted sum of \f$x\f$
+  double sumwx = 0.;
+  /// Weighted sum of \f$x^2\f$
+  double sumwx2 = 0.;
+  /// Weighted sum of \f$y\f$
+  double sumwy = 0.;
+  /// Weighted sum of \f$y^2\f$
+  double sumwy2 = 0.;
+  /// Weighted sum of \f$xy\f$
+  double sumwxy = 0.;
+  /// Number of entries
+  double entries = 0.;
+
+  /**
+   * Add an entry.
+   *
+   * \param[in] x First value
+   * \param[in] y Second value
+   * \param[in] w Weight
+   */
+  void fill(double x, double y, double w) {
+    sumw += w;
+    sumw2 += w * w;
+    sumwx += w * x;
+    sumwx2 += w * x * x;
+    sumwy += w * y;
+    sumwy2 += w * y * y;
+    sumwxy += w * x * y;
+    entries++;
+  }
+};
+
+/**
+ * \ingroup output
+ *
+ * Histogram of one value, which is also used as profile of a second value.
+ */
+class Histogram1D {
+ public:
+  /// \param[in] axis Bins of the histogram
+  explicit Histogram1D(const HistogramAxis &axis)
+      : axis_(axis), bins_(axis.n_bins()) {}
+
+  /**
+   * Add an entry.
+   *
+   * \param[in] x Binned value
+   * \param[in] y Profiled value, if this is a profile
+   * \param[in] w Weight
+   */
+  void fill(double x, double y = 0., double w = 1.);
+
+  /// \return Bins of the histogram
+  const HistogramAxis &axis() const { return axis_; }
+  /// \return Sums of bin \p i
+  const HistogramBin &bin(int i) const { return bins_[i]; }
+  /// \return Sums of the entries below the bins
+  const HistogramBin &underflow() const { return underflow_; }
+  /// \return Sums of the entries above the bins
+  const HistogramBin &overflow() const { return overflow_; }
+  /// \return Sums of all entries
+  const HistogramBin &total() const { return total_; }
+
+ private:
+  /// Bins of the histogram
+  HistogramAxis axis_;
+  /// Sums of every bin
+  std::vector<HistogramBin> bins_;
+  /// Sums of the entries below the bins
+  HistogramBin underflow_;
+  /// Sums of the entries above the bins
+  HistogramBin overflow_;
+  /// Sums of all entries
+  HistogramBin total_;
+};
+
+/**
+ * \ingroup output
+ *
+ * Histogram of two values. Entries outside of the bins only count to the
+ * total.
+ */
+class Histogram2D {
+ public:
+  /**
+   * \param[in] x_axis Bins of the first value
+   * \param[in] y_axis Bins of the second value
+   */
+  Histogram2D(const HistogramAxis &x_axis, const HistogramAxis &y_axis)
+      : x_axis_(x_axis),
+        y_axis_(y_axis),
+        bins_(static_cast<std::size_t>(x_axis.n_bins()) * y_axis.n_bins()) {}
+
+  /**
+   * Add an entry.
+   *
+   * \param[in] x First value
+   * \param[in] y Second value
+   * \param[in] w Weight
+   */
+  void fill(double x, double y, double w = 1.);
+
+  /// \return Bins of the first value
+  const HistogramAxis &x_axis() const { return x_axis_; }
+  /// \return Bins of the second value
+  const HistogramAxis &y_axis() const { return y_axis_; }
+  /// \return Sums of the bin \p ix of the first and \p iy of the second value
+  const HistogramBin &bin(int ix, int iy) const {
+    return bins_[static_cast<std::size_t>(ix) * y_axis_.n_bins() + iy];
+  }
+  /// \return Sums of all entries
+  const HistogramBin &total() const { return total_; }
+
+ private:
+  /// Bins of the first value
+  HistogramAxis x_axis_;
+  /// Bins of the second value
+  HistogramAxis y_axis_;
+  /// Sums of every bin, the second value running fastest
+  std::vector<HistogramBin> bins_;
+  /// Sums of all entries
+  HistogramBin total_;
+};
+
+/**
+ * \ingroup output
+ *
+ * Write a histogram in the YODA text format.
+ *
+ * \param[in] out Stream to write to
+ * \param[in] path YODA path of the histogram
+ * \param[in] title Title of the histogram
+ * \param[in] histogram The histogram
+ * \param[in] scale Factor, which the sums of the weights are scaled by
+ */
+void write_yoda_histo1d(std::ostream &out, const std::string &path,
+                        const std::string &title, const Histogram1D &histogram,
+                        double scale);
+
+/**
+ * \ingroup output
+ *
+ * Write a profile in the YODA text format, see write_yoda_histo1d. A profile
+ * is not scaled.
+ */
+void write_yoda_profile1d(std::ostream &out, const std::string &path,
+                          const std::string &title,
+                          const Histogram1D &histogram);
+
+/**
+ * \ingroup output
+ *
+ * Write a histogram of two values in the YODA text format, see
+ * write_yoda_histo1d.
+ */
+void write_yoda_histo2d(std::ostream &out, const std::string &path,
+                        const std::string &title, const Histogram2D &histogram,
+                        double scale);
+
+/**
+ * \ingroup output
+ *
+ * Fills histograms of the final particles and the interactions over all
+ * events and writes them at the end of the run, instead of writing the
+ * particles themselves, see \ref doxypage_output_histograms.
+ */
+class HistogramOutput : public OutputInterface {
+ public:
+  /**
+   * Create the histograms.
+   *
+   * \param[in] path Output directory
+   * \param[in] name Name of the output
+   * \param[in] out_par Parameters of the output
+   * \throw std::invalid_argument if a quantity is unknown or the binning is
+   *        invalid.
+   */
+  HistogramOutput(const std::filesystem::path &path, const std::string &name,
+                  const OutputParameters &out_par);
+
+  /**
+   * Keep the weight of the event for its interactions.
+   *
+   * \param[in] event Event info, see \ref EventInfo
+   */
+  void at_eventstart(const Particles &, const int,
+                     const EventInfo &event) override;
+
+  /**
+   * Fill the spectra of the final particles of an ensemble, which counts as
+   * an event with its weight.
+   *
+   * \param[in] particles Particles of the ensemble
+   * \param[in] event Event info, see \ref EventInfo
+   */
+  void at_eventend(const Particles &particles, const int,
+                   const EventInfo &event) override;
+
+  /**
+   * Fill the time of an interaction.
+   *
+   * \param[in] action The interaction
+   */
+  void at_interaction(const Action &action, const double) override;
+
+  /**
+   * Write the histograms, normalized per weighted event.
+   * \throw std::runtime_error if the file cannot be written.
+   */
+  void at_runend() override;
+
+ private:
+  /// File the histograms are written to
+  const std::filesystem::path filename_;
+  /// PDG codes of the histogrammed particles, sorted; all if empty
+  std::vector<PdgCode> pdg_codes_;
+  /// Rapidity range and bins
+  const HistogramAxis rapidity_axis_;
+  /// Transverse momentum range and bins
+  const HistogramAxis pt_axis_;
+  /// Sum of the weights of the events filled so far
+  double n_events_ = 0.;
+  /// Weight of the current event
+  double event_weight_ = 1.;
+  /// Rapidity distribution
+  std::optional<Histogram1D> rapidity_;
+  /// Transverse momentum distribution within the rapidity range
+  std::optional<Histogram1D> pt_;
+  /// Rapidity and transverse momentum distribution
+  std::optional<Histogram2D> rapidity_pt_;
+  /// Elliptic flow versus transverse momentum within the rapidity range
+  std::optional<Histogram1D> v2_pt_;
+  /// Times of the interactions
+  std::optional<Histogram1D> interaction_times_;
+};
+
+}  // namespace smash
+
+#endif  // SRC_INCLUDE_SMASH_HISTOGRAMOUTPUT_H_
@@ -1,6 +1,6 @@
 /*
  *
- *    Copyright (c) 2019-2020,2022
+ *    Copyright (c) 2019-2020,2022,2024
  *      SMASH Team
  *
  *    GNU General Public License (GPLv3 or later)
@@ -68,6 +68,10 @@ class HypersurfacecrossingAction : public Action {
  * Finder for hypersurface crossing actions.
  * Loops through all particles and checks if they cross the hypersurface
  * during the next timestep.
+ *
+ * The crossings do not depend on other particles, hence they are found in a
+ * single pass over all particles with find_crossings, which needs neither a
+ * grid nor copies of the particles which do not cross.
  */
 class HyperSurfaceCrossActionsFinder : public ActionFinderInterface {
  public:
@@ -84,6 +88,10 @@ class HyperSurfaceCrossActionsFinder : public ActionFinderInterface {
   explicit HyperSurfaceCrossActionsFinder(double tau, double y, double pT)
       : prop_time_{tau}, rap_cut_{y}, pT_cut_{pT} {};
 
+  // The convenience overloads for a ParticleList are kept visible
+  using ActionFinderInterface::find_actions_in_cell;
+  using ActionFinderInterface::find_actions_with_neighbors;
+
   /**
    * Find the next hypersurface crossings for each particle that occur within
    * the timestepless propagation.
@@ -95,12 +103,27 @@ class HyperSurfaceCrossActionsFinder : public ActionFinderInterface {
    * wall crossings.
    */
   ActionList find_actions_in_cell(
-      const ParticleList &plist, double dt, const double,
+      const ParticleSpan &plist, double dt, const double,
       const std::vector<FourVector> &beam_momentum) const override;
 
+  /**
+   * Find the hypersurface crossings of all particles within the next time
+   * step, see find_actions_in_cell.
+   *
+   * \param[in] particles All particles of an ensemble, including the
+   *            unformed ones
+   * \param[in] dt Time until crossing can appear (until end of timestep). [fm]
+   * \param[in] beam_momentum [GeV] List of beam momenta for each particle;
+   *            only necessary for frozen Fermi motion
+   * \return List of all found crossings.
+   */
+  ActionList find_crossings(
+      const Particles &particles, double dt,
+      const std::vector<FourVector> &beam_momentum) const;
+
   /// Ignore the neighbor searches for hypersurface crossing
   ActionList find_actions_with_neighbors(
-      const ParticleList &, const ParticleList &, double,
+      const ParticleSpan &, const ParticleSpan &, double,
       const std::vector<FourVector> &) const override {
     return {};
   }
@@ -138,32 +161,49 @@ class HyperSurfaceCrossActionsFinder : public ActionFinderInterface {
    */
   const double pT_cut_;
 
+  /**
+   * Find the crossings of the particles of a range, see find_actions_in_cell.
+   *
+   * \param[in] particles Range of the particles
+   * \param[in] dt Time until the end of the time step [fm]
+   * \param[in] beam_momentum [GeV] Beam momenta for frozen Fermi motion
+   * \return List of all found crossings.
+   */
+  template <typename Range>
+  ActionList find_crossings_in_range(
+      const Range &particles, double dt,
+      const std::vector<FourVector> &beam_momentum) const;
+
   /**
    * Determine whether particle crosses hypersurface within next timestep
    * during propagation
-   * \param[in] pdata_before_propagation Particle data at the beginning of time
-   *            step in question
-   * \param[in] pdata_after_propagation Particle data at the end of time step
-   *            in question
+   * \param[in] t1 Time at the beginning of time step in question [fm]
+   * \param[in] z1 Longitudinal position at the beginning of the time step [fm]
+   * \param[in] t2 Time at the end of time step in question [fm]
+   * \param[in] z2 Longitudinal position at the end of the time step [fm]
    * \param[in] tau Proper time of the hypersurface that is tested
    * \return Does particle cross the hypersurface?
    */
-  bool crosses_hypersurface(ParticleData &pdata_before_propagation,
-                            ParticleData &pdata_after_propagation,
-                            const double tau) const;
+  static bool crosses_hypersurface(double t1, double z1, double t2, double z2,
+                                   double tau);
 
   /**
-   * Find the coordinates where particle crosses hypersurface
-   * \param[in] pdata_before_propagation Particle data at the beginning of time
-   *            in question
-   * \param[in] pdata_after_propagation Particle data at the end of time step
-   *            in question
+   * Find the time when the particle crosses the hypersurface
+   * \param[in] t1 Time at the beginning of time step in question [fm]
+   * \param[in] z1 Longitudinal position at the beginning of the time step [fm]
+   * \param[in] t2 Time at the end of time step in question [fm]
+   * \param[in] z2 Longitudinal position at the end of the time step [fm]
    * \param[in] tau Proper time of the hypersurface that is crossed
-   * \return Fourvector of the crossing position
+   * \return Time of the crossing [fm]
+   */
+  static double crossing_time(double t1, double z1, double t2, double z2,
+                              double tau);
+
+  /**
+   * \return whether a particle of momentum \p p is within the kinematic
+   *         cuts for the initial conditions
    */
-  FourVector coordinates_on_hypersurface(ParticleData &pdata_before_propagation,
-                                         ParticleData &pdata_after_propagation,
-                                         const double tau) const;
+  bool is_within_cuts(const FourVector &p) const;
 };
 
 }  // namespace smash
@@ -617,10 +617,11 @@ class Key {
  * \page doxypage_input_conf_modi_list
  * The `List` modus provides a modus for hydro afterburner calculations. It
  * takes files with a list of particles in \ref oscar2013_format
- * "Oscar 2013 format" as an input. These particles are treated as a starting
- * setup. Multiple events per file are supported. In the following, the input
- * keys are listed with a short description, an example is given and some
- * information about the input particle files is provided.
+ * "Oscar 2013 format" or in the binary format of the particles output as an
+ * input. These particles are treated as a starting setup. Multiple events per
+ * file are supported. In the following, the input keys are listed with a short
+ * description, an example is given and some information about the input
+ * particle files is provided.
  *
  * \attention
  * In `List` modus, the provided list of particles has to match information
@@ -1098,6 +1099,11 @@ struct InputKeys {
    *
    * Initial seed for the random number generator. If this is negative, the
    * seed will be randomly generated by the operating system.
+   *
+   * The random numbers are generated with the counter-based Philox algorithm.
+   * From the seed of each event, independent random streams are derived for
+   * every ensemble. Hence, the results do not depend on the number of <tt>\ref
+   * key_gen_threads_ "Threads"</tt>.
    */
   /**
    * \see_key{key_gen_randomseed_}
@@ -1232,6 +1238,57 @@ struct InputKeys {
   inline static const Key<int> gen_ensembles{
       {"General", "Ensembles"}, 1, {"2.1"}};
 
+  /*!\Userguide
+   * \page doxypage_input_conf_general
+   * \optional_key{key_gen_distribute_ensembles_,Distribute_Ensembles,bool,false}
+   *
+   * Distribute the <tt>\ref key_gen_ensembles_ "Ensembles"</tt> of every
+   * event over the processes of `smash_mpi`, instead of distributing the
+   * events, see \ref smash_invocation_mpi_. This is meant for many ensembles
+   * with mean-field potentials, which do not fit into the memory of one node.
+   * Every process evolves its share of the ensembles, while the densities on
+   * the lattices are summed over all processes in every time step, such that
+   * all processes compute the same potentials.
+   *
+   * The densities are only coupled through a lattice, which is therefore
+   * required with potentials. A minimum number of non-empty ensembles,
+   * adaptive time steps, forking the ensembles, event workers, forced
+   * thermalization, Pauli blocking, pregenerated initial states and
+   * checkpoints cannot be used in this mode. The initial states of the
+   * ensembles differ from the ones of a single process.
+   */
+  /**
+   * \see_key{key_gen_distribute_ensembles_}
+   */
+  inline static const Key<bool> gen_distributeEnsembles{
+      {"General", "Distribute_Ensembles"}, false, {"3.2"}};
+
+  /*!\Userguide
+   * \page doxypage_input_conf_general
+   * \optional_key{key_gen_event_workers_,Event_Workers,int,1}
+   *
+   * Number of events generated concurrently within one SMASH process.
+   *
+   * Every worker is an independent copy of the experiment set up from this
+   * configuration, while the particle and decay-mode tables and all
+   * tabulations are shared. This saves the start-up time and memory of
+   * running many SMASH processes side by side. The events are handed out to
+   * the workers in order, each one with the random seed it would have in a
+   * sequential run. The output of the workers is kept in memory until all
+   * previous events have been written, such that the output files are the
+   * same as without workers and do not depend on their number.
+   *
+   * This option cannot be used with the `"List"` and `"ListBox"` modi, which
+   * read the events one after another, nor with forced thermalization. It can
+   * be combined with <tt>\ref key_gen_threads_ "Threads"</tt>, in which case
+   * every worker uses that many threads.
+   */
+  /**
+   * \see_key{key_gen_event_workers_}
+   */
+  inline static const Key<int> gen_eventWorkers{
+      {"General", "Event_Workers"}, 1, {"3.2"}};
+
   /*!\Userguide
    * \page doxypage_input_conf_general
    * \optional_key{key_gen_expansion_rate_,Expansion_Rate,double,0.1}
@@ -1250,6 +1307,34 @@ struct InputKeys {
   inline static const Key<double> gen_expansionRate{
       {"General", "Expansion_Rate"}, 0.1, {"1.1"}};
 
+  /*!\Userguide
+   * \page doxypage_input_conf_general
+   * \optional_key{key_gen_fft_smearing_,FFT_Smearing,bool,false}
+   *
+   * Whether to smear the densities on the lattice by fast Fourier transforms.
+   * The particles are first distributed over the eight lattice nodes around
+   * them, linearly in their distance to the nodes, and the result is then
+   * convolved with the smearing kernel. This costs the same for any number of
+   * particles, which pays off for many test-particles, but the kernel is the
+   * same for all particles: The `"Covariant Gaussian"` smearing uses the
+   * Gaussian of particles at rest, without the Lorentz contraction, such that
+   * it is only suited for slow particles. The `"Triangular"` smearing is the
+   * one of particles sitting on a node, which still conserves the number of
+   * particles on the lattice.
+   *
+   * The spatial derivatives of the currents are then computed in Fourier space
+   * as well, which requires `Derivatives_Mode: "Finite difference"` (or
+   * `"Off"`). They are central differences also on the boundaries of
+   * non-periodic lattices, where the smeared currents are continued beyond the
+   * lattice. `"Discrete"` smearing is not supported. Densities away from the
+   * lattice are always smeared particle by particle.
+   */
+  /**
+   * \see_key{key_gen_fft_smearing_}
+   */
+  inline static const Key<bool> gen_fftSmearing{
+      {"General", "FFT_Smearing"}, false, {"3.2"}};
+
   /*!\Userguide
    * \page doxypage_input_conf_general
    * \optional_key{key_gen_field_derivatives_mode_,Field_Derivatives_Mode,string,
@@ -1324,6 +1409,308 @@ struct InputKeys {
   inline static const Key<ExpansionMode> gen_metricType{
       {"General", "Metric_Type"}, ExpansionMode::NoExpansion, {"1.1"}};
 
+  /*!\Userguide
+   * \page doxypage_input_conf_general
+   * \optional_key{key_gen_profile_,Profile,bool,false}
+   *
+   * Measure the real time spent in the phases of the time evolution, e.g. the
+   * grid construction, the action finding, the propagation or the output. The
+   * times are printed as a table at the end of every event and summed over all
+   * events at the end of the run. The latter is also written together with the
+   * times of the single events to `profile.json` in the output directory.
+   *
+   * Phases which run in several threads at the same time are summed over the
+   * threads, such that their time can exceed the wall time.
+   */
+  /**
+   * \see_key{key_gen_profile_}
+   */
+  inline static const Key<bool> gen_profile{
+      {"General", "Profile"}, false, {"3.2"}};
+
+  /*!\Userguide
+   * \page doxypage_input_conf_general
+   * \optional_key{key_gen_profile_counters_,Profile_Counters,bool,false}
+   *
+   * Together with `Profile`, additionally count the CPU cycles, instructions,
+   * last-level cache misses and mispredicted branches of every phase with the
+   * hardware performance counters. They are written to `profile.json` along
+   * with the instructions per cycle and the cache misses per particle at the
+   * end of the event.
+   *
+   * The counters are read with `perf_event_open`, which is only available on
+   * Linux and might need a lower value of
+   * `/proc/sys/kernel/perf_event_paranoid`. If they are not available, a
+   * warning is printed and only the times are measured.
+   */
+  /**
+   * \see_key{key_gen_profile_counters_}
+   */
+  inline static const Key<bool> gen_profileCounters{
+      {"General", "Profile_Counters"}, false, {"3.2"}};
+
+  /*!\Userguide
+   * \page doxypage_input_conf_general
+   * \optional_key{key_gen_trace_events_,Trace_Events,int,0}
+   *
+   * Number of events, starting with the first one, for which every measured
+   * phase of the time evolution is recorded with its start, duration and
+   * thread, like for the `Profile` key. Additionally, time steps, ensembles,
+   * string fragmentations and lattice updates are recorded. The trace is
+   * written to `trace.json` in the output directory in the Chrome trace event
+   * format, which can be opened with [Perfetto](https://ui.perfetto.dev) or
+   * `chrome://tracing`. Every event is shown as a process.
+   */
+  /**
+   * \see_key{key_gen_trace_events_}
+   */
+  inline static const Key<int> gen_traceEvents{
+      {"General", "Trace_Events"}, 0, {"3.2"}};
+
+  /*!\Userguide
+   * \page doxypage_input_conf_general
+   * \optional_key{key_gen_trace_max_spans_,Trace_Max_Spans,int,1000000}
+   *
+   * Largest number of recorded spans per traced event, see `Trace_Events`.
+   * Further spans of the event are dropped, and their number is written to
+   * the trace. This bounds the memory and the size of the trace.
+   */
+  /**
+   * \see_key{key_gen_trace_max_spans_}
+   */
+  inline static const Key<int> gen_traceMaxSpans{
+      {"General", "Trace_Max_Spans"}, 1000000, {"3.2"}};
+
+  /*!\Userguide
+   * \page doxypage_input_conf_general
+   * \optional_key{key_gen_capture_collisions_,Capture_Collisions,bool,false}
+   *
+   * Write every pair of particles, which is checked for a collision, and
+   * every performed two-particle collision with its incoming particles to
+   * `collisions.trace` in the output directory. The trace can be fed into
+   * the collision finder and the final state generation again with
+   * `smash_replay`, which measures them in isolation:
+   * \verbatim
+   ./smash_replay -i <config> -t <output directory>/collisions.trace
+   \endverbatim
+   * The configuration has to be the one of the captured run, such that the
+   * same particles and reactions are used. The replay does not include
+   * potentials or the frozen Fermi motion of the nuclei.
+   *
+   * The trace grows by about 240 bytes per checked pair, so it is meant for
+   * short runs. Collisions can only be captured with a single event worker.
+   */
+  /**
+   * \see_key{key_gen_capture_collisions_}
+   */
+  inline static const Key<bool> gen_captureCollisions{
+      {"General", "Capture_Collisions"}, false, {"3.2"}};
+
+  /*!\Userguide
+   * \page doxypage_input_conf_general
+   * \optional_key{key_gen_memory_report_,Memory_Report,bool,false}
+   *
+   * Print the memory used by the particles of all ensembles, the grids, the
+   * found actions, the lattices, the tabulations and the output buffers at the
+   * end of every event, together with the resident set size of the process
+   * and their peak values. The number of PYTHIA objects is printed as well.
+   * Only the large containers of the subsystems are accounted for, hence the
+   * sum is smaller than the resident set size.
+   */
+  /**
+   * \see_key{key_gen_memory_report_}
+   */
+  inline static const Key<bool> gen_memoryReport{
+      {"General", "Memory_Report"}, false, {"3.2"}};
+
+  /*!\Userguide
+   * \page doxypage_input_conf_general
+   * \optional_key{key_gen_memory_limit_,Memory_Limit,double,0}
+   *
+   * Limit of the resident set size of SMASH in MiB, which is checked after
+   * every time step. If it is exceeded, SMASH stops with an error showing the
+   * memory used by the subsystems, see `Memory_Report`, instead of being
+   * killed by the operating system or the batch system. A limit of 0 means
+   * no limit.
+   */
+  /**
+   * \see_key{key_gen_memory_limit_}
+   */
+  inline static const Key<double> gen_memoryLimit{
+      {"General", "Memory_Limit"}, 0., {"3.2"}};
+
+  /*!\Userguide
+   * \page doxypage_input_conf_general
+   * \optional_key{key_gen_max_hole_fraction_,Max_Hole_Fraction,double,1.0}
+   *
+   * Removed particles leave holes in the storage of the particles, which are
+   * filled by later particles, but skipped by every loop over the particles.
+   * If more than this fraction of the storage are holes at the beginning of a
+   * time step, the particles are moved into the holes. This changes the order
+   * of the particles, and hence the results of an event, but not their
+   * distributions. The default of 1 never compacts the particles.
+   */
+  /**
+   * \see_key{key_gen_max_hole_fraction_}
+   */
+  inline static const Key<double> gen_maxHoleFraction{
+      {"General", "Max_Hole_Fraction"}, 1.0, {"3.2"}};
+
+  /*!\Userguide
+   * \page doxypage_input_conf_general
+   * \optional_key{key_gen_particle_sort_interval_,Particle_Sort_Interval,int,0}
+   *
+   * Number of time steps, after which the particles are sorted by their
+   * position at the beginning of a time step. The particles stay in the order
+   * they were created otherwise, such that particles close in space are
+   * scattered over the whole storage after a while. Sorted by the Morton key
+   * of their grid cell, the particles of a cell or of a lattice region are
+   * read from consecutive memory again. Like compacting the particles (see
+   * <tt>\ref key_gen_max_hole_fraction_ "Max_Hole_Fraction"</tt>), this
+   * changes the order of the particles, and hence the results of an event,
+   * but not their distributions. The default of 0 never sorts the particles.
+   */
+  /**
+   * \see_key{key_gen_particle_sort_interval_}
+   */
+  inline static const Key<int> gen_particleSortInterval{
+      {"General", "Particle_Sort_Interval"}, 0, {"3.2"}};
+
+  /*!\Userguide
+   * \page doxypage_input_conf_general
+   * \optional_key{key_gen_freeze_out_window_,Freeze_Out_Window,double,0.0}
+   *
+   * Time \unit{in fm}, after which an event counts as frozen out, if no pair
+   * of particles came within reach of a collision meanwhile. This is checked
+   * at the end of every time step, once the event had a collision. The
+   * particles of a frozen out event only stream freely until the
+   * <tt>\ref key_gen_end_time_ "End_Time"</tt>, without grid and action
+   * finding, and the intermediate output is written at the usual times.
+   * Decays which are still pending are performed at the end of the event.
+   * This is meant for collider events, which can be run with a generous end
+   * time then, and needs <tt>\ref key_CT_force_decays_at_end_
+   * "Force_Decays_At_End"</tt>. It cannot be used with potentials, forced
+   * thermalization, the box modus, the initial conditions output, an expanding
+   * metric or ensembles distributed over several processes. The default of 0
+   * always evolves the events until the end time.
+   */
+  /**
+   * \see_key{key_gen_freeze_out_window_}
+   */
+  inline static const Key<double> gen_freezeOutWindow{
+      {"General", "Freeze_Out_Window"}, 0.0, {"3.2"}};
+
+  /*!\Userguide
+   * \page doxypage_input_conf_general
+   * \optional_key{key_gen_batch_wall_crossings_,Batch_Wall_Crossings,bool,false}
+   *
+   * In the box modus, move the particles which left the box back into it
+   * whenever the particles are propagated, instead of finding and performing
+   * a wall crossing action for every particle reaching a wall. The wall
+   * crossings are still written to the collision outputs, but at the time of
+   * the propagation instead of the time the wall is reached and without the
+   * density at the interaction point. This saves the actions in large boxes.
+   */
+  /**
+   * \see_key{key_gen_batch_wall_crossings_}
+   */
+  inline static const Key<bool> gen_batchWallCrossings{
+      {"General", "Batch_Wall_Crossings"}, false, {"3.2"}};
+
+  /*!\Userguide
+   * \page doxypage_input_conf_general
+   * \optional_key{key_gen_checkpoint_interval_,Checkpoint_Interval,double,0}
+   *
+   * Time in fm between two checkpoints of the time evolution, which are
+   * written at the end of a time step to `checkpoint.bin` in the output
+   * directory, replacing the previous one. A long event can then be resumed
+   * with `Restart_From` after the job was interrupted. An interval of 0 means
+   * no checkpoints. Checkpoints cannot be used with more than one event
+   * worker.
+   */
+  /**
+   * \see_key{key_gen_checkpoint_interval_}
+   */
+  inline static const Key<double> gen_checkpointInterval{
+      {"General", "Checkpoint_Interval"}, 0., {"3.2"}};
+
+  /*!\Userguide
+   * \page doxypage_input_conf_general
+   * \optional_key{key_gen_restart_from_,Restart_From,string,none}
+   *
+   * Path of a checkpoint written with `Checkpoint_Interval`, from which the
+   * run is resumed. The event of the checkpoint is initialized again with its
+   * seed, its state is replaced by the one of the checkpoint and the run
+   * continues with the remaining events. The configuration, the particles
+   * and the decay modes must be the same as for the interrupted run, and the
+   * checkpoint can only be read by the same build of SMASH. The outputs are
+   * written to the new output directory and contain the resumed event from
+   * its start, but only the particles of the time steps after the checkpoint.
+   * The list modus cannot be resumed.
+   */
+  /**
+   * \see_key{key_gen_restart_from_}
+   */
+  inline static const Key<std::string> gen_restartFrom{
+      {"General", "Restart_From"}, {"3.2"}};
+
+  /*!\Userguide
+   * \page doxypage_input_conf_general
+   * \optional_key{key_gen_ensemble_fork_time_,Ensemble_Fork_Time,double,none}
+   *
+   * Time in fm at which the first ensemble of a box is forked into all
+   * ensembles. Until then, only the first ensemble is sampled and evolved,
+   * e.g. to equilibrate it. At the forking time, the other ensembles become
+   * copies of it, which then continue with their own random streams. Since
+   * the box is equilibrated only once, the statistics of the ensembles are
+   * much cheaper, but note that the forks start from the same state and
+   * decorrelate only with time. The forks are evolved concurrently with
+   * `Threads`. Forking is only possible in the box modus, with more than one
+   * ensemble and without potentials. The outputs of the other ensembles are
+   * empty before the forking time.
+   */
+  /**
+   * \see_key{key_gen_ensemble_fork_time_}
+   */
+  inline static const Key<double> gen_ensembleForkTime{
+      {"General", "Ensemble_Fork_Time"}, {"3.2"}};
+
+  /*!\Userguide
+   * \page doxypage_input_conf_general
+   * \optional_key{key_gen_conservation_check_,Conservation_Check,string,"Full"}
+   *
+   * How thoroughly the conservation of energy, momentum and quantum numbers is
+   * checked during the evolution.
+   * - `"Full"`: Every action is checked, and the sum over all particles is
+   *   compared to the initial one after every time step.
+   * - `"Sampled"`: Only every n-th action of each ensemble is checked, see
+   *   `Conservation_Check_Interval`. The conserved quantities are updated by
+   *   the changes of every action instead of summing over all particles, and
+   *   they are compared to the initial ones after every time step.
+   * - `"Off"`: The conservation laws are not checked.
+   *
+   * The energy violated by PYTHIA is accounted for in any case. As before, the
+   * sums are not checked after the time steps with potentials, strings,
+   * expansion or the initial conditions output.
+   */
+  /**
+   * \see_key{key_gen_conservation_check_}
+   */
+  inline static const Key<ConservationCheck> gen_conservationCheck{
+      {"General", "Conservation_Check"}, ConservationCheck::Full, {"3.2"}};
+
+  /*!\Userguide
+   * \page doxypage_input_conf_general
+   * \optional_key{key_gen_conservation_check_interval_,Conservation_Check_Interval,int,100}
+   *
+   * Every how many actions one is checked with `Conservation_Check: "Sampled"`.
+   */
+  /**
+   * \see_key{key_gen_conservation_check_interval_}
+   */
+  inline static const Key<int> gen_conservationCheckInterval{
+      {"General", "Conservation_Check_Interval"}, 100, {"3.2"}};
+
   /*!\Userguide
    * \page doxypage_input_conf_general
    * \optional_key{key_gen_rfdd_mode_,Rest_Frame_Density_Derivatives_Mode,string,"Off"}
@@ -1428,6 +1815,73 @@ struct InputKeys {
   inline static const Key<int> gen_testparticles{
       {"General", "Testparticles"}, 1, {"0.50"}};
 
+  /*!\Userguide
+   * \page doxypage_input_conf_general
+   * \optional_key{key_gen_threads_,Threads,int,1}
+   *
+   * Number of threads used to evolve the <tt>\ref key_gen_ensembles_
+   * "Ensembles"</tt> of an event concurrently.
+   *
+   * Within a timestep, the ensembles only couple through the mean-field
+   * potentials, which are updated at the end of the timestep. Hence, the
+   * collision finding and the propagation from action to action are carried
+   * out for several ensembles at the same time, while the update of the
+   * potentials and of the momenta is done by one thread only. More threads
+   * than ensembles only help the parts, which are parallel within an ensemble
+   * as well: the strings fragmented in parallel, see <tt>\ref
+   * key_CT_SP_batch_fragmentation_ "Batch_Fragmentation"</tt>, the final
+   * states of a single ensemble sampled ahead, see <tt>\ref
+   * key_CT_speculation_window_ "Speculation_Window"</tt>, the updates of the
+   * lattices and of their gradients, and the thermodynamic lattice output,
+   * which all share the same threads. A single ensemble instead
+   * searches the layers of cells of its grid for actions concurrently, each
+   * layer with a random number stream of its own. In the box and sphere
+   * modi, the thermal initial momenta of the particle species are also
+   * sampled concurrently, as are the particles in the cells of the <tt>\ref
+   * doxypage_input_conf_forced_therm "Forced_Thermalization"</tt>. The final
+   * decays at the end of an event are found for the ensembles concurrently,
+   * and the final states of all decays are generated in parallel before they
+   * are performed in the order of the ensembles.
+   *
+   * Each ensemble uses its own random number stream, derived from the random
+   * seed of the event. Therefore, the physics results for a given random seed
+   * do not depend on the number of threads. The ID of the processes is
+   * counted for each ensemble on its own and interleaved over the ensembles.
+   * Not reproducible is only the order, in which actions of different
+   * ensembles are written to the output.
+   *
+   * This option cannot be combined with Pauli blocking, because it couples the
+   * ensembles at every action.
+   */
+  /**
+   * \see_key{key_gen_threads_}
+   */
+  inline static const Key<int> gen_threads{
+      {"General", "Threads"}, 1, {"3.2"}};
+
+  /*!\Userguide
+   * \page doxypage_input_conf_general
+   * \optional_key{key_gen_pin_threads_,Pin_Threads,bool,false}
+   *
+   * Whether the <tt>\ref key_gen_threads_ "Threads"</tt> are bound to one CPU
+   * each, the i-th thread to the i-th CPU, which is only supported on Linux.
+   * The tasks are then distributed round-robin, such that every ensemble is
+   * always evolved by the same thread, and the particles of every ensemble are
+   * copied by this thread at the beginning of an event. On machines with
+   * several NUMA nodes, the operating system places memory on the node of the
+   * thread touching it first, hence every thread then works with particles in
+   * local memory. The CPUs should not be shared with other jobs, which is
+   * best ensured by the batch system, and the order of the CPUs should
+   * follow the NUMA nodes, as it usually does. Incompatible with more than
+   * one of the <tt>\ref key_gen_event_workers_ "Event_Workers"</tt>, whose
+   * threads would be bound to the same CPUs.
+   */
+  /**
+   * \see_key{key_gen_pin_threads_}
+   */
+  inline static const Key<bool> gen_pinThreads{
+      {"General", "Pin_Threads"}, false, {"3.2"}};
+
   /*!\Userguide
    * \page doxypage_input_conf_general
    * \optional_key{key_gen_time_step_mode_,Time_Step_Mode,string,"Fixed"}
@@ -1438,6 +1892,18 @@ struct InputKeys {
    * - `"Fixed"`&rarr; Fixed-sized time steps at which collision-finding grid is
    *   created. More efficient for systems with many particles. The `Delta_Time`
    *   is provided by user.
+   * - `"Adaptive"` &rarr; The time steps start with `Delta_Time` and are
+   *   adapted after every time step within
+   *   <tt>\ref key_gen_min_delta_time_ "Min_Delta_Time"</tt> and
+   *   <tt>\ref key_gen_max_delta_time_ "Max_Delta_Time"</tt>. A time step is
+   *   at most a tenth of the time in which the forces of the potentials change
+   *   the momenta of the particles, and at most a tenth of the time in which
+   *   there are as many scatterings as particles at the scattering rate of
+   *   the last time step. It grows by at most a factor of two from one time
+   *   step to the next. Dense stages are hence evolved in small time steps,
+   *   while the dilute late stages take large ones. The output times are not
+   *   affected.
+   *   This cannot be used with the stochastic collision criterion.
    *
    * For `Delta_Time` explanation see \ref key_gen_delta_time_ "here".
    *
@@ -1452,6 +1918,30 @@ struct InputKeys {
   inline static const Key<TimeStepMode> gen_timeStepMode{
       {"General", "Time_Step_Mode"}, TimeStepMode::Fixed, {"0.85"}};
 
+  /*!\Userguide
+   * \page doxypage_input_conf_general
+   * \optional_key{key_gen_min_delta_time_,Min_Delta_Time,double,Delta_Time}
+   *
+   * Smallest time step \unit{in fm} with `Time_Step_Mode: "Adaptive"`.
+   */
+  /**
+   * \see_key{key_gen_min_delta_time_}
+   */
+  inline static const Key<double> gen_minDeltaTime{
+      {"General", "Min_Delta_Time"}, {"3.2"}};
+
+  /*!\Userguide
+   * \page doxypage_input_conf_general
+   * \optional_key{key_gen_max_delta_time_,Max_Delta_Time,double,10 Delta_Time}
+   *
+   * Largest time step \unit{in fm} with `Time_Step_Mode: "Adaptive"`.
+   */
+  /**
+   * \see_key{key_gen_max_delta_time_}
+   */
+  inline static const Key<double> gen_maxDeltaTime{
+      {"General", "Max_Delta_Time"}, {"3.2"}};
+
   /*!\Userguide
    * \page doxypage_input_conf_general
    * \optional_key{key_gen_triangular_range_,Triangular_Range,double,2.0}
@@ -1979,6 +2469,34 @@ struct InputKeys {
       CollisionCriterion::Covariant,
       {"1.7"}};
 
+  /*!\Userguide
+   * \page doxypage_input_conf_collision_term
+   * \optional_key{key_CT_collision_search_,Collision_Search,string,"Grid"}
+   *
+   * How the pairs of particles, which may collide, are searched with the
+   * geometric and covariant collision criteria. The found collisions do not
+   * depend on it, only the time needed to find them.
+   * - `"Grid"` &rarr; The particles are sorted into the cells of a grid,
+   *   whose length covers the interaction range, and particles within the
+   *   same and neighboring cells are paired.
+   * - `"Sweep"` &rarr; The particles are sorted along the axis in which they
+   *   are spread the most, and particles within the interaction range along
+   *   this axis are paired. This is faster for very anisotropic densities,
+   *   like those of the Lorentz-contracted nuclei in ultra-relativistic
+   *   collisions, where few cells of the grid hold many particles.
+   * - `"Auto"` &rarr; Both searches are tried from time to time and the one
+   *   which examines fewer pairs is used for the following time steps.
+   *
+   * \note
+   * The sweep is not available with periodic boundaries (box modus) and the
+   * stochastic collision criterion, where `"Auto"` always uses the grid.
+   */
+  /**
+   * \see_key{key_CT_collision_search_}
+   */
+  inline static const Key<CollisionSearch> collTerm_collisionSearch{
+      {"Collision_Term", "Collision_Search"}, CollisionSearch::Grid, {"3.2"}};
+
   /*!\Userguide
    * \page doxypage_input_conf_collision_term
    * \optional_key{key_CT_cs_scaling_,Cross_Section_Scaling,double,1.0}
@@ -2123,6 +2641,57 @@ struct InputKeys {
   inline static const Key<bool> collTerm_forceDecaysAtEnd{
       {"Collision_Term", "Force_Decays_At_End"}, true, {"0.60"}};
 
+  /*!\Userguide
+   * \page doxypage_input_conf_collision_term
+   * \optional_key{key_CT_freeze_spectators_,Freeze_Spectators,bool,false}
+   *
+   * Leave the spectators of a collider run, i.e. the nucleons of projectile
+   * and target which did not collide yet, out of the search for collisions,
+   * as long as no possible collision partner is within reach in the current
+   * time step. They are still propagated and put back into the search as soon
+   * as they come close to another particle they could interact with. This
+   * saves time especially while the nuclei approach each other and in
+   * peripheral collisions, without changing the results.
+   * - `true` &rarr; Freeze spectators which cannot interact.
+   * - `false` &rarr; Search collisions of all particles.
+   *
+   * \note
+   * This only has an effect in collider modus and with a geometric collision
+   * criterion.
+   */
+  /**
+   * \see_key{key_CT_freeze_spectators_}
+   */
+  inline static const Key<bool> collTerm_freezeSpectators{
+      {"Collision_Term", "Freeze_Spectators"}, false, {"3.2"}};
+
+  /*!\Userguide
+   * \page doxypage_input_conf_collision_term
+   * \optional_key{key_CT_freeze_escaping_particles_,Freeze_Escaping_Particles,bool,false}
+   *
+   * Leave the particles of a collider run, which escaped from the interacting
+   * core, out of the search for collisions, as long as no other particle is
+   * within reach in the current time step. The core is enclosed by the box of
+   * the particles which interacted or were produced within the last time
+   * step. The escaped particles are still propagated and their decays are
+   * still searched, and they are put back into the search as soon as another
+   * particle comes close. This saves time in the late stage of an event.
+   * Unlike with <tt>\ref key_CT_freeze_spectators_ "Freeze_Spectators"</tt>,
+   * the single events change, as the decays of the escaped particles are
+   * sampled apart from the others, but not their distributions.
+   * - `true` &rarr; Freeze particles which escaped from the core.
+   * - `false` &rarr; Search collisions of all particles.
+   *
+   * \note
+   * This only has an effect in collider modus and with a geometric collision
+   * criterion.
+   */
+  /**
+   * \see_key{key_CT_freeze_escaping_particles_}
+   */
+  inline static const Key<bool> collTerm_freezeEscapingParticles{
+      {"Collision_Term", "Freeze_Escaping_Particles"}, false, {"3.2"}};
+
   /*!\Userguide
    * \page doxypage_input_conf_collision_term
    * \optional_key{key_CT_include_decays_end_,Include_Weak_And_EM_Decays_At_The_End,bool,false}
@@ -2213,6 +2782,30 @@ struct InputKeys {
   inline static const Key<bool> collTerm_isotropic{
       {"Collision_Term", "Isotropic"}, false, {"0.7.1"}};
 
+  /*!\Userguide
+   * \page doxypage_input_conf_collision_term
+   * \optional_key{key_CT_max_cell_occupancy_,Max_Cell_Occupancy,int,0}
+   *
+   * The number of particles in a grid cell of the stochastic criterion, above
+   * which the cell is divided into eight octants for the collision search. The
+   * octants are divided further as long as they hold more particles, unless
+   * they would become shorter than
+   * <tt>\ref key_CT_min_subcell_length_ "Min_Subcell_Length"</tt>. Only
+   * particles within the same octant are checked for collisions, with the
+   * collision probabilities scaled by the volume of the octant instead of the
+   * cell. This keeps the number of checked pairs small in dense regions, where
+   * the smaller cells still resolve the density well, and leaves dilute
+   * regions unchanged. A value of `0` disables the division.
+   *
+   * \note
+   * This can only be used with the stochastic collision criterion.
+   */
+  /**
+   * \see_key{key_CT_max_cell_occupancy_}
+   */
+  inline static const Key<int> collTerm_maxCellOccupancy{
+      {"Collision_Term", "Max_Cell_Occupancy"}, 0, {"3.2"}};
+
   /*!\Userguide
    * \page doxypage_input_conf_collision_term
    * \optional_key{key_CT_max_cs_,Maximum_Cross_Section,double,
@@ -2235,6 +2828,22 @@ struct InputKeys {
   inline static const Key<double> collTerm_maximumCrossSection{
       {"Collision_Term", "Maximum_Cross_Section"}, {"2.0"}};
 
+  /*!\Userguide
+   * \page doxypage_input_conf_collision_term
+   * \optional_key{key_CT_min_subcell_length_,Min_Subcell_Length,double,0.5}
+   *
+   * The minimal length \unit{in fm} of the octants, into which the grid cells
+   * of the stochastic criterion are divided with
+   * <tt>\ref key_CT_max_cell_occupancy_ "Max_Cell_Occupancy"</tt>. Since the
+   * collision probabilities grow with the inverse volume of the octants, it
+   * should be chosen such that they stay well below one.
+   */
+  /**
+   * \see_key{key_CT_min_subcell_length_}
+   */
+  inline static const Key<double> collTerm_minSubcellLength{
+      {"Collision_Term", "Min_Subcell_Length"}, 0.5, {"3.2"}};
+
   /*!\Userguide
    * \page doxypage_input_conf_collision_term
    * \optional_key{key_CT_mp_reactions_,Multi_Particle_Reactions,list of
@@ -2361,6 +2970,68 @@ struct InputKeys {
   inline static const Key<double> collTerm_resonanceLifetimeModifier{
       {"Collision_Term", "Resonance_Lifetime_Modifier"}, 1.0, {"1.8"}};
 
+  /*!\Userguide
+   * \page doxypage_input_conf_collision_term
+   * \optional_key{key_CT_sample_pairs_,Sample_Pairs,bool,false}
+   *
+   * Whether the stochastic criterion samples the pairs of a grid cell, which
+   * are checked for collisions, instead of checking all of them. The collision
+   * probability of every pair is bounded by the majorant
+   * \f$P_\mathrm{max} = 2\sigma_\mathrm{max} f_\mathrm{max}^2 \Delta t /
+   * (N_\mathrm{test} V)\f$, with the maximal cross section
+   * <tt>\ref key_CT_max_cs_ "Maximum_Cross_Section"</tt>, the largest cross
+   * section scaling factor \f$f_\mathrm{max}\f$ of the particles in the cell
+   * and the upper limit 2 of the relative velocity. The number of candidate
+   * pairs is drawn from a binomial distribution with \f$P_\mathrm{max}\f$
+   * out of all pairs, the candidates are picked at random and each collides
+   * with the probability \f$P/P_\mathrm{max}\f$. This yields the same
+   * collision probability for every pair as checking all of them, at a cost
+   * which grows with the number of collisions rather than with the number of
+   * pairs. Cells in which \f$P_\mathrm{max}\f$ exceeds one half are checked
+   * pair by pair as usual.
+   *
+   * \note
+   * This can only be used with the stochastic collision criterion. A pair
+   * whose probability exceeds the majorant is treated like a probability
+   * larger than 1, see
+   * <tt>\ref key_CT_warn_high_prob_ "Only_Warn_For_High_Probability"</tt>.
+   */
+  /**
+   * \see_key{key_CT_sample_pairs_}
+   */
+  inline static const Key<bool> collTerm_samplePairs{
+      {"Collision_Term", "Sample_Pairs"}, false, {"3.2"}};
+
+  /*!\Userguide
+   * \page doxypage_input_conf_collision_term
+   * \optional_key{key_CT_speculation_window_,Speculation_Window,int,0}
+   *
+   * Number of upcoming collisions whose final states are generated in
+   * parallel, while the actions of a time step are performed one after the
+   * other. A value of 0 switches this off. The final states are sampled
+   * ahead, including the fragmentation of strings, for the collisions of the
+   * window which neither share a particle with an earlier action of the
+   * window nor are close enough to it in space and time, such that the
+   * particles produced by the earlier action could reach them. The
+   * collisions are still performed in the order of time and are checked
+   * again, a collision which became invalid meanwhile is discarded like
+   * without this option.
+   *
+   * For this, the final state of every collision is sampled from a random
+   * stream of its own, like with <tt>\ref key_CT_SP_batch_fragmentation_
+   * "Batch_Fragmentation"</tt>. The results therefore differ from those
+   * without this option, but they are the same for every window and number
+   * of \ref key_gen_threads_ "Threads", including one thread, which
+   * performs the collisions without sampling ahead. The final states are
+   * only sampled in parallel for a single ensemble, since several ensembles
+   * already occupy the threads.
+   */
+  /**
+   * \see_key{key_CT_speculation_window_}
+   */
+  inline static const Key<int> collTerm_speculationWindow{
+      {"Collision_Term", "Speculation_Window"}, 0, {"3.2"}};
+
   /*!\Userguide
    * \page doxypage_input_conf_collision_term
    * \optional_key{key_CT_strings_,Strings,bool,
@@ -2405,6 +3076,29 @@ struct InputKeys {
   inline static const Key<bool> collTerm_stringsWithProbability{
       {"Collision_Term", "Strings_with_Probability"}, true, {"1.3"}};
 
+  /*!\Userguide
+   * \page doxypage_input_conf_collision_term
+   * \optional_key{key_CT_tabulated_xs_,Tabulated_Cross_Sections,bool,false}
+   *
+   * Interpolate the collision branches of two stable particles from tables
+   * instead of computing all partial cross sections for every pair.
+   *
+   * The branches of each pair of particle types are evaluated on a grid of
+   * the center-of-mass energy with a spacing of 2 MeV, up to 5 GeV above the
+   * threshold, when they are needed first. In between, the partial cross
+   * sections are linearly interpolated, while branches which open between
+   * two grid points are neglected up to the next one. This speeds up the
+   * collision finding in particular at low energies, but it is an
+   * approximation, hence the exact evaluation is the default. The tables are
+   * not used if potentials are enabled, for resonances, and for particles off
+   * their mass shell.
+   */
+  /**
+   * \see_key{key_CT_tabulated_xs_}
+   */
+  inline static const Key<bool> collTerm_tabulatedCrossSections{
+      {"Collision_Term", "Tabulated_Cross_Sections"}, false, {"3.2"}};
+
   /*!\Userguide
    * \page doxypage_input_conf_collision_term
    * \optional_key{key_CT_two_to_one_,Two_to_One,bool,true}
@@ -2488,6 +3182,24 @@ struct InputKeys {
       1.86,
       {"0.7.1"}};
 
+  /*!\Userguide
+   * \page doxypage_input_conf_ct_pauliblocker
+   * \optional_key{key_CT_PB_use_lattice_,Use_Lattice,bool,false}
+   *
+   * Whether to deposit the phase-space densities of the baryons on the lattice
+   * once per time step, with the momentum space divided into cells of the
+   * momentum averaging radius. The densities are then taken at the centres of
+   * the lattice cell and momentum cell of a particle, such that their cost
+   * does not grow with the number of particles. This requires a lattice, see
+   * \ref doxypage_input_conf_lattice. Baryons produced within a time step
+   * only contribute from the next time step on.
+   */
+  /**
+   * \see_key{key_CT_PB_use_lattice_}
+   */
+  inline static const Key<bool> collTerm_pauliBlocking_useLattice{
+      {"Collision_Term", "Pauli_Blocking", "Use_Lattice"}, false, {"3.2"}};
+
   /*!\Userguide
    * \page doxypage_input_conf_ct_string_transition
    * \optional_key{key_CT_ST_KN_offset_,KN_Offset,double,15.15}
@@ -2581,6 +3293,30 @@ struct InputKeys {
       1.0,
       {"3.0"}};
 
+  /*!\Userguide
+   * \page doxypage_input_conf_ct_string_parameters
+   * \optional_key{key_CT_SP_batch_fragmentation_,Batch_Fragmentation,bool,
+   * false}
+   *
+   * Fragment the strings of the collisions found in a time step in parallel,
+   * before the collisions are performed in the order of time. For this, the
+   * final state of every collision is sampled from a random stream of its
+   * own, which is derived from the seed, the ensemble and the colliding
+   * particles. The results therefore differ from those without this option,
+   * but they do not depend on the number of threads given by
+   * \ref key_gen_threads_ "Threads". Strings of collisions which become
+   * invalid before they are performed are fragmented in vain, which only
+   * costs time. This option pays off in high-energy runs, where the string
+   * fragmentation dominates the run time.
+   */
+  /**
+   * \see_key{key_CT_SP_batch_fragmentation_}
+   */
+  inline static const Key<bool> collTerm_stringParam_batchFragmentation{
+      {"Collision_Term", "String_Parameters", "Batch_Fragmentation"},
+      false,
+      {"3.2"}};
+
   /*!\Userguide
    * \page doxypage_input_conf_ct_string_parameters
    * \optional_key{key_CT_SP_diquark_supp_,Diquark_Supp,double,0.036}
@@ -2722,6 +3458,47 @@ struct InputKeys {
       {"Collision_Term", "String_Parameters", "Power_Particle_Formation"},
       {"1.4"}};
 
+  /*!\Userguide
+   * \page doxypage_input_conf_ct_string_parameters
+   * \optional_key{key_CT_SP_prewarm_hard_beams_,Prewarm_Hard_Beams,list of
+   * strings,[]}
+   *
+   * Pairs of hadrons for which the PYTHIA objects of hard non-diffractive
+   * string processes are initialized in a background thread at startup,
+   * instead of when the first such process occurs. Each pair is given as a
+   * string of two PDG codes separated by a space, e.g. `"2212 2212"`. The
+   * hadrons are mapped onto the beams used by PYTHIA (nucleons, antinucleons
+   * and charged pions) like in the hard string processes. Since the
+   * initialization of a PYTHIA object takes seconds, this avoids stalls in
+   * the first events of high-energy runs.
+   */
+  /**
+   * \see_key{key_CT_SP_prewarm_hard_beams_}
+   */
+  inline static const Key<std::vector<std::string>>
+      collTerm_stringParam_prewarmHardBeams{
+          {"Collision_Term", "String_Parameters", "Prewarm_Hard_Beams"},
+          std::vector<std::string>{},
+          {"3.2"}};
+
+  /*!\Userguide
+   * \page doxypage_input_conf_ct_string_parameters
+   * \optional_key{key_CT_SP_prewarm_hard_sqrts_,Prewarm_Hard_Sqrts,double,
+   * 100.0}
+   *
+   * Center-of-mass energy \unit{in GeV} at which the PYTHIA objects given in
+   * \ref key_CT_SP_prewarm_hard_beams_ "Prewarm_Hard_Beams" are initialized.
+   * The collision energy is changed for every process, but PYTHIA should be
+   * initialized at the highest energy expected in the run.
+   */
+  /**
+   * \see_key{key_CT_SP_prewarm_hard_sqrts_}
+   */
+  inline static const Key<double> collTerm_stringParam_prewarmHardSqrts{
+      {"Collision_Term", "String_Parameters", "Prewarm_Hard_Sqrts"},
+      100.0,
+      {"3.2"}};
+
   /*!\Userguide
    * \page doxypage_input_conf_ct_string_parameters
    * \optional_key{key_CT_SP_probability_p_to_duu_,Prob_proton_to_d_uu,double,1./3}
@@ -2753,6 +3530,25 @@ struct InputKeys {
       true,
       {"1.6"}};
 
+  /*!\Userguide
+   * \page doxypage_input_conf_ct_string_parameters
+   * \optional_key{key_CT_SP_share_hard_pythia_,Share_Hard_Pythia,bool,false}
+   *
+   * Whether the hard non-diffractive string processes of all hadrons
+   * colliding with the same nucleon share one PYTHIA object, which switches
+   * the identity of the other beam with the PYTHIA option
+   * `Beams:allowIDAswitch`. This bounds the time and memory spent on PYTHIA
+   * objects, which are otherwise initialized for every pair of beams, but
+   * the generated events differ slightly.
+   */
+  /**
+   * \see_key{key_CT_SP_share_hard_pythia_}
+   */
+  inline static const Key<bool> collTerm_stringParam_shareHardPythia{
+      {"Collision_Term", "String_Parameters", "Share_Hard_Pythia"},
+      false,
+      {"3.2"}};
+
   /*!\Userguide
    * \page doxypage_input_conf_ct_string_parameters
    * \optional_key{key_CT_SP_sigma_perp_,Sigma_Perp,double,0.42}
@@ -2876,6 +3672,27 @@ struct InputKeys {
       2.0,
       {"1.6"}};
 
+  /*!\Userguide
+   * \page doxypage_input_conf_ct_string_parameters
+   * \optional_key{key_CT_SP_tabulate_diffractive_,Tabulate_Diffractive,bool,
+   * false}
+   *
+   * Interpolate the single- and double-diffractive cross sections, which
+   * PYTHIA computes for the hadrons onto which all hadrons are mapped in
+   * string processes, from tables in the center-of-mass energy. The tables
+   * are built at startup with a spacing of about 1% in energy up to
+   * \f$10^5\,\mathrm{GeV}\f$. This avoids setting up the PYTHIA cross
+   * section model for every pair at high energies, but it is an
+   * approximation, hence the exact evaluation is the default.
+   */
+  /**
+   * \see_key{key_CT_SP_tabulate_diffractive_}
+   */
+  inline static const Key<bool> collTerm_stringParam_tabulateDiffractive{
+      {"Collision_Term", "String_Parameters", "Tabulate_Diffractive"},
+      false,
+      {"3.2"}};
+
   /*!\Userguide
    * \page doxypage_input_conf_ct_string_parameters
    * \optional_key{key_CT_SP_use_monash_tune_,Use_Monash_Tune,bool,
@@ -3086,6 +3903,25 @@ struct InputKeys {
   inline static const Key<double> modi_collider_initialDistance{
       {"Modi", "Collider", "Initial_Distance"}, 2.0, {"0.50"}};
 
+  /*!\Userguide
+   * \page doxypage_input_conf_modi_collider
+   * \optional_key{key_MC_pregenerated_events_,Pregenerated_Events,int,0}
+   *
+   * Number of events, whose initial state is generated in advance in a
+   * background thread, while the current event evolves. This hides the time
+   * needed for sampling the nuclei, which matters for short evolutions.
+   *
+   * The initial state of every event is then sampled from a random stream of
+   * the event seed reserved for this purpose. It only depends on the event
+   * seed and not on this number, but differs from the one sampled with the
+   * default of 0, i.e. without generating the initial states in advance.
+   */
+  /**
+   * \see_key{key_MC_pregenerated_events_}
+   */
+  inline static const Key<int> modi_collider_pregeneratedEvents{
+      {"Modi", "Collider", "Pregenerated_Events"}, 0, {"3.2"}};
+
   /*!\Userguide
    * \page doxypage_input_conf_modi_C_proj_targ
    * \optional_key{key_MC_PT_diffusiveness_,Diffusiveness,double,</tt>\f$d(A)\f$<tt>}
@@ -3580,6 +4416,25 @@ struct InputKeys {
   inline static const Key<double> modi_collider_impact_value{
       {"Modi", "Collider", "Impact", "Value"}, 0.0, {"0.50"}};
 
+  /*!\Userguide
+   * \page doxypage_input_conf_modi_C_impact_parameter
+   * \optional_key{key_MC_impact_weighted_,Weighted,bool,false}
+   *
+   * Attach a weight to every event, such that the weighted events follow the
+   * quadratic distribution of minimum bias events, \f$dP(b) = b\,db\f$, within
+   * the sampled range. The weight is the ratio of this distribution to the
+   * one of `Sample`, hence it is 1 for `"quadratic"` sampling. Together with
+   * `"uniform"` or `"custom"` sampling, more events are spent on the
+   * centralities of interest, e.g. on central or ultra-peripheral events,
+   * while weighted results still correspond to minimum bias events. The
+   * weight is written to the ROOT, HepMC, columnar and histogram outputs.
+   */
+  /**
+   * \see_key{key_MC_impact_weighted_}
+   */
+  inline static const Key<bool> modi_collider_impact_weighted{
+      {"Modi", "Collider", "Impact", "Weighted"}, false, {"3.2"}};
+
   /*!\Userguide
    * \page doxypage_input_conf_modi_C_impact_parameter
    * <hr>
@@ -4047,6 +4902,74 @@ struct InputKeys {
   inline static const Key<PdgCode> modi_box_jet_jetPdg{
       {"Modi", "Box", "Jet", "Jet_PDG"}, {"1.7"}};
 
+  /*!\Userguide
+   * \page doxypage_input_conf_modi_box
+   * <hr>
+   * #### Stopping at the equilibrium
+   *
+   * If the `Stop_At_Equilibrium` section is given in the `Box` section, the
+   * box is evolved only until it reached its equilibrium, instead of until
+   * the end time. At the end of every time step, the multiplicity of every
+   * species and the mean and mean square of the momenta of its particles are
+   * sampled. The box counts as equilibrated as soon as each of these
+   * observables, averaged over the later half of the last `Window`, agrees
+   * with its average over the earlier half within the relative `Tolerance`.
+   * Species with fewer particles on average than the inverse of the tolerance
+   * are not taken into account. After the equilibrium is reached, the box is
+   * evolved for the `Measurement_Time` and the intermediate output is only
+   * written during this time. The end time stays the upper limit of the
+   * evolution. Giving any of the keys below enables the stopping, the other
+   * ones take their default values, e.g.
+   *\verbatim
+   Modi:
+       Box:
+           Stop_At_Equilibrium:
+               Window: 20.0
+               Measurement_Time: 50.0
+   \endverbatim
+   */
+
+  /*!\Userguide
+   * \page doxypage_input_conf_modi_box
+   * \optional_key_no_line{key_MB_stop_window_,Window,double,10.0}
+   *
+   * Time over which the observables have to be stationary in fm.
+   */
+  /**
+   * \see_key{key_MB_stop_window_}
+   */
+  inline static const Key<double> modi_box_stopAtEquilibrium_window{
+      {"Modi", "Box", "Stop_At_Equilibrium", "Window"}, 10.0, {"3.2"}};
+
+  /*!\Userguide
+   * \page doxypage_input_conf_modi_box
+   * \optional_key_no_line{key_MB_stop_tolerance_,Tolerance,double,0.02}
+   *
+   * Relative difference of the observables between the two halves of the
+   * window, which is still considered stationary.
+   */
+  /**
+   * \see_key{key_MB_stop_tolerance_}
+   */
+  inline static const Key<double> modi_box_stopAtEquilibrium_tolerance{
+      {"Modi", "Box", "Stop_At_Equilibrium", "Tolerance"}, 0.02, {"3.2"}};
+
+  /*!\Userguide
+   * \page doxypage_input_conf_modi_box
+   * \optional_key_no_line{key_MB_stop_measurement_time_,Measurement_Time,double,0.0}
+   *
+   * Time in fm the box is evolved after it reached the equilibrium. If it is
+   * zero, the evolution stops right away and the intermediate output is
+   * written as without this section.
+   */
+  /**
+   * \see_key{key_MB_stop_measurement_time_}
+   */
+  inline static const Key<double> modi_box_stopAtEquilibrium_measurementTime{
+      {"Modi", "Box", "Stop_At_Equilibrium", "Measurement_Time"},
+      0.0,
+      {"3.2"}};
+
   /*!\Userguide
    * \page doxypage_input_conf_modi_list
    * \required_key{key_ML_file_dir_,File_Directory,string}
@@ -4089,6 +5012,20 @@ struct InputKeys {
   inline static const Key<std::string> modi_list_filePrefix{
       {"Modi", "List", "File_Prefix"}, {"0.60"}};
 
+  /*!\Userguide
+   * \page doxypage_input_conf_modi_list
+   * \optional_key{key_ML_prefetch_,Prefetch,bool,false}
+   *
+   * Whether the next event of the current particle list file is parsed in a
+   * background thread while the current event is simulated. This mostly pays
+   * off for large files with many short events, e.g. in afterburner runs.
+   */
+  /**
+   * \see_key{key_ML_prefetch_}
+   */
+  inline static const Key<bool> modi_list_prefetch{
+      {"Modi", "List", "Prefetch"}, false, {"3.2"}};
+
   /*!\Userguide
    * \page doxypage_input_conf_modi_list
    * \optional_key{key_ML_shift_id_,Shift_Id,int,0}
@@ -4158,39 +5095,140 @@ struct InputKeys {
   inline static const Key<double> modi_listBox_length{
       {"Modi", "ListBox", "Length"}, {"2.1"}};
 
+  /*!\Userguide
+   * \page doxypage_input_conf_modi_listbox
+   * \optional_key{key_MLB_prefetch_,Prefetch,bool,false}
+   *
+   * See &nbsp;
+   * <tt>\ref key_ML_prefetch_ "List: Prefetch"</tt>.
+   */
+  /**
+   * \see_key{key_MLB_prefetch_}
+   */
+  inline static const Key<bool> modi_listBox_prefetch{
+      {"Modi", "ListBox", "Prefetch"}, false, {"3.2"}};
+
   /*!\Userguide
    * \page doxypage_input_conf_modi_listbox
    * \optional_key{key_MLB_shift_id_,Shift_Id,int,0}
    *
-   * See &nbsp;
-   * <tt>\ref key_ML_shift_id_ "List: Shift_Id"</tt>.
+   * See &nbsp;
+   * <tt>\ref key_ML_shift_id_ "List: Shift_Id"</tt>.
+   */
+  /**
+   * \see_key{key_MLB_shift_id_}
+   */
+  inline static const Key<int> modi_listBox_shiftId{
+      {"Modi", "ListBox", "Shift_Id"}, 0, {"2.1"}};
+
+  /*!\Userguide
+   * \page doxypage_input_conf_output
+   *
+   * ## General output configuration parameters
+   *
+   * \optional_key_no_line{key_output_density_type_,Density_Type,string,"none"}
+   *
+   * Determines which kind of density is printed into the headers of the
+   * collision files. Possible valuesare:
+   * - `"hadron"` &rarr; Total hadronic density
+   * - `"baryon"` &rarr; Net baryon density
+   * - `"baryonic isospin"` &rarr; Baryonic isospin density
+   * - `"pion"` &rarr; Pion density
+   * - `"none"` &rarr; Do not calculate density, print 0.0
+   */
+  /**
+   * \see_key{key_output_density_type_}
+   */
+  inline static const Key<std::string> output_densityType{
+      {"Output", "Density_Type"}, "none", {"0.60"}};
+
+  /*!\Userguide
+   * \page doxypage_input_conf_output
+   * \optional_key{key_output_asynchronous_writing_,Asynchronous_Writing,bool,
+   * false}
+   *
+   * Whether every output is written in a thread of its own, such that
+   * formatting and writing the files runs alongside the time evolution. The
+   * data passed to an output is copied and queued, the simulation only waits
+   * if the writing falls behind too much and at the end of every event,
+   * until everything has been written, unless <tt>\ref
+   * key_output_overlap_events_ "Overlap_Events"</tt> is set. The output files
+   * are identical.
+   * - `true` &rarr; Write the outputs in separate threads.
+   * - `false` &rarr; Write the outputs right away.
+   */
+  /**
+   * \see_key{key_output_asynchronous_writing_}
+   */
+  inline static const Key<bool> output_asynchronousWriting{
+      {"Output", "Asynchronous_Writing"}, false, {"3.2"}};
+
+  /*!\Userguide
+   * \page doxypage_input_conf_output
+   * \optional_key{key_output_overlap_events_,Overlap_Events,bool,false}
+   *
+   * Whether the output of an event is written while the next event evolves,
+   * which needs <tt>\ref key_output_asynchronous_writing_
+   * "Asynchronous_Writing"</tt>. The end of an event then only waits until
+   * the previous event has been written, so for short events the writing of
+   * the final particles no longer adds to the run time. The output files are
+   * identical, but are only complete at the end of the run, and an error in
+   * writing an event is only reported at the end of the following one.
+   *
+   * Together with <tt>\ref key_MC_pregenerated_events_
+   * "Pregenerated_Events"</tt> of the collider modus, which samples the
+   * initial states of the following events in advance, the initialization,
+   * the evolution and the output of consecutive events are carried out at the
+   * same time, each with its own random numbers.
+   */
+  /**
+   * \see_key{key_output_overlap_events_}
+   */
+  inline static const Key<bool> output_overlapEvents{
+      {"Output", "Overlap_Events"}, false, {"3.2"}};
+
+  /*!\Userguide
+   * \page doxypage_input_conf_output
+   * \optional_key{key_output_compress_files_,Compress_Files,bool,false}
+   *
+   * Whether the OSCAR and binary output files are compressed in gzip format
+   * while they are written, which reduces their size and the amount of data
+   * written to disk considerably. The compression runs in a thread of its own
+   * for every file and ".gz" is appended to the file names. At the end of
+   * every event a gzip member of the file is finished, such that a file of
+   * an aborted run can be decompressed up to the last complete event. The
+   * files can be read with the usual gzip tools, e.g. `zcat`, or with zlib.
+   * The data arrays inside the files of the `VTK_XML` output and the time
+   * slices of the `Lattice_Chunked` output are compressed as well, keeping
+   * the file names. This option is only available if SMASH
+   * was built with zlib.
+   * - `true` &rarr; Compress the OSCAR and binary output files.
+   * - `false` &rarr; Write the output files uncompressed.
    */
   /**
-   * \see_key{key_MLB_shift_id_}
+   * \see_key{key_output_compress_files_}
    */
-  inline static const Key<int> modi_listBox_shiftId{
-      {"Modi", "ListBox", "Shift_Id"}, 0, {"2.1"}};
+  inline static const Key<bool> output_compressFiles{
+      {"Output", "Compress_Files"}, false, {"3.2"}};
 
   /*!\Userguide
    * \page doxypage_input_conf_output
+   * \optional_key{key_output_binary_event_index_,Binary_Event_Index,bool,
+   * false}
    *
-   * ## General output configuration parameters
-   *
-   * \optional_key_no_line{key_output_density_type_,Density_Type,string,"none"}
-   *
-   * Determines which kind of density is printed into the headers of the
-   * collision files. Possible valuesare:
-   * - `"hadron"` &rarr; Total hadronic density
-   * - `"baryon"` &rarr; Net baryon density
-   * - `"baryonic isospin"` &rarr; Baryonic isospin density
-   * - `"pion"` &rarr; Pion density
-   * - `"none"` &rarr; Do not calculate density, print 0.0
+   * Whether an index of the particle blocks at the start and at the end of
+   * every event is appended to the binary particles and collisions files, such
+   * that the particles of any event can be found without reading the file
+   * from the beginning. See \ref doxypage_output_binary for the format of the
+   * index.
+   * - `true` &rarr; Append the event index to the binary files.
+   * - `false` &rarr; Write the binary files without event index.
    */
   /**
-   * \see_key{key_output_density_type_}
+   * \see_key{key_output_binary_event_index_}
    */
-  inline static const Key<std::string> output_densityType{
-      {"Output", "Density_Type"}, "none", {"0.60"}};
+  inline static const Key<bool> output_binaryEventIndex{
+      {"Output", "Binary_Event_Index"}, false, {"3.2"}};
 
   /*!\Userguide
    * \page doxypage_input_conf_output
@@ -4229,6 +5267,98 @@ struct InputKeys {
   inline static const Key<std::vector<double>> output_outputTimes{
       {"Output", "Output_Times"}, {"1.7"}};
 
+  /*!\Userguide
+   * \page doxypage_input_conf_output
+   * \optional_key{key_output_root_basket_size_,Root_Basket_Size,int,32000}
+   *
+   * Size of the baskets of every branch of the `Root` output trees
+   * \unit{in bytes}, in which ROOT collects the values of a branch before
+   * compressing and writing them. Larger baskets compress better and need
+   * fewer writes, but more memory.
+   */
+  /**
+   * \see_key{key_output_root_basket_size_}
+   */
+  inline static const Key<int> output_rootBasketSize{
+      {"Output", "Root_Basket_Size"}, 32000, {"3.2"}};
+
+  /*!\Userguide
+   * \page doxypage_input_conf_output
+   * \optional_key{key_output_root_auto_flush_,Root_Auto_Flush,int,-30000000}
+   *
+   * When the `Root` output trees flush their baskets to the file. A positive
+   * value gives the number of entries after which the baskets are flushed, a
+   * negative value the number of bytes of uncompressed data, see the
+   * documentation of `TTree::SetAutoFlush`.
+   */
+  /**
+   * \see_key{key_output_root_auto_flush_}
+   */
+  inline static const Key<int> output_rootAutoFlush{
+      {"Output", "Root_Auto_Flush"}, -30000000, {"3.2"}};
+
+  /*!\Userguide
+   * \page doxypage_input_conf_output
+   * \optional_key{key_output_root_compression_,Root_Compression,string,
+   * "ZLIB"}
+   *
+   * Compression algorithm of the `Root` output files, one of `"ZLIB"`,
+   * `"LZMA"`, `"LZ4"` and `"ZSTD"`. `"LZ4"` is much faster than `"ZLIB"` at
+   * the cost of slightly larger files, while `"LZMA"` gives the smallest files
+   * and is the slowest. Which algorithms are available depends on the ROOT
+   * version.
+   */
+  /**
+   * \see_key{key_output_root_compression_}
+   */
+  inline static const Key<std::string> output_rootCompression{
+      {"Output", "Root_Compression"}, "ZLIB", {"3.2"}};
+
+  /*!\Userguide
+   * \page doxypage_input_conf_output
+   * \optional_key{key_output_root_compression_level_,Root_Compression_Level,
+   * int,1}
+   *
+   * Compression level of the `Root` output files from 0 (no compression) to 9
+   * (strongest compression).
+   */
+  /**
+   * \see_key{key_output_root_compression_level_}
+   */
+  inline static const Key<int> output_rootCompressionLevel{
+      {"Output", "Root_Compression_Level"}, 1, {"3.2"}};
+
+  /*!\Userguide
+   * \page doxypage_input_conf_output
+   * \optional_key{key_output_root_implicit_mt_,Root_Implicit_MT,int,0}
+   *
+   * Number of threads ROOT uses to compress the baskets of the `Root` output
+   * trees in parallel, via the implicit multi-threading of ROOT. With `0`, the
+   * baskets are compressed by the thread filling the trees. This option is
+   * only available if ROOT was built with implicit multi-threading.
+   */
+  /**
+   * \see_key{key_output_root_implicit_mt_}
+   */
+  inline static const Key<int> output_rootImplicitMT{
+      {"Output", "Root_Implicit_MT"}, 0, {"3.2"}};
+
+  /*!\Userguide
+   * \page doxypage_input_conf_output
+   * \optional_key{key_output_root_writer_thread_,Root_Writer_Thread,bool,
+   * false}
+   *
+   * Whether the `Root` output trees are filled in a writer thread of their
+   * own, in the same way as with \key Asynchronous_Writing but only for the
+   * `Root` outputs, whose compression is the most expensive part of writing
+   * the output.
+   */
+  /**
+   * \see_key{key_output_root_writer_thread_}
+   */
+  inline static const Key<bool> output_rootWriterThread{
+      {"Output", "Root_Writer_Thread"}, false, {"3.2"}};
+
   /*!\Userguide
    * \page doxypage_input_conf_output
    * <hr>
@@ -4299,6 +5429,11 @@ struct InputKeys {
   inline static const Key<std::vector<std::string>>
       output_thermodynamics_format{
           {"Output", "Thermodynamics", "Format"}, {}, {"1.2"}};
+  /**
+   * \see_key{key_output_content_format_}
+   */
+  inline static const Key<std::vector<std::string>> output_histograms_format{
+      {"Output", "Histograms", "Format"}, {}, {"3.2"}};
 
   /*!\Userguide
    * \page doxypage_input_conf_output
@@ -4315,8 +5450,8 @@ struct InputKeys {
    *
    * \optional_key_no_line{key_output_particles_extended_,Extended,bool,false}
    *
-   * &rArr; Incompatible with `Oscar1999`, `VTK`, `HepMC_asciiv3` and
-   * `HepMC_treeroot` formats.
+   * &rArr; Incompatible with `Oscar1999`, `VTK`, `VTK_XML`, `HepMC_asciiv3`
+   * and `HepMC_treeroot` formats.
    * - `true` &rarr; Print extended information for each particle
    * - `false` &rarr; Regular output for each particle
    */
@@ -4330,7 +5465,8 @@ struct InputKeys {
    * \page doxypage_input_conf_output
    * \optional_key_no_line{key_output_particles_only_final_,Only_Final,string,"Yes"}
    *
-   * &rArr; Incompatible with `VTK`, `HepMC_asciiv3` and `HepMC_treeroot`
+   * &rArr; Incompatible with `VTK`, `VTK_XML`, `HepMC_asciiv3` and
+   * `HepMC_treeroot`
    * - `"Yes"` &rarr; Print only final particle list.
    * - `"IfNotEmpty"` &rarr; Print only final particle list, but only if event
    *   is not empty (i.e. any collisions happened between projectile and
@@ -4343,6 +5479,139 @@ struct InputKeys {
   inline static const Key<OutputOnlyFinal> output_particles_onlyFinal{
       {"Output", "Particles", "Only_Final"}, OutputOnlyFinal::Yes, {"0.50"}};
 
+  /*!\Userguide
+   * \page doxypage_input_conf_output
+   * \optional_key_no_line{key_output_particles_shards_,Shards,int,1}
+   *
+   * &rArr; Only for the `Oscar1999`, `Oscar2013`, `Binary` and `Columnar`
+   * formats, the others are written to a single file.
+   *
+   * Split the particles output into this number of shards, which are written
+   * in parallel, each by a thread of its own. Every ensemble is written as an
+   * event of its own to the shard given by its event number modulo the number
+   * of shards, hence with as many shards as ensembles, every ensemble has a
+   * shard of its own. The shards are written to the directories
+   * `Shards/<format>_<shard>` of the output directory. At the end of the run,
+   * a manifest `<file>.shards` is written for every file of the shards, which
+   * lists the paths of the shards one per line. The reader of the binary
+   * files reads such a manifest like a single file.
+   */
+  /**
+   * \see_key{key_output_particles_shards_}
+   */
+  inline static const Key<int> output_particles_shards{
+      {"Output", "Particles", "Shards"}, 1, {"3.2"}};
+
+  /*!\Userguide
+   * \page doxypage_input_conf_output
+   * \optional_key_no_line{key_output_particles_single_precision_,
+   * Single_Precision,bool,false}
+   *
+   * &rArr; Only for the `Columnar` format.
+   *
+   * Whether the columns of real numbers, e.g. the positions and momenta, are
+   * written as single instead of double precision floats, which halves their
+   * size. See \ref doxypage_output_columnar.
+   */
+  /**
+   * \see_key{key_output_particles_single_precision_}
+   */
+  inline static const Key<bool> output_particles_singlePrecision{
+      {"Output", "Particles", "Single_Precision"}, false, {"3.2"}};
+
+  /*!\Userguide
+   * \page doxypage_input_conf_output
+   * <hr>
+   * #### &diams; Filter
+   * \anchor input_output_filter_
+   *
+   * The optional `Filter` section restricts what is written by all formats of
+   * the particles or collisions output. Everything is written by default.
+   * A particle is written if it passes all of the given selections, an
+   * interaction if its process type is selected and at least one of its
+   * incoming or outgoing particles is.
+   *
+   * \optional_key_no_line{key_output_filter_pdg_,PDG,list of PDG codes,
+   * </tt><b>all</b><tt>}
+   *
+   * Only the particles of these species are written.
+   */
+  /**
+   * \see_key{key_output_filter_pdg_}
+   */
+  inline static const Key<std::vector<PdgCode>> output_particles_filter_pdg{
+      {"Output", "Particles", "Filter", "PDG"}, {"3.2"}};
+
+  /*!\Userguide
+   * \page doxypage_input_conf_output
+   * \optional_key_no_line{key_output_filter_rapidity_,Rapidity,
+   * list of two doubles,</tt><b>all</b><tt>}
+   *
+   * Minimal and maximal momentum space rapidity of the written particles.
+   */
+  /**
+   * \see_key{key_output_filter_rapidity_}
+   */
+  inline static const Key<std::array<double, 2>>
+      output_particles_filter_rapidity{
+          {"Output", "Particles", "Filter", "Rapidity"}, {"3.2"}};
+
+  /*!\Userguide
+   * \page doxypage_input_conf_output
+   * \optional_key_no_line{key_output_filter_pseudorapidity_,Pseudorapidity,
+   * list of two doubles,</tt><b>all</b><tt>}
+   *
+   * Minimal and maximal pseudorapidity of the written particles.
+   */
+  /**
+   * \see_key{key_output_filter_pseudorapidity_}
+   */
+  inline static const Key<std::array<double, 2>>
+      output_particles_filter_pseudorapidity{
+          {"Output", "Particles", "Filter", "Pseudorapidity"}, {"3.2"}};
+
+  /*!\Userguide
+   * \page doxypage_input_conf_output
+   * \optional_key_no_line{key_output_filter_pt_,Transverse_Momentum,
+   * list of two doubles,</tt><b>all</b><tt>}
+   *
+   * Minimal and maximal transverse momentum \unit{in GeV} of the written
+   * particles.
+   */
+  /**
+   * \see_key{key_output_filter_pt_}
+   */
+  inline static const Key<std::array<double, 2>>
+      output_particles_filter_transverseMomentum{
+          {"Output", "Particles", "Filter", "Transverse_Momentum"}, {"3.2"}};
+
+  /*!\Userguide
+   * \page doxypage_input_conf_output
+   * \optional_key_no_line{key_output_filter_ensembles_,Ensembles,
+   * list of ints,</tt><b>all</b><tt>}
+   *
+   * Indices of the written ensembles, counted from 0 within every event.
+   * The interactions of the collisions output are written for all ensembles.
+   */
+  /**
+   * \see_key{key_output_filter_ensembles_}
+   */
+  inline static const Key<std::vector<int>> output_particles_filter_ensembles{
+      {"Output", "Particles", "Filter", "Ensembles"}, {"3.2"}};
+
+  /*!\Userguide
+   * \page doxypage_input_conf_output
+   * \optional_key_no_line{key_output_filter_every_nth_event_,Every_Nth_Event,
+   * int,1}
+   *
+   * Only the events whose number is a multiple of this are written.
+   */
+  /**
+   * \see_key{key_output_filter_every_nth_event_}
+   */
+  inline static const Key<int> output_particles_filter_everyNthEvent{
+      {"Output", "Particles", "Filter", "Every_Nth_Event"}, 1, {"3.2"}};
+
   /*!\Userguide
    * \page doxypage_input_conf_output
    * <hr>
@@ -4377,6 +5646,52 @@ struct InputKeys {
   inline static const Key<bool> output_collisions_printStartEnd{
       {"Output", "Collisions", "Print_Start_End"}, false, {"0.50"}};
 
+  /*!\Userguide
+   * \page doxypage_input_conf_output
+   * The collisions output takes the same \ref input_output_filter_
+   * "Filter" section as the particles output, which applies to the particle
+   * lists and the interactions. Additionally, it can select the process types.
+   *
+   * \optional_key_no_line{key_output_filter_process_types_,Process_Types,
+   * list of ints,</tt><b>all</b><tt>}
+   *
+   * Only the interactions of these process types are written, see
+   * \ref doxypage_output_oscar_particles_process_types.
+   */
+  /**
+   * \see_key{key_output_filter_process_types_}
+   */
+  inline static const Key<std::vector<int>>
+      output_collisions_filter_processTypes{
+          {"Output", "Collisions", "Filter", "Process_Types"}, {"3.2"}};
+
+  /// \see_key{key_output_filter_pdg_}
+  inline static const Key<std::vector<PdgCode>> output_collisions_filter_pdg{
+      {"Output", "Collisions", "Filter", "PDG"}, {"3.2"}};
+
+  /// \see_key{key_output_filter_rapidity_}
+  inline static const Key<std::array<double, 2>>
+      output_collisions_filter_rapidity{
+          {"Output", "Collisions", "Filter", "Rapidity"}, {"3.2"}};
+
+  /// \see_key{key_output_filter_pseudorapidity_}
+  inline static const Key<std::array<double, 2>>
+      output_collisions_filter_pseudorapidity{
+          {"Output", "Collisions", "Filter", "Pseudorapidity"}, {"3.2"}};
+
+  /// \see_key{key_output_filter_pt_}
+  inline static const Key<std::array<double, 2>>
+      output_collisions_filter_transverseMomentum{
+          {"Output", "Collisions", "Filter", "Transverse_Momentum"}, {"3.2"}};
+
+  /// \see_key{key_output_filter_ensembles_}
+  inline static const Key<std::vector<int>> output_collisions_filter_ensembles{
+      {"Output", "Collisions", "Filter", "Ensembles"}, {"3.2"}};
+
+  /// \see_key{key_output_filter_every_nth_event_}
+  inline static const Key<int> output_collisions_filter_everyNthEvent{
+      {"Output", "Collisions", "Filter", "Every_Nth_Event"}, 1, {"3.2"}};
+
   /*!\Userguide
    * \page doxypage_input_conf_output
    * <hr>
@@ -4520,6 +5835,22 @@ struct InputKeys {
   inline static const Key<std::vector<std::string>> output_rivet_analyses{
       {"Output", "Rivet", "Analyses"}, {"2.0.2"}};
 
+  /*!\Userguide
+   * \page doxypage_input_conf_output
+   * \optional_key_no_line{key_output_rivet_analysis_threads_,Analysis_Threads,
+   * int,0}
+   *
+   * Number of threads running copies of the analyses on the events, whose
+   * results are merged at the end. With \key 0, the events are analysed by
+   * the thread running the simulation, which waits for the analyses. See
+   * \ref rivet_output_user_guide_threads_ "here" for more information.
+   */
+  /**
+   * \see_key{key_output_rivet_analysis_threads_}
+   */
+  inline static const Key<int> output_rivet_analysisThreads{
+      {"Output", "Rivet", "Analysis_Threads"}, 0, {"3.2"}};
+
   /*!\Userguide
    * \page doxypage_input_conf_output
    * \optional_key_no_line{key_output_rivet_cross_sections_,Cross_Section,
@@ -4675,15 +6006,134 @@ struct InputKeys {
   inline static const Key<std::vector<std::string>> output_rivet_weights_select{
       {"Output", "Rivet", "Weights", "Select"}, {"2.0.2"}};
 
+  /*!\Userguide
+   * \page doxypage_input_conf_output
+   * <hr> \anchor input_output_histograms_
+   * ### &diams; Histograms
+   * &rArr; Only `YODA` format.
+   *
+   * Histograms of the final particles and of the interactions, see
+   * \ref doxypage_output_histograms.
+   *
+   * \optional_key_no_line{key_output_histograms_quantities_,Quantities,
+   * list of strings,["Rapidity"\, "Transverse_Momentum"]}
+   *
+   * The histogrammed quantities, any of `"Rapidity"`, `"Transverse_Momentum"`,
+   * `"Rapidity_Transverse_Momentum"`, `"Elliptic_Flow"` and
+   * `"Interaction_Rate"`.
+   */
+  /**
+   * \see_key{key_output_histograms_quantities_}
+   */
+  inline static const Key<std::vector<std::string>>
+      output_histograms_quantities{{"Output", "Histograms", "Quantities"},
+                                   {{"Rapidity", "Transverse_Momentum"}},
+                                   {"3.2"}};
+
+  /*!\Userguide
+   * \page doxypage_input_conf_output
+   * \optional_key_no_line{key_output_histograms_pdg_,PDG,list of PDG codes,
+   * </tt><b>all</b><tt>}
+   *
+   * Only the particles of these species are histogrammed.
+   */
+  /**
+   * \see_key{key_output_histograms_pdg_}
+   */
+  inline static const Key<std::vector<PdgCode>> output_histograms_pdg{
+      {"Output", "Histograms", "PDG"}, {"3.2"}};
+
+  /*!\Userguide
+   * \page doxypage_input_conf_output
+   * \optional_key_no_line{key_output_histograms_rapidity_bins_,Rapidity_Bins,
+   * int,40}
+   *
+   * Number of the rapidity bins.
+   */
+  /**
+   * \see_key{key_output_histograms_rapidity_bins_}
+   */
+  inline static const Key<int> output_histograms_rapidityBins{
+      {"Output", "Histograms", "Rapidity_Bins"}, 40, {"3.2"}};
+
+  /*!\Userguide
+   * \page doxypage_input_conf_output
+   * \optional_key_no_line{key_output_histograms_rapidity_range_,Rapidity_Range,
+   * list of two doubles,[-4.0\, 4.0]}
+   *
+   * Range of the rapidity bins. The transverse momentum spectra and the
+   * elliptic flow only include the particles within this range.
+   */
+  /**
+   * \see_key{key_output_histograms_rapidity_range_}
+   */
+  inline static const Key<std::array<double, 2>>
+      output_histograms_rapidityRange{
+          {"Output", "Histograms", "Rapidity_Range"}, {{-4., 4.}}, {"3.2"}};
+
+  /*!\Userguide
+   * \page doxypage_input_conf_output
+   * \optional_key_no_line{key_output_histograms_pt_bins_,
+   * Transverse_Momentum_Bins,int,30}
+   *
+   * Number of the transverse momentum bins.
+   */
+  /**
+   * \see_key{key_output_histograms_pt_bins_}
+   */
+  inline static const Key<int> output_histograms_transverseMomentumBins{
+      {"Output", "Histograms", "Transverse_Momentum_Bins"}, 30, {"3.2"}};
+
+  /*!\Userguide
+   * \page doxypage_input_conf_output
+   * \optional_key_no_line{key_output_histograms_pt_range_,
+   * Transverse_Momentum_Range,list of two doubles,[0.0\, 3.0]}
+   *
+   * Range of the transverse momentum bins \unit{in GeV}.
+   */
+  /**
+   * \see_key{key_output_histograms_pt_range_}
+   */
+  inline static const Key<std::array<double, 2>>
+      output_histograms_transverseMomentumRange{
+          {"Output", "Histograms", "Transverse_Momentum_Range"},
+          {{0., 3.}},
+          {"3.2"}};
+
+  /*!\Userguide
+   * \page doxypage_input_conf_output
+   * \optional_key_no_line{key_output_histograms_time_bins_,Time_Bins,int,100}
+   *
+   * Number of the time bins of the interaction rate.
+   */
+  /**
+   * \see_key{key_output_histograms_time_bins_}
+   */
+  inline static const Key<int> output_histograms_timeBins{
+      {"Output", "Histograms", "Time_Bins"}, 100, {"3.2"}};
+
+  /*!\Userguide
+   * \page doxypage_input_conf_output
+   * \optional_key_no_line{key_output_histograms_time_range_,Time_Range,
+   * list of two doubles,[0.0\, 100.0]}
+   *
+   * Range of the time bins of the interaction rate \unit{in fm}.
+   */
+  /**
+   * \see_key{key_output_histograms_time_range_}
+   */
+  inline static const Key<std::array<double, 2>> output_histograms_timeRange{
+      {"Output", "Histograms", "Time_Range"}, {{0., 100.}}, {"3.2"}};
+
   /*!\Userguide
    * \page doxypage_input_conf_output
    * <hr>
    * ### &diams; Coulomb
-   * &rArr; Only `VTK` format.
+   * &rArr; Only `VTK` and `VTK_XML` formats.
    *
    * No content-specific output options, apart from the <tt>\ref
-   * key_output_content_format_ "Format"</tt> key which accept `["VTK"]` value
-   * only.
+   * key_output_content_format_ "Format"</tt> key which accepts the `"VTK"` and
+   * `"VTK_XML"` values only.
    */
 
   /*!\Userguide
@@ -4692,8 +6142,8 @@ struct InputKeys {
    * ### &diams; Thermodynamics
    *
    * The user can print thermodynamical quantities
-   * -# on the spatial lattice to VTK output;
-   * -# on the spatial lattice to ASCII output;
+   * -# on the spatial lattice to VTK or VTK XML output;
+   * -# on the spatial lattice to ASCII or binary output;
    * -# at a given point to ASCII output;
    * -# averaged over all particles to ASCII output.
    *
@@ -4762,6 +6212,36 @@ struct InputKeys {
       output_thermodynamics_quantites{
           {"Output", "Thermodynamics", "Quantities"}, {}, {"1.0"}};
 
+  /*!\Userguide
+   * \page doxypage_input_conf_output
+   * \optional_key_no_line{key_output_thermo_single_precision_,Single_Precision,
+   * bool,false}
+   *
+   * Whether the `"Lattice_Chunked"` output stores the lattice values as single
+   * instead of double precision floats, which halves the size of the files.
+   * The other formats are not affected, see
+   * \ref doxypage_output_thermodyn_lattice.
+   */
+  /**
+   * \see_key{key_output_thermo_single_precision_}
+   */
+  inline static const Key<bool> output_thermodynamics_singlePrecision{
+      {"Output", "Thermodynamics", "Single_Precision"}, false, {"3.2"}};
+
+  /*!\Userguide
+   * \page doxypage_input_conf_output
+   * \optional_key_no_line{key_output_thermo_variance_,Variance,bool,false}
+   *
+   * Whether the `"Lattice_Averaged"` output writes the variance of the
+   * lattice values over the events besides their average, see
+   * \ref doxypage_output_thermodyn_lattice.
+   */
+  /**
+   * \see_key{key_output_thermo_variance_}
+   */
+  inline static const Key<bool> output_thermodynamics_variance{
+      {"Output", "Thermodynamics", "Variance"}, false, {"3.2"}};
+
   /*!\Userguide
    * \page doxypage_input_conf_output
    * \optional_key_no_line{key_output_thermo_smearing_,Smearing,bool,true}
@@ -4907,6 +6387,83 @@ struct InputKeys {
   inline static const Key<bool> lattice_potentialsAffectThreshold{
       {"Lattice", "Potentials_Affect_Thresholds"}, false, {"1.3"}};
 
+  /*!\Userguide
+   * \page doxypage_input_conf_lattice
+   * \optional_key{key_lattice_interpolate_potentials_,Interpolate_Potentials,
+   * bool,false}
+   *
+   * Whether the potentials and the forces of the mean field and the
+   * electromagnetic fields at the position of a particle are interpolated
+   * trilinearly between the 8 surrounding nodes of their lattices, instead of
+   * being taken from the node of the cell the particle is in. This smooths
+   * the steps of the forces between neighbouring cells, such that coarser
+   * lattices may suffice. It applies to the propagation as well as to the
+   * potentials in the thresholds of the actions, see \ref
+   * key_lattice_pot_affect_threshold_ "Potentials_Affect_Thresholds".
+   */
+  /**
+   * \see_key{key_lattice_interpolate_potentials_}
+   */
+  inline static const Key<bool> lattice_interpolatePotentials{
+      {"Lattice", "Interpolate_Potentials"}, false, {"3.2"}};
+
+  /*!\Userguide
+   * \page doxypage_input_conf_lattice
+   * \optional_key{key_lattice_pot_update_interval_,Potentials_Update_Interval,
+   * int,1}
+   *
+   * Largest number of time steps between two updates of the density lattices
+   * and the potentials on them. By default, they are updated in every time
+   * step. Otherwise, updates are skipped as long as the density changes
+   * slowly, see \ref key_lattice_pot_update_threshold_
+   * "Potentials_Update_Threshold", and the potentials are extrapolated
+   * linearly in time from the last two updates in between. The densities on
+   * the lattices of the potentials are not updated in these time steps. The
+   * number of updates and the largest deviation of the extrapolated
+   * potentials are reported at the end of every event.
+   */
+  /**
+   * \see_key{key_lattice_pot_update_interval_}
+   */
+  inline static const Key<int> lattice_potentialsUpdateInterval{
+      {"Lattice", "Potentials_Update_Interval"}, 1, {"3.2"}};
+
+  /*!\Userguide
+   * \page doxypage_input_conf_lattice
+   * \optional_key{key_lattice_pot_update_threshold_,
+   * Potentials_Update_Threshold,double,0.001}
+   *
+   * Largest change of the density per time step, up to which the updates of
+   * the potentials are skipped, in units of the nuclear ground state density
+   * \f$\rho_0 = 0.168\f$ fm\f$^{-3}\f$. The change is taken on a sample of
+   * the nodes between the last two updates. Only used if \ref
+   * key_lattice_pot_update_interval_ "Potentials_Update_Interval" is larger
+   * than one.
+   */
+  /**
+   * \see_key{key_lattice_pot_update_threshold_}
+   */
+  inline static const Key<double> lattice_potentialsUpdateThreshold{
+      {"Lattice", "Potentials_Update_Threshold"}, 0.001, {"3.2"}};
+
+  /*!\Userguide
+   * \page doxypage_input_conf_lattice
+   * \optional_key{key_lattice_pot_update_single_precision_,
+   * Potentials_Update_Single_Precision,bool,false}
+   *
+   * Whether the potentials of the last two updates, from which they are
+   * extrapolated, are kept in single instead of double precision. This halves
+   * the memory of the copies of the lattices of the potentials, while the
+   * extrapolation itself is still computed in double precision. Only used if
+   * \ref key_lattice_pot_update_interval_ "Potentials_Update_Interval" is
+   * larger than one.
+   */
+  /**
+   * \see_key{key_lattice_pot_update_single_precision_}
+   */
+  inline static const Key<bool> lattice_potentialsUpdateSinglePrecision{
+      {"Lattice", "Potentials_Update_Single_Precision"}, false, {"3.2"}};
+
   /*!\Userguide
    * \page doxypage_input_conf_lattice
    * \optional_key{key_lattice_sizes_,Sizes,list of 3 doubles,
@@ -5051,6 +6608,22 @@ struct InputKeys {
   inline static const Key<std::vector<double>> potentials_coulomb_rCut{
       {"Potentials", "Coulomb", "R_Cut"}, {"2.1"}};
 
+  /*!\Userguide
+   * \page doxypage_input_conf_pot_coulomb
+   * \optional_key{key_potentials_coulomb_use_fft_,Use_FFT,bool,false}
+   *
+   * Whether to calculate the fields on the whole lattice at once by fast
+   * Fourier transforms, instead of integrating over the cube around every
+   * node. Both give the same fields, but the transforms are much faster for
+   * large lattices and integration volumes. Non-periodic lattices are padded
+   * with zeros for the transforms.
+   */
+  /**
+   * \see_key{key_potentials_coulomb_use_fft_}
+   */
+  inline static const Key<bool> potentials_coulomb_useFFT{
+      {"Potentials", "Coulomb", "Use_FFT"}, false, {"3.2"}};
+
   /*!\Userguide
    * \page doxypage_input_conf_pot_momentum_dependence
    * \required_key{key_potentials_momentum_dependence_C,C,double}
@@ -5212,8 +6785,10 @@ struct InputKeys {
       std::reference_wrapper<const Key<std::array<double, 2>>>,
       std::reference_wrapper<const Key<std::array<double, 3>>>,
       std::reference_wrapper<const Key<std::pair<double, double>>>,
+      std::reference_wrapper<const Key<std::vector<int>>>,
       std::reference_wrapper<const Key<std::vector<double>>>,
       std::reference_wrapper<const Key<std::vector<std::string>>>,
+      std::reference_wrapper<const Key<std::vector<PdgCode>>>,
       std::reference_wrapper<const Key<std::set<ThermodynamicQuantity>>>,
       std::reference_wrapper<const Key<std::map<PdgCode, int>>>,
       std::reference_wrapper<const Key<std::map<std::string, std::string>>>,
@@ -5221,6 +6796,8 @@ struct InputKeys {
       std::reference_wrapper<const Key<BoxInitialCondition>>,
       std::reference_wrapper<const Key<CalculationFrame>>,
       std::reference_wrapper<const Key<CollisionCriterion>>,
+      std::reference_wrapper<const Key<CollisionSearch>>,
+      std::reference_wrapper<const Key<ConservationCheck>>,
       std::reference_wrapper<const Key<DensityType>>,
       std::reference_wrapper<const Key<DerivativesMode>>,
       std::reference_wrapper<const Key<ExpansionMode>>,
@@ -5254,15 +6831,38 @@ struct InputKeys {
       std::cref(gen_derivativesMode),
       std::cref(gen_smearingDiscreteWeight),
       std::cref(gen_ensembles),
+      std::cref(gen_distributeEnsembles),
+      std::cref(gen_eventWorkers),
       std::cref(gen_expansionRate),
+      std::cref(gen_fftSmearing),
       std::cref(gen_fieldDerivativesMode),
+      std::cref(gen_freezeOutWindow),
       std::cref(gen_smearingGaussCutoffInSigma),
       std::cref(gen_smearingGaussianSigma),
       std::cref(gen_metricType),
+      std::cref(gen_profile),
+      std::cref(gen_profileCounters),
+      std::cref(gen_traceEvents),
+      std::cref(gen_traceMaxSpans),
+      std::cref(gen_captureCollisions),
+      std::cref(gen_memoryReport),
+      std::cref(gen_memoryLimit),
+      std::cref(gen_maxHoleFraction),
+      std::cref(gen_particleSortInterval),
+      std::cref(gen_pinThreads),
+      std::cref(gen_batchWallCrossings),
+      std::cref(gen_checkpointInterval),
+      std::cref(gen_restartFrom),
+      std::cref(gen_ensembleForkTime),
+      std::cref(gen_conservationCheck),
+      std::cref(gen_conservationCheckInterval),
       std::cref(gen_restFrameDensityDerivativeMode),
       std::cref(gen_smearingMode),
       std::cref(gen_testparticles),
+      std::cref(gen_threads),
       std::cref(gen_timeStepMode),
+      std::cref(gen_minDeltaTime),
+      std::cref(gen_maxDeltaTime),
       std::cref(gen_smearingTriangularRange),
       std::cref(gen_useGrid),
       std::cref(log_default),
@@ -5302,6 +6902,7 @@ struct InputKeys {
       std::cref(version),
       std::cref(collTerm_additionalElasticCrossSection),
       std::cref(collTerm_collisionCriterion),
+      std::cref(collTerm_collisionSearch),
       std::cref(collTerm_crossSectionScaling),
       std::cref(collTerm_elasticCrossSection),
       std::cref(collTerm_elasticNNCutoffSqrts),
@@ -5309,29 +6910,38 @@ struct InputKeys {
       std::cref(collTerm_pseudoresonance),
       std::cref(collTerm_fixedMinCellLength),
       std::cref(collTerm_forceDecaysAtEnd),
+      std::cref(collTerm_freezeSpectators),
+      std::cref(collTerm_freezeEscapingParticles),
       std::cref(collTerm_includeDecaysAtTheEnd),
       std::cref(collTerm_decayInitial),
       std::cref(collTerm_includedTwoToTwo),
       std::cref(collTerm_isotropic),
+      std::cref(collTerm_maxCellOccupancy),
       std::cref(collTerm_maximumCrossSection),
+      std::cref(collTerm_minSubcellLength),
       std::cref(collTerm_multiParticleReactions),
       std::cref(collTerm_nnbarTreatment),
       std::cref(collTerm_noCollisions),
       std::cref(collTerm_onlyWarnForHighProbability),
       std::cref(collTerm_resonanceLifetimeModifier),
+      std::cref(collTerm_samplePairs),
+      std::cref(collTerm_speculationWindow),
       std::cref(collTerm_strings),
       std::cref(collTerm_stringsWithProbability),
+      std::cref(collTerm_tabulatedCrossSections),
       std::cref(collTerm_twoToOne),
       std::cref(collTerm_useAQM),
       std::cref(collTerm_pauliBlocking_gaussianCutoff),
       std::cref(collTerm_pauliBlocking_momentumAveragingRadius),
       std::cref(collTerm_pauliBlocking_spatialAveragingRadius),
+      std::cref(collTerm_pauliBlocking_useLattice),
       std::cref(collTerm_stringTrans_KNOffset),
       std::cref(collTerm_stringTrans_pipiOffset),
       std::cref(collTerm_stringTrans_lower),
       std::cref(collTerm_stringTrans_rangeNN),
       std::cref(collTerm_stringTrans_rangeNpi),
       std::cref(collTerm_stringTrans_range_width),
+      std::cref(collTerm_stringParam_batchFragmentation),
       std::cref(collTerm_stringParam_diquarkSuppression),
       std::cref(collTerm_stringParam_formTimeFactor),
       std::cref(collTerm_stringParam_formationTime),
@@ -5342,8 +6952,11 @@ struct InputKeys {
       std::cref(collTerm_stringParam_quarkBeta),
       std::cref(collTerm_stringParam_popcornRate),
       std::cref(collTerm_stringParam_powerParticleFormation),
+      std::cref(collTerm_stringParam_prewarmHardBeams),
+      std::cref(collTerm_stringParam_prewarmHardSqrts),
       std::cref(collTerm_stringParam_probabilityPToDUU),
       std::cref(collTerm_stringParam_separateFragmentBaryon),
+      std::cref(collTerm_stringParam_shareHardPythia),
       std::cref(collTerm_stringParam_sigmaPerp),
       std::cref(collTerm_stringParam_strangeSuppression),
       std::cref(collTerm_stringParam_stringSigmaT),
@@ -5352,6 +6965,7 @@ struct InputKeys {
       std::cref(collTerm_stringParam_stringZALeading),
       std::cref(collTerm_stringParam_stringZB),
       std::cref(collTerm_stringParam_stringZBLeading),
+      std::cref(collTerm_stringParam_tabulateDiffractive),
       std::cref(collTerm_stringParam_useMonashTune),
       std::cref(collTerm_dileptons_decays),
       std::cref(collTerm_photons_twoToTwoScatterings),
@@ -5365,6 +6979,7 @@ struct InputKeys {
       std::cref(modi_collider_collisionWithinNucleus),
       std::cref(modi_collider_fermiMotion),
       std::cref(modi_collider_initialDistance),
+      std::cref(modi_collider_pregeneratedEvents),
       std::cref(modi_collider_projectile_diffusiveness),
       std::cref(modi_collider_target_diffusiveness),
       std::cref(modi_collider_projectile_particles),
@@ -5406,6 +7021,7 @@ struct InputKeys {
       std::cref(modi_collider_impact_range),
       std::cref(modi_collider_impact_sample),
       std::cref(modi_collider_impact_value),
+      std::cref(modi_collider_impact_weighted),
       std::cref(modi_collider_impact_values),
       std::cref(modi_collider_impact_yields),
       std::cref(modi_sphere_initialMultiplicities),
@@ -5434,18 +7050,33 @@ struct InputKeys {
       std::cref(modi_box_useThermalMultiplicities),
       std::cref(modi_box_jet_jetMomentum),
       std::cref(modi_box_jet_jetPdg),
+      std::cref(modi_box_stopAtEquilibrium_window),
+      std::cref(modi_box_stopAtEquilibrium_tolerance),
+      std::cref(modi_box_stopAtEquilibrium_measurementTime),
       std::cref(modi_list_fileDirectory),
       std::cref(modi_list_filename),
       std::cref(modi_list_filePrefix),
+      std::cref(modi_list_prefetch),
       std::cref(modi_list_shiftId),
       std::cref(modi_listBox_fileDirectory),
       std::cref(modi_listBox_filename),
       std::cref(modi_listBox_filePrefix),
       std::cref(modi_listBox_length),
+      std::cref(modi_listBox_prefetch),
       std::cref(modi_listBox_shiftId),
+      std::cref(output_asynchronousWriting),
+      std::cref(output_binaryEventIndex),
+      std::cref(output_compressFiles),
       std::cref(output_densityType),
       std::cref(output_outputInterval),
       std::cref(output_outputTimes),
+      std::cref(output_overlapEvents),
+      std::cref(output_rootBasketSize),
+      std::cref(output_rootAutoFlush),
+      std::cref(output_rootCompression),
+      std::cref(output_rootCompressionLevel),
+      std::cref(output_rootImplicitMT),
+      std::cref(output_rootWriterThread),
       std::cref(output_particles_format),
       std::cref(output_collisions_format),
       std::cref(output_dileptons_format),
@@ -5454,10 +7085,26 @@ struct InputKeys {
       std::cref(output_rivet_format),
       std::cref(output_coulomb_format),
       std::cref(output_thermodynamics_format),
+      std::cref(output_histograms_format),
       std::cref(output_particles_extended),
       std::cref(output_particles_onlyFinal),
+      std::cref(output_particles_shards),
+      std::cref(output_particles_singlePrecision),
+      std::cref(output_particles_filter_ensembles),
+      std::cref(output_particles_filter_everyNthEvent),
+      std::cref(output_particles_filter_pdg),
+      std::cref(output_particles_filter_pseudorapidity),
+      std::cref(output_particles_filter_rapidity),
+      std::cref(output_particles_filter_transverseMomentum),
       std::cref(output_collisions_extended),
       std::cref(output_collisions_printStartEnd),
+      std::cref(output_collisions_filter_ensembles),
+      std::cref(output_collisions_filter_everyNthEvent),
+      std::cref(output_collisions_filter_pdg),
+      std::cref(output_collisions_filter_processTypes),
+      std::cref(output_collisions_filter_pseudorapidity),
+      std::cref(output_collisions_filter_rapidity),
+      std::cref(output_collisions_filter_transverseMomentum),
       std::cref(output_dileptons_extended),
       std::cref(output_photons_extended),
       std::cref(output_initialConditions_extended),
@@ -5466,6 +7113,7 @@ struct InputKeys {
       std::cref(output_initialConditions_pTCut),
       std::cref(output_initialConditions_rapidityCut),
       std::cref(output_rivet_analyses),
+      std::cref(output_rivet_analysisThreads),
       std::cref(output_rivet_crossSection),
       std::cref(output_rivet_ignoreBeams),
       std::cref(output_rivet_logging),
@@ -5477,16 +7125,30 @@ struct InputKeys {
       std::cref(output_rivet_weights_noMulti),
       std::cref(output_rivet_weights_nominal),
       std::cref(output_rivet_weights_select),
+      std::cref(output_histograms_pdg),
+      std::cref(output_histograms_quantities),
+      std::cref(output_histograms_rapidityBins),
+      std::cref(output_histograms_rapidityRange),
+      std::cref(output_histograms_timeBins),
+      std::cref(output_histograms_timeRange),
+      std::cref(output_histograms_transverseMomentumBins),
+      std::cref(output_histograms_transverseMomentumRange),
       std::cref(output_thermodynamics_onlyParticipants),
       std::cref(output_thermodynamics_position),
       std::cref(output_thermodynamics_quantites),
+      std::cref(output_thermodynamics_singlePrecision),
       std::cref(output_thermodynamics_smearing),
       std::cref(output_thermodynamics_type),
+      std::cref(output_thermodynamics_variance),
       std::cref(lattice_automatic),
       std::cref(lattice_cellNumber),
       std::cref(lattice_origin),
       std::cref(lattice_periodic),
       std::cref(lattice_potentialsAffectThreshold),
+      std::cref(lattice_interpolatePotentials),
+      std::cref(lattice_potentialsUpdateInterval),
+      std::cref(lattice_potentialsUpdateThreshold),
+      std::cref(lattice_potentialsUpdateSinglePrecision),
       std::cref(lattice_sizes),
       std::cref(potentials_use_potentials_outside_lattice),
       std::cref(potentials_skyrme_skyrmeA),
@@ -5498,6 +7160,7 @@ struct InputKeys {
       std::cref(potentials_vdf_powers),
       std::cref(potentials_vdf_satRhoB),
       std::cref(potentials_coulomb_rCut),
+      std::cref(potentials_coulomb_useFFT),
       std::cref(potentials_momentum_dependence_C),
       std::cref(potentials_momentum_dependence_Lambda),
       std::cref(forcedThermalization_cellNumber),
@@ -6172,6 +7835,34 @@ General:
  * with mass = 0.138 GeV, pdg = 111, id = 0 and charge 0 will be initialized for
  * the first event (and also for the second event).
  *
+ * ## Binary input particle files
+ *
+ * Instead of text files, files in the \ref doxypage_output_binary
+ * "binary format" of the particles output can be read, which avoids
+ * formatting and parsing the numbers and loses no precision. They are
+ * recognized by the magic number "SMSH" at the beginning. Hence, the particles
+ * output of a SMASH run can directly be used as input of another one, and the
+ * particles of an event are those of the last 'p' block before its 'f' block,
+ * i.e. the particles at the end of the event. Only the particle lines are
+ * read, the extended quantities are ignored like the additional columns of an
+ * extended Oscar file.
+ *
+ * A minimal file of an external producer, with all numbers in the byte order
+ * of the machine, reads
+ * \code
+ * 4*char  uint16_t  uint16_t  uint32_t  len*char
+ * "SMSH"  9         0         len       producer_version
+ * for every event:
+ * char  uint32_t
+ * 'p'   n_part_lines
+ * n_part_lines times:
+ * 9*double                    3*int32_t
+ * t x y z mass p0 px py pz    pdg ID charge
+ * char  int32_t       double            char
+ * 'f'   event_number  impact_parameter  empty
+ * \endcode
+ * The 'f' block of the last event may be omitted.
+ *
  * \note
  * SMASH is shipped with an example configuration file to set up an afterburner
  * simulation by means of the list modus. This also requires a particle list to
@@ -1,6 +1,6 @@
 /*
  *
- *    Copyright (c) 2015-2020,2022
+ *    Copyright (c) 2015-2020,2022,2024
  *      SMASH Team
  *
  *    GNU General Public License (GPLv3 or later)
@@ -13,12 +13,17 @@
 #include <cuba.h>
 
 #include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstddef>
 #include <iostream>
 #include <memory>
 #include <sstream>
+#include <stdexcept>
 #include <string>
 #include <tuple>
 #include <utility>
+#include <vector>
 
 #include "gsl/gsl_integration.h"
 #include "gsl/gsl_monte_plain.h"
@@ -182,6 +187,122 @@ class Integrator {
   double accuracy_relative_ = 5.0e-4;
 };
 
+/**
+ * Gauss-Legendre quadrature of a fixed order in one dimension.
+ *
+ * It is meant for smooth integrands, which are integrated exactly up to a
+ * polynomial of degree 2 * order - 1. It needs no workspace and estimates no
+ * error, hence one object can be shared by all threads and the integrand is
+ * evaluated exactly order times, at fixed nodes.
+ *
+ * Example:
+ * \code
+ * const GaussLegendre integrate(16);
+ * const double result = integrate(0., M_PI, [](double x) {
+ *   return std::sin(x);
+ * });
+ * \endcode
+ */
+class GaussLegendre {
+ public:
+  /// Maximal number of nodes
+  static constexpr std::size_t max_order = 64;
+
+  /**
+   * Compute the nodes and weights of the quadrature by Newton's method.
+   *
+   * \param[in] order Number of nodes, at most max_order.
+   * \throw std::invalid_argument if the order is not supported.
+   */
+  explicit GaussLegendre(std::size_t order) : nodes_(order), weights_(order) {
+    if (order == 0 || order > max_order) {
+      throw std::invalid_argument(
+          "GaussLegendre: The order has to be between 1 and " +
+          std::to_string(max_order) + ".");
+    }
+    const double n = order;
+    for (std::size_t i = 0; i < (order + 1) / 2; i++) {
+      // Approximation of the i-th largest root of the Legendre polynomial
+      double x = std::cos(M_PI * (i + 0.75) / (n + 0.5));
+      double derivative = 1.;
+      for (int iteration = 0; iteration < 100; iteration++) {
+        double p = x, p_previous = 1.;
+        for (std::size_t k = 2; k <= order; k++) {
+          const double p_next =
+              ((2 * k - 1) * x * p - (k - 1) * p_previous) / k;
+          p_previous = p;
+          p = p_next;
+        }
+        derivative = order == 1 ? 1. : n * (x * p - p_previous) / (x * x - 1.);
+        const double step = p / derivative;
+        x -= step;
+        if (std::abs(step) < 1e-15) {
+          break;
+        }
+      }
+      nodes_[i] = -x;
+      nodes_[order - 1 - i] = x;
+      weights_[i] = weights_[order - 1 - i] =
+          2. / ((1. - x * x) * derivative * derivative);
+    }
+  }
+
+  /**
+   * Integrate a function.
+   *
+   * \param[in] a The lower limit of the integral.
+   * \param[in] b The upper limit of the integral.
+   * \tparam F Type of the integrand function.
+   * \param[in] fun The callable taking and returning a `double`.
+   * \return The integral.
+   */
+  template <typename F>
+  double operator()(double a, double b, F &&fun) const {
+    const double half_length = 0.5 * (b - a), center = 0.5 * (a + b);
+    double sum = 0.;
+    for (std::size_t i = 0; i < nodes_.size(); i++) {
+      sum += weights_[i] * fun(center + half_length * nodes_[i]);
+    }
+    return half_length * sum;
+  }
+
+  /**
+   * Integrate a function, which is evaluated at all nodes at once, such that
+   * it can share work between the nodes or vectorize it.
+   *
+   * \param[in] a The lower limit of the integral.
+   * \param[in] b The upper limit of the integral.
+   * \tparam F Type of the integrand function.
+   * \param[in] fun The callable taking the arguments as `const double *`,
+   *            their number and a `double *` to write the values to.
+   * \return The integral.
+   */
+  template <typename F>
+  double integrate_all_nodes(double a, double b, F &&fun) const {
+    const std::size_t n = nodes_.size();
+    const double half_length = 0.5 * (b - a), center = 0.5 * (a + b);
+    std::array<double, max_order> x, y;
+    for (std::size_t i = 0; i < n; i++) {
+      x[i] = center + half_length * nodes_[i];
+    }
+    fun(static_cast<const double *>(x.data()), n, y.data());
+    double sum = 0.;
+    for (std::size_t i = 0; i < n; i++) {
+      sum += weights_[i] * y[i];
+    }
+    return half_length * sum;
+  }
+
+  /// \return the number of nodes
+  std::size_t order() const { return nodes_.size(); }
+
+ private:
+  /// Nodes in [-1, 1], in ascending order
+  std::vector<double> nodes_;
+  /// Weights of the nodes
+  std::vector<double> weights_;
+};
+
 /**
  * This is a wrapper for the integrand, so we can pass the limits as well for
  * renormalizing to the unit cube.
@@ -1,6 +1,6 @@
 /*
  *
- *    Copyright (c) 2015-2018,2020,2022
+ *    Copyright (c) 2015-2018,2020,2022,2024
  *      SMASH Team
  *
  *    GNU General Public License (GPLv3 or later)
@@ -11,7 +11,9 @@
 #define SRC_INCLUDE_SMASH_INTERPOLATION_H_
 
 #include <algorithm>
+#include <array>
 #include <cassert>
+#include <cmath>
 #include <cstddef>
 #include <numeric>
 #include <sstream>
@@ -71,6 +73,9 @@ class InterpolateDataLinear {
    * Piecewise linear interpolation is used.
    * Values outside the given samples will use the outmost linear
    * interpolation.
+   *
+   * If the x-values are equally spaced, the interval of an argument is
+   * computed instead of searched.
    */
   InterpolateDataLinear(const std::vector<T>& x, const std::vector<T>& y);
   /**
@@ -81,11 +86,46 @@ class InterpolateDataLinear {
    */
   T operator()(T x) const;
 
+  /**
+   * Calculate the linear interpolation at x, starting the search for the
+   * interval at the one of a previous call, which is quick for slowly
+   * changing arguments.
+   *
+   * \param[in] x Interpolation argument.
+   * \param[in,out] hint Interval of the previous argument, which is updated
+   *                to the one of \p x. Start with 0.
+   * \return Interpolated value.
+   */
+  T operator()(T x, std::size_t& hint) const;
+
+  /**
+   * Calculate the linear interpolation at several arguments at once. The
+   * search for the interval of an argument starts at the one of the previous
+   * argument, such that ascending arguments are found quickly.
+   *
+   * \param[in] x Interpolation arguments.
+   * \param[in] n Number of arguments.
+   * \param[out] y Interpolated values, \p n of them.
+   */
+  void evaluate(const T* x, std::size_t n, T* y) const;
+
  private:
+  /**
+   * Find the index of the last x_i strictly smaller than \p x, as by
+   * find_index.
+   *
+   * \param[in] x Interpolation argument.
+   * \param[in] guess Index tried first, along with the next one.
+   * \return Index of the interval.
+   */
+  std::size_t find_interval(T x, std::size_t guess) const;
+
   /// x_i
   std::vector<T> x_;
   /// Piecewise linear interpolation using f(x_i)
   std::vector<InterpolateLinear<T>> f_;
+  /// Inverse of the spacing of the x_i, if they are equally spaced, else 0
+  T inverse_spacing_ = 0;
 };
 
 template <typename T>
@@ -206,6 +246,16 @@ InterpolateDataLinear<T>::InterpolateDataLinear(const std::vector<T>& x,
     f_.emplace_back(
         InterpolateLinear<T>(x_[i], y_sorted[i], x_[i + 1], y_sorted[i + 1]));
   }
+  /* The computed interval is only a guess, which is checked, so the spacing
+   * only has to be equal up to rounding. */
+  const T spacing = (x_.back() - x_.front()) / (n - 1);
+  bool uniform = n > 1;
+  for (size_t i = 0; i + 1 < n && uniform; i++) {
+    uniform = std::abs(x_[i + 1] - x_[i] - spacing) <= 1e-9 * spacing;
+  }
+  if (uniform) {
+    inverse_spacing_ = 1 / spacing;
+  }
 }
 
 /**
@@ -236,16 +286,52 @@ size_t find_index(const std::vector<T>& v, T x) {
   }
 }
 
+template <typename T>
+std::size_t InterpolateDataLinear<T>::find_interval(T x,
+                                                    std::size_t guess) const {
+  if (inverse_spacing_ > 0) {
+    // x_i < x <= x_{i+1} for i = ceil((x - x_0) / spacing) - 1
+    const T position = std::ceil((x - x_.front()) * inverse_spacing_) - 1;
+    const std::size_t last = x_.size() - 1;
+    guess = !(position > 0)       ? 0
+            : position >= T(last) ? last
+                                  : static_cast<std::size_t>(position);
+  }
+  auto found = [&](size_t j) {
+    return (j == 0 || x_[j] < x) && (j + 1 >= x_.size() || !(x_[j + 1] < x));
+  };
+  if (found(guess)) {
+    return guess;
+  }
+  if (guess + 1 < x_.size() && found(guess + 1)) {
+    return guess + 1;
+  }
+  return find_index(x_, x);
+}
+
 template <typename T>
 T InterpolateDataLinear<T>::operator()(T x0) const {
+  std::size_t hint = 0;
+  return (*this)(x0, hint);
+}
+
+template <typename T>
+T InterpolateDataLinear<T>::operator()(T x0, std::size_t& hint) const {
   // Find the piecewise linear interpolation corresponding to x0.
-  size_t i = find_index(x_, x0);
-  if (i >= f_.size()) {
-    // We don't have a linear interpolation beyond the last point in x_.
-    // Use the last linear interpolation instead.
-    i = f_.size() - 1;
+  hint = find_interval(x0, std::min(hint, x_.size() - 1));
+  // We don't have a linear interpolation beyond the last point in x_.
+  // Use the last linear interpolation instead.
+  return f_[std::min(hint, f_.size() - 1)](x0);
+}
+
+template <typename T>
+void InterpolateDataLinear<T>::evaluate(const T* x, std::size_t n,
+                                        T* y) const {
+  // The search starts at the interval of the previous argument
+  std::size_t hint = 0;
+  for (std::size_t k = 0; k < n; k++) {
+    y[k] = (*this)(x[k], hint);
   }
-  return f_[i](x0);
 }
 
 /// Represent a cubic spline interpolation.
@@ -261,13 +347,15 @@ class InterpolateDataSpline {
    * Cubic spline interpolation is used.
    * Values outside the given samples will use the outmost sample
    * as a constant extrapolation.
+   *
+   * The natural cubic spline of GSL is computed once and its polynomials
+   * are stored next to each other, such that an evaluation only reads four
+   * coefficients. If the x-values are equally spaced, the interval of an
+   * argument is computed instead of searched.
    */
   InterpolateDataSpline(const std::vector<double>& x,
                         const std::vector<double>& y);
 
-  /// Destructor
-  ~InterpolateDataSpline();
-
   /**
    * Calculate spline interpolation at x.
    *
@@ -276,19 +364,52 @@ class InterpolateDataSpline {
    */
   double operator()(double x) const;
 
+  /**
+   * Calculate the spline interpolation at x, starting the search for the
+   * interval at the one of a previous call, which is quick for slowly
+   * changing arguments.
+   *
+   * \param[in] x Interpolation argument.
+   * \param[in,out] hint Interval of the previous argument, which is updated
+   *                to the one of \p x. Start with 0.
+   * \return Interpolated value.
+   */
+  double operator()(double x, std::size_t& hint) const;
+
+  /**
+   * Calculate the spline interpolation at several arguments at once, which
+   * is faster for neighbouring arguments.
+   *
+   * \param[in] x Interpolation arguments.
+   * \param[in] n Number of arguments.
+   * \param[out] y Interpolated values, \p n of them.
+   */
+  void evaluate(const double* x, std::size_t n, double* y) const;
+
  private:
-  /// First x value.
-  double first_x_;
-  /// Last x value.
-  double last_x_;
+  /**
+   * Find the index of the last x_i not larger than \p x, limited to the
+   * intervals, as the binary search of GSL.
+   *
+   * \param[in] x Interpolation argument within the samples.
+   * \param[in] guess Index tried first, along with the next one.
+   * \return Index of the interval.
+   */
+  std::size_t find_interval(double x, std::size_t guess) const;
+
+  /// Sorted x values.
+  std::vector<double> x_;
+  /**
+   * Coefficients of the cubic polynomial in x - x_i of every interval i,
+   * starting with the constant one.
+   */
+  std::vector<std::array<double, 4>> coefficients_;
   /// First y value.
   double first_y_;
   /// Last y value.
   double last_y_;
-  /// GSL iterator for interpolation lookups.
-  gsl_interp_accel* acc_;
-  /// GSL spline.
-  gsl_spline* spline_;
+  /// Inverse of the spacing of the x_i, if they are equally spaced, else 0
+  double inverse_spacing_ = 0.;
 };
 
 }  // namespace smash
@@ -1,5 +1,5 @@
 /*
- *    Copyright (c) 2015-2022
+ *    Copyright (c) 2015-2022,2024
  *      SMASH Team
  *
  *    GNU General Public License (GPLv3 or later)
@@ -8,7 +8,6 @@
 #ifndef SRC_INCLUDE_SMASH_ISOPARTICLETYPE_H_
 #define SRC_INCLUDE_SMASH_ISOPARTICLETYPE_H_
 
-#include <filesystem>
 #include <string>
 #include <unordered_map>
 #include <vector>
@@ -19,6 +18,26 @@
 
 namespace smash {
 
+/**
+ * \ingroup data
+ *
+ * Kinds of resonance integrals which can be looked up in a run, see
+ * IsoParticleType::tabulate_integrals. They follow from the configuration,
+ * see reachable_integrals.
+ */
+struct ReachableIntegrals {
+  /// N R integrals, for N N → N R and N d → N d'
+  bool NR = true;
+  /// Δ R integrals, for N N → Δ R
+  bool DeltaR = true;
+  /// π R integrals, for π d → π d'
+  bool piR = true;
+  /// R K integrals, for Δ K → N K
+  bool RK = true;
+  /// ρ ρ and ρ h₁ integrals, for ρ h₁ → N N̄
+  bool rhoR = true;
+};
+
 /**
  * \ingroup data
  *
@@ -204,52 +223,65 @@ class IsoParticleType {
   static void create_multiplet(const ParticleType &type);
 
   /**
-   * Tabulate all relevant integrals.
+   * Tabulate the integrals which can be looked up.
+   *
+   * Only the integrals of the reachable kinds are tabulated, and of those only
+   * the ones of the resonances which are looked up: R K integrals of the Δ
+   * and π R integrals of the nuclei. Any other integral is tabulated when it
+   * is looked up for the first time.
+   *
+   * They are cached by the currently existing TabulationCache, if any.
    *
-   * \param hash The hash of the particle properties.
-   *             This is used to determine whether a cached tabulation can be
-   *             reused or not.
-   * \param tabulations_path The path to the directory where the tabulations are
-   * cached.
+   * \param[in] reachable Kinds of integrals to be tabulated
+   * \param[in] pool Threads to tabulate the integrals concurrently (optional).
+   *                 The integrals contain the spectral functions of the
+   *                 resonances, which then have to be ready, see
+   *                 ParticleType::initialize_lazy_members.
+   * \return Number of tabulated integrals
    */
-  static void tabulate_integrals(sha256::Hash hash,
-                                 const std::filesystem::path &tabulations_path);
+  static std::size_t tabulate_integrals(
+      const ReachableIntegrals &reachable = {}, ThreadPool *pool = nullptr);
 
   /**
    * Look up the tabulated resonance integral for the XX -> NR cross section.
    *
    * \param sqrts The center-of-mass energy.
+   * \throw std::out_of_range if there is no such integral
    */
-  double get_integral_NR(double sqrts);
+  double get_integral_NR(double sqrts) const;
 
   /**
    * Look up the tabulated resonance integral for the XX -> RR cross section.
    *
    * \param type_res_2 Type of the two resonances in the final state.
    * \param sqrts The center-of-mass energy.
+   * \throw std::out_of_range if there is no such integral
    */
-  double get_integral_RR(IsoParticleType *type_res_2, double sqrts);
+  double get_integral_RR(IsoParticleType *type_res_2, double sqrts) const;
 
   /**
    * Look up the tabulated resonance integral for the XX -> RK cross section.
    *
    * \param sqrts The center-of-mass energy.
+   * \throw std::out_of_range if there is no such integral
    */
-  double get_integral_RK(double sqrts);
+  double get_integral_RK(double sqrts) const;
 
   /**
    * Look up the tabulated resonance integral for the XX -> piR cross section.
    *
    * \param sqrts The center-of-mass energy.
+   * \throw std::out_of_range if there is no such integral
    */
-  double get_integral_piR(double sqrts);
+  double get_integral_piR(double sqrts) const;
 
   /**
    * Look up the tabulated resonance integral for the XX -> rhoR cross section.
    *
    * \param sqrts The center-of-mass energy.
+   * \throw std::out_of_range if there is no such integral
    */
-  double get_integral_rhoR(double sqrts);
+  double get_integral_rhoR(double sqrts) const;
 
  private:
   /// name of the multiplet
@@ -266,23 +298,23 @@ class IsoParticleType {
   ParticleTypePtrList states_;
 
   /// A tabulation of the spectral integral for the dpi -> d'pi cross sections.
-  Tabulation *XS_piR_tabulation_ = nullptr;
+  AdaptiveTabulation *XS_piR_tabulation_ = nullptr;
   /// A tabulation of the spectral integral for the NK -> RK cross sections.
-  Tabulation *XS_RK_tabulation_ = nullptr;
+  AdaptiveTabulation *XS_RK_tabulation_ = nullptr;
   /**
    * A tabulation for the NN -> NR cross sections,
    * where R is a resonance from this multiplet.
    */
-  Tabulation *XS_NR_tabulation_ = nullptr;
+  AdaptiveTabulation *XS_NR_tabulation_ = nullptr;
   /**
    * A tabulation for the NN -> RΔ cross sections,
    * where R is a resonance from this multiplet.
    */
-  Tabulation *XS_DeltaR_tabulation_ = nullptr;
+  AdaptiveTabulation *XS_DeltaR_tabulation_ = nullptr;
   /**
    * A tabulation for the ρρ integrals.
    */
-  Tabulation *XS_rhoR_tabulation_ = nullptr;
+  AdaptiveTabulation *XS_rhoR_tabulation_ = nullptr;
 
   /**
    * Private version of the 'find' method that returns a non-const reference.
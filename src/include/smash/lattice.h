@@ -1,6 +1,6 @@
 /*
  *
- *    Copyright (c) 2015-2021
+ *    Copyright (c) 2015-2021,2024
  *      SMASH Team
  *
  *    GNU General Public License (GPLv3 or later)
@@ -10,16 +10,22 @@
 #ifndef SRC_INCLUDE_SMASH_LATTICE_H_
 #define SRC_INCLUDE_SMASH_LATTICE_H_
 
+#include <algorithm>
 #include <array>
 #include <cstring>
 #include <functional>
+#include <type_traits>
 #include <utility>
 #include <vector>
 
+#include "checkpoint.h"
+#include "ensemblecommunicator.h"
 #include "forwarddeclarations.h"
 #include "fourvector.h"
 #include "logging.h"
 #include "numerics.h"
+#include "precision.h"
+#include "threadpool.h"
 
 namespace smash {
 static constexpr int LLattice = LogArea::Lattice::id;
@@ -39,13 +45,42 @@ enum class LatticeUpdate {
   EveryFixedInterval = 2,
 };
 
+/**
+ * Nodes and their weights, from which the value at a position is taken on
+ * all lattices of the same geometry, see RectangularLattice::gather_stencil.
+ */
+struct GatherStencil {
+  /// 1-dimensional indices of the nodes
+  std::array<int, 8> index;
+  /// Weights of the nodes, which add up to one
+  std::array<double, 8> weight;
+  /**
+   * Number of nodes: 1 for the cell of the position, 8 for an interpolation
+   * and 0 if the position is outside of the lattice
+   */
+  int size = 0;
+};
+
 /**
  * A container class to hold all the arrays on the lattice and access them.
+ *
+ * The nodes are stored with a precision policy, see DoublePrecision and
+ * SinglePrecision. With the default one, the nodes hold the values
+ * themselves and are accessed by reference. With another policy, the values
+ * are read and written with get() and set(), and values taken at positions
+ * are computed in double precision from the stored ones. Only lattices of
+ * the default policy can be summed over processes, differentiated or
+ * smeared onto through references to their nodes.
+ *
  * \tparam T The type of the contained values.
+ * \tparam Precision Precision policy, in which the values are stored
  */
-template <typename T>
+template <typename T, typename Precision = DoublePrecision<T>>
 class RectangularLattice {
  public:
+  /// Type in which the values are stored on the nodes
+  using stored_type = typename Precision::type;
+
   /**
    * Rectangular lattice constructor.
    *
@@ -73,7 +108,10 @@ class RectangularLattice {
         cell_volume_{cell_sizes_[0] * cell_sizes_[1] * cell_sizes_[2]},
         origin_(orig),
         periodic_(per),
-        when_update_(upd) {
+        when_update_(upd),
+        n_tiles_{(n[0] + tile_size - 1) / tile_size,
+                 (n[1] + tile_size - 1) / tile_size,
+                 (n[2] + tile_size - 1) / tile_size} {
     lattice_.resize(n_cells_[0] * n_cells_[1] * n_cells_[2]);
     logg[LLattice].debug(
         "Rectangular lattice created: sizes[fm] = (", lattice_sizes_[0], ",",
@@ -90,7 +128,7 @@ class RectangularLattice {
   }
 
   /// Copy-constructor
-  RectangularLattice(RectangularLattice<T> const& rl)
+  RectangularLattice(RectangularLattice const& rl)
       : lattice_(rl.lattice_),
         lattice_sizes_(rl.lattice_sizes_),
         n_cells_(rl.n_cells_),
@@ -98,10 +136,196 @@ class RectangularLattice {
         cell_volume_(rl.cell_volume_),
         origin_(rl.origin_),
         periodic_(rl.periodic_),
-        when_update_(rl.when_update_) {}
+        when_update_(rl.when_update_),
+        n_tiles_(rl.n_tiles_),
+        sparse_(rl.sparse_),
+        interpolated_(rl.interpolated_),
+        occupied_tiles_(rl.occupied_tiles_) {}
+
+  /**
+   * Sets all values on lattice to zeros. A sparse lattice only clears the
+   * occupied tiles, which are empty afterwards.
+   */
+  void reset() {
+    const stored_type empty = Precision::pack(T());
+    if (!sparse_) {
+      std::fill(lattice_.begin(), lattice_.end(), empty);
+      return;
+    }
+    iterate_tiles(occupied_tiles_, [this, &empty](int first, int length) {
+      std::fill_n(lattice_.begin() + first, length, empty);
+    });
+    std::fill(occupied_tiles_.begin(), occupied_tiles_.end(), 0);
+  }
+
+  /**
+   * Make the lattice sparse or dense.
+   *
+   * A sparse lattice keeps track of the tiles of tile_size^3 cells, in which
+   * values were added since the last reset, such that resetting it and
+   * computing its gradient only costs time for the occupied part of the
+   * lattice. Whoever writes to the nodes of a sparse lattice has to mark them
+   * as occupied before the next reset, all other nodes have to stay at their
+   * default value. Initially, all tiles are considered occupied.
+   *
+   * \param[in] sparse Whether the lattice is sparse.
+   */
+  void set_sparse(bool sparse) {
+    sparse_ = sparse;
+    occupied_tiles_.assign(
+        sparse ? n_tiles_[0] * n_tiles_[1] * n_tiles_[2] : 0, 1);
+  }
+
+  /// \return Whether the lattice is sparse, see set_sparse.
+  bool sparse() const { return sparse_; }
+
+  /**
+   * Choose how values at positions are gathered from the lattice, see
+   * gather_stencil.
+   *
+   * \param[in] interpolated Whether the values are interpolated trilinearly
+   *            between the nodes instead of being taken from the node of the
+   *            cell of the position.
+   */
+  void set_interpolated(bool interpolated) { interpolated_ = interpolated; }
+
+  /// \return Whether values at positions are interpolated, see
+  ///         set_interpolated.
+  bool interpolated() const { return interpolated_; }
+
+  /**
+   * Mark the cells in a box as occupied on a sparse lattice, nothing happens
+   * on a dense one. The indices are wrapped for periodic lattices and
+   * restricted to the lattice otherwise, as in iterate_indices_in_rectangle.
+   *
+   * \param[in] lower_bounds Lowest indices of the cells in x, y and z
+   *            direction.
+   * \param[in] upper_bounds Indices after the highest ones.
+   */
+  void mark_occupied(const std::array<int, 3>& lower_bounds,
+                     const std::array<int, 3>& upper_bounds) {
+    if (!sparse_) {
+      return;
+    }
+    // every direction is covered by at most two ranges of tiles
+    std::array<std::array<int, 4>, 3> tiles;
+    for (int i = 0; i < 3; i++) {
+      int lower = lower_bounds[i], upper = upper_bounds[i];
+      if (periodic_ && upper - lower >= n_cells_[i]) {
+        lower = 0;
+        upper = n_cells_[i];
+      } else if (periodic_) {
+        lower = positive_modulo(lower, n_cells_[i]);
+        upper = lower + upper_bounds[i] - lower_bounds[i];
+      } else {
+        lower = std::max(lower, 0);
+        upper = std::min(upper, n_cells_[i]);
+      }
+      if (upper <= lower) {
+        return;
+      }
+      tiles[i] = {lower / tile_size,
+                  (std::min(upper, n_cells_[i]) - 1) / tile_size + 1, 0,
+                  upper > n_cells_[i]
+                      ? (upper - n_cells_[i] - 1) / tile_size + 1
+                      : 0};
+    }
+    for (int rz = 0; rz < 4; rz += 2) {
+      for (int tz = tiles[2][rz]; tz < tiles[2][rz + 1]; tz++) {
+        for (int ry = 0; ry < 4; ry += 2) {
+          for (int ty = tiles[1][ry]; ty < tiles[1][ry + 1]; ty++) {
+            for (int rx = 0; rx < 4; rx += 2) {
+              for (int tx = tiles[0][rx]; tx < tiles[0][rx + 1]; tx++) {
+                occupied_tiles_[tile_index(tx, ty, tz)] = 1;
+              }
+            }
+          }
+        }
+      }
+    }
+  }
 
-  /// Sets all values on lattice to zeros.
-  void reset() { std::fill(lattice_.begin(), lattice_.end(), T()); }
+  /**
+   * Mark the same tiles as occupied as on another sparse lattice of the same
+   * geometry, in addition to the ones already occupied. Nothing happens on a
+   * dense lattice, while a dense \p other occupies everything.
+   *
+   * \param[in] other Lattice whose occupied tiles are taken over
+   * \tparam U Type of the values of the other lattice
+   * \tparam P Precision policy of the other lattice
+   */
+  template <typename U, typename P>
+  void mark_occupied_like(const RectangularLattice<U, P>& other) {
+    if (!sparse_) {
+      return;
+    }
+    if (!other.sparse()) {
+      std::fill(occupied_tiles_.begin(), occupied_tiles_.end(), 1);
+      return;
+    }
+    for (std::size_t i = 0; i < occupied_tiles_.size(); i++) {
+      occupied_tiles_[i] = occupied_tiles_[i] || other.occupied_tiles_[i];
+    }
+  }
+
+  /**
+   * Iterates over the indices of the nodes in the occupied tiles of a sparse
+   * lattice, or over all nodes of a dense one. All other nodes hold the
+   * default value.
+   *
+   * \tparam F Type of the function. The argument is the index of the node.
+   * \param[in] func Function acting on the indices.
+   */
+  template <typename F>
+  void iterate_occupied_indices(F&& func) const {
+    if (!sparse_) {
+      for (std::size_t i = 0; i < lattice_.size(); i++) {
+        func(static_cast<int>(i));
+      }
+      return;
+    }
+    iterate_tiles(occupied_tiles_, [&](int first, int length) {
+      for (int i = first; i < first + length; i++) {
+        func(i);
+      }
+    });
+  }
+
+  /**
+   * Sum the values on the nodes over the processes of a communicator, which
+   * all hold a lattice of the same geometry. A sparse lattice only exchanges
+   * the tiles, which are occupied in any of the processes, and has these
+   * tiles occupied afterwards. The default value of T has to be zero.
+   *
+   * \param[in] communicator The processes the lattice is summed over
+   */
+  void sum_over(EnsembleCommunicator& communicator) {
+    static_assert(std::is_same_v<Precision, DoublePrecision<T>> &&
+                      std::is_trivially_copyable_v<T> &&
+                      sizeof(T) % sizeof(double) == 0,
+                  "Only lattices of doubles can be summed.");
+    constexpr std::size_t doubles_per_node = sizeof(T) / sizeof(double);
+    if (!sparse_) {
+      communicator.sum(reinterpret_cast<double*>(lattice_.data()),
+                       lattice_.size() * doubles_per_node);
+      return;
+    }
+    communicator.combine_or(occupied_tiles_.data(), occupied_tiles_.size());
+    // the rows of the occupied tiles are packed into one buffer
+    std::vector<double> buffer;
+    iterate_tiles(occupied_tiles_, [&](int first, int length) {
+      const std::size_t offset = buffer.size();
+      buffer.resize(offset + length * doubles_per_node);
+      std::memcpy(&buffer[offset], &lattice_[first], length * sizeof(T));
+    });
+    communicator.sum(buffer.data(), buffer.size());
+    std::size_t offset = 0;
+    iterate_tiles(occupied_tiles_, [&](int first, int length) {
+      std::memcpy(static_cast<void*>(&lattice_[first]), &buffer[offset],
+                  length * sizeof(T));
+      offset += length * doubles_per_node;
+    });
+  }
 
   /**
    * Checks if 3D index is out of lattice bounds.
@@ -169,9 +393,9 @@ class RectangularLattice {
   LatticeUpdate when_update() const { return when_update_; }
 
   /// Iterator of lattice.
-  using iterator = typename std::vector<T>::iterator;
+  using iterator = typename std::vector<stored_type>::iterator;
   /// Const interator of lattice.
-  using const_iterator = typename std::vector<T>::const_iterator;
+  using const_iterator = typename std::vector<stored_type>::const_iterator;
   /// \return First element of lattice.
   iterator begin() { return lattice_.begin(); }
   /// \return First element of lattice (const).
@@ -181,17 +405,62 @@ class RectangularLattice {
   /// \return Last element of lattice (const).
   const_iterator end() const { return lattice_.end(); }
   /// \return ith element of lattice.
-  T& operator[](std::size_t i) { return lattice_[i]; }
+  stored_type& operator[](std::size_t i) { return lattice_[i]; }
   /// \return ith element of lattice (const).
-  const T& operator[](std::size_t i) const { return lattice_[i]; }
+  const stored_type& operator[](std::size_t i) const { return lattice_[i]; }
+  /// \return Value of the ith element of lattice, in any precision.
+  T get(std::size_t i) const { return Precision::unpack(lattice_[i]); }
+  /**
+   * Overwrite the ith element of lattice, in any precision.
+   *
+   * \param[in] i Index of the node
+   * \param[in] value New value of the node
+   */
+  void set(std::size_t i, const T& value) {
+    lattice_[i] = Precision::pack(value);
+  }
   /// \return Size of lattice.
   std::size_t size() const { return lattice_.size(); }
+  /// \return Memory allocated for the nodes of the lattice [bytes].
+  std::size_t memory_usage() const {
+    return lattice_.capacity() * sizeof(stored_type) +
+           occupied_tiles_.capacity();
+  }
+
+  /**
+   * Write the values on the nodes to a checkpoint.
+   *
+   * \param[out] out Stream of the checkpoint
+   */
+  void write_checkpoint(std::ostream& out) const {
+    checkpoint::write(out, lattice_);
+    checkpoint::write(out, sparse_);
+    checkpoint::write(out, occupied_tiles_);
+  }
+
+  /**
+   * Replace the values on the nodes with the ones of a checkpoint.
+   *
+   * \param[in] in Stream of the checkpoint
+   * \throw std::runtime_error if the checkpoint was written for a lattice of
+   *        another size or ends unexpectedly
+   */
+  void read_checkpoint(std::istream& in) {
+    const std::size_t n_nodes = lattice_.size();
+    checkpoint::read(in, lattice_);
+    if (lattice_.size() != n_nodes) {
+      throw std::runtime_error(
+          "The lattice of the checkpoint has a different size.");
+    }
+    checkpoint::read(in, sparse_);
+    checkpoint::read(in, occupied_tiles_);
+  }
 
   /**
    * Overwrite with a template value T at a given node
    */
   void assign_value(int lattice_index, T value) {
-    lattice_[lattice_index] = value;
+    lattice_[lattice_index] = Precision::pack(value);
   }
 
   /**
@@ -316,94 +585,56 @@ class RectangularLattice {
    *
    * return a lattice of ThreeVectors which are gradients of the values on the
    * original lattice
+   *
+   * \param[out] grad_lat Lattice of the gradients
+   * \param[in] pool Threads computing slabs of the lattice concurrently, if
+   *            given
    */
-  void compute_gradient_lattice(
-      RectangularLattice<ThreeVector>& grad_lat) const {
-    if (n_cells_[0] < 2 || n_cells_[1] < 2 || n_cells_[2] < 2) {
-      // Gradient calculation is impossible
-      throw std::runtime_error(
-          "Lattice is too small for gradient calculation"
-          " (should be at least 2x2x2)");
-    }
-    if (!identical_to_lattice(&grad_lat)) {
-      // Lattice for gradient should have identical origin/dims/periodicity
-      throw std::invalid_argument(
-          "Lattice for gradient should have the"
-          " same origin/dims/periodicity as the original one.");
-    }
-    const double inv_2dx = 0.5 / cell_sizes_[0];
-    const double inv_2dy = 0.5 / cell_sizes_[1];
-    const double inv_2dz = 0.5 / cell_sizes_[2];
-    const int dix = 1;
-    const int diy = n_cells_[0];
-    const int diz = n_cells_[0] * n_cells_[1];
-    const int d = diz * n_cells_[2];
-
-    for (int iz = 0; iz < n_cells_[2]; iz++) {
-      const int z_offset = diz * iz;
-      for (int iy = 0; iy < n_cells_[1]; iy++) {
-        const int y_offset = diy * iy + z_offset;
-        for (int ix = 0; ix < n_cells_[0]; ix++) {
-          const int index = ix + y_offset;
-          if (unlikely(ix == 0)) {
-            (grad_lat)[index].set_x1(
-                periodic_
-                    ? (lattice_[index + dix] - lattice_[index + diy - dix]) *
-                          inv_2dx
-                    : (lattice_[index + dix] - lattice_[index]) * 2.0 *
-                          inv_2dx);
-          } else if (unlikely(ix == n_cells_[0] - 1)) {
-            (grad_lat)[index].set_x1(
-                periodic_
-                    ? (lattice_[index - diy + dix] - lattice_[index - dix]) *
-                          inv_2dx
-                    : (lattice_[index] - lattice_[index - dix]) * 2.0 *
-                          inv_2dx);
-          } else {
-            (grad_lat)[index].set_x1(
-                (lattice_[index + dix] - lattice_[index - dix]) * inv_2dx);
-          }
-
-          if (unlikely(iy == 0)) {
-            (grad_lat)[index].set_x2(
-                periodic_
-                    ? (lattice_[index + diy] - lattice_[index + diz - diy]) *
-                          inv_2dy
-                    : (lattice_[index + diy] - lattice_[index]) * 2.0 *
-                          inv_2dy);
-          } else if (unlikely(iy == n_cells_[1] - 1)) {
-            (grad_lat)[index].set_x2(
-                periodic_
-                    ? (lattice_[index - diz + diy] - lattice_[index - diy]) *
-                          inv_2dy
-                    : (lattice_[index] - lattice_[index - diy]) * 2.0 *
-                          inv_2dy);
-          } else {
-            (grad_lat)[index].set_x2(
-                (lattice_[index + diy] - lattice_[index - diy]) * inv_2dy);
-          }
+  void compute_gradient_lattice(RectangularLattice<ThreeVector>& grad_lat,
+                                ThreadPool* pool = nullptr) const {
+    check_gradient_lattice(grad_lat);
+    auto gradient_at = [&](int index, const DifferenceStencil& sx,
+                           const DifferenceStencil& sy,
+                           const DifferenceStencil& sz) {
+      grad_lat[index] = ThreeVector(sx.apply(lattice_, index),
+                                    sy.apply(lattice_, index),
+                                    sz.apply(lattice_, index));
+    };
 
-          if (unlikely(iz == 0)) {
-            (grad_lat)[index].set_x3(
-                periodic_
-                    ? (lattice_[index + diz] - lattice_[index + d - diz]) *
-                          inv_2dz
-                    : (lattice_[index + diz] - lattice_[index]) * 2.0 *
-                          inv_2dz);
-          } else if (unlikely(iz == n_cells_[2] - 1)) {
-            (grad_lat)[index].set_x3(
-                periodic_
-                    ? (lattice_[index - d + diz] - lattice_[index - diz]) *
-                          inv_2dz
-                    : (lattice_[index] - lattice_[index - diz]) * 2.0 *
-                          inv_2dz);
-          } else {
-            (grad_lat)[index].set_x3(
-                (lattice_[index + diz] - lattice_[index - diz]) * inv_2dz);
+    if (!sparse_) {
+      iterate_difference_stencils_blocked(pool, sizeof(T) + sizeof(ThreeVector),
+                                          gradient_at);
+      return;
+    }
+    /* The gradient vanishes away from the occupied tiles and their
+     * neighbours, since the finite differences reach one cell only */
+    grad_lat.reset();
+    const std::vector<char> tiles = dilated_tiles();
+    std::vector<std::pair<std::array<int, 3>, std::array<int, 3>>> boxes;
+    for (int tz = 0; tz < n_tiles_[2]; tz++) {
+      for (int ty = 0; ty < n_tiles_[1]; ty++) {
+        for (int tx = 0; tx < n_tiles_[0]; tx++) {
+          if (!tiles[tile_index(tx, ty, tz)]) {
+            continue;
           }
+          const std::array<int, 3> lower = {
+              tx * tile_size, ty * tile_size, tz * tile_size};
+          const std::array<int, 3> upper = {
+              std::min(lower[0] + tile_size, n_cells_[0]),
+              std::min(lower[1] + tile_size, n_cells_[1]),
+              std::min(lower[2] + tile_size, n_cells_[2])};
+          grad_lat.mark_occupied(lower, upper);
+          boxes.emplace_back(lower, upper);
         }
       }
     }
+    const int n_boxes = boxes.size();
+    for_each_chunk(pool, n_boxes, [&](int begin, int end) {
+      for (int b = begin; b < end; b++) {
+        iterate_difference_stencils(boxes[b].first, boxes[b].second,
+                                    gradient_at);
+      }
+    });
   }
 
   /**
@@ -414,103 +645,26 @@ class RectangularLattice {
    * \param[in] time_step the used time step, needed for the time derivative
    * \param[out] grad_lat a lattice of 4-arrays of 4-vectors with the following
    * structure: [djmu_dt, djmu_dx, djmu_dy, djmu_dz]
+   * \param[in] pool Threads computing slabs of the lattice concurrently, if
+   *            given
    */
   void compute_four_gradient_lattice(
       RectangularLattice<FourVector>& old_lat, double time_step,
-      RectangularLattice<std::array<FourVector, 4>>& grad_lat) const {
-    if (n_cells_[0] < 2 || n_cells_[1] < 2 || n_cells_[2] < 2) {
-      // Gradient calculation is impossible
-      throw std::runtime_error(
-          "Lattice is too small for gradient calculation"
-          " (should be at least 2x2x2)");
-    }
-    if (!identical_to_lattice(&grad_lat)) {
-      // Lattice for gradient should have identical origin/dims/periodicity
-      throw std::invalid_argument(
-          "Lattice for gradient should have the"
-          " same origin/dims/periodicity as the original one.");
-    }
-    const double inv_2dx = 0.5 / cell_sizes_[0];
-    const double inv_2dy = 0.5 / cell_sizes_[1];
-    const double inv_2dz = 0.5 / cell_sizes_[2];
-    const int dix = 1;
-    const int diy = n_cells_[0];
-    const int diz = n_cells_[0] * n_cells_[1];
-    const int d = diz * n_cells_[2];
-
-    for (int iz = 0; iz < n_cells_[2]; iz++) {
-      const int z_offset = diz * iz;
-      for (int iy = 0; iy < n_cells_[1]; iy++) {
-        const int y_offset = diy * iy + z_offset;
-        for (int ix = 0; ix < n_cells_[0]; ix++) {
-          const int index = ix + y_offset;
-
-          // auxiliary vectors used for the calculation of gradients
-          FourVector grad_t_jmu(0.0, 0.0, 0.0, 0.0);
-          FourVector grad_x_jmu(0.0, 0.0, 0.0, 0.0);
-          FourVector grad_y_jmu(0.0, 0.0, 0.0, 0.0);
-          FourVector grad_z_jmu(0.0, 0.0, 0.0, 0.0);
-          // t direction
-          grad_t_jmu = (lattice_[index] - (old_lat)[index]) * (1.0 / time_step);
-          // x direction
-          if (unlikely(ix == 0)) {
-            grad_x_jmu =
-                periodic_
-                    ? (lattice_[index + dix] - lattice_[index + diy - dix]) *
-                          inv_2dx
-                    : (lattice_[index + dix] - lattice_[index]) * 2.0 * inv_2dx;
-          } else if (unlikely(ix == n_cells_[0] - 1)) {
-            grad_x_jmu =
-                periodic_
-                    ? (lattice_[index - diy + dix] - lattice_[index - dix]) *
-                          inv_2dx
-                    : (lattice_[index] - lattice_[index - dix]) * 2.0 * inv_2dx;
-          } else {
-            grad_x_jmu =
-                (lattice_[index + dix] - lattice_[index - dix]) * inv_2dx;
-          }
-          // y direction
-          if (unlikely(iy == 0)) {
-            grad_y_jmu =
-                periodic_
-                    ? (lattice_[index + diy] - lattice_[index + diz - diy]) *
-                          inv_2dy
-                    : (lattice_[index + diy] - lattice_[index]) * 2.0 * inv_2dy;
-          } else if (unlikely(iy == n_cells_[1] - 1)) {
-            grad_y_jmu =
-                periodic_
-                    ? (lattice_[index - diz + diy] - lattice_[index - diy]) *
-                          inv_2dy
-                    : (lattice_[index] - lattice_[index - diy]) * 2.0 * inv_2dy;
-          } else {
-            grad_y_jmu =
-                (lattice_[index + diy] - lattice_[index - diy]) * inv_2dy;
-          }
-          // z direction
-          if (unlikely(iz == 0)) {
-            grad_z_jmu =
-                periodic_
-                    ? (lattice_[index + diz] - lattice_[index + d - diz]) *
-                          inv_2dz
-                    : (lattice_[index + diz] - lattice_[index]) * 2.0 * inv_2dz;
-          } else if (unlikely(iz == n_cells_[2] - 1)) {
-            grad_z_jmu =
-                periodic_
-                    ? (lattice_[index - d + diz] - lattice_[index - diz]) *
-                          inv_2dz
-                    : (lattice_[index] - lattice_[index - diz]) * 2.0 * inv_2dz;
-          } else {
-            grad_z_jmu =
-                (lattice_[index + diz] - lattice_[index - diz]) * inv_2dz;
-          }
-          // fill
-          (grad_lat)[index][0] = grad_t_jmu;
-          (grad_lat)[index][1] = grad_x_jmu;
-          (grad_lat)[index][2] = grad_y_jmu;
-          (grad_lat)[index][3] = grad_z_jmu;
-        }
-      }
-    }
+      RectangularLattice<std::array<FourVector, 4>>& grad_lat,
+      ThreadPool* pool = nullptr) const {
+    check_gradient_lattice(grad_lat);
+    const double inv_time_step = 1.0 / time_step;
+    auto gradient_at = [&](int index, const DifferenceStencil& sx,
+                           const DifferenceStencil& sy,
+                           const DifferenceStencil& sz) {
+      std::array<FourVector, 4>& grad = grad_lat[index];
+      grad[0] = (lattice_[index] - old_lat[index]) * inv_time_step;
+      grad[1] = sx.apply(lattice_, index);
+      grad[2] = sy.apply(lattice_, index);
+      grad[3] = sz.apply(lattice_, index);
+    };
+    iterate_difference_stencils_blocked(
+        pool, 2 * sizeof(T) + sizeof(std::array<FourVector, 4>), gradient_at);
   }
 
   /**
@@ -521,7 +675,7 @@ class RectangularLattice {
    * \param[in] iz The index of the cell in z direction.
    * \return Physical quantity evaluated at the cell center.
    */
-  T& node(int ix, int iy, int iz) {
+  stored_type& node(int ix, int iy, int iz) {
     return periodic_
                ? lattice_[positive_modulo(ix, n_cells_[0]) +
                           n_cells_[0] *
@@ -545,18 +699,148 @@ class RectangularLattice {
    * \todo (oliiny): maybe 1-order interpolation instead of 0-order?
    */
   bool value_at(const ThreeVector& r, T& value) {
-    const int ix = std::floor((r.x1() - origin_[0]) / cell_sizes_[0]);
-    const int iy = std::floor((r.x2() - origin_[1]) / cell_sizes_[1]);
-    const int iz = std::floor((r.x3() - origin_[2]) / cell_sizes_[2]);
-    if (out_of_bounds(ix, iy, iz)) {
+    const int index = index_at(r);
+    if (index < 0) {
       value = T();
       return false;
     } else {
-      value = node(ix, iy, iz);
+      value = Precision::unpack(lattice_[index]);
       return true;
     }
   }
 
+  /**
+   * Find the nodes, from which the value at a position is taken, for this
+   * and all lattices of the same geometry and interpolation, see
+   * shares_stencils. Without interpolation, this is the node of the cell of
+   * the position as in value_at. With interpolation, these are the 8 nodes
+   * around the position, weighted trilinearly by the distances to them. In
+   * the outer half of the boundary cells of a non-periodic lattice, the nodes
+   * beyond the boundary are replaced by the boundary nodes.
+   *
+   * \param[in] r Position [fm]
+   * \param[out] stencil Nodes and weights, without nodes if the position is
+   *             outside of the lattice
+   * \return Whether the position is located inside the lattice.
+   */
+  bool gather_stencil(const ThreeVector& r, GatherStencil& stencil) const {
+    if (!interpolated_) {
+      stencil.index[0] = index_at(r);
+      stencil.weight[0] = 1.;
+      stencil.size = stencil.index[0] < 0 ? 0 : 1;
+      return stencil.size > 0;
+    }
+    std::array<double, 3> u;
+    for (int d = 0; d < 3; d++) {
+      u[d] = (r[d] - origin_[d]) / cell_sizes_[d];
+    }
+    const int ix = std::floor(u[0]);
+    const int iy = std::floor(u[1]);
+    const int iz = std::floor(u[2]);
+    if (out_of_bounds(ix, iy, iz)) {
+      stencil.size = 0;
+      return false;
+    }
+    // lower and upper node and the weight of the upper one in every direction
+    std::array<std::array<int, 2>, 3> nodes;
+    std::array<double, 3> upper_weight;
+    for (int d = 0; d < 3; d++) {
+      // the nodes are at the centers of the cells
+      const double v = u[d] - 0.5;
+      const int lower = std::floor(v);
+      upper_weight[d] = v - lower;
+      if (periodic_) {
+        nodes[d] = {positive_modulo(lower, n_cells_[d]),
+                    positive_modulo(lower + 1, n_cells_[d])};
+      } else {
+        nodes[d] = {std::clamp(lower, 0, n_cells_[d] - 1),
+                    std::clamp(lower + 1, 0, n_cells_[d] - 1)};
+      }
+    }
+    stencil.size = 8;
+    for (int k = 0; k < 8; k++) {
+      const int jx = k & 1, jy = (k >> 1) & 1, jz = k >> 2;
+      stencil.index[k] =
+          nodes[0][jx] +
+          n_cells_[0] * (nodes[1][jy] + n_cells_[1] * nodes[2][jz]);
+      stencil.weight[k] = (jx ? upper_weight[0] : 1. - upper_weight[0]) *
+                          (jy ? upper_weight[1] : 1. - upper_weight[1]) *
+                          (jz ? upper_weight[2] : 1. - upper_weight[2]);
+    }
+    return true;
+  }
+
+  /**
+   * Take the value at a position from the nodes found by gather_stencil on
+   * this lattice or on one, with which it shares the stencils.
+   *
+   * \param[in] stencil Nodes and weights of the position
+   * \param[out] value Value at the position, or the default value (usually
+   *             0) if the position is outside of the lattice. It is summed
+   *             up in double precision.
+   * \return Whether the position is located inside the lattice.
+   */
+  bool gather(const GatherStencil& stencil, T& value) const {
+    if (stencil.size == 1) {
+      value = Precision::unpack(lattice_[stencil.index[0]]);
+    } else {
+      value = T();
+      for (int k = 0; k < stencil.size; k++) {
+        add_weighted(value, Precision::unpack(lattice_[stencil.index[k]]),
+                     stencil.weight[k]);
+      }
+    }
+    return stencil.size > 0;
+  }
+
+  /**
+   * Take the value at a position, interpolated if chosen so, see
+   * gather_stencil.
+   *
+   * \param[in] r Position [fm]
+   * \param[out] value Value at the position, see gather
+   * \return Whether the position is located inside the lattice.
+   */
+  bool gather_at(const ThreeVector& r, T& value) const {
+    GatherStencil stencil;
+    gather_stencil(r, stencil);
+    return gather(stencil, value);
+  }
+
+  /**
+   * \tparam L Type of the other lattice.
+   * \param[in] lat The other lattice
+   * \return Whether the stencils of gather_stencil are the same on both
+   *         lattices.
+   */
+  template <typename L>
+  bool shares_stencils(const L* lat) const {
+    return identical_to_lattice(lat) && interpolated_ == lat->interpolated();
+  }
+
+  /**
+   * Find the cell, in which a given position is located, without copying
+   * its value. For periodic lattices, the position is wrapped around.
+   *
+   * \param[in] r Position [fm]
+   * \return 1-dimensional index of the cell, or -1 if the position is not
+   *         located inside the lattice.
+   */
+  int index_at(const ThreeVector& r) const {
+    const int ix = std::floor((r.x1() - origin_[0]) / cell_sizes_[0]);
+    const int iy = std::floor((r.x2() - origin_[1]) / cell_sizes_[1]);
+    const int iz = std::floor((r.x3() - origin_[2]) / cell_sizes_[2]);
+    if (out_of_bounds(ix, iy, iz)) {
+      return -1;
+    }
+    return periodic_
+               ? positive_modulo(ix, n_cells_[0]) +
+                     n_cells_[0] *
+                         (positive_modulo(iy, n_cells_[1]) +
+                          n_cells_[1] * positive_modulo(iz, n_cells_[2]))
+               : ix + n_cells_[0] * (iy + n_cells_[1] * iz);
+  }
+
   /**
    * A sub-lattice iterator, which iterates in a 3D-structured manner and
    * calls a function on every cell.
@@ -570,6 +854,27 @@ class RectangularLattice {
   template <typename F>
   void iterate_sublattice(const std::array<int, 3>& lower_bounds,
                           const std::array<int, 3>& upper_bounds, F&& func) {
+    iterate_sublattice_indices(lower_bounds, upper_bounds,
+                               [&](int index, int ix, int iy, int iz) {
+                                 func(lattice_[index], ix, iy, iz);
+                               });
+  }
+
+  /**
+   * A sub-lattice iterator like iterate_sublattice, which passes the index of
+   * the node instead of the node, such that several lattices of the same
+   * geometry can be accessed at once.
+   *
+   * \tparam F Type of the function. Arguments are the index of the node and
+   * the 3 integer indices of the cell.
+   * \param[in] lower_bounds Starting numbers for iterating ix, iy, iz.
+   * \param[in] upper_bounds Ending numbers for iterating ix, iy, iz.
+   * \param[in] func Function acting on the indices.
+   */
+  template <typename F>
+  void iterate_sublattice_indices(const std::array<int, 3>& lower_bounds,
+                                  const std::array<int, 3>& upper_bounds,
+                                  F&& func) const {
     logg[LLattice].debug(
         "Iterating sublattice with lower bound index (", lower_bounds[0], ",",
         lower_bounds[1], ",", lower_bounds[2], "), upper bound index (",
@@ -582,8 +887,7 @@ class RectangularLattice {
           const int y_offset =
               n_cells_[0] * (positive_modulo(iy, n_cells_[1]) + z_offset);
           for (int ix = lower_bounds[0]; ix < upper_bounds[0]; ix++) {
-            const int index = positive_modulo(ix, n_cells_[0]) + y_offset;
-            func(lattice_[index], ix, iy, iz);
+            func(positive_modulo(ix, n_cells_[0]) + y_offset, ix, iy, iz);
           }
         }
       }
@@ -593,13 +897,40 @@ class RectangularLattice {
         for (int iy = lower_bounds[1]; iy < upper_bounds[1]; iy++) {
           const int y_offset = n_cells_[0] * (iy + z_offset);
           for (int ix = lower_bounds[0]; ix < upper_bounds[0]; ix++) {
-            func(lattice_[ix + y_offset], ix, iy, iz);
+            func(ix + y_offset, ix, iy, iz);
           }
         }
       }
     }
   }
 
+  /**
+   * Find the cells whose centers lie not further than the given distances in
+   * x, y and z direction from a point. The indices are neither wrapped for
+   * periodic lattices nor restricted to the lattice.
+   *
+   * \param[in] point Position, usually the position of particle [fm].
+   * \param[in] rectangle Maximum distances in x, y and z direction [fm].
+   * \param[out] l_bounds Lowest indices of the cells in x, y and z direction.
+   * \param[out] u_bounds Indices after the highest ones.
+   */
+  void rectangle_bounds(const ThreeVector& point,
+                        const std::array<double, 3>& rectangle,
+                        std::array<int, 3>& l_bounds,
+                        std::array<int, 3>& u_bounds) const {
+    /* Array holds value at the cell center: r_center = r_0 + (i+0.5)cell_size,
+     * where i is index in any direction. Therefore we want cells with condition
+     * (r[i]-rectangle[i])/csize - 0.5 < i < (r[i]+rectangle[i])/csize - 0.5,
+     * r[i] = r_center[i] - r_0[i]
+     */
+    for (int i = 0; i < 3; i++) {
+      l_bounds[i] = std::ceil(
+          (point[i] - origin_[i] - rectangle[i]) / cell_sizes_[i] - 0.5);
+      u_bounds[i] = std::ceil(
+          (point[i] - origin_[i] + rectangle[i]) / cell_sizes_[i] - 0.5);
+    }
+  }
+
   /**
    * Iterates only nodes whose cell centers lie not further than r_cut in x, y,
    * z directions from the given point, that is iterates within a cube of side
@@ -615,32 +946,10 @@ class RectangularLattice {
    */
   template <typename F>
   void iterate_in_cube(const ThreeVector& point, const double r_cut, F&& func) {
-    std::array<int, 3> l_bounds, u_bounds;
-
-    /* Array holds value at the cell center: r_center = r_0 + (i+0.5)cell_size,
-     * where i is index in any direction. Therefore we want cells with condition
-     * (r-r_cut)/csize - 0.5 < i < (r+r_cut)/csize - 0.5, r = r_center - r_0 */
-    for (int i = 0; i < 3; i++) {
-      l_bounds[i] =
-          std::ceil((point[i] - origin_[i] - r_cut) / cell_sizes_[i] - 0.5);
-      u_bounds[i] =
-          std::ceil((point[i] - origin_[i] + r_cut) / cell_sizes_[i] - 0.5);
-    }
-
-    if (!periodic_) {
-      for (int i = 0; i < 3; i++) {
-        if (l_bounds[i] < 0) {
-          l_bounds[i] = 0;
-        }
-        if (u_bounds[i] > n_cells_[i]) {
-          u_bounds[i] = n_cells_[i];
-        }
-        if (l_bounds[i] > n_cells_[i] || u_bounds[i] < 0) {
-          return;
-        }
-      }
-    }
-    iterate_sublattice(l_bounds, u_bounds, std::forward<F>(func));
+    iterate_indices_in_rectangle(point, {r_cut, r_cut, r_cut},
+                                 [&](int index, int ix, int iy, int iz) {
+                                   func(lattice_[index], ix, iy, iz);
+                                 });
   }
 
   /**
@@ -660,7 +969,8 @@ class RectangularLattice {
                         const double rcut, const ThreeVector& point) {
     iterate_in_rectangle(
         point, {rcut, rcut, rcut},
-        [&point, &integral, &integrand, this](T value, int ix, int iy, int iz) {
+        [&point, &integral, &integrand, this](T& value, int ix, int iy,
+                                              int iz) {
           ThreeVector pos = this->cell_center(ix, iy, iz);
           integral += integrand(pos, value, point) * this->cell_volume_;
         });
@@ -682,19 +992,30 @@ class RectangularLattice {
   template <typename F>
   void iterate_in_rectangle(const ThreeVector& point,
                             const std::array<double, 3>& rectangle, F&& func) {
-    std::array<int, 3> l_bounds, u_bounds;
+    iterate_indices_in_rectangle(point, rectangle,
+                                 [&](int index, int ix, int iy, int iz) {
+                                   func(lattice_[index], ix, iy, iz);
+                                 });
+  }
 
-    /* Array holds value at the cell center: r_center = r_0 + (i+0.5)cell_size,
-     * where i is index in any direction. Therefore we want cells with condition
-     * (r[i]-rectangle[i])/csize - 0.5 < i < (r[i]+rectangle[i])/csize - 0.5,
-     * r[i] = r_center[i] - r_0[i]
-     */
-    for (int i = 0; i < 3; i++) {
-      l_bounds[i] = std::ceil(
-          (point[i] - origin_[i] - rectangle[i]) / cell_sizes_[i] - 0.5);
-      u_bounds[i] = std::ceil(
-          (point[i] - origin_[i] + rectangle[i]) / cell_sizes_[i] - 0.5);
-    }
+  /**
+   * Iterates over the indices of the nodes, which iterate_in_rectangle would
+   * iterate over, such that several lattices of the same geometry can be
+   * accessed at once.
+   *
+   * \tparam F Type of the function. Arguments are the index of the node and
+   * the 3 integer indices of the cell.
+   * \param[in] point Position, usually the position of particle [fm].
+   * \param[in] rectangle Maximum distances in the x-, y-, and z-directions
+   * from the cell center to the given position. [fm]
+   * \param[in] func Function acting on the indices.
+   */
+  template <typename F>
+  void iterate_indices_in_rectangle(const ThreeVector& point,
+                                    const std::array<double, 3>& rectangle,
+                                    F&& func) const {
+    std::array<int, 3> l_bounds, u_bounds;
+    rectangle_bounds(point, rectangle, l_bounds, u_bounds);
 
     if (!periodic_) {
       for (int i = 0; i < 3; i++) {
@@ -709,7 +1030,7 @@ class RectangularLattice {
         }
       }
     }
-    iterate_sublattice(l_bounds, u_bounds, std::forward<F>(func));
+    iterate_sublattice_indices(l_bounds, u_bounds, std::forward<F>(func));
   }
 
   /**
@@ -785,7 +1106,7 @@ class RectangularLattice {
 
  protected:
   /// The lattice itself, array containing physical quantities.
-  std::vector<T> lattice_;
+  std::vector<stored_type> lattice_;
   /// Lattice sizes in x, y, z directions.
   const std::array<double, 3> lattice_sizes_;
   /// Number of cells in x,y,z directions.
@@ -800,8 +1121,308 @@ class RectangularLattice {
   const bool periodic_;
   /// When the lattice should be recalculated.
   const LatticeUpdate when_update_;
+  /// Edge length of the tiles of a sparse lattice [cells].
+  static constexpr int tile_size = 8;
+  /// Number of tiles in x, y, z directions.
+  const std::array<int, 3> n_tiles_;
+  /// Whether the lattice is sparse, see set_sparse.
+  bool sparse_ = false;
+  /// Whether values at positions are interpolated, see set_interpolated.
+  bool interpolated_ = false;
+  /// Whether the tiles of a sparse lattice are occupied.
+  std::vector<char> occupied_tiles_;
+  /**
+   * Memory, which the nodes touched while sweeping over a block of the
+   * lattice should fit into, about the size of the L2 cache [bytes].
+   */
+  static constexpr std::size_t cache_block_bytes = 1 << 18;
 
  private:
+  /// Lattices of other types take over the occupied tiles
+  template <typename U, typename P>
+  friend class RectangularLattice;
+
+  /**
+   * Add a weighted value to a sum, see gather.
+   *
+   * \param[inout] sum Sum of the weighted values
+   * \param[in] value Value to be added
+   * \param[in] weight Weight of the value
+   */
+  template <typename U>
+  static void add_weighted(U& sum, const U& value, double weight) {
+    sum += value * weight;
+  }
+
+  /// Add a weighted pair of values to a sum element by element, see gather.
+  template <typename U, typename V>
+  static void add_weighted(std::pair<U, V>& sum, const std::pair<U, V>& value,
+                           double weight) {
+    add_weighted(sum.first, value.first, weight);
+    add_weighted(sum.second, value.second, weight);
+  }
+
+  /**
+   * \param[in] tx The index of the tile in x direction.
+   * \param[in] ty The index of the tile in y direction.
+   * \param[in] tz The index of the tile in z direction.
+   * \return Position of the tile in occupied_tiles_.
+   */
+  int tile_index(int tx, int ty, int tz) const {
+    return tx + n_tiles_[0] * (ty + n_tiles_[1] * tz);
+  }
+
+  /**
+   * Calls a function for every row of cells in x direction within the given
+   * tiles.
+   *
+   * \tparam F Type of the function. Arguments are the index of the first
+   * node of the row and the number of nodes.
+   * \param[in] tiles Whether every tile is to be iterated over.
+   * \param[in] func Function acting on the rows.
+   */
+  template <typename F>
+  void iterate_tiles(const std::vector<char>& tiles, F&& func) const {
+    for (int tz = 0; tz < n_tiles_[2]; tz++) {
+      const int z_end = std::min((tz + 1) * tile_size, n_cells_[2]);
+      for (int ty = 0; ty < n_tiles_[1]; ty++) {
+        const int y_end = std::min((ty + 1) * tile_size, n_cells_[1]);
+        int tx = 0;
+        while (tx < n_tiles_[0]) {
+          // neighbouring tiles are joined into one row
+          if (!tiles[tile_index(tx, ty, tz)]) {
+            tx++;
+            continue;
+          }
+          const int x_begin = tx * tile_size;
+          while (tx < n_tiles_[0] && tiles[tile_index(tx, ty, tz)]) {
+            tx++;
+          }
+          const int x_end = std::min(tx * tile_size, n_cells_[0]);
+          for (int iz = tz * tile_size; iz < z_end; iz++) {
+            for (int iy = ty * tile_size; iy < y_end; iy++) {
+              func(x_begin + n_cells_[0] * (iy + n_cells_[1] * iz),
+                   x_end - x_begin);
+            }
+          }
+        }
+      }
+    }
+  }
+
+  /**
+   * Offsets of the two nodes whose difference approximates the derivative in
+   * one direction at a node, together with the inverse of their distance.
+   * Central differences are taken inside the lattice, on the boundaries of a
+   * non-periodic lattice one-sided ones.
+   */
+  struct DifferenceStencil {
+    /// Offset of the node behind
+    int minus;
+    /// Offset of the node ahead
+    int plus;
+    /// Inverse distance of the two nodes [fm\f$^{-1}\f$]
+    double inv_distance;
+
+    /**
+     * \param[in] values Values on the nodes of the lattice
+     * \param[in] index Index of the node
+     * \return Finite difference of the values at the node
+     */
+    template <typename U>
+    U apply(const std::vector<U>& values, int index) const {
+      return (values[index + plus] - values[index + minus]) * inv_distance;
+    }
+  };
+
+  /**
+   * \param[in] direction 0, 1 or 2 for x, y or z direction
+   * \param[in] i Index of the cell in this direction
+   * \return Stencil of the finite difference in this direction at the cell
+   */
+  DifferenceStencil difference_stencil(int direction, int i) const {
+    const int n = n_cells_[direction];
+    const int stride = direction == 0   ? 1
+                       : direction == 1 ? n_cells_[0]
+                                        : n_cells_[0] * n_cells_[1];
+    const double inv_2d = 0.5 / cell_sizes_[direction];
+    if (i == 0) {
+      return periodic_ ? DifferenceStencil{(n - 1) * stride, stride, inv_2d}
+                       : DifferenceStencil{0, stride, 2.0 * inv_2d};
+    } else if (i == n - 1) {
+      return periodic_ ? DifferenceStencil{-stride, -(n - 1) * stride, inv_2d}
+                       : DifferenceStencil{-stride, 0, 2.0 * inv_2d};
+    }
+    return {-stride, stride, inv_2d};
+  }
+
+  /**
+   * Checks that the gradients of this lattice can be computed on the given
+   * lattice.
+   *
+   * \param[in] grad_lat Lattice for the gradients
+   * \throw std::runtime_error if the lattice has less than 2 cells in any
+   * direction.
+   * \throw std::invalid_argument if the lattices differ in their geometry.
+   */
+  template <typename U>
+  void check_gradient_lattice(const RectangularLattice<U>& grad_lat) const {
+    if (n_cells_[0] < 2 || n_cells_[1] < 2 || n_cells_[2] < 2) {
+      // Gradient calculation is impossible
+      throw std::runtime_error(
+          "Lattice is too small for gradient calculation"
+          " (should be at least 2x2x2)");
+    }
+    if (!identical_to_lattice(&grad_lat)) {
+      // Lattice for gradient should have identical origin/dims/periodicity
+      throw std::invalid_argument(
+          "Lattice for gradient should have the"
+          " same origin/dims/periodicity as the original one.");
+    }
+  }
+
+  /**
+   * Calls a function with the stencils of the finite differences for every
+   * cell of a sublattice. The stencils in y and z direction are set up once
+   * per row, and the inner cells of a row only differ by their index, so
+   * that no boundary checks are done for them.
+   *
+   * \tparam F Type of the function. Arguments are the index of the node and
+   * its stencils in x, y and z direction.
+   * \param[in] lower_bounds Starting numbers for iterating ix, iy, iz, which
+   * lie on the lattice.
+   * \param[in] upper_bounds Ending numbers for iterating ix, iy, iz.
+   * \param[in] func Function acting on the cells.
+   */
+  template <typename F>
+  void iterate_difference_stencils(const std::array<int, 3>& lower_bounds,
+                                   const std::array<int, 3>& upper_bounds,
+                                   F&& func) const {
+    const DifferenceStencil sx_first = difference_stencil(0, 0);
+    const DifferenceStencil sx_last = difference_stencil(0, n_cells_[0] - 1);
+    const DifferenceStencil sx_inner = {-1, 1, 0.5 / cell_sizes_[0]};
+    const int x_inner_end = std::min(upper_bounds[0], n_cells_[0] - 1);
+    for (int iz = lower_bounds[2]; iz < upper_bounds[2]; iz++) {
+      const DifferenceStencil sz = difference_stencil(2, iz);
+      for (int iy = lower_bounds[1]; iy < upper_bounds[1]; iy++) {
+        const DifferenceStencil sy = difference_stencil(1, iy);
+        const int row = n_cells_[0] * (iy + n_cells_[1] * iz);
+        int ix = lower_bounds[0];
+        if (ix == 0) {
+          func(row, sx_first, sy, sz);
+          ix++;
+        }
+        for (; ix < x_inner_end; ix++) {
+          func(row + ix, sx_inner, sy, sz);
+        }
+        if (upper_bounds[0] == n_cells_[0]) {
+          func(row + n_cells_[0] - 1, sx_last, sy, sz);
+        }
+      }
+    }
+  }
+
+  /**
+   * Calls a function with the stencils of the finite differences for every
+   * cell of the lattice, like iterate_difference_stencils. The lattice is
+   * swept in blocks of full rows in x direction, which are split in y
+   * direction such that the rows of the three planes reached by the stencils
+   * in z direction fit into cache_block_bytes. Running through z within a
+   * block, every node is then loaded once, instead of once per plane, if the
+   * planes are larger than the cache. The blocks are split among the threads,
+   * if given.
+   *
+   * \tparam F Type of the function, see iterate_difference_stencils.
+   * \param[in] pool Threads sweeping blocks concurrently, may be null.
+   * \param[in] bytes_per_node Memory touched per node by the function.
+   * \param[in] func Function acting on the cells.
+   */
+  template <typename F>
+  void iterate_difference_stencils_blocked(ThreadPool* pool,
+                                           std::size_t bytes_per_node,
+                                           F&& func) const {
+    const std::size_t row_bytes = n_cells_[0] * bytes_per_node;
+    const int rows_per_block = std::clamp(
+        static_cast<int>(cache_block_bytes / (3 * row_bytes)), 1, n_cells_[1]);
+    const int n_blocks = (n_cells_[1] + rows_per_block - 1) / rows_per_block;
+    // the z planes of all blocks are enumerated, z running fastest
+    for_each_chunk(pool, n_blocks * n_cells_[2], [&](int begin, int end) {
+      while (begin < end) {
+        const int block = begin / n_cells_[2];
+        const int z_begin = begin % n_cells_[2];
+        const int z_end = std::min(n_cells_[2], z_begin + end - begin);
+        iterate_difference_stencils(
+            {0, block * rows_per_block, z_begin},
+            {n_cells_[0], std::min(n_cells_[1], (block + 1) * rows_per_block),
+             z_end},
+            func);
+        begin += z_end - z_begin;
+      }
+    });
+  }
+
+  /**
+   * Splits the range [0, n) into contiguous chunks and calls a function for
+   * each of them, concurrently if threads are given.
+   *
+   * \tparam F Type of the function. Arguments are the beginning and the end
+   * of the chunk.
+   * \param[in] pool Threads processing the chunks, may be null.
+   * \param[in] n Size of the range
+   * \param[in] func Function acting on the chunks.
+   */
+  template <typename F>
+  static void for_each_chunk(ThreadPool* pool, int n, F&& func) {
+    if (pool == nullptr || pool->size() < 2 || n < 2) {
+      func(0, n);
+      return;
+    }
+    // a few chunks per thread even out their different costs
+    const int n_chunks = std::min(n, 4 * pool->size());
+    const int chunk_size = (n + n_chunks - 1) / n_chunks;
+    pool->parallel_for(n_chunks, [&](int chunk) {
+      func(std::min(n, chunk * chunk_size),
+           std::min(n, (chunk + 1) * chunk_size));
+    });
+  }
+
+  /**
+   * \return The occupied tiles of a sparse lattice together with their
+   * neighbours, including the ones across the boundaries of a periodic
+   * lattice.
+   */
+  std::vector<char> dilated_tiles() const {
+    std::vector<char> dilated(occupied_tiles_.size(), 0);
+    for (int tz = 0; tz < n_tiles_[2]; tz++) {
+      for (int ty = 0; ty < n_tiles_[1]; ty++) {
+        for (int tx = 0; tx < n_tiles_[0]; tx++) {
+          if (!occupied_tiles_[tile_index(tx, ty, tz)]) {
+            continue;
+          }
+          for (int dz = -1; dz <= 1; dz++) {
+            for (int dy = -1; dy <= 1; dy++) {
+              for (int dx = -1; dx <= 1; dx++) {
+                std::array<int, 3> t = {tx + dx, ty + dy, tz + dz};
+                bool inside = true;
+                for (int i = 0; i < 3; i++) {
+                  if (periodic_) {
+                    t[i] = positive_modulo(t[i], n_tiles_[i]);
+                  } else if (t[i] < 0 || t[i] >= n_tiles_[i]) {
+                    inside = false;
+                  }
+                }
+                if (inside) {
+                  dilated[tile_index(t[0], t[1], t[2])] = 1;
+                }
+              }
+            }
+          }
+        }
+      }
+    }
+    return dilated;
+  }
+
   /**
    * Returns division modulo, which is always between 0 and n-1
    * i%n is not suitable, because it returns results from -(n-1) to n-1
@@ -819,6 +1440,30 @@ class RectangularLattice {
   }
 };
 
+/**
+ * Precision policy of the lattices, which may be stored in single precision,
+ * see RectangularLattice. It is SinglePrecision if SMASH is built with
+ * SMASH_SINGLE_PRECISION_LATTICES and DoublePrecision otherwise.
+ *
+ * \tparam T Type of the values
+ */
+#ifdef SMASH_SINGLE_PRECISION_LATTICES
+template <typename T>
+using LatticePrecision = SinglePrecision<T>;
+#else
+template <typename T>
+using LatticePrecision = DoublePrecision<T>;
+#endif
+
+/**
+ * Lattice of the electric and magnetic components of the forces of the
+ * potentials or of the electromagnetic fields. Its values are only written
+ * and gathered at positions, so it is stored with LatticePrecision.
+ */
+using ForceLattice =
+    RectangularLattice<std::pair<ThreeVector, ThreeVector>,
+                       LatticePrecision<std::pair<ThreeVector, ThreeVector>>>;
+
 }  // namespace smash
 
 #endif  // SRC_INCLUDE_SMASH_LATTICE_H_
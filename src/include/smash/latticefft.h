@@ -0,0 +1,129 @@
+/*
+ *
+ *    Copyright (c) 2024
+ *      SMASH Team
+ *
+ *    GNU General Public License (GPLv3 or later)
+ *
+ */
+
+#ifndef SRC_INCLUDE_SMASH_LATTICEFFT_H_
+#define SRC_INCLUDE_SMASH_LATTICEFFT_H_
+
+#include <gsl/gsl_fft_complex.h>
+
+#include <array>
+#include <complex>
+#include <cstddef>
+#include <optional>
+#include <vector>
+
+namespace smash {
+
+/**
+ * \ingroup data
+ *
+ * Three-dimensional fast Fourier transforms of quantities on the nodes of a
+ * lattice, to convolve them with a kernel, which only reaches a limited
+ * number of cells.
+ *
+ * The transforms act on grids of complex numbers, which hold the lattice in
+ * the nodes with the lowest indices. For periodic lattices, the grid has the
+ * size of the lattice and a convolution wraps around it, like the
+ * integration over a box around a node does. Otherwise, the grid is padded
+ * by the range of the kernel, such that the products in Fourier space do not
+ * mix the two ends of the lattice. The sizes are rounded up to products of
+ * the factors 2, 3 and 5, for which the transforms are fastest.
+ *
+ * A kernel is stored in a grid at the offsets between the nodes, wrapped
+ * around the grid, see offset_index.
+ */
+class LatticeFFT {
+ public:
+  /// Complex numbers on the nodes of a grid, x being the fastest index
+  using Grid = std::vector<std::complex<double>>;
+
+  /**
+   * Set up the transforms for a lattice.
+   *
+   * \param[in] n_cells Number of cells of the lattice in every direction
+   * \param[in] range Largest offset in cells between two nodes, which the
+   *            kernels connect, in every direction
+   * \param[in] periodic Whether the lattice is periodic
+   */
+  LatticeFFT(const std::array<int, 3> &n_cells, const std::array<int, 3> &range,
+             bool periodic);
+
+  /// Cannot be copied
+  LatticeFFT(const LatticeFFT &) = delete;
+  /// Cannot be copied
+  LatticeFFT &operator=(const LatticeFFT &) = delete;
+
+  /// Destructor
+  ~LatticeFFT();
+
+  /// \return Number of cells of the lattice in every direction
+  const std::array<int, 3> &n_cells() const { return n_cells_; }
+
+  /// \return Number of nodes of a grid
+  std::size_t grid_size() const {
+    return static_cast<std::size_t>(size_[0]) * size_[1] * size_[2];
+  }
+
+  /// \return Position of a node of the lattice in a grid
+  std::size_t grid_index(int ix, int iy, int iz) const {
+    return ix + static_cast<std::size_t>(size_[0]) * (iy + size_[1] * iz);
+  }
+
+  /**
+   * \param[in] mx Offset between two nodes in x direction [cells]
+   * \param[in] my Offset in y direction
+   * \param[in] mz Offset in z direction
+   * \return Position of the offset in the grid of a kernel, or nothing if no
+   *         two nodes of a non-periodic lattice are that far apart.
+   */
+  std::optional<std::size_t> offset_index(int mx, int my, int mz) const;
+
+  /**
+   * Fourier transform a grid.
+   *
+   * \param[in,out] grid Grid of grid_size() nodes
+   * \param[in] only_lattice Whether the grid is zero outside of the lattice,
+   *            which skips the transforms of lines known to vanish
+   */
+  void forward(Grid &grid, bool only_lattice);
+
+  /**
+   * Transform a grid back, including the normalization.
+   *
+   * \param[in,out] grid Grid of grid_size() nodes
+   * \param[in] only_lattice Whether only the nodes of the lattice are needed
+   *            afterwards, which skips the transforms of the other lines
+   */
+  void inverse(Grid &grid, bool only_lattice);
+
+ private:
+  /**
+   * Transform the lines of a grid in all directions one after the other.
+   *
+   * \param[in,out] grid Grid to be transformed
+   * \param[in] inverse Whether to transform back
+   * \param[in] only_lattice See forward and inverse
+   */
+  void transform(Grid &grid, bool inverse, bool only_lattice);
+
+  /// Number of cells of the lattice in every direction
+  const std::array<int, 3> n_cells_;
+  /// Whether the lattice is periodic
+  const bool periodic_;
+  /// Size of the grid in every direction
+  std::array<int, 3> size_;
+  /// Trigonometric tables of the transforms in every direction
+  std::array<gsl_fft_complex_wavetable *, 3> wavetables_;
+  /// Workspaces of the transforms in every direction
+  std::array<gsl_fft_complex_workspace *, 3> workspaces_;
+};
+
+}  // namespace smash
+
+#endif  // SRC_INCLUDE_SMASH_LATTICEFFT_H_
@@ -1,6 +1,6 @@
 /*
  *
- *    Copyright (c) 2022
+ *    Copyright (c) 2022,2024
  *      SMASH Team
  *
  *    GNU General Public License (GPLv3 or later)
@@ -11,6 +11,7 @@
 #include <vector>
 
 #include "configuration.h"
+#include "isoparticletype.h"
 
 #ifndef SRC_INCLUDE_SMASH_LIBRARY_H_
 #define SRC_INCLUDE_SMASH_LIBRARY_H_
@@ -39,9 +40,30 @@ Configuration setup_config_and_logging(
     const std::string &decaymodes_file = {},
     const std::vector<std::string> &extra_config = {});
 
+/**
+ * Find the kinds of resonance integrals which the configured reactions can
+ * look up.
+ *
+ * The integrals belong to 2-to-2 reactions of baryons, except for the ρ R
+ * integrals of ρ h₁ → N N̄. Baryons are only present if they are in the
+ * initial state, or if strings or the annihilation of N N̄ via resonances
+ * can create them. In a box or sphere of mesons with the default
+ * `NNbar_Treatment`, and in a box without strings, there are none.
+ *
+ * Nothing is taken from the configuration.
+ *
+ * \param[in] configuration Fully-setup configuration
+ * \return The reachable kinds of integrals
+ */
+ReachableIntegrals reachable_integrals(Configuration &configuration);
+
 /**
  * Initialize the particles and decays from the given configuration,
- * plus tabulate the resonance integrals.
+ * plus tabulate the reachable resonance integrals (see reachable_integrals),
+ * the mass dependence of the decay widths and, if photons are produced in
+ * scatterings, the photon cross sections. All tabulations are cached in the
+ * given directory. The other resonance integrals are tabulated when they are
+ * looked up for the first time.
  *
  * \param[in] configuration Fully-setup configuration i.e. including
  * particles and decaymodes.
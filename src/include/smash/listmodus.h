@@ -1,5 +1,5 @@
 /*
- *    Copyright (c) 2015-2023
+ *    Copyright (c) 2015-2024
  *      SMASH Team
  *
  *    GNU General Public License (GPLv3 or later)
@@ -9,12 +9,19 @@
 
 #include <cmath>
 #include <cstdint>
+#include <future>
 #include <list>
+#include <memory>
+#include <optional>
 #include <string>
+#include <string_view>
 #include <utility>
+#include <vector>
 
+#include "file.h"
 #include "forwarddeclarations.h"
 #include "modusdefault.h"
+#include "pdgcode.h"
 
 namespace smash {
 
@@ -152,18 +159,65 @@ class ListModus : public ModusDefault {
   double start_time_ = 0.;
 
  private:
+  /// Quantities of a particle as given in the external particle list
+  struct InputParticle {
+    /// Position [fm]
+    double t, x, y, z;
+    /// Mass [GeV]
+    double mass;
+    /// Momentum [GeV]
+    double E, px, py, pz;
+    /// PDG code
+    PdgCode pdgcode;
+    /// Electric charge
+    int charge;
+  };
+
+  /// Text of an event in a mapped particle list file
+  struct EventText {
+    /// File, which is kept mapped as long as the text is needed
+    std::shared_ptr<const MappedFile> file;
+    /// Lines of the event, or the particle records for a binary file
+    std::string_view text;
+    /// Size of a particle record of a binary file, 0 for a text file
+    std::size_t binary_record_size;
+  };
+
   /**
-   * Check if the file given by filepath has events left after streampos
-   * last_position
+   * Split the content of a particle list file into events. Events are ended
+   * by lines containing "end", like the event end lines of the Oscar outputs.
+   * Other files contain a single event. Whitespace after the last event end
+   * line is not counted as an event.
    *
-   * \param[in] filepath Path to file to be checked.
-   * \param[in] last_position Stream position in file after which check is
-   * performed
-   * \return True if there is at least one event left, false otherwise
-   * \throws runtime_error If file could not be read for whatever reason.
+   * \param[in] content Content of the file
+   * \return Offset and length of every event in the file
+   */
+  static std::vector<std::pair<std::size_t, std::size_t>> index_events_(
+      std::string_view content);
+
+  /**
+   * Split a particle list file in the binary format of the particles output
+   * into events. The particles of an event are those of the last particle
+   * block before its event end block. A particle block at the end of the file
+   * without event end block is read as the last event.
+   *
+   * \param[in] content Content of the file, starting with "SMSH"
+   * \param[out] record_size Size of the particle records in bytes
+   * \return Offset and length of the particle records of every event
+   * \throw LoadFailure if the file is not correctly formatted
+   */
+  static std::vector<std::pair<std::size_t, std::size_t>>
+  index_binary_events_(std::string_view content, std::size_t &record_size);
+
+  /**
+   * Parse the particles of an event in place, without copying its lines or
+   * records.
+   *
+   * \param[in] event Text or binary records of the event
+   * \return Particles of the event
+   * \throw LoadFailure if a line is not correctly formatted
    */
-  bool file_has_events_(std::filesystem::path filepath,
-                        std::streampos last_position);
+  static std::vector<InputParticle> parse_event_(const EventText &event);
 
   /**
    * Return the absolute path of the data file. If an integer is passed, the
@@ -180,14 +234,24 @@ class ListModus : public ModusDefault {
   std::filesystem::path file_path_(std::optional<int> file_id);
 
   /**
-   * Read the next event. Either from the current file if it has more events
-   * or from the next file (with file_id += 1)
+   * Find the next event. Either in the current file if it has more events
+   * or in the next file (with file_id += 1), which is mapped and indexed.
+   *
+   * \returns Text of the event
+   * \throws runtime_error If file could not be read for whatever reason.
+   */
+  EventText find_next_event_();
+
+  /**
+   * Read the next event, which might already have been parsed in the
+   * background. If prefetching is enabled, parsing the following event of
+   * the same file is started in the background.
    *
-   * \returns
-   *  One event as string.
-   *  \throws runtime_error If file could not be read for whatever reason.
+   * \returns Particles of the event
+   * \throws runtime_error If file could not be read for whatever reason.
+   * \throws LoadFailure If the event is not correctly formatted
    */
-  std::string next_event_();
+  std::vector<InputParticle> next_event_();
 
   /// File directory of the particle list
   std::string particle_list_file_directory_;
@@ -204,8 +268,23 @@ class ListModus : public ModusDefault {
   /// The unique id of the current event
   int event_id_;
 
-  /// Last read position in current file
-  std::streampos last_read_position_ = 0;
+  /// Currently mapped file, if any
+  std::shared_ptr<const MappedFile> file_;
+
+  /// Offset and length of the events in the current file
+  std::vector<std::pair<std::size_t, std::size_t>> file_events_;
+
+  /// Index of the next event to be read from the current file
+  std::size_t next_event_in_file_ = 0;
+
+  /// Size of the particle records of the current file, 0 for a text file
+  std::size_t binary_record_size_ = 0;
+
+  /// Whether the next event is parsed in the background
+  bool prefetch_ = false;
+
+  /// Next event, which is parsed in the background
+  std::future<std::vector<InputParticle>> prefetched_event_;
 
   /// Auxiliary flag to warn about mass-discrepancies only once per instance
   bool warn_about_mass_discrepancy_ = true;
@@ -284,7 +363,8 @@ class ListBoxModus : public ListModus {
       const Particles &particles, double min_cell_length,
       double timestep_duration, CollisionCriterion crit,
       const bool include_unformed_particles,
-      CellSizeStrategy strategy = CellSizeStrategy::Optimal) const {
+      CellSizeStrategy strategy = CellSizeStrategy::Optimal, double = 0.,
+      const std::optional<GridBase::MinAndLength> & = std::nullopt) const {
     CellNumberLimitation limit = CellNumberLimitation::ParticleNumber;
     if (crit == CollisionCriterion::Stochastic) {
       limit = CellNumberLimitation::None;
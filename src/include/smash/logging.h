@@ -1,6 +1,6 @@
 /*
  *
- *    Copyright (c) 2014-2023
+ *    Copyright (c) 2014-2024
  *      SMASH Team
  *
  *    GNU General Public License (GPLv3 or later)
@@ -10,8 +10,11 @@
 #ifndef SRC_INCLUDE_SMASH_LOGGING_H_
 #define SRC_INCLUDE_SMASH_LOGGING_H_
 
+#include <atomic>
+#include <cstdint>
 #include <stdexcept>
 #include <tuple>
+#include <utility>
 
 #include "einhard.hpp"
 #include "yaml-cpp/yaml.h"
@@ -67,7 +70,65 @@ class Configuration;
  * former variant, that could make it slightly more efficient). You can see,
  * though, that the former variant is more concise and often much easier to type
  * than the stream operators.
+ *
+ * In both variants the arguments are evaluated even if the level is disabled.
+ * In hot loops, use the macros SMASH_LOG_DEBUG and SMASH_LOG_TRACE instead,
+ * which only evaluate their arguments if the level is enabled for the area:
+ * \code
+ * SMASH_LOG_DEBUG(LAreaName, "particle", p, " at ", p.position().x0());
+ * \endcode
+ * Messages below the level given by the CMake option
+ * `SMASH_COMPILE_TIME_LOG_LEVEL` are removed at compile time, such that they
+ * cost nothing at all. Without the option, all levels are compiled in, except
+ * for debug and trace messages in builds with `NDEBUG`.
+ */
+
+#ifndef SMASH_COMPILE_TIME_LOG_LEVEL
+/// Name of the lowest einhard::LogLevel compiled into SMASH
+#define SMASH_COMPILE_TIME_LOG_LEVEL ALL
+#endif
+
+/**
+ * Lowest level of the messages, which are compiled into SMASH. With `NDEBUG`,
+ * einhard removes the debug and trace messages anyway.
+ */
+#ifdef NDEBUG
+inline constexpr einhard::LogLevel compile_time_log_level =
+    einhard::SMASH_COMPILE_TIME_LOG_LEVEL > einhard::INFO
+        ? einhard::SMASH_COMPILE_TIME_LOG_LEVEL
+        : einhard::INFO;
+#else
+inline constexpr einhard::LogLevel compile_time_log_level =
+    einhard::SMASH_COMPILE_TIME_LOG_LEVEL;
+#endif
+
+/**
+ * \internal
+ * Write a message with the given method of the logger of an area, if the
+ * level is compiled in and enabled. The arguments are only evaluated then.
  */
+#define SMASH_LOG_AT_LEVEL_(level__, method__, area__, ...)                 \
+  do {                                                                     \
+    if constexpr (::einhard::level__ >= ::smash::compile_time_log_level) { \
+      if (::smash::logg[area__].isEnabled<::einhard::level__>()) {         \
+        ::smash::logg[area__].method__(__VA_ARGS__);                       \
+      }                                                                    \
+    }                                                                      \
+  } while (false)
+
+/**
+ * Write a debug message to the logger of an area, evaluating the arguments
+ * only if debug messages are compiled in and enabled for the area.
+ */
+#define SMASH_LOG_DEBUG(area__, ...) \
+  SMASH_LOG_AT_LEVEL_(DEBUG, debug, area__, __VA_ARGS__)
+
+/**
+ * Write a trace message to the logger of an area, evaluating the arguments
+ * only if trace messages are compiled in and enabled for the area.
+ */
+#define SMASH_LOG_TRACE(area__, ...) \
+  SMASH_LOG_AT_LEVEL_(TRACE, trace, area__, __VA_ARGS__)
 
 /**
  * Declares the necessary interface to identify a new log area.
@@ -223,8 +284,91 @@ FormattingHelper<T> format(const T &value, const char *unit, int width = -1,
  * An array that stores all pre-configured Logger objects. The objects can be
  * accessed via the logger function.
  */
-extern std::array<einhard::Logger<>, std::tuple_size<LogArea::AreaTuple>::value>
+extern std::array<einhard::Logger<compile_time_log_level>,
+                  std::tuple_size<LogArea::AreaTuple>::value>
     logg;
+
+/**
+ * A warning which can occur very often in a hot loop. Only its first
+ * occurrences in an event are written, the later ones are counted without
+ * formatting the message and summarized at the end of the event by
+ * summarize_rate_limited_warnings(). Occurrences may be counted from several
+ * threads at once.
+ *
+ * \code
+ * static RateLimitedWarning warning(LAreaName, "Something happened");
+ * warning.warn("Something happened to particle ", p);
+ * \endcode
+ */
+class RateLimitedWarning {
+ public:
+  /**
+   * Create a warning and register it for the summaries. It has to outlive its
+   * uses, so it is usually a static object.
+   *
+   * \param[in] area Id of the log area the warning is written to
+   * \param[in] description Short description for the summary, which has to
+   *                        outlive the warning
+   * \param[in] limit Number of occurrences per event which are written
+   */
+  RateLimitedWarning(int area, const char *description,
+                     std::uint64_t limit = 10);
+  /// Unregister the warning
+  ~RateLimitedWarning();
+  /// Cannot be copied, as it is registered by address
+  RateLimitedWarning(const RateLimitedWarning &) = delete;
+  /// Cannot be copied, as it is registered by address
+  RateLimitedWarning &operator=(const RateLimitedWarning &) = delete;
+
+  /**
+   * Count an occurrence.
+   *
+   * \return whether it is among the first ones, which are to be written
+   */
+  bool count() {
+    return occurrences_.fetch_add(1, std::memory_order_relaxed) < limit_;
+  }
+
+  /**
+   * Count an occurrence and write the warning, if it is among the first ones.
+   * Otherwise the arguments are not formatted.
+   *
+   * \param[in] args What is written, as for the logger itself
+   */
+  template <typename... Args>
+  void warn(Args &&...args) {
+    if (count()) {
+      logg[area_].warn(std::forward<Args>(args)...);
+    }
+  }
+
+  /// \return Number of occurrences since the last summary
+  std::uint64_t occurrences() const {
+    return occurrences_.load(std::memory_order_relaxed);
+  }
+
+  /**
+   * Write how often the warning was suppressed since the last summary, if it
+   * was, and start counting anew.
+   */
+  void summarize();
+
+ private:
+  /// Id of the log area
+  const int area_;
+  /// Short description for the summary
+  const char *const description_;
+  /// Number of occurrences per event which are written
+  const std::uint64_t limit_;
+  /// Number of occurrences since the last summary
+  std::atomic<std::uint64_t> occurrences_{0};
+};
+
+/**
+ * Summarize all rate-limited warnings, see RateLimitedWarning::summarize.
+ * Called at the end of every event.
+ */
+void summarize_rate_limited_warnings();
 }  // namespace smash
 
 namespace YAML {
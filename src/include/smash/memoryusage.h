@@ -0,0 +1,124 @@
+/*
+ *
+ *    Copyright (c) 2024
+ *      SMASH Team
+ *
+ *    GNU General Public License (GPLv3 or later)
+ *
+ */
+
+#ifndef SRC_INCLUDE_SMASH_MEMORYUSAGE_H_
+#define SRC_INCLUDE_SMASH_MEMORYUSAGE_H_
+
+#include <array>
+#include <cstddef>
+#include <string>
+
+namespace smash {
+
+/**
+ * \ingroup output
+ *
+ * Keeps track of the memory held by the large containers of the subsystems of
+ * SMASH, like the particles of all ensembles or the lattices, and of the
+ * resident set size of the process.
+ *
+ * The memory of the subsystems is given by the capacity of their containers,
+ * which is cheap to obtain, hence the usage can be updated every time step.
+ * Both the current and the peak values are kept. The PYTHIA objects manage
+ * their memory themselves and are only counted.
+ *
+ * Optionally, a limit on the resident set size is checked, such that SMASH
+ * stops with an error naming the largest subsystems instead of being killed
+ * when running out of memory.
+ */
+class MemoryUsage {
+ public:
+  /// Subsystems, whose memory is accounted for
+  enum class Subsystem : int {
+    /// Particles of all ensembles
+    Particles,
+    /// Collision-finding grids of all ensembles
+    Grids,
+    /// Actions found in the time step of all ensembles
+    Actions,
+    /// Density, field and potential lattices
+    Lattices,
+    /// Tabulations of the particle types and cross sections
+    Tabulations,
+    /// Buffers of the outputs
+    Outputs
+  };
+
+  /// Number of subsystems
+  static constexpr int n_subsystems = 6;
+
+  /**
+   * \param[in] subsystem Subsystem
+   * \return Name of the subsystem as used in the report
+   */
+  static const char *name(Subsystem subsystem);
+
+  /**
+   * \param[in] limit Limit of the resident set size in bytes, 0 for none
+   */
+  explicit MemoryUsage(std::size_t limit = 0) : limit_(limit) {}
+
+  /**
+   * Set the memory currently used by a subsystem.
+   *
+   * \param[in] subsystem Subsystem
+   * \param[in] bytes Memory used [bytes]
+   */
+  void set(Subsystem subsystem, std::size_t bytes) {
+    const int i = static_cast<int>(subsystem);
+    current_[i] = bytes;
+    if (bytes > peak_[i]) {
+      peak_[i] = bytes;
+    }
+  }
+
+  /**
+   * Set the number of PYTHIA objects.
+   *
+   * \param[in] n Number of PYTHIA objects
+   */
+  void set_pythia_instances(std::size_t n) { pythia_instances_ = n; }
+
+  /**
+   * Check the resident set size against the limit.
+   *
+   * \throw std::runtime_error if the limit is exceeded, with the report in
+   *        the message
+   */
+  void check_limit() const;
+
+  /**
+   * \return Table of the current and peak memory of the subsystems and of
+   *         the resident set size
+   */
+  std::string report() const;
+
+  /// \return Resident set size of the process [bytes], 0 if unknown
+  static std::size_t resident_set_size();
+
+  /// \return Peak resident set size of the process [bytes], 0 if unknown
+  static std::size_t peak_resident_set_size();
+
+ private:
+  /// Memory currently used per subsystem [bytes]
+  std::array<std::size_t, n_subsystems> current_{};
+
+  /// Peak memory used per subsystem [bytes]
+  std::array<std::size_t, n_subsystems> peak_{};
+
+  /// Number of PYTHIA objects
+  std::size_t pythia_instances_ = 0;
+
+  /// Limit of the resident set size [bytes], 0 for none
+  const std::size_t limit_;
+};
+
+}  // namespace smash
+
+#endif  // SRC_INCLUDE_SMASH_MEMORYUSAGE_H_
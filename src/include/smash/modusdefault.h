@@ -1,6 +1,6 @@
 /*
  *
- *    Copyright (c) 2013-2022
+ *    Copyright (c) 2013-2022,2024
  *      SMASH Team
  *
  *    GNU General Public License (GPLv3 or later)
@@ -10,9 +10,12 @@
 #ifndef SRC_INCLUDE_SMASH_MODUSDEFAULT_H_
 #define SRC_INCLUDE_SMASH_MODUSDEFAULT_H_
 
+#include <cstdint>
 #include <memory>
+#include <optional>
 
 #include "configuration.h"
+#include "equilibrationmonitor.h"
 #include "forwarddeclarations.h"
 #include "fourvector.h"
 #include "grandcan_thermalizer.h"
@@ -72,8 +75,19 @@ class ModusDefault {
   double sqrt_s_NN() const { return 0.; }
   /// \return The impact parameter; overwritten in ColliderModus
   double impact_parameter() const { return -1.; }
+  /// \return Weight of the event; overwritten in ColliderModus
+  double event_weight() const { return 1.; }
   /// sample impact parameter for collider modus
   void sample_impact() const {}
+  /// prepare the initial state of an event in collider modus
+  void prepare_event(int64_t, int) const {}
+  /**
+   * \return Whether the initial states are generated in advance; overwritten
+   *         in ColliderModus
+   */
+  bool pregenerates_events() const { return false; }
+  /// use the threads of the experiment in the initial conditions
+  void set_thread_pool(ThreadPool *) const {}
   /** \return The beam velocity of the projectile required in the Collider
    * modus. In the other modus, return zero. */
   double velocity_projectile() const { return 0.0; }
@@ -87,6 +101,13 @@ class ModusDefault {
   double max_timestep(double) const { return -1.; }
   /// \return equilibration time of the box; overwritten in BoxModus
   double equilibration_time() const { return -1.; }
+  /**
+   * \return When the evolution stops at the equilibrium, if it does;
+   *         overwritten in BoxModus
+   */
+  std::optional<EquilibriumCriterion> equilibrium_criterion() const {
+    return std::nullopt;
+  }
   /// \return length of the box; overwritten in BoxModus
   double length() const { return -1.; }
   /// \return radius of the sphere; overwritten in SphereModus
@@ -118,8 +139,16 @@ class ModusDefault {
    * \param[in] include_unformed_particles include unformed particles from
                                            the grid (worsens runtime, necessary
                                            for IC output)
-   * \param[in] strategy The strategy to determine the cell size \return the
-   * Grid object
+   * \param[in] strategy The strategy to determine the cell size
+   * \param[in] margin Space left free around the particles on every side of
+   *            the grid, relative to their extent, such that the grid can be
+   *            updated while they move (see Grid::update); at least one
+   *            minimal cell length if positive. Boxes have fixed boundaries
+   *            and ignore it.
+   * \param[in] extent (optional) Minimum coordinates and lengths of the
+   *            particles, if they are known already from their propagation;
+   *            otherwise they are found from \p particles. Boxes ignore it.
+   * \return the Grid object
    *
    * \see Grid::Grid
    */
@@ -127,12 +156,18 @@ class ModusDefault {
       const Particles& particles, double min_cell_length,
       double timestep_duration, CollisionCriterion crit,
       const bool include_unformed_particles,
-      CellSizeStrategy strategy = CellSizeStrategy::Optimal) const {
+      CellSizeStrategy strategy = CellSizeStrategy::Optimal,
+      double margin = 0.,
+      const std::optional<GridBase::MinAndLength> &extent =
+          std::nullopt) const {
     CellNumberLimitation limit = CellNumberLimitation::ParticleNumber;
     if (crit == CollisionCriterion::Stochastic) {
       limit = CellNumberLimitation::None;
     }
-    return {particles,
+    return {extent ? GridBase::with_margin(*extent, margin, min_cell_length)
+                   : GridBase::find_min_and_length(particles, margin,
+                                                   min_cell_length),
+            particles,
             min_cell_length,
             timestep_duration,
             limit,
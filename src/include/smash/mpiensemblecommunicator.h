@@ -0,0 +1,56 @@
+/*
+ *
+ *    Copyright (c) 2024
+ *      SMASH Team
+ *
+ *    GNU General Public License (GPLv3 or later)
+ *
+ */
+
+#ifndef SRC_INCLUDE_SMASH_MPIENSEMBLECOMMUNICATOR_H_
+#define SRC_INCLUDE_SMASH_MPIENSEMBLECOMMUNICATOR_H_
+
+#include <mpi.h>
+
+#include <cstddef>
+
+#include "ensemblecommunicator.h"
+
+namespace smash {
+
+/**
+ * Distributes the ensembles over the processes of an MPI communicator, whose
+ * lattices are summed by MPI_Allreduce.
+ *
+ * This is only built into the smash_mpi executable, see \ref
+ * smash_invocation_mpi_.
+ */
+class MpiEnsembleCommunicator : public EnsembleCommunicator {
+ public:
+  /// \param[in] comm Communicator of the processes sharing the events
+  explicit MpiEnsembleCommunicator(MPI_Comm comm);
+
+  /// \see EnsembleCommunicator::rank
+  int rank() const override { return rank_; }
+
+  /// \see EnsembleCommunicator::size
+  int size() const override { return size_; }
+
+  /// \see EnsembleCommunicator::sum
+  void sum(double *values, std::size_t n) override;
+
+  /// \see EnsembleCommunicator::combine_or
+  void combine_or(char *flags, std::size_t n) override;
+
+ private:
+  /// Communicator of the processes
+  MPI_Comm comm_;
+  /// Rank of this process
+  int rank_ = 0;
+  /// Number of processes
+  int size_ = 1;
+};
+
+}  // namespace smash
+
+#endif  // SRC_INCLUDE_SMASH_MPIENSEMBLECOMMUNICATOR_H_
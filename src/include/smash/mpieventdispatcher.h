@@ -0,0 +1,92 @@
+/*
+ *
+ *    Copyright (c) 2024
+ *      SMASH Team
+ *
+ *    GNU General Public License (GPLv3 or later)
+ *
+ */
+
+#ifndef SRC_INCLUDE_SMASH_MPIEVENTDISPATCHER_H_
+#define SRC_INCLUDE_SMASH_MPIEVENTDISPATCHER_H_
+
+#include <mpi.h>
+
+#include <cstdint>
+#include <filesystem>
+#include <vector>
+
+#include "eventdispatcher.h"
+
+namespace smash {
+
+/**
+ * Hands out the events to the processes of an MPI communicator.
+ *
+ * The number of the next event and the number of ensembles with interactions
+ * are kept in a window of the first process, which the processes update by
+ * atomic one-sided operations. No process has to wait for a dispatcher.
+ *
+ * This is only built into the smash_mpi executable, see \ref
+ * smash_invocation_mpi_.
+ */
+class MpiEventDispatcher : public EventDispatcher {
+ public:
+  /**
+   * Create the shared counters. This is collective over the communicator.
+   *
+   * \param[in] comm Communicator of the processes generating events
+   */
+  explicit MpiEventDispatcher(MPI_Comm comm);
+
+  /// Free the shared counters. This is collective over the communicator.
+  ~MpiEventDispatcher() override;
+
+  /// Cannot be copied, because it owns the window
+  MpiEventDispatcher(const MpiEventDispatcher &) = delete;
+  /// Cannot be assigned, because it owns the window
+  MpiEventDispatcher &operator=(const MpiEventDispatcher &) = delete;
+
+  /// \see EventDispatcher::take_event
+  int take_event(int nonempty_ensembles, int &nonempty_total) override;
+
+  /// \return Rank of this process
+  int rank() const { return rank_; }
+
+  /**
+   * Write which directory holds which event, as a table sorted by the events.
+   * This is collective over the communicator, the first process writes the
+   * file.
+   *
+   * \param[in] filename File to be written
+   * \param[in] events Events generated by this process
+   * \throw std::runtime_error if the file cannot be written.
+   */
+  void write_event_index(const std::filesystem::path &filename,
+                         const std::vector<int> &events) const;
+
+  /**
+   * \param[in] rank Rank of a process
+   * \return Name of the directory, in which the process writes its output
+   */
+  static std::filesystem::path directory(int rank);
+
+ private:
+  /// Communicator of the processes
+  MPI_Comm comm_;
+  /// Rank of this process
+  int rank_ = 0;
+  /// Number of processes
+  int size_ = 1;
+  /// Window of the counters
+  MPI_Win window_;
+  /**
+   * Next event and number of ensembles with interactions, only allocated in
+   * the first process
+   */
+  std::int64_t *counters_ = nullptr;
+};
+
+}  // namespace smash
+
+#endif  // SRC_INCLUDE_SMASH_MPIEVENTDISPATCHER_H_
@@ -1,5 +1,5 @@
 /*
- *    Copyright (c) 2014-2022
+ *    Copyright (c) 2014-2022,2024
  *      SMASH Team
  *
  *    GNU General Public License (GPLv3 or later)
@@ -7,8 +7,11 @@
 #ifndef SRC_INCLUDE_SMASH_NUCLEUS_H_
 #define SRC_INCLUDE_SMASH_NUCLEUS_H_
 
+#include <functional>
 #include <map>
 #include <stdexcept>
+#include <string>
+#include <utility>
 #include <vector>
 
 #include "configuration.h"
@@ -16,6 +19,7 @@
 #include "forwarddeclarations.h"
 #include "fourvector.h"
 #include "particledata.h"
+#include "random.h"
 #include "threevector.h"
 
 namespace smash {
@@ -64,6 +68,10 @@ class Nucleus {
    * 1}\f$ where \f$d\f$ is the diffusiveness_ parameter and \f$r_0\f$ is
    * nuclear_radius_.
    *
+   * The radial distribution is tabulated at the first call and whenever the
+   * radius or diffusiveness changed since, and is then sampled without
+   * rejection.
+   *
    * \return  Woods-Saxon distributed position.
    */
   virtual ThreeVector distribute_nucleon();
@@ -282,6 +290,10 @@ class Nucleus {
   double proton_radius_ = 1.2;
   /// Number of testparticles per physical particle
   size_t testparticles_ = 1;
+  /// Tabulated radial Woods-Saxon distribution
+  random::piecewise_constant_dist radial_distribution_;
+  /// Radius and diffusiveness the radial distribution was tabulated for
+  std::pair<double, double> tabulated_parameters_;
 
  protected:
   /// Particles associated with this nucleus.
@@ -297,6 +309,20 @@ class Nucleus {
    */
   void random_euler_angles();
 
+  /**
+   * Integrate the unnormalized density only once for every set of its
+   * parameters, since nuclei with the same parameters are constructed
+   * repeatedly, e.g. in scans of the deformation.
+   *
+   * \param[in] kind Name of the density distribution
+   * \param[in] parameters Parameters of the density distribution
+   * \param[in] compute Function computing the integral
+   * \return The integral over the unnormalized density [fm³]
+   */
+  static double density_integral(const std::string &kind,
+                                 const std::vector<double> &parameters,
+                                 const std::function<double()> &compute);
+
   /// Euler angel phi
   double euler_phi_;
   /// Euler angel theta
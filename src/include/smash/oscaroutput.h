@@ -69,8 +69,10 @@ class OscarOutput : public OutputInterface {
    *
    * \param[in] path Output path.
    * \param[in] name Name of the ouput.
+   * \param[in] compressed Whether the file is compressed, see RenamingFilePtr.
    */
-  OscarOutput(const std::filesystem::path &path, const std::string &name);
+  OscarOutput(const std::filesystem::path &path, const std::string &name,
+              bool compressed = false);
 
   /**
    * Writes the initial particle information of an event to the oscar output.
@@ -125,9 +127,15 @@ class OscarOutput : public OutputInterface {
    */
   void write(const Particles &particles);
 
+  /// Write the collected particle lines to the file.
+  void write_lines();
+
   /// Keep track of event number.
   int current_event_ = 0;
 
+  /// Particle lines collected before they are written at once
+  std::string lines_;
+
   /// Full filepath of the output file.
   RenamingFilePtr file_;
 };
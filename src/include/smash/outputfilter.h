@@ -0,0 +1,204 @@
+/*
+ *
+ *    Copyright (c) 2024
+ *      SMASH Team
+ *
+ *    GNU General Public License (GPLv3 or later)
+ *
+ */
+
+#ifndef SRC_INCLUDE_SMASH_OUTPUTFILTER_H_
+#define SRC_INCLUDE_SMASH_OUTPUTFILTER_H_
+
+#include <array>
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "forwarddeclarations.h"
+#include "outputinterface.h"
+#include "particles.h"
+#include "pdgcode.h"
+
+namespace smash {
+
+/**
+ * \ingroup output
+ *
+ * Selection of the particles, interactions, ensembles and events written by
+ * an output, as given in the `Filter` section of the particles and collisions
+ * outputs.
+ *
+ * Everything is selected by default. A particle is selected if its PDG code
+ * is among the given ones and its rapidity, pseudorapidity and transverse
+ * momentum are within the given ranges. An interaction is selected if its
+ * process type is among the given ones and at least one of its incoming or
+ * outgoing particles is selected.
+ */
+class OutputFilter {
+ public:
+  /// Create a filter selecting everything.
+  OutputFilter() = default;
+
+  /**
+   * Create a filter from the `Filter` section of an output.
+   *
+   * \param[in] conf The `Filter` section, which is taken completely
+   * \throw std::invalid_argument if a range is empty or the event interval
+   *        is not positive.
+   */
+  explicit OutputFilter(Configuration conf);
+
+  /// \return whether anything is filtered out
+  bool is_active() const;
+
+  /// \return whether the particles are filtered by type or momentum
+  bool filters_particles() const {
+    return !pdg_codes_.empty() || cuts_momentum_;
+  }
+
+  /**
+   * \param[in] event Number of the event
+   * \return whether the event is written
+   */
+  bool selects_event(int event) const { return event % every_nth_event_ == 0; }
+
+  /**
+   * \param[in] ensemble Index of the ensemble within its event
+   * \return whether the ensemble is written
+   */
+  bool selects_ensemble(int ensemble) const;
+
+  /// \return whether \p p is written
+  bool selects(const ParticleData &p) const;
+
+  /// \return whether \p action is written
+  bool selects(const Action &action) const;
+
+ private:
+  /// PDG codes of the selected particles, sorted; all if empty
+  std::vector<PdgCode> pdg_codes_;
+  /// Whether the momenta are restricted at all
+  bool cuts_momentum_ = false;
+  /// Range of the rapidity
+  std::array<double, 2> rapidity_ = {-1e300, 1e300};
+  /// Range of the pseudorapidity
+  std::array<double, 2> pseudorapidity_ = {-1e300, 1e300};
+  /// Range of the transverse momentum [GeV]
+  std::array<double, 2> transverse_momentum_ = {-1e300, 1e300};
+  /// Process types of the selected interactions, sorted; all if empty
+  std::vector<int> process_types_;
+  /// Indices of the selected ensembles, sorted; all if empty
+  std::vector<int> ensembles_;
+  /// Only every this many events are written
+  int every_nth_event_ = 1;
+};
+
+/**
+ * \ingroup output
+ *
+ * Output that passes only what an OutputFilter selects to another output.
+ *
+ * The filter is applied before the other output formats or copies anything,
+ * such that unwanted particles and interactions cost neither time nor disk
+ * space. The particle lists are copied into buffers of this output, keeping
+ * the ids of the particles.
+ *
+ * Every ensemble is passed as an event of its own, which tells its index.
+ * The particles at intermediate times do not tell it, so the ensembles are
+ * counted in the order the experiment passes them. Interactions do not tell
+ * their ensemble either and are written for every ensemble.
+ */
+class FilteredOutput : public OutputInterface {
+ public:
+  /**
+   * \param[in] target Output, which the selection is passed to. It is a
+   *            particles or collisions output.
+   * \param[in] filter What is passed on
+   * \param[in] n_ensembles Number of ensembles of every event
+   */
+  FilteredOutput(OutputPtr target, const OutputFilter &filter,
+                 int n_ensembles);
+
+  void at_eventstart(const Particles &particles, const int event_number,
+                     const EventInfo &info) override;
+  void at_eventstart(const std::vector<Particles> &ensembles,
+                     int event_number) override;
+  void at_eventstart(const int event_number, const ThermodynamicQuantity tq,
+                     const DensityType dens_type,
+                     RectangularLattice<DensityOnLattice> lattice) override;
+  void at_eventstart(const int event_number, const ThermodynamicQuantity tq,
+                     const DensityType dens_type,
+                     RectangularLattice<EnergyMomentumTensor> lattice) override;
+  void at_eventend(const int event_number, const ThermodynamicQuantity tq,
+                   const DensityType dens_type) override;
+  void at_eventend(const ThermodynamicQuantity tq) override;
+  void at_eventend(const Particles &particles, const int event_number,
+                   const EventInfo &info) override;
+  void at_eventend(const std::vector<Particles> &ensembles,
+                   const int event_number) override;
+  void at_runend() override;
+  void at_interaction(const Action &action, const double density) override;
+  void at_intermediate_time(const Particles &particles,
+                            const std::unique_ptr<Clock> &clock,
+                            const DensityParameters &dens_param,
+                            const EventInfo &info) override;
+  void at_intermediate_time(const std::vector<Particles> &ensembles,
+                            const std::unique_ptr<Clock> &clock,
+                            const DensityParameters &dens_param) override;
+  void thermodynamics_output(
+      const ThermodynamicQuantity tq, const DensityType dens_type,
+      RectangularLattice<DensityOnLattice> &lattice) override;
+  void thermodynamics_output(
+      const ThermodynamicQuantity tq, const DensityType dens_type,
+      RectangularLattice<EnergyMomentumTensor> &lattice) override;
+  void thermodynamics_lattice_output(
+      RectangularLattice<DensityOnLattice> &lattice,
+      const double current_time) override;
+  void thermodynamics_lattice_output(
+      RectangularLattice<DensityOnLattice> &lattice, const double current_time,
+      const std::vector<Particles> &ensembles,
+      const DensityParameters &dens_param) override;
+  void thermodynamics_lattice_output(
+      const ThermodynamicQuantity tq,
+      RectangularLattice<EnergyMomentumTensor> &lattice,
+      const double current_time) override;
+  void thermodynamics_output(const GrandCanThermalizer &gct) override;
+  void fields_output(const std::string name1, const std::string name2,
+                     ForceLattice &lattice) override;
+  std::size_t buffer_size() const override;
+
+ private:
+  /**
+   * \param[in] particles Particles of one ensemble
+   * \return The selected particles, which may be \p particles itself.
+   */
+  const Particles &select(const Particles &particles);
+
+  /**
+   * \param[in] ensembles All ensembles of an event
+   * \return The selected particles of the selected ensembles, which may be
+   *         \p ensembles itself.
+   */
+  const std::vector<Particles> &select(const std::vector<Particles> &ensembles);
+
+  /// Output the selection is passed to
+  OutputPtr target_;
+  /// What is passed on
+  const OutputFilter filter_;
+  /// Number of ensembles of every event
+  const int n_ensembles_;
+  /// Whether the current event is written
+  bool event_selected_ = true;
+  /// Index of the ensemble at the next intermediate time
+  int next_ensemble_ = 0;
+  /// Buffer of the selected particles of one ensemble
+  Particles selected_;
+  /// Buffer of the selected ensembles
+  std::vector<Particles> selected_ensembles_;
+};
+
+}  // namespace smash
+
+#endif  // SRC_INCLUDE_SMASH_OUTPUTFILTER_H_
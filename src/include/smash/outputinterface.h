@@ -1,6 +1,6 @@
 /*
  *
- *    Copyright (c) 2014-2023
+ *    Copyright (c) 2014-2024
  *      SMASH Team
  *
  *    GNU General Public License (GPLv3 or later)
@@ -56,6 +56,11 @@ struct EventInfo {
   bool empty_event;
   /// Whether or not kinematic cuts are employed for SMASH IC
   bool impose_kinematic_cut_for_SMASH_IC;
+  /**
+   * Weight of the event, which is not 1 only for weighted impact parameters,
+   * see \ref key_MC_impact_weighted_
+   */
+  double event_weight = 1.0;
 };
 
 /**
@@ -80,6 +85,11 @@ struct EventInfo {
  * and then different methods are called on all array entries (some will do what
  * has to be done, but most will just do nothing).
  *
+ * The particles are passed as references to the storage of the experiment, or
+ * of the action in at_interaction, which are only valid during the call. The
+ * outputs read them in place instead of copying them, and data shared by all
+ * particles of a type, like the PDG code string, is taken from the type.
+ *
  * \note The parameters of most methods in this base class are not documented,
  * as irrelevant for the empty implementation. However, every child class which
  * overrides some methods documents them in detail. Refer to them for further
@@ -153,6 +163,9 @@ class OutputInterface {
    */
   virtual void at_eventend(const std::vector<Particles> &, const int) {}
 
+  /// Output launched once after the last event of the run.
+  virtual void at_runend() {}
+
   /**
    * Called whenever an action modified one or more particles.
    */
@@ -222,9 +235,8 @@ class OutputInterface {
    * Write fields in vtk output
    * Fields are a pair of threevectors for example electric and magnetic field
    */
-  virtual void fields_output(
-      const std::string, const std::string,
-      RectangularLattice<std::pair<ThreeVector, ThreeVector>> &) {}
+  virtual void fields_output(const std::string, const std::string,
+                             ForceLattice &) {}
 
   /// Get, whether this is the dilepton output?
   bool is_dilepton_output() const { return is_dilepton_output_; }
@@ -235,6 +247,9 @@ class OutputInterface {
   /// Get, whether this is the IC output?
   bool is_IC_output() const { return is_IC_output_; }
 
+  /// \return Memory allocated for buffers of the output [bytes]
+  virtual std::size_t buffer_size() const { return 0; }
+
   /**
    * Convert thermodynamic quantities to strings.
    * \param[in] tq Enum value of the thermodynamic quantity.
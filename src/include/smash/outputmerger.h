@@ -0,0 +1,214 @@
+/*
+ *
+ *    Copyright (c) 2024
+ *      SMASH Team
+ *
+ *    GNU General Public License (GPLv3 or later)
+ *
+ */
+
+#ifndef SRC_INCLUDE_SMASH_OUTPUTMERGER_H_
+#define SRC_INCLUDE_SMASH_OUTPUTMERGER_H_
+
+#include <atomic>
+#include <climits>
+#include <cstddef>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "forwarddeclarations.h"
+#include "outputinterface.h"
+
+namespace smash {
+
+/**
+ * \ingroup output
+ *
+ * Output that keeps everything passed to it in memory, such that it can be
+ * written later to the actual output it stands in for.
+ *
+ * This is used by the event workers of an Experiment: They generate events
+ * concurrently, but the output files have to contain the events in order.
+ * All arguments are copied, hence a DeferredOutput does not depend on the
+ * state of the experiment after the call. The particles are copied once per
+ * state and the copy is shared by all outputs, see Particles::snapshot.
+ */
+class DeferredOutput : public OutputInterface {
+ public:
+  /// A recorded call to an output
+  using Call = std::function<void(OutputInterface &)>;
+
+  /**
+   * Create a deferred output for the given output.
+   *
+   * \param[in] target Output, whose kind (e.g. dilepton or photon output) is
+   *            taken over, such that actions report to the same outputs.
+   */
+  explicit DeferredOutput(const OutputInterface &target);
+
+  void at_eventstart(const Particles &particles, const int event_number,
+                     const EventInfo &info) override;
+  void at_eventstart(const std::vector<Particles> &ensembles,
+                     int event_number) override;
+  void at_eventstart(const int event_number, const ThermodynamicQuantity tq,
+                     const DensityType dens_type,
+                     RectangularLattice<DensityOnLattice> lattice) override;
+  void at_eventstart(const int event_number, const ThermodynamicQuantity tq,
+                     const DensityType dens_type,
+                     RectangularLattice<EnergyMomentumTensor> lattice) override;
+  void at_eventend(const int event_number, const ThermodynamicQuantity tq,
+                   const DensityType dens_type) override;
+  void at_eventend(const ThermodynamicQuantity tq) override;
+  void at_eventend(const Particles &particles, const int event_number,
+                   const EventInfo &info) override;
+  void at_eventend(const std::vector<Particles> &ensembles,
+                   const int event_number) override;
+  void at_runend() override;
+  void at_interaction(const Action &action, const double density) override;
+  void at_intermediate_time(const Particles &particles,
+                            const std::unique_ptr<Clock> &clock,
+                            const DensityParameters &dens_param,
+                            const EventInfo &info) override;
+  void at_intermediate_time(const std::vector<Particles> &ensembles,
+                            const std::unique_ptr<Clock> &clock,
+                            const DensityParameters &dens_param) override;
+  void thermodynamics_output(
+      const ThermodynamicQuantity tq, const DensityType dens_type,
+      RectangularLattice<DensityOnLattice> &lattice) override;
+  void thermodynamics_output(
+      const ThermodynamicQuantity tq, const DensityType dens_type,
+      RectangularLattice<EnergyMomentumTensor> &lattice) override;
+  void thermodynamics_lattice_output(
+      RectangularLattice<DensityOnLattice> &lattice,
+      const double current_time) override;
+  void thermodynamics_lattice_output(
+      RectangularLattice<DensityOnLattice> &lattice, const double current_time,
+      const std::vector<Particles> &ensembles,
+      const DensityParameters &dens_param) override;
+  void thermodynamics_lattice_output(
+      const ThermodynamicQuantity tq,
+      RectangularLattice<EnergyMomentumTensor> &lattice,
+      const double current_time) override;
+  /**
+   * The thermalizer cannot be kept for later.
+   * \throw std::logic_error always
+   */
+  void thermodynamics_output(const GrandCanThermalizer &gct) override;
+  void fields_output(const std::string name1, const std::string name2,
+                     ForceLattice &lattice) override;
+
+  /// \return All calls recorded so far. Afterwards, none are recorded.
+  std::vector<Call> take_calls();
+
+ protected:
+  /**
+   * Keep a call, which is given the output to be written to later.
+   *
+   * \param[in] call Call with copies of all arguments
+   */
+  virtual void record(Call call);
+
+ private:
+  /// Calls recorded since the last take_calls
+  std::vector<Call> calls_;
+};
+
+/**
+ * \ingroup output
+ *
+ * Writes the output of events, which were generated concurrently, in the order
+ * of their event number.
+ *
+ * The merger owns the actual outputs of the experiment. Every event worker
+ * writes to its own set of DeferredOutput objects (see make_deferred_output)
+ * and submits them once an event is done. Events are kept until all events
+ * with a smaller number have been written, such that the output is the same
+ * as if the events were generated one after another.
+ */
+class OutputMerger {
+ public:
+  /**
+   * Create a merger writing to the given outputs.
+   *
+   * \param[in] outputs The outputs which are finally written to.
+   */
+  explicit OutputMerger(OutputsList &&outputs);
+
+  /**
+   * \param[in] index Index of the output as given in the constructor.
+   * \return A DeferredOutput standing in for the output with the given index.
+   */
+  OutputPtr make_deferred_output(std::size_t index) const;
+
+  /// \return A list of DeferredOutput objects for all outputs.
+  OutputsList make_deferred_outputs() const;
+
+  /**
+   * Hand over the output of an event and write all events that are complete.
+   *
+   * \param[in] event Number of the event
+   * \param[in] deferred_outputs Outputs the event has been written to. They
+   *            have to be created by make_deferred_outputs.
+   * \param[in] bookkeeping Called right before the event is written, in the
+   *            order of the events. It may stop the output by calling
+   *            set_last_event.
+   */
+  void submit(int event, const OutputsList &deferred_outputs,
+              std::function<void()> bookkeeping = {});
+
+  /**
+   * Do not write any event with a larger number than \p event. Events which
+   * are still missing are not waited for, events with a larger number, which
+   * were already submitted, are dropped.
+   *
+   * This may be called from any thread, also from the bookkeeping passed to
+   * submit.
+   *
+   * \param[in] event Number of the last event to be written
+   */
+  void set_last_event(int event);
+
+  /**
+   * \param[in] event Number of an event
+   * \return Whether the event would still be written.
+   */
+  bool accepts(int event) const;
+
+  /// \return Number of events which were written.
+  int written_events() const;
+
+ private:
+  /// Everything needed to write one event later
+  struct PendingEvent {
+    /// Calls for every output
+    std::vector<std::vector<DeferredOutput::Call>> calls;
+    /// Bookkeeping before writing
+    std::function<void()> bookkeeping;
+  };
+
+  /// Write all events that are complete, while holding the mutex.
+  void write_pending();
+
+  /// The actual outputs
+  OutputsList outputs_;
+
+  /// Guards pending_ and next_event_
+  mutable std::mutex mutex_;
+
+  /// Events that cannot be written yet, ordered by event number
+  std::map<int, PendingEvent> pending_;
+
+  /// Number of the next event to be written
+  int next_event_ = 0;
+
+  /// Number of the last event to be written
+  std::atomic<int> last_event_{INT_MAX};
+};
+
+}  // namespace smash
+
+#endif  // SRC_INCLUDE_SMASH_OUTPUTMERGER_H_
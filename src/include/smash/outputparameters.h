@@ -1,5 +1,5 @@
 /*
- *    Copyright (c) 2017-2023
+ *    Copyright (c) 2017-2024
  *      SMASH Team
  *
  *    GNU General Public License (GPLv3 or later)
@@ -7,8 +7,10 @@
 #ifndef SRC_INCLUDE_SMASH_OUTPUTPARAMETERS_H_
 #define SRC_INCLUDE_SMASH_OUTPUTPARAMETERS_H_
 
+#include <array>
 #include <map>
 #include <set>
+#include <stdexcept>
 #include <string>
 #include <vector>
 
@@ -17,6 +19,7 @@
 #include "density.h"
 #include "forwarddeclarations.h"
 #include "logging.h"
+#include "outputfilter.h"
 
 namespace smash {
 static constexpr int LExperiment = LogArea::Experiment::id;
@@ -50,10 +53,57 @@ struct RivetOutputParameters {
   std::optional<bool> no_multi_weight{std::nullopt};
   /// Whether Rivet should ignore beams
   bool ignore_beams{true};
+  /// Number of threads running the analyses, 0 to run them in the caller
+  int analysis_threads{0};
   /// Whether any weight parameter was specified
   bool any_weight_parameter_was_given{false};
 };
 
+/**
+ * Helper structure for OutputParameters in order to store and hand over the
+ * settings of the ROOT output files. OutputParameters has one member of this
+ * type.
+ */
+struct RootOutputParameters {
+  /// Size of the baskets of every branch in bytes
+  int basket_size{32000};
+  /**
+   * Number of entries (if positive) or bytes (if negative) after which the
+   * baskets are flushed to the file
+   */
+  int auto_flush{-30000000};
+  /// Compression settings encoded by ROOT as 100 * algorithm + level
+  int compression_settings{101};
+  /// Number of threads ROOT uses to compress the baskets, 0 to disable them
+  int implicit_mt_threads{0};
+  /// Whether the trees are filled in a writer thread
+  bool writer_thread{false};
+};
+
+/**
+ * Helper structure for OutputParameters in order to store and hand over the
+ * settings of the histogram output. OutputParameters has one member of this
+ * type.
+ */
+struct HistogramOutputParameters {
+  /// Names of the histogrammed quantities
+  std::vector<std::string> quantities{"Rapidity", "Transverse_Momentum"};
+  /// PDG codes of the histogrammed particles, all if empty
+  std::vector<PdgCode> pdg_codes{};
+  /// Number of rapidity bins
+  int rapidity_bins{40};
+  /// Rapidity range of the bins and of the transverse momentum spectra
+  std::array<double, 2> rapidity_range{{-4., 4.}};
+  /// Number of transverse momentum bins
+  int transverse_momentum_bins{30};
+  /// Transverse momentum range of the bins [GeV]
+  std::array<double, 2> transverse_momentum_range{{0., 3.}};
+  /// Number of time bins of the interaction rate
+  int time_bins{100};
+  /// Time range of the interaction rate [fm]
+  std::array<double, 2> time_range{{0., 100.}};
+};
+
 /**
  * Helper structure for Experiment to hold output options and parameters.
  * Experiment has one member of this struct.
@@ -70,14 +120,25 @@ struct OutputParameters {
         td_jQBS(false),
         td_smearing(true),
         td_only_participants(false),
+        td_single_precision(false),
+        td_variance(false),
         part_extended(false),
         part_only_final(OutputOnlyFinal::Yes),
+        part_shards(1),
+        part_single_precision(false),
         coll_extended(false),
         coll_printstartend(false),
         dil_extended(false),
         photons_extended(false),
         ic_extended(false),
-        rivet_parameters{} {}
+        compress_files(false),
+        binary_event_index(false),
+        thread_pool(nullptr),
+        root_parameters{},
+        rivet_parameters{},
+        part_filter{},
+        coll_filter{},
+        histogram_parameters{} {}
 
   /// Constructor from configuration
   explicit OutputParameters(Configuration conf) : OutputParameters() {
@@ -104,17 +165,56 @@ struct OutputParameters {
       }
       td_smearing = thermo_conf.take({"Smearing"}, true);
       td_only_participants = thermo_conf.take({"Only_Participants"}, false);
+      td_single_precision = thermo_conf.take({"Single_Precision"}, false);
+      td_variance = thermo_conf.take({"Variance"}, false);
     }
 
     if (conf.has_value({"Particles"})) {
       part_extended = conf.take({"Particles", "Extended"}, false);
       part_only_final =
           conf.take({"Particles", "Only_Final"}, OutputOnlyFinal::Yes);
+      part_shards = conf.take({"Particles", "Shards"}, 1);
+      if (part_shards < 1) {
+        throw std::invalid_argument(
+            "The particles output needs at least one shard.");
+      }
+      part_single_precision =
+          conf.take({"Particles", "Single_Precision"}, false);
+      if (conf.has_value({"Particles", "Filter"})) {
+        part_filter = OutputFilter(
+            conf.extract_sub_configuration({"Particles", "Filter"}));
+      }
     }
 
     if (conf.has_value({"Collisions"})) {
       coll_extended = conf.take({"Collisions", "Extended"}, false);
       coll_printstartend = conf.take({"Collisions", "Print_Start_End"}, false);
+      if (conf.has_value({"Collisions", "Filter"})) {
+        coll_filter = OutputFilter(
+            conf.extract_sub_configuration({"Collisions", "Filter"}));
+      }
+    }
+
+    if (conf.has_value({"Histograms"})) {
+      const HistogramOutputParameters defaults;
+      HistogramOutputParameters &hist = histogram_parameters;
+      hist.quantities =
+          conf.take({"Histograms", "Quantities"}, defaults.quantities);
+      hist.pdg_codes = conf.take({"Histograms", "PDG"}, defaults.pdg_codes);
+      hist.rapidity_bins =
+          conf.take({"Histograms", "Rapidity_Bins"}, defaults.rapidity_bins);
+      hist.rapidity_range =
+          conf.take({"Histograms", "Rapidity_Range"}, defaults.rapidity_range);
+      hist.transverse_momentum_bins =
+          conf.take({"Histograms", "Transverse_Momentum_Bins"},
+                    defaults.transverse_momentum_bins);
+      hist.transverse_momentum_range =
+          conf.take({"Histograms", "Transverse_Momentum_Range"},
+                    defaults.transverse_momentum_range);
+      hist.time_bins =
+          conf.take({"Histograms", "Time_Bins"}, defaults.time_bins);
+      hist.time_range =
+          conf.take({"Histograms", "Time_Range"}, defaults.time_range);
     }
 
     if (conf.has_value({"Dileptons"})) {
@@ -171,6 +271,8 @@ struct OutputParameters {
             rivet_conf.take({"Cross_Section"}));
       }
       rivet_parameters.ignore_beams = rivet_conf.take({"Ignore_Beams"}, true);
+      rivet_parameters.analysis_threads =
+          rivet_conf.take({"Analysis_Threads"}, 0);
       if (rivet_conf.has_value({"Weights"})) {
         rivet_parameters.any_weight_parameter_was_given = true;
         if (rivet_conf.has_value({"Weights", "Select"})) {
@@ -258,12 +360,24 @@ struct OutputParameters {
    */
   bool td_only_participants;
 
+  /// Store the lattice values of the chunked format in single precision
+  bool td_single_precision;
+
+  /// Write the variance over the events besides the averaged lattice values
+  bool td_variance;
+
   /// Extended format for particles output
   bool part_extended;
 
   /// Print only final particles in event
   OutputOnlyFinal part_only_final;
 
+  /// Number of shards the particles output is split into
+  int part_shards;
+
+  /// Write the real columns of the columnar particles output as floats
+  bool part_single_precision;
+
   /// Extended format for collisions output
   bool coll_extended;
 
@@ -279,8 +393,30 @@ struct OutputParameters {
   /// Extended initial conditions output
   bool ic_extended;
 
+  /// Compress the Oscar and binary output files
+  bool compress_files;
+
+  /// Append an index of the events to the binary particles and collisions files
+  bool binary_event_index;
+
+  /// Threads of the experiment an output may use to compute its values, null
+  /// for a single thread
+  ThreadPool *thread_pool;
+
+  /// ROOT specific parameters
+  RootOutputParameters root_parameters;
+
   /// Rivet specfic parameters
   RivetOutputParameters rivet_parameters;
+
+  /// Selection written by the particles output
+  OutputFilter part_filter;
+
+  /// Selection written by the collisions output
+  OutputFilter coll_filter;
+
+  /// Histogram specific parameters
+  HistogramOutputParameters histogram_parameters;
 };
 
 }  // namespace smash
@@ -9,9 +9,11 @@
 #ifndef SRC_INCLUDE_SMASH_PARAMETRIZATIONS_H_
 #define SRC_INCLUDE_SMASH_PARAMETRIZATIONS_H_
 
+#include <cstddef>
 #include <unordered_map>
 #include <utility>
 
+#include "interpolation.h"
 #include "particletype.h"
 
 /* All quantities in this file use they same units as the rest of SMASH.
@@ -29,6 +31,72 @@ namespace smash {
  * \return Whether the parametrization exists
  */
 bool parametrization_exists(const PdgCode& pdg_a, const PdgCode& pdg_b);
+
+/**
+ * Interpolations of the experimental data, on which the parametrizations are
+ * based.
+ *
+ * All interpolations are built once, when the program starts, and are only
+ * read afterwards, such that they are shared by all threads. Each
+ * interpolation can also be evaluated for several arguments at once with its
+ * evaluate() function, which is faster for ascending arguments. The data are
+ * smoothed with the LOWESS algorithm and cross sections given more than once
+ * for one argument are averaged, except for the resonance contributions.
+ */
+class ParametrizationTables {
+ public:
+  /// \return The interpolations, which are built when the program starts
+  static const ParametrizationTables& get() { return instance_; }
+
+  /// Cannot be copied, there is only one instance
+  ParametrizationTables(const ParametrizationTables&) = delete;
+  /// Cannot be copied, there is only one instance
+  ParametrizationTables& operator=(const ParametrizationTables&) = delete;
+
+  /// pi+ pi- total cross section as a function of sqrt(s)
+  const InterpolateDataLinear<double> pipluspiminus_total;
+  /// pi0 pi0 total cross section as a function of sqrt(s)
+  const InterpolateDataLinear<double> pizeropizero_total;
+  /// pi+ p total cross section as a function of sqrt(s)
+  const InterpolateDataLinear<double> piplusp_total;
+  /// pi+ p elastic cross section as a function of p_lab
+  const InterpolateDataLinear<double> piplusp_elastic;
+  /// pi+ p elastic contribution of resonances as a function of s
+  const InterpolateDataSpline piplusp_elastic_res;
+  /// pi+ p -> Sigma+ K+ cross section as a function of p_lab
+  const InterpolateDataLinear<double> piplusp_sigmapluskplus;
+  /// pi- p total cross section as a function of sqrt(s)
+  const InterpolateDataLinear<double> piminusp_total;
+  /// pi- p elastic cross section as a function of p_lab
+  const InterpolateDataLinear<double> piminusp_elastic;
+  /// pi- p elastic contribution of resonances as a function of s
+  const InterpolateDataSpline piminusp_elastic_res;
+  /// pi- p -> Lambda K0 cross section as a function of p_lab
+  const InterpolateDataLinear<double> piminusp_lambdak0;
+  /// pi- p -> Sigma- K+ cross section as a function of p_lab
+  const InterpolateDataLinear<double> piminusp_sigmaminuskplus;
+  /// pi- p -> Sigma0 K0 resonance contribution as a function of sqrt(s)
+  const InterpolateDataLinear<double> piminusp_sigma0k0;
+  /// K+ p total cross section as a function of p_lab
+  const InterpolateDataLinear<double> kplusp_total;
+  /// K+ n total cross section as a function of p_lab
+  const InterpolateDataLinear<double> kplusn_total;
+  /// K- p total cross section as a function of p_lab
+  const InterpolateDataLinear<double> kminusp_total;
+  /// K- n total cross section as a function of p_lab
+  const InterpolateDataLinear<double> kminusn_total;
+  /// K- p elastic cross section as a function of p_lab
+  const InterpolateDataLinear<double> kminusp_elastic;
+  /// K- p elastic contribution of resonances as a function of p_lab
+  const InterpolateDataSpline kminusp_elastic_res;
+
+ private:
+  /// Build all interpolations from the data.
+  ParametrizationTables();
+
+  /// The only instance
+  static const ParametrizationTables instance_;
+};
 /**
  * total hadronic cross sections at high energies parametrized in the 2016 PDG
  * book(http://pdg.lbl.gov/2016/reviews/rpp2016-rev-cross-section-plots.pdf)
@@ -570,7 +638,7 @@ class KaonNucleonRatios {
                    const ParticleType& c, const ParticleType& d) const;
 };
 
-extern /*thread_local (see #3075)*/ KaonNucleonRatios kaon_nucleon_ratios;
+extern thread_local KaonNucleonRatios kaon_nucleon_ratios;
 
 /**
  * K- p <-> Kbar0 n cross section parametrization.
@@ -787,6 +855,59 @@ double sigmaplussigmaminus_ximinusp(double sqrts_sqrts0);
  */
 double sigmaplussigmaminus_xi0n(double sqrts_sqrts0);
 
+/**
+ * @name Batch evaluation of parametrizations
+ *
+ * Evaluate a parametrization for many arguments at once, e.g. for many pairs
+ * of the same types or for a table in the center-of-mass energy. The values
+ * equal those of the corresponding function for a single argument. The
+ * functions based on interpolated data search the data for neighbouring
+ * arguments quickly and are hence faster for ascending arguments; the others
+ * evaluate the single-argument function in a loop, which the compiler can
+ * inline and vectorize.
+ *
+ * The arguments are Mandelstam s [GeV^2] or the center-of-mass energy [GeV],
+ * like for the single argument. The cross sections [mb] are written to an
+ * array of the same length, which must not overlap with the arguments.
+ */
+///@{
+/// \see pp_elastic(double)
+void pp_elastic(const double* mandelstam_s, std::size_t n, double* xs);
+/// \see pp_total(double)
+void pp_total(const double* mandelstam_s, std::size_t n, double* xs);
+/// \see np_elastic(double)
+void np_elastic(const double* mandelstam_s, std::size_t n, double* xs);
+/// \see np_total(double)
+void np_total(const double* mandelstam_s, std::size_t n, double* xs);
+/// \see ppbar_elastic(double)
+void ppbar_elastic(const double* mandelstam_s, std::size_t n, double* xs);
+/// \see ppbar_total(double)
+void ppbar_total(const double* mandelstam_s, std::size_t n, double* xs);
+/// \see piplusp_elastic(double)
+void piplusp_elastic(const double* mandelstam_s, std::size_t n, double* xs);
+/// \see piminusp_elastic(double)
+void piminusp_elastic(const double* mandelstam_s, std::size_t n, double* xs);
+/// \see piminusp_high_energy(double)
+void piminusp_high_energy(const double* mandelstam_s, std::size_t n,
+                          double* xs);
+/// \see piplusp_total(double)
+void piplusp_total(const double* sqrts, std::size_t n, double* xs);
+/// \see piminusp_total(double)
+void piminusp_total(const double* sqrts, std::size_t n, double* xs);
+/// \see pipluspiminus_total(double)
+void pipluspiminus_total(const double* sqrts, std::size_t n, double* xs);
+/// \see pizeropizero_total(double)
+void pizeropizero_total(const double* sqrts, std::size_t n, double* xs);
+/// \see kplusp_total(double)
+void kplusp_total(const double* mandelstam_s, std::size_t n, double* xs);
+/// \see kplusn_total(double)
+void kplusn_total(const double* mandelstam_s, std::size_t n, double* xs);
+/// \see kminusp_total(double)
+void kminusp_total(const double* mandelstam_s, std::size_t n, double* xs);
+/// \see kminusn_total(double)
+void kminusn_total(const double* mandelstam_s, std::size_t n, double* xs);
+///@}
+
 }  // namespace smash
 
 #endif  // SRC_INCLUDE_SMASH_PARAMETRIZATIONS_H_
@@ -0,0 +1,87 @@
+/*
+ *
+ *    Copyright (c) 2024
+ *      SMASH Team
+ *
+ *    GNU General Public License (GPLv3 or later)
+ *
+ */
+
+#ifndef SRC_INCLUDE_SMASH_PARTICLECELLLIST_H_
+#define SRC_INCLUDE_SMASH_PARTICLECELLLIST_H_
+
+#include <array>
+#include <vector>
+
+#include "forwarddeclarations.h"
+#include "threevector.h"
+
+namespace smash {
+
+/**
+ * \ingroup data
+ *
+ * Particles of a list sorted into cells of at least a given side length, to
+ * find the particles close to a point without looking at all of them.
+ *
+ * The densities from which the potentials are calculated without a lattice
+ * only get contributions from particles closer than the cut-off radius of
+ * the Gaussian smearing. With cells at least as large as the cut-off, these
+ * particles lie in the cell of the point or in one of its 26 neighbours.
+ *
+ * The cell list refers to the particle list it was built from, which has to
+ * outlive it and must not change in between. It is meant to be built once
+ * per time step.
+ */
+class ParticleCellList {
+ public:
+  /**
+   * Sort the particles into cells.
+   *
+   * \param[in] plist Particles to be sorted, not copied
+   * \param[in] r_cut Minimal side length of the cells [fm]
+   */
+  ParticleCellList(const ParticleList &plist, double r_cut);
+
+  /// \return The particles the cell list was built from
+  const ParticleList &particles() const { return *plist_; }
+
+  /**
+   * Find the particles in the cell of a point and in its neighbours, which
+   * includes all particles closer than r_cut to it.
+   *
+   * \param[in] r Position of the point [fm]
+   * \param[out] neighbors Particles close to the point, in the order of the
+   *             particle list
+   */
+  void find_neighbors(const ThreeVector &r,
+                      std::vector<const ParticleData *> &neighbors) const;
+
+ private:
+  /**
+   * \param[in] axis Direction
+   * \param[in] x Coordinate in this direction [fm]
+   * \return Index of the cell in this direction, not restricted to the cells
+   */
+  int cell_coordinate(int axis, double x) const;
+
+  /// Particles sorted into the cells
+  const ParticleList *plist_;
+  /// Lower corner of the cells [fm]
+  std::array<double, 3> lower_corner_ = {0., 0., 0.};
+  /// Inverse side lengths of the cells [1/fm]
+  std::array<double, 3> inv_cell_length_ = {0., 0., 0.};
+  /// Number of cells in x, y and z direction
+  std::array<int, 3> n_cells_ = {1, 1, 1};
+  /**
+   * Position of the first particle of every cell in particle_index_, with x
+   * being the fastest index, followed by the total number of particles
+   */
+  std::vector<int> cell_start_;
+  /// Indices of the particles in the list, sorted by cells
+  std::vector<int> particle_index_;
+};
+
+}  // namespace smash
+
+#endif  // SRC_INCLUDE_SMASH_PARTICLECELLLIST_H_
@@ -134,9 +134,9 @@ class ParticleData {
   uint32_t id_process() const { return history_.id_process; }
   /**
    * Get history information
-   * \return particle history struct
+   * \return particle history struct, which is not copied
    */
-  HistoryData get_history() const { return history_; }
+  const HistoryData &get_history() const { return history_; }
   /**
    * Store history information
    *
@@ -163,6 +163,7 @@ class ParticleData {
    */
   void set_4momentum(const FourVector &momentum_vector) {
     momentum_ = momentum_vector;
+    decay_time_ = std::numeric_limits<double>::quiet_NaN();
   }
 
   /**
@@ -173,6 +174,7 @@ class ParticleData {
    */
   void set_4momentum(double mass, const ThreeVector &mom) {
     momentum_ = FourVector(std::sqrt(mass * mass + mom * mom), mom);
+    decay_time_ = std::numeric_limits<double>::quiet_NaN();
   }
 
   /**
@@ -186,6 +188,7 @@ class ParticleData {
   void set_4momentum(double mass, double px, double py, double pz) {
     momentum_ = FourVector(std::sqrt(mass * mass + px * px + py * py + pz * pz),
                            px, py, pz);
+    decay_time_ = std::numeric_limits<double>::quiet_NaN();
   }
   /**
    * Set the momentum of the particle without modifying the energy.
@@ -195,8 +198,25 @@ class ParticleData {
    */
   void set_3momentum(const ThreeVector &mom) {
     momentum_ = FourVector(momentum_.x0(), mom);
+    decay_time_ = std::numeric_limits<double>::quiet_NaN();
   }
 
+  /**
+   * Get the time at which the particle decays, unless its momentum changes
+   * before. It is sampled by the DecayActionsFinder when the particle is
+   * searched for decays for the first time, and reset when the momentum is
+   * set.
+   * \return absolute decay time [fm], NaN if it is not sampled yet
+   */
+  double decay_time() const { return decay_time_; }
+
+  /**
+   * Store the sampled decay time. It only caches a property of the particle,
+   * hence it can be set for const particles.
+   * \param[in] time absolute decay time [fm]
+   */
+  void set_decay_time(double time) const { decay_time_ = time; }
+
   /**
    * Get the particle's position in Minkowski space
    * \return particle's position 4-vector
@@ -321,8 +341,9 @@ class ParticleData {
    * \param[in] v boost 3-velocity
    */
   void boost(const ThreeVector &v) {
-    set_4momentum(momentum_.lorentz_boost(v));
-    set_4position(position_.lorentz_boost(v));
+    const LorentzBoost boost(v);
+    set_4momentum(boost(momentum_));
+    set_4position(boost(position_));
   }
 
   /**
@@ -333,6 +354,15 @@ class ParticleData {
     set_4momentum(momentum_.lorentz_boost(v));
   }
 
+  /**
+   * Apply a Lorentz-boost to only the momentum, whose factors are computed
+   * once for many particles.
+   * \param[in] boost Lorentz boost
+   */
+  void boost_momentum(const LorentzBoost &boost) {
+    set_4momentum(boost(momentum_));
+  }
+
   /// Setter for belongs_to label
   void set_belongs_to(BelongsTo label) { belongs_to_ = label; }
   /// Getter for belongs_to label
@@ -407,6 +437,7 @@ class ParticleData {
     dst.initial_xsec_scaling_factor_ = initial_xsec_scaling_factor_;
     dst.begin_formation_time_ = begin_formation_time_;
     dst.belongs_to_ = belongs_to_;
+    dst.decay_time_ = decay_time_;
   }
 
   /**
@@ -438,7 +469,7 @@ class ParticleData {
   // this leaves us two Bytes padding to use for "free"
   static_assert(sizeof(ParticleTypePtr) == 2, "");
   // make sure we don't exceed that space
-  static_assert(sizeof(bool) <= 2, "");
+  static_assert(sizeof(bool) + sizeof(BelongsTo) <= 2, "");
   /**
    * If \c true, the object is an entry in Particles::data_ and does not hold
    * valid particle data. Specifically iterations over Particles must skip
@@ -448,7 +479,11 @@ class ParticleData {
    * \see Particles::data_
    */
   bool hole_ = false;
+  /// is it part of projectile or target nuclei?
+  BelongsTo belongs_to_ = BelongsTo::Nothing;
 
+  /* The members read by the transport loops come first, the history is
+   * mostly needed for the output and comes last. */
   /// momenta of the particle: x0, x1, x2, x3 as E, px, py, pz
   FourVector momentum_;
   /// position in space: x0, x1, x2, x3 as t, x, y, z
@@ -464,10 +499,10 @@ class ParticleData {
    * 1 by default, since a particle is fully formed in this case.
    */
   double initial_xsec_scaling_factor_ = 1.0;
+  /// sampled decay time, cf. decay_time()
+  mutable double decay_time_ = std::numeric_limits<double>::quiet_NaN();
   /// history information
   HistoryData history_;
-  /// is it part of projectile or target nuclei?
-  BelongsTo belongs_to_ = BelongsTo::Nothing;
 };
 
 /**
@@ -1,5 +1,5 @@
 /*
- *    Copyright (c) 2013-2018,2020,2022-2023
+ *    Copyright (c) 2013-2018,2020,2022-2024
  *      SMASH Team
  *
  *    GNU General Public License (GPLv3 or later)
@@ -7,6 +7,10 @@
 #ifndef SRC_INCLUDE_SMASH_PARTICLES_H_
 #define SRC_INCLUDE_SMASH_PARTICLES_H_
 
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <iosfwd>
 #include <memory>
 #include <type_traits>
 #include <vector>
@@ -89,6 +93,65 @@ class Particles {
   /// \return whether the list of particles is empty.
   bool is_empty() const { return data_size_ == 0; }
 
+  /**
+   * \return the fraction of the used slots which are holes left by removed
+   *         particles, which the iteration skips.
+   */
+  double hole_fraction() const {
+    return data_size_ == 0 ? 0.
+                           : static_cast<double>(dirty_.size()) / data_size_;
+  }
+
+  /**
+   * Move the last particles into the holes, such that the particles occupy
+   * consecutive slots. The ids are kept, but the moved particles get a new
+   * index, hence copies of them are no longer valid and pointers to them no
+   * longer refer to them. It must therefore only be called while no copies
+   * or pointers are kept, e.g. at the beginning of a time step.
+   */
+  void compact();
+
+  /**
+   * Compact the particles and sort them by a key, such that e.g. particles
+   * close in space also lie close in memory. The ids are kept, but like in
+   * compact the particles get new indices, hence it must only be called while
+   * no copies or pointers are kept. Particles with the same key keep their
+   * order.
+   *
+   * \param[in] key Function returning the key of a particle
+   */
+  void sort(const std::function<std::uint64_t(const ParticleData &)> &key);
+
+  /**
+   * Copy the particles into newly allocated memory of the same capacity.
+   * The calling thread writes the new memory first, so that the operating
+   * system places it on the NUMA node of this thread. Like compact, it must
+   * only be called while no pointers to the particles are kept.
+   */
+  void relocate() { reallocate(data_capacity_); }
+
+  /**
+   * Write the particles, including the holes and the highest id, to a
+   * checkpoint, such that they are restored exactly by read_checkpoint.
+   *
+   * \param[out] out Stream of the checkpoint
+   */
+  void write_checkpoint(std::ostream &out) const;
+
+  /**
+   * Replace the particles with the ones of a checkpoint.
+   *
+   * \param[in] in Stream of the checkpoint
+   * \throw std::runtime_error if the checkpoint ends unexpectedly
+   */
+  void read_checkpoint(std::istream &in);
+
+  /// \return the memory allocated for the particles [bytes].
+  std::size_t memory_usage() const {
+    return data_capacity_ * sizeof(ParticleData) +
+           dirty_.capacity() * sizeof(unsigned);
+  }
+
   /**
    *  Returns the time of the computational frame.
    *
@@ -108,6 +171,52 @@ class Particles {
    */
   void reset();
 
+  /**
+   * Replace the content by a copy of all particles in \p other, keeping their
+   * ids. Since Particles cannot be copied, this is the way to keep the state
+   * of the particles for later, e.g. to write it to an output afterwards.
+   *
+   * \param[in] other The particles to be copied.
+   */
+  void copy_from(const Particles &other);
+
+  /**
+   * Replace the content by a copy of the particles in \p other, which are
+   * selected, keeping their ids.
+   *
+   * \param[in] other The particles to be copied.
+   * \param[in] selected Whether a particle is copied.
+   */
+  void copy_from(const Particles &other,
+                 const std::function<bool(const ParticleData &)> &selected);
+
+  /**
+   * Identify the current state of the particles. Every modification, i.e.
+   * every call of a non-const member function which may change a particle,
+   * leads to a new epoch. Epochs are unique across all Particles objects,
+   * hence equal epochs mean equal particles.
+   *
+   * Not to be called concurrently with a modification or with another call
+   * of epoch() or snapshot().
+   *
+   * \return The epoch of the current state.
+   */
+  std::uint64_t epoch() const;
+
+  /**
+   * Copy the particles like copy_from for readers, which keep the state for
+   * later, e.g. outputs writing in a thread of their own. The copy is shared
+   * by all readers of the same epoch, such that it is made once however many
+   * readers ask for it. The readers keep the copy alive as long as they need
+   * it, the particles neither keep it nor write to it.
+   *
+   * Not to be called concurrently with a modification or with another call
+   * of epoch() or snapshot().
+   *
+   * \return A copy of the particles at the current epoch.
+   */
+  std::shared_ptr<const Particles> snapshot() const;
+
   /**
    * Check whether the ParticleData copy is still a valid copy of the one
    * stored in the Particles object.
@@ -176,6 +285,7 @@ class Particles {
                                       const ParticleData &new_state) {
     assert(is_valid(p));
     assert(p.type() == new_state.type());
+    touch();
     ParticleData &original = data_[p.index_];
     new_state.copy_to(original);
     return original;
@@ -380,7 +490,10 @@ class Particles {
   const ParticleData &front() const { return *begin(); }
 
   /// \return a reference to the last particle in the list.
-  ParticleData &back() { return *(--end()); }
+  ParticleData &back() {
+    touch();
+    return *(--end());
+  }
   /**
    * const overload of &back()
    *
@@ -393,6 +506,7 @@ class Particles {
    * iterate over all particles in the list.
    */
   iterator begin() {
+    touch();
     ParticleData *first = &data_[0];
     while (first->hole_) {
       ++first;
@@ -453,6 +567,14 @@ class Particles {
    * data_capacity_. This is enforced in DEBUG builds.
    */
   void increase_capacity(unsigned new_capacity);
+  /**
+   * \internal
+   * Copies the particles into newly allocated memory for \p new_capacity
+   * particles.
+   *
+   * \param[in] new_capacity new capacity, which is at least data_size_
+   */
+  void reallocate(unsigned new_capacity);
   /**
    * \internal
    * Ensure that the capacity of data_ is large enough to hold \p to_add more
@@ -502,6 +624,20 @@ class Particles {
    * be reused when new particles are added.
    */
   std::vector<unsigned> dirty_;
+
+  /**
+   * Mark the particles as modified, which ends the current epoch. This may
+   * happen concurrently, e.g. when several threads iterate over the
+   * particles, hence the flag is atomic, but without ordering.
+   */
+  void touch() { modified_.store(true, std::memory_order_relaxed); }
+
+  /// Whether the particles were modified since the epoch was taken
+  mutable std::atomic<bool> modified_{true};
+  /// Epoch taken last, see epoch()
+  mutable std::uint64_t epoch_ = 0;
+  /// Copy shared by the readers of the current epoch, see snapshot()
+  mutable std::weak_ptr<const Particles> snapshot_;
 };
 
 }  // namespace smash
@@ -0,0 +1,148 @@
+/*
+ *
+ *    Copyright (c) 2024
+ *      SMASH Team
+ *
+ *    GNU General Public License (GPLv3 or later)
+ *
+ */
+
+#ifndef SRC_INCLUDE_SMASH_PARTICLESPAN_H_
+#define SRC_INCLUDE_SMASH_PARTICLESPAN_H_
+
+#include <cstddef>
+#include <iterator>
+#include <vector>
+
+#include "forwarddeclarations.h"
+#include "particledata.h"
+
+namespace smash {
+
+/**
+ * \ingroup data
+ *
+ * A non-owning view of particles that are stored elsewhere, e.g. in a
+ * Particles object or a ParticleList.
+ *
+ * The span refers to a contiguous range of pointers to the particles. It can be
+ * iterated like a constant ParticleList, but creating it does not copy any
+ * ParticleData. Both the pointers and the particles have to outlive the span.
+ */
+class ParticleSpan {
+ public:
+  /// Iterator over the particles of a span, dereferencing to the particle.
+  class const_iterator {
+   public:
+    /// Type of the iterator
+    using iterator_category = std::forward_iterator_tag;
+    /// Type of the particles
+    using value_type = ParticleData;
+    /// Type of the difference of two iterators
+    using difference_type = std::ptrdiff_t;
+    /// Pointer to a particle
+    using pointer = const ParticleData *;
+    /// Reference to a particle
+    using reference = const ParticleData &;
+
+    /// Construct a singular iterator.
+    const_iterator() = default;
+    /**
+     * Construct an iterator pointing to the given position.
+     * \param[in] position Position in the array of pointers
+     */
+    explicit const_iterator(const ParticleData *const *position)
+        : position_(position) {}
+
+    /// \return the particle
+    reference operator*() const { return **position_; }
+    /// \return pointer to the particle
+    pointer operator->() const { return *position_; }
+    /// Advance to the next particle. \return this iterator
+    const_iterator &operator++() {
+      ++position_;
+      return *this;
+    }
+    /// Advance to the next particle. \return the iterator before advancing
+    const_iterator operator++(int) {
+      const_iterator copy = *this;
+      ++position_;
+      return copy;
+    }
+    /// \return whether both iterators point to the same position
+    bool operator==(const const_iterator &rhs) const {
+      return position_ == rhs.position_;
+    }
+    /// \return whether the iterators point to different positions
+    bool operator!=(const const_iterator &rhs) const {
+      return position_ != rhs.position_;
+    }
+
+   private:
+    /// Current position in the array of pointers
+    const ParticleData *const *position_ = nullptr;
+  };
+  /// Iterators of a span never allow modifications
+  using iterator = const_iterator;
+
+  /// Construct an empty span.
+  ParticleSpan() = default;
+
+  /**
+   * Construct a span from a range of pointers.
+   *
+   * \param[in] first Pointer to the first pointer of the range
+   * \param[in] size Number of particles in the range
+   */
+  ParticleSpan(const ParticleData *const *first, std::size_t size)
+      : first_(first), size_(size) {}
+
+  /**
+   * Construct a span of all particles in \p pointers.
+   *
+   * \param[in] pointers Pointers to the particles
+   */
+  explicit ParticleSpan(const std::vector<const ParticleData *> &pointers)
+      : ParticleSpan(pointers.data(), pointers.size()) {}
+
+  /// \return iterator to the first particle
+  const_iterator begin() const { return const_iterator(first_); }
+  /// \return iterator behind the last particle
+  const_iterator end() const { return const_iterator(first_ + size_); }
+  /// \return number of particles
+  std::size_t size() const { return size_; }
+  /// \return whether there are no particles
+  bool empty() const { return size_ == 0; }
+  /**
+   * \param[in] i Index of the particle
+   * \return the particle with the given index in the span
+   */
+  const ParticleData &operator[](std::size_t i) const { return *first_[i]; }
+  /// \return a copy of all particles in the span
+  ParticleList copy_to_vector() const { return ParticleList(begin(), end()); }
+
+ private:
+  /// First pointer of the range
+  const ParticleData *const *first_ = nullptr;
+  /// Number of particles
+  std::size_t size_ = 0;
+};
+
+/**
+ * \param[in] list Particles to point to
+ * \return Pointers to all particles in \p list, which can be viewed by a
+ *         ParticleSpan as long as \p list is not changed.
+ */
+inline std::vector<const ParticleData *> particle_pointers(
+    const ParticleList &list) {
+  std::vector<const ParticleData *> pointers;
+  pointers.reserve(list.size());
+  for (const ParticleData &p : list) {
+    pointers.push_back(&p);
+  }
+  return pointers;
+}
+
+}  // namespace smash
+
+#endif  // SRC_INCLUDE_SMASH_PARTICLESPAN_H_
@@ -0,0 +1,94 @@
+/*
+ *
+ *    Copyright (c) 2024
+ *      SMASH Team
+ *
+ *    GNU General Public License (GPLv3 or later)
+ *
+ */
+
+#ifndef SRC_INCLUDE_SMASH_PARTICLESSOA_H_
+#define SRC_INCLUDE_SMASH_PARTICLESSOA_H_
+
+#include <cstddef>
+#include <vector>
+
+#include "forwarddeclarations.h"
+#include "particletype.h"
+
+namespace smash {
+
+/**
+ * \ingroup data
+ *
+ * Positions, momenta and types of particles laid out as a structure of arrays.
+ *
+ * Particles stores complete ParticleData objects, of which loops over all
+ * particles like the lattice updates or the expansion of space-time only read
+ * a few bytes each. A snapshot holds only these quantities in separate arrays,
+ * such that the loops stream through memory and can be vectorized.
+ *
+ * The snapshot is not kept in sync with the particles. It has to be assigned
+ * again after the particles changed, typically once per time step, and its
+ * buffers are reused then. The particles are stored in the order of iteration
+ * over Particles, with the ensembles one after another.
+ */
+class ParticlesSoA {
+ public:
+  /// Construct an empty snapshot.
+  ParticlesSoA() = default;
+
+  /**
+   * Construct a snapshot of the particles of all ensembles.
+   *
+   * \param[in] ensembles Particles of each ensemble
+   */
+  explicit ParticlesSoA(const std::vector<Particles> &ensembles) {
+    assign(ensembles);
+  }
+
+  /**
+   * Replace the snapshot by the given particles.
+   *
+   * \param[in] particles Particles to be copied
+   */
+  void assign(const Particles &particles);
+
+  /**
+   * Replace the snapshot by the particles of all ensembles.
+   *
+   * \param[in] ensembles Particles of each ensemble
+   */
+  void assign(const std::vector<Particles> &ensembles);
+
+  /// \return number of particles
+  std::size_t size() const { return particle.size(); }
+
+  /// Particles the snapshot was taken from
+  std::vector<const ParticleData *> particle;
+  /// Types of the particles
+  std::vector<ParticleTypePtr> type;
+  /// Time, x, y and z components of the positions [fm]
+  std::vector<double> t, x, y, z;
+  /// Energy, x, y and z components of the momenta [GeV]
+  std::vector<double> e, px, py, pz;
+
+ private:
+  /**
+   * Remove all particles, but keep the capacity.
+   *
+   * \param[in] capacity Number of particles to reserve memory for
+   */
+  void clear(std::size_t capacity);
+
+  /**
+   * Copy the particles to the end of the arrays.
+   *
+   * \param[in] particles Particles to be copied
+   */
+  void append(const Particles &particles);
+};
+
+}  // namespace smash
+
+#endif  // SRC_INCLUDE_SMASH_PARTICLESSOA_H_
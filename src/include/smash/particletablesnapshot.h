@@ -0,0 +1,128 @@
+/*
+ *
+ *    Copyright (c) 2024
+ *      SMASH Team
+ *
+ *    GNU General Public License (GPLv3 or later)
+ *
+ */
+
+#ifndef SRC_INCLUDE_SMASH_PARTICLETABLESNAPSHOT_H_
+#define SRC_INCLUDE_SMASH_PARTICLETABLESNAPSHOT_H_
+
+#include <cstdint>
+#include <filesystem>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "particletype.h"
+#include "pdgcode.h"
+#include "sha256.h"
+
+namespace smash {
+
+/**
+ * \ingroup data
+ *
+ * Snapshot of the fully resolved particle types and decay modes, i.e. after
+ * the antiparticles were generated, the branching ratios were renormalized
+ * and the consistency was checked.
+ *
+ * Setting up the tables from a snapshot does not parse the particles and
+ * decaymodes input, which is what takes most of the time at startup. The
+ * snapshot is stored in a binary file together with the hash of the input it
+ * was created from, and is only used for the same hash.
+ *
+ * The file starts with the magic, the version of the format and the hash.
+ * It is followed by the particle types in the order of
+ * ParticleType::list_all(), each as its name, pole mass, width, parity and
+ * PDG code, and then by the decay branches of each type, each as its
+ * branching ratio, angular momentum and the indices of the daughter types.
+ * All sizes are stored as 64-bit integers before the data they refer to.
+ */
+class ParticleTableSnapshot {
+ public:
+  /// Particle type as stored in the snapshot
+  struct Type {
+    /// Name of the type
+    std::string name;
+    /// Pole mass [GeV]
+    double mass;
+    /// Width at the pole [GeV]
+    double width;
+    /// Parity
+    Parity parity;
+    /// PDG code
+    PdgCode pdgcode;
+  };
+  /// Decay branch as stored in the snapshot
+  struct Branch {
+    /// Branching ratio
+    double weight;
+    /// Angular momentum
+    int angular_momentum;
+    /// Indices of the daughter types in the list of types
+    std::vector<std::uint32_t> daughters;
+  };
+
+  /**
+   * Take a snapshot of the current particle types and decay modes.
+   *
+   * \return The snapshot
+   */
+  static ParticleTableSnapshot take();
+
+  /**
+   * Read a snapshot from a file with a single read.
+   *
+   * \param[in] path Path of the file
+   * \param[in] hash Hash of the input the snapshot has to be created from
+   * \return The snapshot, or nothing if the file does not exist, is not a
+   *         valid snapshot of the current version or was created for
+   *         another hash
+   */
+  static std::optional<ParticleTableSnapshot> read(
+      const std::filesystem::path &path, sha256::Hash hash);
+
+  /**
+   * Write the snapshot to a file, replacing an existing one atomically.
+   *
+   * \param[in] path Path of the file
+   * \param[in] hash Hash of the input the snapshot was created from
+   * \throws std::runtime_error if the file cannot be written
+   */
+  void write(const std::filesystem::path &path, sha256::Hash hash) const;
+
+  /**
+   * Set up the global particle types and decay modes from the snapshot.
+   * This must happen instead of ParticleType::create_type_list and
+   * DecayModes::load_decaymodes.
+   */
+  void install() const;
+
+  /// \return The particle types in the order of ParticleType::list_all()
+  const std::vector<Type> &types() const { return types_; }
+
+  /// \return The decay branches of each particle type
+  const std::vector<std::vector<Branch>> &branches() const {
+    return branches_;
+  }
+
+  /// Identifies the format at the beginning of the file
+  static constexpr char magic[8] = {'S', 'M', 'A', 'S', 'H', 'P', 'D', 'T'};
+
+  /// Version of the format, which is increased whenever it changes
+  static constexpr std::uint64_t version = 1;
+
+ private:
+  /// Particle types in the order of ParticleType::list_all()
+  std::vector<Type> types_;
+
+  /// Decay branches of each particle type
+  std::vector<std::vector<Branch>> branches_;
+};
+
+}  // namespace smash
+
+#endif  // SRC_INCLUDE_SMASH_PARTICLETABLESNAPSHOT_H_
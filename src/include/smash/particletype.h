@@ -9,6 +9,7 @@
 
 #include <cassert>
 #include <cstdint>
+#include <memory>
 #include <string>
 #include <utility>
 #include <vector>
@@ -16,6 +17,7 @@
 #include "forwarddeclarations.h"
 #include "macros.h"
 #include "pdgcode.h"
+#include "random.h"
 
 namespace smash {
 
@@ -156,6 +158,13 @@ class ParticleType {
   /// \return the PDG code of the particle.
   PdgCode pdgcode() const { return pdgcode_; }
 
+  /**
+   * \return the PDG code of the particle as decimal string, which is created
+   *         once for the type, such that outputs do not need to format it for
+   *         every particle.
+   */
+  const std::string &pdgcode_string() const { return pdgcode_string_; }
+
   /// \copydoc PdgCode::has_antiparticle
   bool has_antiparticle() const { return pdgcode_.has_antiparticle(); }
 
@@ -327,6 +336,22 @@ class ParticleType {
   DecayBranchList get_partial_widths(const FourVector p, const ThreeVector x,
                                      WhichDecaymodes wh) const;
 
+  /**
+   * Get the total width of the wanted decay modes at mass m, interpolated in
+   * a table of its mass dependence. Without potentials, this is the sum of
+   * the widths returned by get_partial_widths, but it does not depend on the
+   * number of decay modes.
+   *
+   * The widths are tabulated at the first call, through the TabulationCache,
+   * in the variable \f$ x = \arctan((m - m_0) / \Gamma_0) \f$ up to
+   * \f$ m_0 + 50 \Gamma_0 \f$. Above, they are summed up directly.
+   *
+   * \param[in] m Invariant mass of the decaying particle [GeV]
+   * \param[in] wh enum that decides which decay modes are included
+   * \return The total width of the wanted decay modes [GeV]
+   */
+  double tabulated_width(double m, WhichDecaymodes wh) const;
+
   /**
    * Get the mass-dependent partial width of a resonance with mass m,
    * decaying into two given daughter particles.
@@ -424,6 +449,18 @@ class ParticleType {
                                                     const double cms_energy,
                                                     int L = 0) const;
 
+  /**
+   * The spectral function tabulated as distribution of
+   * \f$ x = \arctan((m - m_0) / \Gamma_0) \f$, from the minimal mass to
+   * infinity. It is used by sample_resonance_mass and sample_resonance_masses
+   * to sample the spectral function without rejection.
+   *
+   * The distribution is set up at the first call, through the TabulationCache.
+   *
+   * \return The distribution, or nullptr if the particle is stable
+   */
+  const random::piecewise_constant_dist *mass_distribution() const;
+
   /**
    * Prints out width and spectral function versus mass to the
    * standard output. This is useful for debugging and analysis.
@@ -533,6 +570,18 @@ class ParticleType {
    */
   static void create_type_list(const std::string &particles);
 
+  /**
+   * Initialize the global ParticleType list (list_all) from already resolved
+   * types, e.g. from a snapshot of a list created before, and set up the
+   * isospin multiplets and the lists of special types. Like
+   * create_type_list, this function must only be called once.
+   *
+   * \param[in] types All particle types including the antiparticles, sorted
+   *                  by PDG code and without duplicates
+   * \throw runtime_error if the type list was already built
+   */
+  static void set_type_list(ParticleTypeList &&types);
+
   /**
    * \param[in] rhs another ParticleType to compare to
    * \return whether the two ParticleType objects have the same PDG code.
@@ -566,6 +615,29 @@ class ParticleType {
    */
   static void check_consistency();
 
+  /**
+   * Compute all quantities of the particle types and of their decay modes,
+   * which are otherwise only evaluated and stored at their first usage.
+   *
+   * This concerns the minimum masses, the normalization and tabulation of the
+   * spectral functions and the tabulated widths of the decay modes. It has to
+   * be called before particle types are used from several threads at the same
+   * time, because the lazy initialization would otherwise be a data race.
+   *
+   * The particle types are processed in order of their decay chains: a type
+   * is only processed once all unstable particles it decays into are done,
+   * because their spectral functions enter its tabulated widths. All types
+   * whose daughters are done are processed concurrently, if a pool of
+   * threads is given. The results do not depend on the number of threads.
+   *
+   * Note that the particles and decay modes have to be initialized, otherwise
+   * calling this is undefined behavior.
+   *
+   * \param[in] pool Threads to process independent types concurrently
+   *                 (optional)
+   */
+  static void initialize_lazy_members(ThreadPool *pool = nullptr);
+
   /**
    * Returns an object that acts like a pointer, except that it requires only 2
    * bytes and inhibits pointer arithmetics.
@@ -625,6 +697,8 @@ class ParticleType {
   Parity parity_;
   /// PDG Code of the particle
   PdgCode pdgcode_;
+  /// PDG Code of the particle as decimal string
+  std::string pdgcode_string_;
   /**
    * minimum kinematically allowed mass of the particle
    * Mutable, because it is initialized at first call of minimum mass function,
@@ -652,10 +726,17 @@ class ParticleType {
   /// Container for the isospin multiplet information
   IsoParticleType *iso_multiplet_ = nullptr;
 
-  /// Maximum factor for single-res mass sampling, cf. sample_resonance_mass.
-  mutable double max_factor1_ = 1.;
-  /// Maximum factor for double-res mass sampling, cf. sample_resonance_masses.
-  mutable double max_factor2_ = 1.;
+  /**
+   * Tabulated spectral function, cf. mass_distribution.
+   * Mutable, because it is set up at the first call, like norm_factor_.
+   */
+  mutable std::shared_ptr<const random::piecewise_constant_dist>
+      mass_distribution_;
+  /**
+   * Tabulated total widths of the hadronic and of the dilepton decay modes,
+   * cf. tabulated_width. Mutable, because they are set up at the first call.
+   */
+  mutable std::shared_ptr<const std::vector<Tabulation>> width_tables_;
 
   /**\ingroup logging
    * Writes all information about the particle type to the output stream.
@@ -766,13 +847,108 @@ inline ParticleTypePtr ParticleType::get_antiparticle() const {
  * \param[in] type_b second incoming particle.
  * \return list of possible resonances.
  *
- * \note Internally, a `static std::map` is used as a caching mechanism and is
- * filled the first time this function is called, such that calling it again
- * just returns the same list.
+ * \see resonance_formations, from which the list is copied
  */
 ParticleTypePtrList list_possible_resonances(const ParticleTypePtr type_a,
                                              const ParticleTypePtr type_b);
 
+/// A decay channel through which a resonance can be formed.
+struct FormationChannel {
+  /// Type of the decay
+  const DecayType *type;
+  /// Partial width of the decay at the pole mass [GeV]
+  double width_at_pole;
+};
+
+/**
+ * A resonance that can be formed from two particles, with all factors of the
+ * formation cross section that do not depend on the energy.
+ */
+struct ResonanceFormation {
+  /// Type of the resonance
+  ParticleTypePtr resonance;
+  /**
+   * Ratio of the spin degeneracies of the resonance and the incoming
+   * particles, including the symmetry factor of identical particles
+   */
+  double spin_factor;
+  /// Minimal center-of-mass energy of the incoming particles [GeV]
+  double threshold;
+  /// First of the decay channels of the resonance into the incoming particles
+  const FormationChannel *channels;
+  /// Number of decay channels
+  std::size_t n_channels;
+};
+
+/**
+ * A non-owning view of the resonances that can be formed from two particles.
+ *
+ * It refers to a table which is built once and never changed, such that the
+ * view stays valid.
+ */
+class ResonanceFormationSpan {
+ public:
+  /**
+   * Construct a view of the given range.
+   *
+   * \param[in] begin First resonance
+   * \param[in] end Behind the last resonance
+   */
+  ResonanceFormationSpan(const ResonanceFormation *begin,
+                         const ResonanceFormation *end)
+      : begin_(begin), end_(end) {}
+  /// \return pointer to the first resonance
+  const ResonanceFormation *begin() const { return begin_; }
+  /// \return pointer behind the last resonance
+  const ResonanceFormation *end() const { return end_; }
+  /// \return number of resonances
+  std::size_t size() const { return end_ - begin_; }
+  /// \return whether no resonance can be formed
+  bool empty() const { return begin_ == end_; }
+
+ private:
+  /// First resonance
+  const ResonanceFormation *begin_;
+  /// Behind the last resonance
+  const ResonanceFormation *end_;
+};
+
+/**
+ * Lists the resonances that can be formed from two particles, i.e. that decay
+ * into them, in the order of ParticleType::list_all.
+ *
+ * \param[in] type_a first incoming particle.
+ * \param[in] type_b second incoming particle.
+ * \return view of the resonances.
+ *
+ * \note The resonances of all pairs of particle types are found once, the
+ * first time this function is called, which requires the decay modes to be
+ * loaded. Afterwards, the function neither allocates memory nor looks at the
+ * decay modes, and it can be called concurrently.
+ */
+ResonanceFormationSpan resonance_formations(const ParticleType &type_a,
+                                            const ParticleType &type_b);
+
+/**
+ * Find the resonance with the pole mass closest to a given mass among those
+ * that can be formed from two particles.
+ *
+ * The resonances of every pair are kept sorted by their pole masses, such
+ * that this is a binary search. Of several resonances with the same pole
+ * mass, the first one in the list of possible resonances is taken.
+ *
+ * \param[in] type_a first incoming particle
+ * \param[in] type_b second incoming particle
+ * \param[in] mass desired mass [GeV], which is infinite for the heaviest
+ *            resonance
+ * \return the closest resonance, or an invalid pointer if there is none.
+ *
+ * \see list_possible_resonances
+ */
+ParticleTypePtr possible_resonance_by_mass(const ParticleType &type_a,
+                                           const ParticleType &type_b,
+                                           double mass);
+
 }  // namespace smash
 
 #endif  // SRC_INCLUDE_SMASH_PARTICLETYPE_H_
@@ -10,11 +10,17 @@
 #ifndef SRC_INCLUDE_SMASH_PAULIBLOCKING_H_
 #define SRC_INCLUDE_SMASH_PAULIBLOCKING_H_
 
+#include <array>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <unordered_map>
 #include <vector>
 
 #include "configuration.h"
 #include "experimentparameters.h"
 #include "forwarddeclarations.h"
+#include "lattice.h"
 #include "particles.h"
 #include "pdgcode.h"
 #include "threevector.h"
@@ -34,6 +40,20 @@ namespace smash {
  * \iref{Gaitanos:2010fd}, section III B. Our implementation
  * mainly follows this article (and therefore GiBUU, see
  * http://gibuu.hepforge.org).
+ *
+ * Only particles of the same species closer than the averaging radii in
+ * momentum space and the averaging plus cut-off radii in coordinate space
+ * contribute to the phase-space density. During a time step, the baryons of
+ * all ensembles are therefore kept in an index of cells of these sizes in
+ * coordinate and momentum space, such that a density only needs to look at
+ * the particles in the neighbouring cells instead of all particles.
+ *
+ * Alternatively, the phase-space densities of the baryons can be deposited
+ * on a lattice once per time step, with the momentum space divided into
+ * cells of the momentum averaging radius. A density is then looked up at the
+ * centres of the lattice cell of the position and of the momentum cell,
+ * which does not depend on the number of particles. Particles produced
+ * during the time step do not contribute until the next one.
  */
 class PauliBlocker {
  public:
@@ -62,12 +82,65 @@ class PauliBlocker {
    *                       particles when the phase-space density for outgoing
    *                       ones is estimated.
    * \return Phase-space density
+   *
+   * If the index was built for these ensembles, only the particles in the
+   * neighbouring cells of baryons are looked at. On the lattice, the density
+   * of baryons is the one at the centres of the lattice cell and momentum
+   * cell of r and p, and zero outside of the lattice.
    */
   double phasespace_dens(const ThreeVector &r, const ThreeVector &p,
                          const std::vector<Particles> &ensembles,
                          const PdgCode pdg,
                          const ParticleList &disregard) const;
 
+  /// \return Whether the densities are to be calculated on a lattice
+  bool uses_lattice() const { return use_lattice_; }
+
+  /// \return Whether the lattice for the densities was created
+  bool has_lattice() const { return lattice_ != nullptr; }
+
+  /**
+   * Create the lattice on which the densities are deposited.
+   *
+   * \param[in] l Lengths of the lattice in x, y and z direction [fm]
+   * \param[in] n Number of cells in x, y and z direction
+   * \param[in] origin Coordinates of the lattice origin [fm]
+   * \param[in] periodic Whether the lattice is periodic
+   */
+  void create_lattice(const std::array<double, 3> &l,
+                      const std::array<int, 3> &n,
+                      const std::array<double, 3> &origin, bool periodic);
+
+  /**
+   * Sort the baryons of all ensembles into the cells of the index, which is
+   * used by phasespace_dens until clear_index is called. If a lattice was
+   * created, the densities are deposited on the lattice instead.
+   *
+   * The particles are looked up in the ensembles when the density is
+   * calculated, such that they may move in between. Particles which are
+   * removed, added or changed by actions have to be passed to update_index.
+   *
+   * \param[in] ensembles Current list of particles in all ensembles
+   * \param[in] max_drift Distance the particles may move at most while the
+   *            index is used [fm], e.g. the duration of the time step
+   */
+  void build_index(const std::vector<Particles> &ensembles, double max_drift);
+
+  /**
+   * Keep the index up to date after an action was performed. Does nothing if
+   * no index was built or the densities are on the lattice.
+   *
+   * \param[in] i_ensemble Ensemble of the action
+   * \param[in] removed Incoming particles of the action
+   * \param[in] added Outgoing particles of the action, as valid copies from
+   *            the ensemble
+   */
+  void update_index(int i_ensemble, const ParticleList &removed,
+                    const ParticleList &added);
+
+  /// Stop using the index, e.g. at the end of a time step.
+  void clear_index();
+
  private:
   /// Tabulate integrals for weights
   void init_weights();
@@ -75,6 +148,43 @@ class PauliBlocker {
   /// Analytical calculation of weights
   void init_weights_analytical();
 
+  /**
+   * \param[in] rdist_sqr Squared distance of a particle [fm\f$^2\f$]
+   * \return Contribution of the particle to the phase-space density
+   */
+  double weight(double rdist_sqr) const;
+
+  /// \return Key of the index cell of a position or momentum
+  static std::uint64_t cell_key(const std::array<int, 3> &cell);
+
+  /**
+   * \param[in] v Position or momentum
+   * \param[in] inv_length Inverse side length of the cells
+   * \return Coordinates of the cell containing v
+   */
+  static std::array<int, 3> cell_of(const ThreeVector &v, double inv_length);
+
+  /// Add a particle of an ensemble to the index.
+  void add_to_index(int i_ensemble, const ParticleData &p);
+
+  /// Remove a particle of an ensemble from the index, if it is in there.
+  void remove_from_index(int i_ensemble, const ParticleData &p);
+
+  /// Deposit the densities of the baryons of all ensembles on the lattice.
+  void deposit_on_lattice(const std::vector<Particles> &ensembles);
+
+  /// Phase-space density on the lattice, see phasespace_dens.
+  double lattice_phasespace_dens(const ThreeVector &r, const ThreeVector &p,
+                                 const PdgCode pdg,
+                                 const ParticleList &disregard) const;
+
+  /**
+   * \param[in] species Number of the species, below 1024
+   * \param[in] cell Momentum cell
+   * \return Key of the species and momentum cell on a lattice node
+   */
+  static std::uint64_t lattice_key(int species, const std::array<int, 3> &cell);
+
   /// Standard deviation of the gaussian used for smearing
   double sig_;
 
@@ -93,8 +203,46 @@ class PauliBlocker {
   /// Number of ensembles
   int n_ensembles_;
 
+  /// Whether the densities are calculated on a lattice
+  bool use_lattice_;
+
   /// Weights: tabulated results of numerical integration
   std::array<double, 30> weights_;
+
+  /// A particle in the index
+  struct IndexEntry {
+    /// Ensemble of the particle
+    int ensemble;
+    /// Copy of the particle, to look it up in the ensemble
+    ParticleData particle;
+    /// Cell of the index the particle is in
+    std::vector<int> *cell;
+  };
+  /// Entries of the index in a spatial cell, by momentum cell
+  using MomentumCells = std::unordered_map<std::uint64_t, std::vector<int>>;
+  /// Spatial cells of the index of one species
+  using SpatialCells = std::unordered_map<std::uint64_t, MomentumCells>;
+
+  /// Whether phasespace_dens uses the index
+  bool index_built_ = false;
+  /// Inverse side length of the spatial cells [1/fm]
+  double inv_spatial_length_ = 0.;
+  /// Inverse side length of the momentum cells [1/GeV]
+  double inv_momentum_length_ = 0.;
+  /// Cells of the index of every species
+  std::map<PdgCode, SpatialCells> index_;
+  /// Particles in the index, removed ones have a null cell
+  std::vector<IndexEntry> entries_;
+  /// Position of the particles in entries_ by ensemble and id
+  std::vector<std::unordered_map<int32_t, int>> entry_of_id_;
+
+  /// Densities on every node of the lattice, by species and momentum cell
+  std::unique_ptr<RectangularLattice<std::unordered_map<std::uint64_t, double>>>
+      lattice_;
+  /// Numbers of the species deposited on the lattice
+  std::map<PdgCode, int> species_;
+  /// Particles up to this id are deposited on the lattice if they still exist
+  int32_t deposited_id_max_ = -1;
 };
 }  // namespace smash
 
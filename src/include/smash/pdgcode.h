@@ -13,6 +13,7 @@
 #include <algorithm>
 #include <array>
 #include <cassert>
+#include <charconv>
 #include <cstdint>
 #include <cstdlib>
 #include <functional>
@@ -22,6 +23,7 @@
 #include <sstream>
 #include <stdexcept>
 #include <string>
+#include <string_view>
 #include <type_traits>
 
 #include "pdgcode_constants.h"
@@ -130,11 +132,27 @@ class PdgCode {
    * Initialize using a string
    * The string is interpreted as a hexadecimal number, i.e., \c 211 is
    * interpreted as \c 0x211 = \f$529_{10}\f$.
+   *
+   * The string is parsed in place, so that a PDG code can be read from an
+   * input buffer without allocating memory.
    */
-  explicit PdgCode(const std::string& codestring) {
+  explicit PdgCode(std::string_view codestring) {
     set_from_string(codestring);
   }
 
+  /**
+   * Construct a PDG code from the characters in [first, last), which are
+   * interpreted like by the string constructor.
+   *
+   * \param[in] first First character
+   * \param[in] last Past-the-end character
+   * \return The PDG code
+   * \throw InvalidPdgCode if the characters are no valid PDG code
+   */
+  static PdgCode from_chars(const char* first, const char* last) {
+    return PdgCode(std::string_view(first, last - first));
+  }
+
   /**
    * Receive a signed integer and process it into a PDG Code. The sign
    * is taken as antiparticle boolean, while the absolute value of the
@@ -321,11 +339,24 @@ class PdgCode {
   /// \return a signed integer with the PDG code in hexadecimal.
   inline std::int32_t code() const { return antiparticle_sign() * ucode(); }
 
+  /// Maximum number of characters written by to_chars
+  static constexpr std::size_t max_chars = 11;
+
+  /**
+   * Write the PDG code as decimal number without allocating memory.
+   *
+   * \param[out] first Buffer for at least max_chars characters, to which no
+   *                   terminating null character is written
+   * \return Past-the-end pointer of the written characters
+   */
+  char* to_chars(char* first) const {
+    return std::to_chars(first, first + max_chars, get_decimal()).ptr;
+  }
+
   /// \return the PDG Code as a decimal string.
   inline std::string string() const {
-    std::stringstream ss;
-    ss << get_decimal();
-    return ss.str();
+    char buffer[max_chars];
+    return std::string(buffer, to_chars(buffer));
   }
 
   /// Construct the antiparticle to a given PDG code.
@@ -977,7 +1008,7 @@ class PdgCode {
    * \throw InvalidPdgCode
    * if there is nothing else but sign
    */
-  inline void set_from_string(const std::string& codestring) {
+  inline void set_from_string(std::string_view codestring) {
     dump_ = 0;
     // Implicit with the above: digits_.antiparticle_ = false;
     digits_.n_ = digits_.n_R_ = digits_.n_L_ = digits_.n_q1_ = digits_.n_q2_ =
@@ -1003,7 +1034,8 @@ class PdgCode {
     if (length == 10 + sign) {
       nucleus_.is_nucleus_ = true;
       if (codestring[c] != '1' || codestring[c + 1] != '0') {
-        throw InvalidPdgCode("Pdg code of nucleus \"" + codestring +
+        throw InvalidPdgCode("Pdg code of nucleus \"" +
+                             std::string(codestring) +
                              "\" should start with 10\n");
       }
       c += 2;
@@ -1021,7 +1053,7 @@ class PdgCode {
 
     // Codestring shouldn't be longer than 8 + sign, except for nuclei
     if (length > 8 + sign) {
-      throw InvalidPdgCode("String \"" + codestring +
+      throw InvalidPdgCode("String \"" + std::string(codestring) +
                            "\" too long for PDG Code\n");
     }
     /* Please note that in what follows, we actually need c++, not ++c.
@@ -1045,21 +1077,24 @@ class PdgCode {
     if (length > 3 + sign) {
       digits_.n_q1_ = get_digit_from_char(codestring[c++]);
       if (digits_.n_q1_ > 6) {
-        throw InvalidPdgCode("Invalid PDG code " + codestring + " (n_q1>6)");
+        throw InvalidPdgCode("Invalid PDG code " + std::string(codestring) +
+                             " (n_q1>6)");
       }
     }
     // 3rd from last is n_q2_.
     if (length > 2 + sign) {
       digits_.n_q2_ = get_digit_from_char(codestring[c++]);
       if (digits_.n_q2_ > 6) {
-        throw InvalidPdgCode("Invalid PDG code " + codestring + " (n_q2>6)");
+        throw InvalidPdgCode("Invalid PDG code " + std::string(codestring) +
+                             " (n_q2>6)");
       }
     }
     // Next to last is n_q3_.
     if (length > 1 + sign) {
       digits_.n_q3_ = get_digit_from_char(codestring[c++]);
       if (digits_.n_q3_ > 6) {
-        throw InvalidPdgCode("Invalid PDG code " + codestring + " (n_q3>6)");
+        throw InvalidPdgCode("Invalid PDG code " + std::string(codestring) +
+                             " (n_q3>6)");
       }
     }
     // Last digit is the spin degeneracy.
@@ -1067,7 +1102,7 @@ class PdgCode {
       digits_.n_J_ += get_digit_from_char(codestring[c++]);
     } else {
       throw InvalidPdgCode(
-          "String \"" + codestring +
+          "String \"" + std::string(codestring) +
           "\" only consists of a sign, that is no valid PDG Code\n");
     }
     check();
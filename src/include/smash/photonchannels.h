@@ -0,0 +1,79 @@
+/*
+ *
+ *    Copyright (c) 2024
+ *      SMASH Team
+ *
+ *    GNU General Public License (GPLv3 or later)
+ *
+ */
+
+#ifndef SRC_INCLUDE_SMASH_PHOTONCHANNELS_H_
+#define SRC_INCLUDE_SMASH_PHOTONCHANNELS_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "particledata.h"
+#include "particletype.h"
+
+namespace smash {
+
+/**
+ * \ingroup action
+ *
+ * Table of the photon channels of all pairs of particle types.
+ *
+ * After every hadronic scattering, the incoming particles are checked for a
+ * photon reaction of ScatterActionPhoton and a bremsstrahlung reaction of
+ * BremsstrahlungAction, although almost all pairs have none. The table is
+ * built once from the particle types, such that the check is a lookup.
+ */
+class PhotonChannels {
+ public:
+  /// Build the table of all pairs of the current particle types.
+  PhotonChannels();
+
+  /**
+   * \return whether the particles of the incoming list produce photons in
+   *         ScatterActionPhoton, see ScatterActionPhoton::is_photon_reaction
+   */
+  bool is_photon_reaction(const ParticleList &in) const {
+    return in.size() == 2 && (channels(in[0], in[1]) & photon) != 0;
+  }
+
+  /**
+   * \return whether the particles of the incoming list produce photons in
+   *         BremsstrahlungAction, see
+   *         BremsstrahlungAction::is_bremsstrahlung_reaction
+   */
+  bool is_bremsstrahlung_reaction(const ParticleList &in) const {
+    return in.size() == 2 && (channels(in[0], in[1]) & bremsstrahlung) != 0;
+  }
+
+ private:
+  /// Flag of a photon reaction of ScatterActionPhoton
+  static constexpr std::uint8_t photon = 1;
+  /// Flag of a bremsstrahlung reaction
+  static constexpr std::uint8_t bremsstrahlung = 2;
+
+  /// \return the flags of the channels of the types of \p a and \p b
+  std::uint8_t channels(const ParticleData &a, const ParticleData &b) const {
+    // std::addressof, because ParticleType overloads operator&
+    const std::size_t i = std::addressof(a.type()) - first_type_;
+    const std::size_t j = std::addressof(b.type()) - first_type_;
+    return channels_[i * n_types_ + j];
+  }
+
+  /// First of the particle types the table was built for
+  const ParticleType *first_type_;
+  /// Number of particle types
+  std::size_t n_types_;
+  /// Flags of the channels of every pair of types
+  std::vector<std::uint8_t> channels_;
+};
+
+}  // namespace smash
+
+#endif  // SRC_INCLUDE_SMASH_PHOTONCHANNELS_H_
@@ -0,0 +1,61 @@
+/*
+ *
+ *    Copyright (c) 2024
+ *      SMASH Team
+ *
+ *    GNU General Public License (GPLv3 or later)
+ *
+ */
+
+#ifndef SRC_INCLUDE_SMASH_POOLALLOCATED_H_
+#define SRC_INCLUDE_SMASH_POOLALLOCATED_H_
+
+#include <cstddef>
+
+namespace smash {
+
+/**
+ * \ingroup data
+ *
+ * Base class for short-lived objects which are created in large numbers, like
+ * actions and their process branches.
+ *
+ * Objects of derived classes are allocated from free lists of each thread
+ * instead of the global heap. The memory of a deleted object is kept in the
+ * free list of its size and handed out again for the next object of similar
+ * size, such that in a steady state, e.g. from one time step to the next, no
+ * memory is requested from the system. The free lists are bounded and
+ * released when the thread ends. An object may be deleted by another thread
+ * than the one which created it.
+ *
+ * Deriving classes need a virtual destructor, such that the size of the
+ * deleted object is known.
+ */
+class PoolAllocated {
+ public:
+  /**
+   * Allocate memory for an object of a derived class.
+   *
+   * \param[in] size Size of the object in bytes
+   * \return Pointer to the memory
+   * \throw std::bad_alloc if no memory is available
+   */
+  static void *operator new(std::size_t size);
+
+  /**
+   * Return the memory of an object to the free list of this thread.
+   *
+   * \param[in] pointer Memory of the object
+   * \param[in] size Size of the object in bytes
+   */
+  static void operator delete(void *pointer, std::size_t size) noexcept;
+
+  /// Objects larger than this many bytes are allocated from the global heap
+  static constexpr std::size_t max_pooled_size = 1024;
+  /// Largest number of free blocks kept per size and thread
+  static constexpr std::size_t max_free_blocks = 1 << 16;
+};
+
+}  // namespace smash
+
+#endif  // SRC_INCLUDE_SMASH_POOLALLOCATED_H_
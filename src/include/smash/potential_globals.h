@@ -1,6 +1,6 @@
 /*
  *
- *    Copyright (c) 2018-2020
+ *    Copyright (c) 2018-2020,2024
  *      SMASH Team
  *
  *    GNU General Public License (GPLv3 or later)
@@ -24,6 +24,18 @@ extern RectangularLattice<FourVector> *UI3_lat_pointer;
 /// Pointer to a Potential class
 extern Potentials *pot_pointer;
 
+/**
+ * Take the potentials at a position from the lattices of the skyrme and
+ * symmetry potentials, where they exist. The nodes of the position are
+ * found once for both lattices, see RectangularLattice::gather_stencil.
+ *
+ * \param[in] r Position [fm]
+ * \param[inout] UB Skyrme potential, unchanged without its lattice, zero
+ *               outside of it
+ * \param[inout] UI3 Symmetry potential, like \p UB
+ */
+void gather_potentials(const ThreeVector &r, FourVector &UB, FourVector &UI3);
+
 }  // namespace smash
 
 #endif  // SRC_INCLUDE_SMASH_POTENTIAL_GLOBALS_H_
@@ -10,6 +10,7 @@
 #ifndef SRC_INCLUDE_SMASH_POTENTIALS_H_
 #define SRC_INCLUDE_SMASH_POTENTIALS_H_
 
+#include <functional>
 #include <tuple>
 #include <utility>
 #include <vector>
@@ -20,6 +21,7 @@
 #include "configuration.h"
 #include "density.h"
 #include "forwarddeclarations.h"
+#include "particlecelllist.h"
 #include "particledata.h"
 #include "rootsolver.h"
 #include "threevector.h"
@@ -67,6 +69,29 @@ class Potentials {
                                               const ThreeVector &momentum,
                                               double mass,
                                               ParticleList &plist) const {
+    const ParticleCellList cells(plist, param_.r_cut());
+    return single_particle_energy_gradient(
+        jB_lattice, position, momentum, mass,
+        [&cells]() -> const ParticleCellList & { return cells; });
+  }
+
+  /**
+   * Calculates the gradient of the single-particle energy like the function
+   * above, but asks for all particles only if the current has to be
+   * calculated outside of the lattice.
+   *
+   * \param jB_lattice Pointer to the baryon density lattice
+   * \param position Position of the particle of interest in fm
+   * \param momentum Momentum of the particle of interest in GeV
+   * \param mass Mass of the particle of interest in GeV
+   * \param plist Function returning all particles sorted into cells
+   * \return ThreeVector gradient of the single particle energy in the
+   * calculation frame in MeV/fm
+   */
+  ThreeVector single_particle_energy_gradient(
+      DensityLattice *jB_lattice, const ThreeVector &position,
+      const ThreeVector &momentum, double mass,
+      const std::function<const ParticleCellList &()> &plist) const {
     const std::array<double, 3> dr = (jB_lattice)
                                          ? jB_lattice->cell_sizes()
                                          : std::array<double, 3>{0.1, 0.1, 0.1};
@@ -82,7 +107,7 @@ class Potentials {
       if (jB_lattice && jB_lattice->value_at(position_left, jmu_left)) {
         net_4current_left = jmu_left.jmu_net();
       } else if (use_potentials_outside_lattice_) {
-        auto current = current_eckart(position_left, plist, param_,
+        auto current = current_eckart(position_left, plist(), param_,
                                       DensityType::Baryon, false, true);
         net_4current_left = std::get<1>(current);
       } else {
@@ -92,7 +117,7 @@ class Potentials {
       if (jB_lattice && jB_lattice->value_at(position_right, jmu_right)) {
         net_4current_right = jmu_right.jmu_net();
       } else if (use_potentials_outside_lattice_) {
-        auto current = current_eckart(position_right, plist, param_,
+        auto current = current_eckart(position_right, plist(), param_,
                                       DensityType::Baryon, false, true);
         net_4current_right = std::get<1>(current);
       } else {
@@ -195,6 +220,34 @@ class Potentials {
    */
   FourVector vdf_pot(double rhoB, const FourVector jmuB_net) const;
 
+  /**
+   * Evaluates the mean-field energy density of the Skyrme potential, whose
+   * derivative with respect to the density is the Skyrme potential. It is
+   * only exact in the rest frame and does not include the symmetry energy.
+   *
+   * \param[in] baryon_density Baryon density \f$\rho\f$ evaluated in the
+   *            local rest frame in fm\f$^{-3}\f$.
+   * \return Mean-field energy density \f[\epsilon = 10^{-3}\times\left(
+   *         \frac{A}{2}\frac{\rho^2}{\rho_0}+\frac{B}{\tau+1}
+   *         \frac{|\rho|^{\tau+1}}{\rho_0^\tau}\right)\f] in
+   *         GeV fm\f$^{-3}\f$
+   */
+  double skyrme_energy_density(double baryon_density) const;
+
+  /**
+   * Evaluates the mean-field energy density of the VDF potential given the
+   * rest frame density and the computational frame baryon density. It is
+   * correct in any frame.
+   *
+   * \param[in] rhoB rest frame baryon density, in fm\f$^{-3}\f$
+   * \param[in] j0B baryon density in the computational frame, in
+   *            fm\f$^{-3}\f$
+   * \return Mean-field energy density \f[\epsilon = \sum_i C_i
+   *         \rho^{b_i - 2}\frac{j_0^2 - \frac{b_i - 1}{b_i}\rho^2}
+   *         {\rho_0^{b_i - 1}}\f] in GeV fm\f$^{-3}\f$
+   */
+  double vdf_energy_density(double rhoB, double j0B) const;
+
   /**
    * Evaluates potential (Skyrme with optional Symmetry or VDF) at point r.
    * For Skyrme and Symmetry options, potential is always taken in the local
@@ -218,6 +271,20 @@ class Potentials {
   double potential(const ThreeVector &r, const ParticleList &plist,
                    const ParticleType &acts_on) const;
 
+  /**
+   * Evaluates the potential at point r like the function above, but only
+   * sums over the particles in the cells around r, which give the same
+   * result.
+   *
+   * \param[in] r Arbitrary space point where potential is calculated
+   * \param[in] cells All particles to be used in \f$j^{\mu}\f$ calculation,
+   *            sorted into cells at least \f$ r_{cut} \f$ large
+   * \param[in] acts_on Type of particle on which potential is going to act.
+   * \return Total potential energy acting on the particle
+   */
+  double potential(const ThreeVector &r, const ParticleCellList &cells,
+                   const ParticleType &acts_on) const;
+
   /**
    * Evaluates the scaling factor of the forces acting on the particles.
    *
@@ -429,6 +496,19 @@ class Potentials {
   virtual std::tuple<ThreeVector, ThreeVector, ThreeVector, ThreeVector>
   all_forces(const ThreeVector &r, const ParticleList &plist) const;
 
+  /**
+   * Evaluates the electric and magnetic components of the forces at point r
+   * like the function above, but only sums over the particles in the cells
+   * around r, which give the same result. The propagation uses this one.
+   *
+   * \param[in] r Arbitrary space point where potential gradient is calculated
+   * \param[in] cells All particles to be used in \f$j^{\mu}\f$ calculation,
+   *            sorted into cells at least \f$ r_{cut} \f$ large
+   * \return (\f$E_B, B_B, E_{I_3}, B_{I_3}\f$) [GeV/fm], see above
+   */
+  virtual std::tuple<ThreeVector, ThreeVector, ThreeVector, ThreeVector>
+  all_forces(const ThreeVector &r, const ParticleCellList &cells) const;
+
   /// \return Is Skyrme potential on?
   virtual bool use_skyrme() const { return use_skyrme_; }
   /// \return Is symmetry potential on?
@@ -460,9 +540,26 @@ class Potentials {
   /// \return Number of terms in the VDF potential
   int number_of_terms() const { return powers_.size(); }
 
+  /**
+   * Evaluates the factors in front of the baryon current and its derivatives
+   * in the VDF potential and force, which take one logarithm and one
+   * exponential per term.
+   *
+   * \param[in] rhoB rest frame baryon density, in fm\f$^{-3}\f$
+   * \return The factors \f[F_1 = 10^{-3}\times \sum_i C_i (b_i - 2)
+   *         \frac{\rho^{b_i - 3}}{\rho_0^{b_i - 1}}\f] in GeV fm\f$^6\f$ and
+   *         \f[F_2 = 10^{-3}\times \sum_i C_i
+   *         \frac{\rho^{b_i - 2}}{\rho_0^{b_i - 1}}\f] in GeV fm\f$^3\f$,
+   *         each with the sign of the density
+   */
+  std::pair<double, double> vdf_factors(double rhoB) const;
+
   /// \return cutoff radius in ntegration for coulomb potential in fm
   double coulomb_r_cut() const { return coulomb_r_cut_; }
 
+  /// \return Whether to calculate the Coulomb fields by Fourier transforms
+  bool coulomb_use_fft() const { return coulomb_use_fft_; }
+
   /**
    * \return Wether to take potentials into account for particles outside
    * of the lattice
@@ -471,7 +568,36 @@ class Potentials {
     return use_potentials_outside_lattice_;
   }
 
+  /// \return Parameters of the Gaussian smearing of the densities
+  const DensityParameters &density_parameters() const { return param_; }
+
  private:
+  /**
+   * Evaluates the potential at point r, see potential.
+   *
+   * \tparam T ParticleList or ParticleCellList
+   * \param[in] r Arbitrary space point where potential is calculated
+   * \param[in] particles Particles to be used in \f$j^{\mu}\f$ calculation
+   * \param[in] acts_on Type of particle on which potential is going to act
+   * \return Total potential energy acting on the particle
+   */
+  template <typename T>
+  double potential_impl(const ThreeVector &r, const T &particles,
+                        const ParticleType &acts_on) const;
+
+  /**
+   * Evaluates the electric and magnetic components of the forces at point r,
+   * see all_forces.
+   *
+   * \tparam T ParticleList or ParticleCellList
+   * \param[in] r Arbitrary space point where potential gradient is calculated
+   * \param[in] particles Particles to be used in \f$j^{\mu}\f$ calculation
+   * \return (\f$E_B, B_B, E_{I_3}, B_{I_3}\f$) [GeV/fm]
+   */
+  template <typename T>
+  std::tuple<ThreeVector, ThreeVector, ThreeVector, ThreeVector>
+  all_forces_impl(const ThreeVector &r, const T &particles) const;
+
   /**
    * Struct that contains the gaussian smearing width \f$\sigma\f$,
    * the distance cutoff \f$r_{\rm cut}\f$ and the testparticle number
@@ -543,6 +669,9 @@ class Potentials {
   /// Cutoff in integration for coulomb potential
   double coulomb_r_cut_;
 
+  /// Whether the Coulomb fields are calculated by Fourier transforms
+  bool coulomb_use_fft_ = false;
+
   /// Wether potentials should be included outside of the lattice
   bool use_potentials_outside_lattice_;
 
@@ -555,6 +684,8 @@ class Potentials {
   std::vector<double> coeffs_;
   /// Parameters of the VDF potential: exponents \f$b_i\f$
   std::vector<double> powers_;
+  /// Coefficients of the VDF potential divided by \f$\rho_0^{b_i - 1}\f$
+  std::vector<double> scaled_coeffs_;
 
   /**
    * Calculate the derivative of the symmetry potential with respect to
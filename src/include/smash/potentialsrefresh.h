@@ -0,0 +1,343 @@
+/*
+ *
+ *    Copyright (c) 2024
+ *      SMASH Team
+ *
+ *    GNU General Public License (GPLv3 or later)
+ *
+ */
+
+#ifndef SRC_INCLUDE_SMASH_POTENTIALSREFRESH_H_
+#define SRC_INCLUDE_SMASH_POTENTIALSREFRESH_H_
+
+#include <algorithm>
+#include <iosfwd>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <variant>
+#include <vector>
+
+#include "checkpoint.h"
+#include "density.h"
+#include "lattice.h"
+#include "precision.h"
+#include "threevector.h"
+
+namespace smash {
+
+/**
+ * \ingroup data
+ *
+ * Decides in which time steps the lattices of the potentials are
+ * recalculated, if they may be extrapolated in between.
+ *
+ * After every recalculation, the density on every n-th node of the lattice
+ * is compared to the one of the previous recalculation. The largest change
+ * per time step, in units of the nuclear ground state density, decides how
+ * many time steps the next recalculation may be postponed: as many as keep
+ * the change below the threshold, at most twice as many as before and at
+ * most the largest interval. In the time steps in between, the potentials
+ * are extrapolated linearly in time from the last two recalculations, see
+ * LatticeHistory.
+ *
+ * The deviations of the extrapolated potentials from the recalculated ones
+ * are collected for the report at the end of the time evolution.
+ */
+class PotentialsRefresh {
+ public:
+  /**
+   * \param[in] max_interval Largest number of time steps between two
+   *            recalculations
+   * \param[in] threshold Largest change of the density per time step in
+   *            units of the nuclear ground state density, up to which the
+   *            recalculation is postponed
+   * \throw std::invalid_argument if the interval is not positive or the
+   *        threshold is negative.
+   */
+  PotentialsRefresh(int max_interval, double threshold);
+
+  /// Start a new event, which is recalculated in its first time steps.
+  void reset();
+
+  /**
+   * Advance by one time step.
+   *
+   * \return Whether the potentials are recalculated in this time step
+   */
+  bool next_timestep();
+
+  /**
+   * \return Number of time steps since the last recalculation, including
+   *         the current one
+   */
+  int steps_since_refresh() const { return steps_since_refresh_; }
+
+  /**
+   * Compare the density after a recalculation to the one of the previous
+   * recalculation and choose the number of time steps until the next one.
+   *
+   * \param[in] density Lattice of the density the potentials depend on
+   */
+  void refreshed(const DensityLattice &density);
+
+  /**
+   * Collect the deviation of the extrapolated potentials from the
+   * recalculated ones.
+   *
+   * \param[in] deviation Largest deviation on the nodes [GeV]
+   */
+  void add_deviation(double deviation);
+
+  /// \return Summary of the recalculations and their deviations
+  std::string report() const;
+
+  /**
+   * Write the state within the event to a checkpoint.
+   *
+   * \param[out] out Stream of the checkpoint
+   */
+  void write_checkpoint(std::ostream &out) const;
+
+  /**
+   * Replace the state within the event with the one of a checkpoint.
+   *
+   * \param[in] in Stream of the checkpoint
+   */
+  void read_checkpoint(std::istream &in);
+
+ private:
+  /// Largest number of time steps between two recalculations
+  const int max_interval_;
+  /// Largest change of the density per time step [\f$\rho_0\f$]
+  const double threshold_;
+  /// Number of time steps between the last and the next recalculation
+  int interval_ = 1;
+  /// Time steps since the last recalculation
+  int steps_since_refresh_ = 0;
+  /// Density on the sampled nodes at the last recalculation
+  std::vector<double> sampled_density_;
+  /// Number of time steps of the event
+  int n_timesteps_ = 0;
+  /// Number of recalculations in the event
+  int n_refreshes_ = 0;
+  /// Largest deviation of the extrapolated potentials [GeV]
+  double max_deviation_ = 0.;
+};
+
+/**
+ * \ingroup data
+ *
+ * Values on a lattice at the last two times they were calculated, from which
+ * they are extrapolated linearly in time.
+ *
+ * The recorded values are kept either in double or in single precision, see
+ * DoublePrecision and SinglePrecision, while the extrapolation is always
+ * computed in double precision. Checkpoints hold the values in double
+ * precision either way.
+ *
+ * \tparam T Type of the values, which are either added up and scaled
+ * themselves or are pairs of such values.
+ */
+template <typename T>
+class LatticeHistory {
+ public:
+  /**
+   * Create an empty history.
+   *
+   * \param[in] single_precision Whether the values are recorded in single
+   *            precision
+   */
+  explicit LatticeHistory(bool single_precision = false) {
+    if (single_precision) {
+      records_ = Records<SinglePrecision<T>>();
+    }
+  }
+
+  /// Forget the recorded values.
+  void clear() { n_records_ = 0; }
+
+  /// \return Whether the values are recorded in single precision
+  bool single_precision() const {
+    return std::holds_alternative<Records<SinglePrecision<T>>>(records_);
+  }
+
+  /**
+   * Write the recorded values to a checkpoint.
+   *
+   * \param[out] out Stream of the checkpoint
+   */
+  void write_checkpoint(std::ostream &out) const {
+    std::visit([&out](const auto &records) { records.write_checkpoint(out); },
+               records_);
+    checkpoint::write(out, last_time_);
+    checkpoint::write(out, previous_time_);
+    checkpoint::write(out, n_records_);
+  }
+
+  /**
+   * Replace the recorded values with the ones of a checkpoint.
+   *
+   * \param[in] in Stream of the checkpoint
+   */
+  void read_checkpoint(std::istream &in) {
+    std::visit([&in](auto &records) { records.read_checkpoint(in); },
+               records_);
+    checkpoint::read(in, last_time_);
+    checkpoint::read(in, previous_time_);
+    checkpoint::read(in, n_records_);
+  }
+
+  /**
+   * Record the values on a lattice.
+   *
+   * \param[in] lat Lattice of the values
+   * \param[in] time Time of the values [fm]
+   * \tparam P Precision policy of the lattice
+   */
+  template <typename P>
+  void record(const RectangularLattice<T, P> &lat, double time) {
+    std::visit([&lat](auto &records) { records.record(lat); }, records_);
+    previous_time_ = last_time_;
+    last_time_ = time;
+    n_records_++;
+  }
+
+  /**
+   * \param[in] index Index of the node
+   * \param[in] time Time of the extrapolation [fm]
+   * \return Value on a node extrapolated from the last two records, or the
+   *         last record if there is only one
+   */
+  T predict(int index, double time) const {
+    return std::visit(
+        [&](const auto &records) { return predict(records, index, time); },
+        records_);
+  }
+
+  /**
+   * Overwrite a lattice with the extrapolated values, if any were recorded.
+   *
+   * \param[out] lat Lattice to be overwritten
+   * \param[in] time Time of the extrapolation [fm]
+   * \tparam P Precision policy of the lattice
+   */
+  template <typename P>
+  void extrapolate(RectangularLattice<T, P> &lat, double time) const {
+    if (n_records_ == 0) {
+      return;
+    }
+    std::visit(
+        [&](const auto &records) {
+          const int n_nodes = lat.size();
+          for (int i = 0; i < n_nodes; i++) {
+            lat.set(i, predict(records, i, time));
+          }
+        },
+        records_);
+  }
+
+ private:
+  /**
+   * Values of the last two records, stored with a precision policy.
+   *
+   * \tparam Precision Precision policy, see DoublePrecision
+   */
+  template <typename Precision>
+  struct Records {
+    /// Values at the last record
+    std::vector<typename Precision::type> last;
+    /// Values at the record before
+    std::vector<typename Precision::type> previous;
+
+    /// Record the values on a lattice, see LatticeHistory::record.
+    template <typename P>
+    void record(const RectangularLattice<T, P> &lat) {
+      std::swap(previous, last);
+      last.resize(lat.size());
+      for (std::size_t i = 0; i < last.size(); i++) {
+        last[i] = Precision::pack(lat.get(i));
+      }
+    }
+
+    /// Write the values in double precision to a checkpoint.
+    void write_checkpoint(std::ostream &out) const {
+      for (const auto *values : {&last, &previous}) {
+        if constexpr (std::is_same_v<typename Precision::type, T>) {
+          checkpoint::write(out, *values);
+        } else {
+          std::vector<T> unpacked(values->size());
+          std::transform(values->begin(), values->end(), unpacked.begin(),
+                         [](const typename Precision::type &stored) {
+                           return Precision::unpack(stored);
+                         });
+          checkpoint::write(out, unpacked);
+        }
+      }
+    }
+
+    /// Read the values written by write_checkpoint.
+    void read_checkpoint(std::istream &in) {
+      for (auto *values : {&last, &previous}) {
+        if constexpr (std::is_same_v<typename Precision::type, T>) {
+          checkpoint::read(in, *values);
+        } else {
+          std::vector<T> unpacked;
+          checkpoint::read(in, unpacked);
+          values->resize(unpacked.size());
+          std::transform(
+              unpacked.begin(), unpacked.end(), values->begin(),
+              [](const T &value) { return Precision::pack(value); });
+        }
+      }
+    }
+  };
+
+  /**
+   * \param[in] records Recorded values
+   * \param[in] index Index of the node
+   * \param[in] time Time of the extrapolation [fm]
+   * \return Extrapolated value on a node, see predict
+   */
+  template <typename Precision>
+  T predict(const Records<Precision> &records, int index, double time) const {
+    const T last = Precision::unpack(records.last[index]);
+    if (n_records_ < 2) {
+      return last;
+    }
+    const double weight = (time - last_time_) / (last_time_ - previous_time_);
+    return extrapolate_value(last, Precision::unpack(records.previous[index]),
+                             weight);
+  }
+
+  /**
+   * \param[in] last Last value
+   * \param[in] previous Previous value
+   * \param[in] weight Time since the last value divided by the time between
+   *            both
+   * \return Extrapolated value
+   */
+  static T extrapolate_value(const T &last, const T &previous, double weight) {
+    if constexpr (std::is_same_v<T, std::pair<ThreeVector, ThreeVector>>) {
+      return std::make_pair(
+          last.first + (last.first - previous.first) * weight,
+          last.second + (last.second - previous.second) * weight);
+    } else {
+      return last + (last - previous) * weight;
+    }
+  }
+
+  /// Values of the last two records in the chosen precision
+  std::variant<Records<DoublePrecision<T>>, Records<SinglePrecision<T>>>
+      records_;
+  /// Time of the last record [fm]
+  double last_time_ = 0.;
+  /// Time of the record before [fm]
+  double previous_time_ = 0.;
+  /// Number of records
+  int n_records_ = 0;
+};
+
+}  // namespace smash
+
+#endif  // SRC_INCLUDE_SMASH_POTENTIALSREFRESH_H_
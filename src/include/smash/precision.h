@@ -0,0 +1,120 @@
+/*
+ *
+ *    Copyright (c) 2024
+ *      SMASH Team
+ *
+ *    GNU General Public License (GPLv3 or later)
+ *
+ */
+
+#ifndef SRC_INCLUDE_SMASH_PRECISION_H_
+#define SRC_INCLUDE_SMASH_PRECISION_H_
+
+#include <array>
+#include <utility>
+
+#include "fourvector.h"
+#include "threevector.h"
+
+namespace smash {
+
+/**
+ * \ingroup data
+ *
+ * Precision policy, which stores values as they are, i.e. in double
+ * precision.
+ *
+ * A precision policy tells the type in which values of type \p T are stored
+ * and converts them to and from it with pack() and unpack(). Computations
+ * are always done with the unpacked values.
+ *
+ * \tparam T Type of the values
+ */
+template <typename T>
+struct DoublePrecision {
+  /// Type in which the values are stored
+  using type = T;
+  /// \return The value to be stored
+  static const type &pack(const T &value) { return value; }
+  /// \return The stored value
+  static const T &unpack(const type &stored) { return stored; }
+};
+
+/**
+ * \ingroup data
+ *
+ * Precision policy, which stores the components of the values as single
+ * precision floats, see DoublePrecision. This halves the memory of values,
+ * whose relative precision of about \f$10^{-7}\f$ is not needed, e.g. of
+ * smeared densities. It is specialized for doubles, ThreeVector, FourVector
+ * and pairs of them.
+ *
+ * \tparam T Type of the values
+ */
+template <typename T>
+struct SinglePrecision;
+
+/// Doubles stored as single precision floats, see SinglePrecision.
+template <>
+struct SinglePrecision<double> {
+  /// Type in which the values are stored
+  using type = float;
+  /// \return The value to be stored
+  static type pack(double value) { return static_cast<float>(value); }
+  /// \return The stored value
+  static double unpack(type stored) { return stored; }
+};
+
+/// ThreeVector stored as single precision floats, see SinglePrecision.
+template <>
+struct SinglePrecision<ThreeVector> {
+  /// Type in which the values are stored
+  using type = std::array<float, 3>;
+  /// \return The value to be stored
+  static type pack(const ThreeVector &value) {
+    return {static_cast<float>(value.x1()), static_cast<float>(value.x2()),
+            static_cast<float>(value.x3())};
+  }
+  /// \return The stored value
+  static ThreeVector unpack(const type &stored) {
+    return ThreeVector(stored[0], stored[1], stored[2]);
+  }
+};
+
+/// FourVector stored as single precision floats, see SinglePrecision.
+template <>
+struct SinglePrecision<FourVector> {
+  /// Type in which the values are stored
+  using type = std::array<float, 4>;
+  /// \return The value to be stored
+  static type pack(const FourVector &value) {
+    return {static_cast<float>(value.x0()), static_cast<float>(value.x1()),
+            static_cast<float>(value.x2()), static_cast<float>(value.x3())};
+  }
+  /// \return The stored value
+  static FourVector unpack(const type &stored) {
+    return FourVector(stored[0], stored[1], stored[2], stored[3]);
+  }
+};
+
+/// Pairs stored element by element, see SinglePrecision.
+template <typename T, typename U>
+struct SinglePrecision<std::pair<T, U>> {
+  /// Type in which the values are stored
+  using type = std::pair<typename SinglePrecision<T>::type,
+                         typename SinglePrecision<U>::type>;
+  /// \return The value to be stored
+  static type pack(const std::pair<T, U> &value) {
+    return {SinglePrecision<T>::pack(value.first),
+            SinglePrecision<U>::pack(value.second)};
+  }
+  /// \return The stored value
+  static std::pair<T, U> unpack(const type &stored) {
+    return {SinglePrecision<T>::unpack(stored.first),
+            SinglePrecision<U>::unpack(stored.second)};
+  }
+};
+
+}  // namespace smash
+
+#endif  // SRC_INCLUDE_SMASH_PRECISION_H_
@@ -15,6 +15,7 @@
 #include "decaytype.h"
 #include "forwarddeclarations.h"
 #include "particletype.h"
+#include "poolallocated.h"
 
 namespace smash {
 
@@ -126,7 +127,7 @@ std::ostream &operator<<(std::ostream &os, ProcessType process_type);
  * deltaplus_decay_modes.push_back(branch);
  * \endcode
  */
-class ProcessBranch {
+class ProcessBranch : public PoolAllocated {
  public:
   /// Create a ProcessBranch without final states and weight.
   ProcessBranch() : branch_weight_(0.) {}
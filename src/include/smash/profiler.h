@@ -0,0 +1,367 @@
+/*
+ *
+ *    Copyright (c) 2024
+ *      SMASH Team
+ *
+ *    GNU General Public License (GPLv3 or later)
+ *
+ */
+
+#ifndef SRC_INCLUDE_SMASH_PROFILER_H_
+#define SRC_INCLUDE_SMASH_PROFILER_H_
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace smash {
+
+/**
+ * \ingroup output
+ *
+ * Measures the real time spent in the phases of the time evolution, like the
+ * grid construction, the action finding or the output.
+ *
+ * A phase is measured with a ScopedTimer for the scope of its code. If timers
+ * are nested, the time of the inner phase is not counted for the outer one.
+ * Timers in different threads are independent, such that phases which run in
+ * several threads at the same time are summed over the threads, and their
+ * time can exceed the wall time.
+ *
+ * The times are collected per event and summed up over the run. Both can be
+ * formatted as a table, and the run is also written as a JSON file.
+ *
+ * Optionally, hardware events like cycles, instructions, cache misses and
+ * mispredicted branches are counted per phase as well, see enable_counters.
+ *
+ * Optionally, the single measurements of the first events are recorded as
+ * spans with their thread and written in the Chrome trace event format,
+ * which can be viewed with Perfetto or chrome://tracing. Besides the phases,
+ * spans can be recorded with ScopedSpan for code which is not a phase of
+ * its own, like a time step or a single string fragmentation.
+ */
+class Profiler {
+ public:
+  /// Phases of the time evolution, which are measured
+  enum class Phase : int {
+    /// Sampling of the initial conditions, initial output
+    Initialization,
+    /// Construction and update of the collision-finding grid
+    Grid,
+    /// Search for actions, including the cross sections
+    ActionFinding,
+    /// Fragmentation of strings in advance
+    Strings,
+    /// Performing the actions, including the output of interactions
+    Actions,
+    /// Propagation of the particles and dilepton shining
+    Propagation,
+    /// Update of the densities on the lattices and the potentials
+    Potentials,
+    /// Intermediate and final output
+    Output,
+    /// Finding the decays at the end of the event
+    FinalDecays
+  };
+
+  /// Number of phases
+  static constexpr int n_phases = 9;
+
+  /**
+   * \param[in] phase Phase
+   * \return Name of the phase, as written in the tables and the JSON file
+   */
+  static const char *name(Phase phase);
+
+  /// Hardware events, which are counted per phase if enabled
+  enum class Counter : int {
+    /// CPU cycles
+    Cycles,
+    /// Retired instructions
+    Instructions,
+    /// Misses of the last-level cache
+    CacheMisses,
+    /// Mispredicted branches
+    BranchMisses
+  };
+
+  /// Number of counted hardware events
+  static constexpr int n_counters = 4;
+
+  /// Values of all hardware counters
+  using Counts = std::array<std::uint64_t, n_counters>;
+
+  /**
+   * \param[in] counter Hardware event
+   * \return Name of the event, as written in the JSON file
+   */
+  static const char *name(Counter counter);
+
+  /**
+   * Measures the real time until it is destroyed, except for the time of
+   * timers created within its lifetime in the same thread.
+   */
+  class ScopedTimer {
+   public:
+    /**
+     * Start measuring a phase.
+     *
+     * \param[in] profiler Profiler which collects the time, nothing is
+     *            measured if it is null
+     * \param[in] phase Measured phase
+     * \param[in] ensemble Ensemble which is processed, shown in the trace,
+     *            or -1 if the phase is not specific to an ensemble
+     */
+    ScopedTimer(Profiler *profiler, Phase phase, int ensemble = -1);
+
+    /// Add the measured time to the profiler.
+    ~ScopedTimer();
+
+    /// Cannot be copied
+    ScopedTimer(const ScopedTimer &) = delete;
+    /// Cannot be copied
+    ScopedTimer &operator=(const ScopedTimer &) = delete;
+
+   private:
+    /**
+     * Add the time and the hardware events since the last start to the
+     * profiler.
+     *
+     * \param[in] now Current time
+     * \param[in] counts Current values of the hardware counters
+     */
+    void stop(std::chrono::steady_clock::time_point now, const Counts &counts);
+
+    /// Profiler collecting the time, null if disabled
+    Profiler *profiler_;
+    /// Measured phase
+    Phase phase_;
+    /// Processed ensemble, -1 if none
+    int ensemble_;
+    /// Time when the timer was created
+    std::chrono::steady_clock::time_point begin_;
+    /// Time since which the phase is measured
+    std::chrono::steady_clock::time_point start_;
+    /// Values of the hardware counters since which the phase is measured
+    Counts start_counts_{};
+    /// Enclosing timer in the same thread, which is paused meanwhile
+    ScopedTimer *parent_ = nullptr;
+    /// Innermost running timer of the thread
+    static thread_local ScopedTimer *current_;
+  };
+
+  /**
+   * Records a span in the trace until it is destroyed, without affecting the
+   * times of the phases.
+   */
+  class ScopedSpan {
+   public:
+    /**
+     * Start a span.
+     *
+     * \param[in] profiler Profiler recording the span, nothing is recorded if
+     *            it is null or the event is not traced
+     * \param[in] name Name of the span, must outlive the profiler
+     * \param[in] ensemble Ensemble which is processed, or -1
+     */
+    ScopedSpan(Profiler *profiler, const char *name, int ensemble = -1);
+
+    /// Record the span.
+    ~ScopedSpan();
+
+    /// Cannot be copied
+    ScopedSpan(const ScopedSpan &) = delete;
+    /// Cannot be copied
+    ScopedSpan &operator=(const ScopedSpan &) = delete;
+
+   private:
+    /// Profiler recording the span, null if disabled
+    Profiler *profiler_;
+    /// Name of the span
+    const char *name_;
+    /// Processed ensemble, -1 if none
+    int ensemble_;
+    /// Start of the span
+    std::chrono::steady_clock::time_point begin_;
+  };
+
+  /**
+   * Create a profiler.
+   *
+   * \param[in] json_path Path of the JSON file written by write_json
+   */
+  explicit Profiler(std::filesystem::path json_path);
+
+  /**
+   * Record the spans of the first events for write_trace.
+   *
+   * \param[in] trace_path Path of the trace file written by write_trace
+   * \param[in] n_events Number of traced events, starting with event 0
+   * \param[in] max_spans Largest number of spans recorded per event, further
+   *            spans of the event are dropped
+   */
+  void enable_trace(std::filesystem::path trace_path, int n_events,
+                    std::size_t max_spans);
+
+  /// \return Whether spans are recorded for some events
+  bool is_tracing() const { return trace_events_ > 0; }
+
+  /**
+   * Count the hardware events of every phase, which are read from the
+   * performance counters of the CPU with perf_event_open on Linux. Every
+   * thread counts its own events, which are summed like the times.
+   *
+   * \return Whether the counters could be opened. If not, e.g. because SMASH
+   *         was built without perf_event_open or the kernel does not permit
+   *         it, they stay disabled.
+   */
+  bool enable_counters();
+
+  /// \return Whether hardware events are counted
+  bool is_counting() const { return counting_; }
+
+  /**
+   * Start measuring a new event.
+   *
+   * \param[in] event_number Number of the event, which decides whether it is
+   *            traced
+   */
+  void start_event(int event_number);
+
+  /**
+   * Finish measuring the current event.
+   *
+   * \param[in] event_number Number of the event
+   * \param[in] n_particles Number of particles at the end of the event, to
+   *            which the cache misses are normalized in the JSON file
+   * \return Table of the phases of the event
+   */
+  std::string end_event(int event_number, std::int64_t n_particles = 0);
+
+  /**
+   * Add the events measured by another profiler, e.g. of an event worker.
+   *
+   * \param[in] other Profiler whose events are added
+   */
+  void merge(const Profiler &other);
+
+  /// \return Table of the phases summed over all events
+  std::string run_table() const;
+
+  /**
+   * Write the times of all events and their sum as JSON file, together with
+   * the hardware events, the instructions per cycle and the cache misses per
+   * particle if they are counted.
+   *
+   * \throw std::runtime_error if the file cannot be written
+   */
+  void write_json() const;
+
+  /**
+   * Write the recorded spans in the Chrome trace event format. Every event is
+   * shown as a process, and the spans are grouped by thread.
+   *
+   * \throw std::runtime_error if the file cannot be written
+   */
+  void write_trace() const;
+
+ private:
+  /// Times of all phases of one event and its wall time [s]
+  struct Record {
+    /// Number of the event, -1 for the sum over events
+    int event = -1;
+    /// Wall time from start_event to end_event [s]
+    double wall_time = 0.;
+    /// Times of the phases [s]
+    std::array<double, n_phases> phases{};
+    /// Number of particles at the end of the event
+    std::int64_t particles = 0;
+    /// Hardware events of the phases
+    std::array<Counts, n_phases> counts{};
+  };
+
+  /**
+   * \param[in] title First line of the table
+   * \param[in] record Times to be shown
+   * \return Table of the phases with their times and shares of the wall time
+   */
+  static std::string table(const std::string &title, const Record &record);
+
+  /// Measurement recorded in the trace
+  struct Span {
+    /// Name of the span
+    const char *name;
+    /// Event of the span
+    int event;
+    /// Number of the thread, counted from 0 in order of first use
+    int thread;
+    /// Processed ensemble, -1 if none
+    int ensemble;
+    /// Start since the start of the program [us]
+    double start;
+    /// Duration [us]
+    double duration;
+  };
+
+  /// \return Sum of all events
+  Record total() const;
+
+  /**
+   * Record a span, if the current event is traced and the limit of spans is
+   * not reached.
+   *
+   * \param[in] name Name of the span
+   * \param[in] ensemble Processed ensemble, or -1
+   * \param[in] begin Start of the span
+   * \param[in] end End of the span
+   */
+  void add_span(const char *name, int ensemble,
+                std::chrono::steady_clock::time_point begin,
+                std::chrono::steady_clock::time_point end);
+
+  /// Path of the JSON file
+  const std::filesystem::path json_path_;
+
+  /// Start of the current event
+  std::chrono::steady_clock::time_point event_start_;
+
+  /// Times of the phases in the current event [ns], added to by all threads
+  std::array<std::atomic<std::int64_t>, n_phases> event_times_{};
+
+  /// Whether hardware events are counted
+  bool counting_ = false;
+  /// Hardware events of the phases in the current event, added to by all
+  /// threads
+  std::array<std::array<std::atomic<std::uint64_t>, n_counters>, n_phases>
+      event_counts_{};
+
+  /// Finished events
+  std::vector<Record> events_;
+
+  /// Path of the trace file
+  std::filesystem::path trace_path_;
+  /// Number of traced events, 0 if tracing is disabled
+  int trace_events_ = 0;
+  /// Largest number of spans per event
+  std::size_t max_spans_ = 0;
+  /// Number of the current event, if it is traced, -1 otherwise
+  int traced_event_ = -1;
+  /// Number of spans of the current event
+  std::size_t event_spans_ = 0;
+  /// Number of spans dropped because of the limit
+  std::size_t dropped_spans_ = 0;
+  /// Guards the spans, which are added by all threads
+  mutable std::mutex spans_mutex_;
+  /// Recorded spans of all traced events
+  std::vector<Span> spans_;
+};
+
+}  // namespace smash
+
+#endif  // SRC_INCLUDE_SMASH_PROFILER_H_
@@ -1,5 +1,5 @@
 /*
- *    Copyright (c) 2013-2023
+ *    Copyright (c) 2013-2024
  *      SMASH Team
  *
  *    GNU General Public License (GPLv3 or later)
@@ -8,6 +8,7 @@
 #ifndef SRC_INCLUDE_SMASH_PROPAGATION_H_
 #define SRC_INCLUDE_SMASH_PROPAGATION_H_
 
+#include <array>
 #include <utility>
 #include <vector>
 
@@ -65,12 +66,20 @@ double calc_hubble(double time, const ExpansionProperties &metric);
  *            The the Fermi momenta are only used for collisions,
  *            but not for propagation. In this case beam_momentum
  *            is used for propagating the initial nucleons. [GeV]
+ * \param[out] min_and_length (optional) Minimum coordinates and lengths of
+ *             the box around the propagated particles, which are found in
+ *             the same pass, such that the grid of the next time step need
+ *             not look at all particles once more. Left unchanged if there
+ *             are no particles.
  * \return dt time interval of propagation which is equal to the
  *            difference between the final time and the initial
  *            time read from the 4-position of the particle.
  */
-double propagate_straight_line(Particles *particles, double to_time,
-                               const std::vector<FourVector> &beam_momentum);
+double propagate_straight_line(
+    Particles *particles, double to_time,
+    const std::vector<FourVector> &beam_momentum,
+    std::pair<std::array<double, 3>, std::array<double, 3>> *min_and_length =
+        nullptr);
 
 /**
  * Modifies positions and momentum of all particles to account for
@@ -101,13 +110,19 @@ void expand_space_time(Particles *particles,
  *            components of the symmetry force
  * \param[in] EM_lat Lattice for the electric and magnetic field
  * \param[in] jB_lat Lattice of the net baryon density
+ * \param[in] pool Threads updating the particles in parallel, serial if
+ *            nullptr
+ * \return Smallest time scale \f$p^0/|\vec{F}|\f$ of the change of the
+ *         momenta [fm], infinite if there are no forces
+ *
+ * The particles of all ensembles are only copied to a common list, if the
+ * potentials have to be calculated from the particles, because they are
+ * outside of the lattices.
  */
-void update_momenta(
+double update_momenta(
     std::vector<Particles> &particles, double dt, const Potentials &pot,
-    RectangularLattice<std::pair<ThreeVector, ThreeVector>> *FB_lat,
-    RectangularLattice<std::pair<ThreeVector, ThreeVector>> *FI3_lat,
-    RectangularLattice<std::pair<ThreeVector, ThreeVector>> *EM_lat,
-    DensityLattice *jB_lat);
+    ForceLattice *FB_lat, ForceLattice *FI3_lat, ForceLattice *EM_lat,
+    DensityLattice *jB_lat, ThreadPool *pool = nullptr);
 
 }  // namespace smash
 #endif  // SRC_INCLUDE_SMASH_PROPAGATION_H_
@@ -1,6 +1,6 @@
 /*
  *
- *    Copyright (c) 2020,2022
+ *    Copyright (c) 2020,2022,2024
  *      SMASH Team
  *
  *    GNU General Public License (GPLv3 or later)
@@ -23,9 +23,12 @@ namespace smash {
 /**
  * This class:
  * - Calculates chemical potentials given density of particle species
- * - Calculates maxima of a Juttner distribution for these chemical potentials
+ * - Tabulates the Juttner distribution for these chemical potentials
  * - Samples Juttner distribution. This is the main intent of this class,
  *   while previous points are auxiliary calculations for it.
+ *
+ * The set up only depends on the multiplicities, the volume and the
+ * temperature, so it is meant to be done once and used for all events.
  */
 
 class QuantumSampling {
@@ -145,17 +148,17 @@ class QuantumSampling {
 
   /**
    * Sampling radial momenta of given particle species from Boltzmann, Bose, or
-   * Fermi distribution. This sampler uses the simplest rejection sampling.
+   * Fermi distribution. The distribution is inverted on the tabulated
+   * cumulative distribution, so no random numbers are rejected.
    * \param[in] pdg the pdg code of the sampled particle species
    * return the sampled momentum [GeV]
+   * \throw std::out_of_range if the species is not sampled
    */
-  double sample(const PdgCode pdg);
+  double sample(const PdgCode pdg) const;
 
  private:
-  /// Tabulated effective chemical potentials for every particle species
-  std::map<PdgCode, double> effective_chemical_potentials_;
-  /// Tabulated distribution function maxima for every particle species
-  std::map<PdgCode, double> distribution_function_maximums_;
+  /// Tabulated momentum distributions for every particle species
+  std::map<PdgCode, random::piecewise_constant_dist> momentum_distributions_;
   /// Volume [fm^3] in which particles sre sampled
   const double volume_;
   /// Temperature [GeV]
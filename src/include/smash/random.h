@@ -1,6 +1,6 @@
 /*
  *
- *    Copyright (c) 2012-2020
+ *    Copyright (c) 2012-2020,2024
  *      SMASH Team
  *
  *    GNU General Public License (GPLv3 or later)
@@ -10,8 +10,12 @@
 #ifndef SRC_INCLUDE_SMASH_RANDOM_H_
 #define SRC_INCLUDE_SMASH_RANDOM_H_
 
+#include <algorithm>
+#include <array>
 #include <cassert>
+#include <cstdint>
 #include <limits>
+#include <memory>
 #include <random>
 #include <utility>
 #include <vector>
@@ -23,11 +27,217 @@ namespace smash {
 
 namespace random {
 
-/// The random number engine used is the Mersenne Twister.
-using Engine = std::mt19937_64;
+/**
+ * Counter-based random number engine Philox4x64-10 \cite Salmon2011.
+ *
+ * The engine applies a keyed bijection to a counter, such that the n-th
+ * random number of a stream is obtained without generating the previous
+ * ones. Different keys yield statistically independent streams. Here, the
+ * key consists of the seed and a stream number, e.g. the index of an ensemble,
+ * such that independent streams are derived from one seed without any
+ * bookkeeping. The state is small enough to be cheaply copied around.
+ *
+ * The engine satisfies the requirements of RandomNumberEngine and can
+ * therefore be used with the distributions of the standard library.
+ */
+class Philox4x64 {
+ public:
+  /// Type of generated random numbers
+  using result_type = uint64_t;
+  /// Seed used by the default constructor
+  static constexpr result_type default_seed = 0;
+
+  /// Create an engine with default seed and stream.
+  Philox4x64() : Philox4x64(default_seed) {}
+
+  /**
+   * Create an engine for the given random stream.
+   *
+   * \param[in] seed Seed of the engine
+   * \param[in] stream Number of the stream for the given seed
+   */
+  explicit Philox4x64(result_type seed, result_type stream = 0) {
+    this->seed(seed, stream);
+  }
+
+  /**
+   * Reset the engine to the beginning of the given random stream.
+   *
+   * \param[in] seed Seed of the engine
+   * \param[in] stream Number of the stream for the given seed
+   */
+  void seed(result_type seed, result_type stream = 0) {
+    key_ = {seed, stream};
+    set_position(0);
+  }
+
+  /// \return Smallest value generated by the engine.
+  static constexpr result_type min() { return 0; }
+  /// \return Largest value generated by the engine.
+  static constexpr result_type max() {
+    return std::numeric_limits<result_type>::max();
+  }
+
+  /// \return The next random number of the stream.
+  result_type operator()() {
+    if (index_ == block_size) {
+      block_ = bijection({counter_++, 0, 0, 0}, key_);
+      index_ = 0;
+    }
+    return block_[index_++];
+  }
+
+  /**
+   * Skip random numbers of the stream in constant time.
+   *
+   * \param[in] n Number of skipped random numbers
+   */
+  void discard(uint64_t n) { set_position(position() + n); }
+
+  /// \return Number of random numbers generated since the stream beginning.
+  uint64_t position() const {
+    return index_ == block_size ? block_size * counter_
+                                : block_size * (counter_ - 1) + index_;
+  }
 
-/// The engine that is used commonly by all distributions.
-extern /*thread_local (see #3075)*/ Engine engine;
+  /**
+   * Seek to a position in the stream.
+   *
+   * \param[in] position Number of random numbers to be skipped from the
+   *                     beginning of the stream
+   */
+  void set_position(uint64_t position) {
+    counter_ = position / block_size;
+    index_ = position % block_size;
+    if (index_ == 0) {
+      index_ = block_size;
+    } else {
+      block_ = bijection({counter_++, 0, 0, 0}, key_);
+    }
+  }
+
+  /**
+   * The Philox4x64-10 bijection of a counter for a given key.
+   *
+   * \param[in] counter Counter to be transformed
+   * \param[in] key Key of the transformation
+   * \return The four random numbers corresponding to the counter
+   */
+  static std::array<uint64_t, 4> bijection(std::array<uint64_t, 4> counter,
+                                           std::array<uint64_t, 2> key) {
+    constexpr uint64_t multiplier0 = 0xD2E7470EE14C6C93;
+    constexpr uint64_t multiplier1 = 0xCA5A826395121157;
+    constexpr uint64_t weyl0 = 0x9E3779B97F4A7C15;
+    constexpr uint64_t weyl1 = 0xBB67AE8584CAA73B;
+    for (int round = 0; round < 10; round++) {
+      if (round > 0) {
+        key[0] += weyl0;
+        key[1] += weyl1;
+      }
+      uint64_t hi0, hi1;
+      const uint64_t lo0 = multiply_high_low(multiplier0, counter[0], hi0);
+      const uint64_t lo1 = multiply_high_low(multiplier1, counter[2], hi1);
+      counter = {hi1 ^ counter[1] ^ key[0], lo1, hi0 ^ counter[3] ^ key[1],
+                 lo0};
+    }
+    return counter;
+  }
+
+  /// \return Whether two engines generate the same numbers.
+  friend bool operator==(const Philox4x64 &a, const Philox4x64 &b) {
+    return a.key_ == b.key_ && a.position() == b.position();
+  }
+  /// \return Whether two engines generate different numbers.
+  friend bool operator!=(const Philox4x64 &a, const Philox4x64 &b) {
+    return !(a == b);
+  }
+
+ private:
+  /// Number of random numbers generated per counter value
+  static constexpr unsigned int block_size = 4;
+
+  /**
+   * Full 128 bits product of two 64 bits numbers.
+   *
+   * \param[in] a First factor
+   * \param[in] b Second factor
+   * \param[out] high Upper 64 bits of the product
+   * \return Lower 64 bits of the product
+   */
+  static uint64_t multiply_high_low(uint64_t a, uint64_t b, uint64_t &high) {
+#ifdef __SIZEOF_INT128__
+    __extension__ using uint128 = unsigned __int128;
+    const uint128 product = static_cast<uint128>(a) * b;
+    high = static_cast<uint64_t>(product >> 64);
+    return static_cast<uint64_t>(product);
+#else
+    const uint64_t a_lo = a & 0xFFFFFFFF, a_hi = a >> 32;
+    const uint64_t b_lo = b & 0xFFFFFFFF, b_hi = b >> 32;
+    const uint64_t lo_lo = a_lo * b_lo, hi_lo = a_hi * b_lo;
+    const uint64_t lo_hi = a_lo * b_hi, hi_hi = a_hi * b_hi;
+    const uint64_t cross = (lo_lo >> 32) + (hi_lo & 0xFFFFFFFF) + lo_hi;
+    high = hi_hi + (hi_lo >> 32) + (cross >> 32);
+    return (cross << 32) | (lo_lo & 0xFFFFFFFF);
+#endif
+  }
+
+  /// Key of the bijection, i.e. the seed and the stream number
+  std::array<uint64_t, 2> key_;
+  /// Next value of the counter to be transformed
+  uint64_t counter_;
+  /// Random numbers corresponding to the last transformed counter
+  std::array<uint64_t, block_size> block_;
+  /// Index of the next random number to be returned from the block
+  unsigned int index_;
+};
+
+/**
+ * The random number engine used is the counter-based Philox4x64-10.
+ *
+ * It provides one independent stream per event, ensemble or thread, which is
+ * needed to obtain results independent of the number of threads.
+ */
+using Engine = Philox4x64;
+
+/**
+ * The engine that is used commonly by all distributions.
+ *
+ * Every thread has its own engine, such that random numbers can be drawn
+ * concurrently. Engines of threads other than the main one are not seeded by
+ * set_seed and have to be set up explicitly, see EngineGuard.
+ */
+extern thread_local Engine engine;
+
+/**
+ * Guard to let the engine of the calling thread adopt a given state for the
+ * lifetime of the guard.
+ *
+ * On destruction the advanced state is handed back and the previous state of
+ * the engine is restored. This allows to carry independent random number
+ * streams, e.g. one per ensemble, from thread to thread.
+ */
+class EngineGuard {
+ public:
+  /**
+   * Swap in the given state.
+   *
+   * \param[in,out] state Engine state to be used by the calling thread. It is
+   *                      updated when the guard goes out of scope.
+   */
+  explicit EngineGuard(Engine &state) : state_(state) {
+    std::swap(engine, state_);
+  }
+  /// Swap the advanced state back.
+  ~EngineGuard() { std::swap(engine, state_); }
+  /// Cannot be copied
+  EngineGuard(const EngineGuard &) = delete;
+  /// Cannot be copied
+  EngineGuard &operator=(const EngineGuard &) = delete;
+
+ private:
+  /// Guarded engine state
+  Engine &state_;
+};
 
 /** Provides uniform random numbers on a fixed interval.
  *
@@ -230,13 +440,13 @@ int poisson(const T &lam) {
 /**
  * Returns a binomially distributed random number.
  *
- * \param N Number of trials.
+ * \param N Number of trials, whose integer type is also the one returned.
  * \param p Probability of a trial generating true.
  * \return Sampled random number.
  */
-template <typename T>
-int binomial(const int N, const T &p) {
-  return std::binomial_distribution<int>(N, p)(engine);
+template <typename I, typename T>
+I binomial(const I N, const T &p) {
+  return std::binomial_distribution<I>(N, p)(engine);
 }
 
 /**
@@ -290,6 +500,227 @@ class discrete_dist {
   std::discrete_distribution<> distribution;
 };
 
+/**
+ * Discrete distribution with weights given by a vector, which is sampled in
+ * constant time with Walker's alias method: every index is drawn with equal
+ * probability and then either kept or replaced by its alias.
+ */
+class alias_dist {
+ public:
+  /// Default distribution, which always draws 0.
+  alias_dist() : probability_({1.}), alias_({0}) {}
+
+  /**
+   * Set up the alias table.
+   *
+   * \param[in] weights Weights of the indices, which do not need to be
+   *                    normalized
+   */
+  explicit alias_dist(const std::vector<double> &weights)
+      : probability_(weights.size()), alias_(weights.size()) {
+    const std::size_t n = weights.size();
+    assert(n > 0);
+    double sum = 0.;
+    for (double weight : weights) {
+      assert(weight >= 0.);
+      sum += weight;
+    }
+    assert(sum > 0.);
+    // The weights are scaled to an average of one
+    std::vector<std::size_t> small, large;
+    for (std::size_t i = 0; i < n; i++) {
+      probability_[i] = weights[i] * n / sum;
+      alias_[i] = i;
+      (probability_[i] < 1. ? small : large).push_back(i);
+    }
+    // Every small weight is filled up to one by a large one
+    while (!small.empty() && !large.empty()) {
+      const std::size_t i_small = small.back(), i_large = large.back();
+      small.pop_back();
+      alias_[i_small] = i_large;
+      probability_[i_large] -= 1. - probability_[i_small];
+      if (probability_[i_large] < 1.) {
+        large.pop_back();
+        small.push_back(i_large);
+      }
+    }
+    // The remaining weights are one up to rounding errors
+    for (std::size_t i : small) {
+      probability_[i] = 1.;
+    }
+    for (std::size_t i : large) {
+      probability_[i] = 1.;
+    }
+  }
+
+  /** Draw a random number from the discrete distribution.
+   * \return Sampled value
+   */
+  int operator()() const {
+    const std::size_t n = probability_.size();
+    const double u = canonical() * n;
+    const std::size_t i = std::min(static_cast<std::size_t>(u), n - 1);
+    return static_cast<int>(u - i < probability_[i] ? i : alias_[i]);
+  }
+
+ private:
+  /// Probability to keep each index
+  std::vector<double> probability_;
+  /// Index drawn instead of each index, if it is not kept
+  std::vector<std::size_t> alias_;
+};
+
+/**
+ * Continuous distribution on an interval, whose density is tabulated on
+ * equally sized bins and taken to be constant within each bin.
+ *
+ * A number is drawn by inverting the cumulative distribution, so no random
+ * numbers are rejected. The bin is looked up via a guide table, which
+ * takes constant time on average, independent of the number of bins.
+ */
+class piecewise_constant_dist {
+ public:
+  /// Default distribution without any bins, which must not be sampled.
+  piecewise_constant_dist() = default;
+
+  /**
+   * Tabulate the density.
+   *
+   * \param[in] x_min Lower end of the interval
+   * \param[in] x_max Upper end of the interval
+   * \param[in] n_bins Number of bins
+   * \param[in] density Density, which is evaluated at the center of each
+   *                    bin and does not need to be normalized
+   */
+  template <typename F>
+  piecewise_constant_dist(double x_min, double x_max, std::size_t n_bins,
+                          F &&density)
+      : piecewise_constant_dist(
+            x_min, x_max, evaluate_density(x_min, x_max, n_bins, density)) {}
+
+  /**
+   * Set up the distribution from the weights of the bins.
+   *
+   * \param[in] x_min Lower end of the interval
+   * \param[in] x_max Upper end of the interval
+   * \param[in] weights Density at the center of each bin, which does not
+   *                    need to be normalized
+   */
+  piecewise_constant_dist(double x_min, double x_max,
+                          const std::vector<double> &weights)
+      : x_min_(x_min),
+        bin_width_((x_max - x_min) / weights.size()),
+        cdf_(weights.size() + 1, 0.),
+        guide_(weights.size()) {
+    const std::size_t n_bins = weights.size();
+    assert(n_bins > 0);
+    for (std::size_t k = 0; k < n_bins; k++) {
+      const double weight = weights[k];
+      assert(weight >= 0.);
+      cdf_[k + 1] = cdf_[k] + weight;
+      if (weight > 0.) {
+        last_bin_ = k;
+      }
+    }
+    integral_ = cdf_[n_bins] * bin_width_;
+    assert(cdf_[n_bins] > 0.);
+    for (double &c : cdf_) {
+      c /= cdf_[n_bins];
+    }
+    cdf_[n_bins] = 1.;
+    // guide_[j] is the first bin which ends above j / n_bins
+    std::size_t k = 0;
+    for (std::size_t j = 0; j < n_bins; j++) {
+      while (cdf_[k + 1] <= static_cast<double>(j) / n_bins) {
+        k++;
+      }
+      guide_[j] = k;
+    }
+  }
+
+  /**
+   * Invert the cumulative distribution.
+   *
+   * \param[in] u Value of the cumulative distribution in [0, 1]
+   * \return Value x, below which the fraction u of the distribution lies
+   */
+  double inverse_cdf(double u) const {
+    const std::size_t n_bins = guide_.size();
+    std::size_t k =
+        guide_[std::min(static_cast<std::size_t>(u * n_bins), n_bins - 1)];
+    while (k < last_bin_ && cdf_[k + 1] <= u) {
+      k++;
+    }
+    const double fraction = (u - cdf_[k]) / (cdf_[k + 1] - cdf_[k]);
+    return x_min_ + (k + std::min(fraction, 1.)) * bin_width_;
+  }
+
+  /**
+   * Evaluate the cumulative distribution.
+   *
+   * \param[in] x Value
+   * \return Fraction of the distribution below x
+   */
+  double cdf(double x) const {
+    const double bins_below = (x - x_min_) / bin_width_;
+    if (!(bins_below > 0.)) {
+      return 0.;
+    }
+    const std::size_t n_bins = guide_.size();
+    if (bins_below >= n_bins) {
+      return 1.;
+    }
+    const std::size_t k = static_cast<std::size_t>(bins_below);
+    return cdf_[k] + (bins_below - k) * (cdf_[k + 1] - cdf_[k]);
+  }
+
+  /** Draw a random number from the distribution.
+   * \return Sampled value
+   */
+  double operator()() const { return inverse_cdf(canonical()); }
+
+  /// \return Integral of the tabulated density over the interval
+  double integral() const { return integral_; }
+
+  /// \return Whether the distribution was not tabulated yet
+  bool empty() const { return guide_.empty(); }
+
+ private:
+  /**
+   * Evaluate a density at the centers of equally sized bins.
+   *
+   * \param[in] x_min Lower end of the interval
+   * \param[in] x_max Upper end of the interval
+   * \param[in] n_bins Number of bins
+   * \param[in] density Density
+   * \return Density at the center of each bin
+   */
+  template <typename F>
+  static std::vector<double> evaluate_density(double x_min, double x_max,
+                                              std::size_t n_bins,
+                                              F &&density) {
+    const double bin_width = (x_max - x_min) / n_bins;
+    std::vector<double> weights(n_bins);
+    for (std::size_t k = 0; k < n_bins; k++) {
+      weights[k] = density(x_min + (k + 0.5) * bin_width);
+    }
+    return weights;
+  }
+
+  /// Lower end of the interval
+  double x_min_ = 0.;
+  /// Width of each bin
+  double bin_width_ = 0.;
+  /// Integral of the tabulated density
+  double integral_ = 0.;
+  /// Normalized cumulative distribution at the bin edges
+  std::vector<double> cdf_;
+  /// Index of the first bin ending above j / number of bins for each j
+  std::vector<std::size_t> guide_;
+  /// Last bin with a nonzero weight
+  std::size_t last_bin_ = 0;
+};
+
 /**
  * Draws a random number from a Cauchy distribution (sometimes also called
  * Lorentz or non-relativistic Breit-Wigner distribution) with the given
@@ -373,6 +804,9 @@ T beta_a0(T xmin, T b) {
  * \f$ m = \frac{1}{2} (\sqrt{a^2 + N^2} - N) > 6\f$, then the distribution is
  * approximated well by a Gaussian, else probabilities are computed explicitely
  * and a table sampling is applied.
+ *
+ * Samplers, which are set up repeatedly for similar means, should be taken from
+ * the cache of \ref cached.
  */
 class BesselSampler {
  public:
@@ -392,7 +826,25 @@ class BesselSampler {
    *
    * \return Pair of first and second sampled number.
    */
-  std::pair<int, int> sample();
+  std::pair<int, int> sample() const;
+
+  /**
+   * Get a sampler from a cache of samplers of the calling thread, which is
+   * set up only if no sampler with similar parameters was used before.
+   *
+   * The distribution only depends on \f$ a = 2 \sqrt{\nu_1 \nu_2} \f$ and
+   * the difference. Therefore the samplers are cached for the difference and
+   * \f$ a \f$ rounded to a relative precision of \ref cache_precision_, and
+   * the sampler is set up for the rounded \f$ a \f$.
+   *
+   * \param[in] poisson_mean1 Mean of the first number's Poisson distribution.
+   * \param[in] poisson_mean2 Mean of the second number's Poisson distribution.
+   * \param[in] fixed_difference Difference between the sampled numbers.
+   * \return Cached sampler, which remains valid when the cache is cleared.
+   */
+  static std::shared_ptr<const BesselSampler> cached(
+      const double poisson_mean1, const double poisson_mean2,
+      const int fixed_difference);
 
  private:
   /**
@@ -406,8 +858,8 @@ class BesselSampler {
    */
   static double r_(int n, double a);
 
-  /// Vector to store tabulated values of probabilities for small m case (m <6).
-  random::discrete_dist<double> dist_;
+  /// Alias table of the probabilities for small m case (m <6).
+  random::alias_dist dist_;
 
   /// Mode of the Bessel function, see \cite Yuan2000 for details.
   double m_;
@@ -431,6 +883,12 @@ class BesselSampler {
   /// Probabilities smaller than negligibly_probability are neglected.
   static constexpr double negligible_probability_ = 1.e-12;
 
+  /// Relative precision, to which a is rounded in the cache.
+  static constexpr double cache_precision_ = 1.e-4;
+
+  /// Number of cached samplers, above which the cache is cleared.
+  static constexpr std::size_t max_cached_ = 10000;
+
   /// Mean of the Bessel distribution.
   double mu_;
 
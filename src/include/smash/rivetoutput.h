@@ -1,7 +1,7 @@
 /*
  *
  *    Copyright (c) 2021 Christian Holm Christensen
- *    Copyright (c) 2021-2022
+ *    Copyright (c) 2021-2022,2024
  *      SMASH Team
  *
  *    GNU General Public License (GPLv3 or later)
@@ -11,10 +11,17 @@
 #ifndef SRC_INCLUDE_SMASH_RIVETOUTPUT_H_
 #define SRC_INCLUDE_SMASH_RIVETOUTPUT_H_
 
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
 #include <filesystem>
 #include <memory>
+#include <mutex>
 #include <string>
+#include <thread>
 #include <utility>
+#include <vector>
 
 #include "Rivet/AnalysisHandler.hh"
 
@@ -32,6 +39,11 @@ namespace smash {
  * as compared to writing the HepMC event to disk or pipe and then decoding
  * in Rivet.
  *
+ * With analysis threads, every thread runs its own Rivet::AnalysisHandler on
+ * copies of the events, which are handed over through a queue, and the
+ * handlers are merged into the first one before the analyses are finalised.
+ * The handlers are initialised with the first event by the calling thread.
+ *
  * More details of the output format can be found in the User Guide.
  */
 class RivetOutput : public HepMcInterface {
@@ -48,7 +60,8 @@ class RivetOutput : public HepMcInterface {
   RivetOutput(const std::filesystem::path& path, std::string name,
               const bool full_event, const RivetOutputParameters& rivet_par);
   /**
-   * Destructor. Finalises the analzyses and writes out results to file
+   * Destructor. Waits for the analysis threads, merges their handlers,
+   * finalises the analzyses and writes out results to file
    */
   ~RivetOutput();
   /**
@@ -58,6 +71,7 @@ class RivetOutput : public HepMcInterface {
    * \param[in] particles Current list of particles.
    * \param[in] event_number Number of event.
    * \param[in] event Event info, see \ref event_info
+   * \throw Whatever an analysis thread threw since the last call.
    */
   void at_eventend(const Particles& particles, const int32_t event_number,
                    const EventInfo& event) override;
@@ -100,6 +114,16 @@ class RivetOutput : public HepMcInterface {
    */
   void setup(const RivetOutputParameters& params);
 
+  /**
+   * Analyse the events from the queue with a handler until stopped.
+   *
+   * \param[in] handler The handler of this analysis thread
+   */
+  void analyze_queued(const std::shared_ptr<Rivet::AnalysisHandler>& handler);
+
+  /// Rethrow an exception of an analysis thread, while holding the mutex.
+  void rethrow_error();
+
   /**
    * A proxy object that wraps all Rivet::AnalysisHandler calls in an
    * environment where FP errors are disabled.
@@ -119,14 +143,30 @@ class RivetOutput : public HepMcInterface {
     DisableFloatTraps g_;
   };
   /** Return a proxy that temporarily disables FP exceptions */
-  Proxy analysis_handler_proxy() { return Proxy(handler_); }
+  Proxy analysis_handler_proxy(std::size_t i = 0) {
+    return Proxy(handlers_[i]);
+  }
 
-  /**  Rivet analysis handler */
-  std::shared_ptr<Rivet::AnalysisHandler> handler_;
+  /**  Rivet analysis handlers, one per analysis thread or a single one */
+  std::vector<std::shared_ptr<Rivet::AnalysisHandler>> handlers_;
   /** Output file */
   std::filesystem::path filename_;
   /** Whether we need initialisation */
   bool need_init_;
+  /** Number of events waiting in the queue at most */
+  std::size_t capacity_;
+  /** Guards the queue, the stop flag and the error */
+  std::mutex mutex_;
+  /** Notified whenever the queue changes or the threads are asked to stop */
+  std::condition_variable changed_;
+  /** Copies of the events waiting to be analysed */
+  std::deque<std::unique_ptr<HepMC3::GenEvent>> queue_;
+  /** Whether the analysis threads are asked to stop */
+  bool stop_ = false;
+  /** Exception thrown by an analysis, which was not passed on yet */
+  std::exception_ptr error_;
+  /** Analysis threads, started last */
+  std::vector<std::thread> threads_;
 };
 
 }  // namespace smash
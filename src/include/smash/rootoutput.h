@@ -1,6 +1,6 @@
 /*
  *
- *    Copyright (c) 2014-2020,2022-2023
+ *    Copyright (c) 2014-2020,2022-2024
  *      SMASH Team
  *
  *    GNU General Public License (GPLv3 or later)
@@ -10,6 +10,7 @@
 #ifndef SRC_INCLUDE_SMASH_ROOTOUTPUT_H_
 #define SRC_INCLUDE_SMASH_ROOTOUTPUT_H_
 
+#include <cstddef>
 #include <filesystem>
 #include <memory>
 #include <string>
@@ -54,6 +55,7 @@ class Particles;
  * impact_b - impact parameter of the event,
  * empty_event - whether there was no interaction between the projectile and
  * the target,
+ * event_weight - weight of the event,
  * E_kinetic_tot - total kinetic energy in the system,
  * E_fields_tot - total mean field energy * test_p,
  * E_total - sum of E_kinetic_tot and E_fields_tot.
@@ -140,14 +142,14 @@ class RootOutput : public OutputInterface {
    * TFile takes ownership of all TTrees.
    * That's why TTree is not a unique pointer.
    */
-  TTree *particles_tree_;
+  TTree *particles_tree_ = nullptr;
   /**
    * TTree for collision output.
    *
    * TFile takes ownership of all TTrees.
    * That's why TTree is not a unique pointer.
    */
-  TTree *collisions_tree_;
+  TTree *collisions_tree_ = nullptr;
   /**
    * Writes particles to a tree defined by treename.
    * \param[in] particles Particles or ParticleList to be written to output.
@@ -177,35 +179,43 @@ class RootOutput : public OutputInterface {
    */
   static const int max_buffer_size_;
 
+  /**
+   * Buffer size at the start. The buffers grow with the largest block written
+   * so far, up to max_buffer_size_.
+   */
+  static constexpr int initial_buffer_size_ = 1024;
+
   /** @name Buffer for filling TTree
    * See class documentation for definitions.
    */
   //@{
   /// Property that is written to ROOT output.
-  std::vector<double> p0_ = std::vector<double>(max_buffer_size_, 0.0);
-  std::vector<double> px_ = std::vector<double>(max_buffer_size_, 0.0);
-  std::vector<double> py_ = std::vector<double>(max_buffer_size_, 0.0);
-  std::vector<double> pz_ = std::vector<double>(max_buffer_size_, 0.0);
-  std::vector<double> t_ = std::vector<double>(max_buffer_size_, 0.0);
-  std::vector<double> x_ = std::vector<double>(max_buffer_size_, 0.0);
-  std::vector<double> y_ = std::vector<double>(max_buffer_size_, 0.0);
-  std::vector<double> z_ = std::vector<double>(max_buffer_size_, 0.0);
+  std::vector<double> p0_ = std::vector<double>(initial_buffer_size_, 0.0);
+  std::vector<double> px_ = std::vector<double>(initial_buffer_size_, 0.0);
+  std::vector<double> py_ = std::vector<double>(initial_buffer_size_, 0.0);
+  std::vector<double> pz_ = std::vector<double>(initial_buffer_size_, 0.0);
+  std::vector<double> t_ = std::vector<double>(initial_buffer_size_, 0.0);
+  std::vector<double> x_ = std::vector<double>(initial_buffer_size_, 0.0);
+  std::vector<double> y_ = std::vector<double>(initial_buffer_size_, 0.0);
+  std::vector<double> z_ = std::vector<double>(initial_buffer_size_, 0.0);
   std::vector<double> formation_time_ =
-      std::vector<double>(max_buffer_size_, 0.0);
-  std::vector<double> xsec_factor_ = std::vector<double>(max_buffer_size_, 0.0);
+      std::vector<double>(initial_buffer_size_, 0.0);
+  std::vector<double> xsec_factor_ =
+      std::vector<double>(initial_buffer_size_, 0.0);
   std::vector<double> time_last_coll_ =
-      std::vector<double>(max_buffer_size_, 0.0);
-  std::vector<int> pdgcode_ = std::vector<int>(max_buffer_size_, 0);
-  std::vector<int> charge_ = std::vector<int>(max_buffer_size_, 0);
-  std::vector<int> coll_per_part_ = std::vector<int>(max_buffer_size_, 0);
-  std::vector<int> proc_id_origin_ = std::vector<int>(max_buffer_size_, 0);
-  std::vector<int> proc_type_origin_ = std::vector<int>(max_buffer_size_, 0);
-  std::vector<int> pdg_mother1_ = std::vector<int>(max_buffer_size_, 0);
-  std::vector<int> pdg_mother2_ = std::vector<int>(max_buffer_size_, 0);
-  std::vector<int> baryon_number_ = std::vector<int>(max_buffer_size_, 0);
-  std::vector<int> strangeness_ = std::vector<int>(max_buffer_size_, 0);
+      std::vector<double>(initial_buffer_size_, 0.0);
+  std::vector<int> pdgcode_ = std::vector<int>(initial_buffer_size_, 0);
+  std::vector<int> charge_ = std::vector<int>(initial_buffer_size_, 0);
+  std::vector<int> coll_per_part_ = std::vector<int>(initial_buffer_size_, 0);
+  std::vector<int> proc_id_origin_ = std::vector<int>(initial_buffer_size_, 0);
+  std::vector<int> proc_type_origin_ =
+      std::vector<int>(initial_buffer_size_, 0);
+  std::vector<int> pdg_mother1_ = std::vector<int>(initial_buffer_size_, 0);
+  std::vector<int> pdg_mother2_ = std::vector<int>(initial_buffer_size_, 0);
+  std::vector<int> baryon_number_ = std::vector<int>(initial_buffer_size_, 0);
+  std::vector<int> strangeness_ = std::vector<int>(initial_buffer_size_, 0);
   int npart_, tcounter_, ev_, nin_, nout_, test_p_;
-  double wgt_, par_wgt_, impact_b_, modus_l_, current_t_;
+  double wgt_, par_wgt_, impact_b_, event_weight_, modus_l_, current_t_;
   double E_kinetic_tot_, E_fields_tot_, E_tot_;
   bool empty_event_;
   //@}
@@ -240,11 +250,39 @@ class RootOutput : public OutputInterface {
   /// Whether extended ic output is on
   const bool ic_extended_;
 
+  /// Settings of the ROOT file and trees
+  const RootOutputParameters root_parameters_;
+
   /**
    * Basic initialization routine, creating the TTree objects
    * for particles and collisions.
    */
   void init_trees();
+
+  /**
+   * Apply the basket and flush settings to a tree.
+   *
+   * \param[in] tree Tree with all its branches
+   */
+  void configure_tree(TTree *tree);
+
+  /**
+   * Make sure that the buffers can hold a block of particles, enlarging them
+   * and passing their new addresses to the trees if necessary.
+   *
+   * \param[in] size Number of particles in the block, at most
+   *            max_buffer_size_
+   */
+  void reserve_buffers(std::size_t size);
+
+  /**
+   * Pass the addresses of the buffers of the array branches to a tree.
+   *
+   * \param[in] tree Tree, whose branches are updated
+   * \param[in] extended Whether the tree has the branches of the extended
+   *            output
+   */
+  void set_buffer_addresses(TTree *tree, bool extended);
 };
 
 }  // namespace smash
@@ -1,6 +1,6 @@
 /*
  *
- *    Copyright (c) 2014-2023
+ *    Copyright (c) 2014-2024
  *      SMASH Team
  *
  *    GNU General Public License (GPLv3 or later)
@@ -10,13 +10,16 @@
 #ifndef SRC_INCLUDE_SMASH_SCATTERACTION_H_
 #define SRC_INCLUDE_SMASH_SCATTERACTION_H_
 
+#include <cstdint>
 #include <memory>
+#include <optional>
 #include <set>
 #include <string>
 #include <utility>
 
 #include "action.h"
 #include "isoparticletype.h"
+#include "random.h"
 #include "scatteractionsfinderparameters.h"
 #include "stringprocess.h"
 
@@ -148,6 +151,26 @@ class ScatterAction : public Action {
   void add_all_scatterings(
       const ScatterActionsFinderParameters& finder_parameters);
 
+  /**
+   * Compute the sum of the partial cross sections, which add_all_scatterings
+   * would set up, without adding any subprocess. This allows to check the
+   * collision criterion before the collision branches are set up.
+   *
+   * \param[in] finder_parameters parameters for collision finding.
+   * \return Sum of the partial cross sections [mb].
+   */
+  double sum_of_all_scatterings(
+      const ScatterActionsFinderParameters& finder_parameters) const;
+
+  /**
+   * Add the scattering subprocesses, which were interpolated by a
+   * CrossSectionTable, instead of computing them. This can only be called
+   * once per ScatterAction instance, instead of add_all_scatterings.
+   *
+   * \param[in] branches Collision branches of the incoming particles.
+   */
+  void add_tabulated_scatterings(CollisionBranchList branches);
+
   /**
    * Given the incoming particles, assigns the correct parametrization of the
    * total cross section.
@@ -186,6 +209,52 @@ class ScatterAction : public Action {
     string_process_ = str_proc;
   }
 
+  /**
+   * Draw the random numbers of the final state from a random stream of this
+   * action instead of the stream of the calling thread. The stream is
+   * derived from the seed, the ensemble and the incoming particles, such that
+   * the final state does not depend on when it is generated.
+   *
+   * \param[in] seed Seed of the event
+   * \param[in] ensemble Index of the ensemble of the incoming particles
+   */
+  void set_random_stream(std::uint64_t seed, std::uint64_t ensemble);
+
+  /// \return Whether a string process is among the collision branches.
+  bool has_string_channel() const;
+
+  /**
+   * Choose the collision channel ahead of the execution and, if it is a
+   * string process, fragment the string already. The final state is taken
+   * over by generate_final_state, which chooses the same channel again.
+   * This allows to fragment the strings of several actions in parallel,
+   * while the actions are still performed in the order of time.
+   *
+   * The action needs its own random stream, see set_random_stream, and its
+   * incoming particles must be unchanged when the action is performed, which
+   * is the case for valid actions.
+   *
+   * \return Whether a string was fragmented
+   */
+  bool prefragment_string();
+
+  /**
+   * Generate the final state ahead of the execution, whatever the chosen
+   * channel is, like prefragment_string does for strings. The outgoing
+   * particles are only boosted to the computational frame and placed at the
+   * interaction point by generate_final_state, which may come after the
+   * incoming particles were propagated. An error while sampling is raised
+   * again by generate_final_state.
+   *
+   * \return Whether the final state was generated
+   */
+  bool prepare_final_state();
+
+  /// \return Whether a final state was generated ahead of the execution.
+  bool has_prepared_final_state() const {
+    return prepared_final_state_.has_value();
+  }
+
   /**
    * Get the total cross section of the scattering particles, either from a
    * parametrization, or from the sum of partials.
@@ -243,14 +312,26 @@ class ScatterAction : public Action {
   /// Perform an inelastic two-to-many-body scattering (more than 2)
   void two_to_many_scattering();
 
-  /// Creates the final states for string-processes after they are performed
-  void create_string_final_state();
+  /**
+   * Creates the final states for string-processes after they are performed
+   *
+   * \param[in] string_process String process which performed the process
+   */
+  void create_string_final_state(StringProcess &string_process);
   /**
    * Todo(ryu): document better - it is not really UrQMD-based, isn't it?
    * Perform the UrQMD-based string excitation and decay
    */
   void string_excitation();
 
+  /**
+   * Sample the final state of the chosen channel, whose outgoing particles
+   * are set already, in the center of mass frame.
+   *
+   * \throw InvalidScatterAction if the process type is unknown
+   */
+  void sample_final_state();
+
   /**
    * \ingroup logging
    * Writes information about this scatter action to the \p out stream.
@@ -273,6 +354,16 @@ class ScatterAction : public Action {
   double string_formation_time_ = 1.0;
 
  private:
+  /**
+   * Generate the final state ahead of the execution, see
+   * prepare_final_state.
+   *
+   * \param[in] only_strings Whether only the final state of a string is
+   *            generated
+   * \return Whether the final state was generated
+   */
+  bool prepare(bool only_strings);
+
   /**
    * Check if the scattering is elastic.
    *
@@ -312,6 +403,15 @@ class ScatterAction : public Action {
   /// Pointer to interface class for strings
   StringProcess* string_process_ = nullptr;
 
+  /// Random stream of this action, if the one of the thread is not used
+  std::optional<random::Engine> random_stream_ = std::nullopt;
+
+  /// Final state generated ahead of the execution, in the center of mass frame
+  std::optional<ParticleList> prepared_final_state_ = std::nullopt;
+
+  /// Process type of the final state generated ahead of the execution
+  ProcessType prepared_type_ = ProcessType::None;
+
   /// Whether the total cross section is parametrized
   bool is_total_parametrized_ = false;
 
@@ -1,6 +1,6 @@
 /*
  *
- *    Copyright (c) 2016-2018,2020
+ *    Copyright (c) 2016-2018,2020,2024
  *      SMASH Team
  *
  *    GNU General Public License (GPLv3 or later)
@@ -241,6 +241,45 @@ class ScatterActionPhoton : public ScatterAction {
    */
   double rho_mass() const;
 
+  /**
+   * Kinematics of the final state, which are the same for all fractional
+   * photons of a scattering.
+   */
+  struct FinalStateKinematics {
+    /// Point of the scattering
+    FourVector interaction_point;
+    /// Velocity of the center of mass frame in the computational frame
+    ThreeVector velocity;
+    /// Effective masses of the incoming pion and the other particle [GeV]
+    double m1, m2;
+    /// Mandelstam s [GeV^2] and its square root [GeV]
+    double s, sqrts;
+    /// Range of the Mandelstam t [GeV^2]
+    double t1, t2;
+    /// Center of mass momenta of the incoming and outgoing particles [GeV]
+    double pcm_in, pcm_out;
+    /// Mass of the participating rho [GeV], see rho_mass
+    double m_rho;
+  };
+
+  /**
+   * Set up the outgoing particles and compute the kinematics of the final
+   * state, which only depend on the incoming particles.
+   *
+   * \return Kinematics shared by the fractional photons
+   */
+  FinalStateKinematics prepare_final_state();
+
+  /**
+   * Sample one photon / hadron pair of the final state set up by
+   * prepare_final_state.
+   *
+   * \param[in] kin Kinematics of the final state
+   * \param[in] check_conservation Whether the conservation laws are checked
+   */
+  void sample_final_state(const FinalStateKinematics &kin,
+                          bool check_conservation);
+
   /**
    * Creates a CollisionBranchList containing the photon processes.
    * By construction (perturbative treatment) this list will always contain only
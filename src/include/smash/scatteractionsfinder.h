@@ -1,6 +1,6 @@
 /*
  *
- *    Copyright (c) 2014-2022
+ *    Copyright (c) 2014-2024
  *      SMASH Team
  *
  *    GNU General Public License (GPLv3 or later)
@@ -10,18 +10,82 @@
 #ifndef SRC_INCLUDE_SMASH_SCATTERACTIONSFINDER_H_
 #define SRC_INCLUDE_SMASH_SCATTERACTIONSFINDER_H_
 
+#include <cstdint>
 #include <memory>
+#include <mutex>
+#include <ostream>
 #include <set>
+#include <stdexcept>
+#include <type_traits>
 #include <vector>
 
 #include "action.h"
 #include "actionfinderfactory.h"
+#include "collisiontrace.h"
 #include "configuration.h"
+#include "crosssectionenvelope.h"
+#include "crosssectiontable.h"
 #include "scatteraction.h"
 #include "scatteractionsfinderparameters.h"
 
 namespace smash {
 
+/**
+ * \ingroup action
+ * Counts of the two-particle pairs examined by the ScatterActionsFinder, by
+ * the stage of the collision check which rejected them, and of the found
+ * scatterings. The latter are counted by the Experiment once they are
+ * performed, invalidated or Pauli-blocked.
+ */
+struct CollisionFinderStatistics {
+  /// Pairs of particles within the same cell
+  std::uint64_t pairs_in_cells = 0;
+  /// Pairs of particles in neighboring cells or with surrounding particles
+  std::uint64_t pairs_with_neighbors = 0;
+  /**
+   * Pairs rejected by the CollisionPrefilter of the geometric criterion,
+   * including the ones whose distance exceeds the cross section envelope
+   */
+  std::uint64_t prefiltered = 0;
+  /// Pairs of the same nucleus which did not interact yet
+  std::uint64_t rejected_nucleus = 0;
+  /// Pairs of types which cannot interact at their energy
+  std::uint64_t rejected_types = 0;
+  /// Pairs whose collision time is outside of the time step
+  std::uint64_t rejected_time = 0;
+  /// Pairs farther apart than the maximal transverse distance
+  std::uint64_t rejected_distance = 0;
+  /// Pairs rejected by the cross section of the geometric criteria
+  std::uint64_t rejected_cross_section = 0;
+  /// Pairs rejected by the probability of the stochastic criterion
+  std::uint64_t rejected_probability = 0;
+  /// Pairs which collided with each other in the last action
+  std::uint64_t rejected_repeated = 0;
+  /// Created ScatterAction objects
+  std::uint64_t actions_created = 0;
+  /// Scatterings passing the collision criterion
+  std::uint64_t actions_found = 0;
+  /// Performed scatterings
+  std::uint64_t actions_performed = 0;
+  /// Scatterings invalidated by an earlier action
+  std::uint64_t actions_invalid = 0;
+  /// Pauli-blocked scatterings
+  std::uint64_t actions_pauli_blocked = 0;
+
+  /// Add the counts of another instance.
+  void add(const CollisionFinderStatistics &other);
+};
+
+/**
+ * Print the counts of the collision finder in a single line.
+ *
+ * \param[in] out Stream to print to
+ * \param[in] statistics Counts to be printed
+ * \return The stream
+ */
+std::ostream &operator<<(std::ostream &out,
+                         const CollisionFinderStatistics &statistics);
+
 /**
  * \ingroup action
  * A simple scatter finder:
@@ -66,7 +130,30 @@ class ScatterActionsFinder : public ActionFinderInterface {
   inline double collision_time(
       const ParticleData &p1, const ParticleData &p2, double dt,
       const std::vector<FourVector> &beam_momentum) const {
-    if (finder_parameters_.coll_crit == CollisionCriterion::Stochastic) {
+    switch (finder_parameters_.coll_crit) {
+      case CollisionCriterion::Stochastic:
+        return collision_time<CollisionCriterion::Stochastic>(p1, p2, dt,
+                                                              beam_momentum);
+      case CollisionCriterion::Covariant:
+        return collision_time<CollisionCriterion::Covariant>(p1, p2, dt,
+                                                             beam_momentum);
+      default:
+        return collision_time<CollisionCriterion::Geometric>(p1, p2, dt,
+                                                             beam_momentum);
+    }
+  }
+
+  /**
+   * Determine the collision time of the two particles with a given collision
+   * criterion, see collision_time.
+   *
+   * \tparam Criterion Collision criterion of the run
+   */
+  template <CollisionCriterion Criterion>
+  inline double collision_time(
+      const ParticleData &p1, const ParticleData &p2, double dt,
+      const std::vector<FourVector> &beam_momentum) const {
+    if constexpr (Criterion == CollisionCriterion::Stochastic) {
       return dt * random::uniform(0., 1.);
     } else {
       /*
@@ -95,7 +182,7 @@ class ScatterActionsFinder : public ActionFinderInterface {
       const FourVector p2_mom = (p2_has_no_prior_interactions)
                                     ? beam_momentum[p2.id()]
                                     : p2.momentum();
-      if (finder_parameters_.coll_crit == CollisionCriterion::Covariant) {
+      if constexpr (Criterion == CollisionCriterion::Covariant) {
         /**
          * JAM collision times from the closest approach
          * in the two-particle center-of-mass-framem,
@@ -142,6 +229,10 @@ class ScatterActionsFinder : public ActionFinderInterface {
     }
   }
 
+  // The convenience overloads for a ParticleList are kept visible
+  using ActionFinderInterface::find_actions_in_cell;
+  using ActionFinderInterface::find_actions_with_neighbors;
+
   /**
    * Search for all the possible collisions within one cell. This function is
    * only used for counting the primary collisions at the beginning of each
@@ -157,7 +248,7 @@ class ScatterActionsFinder : public ActionFinderInterface {
    * \return A list of possible scatter actions
    */
   ActionList find_actions_in_cell(
-      const ParticleList &search_list, double dt, const double gcell_vol,
+      const ParticleSpan &search_list, double dt, const double gcell_vol,
       const std::vector<FourVector> &beam_momentum) const override;
 
   /**
@@ -173,7 +264,7 @@ class ScatterActionsFinder : public ActionFinderInterface {
    * \return A list of possible scatter actions
    */
   ActionList find_actions_with_neighbors(
-      const ParticleList &search_list, const ParticleList &neighbors_list,
+      const ParticleSpan &search_list, const ParticleSpan &neighbors_list,
       double dt, const std::vector<FourVector> &beam_momentum) const override;
 
   /**
@@ -229,21 +320,31 @@ class ScatterActionsFinder : public ActionFinderInterface {
    *         collision criterion.
    */
   double max_transverse_distance_sqr(int testparticles) const {
-    return (is_constant_elastic_isotropic()
-                ? finder_parameters_.elastic_parameter
-                : finder_parameters_.maximum_cross_section) /
-           testparticles * fm2_mb * M_1_PI;
+    return maximum_cross_section() / testparticles * fm2_mb * M_1_PI;
+  }
+
+  /**
+   * \return The maximal cross section [mb], which is the constant elastic one
+   *         if all collisions are elastic and isotropic.
+   */
+  double maximum_cross_section() const {
+    return is_constant_elastic_isotropic()
+               ? finder_parameters_.elastic_parameter
+               : finder_parameters_.maximum_cross_section;
   }
 
   /**
    * Prints out all the 2-> n (n > 1) reactions with non-zero cross-sections
-   * between all possible pairs of particle types.
+   * between all possible pairs of particle types. The pairs are scanned in
+   * parallel and every line is printed as soon as it and all before it are
+   * done.
    */
   void dump_reactions() const;
 
   /**
    * Print out partial cross-sections of all processes that can occur in
-   * the collision of a(mass = m_a) and b(mass = m_b).
+   * the collision of a(mass = m_a) and b(mass = m_b). The energies are
+   * computed in parallel.
    *
    * \param[in] a The specie of the first incoming particle.
    * \param[in] b The specie of the second incoming particle.
@@ -270,7 +371,134 @@ class ScatterActionsFinder : public ActionFinderInterface {
     }
   }
 
+  /**
+   * Get the counts of the examined pairs, which are accumulated over all
+   * threads since the last call, and reset them.
+   *
+   * \return Counts of the finder, without those of the performed actions
+   */
+  CollisionFinderStatistics take_statistics();
+
+  /**
+   * Capture every pair checked for a collision in a trace.
+   *
+   * \param[in] trace Trace to which the pairs are added, nullptr to stop
+   *            capturing. It has to outlive the finder or the capturing.
+   */
+  void set_collision_trace(CollisionTrace *trace) { collision_trace_ = trace; }
+
+  /**
+   * Check a pair for a collision with the given criterion, as during the
+   * search. This is used to replay a captured pair, see CollisionTrace.
+   *
+   * \param[in] record The captured pair
+   * \param[inout] counts Counts to which the stage rejecting the pair is
+   *               added
+   * \return The found collision, or nullptr
+   */
+  ActionPtr check_collision(const CollisionTraceRecord &record,
+                            CollisionFinderStatistics &counts) const;
+
+  /**
+   * Set up a collision with all its branches, as it is found by the search,
+   * without checking whether it happens. This is used to replay a captured
+   * collision, see CollisionTrace.
+   *
+   * \param[in] record The captured collision
+   * \return The collision, whose final state can be generated
+   */
+  ActionPtr create_collision(const CollisionTraceRecord &record) const;
+
  private:
+  /**
+   * Call a function with the collision criterion of the run as a constant
+   * expression. The criterion is fixed for the whole run, hence the search
+   * loops dispatch once and check every pair with a specialized kernel.
+   *
+   * \param[in] f Function, which is called with a
+   *            `std::integral_constant<CollisionCriterion, ...>`
+   * \return The result of \p f
+   */
+  template <typename F>
+  decltype(auto) with_criterion(F &&f) const {
+    switch (finder_parameters_.coll_crit) {
+      case CollisionCriterion::Geometric:
+        return f(CriterionConstant<CollisionCriterion::Geometric>{});
+      case CollisionCriterion::Stochastic:
+        return f(CriterionConstant<CollisionCriterion::Stochastic>{});
+      case CollisionCriterion::Covariant:
+        return f(CriterionConstant<CollisionCriterion::Covariant>{});
+    }
+    throw std::invalid_argument("Unknown collision criterion.");
+  }
+
+  /// Collision criterion as a type, which with_criterion passes on
+  template <CollisionCriterion Criterion>
+  using CriterionConstant =
+      std::integral_constant<CollisionCriterion, Criterion>;
+
+  /**
+   * Determine which total cross section is used for two particles.
+   *
+   * \param[in] data_a First incoming particle
+   * \param[in] data_b Second incoming particle
+   * \return Whether the total cross section is parametrized instead of summed
+   *         from the partial cross sections
+   */
+  bool incoming_parametrized(const ParticleData &data_a,
+                             const ParticleData &data_b) const;
+
+  /**
+   * Check by the types of two particles and their center-of-mass energy,
+   * whether any of the included processes may take place.
+   *
+   * \param[in] data_a First incoming particle
+   * \param[in] data_b Second incoming particle
+   * \return False if the pair cannot interact at all
+   */
+  bool can_interact(const ParticleData &data_a,
+                    const ParticleData &data_b) const;
+
+  /**
+   * Fill interaction_thresholds_ for all pairs of particle types from the
+   * included processes. The rules over-approximate the processes, such that
+   * no pair is excluded which might interact.
+   */
+  void tabulate_interaction_thresholds() const;
+
+  /**
+   * Compute the total cross section of two particles in the same way as for
+   * the collision criterion, without the scaling factors for formation or
+   * test particles. It is tabulated by the cross section envelope.
+   *
+   * \param[in] data_a First incoming particle
+   * \param[in] data_b Second incoming particle
+   * \return Total cross section [mb]
+   */
+  double exact_cross_section(const ParticleData &data_a,
+                             const ParticleData &data_b) const;
+
+  /**
+   * Compute the collision branches of two particles in the same way as for
+   * a collision, without the scaling factors for formation. They are
+   * tabulated by the cross section table.
+   *
+   * \param[in] data_a First incoming particle
+   * \param[in] data_b Second incoming particle
+   * \return Collision branches
+   */
+  CollisionBranchList exact_collision_list(const ParticleData &data_a,
+                                           const ParticleData &data_b) const;
+
+  /**
+   * Add the collision branches to an action, which are interpolated by the
+   * cross section table, if it is enabled and applies.
+   *
+   * \param[inout] act Action of two particles
+   * \return Whether the branches were added
+   */
+  bool add_tabulated_scatterings(ScatterAction &act) const;
+
   /**
    * Check for a single pair of particles (id_a, id_b) if a collision will
    * happen in the next timestep and create a corresponding Action object
@@ -279,24 +507,60 @@ class ScatterActionsFinder : public ActionFinderInterface {
    * Two criteria for the collision decision are supported: 1. The default
    * geometric criterion from UrQMD \iref{Bass:1998ca} (3.27). 2. A stochastic
    * collision criterion as introduced in \iref{Staudenmaier:2021lrg}.
+   * The criterion is a template parameter, such that the checks of every pair
+   * are specialized for it, see with_criterion.
    *
+   * \tparam Criterion Collision criterion of the run
    * \param[in] data_a First incoming particle
    * \param[in] data_b Second incoming particle
    * \param[in] dt Maximum time interval within which a collision can happen
+   * \param[inout] counts Counts of the calling search, to which the stage
+   *               rejecting the pair is added
    * \param[in] beam_momentum [GeV] List of beam momenta for each particle;
    * only necessary for frozen Fermi motion
    * \param[in] gcell_vol (optional) volume of grid cell in which the collision
    *                                is checked
+   * \param[in] majorant (optional) Probability with which the pair was picked
+   *                     as a candidate by the stochastic criterion, such that
+   *                     it collides with the probability divided by it
    * \return A null pointer if no collision happens or an action which contains
    *         the information of the outgoing particles.
    *
    * Note: gcell_vol is optional, since only find_actions_in_cell has (and
    * needs) this information for the stochastic collision criterion.
    */
+  template <CollisionCriterion Criterion>
   ActionPtr check_collision_two_part(
       const ParticleData &data_a, const ParticleData &data_b, double dt,
+      CollisionFinderStatistics &counts,
       const std::vector<FourVector> &beam_momentum = {},
-      const double gcell_vol = 0.0) const;
+      const double gcell_vol = 0.0, const double majorant = 1.0) const;
+
+  /**
+   * Check randomly picked pairs of a cell for collisions with the stochastic
+   * criterion, see
+   * <tt>\ref key_CT_sample_pairs_ "Sample_Pairs"</tt>. The number of
+   * candidates is binomially distributed with the majorant of the collision
+   * probabilities out of all pairs, and every candidate is accepted with its
+   * probability divided by the majorant. Hence every pair collides with its
+   * probability, as if all pairs were checked.
+   *
+   * \param[in] search_list Particles within one cell
+   * \param[in] dt The maximum time interval at the current time step [fm]
+   * \param[in] gcell_vol Volume of the cell [fm^3]
+   * \param[in] beam_momentum [GeV] List of beam momenta for each particle;
+   *            only necessary for frozen Fermi motion
+   * \param[inout] counts Counts of the search, the candidates are counted as
+   *               pairs in cells
+   * \param[out] actions Actions, to which the collisions are added
+   * \return Whether the pairs were sampled, which is not the case if the
+   *         majorant exceeds one half; then all pairs have to be checked.
+   */
+  bool sample_pairs_in_cell(const ParticleSpan &search_list, double dt,
+                            double gcell_vol,
+                            const std::vector<FourVector> &beam_momentum,
+                            CollisionFinderStatistics &counts,
+                            ActionList &actions) const;
 
   /**
    * Check for multiple i.e. more than 2 particles if a collision will happen in
@@ -316,12 +580,68 @@ class ScatterActionsFinder : public ActionFinderInterface {
   ActionPtr check_collision_multi_part(const ParticleList &plist, double dt,
                                        const double gcell_vol) const;
 
+  /**
+   * Check all combinations of particles in a cell for the included
+   * multi-particle reactions with check_collision_multi_part.
+   *
+   * Only particles of the species taking part in the included reactions are
+   * combined, and a combination is extended only as long as a reaction
+   * with all of its particles remains possible. Hence, the number of checked
+   * combinations grows with the number of suitable particles, instead of with
+   * the fifth power of all particles in the cell.
+   *
+   * \param[in] search_list Particles in the cell
+   * \param[in] dt Maximum time interval within which a collision can happen
+   * \param[in] gcell_vol Volume of the grid cell
+   * \param[inout] actions List, to which the found actions are added
+   */
+  void add_multi_particle_actions(const ParticleSpan &search_list, double dt,
+                                  const double gcell_vol,
+                                  ActionList &actions) const;
+
+  /**
+   * Find the two-particle collisions between the particles of two lists
+   * according to the geometric collision criterion.
+   *
+   * Most pairs are far apart. They are rejected by a CollisionPrefilter
+   * for all partners of a particle at once. The transverse distance of the
+   * selected pairs is compared with their cross section envelope, such that
+   * ScatterAction objects are only constructed for pairs which may collide.
+   * The found actions are the same as by calling check_collision_two_part for
+   * all pairs.
+   *
+   * \param[in] search_list Particles to be tested for collisions
+   * \param[in] partners Possible collision partners
+   * \param[in] same_list Whether \p partners is \p search_list, then every
+   *            pair is tested once
+   * \param[in] dt Maximum time interval within which a collision can happen
+   * \param[in] beam_momentum [GeV] List of beam momenta for each particle;
+   * only necessary for frozen Fermi motion
+   * \param[inout] counts Counts of the calling search
+   * \return A list of possible scatter actions
+   */
+  ActionList find_geometric_collisions(
+      const ParticleSpan &search_list, const ParticleSpan &partners,
+      bool same_list, double dt, const std::vector<FourVector> &beam_momentum,
+      CollisionFinderStatistics &counts) const;
+
+  /**
+   * Add the counts of a search to those of the finder. Every search counts
+   * in a local instance first, such that the shared counts are only locked
+   * once per search.
+   *
+   * \param[in] counts Counts of a search
+   */
+  void add_statistics(const CollisionFinderStatistics &counts) const;
+
   /// Struct collecting several parameters.
   ScatterActionsFinderParameters finder_parameters_;
   /// Class that deals with strings, interfacing Pythia.
   std::unique_ptr<StringProcess> string_process_interface_;
   /// Do all collisions isotropically.
   const bool isotropic_;
+  /// Sample the checked pairs of a cell with the stochastic criterion
+  const bool sample_pairs_;
   /**
    * Box length: needed to determine coordinates of collision
    * correctly in case of collision through the wall.
@@ -330,6 +650,31 @@ class ScatterActionsFinder : public ActionFinderInterface {
   const double box_length_;
   /// Parameter for formation time
   const double string_formation_time_;
+  /**
+   * Upper bound of the total cross sections, by which most pairs are
+   * rejected before the exact cross section is computed
+   */
+  CrossSectionEnvelope cross_section_envelope_;
+  /**
+   * Optional table of the collision branches, from which they are
+   * interpolated instead of computed
+   */
+  std::unique_ptr<CrossSectionTable> cross_section_table_;
+  /**
+   * Minimal center-of-mass energy, above which two particle types may
+   * interact, for all ordered pairs of types [GeV]. It is 0 if the pair may
+   * interact at any energy and infinite if it never interacts. The table is
+   * built on the first use, once the decay modes are known.
+   */
+  mutable std::vector<double> interaction_thresholds_;
+  /// Guards the construction of interaction_thresholds_
+  mutable std::once_flag interaction_thresholds_once_;
+  /// Guards statistics_, as the finder is shared by the ensembles
+  mutable std::mutex statistics_mutex_;
+  /// Counts accumulated since the last call of take_statistics
+  mutable CollisionFinderStatistics statistics_;
+  /// Trace capturing the checked pairs, nullptr if they are not captured
+  CollisionTrace *collision_trace_ = nullptr;
 };
 
 /**
@@ -0,0 +1,98 @@
+/*
+ *
+ *    Copyright (c) 2024
+ *      SMASH Team
+ *
+ *    GNU General Public License (GPLv3 or later)
+ *
+ */
+
+#ifndef SRC_INCLUDE_SMASH_SESSION_H_
+#define SRC_INCLUDE_SMASH_SESSION_H_
+
+#include <filesystem>
+#include <memory>
+#include <utility>
+
+#include "configuration.h"
+#include "experiment.h"
+#include "forwarddeclarations.h"
+
+namespace smash {
+
+/**
+ * \ingroup data
+ *
+ * Long-lived interface to SMASH used as a library, e.g. as an afterburner
+ * which evolves batches of particles sampled by another model.
+ *
+ * The session sets up the experiment once and evolves every event given to
+ * it with that experiment. The configuration is therefore parsed only once,
+ * and the action finders, outputs and the storage of the particles and
+ * actions are reused for all events. The particle types, decay modes and
+ * tabulations have to be initialized before, see
+ * initialize_particles_decays_and_tabulations.
+ *
+ * The particles of every event are added to the initial state of the modus
+ * at its start. For an afterburner, a modus without any initial particles
+ * can be used, e.g. the sphere modus with empty initial multiplicities. The
+ * final particles are handed back directly, so no output has to be
+ * configured.
+ *
+ * \tparam Modus Modus of the experiment
+ */
+template <typename Modus>
+class Session {
+ public:
+  /**
+   * Set up the experiment used for all events of the session.
+   *
+   * \param[inout] config Fully set up configuration, from which all values
+   *                      are taken
+   * \param[in] output_path Directory where the configured outputs, if any,
+   *                        are written
+   */
+  Session(Configuration &config, const std::filesystem::path &output_path)
+      : experiment_(std::make_unique<Experiment<Modus>>(config, output_path)) {}
+
+  /**
+   * Evolve an event.
+   *
+   * \param[in] particles Particles added at the start of the event
+   * \param[in] end_time Time until which the event is evolved, which must not
+   *                     be later than the configured end time
+   * \param[in] final_decays Whether the unstable particles are decayed at the
+   *                         end of the event
+   * \return The particles at the end of the event. The list is reused by the
+   *         next event, so it is only valid until then.
+   */
+  const ParticleList &run_event(ParticleList &&particles, double end_time,
+                                bool final_decays = true) {
+    experiment_->initialize_new_event();
+    experiment_->run_time_evolution(end_time, std::move(particles));
+    if (final_decays) {
+      experiment_->do_final_decays();
+    }
+    experiment_->final_output();
+    experiment_->increase_event_number();
+    const Particles &final_particles = *experiment_->first_ensemble();
+    final_particles_.clear();
+    final_particles_.insert(final_particles_.end(), final_particles.begin(),
+                            final_particles.end());
+    return final_particles_;
+  }
+
+  /// \return The experiment evolving the events
+  Experiment<Modus> &experiment() { return *experiment_; }
+
+ private:
+  /// Experiment evolving the events
+  std::unique_ptr<Experiment<Modus>> experiment_;
+
+  /// Particles at the end of the last event
+  ParticleList final_particles_;
+};
+
+}  // namespace smash
+
+#endif  // SRC_INCLUDE_SMASH_SESSION_H_
@@ -0,0 +1,145 @@
+/*
+ *
+ *    Copyright (c) 2024
+ *      SMASH Team
+ *
+ *    GNU General Public License (GPLv3 or later)
+ *
+ */
+
+#ifndef SRC_INCLUDE_SMASH_SHARDEDOUTPUT_H_
+#define SRC_INCLUDE_SMASH_SHARDEDOUTPUT_H_
+
+#include <cstddef>
+#include <filesystem>
+#include <memory>
+#include <vector>
+
+#include "asyncoutput.h"
+#include "forwarddeclarations.h"
+#include "outputinterface.h"
+
+namespace smash {
+
+/**
+ * \ingroup output
+ *
+ * Particles output, which is split into shards that are written in parallel.
+ *
+ * Every shard is an output of its own in a directory of its own, which is
+ * written by its own thread like an AsyncOutput. Since every ensemble is
+ * written as an event of its own, the particle lists of an ensemble go to the
+ * shard given by its event number modulo the number of shards, see \ref
+ * key_output_particles_shards_. Hence the ensembles of an event are written
+ * concurrently. The end of an event waits until all shards are written.
+ *
+ * Once the shards are complete, a manifest `<file>.shards` is written next to
+ * the shard directories for every file of the shards. It lists the paths of
+ * the shards of the file relative to the manifest, one per line, preceded by
+ * comments starting with `#`. The BinaryReader reads such a manifest like a
+ * single binary file.
+ */
+class ShardedOutput : public OutputInterface {
+ public:
+  /**
+   * Write to the given shards.
+   *
+   * \param[in] path Directory of the manifests
+   * \param[in] shards Outputs of the shards, each writing to its own
+   *            directory
+   * \param[in] directories Directories of the shards
+   * \throw std::invalid_argument if there are no shards or not as many
+   *        directories as shards.
+   */
+  ShardedOutput(const std::filesystem::path &path, OutputsList shards,
+                std::vector<std::filesystem::path> directories);
+
+  /// Finish the shards and write the manifests.
+  ~ShardedOutput() override;
+
+  /**
+   * Pass the particles of an ensemble to its shard.
+   *
+   * \param[in] particles Particles of the ensemble
+   * \param[in] event_number Number of the ensemble as event
+   * \param[in] info Event info, see \ref EventInfo
+   */
+  void at_eventstart(const Particles &particles, const int event_number,
+                     const EventInfo &info) override;
+
+  /**
+   * Mark the start of an event, after the starts of all its ensembles.
+   */
+  void at_eventstart(const std::vector<Particles> &, int) override;
+
+  /**
+   * Pass the particles of an ensemble to its shard.
+   *
+   * \param[in] particles Particles of the ensemble
+   * \param[in] event_number Number of the ensemble as event
+   * \param[in] info Event info, see \ref EventInfo
+   */
+  void at_eventend(const Particles &particles, const int event_number,
+                   const EventInfo &info) override;
+
+  /**
+   * Wait until the shards have written the event, after the ends of all its
+   * ensembles.
+   *
+   * \throw Whatever the outputs of the shards threw.
+   */
+  void at_eventend(const std::vector<Particles> &, const int) override;
+
+  /**
+   * Pass the particles of an ensemble to its shard. The ensembles come in the
+   * same order as at the start of the event.
+   *
+   * \param[in] particles Particles of the ensemble
+   * \param[in] clock Clock of the output times
+   * \param[in] dens_param Parameters of the density
+   * \param[in] info Event info, see \ref EventInfo
+   */
+  void at_intermediate_time(const Particles &particles,
+                            const std::unique_ptr<Clock> &clock,
+                            const DensityParameters &dens_param,
+                            const EventInfo &info) override;
+
+  /// Mark the end of an intermediate time, after all ensembles.
+  void at_intermediate_time(const std::vector<Particles> &,
+                            const std::unique_ptr<Clock> &,
+                            const DensityParameters &) override;
+
+  /**
+   * Finish the run of all shards.
+   *
+   * \throw Whatever the outputs of the shards threw.
+   */
+  void at_runend() override;
+
+ private:
+  /**
+   * \param[in] event_number Number of an ensemble as event
+   * \return The shard of the ensemble
+   */
+  AsyncOutput &shard(int event_number);
+
+  /// Write the manifests of the files of the shards.
+  void write_manifests() const;
+
+  /// Directory of the manifests
+  const std::filesystem::path path_;
+  /// Directories of the shards
+  const std::vector<std::filesystem::path> directories_;
+  /// Shards, each writing in a thread of its own
+  std::vector<std::unique_ptr<AsyncOutput>> shards_;
+  /// Shards of the ensembles in the order of the start of the event
+  std::vector<std::size_t> event_shards_;
+  /// Whether the ensembles of the current event are still starting
+  bool starting_ = false;
+  /// Index of the ensemble at the next intermediate time
+  std::size_t next_ensemble_ = 0;
+};
+
+}  // namespace smash
+
+#endif  // SRC_INCLUDE_SMASH_SHARDEDOUTPUT_H_
@@ -0,0 +1,412 @@
+/*
+ *
+ *    Copyright (c) 2024
+ *      SMASH Team
+ *
+ *    GNU General Public License (GPLv3 or later)
+ *
+ */
+
+#ifndef SRC_INCLUDE_SMASH_SMALLVECTOR_H_
+#define SRC_INCLUDE_SMASH_SMALLVECTOR_H_
+
+#include <algorithm>
+#include <cstddef>
+#include <initializer_list>
+#include <iterator>
+#include <memory>
+#include <ostream>
+#include <stdexcept>
+#include <type_traits>
+
+namespace smash {
+
+/**
+ * \ingroup data
+ *
+ * A vector which stores up to \p N elements within the object itself and
+ * only allocates memory for more elements.
+ *
+ * It is meant for the short lists of particle types in the collision and
+ * decay branches, which almost always hold two or three types, such that
+ * setting up the branches of an action does not allocate memory for them.
+ * The interface is the subset of the one of std::vector used for these
+ * lists. The elements must be trivially copyable, hence they are copied as
+ * bytes and never destructed.
+ *
+ * \tparam T Type of the elements
+ * \tparam N Number of elements stored within the object
+ */
+template <typename T, std::size_t N>
+class SmallVector {
+  static_assert(std::is_trivially_copyable_v<T>,
+                "The elements of a SmallVector are copied as bytes.");
+  static_assert(N > 0, "A SmallVector needs inline storage.");
+
+ public:
+  /// Type of the elements
+  using value_type = T;
+  /// Type of the sizes
+  using size_type = std::size_t;
+  /// Type of the distances of the iterators
+  using difference_type = std::ptrdiff_t;
+  /// Reference to an element
+  using reference = T &;
+  /// Constant reference to an element
+  using const_reference = const T &;
+  /// Iterator over the elements
+  using iterator = T *;
+  /// Constant iterator over the elements
+  using const_iterator = const T *;
+  /// Reverse iterator over the elements
+  using reverse_iterator = std::reverse_iterator<iterator>;
+  /// Constant reverse iterator over the elements
+  using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+
+  /// Construct an empty vector.
+  SmallVector() = default;
+
+  /**
+   * Construct a vector of default elements.
+   *
+   * \param[in] n Number of elements
+   */
+  explicit SmallVector(size_type n) { resize(n); }
+
+  /**
+   * Construct a vector of copies of an element.
+   *
+   * \param[in] n Number of elements
+   * \param[in] value Element to be copied
+   */
+  SmallVector(size_type n, const T &value) { resize(n, value); }
+
+  /**
+   * Construct a vector from a range.
+   *
+   * \param[in] first Begin of the range
+   * \param[in] last End of the range
+   */
+  template <typename InputIt,
+            typename = typename std::iterator_traits<InputIt>::value_type>
+  SmallVector(InputIt first, InputIt last) {
+    insert(end(), first, last);
+  }
+
+  /**
+   * Construct a vector from a list of elements.
+   *
+   * \param[in] values Elements
+   */
+  SmallVector(std::initializer_list<T> values)
+      : SmallVector(values.begin(), values.end()) {}
+
+  /// Copy constructor
+  SmallVector(const SmallVector &other)
+      : SmallVector(other.begin(), other.end()) {}
+
+  /// Move constructor, which takes over the allocated memory
+  SmallVector(SmallVector &&other) noexcept { take(other); }
+
+  /// Copy assignment
+  SmallVector &operator=(const SmallVector &other) {
+    if (this != &other) {
+      assign(other.begin(), other.end());
+    }
+    return *this;
+  }
+
+  /// Move assignment, which takes over the allocated memory
+  SmallVector &operator=(SmallVector &&other) noexcept {
+    if (this != &other) {
+      heap_.reset();
+      take(other);
+    }
+    return *this;
+  }
+
+  /// Assignment of a list of elements
+  SmallVector &operator=(std::initializer_list<T> values) {
+    assign(values.begin(), values.end());
+    return *this;
+  }
+
+  /**
+   * Replace the elements by a range.
+   *
+   * \param[in] first Begin of the range
+   * \param[in] last End of the range
+   */
+  template <typename InputIt>
+  void assign(InputIt first, InputIt last) {
+    clear();
+    insert(end(), first, last);
+  }
+
+  /// \return Pointer to the first element
+  T *data() { return heap_ ? heap_.get() : inline_; }
+  /// \return Constant pointer to the first element
+  const T *data() const { return heap_ ? heap_.get() : inline_; }
+
+  /// \return Iterator to the first element
+  iterator begin() { return data(); }
+  /// \return Iterator behind the last element
+  iterator end() { return data() + size_; }
+  /// \return Constant iterator to the first element
+  const_iterator begin() const { return data(); }
+  /// \return Constant iterator behind the last element
+  const_iterator end() const { return data() + size_; }
+  /// \return Constant iterator to the first element
+  const_iterator cbegin() const { return begin(); }
+  /// \return Constant iterator behind the last element
+  const_iterator cend() const { return end(); }
+  /// \return Reverse iterator to the last element
+  reverse_iterator rbegin() { return reverse_iterator(end()); }
+  /// \return Reverse iterator before the first element
+  reverse_iterator rend() { return reverse_iterator(begin()); }
+  /// \return Constant reverse iterator to the last element
+  const_reverse_iterator rbegin() const {
+    return const_reverse_iterator(end());
+  }
+  /// \return Constant reverse iterator before the first element
+  const_reverse_iterator rend() const {
+    return const_reverse_iterator(begin());
+  }
+
+  /// \return Number of elements
+  size_type size() const { return size_; }
+  /// \return Whether there are no elements
+  bool empty() const { return size_ == 0; }
+  /// \return Number of elements which fit without allocating memory
+  size_type capacity() const { return capacity_; }
+
+  /// \return Element \p i
+  T &operator[](size_type i) { return data()[i]; }
+  /// \return Element \p i
+  const T &operator[](size_type i) const { return data()[i]; }
+
+  /**
+   * \return Element \p i
+   * \throw std::out_of_range if there is no such element
+   */
+  T &at(size_type i) {
+    check_index(i);
+    return data()[i];
+  }
+  /**
+   * \return Element \p i
+   * \throw std::out_of_range if there is no such element
+   */
+  const T &at(size_type i) const {
+    check_index(i);
+    return data()[i];
+  }
+
+  /// \return First element
+  T &front() { return data()[0]; }
+  /// \return First element
+  const T &front() const { return data()[0]; }
+  /// \return Last element
+  T &back() { return data()[size_ - 1]; }
+  /// \return Last element
+  const T &back() const { return data()[size_ - 1]; }
+
+  /**
+   * Make sure that \p n elements fit without allocating memory again.
+   *
+   * \param[in] n Number of elements
+   */
+  void reserve(size_type n) {
+    if (n <= capacity_) {
+      return;
+    }
+    std::unique_ptr<T[]> heap(new T[n]);
+    std::copy(begin(), end(), heap.get());
+    heap_ = std::move(heap);
+    capacity_ = n;
+  }
+
+  /**
+   * Change the number of elements.
+   *
+   * \param[in] n Number of elements
+   * \param[in] value Element, which new elements are copies of
+   */
+  void resize(size_type n, const T &value = T()) {
+    reserve(n);
+    if (n > size_) {
+      std::fill(end(), begin() + n, value);
+    }
+    size_ = n;
+  }
+
+  /// Remove all elements, keeping the memory.
+  void clear() { size_ = 0; }
+
+  /**
+   * Append an element.
+   *
+   * \param[in] value Element
+   */
+  void push_back(const T &value) {
+    // The element may be part of this vector, which is reallocated
+    const T copy = value;
+    grow(size_ + 1);
+    data()[size_++] = copy;
+  }
+
+  /**
+   * Append an element constructed from the arguments.
+   *
+   * \param[in] args Arguments of the constructor of the element
+   * \return The new element
+   */
+  template <typename... Args>
+  T &emplace_back(Args &&...args) {
+    push_back(T(std::forward<Args>(args)...));
+    return back();
+  }
+
+  /// Remove the last element.
+  void pop_back() { size_--; }
+
+  /**
+   * Insert an element.
+   *
+   * \param[in] pos Position of the new element
+   * \param[in] value Element
+   * \return Iterator to the new element
+   */
+  iterator insert(const_iterator pos, const T &value) {
+    const T copy = value;
+    const size_type i = pos - begin();
+    grow(size_ + 1);
+    std::copy_backward(begin() + i, end(), end() + 1);
+    data()[i] = copy;
+    size_++;
+    return begin() + i;
+  }
+
+  /**
+   * Insert a range of elements.
+   *
+   * \param[in] pos Position of the first new element
+   * \param[in] first Begin of the range
+   * \param[in] last End of the range
+   * \return Iterator to the first new element
+   */
+  template <typename InputIt,
+            typename = typename std::iterator_traits<InputIt>::value_type>
+  iterator insert(const_iterator pos, InputIt first, InputIt last) {
+    size_type i = pos - begin();
+    const size_type first_index = i;
+    for (; first != last; ++first) {
+      insert(begin() + i, *first);
+      i++;
+    }
+    return begin() + first_index;
+  }
+
+  /**
+   * Remove an element.
+   *
+   * \param[in] pos Position of the element
+   * \return Iterator to the element following the removed one
+   */
+  iterator erase(const_iterator pos) { return erase(pos, pos + 1); }
+
+  /**
+   * Remove a range of elements.
+   *
+   * \param[in] first Begin of the range
+   * \param[in] last End of the range
+   * \return Iterator to the element following the removed ones
+   */
+  iterator erase(const_iterator first, const_iterator last) {
+    const size_type i = first - begin();
+    const size_type n = last - first;
+    std::copy(begin() + i + n, end(), begin() + i);
+    size_ -= n;
+    return begin() + i;
+  }
+
+  /// Exchange the elements with another vector.
+  void swap(SmallVector &other) noexcept {
+    SmallVector tmp(std::move(other));
+    other = std::move(*this);
+    *this = std::move(tmp);
+  }
+
+  /// \return Whether both vectors hold the same elements
+  friend bool operator==(const SmallVector &a, const SmallVector &b) {
+    return std::equal(a.begin(), a.end(), b.begin(), b.end());
+  }
+  /// \return Whether the vectors differ
+  friend bool operator!=(const SmallVector &a, const SmallVector &b) {
+    return !(a == b);
+  }
+  /// \return Whether \p a is lexicographically before \p b
+  friend bool operator<(const SmallVector &a, const SmallVector &b) {
+    return std::lexicographical_compare(a.begin(), a.end(), b.begin(),
+                                        b.end());
+  }
+
+ private:
+  /// Allocate memory for at least \p n elements, doubling the capacity.
+  void grow(size_type n) {
+    if (n > capacity_) {
+      reserve(std::max(n, 2 * capacity_));
+    }
+  }
+
+  /// Throw unless \p i is the index of an element.
+  void check_index(size_type i) const {
+    if (i >= size_) {
+      throw std::out_of_range("SmallVector index out of range");
+    }
+  }
+
+  /// Take over the elements of \p other, leaving it empty.
+  void take(SmallVector &other) {
+    if (other.heap_) {
+      heap_ = std::move(other.heap_);
+      capacity_ = other.capacity_;
+    } else {
+      std::copy(other.begin(), other.end(), inline_);
+      capacity_ = N;
+    }
+    size_ = other.size_;
+    other.size_ = 0;
+    other.capacity_ = N;
+  }
+
+  /// Storage of the first elements, unless they were moved to the heap
+  T inline_[N] = {};
+  /// Storage of the elements, once they do not fit within the object
+  std::unique_ptr<T[]> heap_;
+  /// Number of elements
+  size_type size_ = 0;
+  /// Number of elements which fit into the current storage
+  size_type capacity_ = N;
+};
+
+/**
+ * \ingroup logging
+ * Writes the elements of a SmallVector, like those of a std::vector.
+ *
+ * \param[in] out Stream to write to
+ * \param[in] v Vector to be written
+ * \return The stream
+ */
+template <typename T, std::size_t N>
+std::ostream &operator<<(std::ostream &out, const SmallVector<T, N> &v) {
+  out << "{";
+  for (std::size_t i = 0; i < v.size(); i++) {
+    out << (i == 0 ? "" : ", ") << v[i];
+  }
+  return out << "}";
+}
+
+}  // namespace smash
+
+#endif  // SRC_INCLUDE_SMASH_SMALLVECTOR_H_
@@ -0,0 +1,145 @@
+/*
+ *
+ *    Copyright (c) 2024
+ *      SMASH Team
+ *
+ *    GNU General Public License (GPLv3 or later)
+ *
+ */
+
+#ifndef SRC_INCLUDE_SMASH_SMEARINGCONVOLUTION_H_
+#define SRC_INCLUDE_SMASH_SMEARINGCONVOLUTION_H_
+
+#include <array>
+#include <functional>
+
+#include "fourvector.h"
+#include "latticefft.h"
+#include "threevector.h"
+
+namespace smash {
+
+/**
+ * \ingroup data
+ *
+ * Smears currents onto the nodes of a lattice by first depositing the
+ * particles on the nodes and then convolving them with the smearing kernel
+ * by fast Fourier transforms.
+ *
+ * The particles are deposited with cloud-in-cell weights, i.e. a particle is
+ * distributed linearly over the eight nodes around it in proportion to its
+ * distance to them. The convolution with a kernel of fixed shape thus costs
+ * the same for any number of particles. A particle sitting on a node is
+ * smeared exactly like by the kernel. Since the shape of the kernel does not
+ * depend on the particle, it cannot be contracted like the covariant
+ * Gaussian smearing of moving particles.
+ *
+ * The spatial derivatives of the net current are central finite differences
+ * of the smeared current, which are computed as convolutions with the
+ * differences of the kernel in the same Fourier space. On the boundary of a
+ * non-periodic lattice, the smeared current continues beyond the lattice
+ * instead of one-sided differences being taken.
+ *
+ * The positive and negative currents are kept apart, like in
+ * DensityOnLattice. Each grid holds two real components as real and
+ * imaginary part, which the kernel, being real, does not mix.
+ */
+class SmearingConvolution {
+ public:
+  /**
+   * Set up the transforms for a lattice and transform the kernel.
+   *
+   * \param[in] n_cells Number of cells of the lattice in every direction
+   * \param[in] cell_sizes Sizes of the lattice cells [fm]
+   * \param[in] origin Origin of the lattice [fm]
+   * \param[in] periodic Whether the lattice is periodic
+   * \param[in] range Largest offset in cells between a particle and the
+   *            nodes it is smeared on, in every direction
+   * \param[in] kernel Weight of a particle on a node at an offset in cells,
+   *            which vanishes beyond the range
+   */
+  SmearingConvolution(const std::array<int, 3> &n_cells,
+                      const std::array<double, 3> &cell_sizes,
+                      const std::array<double, 3> &origin, bool periodic,
+                      const std::array<int, 3> &range,
+                      const std::function<double(int, int, int)> &kernel);
+
+  /// Remove all deposited particles.
+  void clear();
+
+  /**
+   * Deposit a particle on the eight nodes around it. Particles are only
+   * deposited on the nodes of the lattice.
+   *
+   * \param[in] pos Position of the particle [fm]
+   * \param[in] jmu Current of the particle, i.e. its four-velocity times its
+   *            contribution to the density, which decides whether it adds
+   *            to the positive or negative current
+   */
+  void deposit(const ThreeVector &pos, const FourVector &jmu);
+
+  /**
+   * Convolve the deposited currents with the kernel.
+   *
+   * \param[in] compute_gradient Whether to compute the spatial derivatives
+   *            of the net current as well
+   */
+  void convolve(bool compute_gradient);
+
+  /// \return Smeared current of the positively charged particles on a node
+  FourVector jmu_pos(int ix, int iy, int iz) const {
+    return current(sources_[0], sources_[1], fft_.grid_index(ix, iy, iz));
+  }
+
+  /// \return Smeared current of the negatively charged particles on a node
+  FourVector jmu_neg(int ix, int iy, int iz) const {
+    return has_negative_ ? current(sources_[2], sources_[3],
+                                   fft_.grid_index(ix, iy, iz))
+                         : FourVector();
+  }
+
+  /**
+   * \return Derivatives of the net current with respect to x, y and z on a
+   *         node, if they were computed
+   */
+  std::array<FourVector, 3> djmu_dx(int ix, int iy, int iz) const {
+    const std::size_t index = fft_.grid_index(ix, iy, iz);
+    return {current(gradients_[0], gradients_[1], index),
+            current(gradients_[2], gradients_[3], index),
+            current(gradients_[4], gradients_[5], index)};
+  }
+
+ private:
+  /// \return Four-vector stored in two grids
+  static FourVector current(const LatticeFFT::Grid &g01,
+                            const LatticeFFT::Grid &g23, std::size_t index) {
+    return FourVector(g01[index].real(), g01[index].imag(), g23[index].real(),
+                      g23[index].imag());
+  }
+
+  /// Transforms of the lattice
+  LatticeFFT fft_;
+  /// Sizes of the lattice cells [fm]
+  const std::array<double, 3> cell_sizes_;
+  /// Origin of the lattice [fm]
+  const std::array<double, 3> origin_;
+  /// Whether the lattice is periodic
+  const bool periodic_;
+  /// Transformed kernel
+  LatticeFFT::Grid kernel_;
+  /// Transformed central differences of the kernel in x, y and z direction
+  std::array<LatticeFFT::Grid, 3> gradient_kernels_;
+  /**
+   * Components 0 and 1 as well as 2 and 3 of the positive current, followed
+   * by the ones of the negative current
+   */
+  std::array<LatticeFFT::Grid, 4> sources_;
+  /// Components of the derivatives of the net current in every direction
+  std::array<LatticeFFT::Grid, 6> gradients_;
+  /// Whether any negative current was deposited
+  bool has_negative_ = false;
+};
+
+}  // namespace smash
+
+#endif  // SRC_INCLUDE_SMASH_SMEARINGCONVOLUTION_H_
@@ -0,0 +1,134 @@
+/*
+ *
+ *    Copyright (c) 2024
+ *      SMASH Team
+ *
+ *    GNU General Public License (GPLv3 or later)
+ *
+ */
+
+#ifndef SRC_INCLUDE_SMASH_SMEARINGSTENCIL_H_
+#define SRC_INCLUDE_SMASH_SMEARINGSTENCIL_H_
+
+#include <array>
+#include <cstddef>
+#include <vector>
+
+#include "fourvector.h"
+#include "threevector.h"
+
+namespace smash {
+
+/**
+ * \ingroup data
+ *
+ * Weights with which one particle is smeared onto the nodes of a lattice,
+ * computed for a box of cells around the particle before they are added to
+ * the nodes.
+ *
+ * For the covariant Gaussian smearing, the exponent along a row of cells in
+ * x direction is a quadratic polynomial of the cell index. The Gaussian is
+ * thus evaluated by a recurrence of products along the row, which needs
+ * three exponentials per row instead of one per node, and the distances are
+ * computed by loops the compiler vectorizes. The weights of the triangular
+ * smearing factorize into one weight per direction, which are computed once
+ * per particle.
+ *
+ * The stencil keeps its buffers from one particle to the next, such that
+ * filling it does not allocate memory once they have grown.
+ */
+class SmearingStencil {
+ public:
+  /**
+   * Compute the weights of the covariant Gaussian smearing, see
+   * unnormalized_smearing_factor.
+   *
+   * \param[in] l_bounds Lowest indices of the box of cells, see
+   *            RectangularLattice::rectangle_bounds
+   * \param[in] u_bounds Indices after the highest ones
+   * \param[in] origin Origin of the lattice [fm]
+   * \param[in] cell_sizes Sizes of the lattice cells [fm]
+   * \param[in] pos Position of the particle [fm]
+   * \param[in] u Four-velocity of the particle
+   * \param[in] r_cut_sqr Squared cut-off radius [fm\f$^2\f$]
+   * \param[in] two_sig_sqr_inv \f$ (2 \sigma^2)^{-1} \f$ [fm\f$^{-2}\f$]
+   * \param[in] compute_gradient Whether to compute the gradients as well
+   */
+  void covariant_gaussian(const std::array<int, 3> &l_bounds,
+                          const std::array<int, 3> &u_bounds,
+                          const std::array<double, 3> &origin,
+                          const std::array<double, 3> &cell_sizes,
+                          const ThreeVector &pos, const FourVector &u,
+                          double r_cut_sqr, double two_sig_sqr_inv,
+                          bool compute_gradient);
+
+  /**
+   * Compute the weights of the triangular smearing in every direction.
+   *
+   * \param[in] l_bounds Lowest indices of the box of cells, see
+   *            RectangularLattice::rectangle_bounds
+   * \param[in] u_bounds Indices after the highest ones
+   * \param[in] origin Origin of the lattice [fm]
+   * \param[in] cell_sizes Sizes of the lattice cells [fm]
+   * \param[in] pos Position of the particle [fm]
+   * \param[in] radius Range of the smearing in every direction [fm]
+   */
+  void triangular(const std::array<int, 3> &l_bounds,
+                  const std::array<int, 3> &u_bounds,
+                  const std::array<double, 3> &origin,
+                  const std::array<double, 3> &cell_sizes,
+                  const ThreeVector &pos, const std::array<double, 3> &radius);
+
+  /**
+   * \param[in] ix Index of a cell of the box in x direction, not wrapped for
+   *            periodic lattices
+   * \param[in] iy Index in y direction
+   * \param[in] iz Index in z direction
+   * \return Position of the cell in weights() and gradients()
+   */
+  std::size_t index(int ix, int iy, int iz) const {
+    return (ix - l_bounds_[0]) +
+           n_[0] * ((iy - l_bounds_[1]) + n_[1] * (iz - l_bounds_[2]));
+  }
+
+  /// \return Unnormalized weights of the covariant Gaussian smearing
+  const std::vector<double> &weights() const { return weights_; }
+
+  /// \return Gradients of the weights, if they were computed
+  const std::vector<ThreeVector> &gradients() const { return gradients_; }
+
+  /**
+   * \param[in] axis Direction
+   * \param[in] i Index of a cell of the box in this direction
+   * \return Weight of the triangular smearing in this direction [fm]
+   */
+  double triangular_weight(int axis, int i) const {
+    return axis_weights_[axis][i - l_bounds_[axis]];
+  }
+
+ private:
+  /// Set the box of cells.
+  void set_bounds(const std::array<int, 3> &l_bounds,
+                  const std::array<int, 3> &u_bounds);
+
+  /// Lowest indices of the box of cells
+  std::array<int, 3> l_bounds_ = {0, 0, 0};
+  /// Number of cells of the box in every direction
+  std::array<int, 3> n_ = {0, 0, 0};
+  /// Weights of all cells of the box, x being the fastest index
+  std::vector<double> weights_;
+  /// Gradients of the weights
+  std::vector<ThreeVector> gradients_;
+  /// Weights of the triangular smearing in every direction
+  std::array<std::vector<double>, 3> axis_weights_;
+  /// Exponents along a row of cells
+  std::vector<double> exponent_;
+  /// Projections of the distances on the velocity along a row of cells [fm]
+  std::vector<double> u_r_;
+  /// Whether the cells of a row lie within the cut-off, as 1 or 0
+  std::vector<double> inside_;
+};
+
+}  // namespace smash
+
+#endif  // SRC_INCLUDE_SMASH_SMEARINGSTENCIL_H_
@@ -1,5 +1,5 @@
 /*
- *    Copyright (c) 2013-2023
+ *    Copyright (c) 2013-2024
  *      SMASH Team
  *
  *    GNU General Public License (GPLv3 or later)
@@ -12,9 +12,12 @@
 #include <cmath>
 #include <list>
 #include <map>
+#include <optional>
 
 #include "forwarddeclarations.h"
 #include "modusdefault.h"
+#include "quantumsampling.h"
+#include "thermalsampling.h"
 
 namespace smash {
 
@@ -80,6 +83,13 @@ class SphereModus : public ModusDefault {
   /// \return radius
   double radius() const { return radius_; }
 
+  /**
+   * Use the given threads to sample the initial thermal momenta.
+   *
+   * \param[in] thread_pool Threads of the experiment, or nullptr
+   */
+  void set_thread_pool(ThreadPool *thread_pool) { thread_pool_ = thread_pool; }
+
  private:
   /// Sphere radius (in fm)
   double radius_;
@@ -146,6 +156,12 @@ class SphereModus : public ModusDefault {
    * Initial momentum of the jet particle; only used if jet_pdg_ is not nullopt
    */
   const double jet_mom_;
+  /// Tabulated thermal distributions of the particle species
+  ThermalSampling thermal_sampling_;
+  /// Quantum statistical distributions, set up in the first event using them
+  std::optional<QuantumSampling> quantum_sampling_;
+  /// Threads used for the thermal sampling, if any
+  ThreadPool *thread_pool_ = nullptr;
   /**\ingroup logging
    * Writes the initial state for the Sphere to the output stream.
    *
@@ -1,6 +1,6 @@
 /*
  *
- *    Copyright (c) 2017-2020,2022
+ *    Copyright (c) 2017-2020,2022,2024
  *      SMASH Team
  *
  *    GNU General Public License (GPLv3 or later)
@@ -10,9 +10,16 @@
 #ifndef SRC_INCLUDE_SMASH_STRINGPROCESS_H_
 #define SRC_INCLUDE_SMASH_STRINGPROCESS_H_
 
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <future>
 #include <map>
 #include <memory>
+#include <mutex>
 #include <string>
+#include <thread>
+#include <unordered_map>
 #include <utility>
 #include <vector>
 
@@ -21,6 +28,7 @@
 #include "constants.h"
 #include "logging.h"
 #include "particledata.h"
+#include "tabulation.h"
 
 namespace smash {
 static constexpr int LPythia = LogArea::Pythia::id;
@@ -28,7 +36,8 @@ static constexpr int LPythia = LogArea::Pythia::id;
 /**
  * \brief String excitation processes used in SMASH
  *
- * Only one instance of this class should be created.
+ * Only one instance of this class should be created per event, from which
+ * every thread obtains its own instance with for_this_thread().
  *
  * This class implements string excitation processes based on the UrQMD model
  * \iref{Bass:1998ca}, \iref{Bleicher:1999xi} and subsequent fragmentation
@@ -175,23 +184,103 @@ class StringProcess {
    */
   ParticleList final_state_;
 
+  /**
+   * Hadron species sharing the baryon number, isospin projection,
+   * strangeness, charmness and bottomness, which the leading hadrons and the
+   * resonances formed by string ends are chosen from.
+   */
+  struct HadronsWithCharges {
+    /// PDG ids of the species known to PYTHIA, in the order of the type list
+    std::vector<int> pdgids;
+    /**
+     * Cumulative sums of spin degeneracy over pole mass of these species,
+     * starting with 0
+     */
+    std::vector<double> weight_summed{0.};
+    /// Unstable species, in the order of the type list
+    ParticleTypePtrList resonances;
+  };
+
+  /**
+   * Hadron species by the key of their charges, see charges_key. It is filled
+   * at construction, such that the string ends are turned into hadrons
+   * without scanning all particle types.
+   */
+  std::unordered_map<int, HadronsWithCharges> hadrons_by_charges_;
+
   /**
    * Map containing PYTHIA objects for hard string routines.
    * Particle IDs are used as the keys to obtain the respective object.
    * This was introduced to reduce the amount of Pythia init() calls.
+   *
+   * The objects are initialized by the first thread which waits for them,
+   * which may be the background thread started by prewarm_hard_pythia.
    */
-  typedef std::map<std::pair<int, int>, std::unique_ptr<Pythia8::Pythia>>
+  typedef std::map<std::pair<int, int>,
+                   std::shared_future<std::unique_ptr<Pythia8::Pythia>>>
       pythia_map;
 
   /// Map object to contain the different pythia objects
   pythia_map hard_map_;
 
+  /// Guards #hard_map_, which may be filled by the prewarming thread
+  std::mutex hard_map_mutex_;
+
+  /// Thread initializing the hard PYTHIA objects in the background
+  std::thread prewarm_thread_;
+
+  /**
+   * Whether beams A of the same beam B share one hard PYTHIA object, which
+   * switches between them with Beams:allowIDAswitch.
+   */
+  bool share_hard_pythia_ = false;
+
+  /// Pairs of hadrons whose hard PYTHIA objects are prewarmed
+  std::vector<std::pair<PdgCode, PdgCode>> prewarm_beams_;
+
+  /// Center-of-mass energy at which hard PYTHIA objects are prewarmed [GeV]
+  double prewarm_sqrts_ = 0.;
+
+  /// Thread which created this object and uses it directly
+  std::thread::id owner_thread_ = std::this_thread::get_id();
+
+  /// Clones of this object used by the other threads
+  std::map<std::thread::id, std::unique_ptr<StringProcess>> thread_clones_;
+
+  /// Guards #thread_clones_
+  std::mutex thread_clones_mutex_;
+
+  /**
+   * Settings and particle data parsed once from the XML files of PYTHIA,
+   * with the common settings of SMASH applied, see shared_pythia_defaults.
+   */
+  struct PythiaDefaults;
+
+  /// Defaults from which all PYTHIA objects of this object are copied
+  std::shared_ptr<PythiaDefaults> pythia_defaults_;
+
   /// PYTHIA object used in fragmentation
   std::unique_ptr<Pythia8::Pythia> pythia_hadron_;
 
   /// An object to compute cross-sections
   Pythia8::SigmaTotal pythia_sigmatot_;
 
+  /// Diffractive cross sections of a pair of beams, tabulated in ln(sqrt_s)
+  struct DiffractiveTable {
+    /// Energy below which the cross sections at the threshold are used [GeV]
+    double sqrts_threshold;
+    /// Cross sections AB->AX, AB->XB and AB->XX [mb]
+    std::array<Tabulation, 3> xs;
+  };
+
+  /**
+   * Tables of the diffractive cross sections of all pairs of beams onto which
+   * hadrons are mapped, which are shared with the clones. Empty unless
+   * set_tabulate_diffractive was called.
+   */
+  std::shared_ptr<const std::map<std::pair<int, int>, DiffractiveTable>>
+      diffractive_tables_;
+
   /**
    * An object for the flavor selection in string fragmentation
    * in the case of separate fragmentation function for leading baryon
@@ -204,6 +293,99 @@ class StringProcess {
    */
   Pythia8::Event event_intermediate_;
 
+  /**
+   * Scratch lists of the hadrons and of the other particles fragmented out
+   * of a single string, which keep their capacity between string processes
+   * such that the fragmentation does not allocate once it is warmed up.
+   */
+  ParticleList fragments_, non_hadron_fragments_;
+
+  /**
+   * Scratch lists of the PDG ids of the hadrons fragmented out of a string
+   * end in a single step and in all steps before the PYTHIA fragmentation
+   * \see StringProcess::fragment_off_hadron
+   */
+  std::vector<int> pdgid_frag_, pdgid_frag_prior_;
+
+  /// Scratch lists of the four-momenta belonging to #pdgid_frag_ and
+  /// #pdgid_frag_prior_
+  std::vector<FourVector> momentum_frag_, momentum_frag_prior_;
+
+  /// Scratch lists of the open junction legs and of the junctions to be moved
+  /// \see StringProcess::compose_string_junction
+  std::vector<int> junction_legs_, junctions_to_move_;
+
+  /**
+   * Guards the Pythia objects, which must not be used by several threads at
+   * the same time.
+   */
+  std::mutex pythia_mutex_;
+
+  /**
+   * \param[in] pdg_a PDG code of beam A used by PYTHIA
+   * \param[in] pdg_b PDG code of beam B used by PYTHIA
+   * \return Energy below which the diffractive cross sections are constant,
+   *         following PYTHIA [GeV]
+   */
+  double diffractive_threshold(int pdg_a, int pdg_b) const;
+
+  /**
+   * Compute the diffractive cross sections with pythia_sigmatot_.
+   *
+   * \param[in] pdg_a PDG code of beam A used by PYTHIA
+   * \param[in] pdg_b PDG code of beam B used by PYTHIA
+   * \param[in] sqrt_s collision energy above the threshold [GeV]
+   * \return cross sections AB->AX, AB->XB and AB->XX [mb]
+   */
+  std::array<double, 3> compute_diffractive(int pdg_a, int pdg_b,
+                                            double sqrt_s);
+
+  /**
+   * \param[in] idAB Beams used by PYTHIA in a hard string process
+   * \return Key of the PYTHIA object for the beams in #hard_map_
+   */
+  std::pair<int, int> hard_pythia_key(std::pair<int, int> idAB) const;
+
+  /**
+   * Find the PYTHIA object for hard string processes with the given key, or
+   * add one which is initialized by the first thread waiting for it.
+   *
+   * \param[in] key Key of the object in #hard_map_
+   * \param[in] sqrts Center-of-mass energy at which a new object is
+   *            initialized [GeV]
+   * \return The future PYTHIA object
+   */
+  std::shared_future<std::unique_ptr<Pythia8::Pythia>> hard_pythia(
+      std::pair<int, int> key, double sqrts);
+
+  /**
+   * Find the PYTHIA defaults for the parameters of this object. Parsing the
+   * XML files of PYTHIA takes long and needs a lot of memory, so the
+   * defaults are shared by all objects with the same parameters which exist
+   * at the same time, in particular by the clones for the threads.
+   *
+   * \return The shared defaults
+   */
+  std::shared_ptr<PythiaDefaults> shared_pythia_defaults();
+
+  /**
+   * \return New PYTHIA object, which is not initialized yet, with the
+   *         settings and particle data of #pythia_defaults_
+   */
+  std::unique_ptr<Pythia8::Pythia> copy_pythia_defaults() const;
+
+  /**
+   * Set up and initialize a PYTHIA object for hard string processes.
+   *
+   * \param[in] key Key of the object in #hard_map_
+   * \param[in] sqrts Center-of-mass energy at which the object is
+   *            initialized [GeV]
+   * \return The PYTHIA object
+   * \throw std::runtime_error if PYTHIA fails to initialize
+   */
+  std::unique_ptr<Pythia8::Pythia> create_hard_pythia(std::pair<int, int> key,
+                                                      double sqrts);
+
  public:
   // clang-format off
 
@@ -265,6 +447,148 @@ class StringProcess {
                 bool separate_fragment_baryon, double popcorn_rate,
                 bool use_monash_tune);
 
+  /// Destructor, waits for the prewarming of the hard PYTHIA objects.
+  ~StringProcess();
+
+  /**
+   * Create a string process with the same parameters, but its own PYTHIA
+   * objects, which can be used concurrently with this one. The hard PYTHIA
+   * objects of the prewarmed beams are prewarmed for the clone as well.
+   *
+   * \return The clone
+   */
+  std::unique_ptr<StringProcess> clone() const;
+
+  /**
+   * Get the string process to be used by the calling thread, such that
+   * strings of different threads are fragmented concurrently. This is the
+   * object itself for the thread which created it and a clone for any other
+   * thread, which is created when the thread asks for it first and kept
+   * until this object is destroyed.
+   *
+   * The PYTHIA random number generators are seeded from the random stream
+   * of the calling thread for every string process, hence the results do not
+   * depend on which instance fragments a string.
+   *
+   * \return The string process of the calling thread
+   */
+  StringProcess &for_this_thread();
+
+  /// String subprocesses whose statistics are recorded
+  enum class Subprocess {
+    /// next_SDiff
+    SingleDiffractive,
+    /// next_DDiff
+    DoubleDiffractive,
+    /// next_NDiffSoft
+    NonDiffractiveSoft,
+    /// next_NDiffHard
+    NonDiffractiveHard,
+    /// next_BBbarAnn
+    Annihilation,
+    /// fragment_string, called by the soft subprocesses
+    Fragmentation,
+  };
+
+  /// Number of subprocesses in Subprocess
+  static constexpr std::size_t n_subprocesses = 6;
+
+  /// Statistics of a string subprocess, accumulated over the run
+  struct SubprocessStatistics {
+    /// Number of calls
+    std::uint64_t calls = 0;
+    /// Number of calls which failed and are retried by the caller
+    std::uint64_t failures = 0;
+    /// Number of attempts repeated within the calls
+    std::uint64_t retries = 0;
+    /// Wall time spent in all calls [s]
+    double time = 0.;
+    /// Wall time spent in the failed calls [s]
+    double failed_time = 0.;
+
+    /// Add the statistics of another instance.
+    void add(const SubprocessStatistics &other) {
+      calls += other.calls;
+      failures += other.failures;
+      retries += other.retries;
+      time += other.time;
+      failed_time += other.failed_time;
+    }
+  };
+
+  /**
+   * Call a subprocess and record its number of calls, whether it failed and
+   * the time it took.
+   *
+   * \param[in] subprocess Subprocess which is called
+   * \param[in] f Function calling the subprocess, which returns whether it
+   *            succeeded or the number of fragmented hadrons
+   * \return Result of the function
+   */
+  template <typename F>
+  auto timed(Subprocess subprocess, F &&f) {
+    const auto start = std::chrono::steady_clock::now();
+    const auto result = f();
+    const double time =
+        std::chrono::duration<double>(std::chrono::steady_clock::now() - start)
+            .count();
+    SubprocessStatistics &statistics =
+        statistics_[static_cast<std::size_t>(subprocess)];
+    statistics.calls++;
+    statistics.time += time;
+    if (!(result > 0)) {
+      statistics.failures++;
+      statistics.failed_time += time;
+    }
+    return result;
+  }
+
+  /**
+   * Get the statistics of all subprocesses of this object and its clones.
+   * The clones must not be used at the same time.
+   *
+   * \return Statistics, indexed by Subprocess
+   */
+  std::array<SubprocessStatistics, n_subprocesses> statistics();
+
+  /**
+   * \return Number of PYTHIA objects of this object and its clones, including
+   *         the hard ones which are not initialized yet
+   */
+  std::size_t n_pythia_instances();
+
+  /**
+   * \param[in] subprocess A subprocess
+   * \return Name of the subprocess as used in the summary of the run
+   */
+  static const char *subprocess_name(Subprocess subprocess);
+
+  /**
+   * Initialize the PYTHIA objects for hard string processes of the given
+   * beams in a background thread, instead of when they are needed first.
+   * Initializing a PYTHIA object takes seconds, hence this avoids stalls in
+   * the first events. A hard string process of a beam which is still being
+   * initialized waits for it.
+   *
+   * \param[in] beams Pairs of incoming hadrons, which are mapped onto the
+   *            beams used by PYTHIA like in hard string processes
+   * \param[in] sqrts Center-of-mass energy at which the objects are
+   *            initialized (Beams:eCM) [GeV]
+   */
+  void prewarm_hard_pythia(
+      const std::vector<std::pair<PdgCode, PdgCode>> &beams, double sqrts);
+
+  /**
+   * Share one PYTHIA object for hard string processes between all beams A
+   * colliding with the same nucleon, switching between them with
+   * Beams:allowIDAswitch, instead of initializing one per pair of beams.
+   * This bounds the time and memory spent on the objects. It has to be set
+   * before the first hard string process or prewarming.
+   *
+   * \param[in] share Whether to share the objects
+   */
+  void set_share_hard_pythia(bool share) { share_hard_pythia_ = share; }
+
   /**
    * Common setup of PYTHIA objects for soft and hard string routines
    * \param[out] pythia_in pointer to the PYTHIA object
@@ -317,26 +641,22 @@ class StringProcess {
    * double diffractive AB->XX.
    */
   std::array<double, 3> cross_sections_diffractive(int pdg_a, int pdg_b,
-                                                   double sqrt_s) {
-    // This threshold magic is following Pythia. Todo(ryu): take care of this.
-    double sqrts_threshold = 2. * (1. + 1.0e-6);
-    /* In the case of mesons, the corresponding vector meson masses
-     * are used to evaluate the energy threshold. */
-    const int pdg_a_mod =
-        (std::abs(pdg_a) > 1000) ? pdg_a : 10 * (std::abs(pdg_a) / 10) + 3;
-    const int pdg_b_mod =
-        (std::abs(pdg_b) > 1000) ? pdg_b : 10 * (std::abs(pdg_b) / 10) + 3;
-    sqrts_threshold += pythia_hadron_->particleData.m0(pdg_a_mod) +
-                       pythia_hadron_->particleData.m0(pdg_b_mod);
-    /* Constant cross-section for sub-processes below threshold equal to
-     * cross-section at the threshold. */
-    if (sqrt_s < sqrts_threshold) {
-      sqrt_s = sqrts_threshold;
-    }
-    pythia_sigmatot_.calc(pdg_a, pdg_b, sqrt_s);
-    return {pythia_sigmatot_.sigmaAX(), pythia_sigmatot_.sigmaXB(),
-            pythia_sigmatot_.sigmaXX()};
-  }
+                                                   double sqrt_s);
+
+  /**
+   * Interpolate the diffractive cross sections of the hadrons onto which
+   * PYTHIA maps all hadrons (p, n, their antiparticles, pi+ and pi-) from
+   * tables in the center-of-mass energy instead of computing them in every
+   * call of cross_sections_diffractive. The tables are built here and shared
+   * with the clones created afterwards. Energies above
+   * \ref diffractive_sqrts_max are still computed exactly.
+   *
+   * \param[in] tabulate Whether to use the tables
+   */
+  void set_tabulate_diffractive(bool tabulate);
+
+  /// Highest center-of-mass energy of the diffractive tables [GeV]
+  static constexpr double diffractive_sqrts_max = 1.e5;
 
   /**
    * \todo The following set_ functions are replaced with
@@ -393,7 +713,8 @@ class StringProcess {
   /**
    * initialization
    * feed intial particles, time of collision and gamma factor of the center of
-   * mass.
+   * mass. The random seed of the hadronization is set from the current random
+   * stream.
    * \param[in] incoming is the list of initial state particles.
    * \param[in] tcoll is time of collision.
    */
@@ -782,6 +1103,26 @@ class StringProcess {
    */
   ParticleList get_final_state() { return final_state_; }
 
+  /**
+   * a function to move the final state particle list out of this object,
+   * which is called after the collision instead of copying it
+   * \param[out] particles list which is replaced by the final state
+   *             particles. Its previous contents are discarded, and its
+   *             buffer is used for the next final state.
+   */
+  void take_final_state(ParticleList &particles) {
+    particles.swap(final_state_);
+    final_state_.clear();
+  }
+
+  /**
+   * a function to get the mutex guarding the Pythia objects, which has to be
+   * locked while a string process is generated and its final state is read,
+   * unless the object is only used by the calling thread
+   * \return reference to the mutex
+   */
+  std::mutex &pythia_mutex() { return pythia_mutex_; }
+
   /**
    * a function that clears the final state particle list
    * which is used for testing mainly
@@ -814,13 +1155,11 @@ class StringProcess {
    */
   static bool append_intermediate_list(int pdgid, FourVector momentum,
                                        ParticleList &intermediate_particles) {
-    const std::string s = std::to_string(pdgid);
-    PdgCode pythia_code(s);
+    PdgCode pythia_code = PdgCode::from_decimal(pdgid);
     ParticleTypePtr new_type = ParticleType::try_find(pythia_code);
     if (new_type) {
-      ParticleData new_particle(ParticleType::find(pythia_code));
-      new_particle.set_4momentum(momentum);
-      intermediate_particles.push_back(new_particle);
+      intermediate_particles.emplace_back(*new_type);
+      intermediate_particles.back().set_4momentum(momentum);
       return true;
     } else {
       // if the particle does not exist in SMASH the pythia event is rerun
@@ -987,6 +1326,30 @@ class StringProcess {
    */
   int get_resonance_from_quark(int idq1, int idq2, double mass);
 
+  /**
+   * \param[in] baryon_number Baryon number
+   * \param[in] iso3 Twice the isospin projection
+   * \param[in] strangeness Strangeness
+   * \param[in] charmness Charmness
+   * \param[in] bottomness Bottomness
+   * \return Key of the hadron species with these charges in
+   *         #hadrons_by_charges_
+   */
+  static int charges_key(int baryon_number, int iso3, int strangeness,
+                         int charmness, int bottomness);
+
+  /**
+   * \param[in] baryon_number Baryon number
+   * \param[in] idq1 PDG id of a valence quark constituent
+   * \param[in] idq2 PDG id of another valence quark constituent
+   * \return Key of the hadron species with the given baryon number and the
+   *         charges of the two constituents in #hadrons_by_charges_
+   */
+  int charges_key_from_quarks(int baryon_number, int idq1, int idq2) const;
+
+  /// Fill #hadrons_by_charges_ from the particle types.
+  void tabulate_hadrons_by_charges();
+
   /**
    * Determines lightcone momenta of two final hadrons fragmented from a string
    * in the same way as StringFragmentation::finalTwo in StringFragmentation.cc
@@ -1019,6 +1382,10 @@ class StringProcess {
    * \param[in] b parameter for the fragmentation function
    * \param[in] mTrn transverse mass of the fragmented hadron
    * \return sampled lightcone momentum fraction
+   *
+   * The logarithm of the fraction is drawn by inverting an envelope, which is
+   * tabulated once per thread for each a and quantized \f$ b m_T^2 \f$, and
+   * corrected to the exact function by rejection.
    */
   static double sample_zLund(double a, double b, double mTrn);
 
@@ -1243,6 +1610,10 @@ class StringProcess {
   double get_tcoll() { return time_collision_;}
 
   // clang-format on
+
+ private:
+  /// Statistics of the subprocesses, indexed by Subprocess
+  std::array<SubprocessStatistics, n_subprocesses> statistics_;
 };
 
 }  // namespace smash
@@ -0,0 +1,105 @@
+/*
+ *
+ *    Copyright (c) 2024
+ *      SMASH Team
+ *
+ *    GNU General Public License (GPLv3 or later)
+ *
+ */
+
+#ifndef SRC_INCLUDE_SMASH_SWEEPANDPRUNE_H_
+#define SRC_INCLUDE_SMASH_SWEEPANDPRUNE_H_
+
+#include <cstddef>
+#include <functional>
+#include <utility>
+#include <vector>
+
+#include "forwarddeclarations.h"
+#include "particlespan.h"
+
+namespace smash {
+
+/**
+ * \ingroup action
+ *
+ * Alternative to the Grid for the search of two-particle collisions with the
+ * geometric criteria, which sorts the particles along one axis (sweep and
+ * prune).
+ *
+ * The particles are sorted by their coordinate along the axis in which they
+ * are spread the most. Two particles can only collide within the time step,
+ * if their coordinates differ by at most the reach, which is the minimal
+ * cell length of the grid. Hence, only particles within the reach along the
+ * sorted axis are paired. Unlike the cells of the grid, this adapts to very
+ * anisotropic densities, like those of the Lorentz-contracted nuclei at the
+ * beginning of ultra-relativistic collisions, where few cells hold many
+ * particles.
+ *
+ * The sorted particles are searched in blocks of consecutive particles, such
+ * that the action finders see the same kind of calls as for the grid: every
+ * block as a search cell, and every block together with the following
+ * particles within reach of its last particle as neighbors. Every particle is
+ * in exactly one block and every pair within reach is passed once.
+ */
+class SweepAndPrune {
+ public:
+  /// Maximal number of consecutive particles searched together
+  static constexpr std::size_t block_size = 16;
+
+  /**
+   * Sorts the particles along the axis in which they are spread the most.
+   *
+   * \param[in] particles The particles to be searched. They are only referred
+   *            to, so they must outlive the search unchanged.
+   * \param[in] reach Distance along the axis, up to which particles are
+   *            paired [fm]
+   * \param[in] timestep_duration Duration of the timestep [fm]
+   * \param[in] include_unformed_particles Whether particles, which cannot
+   *            interact in the time step, are included, like for the grid
+   * \param[in] skip Optional predicate selecting particles, which are left
+   *            out, e.g. spectators which cannot interact
+   */
+  void update(const Particles &particles, double reach,
+              double timestep_duration, bool include_unformed_particles,
+              const std::function<bool(const ParticleData &)> &skip = {});
+
+  /**
+   * Iterates over the blocks of sorted particles, like Grid::iterate_cells.
+   *
+   * \param[in] search_cell_callback A callable called with every block.
+   * \param[in] neighbor_cell_callback A callable called with every block and
+   *            the following particles within reach, if there are any.
+   */
+  void iterate_cells(
+      const std::function<void(const ParticleSpan &)> &search_cell_callback,
+      const std::function<void(const ParticleSpan &, const ParticleSpan &)>
+          &neighbor_cell_callback) const;
+
+  /// \return Index of the sorted axis (0 for x, 1 for y, 2 for z)
+  int axis() const { return axis_; }
+
+  /// \return the memory allocated for the search [bytes]
+  std::size_t memory_usage() const {
+    return sorted_.capacity() * sizeof(const ParticleData *) +
+           coordinates_.capacity() * sizeof(double) +
+           sorting_.capacity() *
+               sizeof(std::pair<double, const ParticleData *>);
+  }
+
+ private:
+  /// Pointers to the particles, sorted along the axis
+  std::vector<const ParticleData *> sorted_;
+  /// Coordinates of the sorted particles along the axis [fm]
+  std::vector<double> coordinates_;
+  /// Buffer reused for sorting the particles
+  std::vector<std::pair<double, const ParticleData *>> sorting_;
+  /// Distance along the axis, up to which particles are paired [fm]
+  double reach_ = 0.;
+  /// Index of the sorted axis
+  int axis_ = 2;
+};
+
+}  // namespace smash
+
+#endif  // SRC_INCLUDE_SMASH_SWEEPANDPRUNE_H_
@@ -1,5 +1,5 @@
 /*
- *    Copyright (c) 2015-2020
+ *    Copyright (c) 2015-2020,2024
  *      SMASH Team
  *
  *    GNU General Public License (GPLv3 or later)
@@ -8,12 +8,17 @@
 #ifndef SRC_INCLUDE_SMASH_TABULATION_H_
 #define SRC_INCLUDE_SMASH_TABULATION_H_
 
+#include <atomic>
+#include <filesystem>
 #include <fstream>
 #include <functional>
 #include <map>
 #include <memory>
+#include <mutex>
+#include <string>
 #include <vector>
 
+#include "filelock.h"
 #include "forwarddeclarations.h"
 #include "integrate.h"
 #include "kinematics.h"
@@ -37,7 +42,7 @@ class Tabulation {
   /**
    * Construct an empty tabulation object.
    */
-  Tabulation() : values_({}), x_min_(0.0), x_max_(0.0), inv_dx_(0.0) {}
+  Tabulation() : x_min_(0.0), x_max_(0.0), inv_dx_(0.0) {}
 
   /**
    * Construct a new tabulation object.
@@ -53,10 +58,32 @@ class Tabulation {
   Tabulation(double x_min, double range, size_t num,
              std::function<double(double)> f);
 
+  /**
+   * Construct a tabulation object which refers to values stored elsewhere,
+   * e.g. in a memory-mapped file, without copying them.
+   *
+   * \param x_min lower bound of tabulation domain
+   * \param x_max upper bound of tabulation domain
+   * \param inv_dx inverse step size
+   * \param values tabulated values
+   * \param n_values number of tabulated values
+   * \param storage storage of the values, which is kept alive by the
+   *                tabulation and its copies
+   * \return Construct object.
+   */
+  Tabulation(double x_min, double x_max, double inv_dx, const double* values,
+             size_t n_values, std::shared_ptr<const void> storage)
+      : storage_(std::move(storage)),
+        values_(values),
+        n_values_(n_values),
+        x_min_(x_min),
+        x_max_(x_max),
+        inv_dx_(inv_dx) {}
+
   /**
    * \returns whether the tabulation is empty.
    */
-  bool is_empty() const { return values_.empty(); }
+  bool is_empty() const { return n_values_ == 0; }
 
   /**
    * Construct a tabulation object by reading binary data from a stream.
@@ -105,9 +132,31 @@ class Tabulation {
    */
   void write(std::ofstream& stream, sha256::Hash hash) const;
 
+  /**
+   * \return Memory allocated for the values of all tabulations [bytes], not
+   *          including values which are mapped from a file.
+   */
+  static std::size_t allocated_bytes() { return allocated_bytes_; }
+
  protected:
-  /// vector for storing tabulated values
-  std::vector<double> values_;
+  /**
+   * Store the given values in the tabulation.
+   *
+   * \param values Tabulated values
+   */
+  void set_values(std::vector<double>&& values);
+
+  /**
+   * Storage of the tabulated values, which is shared by all copies of the
+   * tabulation. It is either owned by the tabulations or a mapped file.
+   */
+  std::shared_ptr<const void> storage_;
+
+  /// tabulated values, which live in storage_
+  const double* values_ = nullptr;
+
+  /// number of tabulated values
+  size_t n_values_ = 0;
 
   /// lower bound for tabulation
   double x_min_;
@@ -117,6 +166,199 @@ class Tabulation {
 
   /// inverse step size 1/dx
   double inv_dx_;
+
+  /// Memory allocated for the values of all tabulations [bytes]
+  static std::atomic<std::size_t> allocated_bytes_;
+
+  friend class TabulationArchive;
+  friend class AdaptiveTabulation;
+};
+
+/**
+ * A one-dimensional lookup table on a non-uniform grid, which is refined
+ * until a monotone cubic Hermite interpolation reaches a given accuracy.
+ *
+ * Compared to Tabulation, the knots are dense where the function varies
+ * quickly, e.g. close to thresholds and resonance poles, and sparse
+ * elsewhere, such that far fewer function evaluations are needed for the
+ * same accuracy. The slopes at the knots are chosen following Fritsch and
+ * Carlson, such that the interpolation is monotone wherever the tabulated
+ * values are. The knots are found with a uniform grid of buckets, which
+ * holds the first knot of each bucket.
+ *
+ * The knots, values, slopes and buckets are stored as the values of a
+ * Tabulation, such that adaptive tabulations are cached in the same way.
+ */
+class AdaptiveTabulation {
+ public:
+  /// Construct an empty tabulation object.
+  AdaptiveTabulation() = default;
+
+  /**
+   * Construct a new tabulation object.
+   *
+   * Starting from a uniform grid, each interval is split in half as long as
+   * the interpolation deviates from the function at its center by more than
+   * the tolerance, relative to the value of the function there, but at least
+   * to 1% of the largest tabulated value.
+   *
+   * \param x_min lower bound of tabulation domain
+   * \param x_max upper bound of tabulation domain
+   * \param f one-dimensional function f(x) which is supposed to be tabulated
+   * \param tolerance relative tolerance of the interpolation
+   * \param n_initial number of intervals of the initial uniform grid
+   * \param max_knots maximal number of knots
+   * \throws std::runtime_error if the domain is empty or there are less than
+   *         two intervals initially
+   */
+  AdaptiveTabulation(double x_min, double x_max,
+                     const std::function<double(double)>& f, double tolerance,
+                     size_t n_initial = 10, size_t max_knots = 1000);
+
+  /// \returns whether the tabulation is empty.
+  bool is_empty() const { return n_knots_ == 0; }
+
+  /// \returns the number of knots.
+  size_t n_knots() const { return n_knots_; }
+
+  /**
+   * Look up a value from the tabulation using monotone cubic interpolation.
+   * As for Tabulation::get_value_linear, 0 is returned below the lower bound
+   * and values above the upper bound are extrapolated linearly by default.
+   *
+   * \param x Argument to tabulated function.
+   * \param extrapolation Extrapolation that should be used for values
+   * outside the tabulation.
+   * \return Interpolated value.
+   */
+  double get_value(double x,
+                   Extrapolation extrapolation = Extrapolation::Linear) const;
+
+ private:
+  /**
+   * Construct a tabulation object from its packed representation.
+   *
+   * \param packed Tabulation holding the knots, values, slopes and buckets
+   * \throws std::runtime_error if the representation is invalid
+   */
+  explicit AdaptiveTabulation(Tabulation packed);
+
+  /// Set the views of the packed representation.
+  void unpack();
+
+  /// Packed representation, which owns the data
+  Tabulation packed_;
+
+  /// number of knots
+  size_t n_knots_ = 0;
+
+  /// number of buckets
+  size_t n_buckets_ = 0;
+
+  /// knots, which live in packed_
+  const double* x_ = nullptr;
+
+  /// tabulated values at the knots
+  const double* y_ = nullptr;
+
+  /// slopes at the knots
+  const double* slopes_ = nullptr;
+
+  /// index of the interval of the lower bound of each bucket
+  const double* buckets_ = nullptr;
+
+  friend class TabulationCache;
+};
+
+/**
+ * Cache of tabulations on disk.
+ *
+ * All tabulations which depend on the particle properties are obtained
+ * through TabulationCache::get. While a TabulationCache object exists, they
+ * are read from the archive in its directory if they were cached there with
+ * the same hash, and computed otherwise. When the object is destroyed, newly
+ * computed tabulations are added to the archive.
+ *
+ * The archive is a single memory-mapped file (see TabulationArchive), which
+ * is replaced atomically and can therefore always be read. Writing it
+ * requires a lock on the directory, such that concurrent processes do not
+ * overwrite each other's results. If the lock is held by another process,
+ * newly computed tabulations are not stored. Only one object may exist at a
+ * time, and it must not be created or destroyed while other threads call
+ * get. Different tabulations may be obtained concurrently.
+ */
+class TabulationCache {
+ public:
+  /**
+   * Start caching tabulations.
+   *
+   * \param[in] dir Directory of the cached tabulations. If it is empty,
+   *                nothing is cached.
+   * \param[in] hash Hash of the SMASH version and particle properties, which
+   *                 identifies valid cached tabulations
+   * \throws std::logic_error if another TabulationCache exists
+   */
+  TabulationCache(const std::filesystem::path& dir, sha256::Hash hash);
+  /// Store the newly computed tabulations and release the lock.
+  ~TabulationCache();
+  /// Cannot be copied
+  TabulationCache(const TabulationCache&) = delete;
+  /// Cannot be copied
+  TabulationCache& operator=(const TabulationCache&) = delete;
+
+  /**
+   * Get a set of tabulations from the cache, or compute them.
+   *
+   * \param[in] name Name of the tabulations, which has to be unique
+   * \param[in] parameters Description of any parameters that are not part of
+   *                       the particle properties, e.g. the grid. Cached
+   *                       tabulations are only valid for the same parameters.
+   * \param[in] compute Function computing the tabulations
+   * \return The tabulations
+   */
+  static std::vector<Tabulation> get(
+      const std::string& name, const std::string& parameters,
+      const std::function<std::vector<Tabulation>()>& compute);
+
+  /**
+   * Get a single tabulation from the cache, or compute it.
+   *
+   * \param[in] name Name of the tabulation, which has to be unique
+   * \param[in] compute Function computing the tabulation
+   * \return The tabulation
+   */
+  static Tabulation get(const std::string& name,
+                        const std::function<Tabulation()>& compute);
+
+  /**
+   * Get an adaptive tabulation from the cache, or compute it.
+   *
+   * \param[in] name Name of the tabulation, which has to be unique
+   * \param[in] compute Function computing the tabulation
+   * \return The tabulation
+   */
+  static AdaptiveTabulation get(
+      const std::string& name,
+      const std::function<AdaptiveTabulation()>& compute);
+
+ private:
+  /// Directory of the cached tabulations, empty if nothing is cached
+  std::filesystem::path dir_;
+  /// Hash identifying valid cached tabulations
+  sha256::Hash hash_;
+  /// Lock on the directory
+  FileLock lock_;
+  /// Whether the lock was acquired, such that the archive may be written
+  bool store_ = false;
+  /// Archive of the cached tabulations
+  std::unique_ptr<TabulationArchive> archive_;
+  /// Newly computed tabulations and their hashes by name
+  std::map<std::string, std::pair<sha256::Hash, std::vector<Tabulation>>>
+      computed_;
+  /// Guards computed_
+  std::mutex computed_mutex_;
+  /// The currently existing cache, if any
+  static TabulationCache* active_;
 };
 
 /**
@@ -176,6 +418,12 @@ inline double spec_func_integrand_2res(double sqrts, double res_mass_1,
          pCM(sqrts, res_mass_1, res_mass_2);
 }
 
+/**
+ * Relative tolerance of the tabulated spectral integrals, which is above the
+ * accuracy of the numerical integration.
+ */
+constexpr double integral_tolerance = 1e-3;
+
 /**
  * Create a table for the spectral integral of a resonance and a stable
  * particle.
@@ -183,20 +431,22 @@ inline double spec_func_integrand_2res(double sqrts, double res_mass_1,
  * \param[inout] integrate Numerical integrator.
  * \param[in] resonance Type of the resonance particle.
  * \param[in] stable Type of the stable particle.
- * \param[in] range Distance between tabulation points [GeV].
+ * \param[in] range Range of the tabulation above the threshold [GeV].
  * \return Tabulation of the given integral.
  */
-inline Tabulation spectral_integral_semistable(Integrator& integrate,
-                                               const ParticleType& resonance,
-                                               const ParticleType& stable,
-                                               double range) {
+inline AdaptiveTabulation spectral_integral_semistable(
+    Integrator& integrate, const ParticleType& resonance,
+    const ParticleType& stable, double range) {
   const double m_min = resonance.min_mass_kinematic();
   const double m_stable = stable.mass();
-  return Tabulation(m_min + m_stable, range, 100, [&](double srts) {
-    return integrate(m_min, srts - m_stable, [&](double m) {
-      return spec_func_integrand_1res(m, srts, m_stable, resonance);
-    });
-  });
+  return AdaptiveTabulation(
+      m_min + m_stable, m_min + m_stable + range,
+      [&](double srts) {
+        return integrate(m_min, srts - m_stable, [&](double m) {
+          return spec_func_integrand_1res(m, srts, m_stable, resonance);
+        });
+      },
+      integral_tolerance);
 }
 
 /**
@@ -205,23 +455,25 @@ inline Tabulation spectral_integral_semistable(Integrator& integrate,
  * \param[inout] integrate2d Numerical integrator.
  * \param[in] res1 Type of the first resonance particle.
  * \param[in] res2 Type of the second resonance particle.
- * \param[in] range Distance between tabulation points [GeV].
+ * \param[in] range Range of the tabulation above the threshold [GeV].
  * \return Tabulation of the given integral.
  */
-inline Tabulation spectral_integral_unstable(Integrator2d& integrate2d,
-                                             const ParticleType& res1,
-                                             const ParticleType& res2,
-                                             double range) {
+inline AdaptiveTabulation spectral_integral_unstable(
+    Integrator2d& integrate2d, const ParticleType& res1,
+    const ParticleType& res2, double range) {
   const double m1_min = res1.min_mass_kinematic();
   const double m2_min = res2.min_mass_kinematic();
-  return Tabulation(m1_min + m2_min, range, 125, [&](double srts) {
-    const double m1_max = srts - m2_min;
-    const double m2_max = srts - m1_min;
-    return integrate2d(
-        m1_min, m1_max, m2_min, m2_max, [&](double m1, double m2) {
-          return spec_func_integrand_2res(srts, m1, m2, res1, res2);
-        });
-  });
+  return AdaptiveTabulation(
+      m1_min + m2_min, m1_min + m2_min + range,
+      [&](double srts) {
+        const double m1_max = srts - m2_min;
+        const double m2_max = srts - m1_min;
+        return integrate2d(
+            m1_min, m1_max, m2_min, m2_max, [&](double m1, double m2) {
+              return spec_func_integrand_2res(srts, m1, m2, res1, res2);
+            });
+      },
+      integral_tolerance);
 }
 
 }  // namespace smash
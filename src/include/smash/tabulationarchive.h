@@ -0,0 +1,135 @@
+/*
+ *
+ *    Copyright (c) 2024
+ *      SMASH Team
+ *
+ *    GNU General Public License (GPLv3 or later)
+ *
+ */
+
+#ifndef SRC_INCLUDE_SMASH_TABULATIONARCHIVE_H_
+#define SRC_INCLUDE_SMASH_TABULATIONARCHIVE_H_
+
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "sha256.h"
+#include "tabulation.h"
+
+namespace smash {
+
+/**
+ * \ingroup data
+ *
+ * A single file holding many sets of tabulations, which is memory-mapped
+ * and read without copying the tabulated values.
+ *
+ * The file starts with a header, which identifies the format and its
+ * version, followed by an index of all entries. Each entry is a named set
+ * of tabulations together with the hash for which they were computed. The
+ * index is followed by the data of all tabulations, aligned to 8 bytes.
+ *
+ * An archive file is never modified. To add entries, a new file is written
+ * next to it and then renamed to replace it, which is atomic on POSIX file
+ * systems. Processes which still map the old file keep reading the old
+ * data, such that concurrent jobs can share the archive. Writers have to be
+ * serialized by the caller, e.g. with a FileLock.
+ */
+class TabulationArchive {
+ public:
+  /// A named set of tabulations
+  struct Entry {
+    /// Name of the set
+    std::string name;
+    /// Hash for which the set was computed
+    sha256::Hash hash;
+    /// The tabulations
+    std::vector<Tabulation> tabulations;
+  };
+
+  /// Construct an empty archive.
+  TabulationArchive() = default;
+
+  /**
+   * Map an archive file.
+   *
+   * \param[in] path Path of the file
+   * \return The archive, which is empty if the file does not exist or is not
+   *         a valid archive of the current version
+   */
+  static TabulationArchive open(const std::filesystem::path &path);
+
+  /**
+   * Write an archive file, replacing an existing one atomically.
+   *
+   * \param[in] path Path of the file
+   * \param[in] entries Entries of the archive
+   * \throws std::runtime_error if the file cannot be written
+   */
+  static void write(const std::filesystem::path &path,
+                    const std::vector<Entry> &entries);
+
+  /**
+   * Look up a set of tabulations.
+   *
+   * \param[in] name Name of the set
+   * \param[in] hash Hash for which the set was computed
+   * \return The tabulations, referring to the mapped file, or an empty list
+   *         if there is no such entry
+   */
+  std::vector<Tabulation> find(const std::string &name,
+                               sha256::Hash hash) const;
+
+  /// \return All entries of the archive, referring to the mapped file
+  std::vector<Entry> entries() const;
+
+  /// \return Number of entries
+  std::size_t size() const { return index_.size(); }
+
+  /// Identifies the format at the beginning of the file
+  static constexpr char magic[8] = {'S', 'M', 'A', 'S', 'H', 'T', 'A', 'B'};
+
+  /// Version of the format, which is increased whenever it changes
+  static constexpr std::uint64_t version = 1;
+
+ private:
+  /// Location of an entry in the mapped file
+  struct Location {
+    /// Name of the set
+    std::string name;
+    /// Hash for which the set was computed
+    sha256::Hash hash;
+    /// Offset of the first tabulation in the file [bytes]
+    std::uint64_t offset;
+    /// Number of tabulations
+    std::uint64_t n_tabulations;
+  };
+
+  /**
+   * Read the tabulations of an entry from the mapped file.
+   *
+   * \param[in] location Location of the entry
+   * \return The tabulations, or an empty list if the data is invalid
+   */
+  std::vector<Tabulation> read(const Location &location) const;
+
+  /// Mapped file, which is shared with the tabulations referring to it
+  std::shared_ptr<const void> mapping_;
+
+  /// Start of the mapped file
+  const char *data_ = nullptr;
+
+  /// Size of the mapped file [bytes]
+  std::size_t size_ = 0;
+
+  /// Entries, the key being the name followed by the hash
+  std::unordered_map<std::string, Location> index_;
+};
+
+}  // namespace smash
+
+#endif  // SRC_INCLUDE_SMASH_TABULATIONARCHIVE_H_
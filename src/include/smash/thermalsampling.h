@@ -0,0 +1,104 @@
+/*
+ *
+ *    Copyright (c) 2024
+ *      SMASH Team
+ *
+ *    GNU General Public License (GPLv3 or later)
+ *
+ */
+
+#ifndef SRC_INCLUDE_SMASH_THERMALSAMPLING_H_
+#define SRC_INCLUDE_SMASH_THERMALSAMPLING_H_
+
+#include <map>
+
+#include "forwarddeclarations.h"
+#include "random.h"
+
+namespace smash {
+
+/**
+ * \ingroup data
+ *
+ * Samples the masses and momenta of particles in thermal equilibrium at a
+ * fixed temperature according to the Boltzmann distribution, like
+ * HadronGasEos::sample_mass_thermal and sample_momenta_from_thermal.
+ *
+ * Instead of a rejection loop for every particle, the distributions are
+ * tabulated once per particle species and sampled by inverting the
+ * cumulative distribution:
+ * - The mass distribution \f$ A(m) m^2 K_2(m/T) \f$ of a resonance is
+ *   tabulated in the variable \f$ u = \arctan(2(m - m_0)/\Gamma_0) \f$, such
+ *   that the bins are finest at the pole even for narrow resonances.
+ * - The momentum distribution \f$ p^2 \exp(-E/T) \f$ is tabulated for the
+ *   pole mass, up to a kinetic energy of \f$ 40 T \f$. Momenta for other
+ *   masses, i.e. of resonances with sampled masses, are sampled with
+ *   sample_momenta_from_thermal.
+ *
+ * The particles of each species are sampled with an independent random
+ * stream, whose seed is drawn from the current random engine. Therefore the
+ * species can be sampled concurrently with the same result.
+ */
+class ThermalSampling {
+ public:
+  /**
+   * Prepare the sampling, the tables are set up when the species are
+   * sampled for the first time.
+   *
+   * \param[in] temperature Temperature [GeV]
+   * \param[in] account_for_resonance_widths Whether the masses of resonances
+   *            are sampled instead of taking the pole mass
+   */
+  ThermalSampling(double temperature, bool account_for_resonance_widths);
+
+  /**
+   * Set the masses and momenta of all given particles, with isotropic
+   * directions.
+   *
+   * \param[inout] particles Particles to be sampled
+   * \param[in] thread_pool If given, the species are sampled concurrently
+   */
+  void sample(Particles *particles, ThreadPool *thread_pool = nullptr);
+
+ private:
+  /// Tabulated distributions of one particle species
+  struct Species {
+    /**
+     * Distribution of \f$ u = \arctan(2(m - m_0)/\Gamma_0) \f$, empty if the
+     * pole mass is taken
+     */
+    random::piecewise_constant_dist mass;
+    /// Distribution of the momentum for the pole mass [GeV]
+    random::piecewise_constant_dist momentum;
+  };
+
+  /**
+   * Tabulate the distributions of a particle species.
+   *
+   * \param[in] type Particle species
+   * \return Tabulated distributions
+   */
+  Species tabulate(const ParticleType &type) const;
+
+  /**
+   * Sample the mass of a particle.
+   *
+   * \param[in] type Particle species
+   * \param[in] species Tabulated distributions of the species
+   * \return Mass [GeV]
+   */
+  static double sample_mass(const ParticleType &type, const Species &species);
+
+  /// Temperature [GeV]
+  const double temperature_;
+
+  /// Whether the masses of resonances are sampled
+  const bool account_for_resonance_widths_;
+
+  /// Tabulated distributions of all species sampled so far
+  std::map<const ParticleType *, Species> species_;
+};
+
+}  // namespace smash
+
+#endif  // SRC_INCLUDE_SMASH_THERMALSAMPLING_H_
@@ -1,6 +1,6 @@
 /*
  *
- *    Copyright (c) 2014-2022
+ *    Copyright (c) 2014-2022,2024
  *      SMASH Team
  *
  *    GNU General Public License (GPLv3 or later)
@@ -10,7 +10,9 @@
 #ifndef SRC_INCLUDE_SMASH_THERMODYNAMICLATTICEOUTPUT_H_
 #define SRC_INCLUDE_SMASH_THERMODYNAMICLATTICEOUTPUT_H_
 
+#include <cstdint>
 #include <filesystem>
+#include <fstream>
 #include <map>
 #include <memory>
 #include <set>
@@ -24,6 +26,7 @@
 #include "logging.h"
 #include "outputinterface.h"
 #include "outputparameters.h"
+#include "threadpool.h"
 #include "threevector.h"
 
 namespace smash {
@@ -44,6 +47,9 @@ class ThermodynamicLatticeOutput : public OutputInterface {
   /// Version of the thermodynamic lattice output
   static const double_t version;
 
+  /// Version of the chunked thermodynamic lattice output
+  static const std::uint16_t chunked_version;
+
   /**
    * Construct Output
    * \param[in] path Path to output
@@ -51,11 +57,17 @@ class ThermodynamicLatticeOutput : public OutputInterface {
    * \param[in] out_par Parameters of output
    * \param[in] enable_ascii Bool (True or False) to enable ASCII format
    * \param[in] enable_binary Bool (True or False) to enable binary format
+   * \param[in] enable_chunked Bool (True or False) to enable the chunked
+   *            binary format
+   * \param[in] enable_averaged Bool (True or False) to enable the average
+   *            over all events, written at the end of the run
    */
   ThermodynamicLatticeOutput(const std::filesystem::path &path,
                              const std::string &name,
                              const OutputParameters &out_par,
-                             const bool enable_ascii, const bool enable_binary);
+                             const bool enable_ascii, const bool enable_binary,
+                             const bool enable_chunked = false,
+                             const bool enable_averaged = false);
   /// Default destructor
   ~ThermodynamicLatticeOutput();
   /**
@@ -90,6 +102,14 @@ class ThermodynamicLatticeOutput : public OutputInterface {
    */
   void at_eventend(const ThermodynamicQuantity tq) override;
 
+  /**
+   * Writes the averages over all events, and their variances if requested,
+   * of the averaged format.
+   *
+   * \throw std::runtime_error if a file cannot be opened.
+   */
+  void at_runend() override;
+
   /**
    * Prints the density lattice on a grid.   *
    * \param[in] lattice DensityOnLattice lattice to use.
@@ -138,7 +158,8 @@ class ThermodynamicLatticeOutput : public OutputInterface {
    *
    * \param[in] description The description.
    * \param[in] event_number The event number.
-   * \param[in] type Flag for the file type: 'a' for ASCII, 'b' for Binary
+   * \param[in] type Flag for the file type: 'a' for ASCII, 'b' for Binary,
+   *            'c' for chunked binary
    */
   std::string make_filename(const std::string &description,
                             const int event_number, const char type);
@@ -172,6 +193,91 @@ class ThermodynamicLatticeOutput : public OutputInterface {
   void write_therm_lattice_binary_header(std::shared_ptr<std::ofstream> file,
                                          const ThermodynamicQuantity &tq);
 
+  /**
+   * Writes the header for the chunked binary output files
+   *
+   * \param[in] file Output file.
+   * \param[in] tq The quantity to be written,
+   *           see ThermodynamicQuantity.
+   */
+  void write_therm_lattice_chunked_header(std::ofstream &file,
+                                          const ThermodynamicQuantity &tq);
+
+  /**
+   * Opens the output files of a quantity at the start of an event and writes
+   * their headers.
+   *
+   * \param[in] event_number The event number.
+   * \param[in] tq The quantity to be written, see ThermodynamicQuantity.
+   * \param[in] dens_type The density type.
+   * \throw std::runtime_error if a file cannot be opened.
+   */
+  void open_files(const int event_number, const ThermodynamicQuantity tq,
+                  const DensityType dens_type);
+
+  /**
+   * Computes the values of a quantity at all nodes of the lattice, using the
+   * threads of the output if there are any.
+   *
+   * \tparam F Type of the function computing the values at a node
+   * \param[in] n_components Number of values at every node
+   * \param[in] compute Function taking the node index and a pointer to the
+   *            n_components values of the node, which it fills
+   * \return The values of all nodes, the components of a node are adjacent.
+   */
+  template <typename F>
+  std::vector<double> lattice_values(int n_components, F &&compute);
+
+  /**
+   * Writes the values of a quantity at one output time to all formats.
+   *
+   * \param[in] tq The quantity to be written, see ThermodynamicQuantity.
+   * \param[in] ctime The output time in the computational frame
+   * \param[in] values The values of all nodes as given by lattice_values
+   */
+  void write_values(const ThermodynamicQuantity tq, double ctime,
+                    const std::vector<double> &values);
+
+  /**
+   * Writes a time slice to the chunked binary file of a quantity. Only the
+   * bounding box of the nodes, whose values changed since the previous slice,
+   * is stored.
+   *
+   * \param[in] tq The quantity to be written, see ThermodynamicQuantity.
+   * \param[in] ctime The output time in the computational frame
+   * \param[in] values The values of all nodes as given by lattice_values
+   */
+  void write_chunk(const ThermodynamicQuantity tq, double ctime,
+                   const std::vector<double> &values);
+
+  /**
+   * Writes the values of a quantity at one output time in the ASCII format.
+   *
+   * \param[in] file Output file.
+   * \param[in] tq The quantity to be written, see ThermodynamicQuantity.
+   * \param[in] ctime The output time in the computational frame
+   * \param[in] values The values of all nodes as given by lattice_values
+   */
+  void write_ascii_values(std::ofstream &file, const ThermodynamicQuantity tq,
+                          double ctime, const std::vector<double> &values);
+
+  /**
+   * Adds the values of a quantity at one output time to the sums over the
+   * events of the averaged format.
+   *
+   * \param[in] tq The quantity, see ThermodynamicQuantity.
+   * \param[in] ctime The output time in the computational frame
+   * \param[in] values The values of all nodes as given by lattice_values
+   */
+  void accumulate(const ThermodynamicQuantity tq, double ctime,
+                  const std::vector<double> &values);
+
+  /**
+   * \param[in] tq A thermodynamic quantity, see ThermodynamicQuantity.
+   * \return Number of values of the quantity at every node.
+   */
+  static int n_components(const ThermodynamicQuantity tq);
+
   /**
    * Convert a ThermodynamicQuantity into an int
    * \param[in] tq The quantity to be converted, see ThermodynamicQuantity.
@@ -190,6 +296,42 @@ class ThermodynamicLatticeOutput : public OutputInterface {
   std::map<ThermodynamicQuantity, std::shared_ptr<std::ofstream>>
       output_binary_files_;
 
+  /// Output file and state of the chunked binary format for one quantity
+  struct ChunkedFile {
+    /// Output file handler
+    std::ofstream file;
+    /**
+     * Values of the previous time slice as stored, zero before the first
+     * slice of an event
+     */
+    std::vector<double> previous;
+  };
+
+  /// map of output files of the chunked binary format
+  std::map<ThermodynamicQuantity, ChunkedFile> output_chunked_files_;
+
+  /// Sums over the events of one quantity for the averaged format
+  struct AveragedQuantity {
+    /// Variable name of the quantity, which the file names start with
+    std::string varname;
+    /// Output times of the time slices
+    std::vector<double> times;
+    /// Number of events, which contributed to every time slice
+    std::vector<int> n_events;
+    /// Sums of the values of every time slice over the events
+    std::vector<std::vector<double>> sums;
+    /// Sums of the squared values of every time slice over the events
+    std::vector<std::vector<double>> sums_sqr;
+    /// Index of the next time slice of the current event
+    std::size_t next_slice = 0;
+  };
+
+  /// map of the sums over the events of the averaged format
+  std::map<ThermodynamicQuantity, AveragedQuantity> averaged_quantities_;
+
+  /// Threads computing the values at the nodes, null for a single thread
+  ThreadPool *const pool_;
+
   /// number of nodes in the lattice along the three axes
   std::array<int, 3> nodes_;
 
@@ -207,6 +349,15 @@ class ThermodynamicLatticeOutput : public OutputInterface {
   /// enable output type Binary
   bool enable_binary_;
 
+  /// enable output type chunked binary
+  bool enable_chunked_;
+
+  /// enable output type averaged over the events
+  bool enable_averaged_;
+
+  /// compress the time slices of the chunked binary format
+  bool compress_chunks_;
+
   /// enable output, of any kind (if False, the object does nothing)
   bool enable_output_;
 };
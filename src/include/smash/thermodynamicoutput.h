@@ -1,6 +1,6 @@
 /*
  *
- *    Copyright (c) 2014-2020,2022
+ *    Copyright (c) 2014-2020,2022,2024
  *      SMASH Team
  *
  *    GNU General Public License (GPLv3 or later)
@@ -92,11 +92,17 @@ class ThermodynamicOutput : public OutputInterface {
    * \param[in] line_end ending point of the line
    * \param[in] n_points number of points along the line, where density
    *            is printed out
+   * \param[in] pool Threads, which the points are distributed to, or nullptr
+   *
+   * The particles are sorted into cells of the size of the cut-off radius of
+   * the smearing once, such that only the particles close to a point are
+   * summed over.
    */
   void density_along_line(const char *file_name, const ParticleList &plist,
                           const DensityParameters &param, DensityType dens_type,
                           const ThreeVector &line_start,
-                          const ThreeVector &line_end, int n_points);
+                          const ThreeVector &line_end, int n_points,
+                          ThreadPool *pool = nullptr);
 
  private:
   /// Pointer to output file
@@ -0,0 +1,149 @@
+/*
+ *
+ *    Copyright (c) 2024
+ *      SMASH Team
+ *
+ *    GNU General Public License (GPLv3 or later)
+ *
+ */
+
+#ifndef SRC_INCLUDE_SMASH_THREADPOOL_H_
+#define SRC_INCLUDE_SMASH_THREADPOOL_H_
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace smash {
+
+/**
+ * \ingroup data
+ *
+ * A fixed-size pool of worker threads to process independent tasks.
+ *
+ * The pool is created once and then reused, such that no threads have to be
+ * spawned in the time evolution. The only supported operation is a blocking
+ * parallel_for over a range of task indices, which is all SMASH needs to
+ * process e.g. the different ensembles of one timestep concurrently.
+ *
+ * The calling thread takes part in the processing, a pool of size \f$n\f$
+ * therefore only owns \f$n-1\f$ worker threads. One pool is shared by all
+ * parallel stages of an experiment and its outputs: a parallel_for called
+ * while the pool is busy, from within a task or from another thread such as
+ * the writer thread of an output, runs its tasks in the calling thread. A
+ * pool of size 1 runs all tasks sequentially in the calling thread, in
+ * increasing order of the index.
+ *
+ * The threads of a pinned pool are bound to one CPU each and process the
+ * tasks round-robin, task \f$i\f$ always by thread \f$i \bmod n\f$. Memory
+ * first touched by a task, e.g. the particles of an ensemble, hence stays
+ * on the NUMA node of the thread processing this task in every batch. The
+ * calling thread is only bound to its CPU while it processes the tasks of
+ * parallel_for, afterwards it may run on the same CPUs as before again.
+ */
+class ThreadPool {
+ public:
+  /**
+   * Create a pool of threads.
+   *
+   * \param[in] n_threads Total number of threads processing tasks, including
+   *                      the calling thread.
+   * \param[in] pinned Whether thread \f$i\f$ is bound to CPU \f$i\f$, which
+   *                   is only supported on Linux and ignored elsewhere.
+   * \throw std::invalid_argument if the number of threads is not positive.
+   */
+  explicit ThreadPool(int n_threads, bool pinned = false);
+
+  /// Stop and join all worker threads.
+  ~ThreadPool();
+
+  /// Cannot be copied
+  ThreadPool(const ThreadPool &) = delete;
+  /// Cannot be copied
+  ThreadPool &operator=(const ThreadPool &) = delete;
+
+  /// \return Number of threads taking part in parallel_for.
+  int size() const { return static_cast<int>(workers_.size()) + 1; }
+
+  /// \return Whether the threads are bound to CPUs and process tasks
+  /// round-robin.
+  bool pinned() const { return pinned_; }
+
+  /**
+   * Call a function for all indices in [0, n_tasks) and wait until all of
+   * them have been processed.
+   *
+   * Every index is processed exactly once, but the order and, unless the pool
+   * is pinned, the thread processing it are unspecified. If tasks throw, the
+   * remaining tasks are still processed and the first exception is rethrown
+   * in the calling thread.
+   *
+   * \param[in] n_tasks Number of tasks to be processed
+   * \param[in] task Function taking the task index as argument
+   */
+  void parallel_for(int n_tasks, const std::function<void(int)> &task);
+
+ private:
+  /**
+   * Main loop of the worker threads.
+   *
+   * \param[in] thread Number of the worker thread, starting at 1
+   */
+  void work(int thread);
+
+  /**
+   * Process tasks of the current batch until none are left.
+   *
+   * \param[in] thread Number of the calling thread, 0 for the thread calling
+   *                   parallel_for
+   */
+  void process_tasks(int thread);
+
+  /// Whether the threads are bound to CPUs and process tasks round-robin
+  const bool pinned_;
+
+  /// Whether a batch is being processed by the threads of the pool
+  std::atomic<bool> running_{false};
+
+  /// The worker threads
+  std::vector<std::thread> workers_;
+
+  /// Guards all members below but next_task_.
+  std::mutex mutex_;
+
+  /// Wakes the workers up for a new batch or for stopping.
+  std::condition_variable batch_started_;
+
+  /// Signals that all workers are done with the current batch.
+  std::condition_variable batch_finished_;
+
+  /// Function to be called for the current batch
+  const std::function<void(int)> *task_ = nullptr;
+
+  /// Number of tasks in the current batch
+  int n_tasks_ = 0;
+
+  /// Index of the next task to be picked up
+  std::atomic<int> next_task_{0};
+
+  /// Counter of batches, which workers use to recognize a new batch.
+  uint64_t batch_ = 0;
+
+  /// Number of workers that did not finish the current batch yet.
+  int busy_workers_ = 0;
+
+  /// First exception thrown by a task of the current batch
+  std::exception_ptr exception_;
+
+  /// Whether the workers should terminate
+  bool stop_ = false;
+};
+
+}  // namespace smash
+
+#endif  // SRC_INCLUDE_SMASH_THREADPOOL_H_
@@ -0,0 +1,116 @@
+/*
+ *
+ *    Copyright (c) 2024
+ *      SMASH Team
+ *
+ *    GNU General Public License (GPLv3 or later)
+ *
+ */
+
+#ifndef SRC_INCLUDE_SMASH_TIMESTEPLESSGRID_H_
+#define SRC_INCLUDE_SMASH_TIMESTEPLESSGRID_H_
+
+#include <array>
+#include <cstddef>
+#include <vector>
+
+#include "forwarddeclarations.h"
+#include "particledata.h"
+
+namespace smash {
+
+/**
+ * \ingroup action
+ *
+ * Cells of the particles, which are kept up to date during the timestepless
+ * propagation, such that the collision partners of the particles produced by
+ * an action are searched among the nearby particles instead of all
+ * particles.
+ *
+ * The cells hold copies of the particles, taken when the cells are built or
+ * when the particles are produced. The copies identify the particles in the
+ * Particles object, hence particles which interacted since are recognized as
+ * outdated with Particles::is_valid. Their positions become outdated as well:
+ * since the copies were taken, the particles moved at most by the time
+ * passed since the cells were built, which is added to the reach of a
+ * search. Particles outside of the cells are kept in the cells at the
+ * border.
+ */
+class TimesteplessGrid {
+ public:
+  /**
+   * Sorts the particles into cells, replacing the previous ones.
+   *
+   * \param[in] particles The particles to be searched
+   * \param[in] min_cell_length Minimal length of the cells [fm]
+   */
+  void build(const Particles &particles, double min_cell_length);
+
+  /**
+   * Adds particles produced by an action to the cells.
+   *
+   * \param[in] new_particles Valid copies of the produced particles
+   */
+  void insert(const ParticleList &new_particles);
+
+  /**
+   * Collects the particles, which may be within reach of the particles of
+   * the search list.
+   *
+   * \param[in] search_list Particles searched for partners. They are
+   *            excluded from the candidates.
+   * \param[in] reach Distance of possible partners at the time of the search
+   *            list [fm]. The time passed since the cells were built is
+   *            added.
+   * \param[in] particles The particles the cells were built from
+   * \param[out] candidates The current states of the possible partners, in
+   *             the order of the particles
+   */
+  void find_candidates(const ParticleList &search_list, double reach,
+                       const Particles &particles,
+                       std::vector<const ParticleData *> &candidates) const;
+
+  /// \return whether the cells were built
+  bool is_built() const { return built_; }
+
+  /**
+   * Forget the particles, such that the cells are built anew before the next
+   * search. The memory of the cells is kept.
+   */
+  void clear() { built_ = false; }
+
+  /// \return the memory allocated for the cells [bytes]
+  std::size_t memory_usage() const;
+
+ private:
+  /**
+   * \return the cell index along the axis \p i of the coordinate \p x,
+   *         limited to the cells.
+   */
+  int cell_coordinate(double x, int i) const;
+
+  /// \return the cell of the position \p x
+  std::vector<ParticleData> &cell_of(const FourVector &x);
+
+  /// Minimal coordinates of the cells [fm]
+  std::array<double, 3> min_position_ = {0., 0., 0.};
+
+  /// Length of the cells [fm]
+  double cell_length_ = 1.;
+
+  /// Number of cells along every axis
+  std::array<int, 3> number_of_cells_ = {1, 1, 1};
+
+  /// Earliest time of the particles, when the cells were built [fm]
+  double reference_time_ = 0.;
+
+  /// Copies of the particles in every cell
+  std::vector<std::vector<ParticleData>> cells_;
+
+  /// Whether the cells hold the particles
+  bool built_ = false;
+};
+
+}  // namespace smash
+
+#endif  // SRC_INCLUDE_SMASH_TIMESTEPLESSGRID_H_
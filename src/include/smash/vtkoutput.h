@@ -1,6 +1,6 @@
 /*
  *
- *    Copyright (c) 2014-2022
+ *    Copyright (c) 2014-2022,2024
  *      SMASH Team
  *
  *    GNU General Public License (GPLv3 or later)
@@ -11,9 +11,11 @@
 #define SRC_INCLUDE_SMASH_VTKOUTPUT_H_
 
 #include <filesystem>
+#include <map>
 #include <memory>
 #include <string>
 #include <utility>
+#include <vector>
 
 #include "density.h"
 #include "forwarddeclarations.h"
@@ -25,6 +27,10 @@ namespace smash {
 /**
  * \ingroup output
  * SMASH output in a paraview format, intended for simple visualization.
+ *
+ * Either the legacy VTK text format is written or the VTK XML format, in which
+ * the values are appended to the XML description as raw binary data and
+ * optionally compressed with zlib.
  */
 class VtkOutput : public OutputInterface {
  public:
@@ -34,9 +40,11 @@ class VtkOutput : public OutputInterface {
    * \param path Path to the output file.
    * \param name Name of the output.
    * \param out_par Additional information on the configured output.
+   * \param xml Whether the VTK XML format is written instead of the legacy
+   *            text format.
    */
   VtkOutput(const std::filesystem::path &path, const std::string &name,
-            const OutputParameters &out_par);
+            const OutputParameters &out_par, bool xml = false);
   ~VtkOutput();
 
   /**
@@ -52,8 +60,9 @@ class VtkOutput : public OutputInterface {
 
   /**
    * Writes the final particle information list of an event to the VTK
-   * output. This currently does not do anything, because it is not
-   * required for the VTK output.
+   * output. This currently does not do anything for the legacy format. For
+   * the XML format, the time series of the files of the event are written to
+   * `.pvd` files.
    *
    * \param particles Unused. Current list of particles.
    * \param event_number Unused. Number of event.
@@ -108,9 +117,8 @@ class VtkOutput : public OutputInterface {
   void thermodynamics_output(const GrandCanThermalizer &gct) override;
 
   /// \copydoc OutputInterface::fields_output
-  void fields_output(
-      const std::string name1, const std::string name2,
-      RectangularLattice<std::pair<ThreeVector, ThreeVector>> &lat) override;
+  void fields_output(const std::string name1, const std::string name2,
+                     ForceLattice &lat) override;
 
  private:
   /**
@@ -137,40 +145,85 @@ class VtkOutput : public OutputInterface {
   std::string make_varname(const ThermodynamicQuantity tq,
                            const DensityType dens_type);
 
+  /// Values of a quantity on all nodes of a lattice
+  struct LatticeQuantity {
+    /// Name of the quantity
+    std::string name;
+    /// Number of components, 1 for a scalar and 3 for a vector
+    int n_components;
+    /// Values of all nodes, with the components of a node next to each other
+    std::vector<double> values;
+  };
+
   /**
-   * Write the VTK header.
+   * Get a scalar quantity of all lattice nodes.
    *
-   * \param file Output file.
    * \param lat Lattice corresponding to output.
-   * \param description Description of the output.
+   * \param varname Name of the output variable.
+   * \param function Function that gets the scalar given a lattice node.
    */
-  template <typename T>
-  void write_vtk_header(std::ofstream &file, RectangularLattice<T> &lat,
-                        const std::string &description);
+  template <typename T, typename F>
+  static LatticeQuantity lattice_scalar(RectangularLattice<T> &lat,
+                                        const std::string &varname,
+                                        F &&function);
 
   /**
-   * Write a VTK scalar.
+   * Get a vector quantity of all lattice nodes.
    *
-   * \param file Output file.
    * \param lat Lattice corresponding to output.
    * \param varname Name of the output variable.
-   * \param function Function that gets the scalar given a lattice node.
+   * \param function Function that gets the vector given the value of a
+   *        lattice node.
    */
-  template <typename T, typename F>
-  void write_vtk_scalar(std::ofstream &file, RectangularLattice<T> &lat,
-                        const std::string &varname, F &&function);
+  template <typename T, typename P, typename F>
+  static LatticeQuantity lattice_vector(RectangularLattice<T, P> &lat,
+                                        const std::string &varname,
+                                        F &&function);
 
   /**
-   * Write a VTK vector.
+   * Write quantities on a lattice to a new file in the configured format.
    *
-   * \param file Output file.
+   * \param description Description of the output, used for the file name.
+   * \param counter The counter enumerating the outputs.
    * \param lat Lattice corresponding to output.
-   * \param varname Name of the output variable.
-   * \param function Function that gets the vector given a lattice node.
+   * \param quantities Quantities to be written.
    */
-  template <typename T, typename F>
-  void write_vtk_vector(std::ofstream &file, RectangularLattice<T> &lat,
-                        const std::string &varname, F &&function);
+  template <typename T, typename P>
+  void write_lattice(const std::string &description, int counter,
+                     RectangularLattice<T, P> &lat,
+                     const std::vector<LatticeQuantity> &quantities);
+
+  /// Data array of a VTK XML file
+  struct XmlDataArray {
+    /// Attributes of the DataArray element apart from format and offset
+    std::string attributes;
+    /// Raw values
+    std::vector<char> data;
+  };
+
+  /**
+   * Write the given particles in the VTK XML format for unstructured grids.
+   *
+   * \param particles The particles.
+   */
+  void write_xml(const Particles &particles);
+
+  /**
+   * Write a VTK XML file, in which the data arrays are appended as raw
+   * binary data.
+   *
+   * \param filename Name of the file in the output directory.
+   * \param type Type of the data set, e.g. "ImageData".
+   * \param dataset_attributes Attributes of the data set element.
+   * \param piece_attributes Attributes of the piece element.
+   * \param sections Elements of the piece with their data arrays.
+   */
+  void write_xml_file(
+      const std::string &filename, const std::string &type,
+      const std::string &dataset_attributes,
+      const std::string &piece_attributes,
+      const std::vector<std::pair<std::string, std::vector<XmlDataArray>>>
+          &sections);
 
   /// filesystem path for output
   const std::filesystem::path base_path_;
@@ -196,6 +249,14 @@ class VtkOutput : public OutputInterface {
   bool is_thermodynamics_output_;
   /// Is the VTK output an output for fields
   bool is_fields_output_;
+  /// Whether the VTK XML format is written
+  const bool xml_;
+  /// Whether the data arrays of the XML format are compressed
+  bool compressed_;
+  /// Time of the current output moment
+  double current_time_ = 0.;
+  /// Time and file name of the XML files of the current event per time series
+  std::map<std::string, std::vector<std::pair<double, std::string>>> series_;
 };
 
 }  // namespace smash
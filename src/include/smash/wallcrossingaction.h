@@ -57,6 +57,10 @@ class WallCrossActionsFinder : public ActionFinderInterface {
    */
   explicit WallCrossActionsFinder(double l) : l_{l, l, l} {};
 
+  // The convenience overloads for a ParticleList are kept visible
+  using ActionFinderInterface::find_actions_in_cell;
+  using ActionFinderInterface::find_actions_with_neighbors;
+
   /**
    * Find the next wall crossings for every particle before time t_max.
    * \param[in] plist List of all particles.
@@ -64,12 +68,12 @@ class WallCrossActionsFinder : public ActionFinderInterface {
    * \return List of all found wall crossings.
    */
   ActionList find_actions_in_cell(
-      const ParticleList &plist, double t_max, const double,
+      const ParticleSpan &plist, double t_max, const double,
       const std::vector<FourVector> &) const override;
 
   /// Ignore the neighbor searches for wall crossing
   ActionList find_actions_with_neighbors(
-      const ParticleList &, const ParticleList &, double,
+      const ParticleSpan &, const ParticleSpan &, double,
       const std::vector<FourVector> &) const override {
     return {};
   }
@@ -1,5 +1,5 @@
 /*
- *    Copyright (c) 2015-2018,2020
+ *    Copyright (c) 2015-2018,2020,2024
  *      SMASH Team
  *
  *    GNU General Public License (GPLv3 or later)
@@ -7,6 +7,7 @@
 
 #include "smash/interpolation.h"
 
+#include <cmath>
 #include <iostream>
 
 namespace smash {
@@ -28,30 +29,98 @@ InterpolateDataSpline::InterpolateDataSpline(const std::vector<double>& x,
   const std::vector<double> sorted_y = apply_permutation(y, p);
   check_duplicates(sorted_x, "InterpolateDataSpline");
 
-  first_x_ = sorted_x.front();
-  last_x_ = sorted_x.back();
   first_y_ = sorted_y.front();
   last_y_ = sorted_y.back();
-  acc_ = gsl_interp_accel_alloc();
-  spline_ = gsl_spline_alloc(gsl_interp_cspline, N);
-  gsl_spline_init(spline_, &(*sorted_x.begin()), &(*sorted_y.begin()), N);
+  x_ = sorted_x;
+
+  /* The coefficients are taken from the natural cubic spline of GSL and
+   * combined in the same way as by gsl_spline_eval, such that the values are
+   * the same. The second derivative at a sample is twice the quadratic
+   * coefficient, which vanishes at the last sample. */
+  gsl_spline* spline = gsl_spline_alloc(gsl_interp_cspline, N);
+  gsl_spline_init(spline, sorted_x.data(), sorted_y.data(), N);
+  std::vector<double> c(N, 0.);
+  for (std::size_t i = 0; i + 1 < N; i++) {
+    c[i] = 0.5 * gsl_spline_eval_deriv2(spline, sorted_x[i], nullptr);
+  }
+  gsl_spline_free(spline);
+  coefficients_.resize(N - 1);
+  for (std::size_t i = 0; i + 1 < N; i++) {
+    const double h = sorted_x[i + 1] - sorted_x[i];
+    const double dy = sorted_y[i + 1] - sorted_y[i];
+    const double b = (dy / h) - h * (c[i + 1] + 2.0 * c[i]) / 3.0;
+    const double d = (c[i + 1] - c[i]) / (3.0 * h);
+    coefficients_[i] = {sorted_y[i], b, c[i], d};
+  }
+
+  const double spacing = (x_.back() - x_.front()) / (N - 1);
+  bool uniform = true;
+  for (std::size_t i = 0; i + 1 < N && uniform; i++) {
+    uniform = std::abs(x_[i + 1] - x_[i] - spacing) <= 1e-9 * spacing;
+  }
+  if (uniform) {
+    inverse_spacing_ = 1. / spacing;
+  }
 }
 
-InterpolateDataSpline::~InterpolateDataSpline() {
-  gsl_spline_free(spline_);
-  gsl_interp_accel_free(acc_);
+std::size_t InterpolateDataSpline::find_interval(double x,
+                                                 std::size_t guess) const {
+  const std::size_t last = coefficients_.size() - 1;
+  if (inverse_spacing_ > 0.) {
+    const double position = std::floor((x - x_.front()) * inverse_spacing_);
+    guess = !(position > 0.)           ? 0
+            : position >= double(last) ? last
+                                       : static_cast<std::size_t>(position);
+  }
+  auto found = [&](std::size_t j) {
+    return x_[j] <= x && (j == last || x < x_[j + 1]);
+  };
+  if (guess <= last && found(guess)) {
+    return guess;
+  }
+  if (guess + 1 <= last && found(guess + 1)) {
+    return guess + 1;
+  }
+  // binary search as gsl_interp_bsearch
+  std::size_t low = 0, high = x_.size() - 1;
+  while (high > low + 1) {
+    const std::size_t i = (high + low) / 2;
+    if (x_[i] > x) {
+      high = i;
+    } else {
+      low = i;
+    }
+  }
+  return low;
 }
 
 double InterpolateDataSpline::operator()(double xi) const {
+  std::size_t hint = 0;
+  return (*this)(xi, hint);
+}
+
+double InterpolateDataSpline::operator()(double xi, std::size_t& hint) const {
   // constant extrapolation
-  if (xi < first_x_) {
+  if (xi < x_.front()) {
     return first_y_;
   }
-  if (xi > last_x_) {
+  if (xi > x_.back()) {
     return last_y_;
   }
   // cubic spline interpolation
-  return gsl_spline_eval(spline_, xi, acc_);
+  hint = find_interval(xi, hint);
+  const std::array<double, 4>& a = coefficients_[hint];
+  const double dx = xi - x_[hint];
+  return a[0] + dx * (a[1] + dx * (a[2] + dx * a[3]));
+}
+
+void InterpolateDataSpline::evaluate(const double* x, std::size_t n,
+                                     double* y) const {
+  // The search starts at the interval of the previous argument
+  std::size_t hint = 0;
+  for (std::size_t k = 0; k < n; k++) {
+    y[k] = (*this)(x[k], hint);
+  }
 }
 
 }  // namespace smash
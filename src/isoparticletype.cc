@@ -1,5 +1,5 @@
 /*
- *    Copyright (c) 2015-2022
+ *    Copyright (c) 2015-2022,2024
  *      SMASH Team
  *
  *    GNU General Public License (GPLv3 or later)
@@ -7,11 +7,16 @@
 
 #include "smash/isoparticletype.h"
 
-#include <filesystem>
+#include <algorithm>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <vector>
 
-#include "smash/filelock.h"
 #include "smash/integrate.h"
 #include "smash/logging.h"
+#include "smash/threadpool.h"
 
 namespace smash {
 static constexpr int LParticleType = LogArea::ParticleType::id;
@@ -178,185 +183,245 @@ void IsoParticleType::create_multiplet(const ParticleType &type) {
   multiplet.add_state(type);
 }
 
-static Integrator integrate;
-static Integrator2d integrate2d;
+static thread_local Integrator integrate;
+static thread_local Integrator2d integrate2d;
 
 /**
- * Tabulation of all N R integrals.
+ * Tabulations of one kind of resonance integrals.
  *
- * Keys are the multiplet names (which are unique).
+ * Indices are those of the resonance multiplets in the list of all multiplets.
+ * The integrals which IsoParticleType::tabulate_integrals skips are tabulated
+ * once, when they are looked up for the first time.
  */
-static std::unordered_map<std::string, Tabulation> NR_tabulations;
+struct IntegralTabulations {
+  /// Kind of the integrals, for the error messages
+  const char *kind;
+  /// Name of the multiplet of the other particle
+  const char *part;
+  /// Whether the other particle is unstable
+  bool unstable;
+  /// The tabulations
+  std::vector<AdaptiveTabulation> tabulations = {};
+  /// Guards the tabulation at the first look-up
+  std::unique_ptr<std::once_flag[]> once = nullptr;
+};
+
+/// Tabulation of all N R integrals.
+static IntegralTabulations NR_tabulations{"NR", "N", false};
+
+/// Tabulation of all pi R integrals.
+static IntegralTabulations piR_tabulations{"piR", "π", false};
+
+/// Tabulation of all K R integrals.
+static IntegralTabulations RK_tabulations{"RK", "K", false};
+
+/// Tabulation of all Delta R integrals.
+static IntegralTabulations DeltaR_tabulations{"DeltaR", "Δ", true};
+
+/// Tabulation of all rho rho and rho h1 integrals.
+static IntegralTabulations rhoR_tabulations{"rhoR", "ρ", true};
+
+/// A resonance integral to be tabulated
+struct ResonanceIntegral {
+  /// Tabulations to which the integral belongs
+  IntegralTabulations *tabulations;
+  /// Member of the multiplets, which points to their tabulation
+  AdaptiveTabulation *IsoParticleType::*tabulation;
+  /// Multiplet of the other particle
+  const IsoParticleType *part;
+  /// Multiplet of the resonance
+  const IsoParticleType *res;
+  /// Multiplet of the antiresonance, which shares the integral, if any
+  const IsoParticleType *antires;
+};
 
 /**
- * Tabulation of all pi R integrals.
+ * Tabulate a resonance integral, or read it from the cache.
  *
- * Keys are the multiplet names (which are unique).
+ * \param[in] integral The integral to be tabulated
+ * \return Tabulation of the integral
  */
-static std::unordered_map<std::string, Tabulation> piR_tabulations;
-
-/**
- * Tabulation of all K R integrals.
- *
- * Keys are the multiplet names (which are unique).
- */
-static std::unordered_map<std::string, Tabulation> RK_tabulations;
-
-/**
- * Tabulation of all Delta R integrals.
- *
- * Keys are the pairs of multiplet names (which are unique).
- */
-static std::unordered_map<std::string, Tabulation> DeltaR_tabulations;
-
-/**
- * Tabulation of all rho rho integrals.
- *
- * Keys are the pairs of multiplet names (which are unique).
- */
-static std::unordered_map<std::string, Tabulation> rhoR_tabulations;
-
-static std::filesystem::path generate_tabulation_path(
-    const std::filesystem::path &dir, const std::string &prefix,
-    const std::string &res_name) {
-  return dir / (prefix + res_name + ".bin");
-}
-
-inline void cache_integral(
-    std::unordered_map<std::string, Tabulation> &tabulations,
-    const std::filesystem::path &dir, sha256::Hash hash,
-    const IsoParticleType &part, const IsoParticleType &res,
-    const IsoParticleType *antires, bool unstable) {
+static AdaptiveTabulation tabulate_integral(const ResonanceIntegral &integral) {
   constexpr double spacing = 2.0;
   constexpr double spacing2d = 3.0;
-  const auto path = generate_tabulation_path(dir, part.name_filtered_prime(),
-                                             res.name_filtered_prime());
-  Tabulation integral;
-  if (!dir.empty() && std::filesystem::exists(path)) {
-    std::ifstream file(path.string());
-    integral = Tabulation::from_file(file, hash);
-    if (!integral.is_empty()) {
-      // Only print message if the found tabulation was valid.
-      std::cout << "Tabulation found at " << path.filename() << '\r'
-                << std::flush;
-    }
-  }
-  if (integral.is_empty()) {
-    if (!dir.empty()) {
-      std::cout << "Caching tabulation to " << path.filename() << '\r'
-                << std::flush;
-    } else {
-      std::cout << "Calculating integral for " << part.name_filtered_prime()
-                << res.name_filtered_prime() << '\r' << std::flush;
-    }
-    if (!unstable) {
-      integral = spectral_integral_semistable(integrate, *res.get_states()[0],
-                                              *part.get_states()[0], spacing);
-    } else {
-      integral = spectral_integral_unstable(integrate2d, *res.get_states()[0],
+  const IsoParticleType &part = *integral.part;
+  const IsoParticleType &res = *integral.res;
+  return TabulationCache::get(
+      part.name_filtered_prime() + res.name_filtered_prime(), [&]() {
+        if (!integral.tabulations->unstable) {
+          return spectral_integral_semistable(
+              integrate, *res.get_states()[0], *part.get_states()[0], spacing);
+        } else {
+          return spectral_integral_unstable(integrate2d, *res.get_states()[0],
                                             *part.get_states()[0], spacing2d);
-    }
-    if (!dir.empty()) {
-      std::ofstream file(path.string());
-      integral.write(file, hash);
-    }
-  }
-  tabulations.emplace(std::make_pair(res.name(), integral));
-  if (antires != nullptr) {
-    tabulations.emplace(std::make_pair(antires->name(), integral));
-  }
+        }
+      });
 }
 
-void IsoParticleType::tabulate_integrals(
-    sha256::Hash hash, const std::filesystem::path &tabulations_path) {
-  // To avoid race conditions, make sure we are the only ones currently storing
-  // tabulations. Otherwise, we ignore any stored tabulations and don't store
-  // our results.
-  FileLock lock(tabulations_path / "tabulations.lock");
-  const std::filesystem::path &dir = lock.acquire() ? tabulations_path : "";
-
+std::size_t IsoParticleType::tabulate_integrals(
+    const ReachableIntegrals &reachable, ThreadPool *pool) {
   const auto nuc = IsoParticleType::try_find("N");
   const auto pion = IsoParticleType::try_find("π");
   const auto kaon = IsoParticleType::try_find("K");
   const auto delta = IsoParticleType::try_find("Δ");
   const auto rho = IsoParticleType::try_find("ρ");
   const auto h1 = IsoParticleType::try_find("h₁(1170)");
+  std::vector<ResonanceIntegral> integrals;
+  for (auto *tabulations : {&NR_tabulations, &piR_tabulations, &RK_tabulations,
+                            &DeltaR_tabulations, &rhoR_tabulations}) {
+    tabulations->tabulations.assign(iso_type_list.size(),
+                                    AdaptiveTabulation());
+    tabulations->once =
+        std::make_unique<std::once_flag[]>(iso_type_list.size());
+  }
+  for (IsoParticleType &multiplet : iso_type_list) {
+    multiplet.XS_NR_tabulation_ = nullptr;
+    multiplet.XS_piR_tabulation_ = nullptr;
+    multiplet.XS_RK_tabulation_ = nullptr;
+    multiplet.XS_DeltaR_tabulation_ = nullptr;
+    multiplet.XS_rhoR_tabulation_ = nullptr;
+  }
   for (const auto &res : IsoParticleType::list_baryon_resonances()) {
     const auto antires = res->anti_multiplet();
-    if (nuc) {
-      cache_integral(NR_tabulations, dir, hash, *nuc, *res, antires, false);
+    if (nuc && reachable.NR) {
+      integrals.push_back({&NR_tabulations,
+                           &IsoParticleType::XS_NR_tabulation_, nuc, res,
+                           antires});
     }
-    if (pion) {
-      cache_integral(piR_tabulations, dir, hash, *pion, *res, antires, false);
+    // Only the excited nuclei are produced in π d → π d'
+    if (pion && reachable.piR && res->states_[0]->is_nucleus()) {
+      integrals.push_back({&piR_tabulations,
+                           &IsoParticleType::XS_piR_tabulation_, pion, res,
+                           antires});
     }
-    if (kaon) {
-      cache_integral(RK_tabulations, dir, hash, *kaon, *res, antires, false);
+    // Only Δ K → N K is obtained by detailed balance
+    if (kaon && reachable.RK && res->states_[0]->is_Delta()) {
+      integrals.push_back({&RK_tabulations,
+                           &IsoParticleType::XS_RK_tabulation_, kaon, res,
+                           antires});
     }
-    if (delta) {
-      cache_integral(DeltaR_tabulations, dir, hash, *delta, *res, antires,
-                     true);
+    if (delta && reachable.DeltaR) {
+      integrals.push_back({&DeltaR_tabulations,
+                           &IsoParticleType::XS_DeltaR_tabulation_, delta, res,
+                           antires});
     }
   }
-  if (rho) {
-    cache_integral(rhoR_tabulations, dir, hash, *rho, *rho, nullptr, true);
+  if (rho && reachable.rhoR) {
+    integrals.push_back({&rhoR_tabulations,
+                         &IsoParticleType::XS_rhoR_tabulation_, rho, rho,
+                         nullptr});
   }
-  if (rho && h1) {
-    cache_integral(rhoR_tabulations, dir, hash, *rho, *h1, nullptr, true);
+  if (rho && h1 && reachable.rhoR) {
+    integrals.push_back({&rhoR_tabulations,
+                         &IsoParticleType::XS_rhoR_tabulation_, rho, h1,
+                         nullptr});
   }
-}
 
-double IsoParticleType::get_integral_NR(double sqrts) {
-  if (XS_NR_tabulation_ == nullptr) {
-    const auto res = states_[0]->iso_multiplet();
-    XS_NR_tabulation_ = &NR_tabulations.at(res->name());
+  // The integrals are independent, only storing them has to be serial
+  std::vector<AdaptiveTabulation> tabulations(integrals.size());
+  auto tabulate = [&](int i) {
+    tabulations[i] = tabulate_integral(integrals[i]);
+  };
+  if (pool) {
+    pool->parallel_for(integrals.size(), tabulate);
+  } else {
+    for (std::size_t i = 0; i < integrals.size(); i++) {
+      tabulate(i);
+    }
+  }
+  // Every multiplet points to its tabulations, which are never looked up
+  for (std::size_t i = 0; i < integrals.size(); i++) {
+    const ResonanceIntegral &integral = integrals[i];
+    for (const IsoParticleType *res : {integral.res, integral.antires}) {
+      if (res == nullptr) {
+        continue;
+      }
+      const std::size_t index = res - iso_type_list.data();
+      integral.tabulations->tabulations[index] = tabulations[i];
+      iso_type_list[index].*integral.tabulation =
+          &integral.tabulations->tabulations[index];
+    }
   }
-  return XS_NR_tabulation_->get_value_linear(sqrts);
+  return integrals.size();
 }
 
-double IsoParticleType::get_integral_piR(double sqrts) {
-  if (XS_piR_tabulation_ == nullptr) {
-    const auto res = states_[0]->iso_multiplet();
-    XS_piR_tabulation_ = &piR_tabulations.at(res->name());
+/**
+ * Look up a resonance integral, which is tabulated at the first look-up if
+ * IsoParticleType::tabulate_integrals skipped it.
+ *
+ * The tabulation is shared with the antiresonance, like the ones of
+ * IsoParticleType::tabulate_integrals. The resonance has to be a baryon
+ * resonance, or ρ or h₁(1170) for the ρ R integrals.
+ *
+ * \param[in] tabulation Tabulation of the integral, if it was tabulated by
+ *            IsoParticleType::tabulate_integrals
+ * \param[in] tabulations Tabulations of the kind of the integral
+ * \param[in] res Multiplet of the resonance
+ * \param[in] sqrts The center-of-mass energy
+ * \return Value of the integral
+ * \throw std::out_of_range if there is no such integral
+ */
+static double tabulated_integral(const AdaptiveTabulation *tabulation,
+                                 IntegralTabulations &tabulations,
+                                 const IsoParticleType &res, double sqrts) {
+  if (tabulation != nullptr) {
+    return tabulation->get_value(sqrts);
   }
-  return XS_piR_tabulation_->get_value_linear(sqrts);
+  const auto &baryon_resonances = IsoParticleType::list_baryon_resonances();
+  const IsoParticleType *resonance = nullptr;
+  if (&tabulations == &rhoR_tabulations) {
+    if (res.name() == "ρ" || res.name() == "h₁(1170)") {
+      resonance = &res;
+    }
+  } else {
+    for (const IsoParticleType *candidate : {&res, res.anti_multiplet()}) {
+      if (std::find(baryon_resonances.begin(), baryon_resonances.end(),
+                    candidate) != baryon_resonances.end()) {
+        resonance = candidate;
+      }
+    }
+  }
+  const IsoParticleType *part = IsoParticleType::try_find(tabulations.part);
+  const std::size_t index =
+      resonance ? resonance - iso_type_list.data() : iso_type_list.size();
+  if (part == nullptr || index >= tabulations.tabulations.size()) {
+    throw std::out_of_range(std::string("No ") + tabulations.kind +
+                            " integral of " + res.name() + " is available.");
+  }
+  std::call_once(tabulations.once[index], [&]() {
+    tabulations.tabulations[index] =
+        tabulate_integral({&tabulations, nullptr, part, resonance, nullptr});
+  });
+  return tabulations.tabulations[index].get_value(sqrts);
 }
 
-double IsoParticleType::get_integral_RK(double sqrts) {
-  if (XS_RK_tabulation_ == nullptr) {
-    const auto res = states_[0]->iso_multiplet();
-    XS_RK_tabulation_ = &RK_tabulations.at(res->name());
-  }
-  return XS_RK_tabulation_->get_value_linear(sqrts);
+double IsoParticleType::get_integral_NR(double sqrts) const {
+  return tabulated_integral(XS_NR_tabulation_, NR_tabulations, *this, sqrts);
 }
 
-double IsoParticleType::get_integral_rhoR(double sqrts) {
-  if (XS_rhoR_tabulation_ == nullptr) {
-    const auto res = states_[0]->iso_multiplet();
-    XS_rhoR_tabulation_ = &rhoR_tabulations.at(res->name());
-  }
-  return XS_rhoR_tabulation_->get_value_linear(sqrts);
+double IsoParticleType::get_integral_piR(double sqrts) const {
+  return tabulated_integral(XS_piR_tabulation_, piR_tabulations, *this,
+                            sqrts);
+}
+
+double IsoParticleType::get_integral_RK(double sqrts) const {
+  return tabulated_integral(XS_RK_tabulation_, RK_tabulations, *this, sqrts);
+}
+
+double IsoParticleType::get_integral_rhoR(double sqrts) const {
+  return tabulated_integral(XS_rhoR_tabulation_, rhoR_tabulations, *this,
+                            sqrts);
 }
 
 double IsoParticleType::get_integral_RR(IsoParticleType *type_res_2,
-                                        double sqrts) {
-  const auto res = states_[0]->iso_multiplet();
+                                        double sqrts) const {
   if (type_res_2->states_[0]->is_Delta()) {
-    if (XS_DeltaR_tabulation_ == nullptr) {
-      XS_DeltaR_tabulation_ = &DeltaR_tabulations.at(res->name());
-    }
-    return XS_DeltaR_tabulation_->get_value_linear(sqrts);
+    return tabulated_integral(XS_DeltaR_tabulation_, DeltaR_tabulations, *this,
+                              sqrts);
   }
-  if (type_res_2->name() == "ρ") {
-    if (XS_rhoR_tabulation_ == nullptr) {
-      XS_rhoR_tabulation_ = &rhoR_tabulations.at(res->name());
-    }
-    return XS_rhoR_tabulation_->get_value_linear(sqrts);
-  }
-  if (type_res_2->name() == "h₁(1170)") {
-    if (XS_rhoR_tabulation_ == nullptr) {
-      XS_rhoR_tabulation_ = &rhoR_tabulations.at(res->name());
-    }
-    return XS_rhoR_tabulation_->get_value_linear(sqrts);
+  if (type_res_2->name() == "ρ" || type_res_2->name() == "h₁(1170)") {
+    return tabulated_integral(XS_rhoR_tabulation_, rhoR_tabulations, *this,
+                              sqrts);
   }
   std::stringstream err;
   err << "RR=" << name() << type_res_2->name() << " is not implemented";
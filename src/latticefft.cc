@@ -0,0 +1,108 @@
+/*
+ *
+ *    Copyright (c) 2024
+ *      SMASH Team
+ *
+ *    GNU General Public License (GPLv3 or later)
+ *
+ */
+
+#include "smash/latticefft.h"
+
+#include <algorithm>
+#include <cstdlib>
+
+namespace smash {
+
+/**
+ * \param[in] n Smallest size
+ * \return Smallest size of at least n which only has the factors 2, 3 and 5,
+ *         for which the transforms are fastest
+ */
+static int fft_size(int n) {
+  for (int m = n;; m++) {
+    int rest = m;
+    for (const int factor : {2, 3, 5}) {
+      while (rest % factor == 0) {
+        rest /= factor;
+      }
+    }
+    if (rest == 1) {
+      return m;
+    }
+  }
+}
+
+LatticeFFT::LatticeFFT(const std::array<int, 3> &n_cells,
+                       const std::array<int, 3> &range, bool periodic)
+    : n_cells_(n_cells), periodic_(periodic) {
+  for (int i = 0; i < 3; i++) {
+    // no two nodes are further apart than the lattice
+    size_[i] = periodic ? n_cells_[i]
+                        : fft_size(n_cells_[i] +
+                                   std::clamp(range[i], 0, n_cells_[i] - 1));
+    wavetables_[i] = gsl_fft_complex_wavetable_alloc(size_[i]);
+    workspaces_[i] = gsl_fft_complex_workspace_alloc(size_[i]);
+  }
+}
+
+LatticeFFT::~LatticeFFT() {
+  for (int i = 0; i < 3; i++) {
+    gsl_fft_complex_wavetable_free(wavetables_[i]);
+    gsl_fft_complex_workspace_free(workspaces_[i]);
+  }
+}
+
+std::optional<std::size_t> LatticeFFT::offset_index(int mx, int my,
+                                                    int mz) const {
+  const std::array<int, 3> m = {mx, my, mz};
+  std::array<int, 3> wrapped;
+  for (int i = 0; i < 3; i++) {
+    if (!periodic_ && std::abs(m[i]) >= n_cells_[i]) {
+      return std::nullopt;
+    }
+    wrapped[i] = ((m[i] % size_[i]) + size_[i]) % size_[i];
+  }
+  return grid_index(wrapped[0], wrapped[1], wrapped[2]);
+}
+
+void LatticeFFT::forward(Grid &grid, bool only_lattice) {
+  transform(grid, false, only_lattice);
+}
+
+void LatticeFFT::inverse(Grid &grid, bool only_lattice) {
+  transform(grid, true, only_lattice);
+}
+
+void LatticeFFT::transform(Grid &grid, bool inverse, bool only_lattice) {
+  /* A forward transform of a grid, which is zero outside of the lattice, can
+   * skip the lines of directions which are not transformed yet and lie
+   * outside of the lattice. After an inverse transform, only the lattice is
+   * needed, which skips the lines outside of it in the directions which are
+   * already transformed. */
+  std::array<int, 3> extent = only_lattice && !inverse ? n_cells_ : size_;
+  const std::array<std::size_t, 3> stride = {
+      1, static_cast<std::size_t>(size_[0]),
+      static_cast<std::size_t>(size_[0]) * size_[1]};
+  // the complex numbers are stored as pairs of real and imaginary part
+  double *data = reinterpret_cast<double *>(grid.data());
+  for (int step = 0; step < 3; step++) {
+    const int axis = inverse ? 2 - step : step;
+    const int a = axis == 0 ? 1 : 0, b = axis == 2 ? 1 : 2;
+    for (int ib = 0; ib < extent[b]; ib++) {
+      for (int ia = 0; ia < extent[a]; ia++) {
+        double *line = data + 2 * (ia * stride[a] + ib * stride[b]);
+        if (inverse) {
+          gsl_fft_complex_inverse(line, stride[axis], size_[axis],
+                                  wavetables_[axis], workspaces_[axis]);
+        } else {
+          gsl_fft_complex_forward(line, stride[axis], size_[axis],
+                                  wavetables_[axis], workspaces_[axis]);
+        }
+      }
+    }
+    extent[axis] = only_lattice && inverse ? n_cells_[axis] : size_[axis];
+  }
+}
+
+}  // namespace smash
@@ -1,6 +1,6 @@
 /*
  *
- *    Copyright (c) 2022
+ *    Copyright (c) 2022,2024
  *      SMASH Team
  *
  *    GNU General Public License (GPLv3 or later)
@@ -9,15 +9,25 @@
 
 #include "smash/library.h"
 
+#include <algorithm>
 #include <filesystem>
+#include <map>
+#include <optional>
+#include <thread>
 
+#include "smash/chrono.h"
 #include "smash/configuration.h"
+#include "smash/crosssectionsphoton.h"
 #include "smash/decaymodes.h"
 #include "smash/inputfunctions.h"
 #include "smash/isoparticletype.h"
 #include "smash/logging.h"
+#include "smash/particletablesnapshot.h"
+#include "smash/pdgcode.h"
 #include "smash/setup_particles_decaymodes.h"
 #include "smash/stringfunctions.h"
+#include "smash/tabulation.h"
+#include "smash/threadpool.h"
 
 namespace smash {
 static constexpr int LMain = LogArea::Main::id;
@@ -42,6 +52,58 @@ Configuration setup_config_and_logging(
   return configuration;
 }
 
+ReachableIntegrals reachable_integrals(Configuration &configuration) {
+  ReachableIntegrals reachable;
+  if (configuration.read({"Collision_Term", "No_Collisions"}, false)) {
+    return {false, false, false, false, false};
+  }
+  const std::string modus =
+      configuration.read({"General", "Modus"}, std::string());
+  const auto included_2to2 = configuration.read(
+      {"Collision_Term", "Included_2to2"}, ReactionsBitSet().set());
+  const auto multi_particle_reactions =
+      configuration.read({"Collision_Term", "Multi_Particle_Reactions"},
+                         MultiParticleReactionsBitSet().reset());
+  const auto nnbar_treatment = configuration.read(
+      {"Collision_Term", "NNbar_Treatment"}, NNbarTreatment::Strings);
+  const bool strings =
+      configuration.read({"Collision_Term", "Strings"}, modus != "Box");
+
+  const bool nnbar_from_pions =
+      multi_particle_reactions[IncludedMultiParticleReactions::NNbar_5to2];
+  bool baryons = strings || nnbar_from_pions ||
+                 nnbar_treatment == NNbarTreatment::Resonances;
+  if (modus == "Box" || modus == "Sphere") {
+    const char *section = modus.c_str();
+    if (configuration.read({"Modus", section, "Use_Thermal_Multiplicities"},
+                           false) ||
+        configuration.has_value({"Modus", section, "Jet"})) {
+      baryons = true;
+    } else if (configuration.has_value(
+                   {"Modus", section, "Init_Multiplicities"})) {
+      const std::map<PdgCode, int> multiplicities =
+          configuration.read({"Modus", section, "Init_Multiplicities"});
+      for (const auto &pdg_and_multiplicity : multiplicities) {
+        baryons = baryons || pdg_and_multiplicity.first.baryon_number() != 0;
+      }
+    }
+  } else {
+    // The initial state of the other modi contains baryons in general
+    baryons = true;
+  }
+
+  const bool nucleon_resonances =
+      included_2to2[IncludedReactions::NN_to_NR] ||
+      included_2to2[IncludedReactions::NDeuteron_to_Ndprime];
+  reachable.NR = baryons && nucleon_resonances;
+  reachable.DeltaR = baryons && included_2to2[IncludedReactions::NN_to_DR];
+  reachable.piR =
+      baryons && included_2to2[IncludedReactions::PiDeuteron_to_pidprime];
+  reachable.RK = baryons && included_2to2[IncludedReactions::KN_to_KDelta];
+  reachable.rhoR = nnbar_treatment == NNbarTreatment::Resonances;
+  return reachable;
+}
+
 void initialize_particles_decays_and_tabulations(
     Configuration &configuration, const std::string &version,
     const std::string &tabulations_dir) {
@@ -49,9 +111,6 @@ void initialize_particles_decays_and_tabulations(
                     " create ParticleType and DecayModes");
   const std::string particles_string = configuration.take({"particles"});
   const std::string decaymodes_string = configuration.take({"decaymodes"});
-  ParticleType::create_type_list(particles_string);
-  DecayModes::load_decaymodes(decaymodes_string);
-  ParticleType::check_consistency();
 
   // Calculate a hash of the SMASH version, the particles and decaymodes.
   sha256::Context hash_context;
@@ -61,14 +120,68 @@ void initialize_particles_decays_and_tabulations(
   const auto hash = hash_context.finalize();
   logg[LMain].info() << "Config hash: " << sha256::hash_to_string(hash);
 
-  logg[LMain].info("Tabulating cross section integrals...");
   std::filesystem::path tabulations_path(tabulations_dir);
   if (!tabulations_path.empty()) {
     // Store tabulations on disk
     std::filesystem::create_directories(tabulations_path);
     logg[LMain].info() << "Tabulations path: " << tabulations_path;
   }
-  IsoParticleType::tabulate_integrals(hash, tabulations_path);
+  /* The resolved particle types and decay modes are stored next to the
+   * tabulations, such that they do not have to be parsed and checked again
+   * for the same input. */
+  const std::filesystem::path snapshot_path =
+      tabulations_path / "particles.bin";
+  std::optional<ParticleTableSnapshot> snapshot;
+  if (!tabulations_path.empty()) {
+    snapshot = ParticleTableSnapshot::read(snapshot_path, hash);
+  }
+  if (snapshot) {
+    snapshot->install();
+    logg[LMain].info() << "Read particle types and decay modes from "
+                       << snapshot_path;
+  } else {
+    ParticleType::create_type_list(particles_string);
+    DecayModes::load_decaymodes(decaymodes_string);
+    ParticleType::check_consistency();
+    if (!tabulations_path.empty()) {
+      try {
+        ParticleTableSnapshot::take().write(snapshot_path, hash);
+      } catch (const std::exception &e) {
+        logg[LMain].warn() << "Could not store the particle types and decay "
+                           << "modes: " << e.what();
+      }
+    }
+  }
+
+  logg[LMain].info("Tabulating cross section integrals...");
+  TabulationCache cache(tabulations_path, hash);
+  /* The tabulations are independent of each other and are computed
+   * concurrently. Each is computed in the same way by one thread, so the
+   * tables do not depend on the number of threads. */
+  ThreadPool pool(
+      static_cast<int>(std::max(1u, std::thread::hardware_concurrency())));
+  auto seconds_since = [](SystemTimePoint start) {
+    return std::chrono::duration<double>(SystemClock::now() - start).count();
+  };
+  SystemTimePoint start = SystemClock::now();
+  // The decay widths tabulate their mass dependence at the first call
+  ParticleType::initialize_lazy_members(&pool);
+  logg[LMain].info("Tabulated the decay widths in ", seconds_since(start),
+                   " [s] using ", pool.size(), " threads");
+  start = SystemClock::now();
+  const std::size_t n_integrals = IsoParticleType::tabulate_integrals(
+      reachable_integrals(configuration), &pool);
+  logg[LMain].info("Tabulated ", n_integrals,
+                   " reachable resonance integrals in ", seconds_since(start),
+                   " [s], the others are tabulated when needed");
+  if (configuration.read({"Collision_Term", "Photons", "2to2_Scatterings"},
+                         false)) {
+    logg[LMain].info("Tabulating photon cross sections...");
+    start = SystemClock::now();
+    CrosssectionsPhoton<ComputationMethod::Lookup>::tabulate(&pool);
+    logg[LMain].info("Tabulated the photon cross sections in ",
+                     seconds_since(start), " [s]");
+  }
 }
 
 static Configuration create_configuration(
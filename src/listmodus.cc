@@ -1,6 +1,6 @@
 /*
  *
- *    Copyright (c) 2015-2023
+ *    Copyright (c) 2015-2024
  *      SMASH Team
  *
  *    GNU General Public License (GPLv3 or later)
@@ -9,14 +9,20 @@
 
 #include "smash/listmodus.h"
 
+#include <cfloat>
+#include <charconv>
 #include <cmath>
+#include <cstdint>
 #include <cstdio>
 #include <cstdlib>
+#include <cstring>
 #include <filesystem>
-#include <fstream>
 #include <list>
 #include <map>
-#include <sstream>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <type_traits>
 #include <utility>
 #include <vector>
 
@@ -29,6 +35,7 @@
 #include "smash/inputfunctions.h"
 #include "smash/logging.h"
 #include "smash/particledata.h"
+#include "smash/stringfunctions.h"
 #include "smash/threevector.h"
 #include "smash/wallcrossingaction.h"
 
@@ -66,6 +73,7 @@ ListModus::ListModus(Configuration modus_config,
   particle_list_file_directory_ =
       plain_config.take({"File_Directory"})
           .convert_for(particle_list_file_directory_);
+  prefetch_ = plain_config.take({"Prefetch"}, false);
   if (param.n_ensembles > 1) {
     throw std::runtime_error("ListModus only makes sense with one ensemble");
   }
@@ -134,31 +142,18 @@ void ListModus::try_create_particle(Particles &particles, PdgCode pdgcode,
 /* initial_conditions - sets particle data for @particles */
 double ListModus::initial_conditions(Particles *particles,
                                      const ExperimentParameters &) {
-  std::string particle_list = next_event_();
-  for (const Line &line : line_parser(particle_list)) {
-    std::istringstream lineinput(line.text);
-    double t, x, y, z, mass, E, px, py, pz;
-    int id, charge;
-    std::string pdg_string;
-    lineinput >> t >> x >> y >> z >> mass >> E >> px >> py >> pz >>
-        pdg_string >> id >> charge;
-    if (lineinput.fail()) {
-      throw LoadFailure(
-          build_error_string("While loading external particle lists data:\n"
-                             "Failed to convert the input string to the "
-                             "expected data types.",
-                             line));
-    }
-    PdgCode pdgcode(pdg_string);
-    logg[LList].debug("Particle ", pdgcode, " (x,y,z)= (", x, ", ", y, ", ", z,
-                      ")");
+  for (const InputParticle &p : next_event_()) {
+    logg[LList].debug("Particle ", p.pdgcode, " (x,y,z)= (", p.x, ", ", p.y,
+                      ", ", p.z, ")");
 
     // Charge consistency check
-    if (pdgcode.charge() != charge) {
-      logg[LList].error() << "Charge of pdg = " << pdgcode << " != " << charge;
+    if (p.pdgcode.charge() != p.charge) {
+      logg[LList].error() << "Charge of pdg = " << p.pdgcode
+                          << " != " << p.charge;
       throw std::invalid_argument("Inconsistent input (charge).");
     }
-    try_create_particle(*particles, pdgcode, t, x, y, z, mass, E, px, py, pz);
+    try_create_particle(*particles, p.pdgcode, p.t, p.x, p.y, p.z, p.mass,
+                        p.E, p.px, p.py, p.pz);
   }
   if (particles->size() > 0) {
     backpropagate_to_same_time(*particles);
@@ -195,80 +190,265 @@ std::filesystem::path ListModus::file_path_(std::optional<int> file_id) {
   return fpath;
 }
 
-std::string ListModus::next_event_() {
-  const std::filesystem::path fpath = file_path_(file_id_);
-  std::ifstream ifs{fpath};
-  ifs.seekg(last_read_position_);
-
-  if (!file_has_events_(fpath, last_read_position_)) {
-    if (file_id_) {
-      // Get next file and call this function recursively
-      (*file_id_)++;
-      last_read_position_ = 0;
-      ifs.close();
-      return next_event_();
+ListModus::EventText ListModus::find_next_event_() {
+  auto map_file = [this]() {
+    file_ = std::make_shared<const MappedFile>(file_path_(file_id_));
+    const std::string_view content = file_->content();
+    if (content.substr(0, 4) == "SMSH") {
+      file_events_ = index_binary_events_(content, binary_record_size_);
     } else {
+      file_events_ = index_events_(content);
+      binary_record_size_ = 0;
+    }
+    next_event_in_file_ = 0;
+  };
+  if (!file_) {
+    map_file();
+  }
+  while (next_event_in_file_ == file_events_.size()) {
+    if (!file_id_) {
       throw std::runtime_error(
           "Attempt to read in next event in Listmodus object but no further "
           "data found in single provided file. Please, check your setup.");
     }
+    (*file_id_)++;
+    map_file();
   }
+  const auto [offset, length] = file_events_[next_event_in_file_++];
+  return {file_, file_->content().substr(offset, length), binary_record_size_};
+}
 
-  // read one event. events marked by line # event end i in case of Oscar
-  // output. Assume one event per file for all other output formats
-  std::string event_string;
-  const std::string needle = "end";
-  std::string line;
-  while (getline(ifs, line)) {
-    if (line.find(needle) == std::string::npos) {
-      event_string += line + "\n";
-    } else {
-      break;
-    }
+std::vector<ListModus::InputParticle> ListModus::next_event_() {
+  std::vector<InputParticle> event;
+  if (prefetched_event_.valid()) {
+    event = prefetched_event_.get();
+  } else {
+    event = parse_event_(find_next_event_());
+  }
+  /* Only events of the current file are prefetched, such that missing files
+   * are reported only when their events are needed. */
+  if (prefetch_ && next_event_in_file_ < file_events_.size()) {
+    prefetched_event_ =
+        std::async(std::launch::async, [next = find_next_event_()]() {
+          return parse_event_(next);
+        });
   }
+  return event;
+}
 
-  if (!ifs.eof() && (ifs.fail() || ifs.bad())) {
-    logg[LList].fatal() << "Error while reading " << fpath.filename().native();
-    throw std::runtime_error("Error while reading external particle list");
+std::vector<std::pair<std::size_t, std::size_t>> ListModus::index_events_(
+    std::string_view content) {
+  // events are ended by lines like "# event 0 end" in case of Oscar output,
+  // all other output formats are assumed to have one event per file
+  std::vector<std::pair<std::size_t, std::size_t>> events;
+  std::size_t event_begin = 0;
+  std::size_t line_begin = 0;
+  while (line_begin < content.size()) {
+    std::size_t line_end = content.find('\n', line_begin);
+    if (line_end == std::string_view::npos) {
+      line_end = content.size();
+    }
+    const auto line = content.substr(line_begin, line_end - line_begin);
+    if (line.find("end") != std::string_view::npos) {
+      events.emplace_back(event_begin, line_begin - event_begin);
+      event_begin = line_end + 1;
+    }
+    line_begin = line_end + 1;
+  }
+  if (event_begin < content.size() &&
+      content.find_first_not_of(" \t\r\n", event_begin) !=
+          std::string_view::npos) {
+    events.emplace_back(event_begin, content.size() - event_begin);
   }
-  // save position for next event read
-  last_read_position_ = ifs.tellg();
-  ifs.close();
+  return events;
+}
 
-  return event_string;
+namespace {
+/// Version of the binary particles output, which can be read
+constexpr std::uint16_t binary_format_version = 9;
+/// Size of a particle record of the binary particles output in bytes
+constexpr std::size_t binary_record_size =
+    9 * sizeof(double) + 3 * sizeof(std::int32_t);
+/// Size of the extended part of a particle record in bytes
+constexpr std::size_t binary_extended_record_size =
+    3 * sizeof(double) + 7 * sizeof(std::int32_t);
+
+/**
+ * Copy a value out of a binary particle list file.
+ *
+ * \param[in] content Content of the file
+ * \param[inout] offset Position of the value, which is advanced behind it
+ * \throw LoadFailure if the value is not within the file.
+ */
+template <typename T>
+T read_binary(std::string_view content, std::size_t &offset) {
+  if (offset + sizeof(T) > content.size()) {
+    throw ListModus::LoadFailure("Binary particle list ends unexpectedly.");
+  }
+  T value;
+  std::memcpy(&value, content.data() + offset, sizeof(T));
+  offset += sizeof(T);
+  return value;
 }
+}  // namespace
 
-bool ListModus::file_has_events_(std::filesystem::path filepath,
-                                 std::streampos last_position) {
-  std::ifstream ifs{filepath};
-  std::string line;
+std::vector<std::pair<std::size_t, std::size_t>>
+ListModus::index_binary_events_(std::string_view content,
+                                std::size_t &record_size) {
+  std::size_t offset = 4;
+  const auto format_version = read_binary<std::uint16_t>(content, offset);
+  const auto format_variant = read_binary<std::uint16_t>(content, offset);
+  if (format_version != binary_format_version || format_variant > 1) {
+    throw LoadFailure("Binary particle lists of format version " +
+                      std::to_string(format_version) + " and variant " +
+                      std::to_string(format_variant) +
+                      " are not supported.");
+  }
+  record_size = binary_record_size +
+                (format_variant == 1 ? binary_extended_record_size : 0);
+  // skip the SMASH version
+  offset += read_binary<std::uint32_t>(content, offset);
 
-  // last event read read at end of file. we know this because errors are
-  // handled in next_event
-  if (last_position == -1) {
-    return false;
+  std::vector<std::pair<std::size_t, std::size_t>> events;
+  std::optional<std::pair<std::size_t, std::size_t>> last_particles;
+  while (offset < content.size()) {
+    const char block = read_binary<char>(content, offset);
+    if (block == 'p') {
+      const std::size_t n = read_binary<std::uint32_t>(content, offset);
+      last_particles = {offset, n * record_size};
+      offset += n * record_size;
+    } else if (block == 'i') {
+      const std::size_t n_in = read_binary<std::uint32_t>(content, offset);
+      const std::size_t n_out = read_binary<std::uint32_t>(content, offset);
+      offset += 3 * sizeof(double) + sizeof(std::uint32_t) +
+                (n_in + n_out) * record_size;
+    } else if (block == 'f') {
+      offset += sizeof(std::int32_t) + sizeof(double) + sizeof(char);
+      // an event without particle block is empty
+      const std::pair<std::size_t, std::size_t> no_particles{offset, 0};
+      events.push_back(last_particles.value_or(no_particles));
+      last_particles.reset();
+    } else if (block == 'x') {
+      // the event index of the binary output follows
+      break;
+    } else {
+      throw LoadFailure("Unknown block '" + std::string(1, block) +
+                        "' in binary particle list.");
+    }
+  }
+  if (offset > content.size()) {
+    throw LoadFailure("Binary particle list ends unexpectedly.");
   }
-  ifs.seekg(last_position);
-  // skip over comment lines, assume that a max. of four consecutive comment
-  // lines can occur
-  int skipped_lines = 0;
-  const int max_comment_lines = 4;
-  while (std::getline(ifs, line) && line[0] != '#' &&
-         skipped_lines++ < max_comment_lines) {
+  if (last_particles) {
+    events.push_back(*last_particles);
   }
+  return events;
+}
 
-  if (ifs.eof()) {
+namespace {
+/**
+ * Parse the next field of a line of a particle list.
+ *
+ * \param[inout] begin Position in the line, which is advanced behind the field
+ * \param[in] end End of the line
+ * \param[out] value Value of the field
+ * \return Whether the field was found and converted completely.
+ */
+template <typename T>
+bool parse_field(const char *&begin, const char *end, T &value) {
+  auto is_space = [](char c) { return c == ' ' || c == '\t' || c == '\r'; };
+  while (begin != end && is_space(*begin)) {
+    begin++;
+  }
+  // a plus sign is accepted by streams, but not by std::from_chars
+  if (begin != end && *begin == '+') {
+    begin++;
+  }
+  const char *field_end = begin;
+  while (field_end != end && !is_space(*field_end)) {
+    field_end++;
+  }
+  if (field_end == begin) {
     return false;
   }
+  const char *parsed_end;
+  if constexpr (std::is_same_v<T, std::string_view>) {
+    value = std::string_view(begin, field_end - begin);
+    parsed_end = field_end;
+#ifndef __cpp_lib_to_chars
+  } else if constexpr (std::is_floating_point_v<T>) {
+    // std::from_chars for floating point numbers is not available
+    const std::string field(begin, field_end);
+    char *field_parsed_end;
+    value = std::strtod(field.c_str(), &field_parsed_end);
+    parsed_end = begin + (field_parsed_end - field.c_str());
+#endif
+  } else {
+    parsed_end = std::from_chars(begin, field_end, value).ptr;
+  }
+  begin = field_end;
+  return parsed_end == field_end;
+}
+}  // namespace
 
-  if (!ifs.good()) {
-    logg[LList].fatal() << "Error while reading "
-                        << filepath.filename().native();
-    throw std::runtime_error("Error while reading external particle list");
+std::vector<ListModus::InputParticle> ListModus::parse_event_(
+    const EventText &event) {
+  std::vector<InputParticle> particles;
+  if (event.binary_record_size > 0) {
+    const std::size_t n = event.text.size() / event.binary_record_size;
+    particles.reserve(n);
+    for (std::size_t i = 0; i < n; i++) {
+      const char *record = event.text.data() + i * event.binary_record_size;
+      double reals[9];
+      std::memcpy(reals, record, sizeof(reals));
+      // PDG code, ID and charge
+      std::int32_t integers[3];
+      std::memcpy(integers, record + sizeof(reals), sizeof(integers));
+      particles.push_back({reals[0], reals[1], reals[2], reals[3], reals[4],
+                           reals[5], reals[6], reals[7], reals[8],
+                           PdgCode(integers[0]), integers[2]});
+    }
+    return particles;
   }
 
-  ifs.close();
-  return true;
+  const std::string_view text = event.text;
+  int line_number = 0;
+  std::size_t line_begin = 0;
+  while (line_begin < text.size()) {
+    ++line_number;
+    std::size_t line_end = text.find('\n', line_begin);
+    if (line_end == std::string_view::npos) {
+      line_end = text.size();
+    }
+    auto line = text.substr(line_begin, line_end - line_begin);
+    line_begin = line_end + 1;
+    // remove comments and skip lines with only whitespace
+    line = line.substr(0, line.find('#'));
+    if (line.find_first_not_of(" \t\r") == std::string_view::npos) {
+      continue;
+    }
+
+    double t, x, y, z, mass, E, px, py, pz;
+    int id, charge;
+    std::string_view pdg_string;
+    const char *begin = line.data();
+    const char *end = line.data() + line.size();
+    if (!(parse_field(begin, end, t) && parse_field(begin, end, x) &&
+          parse_field(begin, end, y) && parse_field(begin, end, z) &&
+          parse_field(begin, end, mass) && parse_field(begin, end, E) &&
+          parse_field(begin, end, px) && parse_field(begin, end, py) &&
+          parse_field(begin, end, pz) && parse_field(begin, end, pdg_string) &&
+          parse_field(begin, end, id) && parse_field(begin, end, charge))) {
+      throw LoadFailure(
+          build_error_string("While loading external particle lists data:\n"
+                             "Failed to convert the input string to the "
+                             "expected data types.",
+                             Line(line_number, trim(std::string(line)))));
+    }
+    particles.push_back({t, x, y, z, mass, E, px, py, pz,
+                         PdgCode(pdg_string), charge});
+  }
+  return particles;
 }
 
 ListBoxModus::ListBoxModus(Configuration modus_config,
@@ -1,6 +1,6 @@
 /*
  *
- *    Copyright (c) 2014-2015,2017-2019,2022
+ *    Copyright (c) 2014-2015,2017-2019,2022,2024
  *      SMASH Team
  *
  *    GNU General Public License (GPLv3 or later)
@@ -9,7 +9,10 @@
 
 #include "smash/logging.h"
 
+#include <algorithm>
 #include <array>
+#include <mutex>
+#include <vector>
 
 #include "smash/configuration.h"
 #include "smash/stringfunctions.h"
@@ -36,7 +39,9 @@ void set_default_loglevel(einhard::LogLevel level) {
  * \endcode
  * For further documentation see `logging.h`.
  */
-std::array<einhard::Logger<>, std::tuple_size<LogArea::AreaTuple>::value> logg;
+std::array<einhard::Logger<compile_time_log_level>,
+           std::tuple_size<LogArea::AreaTuple>::value>
+    logg;
 
 /**
  * \internal
@@ -120,4 +125,54 @@ void create_all_loggers(Configuration config) {
   create_all_loggers_impl<std::tuple_size<LogArea::AreaTuple>::value>(config);
 }
 
+namespace {
+/// All rate-limited warnings, which are summarized at the end of an event
+struct RateLimitedWarnings {
+  /// Guards the list
+  std::mutex mutex;
+  /// The registered warnings
+  std::vector<RateLimitedWarning *> list;
+};
+
+/**
+ * \return The registered warnings, which are created on first use, as the
+ *         warnings are static objects themselves.
+ */
+RateLimitedWarnings &rate_limited_warnings() {
+  static RateLimitedWarnings warnings;
+  return warnings;
+}
+}  // namespace
+
+RateLimitedWarning::RateLimitedWarning(int area, const char *description,
+                                       std::uint64_t limit)
+    : area_(area), description_(description), limit_(limit) {
+  RateLimitedWarnings &warnings = rate_limited_warnings();
+  std::lock_guard<std::mutex> lock(warnings.mutex);
+  warnings.list.push_back(this);
+}
+
+RateLimitedWarning::~RateLimitedWarning() {
+  RateLimitedWarnings &warnings = rate_limited_warnings();
+  std::lock_guard<std::mutex> lock(warnings.mutex);
+  warnings.list.erase(
+      std::find(warnings.list.begin(), warnings.list.end(), this));
+}
+
+void RateLimitedWarning::summarize() {
+  const std::uint64_t n = occurrences_.exchange(0, std::memory_order_relaxed);
+  if (n > limit_) {
+    logg[area_].warn(description_, ": ", n, " times in this event, of which ",
+                     n - limit_, " were not written.");
+  }
+}
+
+void summarize_rate_limited_warnings() {
+  RateLimitedWarnings &warnings = rate_limited_warnings();
+  std::lock_guard<std::mutex> lock(warnings.mutex);
+  for (RateLimitedWarning *warning : warnings.list) {
+    warning->summarize();
+  }
+}
+
 }  // namespace smash
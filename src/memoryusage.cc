@@ -0,0 +1,117 @@
+/*
+ *
+ *    Copyright (c) 2024
+ *      SMASH Team
+ *
+ *    GNU General Public License (GPLv3 or later)
+ *
+ */
+
+#include "smash/memoryusage.h"
+
+#include <sys/resource.h>
+#include <unistd.h>
+
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+
+namespace smash {
+
+namespace {
+/// \return Bytes in MiB
+double mebibytes(std::size_t bytes) { return bytes / (1024. * 1024.); }
+}  // namespace
+
+const char *MemoryUsage::name(Subsystem subsystem) {
+  switch (subsystem) {
+    case Subsystem::Particles:
+      return "Particles";
+    case Subsystem::Grids:
+      return "Grids";
+    case Subsystem::Actions:
+      return "Actions";
+    case Subsystem::Lattices:
+      return "Lattices";
+    case Subsystem::Tabulations:
+      return "Tabulations";
+    case Subsystem::Outputs:
+      return "Output buffers";
+  }
+  throw std::invalid_argument("Unknown memory subsystem");
+}
+
+void MemoryUsage::check_limit() const {
+  if (limit_ == 0) {
+    return;
+  }
+  const std::size_t rss = resident_set_size();
+  if (rss > limit_) {
+    std::ostringstream message;
+    message.precision(1);
+    message << std::fixed << "The memory limit of " << mebibytes(limit_)
+            << " MiB is exceeded with a resident set size of "
+            << mebibytes(rss) << " MiB.\n"
+            << report();
+    throw std::runtime_error(message.str());
+  }
+}
+
+std::string MemoryUsage::report() const {
+  std::ostringstream out;
+  char line[80];
+  out << "Memory usage:";
+  std::snprintf(line, sizeof(line), "\n  %-22s %12s %12s", "Subsystem",
+                "Now [MiB]", "Peak [MiB]");
+  out << line;
+  for (int i = 0; i < n_subsystems; i++) {
+    std::snprintf(line, sizeof(line), "\n  %-22s %12.1f %12.1f",
+                  name(static_cast<Subsystem>(i)), mebibytes(current_[i]),
+                  mebibytes(peak_[i]));
+    out << line;
+  }
+  std::snprintf(line, sizeof(line), "\n  %-22s %12.1f %12.1f",
+                "Resident set size", mebibytes(resident_set_size()),
+                mebibytes(peak_resident_set_size()));
+  out << line;
+  if (pythia_instances_ > 0) {
+    out << "\n  " << pythia_instances_ << " PYTHIA objects";
+  }
+  return out.str();
+}
+
+std::size_t MemoryUsage::resident_set_size() {
+  // The second field of statm is the number of resident pages
+  std::ifstream statm("/proc/self/statm");
+  std::size_t size = 0, resident = 0;
+  if (statm >> size >> resident) {
+    return resident * static_cast<std::size_t>(sysconf(_SC_PAGESIZE));
+  }
+  return 0;
+}
+
+std::size_t MemoryUsage::peak_resident_set_size() {
+  // The high water mark of the resident set size in KiB on Linux
+  std::ifstream status("/proc/self/status");
+  std::string line;
+  while (std::getline(status, line)) {
+    if (line.rfind("VmHWM:", 0) == 0) {
+      return std::stoul(line.substr(6)) * 1024;
+    }
+  }
+  rusage usage;
+  if (getrusage(RUSAGE_SELF, &usage) != 0) {
+    return 0;
+  }
+#ifdef __APPLE__
+  // In bytes on macOS
+  return usage.ru_maxrss;
+#else
+  // In KiB on Linux
+  return static_cast<std::size_t>(usage.ru_maxrss) * 1024;
+#endif
+}
+
+}  // namespace smash
@@ -0,0 +1,44 @@
+/*
+ *
+ *    Copyright (c) 2024
+ *      SMASH Team
+ *
+ *    GNU General Public License (GPLv3 or later)
+ *
+ */
+
+#include "smash/mpiensemblecommunicator.h"
+
+#include <algorithm>
+#include <climits>
+
+namespace smash {
+
+namespace {
+/// Largest number of values reduced by one call, as MPI counts are int
+constexpr std::size_t max_chunk = INT_MAX;
+}  // namespace
+
+MpiEnsembleCommunicator::MpiEnsembleCommunicator(MPI_Comm comm)
+    : comm_(comm) {
+  MPI_Comm_rank(comm_, &rank_);
+  MPI_Comm_size(comm_, &size_);
+}
+
+void MpiEnsembleCommunicator::sum(double *values, std::size_t n) {
+  for (std::size_t first = 0; first < n; first += max_chunk) {
+    const int count = std::min(max_chunk, n - first);
+    MPI_Allreduce(MPI_IN_PLACE, values + first, count, MPI_DOUBLE, MPI_SUM,
+                  comm_);
+  }
+}
+
+void MpiEnsembleCommunicator::combine_or(char *flags, std::size_t n) {
+  for (std::size_t first = 0; first < n; first += max_chunk) {
+    const int count = std::min(max_chunk, n - first);
+    MPI_Allreduce(MPI_IN_PLACE, flags + first, count, MPI_BYTE, MPI_BOR,
+                  comm_);
+  }
+}
+
+}  // namespace smash
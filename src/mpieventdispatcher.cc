@@ -0,0 +1,93 @@
+/*
+ *
+ *    Copyright (c) 2024
+ *      SMASH Team
+ *
+ *    GNU General Public License (GPLv3 or later)
+ *
+ */
+
+#include "smash/mpieventdispatcher.h"
+
+#include <algorithm>
+#include <fstream>
+#include <numeric>
+#include <stdexcept>
+#include <string>
+#include <utility>
+
+namespace smash {
+
+MpiEventDispatcher::MpiEventDispatcher(MPI_Comm comm) : comm_(comm) {
+  MPI_Comm_rank(comm_, &rank_);
+  MPI_Comm_size(comm_, &size_);
+  const MPI_Aint n_counters = rank_ == 0 ? 2 : 0;
+  MPI_Win_allocate(n_counters * sizeof(std::int64_t), sizeof(std::int64_t),
+                   MPI_INFO_NULL, comm_, &counters_, &window_);
+  if (rank_ == 0) {
+    MPI_Win_lock(MPI_LOCK_EXCLUSIVE, 0, 0, window_);
+    counters_[0] = 0;
+    counters_[1] = 0;
+    MPI_Win_unlock(0, window_);
+  }
+  // No event is taken before the counters are set
+  MPI_Barrier(comm_);
+}
+
+MpiEventDispatcher::~MpiEventDispatcher() { MPI_Win_free(&window_); }
+
+int MpiEventDispatcher::take_event(int nonempty_ensembles,
+                                   int &nonempty_total) {
+  const std::int64_t increments[2] = {1, nonempty_ensembles};
+  std::int64_t before[2];
+  MPI_Win_lock(MPI_LOCK_SHARED, 0, 0, window_);
+  MPI_Fetch_and_op(&increments[0], &before[0], MPI_INT64_T, 0, 0, MPI_SUM,
+                   window_);
+  MPI_Fetch_and_op(&increments[1], &before[1], MPI_INT64_T, 0, 1, MPI_SUM,
+                   window_);
+  MPI_Win_unlock(0, window_);
+  nonempty_total = before[1] + nonempty_ensembles;
+  return before[0];
+}
+
+void MpiEventDispatcher::write_event_index(
+    const std::filesystem::path &filename,
+    const std::vector<int> &events) const {
+  const int n_events = events.size();
+  std::vector<int> counts(rank_ == 0 ? size_ : 0);
+  MPI_Gather(&n_events, 1, MPI_INT, counts.data(), 1, MPI_INT, 0, comm_);
+  std::vector<int> offsets(counts.size(), 0);
+  if (rank_ == 0) {
+    std::partial_sum(counts.begin(), counts.end() - 1, offsets.begin() + 1);
+  }
+  std::vector<int> all_events(rank_ == 0 ? offsets.back() + counts.back()
+                                         : 0);
+  MPI_Gatherv(events.data(), n_events, MPI_INT, all_events.data(),
+              counts.data(), offsets.data(), MPI_INT, 0, comm_);
+  if (rank_ != 0) {
+    return;
+  }
+  std::vector<std::pair<int, int>> event_ranks;
+  event_ranks.reserve(all_events.size());
+  for (int rank = 0; rank < size_; rank++) {
+    for (int i = offsets[rank]; i < offsets[rank] + counts[rank]; i++) {
+      event_ranks.emplace_back(all_events[i], rank);
+    }
+  }
+  std::sort(event_ranks.begin(), event_ranks.end());
+  std::ofstream out(filename);
+  out << "# event directory\n";
+  for (const auto &[event, rank] : event_ranks) {
+    out << event << ' ' << directory(rank).native() << '\n';
+  }
+  if (!out) {
+    throw std::runtime_error("Could not write the event index " +
+                             filename.native() + ".");
+  }
+}
+
+std::filesystem::path MpiEventDispatcher::directory(int rank) {
+  return "rank_" + std::to_string(rank);
+}
+
+}  // namespace smash
@@ -1,5 +1,5 @@
 /*
- *    Copyright (c) 2014-2023
+ *    Copyright (c) 2014-2024
  *      SMASH Team
  *
  *    GNU General Public License (GPLv3 or later)
@@ -10,7 +10,10 @@
 #include <iostream>
 #include <limits>
 #include <map>
+#include <mutex>
 #include <string>
+#include <typeinfo>
+#include <utility>
 
 #include "smash/angles.h"
 #include "smash/constants.h"
@@ -85,132 +88,14 @@ double Nucleus::mass() const {
  * \f[\frac{dN}{4\pi\rho_0dr} =
  * \frac{r^2}{\exp\left(\frac{r-r_0}{d}\right) + 1}.\f]
  *
- * Let us rewrite that in units of \f$d\f$ (that's the diffusiveness)
- * and drop any constraints on normalization (since in the end we only
- * care about relative probabilities: we create as many nucleons as we
- * need). Now, \f$p(B)\f$ is the un-normalized probability to obtain a
- * point at \f$r = Bd\f$ (with \f$R = r_0/d\f$):
- *
- * \f[p(B) = \frac{B^2}{\exp(B-R) + 1}.\f]
- *
- * Splitting it up in two regimes
- * ------------------------------
- *
- * We shift the distribution so that \f$B-R\f$ is 0 at \f$t = 0\f$: \f$t
- * = B-R\f$:
- *
- * \f[p^{(1)}(t)= \frac{(t+R)^2}{\exp(t)+1}\f]
- *
- * and observe
- *
- * \f[\frac{1}{\exp(x)+1} = \frac{e^{-x}}{e^{-x}e^{x}+e^{-x}} =
- * \frac{e^{-x}}{e^{-x}+1}.\f]
- *
- * The distribution function can now be split into two cases. For
- * negative t (first case), \f$-|t| = t\f$, and for positive t (second
- * case), \f$-|t| = -t\f$:
- *
- * \f[p^{(1)}(t) = \frac{1}{e^{-|t|}+1} \cdot (t+R)^2 \cdot
- * \begin{cases}
- * 1 & -R \le t < 0 \\
- * e^{-t} & t \ge 0
- * \end{cases}.\f]
- *
- * Apart from the first term, all that remains here can easily and
- * exactly be generated from unrejected uniform random numbers (see
- * below). The first term itself - \f$(1+e^{-|t|})^{-1}\f$ - is a number
- * between 1/2 and 1.
- *
- * If we now have a variable \f$t\f$ distributed according to the
- * remainder, \f$p^{(2)}(t)\f$, and reject \f$t\f$ with a probability
- * \f$p^{(rej)}(t) = 1 - p^{(survive)}(t) = 1 - (1+e^{-|t|})^{-1}\f$,
- * the resulting distribution is \f$p^{(combined)}(t) = p^{(2)}(t) \cdot
- * p^{(survive)}(t)\f$. Hence, we need to generate \f$p^{(2)}(t)\f$,
- * which we can normalize to
- *
- * \f[\tilde{p}^{(2)}(t) = \frac{1}{1+3/R+6/R^2+6/R^3} \cdot \begin{cases}
- * \frac{3}{R^3} (t+R)^2 & -R \le t < 0 \\
- * e^{-t} \left( \frac{3}{R}+\frac{6}{R^2}t+\frac{6}{R^3}\frac{1}{2}t^2 \right)
- * & t \ge 0 \end{cases}.\f]
- *
- * (the tilde \f$\tilde{p}\f$ means that this is normalized).
- *
- * Four parts inside the rejection
- * -------------------------------
- *
- * Let \f$c_1 = 1+3/R+6/R^2+6/R^3\f$. The above means:
- *
- * \f[\mbox{Choose: } \begin{cases}
- * \tilde p^{({\rm I})} = \frac{3}{R^3}(t+R)^2 \Theta(-t) \Theta(t+R) \\
- * \tilde p^{({\rm II})}= e^{-t}\Theta(t) \\
- * \tilde p^{({\rm III})}=e^{-t}\Theta(t) t \\
- * \tilde p^{({\rm IV})} =e^{-t}\Theta(t) \frac{1}{2} t^2
- * \end{cases} \mbox{ with a probability of }\begin{cases}
- * \frac{1}{c_1} \cdot 1 \\
- * \frac{1}{c_1} \cdot \frac{3}{R} \\
- * \frac{1}{c_1} \cdot \frac{6}{R^2} \\
- * \frac{1}{c_1} \cdot \frac{6}{R^3}
- * \end{cases}.\f]
- *
- * Let us see how those are generated. \f$\chi_i\f$ are uniformly
- * distributed numbers between 0 and 1.
- *
- * \f[p(\chi_i) = \Theta(\chi_i)\Theta(1-\chi_i)\f]
- *
- * For simple distributions (only one \f$\chi\f$ involved), we invert
- * \f$t(\chi)\f$, derive it w.r.t. \f$t\f$ and normalize.
- *
- * ### Case I: \f$p^{({\rm I})}\f$
- *
- * Simply from one random number:
- *
- * \f[t = R\left( \sqrt[ 3 ]{\chi} - 1 \right)\f]
- * \f[\tilde p^{({\rm I})} = \frac{3}{R^3}(t+R)^2 \mbox{ for } -R \le t
- * \le 0\f]
- *
- * ### Case II: \f$p^{({\rm II})}\f$
- *
- * Again, from one only:
- *
- * \f[t = -\log(\chi)\f]
- * \f[p(t) = \frac{d\chi}{dt}\f]
- * \f[p^{({\rm II})} = e^{-t} \mbox{ for } t > 0\f]
- *
- * ### Case III: \f$p^{({\rm III})}\f$
- *
- * Here, we need two variables:
- *
- * \f[t = -\log{\chi_1} -\log{\chi_2}\f]
- *
- * \f$p^{({\rm III})}\f$ is now the folding of \f$p^{({\rm II})}\f$ with
- *itself[1]:
- *
- * \f[p^{({\rm III})} = \int_{-\infty}^{\infty} d\tau e^{-\tau} e^{-(t-\tau)}
- * \Theta(\tau) \Theta(t-\tau) = t e^{-t} \mbox{ for } t > 0\f]
- *
- * ### Case IV: \f$p^{({\rm IV})}\f$
- *
- * Three variables needed:
- *
- * \f[t = -\log{\chi_1} -\log{\chi_2} -\log{\chi_3}\f]
- *
- * \f$p^{({\rm IV})}\f$ is now the folding of \f$p^{({\rm II})}\f$ with
- * \f$p^{({\rm III})}\f$:
- *
- * \f[p^{({\rm IV})} = \int_{ - \infty}^{\infty} d\tau e^{- \tau} \left(
- * t - \tau \right) e^{ - (t - \tau)} \Theta(\tau) \Theta(t - \tau) =
- * \frac{1}{2} t^2 e^{ -t} \mbox{ for } t > 0\f]
- *
- * [1]: This is [the probability to find a \f$\tau\f$] times [the
- * probability to find the value \f$\tau_2 = t-\tau\f$ that added to
- * \f$\tau\f$ yields \f$t\f$], integrated over all possible combinations
- * that have that property.
- *
- * From the beginning
- * ------------------
- *
- *  So, the algorithm needs to do all this from the end:
+ * Sampling
+ * --------
  *
+ * The radial distribution does not change between events, so it is
+ * tabulated once on fine bins up to \f$r_0 + 20d\f$, beyond which the
+ * remaining probability is negligible, and the radius is obtained by
+ * inverting the tabulated cumulative distribution. Unlike a rejection
+ * method, this needs exactly one random number for the radius.
  */
 ThreeVector Nucleus::distribute_nucleon() {
   // Get the solid angle of the nucleon.
@@ -223,39 +108,15 @@ ThreeVector Nucleus::distribute_nucleon() {
   if (almost_equal(nuclear_radius_, 0.)) {
     return smash::ThreeVector();
   }
-  double radius_scaled = nuclear_radius_ / diffusiveness_;
-  double prob_range1 = 1.0;
-  double prob_range2 = 3. / radius_scaled;
-  double prob_range3 = 2. * prob_range2 / radius_scaled;
-  double prob_range4 = 1. * prob_range3 / radius_scaled;
-  double ranges234 = prob_range2 + prob_range3 + prob_range4;
-  double t;
-  /// \li Decide which branch \f$\tilde p^{({\rm I - IV})}\f$ to go into
-  do {
-    double which_range = random::uniform(-prob_range1, ranges234);
-    if (which_range < 0.0) {
-      t = radius_scaled * (std::cbrt(random::canonical()) - 1.);
-    } else {
-      t = -std::log(random::canonical());
-      if (which_range >= prob_range2) {
-        t -= std::log(random::canonical());
-        if (which_range >= prob_range2 + prob_range3) {
-          t -= std::log(random::canonical());
-        }
-      }
-    }
-    /**
-     * \li Generate \f$t\f$ from the distribution in the respective
-     * branches
-     * \li \a Reject that number with a probability
-     * \f$1-(1+\exp(-|t|))^{-1}\f$ (the efficiency of this should be
-     * \f$\gg \frac{1}{2}\f$)
-     */
-  } while (random::canonical() > 1. / (1. + std::exp(-std::abs(t))));
-  /// \li Shift and rescale \f$t\f$ to \f$r = d\cdot t + r_0\f$
-  double position_scaled = t + radius_scaled;
-  double position = position_scaled * diffusiveness_;
-  return dir.threevec() * position;
+  const std::pair<double, double> parameters{nuclear_radius_, diffusiveness_};
+  if (radial_distribution_.empty() || tabulated_parameters_ != parameters) {
+    constexpr std::size_t n_bins = 2000;
+    radial_distribution_ = random::piecewise_constant_dist(
+        0., nuclear_radius_ + 20. * diffusiveness_, n_bins,
+        [this](double r) { return woods_saxon(r); });
+    tabulated_parameters_ = parameters;
+  }
+  return dir.threevec() * radial_distribution_();
 }
 
 double Nucleus::woods_saxon(double r) {
@@ -493,19 +354,48 @@ double Nucleus::nucleon_density_unnormalized(double r, double, double) const {
   return 1.0 / (std::exp((r - nuclear_radius_) / diffusiveness_) + 1.);
 }
 
+double Nucleus::density_integral(const std::string &kind,
+                                 const std::vector<double> &parameters,
+                                 const std::function<double()> &compute) {
+  static std::map<std::pair<std::string, std::vector<double>>, double>
+      integrals;
+  static std::mutex mutex;
+  const auto key = std::make_pair(kind, parameters);
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    const auto it = integrals.find(key);
+    if (it != integrals.end()) {
+      return it->second;
+    }
+  }
+  // Not locked while integrating, at worst the same integral is done twice
+  const double integral = compute();
+  std::lock_guard<std::mutex> lock(mutex);
+  integrals.emplace(key, integral);
+  return integral;
+}
+
 double Nucleus::calculate_saturation_density() const {
-  Integrator2d integrate;
-  // Transform integral from (0, oo) to (0, 1) via r = (1 - t) / t.
-  // To prevent overflow, the integration is only performed to t = 0.01 which
-  // corresponds to r = 99fm. Additionally the precision settings in the
-  // Integrator2d scheme are equally important. However both these point affect
-  // the result only after the seventh digit which should not be relevant here.
-  const auto result = integrate(0.01, 1, -1, 1, [&](double t, double cosx) {
-    const double r = (1 - t) / t;
-    return twopi * std::pow(r, 2.0) *
-           nucleon_density_unnormalized(r, cosx, 0.0) / std::pow(t, 2.0);
-  });
-  const auto rho0 = number_of_particles() / result.value();
+  // Derived nuclei may change the density, hence it is told apart by the type
+  const double integral = density_integral(
+      typeid(*this).name(), {nuclear_radius_, diffusiveness_}, [this]() {
+        Integrator2d integrate;
+        // Transform integral from (0, oo) to (0, 1) via r = (1 - t) / t.
+        // To prevent overflow, the integration is only performed to t = 0.01
+        // which corresponds to r = 99fm. Additionally the precision settings
+        // in the Integrator2d scheme are equally important. However both
+        // these point affect the result only after the seventh digit which
+        // should not be relevant here.
+        const auto result =
+            integrate(0.01, 1, -1, 1, [&](double t, double cosx) {
+              const double r = (1 - t) / t;
+              return twopi * std::pow(r, 2.0) *
+                     nucleon_density_unnormalized(r, cosx, 0.0) /
+                     std::pow(t, 2.0);
+            });
+        return result.value();
+      });
+  const auto rho0 = number_of_particles() / integral;
   return rho0;
 }
 
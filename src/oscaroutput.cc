@@ -1,6 +1,6 @@
 /*
  *
- *    Copyright (c) 2014-2023
+ *    Copyright (c) 2014-2024
  *      SMASH Team
  *
  *    GNU General Public License (GPLv3 or later)
@@ -9,6 +9,8 @@
 
 #include "smash/oscaroutput.h"
 
+#include <charconv>
+#include <cstdio>
 #include <filesystem>
 #include <string>
 
@@ -22,11 +24,12 @@ static constexpr int LHyperSurfaceCrossing = LogArea::HyperSurfaceCrossing::id;
 
 template <OscarOutputFormat Format, int Contents>
 OscarOutput<Format, Contents>::OscarOutput(const std::filesystem::path &path,
-                                           const std::string &name)
+                                           const std::string &name,
+                                           bool compressed)
     : OutputInterface(name),
       file_{path /
                 (name + ".oscar" + ((Format == OscarFormat1999) ? "1999" : "")),
-            "w"} {
+            "w", compressed} {
   /*!\Userguide
    * \page doxypage_output_oscar
    * OSCAR outputs are a family of ASCII and binary formats that follow
@@ -120,6 +123,13 @@ inline void OscarOutput<Format, Contents>::write(const Particles &particles) {
   for (const ParticleData &data : particles) {
     write_particledata(data);
   }
+  write_lines();
+}
+
+template <OscarOutputFormat Format, int Contents>
+void OscarOutput<Format, Contents>::write_lines() {
+  std::fwrite(lines_.data(), 1, lines_.size(), file_.get());
+  lines_.clear();
 }
 
 template <OscarOutputFormat Format, int Contents>
@@ -180,7 +190,7 @@ void OscarOutput<Format, Contents>::at_eventend(const Particles &particles,
                  event.impact_parameter);
   }
   // Flush to disk
-  std::fflush(file_.get());
+  file_.flush();
 
   if (Contents & OscarParticlesIC) {
     // If the runtime is too short some particles might not yet have
@@ -230,6 +240,7 @@ void OscarOutput<Format, Contents>::at_interaction(const Action &action,
       write_particledata(p);
     }
   }
+  write_lines();
 }
 
 template <OscarOutputFormat Format, int Contents>
@@ -742,35 +753,110 @@ void OscarOutput<Format, Contents>::at_intermediate_time(
  * that are printed.
  **/
 
+namespace {
+/// Size of the collected particle lines, beyond which they are written
+constexpr std::size_t lines_buffer_size = 1 << 16;
+
+/**
+ * Append a number and a space to a line, formatted like by std::printf with
+ * the conversion "%.<precision>g".
+ *
+ * \param[inout] line Line, to which the number is appended
+ * \param[in] value Number to be appended
+ * \param[in] precision Number of significant digits
+ */
+void append_general(std::string &line, double value, int precision = 6) {
+  char number[32];
+#ifdef __cpp_lib_to_chars
+  char *end = std::to_chars(number, number + sizeof(number), value,
+                            std::chars_format::general, precision)
+                  .ptr;
+#else
+  char *end =
+      number + std::snprintf(number, sizeof(number), "%.*g", precision, value);
+#endif
+  line.append(number, end);
+  line += ' ';
+}
+
+/**
+ * Append an integer and a space to a line.
+ *
+ * \param[inout] line Line, to which the number is appended
+ * \param[in] value Number to be appended
+ */
+void append_integer(std::string &line, int value) {
+  char number[16];
+  char *end = std::to_chars(number, number + sizeof(number), value).ptr;
+  line.append(number, end);
+  line += ' ';
+}
+
+/**
+ * Append a PDG code as decimal number and a space to a line.
+ *
+ * \param[inout] line Line, to which the code is appended
+ * \param[in] pdg PDG code to be appended
+ */
+void append_pdgcode(std::string &line, PdgCode pdg) {
+  char number[PdgCode::max_chars];
+  line.append(number, pdg.to_chars(number));
+  line += ' ';
+}
+}  // unnamed namespace
+
 template <OscarOutputFormat Format, int Contents>
 void OscarOutput<Format, Contents>::write_particledata(
     const ParticleData &data) {
-  const FourVector pos = data.position();
-  const FourVector mom = data.momentum();
-  if (Format == OscarFormat2013) {
-    std::fprintf(file_.get(), "%g %g %g %g %g %.9g %.9g %.9g %.9g %s %i %i\n",
-                 pos.x0(), pos.x1(), pos.x2(), pos.x3(), data.effective_mass(),
-                 mom.x0(), mom.x1(), mom.x2(), mom.x3(),
-                 data.pdgcode().string().c_str(), data.id(),
-                 data.type().charge());
-  } else if (Format == OscarFormat2013Extended) {
-    const auto h = data.get_history();
-    std::fprintf(
-        file_.get(),
-        "%g %g %g %g %g %.9g %.9g %.9g"
-        " %.9g %s %i %i %i %g %g %i %i %g %s %s %i %i\n",
-        pos.x0(), pos.x1(), pos.x2(), pos.x3(), data.effective_mass(), mom.x0(),
-        mom.x1(), mom.x2(), mom.x3(), data.pdgcode().string().c_str(),
-        data.id(), data.type().charge(), h.collisions_per_particle,
-        data.formation_time(), data.xsec_scaling_factor(), h.id_process,
-        static_cast<int>(h.process_type), h.time_last_collision,
-        h.p1.string().c_str(), h.p2.string().c_str(),
-        data.type().baryon_number(), data.type().strangeness());
+  /* The numbers are formatted like "%g" and "%.9g" of std::printf, but
+   * without parsing a format string, and the lines are collected and written
+   * at once. */
+  const FourVector &pos = data.position();
+  const FourVector &mom = data.momentum();
+  if (Format == OscarFormat2013 || Format == OscarFormat2013Extended) {
+    for (int i = 0; i < 4; i++) {
+      append_general(lines_, pos[i]);
+    }
+    append_general(lines_, data.effective_mass());
+    for (int i = 0; i < 4; i++) {
+      append_general(lines_, mom[i], 9);
+    }
+    lines_ += data.type().pdgcode_string();
+    lines_ += ' ';
+    append_integer(lines_, data.id());
+    append_integer(lines_, data.type().charge());
+    if (Format == OscarFormat2013Extended) {
+      const auto &h = data.get_history();
+      append_integer(lines_, h.collisions_per_particle);
+      append_general(lines_, data.formation_time());
+      append_general(lines_, data.xsec_scaling_factor());
+      append_integer(lines_, h.id_process);
+      append_integer(lines_, static_cast<int>(h.process_type));
+      append_general(lines_, h.time_last_collision);
+      append_pdgcode(lines_, h.p1);
+      append_pdgcode(lines_, h.p2);
+      append_integer(lines_, data.type().baryon_number());
+      append_integer(lines_, data.type().strangeness());
+    }
   } else {
-    std::fprintf(file_.get(), "%i %s %i %g %g %g %g %g %g %g %g %g\n",
-                 data.id(), data.pdgcode().string().c_str(), 0, mom.x1(),
-                 mom.x2(), mom.x3(), mom.x0(), data.effective_mass(), pos.x1(),
-                 pos.x2(), pos.x3(), pos.x0());
+    append_integer(lines_, data.id());
+    lines_ += data.type().pdgcode_string();
+    lines_ += ' ';
+    append_integer(lines_, 0);
+    for (int i = 1; i < 4; i++) {
+      append_general(lines_, mom[i]);
+    }
+    append_general(lines_, mom.x0());
+    append_general(lines_, data.effective_mass());
+    for (int i = 1; i < 4; i++) {
+      append_general(lines_, pos[i]);
+    }
+    append_general(lines_, pos.x0());
+  }
+  // replace the last space by the end of the line
+  lines_.back() = '\n';
+  if (lines_.size() > lines_buffer_size) {
+    write_lines();
   }
 }
 
@@ -794,16 +880,19 @@ std::unique_ptr<OutputInterface> create_select_format(
                                                         : out_par.part_extended;
   if (modern_format && extended_format) {
     return std::make_unique<OscarOutput<OscarFormat2013Extended, Contents>>(
-        path, name);
+        path, name, out_par.compress_files);
   } else if (modern_format && !extended_format) {
-    return std::make_unique<OscarOutput<OscarFormat2013, Contents>>(path, name);
+    return std::make_unique<OscarOutput<OscarFormat2013, Contents>>(
+        path, name, out_par.compress_files);
   } else if (!modern_format && !extended_format) {
-    return std::make_unique<OscarOutput<OscarFormat1999, Contents>>(path, name);
+    return std::make_unique<OscarOutput<OscarFormat1999, Contents>>(
+        path, name, out_par.compress_files);
   } else {
     // Only remaining possibility: (!modern_format && extended_format)
     logg[LOutput].warn() << "Creating Oscar output: "
                          << "There is no extended Oscar1999 format.";
-    return std::make_unique<OscarOutput<OscarFormat1999, Contents>>(path, name);
+    return std::make_unique<OscarOutput<OscarFormat1999, Contents>>(
+        path, name, out_par.compress_files);
   }
 }
 }  // unnamed namespace
@@ -840,14 +929,14 @@ std::unique_ptr<OutputInterface> create_oscar_output(
   } else if (content == "Dileptons") {
     if (modern_format && out_par.dil_extended) {
       return std::make_unique<
-          OscarOutput<OscarFormat2013Extended, OscarInteractions>>(path,
-                                                                   "Dileptons");
+          OscarOutput<OscarFormat2013Extended, OscarInteractions>>(
+          path, "Dileptons", out_par.compress_files);
     } else if (modern_format && !out_par.dil_extended) {
       return std::make_unique<OscarOutput<OscarFormat2013, OscarInteractions>>(
-          path, "Dileptons");
+          path, "Dileptons", out_par.compress_files);
     } else if (!modern_format && !out_par.dil_extended) {
       return std::make_unique<OscarOutput<OscarFormat1999, OscarInteractions>>(
-          path, "Dileptons");
+          path, "Dileptons", out_par.compress_files);
     } else if (!modern_format && out_par.dil_extended) {
       logg[LOutput].warn()
           << "Creating Oscar output: "
@@ -856,14 +945,14 @@ std::unique_ptr<OutputInterface> create_oscar_output(
   } else if (content == "Photons") {
     if (modern_format && !out_par.photons_extended) {
       return std::make_unique<OscarOutput<OscarFormat2013, OscarInteractions>>(
-          path, "Photons");
+          path, "Photons", out_par.compress_files);
     } else if (modern_format && out_par.photons_extended) {
       return std::make_unique<
-          OscarOutput<OscarFormat2013Extended, OscarInteractions>>(path,
-                                                                   "Photons");
+          OscarOutput<OscarFormat2013Extended, OscarInteractions>>(
+          path, "Photons", out_par.compress_files);
     } else if (!modern_format && !out_par.photons_extended) {
       return std::make_unique<OscarOutput<OscarFormat1999, OscarInteractions>>(
-          path, "Photons");
+          path, "Photons", out_par.compress_files);
     } else if (!modern_format && out_par.photons_extended) {
       logg[LOutput].warn()
           << "Creating Oscar output: "
@@ -873,15 +962,15 @@ std::unique_ptr<OutputInterface> create_oscar_output(
     if (modern_format && !out_par.ic_extended) {
       return std::make_unique<
           OscarOutput<OscarFormat2013, OscarParticlesIC | OscarAtEventstart>>(
-          path, "SMASH_IC");
+          path, "SMASH_IC", out_par.compress_files);
     } else if (modern_format && out_par.ic_extended) {
       return std::make_unique<OscarOutput<
           OscarFormat2013Extended, OscarParticlesIC | OscarAtEventstart>>(
-          path, "SMASH_IC");
+          path, "SMASH_IC", out_par.compress_files);
     } else if (!modern_format && !out_par.ic_extended) {
       return std::make_unique<
           OscarOutput<OscarFormat1999, OscarParticlesIC | OscarAtEventstart>>(
-          path, "SMASH_IC");
+          path, "SMASH_IC", out_par.compress_files);
     } else if (!modern_format && out_par.ic_extended) {
       logg[LOutput].warn()
           << "Creating Oscar output: "
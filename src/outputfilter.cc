@@ -0,0 +1,318 @@
+/*
+ *
+ *    Copyright (c) 2024
+ *      SMASH Team
+ *
+ *    GNU General Public License (GPLv3 or later)
+ *
+ */
+
+#include "smash/outputfilter.h"
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#include <utility>
+
+#include "smash/action.h"
+#include "smash/configuration.h"
+
+namespace smash {
+
+namespace {
+/**
+ * Take a range from the filter section.
+ *
+ * \param[in] conf The `Filter` section
+ * \param[in] key Name of the range
+ * \param[out] range The range, if given
+ * \return whether the range is given
+ * \throw std::invalid_argument if the range is empty
+ */
+bool take_range(Configuration &conf, const char *key,
+                std::array<double, 2> &range) {
+  if (!conf.has_value({key})) {
+    return false;
+  }
+  range = conf.take({key});
+  if (!(range[0] <= range[1])) {
+    throw std::invalid_argument(std::string("The output filter range ") +
+                                key + " is empty.");
+  }
+  return true;
+}
+
+/// \return whether \p x is within \p range, including the limits
+bool within(double x, const std::array<double, 2> &range) {
+  return range[0] <= x && x <= range[1];
+}
+
+/// \return whether the sorted \p values are empty or contain \p value
+template <typename T>
+bool empty_or_contains(const std::vector<T> &values, const T &value) {
+  return values.empty() ||
+         std::binary_search(values.begin(), values.end(), value);
+}
+}  // namespace
+
+OutputFilter::OutputFilter(Configuration conf) {
+  pdg_codes_ = conf.take({"PDG"}, std::vector<PdgCode>{});
+  std::sort(pdg_codes_.begin(), pdg_codes_.end());
+  const bool cuts_rapidity = take_range(conf, "Rapidity", rapidity_);
+  const bool cuts_pseudorapidity =
+      take_range(conf, "Pseudorapidity", pseudorapidity_);
+  const bool cuts_transverse_momentum =
+      take_range(conf, "Transverse_Momentum", transverse_momentum_);
+  cuts_momentum_ =
+      cuts_rapidity || cuts_pseudorapidity || cuts_transverse_momentum;
+  process_types_ = conf.take({"Process_Types"}, std::vector<int>{});
+  std::sort(process_types_.begin(), process_types_.end());
+  ensembles_ = conf.take({"Ensembles"}, std::vector<int>{});
+  std::sort(ensembles_.begin(), ensembles_.end());
+  every_nth_event_ = conf.take({"Every_Nth_Event"}, 1);
+  if (every_nth_event_ < 1) {
+    throw std::invalid_argument(
+        "The output filter needs a positive Every_Nth_Event.");
+  }
+}
+
+bool OutputFilter::is_active() const {
+  return filters_particles() || !process_types_.empty() ||
+         !ensembles_.empty() || every_nth_event_ > 1;
+}
+
+bool OutputFilter::selects_ensemble(int ensemble) const {
+  return empty_or_contains(ensembles_, ensemble);
+}
+
+bool OutputFilter::selects(const ParticleData &p) const {
+  if (!empty_or_contains(pdg_codes_, p.pdgcode())) {
+    return false;
+  }
+  if (!cuts_momentum_) {
+    return true;
+  }
+  const FourVector &momentum = p.momentum();
+  const double pt = std::hypot(momentum.x1(), momentum.x2());
+  const double pz = momentum.x3();
+  // The pseudorapidity of a particle at rest is taken to be zero
+  const double eta = pt > 0. || pz != 0. ? std::asinh(pz / pt) : 0.;
+  return within(std::atanh(pz / momentum.x0()), rapidity_) &&
+         within(eta, pseudorapidity_) && within(pt, transverse_momentum_);
+}
+
+bool OutputFilter::selects(const Action &action) const {
+  if (!empty_or_contains(process_types_,
+                         static_cast<int>(action.get_type()))) {
+    return false;
+  }
+  if (!filters_particles()) {
+    return true;
+  }
+  auto selected = [this](const ParticleData &p) { return selects(p); };
+  return std::any_of(action.incoming_particles().begin(),
+                     action.incoming_particles().end(), selected) ||
+         std::any_of(action.outgoing_particles().begin(),
+                     action.outgoing_particles().end(), selected);
+}
+
+FilteredOutput::FilteredOutput(OutputPtr target, const OutputFilter &filter,
+                               int n_ensembles)
+    : OutputInterface("Filtered"),
+      target_(std::move(target)),
+      filter_(filter),
+      n_ensembles_(n_ensembles) {}
+
+const Particles &FilteredOutput::select(const Particles &particles) {
+  if (!filter_.filters_particles()) {
+    return particles;
+  }
+  selected_.copy_from(particles, [this](const ParticleData &p) {
+    return filter_.selects(p);
+  });
+  return selected_;
+}
+
+const std::vector<Particles> &FilteredOutput::select(
+    const std::vector<Particles> &ensembles) {
+  std::vector<int> indices;
+  for (int i = 0; i < static_cast<int>(ensembles.size()); i++) {
+    if (filter_.selects_ensemble(i)) {
+      indices.push_back(i);
+    }
+  }
+  if (indices.size() == ensembles.size() && !filter_.filters_particles()) {
+    return ensembles;
+  }
+  if (selected_ensembles_.size() != indices.size()) {
+    selected_ensembles_ = std::vector<Particles>(indices.size());
+  }
+  for (std::size_t i = 0; i < indices.size(); i++) {
+    selected_ensembles_[i].copy_from(
+        ensembles[indices[i]],
+        [this](const ParticleData &p) { return filter_.selects(p); });
+  }
+  return selected_ensembles_;
+}
+
+void FilteredOutput::at_eventstart(const Particles &particles,
+                                   const int event_number,
+                                   const EventInfo &info) {
+  // Every ensemble is numbered as an event of its own
+  event_selected_ = filter_.selects_event(event_number / n_ensembles_);
+  next_ensemble_ = 0;
+  if (event_selected_ &&
+      filter_.selects_ensemble(event_number % n_ensembles_)) {
+    target_->at_eventstart(select(particles), event_number, info);
+  }
+}
+
+void FilteredOutput::at_eventstart(const std::vector<Particles> &ensembles,
+                                   int event_number) {
+  event_selected_ = filter_.selects_event(event_number);
+  next_ensemble_ = 0;
+  if (event_selected_) {
+    target_->at_eventstart(select(ensembles), event_number);
+  }
+}
+
+void FilteredOutput::at_eventstart(
+    const int event_number, const ThermodynamicQuantity tq,
+    const DensityType dens_type, RectangularLattice<DensityOnLattice> lattice) {
+  if (filter_.selects_event(event_number)) {
+    target_->at_eventstart(event_number, tq, dens_type, std::move(lattice));
+  }
+}
+
+void FilteredOutput::at_eventstart(
+    const int event_number, const ThermodynamicQuantity tq,
+    const DensityType dens_type,
+    RectangularLattice<EnergyMomentumTensor> lattice) {
+  if (filter_.selects_event(event_number)) {
+    target_->at_eventstart(event_number, tq, dens_type, std::move(lattice));
+  }
+}
+
+void FilteredOutput::at_eventend(const int event_number,
+                                 const ThermodynamicQuantity tq,
+                                 const DensityType dens_type) {
+  if (filter_.selects_event(event_number)) {
+    target_->at_eventend(event_number, tq, dens_type);
+  }
+}
+
+void FilteredOutput::at_eventend(const ThermodynamicQuantity tq) {
+  if (event_selected_) {
+    target_->at_eventend(tq);
+  }
+}
+
+void FilteredOutput::at_eventend(const Particles &particles,
+                                 const int event_number,
+                                 const EventInfo &info) {
+  if (filter_.selects_event(event_number / n_ensembles_) &&
+      filter_.selects_ensemble(event_number % n_ensembles_)) {
+    target_->at_eventend(select(particles), event_number, info);
+  }
+}
+
+void FilteredOutput::at_eventend(const std::vector<Particles> &ensembles,
+                                 const int event_number) {
+  if (filter_.selects_event(event_number)) {
+    target_->at_eventend(select(ensembles), event_number);
+  }
+}
+
+void FilteredOutput::at_runend() { target_->at_runend(); }
+
+void FilteredOutput::at_interaction(const Action &action,
+                                    const double density) {
+  if (event_selected_ && filter_.selects(action)) {
+    target_->at_interaction(action, density);
+  }
+}
+
+void FilteredOutput::at_intermediate_time(const Particles &particles,
+                                          const std::unique_ptr<Clock> &clock,
+                                          const DensityParameters &dens_param,
+                                          const EventInfo &info) {
+  const int ensemble = next_ensemble_++;
+  if (event_selected_ && filter_.selects_ensemble(ensemble)) {
+    target_->at_intermediate_time(select(particles), clock, dens_param, info);
+  }
+}
+
+void FilteredOutput::at_intermediate_time(
+    const std::vector<Particles> &ensembles,
+    const std::unique_ptr<Clock> &clock, const DensityParameters &dens_param) {
+  next_ensemble_ = 0;
+  if (event_selected_) {
+    target_->at_intermediate_time(select(ensembles), clock, dens_param);
+  }
+}
+
+void FilteredOutput::thermodynamics_output(
+    const ThermodynamicQuantity tq, const DensityType dens_type,
+    RectangularLattice<DensityOnLattice> &lattice) {
+  if (event_selected_) {
+    target_->thermodynamics_output(tq, dens_type, lattice);
+  }
+}
+
+void FilteredOutput::thermodynamics_output(
+    const ThermodynamicQuantity tq, const DensityType dens_type,
+    RectangularLattice<EnergyMomentumTensor> &lattice) {
+  if (event_selected_) {
+    target_->thermodynamics_output(tq, dens_type, lattice);
+  }
+}
+
+void FilteredOutput::thermodynamics_lattice_output(
+    RectangularLattice<DensityOnLattice> &lattice, const double current_time) {
+  if (event_selected_) {
+    target_->thermodynamics_lattice_output(lattice, current_time);
+  }
+}
+
+void FilteredOutput::thermodynamics_lattice_output(
+    RectangularLattice<DensityOnLattice> &lattice, const double current_time,
+    const std::vector<Particles> &ensembles,
+    const DensityParameters &dens_param) {
+  if (event_selected_) {
+    target_->thermodynamics_lattice_output(lattice, current_time, ensembles,
+                                           dens_param);
+  }
+}
+
+void FilteredOutput::thermodynamics_lattice_output(
+    const ThermodynamicQuantity tq,
+    RectangularLattice<EnergyMomentumTensor> &lattice,
+    const double current_time) {
+  if (event_selected_) {
+    target_->thermodynamics_lattice_output(tq, lattice, current_time);
+  }
+}
+
+void FilteredOutput::thermodynamics_output(const GrandCanThermalizer &gct) {
+  if (event_selected_) {
+    target_->thermodynamics_output(gct);
+  }
+}
+
+void FilteredOutput::fields_output(const std::string name1,
+                                   const std::string name2,
+                                   ForceLattice &lattice) {
+  if (event_selected_) {
+    target_->fields_output(name1, name2, lattice);
+  }
+}
+
+std::size_t FilteredOutput::buffer_size() const {
+  std::size_t bytes = target_->buffer_size() + selected_.memory_usage();
+  for (const Particles &particles : selected_ensembles_) {
+    bytes += particles.memory_usage();
+  }
+  return bytes;
+}
+
+}  // namespace smash
@@ -0,0 +1,347 @@
+/*
+ *
+ *    Copyright (c) 2024
+ *      SMASH Team
+ *
+ *    GNU General Public License (GPLv3 or later)
+ *
+ */
+
+#include "smash/outputmerger.h"
+
+#include <cstdint>
+#include <stdexcept>
+#include <utility>
+
+#include "smash/action.h"
+#include "smash/clock.h"
+#include "smash/particles.h"
+
+namespace smash {
+
+namespace {
+/**
+ * \param[in] target Output to stand in for
+ * \return Name of an output of the same kind as \p target.
+ */
+std::string name_of_same_kind(const OutputInterface &target) {
+  if (target.is_dilepton_output()) {
+    return "Dileptons";
+  } else if (target.is_photon_output()) {
+    return "Photons";
+  } else if (target.is_IC_output()) {
+    return "SMASH_IC";
+  }
+  return "Deferred";
+}
+
+/**
+ * \param[in] particles Particles to be copied
+ * \return A copy of the particles, keeping their ids, which is shared with
+ *         the other outputs at the same epoch, see Particles::snapshot.
+ */
+std::shared_ptr<const Particles> snapshot(const Particles &particles) {
+  return particles.snapshot();
+}
+
+/**
+ * Like the particles of an ensemble, the copy of all ensembles is shared by
+ * the outputs as long as they keep it and the ensembles are not modified.
+ * Every thread keeps the copy it made last, since each event worker writes
+ * to its own outputs.
+ *
+ * \param[in] ensembles Ensembles to be copied
+ * \return A copy of all ensembles, keeping the particle ids.
+ */
+std::shared_ptr<const std::vector<Particles>> snapshot(
+    const std::vector<Particles> &ensembles) {
+  thread_local std::vector<std::uint64_t> last_epochs;
+  thread_local std::weak_ptr<const std::vector<Particles>> last_copy;
+  std::vector<std::uint64_t> epochs(ensembles.size());
+  for (std::size_t i = 0; i < ensembles.size(); i++) {
+    epochs[i] = ensembles[i].epoch();
+  }
+  std::shared_ptr<const std::vector<Particles>> shared = last_copy.lock();
+  if (shared && epochs == last_epochs) {
+    return shared;
+  }
+  auto copy = std::make_shared<std::vector<Particles>>(ensembles.size());
+  for (std::size_t i = 0; i < ensembles.size(); i++) {
+    (*copy)[i].copy_from(ensembles[i]);
+  }
+  last_epochs = std::move(epochs);
+  last_copy = copy;
+  return copy;
+}
+
+/**
+ * Outputs only ask a clock for the current time, which is all that is kept.
+ *
+ * \param[in] clock Clock to be copied
+ * \return A clock showing the same current time.
+ */
+std::shared_ptr<const std::unique_ptr<Clock>> snapshot(
+    const std::unique_ptr<Clock> &clock) {
+  auto copy = std::make_unique<CustomClock>(std::vector<double>{});
+  copy->reset(clock->current_time(), false);
+  return std::make_shared<const std::unique_ptr<Clock>>(std::move(copy));
+}
+
+/**
+ * An action which was already performed, keeping everything that outputs ask
+ * for.
+ */
+class PerformedAction : public Action {
+ public:
+  /**
+   * Copy the outcome of an action.
+   * \param[in] action Performed action
+   */
+  explicit PerformedAction(const Action &action)
+      : Action(action.incoming_particles(), action.outgoing_particles(),
+               action.time_of_execution(), action.get_type()),
+        total_weight_(action.get_total_weight()),
+        partial_weight_(action.get_partial_weight()) {}
+  double get_total_weight() const override { return total_weight_; }
+  double get_partial_weight() const override { return partial_weight_; }
+  void generate_final_state() override {}
+  void format_debug_output(std::ostream &out) const override {
+    out << "Performed " << get_type() << " of " << incoming_particles_
+        << " to " << outgoing_particles_;
+  }
+
+ private:
+  /// Total weight of the original action
+  const double total_weight_;
+  /// Partial weight of the original action
+  const double partial_weight_;
+};
+}  // namespace
+
+DeferredOutput::DeferredOutput(const OutputInterface &target)
+    : OutputInterface(name_of_same_kind(target)) {}
+
+void DeferredOutput::at_eventstart(const Particles &particles,
+                                   const int event_number,
+                                   const EventInfo &info) {
+  record([copy = snapshot(particles), event_number,
+          info](OutputInterface &output) {
+    output.at_eventstart(*copy, event_number, info);
+  });
+}
+
+void DeferredOutput::at_eventstart(const std::vector<Particles> &ensembles,
+                                   int event_number) {
+  record([copy = snapshot(ensembles), event_number](OutputInterface &output) {
+    output.at_eventstart(*copy, event_number);
+  });
+}
+
+void DeferredOutput::at_eventstart(
+    const int event_number, const ThermodynamicQuantity tq,
+    const DensityType dens_type, RectangularLattice<DensityOnLattice> lattice) {
+  record([event_number, tq, dens_type, lattice](OutputInterface &output) {
+    output.at_eventstart(event_number, tq, dens_type, lattice);
+  });
+}
+
+void DeferredOutput::at_eventstart(
+    const int event_number, const ThermodynamicQuantity tq,
+    const DensityType dens_type,
+    RectangularLattice<EnergyMomentumTensor> lattice) {
+  record([event_number, tq, dens_type, lattice](OutputInterface &output) {
+    output.at_eventstart(event_number, tq, dens_type, lattice);
+  });
+}
+
+void DeferredOutput::at_eventend(const int event_number,
+                                 const ThermodynamicQuantity tq,
+                                 const DensityType dens_type) {
+  record([event_number, tq, dens_type](OutputInterface &output) {
+    output.at_eventend(event_number, tq, dens_type);
+  });
+}
+
+void DeferredOutput::at_eventend(const ThermodynamicQuantity tq) {
+  record([tq](OutputInterface &output) { output.at_eventend(tq); });
+}
+
+void DeferredOutput::at_eventend(const Particles &particles,
+                                 const int event_number,
+                                 const EventInfo &info) {
+  record([copy = snapshot(particles), event_number,
+          info](OutputInterface &output) {
+    output.at_eventend(*copy, event_number, info);
+  });
+}
+
+void DeferredOutput::at_eventend(const std::vector<Particles> &ensembles,
+                                 const int event_number) {
+  record([copy = snapshot(ensembles), event_number](OutputInterface &output) {
+    output.at_eventend(*copy, event_number);
+  });
+}
+
+void DeferredOutput::at_runend() {
+  record([](OutputInterface &output) { output.at_runend(); });
+}
+
+void DeferredOutput::at_interaction(const Action &action,
+                                    const double density) {
+  record([copy = std::make_shared<const PerformedAction>(action),
+          density](OutputInterface &output) {
+    output.at_interaction(*copy, density);
+  });
+}
+
+void DeferredOutput::at_intermediate_time(const Particles &particles,
+                                          const std::unique_ptr<Clock> &clock,
+                                          const DensityParameters &dens_param,
+                                          const EventInfo &info) {
+  record([copy = snapshot(particles), clock = snapshot(clock), dens_param,
+          info](OutputInterface &output) {
+    output.at_intermediate_time(*copy, *clock, dens_param, info);
+  });
+}
+
+void DeferredOutput::at_intermediate_time(
+    const std::vector<Particles> &ensembles,
+    const std::unique_ptr<Clock> &clock, const DensityParameters &dens_param) {
+  record([copy = snapshot(ensembles), clock = snapshot(clock),
+          dens_param](OutputInterface &output) {
+    output.at_intermediate_time(*copy, *clock, dens_param);
+  });
+}
+
+void DeferredOutput::thermodynamics_output(
+    const ThermodynamicQuantity tq, const DensityType dens_type,
+    RectangularLattice<DensityOnLattice> &lattice) {
+  record([tq, dens_type, lattice](OutputInterface &output) mutable {
+    output.thermodynamics_output(tq, dens_type, lattice);
+  });
+}
+
+void DeferredOutput::thermodynamics_output(
+    const ThermodynamicQuantity tq, const DensityType dens_type,
+    RectangularLattice<EnergyMomentumTensor> &lattice) {
+  record([tq, dens_type, lattice](OutputInterface &output) mutable {
+    output.thermodynamics_output(tq, dens_type, lattice);
+  });
+}
+
+void DeferredOutput::thermodynamics_lattice_output(
+    RectangularLattice<DensityOnLattice> &lattice, const double current_time) {
+  record([lattice, current_time](OutputInterface &output) mutable {
+    output.thermodynamics_lattice_output(lattice, current_time);
+  });
+}
+
+void DeferredOutput::thermodynamics_lattice_output(
+    RectangularLattice<DensityOnLattice> &lattice, const double current_time,
+    const std::vector<Particles> &ensembles,
+    const DensityParameters &dens_param) {
+  record([lattice, current_time, copy = snapshot(ensembles),
+          dens_param](OutputInterface &output) mutable {
+    output.thermodynamics_lattice_output(lattice, current_time, *copy,
+                                         dens_param);
+  });
+}
+
+void DeferredOutput::thermodynamics_lattice_output(
+    const ThermodynamicQuantity tq,
+    RectangularLattice<EnergyMomentumTensor> &lattice,
+    const double current_time) {
+  record([tq, lattice, current_time](OutputInterface &output) mutable {
+    output.thermodynamics_lattice_output(tq, lattice, current_time);
+  });
+}
+
+void DeferredOutput::thermodynamics_output(const GrandCanThermalizer &) {
+  throw std::logic_error(
+      "The output of the thermalizer cannot be deferred to be written later.");
+}
+
+void DeferredOutput::fields_output(const std::string name1,
+                                   const std::string name2,
+                                   ForceLattice &lattice) {
+  record([name1, name2, lattice](OutputInterface &output) mutable {
+    output.fields_output(name1, name2, lattice);
+  });
+}
+
+void DeferredOutput::record(Call call) { calls_.emplace_back(std::move(call)); }
+
+std::vector<DeferredOutput::Call> DeferredOutput::take_calls() {
+  std::vector<Call> calls;
+  calls.swap(calls_);
+  return calls;
+}
+
+OutputMerger::OutputMerger(OutputsList &&outputs)
+    : outputs_(std::move(outputs)) {}
+
+OutputPtr OutputMerger::make_deferred_output(std::size_t index) const {
+  return std::make_unique<DeferredOutput>(*outputs_.at(index));
+}
+
+OutputsList OutputMerger::make_deferred_outputs() const {
+  OutputsList deferred_outputs;
+  for (std::size_t i = 0; i < outputs_.size(); i++) {
+    deferred_outputs.emplace_back(make_deferred_output(i));
+  }
+  return deferred_outputs;
+}
+
+void OutputMerger::submit(int event, const OutputsList &deferred_outputs,
+                          std::function<void()> bookkeeping) {
+  if (deferred_outputs.size() != outputs_.size()) {
+    throw std::invalid_argument(
+        "Number of deferred outputs does not match the outputs.");
+  }
+  PendingEvent pending{{}, std::move(bookkeeping)};
+  for (const OutputPtr &output : deferred_outputs) {
+    pending.calls.emplace_back(
+        dynamic_cast<DeferredOutput &>(*output).take_calls());
+  }
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (event > last_event_) {
+    return;
+  }
+  pending_.emplace(event, std::move(pending));
+  write_pending();
+}
+
+void OutputMerger::write_pending() {
+  while (!pending_.empty() && pending_.begin()->first == next_event_ &&
+         next_event_ <= last_event_) {
+    PendingEvent &pending = pending_.begin()->second;
+    if (pending.bookkeeping) {
+      pending.bookkeeping();
+    }
+    for (std::size_t i = 0; i < outputs_.size(); i++) {
+      for (const DeferredOutput::Call &call : pending.calls[i]) {
+        call(*outputs_[i]);
+      }
+    }
+    pending_.erase(pending_.begin());
+    next_event_++;
+  }
+  // Drop events which will never be written
+  pending_.erase(pending_.upper_bound(last_event_), pending_.end());
+}
+
+void OutputMerger::set_last_event(int event) {
+  int last_event = last_event_;
+  while (event < last_event &&
+         !last_event_.compare_exchange_weak(last_event, event)) {
+  }
+}
+
+bool OutputMerger::accepts(int event) const { return event <= last_event_; }
+
+int OutputMerger::written_events() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return next_event_;
+}
+
+}  // namespace smash
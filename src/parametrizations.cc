@@ -12,7 +12,6 @@
 #include <cmath>
 #include <initializer_list>
 #include <iostream>
-#include <memory>
 #include <set>
 #include <vector>
 
@@ -37,6 +36,103 @@ bool parametrization_exists(const PdgCode& pdg_a, const PdgCode& pdg_b) {
   return two_nucleons || nucleon_and_kaon || nucleon_and_pion || two_pions;
 }
 
+namespace {
+/**
+ * Average cross sections given more than once for one argument, smooth them
+ * with the LOWESS algorithm and interpolate them linearly.
+ *
+ * \param[in] x Arguments of the data
+ * \param[in] y Cross sections of the data [mb]
+ * \param[in] span Fraction of the data used for smoothing each point
+ * \param[in] iterations Number of robustifying iterations of the smoothing
+ * \return Interpolation of the smoothed data
+ */
+InterpolateDataLinear<double> smoothed_interpolation(
+    const std::vector<double>& x, const std::vector<double>& y, double span,
+    size_t iterations) {
+  auto [dedup_x, dedup_y] = dedup_avg<double>(x, y);
+  dedup_y = smooth(dedup_x, dedup_y, span, iterations);
+  return InterpolateDataLinear<double>(dedup_x, dedup_y);
+}
+
+/**
+ * \param[in] sqrts Center-of-mass energies [GeV]
+ * \param[in] m1 Mass of the projectile [GeV]
+ * \param[in] m2 Mass of the target [GeV]
+ * \return Momenta of the projectile in the rest frame of the target [GeV]
+ */
+std::vector<double> plab_from_sqrts(const std::vector<double>& sqrts,
+                                    double m1, double m2) {
+  std::vector<double> p_lab = sqrts;
+  for (auto& i : p_lab) {
+    i = plab_from_s(i * i, m1, m2);
+  }
+  return p_lab;
+}
+
+/**
+ * \param[in] sqrts Center-of-mass energies [GeV]
+ * \return Squared center-of-mass energies [GeV^2]
+ */
+std::vector<double> squared(const std::vector<double>& sqrts) {
+  std::vector<double> s = sqrts;
+  for (auto& i : s) {
+    i = i * i;
+  }
+  return s;
+}
+
+/// Resonance contributions to the pi- p cross section, averaged
+InterpolateDataSpline piminusp_res_interpolation() {
+  auto [dedup_x, dedup_y] = dedup_avg(squared(PIMINUSP_RES_SQRTS),
+                                      std::vector<double>(PIMINUSP_RES_SIG));
+  return InterpolateDataSpline(dedup_x, dedup_y);
+}
+}  // namespace
+
+ParametrizationTables::ParametrizationTables()
+    : pipluspiminus_total(smoothed_interpolation(
+          PIPLUSPIMINUS_TOT_SQRTS, PIPLUSPIMINUS_TOT_SIG, 0.01, 10)),
+      pizeropizero_total(smoothed_interpolation(
+          PIZEROPIZERO_TOT_SQRTS, PIZEROPIZERO_TOT_SIG, 0.01, 10)),
+      piplusp_total(smoothed_interpolation(PIPLUSP_TOT_SQRTS, PIPLUSP_TOT_SIG,
+                                           0.01, 10)),
+      piplusp_elastic(smoothed_interpolation(
+          PIPLUSP_ELASTIC_P_LAB, PIPLUSP_ELASTIC_SIG, 0.1, 5)),
+      piplusp_elastic_res(squared(PIPLUSP_RES_SQRTS), PIPLUSP_RES_SIG),
+      piplusp_sigmapluskplus(smoothed_interpolation(
+          PIPLUSP_SIGMAPLUSKPLUS_P_LAB, PIPLUSP_SIGMAPLUSKPLUS_SIG, 0.2, 5)),
+      piminusp_total(smoothed_interpolation(PIMINUSP_TOT_SQRTS,
+                                            PIMINUSP_TOT_SIG, 0.01, 6)),
+      piminusp_elastic(smoothed_interpolation(
+          PIMINUSP_ELASTIC_P_LAB, PIMINUSP_ELASTIC_SIG, 0.2, 6)),
+      piminusp_elastic_res(piminusp_res_interpolation()),
+      piminusp_lambdak0(smoothed_interpolation(
+          PIMINUSP_LAMBDAK0_P_LAB, PIMINUSP_LAMBDAK0_SIG, 0.2, 6)),
+      piminusp_sigmaminuskplus(
+          smoothed_interpolation(PIMINUSP_SIGMAMINUSKPLUS_P_LAB,
+                                 PIMINUSP_SIGMAMINUSKPLUS_SIG, 0.2, 6)),
+      piminusp_sigma0k0(smoothed_interpolation(
+          PIMINUSP_SIGMA0K0_RES_SQRTS, PIMINUSP_SIGMA0K0_RES_SIG, 0.2, 6)),
+      kplusp_total(
+          smoothed_interpolation(KPLUSP_TOT_PLAB, KPLUSP_TOT_SIG, 0.1, 5)),
+      kplusn_total(
+          smoothed_interpolation(KPLUSN_TOT_PLAB, KPLUSN_TOT_SIG, 0.05, 5)),
+      // Parametrization data is pre-smoothed
+      kminusp_total(
+          smoothed_interpolation(KMINUSP_TOT_PLAB, KMINUSP_TOT_SIG, 0.01, 5)),
+      kminusn_total(
+          smoothed_interpolation(KMINUSN_TOT_PLAB, KMINUSN_TOT_SIG, 0.05, 5)),
+      kminusp_elastic(smoothed_interpolation(
+          KMINUSP_ELASTIC_P_LAB, KMINUSP_ELASTIC_SIG, 0.1, 5)),
+      kminusp_elastic_res(
+          plab_from_sqrts(KMINUSP_RES_SQRTS, kaon_mass, nucleon_mass),
+          KMINUSP_RES_SIG) {}
+
+/* Built during the static initialization, after the data above, such that
+ * evaluating a parametrization does not check whether its data is ready. */
+const ParametrizationTables ParametrizationTables::instance_;
+
 double xs_high_energy(double mandelstam_s, bool is_opposite_charge, double ma,
                       double mb, double P, double R1, double R2) {
   const double M = 2.1206;
@@ -111,46 +207,25 @@ double pipi_string_hard(double mandelstam_s) {
 }
 
 double pipluspiminus_total(double sqrts) {
-  if (pipluspiminus_total_interpolation == nullptr) {
-    auto [dedup_x, dedup_y] =
-        dedup_avg<double>(PIPLUSPIMINUS_TOT_SQRTS, PIPLUSPIMINUS_TOT_SIG);
-    dedup_y = smooth(dedup_x, dedup_y, 0.01, 10);
-    pipluspiminus_total_interpolation =
-        std::make_unique<InterpolateDataLinear<double>>(dedup_x, dedup_y);
-  }
   const double last = *(PIPLUSPIMINUS_TOT_SQRTS.end() - 1);
   if (sqrts < last)
-    return (*pipluspiminus_total_interpolation)(sqrts);
+    return ParametrizationTables::get().pipluspiminus_total(sqrts);
   else
     return pipi_string_hard(sqrts * sqrts);
 }
 
 double pizeropizero_total(double sqrts) {
-  if (pizeropizero_total_interpolation == nullptr) {
-    auto [dedup_x, dedup_y] =
-        dedup_avg<double>(PIZEROPIZERO_TOT_SQRTS, PIZEROPIZERO_TOT_SIG);
-    dedup_y = smooth(dedup_x, dedup_y, 0.01, 10);
-    pizeropizero_total_interpolation =
-        std::make_unique<InterpolateDataLinear<double>>(dedup_x, dedup_y);
-  }
   const double last = *(PIZEROPIZERO_TOT_SQRTS.end() - 1);
   if (sqrts < last)
-    return (*pizeropizero_total_interpolation)(sqrts);
+    return ParametrizationTables::get().pizeropizero_total(sqrts);
   else
     return pipi_string_hard(sqrts * sqrts);
 }
 
 double piplusp_total(double sqrts) {
-  if (piplusp_total_interpolation == nullptr) {
-    auto [dedup_x, dedup_y] =
-        dedup_avg<double>(PIPLUSP_TOT_SQRTS, PIPLUSP_TOT_SIG);
-    dedup_y = smooth(dedup_x, dedup_y, 0.01, 10);
-    piplusp_total_interpolation =
-        std::make_unique<InterpolateDataLinear<double>>(dedup_x, dedup_y);
-  }
   const double last = *(PIPLUSP_TOT_SQRTS.end() - 1);
   if (sqrts < last)
-    return (*piplusp_total_interpolation)(sqrts);
+    return ParametrizationTables::get().piplusp_total(sqrts);
   else
     return piplusp_high_energy(sqrts * sqrts);
 }
@@ -161,15 +236,8 @@ double piplusp_total(double sqrts) {
  * cross section was given for one p_lab value, the corresponding cross sections
  * are averaged. */
 static double piplusp_elastic_pdg(double mandelstam_s) {
-  if (piplusp_elastic_interpolation == nullptr) {
-    auto [dedup_x, dedup_y] =
-        dedup_avg<double>(PIPLUSP_ELASTIC_P_LAB, PIPLUSP_ELASTIC_SIG);
-    dedup_y = smooth(dedup_x, dedup_y, 0.1, 5);
-    piplusp_elastic_interpolation =
-        std::make_unique<InterpolateDataLinear<double>>(dedup_x, dedup_y);
-  }
   const double p_lab = plab_from_s(mandelstam_s, pion_mass, nucleon_mass);
-  return (*piplusp_elastic_interpolation)(p_lab);
+  return ParametrizationTables::get().piplusp_elastic(p_lab);
 }
 
 double piplusp_elastic_high_energy(double mandelstam_s, double m1, double m2) {
@@ -202,16 +270,7 @@ double piplusp_elastic(double mandelstam_s) {
   }
 
   // The elastic contributions from decays still need to be subtracted.
-  if (piplusp_elastic_res_interpolation == nullptr) {
-    std::vector<double> x = PIPLUSP_RES_SQRTS;
-    for (auto& i : x) {
-      i = i * i;
-    }
-    std::vector<double> y = PIPLUSP_RES_SIG;
-    piplusp_elastic_res_interpolation =
-        std::make_unique<InterpolateDataSpline>(x, y);
-  }
-  sigma -= (*piplusp_elastic_res_interpolation)(mandelstam_s);
+  sigma -= ParametrizationTables::get().piplusp_elastic_res(mandelstam_s);
   if (sigma < 0) {
     sigma = really_small;
   }
@@ -224,31 +283,17 @@ double piplusp_elastic(double mandelstam_s) {
  * cross section was given for one p_lab value, the corresponding cross sections
  * are averaged. */
 double piplusp_sigmapluskplus_pdg(double mandelstam_s) {
-  if (piplusp_sigmapluskplus_interpolation == nullptr) {
-    auto [dedup_x, dedup_y] = dedup_avg<double>(PIPLUSP_SIGMAPLUSKPLUS_P_LAB,
-                                                PIPLUSP_SIGMAPLUSKPLUS_SIG);
-    dedup_y = smooth(dedup_x, dedup_y, 0.2, 5);
-    piplusp_sigmapluskplus_interpolation =
-        std::make_unique<InterpolateDataLinear<double>>(dedup_x, dedup_y);
-  }
   const double p_lab = plab_from_s(mandelstam_s, pion_mass, nucleon_mass);
   /* If p_lab is beyond the upper bound of the linear interpolation,
    * InterpolationDataLinear will return the value at the upper bound and this
    * is what we want here. */
-  return (*piplusp_sigmapluskplus_interpolation)(p_lab);
+  return ParametrizationTables::get().piplusp_sigmapluskplus(p_lab);
 }
 
 double piminusp_total(double sqrts) {
-  if (piminusp_total_interpolation == nullptr) {
-    auto [dedup_x, dedup_y] =
-        dedup_avg<double>(PIMINUSP_TOT_SQRTS, PIMINUSP_TOT_SIG);
-    dedup_y = smooth(dedup_x, dedup_y, 0.01, 6);
-    piminusp_total_interpolation =
-        std::make_unique<InterpolateDataLinear<double>>(dedup_x, dedup_y);
-  }
   const double last = *(PIMINUSP_TOT_SQRTS.end() - 1);
   if (sqrts < last)
-    return (*piminusp_total_interpolation)(sqrts);
+    return ParametrizationTables::get().piminusp_total(sqrts);
   else
     return piminusp_high_energy(sqrts * sqrts);
 }
@@ -259,15 +304,8 @@ double piminusp_total(double sqrts) {
  * cross section was given for one p_lab value, the corresponding cross sections
  * are averaged. */
 static double piminusp_elastic_pdg(double mandelstam_s) {
-  if (piminusp_elastic_interpolation == nullptr) {
-    auto [dedup_x, dedup_y] =
-        dedup_avg<double>(PIMINUSP_ELASTIC_P_LAB, PIMINUSP_ELASTIC_SIG);
-    dedup_y = smooth(dedup_x, dedup_y, 0.2, 6);
-    piminusp_elastic_interpolation =
-        std::make_unique<InterpolateDataLinear<double>>(dedup_x, dedup_y);
-  }
   const double p_lab = plab_from_s(mandelstam_s, pion_mass, nucleon_mass);
-  return (*piminusp_elastic_interpolation)(p_lab);
+  return ParametrizationTables::get().piminusp_elastic(p_lab);
 }
 
 double piminusp_elastic(double mandelstam_s) {
@@ -292,17 +330,7 @@ double piminusp_elastic(double mandelstam_s) {
               0.88);
   }
   // The elastic contributions from decays still need to be subtracted.
-  if (piminusp_elastic_res_interpolation == nullptr) {
-    std::vector<double> x = PIMINUSP_RES_SQRTS;
-    for (auto& i : x) {
-      i = i * i;
-    }
-    std::vector<double> y = PIMINUSP_RES_SIG;
-    auto [dedup_x, dedup_y] = dedup_avg(x, y);
-    piminusp_elastic_res_interpolation =
-        std::make_unique<InterpolateDataSpline>(dedup_x, dedup_y);
-  }
-  sigma -= (*piminusp_elastic_res_interpolation)(mandelstam_s);
+  sigma -= ParametrizationTables::get().piminusp_elastic_res(mandelstam_s);
   if (sigma < 0) {
     sigma = really_small;
   }
@@ -315,15 +343,8 @@ double piminusp_elastic(double mandelstam_s) {
  * cross section was given for one p_lab value, the corresponding cross sections
  * are averaged. */
 double piminusp_lambdak0_pdg(double mandelstam_s) {
-  if (piminusp_lambdak0_interpolation == nullptr) {
-    auto [dedup_x, dedup_y] =
-        dedup_avg<double>(PIMINUSP_LAMBDAK0_P_LAB, PIMINUSP_LAMBDAK0_SIG);
-    dedup_y = smooth(dedup_x, dedup_y, 0.2, 6);
-    piminusp_lambdak0_interpolation =
-        std::make_unique<InterpolateDataLinear<double>>(dedup_x, dedup_y);
-  }
   const double p_lab = plab_from_s(mandelstam_s, pion_mass, nucleon_mass);
-  return (*piminusp_lambdak0_interpolation)(p_lab);
+  return ParametrizationTables::get().piminusp_lambdak0(p_lab);
 }
 
 /* pi- p -> Sigma- K+ cross section parametrization, PDG data.
@@ -332,15 +353,8 @@ double piminusp_lambdak0_pdg(double mandelstam_s) {
  * cross section was given for one p_lab value, the corresponding cross sections
  * are averaged. */
 double piminusp_sigmaminuskplus_pdg(double mandelstam_s) {
-  if (piminusp_sigmaminuskplus_interpolation == nullptr) {
-    auto [dedup_x, dedup_y] = dedup_avg<double>(PIMINUSP_SIGMAMINUSKPLUS_P_LAB,
-                                                PIMINUSP_SIGMAMINUSKPLUS_SIG);
-    dedup_y = smooth(dedup_x, dedup_y, 0.2, 6);
-    piminusp_sigmaminuskplus_interpolation =
-        std::make_unique<InterpolateDataLinear<double>>(dedup_x, dedup_y);
-  }
   const double p_lab = plab_from_s(mandelstam_s, pion_mass, nucleon_mass);
-  return (*piminusp_sigmaminuskplus_interpolation)(p_lab);
+  return ParametrizationTables::get().piminusp_sigmaminuskplus(p_lab);
 }
 
 /* pi- p -> Sigma0 K0 cross section parametrization, resonance contribution.
@@ -349,15 +363,8 @@ double piminusp_sigmaminuskplus_pdg(double mandelstam_s) {
  * cross section was given for one sqrts value, the corresponding cross sections
  * are averaged. */
 double piminusp_sigma0k0_res(double mandelstam_s) {
-  if (piminusp_sigma0k0_interpolation == nullptr) {
-    auto [dedup_x, dedup_y] = dedup_avg<double>(PIMINUSP_SIGMA0K0_RES_SQRTS,
-                                                PIMINUSP_SIGMA0K0_RES_SIG);
-    dedup_y = smooth(dedup_x, dedup_y, 0.2, 6);
-    piminusp_sigma0k0_interpolation =
-        std::make_unique<InterpolateDataLinear<double>>(dedup_x, dedup_y);
-  }
   const double sqrts = std::sqrt(mandelstam_s);
-  return (*piminusp_sigma0k0_interpolation)(sqrts);
+  return ParametrizationTables::get().piminusp_sigma0k0(sqrts);
 }
 
 double pp_elastic(double mandelstam_s) {
@@ -484,52 +491,23 @@ double deuteron_nucleon_elastic(double mandelstam_s) {
 }
 
 double kplusp_total(double mandelstam_s) {
-  if (kplusp_total_interpolation == nullptr) {
-    auto [dedup_x, dedup_y] =
-        dedup_avg<double>(KPLUSP_TOT_PLAB, KPLUSP_TOT_SIG);
-    dedup_y = smooth(dedup_x, dedup_y, 0.1, 5);
-    kplusp_total_interpolation =
-        std::make_unique<InterpolateDataLinear<double>>(dedup_x, dedup_y);
-  }
   const double p_lab = plab_from_s(mandelstam_s, kaon_mass, nucleon_mass);
-  return (*kplusp_total_interpolation)(p_lab);
+  return ParametrizationTables::get().kplusp_total(p_lab);
 }
 
 double kplusn_total(double mandelstam_s) {
-  if (kplusn_total_interpolation == nullptr) {
-    auto [dedup_x, dedup_y] =
-        dedup_avg<double>(KPLUSN_TOT_PLAB, KPLUSN_TOT_SIG);
-    dedup_y = smooth(dedup_x, dedup_y, 0.05, 5);
-    kplusn_total_interpolation =
-        std::make_unique<InterpolateDataLinear<double>>(dedup_x, dedup_y);
-  }
   const double p_lab = plab_from_s(mandelstam_s, kaon_mass, nucleon_mass);
-  return (*kplusn_total_interpolation)(p_lab);
+  return ParametrizationTables::get().kplusn_total(p_lab);
 }
 
 double kminusp_total(double mandelstam_s) {
-  if (kminusp_total_interpolation == nullptr) {
-    auto [dedup_x, dedup_y] =
-        dedup_avg<double>(KMINUSP_TOT_PLAB, KMINUSP_TOT_SIG);
-    // Parametrization data is pre-smoothed
-    dedup_y = smooth(dedup_x, dedup_y, 0.01, 5);
-    kminusp_total_interpolation =
-        std::make_unique<InterpolateDataLinear<double>>(dedup_x, dedup_y);
-  }
   const double p_lab = plab_from_s(mandelstam_s, kaon_mass, nucleon_mass);
-  return (*kminusp_total_interpolation)(p_lab);
+  return ParametrizationTables::get().kminusp_total(p_lab);
 }
 
 double kminusn_total(double mandelstam_s) {
-  if (kminusn_total_interpolation == nullptr) {
-    auto [dedup_x, dedup_y] =
-        dedup_avg<double>(KMINUSN_TOT_PLAB, KMINUSN_TOT_SIG);
-    dedup_y = smooth(dedup_x, dedup_y, 0.05, 5);
-    kminusn_total_interpolation =
-        std::make_unique<InterpolateDataLinear<double>>(dedup_x, dedup_y);
-  }
   const double p_lab = plab_from_s(mandelstam_s, kaon_mass, nucleon_mass);
-  return (*kminusn_total_interpolation)(p_lab);
+  return ParametrizationTables::get().kminusn_total(p_lab);
 }
 
 double kplusp_elastic_background(double mandelstam_s) {
@@ -559,15 +537,8 @@ double kplusn_k0p(double mandelstam_s) {
  * cross section was given for one p_lab value, the corresponding cross sections
  * are averaged. */
 static double kminusp_elastic_pdg(double mandelstam_s) {
-  if (kminusp_elastic_interpolation == nullptr) {
-    auto [dedup_x, dedup_y] =
-        dedup_avg<double>(KMINUSP_ELASTIC_P_LAB, KMINUSP_ELASTIC_SIG);
-    dedup_y = smooth(dedup_x, dedup_y, 0.1, 5);
-    kminusp_elastic_interpolation =
-        std::make_unique<InterpolateDataLinear<double>>(dedup_x, dedup_y);
-  }
   const double p_lab = plab_from_s(mandelstam_s, kaon_mass, nucleon_mass);
-  return (*kminusp_elastic_interpolation)(p_lab);
+  return ParametrizationTables::get().kminusp_elastic(p_lab);
 }
 
 double kminusp_elastic_background(double mandelstam_s) {
@@ -592,22 +563,13 @@ double kminusp_elastic_background(double mandelstam_s) {
     sigma = kminusp_elastic_pdg(mandelstam_s);
   }
   // The elastic contributions from decays still need to be subtracted.
-  if (kminusp_elastic_res_interpolation == nullptr) {
-    std::vector<double> x = KMINUSP_RES_SQRTS;
-    for (auto& i : x) {
-      i = plab_from_s(i * i, kaon_mass, nucleon_mass);
-    }
-    std::vector<double> y = KMINUSP_RES_SIG;
-    kminusp_elastic_res_interpolation =
-        std::make_unique<InterpolateDataSpline>(x, y);
-  }
   const auto old_sigma = sigma;
-  sigma -= (*kminusp_elastic_res_interpolation)(p_lab);
+  sigma -= ParametrizationTables::get().kminusp_elastic_res(p_lab);
   if (sigma < 0) {
     std::cout << "NEGATIVE SIGMA: sigma=" << sigma
               << ", sqrt(s)=" << std::sqrt(mandelstam_s)
               << ", sig_el_exp=" << old_sigma
-              << ", sig_el_res=" << (*kminusp_elastic_res_interpolation)(p_lab)
+              << ", sig_el_res=" << ParametrizationTables::get().kminusp_elastic_res(p_lab)
               << std::endl;
   }
   assert(sigma >= 0);
@@ -637,28 +599,14 @@ double kbar0n_elastic_background(double mandelstam_s) {
 }
 
 double kplusp_inelastic_background(double mandelstam_s) {
-  if (kplusp_total_interpolation == nullptr) {
-    auto [dedup_x, dedup_y] =
-        dedup_avg<double>(KPLUSP_TOT_PLAB, KPLUSP_TOT_SIG);
-    dedup_y = smooth(dedup_x, dedup_y, 0.1, 5);
-    kplusp_total_interpolation =
-        std::make_unique<InterpolateDataLinear<double>>(dedup_x, dedup_y);
-  }
   const double p_lab = plab_from_s(mandelstam_s, kaon_mass, nucleon_mass);
-  return (*kplusp_total_interpolation)(p_lab)-kplusp_elastic_background(
+  return ParametrizationTables::get().kplusp_total(p_lab)-kplusp_elastic_background(
       mandelstam_s);
 }
 
 double kplusn_inelastic_background(double mandelstam_s) {
-  if (kplusn_total_interpolation == nullptr) {
-    auto [dedup_x, dedup_y] =
-        dedup_avg<double>(KPLUSN_TOT_PLAB, KPLUSN_TOT_SIG);
-    dedup_y = smooth(dedup_x, dedup_y, 0.05, 5);
-    kplusn_total_interpolation =
-        std::make_unique<InterpolateDataLinear<double>>(dedup_x, dedup_y);
-  }
   const double p_lab = plab_from_s(mandelstam_s, kaon_mass, nucleon_mass);
-  return (*kplusn_total_interpolation)(p_lab)-kplusn_elastic_background(
+  return ParametrizationTables::get().kplusn_total(p_lab)-kplusn_elastic_background(
              mandelstam_s) -
          kplusn_k0p(mandelstam_s);
 }
@@ -766,7 +714,7 @@ double KaonNucleonRatios::get_ratio(const ParticleType& a,
   return ratios_.at(key);
 }
 
-/*thread_local (see #3075)*/ KaonNucleonRatios kaon_nucleon_ratios;
+thread_local KaonNucleonRatios kaon_nucleon_ratios;
 
 double kminusp_kbar0n(double mandelstam_s) {
   constexpr double a0 = 100;   // mb GeV^2
@@ -869,4 +817,145 @@ double sigmaplussigmaminus_xi0n(double sqrts_sqrts0) {
   return sigmaplussigmaminus_ximinusp(sqrts_sqrts0);
 }
 
+/**
+ * Evaluate a parametrization for several arguments.
+ *
+ * \tparam parametrization Parametrization for a single argument, which is
+ *         inlined into the loop
+ * \param[in] x Arguments
+ * \param[in] n Number of arguments
+ * \param[out] xs Cross sections [mb]
+ */
+template <double (*parametrization)(double)>
+static void evaluate_batch(const double* x, std::size_t n, double* xs) {
+  for (std::size_t i = 0; i < n; i++) {
+    xs[i] = parametrization(x[i]);
+  }
+}
+
+void pp_elastic(const double* mandelstam_s, std::size_t n, double* xs) {
+  evaluate_batch<pp_elastic>(mandelstam_s, n, xs);
+}
+
+void pp_total(const double* mandelstam_s, std::size_t n, double* xs) {
+  evaluate_batch<pp_total>(mandelstam_s, n, xs);
+}
+
+void np_elastic(const double* mandelstam_s, std::size_t n, double* xs) {
+  evaluate_batch<np_elastic>(mandelstam_s, n, xs);
+}
+
+void np_total(const double* mandelstam_s, std::size_t n, double* xs) {
+  evaluate_batch<np_total>(mandelstam_s, n, xs);
+}
+
+void ppbar_elastic(const double* mandelstam_s, std::size_t n, double* xs) {
+  evaluate_batch<ppbar_elastic>(mandelstam_s, n, xs);
+}
+
+void ppbar_total(const double* mandelstam_s, std::size_t n, double* xs) {
+  evaluate_batch<ppbar_total>(mandelstam_s, n, xs);
+}
+
+void piplusp_elastic(const double* mandelstam_s, std::size_t n, double* xs) {
+  evaluate_batch<piplusp_elastic>(mandelstam_s, n, xs);
+}
+
+void piminusp_elastic(const double* mandelstam_s, std::size_t n, double* xs) {
+  evaluate_batch<piminusp_elastic>(mandelstam_s, n, xs);
+}
+
+void piminusp_high_energy(const double* mandelstam_s, std::size_t n,
+                          double* xs) {
+  evaluate_batch<piminusp_high_energy>(mandelstam_s, n, xs);
+}
+
+/**
+ * Evaluate a total cross section which is interpolated from data up to the
+ * last data point and parametrized beyond, for several arguments.
+ *
+ * \tparam high_energy Parametrization beyond the data, depending on
+ *         Mandelstam s
+ * \param[in] data Interpolation of the data
+ * \param[in] last Center-of-mass energy of the last data point [GeV]
+ * \param[in] sqrts Center-of-mass energies [GeV]
+ * \param[in] n Number of arguments
+ * \param[out] xs Cross sections [mb]
+ */
+template <double (*high_energy)(double)>
+static void total_batch(const InterpolateDataLinear<double>& data,
+                        double last, const double* sqrts, std::size_t n,
+                        double* xs) {
+  data.evaluate(sqrts, n, xs);
+  for (std::size_t i = 0; i < n; i++) {
+    if (!(sqrts[i] < last)) {
+      xs[i] = high_energy(sqrts[i] * sqrts[i]);
+    }
+  }
+}
+
+void piplusp_total(const double* sqrts, std::size_t n, double* xs) {
+  total_batch<piplusp_high_energy>(ParametrizationTables::get().piplusp_total,
+                                   *(PIPLUSP_TOT_SQRTS.end() - 1), sqrts, n,
+                                   xs);
+}
+
+void piminusp_total(const double* sqrts, std::size_t n, double* xs) {
+  total_batch<piminusp_high_energy>(
+      ParametrizationTables::get().piminusp_total,
+      *(PIMINUSP_TOT_SQRTS.end() - 1), sqrts, n, xs);
+}
+
+void pipluspiminus_total(const double* sqrts, std::size_t n, double* xs) {
+  total_batch<pipi_string_hard>(
+      ParametrizationTables::get().pipluspiminus_total,
+      *(PIPLUSPIMINUS_TOT_SQRTS.end() - 1), sqrts, n, xs);
+}
+
+void pizeropizero_total(const double* sqrts, std::size_t n, double* xs) {
+  total_batch<pipi_string_hard>(
+      ParametrizationTables::get().pizeropizero_total,
+      *(PIZEROPIZERO_TOT_SQRTS.end() - 1), sqrts, n, xs);
+}
+
+/**
+ * Evaluate a kaon-nucleon total cross section, which is interpolated in the
+ * momentum of the kaon in the rest frame of the nucleon, for several
+ * arguments.
+ *
+ * \param[in] data Interpolation of the data in the momentum
+ * \param[in] mandelstam_s Mandelstam s [GeV^2]
+ * \param[in] n Number of arguments
+ * \param[out] xs Cross sections [mb]
+ */
+static void kaon_nucleon_total_batch(const InterpolateDataLinear<double>& data,
+                                     const double* mandelstam_s,
+                                     std::size_t n, double* xs) {
+  // The momenta are stored in the output, which is interpolated in place
+  for (std::size_t i = 0; i < n; i++) {
+    xs[i] = plab_from_s(mandelstam_s[i], kaon_mass, nucleon_mass);
+  }
+  data.evaluate(xs, n, xs);
+}
+
+void kplusp_total(const double* mandelstam_s, std::size_t n, double* xs) {
+  kaon_nucleon_total_batch(ParametrizationTables::get().kplusp_total,
+                           mandelstam_s, n, xs);
+}
+
+void kplusn_total(const double* mandelstam_s, std::size_t n, double* xs) {
+  kaon_nucleon_total_batch(ParametrizationTables::get().kplusn_total,
+                           mandelstam_s, n, xs);
+}
+
+void kminusp_total(const double* mandelstam_s, std::size_t n, double* xs) {
+  kaon_nucleon_total_batch(ParametrizationTables::get().kminusp_total,
+                           mandelstam_s, n, xs);
+}
+
+void kminusn_total(const double* mandelstam_s, std::size_t n, double* xs) {
+  kaon_nucleon_total_batch(ParametrizationTables::get().kminusn_total,
+                           mandelstam_s, n, xs);
+}
+
 }  // namespace smash
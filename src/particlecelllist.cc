@@ -0,0 +1,121 @@
+/*
+ *
+ *    Copyright (c) 2024
+ *      SMASH Team
+ *
+ *    GNU General Public License (GPLv3 or later)
+ *
+ */
+
+#include "smash/particlecelllist.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#include "smash/particledata.h"
+
+namespace smash {
+
+ParticleCellList::ParticleCellList(const ParticleList &plist, double r_cut)
+    : plist_(&plist) {
+  const int n_particles = plist.size();
+  std::array<double, 3> upper_corner = {0., 0., 0.};
+  if (n_particles > 0) {
+    lower_corner_.fill(std::numeric_limits<double>::max());
+    upper_corner.fill(std::numeric_limits<double>::lowest());
+    for (const ParticleData &p : plist) {
+      const ThreeVector r = p.position().threevec();
+      for (int i = 0; i < 3; i++) {
+        lower_corner_[i] = std::min(lower_corner_[i], r[i]);
+        upper_corner[i] = std::max(upper_corner[i], r[i]);
+      }
+    }
+  }
+
+  /* The cells are made slightly larger than r_cut, such that rounding cannot
+   * put particles closer than r_cut two cells apart. For widely spread
+   * particles, the cells are enlarged to bound the memory. */
+  const double min_length = r_cut * (1. + 1.e-9);
+  std::array<int, 3> n_inner;
+  for (int i = 0; i < 3; i++) {
+    const double extent = upper_corner[i] - lower_corner_[i];
+    n_inner[i] = static_cast<int>(
+        std::max(1.0, std::min(std::floor(extent / min_length), 1.e6)));
+  }
+  const double max_cells = 8. * n_particles + 64.;
+  auto n_all_cells = [&]() {
+    return (n_inner[0] + 1.) * (n_inner[1] + 1.) * (n_inner[2] + 1.);
+  };
+  while (n_all_cells() > max_cells) {
+    int *largest = std::max_element(n_inner.begin(), n_inner.end());
+    *largest = std::max(1, *largest / 2);
+  }
+  for (int i = 0; i < 3; i++) {
+    const double extent = upper_corner[i] - lower_corner_[i];
+    inv_cell_length_[i] = 1. / std::max(extent / n_inner[i], min_length);
+    // one more cell for the particles at the upper corner
+    n_cells_[i] = n_inner[i] + 1;
+  }
+
+  // sort the particle indices into the cells, keeping their order
+  std::vector<int> cell_of(n_particles);
+  cell_start_.assign(n_cells_[0] * n_cells_[1] * n_cells_[2] + 1, 0);
+  for (int k = 0; k < n_particles; k++) {
+    const ThreeVector r = plist[k].position().threevec();
+    std::array<int, 3> c;
+    for (int i = 0; i < 3; i++) {
+      c[i] = std::clamp(cell_coordinate(i, r[i]), 0, n_cells_[i] - 1);
+    }
+    cell_of[k] = c[0] + n_cells_[0] * (c[1] + n_cells_[1] * c[2]);
+    cell_start_[cell_of[k] + 1]++;
+  }
+  for (std::size_t cell = 1; cell < cell_start_.size(); cell++) {
+    cell_start_[cell] += cell_start_[cell - 1];
+  }
+  particle_index_.resize(n_particles);
+  std::vector<int> next(cell_start_.begin(), cell_start_.end() - 1);
+  for (int k = 0; k < n_particles; k++) {
+    particle_index_[next[cell_of[k]]++] = k;
+  }
+}
+
+int ParticleCellList::cell_coordinate(int axis, double x) const {
+  const double c = std::floor((x - lower_corner_[axis]) *
+                              inv_cell_length_[axis]);
+  // points far outside are clamped to a value beyond the cells
+  return static_cast<int>(std::clamp(c, -2., n_cells_[axis] + 1.));
+}
+
+void ParticleCellList::find_neighbors(
+    const ThreeVector &r, std::vector<const ParticleData *> &neighbors) const {
+  neighbors.clear();
+  std::array<int, 3> lower, upper;
+  for (int i = 0; i < 3; i++) {
+    const int c = cell_coordinate(i, r[i]);
+    lower[i] = std::max(c - 1, 0);
+    upper[i] = std::min(c + 1, n_cells_[i] - 1);
+    if (lower[i] > upper[i]) {
+      return;
+    }
+  }
+  static thread_local std::vector<int> indices;
+  indices.clear();
+  for (int iz = lower[2]; iz <= upper[2]; iz++) {
+    for (int iy = lower[1]; iy <= upper[1]; iy++) {
+      // the cells of a row in x direction are contiguous
+      const int row = n_cells_[0] * (iy + n_cells_[1] * iz);
+      indices.insert(indices.end(),
+                     particle_index_.begin() + cell_start_[row + lower[0]],
+                     particle_index_.begin() + cell_start_[row + upper[0] + 1]);
+    }
+  }
+  // restore the order of the list, such that sums over them do not change
+  std::sort(indices.begin(), indices.end());
+  neighbors.reserve(indices.size());
+  for (const int k : indices) {
+    neighbors.push_back(&(*plist_)[k]);
+  }
+}
+
+}  // namespace smash
@@ -1,6 +1,6 @@
 /*
  *
- *    Copyright (c) 2014-2023
+ *    Copyright (c) 2014-2024
  *      SMASH Team
  *
  *    GNU General Public License (GPLv3 or later)
@@ -9,6 +9,7 @@
 
 #include "smash/particledata.h"
 
+#include <cmath>
 #include <iomanip>
 #include <iostream>
 #include <optional>
@@ -18,6 +19,7 @@
 #include "smash/iomanipulators.h"
 #include "smash/logging.h"
 #include "smash/numerics.h"
+#include "smash/pow.h"
 
 namespace smash {
 
@@ -83,6 +85,28 @@ void ParticleData::set_history(int ncoll, uint32_t pid, ProcessType pt,
   }
 }
 
+/**
+ * Raise the formed fraction of the formation time to the formation power.
+ *
+ * The usual integer and half-integer powers are evaluated with
+ * multiplications and a square root, which are much cheaper than std::pow.
+ *
+ * \param[in] fraction Fraction of the formation time passed, in [0, 1]
+ * \param[in] power Positive formation power
+ * \return fraction^power
+ */
+static double formation_ramp(double fraction, double power) {
+  constexpr double max_multiplications = 16.;
+  const double twice_power = 2. * power;
+  if (twice_power == std::floor(twice_power) &&
+      power <= max_multiplications) {
+    const unsigned n = static_cast<unsigned>(power);
+    const double ramp = pow_int(fraction, n);
+    return twice_power == 2. * n ? ramp : ramp * std::sqrt(fraction);
+  }
+  return std::pow(fraction, power);
+}
+
 double ParticleData::xsec_scaling_factor(double delta_time) const {
   double time_of_interest = position_.x0() + delta_time;
   // cross section scaling factor at the time_of_interest
@@ -111,9 +135,9 @@ double ParticleData::xsec_scaling_factor(double delta_time) const {
       scaling_factor =
           initial_xsec_scaling_factor_ +
           (1. - initial_xsec_scaling_factor_) *
-              std::pow((time_of_interest - begin_formation_time_) /
-                           (formation_time_ - begin_formation_time_),
-                       formation_power_);
+              formation_ramp((time_of_interest - begin_formation_time_) /
+                                 (formation_time_ - begin_formation_time_),
+                             formation_power_);
     }
   }
   return scaling_factor;
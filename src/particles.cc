@@ -1,6 +1,6 @@
 /*
  *
- *    Copyright (c) 2013-2015,2017-2018
+ *    Copyright (c) 2013-2015,2017-2018,2024
  *      SMASH Team
  *
  *    GNU General Public License (GPLv3 or later)
@@ -9,8 +9,16 @@
 
 #include "smash/particles.h"
 
+#include <algorithm>
+#include <atomic>
 #include <iomanip>
 #include <iostream>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "smash/checkpoint.h"
 
 namespace smash {
 
@@ -29,13 +37,16 @@ inline void Particles::ensure_capacity(unsigned to_add) {
 
 void Particles::increase_capacity(unsigned new_capacity) {
   assert(new_capacity > data_capacity_);
+  reallocate(new_capacity);
+}
+
+void Particles::reallocate(unsigned new_capacity) {
+  assert(new_capacity >= data_size_);
   data_capacity_ = new_capacity;
   std::unique_ptr<ParticleData[]> new_memory(new ParticleData[data_capacity_]);
-  unsigned i = 0;
-  for (; i < data_size_; ++i) {
-    new_memory[i] = data_[i];
-  }
-  for (; i < data_capacity_; ++i) {
+  // ParticleData is trivially copyable, hence this copies the bytes at once
+  std::copy_n(data_.get(), data_size_, new_memory.get());
+  for (unsigned i = data_size_; i < data_capacity_; ++i) {
     new_memory[i].index_ = i;
   }
   std::swap(data_, new_memory);
@@ -48,6 +59,7 @@ inline void Particles::copy_in(ParticleData &to, const ParticleData &from) {
 }
 
 const ParticleData &Particles::insert(const ParticleData &p) {
+  touch();
   if (likely(dirty_.empty())) {
     ensure_capacity(1);
     ParticleData &in_vector = data_[data_size_];
@@ -64,6 +76,7 @@ const ParticleData &Particles::insert(const ParticleData &p) {
 }
 
 void Particles::create(size_t number, PdgCode pdg) {
+  touch();
   const ParticleData pd(ParticleType::find(pdg));
   while (number && !dirty_.empty()) {
     const auto offset = dirty_.back();
@@ -87,6 +100,7 @@ void Particles::create(size_t number, PdgCode pdg) {
 }
 
 ParticleData &Particles::create(const PdgCode pdg) {
+  touch();
   const ParticleData pd(ParticleType::find(pdg));
   ParticleData *ptr;
   if (likely(dirty_.empty())) {
@@ -106,6 +120,7 @@ ParticleData &Particles::create(const PdgCode pdg) {
 }
 
 void Particles::remove(const ParticleData &p) {
+  touch();
   assert(is_valid(p));
   const unsigned index = p.index_;
   if (index == data_size_ - 1) {
@@ -118,6 +133,7 @@ void Particles::remove(const ParticleData &p) {
 }
 
 void Particles::replace(const ParticleList &to_remove, ParticleList &to_add) {
+  touch();
   std::size_t i = 0;
   for (; i < std::min(to_remove.size(), to_add.size()); ++i) {
     assert(is_valid(to_remove[i]));
@@ -136,7 +152,51 @@ void Particles::replace(const ParticleList &to_remove, ParticleList &to_add) {
   }
 }
 
+void Particles::compact() {
+  touch();
+  /* The holes are filled from the first one with the particles from the end,
+   * while holes at the end are dropped. The holes dirty_[first, end) are left
+   * to be filled. */
+  std::sort(dirty_.begin(), dirty_.end());
+  std::size_t first = 0, end = dirty_.size();
+  while (first < end) {
+    const unsigned last = data_size_ - 1;
+    if (dirty_[end - 1] == last) {
+      data_[last].hole_ = false;
+      --end;
+    } else {
+      const unsigned hole = dirty_[first++];
+      data_[hole] = data_[last];
+      data_[hole].index_ = hole;
+    }
+    --data_size_;
+  }
+  dirty_.clear();
+}
+
+void Particles::sort(
+    const std::function<std::uint64_t(const ParticleData &)> &key) {
+  touch();
+  compact();
+  std::vector<std::pair<std::uint64_t, unsigned>> order(data_size_);
+  for (unsigned i = 0; i < data_size_; ++i) {
+    order[i] = {key(data_[i]), i};
+  }
+  // The slots break ties, which keeps the order of equal keys
+  std::sort(order.begin(), order.end());
+  std::unique_ptr<ParticleData[]> new_memory(new ParticleData[data_capacity_]);
+  for (unsigned i = 0; i < data_size_; ++i) {
+    new_memory[i] = data_[order[i].second];
+    new_memory[i].index_ = i;
+  }
+  for (unsigned i = data_size_; i < data_capacity_; ++i) {
+    new_memory[i].index_ = i;
+  }
+  std::swap(data_, new_memory);
+}
+
 void Particles::reset() {
+  touch();
   id_max_ = -1;
   data_size_ = 0;
   for (auto index : dirty_) {
@@ -145,6 +205,83 @@ void Particles::reset() {
   dirty_.clear();
 }
 
+void Particles::write_checkpoint(std::ostream &out) const {
+  checkpoint::write(out, id_max_);
+  checkpoint::write(out, data_size_);
+  out.write(reinterpret_cast<const char *>(data_.get()),
+            data_size_ * sizeof(ParticleData));
+  checkpoint::write(out, dirty_);
+}
+
+void Particles::read_checkpoint(std::istream &in) {
+  static_assert(std::is_trivially_copyable_v<ParticleData>,
+                "The particles are written as bytes.");
+  reset();
+  unsigned size = 0;
+  checkpoint::read(in, id_max_);
+  checkpoint::read(in, size);
+  ensure_capacity(size);
+  if (!in.read(reinterpret_cast<char *>(data_.get()),
+               size * sizeof(ParticleData))) {
+    throw std::runtime_error("The checkpoint ends unexpectedly.");
+  }
+  data_size_ = size;
+  checkpoint::read(in, dirty_);
+}
+
+void Particles::copy_from(const Particles &other) {
+  reset();
+  ensure_capacity(other.size());
+  for (const ParticleData &p : other) {
+    ParticleData &to = data_[data_size_];
+    p.copy_to(to);
+    to.id_ = p.id_;
+    to.type_ = p.type_;
+    ++data_size_;
+  }
+  id_max_ = other.id_max_;
+}
+
+void Particles::copy_from(
+    const Particles &other,
+    const std::function<bool(const ParticleData &)> &selected) {
+  reset();
+  ensure_capacity(other.size());
+  for (const ParticleData &p : other) {
+    if (!selected(p)) {
+      continue;
+    }
+    ParticleData &to = data_[data_size_];
+    p.copy_to(to);
+    to.id_ = p.id_;
+    to.type_ = p.type_;
+    ++data_size_;
+  }
+  id_max_ = other.id_max_;
+}
+
+std::uint64_t Particles::epoch() const {
+  // The epochs of all objects are drawn from one counter
+  static std::atomic<std::uint64_t> last_epoch{0};
+  if (modified_.exchange(false, std::memory_order_relaxed)) {
+    epoch_ = ++last_epoch;
+    snapshot_.reset();
+  }
+  return epoch_;
+}
+
+std::shared_ptr<const Particles> Particles::snapshot() const {
+  epoch();
+  std::shared_ptr<const Particles> shared = snapshot_.lock();
+  if (!shared) {
+    auto copy = std::make_shared<Particles>();
+    copy->copy_from(*this);
+    shared = std::move(copy);
+    snapshot_ = shared;
+  }
+  return shared;
+}
+
 std::ostream &operator<<(std::ostream &out, const Particles &particles) {
   out << particles.size() << " Particles:\n";
   for (unsigned i = 0; i < particles.data_size_; ++i) {
@@ -0,0 +1,58 @@
+/*
+ *
+ *    Copyright (c) 2024
+ *      SMASH Team
+ *
+ *    GNU General Public License (GPLv3 or later)
+ *
+ */
+
+#include "smash/particlessoa.h"
+
+#include "smash/particles.h"
+
+namespace smash {
+
+void ParticlesSoA::assign(const Particles &particles) {
+  clear(particles.size());
+  append(particles);
+}
+
+void ParticlesSoA::assign(const std::vector<Particles> &ensembles) {
+  std::size_t n = 0;
+  for (const Particles &particles : ensembles) {
+    n += particles.size();
+  }
+  clear(n);
+  for (const Particles &particles : ensembles) {
+    append(particles);
+  }
+}
+
+void ParticlesSoA::clear(std::size_t capacity) {
+  particle.clear();
+  particle.reserve(capacity);
+  type.clear();
+  type.reserve(capacity);
+  for (auto *v : {&t, &x, &y, &z, &e, &px, &py, &pz}) {
+    v->clear();
+    v->reserve(capacity);
+  }
+}
+
+void ParticlesSoA::append(const Particles &particles) {
+  for (const ParticleData &p : particles) {
+    particle.push_back(&p);
+    type.push_back(&p.type());
+    t.push_back(p.position().x0());
+    x.push_back(p.position().x1());
+    y.push_back(p.position().x2());
+    z.push_back(p.position().x3());
+    e.push_back(p.momentum().x0());
+    px.push_back(p.momentum().x1());
+    py.push_back(p.momentum().x2());
+    pz.push_back(p.momentum().x3());
+  }
+}
+
+}  // namespace smash
@@ -0,0 +1,186 @@
+/*
+ *
+ *    Copyright (c) 2024
+ *      SMASH Team
+ *
+ *    GNU General Public License (GPLv3 or later)
+ *
+ */
+
+#include "smash/particletablesnapshot.h"
+
+#include <unistd.h>
+
+#include <cstring>
+#include <fstream>
+#include <memory>
+#include <stdexcept>
+#include <utility>
+
+#include "smash/decaymodes.h"
+
+namespace smash {
+
+ParticleTableSnapshot ParticleTableSnapshot::take() {
+  ParticleTableSnapshot snapshot;
+  const ParticleTypeList &list = ParticleType::list_all();
+  snapshot.types_.reserve(list.size());
+  snapshot.branches_.resize(list.size());
+  for (std::size_t i = 0; i < list.size(); i++) {
+    const ParticleType &type = list[i];
+    snapshot.types_.push_back({type.name(), type.mass(), type.width_at_pole(),
+                               type.parity(), type.pdgcode()});
+    for (const auto &mode : type.decay_modes().decay_mode_list()) {
+      Branch branch{mode->weight(), mode->angular_momentum(), {}};
+      for (const ParticleTypePtr daughter : mode->particle_types()) {
+        branch.daughters.push_back(std::addressof(*daughter) -
+                                   std::addressof(list[0]));
+      }
+      snapshot.branches_[i].push_back(std::move(branch));
+    }
+  }
+  return snapshot;
+}
+
+std::optional<ParticleTableSnapshot> ParticleTableSnapshot::read(
+    const std::filesystem::path &path, sha256::Hash hash) {
+  std::ifstream file(path, std::ios::binary | std::ios::ate);
+  if (!file) {
+    return std::nullopt;
+  }
+  std::string data(static_cast<std::size_t>(file.tellg()), '\0');
+  file.seekg(0);
+  if (!file.read(data.data(), data.size())) {
+    return std::nullopt;
+  }
+
+  // Read the snapshot, checking every access against the size
+  std::size_t position = 0;
+  auto read_value = [&](auto &x) {
+    if (position + sizeof(x) > data.size()) {
+      return false;
+    }
+    std::memcpy(&x, data.data() + position, sizeof(x));
+    position += sizeof(x);
+    return true;
+  };
+  char file_magic[sizeof(magic)];
+  std::uint64_t file_version = 0, n_types = 0;
+  sha256::Hash file_hash;
+  if (!read_value(file_magic) ||
+      std::memcmp(file_magic, magic, sizeof(magic)) != 0 ||
+      !read_value(file_version) || file_version != version ||
+      !read_value(file_hash) || file_hash != hash || !read_value(n_types) ||
+      n_types > data.size()) {
+    return std::nullopt;
+  }
+  ParticleTableSnapshot snapshot;
+  snapshot.types_.resize(n_types);
+  for (Type &type : snapshot.types_) {
+    std::uint64_t name_length = 0;
+    std::int32_t parity = 0, pdg = 0;
+    if (!read_value(name_length) || name_length > data.size() - position) {
+      return std::nullopt;
+    }
+    type.name.assign(data.data() + position, name_length);
+    position += name_length;
+    if (!read_value(type.mass) || !read_value(type.width) ||
+        !read_value(parity) || !read_value(pdg)) {
+      return std::nullopt;
+    }
+    type.parity = parity == 0 ? Parity::Pos : Parity::Neg;
+    type.pdgcode = PdgCode::from_decimal(pdg);
+  }
+  snapshot.branches_.resize(n_types);
+  for (std::vector<Branch> &branches : snapshot.branches_) {
+    std::uint64_t n_branches = 0;
+    if (!read_value(n_branches) || n_branches > data.size() - position) {
+      return std::nullopt;
+    }
+    branches.resize(n_branches);
+    for (Branch &branch : branches) {
+      std::int32_t angular_momentum = 0;
+      std::uint64_t n_daughters = 0;
+      if (!read_value(branch.weight) || !read_value(angular_momentum) ||
+          !read_value(n_daughters) || n_daughters > data.size() - position) {
+        return std::nullopt;
+      }
+      branch.angular_momentum = angular_momentum;
+      branch.daughters.resize(n_daughters);
+      for (std::uint32_t &daughter : branch.daughters) {
+        if (!read_value(daughter) || daughter >= n_types) {
+          return std::nullopt;
+        }
+      }
+    }
+  }
+  return snapshot;
+}
+
+void ParticleTableSnapshot::write(const std::filesystem::path &path,
+                                  sha256::Hash hash) const {
+  // Concurrent jobs may write the same snapshot
+  const std::filesystem::path temporary =
+      path.string() + ".tmp" + std::to_string(::getpid());
+  {
+    std::ofstream file(temporary, std::ios::binary);
+    auto write_value = [&](const auto &x) {
+      file.write(reinterpret_cast<const char *>(&x), sizeof(x));
+    };
+    file.write(magic, sizeof(magic));
+    write_value(version);
+    write_value(hash);
+    write_value(static_cast<std::uint64_t>(types_.size()));
+    for (const Type &type : types_) {
+      write_value(static_cast<std::uint64_t>(type.name.size()));
+      file.write(type.name.data(), type.name.size());
+      write_value(type.mass);
+      write_value(type.width);
+      const std::int32_t parity = type.parity == Parity::Pos ? 0 : 1;
+      write_value(parity);
+      write_value(type.pdgcode.get_decimal());
+    }
+    for (const std::vector<Branch> &branches : branches_) {
+      write_value(static_cast<std::uint64_t>(branches.size()));
+      for (const Branch &branch : branches) {
+        write_value(branch.weight);
+        write_value(static_cast<std::int32_t>(branch.angular_momentum));
+        write_value(static_cast<std::uint64_t>(branch.daughters.size()));
+        for (const std::uint32_t daughter : branch.daughters) {
+          write_value(daughter);
+        }
+      }
+    }
+    if (!file) {
+      throw std::runtime_error("Could not write particle tables to " +
+                               temporary.string());
+    }
+  }
+  std::filesystem::rename(temporary, path);
+}
+
+void ParticleTableSnapshot::install() const {
+  ParticleTypeList list;
+  list.reserve(types_.size());
+  for (const Type &type : types_) {
+    list.emplace_back(type.name, type.mass, type.width, type.parity,
+                      type.pdgcode);
+  }
+  ParticleType::set_type_list(std::move(list));
+
+  const ParticleTypeList &types = ParticleType::list_all();
+  std::vector<DecayModes> &decaymodes = DecayModes::create_empty_decaymodes();
+  for (std::size_t i = 0; i < branches_.size(); i++) {
+    for (const Branch &branch : branches_[i]) {
+      ParticleTypePtrList daughters;
+      daughters.reserve(branch.daughters.size());
+      for (const std::uint32_t daughter : branch.daughters) {
+        daughters.push_back(&types[daughter]);
+      }
+      decaymodes[i].add_mode(&types[i], branch.weight, branch.angular_momentum,
+                             daughters);
+    }
+  }
+}
+
+}  // namespace smash
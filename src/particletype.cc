@@ -1,6 +1,6 @@
 /*
  *
- *    Copyright (c) 2014-2020,2022-2023
+ *    Copyright (c) 2014-2020,2022-2024
  *      SMASH Team
  *
  *    GNU General Public License (GPLv3 or later)
@@ -12,9 +12,16 @@
 #include <assert.h>
 
 #include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <functional>
 #include <map>
+#include <memory>
+#include <utility>
 #include <vector>
 
+#include "smash/clebschgordan_lookup.h"
 #include "smash/constants.h"
 #include "smash/decaymodes.h"
 #include "smash/distributions.h"
@@ -25,7 +32,10 @@
 #include "smash/isoparticletype.h"
 #include "smash/logging.h"
 #include "smash/potential_globals.h"
+#include "smash/random.h"
 #include "smash/stringfunctions.h"
+#include "smash/tabulation.h"
+#include "smash/threadpool.h"
 
 namespace smash {
 static constexpr int LParticleType = LogArea::ParticleType::id;
@@ -46,6 +56,37 @@ ParticleTypePtrList anti_deltas_list;
 ParticleTypePtrList baryon_resonances_list;
 /// Global pointer to the Particle Type list of light nuclei
 ParticleTypePtrList light_nuclei_list;
+
+/// Number of bits of the slots of the PDG code lookup table
+constexpr int pdg_table_bits = 12;
+/// Number of slots of the PDG code lookup table
+constexpr std::size_t pdg_table_size = std::size_t{1} << pdg_table_bits;
+/// Marks an empty slot, PdgCode::dump never sets the bits 28 to 30
+constexpr std::uint32_t empty_pdg_slot = 0xffffffff;
+/// Slot of the PDG code lookup table
+struct PdgTableSlot {
+  /// PDG code as given by PdgCode::dump, or empty_pdg_slot
+  std::uint32_t code;
+  /// Index of the type in the type list
+  std::uint16_t index;
+};
+/**
+ * Open-addressing hash table from the PDG codes to the indices of the types,
+ * which is filled to at most a quarter, such that most codes are found in
+ * their first slot.
+ */
+std::array<PdgTableSlot, pdg_table_size> pdg_table;
+/// Whether pdg_table holds all types, else a binary search is used
+bool pdg_table_filled = false;
+
+/**
+ * \param[in] code PDG code as given by PdgCode::dump
+ * \return First slot of the code in the lookup table
+ */
+inline std::size_t pdg_table_slot(std::uint32_t code) {
+  // Fibonacci hashing, the highest bits of the product are well mixed
+  return (code * 0x9e3779b1u) >> (32 - pdg_table_bits);
+}
 }  // unnamed namespace
 
 const ParticleTypeList &ParticleType::list_all() {
@@ -87,6 +128,21 @@ ParticleTypePtrList &ParticleType::list_light_nuclei() {
 }
 
 const ParticleTypePtr ParticleType::try_find(PdgCode pdgcode) {
+  if (likely(pdg_table_filled)) {
+    const std::uint32_t code = pdgcode.dump();
+    for (std::size_t slot = pdg_table_slot(code);;
+         slot = (slot + 1) & (pdg_table_size - 1)) {
+      const PdgTableSlot &entry = pdg_table[slot];
+      if (entry.code == empty_pdg_slot) {
+        return {};
+      }
+      // dump does not include the nucleus flag, so the full code is compared
+      if (entry.code == code &&
+          (*all_particle_types)[entry.index].pdgcode() == pdgcode) {
+        return &(*all_particle_types)[entry.index];
+      }
+    }
+  }
   const auto found = std::lower_bound(
       all_particle_types->begin(), all_particle_types->end(), pdgcode,
       [](const ParticleType &l, const PdgCode &r) { return l.pdgcode() < r; });
@@ -126,6 +182,7 @@ ParticleType::ParticleType(std::string n, double m, double w, Parity p,
       width_(w),
       parity_(p),
       pdgcode_(id),
+      pdgcode_string_(id.string()),
       min_mass_kinematic_(-1.),
       min_mass_spectral_(-1.),
       charge_(pdgcode_.charge()),
@@ -197,9 +254,7 @@ static std::string chargestr(int charge) {
 }
 
 void ParticleType::create_type_list(const std::string &input) {  // {{{
-  static ParticleTypeList type_list;
-  type_list.clear();  // in case LoadFailure was thrown and caught and we should
-                      // try again
+  ParticleTypeList type_list;
   for (const Line &line : line_parser(input)) {
     std::istringstream lineinput(line.text);
     std::string name;
@@ -311,13 +366,37 @@ void ParticleType::create_type_list(const std::string &input) {  // {{{
     prev_pdg = t.pdgcode();
   }
 
+  set_type_list(std::move(type_list));
+} /*}}}*/
+
+void ParticleType::set_type_list(ParticleTypeList &&types) {
+  static ParticleTypeList type_list;
   if (all_particle_types != nullptr) {
     throw std::runtime_error("Error: Type list was already built!");
   }
+  type_list = std::move(types);
   all_particle_types = &type_list;  // note that type_list is a function-local
                                     // static and thus will live on until after
                                     // main().
 
+  // Fill the PDG code lookup table, unless it would be too crowded
+  pdg_table.fill({empty_pdg_slot, 0});
+  pdg_table_filled = type_list.size() <= pdg_table_size / 4;
+  if (pdg_table_filled) {
+    for (std::size_t i = 0; i < type_list.size(); i++) {
+      const std::uint32_t code = type_list[i].pdgcode().dump();
+      std::size_t slot = pdg_table_slot(code);
+      while (pdg_table[slot].code != empty_pdg_slot) {
+        slot = (slot + 1) & (pdg_table_size - 1);
+      }
+      pdg_table[slot] = {code, static_cast<std::uint16_t>(i)};
+    }
+  } else {
+    logg[LParticleType].warn(
+        "Too many particle types for the lookup table, PDG codes are found "
+        "by a binary search.");
+  }
+
   // create all isospin multiplets
   for (const auto &t : type_list) {
     IsoParticleType::create_multiplet(t);
@@ -327,6 +406,14 @@ void ParticleType::create_type_list(const std::string &input) {  // {{{
     t.iso_multiplet_ = IsoParticleType::find(t);
   }
 
+  /* Tabulate the Clebsch-Gordan coefficients of all isospins two of these
+   * types can couple to, before any thread needs them. */
+  int max_isospin = 0;
+  for (const auto &t : type_list) {
+    max_isospin = std::max(max_isospin, t.isospin());
+  }
+  ClebschGordan::tabulate(2 * max_isospin);
+
   // Create nucleons/anti-nucleons list
   if (IsoParticleType::exists("N")) {
     for (const auto &state : IsoParticleType::find("N").get_states()) {
@@ -359,7 +446,7 @@ void ParticleType::create_type_list(const std::string &input) {  // {{{
       light_nuclei_list.push_back(&type);
     }
   }
-} /*}}}*/
+}
 
 double ParticleType::min_mass_kinematic() const {
   if (unlikely(min_mass_kinematic_ < 0.)) {
@@ -468,6 +555,100 @@ void ParticleType::check_consistency() {
   }
 }
 
+/**
+ * Determine the position of a particle type in the decay chains, which is -1
+ * for stable types and otherwise larger than that of all its daughters.
+ *
+ * \param[in] type Particle type
+ * \param[inout] levels Known levels, in the order of ParticleType::list_all,
+ *                      -2 if unknown
+ * \return Level of the given type
+ */
+static int decay_chain_level(const ParticleType &type,
+                             std::vector<int> &levels) {
+  const auto index =
+      std::addressof(type) - std::addressof(ParticleType::list_all().front());
+  int &level = levels[index];
+  if (level > -2) {
+    return level;
+  }
+  int max_daughter_level = -2;
+  for (const auto &mode : type.decay_modes().decay_mode_list()) {
+    for (const ParticleTypePtr daughter : mode->type().particle_types()) {
+      max_daughter_level =
+          std::max(max_daughter_level, decay_chain_level(*daughter, levels));
+    }
+  }
+  level = type.is_stable() ? -1 : std::max(max_daughter_level, -1) + 1;
+  return level;
+}
+
+void ParticleType::initialize_lazy_members(ThreadPool *pool) {
+  const ParticleTypeList &types = ParticleType::list_all();
+  std::vector<int> levels(types.size(), -2);
+  int max_level = -1;
+  for (const ParticleType &ptype : types) {
+    ptype.isospin();
+    max_level = std::max(max_level, decay_chain_level(ptype, levels));
+  }
+  auto run = [pool](int n_tasks, const std::function<void(int)> &task) {
+    if (pool) {
+      pool->parallel_for(n_tasks, task);
+    } else {
+      for (int i = 0; i < n_tasks; i++) {
+        task(i);
+      }
+    }
+  };
+  for (int level = -1; level <= max_level; level++) {
+    ParticleTypePtrList level_types;
+    for (std::size_t i = 0; i < types.size(); i++) {
+      if (levels[i] == level) {
+        level_types.push_back(&types[i]);
+      }
+    }
+    /* The width functions of the decay types tabulate their mass dependence
+     * at the first call, irrespective of the mass they are called with.
+     * Hadronic decay types can be shared by several mothers, hence they are
+     * tabulated once each before the mothers are processed. */
+    std::vector<std::pair<const DecayType *, ParticleTypePtr>> modes;
+    for (const ParticleTypePtr ptype : level_types) {
+      for (const auto &mode : ptype->decay_modes().decay_mode_list()) {
+        const DecayType *decay_type = &mode->type();
+        if (!decay_type->is_dilepton_decay() &&
+            std::none_of(modes.begin(), modes.end(), [&](const auto &m) {
+              return m.first == decay_type;
+            })) {
+          modes.emplace_back(decay_type, ptype);
+        }
+      }
+    }
+    run(modes.size(), [&](int i) {
+      const ParticleType &mother = *modes[i].second;
+      modes[i].first->width(mother.mass(), mother.width_at_pole(),
+                            mother.mass());
+    });
+    /* The dilepton decay types depend on the hadronic widths of their only
+     * mother, and the spectral function on all its widths. */
+    run(level_types.size(), [&](int i) {
+      const ParticleType &ptype = *level_types[i];
+      ptype.min_mass_spectral();
+      if (ptype.is_stable()) {
+        return;
+      }
+      ptype.spectral_function(ptype.mass());
+      ptype.mass_distribution();
+      for (const auto &mode : ptype.decay_modes().decay_mode_list()) {
+        if (mode->type().is_dilepton_decay()) {
+          mode->type().width(ptype.mass(), ptype.width_at_pole(),
+                             ptype.mass());
+        }
+      }
+      ptype.tabulated_width(ptype.mass(), WhichDecaymodes::All);
+    });
+  }
+}
+
 bool ParticleType::wanted_decaymode(const DecayType &t,
                                     WhichDecaymodes wh) const {
   switch (wh) {
@@ -495,12 +676,7 @@ DecayBranchList ParticleType::get_partial_widths(const FourVector p,
    * particle */
   FourVector UB = FourVector();
   FourVector UI3 = FourVector();
-  if (UB_lat_pointer != nullptr) {
-    UB_lat_pointer->value_at(x, UB);
-  }
-  if (UI3_lat_pointer != nullptr) {
-    UI3_lat_pointer->value_at(x, UI3);
-  }
+  gather_potentials(x, UB, UI3);
   /* Loop over decay modes and calculate all partial widths. */
   DecayBranchList partial;
   partial.reserve(decay_mode_list.size());
@@ -531,6 +707,59 @@ DecayBranchList ParticleType::get_partial_widths(const FourVector p,
   return partial;
 }
 
+/// Number of intervals of the tabulated widths
+static constexpr std::size_t n_width_intervals = 1000;
+
+/// Largest tabulated mass, relative to the pole mass in units of the width
+static constexpr double max_width_table_mass = 50.;
+
+double ParticleType::tabulated_width(double m, WhichDecaymodes wh) const {
+  if (is_stable()) {
+    return 0.;
+  }
+  const auto &modes = decay_modes().decay_mode_list();
+  const double m0 = mass();
+  const double width = width_at_pole();
+  const double x_max = std::atan(max_width_table_mass);
+  auto sum_widths = [&](double mass, bool dilepton) {
+    double w = 0.;
+    for (const auto &mode : modes) {
+      if (mode->type().is_dilepton_decay() == dilepton) {
+        w += partial_width(mass, mode.get());
+      }
+    }
+    return w;
+  };
+  const double x = std::atan((m - m0) / width);
+  if (x > x_max) {
+    return (wh == WhichDecaymodes::Dileptons ? 0. : sum_widths(m, false)) +
+           (wh == WhichDecaymodes::Hadronic ? 0. : sum_widths(m, true));
+  }
+  if (!width_tables_) {
+    const double x_min = std::atan((min_mass_kinematic() - m0) / width);
+    width_tables_ = std::make_shared<const std::vector<Tabulation>>(
+        TabulationCache::get(
+            "widths_" + pdgcode().string(),
+            std::to_string(n_width_intervals) + " " +
+                std::to_string(max_width_table_mass),
+            [&]() {
+              std::vector<Tabulation> result;
+              for (bool dilepton : {false, true}) {
+                result.emplace_back(x_min, x_max - x_min, n_width_intervals,
+                                    [&](double xi) {
+                                      return sum_widths(
+                                          m0 + width * std::tan(xi), dilepton);
+                                    });
+              }
+              return result;
+            }));
+  }
+  const std::vector<Tabulation> &tables = *width_tables_;
+  return (wh == WhichDecaymodes::Dileptons ? 0.
+                                           : tables[0].get_value_linear(x)) +
+         (wh == WhichDecaymodes::Hadronic ? 0. : tables[1].get_value_linear(x));
+}
+
 double ParticleType::get_partial_width(const double m,
                                        const ParticleTypePtrList dlist) const {
   /* Get all decay modes. */
@@ -570,7 +799,7 @@ double ParticleType::spectral_function(double m) const {
   if (norm_factor_ < 0.) {
     /* Initialize the normalization factor
      * by integrating over the unnormalized spectral function. */
-    static /*thread_local (see #3075)*/ Integrator integrate;
+    static thread_local Integrator integrate;
     const double width = width_at_pole();
     const double m_pole = mass();
     // We transform the integral using m = m_min + width_pole * tan(x), to
@@ -610,6 +839,89 @@ double ParticleType::spectral_function_simple(double m) const {
   return breit_wigner_nonrel(m, mass(), width_at_pole());
 }
 
+/// Number of bins of the tabulated spectral functions
+static constexpr std::size_t n_mass_bins = 2000;
+
+const random::piecewise_constant_dist *ParticleType::mass_distribution()
+    const {
+  if (is_stable()) {
+    return nullptr;
+  }
+  if (!mass_distribution_) {
+    const double m0 = mass();
+    const double width = width_at_pole();
+    const double x_min = std::atan((min_mass_spectral() - m0) / width);
+    const double bin_width = (M_PI / 2. - x_min) / n_mass_bins;
+    /* The density in x is tabulated against the index of the bin, such that
+     * each bin is looked up exactly. */
+    const std::vector<Tabulation> tabulations = TabulationCache::get(
+        "mass_distribution_" + pdgcode().string(), std::to_string(n_mass_bins),
+        [&]() {
+          std::vector<Tabulation> result;
+          result.emplace_back(0., n_mass_bins - 1., n_mass_bins - 1,
+                              [&](double k) {
+                                const double tanx =
+                                    std::tan(x_min + (k + 0.5) * bin_width);
+                                return spectral_function_no_norm(
+                                           m0 + width * tanx) *
+                                       (1. + tanx * tanx);
+                              });
+          return result;
+        });
+    std::vector<double> weights(n_mass_bins);
+    for (std::size_t k = 0; k < n_mass_bins; k++) {
+      weights[k] = tabulations.front().get_value_step(k);
+    }
+    mass_distribution_ = std::make_shared<random::piecewise_constant_dist>(
+        x_min, M_PI / 2., weights);
+  }
+  return mass_distribution_.get();
+}
+
+namespace {
+/**
+ * Samples the mass of a resonance from its tabulated spectral function,
+ * below a maximum mass.
+ */
+class TruncatedSpectralFunction {
+ public:
+  /**
+   * Prepare the sampling.
+   *
+   * \param[in] type Type of the resonance
+   * \param[in] max_mass Largest mass to be sampled
+   */
+  TruncatedSpectralFunction(const ParticleType &type, double max_mass)
+      : type_(type),
+        max_mass_(max_mass),
+        distribution_(type.mass_distribution()),
+        cdf_max_(distribution_ ? distribution_->cdf(std::atan(
+                                     (max_mass - type.mass()) /
+                                     type.width_at_pole()))
+                               : 0.) {}
+
+  /// \return Whether the spectral function is tabulated below max_mass
+  bool valid() const { return cdf_max_ > 0.; }
+
+  /// \return Sampled mass
+  double operator()() const {
+    const double x = distribution_->inverse_cdf(cdf_max_ * random::canonical());
+    return std::min(type_.mass() + type_.width_at_pole() * std::tan(x),
+                    max_mass_);
+  }
+
+ private:
+  /// Type of the resonance
+  const ParticleType &type_;
+  /// Largest mass to be sampled
+  const double max_mass_;
+  /// Tabulated spectral function
+  const random::piecewise_constant_dist *distribution_;
+  /// Fraction of the spectral function below the largest mass
+  const double cdf_max_;
+};
+}  // namespace
+
 /* Resonance mass sampling for 2-particle final state */
 double ParticleType::sample_resonance_mass(const double mass_stable,
                                            const double cms_energy,
@@ -624,19 +936,38 @@ double ParticleType::sample_resonance_mass(const double mass_stable,
   // largest possible cm momentum (from smallest mass)
   const double pcm_max = pCM(cms_energy, mass_stable, min_mass);
   const double blw_max = pcm_max * blatt_weisskopf_sqr(pcm_max, L);
+
+  /* Sample the spectral function from its tabulation, only the momentum
+   * factor, which is largest at the smallest mass, is left for rejection. */
+  const TruncatedSpectralFunction spectral_function(*this, max_mass);
+  if (spectral_function.valid()) {
+    double mass_res, blw;
+    do {
+      mass_res = spectral_function();
+      const double pcm = pCM(cms_energy, mass_stable, mass_res);
+      blw = pcm * blatt_weisskopf_sqr(pcm, L);
+    } while (blw < random::uniform(0., blw_max));
+    return mass_res;
+  }
+
   /* The maximum of the spectral-function ratio 'usually' happens at the
    * largest mass. However, this is not always the case, therefore we need
    * and additional fudge factor (determined automatically). Additionally,
    * a heuristic knowledge is used that usually such mass exist that
-   * spectral_function(m) > spectral_function_simple(m). */
+   * spectral_function(m) > spectral_function_simple(m). The fudge factor is
+   * only kept within this call, such that the sampled mass only depends on
+   * the random stream of the caller and not on earlier calls of other
+   * ensembles or threads. The tabulated spectral function above is missing
+   * only close to the threshold, where the ratio hardly changes. */
   const double sf_ratio_max =
       std::max(1., this->spectral_function(max_mass) /
                        this->spectral_function_simple(max_mass));
 
   double mass_res, val;
+  double max_factor = 1.;
   // outer loop: repeat if maximum is too small
   do {
-    const double q_max = sf_ratio_max * this->max_factor1_;
+    const double q_max = sf_ratio_max * max_factor;
     const double max = blw_max * q_max;  // maximum value for rejection sampling
     // inner loop: rejection sampling
     do {
@@ -656,9 +987,9 @@ double ParticleType::sample_resonance_mass(const double mass_stable,
     if (val > max) {
       logg[LResonances].debug(
           "maximum is being increased in sample_resonance_mass: ",
-          this->max_factor1_, " ", val / max, " ", this->pdgcode(), " ",
-          mass_stable, " ", cms_energy, " ", mass_res);
-      this->max_factor1_ *= val / max;
+          max_factor, " ", val / max, " ", this->pdgcode(), " ", mass_stable,
+          " ", cms_energy, " ", mass_res);
+      max_factor *= val / max;
     } else {
       break;  // maximum ok, exit loop
     }
@@ -683,10 +1014,25 @@ std::pair<double, double> ParticleType::sample_resonance_masses(
   const double blw_max = pcm_max * blatt_weisskopf_sqr(pcm_max, L);
 
   double mass_1, mass_2, val;
+  // As for one resonance, only the momentum factor is left for rejection
+  const TruncatedSpectralFunction spectral_function_1(t1, max_mass_1);
+  const TruncatedSpectralFunction spectral_function_2(t2, max_mass_2);
+  if (spectral_function_1.valid() && spectral_function_2.valid()) {
+    do {
+      mass_1 = spectral_function_1();
+      mass_2 = spectral_function_2();
+      const double pcm = pCM(cms_energy, mass_1, mass_2);
+      val = pcm * blatt_weisskopf_sqr(pcm, L);
+    } while (val < random::uniform(0., blw_max));
+    return {mass_1, mass_2};
+  }
+
+  // As for one resonance, the fudge factor is only kept within this call
+  double max_factor = 1.;
   // outer loop: repeat if maximum is too small
   do {
     // maximum value for rejection sampling (determined automatically)
-    const double max = blw_max * t1.max_factor2_;
+    const double max = blw_max * max_factor;
     // inner loop: rejection sampling
     do {
       // sample mass from a simple Breit-Wigner (aka Cauchy) distribution
@@ -708,9 +1054,9 @@ std::pair<double, double> ParticleType::sample_resonance_masses(
     if (val > max) {
       logg[LResonances].debug(
           "maximum is being increased in sample_resonance_masses: ",
-          t1.max_factor2_, " ", val / max, " ", t1.pdgcode(), " ", t2.pdgcode(),
+          max_factor, " ", val / max, " ", t1.pdgcode(), " ", t2.pdgcode(),
           " ", cms_energy, " ", mass_1, " ", mass_2);
-      t1.max_factor2_ *= val / max;
+      max_factor *= val / max;
     } else {
       break;  // maximum ok, exit loop
     }
@@ -767,63 +1113,198 @@ std::ostream &operator<<(std::ostream &out, const ParticleType &type) {
              << ", spin:" << field<2> << pdg.spin() << "/2 ]";
 }
 
-/*
- * This is valid for two particles of the same species because the comparison
- * operator for smart pointers compares the pointed object. In this case, the
- * `std::set<ParticleTypePtr> incoming` will contain one element instead of two.
- */
 ParticleTypePtrList list_possible_resonances(const ParticleTypePtr type_a,
                                              const ParticleTypePtr type_b) {
-  static std::map<std::set<ParticleTypePtr>, ParticleTypePtrList>
-      map_possible_resonances_of;
-  std::set<ParticleTypePtr> incoming{type_a, type_b};
-  const ParticleTypePtrList incoming_types = {type_a, type_b};
-  // Fill map if set is not yet present
-  if (map_possible_resonances_of.count(incoming) == 0) {
-    logg[LResonances].debug()
-        << "Filling map of compatible resonances for ptypes " << type_a->name()
-        << " " << type_b->name();
-    ParticleTypePtrList resonance_list{};
-    // The tests below are redundant as the decay modes already obey them, but
-    // they are quicker to check and so improve performance.
-    for (const ParticleType &resonance : ParticleType::list_all()) {
-      /* Not a resonance, go to next type of particle */
-      if (resonance.is_stable()) {
+  ParticleTypePtrList resonance_list;
+  for (const ResonanceFormation &formation :
+       resonance_formations(*type_a, *type_b)) {
+    resonance_list.push_back(formation.resonance);
+  }
+  return resonance_list;
+}
+
+namespace {
+/**
+ * The resonances that can be formed from all pairs of particle types.
+ *
+ * The formations of each pair are stored contiguously, in the order of the
+ * pairs, and the decay channels of each formation as well.
+ */
+struct ResonanceFormationTable {
+  /// Decay channels of all formations
+  std::vector<FormationChannel> channels;
+  /// Formations of all pairs
+  std::vector<ResonanceFormation> formations;
+  /// Formations of each pair, starting at the offset of the pair
+  std::vector<std::uint32_t> offsets;
+  /**
+   * Resonances of each pair sorted by their pole masses, starting at the same
+   * offsets as the formations
+   */
+  std::vector<ParticleTypePtr> by_mass;
+};
+}  // unnamed namespace
+
+/**
+ * \param[in] type Particle type
+ * \return Index of the type in ParticleType::list_all
+ */
+static std::size_t type_index(const ParticleType &type) {
+  // std::addressof, because ParticleType overloads operator&
+  return std::addressof(type) - std::addressof(ParticleType::list_all()[0]);
+}
+
+/**
+ * \param[in] i Index of the first particle type
+ * \param[in] j Index of the second particle type
+ * \return Index of the unordered pair of types
+ */
+static std::size_t pair_index(std::size_t i, std::size_t j) {
+  if (i > j) {
+    std::swap(i, j);
+  }
+  return j * (j + 1) / 2 + i;
+}
+
+/**
+ * Find the resonances that can be formed from all pairs of particle types.
+ *
+ * Instead of checking all resonances for every pair, the two-body decays of
+ * every resonance are sorted into the pairs of their final states.
+ *
+ * \return The table of the formations
+ */
+static ResonanceFormationTable build_resonance_formations() {
+  const ParticleTypeList &types = ParticleType::list_all();
+  const std::size_t n_pairs = types.size() * (types.size() + 1) / 2;
+
+  // A formation whose decay channels are not stored in the table yet
+  struct Pending {
+    std::size_t pair;
+    ResonanceFormation formation;
+    std::vector<FormationChannel> channels;
+  };
+  std::vector<Pending> pending;
+  std::size_t n_channels = 0;
+  for (const ParticleType &resonance : types) {
+    if (resonance.is_stable()) {
+      continue;
+    }
+    const std::size_t first_of_resonance = pending.size();
+    for (const auto &mode : resonance.decay_modes().decay_mode_list()) {
+      const DecayType &decay = mode->type();
+      if (decay.particle_number() != 2) {
         continue;
       }
+      const ParticleType &type_a = *decay.particle_types()[0];
+      const ParticleType &type_b = *decay.particle_types()[1];
       // Same resonance as in the beginning, ignore
-      if ((resonance.pdgcode() == type_a->pdgcode()) ||
-          (resonance.pdgcode() == type_b->pdgcode())) {
+      if (resonance.pdgcode() == type_a.pdgcode() ||
+          resonance.pdgcode() == type_b.pdgcode()) {
         continue;
       }
-      // Check for charge conservation.
-      if (resonance.charge() != type_a->charge() + type_b->charge()) {
-        continue;
-      }
-      // Check for baryon-number conservation.
-      if (resonance.baryon_number() !=
-          type_a->baryon_number() + type_b->baryon_number()) {
-        continue;
-      }
-      // Check for strangeness conservation.
-      if (resonance.strangeness() !=
-          type_a->strangeness() + type_b->strangeness()) {
-        continue;
-      }
-      const auto &decaymodes = resonance.decay_modes().decay_mode_list();
-      for (const auto &mode : decaymodes) {
-        if (mode->type().has_particles(incoming_types)) {
-          resonance_list.push_back(&resonance);
-          break;
-        }
+      const std::size_t pair =
+          pair_index(type_index(type_a), type_index(type_b));
+      // Several decay modes of a resonance may lead to the same particles
+      auto it = std::find_if(
+          pending.begin() + first_of_resonance, pending.end(),
+          [&](const Pending &p) { return p.pair == pair; });
+      if (it == pending.end()) {
+        const int sym_factor = (type_a.pdgcode() == type_b.pdgcode()) ? 2 : 1;
+        const double spin_factor =
+            sym_factor * static_cast<double>(resonance.spin() + 1) /
+            ((type_a.spin() + 1) * (type_b.spin() + 1));
+        const double threshold =
+            type_a.min_mass_kinematic() + type_b.min_mass_kinematic();
+        pending.push_back(
+            {pair, {&resonance, spin_factor, threshold, nullptr, 0}, {}});
+        it = pending.end() - 1;
       }
+      it->channels.push_back(
+          {&decay, resonance.width_at_pole() * mode->weight()});
+      n_channels++;
     }
-    // Here `resonance_list` can be empty, corresponding to the case where there
-    // are no possible resonances.
-    map_possible_resonances_of[incoming] = resonance_list;
   }
+  // Sort by pair, keeping the order of the resonances within each pair
+  std::stable_sort(
+      pending.begin(), pending.end(),
+      [](const Pending &a, const Pending &b) { return a.pair < b.pair; });
+
+  ResonanceFormationTable table;
+  // The channels are referred to by pointers, so they must not be reallocated
+  table.channels.reserve(n_channels);
+  table.formations.reserve(pending.size());
+  table.offsets.assign(n_pairs + 1, 0);
+  for (Pending &p : pending) {
+    ResonanceFormation formation = p.formation;
+    formation.channels = table.channels.data() + table.channels.size();
+    formation.n_channels = p.channels.size();
+    table.channels.insert(table.channels.end(), p.channels.begin(),
+                          p.channels.end());
+    table.formations.push_back(formation);
+    table.offsets[p.pair + 1]++;
+  }
+  for (std::size_t pair = 0; pair < n_pairs; pair++) {
+    table.offsets[pair + 1] += table.offsets[pair];
+  }
+  for (const ResonanceFormation &formation : table.formations) {
+    table.by_mass.push_back(formation.resonance);
+  }
+  for (std::size_t pair = 0; pair < n_pairs; pair++) {
+    // Resonances of the same mass stay in the order of the formations
+    std::stable_sort(
+        table.by_mass.begin() + table.offsets[pair],
+        table.by_mass.begin() + table.offsets[pair + 1],
+        [](ParticleTypePtr a, ParticleTypePtr b) {
+          return a->mass() < b->mass();
+        });
+  }
+  logg[LResonances].debug("Found ", table.formations.size(),
+                          " resonance formations with ", n_channels,
+                          " decay channels");
+  return table;
+}
+
+/// \return The table of the formations, which is built at the first call
+static const ResonanceFormationTable &resonance_formation_table() {
+  static const ResonanceFormationTable table = build_resonance_formations();
+  return table;
+}
+
+ResonanceFormationSpan resonance_formations(const ParticleType &type_a,
+                                            const ParticleType &type_b) {
+  const ResonanceFormationTable &table = resonance_formation_table();
+  const std::size_t pair = pair_index(type_index(type_a), type_index(type_b));
+  const ResonanceFormation *formations = table.formations.data();
+  return {formations + table.offsets[pair],
+          formations + table.offsets[pair + 1]};
+}
 
-  return map_possible_resonances_of[incoming];
+ParticleTypePtr possible_resonance_by_mass(const ParticleType &type_a,
+                                           const ParticleType &type_b,
+                                           double mass) {
+  const ResonanceFormationTable &table = resonance_formation_table();
+  const std::size_t pair = pair_index(type_index(type_a), type_index(type_b));
+  const auto begin = table.by_mass.begin() + table.offsets[pair];
+  const auto end = table.by_mass.begin() + table.offsets[pair + 1];
+  if (begin == end) {
+    return {};
+  }
+  auto lighter_than = [](double m, ParticleTypePtr type) {
+    return m < type->mass();
+  };
+  // The first resonance heavier than the mass and the one just below
+  const auto above = std::upper_bound(begin, end, mass, lighter_than);
+  if (above == begin) {
+    return *above;
+  }
+  const double mass_below = (*(above - 1))->mass();
+  if (above != end && (*above)->mass() - mass < mass - mass_below) {
+    return *above;
+  }
+  // The first of the resonances with the same mass below
+  return *std::upper_bound(begin, above, std::nextafter(mass_below, 0.),
+                           lighter_than);
 }
 
 }  // namespace smash
@@ -9,6 +9,11 @@
 
 #include "smash/pauliblocking.h"
 
+#include <algorithm>
+#include <cassert>
+#include <limits>
+#include <utility>
+
 #include "smash/constants.h"
 #include "smash/logging.h"
 
@@ -22,7 +27,8 @@ PauliBlocker::PauliBlocker(Configuration conf,
       rr_(conf.take({"Spatial_Averaging_Radius"}, 1.86)),
       rp_(conf.take({"Momentum_Averaging_Radius"}, 0.08)),
       ntest_(param.testparticles),
-      n_ensembles_(param.n_ensembles) {
+      n_ensembles_(param.n_ensembles),
+      use_lattice_(conf.take({"Use_Lattice"}, false)) {
   if (ntest_ * n_ensembles_ < 20) {
     logg[LPauliBlocking].warn(
         "Phase-space density calculation in Pauli blocking will not work "
@@ -46,48 +52,317 @@ double PauliBlocker::phasespace_dens(const ThreeVector &r, const ThreeVector &p,
                                      const std::vector<Particles> &ensembles,
                                      const PdgCode pdg,
                                      const ParticleList &disregard) const {
+  // Do not count particles that should be disregarded.
+  auto to_disregard = [&disregard](const ParticleData &part) {
+    return std::any_of(disregard.begin(), disregard.end(),
+                       [&part](const ParticleData &disregard_part) {
+                         return part.id() == disregard_part.id();
+                       });
+  };
+  if (index_built_ && lattice_ && pdg.is_baryon()) {
+    return lattice_phasespace_dens(r, p, pdg, disregard);
+  }
   double f = 0.0;
+  if (!index_built_ || !pdg.is_baryon()) {
+    for (const Particles &particles : ensembles) {
+      for (const ParticleData &part : particles) {
+        // Only consider identical particles
+        if (part.pdgcode() != pdg) {
+          continue;
+        }
+        // Only consider momenta in sphere of radius rp_ with center at p
+        const double pdist_sqr = (part.momentum().threevec() - p).sqr();
+        if (pdist_sqr > rp_ * rp_) {
+          continue;
+        }
+        const double rdist_sqr = (part.position().threevec() - r).sqr();
+        // Only consider coordinates in sphere of radius rr_+rc_ with center r
+        if (rdist_sqr >= (rr_ + rc_) * (rr_ + rc_) || to_disregard(part)) {
+          continue;
+        }
+        f += weight(rdist_sqr);
+      }  // loop over particles in one ensemble
+    }    // loop over ensembles
+    return f / ntest_ / n_ensembles_;
+  }
+
+  const auto species = index_.find(pdg);
+  if (species == index_.end()) {
+    return 0.0;
+  }
+  // Only the cells neighbouring the ones of r and p can contain particles
+  static thread_local std::vector<int> candidates;
+  candidates.clear();
+  const std::array<int, 3> r_cell = cell_of(r, inv_spatial_length_);
+  const std::array<int, 3> p_cell = cell_of(p, inv_momentum_length_);
+  for (int rz = -1; rz <= 1; rz++) {
+    for (int ry = -1; ry <= 1; ry++) {
+      for (int rx = -1; rx <= 1; rx++) {
+        const auto spatial = species->second.find(
+            cell_key({r_cell[0] + rx, r_cell[1] + ry, r_cell[2] + rz}));
+        if (spatial == species->second.end()) {
+          continue;
+        }
+        for (int pz = -1; pz <= 1; pz++) {
+          for (int py = -1; py <= 1; py++) {
+            for (int px = -1; px <= 1; px++) {
+              const auto cell = spatial->second.find(
+                  cell_key({p_cell[0] + px, p_cell[1] + py, p_cell[2] + pz}));
+              if (cell != spatial->second.end()) {
+                candidates.insert(candidates.end(), cell->second.begin(),
+                                  cell->second.end());
+              }
+            }
+          }
+        }
+      }
+    }
+  }
+  /* Sum in a fixed order, independent of the cells. Cells far away may share
+   * a key, which could add a particle twice. */
+  std::sort(candidates.begin(), candidates.end(), [this](int a, int b) {
+    return std::make_pair(entries_[a].ensemble, entries_[a].particle.id()) <
+           std::make_pair(entries_[b].ensemble, entries_[b].particle.id());
+  });
+  candidates.erase(std::unique(candidates.begin(), candidates.end()),
+                   candidates.end());
+  for (const int i : candidates) {
+    const IndexEntry &entry = entries_[i];
+    // The particles have moved since they were added to the index
+    const ParticleData &part =
+        ensembles[entry.ensemble].lookup(entry.particle);
+    const double pdist_sqr = (part.momentum().threevec() - p).sqr();
+    if (pdist_sqr > rp_ * rp_) {
+      continue;
+    }
+    const double rdist_sqr = (part.position().threevec() - r).sqr();
+    if (rdist_sqr >= (rr_ + rc_) * (rr_ + rc_) || to_disregard(part)) {
+      continue;
+    }
+    f += weight(rdist_sqr);
+  }
+  return f / ntest_ / n_ensembles_;
+}
+
+double PauliBlocker::weight(double rdist_sqr) const {
+  // 1st order interpolation using tabulated values
+  const double i_real = std::sqrt(rdist_sqr) / (rr_ + rc_) * weights_.size();
+  const size_t i = std::floor(i_real);
+  const double rest = i_real - i;
+  if (likely(i + 1 < weights_.size())) {
+    return weights_[i] * rest + weights_[i + 1] * (1. - rest);
+  }
+  return 0.0;
+}
+
+std::uint64_t PauliBlocker::cell_key(const std::array<int, 3> &cell) {
+  // 21 bits per direction; cells further out share keys
+  constexpr int offset = 1 << 20;
+  std::uint64_t key = 0;
+  for (int i = 0; i < 3; i++) {
+    const int c = std::clamp(cell[i], -offset, offset - 1) + offset;
+    key = (key << 21) | static_cast<std::uint64_t>(c);
+  }
+  return key;
+}
+
+std::array<int, 3> PauliBlocker::cell_of(const ThreeVector &v,
+                                         double inv_length) {
+  std::array<int, 3> cell;
+  for (int i = 0; i < 3; i++) {
+    // clamped to stay within int, the keys are clamped further anyway
+    cell[i] = static_cast<int>(
+        std::clamp(std::floor(v[i] * inv_length), -1.e9, 1.e9));
+  }
+  return cell;
+}
+
+void PauliBlocker::build_index(const std::vector<Particles> &ensembles,
+                               double max_drift) {
+  clear_index();
+  /* Particles closer than rr_ + rc_ to a point at the time of the density
+   * were at most max_drift further away when they were added. */
+  inv_spatial_length_ = 1. / (rr_ + rc_ + std::max(max_drift, 0.));
+  inv_momentum_length_ = 1. / std::max(rp_, really_small);
+  index_built_ = true;
+  if (lattice_) {
+    deposit_on_lattice(ensembles);
+    return;
+  }
+  entry_of_id_.resize(ensembles.size());
+  for (std::size_t i_ens = 0; i_ens < ensembles.size(); i_ens++) {
+    for (const ParticleData &part : ensembles[i_ens]) {
+      add_to_index(i_ens, part);
+    }
+  }
+}
+
+void PauliBlocker::update_index(int i_ensemble, const ParticleList &removed,
+                                const ParticleList &added) {
+  if (!index_built_ || lattice_) {
+    return;
+  }
+  for (const ParticleData &part : removed) {
+    remove_from_index(i_ensemble, part);
+  }
+  for (const ParticleData &part : added) {
+    add_to_index(i_ensemble, part);
+  }
+}
+
+void PauliBlocker::clear_index() {
+  index_built_ = false;
+  index_.clear();
+  entries_.clear();
+  entry_of_id_.clear();
+}
 
-  /* TODO(oliiny): looping over all particles is inefficient,
-   * I need only particles within rp_ radius in momentum and
-   * within rr_+rc_ in coordinate space. Some search algorithm might help. */
+void PauliBlocker::add_to_index(int i_ensemble, const ParticleData &p) {
+  if (!p.is_baryon()) {
+    return;
+  }
+  std::vector<int> &cell =
+      index_[p.pdgcode()][cell_key(cell_of(p.position().threevec(),
+                                           inv_spatial_length_))]
+            [cell_key(cell_of(p.momentum().threevec(), inv_momentum_length_))];
+  const int i = entries_.size();
+  cell.push_back(i);
+  entries_.push_back({i_ensemble, p, &cell});
+  entry_of_id_[i_ensemble][p.id()] = i;
+}
+
+void PauliBlocker::remove_from_index(int i_ensemble, const ParticleData &p) {
+  auto &entry_of_id = entry_of_id_[i_ensemble];
+  const auto found = entry_of_id.find(p.id());
+  if (found == entry_of_id.end()) {
+    return;
+  }
+  IndexEntry &entry = entries_[found->second];
+  std::vector<int> &cell = *entry.cell;
+  *std::find(cell.begin(), cell.end(), found->second) = cell.back();
+  cell.pop_back();
+  entry.cell = nullptr;
+  entry_of_id.erase(found);
+}
+
+void PauliBlocker::create_lattice(const std::array<double, 3> &l,
+                                  const std::array<int, 3> &n,
+                                  const std::array<double, 3> &origin,
+                                  bool periodic) {
+  lattice_ = std::make_unique<
+      RectangularLattice<std::unordered_map<std::uint64_t, double>>>(
+      l, n, origin, periodic, LatticeUpdate::EveryTimestep);
+  // Only the nodes close to particles are reset
+  lattice_->set_sparse(true);
+}
+
+std::uint64_t PauliBlocker::lattice_key(int species,
+                                        const std::array<int, 3> &cell) {
+  // 18 bits per direction; cells further out share keys
+  constexpr int offset = 1 << 17;
+  std::uint64_t key = static_cast<std::uint64_t>(species);
+  for (int i = 0; i < 3; i++) {
+    const int c = std::clamp(cell[i], -offset, offset - 1) + offset;
+    key = (key << 18) | static_cast<std::uint64_t>(c);
+  }
+  return key;
+}
+
+void PauliBlocker::deposit_on_lattice(const std::vector<Particles> &ensembles) {
+  lattice_->reset();
+  const double r_max = rr_ + rc_;
+  const std::array<double, 3> cube = {r_max, r_max, r_max};
+  deposited_id_max_ = std::numeric_limits<int32_t>::max();
+  std::vector<std::uint64_t> keys;
   for (const Particles &particles : ensembles) {
+    int32_t id_max = -1;
     for (const ParticleData &part : particles) {
-      // Only consider identical particles
-      if (part.pdgcode() != pdg) {
-        continue;
-      }
-      // Only consider momenta in sphere of radius rp_ with center at p
-      const double pdist_sqr = (part.momentum().threevec() - p).sqr();
-      if (pdist_sqr > rp_ * rp_) {
-        continue;
-      }
-      const double rdist_sqr = (part.position().threevec() - r).sqr();
-      // Only consider coordinates in sphere of radius rr_+rc_ with center at r
-      if (rdist_sqr >= (rr_ + rc_) * (rr_ + rc_)) {
+      id_max = std::max(id_max, part.id());
+      if (!part.is_baryon()) {
         continue;
       }
-      // Do not count particles that should be disregarded.
-      bool to_disregard = false;
-      for (const auto &disregard_part : disregard) {
-        if (part.id() == disregard_part.id()) {
-          to_disregard = true;
+      const int species =
+          species_.emplace(part.pdgcode(), species_.size()).first->second;
+      assert(species < (1 << 10));
+      /* The momentum cells are as large as rp_, so the one of the particle
+       * and some of its neighbours have their centre within rp_. */
+      const ThreeVector mom = part.momentum().threevec();
+      const std::array<int, 3> p_cell = cell_of(mom, inv_momentum_length_);
+      keys.clear();
+      for (int pz = -1; pz <= 1; pz++) {
+        for (int py = -1; py <= 1; py++) {
+          for (int px = -1; px <= 1; px++) {
+            const std::array<int, 3> cell = {p_cell[0] + px, p_cell[1] + py,
+                                             p_cell[2] + pz};
+            const ThreeVector center(
+                (cell[0] + 0.5) / inv_momentum_length_,
+                (cell[1] + 0.5) / inv_momentum_length_,
+                (cell[2] + 0.5) / inv_momentum_length_);
+            if ((center - mom).sqr() <= rp_ * rp_) {
+              keys.push_back(lattice_key(species, cell));
+            }
+          }
         }
       }
-      if (to_disregard) {
-        continue;
-      }
-      // 1st order interpolation using tabulated values
-      const double i_real =
-          std::sqrt(rdist_sqr) / (rr_ + rc_) * weights_.size();
-      const size_t i = std::floor(i_real);
-      const double rest = i_real - i;
-      if (likely(i + 1 < weights_.size())) {
-        f += weights_[i] * rest + weights_[i + 1] * (1. - rest);
-      }
-    }  // loop over particles in one ensemble
-  }    // loop over ensembles
-  return f / ntest_ / n_ensembles_;
+      const ThreeVector pos = part.position().threevec();
+      std::array<int, 3> l_bounds, u_bounds;
+      lattice_->rectangle_bounds(pos, cube, l_bounds, u_bounds);
+      lattice_->mark_occupied(l_bounds, u_bounds);
+      lattice_->iterate_indices_in_rectangle(
+          pos, cube, [&](int index, int ix, int iy, int iz) {
+            const double rdist_sqr =
+                (lattice_->cell_center(ix, iy, iz) - pos).sqr();
+            if (rdist_sqr >= r_max * r_max) {
+              return;
+            }
+            const double w = weight(rdist_sqr);
+            auto &node = (*lattice_)[index];
+            for (const std::uint64_t key : keys) {
+              node[key] += w;
+            }
+          });
+    }
+    deposited_id_max_ = std::min(deposited_id_max_, id_max);
+  }
+}
+
+double PauliBlocker::lattice_phasespace_dens(
+    const ThreeVector &r, const ThreeVector &p, const PdgCode pdg,
+    const ParticleList &disregard) const {
+  const auto species = species_.find(pdg);
+  std::array<int, 3> node;
+  for (int i = 0; i < 3; i++) {
+    node[i] = static_cast<int>(std::floor((r[i] - lattice_->origin()[i]) /
+                                          lattice_->cell_sizes()[i]));
+  }
+  if (species == species_.end() ||
+      lattice_->out_of_bounds(node[0], node[1], node[2])) {
+    return 0.0;
+  }
+  const std::array<int, 3> p_cell = cell_of(p, inv_momentum_length_);
+  const auto &values = lattice_->node(node[0], node[1], node[2]);
+  const auto found = values.find(lattice_key(species->second, p_cell));
+  if (found == values.end()) {
+    return 0.0;
+  }
+  double f = found->second;
+  // The disregarded particles were deposited as well, if they existed then
+  const ThreeVector r_center = lattice_->cell_center(node[0], node[1], node[2]);
+  const ThreeVector p_center((p_cell[0] + 0.5) / inv_momentum_length_,
+                             (p_cell[1] + 0.5) / inv_momentum_length_,
+                             (p_cell[2] + 0.5) / inv_momentum_length_);
+  const double r_max = rr_ + rc_;
+  for (const ParticleData &part : disregard) {
+    if (part.pdgcode() != pdg || part.id() > deposited_id_max_ ||
+        (part.momentum().threevec() - p_center).sqr() > rp_ * rp_) {
+      continue;
+    }
+    const double rdist_sqr = (part.position().threevec() - r_center).sqr();
+    if (rdist_sqr < r_max * r_max) {
+      f -= weight(rdist_sqr);
+    }
+  }
+  return std::max(f, 0.0) / ntest_ / n_ensembles_;
 }
 
 void PauliBlocker::init_weights_analytical() {
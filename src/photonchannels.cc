@@ -0,0 +1,36 @@
+/*
+ *
+ *    Copyright (c) 2024
+ *      SMASH Team
+ *
+ *    GNU General Public License (GPLv3 or later)
+ *
+ */
+
+#include "smash/photonchannels.h"
+
+#include "smash/bremsstrahlungaction.h"
+#include "smash/scatteractionphoton.h"
+
+namespace smash {
+
+PhotonChannels::PhotonChannels()
+    : first_type_(std::addressof(ParticleType::list_all()[0])),
+      n_types_(ParticleType::list_all().size()),
+      channels_(n_types_ * n_types_, 0) {
+  const ParticleTypeList &types = ParticleType::list_all();
+  for (std::size_t i = 0; i < n_types_; i++) {
+    for (std::size_t j = 0; j < n_types_; j++) {
+      const ParticleList in{ParticleData(types[i]), ParticleData(types[j])};
+      std::uint8_t &flags = channels_[i * n_types_ + j];
+      if (ScatterActionPhoton::is_photon_reaction(in)) {
+        flags |= photon;
+      }
+      if (BremsstrahlungAction::is_bremsstrahlung_reaction(in)) {
+        flags |= bremsstrahlung;
+      }
+    }
+  }
+}
+
+}  // namespace smash
@@ -0,0 +1,105 @@
+/*
+ *
+ *    Copyright (c) 2024
+ *      SMASH Team
+ *
+ *    GNU General Public License (GPLv3 or later)
+ *
+ */
+
+#include "smash/poolallocated.h"
+
+#include <new>
+
+namespace smash {
+
+namespace {
+/// Step between the sizes of the free lists in bytes
+constexpr std::size_t granularity = 16;
+/// Number of free lists
+constexpr std::size_t n_sizes = PoolAllocated::max_pooled_size / granularity;
+
+/// A block of memory in a free list
+struct FreeBlock {
+  /// Next free block of the same size
+  FreeBlock *next;
+};
+
+/**
+ * Free lists of a thread. They are trivially destructible, such that they can
+ * be used until the end of the thread.
+ */
+struct FreeLists {
+  /// First free block of each size
+  FreeBlock *first[n_sizes];
+  /// Number of free blocks of each size
+  std::size_t count[n_sizes];
+  /// Whether the blocks were released, because the thread ends
+  bool released;
+};
+
+/// Free lists of this thread
+thread_local FreeLists free_lists{};
+
+/// Releases the free blocks of a thread when it ends
+struct Releaser {
+  /// Release all free blocks and return later memory to the global heap.
+  ~Releaser() {
+    for (std::size_t i = 0; i < n_sizes; i++) {
+      while (free_lists.first[i] != nullptr) {
+        FreeBlock *block = free_lists.first[i];
+        free_lists.first[i] = block->next;
+        ::operator delete(block);
+      }
+      free_lists.count[i] = 0;
+    }
+    free_lists.released = true;
+  }
+};
+
+/**
+ * \param[in] size Size of an object in bytes
+ * \return Index of the free list holding blocks for the object
+ */
+constexpr std::size_t size_index(std::size_t size) {
+  return (size + granularity - 1) / granularity - 1;
+}
+}  // namespace
+
+void *PoolAllocated::operator new(std::size_t size) {
+  if (size == 0 || size > max_pooled_size || free_lists.released) {
+    return ::operator new(size);
+  }
+  const std::size_t i = size_index(size);
+  FreeBlock *block = free_lists.first[i];
+  if (block == nullptr) {
+    return ::operator new((i + 1) * granularity);
+  }
+  free_lists.first[i] = block->next;
+  free_lists.count[i]--;
+  return block;
+}
+
+void PoolAllocated::operator delete(void *pointer,
+                                    std::size_t size) noexcept {
+  if (pointer == nullptr) {
+    return;
+  }
+  if (size == 0 || size > max_pooled_size) {
+    ::operator delete(pointer);
+    return;
+  }
+  const std::size_t i = size_index(size);
+  if (free_lists.released || free_lists.count[i] >= max_free_blocks) {
+    ::operator delete(pointer);
+    return;
+  }
+  // The blocks are released when this thread ends
+  thread_local Releaser releaser;
+  FreeBlock *block = static_cast<FreeBlock *>(pointer);
+  block->next = free_lists.first[i];
+  free_lists.first[i] = block;
+  free_lists.count[i]++;
+}
+
+}  // namespace smash
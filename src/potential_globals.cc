@@ -1,6 +1,6 @@
 /*
  *
- *    Copyright (c) 2018-2019
+ *    Copyright (c) 2018-2019,2024
  *      SMASH Team
  *
  *    GNU General Public License (GPLv3 or later)
@@ -16,4 +16,20 @@ RectangularLattice<FourVector> *UB_lat_pointer = nullptr;
 RectangularLattice<FourVector> *UI3_lat_pointer = nullptr;
 Potentials *pot_pointer = nullptr;
 
+void gather_potentials(const ThreeVector &r, FourVector &UB, FourVector &UI3) {
+  GatherStencil stencil;
+  if (UB_lat_pointer != nullptr) {
+    UB_lat_pointer->gather_stencil(r, stencil);
+    UB_lat_pointer->gather(stencil, UB);
+  }
+  if (UI3_lat_pointer != nullptr) {
+    // the nodes are only searched again on a lattice of another geometry
+    if (UB_lat_pointer == nullptr ||
+        !UI3_lat_pointer->shares_stencils(UB_lat_pointer)) {
+      UI3_lat_pointer->gather_stencil(r, stencil);
+    }
+    UI3_lat_pointer->gather(stencil, UI3);
+  }
+}
+
 }  // namespace smash
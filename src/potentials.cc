@@ -45,6 +45,9 @@ Potentials::Potentials(Configuration conf, const DensityParameters &param)
   }
   if (use_coulomb_) {
     coulomb_r_cut_ = conf.take({"Coulomb", "R_Cut"});
+    coulomb_use_fft_ = conf.take({"Coulomb", "Use_FFT"},
+                                 InputKeys::potentials_coulomb_useFFT
+                                     .default_value());
   }
   if (use_vdf_) {
     saturation_density_ = conf.take({"VDF", "Sat_rhoB"});
@@ -62,6 +65,8 @@ Potentials::Potentials(Configuration conf, const DensityParameters &param)
       // coefficients are provided in MeV, but the code uses GeV
       coeffs_.push_back(aux_coeffs[i] * mev_to_gev);
       powers_.push_back(aux_powers[i]);
+      scaled_coeffs_.push_back(
+          coeffs_[i] / std::pow(saturation_density_, powers_[i] - 1.0));
     }
   }
 }
@@ -98,7 +103,7 @@ double Potentials::symmetry_pot(const double baryon_isospin_density,
   return pot;
 }
 
-FourVector Potentials::vdf_pot(double rhoB, const FourVector jmuB_net) const {
+std::pair<double, double> Potentials::vdf_factors(double rhoB) const {
   // this needs to be used in order to prevent trying to calculate something
   // like
   // (-rho_B)^{3.4}
@@ -108,20 +113,67 @@ FourVector Potentials::vdf_pot(double rhoB, const FourVector jmuB_net) const {
   if (abs_rhoB < very_small_double) {
     abs_rhoB = very_small_double;
   }
-  // F_2 is a multiplicative factor in front of the baryon current
-  // in the VDF potential
-  double F_2 = 0.0;
+  // rho^(b_i - 2) = exp((b_i - 2) ln(rho)) with the logarithm shared by all
+  // terms, rho^(b_i - 3) follows by one division
+  const double log_rhoB = std::log(abs_rhoB);
+  double F_1 = 0.0, F_2 = 0.0;
   for (int i = 0; i < number_of_terms(); i++) {
-    F_2 += coeffs_[i] * std::pow(abs_rhoB, powers_[i] - 2.0) /
-           std::pow(saturation_density_, powers_[i] - 1.0);
+    const double term =
+        scaled_coeffs_[i] * std::exp((powers_[i] - 2.0) * log_rhoB);
+    F_1 += (powers_[i] - 2.0) * term;
+    F_2 += term;
   }
-  F_2 = F_2 * sgn;
+  return std::make_pair(sgn * F_1 / abs_rhoB, sgn * F_2);
+}
+
+FourVector Potentials::vdf_pot(double rhoB, const FourVector jmuB_net) const {
+  // F_2 is a multiplicative factor in front of the baryon current
+  // in the VDF potential
+  const double F_2 = vdf_factors(rhoB).second;
   // Return in GeV
   return F_2 * jmuB_net;
 }
 
+double Potentials::skyrme_energy_density(double baryon_density) const {
+  const double abs_rhoB = std::abs(baryon_density);
+  if (abs_rhoB < very_small_double) {
+    return 0.0;
+  }
+  // The powers are larger by 1 than those of the potential
+  const double b2 = skyrme_tau_ + 1.0;
+  return mev_to_gev *
+         (0.5 * skyrme_a_ * abs_rhoB * abs_rhoB / nuclear_density +
+          (skyrme_b_ / b2) * std::pow(abs_rhoB, b2) /
+              std::pow(nuclear_density, skyrme_tau_));
+}
+
+double Potentials::vdf_energy_density(double rhoB, double j0B) const {
+  // in order to prevent dividing by zero in case any b_i < 2.0
+  const double abs_rhoB = std::max(std::abs(rhoB), very_small_double);
+  double energy_density = 0.0;
+  for (int i = 0; i < number_of_terms(); i++) {
+    energy_density += coeffs_[i] * std::pow(abs_rhoB, powers_[i] - 2.0) *
+                      (j0B * j0B - ((powers_[i] - 1.0) / powers_[i]) *
+                                       abs_rhoB * abs_rhoB) /
+                      std::pow(saturation_density_, powers_[i] - 1.0);
+  }
+  return energy_density;
+}
+
 double Potentials::potential(const ThreeVector &r, const ParticleList &plist,
                              const ParticleType &acts_on) const {
+  return potential_impl(r, plist, acts_on);
+}
+
+double Potentials::potential(const ThreeVector &r,
+                             const ParticleCellList &cells,
+                             const ParticleType &acts_on) const {
+  return potential_impl(r, cells, acts_on);
+}
+
+template <typename T>
+double Potentials::potential_impl(const ThreeVector &r, const T &particles,
+                                  const ParticleType &acts_on) const {
   double total_potential = 0.0;
   const bool compute_gradient = false;
   const bool smearing = true;
@@ -131,14 +183,14 @@ double Potentials::potential(const ThreeVector &r, const ParticleList &plist,
     return total_potential;
   }
   const auto baryon_density_and_gradient = current_eckart(
-      r, plist, param_, DensityType::Baryon, compute_gradient, smearing);
+      r, particles, param_, DensityType::Baryon, compute_gradient, smearing);
   const double rhoB = std::get<0>(baryon_density_and_gradient);
   if (use_skyrme_) {
     total_potential += scale.first * skyrme_pot(rhoB);
   }
   if (use_symmetry_) {
     const double rho_iso = std::get<0>(
-        current_eckart(r, plist, param_, DensityType::BaryonicIsospin,
+        current_eckart(r, particles, param_, DensityType::BaryonicIsospin,
                        compute_gradient, smearing));
     const double sym_pot = symmetry_pot(rho_iso, rhoB) * acts_on.isospin3_rel();
     total_potential += scale.second * sym_pot;
@@ -199,32 +251,11 @@ std::pair<ThreeVector, ThreeVector> Potentials::vdf_force(
     const ThreeVector gradrhoB_cross_vecjB, const double j0B,
     const ThreeVector grad_j0B, const ThreeVector vecjB,
     const ThreeVector dvecjB_dt, const ThreeVector curl_vecjB) const {
-  // this needs to be used to prevent trying to calculate something like
-  // (-rhoB)^{3.4}
-  const int sgn = rhoB > 0 ? 1 : -1;
   ThreeVector E_component(0.0, 0.0, 0.0), B_component(0.0, 0.0, 0.0);
-  // to prevent NAN expressions
-  double abs_rhoB = std::abs(rhoB);
-  if (abs_rhoB < very_small_double) {
-    abs_rhoB = very_small_double;
-  }
   if (use_vdf_) {
     // F_1 and F_2 are multiplicative factors in front of the baryon current
     // in the VDF potential
-    double F_1 = 0.0;
-    for (int i = 0; i < number_of_terms(); i++) {
-      F_1 += coeffs_[i] * (powers_[i] - 2.0) *
-             std::pow(abs_rhoB, powers_[i] - 3.0) /
-             std::pow(saturation_density_, powers_[i] - 1.0);
-    }
-    F_1 = F_1 * sgn;
-
-    double F_2 = 0.0;
-    for (int i = 0; i < number_of_terms(); i++) {
-      F_2 += coeffs_[i] * std::pow(abs_rhoB, powers_[i] - 2.0) /
-             std::pow(saturation_density_, powers_[i] - 1.0);
-    }
-    F_2 = F_2 * sgn;
+    const auto [F_1, F_2] = vdf_factors(rhoB);
 
     E_component -= (F_1 * (grad_rhoB * j0B + drhoB_dt * vecjB) +
                     F_2 * (grad_j0B + dvecjB_dt));
@@ -270,6 +301,18 @@ double Potentials::dVsym_drhoB(const double rhoB, const double rhoI3) const {
 
 std::tuple<ThreeVector, ThreeVector, ThreeVector, ThreeVector>
 Potentials::all_forces(const ThreeVector &r, const ParticleList &plist) const {
+  return all_forces_impl(r, plist);
+}
+
+std::tuple<ThreeVector, ThreeVector, ThreeVector, ThreeVector>
+Potentials::all_forces(const ThreeVector &r,
+                       const ParticleCellList &cells) const {
+  return all_forces_impl(r, cells);
+}
+
+template <typename T>
+std::tuple<ThreeVector, ThreeVector, ThreeVector, ThreeVector>
+Potentials::all_forces_impl(const ThreeVector &r, const T &particles) const {
   const bool compute_gradient = true;
   const bool smearing = true;
   auto F_skyrme_or_VDF =
@@ -278,7 +321,7 @@ Potentials::all_forces(const ThreeVector &r, const ParticleList &plist) const {
       std::make_pair(ThreeVector(0., 0., 0.), ThreeVector(0., 0., 0.));
 
   const auto baryon_density_and_gradient = current_eckart(
-      r, plist, param_, DensityType::Baryon, compute_gradient, smearing);
+      r, particles, param_, DensityType::Baryon, compute_gradient, smearing);
   double rhoB = std::get<0>(baryon_density_and_gradient);
   const ThreeVector grad_j0B = std::get<2>(baryon_density_and_gradient);
   const ThreeVector curl_vecjB = std::get<3>(baryon_density_and_gradient);
@@ -290,7 +333,7 @@ Potentials::all_forces(const ThreeVector &r, const ParticleList &plist) const {
 
   if (use_symmetry_) {
     const auto density_and_gradient =
-        current_eckart(r, plist, param_, DensityType::BaryonicIsospin,
+        current_eckart(r, particles, param_, DensityType::BaryonicIsospin,
                        compute_gradient, smearing);
     const double rhoI3 = std::get<0>(density_and_gradient);
     const ThreeVector grad_j0I3 = std::get<2>(density_and_gradient);
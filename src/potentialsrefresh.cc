@@ -0,0 +1,106 @@
+/*
+ *
+ *    Copyright (c) 2024
+ *      SMASH Team
+ *
+ *    GNU General Public License (GPLv3 or later)
+ *
+ */
+
+#include "smash/potentialsrefresh.h"
+
+#include <algorithm>
+#include <cmath>
+#include <sstream>
+#include <stdexcept>
+
+#include "smash/constants.h"
+
+namespace smash {
+
+/// Number of nodes, on which the density is compared at most
+static constexpr int max_sampled_nodes = 1024;
+
+PotentialsRefresh::PotentialsRefresh(int max_interval, double threshold)
+    : max_interval_(max_interval), threshold_(threshold) {
+  if (max_interval < 1) {
+    throw std::invalid_argument(
+        "The largest interval between updates of the potentials has to be at "
+        "least one time step.");
+  }
+  if (threshold < 0.) {
+    throw std::invalid_argument(
+        "The threshold for updates of the potentials must not be negative.");
+  }
+}
+
+void PotentialsRefresh::reset() {
+  interval_ = 1;
+  steps_since_refresh_ = 0;
+  sampled_density_.clear();
+  n_timesteps_ = 0;
+  n_refreshes_ = 0;
+  max_deviation_ = 0.;
+}
+
+bool PotentialsRefresh::next_timestep() {
+  n_timesteps_++;
+  steps_since_refresh_++;
+  return steps_since_refresh_ >= interval_;
+}
+
+void PotentialsRefresh::refreshed(const DensityLattice &density) {
+  // an odd stride does not line up with the rows of the lattice
+  const int n_nodes = density.size();
+  const int stride = (n_nodes / max_sampled_nodes) | 1;
+  const bool compare = !sampled_density_.empty();
+  double max_change = 0.;
+  sampled_density_.resize((n_nodes + stride - 1) / stride);
+  for (int i = 0, k = 0; i < n_nodes; i += stride, k++) {
+    const double rho = density[i].rho();
+    max_change = std::max(max_change, std::abs(rho - sampled_density_[k]));
+    sampled_density_[k] = rho;
+  }
+  if (compare) {
+    const double change_per_step =
+        max_change / (nuclear_density * steps_since_refresh_);
+    const int allowed = change_per_step * max_interval_ <= threshold_
+                            ? max_interval_
+                            : static_cast<int>(threshold_ / change_per_step);
+    interval_ = std::clamp(std::min(allowed, 2 * interval_), 1, max_interval_);
+  }
+  steps_since_refresh_ = 0;
+  n_refreshes_++;
+}
+
+void PotentialsRefresh::add_deviation(double deviation) {
+  max_deviation_ = std::max(max_deviation_, deviation);
+}
+
+std::string PotentialsRefresh::report() const {
+  std::ostringstream out;
+  out << "Potentials updated in " << n_refreshes_ << " of " << n_timesteps_
+      << " time steps, largest deviation of the extrapolated potentials: "
+      << 1000. * max_deviation_ << " MeV";
+  return out.str();
+}
+
+void PotentialsRefresh::write_checkpoint(std::ostream &out) const {
+  checkpoint::write(out, interval_);
+  checkpoint::write(out, steps_since_refresh_);
+  checkpoint::write(out, sampled_density_);
+  checkpoint::write(out, n_timesteps_);
+  checkpoint::write(out, n_refreshes_);
+  checkpoint::write(out, max_deviation_);
+}
+
+void PotentialsRefresh::read_checkpoint(std::istream &in) {
+  checkpoint::read(in, interval_);
+  checkpoint::read(in, steps_since_refresh_);
+  checkpoint::read(in, sampled_density_);
+  checkpoint::read(in, n_timesteps_);
+  checkpoint::read(in, n_refreshes_);
+  checkpoint::read(in, max_deviation_);
+}
+
+}  // namespace smash
@@ -0,0 +1,449 @@
+/*
+ *
+ *    Copyright (c) 2024
+ *      SMASH Team
+ *
+ *    GNU General Public License (GPLv3 or later)
+ *
+ */
+
+#include "smash/profiler.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+#include <utility>
+
+#ifdef SMASH_USE_PERF_EVENT
+#include <linux/perf_event.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace smash {
+
+thread_local Profiler::ScopedTimer *Profiler::ScopedTimer::current_ = nullptr;
+
+namespace {
+/// Common origin of the times in the trace
+const std::chrono::steady_clock::time_point trace_origin =
+    std::chrono::steady_clock::now();
+
+/// \return Number of the calling thread, counted in order of first use
+int thread_number() {
+  static std::atomic<int> n_threads{0};
+  thread_local const int number = n_threads++;
+  return number;
+}
+
+/**
+ * \param[in] time Point in time
+ * \return Microseconds since the trace origin
+ */
+double microseconds(std::chrono::steady_clock::time_point time) {
+  return std::chrono::duration<double, std::micro>(time - trace_origin)
+      .count();
+}
+
+#ifdef SMASH_USE_PERF_EVENT
+/**
+ * Hardware counters of one thread, which are opened as a group with
+ * perf_event_open, such that they are read together and count the same code.
+ */
+class CounterGroup {
+ public:
+  /// Open the counters of the calling thread, they count from now on.
+  CounterGroup() {
+    // In the order of Profiler::Counter
+    const std::array<std::uint64_t, Profiler::n_counters> events = {
+        PERF_COUNT_HW_CPU_CYCLES, PERF_COUNT_HW_INSTRUCTIONS,
+        PERF_COUNT_HW_CACHE_MISSES, PERF_COUNT_HW_BRANCH_MISSES};
+    for (int i = 0; i < Profiler::n_counters; i++) {
+      perf_event_attr attr{};
+      attr.type = PERF_TYPE_HARDWARE;
+      attr.size = sizeof(attr);
+      attr.config = events[i];
+      attr.exclude_kernel = 1;
+      attr.exclude_hv = 1;
+      attr.read_format = PERF_FORMAT_GROUP;
+      fds_[i] = static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1,
+                                         i == 0 ? -1 : fds_[0], 0));
+      if (fds_[i] < 0) {
+        close_all();
+        return;
+      }
+    }
+  }
+
+  /// Close the counters.
+  ~CounterGroup() { close_all(); }
+
+  /// Cannot be copied
+  CounterGroup(const CounterGroup &) = delete;
+  /// Cannot be copied
+  CounterGroup &operator=(const CounterGroup &) = delete;
+
+  /**
+   * \param[out] counts Current values of the counters
+   * \return Whether the counters could be read
+   */
+  bool read(Profiler::Counts &counts) const {
+    if (fds_[0] < 0) {
+      return false;
+    }
+    // The number of counters precedes their values
+    std::array<std::uint64_t, Profiler::n_counters + 1> buffer;
+    if (::read(fds_[0], buffer.data(), sizeof(buffer)) !=
+        static_cast<ssize_t>(sizeof(buffer))) {
+      return false;
+    }
+    std::copy(buffer.begin() + 1, buffer.end(), counts.begin());
+    return true;
+  }
+
+ private:
+  /// Close all opened counters.
+  void close_all() {
+    for (int &fd : fds_) {
+      if (fd >= 0) {
+        close(fd);
+      }
+      fd = -1;
+    }
+  }
+
+  /// File descriptors of the counters, the first one leads the group
+  std::array<int, Profiler::n_counters> fds_ = {-1, -1, -1, -1};
+};
+#endif
+
+/**
+ * Read the hardware counters of the calling thread, which are opened on the
+ * first call.
+ *
+ * \param[out] counts Current values of the counters, zero if unavailable
+ * \return Whether the counters are available
+ */
+bool read_counters(Profiler::Counts &counts) {
+#ifdef SMASH_USE_PERF_EVENT
+  thread_local const CounterGroup group;
+  if (group.read(counts)) {
+    return true;
+  }
+#endif
+  counts.fill(0);
+  return false;
+}
+}  // namespace
+
+const char *Profiler::name(Phase phase) {
+  switch (phase) {
+    case Phase::Initialization:
+      return "Initialization";
+    case Phase::Grid:
+      return "Grid";
+    case Phase::ActionFinding:
+      return "Action finding";
+    case Phase::Strings:
+      return "String fragmentation";
+    case Phase::Actions:
+      return "Actions";
+    case Phase::Propagation:
+      return "Propagation";
+    case Phase::Potentials:
+      return "Potentials";
+    case Phase::Output:
+      return "Output";
+    case Phase::FinalDecays:
+      return "Final decays";
+  }
+  throw std::invalid_argument("Unknown profiler phase");
+}
+
+const char *Profiler::name(Counter counter) {
+  switch (counter) {
+    case Counter::Cycles:
+      return "cycles";
+    case Counter::Instructions:
+      return "instructions";
+    case Counter::CacheMisses:
+      return "llc_misses";
+    case Counter::BranchMisses:
+      return "branch_misses";
+  }
+  throw std::invalid_argument("Unknown profiler counter");
+}
+
+Profiler::ScopedTimer::ScopedTimer(Profiler *profiler, Phase phase,
+                                   int ensemble)
+    : profiler_(profiler), phase_(phase), ensemble_(ensemble) {
+  if (!profiler_) {
+    return;
+  }
+  if (profiler_->counting_) {
+    read_counters(start_counts_);
+  }
+  begin_ = start_ = std::chrono::steady_clock::now();
+  parent_ = current_;
+  if (parent_) {
+    parent_->stop(start_, start_counts_);
+  }
+  current_ = this;
+}
+
+Profiler::ScopedTimer::~ScopedTimer() {
+  if (!profiler_) {
+    return;
+  }
+  const auto now = std::chrono::steady_clock::now();
+  Counts counts{};
+  if (profiler_->counting_) {
+    read_counters(counts);
+  }
+  stop(now, counts);
+  current_ = parent_;
+  if (parent_) {
+    parent_->start_ = now;
+    parent_->start_counts_ = counts;
+  }
+  profiler_->add_span(name(phase_), ensemble_, begin_, now);
+}
+
+Profiler::ScopedSpan::ScopedSpan(Profiler *profiler, const char *name,
+                                 int ensemble)
+    : profiler_(profiler), name_(name), ensemble_(ensemble) {
+  if (profiler_) {
+    begin_ = std::chrono::steady_clock::now();
+  }
+}
+
+Profiler::ScopedSpan::~ScopedSpan() {
+  if (profiler_) {
+    profiler_->add_span(name_, ensemble_, begin_,
+                        std::chrono::steady_clock::now());
+  }
+}
+
+void Profiler::ScopedTimer::stop(std::chrono::steady_clock::time_point now,
+                                 const Counts &counts) {
+  const int phase = static_cast<int>(phase_);
+  const auto ns =
+      std::chrono::duration_cast<std::chrono::nanoseconds>(now - start_);
+  profiler_->event_times_[phase].fetch_add(ns.count(),
+                                           std::memory_order_relaxed);
+  if (!profiler_->counting_) {
+    return;
+  }
+  for (int i = 0; i < n_counters; i++) {
+    profiler_->event_counts_[phase][i].fetch_add(counts[i] - start_counts_[i],
+                                                 std::memory_order_relaxed);
+  }
+}
+
+Profiler::Profiler(std::filesystem::path json_path)
+    : json_path_(std::move(json_path)),
+      event_start_(std::chrono::steady_clock::now()) {}
+
+void Profiler::enable_trace(std::filesystem::path trace_path, int n_events,
+                            std::size_t max_spans) {
+  trace_path_ = std::move(trace_path);
+  trace_events_ = n_events;
+  max_spans_ = max_spans;
+}
+
+bool Profiler::enable_counters() {
+  Counts counts;
+  counting_ = read_counters(counts);
+  return counting_;
+}
+
+void Profiler::start_event(int event_number) {
+  event_start_ = std::chrono::steady_clock::now();
+  for (auto &time : event_times_) {
+    time = 0;
+  }
+  for (auto &phase_counts : event_counts_) {
+    for (auto &count : phase_counts) {
+      count = 0;
+    }
+  }
+  traced_event_ = event_number < trace_events_ ? event_number : -1;
+  event_spans_ = 0;
+}
+
+void Profiler::add_span(const char *name, int ensemble,
+                        std::chrono::steady_clock::time_point begin,
+                        std::chrono::steady_clock::time_point end) {
+  // Only changed between events, when no other threads are running
+  if (traced_event_ < 0) {
+    return;
+  }
+  const int thread = thread_number();
+  std::lock_guard<std::mutex> lock(spans_mutex_);
+  if (event_spans_ >= max_spans_) {
+    dropped_spans_++;
+    return;
+  }
+  event_spans_++;
+  spans_.push_back({name, traced_event_, thread, ensemble, microseconds(begin),
+                    microseconds(end) - microseconds(begin)});
+}
+
+std::string Profiler::end_event(int event_number, std::int64_t n_particles) {
+  Record record;
+  record.event = event_number;
+  record.particles = n_particles;
+  record.wall_time = std::chrono::duration<double>(
+                         std::chrono::steady_clock::now() - event_start_)
+                         .count();
+  for (int i = 0; i < n_phases; i++) {
+    record.phases[i] = event_times_[i] * 1e-9;
+    for (int j = 0; j < n_counters; j++) {
+      record.counts[i][j] = event_counts_[i][j];
+    }
+  }
+  events_.push_back(record);
+  return table("Profile of event " + std::to_string(event_number), record);
+}
+
+void Profiler::merge(const Profiler &other) {
+  counting_ = counting_ || other.counting_;
+  events_.insert(events_.end(), other.events_.begin(), other.events_.end());
+  std::sort(events_.begin(), events_.end(),
+            [](const Record &a, const Record &b) { return a.event < b.event; });
+  spans_.insert(spans_.end(), other.spans_.begin(), other.spans_.end());
+  std::stable_sort(
+      spans_.begin(), spans_.end(),
+      [](const Span &a, const Span &b) { return a.event < b.event; });
+  dropped_spans_ += other.dropped_spans_;
+}
+
+Profiler::Record Profiler::total() const {
+  Record sum;
+  for (const Record &record : events_) {
+    sum.wall_time += record.wall_time;
+    sum.particles += record.particles;
+    for (int i = 0; i < n_phases; i++) {
+      sum.phases[i] += record.phases[i];
+      for (int j = 0; j < n_counters; j++) {
+        sum.counts[i][j] += record.counts[i][j];
+      }
+    }
+  }
+  return sum;
+}
+
+std::string Profiler::run_table() const {
+  return table("Profile of " + std::to_string(events_.size()) + " events",
+               total());
+}
+
+std::string Profiler::table(const std::string &title, const Record &record) {
+  std::ostringstream out;
+  char line[80];
+  out << title << " (wall time " << record.wall_time << " s):";
+  std::snprintf(line, sizeof(line), "\n  %-22s %12s %8s", "Phase", "Time [s]",
+                "Share");
+  out << line;
+  for (int i = 0; i < n_phases; i++) {
+    const double time = record.phases[i];
+    const double share =
+        record.wall_time > 0. ? 100. * time / record.wall_time : 0.;
+    std::snprintf(line, sizeof(line), "\n  %-22s %12.3f %7.1f%%",
+                  name(static_cast<Phase>(i)), time, share);
+    out << line;
+  }
+  return out.str();
+}
+
+void Profiler::write_json() const {
+  std::ofstream file(json_path_);
+  if (!file) {
+    throw std::runtime_error("Could not write the profile to " +
+                             json_path_.string());
+  }
+  auto write_record = [&](const Record &record, const std::string &indent) {
+    if (record.event >= 0) {
+      file << indent << "\"event\": " << record.event << ",\n";
+    }
+    file << indent << "\"wall_time\": " << record.wall_time << ",\n"
+         << indent << "\"phases\": {";
+    for (int i = 0; i < n_phases; i++) {
+      file << (i == 0 ? "\n" : ",\n") << indent << "  \""
+           << name(static_cast<Phase>(i)) << "\": " << record.phases[i];
+    }
+    file << "\n" << indent << "}";
+    if (!counting_) {
+      return;
+    }
+    file << ",\n" << indent << "\"particles\": " << record.particles << ",\n"
+         << indent << "\"counters\": {";
+    for (int i = 0; i < n_phases; i++) {
+      const Counts &counts = record.counts[i];
+      file << (i == 0 ? "\n" : ",\n") << indent << "  \""
+           << name(static_cast<Phase>(i)) << "\": {";
+      for (int j = 0; j < n_counters; j++) {
+        file << "\"" << name(static_cast<Counter>(j)) << "\": " << counts[j]
+             << ", ";
+      }
+      // Derived quantities are 0 if they are undefined
+      const double cycles = counts[static_cast<int>(Counter::Cycles)];
+      const double misses = counts[static_cast<int>(Counter::CacheMisses)];
+      file << "\"instructions_per_cycle\": "
+           << (cycles > 0.
+                   ? counts[static_cast<int>(Counter::Instructions)] / cycles
+                   : 0.)
+           << ", \"llc_misses_per_particle\": "
+           << (record.particles > 0 ? misses / record.particles : 0.) << "}";
+    }
+    file << "\n" << indent << "}";
+  };
+  file.precision(9);
+  file << "{\n  \"total\": {\n";
+  write_record(total(), "    ");
+  file << "\n  },\n  \"events\": [";
+  for (std::size_t i = 0; i < events_.size(); i++) {
+    file << (i == 0 ? "\n" : ",\n") << "    {\n";
+    write_record(events_[i], "      ");
+    file << "\n    }";
+  }
+  file << "\n  ]\n}\n";
+}
+
+void Profiler::write_trace() const {
+  std::ofstream file(trace_path_);
+  if (!file) {
+    throw std::runtime_error("Could not write the trace to " +
+                             trace_path_.string());
+  }
+  file.precision(3);
+  file << std::fixed << "{\n  \"displayTimeUnit\": \"ms\",\n"
+       << "  \"otherData\": {\"dropped_spans\": " << dropped_spans_ << "},\n"
+       << "  \"traceEvents\": [";
+  bool first = true;
+  int named_event = -1;
+  for (const Span &span : spans_) {
+    if (span.event != named_event) {
+      // Name the process of the event in the viewer
+      named_event = span.event;
+      file << (first ? "\n" : ",\n")
+           << "    {\"name\": \"process_name\", \"ph\": \"M\", \"pid\": "
+           << span.event << ", \"args\": {\"name\": \"Event " << span.event
+           << "\"}}";
+      first = false;
+    }
+    file << ",\n    {\"name\": \"" << span.name
+         << "\", \"cat\": \"smash\", \"ph\": \"X\", \"ts\": " << span.start
+         << ", \"dur\": " << span.duration << ", \"pid\": " << span.event
+         << ", \"tid\": " << span.thread;
+    if (span.ensemble >= 0) {
+      file << ", \"args\": {\"ensemble\": " << span.ensemble << "}";
+    }
+    file << "}";
+  }
+  file << "\n  ]\n}\n";
+}
+
+}  // namespace smash
@@ -1,6 +1,6 @@
 /*
  *
- *    Copyright (c) 2015-2023
+ *    Copyright (c) 2015-2024
  *      SMASH Team
  *
  *    GNU General Public License (GPLv3 or later)
@@ -9,11 +9,19 @@
 
 #include "smash/propagation.h"
 
+#include <algorithm>
+#include <limits>
+#include <mutex>
+#include <optional>
+
 #include "smash/boxmodus.h"
 #include "smash/collidermodus.h"
 #include "smash/listmodus.h"
 #include "smash/logging.h"
+#include "smash/particlecelllist.h"
+#include "smash/particlessoa.h"
 #include "smash/spheremodus.h"
+#include "smash/threadpool.h"
 
 namespace smash {
 static constexpr int LPropagation = LogArea::Propagation::id;
@@ -41,10 +49,15 @@ double calc_hubble(double time, const ExpansionProperties &metric) {
   return h;
 }
 
-double propagate_straight_line(Particles *particles, double to_time,
-                               const std::vector<FourVector> &beam_momentum) {
+double propagate_straight_line(
+    Particles *particles, double to_time,
+    const std::vector<FourVector> &beam_momentum,
+    std::pair<std::array<double, 3>, std::array<double, 3>> *min_and_length) {
   bool negative_dt_error = false;
   double dt = 0.0;
+  constexpr double infinity = std::numeric_limits<double>::infinity();
+  std::array<double, 3> min_position = {infinity, infinity, infinity};
+  std::array<double, 3> max_position = {-infinity, -infinity, -infinity};
   for (ParticleData &data : *particles) {
     const double t0 = data.position().x0();
     dt = to_time - t0;
@@ -79,6 +92,18 @@ double propagate_straight_line(Particles *particles, double to_time,
     FourVector position = data.position() + distance;
     position.set_x0(to_time);
     data.set_4position(position);
+    if (min_and_length) {
+      for (int i = 0; i < 3; i++) {
+        min_position[i] = std::min(min_position[i], position[i + 1]);
+        max_position[i] = std::max(max_position[i], position[i + 1]);
+      }
+    }
+  }
+  if (min_and_length && !particles->is_empty()) {
+    min_and_length->first = min_position;
+    for (int i = 0; i < 3; i++) {
+      min_and_length->second[i] = max_position[i] - min_position[i];
+    }
   }
   return dt;
 }
@@ -87,118 +112,180 @@ void expand_space_time(Particles *particles,
                        const ExperimentParameters &parameters,
                        const ExpansionProperties &metric) {
   const double dt = parameters.labclock->timestep_duration();
-  for (ParticleData &data : *particles) {
-    // Momentum and position modification to ensure appropriate expansion
-    const double h = calc_hubble(parameters.labclock->current_time(), metric);
-    FourVector delta_mom = FourVector(0.0, h * data.momentum().threevec() * dt);
-    FourVector expan_dist =
-        FourVector(0.0, h * data.position().threevec() * dt);
-
-    logg[LPropagation].debug("Particle ", data,
-                             " expansion motion: ", expan_dist);
-    // New position and momentum
-    FourVector position = data.position() + expan_dist;
-    FourVector momentum = data.momentum() - delta_mom;
+  // Momentum and position modification to ensure appropriate expansion
+  const double h = calc_hubble(parameters.labclock->current_time(), metric);
+  /* The new positions and momenta are computed on a snapshot, such that the
+   * loop can be vectorized, and are written back afterwards. */
+  thread_local ParticlesSoA soa;
+  soa.assign(*particles);
+  const std::size_t n = soa.size();
+  for (std::size_t i = 0; i < n; i++) {
+    soa.x[i] += h * soa.x[i] * dt;
+    soa.y[i] += h * soa.y[i] * dt;
+    soa.z[i] += h * soa.z[i] * dt;
+    soa.px[i] -= h * soa.px[i] * dt;
+    soa.py[i] -= h * soa.py[i] * dt;
+    soa.pz[i] -= h * soa.pz[i] * dt;
+  }
 
+  std::size_t i = 0;
+  for (ParticleData &data : *particles) {
+    const FourVector position(soa.t[i], soa.x[i], soa.y[i], soa.z[i]);
+    logg[LPropagation].debug("Particle ", data, " expansion motion: ",
+                             position - data.position());
     // set the new momentum and position variables
     data.set_4position(position);
-    data.set_4momentum(momentum);
     // force the on shell condition to ensure correct energy
-    data.set_4momentum(data.pole_mass(), data.momentum().threevec());
+    data.set_4momentum(soa.type[i]->mass(),
+                       ThreeVector(soa.px[i], soa.py[i], soa.pz[i]));
+    i++;
   }
 }
 
-void update_momenta(
+double update_momenta(
     std::vector<Particles> &ensembles, double dt, const Potentials &pot,
-    RectangularLattice<std::pair<ThreeVector, ThreeVector>> *FB_lat,
-    RectangularLattice<std::pair<ThreeVector, ThreeVector>> *FI3_lat,
-    RectangularLattice<std::pair<ThreeVector, ThreeVector>> *EM_lat,
-    DensityLattice *jB_lat) {
-  // Copy particles from ALL ensembles to a single list before propagation
-  // and calculate potentials from this list
+    ForceLattice *FB_lat, ForceLattice *FI3_lat, ForceLattice *EM_lat,
+    DensityLattice *jB_lat, ThreadPool *pool) {
+  /* The potentials are only calculated from the particles of ALL ensembles,
+   * if a particle is outside of the lattices. The list is then copied once
+   * for all of them and sorted into cells, such that only the particles
+   * within the cut-off of the smearing are summed over. */
   ParticleList plist;
+  std::optional<ParticleCellList> cells;
+  std::once_flag plist_copied;
+  auto all_particles = [&]() -> const ParticleCellList & {
+    std::call_once(plist_copied, [&]() {
+      for (Particles &particles : ensembles) {
+        const ParticleList tmp = particles.copy_to_vector();
+        plist.insert(plist.end(), tmp.begin(), tmp.end());
+      }
+      cells.emplace(plist, pot.density_parameters().r_cut());
+    });
+    return *cells;
+  };
+
+  // Only baryons and nuclei will be affected by the potentials
+  std::vector<ParticleData *> affected;
   for (Particles &particles : ensembles) {
-    const ParticleList tmp = particles.copy_to_vector();
-    plist.insert(plist.end(), tmp.begin(), tmp.end());
+    for (ParticleData &data : particles) {
+      if (data.is_baryon() || data.is_nucleus()) {
+        affected.push_back(&data);
+      }
+    }
   }
 
-  bool possibly_use_lattice =
-      (pot.use_skyrme() ? (FB_lat != nullptr) : true) &&
-      (pot.use_vdf() ? (FB_lat != nullptr) : true) &&
+  const bool use_FB = pot.use_skyrme() || pot.use_vdf();
+  const bool possibly_use_lattice =
+      (use_FB ? (FB_lat != nullptr) : true) &&
       (pot.use_symmetry() ? (FI3_lat != nullptr) : true);
-  std::pair<ThreeVector, ThreeVector> FB, FI3, EM_fields;
-  double min_time_scale = std::numeric_limits<double>::infinity();
 
-  for (Particles &particles : ensembles) {
-    for (ParticleData &data : particles) {
-      // Only baryons and nuclei will be affected by the potentials
-      if (!(data.is_baryon() || data.is_nucleus())) {
-        continue;
-      }
-      const auto scale = pot.force_scale(data.type());
-      const ThreeVector r = data.position().threevec();
-      /* Lattices can be used for calculation if 1-2 are fulfilled:
-       * 1) Required lattices are not nullptr - possibly_use_lattice
-       * 2) r is not out of required lattices */
-      const bool use_lattice =
-          possibly_use_lattice &&
-          (pot.use_skyrme() ? FB_lat->value_at(r, FB) : true) &&
-          (pot.use_vdf() ? FB_lat->value_at(r, FB) : true) &&
-          (pot.use_symmetry() ? FI3_lat->value_at(r, FI3) : true);
-      if (!use_lattice && !pot.use_potentials_outside_lattice()) {
-        continue;
-      }
-      if (!pot.use_skyrme() && !pot.use_vdf()) {
-        FB = std::make_pair(ThreeVector(0., 0., 0.), ThreeVector(0., 0., 0.));
-      }
-      if (!pot.use_symmetry()) {
-        FI3 = std::make_pair(ThreeVector(0., 0., 0.), ThreeVector(0., 0., 0.));
-      }
-      if (!use_lattice) {
-        const auto tmp = pot.all_forces(r, plist);
-        FB = std::make_pair(std::get<0>(tmp), std::get<1>(tmp));
-        FI3 = std::make_pair(std::get<2>(tmp), std::get<3>(tmp));
-      }
-      /* Floating point traps should be raised if the force is not overwritten
-       * with a meaningful value */
-      const auto sNaN = std::numeric_limits<double>::signaling_NaN();
-      ThreeVector force(sNaN, sNaN, sNaN);
-      if (pot.use_momentum_dependence()) {
-        ThreeVector energy_grad = pot.single_particle_energy_gradient(
-            jB_lat, data.position().threevec(), data.momentum().threevec(),
-            data.effective_mass(), plist);
-        force = -energy_grad * scale.first;
-        force +=
-            scale.second * data.type().isospin3_rel() *
-            (FI3.first + data.momentum().velocity().cross_product(FI3.second));
-      } else {
-        force = scale.first *
-                    (FB.first +
-                     data.momentum().velocity().cross_product(FB.second)) +
-                scale.second * data.type().isospin3_rel() *
-                    (FI3.first +
-                     data.momentum().velocity().cross_product(FI3.second));
-      }
-      // Potentially add Lorentz force
-      if (pot.use_coulomb() && EM_lat->value_at(r, EM_fields)) {
-        // factor hbar*c to convert fields from 1/fm^2 to GeV/fm
-        force += hbarc * data.type().charge() * elementary_charge *
-                 (EM_fields.first +
-                  data.momentum().velocity().cross_product(EM_fields.second));
-      }
-      logg[LPropagation].debug("Update momenta: F [GeV/fm] = ", force);
-      data.set_4momentum(data.effective_mass(),
-                         data.momentum().threevec() + force * dt);
-
-      // calculate the time scale of the change in momentum
-      const double Force_abs = force.abs();
-      if (Force_abs < really_small) {
-        continue;
-      }
-      const double time_scale = data.momentum().x0() / Force_abs;
-      if (time_scale < min_time_scale) {
-        min_time_scale = time_scale;
+  /* The nodes, from which the forces at a position are taken, are found once
+   * for all force lattices of the same geometry as the first one used. */
+  const ForceLattice *first_lat = use_FB               ? FB_lat
+                                  : pot.use_symmetry() ? FI3_lat
+                                  : pot.use_coulomb()  ? EM_lat
+                                                       : nullptr;
+  auto shares_stencils = [first_lat](const ForceLattice *lat) {
+    return first_lat != nullptr && lat != nullptr &&
+           lat->shares_stencils(first_lat);
+  };
+  const bool FB_shares = shares_stencils(FB_lat);
+  const bool FI3_shares = shares_stencils(FI3_lat);
+  const bool EM_shares = shares_stencils(EM_lat);
+
+  // returns the time scale of the change in momentum
+  auto update_momentum = [&](ParticleData &data) {
+    std::pair<ThreeVector, ThreeVector> FB, FI3, EM_fields;
+    const auto scale = pot.force_scale(data.type());
+    const ThreeVector r = data.position().threevec();
+    GatherStencil stencil;
+    if (first_lat != nullptr) {
+      first_lat->gather_stencil(r, stencil);
+    }
+    auto gather = [&](const ForceLattice *lat, bool shares,
+                      std::pair<ThreeVector, ThreeVector> &value) {
+      return shares ? lat->gather(stencil, value) : lat->gather_at(r, value);
+    };
+    /* Lattices can be used for calculation if 1-2 are fulfilled:
+     * 1) Required lattices are not nullptr - possibly_use_lattice
+     * 2) r is not out of required lattices */
+    const bool use_lattice =
+        possibly_use_lattice &&
+        (use_FB ? gather(FB_lat, FB_shares, FB) : true) &&
+        (pot.use_symmetry() ? gather(FI3_lat, FI3_shares, FI3) : true);
+    if (!use_lattice && !pot.use_potentials_outside_lattice()) {
+      return std::numeric_limits<double>::infinity();
+    }
+    if (!pot.use_skyrme() && !pot.use_vdf()) {
+      FB = std::make_pair(ThreeVector(0., 0., 0.), ThreeVector(0., 0., 0.));
+    }
+    if (!pot.use_symmetry()) {
+      FI3 = std::make_pair(ThreeVector(0., 0., 0.), ThreeVector(0., 0., 0.));
+    }
+    if (!use_lattice) {
+      const auto tmp = pot.all_forces(r, all_particles());
+      FB = std::make_pair(std::get<0>(tmp), std::get<1>(tmp));
+      FI3 = std::make_pair(std::get<2>(tmp), std::get<3>(tmp));
+    }
+    /* Floating point traps should be raised if the force is not overwritten
+     * with a meaningful value */
+    const auto sNaN = std::numeric_limits<double>::signaling_NaN();
+    ThreeVector force(sNaN, sNaN, sNaN);
+    if (pot.use_momentum_dependence()) {
+      ThreeVector energy_grad = pot.single_particle_energy_gradient(
+          jB_lat, data.position().threevec(), data.momentum().threevec(),
+          data.effective_mass(), all_particles);
+      force = -energy_grad * scale.first;
+      force +=
+          scale.second * data.type().isospin3_rel() *
+          (FI3.first + data.momentum().velocity().cross_product(FI3.second));
+    } else {
+      force = scale.first *
+                  (FB.first +
+                   data.momentum().velocity().cross_product(FB.second)) +
+              scale.second * data.type().isospin3_rel() *
+                  (FI3.first +
+                   data.momentum().velocity().cross_product(FI3.second));
+    }
+    // Potentially add Lorentz force
+    if (pot.use_coulomb() && gather(EM_lat, EM_shares, EM_fields)) {
+      // factor hbar*c to convert fields from 1/fm^2 to GeV/fm
+      force += hbarc * data.type().charge() * elementary_charge *
+               (EM_fields.first +
+                data.momentum().velocity().cross_product(EM_fields.second));
+    }
+    logg[LPropagation].debug("Update momenta: F [GeV/fm] = ", force);
+    data.set_4momentum(data.effective_mass(),
+                       data.momentum().threevec() + force * dt);
+
+    const double Force_abs = force.abs();
+    if (Force_abs < really_small) {
+      return std::numeric_limits<double>::infinity();
+    }
+    return data.momentum().x0() / Force_abs;
+  };
+
+  double min_time_scale = std::numeric_limits<double>::infinity();
+  const int n_affected = affected.size();
+  if (pool == nullptr || pool->size() < 2) {
+    for (ParticleData *data : affected) {
+      min_time_scale = std::min(min_time_scale, update_momentum(*data));
+    }
+  } else {
+    // the particles are independent, give each thread a few chunks
+    const int n_chunks = std::max(1, std::min(n_affected, 4 * pool->size()));
+    const int chunk_size = (n_affected + n_chunks - 1) / n_chunks;
+    std::vector<double> chunk_time_scale(
+        n_chunks, std::numeric_limits<double>::infinity());
+    pool->parallel_for(n_chunks, [&](int chunk) {
+      const int end = std::min(n_affected, (chunk + 1) * chunk_size);
+      for (int i = chunk * chunk_size; i < end; i++) {
+        chunk_time_scale[chunk] =
+            std::min(chunk_time_scale[chunk], update_momentum(*affected[i]));
       }
+    });
+    for (const double time_scale : chunk_time_scale) {
+      min_time_scale = std::min(min_time_scale, time_scale);
     }
   }
   // warn if the time step is too big
@@ -211,6 +298,7 @@ void update_momenta(
         << "In case of Triangular or Discrete smearing you may additionally "
         << "need to increase the number of ensembles or testparticles.";
   }
+  return min_time_scale;
 }
 
 }  // namespace smash
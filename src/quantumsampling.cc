@@ -1,6 +1,6 @@
 /*
  *
- *    Copyright (c) 2020,2022
+ *    Copyright (c) 2020,2022,2024
  *      SMASH Team
  *
  *    GNU General Public License (GPLv3 or later)
@@ -9,6 +9,7 @@
 
 #include "smash/quantumsampling.h"
 
+#include <algorithm>
 #include <cstdlib>
 #include <iostream>
 #include <random>
@@ -24,6 +25,18 @@
 
 namespace smash {
 
+namespace {
+/// Number of bins of the tabulated momentum distributions
+constexpr std::size_t n_momentum_bins = 4000;
+/**
+ * Largest tabulated kinetic energy above the effective chemical potential in
+ * units of the temperature
+ */
+constexpr double max_kinetic_energy_over_T = 40.;
+/// Momentum above which no particle is sampled [GeV]
+constexpr double maximum_momentum = 10.;
+}  // namespace
+
 /*
  * Root equations and GSL procedure for finding the momentum for which the
  * maximum of a given Juttner distribution occurs. This is needed for a method
@@ -206,7 +219,8 @@ double QuantumSampling::maximum_of_the_distribution(
 
 /*
  * Initializing the QuantumSampling object triggers calculation of the
- * chemical potential and distribution maximum for all species present.
+ * chemical potential and the tabulation of the distribution for all species
+ * present.
  */
 QuantumSampling::QuantumSampling(
     const std::map<PdgCode, int> &initial_multiplicities, double volume,
@@ -235,48 +249,32 @@ QuantumSampling::QuantumSampling(
     chemical_potential = mu_solver.effective_chemical_potential(
         spin_degeneracy, particle_mass, number_density, temperature_,
         quantum_statistics, solution_precision);
-    effective_chemical_potentials_[pdg] = chemical_potential;
-    const double distribution_function_maximum = maximum_of_the_distribution(
-        particle_mass, temperature_, chemical_potential, quantum_statistics,
-        solution_precision);
-    distribution_function_maximums_[pdg] = distribution_function_maximum;
+    /* The distribution is negligible beyond the kinetic energy, which is
+     * larger than the one at the Fermi surface of a degenerate gas by many
+     * temperatures. */
+    const double kinetic_energy_max =
+        std::max(0., chemical_potential - particle_mass) +
+        max_kinetic_energy_over_T * temperature_;
+    const double p_max =
+        std::min(maximum_momentum,
+                 std::sqrt(kinetic_energy_max *
+                           (kinetic_energy_max + 2. * particle_mass)));
+    momentum_distributions_[pdg] = random::piecewise_constant_dist(
+        0., p_max, n_momentum_bins, [&](double p) {
+          return p * p *
+                 juttner_distribution_func(p, particle_mass, temperature_,
+                                           chemical_potential,
+                                           quantum_statistics);
+        });
   }
 }
 
 /*
  * Sampling radial momenta of given particle species from Bose, Boltzmann, or
- * Fermi distribution. The choice between the distributions is made based on
- * the <statistics> variable:
- * -1 for Bose
- *  0 fot Boltzmann
- * +1 for Fermi
- *
- * This sampler is the simplest implementation of sampling based on sampling
- * from a uniform distribution.
+ * Fermi distribution by inverting the tabulated cumulative distribution.
  */
-double QuantumSampling::sample(const PdgCode pdg) {
-  const ParticleType &ptype = ParticleType::find(pdg);
-  const double mass = ptype.mass();
-  const double mu = effective_chemical_potentials_.find(pdg)->second;
-  const double distr_max = distribution_function_maximums_.find(pdg)->second;
-  /*
-   * The variable maximum_momentum denotes the "far right" boundary of the
-   * sampled region; we assume that no particle has momentum larger than 10 GeV
-   */
-  constexpr double maximum_momentum = 10.0;  // in [GeV]
-  const double statistics = (pdg.spin() % 2 == 0) ? -1.0 : 1.0;
-  double sampled_momentum = 0.0, sampled_ratio = 0.0;
-
-  do {
-    sampled_momentum = random::uniform(0.0, maximum_momentum);
-    double distribution_at_sampled_p =
-        sampled_momentum * sampled_momentum *
-        juttner_distribution_func(sampled_momentum, mass, temperature_, mu,
-                                  statistics);
-    sampled_ratio = distribution_at_sampled_p / distr_max;
-  } while (random::canonical() > sampled_ratio);
-
-  return sampled_momentum;
+double QuantumSampling::sample(const PdgCode pdg) const {
+  return momentum_distributions_.at(pdg)();
 }
 
 }  // namespace smash
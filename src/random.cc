@@ -1,6 +1,6 @@
 /*
  *
- *    Copyright (c) 2014,2017-2019,2022
+ *    Copyright (c) 2014,2017-2019,2022,2024
  *      SMASH Team
  *
  *    GNU General Public License (GPLv3 or later)
@@ -9,13 +9,15 @@
 
 #include "smash/random.h"
 
+#include <cmath>
+#include <map>
 #include <random>
 
 #include "smash/logging.h"
 
 namespace smash {
 static constexpr int LGrandcanThermalizer = LogArea::GrandcanThermalizer::id;
-/*thread_local (see #3075)*/ random::Engine random::engine;
+thread_local random::Engine random::engine;
 
 int64_t random::generate_63bit_seed() {
   std::random_device rd;
@@ -66,11 +68,11 @@ random::BesselSampler::BesselSampler(const double poisson_mean1,
       logg[LGrandcanThermalizer].debug("Probability (", i, ") = ", p);
       i++;
     }
-    dist_.reset_weights(probabilities);
+    dist_ = alias_dist(probabilities);
   }
 }
 
-std::pair<int, int> random::BesselSampler::sample() {
+std::pair<int, int> random::BesselSampler::sample() const {
   const int N_smaller = (m_ >= m_switch_method_)
                             ? std::round(random::normal(mu_, sigma_))
                             : dist_();
@@ -78,6 +80,29 @@ std::pair<int, int> random::BesselSampler::sample() {
                         : std::make_pair(N_smaller, N_smaller + N_);
 }
 
+std::shared_ptr<const random::BesselSampler> random::BesselSampler::cached(
+    const double poisson_mean1, const double poisson_mean2,
+    const int fixed_difference) {
+  static thread_local std::map<std::pair<int64_t, int>,
+                               std::shared_ptr<const BesselSampler>>
+      cache;
+  const double a = 2.0 * std::sqrt(poisson_mean1 * poisson_mean2);
+  const double log_step = std::log1p(cache_precision_);
+  const int64_t a_key = a > 0.0 ? std::llround(std::log(a) / log_step)
+                                : std::numeric_limits<int64_t>::min();
+  auto &sampler = cache[std::make_pair(a_key, fixed_difference)];
+  if (!sampler) {
+    if (cache.size() > max_cached_) {
+      cache.clear();
+      return cached(poisson_mean1, poisson_mean2, fixed_difference);
+    }
+    const double a_rounded = a > 0.0 ? std::exp(a_key * log_step) : 0.0;
+    sampler = std::make_shared<const BesselSampler>(
+        0.5 * a_rounded, 0.5 * a_rounded, fixed_difference);
+  }
+  return sampler;
+}
+
 double random::BesselSampler::r_(int n, double a) {
   const double a_inv = 1.0 / a;
   double res = 0.0;
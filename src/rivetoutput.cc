@@ -1,7 +1,7 @@
 /*
  *
  *    Copyright (c) 2021 Christian Holm Christensen
- *    Copyright (c) 2021-2022
+ *    Copyright (c) 2021-2022,2024
  *      SMASH Team
  *
  *    GNU General Public License (GPLv3 or later)
@@ -10,6 +10,9 @@
 
 #include "smash/rivetoutput.h"
 
+#include <algorithm>
+#include <stdexcept>
+
 #include "Rivet/Rivet.hh"
 #include "Rivet/Tools/Logging.hh"
 
@@ -86,20 +89,73 @@ namespace smash {
  *
  * The Rivet set-up can be configured using the \ref input_output_rivet_
  * "content specific \c Rivet section" in the configuration file.
+ *
+ * \section rivet_output_user_guide_threads_ Analysis threads
+ *
+ * By default the events are analysed by the thread running the simulation,
+ * which waits for the analyses. With
+ * <tt>\ref key_output_rivet_analysis_threads_ "Analysis_Threads"</tt> the
+ * events are instead handed over to that many threads, each running its own
+ * copy of the analyses, and the results of all threads are merged before the
+ * analyses are finalised. The simulation then only waits if the threads fall
+ * behind by more events than they can queue. This requires that the analyses
+ * do not share state between their instances, which holds for analyses that
+ * keep everything in their members, as Rivet analyses should.
  */
 
 RivetOutput::RivetOutput(const std::filesystem::path& path, std::string name,
                          const bool full_event,
                          const RivetOutputParameters& rivet_par)
     : HepMcInterface(name, full_event),
-      handler_(),
+      handlers_(),
       filename_(path / (name + ".yoda")),
-      need_init_(true) {
-  handler_ = std::make_shared<Rivet::AnalysisHandler>();
+      need_init_(true),
+      capacity_(4 * static_cast<std::size_t>(
+                        std::max(rivet_par.analysis_threads, 1))) {
+  if (rivet_par.analysis_threads < 0) {
+    throw std::invalid_argument(
+        "The number of Rivet analysis threads must not be negative.");
+  }
+  for (int i = 0; i < std::max(rivet_par.analysis_threads, 1); i++) {
+    handlers_.push_back(std::make_shared<Rivet::AnalysisHandler>());
+  }
   setup(rivet_par);
+  if (rivet_par.analysis_threads > 0) {
+    logg[LOutput].info() << "Running the Rivet analyses in "
+                         << rivet_par.analysis_threads << " threads\n";
+    for (const auto& handler : handlers_) {
+      threads_.emplace_back([this, handler] { analyze_queued(handler); });
+    }
+  }
 }
 
 RivetOutput::~RivetOutput() {
+  if (!threads_.empty()) {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      stop_ = true;
+    }
+    changed_.notify_all();
+    for (std::thread& thread : threads_) {
+      thread.join();
+    }
+    if (error_) {
+      try {
+        std::rethrow_exception(error_);
+      } catch (const std::exception& e) {
+        logg[LOutput].error() << "A Rivet analysis failed: " << e.what()
+                              << std::endl;
+      } catch (...) {
+        logg[LOutput].error() << "A Rivet analysis failed." << std::endl;
+      }
+    }
+    // Without any event, the handlers were never initialised
+    if (!need_init_) {
+      for (std::size_t i = 1; i < handlers_.size(); i++) {
+        analysis_handler_proxy()->merge(*handlers_[i]);
+      }
+    }
+  }
   logg[LOutput].debug() << "Writing Rivet results to " << filename_
                         << std::endl;
   analysis_handler_proxy()->finalize();
@@ -111,20 +167,71 @@ void RivetOutput::at_eventend(const Particles& particles,
                               const EventInfo& event) {
   HepMcInterface::at_eventend(particles, event_number, event);
 
-  // Initialize Rivet on first event
+  /* Initialize Rivet on first event. Loading the analyses is left to this
+   * thread, such that only the analyses themselves run concurrently. */
   if (need_init_) {
     logg[LOutput].debug() << "Initialising Rivet" << std::endl;
     need_init_ = false;
-    analysis_handler_proxy()->init(event_);
+    for (std::size_t i = 0; i < handlers_.size(); i++) {
+      analysis_handler_proxy(i)->init(event_);
+    }
   }
 
   logg[LOutput].debug() << "Analysing event " << event_number << std::endl;
-  // Let Rivet analyse the event
-  analysis_handler_proxy()->analyze(event_);
+  if (threads_.empty()) {
+    // Let Rivet analyse the event
+    analysis_handler_proxy()->analyze(event_);
+    return;
+  }
+  // The event is reused for the next one, so a copy is handed over
+  auto copy = std::make_unique<HepMC3::GenEvent>(event_);
+  {
+    std::unique_lock<std::mutex> lock(mutex_);
+    changed_.wait(lock, [this] { return queue_.size() < capacity_ || error_; });
+    rethrow_error();
+    queue_.push_back(std::move(copy));
+  }
+  changed_.notify_all();
+}
+
+void RivetOutput::analyze_queued(
+    const std::shared_ptr<Rivet::AnalysisHandler>& handler) {
+  while (true) {
+    std::unique_ptr<HepMC3::GenEvent> event;
+    {
+      std::unique_lock<std::mutex> lock(mutex_);
+      changed_.wait(lock, [this] { return stop_ || !queue_.empty(); });
+      if (queue_.empty()) {
+        return;
+      }
+      event = std::move(queue_.front());
+      queue_.pop_front();
+    }
+    changed_.notify_all();
+    try {
+      Proxy(handler)->analyze(*event);
+    } catch (...) {
+      std::lock_guard<std::mutex> lock(mutex_);
+      if (!error_) {
+        error_ = std::current_exception();
+      }
+      changed_.notify_all();
+    }
+  }
+}
+
+void RivetOutput::rethrow_error() {
+  if (error_) {
+    std::exception_ptr error = error_;
+    error_ = nullptr;
+    std::rethrow_exception(error);
+  }
 }
 
 void RivetOutput::add_analysis(const std::string& name) {
-  analysis_handler_proxy()->addAnalysis(name);
+  for (std::size_t i = 0; i < handlers_.size(); i++) {
+    analysis_handler_proxy(i)->addAnalysis(name);
+  }
 }
 
 void RivetOutput::add_path(const std::string& path) {
@@ -133,13 +240,17 @@ void RivetOutput::add_path(const std::string& path) {
 }
 
 void RivetOutput::add_preload(const std::string& file) {
-  analysis_handler_proxy()->readData(file);
+  for (std::size_t i = 0; i < handlers_.size(); i++) {
+    analysis_handler_proxy(i)->readData(file);
+  }
 }
 
 void RivetOutput::set_ignore_beams(bool ignore) {
   logg[LOutput].info() << "Ignore beams? " << (ignore ? "yes" : "no")
                        << std::endl;
-  analysis_handler_proxy()->setIgnoreBeams(ignore);
+  for (std::size_t i = 0; i < handlers_.size(); i++) {
+    analysis_handler_proxy(i)->setIgnoreBeams(ignore);
+  }
 }
 
 void RivetOutput::set_log_level(const std::string& name,
@@ -163,7 +274,9 @@ void RivetOutput::set_log_level(const std::string& name,
 }
 
 void RivetOutput::set_cross_section(double xs, double xserr) {
-  analysis_handler_proxy()->setCrossSection(xs, xserr, true);
+  for (std::size_t i = 0; i < handlers_.size(); i++) {
+    analysis_handler_proxy(i)->setCrossSection(xs, xserr, true);
+  }
 }
 
 void RivetOutput::setup(const RivetOutputParameters& params) {
@@ -207,44 +320,46 @@ void RivetOutput::setup(const RivetOutputParameters& params) {
 
   // Treatment of event weights in Rivet
   if (params.any_weight_parameter_was_given) {
-    // Do not care about multi weights
-    if (params.no_multi_weight) {
-      analysis_handler_proxy()->skipMultiWeights(
-          params.no_multi_weight.value());
-    }
+    for (std::size_t i = 0; i < handlers_.size(); i++) {
+      // Do not care about multi weights
+      if (params.no_multi_weight) {
+        analysis_handler_proxy(i)->skipMultiWeights(
+            params.no_multi_weight.value());
+      }
 
-    // Set nominal weight name
-    if (params.nominal_weight_name) {
-      analysis_handler_proxy()->setNominalWeightName(
-          params.nominal_weight_name.value());
-    }
+      // Set nominal weight name
+      if (params.nominal_weight_name) {
+        analysis_handler_proxy(i)->setNominalWeightName(
+            params.nominal_weight_name.value());
+      }
 
-    // Set cap (maximum) on weights
-    if (params.cap_on_weights) {
-      analysis_handler_proxy()->setWeightCap(params.cap_on_weights.value());
-    }
+      // Set cap (maximum) on weights
+      if (params.cap_on_weights) {
+        analysis_handler_proxy(i)->setWeightCap(params.cap_on_weights.value());
+      }
 
-    // Whether to smear for NLO calculations
-    if (params.nlo_smearing) {
-      analysis_handler_proxy()->setNLOSmearing(params.nlo_smearing.value());
-    }
+      // Whether to smear for NLO calculations
+      if (params.nlo_smearing) {
+        analysis_handler_proxy(i)->setNLOSmearing(params.nlo_smearing.value());
+      }
 
-    // Select which weights to enable
-    if (params.to_be_enabled_weights) {
-      std::stringstream s;
-      int comma = 0;
-      for (auto w : params.to_be_enabled_weights.value())
-        s << (comma++ ? "," : "") << w;
-      analysis_handler_proxy()->selectMultiWeights(s.str());
-    }
+      // Select which weights to enable
+      if (params.to_be_enabled_weights) {
+        std::stringstream s;
+        int comma = 0;
+        for (auto w : params.to_be_enabled_weights.value())
+          s << (comma++ ? "," : "") << w;
+        analysis_handler_proxy(i)->selectMultiWeights(s.str());
+      }
 
-    // Select weights to disable
-    if (params.to_be_disabled_weights) {
-      std::stringstream s;
-      int comma = 0;
-      for (auto w : params.to_be_disabled_weights.value())
-        s << (comma++ ? "," : "") << w;
-      analysis_handler_proxy()->deselectMultiWeights(s.str());
+      // Select weights to disable
+      if (params.to_be_disabled_weights) {
+        std::stringstream s;
+        int comma = 0;
+        for (auto w : params.to_be_disabled_weights.value())
+          s << (comma++ ? "," : "") << w;
+        analysis_handler_proxy(i)->deselectMultiWeights(s.str());
+      }
     }
   }
   logg[LOutput].debug() << "Setup of Rivet output done.\n";
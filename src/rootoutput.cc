@@ -1,6 +1,6 @@
 /*
  *
- *    Copyright (c) 2014-2023
+ *    Copyright (c) 2014-2024
  *      SMASH Team
  *
  *    GNU General Public License (GPLv3 or later)
@@ -9,7 +9,11 @@
 
 #include "smash/rootoutput.h"
 
+#include <algorithm>
+
+#include "RConfigure.h"
 #include "TFile.h"
+#include "TROOT.h"
 #include "TTree.h"
 #include "smash/action.h"
 #include "smash/clock.h"
@@ -59,7 +63,7 @@ const int RootOutput::max_buffer_size_ = 500000;
  * Every physical quantity corresponds to a separate TBranch.
  * One entry in the \c particles TTree is:
  * \code
- * ev tcounter npart test_p modus_l current_t impact_b empty_event
+ * ev tcounter npart test_p modus_l current_t impact_b empty_event event_weight
  * pdgcode[npart] charge[npart] t[npart] x[npart] y[npart] z[npart] p0[npart]
  * px[npart] py[npart] pz[npart] E_kinetic_tot E_fields_tot E_tot
  * \endcode
@@ -79,6 +83,8 @@ const int RootOutput::max_buffer_size_ = 500000;
  * \li \c impact_b is the impact parameter of the event
  * \li \c empty_event indicates whether the projectile did not interact with the
  * target
+ * \li \c event_weight is the weight of the event, which is 1 unless the
+ * impact parameters are weighted, see \ref key_MC_impact_weighted_
  * \li \c pdgcode is PDG id array
  * \li \c charge is the electric charge array
  * \li \c p0, \c px, \c py, \c pz are 4-momenta arrays
@@ -87,6 +93,14 @@ const int RootOutput::max_buffer_size_ = 500000;
  * \li \c E_fields_tot is total mean field energy * test_p
  * \li \c E_total is the sum of E_kinetic_tot and E_fields_tot
  *
+ * The compression of the files and the basket and flush settings of the trees
+ * can be configured with the \key Root_Compression, \key
+ * Root_Compression_Level, \key Root_Basket_Size and \key Root_Auto_Flush
+ * keys of the \key Output section. With \key Root_Implicit_MT, ROOT
+ * compresses the baskets in threads of its own, and with \key
+ * Root_Writer_Thread, the trees are filled in a writer thread alongside the
+ * time evolution.
+ *
  * In case of extended output (see \ref input_output_content_specific_) more
  * fields are added. Their description is the same that in case of OSCAR
  * format, see \ref extended_output_format_.
@@ -241,11 +255,28 @@ RootOutput::RootOutput(const std::filesystem::path &path,
       autosave_frequency_(1000),
       part_extended_(out_par.part_extended),
       coll_extended_(out_par.coll_extended),
-      ic_extended_(out_par.ic_extended) {
+      ic_extended_(out_par.ic_extended),
+      root_parameters_(out_par.root_parameters) {
+  if (root_parameters_.writer_thread) {
+    // the trees are filled in another thread than the one creating them
+    ROOT::EnableThreadSafety();
+  }
+  if (root_parameters_.implicit_mt_threads > 0) {
+#ifdef R__USE_IMT
+    if (!ROOT::IsImplicitMTEnabled()) {
+      ROOT::EnableImplicitMT(root_parameters_.implicit_mt_threads);
+    }
+#else
+    logg[LOutput].warn(
+        "ROOT was built without implicit multi-threading, the ROOT output is "
+        "compressed without additional threads.");
+#endif
+  }
   filename_unfinished_ = filename_;
   filename_unfinished_ += ".unfinished";
   root_out_file_ =
       std::make_unique<TFile>(filename_unfinished_.native().c_str(), "NEW");
+  root_out_file_->SetCompressionSettings(root_parameters_.compression_settings);
   init_trees();
 }
 
@@ -261,6 +292,7 @@ void RootOutput::init_trees() {
     particles_tree_->Branch("current_t", &current_t_, "current_t/D");
     particles_tree_->Branch("impact_b", &impact_b_, "impact_b/D");
     particles_tree_->Branch("empty_event", &empty_event_, "empty_event/O");
+    particles_tree_->Branch("event_weight", &event_weight_, "event_weight/D");
 
     particles_tree_->Branch("pdgcode", &pdgcode_[0], "pdgcode[npart]/I");
     particles_tree_->Branch("charge", &charge_[0], "charge[npart]/I");
@@ -300,6 +332,7 @@ void RootOutput::init_trees() {
       particles_tree_->Branch("strangeness", &strangeness_[0],
                               "strangeness[npart]/I");
     }
+    configure_tree(particles_tree_);
   }
 
   if (write_collisions_) {
@@ -345,6 +378,63 @@ void RootOutput::init_trees() {
       collisions_tree_->Branch("strangeness", &strangeness_[0],
                                "strangeness[npart]/I");
     }
+    configure_tree(collisions_tree_);
+  }
+}
+
+void RootOutput::configure_tree(TTree *tree) {
+  tree->SetBasketSize("*", root_parameters_.basket_size);
+  tree->SetAutoFlush(root_parameters_.auto_flush);
+}
+
+void RootOutput::reserve_buffers(std::size_t size) {
+  if (size <= pdgcode_.size()) {
+    return;
+  }
+  // grow geometrically, such that the trees rarely have to be updated
+  size = std::min<std::size_t>(std::max(size, 2 * pdgcode_.size()),
+                               max_buffer_size_);
+  for (std::vector<double> *buffer :
+       {&p0_, &px_, &py_, &pz_, &t_, &x_, &y_, &z_, &formation_time_,
+        &xsec_factor_, &time_last_coll_}) {
+    buffer->resize(size);
+  }
+  for (std::vector<int> *buffer :
+       {&pdgcode_, &charge_, &coll_per_part_, &proc_id_origin_,
+        &proc_type_origin_, &pdg_mother1_, &pdg_mother2_, &baryon_number_,
+        &strangeness_}) {
+    buffer->resize(size);
+  }
+  if (particles_tree_) {
+    set_buffer_addresses(particles_tree_, part_extended_ || ic_extended_);
+  }
+  if (collisions_tree_) {
+    set_buffer_addresses(collisions_tree_, coll_extended_);
+  }
+}
+
+void RootOutput::set_buffer_addresses(TTree *tree, bool extended) {
+  tree->SetBranchAddress("pdgcode", pdgcode_.data());
+  tree->SetBranchAddress("charge", charge_.data());
+  tree->SetBranchAddress("p0", p0_.data());
+  tree->SetBranchAddress("px", px_.data());
+  tree->SetBranchAddress("py", py_.data());
+  tree->SetBranchAddress("pz", pz_.data());
+  tree->SetBranchAddress("t", t_.data());
+  tree->SetBranchAddress("x", x_.data());
+  tree->SetBranchAddress("y", y_.data());
+  tree->SetBranchAddress("z", z_.data());
+  if (extended) {
+    tree->SetBranchAddress("ncoll", coll_per_part_.data());
+    tree->SetBranchAddress("form_time", formation_time_.data());
+    tree->SetBranchAddress("xsecfac", xsec_factor_.data());
+    tree->SetBranchAddress("proc_id_origin", proc_id_origin_.data());
+    tree->SetBranchAddress("proc_type_origin", proc_type_origin_.data());
+    tree->SetBranchAddress("time_last_coll", time_last_coll_.data());
+    tree->SetBranchAddress("pdg_mother1", pdg_mother1_.data());
+    tree->SetBranchAddress("pdg_mother2", pdg_mother2_.data());
+    tree->SetBranchAddress("baryon_number", baryon_number_.data());
+    tree->SetBranchAddress("strangeness", strangeness_.data());
   }
 }
 
@@ -370,6 +460,7 @@ void RootOutput::at_eventstart(const Particles &particles,
   E_kinetic_tot_ = event.total_kinetic_energy;
   E_fields_tot_ = event.total_mean_field_energy;
   E_tot_ = event.total_energy;
+  event_weight_ = event.event_weight;
 
   if (write_particles_ && particles_only_final_ == OutputOnlyFinal::No) {
     output_counter_ = 0;
@@ -458,9 +549,10 @@ void RootOutput::particles_to_tree(T &particles) {
   ev_ = current_event_;
   tcounter_ = output_counter_;
   bool exceeded_buffer_message = true;
+  reserve_buffers(std::min<std::size_t>(particles.size(), max_buffer_size_));
 
   for (const auto &p : particles) {
-    // Buffer full - flush to tree, else fill with particles
+    // Buffer full - flush to tree before adding the particle
     if (i >= max_buffer_size_) {
       if (exceeded_buffer_message) {
         logg[LOutput].warn()
@@ -477,36 +569,35 @@ void RootOutput::particles_to_tree(T &particles) {
       npart_ = max_buffer_size_;
       i = 0;
       particles_tree_->Fill();
-    } else {
-      pdgcode_[i] = p.pdgcode().get_decimal();
-      charge_[i] = p.type().charge();
-
-      p0_[i] = p.momentum().x0();
-      px_[i] = p.momentum().x1();
-      py_[i] = p.momentum().x2();
-      pz_[i] = p.momentum().x3();
+    }
+    pdgcode_[i] = p.pdgcode().get_decimal();
+    charge_[i] = p.type().charge();
 
-      t_[i] = p.position().x0();
-      x_[i] = p.position().x1();
-      y_[i] = p.position().x2();
-      z_[i] = p.position().x3();
+    p0_[i] = p.momentum().x0();
+    px_[i] = p.momentum().x1();
+    py_[i] = p.momentum().x2();
+    pz_[i] = p.momentum().x3();
 
-      if (part_extended_ || ic_extended_) {
-        const auto h = p.get_history();
-        formation_time_[i] = p.formation_time();
-        xsec_factor_[i] = p.xsec_scaling_factor();
-        time_last_coll_[i] = h.time_last_collision;
-        coll_per_part_[i] = h.collisions_per_particle;
-        proc_id_origin_[i] = h.id_process;
-        proc_type_origin_[i] = static_cast<int>(h.process_type);
-        pdg_mother1_[i] = h.p1.get_decimal();
-        pdg_mother2_[i] = h.p2.get_decimal();
-        baryon_number_[i] = p.type().baryon_number();
-        strangeness_[i] = p.type().strangeness();
-      }
+    t_[i] = p.position().x0();
+    x_[i] = p.position().x1();
+    y_[i] = p.position().x2();
+    z_[i] = p.position().x3();
 
-      i++;
+    if (part_extended_ || ic_extended_) {
+      const auto &h = p.get_history();
+      formation_time_[i] = p.formation_time();
+      xsec_factor_[i] = p.xsec_scaling_factor();
+      time_last_coll_[i] = h.time_last_collision;
+      coll_per_part_[i] = h.collisions_per_particle;
+      proc_id_origin_[i] = h.id_process;
+      proc_type_origin_[i] = static_cast<int>(h.process_type);
+      pdg_mother1_[i] = h.p1.get_decimal();
+      pdg_mother2_[i] = h.p2.get_decimal();
+      baryon_number_[i] = p.type().baryon_number();
+      strangeness_[i] = p.type().strangeness();
     }
+
+    i++;
   }
   // Flush rest to tree
   if (i > 0) {
@@ -528,13 +619,14 @@ void RootOutput::collisions_to_tree(const ParticleList &incoming,
 
   int i = 0;
 
-  /* It is assumed that nin + nout < max_buffer_size_
-   * This is true for any possible reaction for current buffer size: 10000
-   * But if one wants initial/final particles written to collisions
-   * then implementation should be updated. */
+  /* It is assumed that nin + nout <= max_buffer_size_, which is true for any
+   * possible reaction. But if one wants initial/final particles written to
+   * collisions then implementation should be updated. */
+  reserve_buffers(npart_);
 
-  for (const ParticleList &plist : {incoming, outgoing}) {
-    for (const auto &p : plist) {
+  // the lists are pointed to, such that they are not copied
+  for (const ParticleList *plist : {&incoming, &outgoing}) {
+    for (const auto &p : *plist) {
       pdgcode_[i] = p.pdgcode().get_decimal();
       charge_[i] = p.type().charge();
 
@@ -549,7 +641,7 @@ void RootOutput::collisions_to_tree(const ParticleList &incoming,
       z_[i] = p.position().x3();
 
       if (coll_extended_) {
-        const auto h = p.get_history();
+        const auto &h = p.get_history();
         formation_time_[i] = p.formation_time();
         xsec_factor_[i] = p.xsec_scaling_factor();
         time_last_coll_[i] = h.time_last_collision;
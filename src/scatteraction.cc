@@ -1,6 +1,6 @@
 /*
  *
- *    Copyright (c) 2014-2023
+ *    Copyright (c) 2014-2024
  *      SMASH Team
  *
  *    GNU General Public License (GPLv3 or later)
@@ -10,6 +10,9 @@
 #include "smash/scatteraction.h"
 
 #include <cmath>
+#include <cstdint>
+#include <limits>
+#include <optional>
 
 #include "Pythia8/Pythia.h"
 
@@ -50,9 +53,85 @@ void ScatterAction::add_collisions(CollisionBranchList pv) {
                                  sum_of_partial_cross_sections_);
 }
 
+/**
+ * Mix the bits of an integer, as in the finalizer of SplitMix64.
+ *
+ * \param[in] x Integer to be mixed
+ * \return Mixed integer
+ */
+static std::uint64_t mix_bits(std::uint64_t x) {
+  x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9;
+  x = (x ^ (x >> 27)) * 0x94d049bb133111eb;
+  return x ^ (x >> 31);
+}
+
+void ScatterAction::set_random_stream(std::uint64_t seed,
+                                      std::uint64_t ensemble) {
+  std::uint64_t stream = mix_bits(ensemble);
+  for (const ParticleData &incoming : incoming_particles_) {
+    stream = mix_bits(stream ^ static_cast<std::uint64_t>(incoming.id()));
+  }
+  // The streams of the ensembles are numbered from 1, keep clear of them
+  random_stream_.emplace(seed, stream | (std::uint64_t{1} << 63));
+}
+
+bool ScatterAction::has_string_channel() const {
+  for (const CollisionBranchPtr &channel : collision_channels_) {
+    const ProcessType type = channel->get_type();
+    if (is_string_soft_process(type) || type == ProcessType::StringHard) {
+      return true;
+    }
+  }
+  return false;
+}
+
+bool ScatterAction::prepare(bool only_strings) {
+  if (!random_stream_) {
+    return false;
+  }
+  // Draw from the beginning of the stream, like generate_final_state
+  random::Engine engine = *random_stream_;
+  random::EngineGuard guard(engine);
+  const CollisionBranch *proc = choose_channel<CollisionBranch>(
+      collision_channels_, is_total_parametrized_
+                               ? *parametrized_total_cross_section_
+                               : sum_of_partial_cross_sections_);
+  const ProcessType type = proc->get_type();
+  if (only_strings && !is_string_soft_process(type) &&
+      type != ProcessType::StringHard) {
+    return false;
+  }
+  process_type_ = type;
+  outgoing_particles_ = proc->particle_list();
+  sample_final_state();
+  prepared_type_ = process_type_;
+  prepared_final_state_ = std::move(outgoing_particles_);
+  outgoing_particles_.clear();
+  return true;
+}
+
+bool ScatterAction::prefragment_string() { return prepare(true); }
+
+bool ScatterAction::prepare_final_state() {
+  try {
+    return prepare(false);
+  } catch (const std::exception &) {
+    // The error is raised again when the final state is generated
+    outgoing_particles_.clear();
+    return false;
+  }
+}
+
 void ScatterAction::generate_final_state() {
   logg[LScatterAction].debug("Incoming particles: ", incoming_particles_);
 
+  // Draw from the beginning of the own random stream, if there is one
+  std::optional<random::Engine> engine = random_stream_;
+  std::optional<random::EngineGuard> guard;
+  if (engine) {
+    guard.emplace(*engine);
+  }
+
   const CollisionBranch *proc = choose_channel<CollisionBranch>(
       collision_channels_, is_total_parametrized_
                                ? *parametrized_total_cross_section_
@@ -67,6 +146,36 @@ void ScatterAction::generate_final_state() {
   /* The production point of the new particles.  */
   FourVector middle_point = get_interaction_point();
 
+  if (prepared_final_state_) {
+    // The same channel was chosen when the final state was prepared
+    outgoing_particles_ = std::move(*prepared_final_state_);
+    process_type_ = prepared_type_;
+    prepared_final_state_.reset();
+    if (process_type_ == ProcessType::Elastic) {
+      // The incoming particles may have been propagated since
+      for (std::size_t i = 0; i < outgoing_particles_.size(); i++) {
+        const FourVector momentum = outgoing_particles_[i].momentum();
+        outgoing_particles_[i] = incoming_particles_[i];
+        outgoing_particles_[i].set_4momentum(momentum);
+      }
+    }
+  } else {
+    sample_final_state();
+  }
+
+  // Boost to the computational frame
+  const LorentzBoost to_computational_frame(
+      -total_momentum_of_outgoing_particles().velocity());
+  for (ParticleData &new_particle : outgoing_particles_) {
+    new_particle.boost_momentum(to_computational_frame);
+    /* Set positions of the outgoing particles */
+    if (proc->get_type() != ProcessType::Elastic) {
+      new_particle.set_4position(middle_point);
+    }
+  }
+}
+
+void ScatterAction::sample_final_state() {
   switch (process_type_) {
     case ProcessType::Elastic:
       /* 2->2 elastic scattering */
@@ -102,16 +211,6 @@ void ScatterAction::generate_final_state() {
           "(PDGcode1=" + incoming_particles_[0].pdgcode().string() +
           ", PDGcode2=" + incoming_particles_[1].pdgcode().string() + ")");
   }
-
-  for (ParticleData &new_particle : outgoing_particles_) {
-    // Boost to the computational frame
-    new_particle.boost_momentum(
-        -total_momentum_of_outgoing_particles().velocity());
-    /* Set positions of the outgoing particles */
-    if (proc->get_type() != ProcessType::Elastic) {
-      new_particle.set_4position(middle_point);
-    }
-  }
 }
 
 void ScatterAction::add_all_scatterings(
@@ -178,6 +277,57 @@ void ScatterAction::add_all_scatterings(
   }
 }
 
+double ScatterAction::sum_of_all_scatterings(
+    const ScatterActionsFinderParameters &finder_parameters) const {
+  // The sum follows the partial cross sections added by add_all_scatterings
+  CrossSections xs(incoming_particles_, sqrt_s(),
+                   get_potential_at_interaction_point());
+  double sum = xs.sum_of_collision_list(finder_parameters, string_process_);
+  if (!finder_parameters.strings_with_probability &&
+      xs.string_probability(finder_parameters)) {
+    const double xs_diff =
+        xs.high_energy(finder_parameters.transition_high_energy) - sum;
+    if (xs_diff > 0.) {
+      for (const CollisionBranchPtr &branch : xs.string_excitation(
+               xs_diff, string_process_, finder_parameters.use_AQM)) {
+        if (branch->weight() > 0.) {
+          sum += branch->weight();
+        }
+      }
+    }
+  }
+
+  ParticleTypePtr pseudoresonance =
+      try_find_pseudoresonance(finder_parameters.pseudoresonance_method,
+                               finder_parameters.transition_high_energy);
+  if (pseudoresonance && finder_parameters.two_to_one) {
+    const double xs_total =
+        is_total_parametrized_
+            ? *parametrized_total_cross_section_
+            : xs.high_energy(finder_parameters.transition_high_energy);
+    const double xs_gap = xs_total - sum;
+    if (xs_gap > really_small) {
+      sum += xs_gap;
+    }
+  }
+  return sum;
+}
+
+void ScatterAction::add_tabulated_scatterings(CollisionBranchList branches) {
+  if (were_processes_added_) {
+    logg[LScatterAction].fatal() << "Trying to add processes again.";
+    throw std::logic_error(
+        "add_tabulated_scatterings should be called only once per "
+        "ScatterAction instance");
+  }
+  add_collisions(std::move(branches));
+  were_processes_added_ = true;
+  // The tabulated branches only approximate the parametrization
+  if (is_total_parametrized_) {
+    rescale_outgoing_branches();
+  }
+}
+
 void ScatterAction::rescale_outgoing_branches() {
   if (!were_processes_added_) {
     logg[LScatterAction].fatal()
@@ -248,27 +398,15 @@ ParticleTypePtr ScatterAction::try_find_pseudoresonance(
     }
   }
 
-  // If this list is empty, there are no possible pseudo-resonances.
-  ParticleTypePtrList list = list_possible_resonances(type_a, type_b);
-  if (std::empty(list)) {
-    return {};
-  }
-
+  /* The possible resonances are sorted by their masses, the result is an
+   * invalid pointer if there are none. */
   if (method == PseudoResonance::Largest ||
       method == PseudoResonance::LargestFromUnstable) {
-    auto largest = *std::max_element(list.begin(), list.end(),
-                                     [](ParticleTypePtr a, ParticleTypePtr b) {
-                                       return a->mass() < b->mass();
-                                     });
-    return largest;
+    return possible_resonance_by_mass(
+        *type_a, *type_b, std::numeric_limits<double>::infinity());
   } else if (method == PseudoResonance::Closest ||
              method == PseudoResonance::ClosestFromUnstable) {
-    auto comparison = [&desired_mass](ParticleTypePtr a, ParticleTypePtr b) {
-      return std::abs(a->mass() - desired_mass) <
-             std::abs(b->mass() - desired_mass);
-    };
-    auto closest = *std::min_element(list.begin(), list.end(), comparison);
-    return closest;
+    return possible_resonance_by_mass(*type_a, *type_b, desired_mass);
   } else {
     throw std::logic_error("Unknown method for selecting pseudoresonance.");
   }
@@ -632,8 +770,8 @@ void ScatterAction::resonance_formation() {
 /* This function generates the outgoing state when
  * ScatterAction::string_excitation() is used */
 
-void ScatterAction::create_string_final_state() {
-  outgoing_particles_ = string_process_->get_final_state();
+void ScatterAction::create_string_final_state(StringProcess &string_process) {
+  string_process.take_final_state(outgoing_particles_);
   assign_formation_time_to_outgoing_particles();
   /* Check momentum difference for debugging */
   FourVector out_mom;
@@ -644,6 +782,52 @@ void ScatterAction::create_string_final_state() {
   logg[LPythia].debug("Outgoing momenta string:", out_mom);
 }
 
+/**
+ * Generate a string process of the given type, recording the statistics of
+ * the subprocess.
+ *
+ * \param[in] string_process String process of the calling thread
+ * \param[in] type Type of the string process
+ * \return Whether the string process succeeded
+ */
+static bool generate_string_subprocess(StringProcess &string_process,
+                                       ProcessType type) {
+  using Subprocess = StringProcess::Subprocess;
+  switch (type) {
+    case ProcessType::StringSoftSingleDiffractiveAX:
+      /* single diffractive to A+X */
+      return string_process.timed(Subprocess::SingleDiffractive, [&]() {
+        return string_process.next_SDiff(true);
+      });
+    case ProcessType::StringSoftSingleDiffractiveXB:
+      /* single diffractive to X+B */
+      return string_process.timed(Subprocess::SingleDiffractive, [&]() {
+        return string_process.next_SDiff(false);
+      });
+    case ProcessType::StringSoftDoubleDiffractive:
+      /* double diffractive */
+      return string_process.timed(Subprocess::DoubleDiffractive,
+                                  [&]() { return string_process.next_DDiff(); });
+    case ProcessType::StringSoftNonDiffractive:
+      /* soft non-diffractive */
+      return string_process.timed(Subprocess::NonDiffractiveSoft, [&]() {
+        return string_process.next_NDiffSoft();
+      });
+    case ProcessType::StringSoftAnnihilation:
+      /* soft BBbar 2 mesonic annihilation */
+      return string_process.timed(Subprocess::Annihilation, [&]() {
+        return string_process.next_BBbarAnn();
+      });
+    case ProcessType::StringHard:
+      return string_process.timed(Subprocess::NonDiffractiveHard, [&]() {
+        return string_process.next_NDiffHard();
+      });
+    default:
+      logg[LPythia].error("Unknown string process required.");
+      return false;
+  }
+}
+
 /* This function will generate outgoing particles in computational frame
  * from a hard process.
  * The way to excite soft strings is based on the UrQMD model */
@@ -653,42 +837,19 @@ void ScatterAction::string_excitation() {
   // Disable floating point exception trap for Pythia
   {
     DisableFloatTraps guard;
-    /* initialize the string_process_ object for this particular collision */
-    string_process_->init(incoming_particles_, time_of_execution_);
+    /* Every thread fragments strings with its own instance, which is only
+     * locked against the setup of a new event. */
+    StringProcess &string_process = string_process_->for_this_thread();
+    std::lock_guard<std::mutex> lock(string_process.pythia_mutex());
+    /* initialize the string process for this particular collision */
+    string_process.init(incoming_particles_, time_of_execution_);
     /* implement collision */
     bool success = false;
     int ntry = 0;
     const int ntry_max = 10000;
     while (!success && ntry < ntry_max) {
       ntry++;
-      switch (process_type_) {
-        case ProcessType::StringSoftSingleDiffractiveAX:
-          /* single diffractive to A+X */
-          success = string_process_->next_SDiff(true);
-          break;
-        case ProcessType::StringSoftSingleDiffractiveXB:
-          /* single diffractive to X+B */
-          success = string_process_->next_SDiff(false);
-          break;
-        case ProcessType::StringSoftDoubleDiffractive:
-          /* double diffractive */
-          success = string_process_->next_DDiff();
-          break;
-        case ProcessType::StringSoftNonDiffractive:
-          /* soft non-diffractive */
-          success = string_process_->next_NDiffSoft();
-          break;
-        case ProcessType::StringSoftAnnihilation:
-          /* soft BBbar 2 mesonic annihilation */
-          success = string_process_->next_BBbarAnn();
-          break;
-        case ProcessType::StringHard:
-          success = string_process_->next_NDiffHard();
-          break;
-        default:
-          logg[LPythia].error("Unknown string process required.");
-          success = false;
-      }
+      success = generate_string_subprocess(string_process, process_type_);
     }
     if (ntry == ntry_max) {
       /* If pythia fails to form a string, it is usually because the energy
@@ -713,15 +874,12 @@ void ScatterAction::string_excitation() {
       int ntry_new = 0;
       while (!success_newtry && ntry_new < ntry_max) {
         ntry_new++;
-        if (is_BBbar_Pair) {
-          success_newtry = string_process_->next_BBbarAnn();
-        } else {
-          success_newtry = string_process_->next_DDiff();
-        }
+        success_newtry =
+            generate_string_subprocess(string_process, process_type_);
       }
 
       if (success_newtry) {
-        create_string_final_state();
+        create_string_final_state(string_process);
       }
 
       if (!success_newtry) {
@@ -737,7 +895,7 @@ void ScatterAction::string_excitation() {
         elastic_scattering();
       }
     } else {
-      create_string_final_state();
+      create_string_final_state(string_process);
     }
   }
 }
@@ -1,6 +1,6 @@
 /*
  *
- *    Copyright (c) 2020-2023
+ *    Copyright (c) 2020-2024
  *      SMASH Team
  *
  *    GNU General Public License (GPLv3 or later)
@@ -400,10 +400,11 @@ void ScatterActionMulti::generate_final_state() {
   /* The production point of the new particles.  */
   FourVector middle_point = get_interaction_point();
 
+  // Boost to the computational frame
+  const LorentzBoost to_computational_frame(
+      -total_momentum_of_outgoing_particles().velocity());
   for (ParticleData& new_particle : outgoing_particles_) {
-    // Boost to the computational frame
-    new_particle.boost_momentum(
-        -total_momentum_of_outgoing_particles().velocity());
+    new_particle.boost_momentum(to_computational_frame);
     /* Set positions of the outgoing particles */
     new_particle.set_4position(middle_point);
   }
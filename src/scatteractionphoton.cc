@@ -1,6 +1,6 @@
 /*
  *
- *    Copyright (c) 2016-2022
+ *    Copyright (c) 2016-2022,2024
  *      SMASH Team
  *
  *    GNU General Public License (GPLv3 or later)
@@ -87,13 +87,21 @@ ScatterActionPhoton::ReactionType ScatterActionPhoton::photon_reaction_type(
 }
 
 void ScatterActionPhoton::perform_photons(const OutputsList &outputs) {
+  std::vector<OutputInterface *> photon_outputs;
+  for (const auto &output : outputs) {
+    if (output->is_photon_output()) {
+      photon_outputs.push_back(output.get());
+    }
+  }
+  /* The kinematics only depend on the incoming particles, hence they are
+   * computed once for all fractional photons. The final states only differ
+   * in their momenta, so the conservation laws are checked once. */
+  const FinalStateKinematics kin = prepare_final_state();
   for (int i = 0; i < number_of_fractional_photons_; i++) {
-    generate_final_state();
-    for (const auto &output : outputs) {
-      if (output->is_photon_output()) {
-        // we do not care about the local density
-        output->at_interaction(*this, 0.0);
-      }
+    sample_final_state(kin, i == 0);
+    for (OutputInterface *output : photon_outputs) {
+      // we do not care about the local density
+      output->at_interaction(*this, 0.0);
     }
   }
 }
@@ -188,6 +196,11 @@ bool ScatterActionPhoton::is_kinematically_possible(const double s_sqrt,
 }
 
 void ScatterActionPhoton::generate_final_state() {
+  sample_final_state(prepare_final_state(), true);
+}
+
+ScatterActionPhoton::FinalStateKinematics
+ScatterActionPhoton::prepare_final_state() {
   // we have only one reaction per incoming particle pair
   if (collision_processes_photons_.size() != 1) {
     logg[LScatterAction].fatal()
@@ -199,7 +212,8 @@ void ScatterActionPhoton::generate_final_state() {
   outgoing_particles_ = proc->particle_list();
   process_type_ = proc->get_type();
 
-  FourVector middle_point = get_interaction_point();
+  FinalStateKinematics kin;
+  kin.interaction_point = get_interaction_point();
 
   // t is defined to be the momentum exchanged between the rho meson and the
   // photon in pi + rho -> pi + photon channel. Therefore,
@@ -212,18 +226,37 @@ void ScatterActionPhoton::generate_final_state() {
 
   // 2->2 inelastic scattering
   // Sample the particle momenta in CM system
-  const double m1 = incoming_particles_[0].effective_mass();
-  const double m2 = incoming_particles_[1].effective_mass();
+  kin.m1 = incoming_particles_[0].effective_mass();
+  kin.m2 = incoming_particles_[1].effective_mass();
 
   const double &m_out = hadron_out_mass_;
 
-  const double s = mandelstam_s();
-  const double sqrts = sqrt_s();
-  std::array<double, 2> mandelstam_t = get_t_range(sqrts, m1, m2, m_out, 0.0);
-  const double t1 = mandelstam_t[1];
-  const double t2 = mandelstam_t[0];
-  const double pcm_in = cm_momentum();
-  const double pcm_out = pCM(sqrts, m_out, 0.0);
+  kin.s = mandelstam_s();
+  kin.sqrts = sqrt_s();
+  std::array<double, 2> mandelstam_t =
+      get_t_range(kin.sqrts, kin.m1, kin.m2, m_out, 0.0);
+  kin.t1 = mandelstam_t[1];
+  kin.t2 = mandelstam_t[0];
+  kin.pcm_in = cm_momentum();
+  kin.pcm_out = pCM(kin.sqrts, m_out, 0.0);
+  kin.velocity = total_momentum_of_outgoing_particles().velocity();
+  // if rho in final state take already sampled mass (same as m_out). If rho
+  // is incoming take the mass of the incoming particle
+  kin.m_rho = number_of_fractional_photons_ > 1 ? rho_mass() : 0.;
+  return kin;
+}
+
+void ScatterActionPhoton::sample_final_state(const FinalStateKinematics &kin,
+                                             bool check_conservation) {
+  const double m1 = kin.m1;
+  const double m2 = kin.m2;
+  const double &m_out = hadron_out_mass_;
+  const double s = kin.s;
+  const double sqrts = kin.sqrts;
+  const double t1 = kin.t1;
+  const double t2 = kin.t2;
+  const double pcm_in = kin.pcm_in;
+  const double pcm_out = kin.pcm_out;
 
   const double t = random::uniform(t1, t2);
 
@@ -250,22 +283,18 @@ void ScatterActionPhoton::generate_final_state() {
   outgoing_particles_[1].set_4momentum(0.0, -phitheta.threevec() * pcm_out);
 
   // Set positions & boost to computational frame.
+  const LorentzBoost to_computational_frame(-kin.velocity);
   for (ParticleData &new_particle : outgoing_particles_) {
-    new_particle.set_4position(middle_point);
-    new_particle.boost_momentum(
-        -total_momentum_of_outgoing_particles().velocity());
+    new_particle.set_4position(kin.interaction_point);
+    new_particle.boost_momentum(to_computational_frame);
   }
 
   const double E_Photon = outgoing_particles_[1].momentum()[0];
 
   // Weighing of the fractional photons
   if (number_of_fractional_photons_ > 1) {
-    // if rho in final state take already sampled mass (same as m_out). If rho
-    // is incoming take the mass of the incoming particle
-    const double m_rho = rho_mass();
-
     // compute the differential cross section with form factor included
-    const double diff_xs = diff_cross_section_w_ff(t, m_rho, E_Photon);
+    const double diff_xs = diff_cross_section_w_ff(t, kin.m_rho, E_Photon);
 
     weight_ = diff_xs * (t2 - t1) /
               (number_of_fractional_photons_ * hadronic_cross_section());
@@ -279,10 +308,12 @@ void ScatterActionPhoton::generate_final_state() {
   weight_ *= incoming_particles_[0].xsec_scaling_factor() *
              incoming_particles_[1].xsec_scaling_factor();
 
-  // Photons are not really part of the normal processes, so we have to set a
-  // constant arbitrary number.
-  const auto id_process = ID_PROCESS_PHOTON;
-  Action::check_conservation(id_process);
+  if (check_conservation) {
+    // Photons are not really part of the normal processes, so we have to set a
+    // constant arbitrary number.
+    const auto id_process = ID_PROCESS_PHOTON;
+    Action::check_conservation(id_process);
+  }
 }
 
 void ScatterActionPhoton::add_dummy_hadronic_process(
@@ -349,7 +380,7 @@ CollisionBranchList ScatterActionPhoton::create_collision_branch() {
 
 double ScatterActionPhoton::total_cross_section(MediatorType mediator) const {
   CollisionBranchList process_list;
-  CrosssectionsPhoton<ComputationMethod::Analytic> xs_object;
+  CrosssectionsPhoton<ComputationMethod::Lookup> xs_object;
 
   const double s = mandelstam_s();
   // the mass of the mediating particle depends on the channel. For an incoming
@@ -505,7 +536,7 @@ double ScatterActionPhoton::diff_cross_section(const double t,
   const double s = mandelstam_s();
   double diff_xsection = 0.0;
 
-  CrosssectionsPhoton<ComputationMethod::Analytic> xs_object;
+  CrosssectionsPhoton<ComputationMethod::Lookup> xs_object;
 
   switch (reac_) {
     case ReactionType::pi_p_pi_m_rho_z:
@@ -10,20 +10,112 @@
 #include "smash/scatteractionsfinder.h"
 
 #include <algorithm>
+#include <array>
+#include <cstdint>
+#include <limits>
 #include <map>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <unordered_set>
+#include <utility>
 #include <vector>
 
+#include "smash/collisionprefilter.h"
 #include "smash/constants.h"
 #include "smash/decaymodes.h"
 #include "smash/logging.h"
 #include "smash/parametrizations.h"
+#include "smash/potential_globals.h"
 #include "smash/scatteraction.h"
 #include "smash/scatteractionmulti.h"
 #include "smash/scatteractionphoton.h"
 #include "smash/stringfunctions.h"
+#include "smash/threadpool.h"
 
 namespace smash {
 static constexpr int LFindScatter = LogArea::FindScatter::id;
+
+namespace {
+/// Written instead of throwing for too large 2-particle probabilities
+RateLimitedWarning high_probability_2_warning(
+    LFindScatter, "2-particle collision probability too large");
+/// Written instead of throwing for too large multi-particle probabilities
+RateLimitedWarning high_probability_multi_warning(
+    LFindScatter, "Multi-particle collision probability larger than 1");
+
+/// Classes of particles taking part in multi-particle reactions
+enum MultiParticleClass : unsigned {
+  /// Pions
+  MultiPion = 1u << 0,
+  /// Eta meson
+  MultiEta = 1u << 1,
+  /// Nucleons and anti-nucleons
+  MultiNucleon = 1u << 2,
+  /// Lambdas and anti-Lambdas
+  MultiLambda = 1u << 3
+};
+
+/**
+ * \param[in] data Particle
+ * \return Class of the particle in multi-particle reactions, 0 if it takes
+ *         part in none of them
+ */
+unsigned multi_particle_class(const ParticleData& data) {
+  const PdgCode pdg = data.pdgcode();
+  if (pdg.is_pion()) {
+    return MultiPion;
+  } else if (pdg == pdg::eta) {
+    return MultiEta;
+  } else if (pdg.is_nucleon()) {
+    return MultiNucleon;
+  } else if (pdg.is_Lambda()) {
+    return MultiLambda;
+  }
+  return 0;
+}
+}  // namespace
+
+void CollisionFinderStatistics::add(const CollisionFinderStatistics& other) {
+  pairs_in_cells += other.pairs_in_cells;
+  pairs_with_neighbors += other.pairs_with_neighbors;
+  prefiltered += other.prefiltered;
+  rejected_nucleus += other.rejected_nucleus;
+  rejected_types += other.rejected_types;
+  rejected_time += other.rejected_time;
+  rejected_distance += other.rejected_distance;
+  rejected_cross_section += other.rejected_cross_section;
+  rejected_probability += other.rejected_probability;
+  rejected_repeated += other.rejected_repeated;
+  actions_created += other.actions_created;
+  actions_found += other.actions_found;
+  actions_performed += other.actions_performed;
+  actions_invalid += other.actions_invalid;
+  actions_pauli_blocked += other.actions_pauli_blocked;
+}
+
+std::ostream& operator<<(std::ostream& out,
+                         const CollisionFinderStatistics& statistics) {
+  return out << "pairs in cells/with neighbors = " << statistics.pairs_in_cells
+             << "/" << statistics.pairs_with_neighbors
+             << ", rejected by prefilter/types/nucleus/time/distance/cross "
+                "section/probability/repetition = "
+             << statistics.prefiltered << "/" << statistics.rejected_types
+             << "/" << statistics.rejected_nucleus << "/"
+             << statistics.rejected_time << "/"
+             << statistics.rejected_distance << "/"
+             << statistics.rejected_cross_section << "/"
+             << statistics.rejected_probability << "/"
+             << statistics.rejected_repeated
+             << ", scatterings created/found/performed/invalid/Pauli-blocked = "
+             << statistics.actions_created << "/" << statistics.actions_found
+             << "/" << statistics.actions_performed << "/"
+             << statistics.actions_invalid << "/"
+             << statistics.actions_pauli_blocked;
+}
 /*!\Userguide
  * \page doxypage_input_conf_ct_string_parameters
  *
@@ -35,14 +127,36 @@ ScatterActionsFinder::ScatterActionsFinder(
     Configuration& config, const ExperimentParameters& parameters)
     : finder_parameters_(create_finder_parameters(config, parameters)),
       isotropic_(config.take({"Collision_Term", "Isotropic"}, false)),
+      sample_pairs_(
+          config.take({"Collision_Term", "Sample_Pairs"},
+                      InputKeys::collTerm_samplePairs.default_value())),
       box_length_(parameters.box_length),
       string_formation_time_(config.take(
-          {"Collision_Term", "String_Parameters", "Formation_Time"}, 1.)) {
+          {"Collision_Term", "String_Parameters", "Formation_Time"}, 1.)),
+      cross_section_envelope_(
+          [this](const ParticleData& data_a, const ParticleData& data_b) {
+            return exact_cross_section(data_a, data_b);
+          }) {
+  if (config.take({"Collision_Term", "Tabulated_Cross_Sections"},
+                  InputKeys::collTerm_tabulatedCrossSections.default_value())) {
+    logg[LFindScatter].info(
+        "Interpolating collision branches of stable particles from tables.");
+    cross_section_table_ = std::make_unique<CrossSectionTable>(
+        [this](const ParticleData& data_a, const ParticleData& data_b) {
+          return exact_collision_list(data_a, data_b);
+        });
+  }
   if (is_constant_elastic_isotropic()) {
     logg[LFindScatter].info(
         "Constant elastic isotropic cross-section mode:", " using ",
         finder_parameters_.elastic_parameter, " mb as maximal cross-section.");
   }
+  if (sample_pairs_ &&
+      finder_parameters_.coll_crit != CollisionCriterion::Stochastic) {
+    throw std::invalid_argument(
+        "Only sample the pairs of a cell with the stochastic collision "
+        "criterion.");
+  }
   if (finder_parameters_.included_multi.any() &&
       finder_parameters_.coll_crit != CollisionCriterion::Stochastic) {
     throw std::invalid_argument(
@@ -124,6 +238,27 @@ ScatterActionsFinder::ScatterActionsFinder(
         subconfig.take({"Popcorn_Rate"}, 0.15),
         subconfig.take({"Use_Monash_Tune"},
                        parameters.use_monash_tune_default.value()));
+    string_process_interface_->set_share_hard_pythia(
+        subconfig.take({"Share_Hard_Pythia"}, false));
+    string_process_interface_->set_tabulate_diffractive(
+        subconfig.take({"Tabulate_Diffractive"}, false));
+    const std::vector<std::string> prewarm_beams =
+        subconfig.take({"Prewarm_Hard_Beams"}, std::vector<std::string>{});
+    const double prewarm_sqrts = subconfig.take({"Prewarm_Hard_Sqrts"}, 100.);
+    if (!prewarm_beams.empty()) {
+      std::vector<std::pair<PdgCode, PdgCode>> beams;
+      for (const std::string &beam : prewarm_beams) {
+        std::istringstream stream(beam);
+        std::string pdg_a, pdg_b, rest;
+        if (!(stream >> pdg_a >> pdg_b) || stream >> rest) {
+          throw std::invalid_argument(
+              "Prewarm_Hard_Beams expects two PDG codes per entry, got \"" +
+              beam + "\".");
+        }
+        beams.emplace_back(PdgCode(pdg_a), PdgCode(pdg_b));
+      }
+      string_process_interface_->prewarm_hard_pythia(beams, prewarm_sqrts);
+    }
   }
 }
 
@@ -208,10 +343,173 @@ ScatterActionsFinderParameters create_finder_parameters(
                   InputKeys::collTerm_pseudoresonance.default_value())};
 }
 
+bool ScatterActionsFinder::incoming_parametrized(
+    const ParticleData& data_a, const ParticleData& data_b) const {
+  if (finder_parameters_.total_xs_strategy ==
+      TotalCrossSectionStrategy::TopDownMeasured) {
+    return parametrization_exists(data_a.type().pdgcode(),
+                                  data_b.type().pdgcode());
+  }
+  return finder_parameters_.total_xs_strategy ==
+         TotalCrossSectionStrategy::TopDown;
+}
+
+bool ScatterActionsFinder::can_interact(const ParticleData& data_a,
+                                        const ParticleData& data_b) const {
+  std::call_once(interaction_thresholds_once_,
+                 [this]() { tabulate_interaction_thresholds(); });
+  // std::addressof, because ParticleType overloads operator&
+  const ParticleType* first = std::addressof(ParticleType::list_all()[0]);
+  const std::size_t n = ParticleType::list_all().size();
+  const std::size_t i = std::addressof(data_a.type()) - first;
+  const std::size_t j = std::addressof(data_b.type()) - first;
+  const double threshold = interaction_thresholds_[i * n + j];
+  if (threshold <= 0.) {
+    return true;
+  }
+  // Same energy as ScatterAction::sqrt_s, which the formation is checked with
+  return (data_a.momentum() + data_b.momentum()).abs() > threshold;
+}
+
+void ScatterActionsFinder::tabulate_interaction_thresholds() const {
+  const ParticleTypeList& types = ParticleType::list_all();
+  const std::size_t n = types.size();
+  const ScatterActionsFinderParameters& p = finder_parameters_;
+  const bool elastic = p.included_2to2[IncludedReactions::Elastic];
+  // Every pair has a total cross section
+  if (p.total_xs_strategy == TotalCrossSectionStrategy::TopDown ||
+      (elastic && (p.elastic_parameter > 0. || p.additional_el_xs > 0.))) {
+    interaction_thresholds_.assign(n * n, 0.);
+    return;
+  }
+  ReactionsBitSet inelastic_2to2 = p.included_2to2;
+  inelastic_2to2.reset(IncludedReactions::Elastic);
+  const bool nnbar_processes =
+      p.nnbar_treatment == NNbarTreatment::Resonances ||
+      p.nnbar_treatment == NNbarTreatment::TwoToFive;
+  /* The threshold of the resonance formation does not hold with potentials,
+   * like the cross section envelope. */
+  const bool energy_dependent_only =
+      UB_lat_pointer == nullptr && UI3_lat_pointer == nullptr;
+  constexpr double never = std::numeric_limits<double>::infinity();
+
+  interaction_thresholds_.assign(n * n, never);
+  for (std::size_t i = 0; i < n; i++) {
+    const PdgCode a = types[i].pdgcode();
+    for (std::size_t j = 0; j < n; j++) {
+      const PdgCode b = types[j].pdgcode();
+      auto either = [&a, &b](bool (PdgCode::*is_x)() const,
+                             bool (PdgCode::*is_y)() const) {
+        return ((a.*is_x)() && (b.*is_y)()) || ((b.*is_x)() && (a.*is_y)());
+      };
+      const bool nucleus = a.is_nucleus() || b.is_nucleus();
+      const bool hadrons = a.is_hadron() && b.is_hadron();
+      const bool parametrized_elastic =
+          either(&PdgCode::is_nucleon, &PdgCode::is_pion) ||
+          either(&PdgCode::is_nucleon, &PdgCode::is_kaon) ||
+          (a.is_nucleon() && b.is_nucleon()) || nucleus ||
+          (p.use_AQM && hadrons);
+      const bool two_to_two =
+          (a.is_baryon() && b.is_baryon()) ||
+          either(&PdgCode::is_nucleon, &PdgCode::is_kaon) ||
+          either(&PdgCode::is_hyperon, &PdgCode::is_pion) ||
+          either(&PdgCode::is_Delta, &PdgCode::is_kaon) || nucleus;
+      const bool nnbar =
+          (a.is_nucleon() && b.is_nucleon()) ||
+          (a == pdg::rho_z && b == pdg::h1) ||
+          (a == pdg::h1 && b == pdg::rho_z);
+      if ((p.total_xs_strategy == TotalCrossSectionStrategy::TopDownMeasured &&
+           parametrization_exists(a, b)) ||
+          (elastic && p.elastic_parameter < 0. && parametrized_elastic) ||
+          (p.strings_switch && (hadrons || nucleus)) ||
+          (inelastic_2to2.any() && two_to_two) ||
+          (p.included_multi.any() && nucleus) ||
+          (nnbar_processes && nnbar)) {
+        interaction_thresholds_[i * n + j] = 0.;
+        continue;
+      }
+      if (!p.two_to_one) {
+        continue;
+      }
+      double threshold = never;
+      for (const ResonanceFormation& resonance :
+           resonance_formations(types[i], types[j])) {
+        threshold = std::min(threshold, resonance.threshold);
+      }
+      // Pseudo-resonances and tabulated branches are not bound by it
+      if (threshold < never &&
+          (!energy_dependent_only ||
+           p.pseudoresonance_method != PseudoResonance::None ||
+           cross_section_table_)) {
+        threshold = 0.;
+      }
+      interaction_thresholds_[i * n + j] = threshold;
+    }
+  }
+}
+
+double ScatterActionsFinder::exact_cross_section(
+    const ParticleData& data_a, const ParticleData& data_b) const {
+  const bool parametrized = incoming_parametrized(data_a, data_b);
+  ScatterAction act(data_a, data_b, 0., isotropic_, string_formation_time_,
+                    box_length_, parametrized);
+  if (finder_parameters_.strings_switch) {
+    act.set_string_interface(string_process_interface_.get());
+  }
+  if (parametrized) {
+    act.set_parametrized_total_cross_section(finder_parameters_);
+  } else {
+    act.add_all_scatterings(finder_parameters_);
+  }
+  return act.cross_section();
+}
+
+CollisionBranchList ScatterActionsFinder::exact_collision_list(
+    const ParticleData& data_a, const ParticleData& data_b) const {
+  const bool parametrized = incoming_parametrized(data_a, data_b);
+  ScatterAction act(data_a, data_b, 0., isotropic_, string_formation_time_,
+                    box_length_, parametrized);
+  if (finder_parameters_.strings_switch) {
+    act.set_string_interface(string_process_interface_.get());
+  }
+  if (parametrized) {
+    act.set_parametrized_total_cross_section(finder_parameters_);
+  }
+  act.add_all_scatterings(finder_parameters_);
+  CollisionBranchList branches;
+  branches.reserve(act.collision_channels().size());
+  for (const CollisionBranchPtr& branch : act.collision_channels()) {
+    branches.push_back(std::make_unique<CollisionBranch>(
+        branch->particle_types(), branch->weight(), branch->get_type()));
+  }
+  return branches;
+}
+
+bool ScatterActionsFinder::add_tabulated_scatterings(ScatterAction& act) const {
+  if (!cross_section_table_) {
+    return false;
+  }
+  const ParticleList& incoming = act.incoming_particles();
+  std::optional<CollisionBranchList> branches =
+      cross_section_table_->collision_list(incoming[0], incoming[1],
+                                           act.sqrt_s());
+  if (!branches) {
+    return false;
+  }
+  act.add_tabulated_scatterings(std::move(*branches));
+  return true;
+}
+
+template <CollisionCriterion Criterion>
 ActionPtr ScatterActionsFinder::check_collision_two_part(
     const ParticleData& data_a, const ParticleData& data_b, double dt,
-    const std::vector<FourVector>& beam_momentum,
-    const double gcell_vol) const {
+    CollisionFinderStatistics& counts,
+    const std::vector<FourVector>& beam_momentum, const double gcell_vol,
+    const double majorant) const {
+  if (collision_trace_) {
+    collision_trace_->add_pair(Criterion, data_a, data_b, dt, gcell_vol,
+                               majorant);
+  }
   /* If the two particles
    * 1) belong to one of the two colliding nuclei, and
    * 2) both of them have never experienced any collisions,
@@ -227,41 +525,54 @@ ActionPtr ScatterActionsFinder::check_collision_two_part(
         data_a.get_history().collisions_per_particle == 0 &&
         data_b.get_history().collisions_per_particle == 0;
     if (in_same_nucleus && never_interacted_before) {
+      counts.rejected_nucleus++;
       return nullptr;
     }
   }
 
+  /* Pairs of types, which cannot interact, are rejected first. The stochastic
+   * criterion draws random numbers for the collision time and the probability
+   * of such pairs, hence they are only rejected after the time, drawing the
+   * number of the probability, such that the random numbers do not change. */
+  constexpr bool stochastic = Criterion == CollisionCriterion::Stochastic;
+  if (!stochastic && !can_interact(data_a, data_b)) {
+    counts.rejected_types++;
+    return nullptr;
+  }
+
   // No grid or search in cell means no collision for stochastic criterion
-  if (finder_parameters_.coll_crit == CollisionCriterion::Stochastic &&
+  if (Criterion == CollisionCriterion::Stochastic &&
       gcell_vol < really_small) {
+    counts.rejected_probability++;
     return nullptr;
   }
 
   // Determine time of collision.
   const double time_until_collision =
-      collision_time(data_a, data_b, dt, beam_momentum);
+      collision_time<Criterion>(data_a, data_b, dt, beam_momentum);
 
   // Check that collision happens in this timestep.
   if (time_until_collision < 0. || time_until_collision >= dt) {
+    counts.rejected_time++;
     return nullptr;
   }
 
-  // Determine which total cross section to use
-  bool incoming_parametrized = (finder_parameters_.total_xs_strategy ==
-                                TotalCrossSectionStrategy::TopDown);
-  if (finder_parameters_.total_xs_strategy ==
-      TotalCrossSectionStrategy::TopDownMeasured) {
-    const PdgCode& pdg_a = data_a.type().pdgcode();
-    const PdgCode& pdg_b = data_b.type().pdgcode();
-    incoming_parametrized = parametrization_exists(pdg_a, pdg_b);
+  if (stochastic && !can_interact(data_a, data_b)) {
+    random::uniform(0., 1.);
+    counts.rejected_types++;
+    return nullptr;
   }
 
+  // Determine which total cross section to use
+  const bool parametrized = incoming_parametrized(data_a, data_b);
+
   // Create ScatterAction object.
   ScatterActionPtr act = std::make_unique<ScatterAction>(
       data_a, data_b, time_until_collision, isotropic_, string_formation_time_,
-      box_length_, incoming_parametrized);
+      box_length_, parametrized);
+  counts.actions_created++;
 
-  if (finder_parameters_.coll_crit == CollisionCriterion::Stochastic) {
+  if constexpr (Criterion == CollisionCriterion::Stochastic) {
     act->set_stochastic_pos_idx();
   }
 
@@ -271,55 +582,101 @@ ActionPtr ScatterActionsFinder::check_collision_two_part(
 
   // Distance squared calculation not needed for stochastic criterion
   const double distance_squared =
-      (finder_parameters_.coll_crit == CollisionCriterion::Geometric)
+      (Criterion == CollisionCriterion::Geometric)
           ? act->transverse_distance_sqr()
-      : (finder_parameters_.coll_crit == CollisionCriterion::Covariant)
+      : (Criterion == CollisionCriterion::Covariant)
           ? act->cov_transverse_distance_sqr()
           : 0.0;
 
   // Don't calculate cross section if the particles are very far apart.
   // Not needed for stochastic criterion because of cell structure.
-  if (finder_parameters_.coll_crit != CollisionCriterion::Stochastic &&
+  if (Criterion != CollisionCriterion::Stochastic &&
       distance_squared >=
           max_transverse_distance_sqr(finder_parameters_.testparticles)) {
+    counts.rejected_distance++;
     return nullptr;
   }
 
-  if (incoming_parametrized) {
-    act->set_parametrized_total_cross_section(finder_parameters_);
-  } else {
-    // Add various subprocesses.
-    act->add_all_scatterings(finder_parameters_);
+  // Cross section scaling factors and test particles
+  const double xs_factor =
+      fm2_mb / static_cast<double>(finder_parameters_.testparticles) *
+      data_a.xsec_scaling_factor(time_until_collision) *
+      data_b.xsec_scaling_factor(time_until_collision);
+
+  /* Reject the pair by the upper bound of the cross section already, such
+   * that the collision branches are only set up for pairs which may collide.
+   * The bound, like the cross section table, does not hold if potentials
+   * shift the thresholds. */
+  const bool energy_dependent_only =
+      UB_lat_pointer == nullptr && UI3_lat_pointer == nullptr;
+  const double max_xs =
+      energy_dependent_only
+          ? cross_section_envelope_.max_cross_section(data_a, data_b,
+                                                      act->sqrt_s())
+          : std::numeric_limits<double>::infinity();
+  /* The random number of the stochastic criterion is drawn in advance, which
+   * does not change the sequence of random numbers. A pair picked with the
+   * probability of the majorant compares its probability with a number up to
+   * the majorant. */
+  double random_no = 0.;
+  if constexpr (Criterion == CollisionCriterion::Stochastic) {
+    random_no = random::uniform(0., majorant);
+    if (random_no >
+        max_xs * xs_factor * act->relative_velocity() * dt / gcell_vol) {
+      counts.rejected_probability++;
+      return nullptr;
+    }
+  } else if (distance_squared >= max_xs * xs_factor * M_1_PI) {
+    counts.rejected_cross_section++;
+    return nullptr;
   }
 
-  double xs = act->cross_section() * fm2_mb /
-              static_cast<double>(finder_parameters_.testparticles);
+  /* Unless the branches are interpolated, only the total cross section is
+   * computed here, and the branches are set up once the pair passed the
+   * collision criterion. */
+  const bool tabulated = !parametrized && energy_dependent_only &&
+                         add_tabulated_scatterings(*act);
+  if (parametrized) {
+    act->set_parametrized_total_cross_section(finder_parameters_);
+  }
+  const double total_xs = parametrized || tabulated
+                              ? act->cross_section()
+                              : act->sum_of_all_scatterings(finder_parameters_);
+  assert(total_xs <= max_xs);
 
-  // Take cross section scaling factors into account
-  xs *= data_a.xsec_scaling_factor(time_until_collision);
-  xs *= data_b.xsec_scaling_factor(time_until_collision);
+  const double xs = total_xs * xs_factor;
 
-  if (finder_parameters_.coll_crit == CollisionCriterion::Stochastic) {
+  if constexpr (Criterion == CollisionCriterion::Stochastic) {
     const double v_rel = act->relative_velocity();
     /* Collision probability for 2-particle scattering, see
      * \iref{Staudenmaier:2021lrg}. */
     const double prob = xs * v_rel * dt / gcell_vol;
 
-    logg[LFindScatter].debug(
+    SMASH_LOG_DEBUG(
+        LFindScatter,
         "Stochastic collison criterion parameters (2-particles):\nprob = ",
         prob, ", xs = ", xs, ", v_rel = ", v_rel, ", dt = ", dt,
         ", gcell_vol = ", gcell_vol,
         ", testparticles = ", finder_parameters_.testparticles);
 
-    if (prob > 1.) {
+    // Only the written warnings are formatted
+    if (prob > majorant && (!finder_parameters_.only_warn_for_high_prob ||
+                            high_probability_2_warning.count())) {
       std::stringstream err;
-      err << "Probability larger than 1 for stochastic rates. ( P_22 = " << prob
-          << " )\n"
+      if (majorant < 1.) {
+        err << "Probability larger than the majorant " << majorant
+            << " of the sampled pairs. ( P_22 = " << prob << " )\n";
+      } else {
+        err << "Probability larger than 1 for stochastic rates. ( P_22 = "
+            << prob << " )\n";
+      }
+      err
           << data_a.type().name() << data_b.type().name() << " with masses "
           << data_a.momentum().abs() << " and " << data_b.momentum().abs()
           << " at sqrts[GeV] = " << act->sqrt_s()
           << " with xs[fm^2]/Ntest = " << xs
-          << "\nConsider using smaller timesteps.";
+          << (majorant < 1. ? "\nConsider increasing Maximum_Cross_Section."
+                            : "\nConsider using smaller timesteps.");
       if (finder_parameters_.only_warn_for_high_prob) {
         logg[LFindScatter].warn(err.str());
       } else {
@@ -328,20 +685,18 @@ ActionPtr ScatterActionsFinder::check_collision_two_part(
     }
 
     // probability criterion
-    double random_no = random::uniform(0., 1.);
     if (random_no > prob) {
+      counts.rejected_probability++;
       return nullptr;
     }
 
-  } else if (finder_parameters_.coll_crit == CollisionCriterion::Geometric ||
-             finder_parameters_.coll_crit == CollisionCriterion::Covariant) {
+  } else {
     // just collided with this particle
     if (data_a.id_process() > 0 && data_a.id_process() == data_b.id_process()) {
-      logg[LFindScatter].debug("Skipping collided particles at time ",
-                               data_a.position().x0(), " due to process ",
-                               data_a.id_process(), "\n    ", data_a, "\n<-> ",
-                               data_b);
-
+      SMASH_LOG_DEBUG(LFindScatter, "Skipping collided particles at time ",
+                      data_a.position().x0(), " due to process ",
+                      data_a.id_process(), "\n    ", data_a, "\n<-> ", data_b);
+      counts.rejected_repeated++;
       return nullptr;
     }
 
@@ -350,18 +705,26 @@ ActionPtr ScatterActionsFinder::check_collision_two_part(
 
     // distance criterion according to cross_section
     if (distance_squared >= cross_section_criterion) {
+      counts.rejected_cross_section++;
       return nullptr;
     }
 
-    logg[LFindScatter].debug("particle distance squared: ", distance_squared,
-                             "\n    ", data_a, "\n<-> ", data_b);
+    SMASH_LOG_DEBUG(LFindScatter, "particle distance squared: ",
+                    distance_squared, "\n    ", data_a, "\n<-> ", data_b);
   }
 
   // Include possible outgoing branches
-  if (incoming_parametrized) {
+  if (parametrized) {
+    if (!energy_dependent_only || !add_tabulated_scatterings(*act)) {
+      act->add_all_scatterings(finder_parameters_);
+    }
+  } else if (!tabulated) {
     act->add_all_scatterings(finder_parameters_);
+    assert(std::abs(act->cross_section() - total_xs) <=
+           1e-9 * total_xs + really_small);
   }
 
+  counts.actions_found++;
   return act;
 }
 
@@ -418,7 +781,8 @@ ActionPtr ScatterActionsFinder::check_collision_multi_part(
       std::pow(finder_parameters_.testparticles, plist.size() - 1);
 
   // 5. Check that probability is smaller than one
-  if (prob > 1.) {
+  if (prob > 1. && (!finder_parameters_.only_warn_for_high_prob ||
+                    high_probability_multi_warning.count())) {
     std::stringstream err;
     err << "Probability " << prob << " larger than 1 for stochastic rates for ";
     for (const ParticleData& data : plist) {
@@ -443,88 +807,264 @@ ActionPtr ScatterActionsFinder::check_collision_multi_part(
 }
 
 ActionList ScatterActionsFinder::find_actions_in_cell(
-    const ParticleList& search_list, double dt, const double gcell_vol,
+    const ParticleSpan& search_list, double dt, const double gcell_vol,
     const std::vector<FourVector>& beam_momentum) const {
+  if (finder_parameters_.coll_crit == CollisionCriterion::Geometric) {
+    // Multi-particle reactions need the stochastic criterion
+    CollisionFinderStatistics counts;
+    ActionList actions = find_geometric_collisions(
+        search_list, search_list, true, dt, beam_momentum, counts);
+    add_statistics(counts);
+    return actions;
+  }
   std::vector<ActionPtr> actions;
-  for (const ParticleData& p1 : search_list) {
-    for (const ParticleData& p2 : search_list) {
-      // Check for 2 particle scattering
-      if (p1.id() < p2.id()) {
-        ActionPtr act =
-            check_collision_two_part(p1, p2, dt, beam_momentum, gcell_vol);
+  CollisionFinderStatistics counts;
+  if (!sample_pairs_ || !sample_pairs_in_cell(search_list, dt, gcell_vol,
+                                              beam_momentum, counts, actions)) {
+    with_criterion([&](auto criterion) {
+      for (const ParticleData& p1 : search_list) {
+        for (const ParticleData& p2 : search_list) {
+          // Check for 2 particle scattering
+          if (p1.id() < p2.id()) {
+            counts.pairs_in_cells++;
+            ActionPtr act =
+                check_collision_two_part<decltype(criterion)::value>(
+                    p1, p2, dt, counts, beam_momentum, gcell_vol);
+            if (act) {
+              actions.push_back(std::move(act));
+            }
+          }
+        }
+      }
+    });
+  }
+  if (finder_parameters_.included_multi.any()) {
+    add_multi_particle_actions(search_list, dt, gcell_vol, actions);
+  }
+  add_statistics(counts);
+  return actions;
+}
+
+bool ScatterActionsFinder::sample_pairs_in_cell(
+    const ParticleSpan& search_list, double dt, double gcell_vol,
+    const std::vector<FourVector>& beam_momentum,
+    CollisionFinderStatistics& counts, ActionList& actions) const {
+  const std::int64_t n = search_list.size();
+  if (n < 2 || gcell_vol < really_small) {
+    return false;
+  }
+  /* The cross section scaling factor of a particle lies between its initial
+   * one and 1, the relative velocity is at most 2. */
+  double max_scaling = 1.;
+  for (const ParticleData& p : search_list) {
+    max_scaling = std::max(max_scaling, p.initial_xsec_scaling_factor());
+  }
+  const double majorant = 2. * maximum_cross_section() * fm2_mb /
+                          finder_parameters_.testparticles * max_scaling *
+                          max_scaling * dt / gcell_vol;
+  /* Distinct candidates are picked by rejecting the ones picked before, which
+   * only stays cheap if they are a small fraction of all pairs. */
+  if (!(majorant <= 0.5)) {
+    return false;
+  }
+  const std::int64_t n_candidates = random::binomial(n * (n - 1) / 2, majorant);
+  std::unordered_set<std::int64_t> picked;
+  picked.reserve(n_candidates);
+  while (static_cast<std::int64_t>(picked.size()) < n_candidates) {
+    const std::int64_t i = random::uniform_int<std::int64_t>(0, n - 1);
+    std::int64_t j = random::uniform_int<std::int64_t>(0, n - 2);
+    if (j >= i) {
+      j++;
+    }
+    if (!picked.insert(std::min(i, j) * n + std::max(i, j)).second) {
+      continue;
+    }
+    const ParticleData* p1 = &search_list[i];
+    const ParticleData* p2 = &search_list[j];
+    if (p1->id() > p2->id()) {
+      std::swap(p1, p2);
+    }
+    counts.pairs_in_cells++;
+    ActionPtr act = check_collision_two_part<CollisionCriterion::Stochastic>(
+        *p1, *p2, dt, counts, beam_momentum, gcell_vol, majorant);
+    if (act) {
+      actions.push_back(std::move(act));
+    }
+  }
+  return true;
+}
+
+void ScatterActionsFinder::add_multi_particle_actions(
+    const ParticleSpan& search_list, double dt, const double gcell_vol,
+    ActionList& actions) const {
+  const MultiParticleReactionsBitSet& incl = finder_parameters_.included_multi;
+  /* Number of incoming particles and classes of particles taking part in the
+   * multi-particle reactions, see ScatterActionMulti::add_possible_reactions.
+   * Reactions, which are not included, accept no particles. */
+  struct Reaction {
+    std::size_t n_incoming;
+    unsigned classes;
+  };
+  const auto classes_if = [&incl](IncludedMultiParticleReactions r,
+                                  unsigned classes) {
+    return incl[r] == 1 ? classes : 0u;
+  };
+  const std::array<Reaction, 4> reactions{{
+      {3, classes_if(IncludedMultiParticleReactions::Meson_3to1,
+                     MultiPion | MultiEta)},
+      {3, classes_if(IncludedMultiParticleReactions::Deuteron_3to2,
+                     MultiPion | MultiNucleon)},
+      {4, classes_if(IncludedMultiParticleReactions::A3_Nuclei_4to2,
+                     MultiPion | MultiNucleon | MultiLambda)},
+      {5, classes_if(IncludedMultiParticleReactions::NNbar_5to2, MultiPion)},
+  }};
+
+  for (std::size_t n_incoming = 3; n_incoming <= 5; n_incoming++) {
+    /* Candidates in ascending order of their ids, together with the reactions
+     * of n_incoming particles (as bits of the index in reactions), which they
+     * may take part in. */
+    std::vector<std::pair<const ParticleData*, unsigned>> candidates;
+    for (const ParticleData& data : search_list) {
+      const unsigned particle_class = multi_particle_class(data);
+      unsigned possible = 0;
+      for (std::size_t r = 0; r < reactions.size(); r++) {
+        if (reactions[r].n_incoming == n_incoming &&
+            (reactions[r].classes & particle_class) != 0) {
+          possible |= 1u << r;
+        }
+      }
+      if (possible != 0) {
+        candidates.emplace_back(&data, possible);
+      }
+    }
+    if (candidates.size() < n_incoming) {
+      continue;
+    }
+    std::sort(candidates.begin(), candidates.end(),
+              [](const auto& a, const auto& b) {
+                return a.first->id() < b.first->id();
+              });
+
+    /* Enumerate the combinations of n_incoming candidates in ascending order
+     * of their ids, skipping all combinations containing a particle, which
+     * takes part in none of the reactions possible for the others. */
+    ParticleList incoming;
+    const auto enumerate = [&](const auto& self, std::size_t first,
+                               unsigned possible) -> void {
+      if (incoming.size() == n_incoming) {
+        ActionPtr act = check_collision_multi_part(incoming, dt, gcell_vol);
         if (act) {
           actions.push_back(std::move(act));
         }
+        return;
       }
-      if (finder_parameters_.included_multi.any()) {
-        // Also, check for 3 particle scatterings with stochastic criterion
-        for (const ParticleData& p3 : search_list) {
-          if (finder_parameters_.included_multi
-                      [IncludedMultiParticleReactions::Deuteron_3to2] == 1 ||
-              finder_parameters_.included_multi
-                      [IncludedMultiParticleReactions::Meson_3to1] == 1) {
-            if (p1.id() < p2.id() && p2.id() < p3.id()) {
-              ActionPtr act =
-                  check_collision_multi_part({p1, p2, p3}, dt, gcell_vol);
-              if (act) {
-                actions.push_back(std::move(act));
-              }
-            }
-          }
-          for (const ParticleData& p4 : search_list) {
-            if (finder_parameters_.included_multi
-                    [IncludedMultiParticleReactions::A3_Nuclei_4to2]) {
-              if (p1.id() < p2.id() && p2.id() < p3.id() && p3.id() < p4.id()) {
-                ActionPtr act =
-                    check_collision_multi_part({p1, p2, p3, p4}, dt, gcell_vol);
-                if (act) {
-                  actions.push_back(std::move(act));
-                }
-              }
-            }
-            if (finder_parameters_.included_multi
-                        [IncludedMultiParticleReactions::NNbar_5to2] == 1 &&
-                search_list.size() >= 5) {
-              for (const ParticleData& p5 : search_list) {
-                if ((p1.id() < p2.id() && p2.id() < p3.id() &&
-                     p3.id() < p4.id() && p4.id() < p5.id()) &&
-                    (p1.is_pion() && p2.is_pion() && p3.is_pion() &&
-                     p4.is_pion() && p5.is_pion())) {
-                  // at the moment only pure pion 5-body reactions
-                  ActionPtr act = check_collision_multi_part(
-                      {p1, p2, p3, p4, p5}, dt, gcell_vol);
-                  if (act) {
-                    actions.push_back(std::move(act));
-                  }
-                }
-              }
-            }
-          }
+      const std::size_t missing = n_incoming - incoming.size();
+      for (std::size_t i = first; i + missing <= candidates.size(); i++) {
+        const unsigned still_possible = possible & candidates[i].second;
+        if (still_possible == 0) {
+          continue;
         }
+        incoming.push_back(*candidates[i].first);
+        self(self, i + 1, still_possible);
+        incoming.pop_back();
       }
-    }
+    };
+    enumerate(enumerate, 0, ~0u);
   }
-  return actions;
 }
 
 ActionList ScatterActionsFinder::find_actions_with_neighbors(
-    const ParticleList& search_list, const ParticleList& neighbors_list,
+    const ParticleSpan& search_list, const ParticleSpan& neighbors_list,
     double dt, const std::vector<FourVector>& beam_momentum) const {
   std::vector<ActionPtr> actions;
   if (finder_parameters_.coll_crit == CollisionCriterion::Stochastic) {
     // Only search in cells
     return actions;
+  } else if (finder_parameters_.coll_crit == CollisionCriterion::Geometric) {
+    CollisionFinderStatistics counts;
+    actions = find_geometric_collisions(search_list, neighbors_list, false, dt,
+                                        beam_momentum, counts);
+    add_statistics(counts);
+    return actions;
   }
+  CollisionFinderStatistics counts;
   for (const ParticleData& p1 : search_list) {
     for (const ParticleData& p2 : neighbors_list) {
       assert(p1.id() != p2.id());
+      counts.pairs_with_neighbors++;
       // Check if a collision is possible.
-      ActionPtr act = check_collision_two_part(p1, p2, dt, beam_momentum);
+      ActionPtr act = check_collision_two_part<CollisionCriterion::Covariant>(
+          p1, p2, dt, counts, beam_momentum);
       if (act) {
         actions.push_back(std::move(act));
       }
     }
   }
+  add_statistics(counts);
+  return actions;
+}
+
+ActionList ScatterActionsFinder::find_geometric_collisions(
+    const ParticleSpan& search_list, const ParticleSpan& partners,
+    bool same_list, double dt, const std::vector<FourVector>& beam_momentum,
+    CollisionFinderStatistics& counts) const {
+  // Kept per thread to reuse the memory, as the finder is shared
+  thread_local KinematicsSnapshot search_snapshot, partners_snapshot;
+  thread_local CollisionPrefilter prefilter;
+  search_snapshot.assign(search_list, beam_momentum);
+  if (!same_list) {
+    partners_snapshot.assign(partners, beam_momentum);
+  }
+  const KinematicsSnapshot& partners_kinematics =
+      same_list ? search_snapshot : partners_snapshot;
+  const double max_distance_sqr =
+      max_transverse_distance_sqr(finder_parameters_.testparticles);
+  /* The selected pairs are also compared with the cross section envelope,
+   * before an action is set up for them, see check_collision_two_part. The
+   * scaling factors of the cross sections stay between their initial value
+   * and 1. */
+  const bool energy_dependent_only =
+      UB_lat_pointer == nullptr && UI3_lat_pointer == nullptr;
+  const double xs_to_distance_sqr =
+      fm2_mb * M_1_PI / static_cast<double>(finder_parameters_.testparticles);
+
+  const std::uint64_t n = search_list.size();
+  const std::uint64_t n_pairs =
+      same_list ? n * (n - 1) / 2 : n * partners.size();
+  (same_list ? counts.pairs_in_cells : counts.pairs_with_neighbors) += n_pairs;
+  std::uint64_t n_selected = 0;
+
+  std::vector<ActionPtr> actions;
+  for (std::size_t i = 0; i < search_list.size(); i++) {
+    const ParticleData& p1 = search_list[i];
+    /* Pairs of spectators of the same nucleus, which are not allowed to
+     * collide, are not even looked at. */
+    const std::vector<std::size_t>& selected = prefilter.select(
+        search_snapshot, i, partners_kinematics, dt, max_distance_sqr,
+        same_list, !finder_parameters_.allow_collisions_within_nucleus);
+    for (std::size_t j : selected) {
+      const ParticleData& p2 = partners[j];
+      assert(p1.id() != p2.id());
+      if (energy_dependent_only) {
+        const double max_xs = cross_section_envelope_.max_cross_section(
+            p1, p2, (p1.momentum() + p2.momentum()).abs());
+        const double max_scaling =
+            std::max(1., p1.initial_xsec_scaling_factor()) *
+            std::max(1., p2.initial_xsec_scaling_factor());
+        if (prefilter.min_transverse_distance_sqr(partners_kinematics, j) >=
+            max_xs * max_scaling * xs_to_distance_sqr) {
+          continue;
+        }
+      }
+      n_selected++;
+      ActionPtr act = check_collision_two_part<CollisionCriterion::Geometric>(
+          p1, p2, dt, counts, beam_momentum);
+      if (act) {
+        actions.push_back(std::move(act));
+      }
+    }
+  }
+  counts.prefiltered += n_pairs - n_selected;
   return actions;
 }
 
@@ -536,26 +1076,93 @@ ActionList ScatterActionsFinder::find_actions_with_surrounding_particles(
     // Only search in cells
     return actions;
   }
-  for (const ParticleData& p2 : surrounding_list) {
-    /* don't look for collisions if the particle from the surrounding list is
-     * also in the search list */
-    auto result = std::find_if(
-        search_list.begin(), search_list.end(),
-        [&p2](const ParticleData& p) { return p.id() == p2.id(); });
-    if (result != search_list.end()) {
-      continue;
-    }
-    for (const ParticleData& p1 : search_list) {
-      // Check if a collision is possible.
-      ActionPtr act = check_collision_two_part(p1, p2, dt, beam_momentum);
-      if (act) {
-        actions.push_back(std::move(act));
+  CollisionFinderStatistics counts;
+  with_criterion([&](auto criterion) {
+    for (const ParticleData& p2 : surrounding_list) {
+      /* don't look for collisions if the particle from the surrounding list
+       * is also in the search list */
+      auto result = std::find_if(
+          search_list.begin(), search_list.end(),
+          [&p2](const ParticleData& p) { return p.id() == p2.id(); });
+      if (result != search_list.end()) {
+        continue;
+      }
+      for (const ParticleData& p1 : search_list) {
+        counts.pairs_with_neighbors++;
+        // Check if a collision is possible.
+        ActionPtr act = check_collision_two_part<decltype(criterion)::value>(
+            p1, p2, dt, counts, beam_momentum);
+        if (act) {
+          actions.push_back(std::move(act));
+        }
       }
     }
-  }
+  });
+  add_statistics(counts);
   return actions;
 }
 
+void ScatterActionsFinder::add_statistics(
+    const CollisionFinderStatistics& counts) const {
+  if (counts.pairs_in_cells == 0 && counts.pairs_with_neighbors == 0) {
+    return;
+  }
+  std::lock_guard<std::mutex> lock(statistics_mutex_);
+  statistics_.add(counts);
+}
+
+CollisionFinderStatistics ScatterActionsFinder::take_statistics() {
+  std::lock_guard<std::mutex> lock(statistics_mutex_);
+  return std::exchange(statistics_, CollisionFinderStatistics());
+}
+
+ActionPtr ScatterActionsFinder::check_collision(
+    const CollisionTraceRecord& record,
+    CollisionFinderStatistics& counts) const {
+  if (record.criterion != finder_parameters_.coll_crit) {
+    throw std::invalid_argument(
+        "The pair was captured with another collision criterion.");
+  }
+  return with_criterion([&](auto criterion) {
+    return check_collision_two_part<decltype(criterion)::value>(
+        record.incoming[0], record.incoming[1], record.time, counts, {},
+        record.gcell_vol, record.majorant);
+  });
+}
+
+ActionPtr ScatterActionsFinder::create_collision(
+    const CollisionTraceRecord& record) const {
+  const ParticleData& data_a = record.incoming[0];
+  const ParticleData& data_b = record.incoming[1];
+  const bool parametrized = incoming_parametrized(data_a, data_b);
+  ScatterActionPtr act = std::make_unique<ScatterAction>(
+      data_a, data_b, record.time, isotropic_, string_formation_time_,
+      box_length_, parametrized);
+  if (record.criterion == CollisionCriterion::Stochastic) {
+    act->set_stochastic_pos_idx();
+  }
+  if (finder_parameters_.strings_switch) {
+    act->set_string_interface(string_process_interface_.get());
+  }
+  if (parametrized) {
+    act->set_parametrized_total_cross_section(finder_parameters_);
+  }
+  if (!add_tabulated_scatterings(*act)) {
+    act->add_all_scatterings(finder_parameters_);
+  }
+  return act;
+}
+
+namespace {
+/// \return A pool with as many threads as the hardware supports, for the dumps
+std::unique_ptr<ThreadPool> dump_thread_pool() {
+  // All lazily evaluated quantities must be ready before threads start
+  ParticleType::initialize_lazy_members();
+  return std::make_unique<ThreadPool>(
+      std::max(1, static_cast<int>(std::thread::hardware_concurrency())));
+}
+}  // namespace
+
 void ScatterActionsFinder::dump_reactions() const {
   constexpr double time = 0.0;
 
@@ -564,70 +1171,91 @@ void ScatterActionsFinder::dump_reactions() const {
 
   std::cout << N_isotypes << " iso-particle types." << std::endl;
   std::cout << "They can make " << N_pairs << " pairs." << std::endl;
-  std::vector<double> momentum_scan_list = {0.1, 0.3, 0.5, 1.0,
-                                            2.0, 3.0, 5.0, 10.0};
+  const std::vector<double> momentum_scan_list = {0.1, 0.3, 0.5, 1.0,
+                                                  2.0, 3.0, 5.0, 10.0};
+  std::vector<std::pair<const IsoParticleType*, const IsoParticleType*>>
+      isotype_pairs;
   for (const IsoParticleType& A_isotype : IsoParticleType::list_all()) {
     for (const IsoParticleType& B_isotype : IsoParticleType::list_all()) {
-      if (&A_isotype > &B_isotype) {
-        continue;
+      if (&A_isotype <= &B_isotype) {
+        isotype_pairs.emplace_back(&A_isotype, &B_isotype);
       }
-      bool any_nonzero_cs = false;
-      std::vector<std::string> r_list;
-      for (const ParticleTypePtr A_type : A_isotype.get_states()) {
-        for (const ParticleTypePtr B_type : B_isotype.get_states()) {
-          if (A_type > B_type) {
+    }
+  }
+
+  /* The pairs are scanned in parallel, but printed in their original order as
+   * soon as all earlier ones are done. Pairs without any reaction print an
+   * empty string. */
+  const int n_pairs = static_cast<int>(isotype_pairs.size());
+  std::vector<std::optional<std::string>> lines(n_pairs);
+  std::mutex lines_mutex;
+  int n_printed = 0;
+  dump_thread_pool()->parallel_for(n_pairs, [&](int i) {
+    const IsoParticleType& A_isotype = *isotype_pairs[i].first;
+    const IsoParticleType& B_isotype = *isotype_pairs[i].second;
+    bool any_nonzero_cs = false;
+    std::vector<std::string> r_list;
+    for (const ParticleTypePtr A_type : A_isotype.get_states()) {
+      for (const ParticleTypePtr B_type : B_isotype.get_states()) {
+        if (A_type > B_type) {
+          continue;
+        }
+        ParticleData A(*A_type), B(*B_type);
+        for (auto mom : momentum_scan_list) {
+          A.set_4momentum(A.pole_mass(), mom, 0.0, 0.0);
+          B.set_4momentum(B.pole_mass(), -mom, 0.0, 0.0);
+          ScatterActionPtr act = std::make_unique<ScatterAction>(
+              A, B, time, isotropic_, string_formation_time_, -1, false);
+          if (finder_parameters_.strings_switch) {
+            act->set_string_interface(string_process_interface_.get());
+          }
+          act->add_all_scatterings(finder_parameters_);
+          const double total_cs = act->cross_section();
+          if (total_cs <= 0.0) {
             continue;
           }
-          ParticleData A(*A_type), B(*B_type);
-          for (auto mom : momentum_scan_list) {
-            A.set_4momentum(A.pole_mass(), mom, 0.0, 0.0);
-            B.set_4momentum(B.pole_mass(), -mom, 0.0, 0.0);
-            ScatterActionPtr act = std::make_unique<ScatterAction>(
-                A, B, time, isotropic_, string_formation_time_, -1, false);
-            if (finder_parameters_.strings_switch) {
-              act->set_string_interface(string_process_interface_.get());
-            }
-            act->add_all_scatterings(finder_parameters_);
-            const double total_cs = act->cross_section();
-            if (total_cs <= 0.0) {
-              continue;
-            }
-            any_nonzero_cs = true;
-            for (const auto& channel : act->collision_channels()) {
-              const auto type = channel->get_type();
-              std::string r;
-              if (is_string_soft_process(type) ||
-                  type == ProcessType::StringHard) {
-                r = A_type->name() + B_type->name() + std::string(" → strings");
-              } else {
-                std::string r_type =
-                    (type == ProcessType::Elastic) ? std::string(" (el)")
-                    : (channel->get_type() == ProcessType::TwoToTwo)
-                        ? std::string(" (inel)")
-                        : std::string(" (?)");
-                r = A_type->name() + B_type->name() + std::string(" → ") +
-                    channel->particle_types()[0]->name() +
-                    channel->particle_types()[1]->name() + r_type;
-              }
-              isoclean(r);
-              r_list.push_back(r);
+          any_nonzero_cs = true;
+          for (const auto& channel : act->collision_channels()) {
+            const auto type = channel->get_type();
+            std::string r;
+            if (is_string_soft_process(type) ||
+                type == ProcessType::StringHard) {
+              r = A_type->name() + B_type->name() + std::string(" → strings");
+            } else {
+              std::string r_type =
+                  (type == ProcessType::Elastic) ? std::string(" (el)")
+                  : (channel->get_type() == ProcessType::TwoToTwo)
+                      ? std::string(" (inel)")
+                      : std::string(" (?)");
+              r = A_type->name() + B_type->name() + std::string(" → ") +
+                  channel->particle_types()[0]->name() +
+                  channel->particle_types()[1]->name() + r_type;
             }
+            isoclean(r);
+            r_list.push_back(r);
           }
         }
       }
-      std::sort(r_list.begin(), r_list.end());
-      r_list.erase(std::unique(r_list.begin(), r_list.end()), r_list.end());
-      if (any_nonzero_cs) {
-        for (auto r : r_list) {
-          std::cout << r;
-          if (r_list.back() != r) {
-            std::cout << ", ";
-          }
+    }
+    std::sort(r_list.begin(), r_list.end());
+    r_list.erase(std::unique(r_list.begin(), r_list.end()), r_list.end());
+    std::string line;
+    if (any_nonzero_cs) {
+      for (const auto& r : r_list) {
+        line += r;
+        if (r_list.back() != r) {
+          line += ", ";
         }
-        std::cout << std::endl;
       }
+      line += '\n';
     }
-  }
+    std::lock_guard<std::mutex> lock(lines_mutex);
+    lines[i] = std::move(line);
+    for (; n_printed < n_pairs && lines[n_printed]; n_printed++) {
+      std::cout << *lines[n_printed] << std::flush;
+      lines[n_printed]->clear();
+    }
+  });
 }
 
 /// Represent a final-state cross section.
@@ -946,26 +1574,31 @@ void ScatterActionsFinder::dump_cross_sections(
   std::map<std::string, xs_saver> xs_dump;
   std::map<std::string, double> outgoing_total_mass;
 
-  ParticleData a_data(a), b_data(b);
   int n_momentum_points = 200;
   constexpr double momentum_step = 0.02;
   if (plab.size() > 0) {
-    n_momentum_points = plab.size();
     // Remove duplicates.
     std::sort(plab.begin(), plab.end());
     plab.erase(std::unique(plab.begin(), plab.end()), plab.end());
+    n_momentum_points = plab.size();
   }
-  for (int i = 0; i < n_momentum_points; i++) {
+  /* Every point is computed once, in parallel, and merged in order, such that
+   * the channels appear as in a serial scan. */
+  std::vector<double> sqrts_points(n_momentum_points);
+  std::vector<std::vector<FinalStateCrossSection>> point_xs(n_momentum_points);
+  dump_thread_pool()->parallel_for(n_momentum_points, [&](int i) {
     double momentum;
     if (plab.size() > 0) {
       momentum = pCM_from_s(s_from_plab(plab.at(i), m_a, m_b), m_a, m_b);
     } else {
       momentum = momentum_step * (i + 1);
     }
+    ParticleData a_data(a), b_data(b);
     a_data.set_4momentum(m_a, momentum, 0.0, 0.0);
     b_data.set_4momentum(m_b, -momentum, 0.0, 0.0);
     const double sqrts = (a_data.momentum() + b_data.momentum()).abs();
-    const ParticleList incoming = {a_data, b_data};
+    sqrts_points[i] = sqrts;
+    std::vector<FinalStateCrossSection>& channels = point_xs[i];
     ScatterActionPtr act = std::make_unique<ScatterAction>(
         a_data, b_data, 0., isotropic_, string_formation_time_, -1, false);
     if (finder_parameters_.strings_switch) {
@@ -980,26 +1613,16 @@ void ScatterActionsFinder::dump_cross_sections(
       if (xs <= 0.0) {
         continue;
       }
+      std::stringstream process_description_stream;
+      process_description_stream << *process;
+      const std::string& description = process_description_stream.str();
       if (!final_state) {
-        std::stringstream process_description_stream;
-        process_description_stream << *process;
-        const std::string& description = process_description_stream.str();
         double m_tot = 0.0;
         for (const auto& ptype : process->particle_types()) {
           m_tot += ptype->mass();
         }
-        outgoing_total_mass[description] = m_tot;
-        if (!xs_dump[description].empty() &&
-            std::abs(xs_dump[description].back().first - sqrts) <
-                really_small) {
-          xs_dump[description].back().second += xs;
-        } else {
-          xs_dump[description].push_back(std::make_pair(sqrts, xs));
-        }
+        channels.emplace_back(description, xs, m_tot);
       } else {
-        std::stringstream process_description_stream;
-        process_description_stream << *process;
-        const std::string& description = process_description_stream.str();
         ParticleTypePtrList initial_particles = {&a, &b};
         ParticleTypePtrList final_particles = process->particle_types();
         auto& process_node =
@@ -1008,14 +1631,13 @@ void ScatterActionsFinder::dump_cross_sections(
         decaytree::add_decays(process_node, sqrts);
       }
     }
-    xs_dump["total"].push_back(std::make_pair(sqrts, act->cross_section()));
     // Total cross-section should be the first in the list -> negative mass
-    outgoing_total_mass["total"] = -1.0;
+    channels.emplace_back("total", act->cross_section(), -1.0);
     if (final_state) {
       // tree.print();
       auto final_state_xs = tree.final_state_cross_sections();
       deduplicate(final_state_xs);
-      for (const auto& p : final_state_xs) {
+      for (auto& p : final_state_xs) {
         // Don't print empty columns.
         //
         // FIXME(steinberg): The better fix would be to not have them in the
@@ -1023,8 +1645,20 @@ void ScatterActionsFinder::dump_cross_sections(
         if (p.name_ == "") {
           continue;
         }
-        outgoing_total_mass[p.name_] = p.mass_;
-        xs_dump[p.name_].push_back(std::make_pair(sqrts, p.cross_section_));
+        channels.push_back(std::move(p));
+      }
+    }
+  });
+  for (int i = 0; i < n_momentum_points; i++) {
+    const double sqrts = sqrts_points[i];
+    for (const FinalStateCrossSection& channel : point_xs[i]) {
+      outgoing_total_mass[channel.name_] = channel.mass_;
+      xs_saver& xs = xs_dump[channel.name_];
+      // Channels with the same name at the same energy are summed
+      if (!xs.empty() && std::abs(xs.back().first - sqrts) < really_small) {
+        xs.back().second += channel.cross_section_;
+      } else {
+        xs.push_back(std::make_pair(sqrts, channel.cross_section_));
       }
     }
   }
@@ -1069,15 +1703,7 @@ void ScatterActionsFinder::dump_cross_sections(
 
   // Print out all partial cross-sections in mb
   for (int i = 0; i < n_momentum_points; i++) {
-    double momentum;
-    if (plab.size() > 0) {
-      momentum = pCM_from_s(s_from_plab(plab.at(i), m_a, m_b), m_a, m_b);
-    } else {
-      momentum = momentum_step * (i + 1);
-    }
-    a_data.set_4momentum(m_a, momentum, 0.0, 0.0);
-    b_data.set_4momentum(m_b, -momentum, 0.0, 0.0);
-    const double sqrts = (a_data.momentum() + b_data.momentum()).abs();
+    const double sqrts = sqrts_points[i];
     std::printf("%9.6f", sqrts);
     for (const auto& channel : all_channels) {
       const xs_saver energy_and_xs = xs_dump[channel];
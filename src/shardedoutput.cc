@@ -0,0 +1,129 @@
+/*
+ *
+ *    Copyright (c) 2024
+ *      SMASH Team
+ *
+ *    GNU General Public License (GPLv3 or later)
+ *
+ */
+
+#include "smash/shardedoutput.h"
+
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <utility>
+
+#include "smash/logging.h"
+
+namespace smash {
+
+ShardedOutput::ShardedOutput(const std::filesystem::path &path,
+                             OutputsList shards,
+                             std::vector<std::filesystem::path> directories)
+    : OutputInterface("Particles"),
+      path_(path),
+      directories_(std::move(directories)) {
+  if (shards.empty() || shards.size() != directories_.size()) {
+    throw std::invalid_argument(
+        "A sharded output needs a directory for each of at least one shard.");
+  }
+  for (OutputPtr &output : shards) {
+    shards_.push_back(std::make_unique<AsyncOutput>(std::move(output)));
+    // The shards are only waited for at the end of an event
+    shards_.back()->overlap_events();
+  }
+}
+
+ShardedOutput::~ShardedOutput() {
+  // The files of the shards are complete once their outputs are gone
+  shards_.clear();
+  try {
+    write_manifests();
+  } catch (const std::exception &e) {
+    logg[LOutput].error("Writing the manifests of the shards failed: ",
+                        e.what());
+  }
+}
+
+void ShardedOutput::at_eventstart(const Particles &particles,
+                                  const int event_number,
+                                  const EventInfo &info) {
+  if (!starting_) {
+    event_shards_.clear();
+    starting_ = true;
+  }
+  event_shards_.push_back(event_number % shards_.size());
+  shard(event_number).at_eventstart(particles, event_number, info);
+}
+
+void ShardedOutput::at_eventstart(const std::vector<Particles> &, int) {
+  starting_ = false;
+  next_ensemble_ = 0;
+}
+
+void ShardedOutput::at_eventend(const Particles &particles,
+                                const int event_number,
+                                const EventInfo &info) {
+  shard(event_number).at_eventend(particles, event_number, info);
+}
+
+void ShardedOutput::at_eventend(const std::vector<Particles> &, const int) {
+  for (const auto &output : shards_) {
+    output->flush();
+  }
+}
+
+void ShardedOutput::at_intermediate_time(const Particles &particles,
+                                         const std::unique_ptr<Clock> &clock,
+                                         const DensityParameters &dens_param,
+                                         const EventInfo &info) {
+  if (event_shards_.empty()) {
+    return;
+  }
+  const std::size_t i = event_shards_[next_ensemble_++ % event_shards_.size()];
+  shards_[i]->at_intermediate_time(particles, clock, dens_param, info);
+}
+
+void ShardedOutput::at_intermediate_time(const std::vector<Particles> &,
+                                         const std::unique_ptr<Clock> &,
+                                         const DensityParameters &) {
+  next_ensemble_ = 0;
+}
+
+void ShardedOutput::at_runend() {
+  for (const auto &output : shards_) {
+    output->at_runend();
+  }
+  for (const auto &output : shards_) {
+    output->flush();
+  }
+}
+
+AsyncOutput &ShardedOutput::shard(int event_number) {
+  return *shards_[event_number % shards_.size()];
+}
+
+void ShardedOutput::write_manifests() const {
+  for (const auto &entry :
+       std::filesystem::directory_iterator(directories_.front())) {
+    if (!entry.is_regular_file()) {
+      continue;
+    }
+    const std::filesystem::path name = entry.path().filename();
+    const std::filesystem::path manifest =
+        path_ / (name.string() + ".shards");
+    std::ofstream out(manifest);
+    out << "# SMASH output shards of " << name.string() << "\n"
+        << "# The ensembles, numbered as events, are written to the shard\n"
+        << "# event number % " << directories_.size() << ".\n";
+    for (const std::filesystem::path &directory : directories_) {
+      out << (directory / name).lexically_relative(path_).string() << '\n';
+    }
+    if (!out) {
+      throw std::runtime_error("Cannot write " + manifest.string());
+    }
+  }
+}
+
+}  // namespace smash
@@ -1,6 +1,6 @@
 /*
  *
- *    Copyright (c) 2012-2023
+ *    Copyright (c) 2012-2024
  *      SMASH Team
  *
  *    GNU General Public License (GPLv3 or later)
@@ -21,6 +21,10 @@
 #include "smash/setup_particles_decaymodes.h"
 #include "smash/sha256.h"
 #include "smash/stringfunctions.h"
+#ifdef SMASH_USE_MPI
+#include "smash/mpiensemblecommunicator.h"
+#include "smash/mpieventdispatcher.h"
+#endif
 /* build dependent variables */
 #include "smash/config.h"
 #include "smash/library.h"
@@ -122,6 +126,40 @@ namespace smash {
  * <td>Quiets the disclaimer for scenarios where no printout is wanted. To
  *     get no printout, you also need to disable logging from the config.
  * </table>
+ *
+ * \section smash_invocation_mpi_ Distributing the events over MPI processes
+ *
+ * If SMASH is configured with `-DTRY_USE_MPI=ON` and an MPI library is found,
+ * an additional executable `smash_mpi` is built, which takes the same
+ * options. All its processes, e.g. started by
+ * \verbatim
+ mpirun -n 256 ./smash_mpi -i config.yaml -o data/run
+ \endverbatim
+ * share the configuration and generate the events of one run together. An
+ * unset `Randomseed` is drawn once by the first process. Whenever a process
+ * has finished an event, it takes the next one, so the expensive events do
+ * not hold back the others. Every event has the random seed it would have in
+ * a sequential run, the result of a run therefore does not depend on the
+ * number of processes.
+ *
+ * Each process writes the output of its events into a directory `rank_<n>`
+ * within the output directory, where `<n>` is the rank of the process. The
+ * event numbers in these outputs count over all processes. When all events
+ * are done, the first process writes the file `event_index.txt`, which lists
+ * the directory of every event in order of the events.
+ *
+ * With a minimum number of non-empty ensembles, the processes stop taking
+ * events once enough non-empty ensembles are reported, and the events still
+ * in progress are completed. The run can then contain a few more events than
+ * a sequential one. Event workers, the list modi and resuming a checkpoint
+ * are not supported in this mode.
+ *
+ * With <tt>\ref key_gen_distribute_ensembles_ "Distribute_Ensembles"</tt>,
+ * all processes generate every event together instead, each one evolving
+ * its share of the parallel ensembles. The first processes take one ensemble
+ * more, if the ensembles cannot be shared evenly. Each process still writes
+ * the output of its ensembles into its own directory, where the ensembles
+ * are numbered over all processes.
  */
 
 namespace {
@@ -311,6 +349,23 @@ void ensure_path_is_valid(const std::filesystem::path &path) {
   }
 }
 
+#ifdef SMASH_USE_MPI
+/**
+ * Shares a path of the first MPI process with all other processes.
+ *
+ * \param[inout] path The path, which is replaced by the one of the first
+ *                process
+ */
+void broadcast_path(std::filesystem::path &path) {
+  std::string native = path.native();
+  int length = native.size();
+  MPI_Bcast(&length, 1, MPI_INT, 0, MPI_COMM_WORLD);
+  native.resize(length);
+  MPI_Bcast(native.data(), length, MPI_CHAR, 0, MPI_COMM_WORLD);
+  path = native;
+}
+#endif
+
 /**
  * Prepares ActionsFinder for cross-section and reaction dumps.
  *
@@ -391,7 +446,13 @@ int main(int argc, char *argv[]) {
   const std::string progname =
       std::filesystem::path(argv[0]).filename().native();
 
+#ifdef SMASH_USE_MPI
+  MPI_Init(&argc, &argv);
+#endif
   try {
+#ifdef SMASH_USE_MPI
+    MpiEventDispatcher dispatcher(MPI_COMM_WORLD);
+#endif
     bool force_overwrite = false;
     std::filesystem::path output_path = default_output_path();
     std::string input_path("./config.yaml"), particles, decaymodes;
@@ -492,6 +553,9 @@ int main(int argc, char *argv[]) {
       usage(EXIT_FAILURE, progname);
     }
 
+#ifdef SMASH_USE_MPI
+    suppress_disclaimer = suppress_disclaimer || dispatcher.rank() != 0;
+#endif
     if (!suppress_disclaimer) {
       print_disclaimer();
     }
@@ -502,7 +566,17 @@ int main(int argc, char *argv[]) {
     setup_default_float_traps();
 
     // Check output path
+#ifdef SMASH_USE_MPI
+    /* All processes use the output directory of the first one, which creates
+     * it before the others continue. */
+    broadcast_path(output_path);
+    if (dispatcher.rank() == 0) {
+      ensure_path_is_valid(output_path);
+    }
+    MPI_Barrier(MPI_COMM_WORLD);
+#else
     ensure_path_is_valid(output_path);
+#endif
     std::string tabulations_path;
     if (cache_integrals) {
       tabulations_path = output_path.has_parent_path()
@@ -513,6 +587,12 @@ int main(int argc, char *argv[]) {
       tabulations_path = "";
     }
     const std::string version(SMASH_VERSION);
+#ifdef SMASH_USE_MPI
+    // Every process writes its events into a directory of its own
+    const std::filesystem::path run_path = output_path;
+    output_path /= MpiEventDispatcher::directory(dispatcher.rank());
+    std::filesystem::create_directories(output_path);
+#endif
 
     if (list2n_activated) {
       /* Print only 2->n, n > 1. Do not dump decays, which can be found in
@@ -638,8 +718,12 @@ int main(int argc, char *argv[]) {
 
     int64_t seed = configuration.read({"General", "Randomseed"});
     if (seed < 0) {
-      configuration.set_value({"General", "Randomseed"},
-                              random::generate_63bit_seed());
+      seed = random::generate_63bit_seed();
+#ifdef SMASH_USE_MPI
+      // All processes use the seed of the first one
+      MPI_Bcast(&seed, 1, MPI_INT64_T, 0, MPI_COMM_WORLD);
+#endif
+      configuration.set_value({"General", "Randomseed"}, seed);
     }
 
     // Avoid overwriting SMASH output
@@ -673,12 +757,41 @@ int main(int argc, char *argv[]) {
         << "# Date     : " << BUILD_DATE << '\n'
         << configuration.to_string() << '\n';
 
+#ifdef SMASH_USE_MPI
+    // The first process writes the tabulations, which the others then read
+    if (dispatcher.rank() != 0) {
+      MPI_Barrier(MPI_COMM_WORLD);
+    }
+#endif
     initialize_particles_decays_and_tabulations(configuration, version,
                                                 tabulations_path);
+#ifdef SMASH_USE_MPI
+    if (dispatcher.rank() == 0) {
+      MPI_Barrier(MPI_COMM_WORLD);
+    }
+#endif
+
+    const bool distribute_ensembles =
+        configuration.take({"General", "Distribute_Ensembles"}, false);
+#ifdef SMASH_USE_MPI
+    MpiEnsembleCommunicator communicator(MPI_COMM_WORLD);
+#else
+    if (distribute_ensembles) {
+      throw std::invalid_argument(
+          "The ensembles can only be distributed over the processes of "
+          "smash_mpi.");
+    }
+#endif
 
     // Create an experiment
     logg[LMain].trace(SMASH_SOURCE_LOCATION, " create Experiment");
+#ifdef SMASH_USE_MPI
+    auto experiment = ExperimentBase::create(
+        configuration, output_path,
+        distribute_ensembles ? &communicator : nullptr);
+#else
     auto experiment = ExperimentBase::create(configuration, output_path);
+#endif
 
     // Version key is deprecated. If present, ignore it.
     if (configuration.has_value({"Version"})) {
@@ -688,12 +801,29 @@ int main(int argc, char *argv[]) {
 
     // Run the experiment
     logg[LMain].trace(SMASH_SOURCE_LOCATION, " run the Experiment");
+#ifdef SMASH_USE_MPI
+    if (distribute_ensembles) {
+      // All processes take part in every event
+      experiment->run();
+    } else {
+      const std::vector<int> events = experiment->run(dispatcher);
+      dispatcher.write_event_index(run_path / "event_index.txt", events);
+    }
+#else
     experiment->run();
+#endif
   } catch (std::exception &e) {
     logg[LMain].fatal() << "SMASH failed with the following error:\n"
                         << e.what();
+#ifdef SMASH_USE_MPI
+    // The other processes may wait for this one
+    MPI_Abort(MPI_COMM_WORLD, EXIT_FAILURE);
+#endif
     return EXIT_FAILURE;
   }
+#ifdef SMASH_USE_MPI
+  MPI_Finalize();
+#endif
 
   logg[LMain].trace() << SMASH_SOURCE_LOCATION << " about to return from main";
   return 0;
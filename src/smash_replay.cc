@@ -0,0 +1,217 @@
+/*
+ *
+ *    Copyright (c) 2024
+ *      SMASH Team
+ *
+ *    GNU General Public License (GPLv3 or later)
+ *
+ */
+
+#include <getopt.h>
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+#include "smash/collisiontrace.h"
+#include "smash/experiment.h"
+#include "smash/fpenvironment.h"
+#include "smash/random.h"
+#include "smash/scatteractionsfinder.h"
+
+#include "smash/config.h"
+#include "smash/library.h"
+
+namespace smash {
+
+namespace {
+/**
+ * Prints usage information and exits the program
+ *
+ * \param[out] rc Exit status to return
+ * \param[in] progname Name of the program
+ */
+void usage(const int rc, const std::string &progname) {
+  std::printf("\nUsage: %s -t <trace> [option]\n\n", progname.c_str());
+  std::printf(
+      "Replays the pairs and collisions captured with\n"
+      "'General: { Capture_Collisions: True }' and measures the time of the\n"
+      "collision checks and of the final state generation.\n"
+      "\n"
+      "  -h, --help              usage information\n"
+      "\n"
+      "  -t, --trace <file>      captured collision trace\n"
+      "  -i, --inputfile <file>  configuration of the captured run\n"
+      "                          (default: ./config.yaml)\n"
+      "  -d, --decaymodes <file> override default decay modes from file\n"
+      "  -p, --particles <file>  override default particles from file\n"
+      "  -c, --config <YAML>     specify config value overrides\n"
+      "                          (multiple -c arguments are supported)\n"
+      "  -r, --repetitions <n>   replay the trace n times (default: 3)\n"
+      "  -s, --seed <seed>       seed of the random numbers (default: 1)\n"
+      "  -n, --no-cache          Don't cache integrals on disk\n\n");
+  std::exit(rc);
+}
+
+/**
+ * \param[in] start Point in time
+ * \return Seconds since \p start
+ */
+double seconds_since(std::chrono::steady_clock::time_point start) {
+  return std::chrono::duration<double>(std::chrono::steady_clock::now() -
+                                       start)
+      .count();
+}
+}  // unnamed namespace
+
+}  // namespace smash
+
+/**
+ * Replays a collision trace.
+ *
+ * Every repetition starts from the same seed, hence it checks the same pairs
+ * with the same random numbers and finds the same collisions. The first
+ * repetition also sets up the lazily computed tables, so the later ones are
+ * the better measure.
+ *
+ * \param[in] argc Number of arguments on command-line
+ * \param[in] argv List of arguments on command-line
+ * \return Either 0 or EXIT_FAILURE.
+ */
+int main(int argc, char *argv[]) {
+  using namespace smash;  // NOLINT(build/namespaces)
+
+  constexpr option longopts[] = {{"config", required_argument, 0, 'c'},
+                                 {"decaymodes", required_argument, 0, 'd'},
+                                 {"help", no_argument, 0, 'h'},
+                                 {"inputfile", required_argument, 0, 'i'},
+                                 {"no-cache", no_argument, 0, 'n'},
+                                 {"particles", required_argument, 0, 'p'},
+                                 {"repetitions", required_argument, 0, 'r'},
+                                 {"seed", required_argument, 0, 's'},
+                                 {"trace", required_argument, 0, 't'},
+                                 {nullptr, 0, 0, 0}};
+
+  // strip any path to progname
+  const std::string progname =
+      std::filesystem::path(argv[0]).filename().native();
+
+  try {
+    std::string input_path("./config.yaml"), particles, decaymodes;
+    std::filesystem::path trace_path;
+    std::vector<std::string> extra_config;
+    int repetitions = 3;
+    std::int64_t seed = 1;
+    bool cache_integrals = true;
+
+    // parse command-line arguments
+    int opt;
+    while ((opt = getopt_long(argc, argv, "c:d:hi:np:r:s:t:", longopts,
+                              nullptr)) != -1) {
+      switch (opt) {
+        case 'c':
+          extra_config.emplace_back(optarg);
+          break;
+        case 'd':
+          decaymodes = optarg;
+          break;
+        case 'h':
+          usage(EXIT_SUCCESS, progname);
+          break;
+        case 'i':
+          input_path = optarg;
+          break;
+        case 'n':
+          cache_integrals = false;
+          break;
+        case 'p':
+          particles = optarg;
+          break;
+        case 'r':
+          repetitions = std::stoi(optarg);
+          break;
+        case 's':
+          seed = std::stoll(optarg);
+          break;
+        case 't':
+          trace_path = optarg;
+          break;
+        default:
+          usage(EXIT_FAILURE, progname);
+      }
+    }
+    if (optind < argc || trace_path.empty() || repetitions < 1) {
+      usage(EXIT_FAILURE, progname);
+    }
+
+    auto configuration = setup_config_and_logging(input_path, particles,
+                                                  decaymodes, extra_config);
+    setup_default_float_traps();
+    // The same cache as for a run with the default output directory
+    const std::string tabulations_path =
+        cache_integrals ? "./data/tabulations" : "";
+    initialize_particles_decays_and_tabulations(configuration, SMASH_VERSION,
+                                                tabulations_path);
+
+    const CollisionTraceContent trace = read_collision_trace(trace_path);
+    // Like in the captured run, this key is taken before the finder is set up
+    ParticleData::formation_power_ = trace.formation_power;
+    configuration.take(
+        {"Collision_Term", "String_Parameters", "Power_Particle_Formation"},
+        1.);
+    ExperimentParameters parameters =
+        create_experiment_parameters(configuration);
+    parameters.use_monash_tune_default = trace.use_monash_tune_default;
+    ScatterActionsFinder finder(configuration, parameters);
+    // The keys of the rest of the run are not needed
+    configuration.clear();
+    ParticleType::initialize_lazy_members();
+
+    std::vector<const CollisionTraceRecord *> pairs, collisions;
+    for (const CollisionTraceRecord &record : trace.records) {
+      (record.kind == CollisionTraceRecord::Kind::Pair ? pairs : collisions)
+          .push_back(&record);
+    }
+    logg[LMain].info("Replaying ", pairs.size(), " pairs and ",
+                     collisions.size(), " collisions from ", trace_path);
+
+    for (int i = 0; i < repetitions; i++) {
+      random::set_seed(seed);
+      CollisionFinderStatistics counts;
+      std::size_t found = 0;
+      const auto pairs_start = std::chrono::steady_clock::now();
+      for (const CollisionTraceRecord *record : pairs) {
+        found += finder.check_collision(*record, counts) != nullptr;
+      }
+      const double pairs_time = seconds_since(pairs_start);
+
+      std::size_t outgoing = 0;
+      const auto collisions_start = std::chrono::steady_clock::now();
+      for (const CollisionTraceRecord *record : collisions) {
+        ActionPtr action = finder.create_collision(*record);
+        try {
+          action->generate_final_state();
+          outgoing += action->outgoing_particles().size();
+        } catch (Action::StochasticBelowEnergyThreshold &) {
+        }
+      }
+      const double collisions_time = seconds_since(collisions_start);
+
+      logg[LMain].info(
+          "Repetition ", i, ": checked the pairs in ", pairs_time, " s (",
+          pairs.empty() ? 0. : 1e9 * pairs_time / pairs.size(),
+          " ns per pair), found ", found, " collisions; generated the final ",
+          "states in ", collisions_time, " s (",
+          collisions.empty() ? 0. : 1e6 * collisions_time / collisions.size(),
+          " us per collision) with ", outgoing, " outgoing particles");
+    }
+  } catch (std::exception &e) {
+    logg[LMain].fatal() << "smash_replay failed with the following error:\n"
+                        << e.what();
+    return EXIT_FAILURE;
+  }
+  return 0;
+}
@@ -0,0 +1,162 @@
+/*
+ *
+ *    Copyright (c) 2024
+ *      SMASH Team
+ *
+ *    GNU General Public License (GPLv3 or later)
+ *
+ */
+
+#include "smash/smearingconvolution.h"
+
+#include <cmath>
+#include <cstdlib>
+
+namespace smash {
+
+SmearingConvolution::SmearingConvolution(
+    const std::array<int, 3> &n_cells, const std::array<double, 3> &cell_sizes,
+    const std::array<double, 3> &origin, bool periodic,
+    const std::array<int, 3> &range,
+    const std::function<double(int, int, int)> &kernel)
+    // the differences of the kernel reach one cell further
+    : fft_(n_cells, {range[0] + 1, range[1] + 1, range[2] + 1}, periodic),
+      cell_sizes_(cell_sizes),
+      origin_(origin),
+      periodic_(periodic) {
+  auto weight = [&](int mx, int my, int mz) {
+    return std::abs(mx) > range[0] || std::abs(my) > range[1] ||
+                   std::abs(mz) > range[2]
+               ? 0.
+               : kernel(mx, my, mz);
+  };
+  kernel_.assign(fft_.grid_size(), 0.);
+  for (LatticeFFT::Grid &g : gradient_kernels_) {
+    g.assign(fft_.grid_size(), 0.);
+  }
+  for (int mz = -range[2] - 1; mz <= range[2] + 1; mz++) {
+    for (int my = -range[1] - 1; my <= range[1] + 1; my++) {
+      for (int mx = -range[0] - 1; mx <= range[0] + 1; mx++) {
+        const std::optional<std::size_t> index = fft_.offset_index(mx, my, mz);
+        if (!index) {
+          continue;
+        }
+        // a periodic lattice smaller than the kernel gets all its images
+        kernel_[*index] += weight(mx, my, mz);
+        gradient_kernels_[0][*index] +=
+            (weight(mx + 1, my, mz) - weight(mx - 1, my, mz)) /
+            (2. * cell_sizes[0]);
+        gradient_kernels_[1][*index] +=
+            (weight(mx, my + 1, mz) - weight(mx, my - 1, mz)) /
+            (2. * cell_sizes[1]);
+        gradient_kernels_[2][*index] +=
+            (weight(mx, my, mz + 1) - weight(mx, my, mz - 1)) /
+            (2. * cell_sizes[2]);
+      }
+    }
+  }
+  fft_.forward(kernel_, false);
+  for (LatticeFFT::Grid &g : gradient_kernels_) {
+    fft_.forward(g, false);
+  }
+  clear();
+}
+
+void SmearingConvolution::clear() {
+  for (LatticeFFT::Grid &s : sources_) {
+    s.assign(fft_.grid_size(), 0.);
+  }
+  has_negative_ = false;
+}
+
+void SmearingConvolution::deposit(const ThreeVector &pos,
+                                  const FourVector &jmu) {
+  const std::array<int, 3> &n_cells = fft_.n_cells();
+  // lower node around the particle and the weight of the upper one
+  std::array<int, 3> lower;
+  std::array<double, 3> upper_weight;
+  for (int i = 0; i < 3; i++) {
+    double s = (pos[i] - origin_[i]) / cell_sizes_[i] - 0.5;
+    if (periodic_) {
+      s -= n_cells[i] * std::floor(s / n_cells[i]);
+    } else if (!(s > -1. && s < n_cells[i])) {
+      return;
+    }
+    const double floor_s = std::floor(s);
+    lower[i] = static_cast<int>(floor_s);
+    upper_weight[i] = s - floor_s;
+  }
+  const bool negative = jmu.x0() < 0.;
+  has_negative_ = has_negative_ || negative;
+  LatticeFFT::Grid &g01 = sources_[negative ? 2 : 0];
+  LatticeFFT::Grid &g23 = sources_[negative ? 3 : 1];
+  for (int dz = 0; dz < 2; dz++) {
+    int iz = lower[2] + dz;
+    if (periodic_ && iz == n_cells[2]) {
+      iz = 0;
+    } else if (iz < 0 || iz >= n_cells[2]) {
+      continue;
+    }
+    const double wz = dz ? upper_weight[2] : 1. - upper_weight[2];
+    for (int dy = 0; dy < 2; dy++) {
+      int iy = lower[1] + dy;
+      if (periodic_ && iy == n_cells[1]) {
+        iy = 0;
+      } else if (iy < 0 || iy >= n_cells[1]) {
+        continue;
+      }
+      const double wyz = wz * (dy ? upper_weight[1] : 1. - upper_weight[1]);
+      for (int dx = 0; dx < 2; dx++) {
+        int ix = lower[0] + dx;
+        if (periodic_ && ix == n_cells[0]) {
+          ix = 0;
+        } else if (ix < 0 || ix >= n_cells[0]) {
+          continue;
+        }
+        const double w = wyz * (dx ? upper_weight[0] : 1. - upper_weight[0]);
+        const std::size_t index = fft_.grid_index(ix, iy, iz);
+        g01[index] += std::complex<double>(w * jmu.x0(), w * jmu.x1());
+        g23[index] += std::complex<double>(w * jmu.x2(), w * jmu.x3());
+      }
+    }
+  }
+}
+
+void SmearingConvolution::convolve(bool compute_gradient) {
+  const int n_sources = has_negative_ ? 4 : 2;
+  for (int s = 0; s < n_sources; s++) {
+    fft_.forward(sources_[s], true);
+  }
+  const std::size_t grid_size = fft_.grid_size();
+  if (compute_gradient) {
+    for (int axis = 0; axis < 3; axis++) {
+      for (int part = 0; part < 2; part++) {
+        const LatticeFFT::Grid &pos = sources_[part];
+        const LatticeFFT::Grid &kernel = gradient_kernels_[axis];
+        LatticeFFT::Grid &g = gradients_[2 * axis + part];
+        g.resize(grid_size);
+        // the transform of the net current is the sum of both
+        if (has_negative_) {
+          const LatticeFFT::Grid &neg = sources_[part + 2];
+          for (std::size_t k = 0; k < grid_size; k++) {
+            g[k] = (pos[k] + neg[k]) * kernel[k];
+          }
+        } else {
+          for (std::size_t k = 0; k < grid_size; k++) {
+            g[k] = pos[k] * kernel[k];
+          }
+        }
+        fft_.inverse(g, true);
+      }
+    }
+  }
+  for (int s = 0; s < n_sources; s++) {
+    LatticeFFT::Grid &source = sources_[s];
+    for (std::size_t k = 0; k < grid_size; k++) {
+      source[k] *= kernel_[k];
+    }
+    fft_.inverse(source, true);
+  }
+}
+
+}  // namespace smash
@@ -0,0 +1,133 @@
+/*
+ *
+ *    Copyright (c) 2024
+ *      SMASH Team
+ *
+ *    GNU General Public License (GPLv3 or later)
+ *
+ */
+
+#include "smash/smearingstencil.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace smash {
+
+void SmearingStencil::set_bounds(const std::array<int, 3> &l_bounds,
+                                 const std::array<int, 3> &u_bounds) {
+  l_bounds_ = l_bounds;
+  for (int i = 0; i < 3; i++) {
+    n_[i] = std::max(0, u_bounds[i] - l_bounds[i]);
+  }
+}
+
+void SmearingStencil::covariant_gaussian(
+    const std::array<int, 3> &l_bounds, const std::array<int, 3> &u_bounds,
+    const std::array<double, 3> &origin,
+    const std::array<double, 3> &cell_sizes, const ThreeVector &pos,
+    const FourVector &u, double r_cut_sqr, double two_sig_sqr_inv,
+    bool compute_gradient) {
+  set_bounds(l_bounds, u_bounds);
+  const int n_x = n_[0];
+  weights_.assign(static_cast<std::size_t>(n_x) * n_[1] * n_[2], 0.);
+  if (compute_gradient) {
+    gradients_.assign(weights_.size(), ThreeVector(0., 0., 0.));
+  }
+  exponent_.resize(n_x);
+  u_r_.resize(n_x);
+  inside_.resize(n_x);
+
+  const double ux = u.x1(), uy = u.x2(), uz = u.x3();
+  const double px = pos.x1(), dx = cell_sizes[0];
+  const double x0 = origin[0] + dx * (l_bounds[0] + 0.5);
+  /* The exponent along a row is -A k^2 + linear terms in the index k, so the
+   * ratio of neighbouring Gaussians changes by exp(-2A) from one cell to the
+   * next. If this underflows, the row is evaluated directly. */
+  const double curvature = dx * dx * (1. + ux * ux) * two_sig_sqr_inv;
+  const double ratio_step = std::exp(-2. * curvature);
+
+  for (int iz = 0; iz < n_[2]; iz++) {
+    const double rz =
+        pos.x3() - (origin[2] + cell_sizes[2] * (l_bounds[2] + iz + 0.5));
+    for (int iy = 0; iy < n_[1]; iy++) {
+      const double ry =
+          pos.x2() - (origin[1] + cell_sizes[1] * (l_bounds[1] + iy + 0.5));
+      const double ryz_sqr = ry * ry + rz * rz;
+      const double u_ryz = ry * uy + rz * uz;
+
+      // Branch-free, such that the loop along the row can be vectorized
+      double *exponent = exponent_.data();
+      double *u_r_row = u_r_.data();
+      double *inside = inside_.data();
+      for (int k = 0; k < n_x; k++) {
+        const double rx = px - (x0 + dx * k);
+        const double r_sqr = rx * rx + ryz_sqr;
+        const double u_r = rx * ux + u_ryz;
+        const double r_rest_sqr = r_sqr + u_r * u_r;
+        exponent[k] = -r_rest_sqr * two_sig_sqr_inv;
+        u_r_row[k] = u_r;
+        inside[k] = r_sqr <= r_cut_sqr && r_rest_sqr <= r_cut_sqr ? 1. : 0.;
+      }
+
+      // Cells within the cut-off form one interval of the row
+      int first = 0, last = n_x - 1;
+      while (first < n_x && inside_[first] == 0.) {
+        first++;
+      }
+      while (last > first && inside_[last] == 0.) {
+        last--;
+      }
+      if (first == n_x) {
+        continue;
+      }
+      double *row = &weights_[index(l_bounds[0], l_bounds[1] + iy,
+                                    l_bounds[2] + iz)];
+      if (ratio_step > 0.) {
+        double sf = std::exp(exponent_[first]) * u.x0();
+        double ratio =
+            last > first ? std::exp(exponent_[first + 1] - exponent_[first])
+                         : 0.;
+        for (int k = first; k <= last; k++) {
+          row[k] = inside_[k] * sf;
+          sf *= ratio;
+          ratio *= ratio_step;
+        }
+      } else {
+        for (int k = first; k <= last; k++) {
+          row[k] = inside_[k] != 0. ? std::exp(exponent_[k]) * u.x0() : 0.;
+        }
+      }
+
+      if (compute_gradient) {
+        ThreeVector *grad_row = &gradients_[row - weights_.data()];
+        for (int k = first; k <= last; k++) {
+          const double rx = px - (x0 + dx * k);
+          grad_row[k] = ThreeVector(rx + ux * u_r_[k], ry + uy * u_r_[k],
+                                    rz + uz * u_r_[k]) *
+                        (row[k] * two_sig_sqr_inv * 2.0);
+        }
+      }
+    }
+  }
+}
+
+void SmearingStencil::triangular(const std::array<int, 3> &l_bounds,
+                                 const std::array<int, 3> &u_bounds,
+                                 const std::array<double, 3> &origin,
+                                 const std::array<double, 3> &cell_sizes,
+                                 const ThreeVector &pos,
+                                 const std::array<double, 3> &radius) {
+  set_bounds(l_bounds, u_bounds);
+  for (int axis = 0; axis < 3; axis++) {
+    std::vector<double> &w = axis_weights_[axis];
+    w.resize(n_[axis]);
+    for (int k = 0; k < n_[axis]; k++) {
+      const double center =
+          origin[axis] + cell_sizes[axis] * (l_bounds[axis] + k + 0.5);
+      w[k] = radius[axis] - std::abs(center - pos[axis]);
+    }
+  }
+}
+
+}  // namespace smash
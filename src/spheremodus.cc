@@ -1,6 +1,6 @@
 /*
  *
- *    Copyright (c) 2012-2023
+ *    Copyright (c) 2012-2024
  *      SMASH Team
  *
  *    GNU General Public License (GPLv3 or later)
@@ -66,7 +66,8 @@ SphereModus::SphereModus(Configuration modus_config,
                          modus_config.take({"Sphere", "Jet", "Jet_PDG"}))
                    : std::nullopt),
 
-      jet_mom_(modus_config.take({"Sphere", "Jet", "Jet_Momentum"}, 20.)) {}
+      jet_mom_(modus_config.take({"Sphere", "Jet", "Jet_Momentum"}, 20.)),
+      thermal_sampling_(sphere_temperature_, account_for_resonance_widths_) {}
 
 /* console output on startup of sphere specific parameters */
 std::ostream &operator<<(std::ostream &out, const SphereModus &m) {
@@ -148,14 +149,21 @@ double SphereModus::initial_conditions(Particles *particles,
                           p.second);
     }
   }
-  std::unique_ptr<QuantumSampling> quantum_sampling;
-  if (this->init_distr_ == SphereInitialCondition::ThermalMomentaQuantum) {
-    quantum_sampling = std::make_unique<QuantumSampling>(init_multipl_, V, T);
+  // The set up of the quantum sampling is the same for all events
+  if (this->init_distr_ == SphereInitialCondition::ThermalMomentaQuantum &&
+      !quantum_sampling_) {
+    quantum_sampling_.emplace(init_multipl_, V, T);
+  }
+  const bool thermal_boltzmann =
+      init_distr_ == SphereInitialCondition::ThermalMomentaBoltzmann;
+  if (thermal_boltzmann) {
+    /* thermal momentum according Maxwell-Boltzmann distribution, sampled
+     * for all particles of a species at once */
+    thermal_sampling_.sample(particles, thread_pool_);
   }
   /* loop over particle data to fill in momentum and position information */
   for (ParticleData &data : *particles) {
     Angles phitheta;
-    /* thermal momentum according Maxwell-Boltzmann distribution */
     double momentum_radial = 0.0, mass = data.pole_mass();
     /* assign momentum_radial according to requested distribution */
     switch (init_distr_) {
@@ -173,10 +181,7 @@ double SphereModus::initial_conditions(Particles *particles,
         break;
       case (SphereInitialCondition::ThermalMomentaBoltzmann):
       default:
-        mass = (!account_for_resonance_widths_)
-                   ? data.type().mass()
-                   : HadronGasEos::sample_mass_thermal(data.type(), 1.0 / T);
-        momentum_radial = sample_momenta_from_thermal(T, mass);
+        // sampled above
         break;
       case (SphereInitialCondition::ThermalMomentaQuantum):
         /*
@@ -187,14 +192,15 @@ double SphereModus::initial_conditions(Particles *particles,
          * **********************************************************************
          */
         mass = data.type().mass();
-        momentum_radial = quantum_sampling->sample(data.pdgcode());
+        momentum_radial = quantum_sampling_->sample(data.pdgcode());
         break;
     }
-    phitheta.distribute_isotropically();
-    logg[LSphere].debug(data.type().name(), "(id ", data.id(),
-                        ") radial momentum ", momentum_radial, ", direction",
-                        phitheta);
-    data.set_4momentum(mass, phitheta.threevec() * momentum_radial);
+    if (!thermal_boltzmann) {
+      phitheta.distribute_isotropically();
+      data.set_4momentum(mass, phitheta.threevec() * momentum_radial);
+    }
+    logg[LSphere].debug(data.type().name(), "(id ", data.id(), ") momentum ",
+                        data.momentum());
     momentum_total += data.momentum();
     /* uniform sampling in a sphere with radius r */
     double position_radial;
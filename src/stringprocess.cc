@@ -1,6 +1,6 @@
 /*
  *
- *    Copyright (c) 2017-2020,2022
+ *    Copyright (c) 2017-2020,2022,2024
  *      SMASH Team
  *
  *    GNU General Public License (GPLv3 or later)
@@ -9,7 +9,13 @@
 
 #include "smash/stringprocess.h"
 
+#include <algorithm>
 #include <array>
+#include <cmath>
+#include <map>
+#include <tuple>
+#include <utility>
+#include <vector>
 
 #include "smash/angles.h"
 #include "smash/kinematics.h"
@@ -19,6 +25,13 @@
 namespace smash {
 static constexpr int LOutput = LogArea::Output::id;
 
+struct StringProcess::PythiaDefaults {
+  /// Never initialized, only its settings and particle data are copied
+  Pythia8::Pythia pythia{PYTHIA_XML_DIR, false};
+  /// Guards the copies, which may be made by several threads
+  std::mutex mutex;
+};
+
 StringProcess::StringProcess(
     double string_tension, double time_formation, double gluon_beta,
     double gluon_pmin, double quark_alpha, double quark_beta,
@@ -49,12 +62,11 @@ StringProcess::StringProcess(
       prob_proton_to_d_uu_(prob_proton_to_d_uu),
       separate_fragment_baryon_(separate_fragment_baryon),
       use_monash_tune_(use_monash_tune) {
+  pythia_defaults_ = shared_pythia_defaults();
   // setup and initialize pythia for fragmentation
-  pythia_hadron_ = std::make_unique<Pythia8::Pythia>(PYTHIA_XML_DIR, false);
+  pythia_hadron_ = copy_pythia_defaults();
   /* turn off all parton-level processes to implement only hadronization */
   pythia_hadron_->readString("ProcessLevel:all = off");
-  common_setup_pythia(pythia_hadron_.get(), strange_supp, diquark_supp,
-                      popcorn_rate, stringz_a, stringz_b, string_sigma_T);
 
   /* initialize PYTHIA */
   pythia_hadron_->init();
@@ -76,6 +88,8 @@ StringProcess::StringProcess(
       const_cast<Pythia8::Info &>(pythia_hadron_->info));
   pythia_stringflav_.init();
 
+  tabulate_hadrons_by_charges();
+
   event_intermediate_.init("intermediate partons",
                            &pythia_hadron_->particleData);
 
@@ -86,6 +100,274 @@ StringProcess::StringProcess(
   final_state_.clear();
 }
 
+StringProcess::~StringProcess() {
+  if (prewarm_thread_.joinable()) {
+    prewarm_thread_.join();
+  }
+}
+
+std::pair<int, int> StringProcess::hard_pythia_key(
+    std::pair<int, int> idAB) const {
+  // Beams A can only be switched for a proton or neutron beam B
+  const bool switchable = std::abs(idAB.first) != 11 &&
+                          (idAB.second == 2212 || idAB.second == 2112);
+  if (share_hard_pythia_ && switchable) {
+    return {0, idAB.second};
+  }
+  return idAB;
+}
+
+std::shared_future<std::unique_ptr<Pythia8::Pythia>> StringProcess::hard_pythia(
+    std::pair<int, int> key, double sqrts) {
+  std::lock_guard<std::mutex> lock(hard_map_mutex_);
+  auto it = hard_map_.find(key);
+  if (it == hard_map_.end()) {
+    // Deferred, such that the first thread waiting for it initializes it
+    auto pythia = std::async(std::launch::deferred, [this, key, sqrts]() {
+      return create_hard_pythia(key, sqrts);
+    });
+    it = hard_map_.emplace(key, pythia.share()).first;
+  }
+  return it->second;
+}
+
+std::shared_ptr<StringProcess::PythiaDefaults>
+StringProcess::shared_pythia_defaults() {
+  using Parameters =
+      std::tuple<double, double, double, double, double, double, bool>;
+  static std::mutex mutex;
+  static std::map<Parameters, std::weak_ptr<PythiaDefaults>> all_defaults;
+  const Parameters parameters{strange_supp_,      diquark_supp_,
+                              popcorn_rate_,      stringz_a_produce_,
+                              stringz_b_produce_, string_sigma_T_,
+                              use_monash_tune_};
+  std::lock_guard<std::mutex> lock(mutex);
+  std::weak_ptr<PythiaDefaults> &existing = all_defaults[parameters];
+  std::shared_ptr<PythiaDefaults> defaults = existing.lock();
+  if (!defaults) {
+    defaults = std::make_shared<PythiaDefaults>();
+    common_setup_pythia(&defaults->pythia, strange_supp_, diquark_supp_,
+                        popcorn_rate_, stringz_a_produce_, stringz_b_produce_,
+                        string_sigma_T_);
+    existing = defaults;
+  }
+  return defaults;
+}
+
+std::unique_ptr<Pythia8::Pythia> StringProcess::copy_pythia_defaults() const {
+  PythiaDefaults &defaults = *pythia_defaults_;
+  std::lock_guard<std::mutex> lock(defaults.mutex);
+  return std::make_unique<Pythia8::Pythia>(defaults.pythia.settings,
+                                           defaults.pythia.particleData, false);
+}
+
+std::unique_ptr<Pythia8::Pythia> StringProcess::create_hard_pythia(
+    std::pair<int, int> key, double sqrts) {
+  auto pythia = copy_pythia_defaults();
+  pythia->readString("SoftQCD:nonDiffractive = on");
+  pythia->readString("MultipartonInteractions:pTmin = 1.5");
+  pythia->readString("HadronLevel:all = off");
+
+  pythia->settings.flag("Beams:allowVariableEnergy", true);
+
+  if (key.first == 0) {
+    // Shared by all hadrons onto which beam A can be mapped
+    pythia->settings.flag("Beams:allowIDAswitch", true);
+    pythia->readString("Beams:idAList = {2212,2112,-2212,-2112,211,-211}");
+    pythia->settings.mode("Beams:idA", 2212);
+  } else {
+    pythia->settings.mode("Beams:idA", key.first);
+  }
+  pythia->settings.mode("Beams:idB", key.second);
+  pythia->settings.parm("Beams:eCM", sqrts);
+
+  logg[LPythia].debug("Pythia object initialized with ", key.first, " + ",
+                      key.second, " at CM energy [GeV] ", sqrts);
+
+  if (!pythia->init()) {
+    throw std::runtime_error("Pythia failed to initialize.");
+  }
+  return pythia;
+}
+
+std::unique_ptr<StringProcess> StringProcess::clone() const {
+  auto copy = std::make_unique<StringProcess>(
+      kappa_tension_string_, time_formation_const_, pow_fgluon_beta_,
+      pmin_gluon_lightcone_, pow_fquark_alpha_, pow_fquark_beta_,
+      strange_supp_, diquark_supp_, sigma_qperp_, stringz_a_leading_,
+      stringz_b_leading_, stringz_a_produce_, stringz_b_produce_,
+      string_sigma_T_, soft_t_form_, mass_dependent_formation_times_,
+      prob_proton_to_d_uu_, separate_fragment_baryon_, popcorn_rate_,
+      use_monash_tune_);
+  copy->set_share_hard_pythia(share_hard_pythia_);
+  copy->diffractive_tables_ = diffractive_tables_;
+  if (!prewarm_beams_.empty()) {
+    copy->prewarm_hard_pythia(prewarm_beams_, prewarm_sqrts_);
+  }
+  return copy;
+}
+
+std::array<StringProcess::SubprocessStatistics, StringProcess::n_subprocesses>
+StringProcess::statistics() {
+  std::array<SubprocessStatistics, n_subprocesses> result = statistics_;
+  std::lock_guard<std::mutex> lock(thread_clones_mutex_);
+  for (const auto &thread_and_clone : thread_clones_) {
+    for (std::size_t i = 0; i < n_subprocesses; i++) {
+      result[i].add(thread_and_clone.second->statistics_[i]);
+    }
+  }
+  return result;
+}
+
+std::size_t StringProcess::n_pythia_instances() {
+  std::size_t n = pythia_hadron_ ? 1 : 0;
+  {
+    std::lock_guard<std::mutex> lock(hard_map_mutex_);
+    n += hard_map_.size();
+  }
+  std::lock_guard<std::mutex> lock(thread_clones_mutex_);
+  for (const auto &thread_and_clone : thread_clones_) {
+    n += thread_and_clone.second->n_pythia_instances();
+  }
+  return n;
+}
+
+const char *StringProcess::subprocess_name(Subprocess subprocess) {
+  switch (subprocess) {
+    case Subprocess::SingleDiffractive:
+      return "single diffractive";
+    case Subprocess::DoubleDiffractive:
+      return "double diffractive";
+    case Subprocess::NonDiffractiveSoft:
+      return "soft non-diffractive";
+    case Subprocess::NonDiffractiveHard:
+      return "hard non-diffractive";
+    case Subprocess::Annihilation:
+      return "annihilation";
+    case Subprocess::Fragmentation:
+      return "fragmentation";
+  }
+  return "unknown";
+}
+
+double StringProcess::diffractive_threshold(int pdg_a, int pdg_b) const {
+  // This threshold magic is following Pythia. Todo(ryu): take care of this.
+  double sqrts_threshold = 2. * (1. + 1.0e-6);
+  /* In the case of mesons, the corresponding vector meson masses
+   * are used to evaluate the energy threshold. */
+  const int pdg_a_mod =
+      (std::abs(pdg_a) > 1000) ? pdg_a : 10 * (std::abs(pdg_a) / 10) + 3;
+  const int pdg_b_mod =
+      (std::abs(pdg_b) > 1000) ? pdg_b : 10 * (std::abs(pdg_b) / 10) + 3;
+  sqrts_threshold += pythia_hadron_->particleData.m0(pdg_a_mod) +
+                     pythia_hadron_->particleData.m0(pdg_b_mod);
+  return sqrts_threshold;
+}
+
+std::array<double, 3> StringProcess::compute_diffractive(int pdg_a, int pdg_b,
+                                                         double sqrt_s) {
+  std::lock_guard<std::mutex> lock(pythia_mutex_);
+  pythia_sigmatot_.calc(pdg_a, pdg_b, sqrt_s);
+  return {pythia_sigmatot_.sigmaAX(), pythia_sigmatot_.sigmaXB(),
+          pythia_sigmatot_.sigmaXX()};
+}
+
+std::array<double, 3> StringProcess::cross_sections_diffractive(
+    int pdg_a, int pdg_b, double sqrt_s) {
+  if (diffractive_tables_) {
+    const auto it = diffractive_tables_->find({pdg_a, pdg_b});
+    if (it != diffractive_tables_->end() && sqrt_s < diffractive_sqrts_max) {
+      const DiffractiveTable &table = it->second;
+      const double x = std::log(std::max(sqrt_s, table.sqrts_threshold));
+      return {table.xs[0].get_value_linear(x),
+              table.xs[1].get_value_linear(x),
+              table.xs[2].get_value_linear(x)};
+    }
+  }
+  /* Constant cross-section for sub-processes below threshold equal to
+   * cross-section at the threshold. */
+  const double sqrts_threshold = diffractive_threshold(pdg_a, pdg_b);
+  return compute_diffractive(pdg_a, pdg_b, std::max(sqrt_s, sqrts_threshold));
+}
+
+void StringProcess::set_tabulate_diffractive(bool tabulate) {
+  if (!tabulate) {
+    diffractive_tables_.reset();
+    return;
+  }
+  // Number of intervals in ln(sqrt_s), which are about 1% wide
+  constexpr size_t n_intervals = 1000;
+  constexpr int beams[] = {2212, 2112, -2212, -2112, 211, -211};
+  auto tables =
+      std::make_shared<std::map<std::pair<int, int>, DiffractiveTable>>();
+  for (int pdg_a : beams) {
+    for (int pdg_b : beams) {
+      DiffractiveTable table;
+      table.sqrts_threshold = diffractive_threshold(pdg_a, pdg_b);
+      const double x_min = std::log(table.sqrts_threshold);
+      const double x_max = std::log(diffractive_sqrts_max);
+      const double dx = (x_max - x_min) / n_intervals;
+      // All three cross sections come from a single evaluation
+      std::array<std::shared_ptr<std::vector<double>>, 3> values;
+      for (auto &v : values) {
+        v = std::make_shared<std::vector<double>>(n_intervals + 1);
+      }
+      for (size_t j = 0; j <= n_intervals; j++) {
+        const std::array<double, 3> xs =
+            compute_diffractive(pdg_a, pdg_b, std::exp(x_min + j * dx));
+        for (int i = 0; i < 3; i++) {
+          (*values[i])[j] = xs[i];
+        }
+      }
+      for (int i = 0; i < 3; i++) {
+        table.xs[i] = Tabulation(x_min, x_max, 1. / dx, values[i]->data(),
+                                 values[i]->size(), values[i]);
+      }
+      tables->emplace(std::make_pair(pdg_a, pdg_b), std::move(table));
+    }
+  }
+  diffractive_tables_ = std::move(tables);
+}
+
+StringProcess &StringProcess::for_this_thread() {
+  const std::thread::id thread = std::this_thread::get_id();
+  if (thread == owner_thread_) {
+    return *this;
+  }
+  {
+    std::lock_guard<std::mutex> lock(thread_clones_mutex_);
+    auto it = thread_clones_.find(thread);
+    if (it != thread_clones_.end()) {
+      return *it->second;
+    }
+  }
+  /* Only the calling thread adds its clone, hence the PYTHIA objects can be
+   * initialized without blocking the other threads. */
+  std::unique_ptr<StringProcess> copy = clone();
+  std::lock_guard<std::mutex> lock(thread_clones_mutex_);
+  return *thread_clones_.emplace(thread, std::move(copy)).first->second;
+}
+
+void StringProcess::prewarm_hard_pythia(
+    const std::vector<std::pair<PdgCode, PdgCode>> &beams, double sqrts) {
+  prewarm_beams_ = beams;
+  prewarm_sqrts_ = sqrts;
+  std::vector<std::pair<int, int>> keys;
+  for (auto beam : beams) {
+    keys.push_back(hard_pythia_key({pdg_map_for_pythia(beam.first),
+                                    pdg_map_for_pythia(beam.second)}));
+  }
+  if (prewarm_thread_.joinable()) {
+    prewarm_thread_.join();
+  }
+  prewarm_thread_ = std::thread([this, keys, sqrts]() {
+    for (const std::pair<int, int> &key : keys) {
+      // Errors are raised again when the object is needed
+      hard_pythia(key, sqrts).wait();
+    }
+  });
+}
+
 void StringProcess::common_setup_pythia(Pythia8::Pythia *pythia_in,
                                         double strange_supp,
                                         double diquark_supp,
@@ -171,8 +453,9 @@ int StringProcess::append_final_state(ParticleList &intermediate_particles,
   assign_all_scaling_factors(bstring, intermediate_particles, evecLong,
                              additional_xsec_supp_);
 
-  // Velocity three-vector to perform Lorentz boost.
-  const ThreeVector vstring = uString.velocity();
+  // Lorentz boosts from the string into the center of mass and the lab frame
+  const LorentzBoost from_string_frame(-uString.velocity());
+  const LorentzBoost from_com_frame(-vcomAB_);
 
   // compute the formation times of hadrons
   for (int i = 0; i < nfrag; i++) {
@@ -180,7 +463,7 @@ int StringProcess::append_final_state(ParticleList &intermediate_particles,
     double gamma = 1. / intermediate_particles[i].inverse_gamma();
     // boost 4-momentum into the center of mass frame
     FourVector momentum =
-        intermediate_particles[i].momentum().lorentz_boost(-vstring);
+        from_string_frame(intermediate_particles[i].momentum());
     intermediate_particles[i].set_4momentum(momentum);
 
     if (mass_dependent_formation_times_) {
@@ -191,13 +474,12 @@ int StringProcess::append_final_state(ParticleList &intermediate_particles,
       FourVector fragment_position = FourVector(t_prod, t_prod * velocity);
       /* boost formation position into the center of mass frame
        * and then into the lab frame */
-      fragment_position = fragment_position.lorentz_boost(-vstring);
-      fragment_position = fragment_position.lorentz_boost(-vcomAB_);
+      fragment_position = from_com_frame(from_string_frame(fragment_position));
       intermediate_particles[i].set_slow_formation_times(
           time_collision_,
           soft_t_form_ * fragment_position.x0() + time_collision_);
     } else {
-      ThreeVector v_calc = momentum.lorentz_boost(-vcomAB_).velocity();
+      ThreeVector v_calc = from_com_frame(momentum).velocity();
       double gamma_factor = 1.0 / std::sqrt(1 - (v_calc).sqr());
       intermediate_particles[i].set_slow_formation_times(
           time_collision_,
@@ -211,6 +493,11 @@ int StringProcess::append_final_state(ParticleList &intermediate_particles,
 }
 
 void StringProcess::init(const ParticleList &incoming, double tcoll) {
+  /* Seed the hadronization from the current random stream, such that the
+   * fragmentation does not depend on the order in which concurrently evolved
+   * ensembles use this object. */
+  init_pythia_hadron_rndm();
+
   PDGcodes_[0] = incoming[0].pdgcode();
   PDGcodes_[1] = incoming[1].pdgcode();
   massA_ = incoming[0].effective_mass();
@@ -299,15 +586,14 @@ bool StringProcess::next_SDiff(bool is_AB_to_AX) {
   const FourVector prs = pnull.lorentz_boost(ustrXcom.velocity());
   ThreeVector evec = prs.threevec() / prs.threevec().abs();
   // perform fragmentation and add particles to final_state.
-  ParticleList new_intermediate_particles;
-  int nfrag = fragment_string(idqX1, idqX2, massX, evec, true, false,
-                              new_intermediate_particles);
+  int nfrag = timed(Subprocess::Fragmentation, [&]() {
+    return fragment_string(idqX1, idqX2, massX, evec, true, false, fragments_);
+  });
   if (nfrag < 1) {
     NpartString_[0] = 0;
     return false;
   }
-  NpartString_[0] =
-      append_final_state(new_intermediate_particles, ustrXcom, evec);
+  NpartString_[0] = append_final_state(fragments_, ustrXcom, evec);
 
   NpartString_[1] = 1;
   PdgCode hadron_code = is_AB_to_AX ? PDGcodes_[0] : PDGcodes_[1];
@@ -367,20 +653,19 @@ bool StringProcess::make_final_state_2strings(
   const std::array<FourVector, 2> ustr_com = {pstr_com[0] / m_str[0],
                                               pstr_com[1] / m_str[1]};
   for (int i = 0; i < 2; i++) {
-    ParticleList new_intermediate_particles;
-
     // determine direction in which string i is stretched.
     ThreeVector evec = evec_str[i];
     // perform fragmentation and add particles to final_state.
-    int nfrag = fragment_string(quarks[i][0], quarks[i][1], m_str[i], evec,
-                                flip_string_ends, separate_fragment_baryon,
-                                new_intermediate_particles);
+    int nfrag = timed(Subprocess::Fragmentation, [&]() {
+      return fragment_string(quarks[i][0], quarks[i][1], m_str[i], evec,
+                             flip_string_ends, separate_fragment_baryon,
+                             fragments_);
+    });
     if (nfrag <= 0) {
       NpartString_[i] = 0;
       return false;
     }
-    NpartString_[i] =
-        append_final_state(new_intermediate_particles, ustr_com[i], evec);
+    NpartString_[i] = append_final_state(fragments_, ustr_com[i], evec);
     assert(nfrag == NpartString_[i]);
   }
   if ((NpartString_[0] > 0) && (NpartString_[1] > 0)) {
@@ -561,35 +846,17 @@ bool StringProcess::next_NDiffHard() {
 
   std::pair<int, int> idAB{pdg_for_pythia[0], pdg_for_pythia[1]};
 
-  // If an entry for the calculated particle IDs does not exist, create one and
-  // initialize it accordingly
-  if (hard_map_.count(idAB) == 0) {
-    hard_map_[idAB] = std::make_unique<Pythia8::Pythia>(PYTHIA_XML_DIR, false);
-    hard_map_[idAB]->readString("SoftQCD:nonDiffractive = on");
-    hard_map_[idAB]->readString("MultipartonInteractions:pTmin = 1.5");
-    hard_map_[idAB]->readString("HadronLevel:all = off");
-
-    common_setup_pythia(hard_map_[idAB].get(), strange_supp_, diquark_supp_,
-                        popcorn_rate_, stringz_a_produce_, stringz_b_produce_,
-                        string_sigma_T_);
-
-    hard_map_[idAB]->settings.flag("Beams:allowVariableEnergy", true);
-
-    hard_map_[idAB]->settings.mode("Beams:idA", idAB.first);
-    hard_map_[idAB]->settings.mode("Beams:idB", idAB.second);
-    hard_map_[idAB]->settings.parm("Beams:eCM", sqrtsAB_);
-
-    logg[LPythia].debug("Pythia object initialized with ", pdg_for_pythia[0],
-                        " + ", pdg_for_pythia[1], " at CM energy [GeV] ",
-                        sqrtsAB_);
-
-    if (!hard_map_[idAB]->init()) {
-      throw std::runtime_error("Pythia failed to initialize.");
-    }
+  // Get the PYTHIA object for the calculated particle IDs, which is created
+  // and initialized if it does not exist yet
+  const std::pair<int, int> key = hard_pythia_key(idAB);
+  Pythia8::Pythia *pythia_hard = hard_pythia(key, sqrtsAB_).get().get();
+  if (key != idAB && !pythia_hard->setBeamIDs(idAB.first)) {
+    throw std::runtime_error("Pythia failed to switch the beam to " +
+                             std::to_string(idAB.first));
   }
 
   const int seed_new = random::uniform_int(1, maximum_rndm_seed_in_pythia);
-  hard_map_[idAB]->rndm.init(seed_new);
+  pythia_hard->rndm.init(seed_new);
   logg[LPythia].debug("hard_map_[", idAB.first, "][", idAB.second,
                       "] : rndm is initialized with seed ", seed_new);
 
@@ -599,31 +866,30 @@ bool StringProcess::next_NDiffHard() {
   Pythia8::Event &event_hadron = pythia_hadron_->event;
   logg[LPythia].debug("Pythia hard event created");
   // we update the collision energy in the CM frame
-  hard_map_[idAB]->setKinematics(sqrtsAB_);
-  bool final_state_success = hard_map_[idAB]->next();
+  pythia_hard->setKinematics(sqrtsAB_);
+  bool final_state_success = pythia_hard->next();
   logg[LPythia].debug("Pythia final state computed, success = ",
                       final_state_success);
   if (!final_state_success) {
     return false;
   }
 
-  ParticleList new_intermediate_particles;
-  ParticleList new_non_hadron_particles;
+  non_hadron_fragments_.clear();
 
   Pythia8::Vec4 pSum = 0.;
   event_intermediate_.reset();
   /* Update the partonic intermediate state from PYTHIA output.
    * Note that hadronization will be performed separately,
    * after identification of strings and replacement of constituents. */
-  for (int i = 0; i < hard_map_[idAB]->event.size(); i++) {
-    if (hard_map_[idAB]->event[i].isFinal()) {
-      const int pdgid = hard_map_[idAB]->event[i].id();
-      Pythia8::Vec4 pquark = hard_map_[idAB]->event[i].p();
-      const double mass = hard_map_[idAB]->particleData.m0(pdgid);
+  for (int i = 0; i < pythia_hard->event.size(); i++) {
+    if (pythia_hard->event[i].isFinal()) {
+      const int pdgid = pythia_hard->event[i].id();
+      Pythia8::Vec4 pquark = pythia_hard->event[i].p();
+      const double mass = pythia_hard->particleData.m0(pdgid);
 
-      const int status = hard_map_[idAB]->event[i].status();
-      const int color = hard_map_[idAB]->event[i].col();
-      const int anticolor = hard_map_[idAB]->event[i].acol();
+      const int status = pythia_hard->event[i].status();
+      const int color = pythia_hard->event[i].col();
+      const int anticolor = pythia_hard->event[i].acol();
 
       pSum += pquark;
       event_intermediate_.append(pdgid, status, color, anticolor, pquark, mass);
@@ -631,11 +897,11 @@ bool StringProcess::next_NDiffHard() {
   }
   // add junctions to the intermediate state if there is any.
   event_intermediate_.clearJunctions();
-  for (int i = 0; i < hard_map_[idAB]->event.sizeJunction(); i++) {
-    const int kind = hard_map_[idAB]->event.kindJunction(i);
+  for (int i = 0; i < pythia_hard->event.sizeJunction(); i++) {
+    const int kind = pythia_hard->event.kindJunction(i);
     std::array<int, 3> col;
     for (int j = 0; j < 3; j++) {
-      col[j] = hard_map_[idAB]->event.colJunction(i, j);
+      col[j] = pythia_hard->event.colJunction(i, j);
     }
     event_intermediate_.appendJunction(kind, col[0], col[1], col[2]);
   }
@@ -660,12 +926,12 @@ bool StringProcess::next_NDiffHard() {
     const int pdgid = event_intermediate_[ipart].id();
     if (event_intermediate_[ipart].isFinal() &&
         !event_intermediate_[ipart].isParton() &&
-        !hard_map_[idAB]->particleData.isOctetHadron(pdgid)) {
+        !pythia_hard->particleData.isOctetHadron(pdgid)) {
       logg[LPythia].debug("PDG ID from Pythia: ", pdgid);
       FourVector momentum = reorient(event_intermediate_[ipart], evecBasisAB_);
       logg[LPythia].debug("4-momentum from Pythia: ", momentum);
       bool found_ptype =
-          append_intermediate_list(pdgid, momentum, new_non_hadron_particles);
+          append_intermediate_list(pdgid, momentum, non_hadron_fragments_);
       if (!found_ptype) {
         logg[LPythia].warn("PDG ID ", pdgid,
                            " does not exist in ParticleType - start over.");
@@ -707,7 +973,7 @@ bool StringProcess::next_NDiffHard() {
     hadronize_success = pythia_hadron_->forceHadronLevel(false);
     logg[LPythia].debug("Pythia hadronized, success = ", hadronize_success);
 
-    new_intermediate_particles.clear();
+    fragments_.clear();
     if (hadronize_success) {
       for (int i = 0; i < event_hadron.size(); i++) {
         if (event_hadron[i].isFinal()) {
@@ -730,11 +996,11 @@ bool StringProcess::next_NDiffHard() {
                               " to the intermediate particle list.");
           bool found_ptype = false;
           if (event_hadron[i].isHadron()) {
-            found_ptype = append_intermediate_list(pythia_id, momentum,
-                                                   new_intermediate_particles);
+            found_ptype =
+                append_intermediate_list(pythia_id, momentum, fragments_);
           } else {
             found_ptype = append_intermediate_list(pythia_id, momentum,
-                                                   new_non_hadron_particles);
+                                                   non_hadron_fragments_);
           }
           if (!found_ptype) {
             logg[LPythia].warn("PDG ID ", pythia_id,
@@ -753,7 +1019,7 @@ bool StringProcess::next_NDiffHard() {
 
     FourVector uString = FourVector(1., 0., 0., 0.);
     ThreeVector evec = find_forward_string ? evecBasisAB_[0] : -evecBasisAB_[0];
-    int nfrag = append_final_state(new_intermediate_particles, uString, evec);
+    int nfrag = append_final_state(fragments_, uString, evec);
     NpartFinal_ += nfrag;
 
     find_forward_string = !find_forward_string;
@@ -761,7 +1027,7 @@ bool StringProcess::next_NDiffHard() {
 
   if (hadronize_success) {
     // add the final state particles, which are not hadron.
-    for (ParticleData data : new_non_hadron_particles) {
+    for (ParticleData &data : non_hadron_fragments_) {
       data.set_cross_section_scaling_factor(1.);
       data.set_formation_time(time_collision_);
       final_state_.push_back(data);
@@ -835,22 +1101,21 @@ void StringProcess::replace_constituent(
   for (int iq = 0; iq < nq; iq++) {
     int jq = std::abs(pdgid[iq]) - 1;
     int k_select = 0;
-    std::vector<int> k_found;
-    k_found.clear();
+    std::array<int, 5> k_found;
+    int n_found = 0;
     // check if the constituent needs to be converted.
     if (excess_constituent[jq] < 0) {
       for (int k = 0; k < 5; k++) {
         // check which specie it can be converted into.
         if (k != jq && excess_constituent[k] > 0) {
-          k_found.push_back(k);
+          k_found[n_found++] = k;
         }
       }
     }
 
     // make a random selection of specie and update the excess of constituent.
-    if (k_found.size() > 0) {
-      const int l =
-          random::uniform_int(0, static_cast<int>(k_found.size()) - 1);
+    if (n_found > 0) {
+      const int l = random::uniform_int(0, n_found - 1);
       k_select = k_found[l];
       /* flavor jq + 1 is converted into k_select + 1
        * and excess_constituent is updated. */
@@ -1370,7 +1635,9 @@ void StringProcess::compose_string_junction(bool &find_forward_string,
    * to make a color-neutral anti-baryonic configuration. */
   const int kind = event_intermediate.kindJunction(0);
   bool sign_color = kind % 2 == 1;
-  std::vector<int> col;  // color or anti-color indices of the junction legs
+  // color or anti-color indices of the junction legs
+  std::vector<int> &col = junction_legs_;
+  col.clear();
   for (int j = 0; j < 3; j++) {
     col.push_back(event_intermediate.colJunction(0, j));
   }
@@ -1392,7 +1659,8 @@ void StringProcess::compose_string_junction(bool &find_forward_string,
        * look over junctions and find connected ones. */
       logg[LPythia].debug("  still has leg(s) unfinished.");
       sign_color = !sign_color;
-      std::vector<int> junction_to_move;
+      std::vector<int> &junction_to_move = junctions_to_move_;
+      junction_to_move.clear();
       for (int i = 0; i < event_intermediate.sizeJunction(); i++) {
         const int kind_new = event_intermediate.kindJunction(i);
         /* If the original junction is associated with positive baryon number,
@@ -1616,18 +1884,16 @@ bool StringProcess::next_BBbarAnn() {
   }
   // Fragment two strings
   for (int i = 0; i < 2; i++) {
-    ParticleList new_intermediate_particles;
-
     ThreeVector evec = pcom_[i].threevec() / pcom_[i].threevec().abs();
-    const int nfrag =
-        fragment_string(remaining_quarks[i], remaining_antiquarks[i], mstr[i],
-                        evec, true, false, new_intermediate_particles);
+    const int nfrag = timed(Subprocess::Fragmentation, [&]() {
+      return fragment_string(remaining_quarks[i], remaining_antiquarks[i],
+                             mstr[i], evec, true, false, fragments_);
+    });
     if (nfrag <= 0) {
       NpartString_[i] = 0;
       return false;
     }
-    NpartString_[i] =
-        append_final_state(new_intermediate_particles, ustrcom[i], evec);
+    NpartString_[i] = append_final_state(fragments_, ustrcom[i], evec);
   }
   NpartFinal_ = NpartString_[0] + NpartString_[1];
   return true;
@@ -1849,10 +2115,10 @@ int StringProcess::fragment_string(int idq1, int idq2, double mString,
     int n_frag_prior;
     /* PDG id of fragmented hadrons
      * before switching to the PYTHIA fragmentation */
-    std::vector<int> pdgid_frag_prior;
+    std::vector<int> &pdgid_frag_prior = pdgid_frag_prior_;
     /* four-momenta of fragmented hadrons
      * before switching to the PYTHIA fragmentation */
-    std::vector<FourVector> momentum_frag_prior;
+    std::vector<FourVector> &momentum_frag_prior = momentum_frag_prior_;
 
     // Transverse momentum px of the forward end of the string
     double QTrx_string_pos;
@@ -1875,12 +2141,16 @@ int StringProcess::fragment_string(int idq1, int idq2, double mString,
     const int niter_max = 10000;
     bool found_leading_baryon = false;
     for (int iiter = 0; iiter < niter_max; iiter++) {
+      if (iiter > 0) {
+        statistics_[static_cast<std::size_t>(Subprocess::Fragmentation)]
+            .retries++;
+      }
       n_frag_prior = 0;
       pdgid_frag_prior.clear();
       momentum_frag_prior.clear();
       int n_frag = 0;
-      std::vector<int> pdgid_frag;
-      std::vector<FourVector> momentum_frag;
+      std::vector<int> &pdgid_frag = pdgid_frag_;
+      std::vector<FourVector> &momentum_frag = momentum_frag_;
       // The original string is aligned in the logitudinal direction.
       ppos_string_new = mString * M_SQRT1_2;
       pneg_string_new = mString * M_SQRT1_2;
@@ -2588,62 +2858,22 @@ int StringProcess::get_hadrontype_from_quark(int idq1, int idq2) {
   }
 
   /* If PYTHIA machinary does not work, determine type of the leading baryon
-   * based on the quantum numbers and mass. */
-
-  // net quark number of d, u, s, c and b flavors
-  std::array<int, 5> frag_net_q;
-  /* Evaluate total net quark number of baryon (antibaryon)
-   * from the valence quark constituents. */
-  for (int iq = 0; iq < 5; iq++) {
-    int nq1 =
-        pythia_hadron_->particleData.nQuarksInCode(std::abs(idq1), iq + 1);
-    int nq2 =
-        pythia_hadron_->particleData.nQuarksInCode(std::abs(idq2), iq + 1);
-    nq1 = idq1 > 0 ? nq1 : -nq1;
-    nq2 = idq2 > 0 ? nq2 : -nq2;
-    frag_net_q[iq] = nq1 + nq2;
-  }
-  const int frag_iso3 = frag_net_q[1] - frag_net_q[0];
-  const int frag_strange = -frag_net_q[2];
-  const int frag_charm = frag_net_q[3];
-  const int frag_bottom = -frag_net_q[4];
-  logg[LPythia].debug("  conserved charges : iso3 = ", frag_iso3,
-                      ", strangeness = ", frag_strange,
-                      ", charmness = ", frag_charm,
-                      ", bottomness = ", frag_bottom);
-
-  std::vector<int> pdgid_possible;
-  std::vector<double> weight_possible;
-  std::vector<double> weight_summed;
-  /* loop over hadronic species
+   * based on the quantum numbers and mass.
    * Any hadron with the same valence quark contents is allowed and
    * the probability goes like spin degeneracy over mass. */
-  for (auto &ptype : ParticleType::list_all()) {
-    if (!ptype.is_hadron()) {
-      continue;
-    }
-    const int pdgid = ptype.pdgcode().get_decimal();
-    if ((pythia_hadron_->particleData.isParticle(pdgid)) &&
-        (baryon_number == 3 * ptype.pdgcode().baryon_number()) &&
-        (frag_iso3 == ptype.pdgcode().isospin3()) &&
-        (frag_strange == ptype.pdgcode().strangeness()) &&
-        (frag_charm == ptype.pdgcode().charmness()) &&
-        (frag_bottom == ptype.pdgcode().bottomness())) {
-      const int spin_degeneracy = ptype.pdgcode().spin_degeneracy();
-      const double mass_pole = ptype.mass();
-      const double weight = static_cast<double>(spin_degeneracy) / mass_pole;
-      pdgid_possible.push_back(pdgid);
-      weight_possible.push_back(weight);
-
-      logg[LPythia].debug("  PDG id ", pdgid, " is possible with weight ",
-                          weight);
-    }
-  }
+  static const HadronsWithCharges no_hadrons{};
+  const auto found =
+      baryon_number % 3 == 0
+          ? hadrons_by_charges_.find(
+                charges_key_from_quarks(baryon_number / 3, idq1, idq2))
+          : hadrons_by_charges_.end();
+  const HadronsWithCharges &hadrons =
+      found != hadrons_by_charges_.end() ? found->second : no_hadrons;
+  const std::vector<int> &pdgid_possible = hadrons.pdgids;
+  const std::vector<double> &weight_summed = hadrons.weight_summed;
   const int n_possible = pdgid_possible.size();
-  weight_summed.push_back(0.);
-  for (int i = 0; i < n_possible; i++) {
-    weight_summed.push_back(weight_summed[i] + weight_possible[i]);
-  }
+  logg[LPythia].debug("  ", n_possible, " hadrons with the charges of ", idq1,
+                      " and ", idq2, " are possible");
 
   /* Sample baryon (antibaryon) specie,
    * which is fragmented from the leading diquark (anti-diquark). */
@@ -2697,68 +2927,23 @@ int StringProcess::get_resonance_from_quark(int idq1, int idq2, double mass) {
     return 0;
   }
 
-  /* array for the net quark numbers of the constituents.
-   * net_qnumber[0, 1, 2, 3 and 4] correspond respectively to
-   * d, u, s, c, b quark flavors. */
-  std::array<int, 5> net_qnumber;
-  for (int iflav = 0; iflav < 5; iflav++) {
-    net_qnumber[iflav] = 0;
-
-    int qnumber1 =
-        pythia_hadron_->particleData.nQuarksInCode(std::abs(idq1), iflav + 1);
-    if (idq1 < 0) {
-      // anti-diquark gets an extra minus sign.
-      qnumber1 = -qnumber1;
-    }
-    net_qnumber[iflav] += qnumber1;
-
-    int qnumber2 =
-        pythia_hadron_->particleData.nQuarksInCode(std::abs(idq2), iflav + 1);
-    if (idq2 < 0) {
-      // anti-quark gets an extra minus sign.
-      qnumber2 = -qnumber2;
-    }
-    net_qnumber[iflav] += qnumber2;
+  const auto found =
+      hadrons_by_charges_.find(charges_key_from_quarks(baryon, idq1, idq2));
+  if (found == hadrons_by_charges_.end()) {
+    return 0;
   }
-
   // List of PDG ids of resonances with the same quantum number.
   std::vector<int> pdgid_possible;
   // Corresponding mass differences.
   std::vector<double> mass_diff;
-  for (auto &ptype : ParticleType::list_all()) {
-    if (!ptype.is_hadron() || ptype.is_stable() ||
-        ptype.pdgcode().baryon_number() != baryon) {
-      // Only resonances with the same baryon number are considered.
-      continue;
-    }
-    const int pdgid = ptype.pdgcode().get_decimal();
-    const double mass_min = ptype.min_mass_spectral();
-    if (mass < mass_min) {
+  for (const ParticleTypePtr ptype : found->second.resonances) {
+    if (mass < ptype->min_mass_spectral()) {
       // A resoance with mass lower than its minimum threshold is not allowed.
       continue;
     }
-
-    if (ptype.pdgcode().isospin3() != net_qnumber[1] - net_qnumber[0]) {
-      // check isospin3.
-      continue;
-    }
-    if (ptype.pdgcode().strangeness() != -net_qnumber[2]) {
-      // check strangeness.
-      continue;
-    }
-    if (ptype.pdgcode().charmness() != net_qnumber[3]) {
-      // check charmness.
-      continue;
-    }
-    if (ptype.pdgcode().bottomness() != -net_qnumber[4]) {
-      // check bottomness.
-      continue;
-    }
-
-    const double mass_pole = ptype.mass();
     // Add the PDG id and mass difference to the vector array.
-    pdgid_possible.push_back(pdgid);
-    mass_diff.push_back(mass - mass_pole);
+    pdgid_possible.push_back(ptype->pdgcode().get_decimal());
+    mass_diff.push_back(mass - ptype->mass());
   }
 
   const int n_res = pdgid_possible.size();
@@ -2783,6 +2968,57 @@ int StringProcess::get_resonance_from_quark(int idq1, int idq2, double mass) {
   return pdgid_possible[ires_closest];
 }
 
+int StringProcess::charges_key(int baryon_number, int iso3, int strangeness,
+                               int charmness, int bottomness) {
+  // Every charge of a hadron fits into 6 bits
+  constexpr int offset = 32;
+  int key = baryon_number + offset;
+  for (const int charge : {iso3, strangeness, charmness, bottomness}) {
+    key = key * 2 * offset + charge + offset;
+  }
+  return key;
+}
+
+int StringProcess::charges_key_from_quarks(int baryon_number, int idq1,
+                                           int idq2) const {
+  /* net quark numbers of the d, u, s, c and b flavors,
+   * where antiquarks count negatively. */
+  std::array<int, 5> net_q;
+  for (int iq = 0; iq < 5; iq++) {
+    int nq1 =
+        pythia_hadron_->particleData.nQuarksInCode(std::abs(idq1), iq + 1);
+    int nq2 =
+        pythia_hadron_->particleData.nQuarksInCode(std::abs(idq2), iq + 1);
+    nq1 = idq1 > 0 ? nq1 : -nq1;
+    nq2 = idq2 > 0 ? nq2 : -nq2;
+    net_q[iq] = nq1 + nq2;
+  }
+  return charges_key(baryon_number, net_q[1] - net_q[0], -net_q[2], net_q[3],
+                     -net_q[4]);
+}
+
+void StringProcess::tabulate_hadrons_by_charges() {
+  for (const ParticleType &ptype : ParticleType::list_all()) {
+    if (!ptype.is_hadron()) {
+      continue;
+    }
+    const PdgCode pdg = ptype.pdgcode();
+    HadronsWithCharges &hadrons = hadrons_by_charges_[charges_key(
+        pdg.baryon_number(), pdg.isospin3(), pdg.strangeness(),
+        pdg.charmness(), pdg.bottomness())];
+    const int pdgid = pdg.get_decimal();
+    if (pythia_hadron_->particleData.isParticle(pdgid)) {
+      hadrons.pdgids.push_back(pdgid);
+      hadrons.weight_summed.push_back(
+          hadrons.weight_summed.back() +
+          static_cast<double>(pdg.spin_degeneracy()) / ptype.mass());
+    }
+    if (!ptype.is_stable()) {
+      hadrons.resonances.push_back(&ptype);
+    }
+  }
+}
+
 bool StringProcess::make_lightcone_final_two(
     bool separate_fragment_hadron, double ppos_string, double pneg_string,
     double mTrn_had_forward, double mTrn_had_backward, double &ppos_had_forward,
@@ -2848,35 +3084,116 @@ bool StringProcess::make_lightcone_final_two(
   return true;
 }
 
-double StringProcess::sample_zLund(double a, double b, double mTrn) {
-  // the lightcone momentum fraction x
-  double xfrac = 0.;
-  bool xfrac_accepted = false;
-  /* First sample the inverse 1/x of the lightcone momentum fraction.
-   * Then, obtain x itself.
-   * The probability distribution function for the inverse of x is
-   * PDF(u = 1/x) = (1/u) * (1 - 1/u)^a * exp(-b * mTrn^2 * u)
-   * with 1 < u < infinity.
-   * The rejection method can be used with an envelop function
-   * ENV(u) = exp(-b * mTrn^2 * u). */
-  while (!xfrac_accepted) {
-    const double fac_env = b * mTrn * mTrn;
-    const double u_aux = random::uniform(0., 1.);
-    /* Sample u = 1/x according to the envelop function
-     * ENV(u) = exp(-b * mTrn^2 * u). */
-    const double xfrac_inv = 1. - std::log(u_aux) / fac_env;
-    assert(xfrac_inv >= 1.);
-    /* Evaluate the ratio of the real probability distribution function to
-     * the envelop function. */
-    const double xf_ratio = std::pow(1. - 1. / xfrac_inv, a) / xfrac_inv;
-    // Determine whether the sampled value will be accepted.
-    if (random::uniform(0., 1.) <= xf_ratio) {
-      /* If the sampled value of 1/x is accepted,
-       * obtain the value of x. */
-      xfrac = 1. / xfrac_inv;
-      xfrac_accepted = true;
+namespace {
+/// Number of bins of the tabulated LUND fragmentation function
+constexpr std::size_t n_zlund_bins = 256;
+/// Number of quantization steps of \f$ b m_T^2 \f$ per factor e
+constexpr double zlund_steps_per_efold = 32.;
+
+/**
+ * LUND fragmentation function times z, which is the density of \f$ \ln z
+ * \f$ and bounded by one:
+ * \f$ z f(z) = (1 - z)^a \exp{ \left(- \frac{c}{z} \right) } \f$
+ *
+ * \param[in] a parameter for the fragmentation function
+ * \param[in] c product \f$ b m_T^2 \f$
+ * \param[in] z lightcone momentum fraction
+ * \return density of \f$ \ln z \f$
+ */
+double zlund_log_density(double a, double c, double z) {
+  return std::pow(1. - z, a) * std::exp(-c / z);
+}
+
+/**
+ * Envelope of the LUND fragmentation function in \f$ \ln z \f$, which is
+ * constant on each bin and equal to the maximum of the function within the
+ * bin. It is tabulated for a quantized \f$ c = b m_T^2 \f$, which is not
+ * larger than the actual one, so that it also bounds the function for the
+ * actual \f$ c \f$.
+ */
+class ZLundEnvelope {
+ public:
+  /**
+   * Tabulate the envelope.
+   *
+   * Below \f$ z = c / (c + 40) \f$, the function is suppressed by at least
+   * \f$ e^{-40} \f$ relative to its value at larger z and left out.
+   *
+   * \param[in] a parameter for the fragmentation function
+   * \param[in] c product \f$ b m_T^2 \f$
+   */
+  ZLundEnvelope(double a, double c)
+      : log_z_min_(std::log(c / (c + 40.))),
+        bin_width_(-log_z_min_ / n_zlund_bins),
+        maxima_(n_zlund_bins) {
+    /* The function is unimodal in z, its maximum is the solution of
+     * a z^2 + c z - c = 0. */
+    const double z_mode =
+        a > 0. ? (std::sqrt(c * c + 4. * a * c) - c) / (2. * a) : 1.;
+    for (std::size_t k = 0; k < n_zlund_bins; k++) {
+      const double z_low = std::exp(log_z_min_ + k * bin_width_);
+      const double z_high = std::exp(log_z_min_ + (k + 1) * bin_width_);
+      if (z_low <= z_mode && z_mode <= z_high) {
+        maxima_[k] = zlund_log_density(a, c, z_mode);
+      } else {
+        maxima_[k] = std::max(zlund_log_density(a, c, z_low),
+                              zlund_log_density(a, c, z_high));
+      }
     }
+    distribution_ = random::piecewise_constant_dist(log_z_min_, 0., maxima_);
   }
+
+  /**
+   * Sample \f$ \ln z \f$ from the envelope.
+   *
+   * \param[out] maximum value of the envelope at the sampled point
+   * \return sampled logarithm of the lightcone momentum fraction
+   */
+  double sample_log_z(double &maximum) const {
+    const double log_z = distribution_();
+    const std::size_t k = std::min(
+        static_cast<std::size_t>((log_z - log_z_min_) / bin_width_),
+        n_zlund_bins - 1);
+    maximum = maxima_[k];
+    return log_z;
+  }
+
+ private:
+  /// Lower end of the tabulated \f$ \ln z \f$
+  double log_z_min_;
+  /// Width of each bin in \f$ \ln z \f$
+  double bin_width_;
+  /// Maximum of the function within each bin
+  std::vector<double> maxima_;
+  /// Distribution of \f$ \ln z \f$ following the envelope
+  random::piecewise_constant_dist distribution_;
+};
+}  // namespace
+
+double StringProcess::sample_zLund(double a, double b, double mTrn) {
+  const double fac_env = b * mTrn * mTrn;
+  assert(fac_env > 0.);
+  /* Sample ln z from the envelope tabulated for the quantized b * mTrn^2,
+   * and correct for the difference to the actual function by rejection.
+   * The result is exact, but as the envelope is close to the function,
+   * hardly any samples are rejected, independent of a and b * mTrn^2.
+   * The envelopes are cached per thread, so they need not be locked. */
+  const int step =
+      static_cast<int>(std::floor(zlund_steps_per_efold * std::log(fac_env)));
+  thread_local std::map<std::pair<double, int>, ZLundEnvelope> envelopes;
+  auto found = envelopes.find({a, step});
+  if (found == envelopes.end()) {
+    const double fac_env_quantized = std::exp(step / zlund_steps_per_efold);
+    found = envelopes
+                .emplace(std::make_pair(a, step),
+                         ZLundEnvelope(a, fac_env_quantized))
+                .first;
+  }
+  const ZLundEnvelope &envelope = found->second;
+  double xfrac, maximum;
+  do {
+    xfrac = std::exp(envelope.sample_log_z(maximum));
+  } while (random::uniform(0., maximum) > zlund_log_density(a, fac_env, xfrac));
   return xfrac;
 }
 
@@ -3219,7 +3536,7 @@ void StringProcess::assign_all_scaling_factors(int baryon_string,
   }
   // sort outgoing particles according to the longitudinal velocity
   std::sort(outgoing_particles.begin(), outgoing_particles.end(),
-            [&](ParticleData i, ParticleData j) {
+            [&](const ParticleData &i, const ParticleData &j) {
               return i.momentum().velocity() * evecLong >
                      j.momentum().velocity() * evecLong;
             });
@@ -0,0 +1,101 @@
+/*
+ *
+ *    Copyright (c) 2024
+ *      SMASH Team
+ *
+ *    GNU General Public License (GPLv3 or later)
+ *
+ */
+
+#include "smash/sweepandprune.h"
+
+#include <algorithm>
+#include <array>
+
+#include "smash/particledata.h"
+#include "smash/particles.h"
+
+namespace smash {
+
+void SweepAndPrune::update(
+    const Particles &particles, double reach, double timestep_duration,
+    bool include_unformed_particles,
+    const std::function<bool(const ParticleData &)> &skip) {
+  reach_ = reach;
+  sorting_.clear();
+  sorted_.clear();
+  coordinates_.clear();
+  std::array<double, 3> sum = {0., 0., 0.}, sum_sqr = {0., 0., 0.};
+  for (const ParticleData &p : particles) {
+    if (!include_unformed_particles &&
+        p.xsec_scaling_factor(timestep_duration) <= 0.0) {
+      continue;
+    }
+    if (skip && skip(p)) {
+      continue;
+    }
+    for (int i = 0; i < 3; i++) {
+      const double x = p.position()[i + 1];
+      sum[i] += x;
+      sum_sqr[i] += x * x;
+    }
+    // the coordinate is set once the axis is known
+    sorting_.emplace_back(0., &p);
+  }
+  if (sorting_.empty()) {
+    return;
+  }
+
+  // The axis with the largest variance of the positions
+  const double n = sorting_.size();
+  double largest_variance = -1.;
+  for (int i = 0; i < 3; i++) {
+    const double variance = sum_sqr[i] / n - (sum[i] / n) * (sum[i] / n);
+    if (variance > largest_variance) {
+      largest_variance = variance;
+      axis_ = i;
+    }
+  }
+
+  for (auto &entry : sorting_) {
+    entry.first = entry.second->position()[axis_ + 1];
+  }
+  // Ties are ordered by the ids, such that the order is reproducible
+  std::sort(sorting_.begin(), sorting_.end(),
+            [](const auto &a, const auto &b) {
+              return a.first < b.first ||
+                     (a.first == b.first && a.second->id() < b.second->id());
+            });
+  sorted_.reserve(sorting_.size());
+  coordinates_.reserve(sorting_.size());
+  for (const auto &entry : sorting_) {
+    coordinates_.push_back(entry.first);
+    sorted_.push_back(entry.second);
+  }
+}
+
+void SweepAndPrune::iterate_cells(
+    const std::function<void(const ParticleSpan &)> &search_cell_callback,
+    const std::function<void(const ParticleSpan &, const ParticleSpan &)>
+        &neighbor_cell_callback) const {
+  const std::size_t n = sorted_.size();
+  // End of the particles within reach of the current block
+  std::size_t end = 0;
+  for (std::size_t first = 0; first < n; first += block_size) {
+    const std::size_t last = std::min(first + block_size, n);
+    const ParticleSpan block(sorted_.data() + first, last - first);
+    search_cell_callback(block);
+
+    const double limit = coordinates_[last - 1] + reach_;
+    end = std::max(end, last);
+    while (end < n && coordinates_[end] <= limit) {
+      end++;
+    }
+    if (end > last) {
+      neighbor_cell_callback(block,
+                             ParticleSpan(sorted_.data() + last, end - last));
+    }
+  }
+}
+
+}  // namespace smash
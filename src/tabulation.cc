@@ -1,5 +1,5 @@
 /*
- *    Copyright (c) 2015-2019
+ *    Copyright (c) 2015-2019,2024
  *      SMASH Team
  *
  *    GNU General Public License (GPLv3 or later)
@@ -7,7 +7,18 @@
 
 #include "smash/tabulation.h"
 
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <limits>
+#include <mutex>
+#include <stdexcept>
+
+#include "smash/logging.h"
+#include "smash/tabulationarchive.h"
+
 namespace smash {
+static constexpr int LResonances = LogArea::Resonances::id;
 
 Tabulation::Tabulation(double x_min, double range, size_t num,
                        std::function<double(double)> f)
@@ -15,11 +26,29 @@ Tabulation::Tabulation(double x_min, double range, size_t num,
   if (num < 2) {
     throw std::runtime_error("Tabulation needs at least two values");
   }
-  values_.resize(num + 1);
+  std::vector<double> values(num + 1);
   const double dx = range / num;
   for (size_t i = 0; i <= num; i++) {
-    values_[i] = f(x_min_ + i * dx);
+    values[i] = f(x_min_ + i * dx);
   }
+  set_values(std::move(values));
+}
+
+std::atomic<std::size_t> Tabulation::allocated_bytes_{0};
+
+void Tabulation::set_values(std::vector<double>&& values) {
+  const std::size_t bytes = values.capacity() * sizeof(double);
+  allocated_bytes_ += bytes;
+  // The values are accounted for until the last copy is destroyed
+  std::shared_ptr<const std::vector<double>> storage(
+      new std::vector<double>(std::move(values)),
+      [bytes](const std::vector<double>* v) {
+        allocated_bytes_ -= bytes;
+        delete v;
+      });
+  values_ = storage->data();
+  n_values_ = storage->size();
+  storage_ = std::move(storage);
 }
 
 double Tabulation::get_value_step(double x) const {
@@ -28,8 +57,8 @@ double Tabulation::get_value_step(double x) const {
   }
   // this rounds correctly because double -> int conversion truncates
   const unsigned int n = (x - x_min_) * inv_dx_ + 0.5;
-  if (n >= values_.size()) {
-    return values_.back();
+  if (n >= n_values_) {
+    return values_[n_values_ - 1];
   } else {
     return values_[n];
   }
@@ -43,16 +72,224 @@ double Tabulation::get_value_linear(double x, Extrapolation extrapol) const {
     return 0.0;
   }
   if (extrapol == Extrapolation::Const && x > x_max_) {
-    return values_.back();
+    return values_[n_values_ - 1];
   }
   const double index_double = (x - x_min_) * inv_dx_;
   // here n is the lower index
   const size_t n =
-      std::min(static_cast<size_t>(index_double), values_.size() - 2);
+      std::min(static_cast<size_t>(index_double), n_values_ - 2);
   const double r = index_double - n;
   return values_[n] + (values_[n + 1] - values_[n]) * r;
 }
 
+/**
+ * Slopes of the monotone cubic Hermite interpolation through the given
+ * points, following Fritsch and Carlson with the weighted harmonic mean of
+ * Fritsch and Butland.
+ *
+ * \param x Knots
+ * \param y Values at the knots
+ * \return Slopes at the knots
+ */
+static std::vector<double> monotone_slopes(const std::vector<double>& x,
+                                           const std::vector<double>& y) {
+  const size_t n = x.size();
+  std::vector<double> secants(n - 1);
+  for (size_t i = 0; i < n - 1; i++) {
+    secants[i] = (y[i + 1] - y[i]) / (x[i + 1] - x[i]);
+  }
+  std::vector<double> slopes(n);
+  slopes[0] = secants[0];
+  slopes[n - 1] = secants[n - 2];
+  for (size_t i = 1; i < n - 1; i++) {
+    if (secants[i - 1] * secants[i] <= 0.) {
+      // Local extremum
+      slopes[i] = 0.;
+    } else {
+      const double h0 = x[i] - x[i - 1];
+      const double h1 = x[i + 1] - x[i];
+      const double w0 = 2. * h1 + h0;
+      const double w1 = h1 + 2. * h0;
+      slopes[i] = (w0 + w1) / (w0 / secants[i - 1] + w1 / secants[i]);
+    }
+  }
+  return slopes;
+}
+
+/**
+ * Evaluate a cubic Hermite polynomial.
+ *
+ * \param x0 Lower knot
+ * \param x1 Upper knot
+ * \param y0 Value at the lower knot
+ * \param y1 Value at the upper knot
+ * \param d0 Slope at the lower knot
+ * \param d1 Slope at the upper knot
+ * \param x Argument
+ * \return Value of the polynomial at x
+ */
+static double hermite(double x0, double x1, double y0, double y1, double d0,
+                      double d1, double x) {
+  const double h = x1 - x0;
+  const double t = (x - x0) / h;
+  const double t2 = t * t;
+  const double t3 = t2 * t;
+  return (2. * t3 - 3. * t2 + 1.) * y0 + (t3 - 2. * t2 + t) * h * d0 +
+         (3. * t2 - 2. * t3) * y1 + (t3 - t2) * h * d1;
+}
+
+AdaptiveTabulation::AdaptiveTabulation(double x_min, double x_max,
+                                       const std::function<double(double)>& f,
+                                       double tolerance, size_t n_initial,
+                                       size_t max_knots) {
+  if (!(x_max > x_min) || n_initial < 2) {
+    throw std::runtime_error(
+        "AdaptiveTabulation needs a domain and at least two intervals");
+  }
+  std::vector<double> x(n_initial + 1), y(n_initial + 1);
+  double scale = 0.;
+  for (size_t i = 0; i <= n_initial; i++) {
+    x[i] = x_min + (x_max - x_min) * i / n_initial;
+    y[i] = f(x[i]);
+    scale = std::max(scale, std::abs(y[i]));
+  }
+  // Intervals are not split further than this
+  const double min_width = (x_max - x_min) * 1e-6;
+
+  /* Check the center of every interval that has not converged yet and split
+   * it if needed. Splitting an interval changes the slopes of its neighbors,
+   * which therefore have to be checked again. The values at the centers are
+   * kept for this, NaN meaning that they are not known yet. */
+  constexpr double unknown = std::numeric_limits<double>::quiet_NaN();
+  std::vector<bool> converged(n_initial, false);
+  std::vector<double> centers(n_initial, unknown);
+  bool refined = true;
+  while (refined) {
+    refined = false;
+    const std::vector<double> slopes = monotone_slopes(x, y);
+    std::vector<double> new_x, new_y, new_centers;
+    std::vector<bool> new_converged;
+    bool neighbor_split = false;
+    for (size_t i = 0; i < x.size() - 1; i++) {
+      new_x.push_back(x[i]);
+      new_y.push_back(y[i]);
+      const bool full = x.size() + new_x.size() - i > max_knots;
+      if ((converged[i] && !neighbor_split) || full ||
+          x[i + 1] - x[i] < min_width) {
+        new_converged.push_back(true);
+        new_centers.push_back(centers[i]);
+        neighbor_split = false;
+        continue;
+      }
+      const double x_center = 0.5 * (x[i] + x[i + 1]);
+      if (std::isnan(centers[i])) {
+        centers[i] = f(x_center);
+        scale = std::max(scale, std::abs(centers[i]));
+      }
+      const double y_center = centers[i];
+      const double error = std::abs(
+          hermite(x[i], x[i + 1], y[i], y[i + 1], slopes[i], slopes[i + 1],
+                  x_center) -
+          y_center);
+      neighbor_split = false;
+      if (error <= tolerance * std::max(std::abs(y_center), 0.01 * scale)) {
+        new_converged.push_back(true);
+        new_centers.push_back(y_center);
+      } else {
+        if (!new_converged.empty()) {
+          new_converged.back() = false;
+        }
+        new_x.push_back(x_center);
+        new_y.push_back(y_center);
+        new_converged.insert(new_converged.end(), 2, false);
+        new_centers.insert(new_centers.end(), 2, unknown);
+        neighbor_split = true;
+        refined = true;
+      }
+    }
+    new_x.push_back(x.back());
+    new_y.push_back(y.back());
+    x = std::move(new_x);
+    y = std::move(new_y);
+    converged = std::move(new_converged);
+    centers = std::move(new_centers);
+  }
+  const std::vector<double> slopes = monotone_slopes(x, y);
+
+  // Pack everything, followed by one bucket per interval on average
+  const size_t n = x.size();
+  const size_t n_buckets = n - 1;
+  const double bucket_width = (x_max - x_min) / n_buckets;
+  std::vector<double> values;
+  values.reserve(1 + 3 * n + n_buckets + 1);
+  values.push_back(n);
+  values.insert(values.end(), x.begin(), x.end());
+  values.insert(values.end(), y.begin(), y.end());
+  values.insert(values.end(), slopes.begin(), slopes.end());
+  size_t interval = 0;
+  for (size_t b = 0; b <= n_buckets; b++) {
+    const double bucket_start = x_min + b * bucket_width;
+    while (interval < n - 2 && x[interval + 1] <= bucket_start) {
+      interval++;
+    }
+    values.push_back(interval);
+  }
+  packed_.x_min_ = x_min;
+  packed_.x_max_ = x_max;
+  packed_.inv_dx_ = 1. / bucket_width;
+  packed_.set_values(std::move(values));
+  unpack();
+}
+
+AdaptiveTabulation::AdaptiveTabulation(Tabulation packed)
+    : packed_(std::move(packed)) {
+  unpack();
+}
+
+void AdaptiveTabulation::unpack() {
+  const size_t n_values = packed_.n_values_;
+  const size_t n = n_values > 0 ? static_cast<size_t>(packed_.values_[0]) : 0;
+  if (n < 2 || n_values < 3 * n + 3) {
+    throw std::runtime_error("Invalid packed AdaptiveTabulation");
+  }
+  n_knots_ = n;
+  n_buckets_ = n_values - 1 - 3 * n - 1;
+  x_ = packed_.values_ + 1;
+  y_ = x_ + n;
+  slopes_ = y_ + n;
+  buckets_ = slopes_ + n;
+}
+
+double AdaptiveTabulation::get_value(double x,
+                                     Extrapolation extrapolation) const {
+  const double x_min = packed_.x_min_;
+  const double x_max = packed_.x_max_;
+  if (x < x_min) {
+    return 0.;
+  }
+  if (x > x_max) {
+    switch (extrapolation) {
+      case Extrapolation::Zero:
+        return 0.;
+      case Extrapolation::Const:
+        return y_[n_knots_ - 1];
+      case Extrapolation::Linear:
+        return y_[n_knots_ - 1] + slopes_[n_knots_ - 1] * (x - x_max);
+    }
+  }
+  // The interval is between those of the bounds of the bucket
+  const size_t bucket =
+      std::min(static_cast<size_t>((x - x_min) * packed_.inv_dx_),
+               n_buckets_ - 1);
+  const size_t first = buckets_[bucket];
+  const size_t last = buckets_[bucket + 1];
+  size_t i =
+      std::upper_bound(x_ + first + 1, x_ + last + 1, x) - x_ - 1;
+  i = std::min(i, n_knots_ - 2);
+  return hermite(x_[i], x_[i + 1], y_[i], y_[i + 1], slopes_[i],
+                 slopes_[i + 1], x);
+}
+
 /**
  * Write binary representation to stream.
  *
@@ -108,13 +345,13 @@ static size_t sread_size(std::ifstream& stream) {
  * Write binary representation to stream.
  *
  * \param stream Output stream.
- * \param x Value to be written.
+ * \param x Values to be written.
+ * \param n Number of values.
  */
-static void swrite(std::ofstream& stream, const std::vector<double> x) {
-  swrite(stream, x.size());
-  if (x.size() > 0) {
-    stream.write(reinterpret_cast<const char*>(x.data()),
-                 sizeof(x[0]) * x.size());
+static void swrite(std::ofstream& stream, const double* x, size_t n) {
+  swrite(stream, n);
+  if (n > 0) {
+    stream.write(reinterpret_cast<const char*>(x), sizeof(x[0]) * n);
   }
 }
 
@@ -161,7 +398,7 @@ void Tabulation::write(std::ofstream& stream, sha256::Hash hash) const {
   swrite(stream, x_min_);
   swrite(stream, x_max_);
   swrite(stream, inv_dx_);
-  swrite(stream, values_);
+  swrite(stream, values_, n_values_);
 }
 
 Tabulation Tabulation::from_file(std::ifstream& stream, sha256::Hash hash) {
@@ -173,8 +410,122 @@ Tabulation Tabulation::from_file(std::ifstream& stream, sha256::Hash hash) {
   t.x_min_ = sread_double(stream);
   t.x_max_ = sread_double(stream);
   t.inv_dx_ = sread_double(stream);
-  t.values_ = sread_vector(stream);
+  t.set_values(sread_vector(stream));
   return t;
 }
 
+TabulationCache* TabulationCache::active_ = nullptr;
+
+/**
+ * Print a progress message, which is overwritten by the next one.
+ *
+ * Tabulations may be obtained from several threads at the same time, hence
+ * the messages are serialized.
+ *
+ * \param[in] message Message
+ * \param[in] name Name of the tabulation
+ */
+static void print_progress(const char* message, const std::string& name) {
+  static std::mutex mutex;
+  std::lock_guard<std::mutex> lock(mutex);
+  std::cout << message << name << '\r' << std::flush;
+}
+
+TabulationCache::TabulationCache(const std::filesystem::path& dir,
+                                 sha256::Hash hash)
+    : dir_(dir), hash_(hash), lock_(dir / "tabulations.lock") {
+  if (active_ != nullptr) {
+    throw std::logic_error("Only one TabulationCache may exist at a time.");
+  }
+  if (!dir_.empty()) {
+    // To avoid race conditions, make sure we are the only ones currently
+    // storing tabulations. Reading is always safe, since the archive is
+    // replaced atomically.
+    store_ = lock_.acquire();
+    archive_ = std::make_unique<TabulationArchive>(
+        TabulationArchive::open(dir_ / "tabulations.bin"));
+  }
+  active_ = this;
+}
+
+TabulationCache::~TabulationCache() {
+  active_ = nullptr;
+  if (!store_ || computed_.empty()) {
+    return;
+  }
+  // Keep the entries of the old archive that were not recomputed
+  std::vector<TabulationArchive::Entry> entries;
+  for (TabulationArchive::Entry& entry : archive_->entries()) {
+    if (computed_.count(entry.name) == 0) {
+      entries.push_back(std::move(entry));
+    }
+  }
+  for (auto& name_and_computed : computed_) {
+    entries.push_back({name_and_computed.first, name_and_computed.second.first,
+                       std::move(name_and_computed.second.second)});
+  }
+  try {
+    TabulationArchive::write(dir_ / "tabulations.bin", entries);
+  } catch (const std::exception& e) {
+    logg[LResonances].warn("Could not cache the tabulations: ", e.what());
+  }
+}
+
+std::vector<Tabulation> TabulationCache::get(
+    const std::string& name, const std::string& parameters,
+    const std::function<std::vector<Tabulation>()>& compute) {
+  if (active_ == nullptr || active_->dir_.empty()) {
+    return compute();
+  }
+  sha256::Hash hash = active_->hash_;
+  if (!parameters.empty()) {
+    sha256::Context hash_context;
+    hash_context.update(hash.data(), hash.size());
+    hash_context.update(parameters);
+    hash = hash_context.finalize();
+  }
+  std::vector<Tabulation> tabulations = active_->archive_->find(name, hash);
+  if (!tabulations.empty()) {
+    print_progress("Tabulation found for ", name);
+    return tabulations;
+  }
+  if (active_->store_) {
+    // The tabulations might have been computed before in this run
+    std::lock_guard<std::mutex> lock(active_->computed_mutex_);
+    const auto it = active_->computed_.find(name);
+    if (it != active_->computed_.end() && it->second.first == hash) {
+      return it->second.second;
+    }
+  }
+  print_progress("Caching tabulation for ", name);
+  tabulations = compute();
+  if (active_->store_) {
+    std::lock_guard<std::mutex> lock(active_->computed_mutex_);
+    active_->computed_[name] = {hash, tabulations};
+  }
+  return tabulations;
+}
+
+Tabulation TabulationCache::get(const std::string& name,
+                                const std::function<Tabulation()>& compute) {
+  std::vector<Tabulation> tabulations = get(name, {}, [&]() {
+    std::vector<Tabulation> result;
+    result.push_back(compute());
+    return result;
+  });
+  return std::move(tabulations.front());
+}
+
+AdaptiveTabulation TabulationCache::get(
+    const std::string& name,
+    const std::function<AdaptiveTabulation()>& compute) {
+  // The parameters keep the packed representation apart from Tabulation
+  std::vector<Tabulation> tabulations = get(name, "adaptive", [&]() {
+    std::vector<Tabulation> result;
+    result.push_back(compute().packed_);
+    return result;
+  });
+  return AdaptiveTabulation(std::move(tabulations.front()));
+}
+
 }  // namespace smash
@@ -0,0 +1,203 @@
+/*
+ *
+ *    Copyright (c) 2024
+ *      SMASH Team
+ *
+ *    GNU General Public License (GPLv3 or later)
+ *
+ */
+
+#include "smash/tabulationarchive.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+
+namespace smash {
+
+/**
+ * \param[in] name Name of an entry
+ * \param[in] hash Hash of an entry
+ * \return Key of the entry in the index
+ */
+static std::string index_key(const std::string &name, sha256::Hash hash) {
+  return name + std::string(hash.begin(), hash.end());
+}
+
+/**
+ * \param[in] n Number of bytes
+ * \return Number of bytes rounded up to a multiple of 8
+ */
+static std::uint64_t padded(std::uint64_t n) { return (n + 7) / 8 * 8; }
+
+/// Size of the header: magic, version, number of entries [bytes]
+constexpr std::uint64_t header_size = 24;
+
+TabulationArchive TabulationArchive::open(const std::filesystem::path &path) {
+  TabulationArchive archive;
+  const int fd = ::open(path.c_str(), O_RDONLY);
+  if (fd < 0) {
+    return archive;
+  }
+  struct stat status;
+  if (fstat(fd, &status) != 0 ||
+      static_cast<std::uint64_t>(status.st_size) < header_size) {
+    close(fd);
+    return archive;
+  }
+  const std::size_t size = status.st_size;
+  void *address = mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0);
+  // The mapping stays valid after closing the file
+  close(fd);
+  if (address == MAP_FAILED) {
+    return archive;
+  }
+  archive.mapping_ = std::shared_ptr<const void>(
+      address, [size](const void *p) { munmap(const_cast<void *>(p), size); });
+  archive.data_ = static_cast<const char *>(address);
+  archive.size_ = size;
+
+  // Read the header and the index, checking every access against the size
+  std::uint64_t position = 0;
+  auto read_u64 = [&](std::uint64_t &x) {
+    if (position + sizeof(x) > size) {
+      return false;
+    }
+    std::memcpy(&x, archive.data_ + position, sizeof(x));
+    position += sizeof(x);
+    return true;
+  };
+  std::uint64_t file_version = 0, n_entries = 0;
+  if (std::memcmp(archive.data_, magic, sizeof(magic)) != 0) {
+    return TabulationArchive();
+  }
+  position = sizeof(magic);
+  if (!read_u64(file_version) || file_version != version ||
+      !read_u64(n_entries)) {
+    return TabulationArchive();
+  }
+  for (std::uint64_t i = 0; i < n_entries; i++) {
+    Location location;
+    std::uint64_t name_length = 0;
+    if (!read_u64(name_length) || name_length > size - position) {
+      return TabulationArchive();
+    }
+    location.name.assign(archive.data_ + position, name_length);
+    position += padded(name_length);
+    if (position + location.hash.size() > size) {
+      return TabulationArchive();
+    }
+    std::memcpy(location.hash.data(), archive.data_ + position,
+                location.hash.size());
+    position += location.hash.size();
+    if (!read_u64(location.offset) || !read_u64(location.n_tabulations)) {
+      return TabulationArchive();
+    }
+    archive.index_.emplace(index_key(location.name, location.hash),
+                           std::move(location));
+  }
+  return archive;
+}
+
+std::vector<Tabulation> TabulationArchive::read(
+    const Location &location) const {
+  std::vector<Tabulation> tabulations;
+  std::uint64_t position = location.offset;
+  for (std::uint64_t i = 0; i < location.n_tabulations; i++) {
+    // x_min, x_max, inv_dx and the number of values
+    if (position + 32 > size_) {
+      return {};
+    }
+    double bounds[3];
+    std::uint64_t n_values;
+    std::memcpy(bounds, data_ + position, sizeof(bounds));
+    std::memcpy(&n_values, data_ + position + 24, sizeof(n_values));
+    position += 32;
+    if (n_values < 2 || n_values > (size_ - position) / sizeof(double)) {
+      return {};
+    }
+    // The mapping is page-aligned and all offsets are multiples of 8
+    tabulations.emplace_back(bounds[0], bounds[1], bounds[2],
+                             reinterpret_cast<const double *>(data_ + position),
+                             n_values, mapping_);
+    position += n_values * sizeof(double);
+  }
+  return tabulations;
+}
+
+std::vector<Tabulation> TabulationArchive::find(const std::string &name,
+                                                sha256::Hash hash) const {
+  const auto it = index_.find(index_key(name, hash));
+  if (it == index_.end()) {
+    return {};
+  }
+  return read(it->second);
+}
+
+std::vector<TabulationArchive::Entry> TabulationArchive::entries() const {
+  std::vector<Entry> result;
+  result.reserve(index_.size());
+  for (const auto &key_and_location : index_) {
+    const Location &location = key_and_location.second;
+    std::vector<Tabulation> tabulations = read(location);
+    if (!tabulations.empty()) {
+      result.push_back({location.name, location.hash, std::move(tabulations)});
+    }
+  }
+  return result;
+}
+
+void TabulationArchive::write(const std::filesystem::path &path,
+                              const std::vector<Entry> &entries) {
+  const std::filesystem::path temporary = path.string() + ".tmp";
+  {
+    std::ofstream file(temporary, std::ios::binary);
+    auto write_u64 = [&](std::uint64_t x) {
+      file.write(reinterpret_cast<const char *>(&x), sizeof(x));
+    };
+    const char padding[8] = {};
+
+    // The data follows the index, whose size is known beforehand
+    std::uint64_t offset = header_size;
+    for (const Entry &entry : entries) {
+      offset += 8 + padded(entry.name.size()) + entry.hash.size() + 16;
+    }
+
+    file.write(magic, sizeof(magic));
+    write_u64(version);
+    write_u64(entries.size());
+    for (const Entry &entry : entries) {
+      write_u64(entry.name.size());
+      file.write(entry.name.data(), entry.name.size());
+      file.write(padding, padded(entry.name.size()) - entry.name.size());
+      file.write(reinterpret_cast<const char *>(entry.hash.data()),
+                 entry.hash.size());
+      write_u64(offset);
+      write_u64(entry.tabulations.size());
+      for (const Tabulation &t : entry.tabulations) {
+        offset += 32 + t.n_values_ * sizeof(double);
+      }
+    }
+    for (const Entry &entry : entries) {
+      for (const Tabulation &t : entry.tabulations) {
+        const double bounds[3] = {t.x_min_, t.x_max_, t.inv_dx_};
+        file.write(reinterpret_cast<const char *>(bounds), sizeof(bounds));
+        write_u64(t.n_values_);
+        file.write(reinterpret_cast<const char *>(t.values_),
+                   t.n_values_ * sizeof(double));
+      }
+    }
+    if (!file) {
+      throw std::runtime_error("Could not write tabulations to " +
+                               temporary.string());
+    }
+  }
+  std::filesystem::rename(temporary, path);
+}
+
+}  // namespace smash
@@ -1,6 +1,6 @@
 /*
  *
- *    Copyright (c) 2015,2017-2018,2020,2022
+ *    Copyright (c) 2015,2017-2018,2020,2022,2024
  *      SMASH Team
  *
  *    GNU General Public License (GPLv3 or later)
@@ -15,6 +15,8 @@
 
 #include "setup.h"
 #include "smash/decayaction.h"
+#include "smash/particles.h"
+#include "smash/random.h"
 
 using namespace smash;
 
@@ -65,3 +67,100 @@ TEST(construct_and_insert) {
 
   VERIFY(actions.is_empty());
 }
+
+TEST(insert_many) {
+  ParticleData testparticle = Test::smashon(Test::Position{0., 1., .9, 1.});
+  Actions actions;
+  random::set_seed(5);
+  // Few actions into a large heap and many actions into a small heap
+  for (int n : {1, 1000, 2, 3, 5000, 1}) {
+    ActionList new_actions;
+    for (int i = 0; i < n; i++) {
+      new_actions.push_back(std::make_unique<DecayAction>(
+          testparticle, random::uniform(0., 10.)));
+    }
+    actions.insert(std::move(new_actions));
+    VERIFY(actions.earliest_time() >= 0.);
+  }
+  COMPARE(actions.size(), 6007u);
+  double previous = actions.earliest_time();
+  while (!actions.is_empty()) {
+    const double time = actions.pop()->time_of_execution();
+    VERIFY(time >= previous);
+    previous = time;
+  }
+}
+
+TEST(compact) {
+  Particles particles;
+  ActionList action_vec;
+  for (int i = 0; i < 2000; i++) {
+    const ParticleData &p = particles.insert(Test::smashon());
+    action_vec.push_back(std::make_unique<DecayAction>(p, 0.001 * i));
+  }
+  Actions actions;
+  actions.insert(std::move(action_vec));
+  // Particles with even ids decayed
+  for (const ParticleData &p : particles.copy_to_vector()) {
+    if (p.id() % 2 == 0) {
+      particles.remove(p);
+    }
+  }
+  COMPARE(actions.compact(particles), 1000u);
+  COMPARE(actions.size(), 1000u);
+  // Compacted again only after the size doubled
+  COMPARE(actions.compact(particles), 0u);
+  double previous = 0.;
+  while (!actions.is_empty()) {
+    ActionPtr act = actions.pop();
+    VERIFY(act->is_valid(particles));
+    VERIFY(act->time_of_execution() >= previous);
+    previous = act->time_of_execution();
+  }
+}
+
+TEST(equal_times_ordered_by_ids) {
+  Particles particles;
+  for (int i = 0; i < 50; i++) {
+    particles.insert(Test::smashon());
+  }
+  const ParticleList all = particles.copy_to_vector();
+  // However the actions are inserted, they are performed in the same order
+  for (int shift : {0, 17, 33}) {
+    Actions actions;
+    ActionList action_vec;
+    for (int i = 0; i < 50; i++) {
+      action_vec.push_back(
+          std::make_unique<DecayAction>(all[(i + shift) % 50], 1.));
+    }
+    actions.insert(std::move(action_vec));
+    actions.insert(std::make_unique<DecayAction>(all[shift], 0.5));
+    COMPARE(actions.pop()->incoming_particles()[0].id(), all[shift].id());
+    for (int i = 0; i < 50; i++) {
+      COMPARE(actions.pop()->incoming_particles()[0].id(), i);
+    }
+  }
+}
+
+TEST(earliest_in_pop_order) {
+  Particles particles;
+  ActionList action_vec;
+  random::set_seed(7);
+  for (int i = 0; i < 200; i++) {
+    const ParticleData &p = particles.insert(Test::smashon());
+    action_vec.push_back(
+        std::make_unique<DecayAction>(p, random::uniform(0., 10.)));
+  }
+  Actions actions;
+  actions.insert(std::move(action_vec));
+  const std::vector<Action *> earliest = actions.earliest(20, 5.);
+  COMPARE(earliest.size(), 20u);
+  COMPARE(actions.size(), 200u);
+  for (const Action *action : earliest) {
+    COMPARE(actions.pop().get(), action);
+  }
+  // Only the actions until the end time are found
+  for (const Action *action : actions.earliest(1000, 5.)) {
+    VERIFY(action->time_of_execution() <= 5.);
+  }
+}
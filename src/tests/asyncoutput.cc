@@ -0,0 +1,134 @@
+/*
+ *
+ *    Copyright (c) 2024
+ *      SMASH Team
+ *
+ *    GNU General Public License (GPLv3 or later)
+ *
+ */
+
+#include "vir/test.h"  // This include has to be first
+
+#include "smash/asyncoutput.h"
+
+#include <chrono>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "setup.h"
+#include "smash/particles.h"
+#include "smash/wallcrossingaction.h"
+
+using namespace smash;
+
+namespace {
+/// Output which slowly remembers what it was asked to write
+class SlowOutput : public OutputInterface {
+ public:
+  explicit SlowOutput(std::vector<std::string> *log,
+                      std::string name = "Particles")
+      : OutputInterface(name), log_(log) {}
+  void at_eventstart(const Particles &particles, const int event_number,
+                     const EventInfo &) override {
+    wait();
+    log_->push_back("start " + std::to_string(event_number) + " " +
+                    std::to_string(particles.size()));
+  }
+  void at_eventend(const Particles &particles, const int event_number,
+                   const EventInfo &) override {
+    wait();
+    log_->push_back("end " + std::to_string(event_number) + " " +
+                    std::to_string(particles.size()));
+  }
+  void at_interaction(const Action &action, const double) override {
+    wait();
+    if (action.incoming_particles().front().id() < 0) {
+      throw std::runtime_error("invalid particle");
+    }
+    log_->push_back("interaction " +
+                    std::to_string(action.incoming_particles().front().id()));
+  }
+
+ private:
+  /// Take some time, such that the queue fills up.
+  static void wait() {
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+  std::vector<std::string> *log_;
+};
+}  // namespace
+
+TEST(init_particle_types) { Test::create_smashon_particletypes(); }
+
+TEST(keeps_kind) {
+  std::vector<std::string> log;
+  VERIFY(AsyncOutput(std::make_unique<SlowOutput>(&log, "Dileptons"))
+             .is_dilepton_output());
+  VERIFY(AsyncOutput(std::make_unique<SlowOutput>(&log, "Photons"))
+             .is_photon_output());
+  VERIFY(!AsyncOutput(std::make_unique<SlowOutput>(&log)).is_IC_output());
+}
+
+TEST_CATCH(no_capacity, std::invalid_argument) {
+  std::vector<std::string> log;
+  AsyncOutput(std::make_unique<SlowOutput>(&log), 0);
+}
+
+/*
+ * The calls are written in order, even if the caller has to wait for the
+ * writer, and are complete at the end of an event.
+ */
+TEST(written_in_order) {
+  std::vector<std::string> log;
+  std::vector<std::string> expected;
+  AsyncOutput output(std::make_unique<SlowOutput>(&log), 2);
+  for (int event = 0; event < 2; event++) {
+    Particles particles;
+    particles.insert(Test::smashon());
+    particles.insert(Test::smashon());
+    output.at_eventstart(particles, event, Test::default_event_info());
+    expected.push_back("start " + std::to_string(event) + " 2");
+    for (const ParticleData &p : particles) {
+      output.at_interaction(WallcrossingAction(p, p), 0.);
+      expected.push_back("interaction " + std::to_string(p.id()));
+    }
+    // the snapshot is written, not the particles after the call
+    particles.remove(particles.front());
+    output.at_eventend(particles, event, Test::default_event_info());
+    expected.push_back("end " + std::to_string(event) + " 1");
+    COMPARE(log, expected);
+  }
+}
+
+/*
+ * With overlapping events, the end of an event does not wait for its output,
+ * but everything is still written in order.
+ */
+TEST(overlapping_events) {
+  std::vector<std::string> log;
+  std::vector<std::string> expected;
+  AsyncOutput output(std::make_unique<SlowOutput>(&log), 2);
+  output.overlap_events();
+  Particles particles;
+  particles.insert(Test::smashon());
+  for (int event = 0; event < 3; event++) {
+    output.at_eventstart(particles, event, Test::default_event_info());
+    output.at_eventend(particles, event, Test::default_event_info());
+    output.end_event();
+    expected.push_back("start " + std::to_string(event) + " 1");
+    expected.push_back("end " + std::to_string(event) + " 1");
+  }
+  output.flush();
+  COMPARE(log, expected);
+}
+
+/// An exception of the actual output is passed on to the caller.
+TEST_CATCH(passes_on_errors, std::runtime_error) {
+  std::vector<std::string> log;
+  AsyncOutput output(std::make_unique<SlowOutput>(&log));
+  const ParticleData p = Test::smashon();
+  output.at_interaction(WallcrossingAction(p, p), 0.);
+  output.flush();
+}
@@ -17,9 +17,14 @@
 #include <cstring>
 #include <fstream>
 #include <iostream>
+#include <iterator>
 #include <string>
 #include <vector>
 
+#ifdef SMASH_USE_ZLIB
+#include <zlib.h>
+#endif
+
 #include "setup.h"
 #include "smash/clock.h"
 #include "smash/config.h"
@@ -353,6 +358,115 @@ TEST(particles_format) {
   VERIFY(std::filesystem::remove(particleoutputpath));
 }
 
+/*
+ * A particle block larger than the buffer of the output is written in several
+ * parts, which have to fit together seamlessly.
+ */
+TEST(particles_larger_than_buffer) {
+  // about 2 MB of extended particle records
+  const auto particles =
+      Test::create_particles(15000, [] { return Test::smashon_random(); });
+  const int event_id = 0;
+  EventInfo event = Test::default_event_info(1.5, false);
+
+  const std::filesystem::path particleoutputpath =
+      testoutputpath / "particles_binary.bin";
+  {
+    OutputParameters output_par = OutputParameters();
+    output_par.part_extended = true;
+    output_par.part_only_final = OutputOnlyFinal::No;
+    BinaryOutputParticles bin_output(testoutputpath, "Particles", output_par);
+    bin_output.at_eventstart(*particles, event_id, event);
+    bin_output.at_eventend(*particles, event_id, event);
+  }
+
+  {
+    FilePtr binF = fopen(particleoutputpath.native(), "rb");
+    VERIFY(binF.get());
+    std::vector<char> buf(4);
+    std::string smash_version;
+    int format_version_number;
+    COMPARE(std::fread(&buf[0], 1, 4, binF.get()), 4u);
+    read_binary(format_version_number, binF);
+    read_binary(smash_version, binF);
+    for (int block = 0; block < 2; block++) {
+      VERIFY(compare_particles_block_header(particles->size(), binF));
+      for (const ParticleData &p : *particles) {
+        compare_particle_extended(p, binF);
+      }
+    }
+    VERIFY(compare_final_block_header(event_id, 1.5, false, binF));
+    VERIFY(check_end_of_file(binF));
+  }
+
+  VERIFY(std::filesystem::remove(particleoutputpath));
+}
+
+#ifdef SMASH_USE_ZLIB
+/*
+ * A compressed output holds the same data as the uncompressed one, in one gzip
+ * member per event.
+ */
+TEST(compressed_files) {
+  const auto particles =
+      Test::create_particles(100, [] { return Test::smashon_random(); });
+  EventInfo event = Test::default_event_info(2.5, false);
+  OutputParameters output_par = OutputParameters();
+  output_par.part_only_final = OutputOnlyFinal::No;
+  for (const bool compressed : {false, true}) {
+    output_par.compress_files = compressed;
+    BinaryOutputParticles bin_output(testoutputpath, "Particles", output_par);
+    for (int event_id = 0; event_id < 2; event_id++) {
+      bin_output.at_eventstart(*particles, event_id, event);
+      bin_output.at_eventend(*particles, event_id, event);
+    }
+  }
+
+  const std::filesystem::path particleoutputpath =
+      testoutputpath / "particles_binary.bin";
+  std::filesystem::path compressedpath = particleoutputpath;
+  compressedpath += ".gz";
+  std::ifstream file(particleoutputpath, std::ios::binary);
+  const std::string expected{std::istreambuf_iterator<char>(file),
+                             std::istreambuf_iterator<char>()};
+  VERIFY(!expected.empty());
+
+  // the first member ends with the first event
+  std::ifstream compressed_file(compressedpath, std::ios::binary);
+  std::string compressed{std::istreambuf_iterator<char>(compressed_file),
+                         std::istreambuf_iterator<char>()};
+  z_stream stream{};
+  COMPARE(inflateInit2(&stream, 15 + 16), Z_OK);
+  std::vector<char> first_member(expected.size());
+  stream.next_in = reinterpret_cast<Bytef *>(compressed.data());
+  stream.avail_in = compressed.size();
+  stream.next_out = reinterpret_cast<Bytef *>(first_member.data());
+  stream.avail_out = first_member.size();
+  COMPARE(inflate(&stream, Z_FINISH), Z_STREAM_END);
+  first_member.resize(stream.total_out);
+  VERIFY(stream.avail_in > 0);
+  inflateEnd(&stream);
+  const std::size_t header_size = 4 + 2 * sizeof(std::uint16_t) +
+                                  sizeof(std::uint32_t) +
+                                  std::strlen(SMASH_VERSION);
+  const std::size_t event_size = (expected.size() - header_size) / 2;
+  COMPARE(first_member.size(), header_size + event_size);
+
+  // gzip readers continue with the following members
+  gzFile gz = gzopen(compressedpath.c_str(), "rb");
+  VERIFY(gz != nullptr);
+  std::string decompressed(expected.size() + 1, '\0');
+  COMPARE(gzread(gz, decompressed.data(), decompressed.size()),
+          static_cast<int>(expected.size()));
+  gzclose(gz);
+  decompressed.resize(expected.size());
+  VERIFY(decompressed == expected);
+
+  VERIFY(std::filesystem::remove(particleoutputpath));
+  VERIFY(std::filesystem::remove(compressedpath));
+}
+#endif
+
 TEST(extended) {
   /* create two smashon particles */
   Particles particles;
@@ -0,0 +1,98 @@
+/*
+ *
+ *    Copyright (c) 2024
+ *      SMASH Team
+ *
+ *    GNU General Public License (GPLv3 or later)
+ *
+ */
+
+#include "vir/test.h"  // This include has to be first
+
+#include "smash/binaryreader.h"
+
+#include <stdexcept>
+#include <vector>
+
+#include "setup.h"
+#include "smash/binaryoutput.h"
+#include "smash/config.h"
+
+using namespace smash;
+
+static const std::filesystem::path testoutputpath =
+    std::filesystem::absolute(SMASH_TEST_OUTPUT_PATH);
+
+TEST(directory_is_created) {
+  std::filesystem::create_directories(testoutputpath);
+  VERIFY(std::filesystem::exists(testoutputpath));
+}
+
+TEST(init_particletypes) { Test::create_smashon_particletypes(); }
+
+/*
+ * The particles at the start and end of any event are found via the event
+ * index at the end of the file.
+ */
+TEST(particles_of_event) {
+  const std::filesystem::path path = testoutputpath / "particles_binary.bin";
+  const int n_events = 3;
+  std::vector<ParticleList> final_particles;
+  {
+    OutputParameters output_par = OutputParameters();
+    output_par.part_only_final = OutputOnlyFinal::No;
+    output_par.binary_event_index = true;
+    BinaryOutputParticles output(testoutputpath, "Particles", output_par);
+    EventInfo event = Test::default_event_info();
+    for (int event_number = 0; event_number < n_events; event_number++) {
+      const auto particles = Test::create_particles(
+          2 + event_number, [] { return Test::smashon_random(); });
+      output.at_eventstart(*particles, event_number, event);
+      particles->remove(particles->front());
+      output.at_eventend(*particles, event_number, event);
+      final_particles.push_back(particles->copy_to_vector());
+    }
+  }
+
+  BinaryReader reader(path);
+  COMPARE(reader.smash_version(), SMASH_VERSION);
+  VERIFY(!reader.extended());
+  COMPARE(reader.index().size(), 2u * n_events);
+  COMPARE(reader.index()[2].stage, 's');
+  COMPARE(reader.index()[2].event_number, 1);
+  COMPARE(reader.index()[2].n_particles, 3u);
+
+  const BinaryParticleBlock block = reader.particles(1);
+  const ParticleList &expected = final_particles[1];
+  COMPARE(block.size(), expected.size());
+  for (std::size_t i = 0; i < block.size(); i++) {
+    COMPARE(block.pdg(i), expected[i].pdgcode().get_decimal());
+    COMPARE(block.id(i), expected[i].id());
+    COMPARE(block.mass(i), expected[i].effective_mass());
+    for (int mu = 0; mu < 4; mu++) {
+      COMPARE(block.position(i, mu), expected[i].position()[mu]);
+      COMPARE(block.momentum(i, mu), expected[i].momentum()[mu]);
+    }
+  }
+  COMPARE(reader.particles(2, 's').size(), 4u);
+  bool missing_event_found = true;
+  try {
+    reader.particles(n_events);
+  } catch (const std::out_of_range &) {
+    missing_event_found = false;
+  }
+  VERIFY(!missing_event_found);
+
+  VERIFY(std::filesystem::remove(path));
+}
+
+TEST_CATCH(file_without_index, std::runtime_error) {
+  {
+    OutputParameters output_par = OutputParameters();
+    BinaryOutputParticles output(testoutputpath, "Particles", output_par);
+    const auto particles =
+        Test::create_particles(2, [] { return Test::smashon_random(); });
+    output.at_eventend(*particles, 0, Test::default_event_info());
+  }
+  BinaryReader reader(testoutputpath / "particles_binary.bin");
+}
@@ -0,0 +1,86 @@
+/*
+ *
+ *    Copyright (c) 2024
+ *      SMASH Team
+ *
+ *    GNU General Public License (GPLv3 or later)
+ *
+ */
+
+#include "vir/test.h"  // This include has to be first
+
+#include "smash/callbackoutput.h"
+
+#include <cstddef>
+#include <memory>
+#include <stdexcept>
+
+#include "setup.h"
+#include "smash/particles.h"
+#include "smash/scatteraction.h"
+#include "smash/scatteractionsfinderparameters.h"
+
+using namespace smash;
+
+TEST(init_particle_types) { Test::create_smashon_particletypes(); }
+
+TEST_CATCH(no_event_end_function, std::invalid_argument) {
+  CallbackOutput output(nullptr);
+}
+
+TEST(event_end) {
+  Particles particles;
+  particles.insert(Test::smashon_random());
+  particles.insert(Test::smashon_random());
+  particles.insert(Test::smashon_random());
+  particles.remove(particles.front());
+
+  int calls = 0;
+  CallbackOutput output(
+      [&](int event_number, const EventInfo &info, ParticleSpan span) {
+        calls++;
+        COMPARE(event_number, 3);
+        COMPARE(info.impact_parameter, 1.5);
+        COMPARE(span.size(), particles.size());
+        auto it = particles.begin();
+        for (const ParticleData &p : span) {
+          // the particles are not copied
+          COMPARE(&p, &*it);
+          ++it;
+        }
+      });
+  output.at_eventstart(particles, 3, Test::default_event_info(1.5));
+  output.at_eventend(particles, 3, Test::default_event_info(1.5));
+  COMPARE(calls, 1);
+}
+
+TEST(interaction) {
+  Particles particles;
+  const ParticleData p1 = particles.insert(Test::smashon_random());
+  const ParticleData p2 = particles.insert(Test::smashon_random());
+  ScatterActionPtr action = std::make_unique<ScatterAction>(p1, p2, 0.);
+  action->add_all_scatterings(Test::default_finder_parameters());
+  action->generate_final_state();
+
+  int calls = 0;
+  CallbackOutput output(
+      [](int, const EventInfo &, ParticleSpan) {},
+      [&](const Action &a, ParticleSpan incoming, ParticleSpan outgoing) {
+        calls++;
+        COMPARE(&a, action.get());
+        COMPARE(incoming.size(), 2u);
+        COMPARE(&incoming[0], &action->incoming_particles()[0]);
+        COMPARE(&incoming[1], &action->incoming_particles()[1]);
+        COMPARE(outgoing.size(), action->outgoing_particles().size());
+        for (std::size_t i = 0; i < outgoing.size(); i++) {
+          COMPARE(&outgoing[i], &action->outgoing_particles()[i]);
+        }
+      });
+  output.at_interaction(*action, 0.);
+  output.at_interaction(*action, 0.);
+  COMPARE(calls, 2);
+
+  // without an interaction function, the interactions are ignored
+  CallbackOutput event_end_only([](int, const EventInfo &, ParticleSpan) {});
+  event_end_only.at_interaction(*action, 0.);
+}
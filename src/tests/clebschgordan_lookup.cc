@@ -1,6 +1,6 @@
 /*
  *
- *    Copyright (c) 2023
+ *    Copyright (c) 2023-2024
  *      SMASH Team
  *
  *    GNU General Public License (GPLv3 or later)
@@ -11,6 +11,7 @@
 
 #include "smash/clebschgordan_lookup.h"
 
+#include <array>
 #include <vector>
 
 #include "setup.h"
@@ -96,71 +97,56 @@ TEST(coefficient) {
   }
 }
 
-// This help function is used in the commented out part of the tabulate test
-[[maybe_unused]] static std::ostream &operator<<(
-    std::ostream &out, const ClebschGordan::ThreeSpins &v) {
-  out.put('{');
-  out << v.j1 << ", " << v.j2 << ", " << v.j3 << ',' << std::showpos
-      << field<2> << v.m1 << ',' << field<2> << v.m2 << ',' << field<2> << v.m3
-      << std::noshowpos;
-  return out << '}';
-}
-
 /*
- * This test is not really supposed to be a unit test, but rather a way to
- * include somewhere in the codebase the snippet of code that we used to
- * calculate the tabulated Clebsch-Gordan coefficients. By default the (long)
- * list of tabulated coefficients is not printed to the output, but the code to
- * print it is included commented out at the end of this test. Here we use a
- * couple of vectors in order to then print the coefficients ordered w.r.t. to
- * j1, j2, j3, m1, m2, m3, respectively. Note that physics symmetries and
- * properties could be used to reduce the number of iterations, since j1+j2+j3
- * should be even (here all j and m are twice the physical quantity, so even
- * means that its half is integer), m1+m2=m3 (since m3 here enters the CG
- * formula as -m3) and |m3|≤j3. Instead, these properties are used to test the
- * obtained non-zero results.
+ * Here the coefficients are first calculated on the fly, as they are before
+ * the table is filled, and then compared to the table. Note that physics
+ * symmetries and properties could be used to reduce the number of iterations,
+ * since j1+j2+j3 should be even (here all j and m are twice the physical
+ * quantity, so even means that its half is integer), m1+m2=m3 (since m3 here
+ * enters the CG formula as -m3) and |m3|≤j3. Instead, these properties are
+ * used to test the obtained non-zero results.
  */
 TEST(tabulate) {
-  std::vector<ClebschGordan::ThreeSpins> keys{};
+  const int L = 6;
+  std::vector<std::array<int, 6>> keys{};
   std::vector<double> coefficients{};
-  const int L = 3;
-  for (auto l1 = 0; l1 <= L; l1++) {
-    for (auto l2 = 0; l2 <= L; l2++) {
-      for (auto l3 = std::abs(l1 - l2); l3 <= l1 + l2; l3++) {
-        for (auto m1 = -l1; m1 <= l1; m1 += 2) {
-          for (auto m2 = -l2; m2 <= l2; m2 += 2) {
-            for (auto m3 = -l3; m3 <= l3; m3 += 2) {
-              coefficients.push_back(
-                  ClebschGordan::coefficient(l1, l2, l3, m1, m2, m3));
-              if (coefficients.back() != 0.0)
-                keys.push_back({l1, l2, l3, m1, m2, m3});
-              else
-                coefficients.pop_back();
+  auto for_all_spins = [](auto f) {
+    for (auto l1 = 0; l1 <= L; l1++) {
+      for (auto l2 = 0; l2 <= L; l2++) {
+        for (auto l3 = 0; l3 <= L; l3++) {
+          for (auto m1 = -l1; m1 <= l1; m1 += 2) {
+            for (auto m2 = -l2; m2 <= l2; m2 += 2) {
+              for (auto m3 = -l3; m3 <= l3; m3 += 2) {
+                f(std::array<int, 6>{l1, l2, l3, m1, m2, m3});
+              }
             }
           }
         }
       }
     }
-  }
-  for (auto i = 0u; i < keys.size(); i++) {
-    VERIFY((keys[i].j1 + keys[i].j2 + keys[i].j3) % 2 == 0);
-    VERIFY(keys[i].m1 + keys[i].m2 == keys[i].m3);
-  }
-  /*
-   * The printing is left out, in order not to pollute normal runs of tests.
-   * Change the #if 0 to e.g. #if 1 to include this snippet in compilation in
-   * case of need. Printing to standard error facilitates redirection to file,
-   * especially in case L should be increased in the future (it is then easier
-   * to copy from a file than from the terminal).
-   */
-#if 0
-  std::cerr << "\nstd::unordered_map<ThreeSpins, double, "
-               "smash::ThreeSpinHash> CG_coefficients =\n{\n";
-  const auto double_digits = std::numeric_limits<double>::max_digits10;
+  };
+  for_all_spins([&](const std::array<int, 6> &s) {
+    keys.push_back(s);
+    coefficients.push_back(
+        ClebschGordan::coefficient(s[0], s[1], s[2], s[3], s[4], s[5]));
+  });
   for (auto i = 0u; i < keys.size(); i++) {
-    std::cerr << "  {" << keys[i] << ", " << std::setprecision(double_digits)
-              << std::setw(double_digits + 3) << coefficients[i] << "},\n";
+    if (coefficients[i] != 0.0) {
+      VERIFY((keys[i][0] + keys[i][1] + keys[i][2]) % 2 == 0);
+      VERIFY(keys[i][3] + keys[i][4] == keys[i][5]);
+    }
   }
-  std::cerr << "};\n\n";
-#endif
+
+  ClebschGordan::tabulate(L);
+  auto i = 0u;
+  for_all_spins([&](const std::array<int, 6> &s) {
+    COMPARE(ClebschGordan::coefficient(s[0], s[1], s[2], s[3], s[4], s[5]),
+            coefficients[i++]);
+  });
+  // Beyond the table, the coefficients are still calculated
+  FUZZY_COMPARE(ClebschGordan::coefficient(L + 1, 1, L + 2, L + 1, 1, L + 2),
+                1.);
+  // Invalid z-components are not looked up
+  COMPARE(ClebschGordan::coefficient(2, 2, 2, 4, 0, 4), 0.);
+  COMPARE(ClebschGordan::coefficient(2, 2, 2, 1, 1, 2), 0.);
 }
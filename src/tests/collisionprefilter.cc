@@ -0,0 +1,160 @@
+/*
+ *
+ *    Copyright (c) 2024
+ *      SMASH Team
+ *
+ *    GNU General Public License (GPLv3 or later)
+ *
+ */
+
+#include "vir/test.h"  // This include has to be first
+
+#include "smash/collisionprefilter.h"
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+#include "setup.h"
+#include "smash/constants.h"
+#include "smash/random.h"
+#include "smash/scatteractionsfinder.h"
+
+using namespace smash;
+
+TEST(init_particle_types) { Test::create_smashon_particletypes(); }
+
+TEST(select_all_colliding_pairs) {
+  random::set_seed(17);
+  Configuration config{R"(
+    Collision_Term:
+      Elastic_Cross_Section: 30.0)"};
+  const ExperimentParameters parameters = Test::default_parameters();
+  const ScatterActionsFinder finder(config, parameters);
+  const double max_distance_sqr = 30. * fm2_mb * M_1_PI;
+  constexpr double dt = 0.5;
+
+  ParticleList particles;
+  auto position = random::make_uniform_distribution(-2., 2.);
+  auto momentum = random::make_uniform_distribution(-1., 1.);
+  for (int id = 0; id < 200; id++) {
+    ParticleData p = Test::smashon(
+        Test::Position{0.1 * position(), position(), position(), position()},
+        id);
+    p.set_4momentum(Test::smashon_mass, momentum(), momentum(), momentum());
+    particles.push_back(p);
+  }
+  // Frozen Fermi motion for some of the particles
+  const double beam_energy =
+      std::sqrt(Test::smashon_mass * Test::smashon_mass + 1.);
+  const std::vector<FourVector> beam_momentum(
+      50, FourVector(beam_energy, 0., 0., 1.));
+  const auto pointers = particle_pointers(particles);
+  const ParticleSpan span(pointers);
+  KinematicsSnapshot snapshot;
+  snapshot.assign(span, beam_momentum);
+  COMPARE(snapshot.size(), particles.size());
+  CollisionPrefilter prefilter;
+
+  std::size_t colliding = 0, selected = 0;
+  for (std::size_t i = 0; i < particles.size(); i++) {
+    const std::vector<std::size_t> candidates =
+        prefilter.select(snapshot, i, snapshot, dt, max_distance_sqr, true);
+    selected += candidates.size();
+    for (std::size_t j = 0; j < particles.size(); j++) {
+      const ParticleData &a = particles[i], &b = particles[j];
+      if (a.id() >= b.id()) {
+        VERIFY(std::find(candidates.begin(), candidates.end(), j) ==
+               candidates.end());
+        continue;
+      }
+      const double time = finder.collision_time(a, b, dt, beam_momentum);
+      const double distance_sqr =
+          ScatterAction(a, b, time).transverse_distance_sqr();
+      if (std::find(candidates.begin(), candidates.end(), j) !=
+          candidates.end()) {
+        VERIFY(prefilter.min_transverse_distance_sqr(snapshot, j) <=
+               distance_sqr);
+      }
+      if (time >= 0. && time < dt && distance_sqr < max_distance_sqr) {
+        colliding++;
+        VERIFY(std::find(candidates.begin(), candidates.end(), j) !=
+               candidates.end())
+            << "pair " << i << ", " << j << " at time " << time
+            << " with distance^2 " << distance_sqr;
+      }
+    }
+  }
+  // The filter is only worth it, if it rejects most pairs
+  VERIFY(colliding > 0);
+  VERIFY(selected < particles.size() * particles.size() / 20) << selected;
+}
+
+TEST(select_at_thresholds) {
+  // The particles pass each other at a distance of 1 fm after the given time
+  ParticleList particles{
+      Test::smashon(Test::Position{0., -1., 0.5, 0.}, 0),
+      Test::smashon(Test::Position{0., 1., -0.5, 0.}, 1)};
+  particles[0].set_4momentum(Test::smashon_mass, 1., 0., 0.);
+  particles[1].set_4momentum(Test::smashon_mass, -1., 0., 0.);
+  const auto pointers = particle_pointers(particles);
+  KinematicsSnapshot snapshot;
+  snapshot.assign(ParticleSpan(pointers), {});
+  CollisionPrefilter prefilter;
+  const double time =
+      std::sqrt(1. + Test::smashon_mass * Test::smashon_mass);
+  COMPARE(prefilter.select(snapshot, 0, snapshot, 1.01 * time, 1.01).size(),
+          1u);
+  COMPARE(prefilter.select(snapshot, 0, snapshot, 0.99 * time, 1.01).size(),
+          0u);
+  COMPARE(prefilter.select(snapshot, 0, snapshot, 1.01 * time, 0.99).size(),
+          0u);
+  // Only larger ids
+  COMPARE(prefilter.select(snapshot, 1, snapshot, 1.01 * time, 1.01, true)
+              .size(),
+          0u);
+}
+
+TEST(separate_spectators) {
+  // All particles move towards the origin
+  ParticleList particles{
+      Test::smashon(Test::Position{0., -1., 0.1, 0.}, 0),
+      Test::smashon(Test::Position{0., 1., -0.1, 0.}, 1),
+      Test::smashon(Test::Position{0., 0., -1., 0.1}, 2),
+      Test::smashon(Test::Position{0., 0., 1., -0.1}, 3)};
+  particles[0].set_4momentum(Test::smashon_mass, 1., 0., 0.);
+  particles[1].set_4momentum(Test::smashon_mass, -1., 0., 0.);
+  particles[2].set_4momentum(Test::smashon_mass, 0., 1., 0.);
+  particles[3].set_4momentum(Test::smashon_mass, 0., -1., 0.);
+  particles[0].set_belongs_to(BelongsTo::Projectile);
+  particles[1].set_belongs_to(BelongsTo::Projectile);
+  particles[2].set_belongs_to(BelongsTo::Target);
+  // A nucleon of the projectile, which collided already
+  particles[3].set_belongs_to(BelongsTo::Projectile);
+  particles[3].set_history(1, 1, ProcessType::Elastic, 0., {});
+  const auto pointers = particle_pointers(particles);
+  KinematicsSnapshot snapshot;
+  snapshot.assign(ParticleSpan(pointers), {});
+  COMPARE(snapshot.group_begin[KinematicsSnapshot::ProjectileSpectator], 1u);
+  COMPARE(snapshot.group_begin[KinematicsSnapshot::TargetSpectator], 3u);
+  CollisionPrefilter prefilter;
+  constexpr double dt = 10., distance_sqr = 100.;
+
+  using Positions = std::vector<std::size_t>;
+  const Positions all_others = {1, 2, 3};
+  COMPARE(prefilter.select(snapshot, 0, snapshot, dt, distance_sqr),
+          all_others);
+  const Positions other_nucleus = {2, 3};
+  COMPARE(prefilter.select(snapshot, 0, snapshot, dt, distance_sqr, false,
+                           true),
+          other_nucleus);
+  const Positions projectile = {0, 1, 3};
+  COMPARE(prefilter.select(snapshot, 2, snapshot, dt, distance_sqr, false,
+                           true),
+          projectile);
+  // Participants are not separated
+  const Positions spectators = {0, 1, 2};
+  COMPARE(prefilter.select(snapshot, 3, snapshot, dt, distance_sqr, false,
+                           true),
+          spectators);
+}
@@ -0,0 +1,75 @@
+/*
+ *
+ *    Copyright (c) 2024
+ *      SMASH Team
+ *
+ *    GNU General Public License (GPLv3 or later)
+ *
+ */
+
+#include "vir/test.h"  // This include has to be first
+
+#include "smash/collisiontrace.h"
+
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+
+#include "setup.h"
+
+using namespace smash;
+
+static const std::filesystem::path testoutputpath =
+    std::filesystem::absolute(SMASH_TEST_OUTPUT_PATH);
+
+TEST(init_particle_types) { Test::create_smashon_particletypes(); }
+
+TEST(write_and_read) {
+  std::filesystem::create_directories(testoutputpath);
+  const std::filesystem::path path = testoutputpath / "collisions.trace";
+  ParticleData a = Test::smashon(Test::Position{1., 2., 3., 4.},
+                                 Test::Momentum{1.5, 0.1, 0.2, 0.3}, 7);
+  a.set_belongs_to(BelongsTo::Projectile);
+  a.set_slow_formation_times(0.5, 2.5);
+  a.set_cross_section_scaling_factor(0.25);
+  const ParticleData b = Test::smashon(Test::Position{1., -2., 0., 1.},
+                                       Test::Momentum{2., 0., 0., -1.}, 9);
+  {
+    CollisionTrace trace(path, 0.5, true);
+    trace.add_pair(CollisionCriterion::Stochastic, a, b, 0.1, 8., 0.5);
+    trace.add_collision(CollisionCriterion::Stochastic, b, a, 0.03);
+  }
+  const CollisionTraceContent content = read_collision_trace(path);
+  COMPARE(content.formation_power, 0.5);
+  VERIFY(content.use_monash_tune_default);
+  COMPARE(content.records.size(), 2u);
+
+  const CollisionTraceRecord &pair = content.records[0];
+  VERIFY(pair.kind == CollisionTraceRecord::Kind::Pair);
+  VERIFY(pair.criterion == CollisionCriterion::Stochastic);
+  COMPARE(pair.time, 0.1);
+  COMPARE(pair.gcell_vol, 8.);
+  COMPARE(pair.majorant, 0.5);
+  const ParticleData &read_a = pair.incoming[0];
+  COMPARE(read_a.id(), 7);
+  COMPARE(read_a.pdgcode(), a.pdgcode());
+  COMPARE(read_a.position(), a.position());
+  COMPARE(read_a.momentum(), a.momentum());
+  VERIFY(read_a.belongs_to() == BelongsTo::Projectile);
+  COMPARE(read_a.begin_formation_time(), 0.5);
+  COMPARE(read_a.formation_time(), 2.5);
+  COMPARE(read_a.initial_xsec_scaling_factor(), 0.25);
+  COMPARE(pair.incoming[1].id(), 9);
+
+  const CollisionTraceRecord &collision = content.records[1];
+  VERIFY(collision.kind == CollisionTraceRecord::Kind::Collision);
+  COMPARE(collision.time, 0.03);
+  COMPARE(collision.incoming[0].id(), 9);
+  COMPARE(collision.incoming[1].id(), 7);
+}
+
+TEST_CATCH(no_trace, std::runtime_error) {
+  const std::filesystem::path path = testoutputpath / "no.trace";
+  std::ofstream(path) << "This is no trace.";
+  read_collision_trace(path);
+}
@@ -0,0 +1,175 @@
+/*
+ *
+ *    Copyright (c) 2024
+ *      SMASH Team
+ *
+ *    GNU General Public License (GPLv3 or later)
+ *
+ */
+
+#include "vir/test.h"  // This include has to be first
+
+#include "smash/columnaroutput.h"
+
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include "setup.h"
+#include "smash/config.h"
+#include "smash/file.h"
+
+using namespace smash;
+
+static const std::filesystem::path testoutputpath =
+    std::filesystem::absolute(SMASH_TEST_OUTPUT_PATH);
+
+TEST(directory_is_created) {
+  std::filesystem::create_directories(testoutputpath);
+  VERIFY(std::filesystem::exists(testoutputpath));
+}
+
+TEST(init_particletypes) { Test::create_smashon_particletypes(); }
+
+/// Read a value of the given type from the file.
+template <typename T>
+static T read_binary(const FilePtr &file) {
+  T value{};
+  COMPARE(std::fread(&value, sizeof(T), 1, file.get()), 1u);
+  return value;
+}
+
+/// Read a string preceded by its length from the file.
+static std::string read_string(const FilePtr &file) {
+  std::vector<char> buf(read_binary<std::uint32_t>(file));
+  COMPARE(std::fread(buf.data(), 1, buf.size(), file.get()), buf.size());
+  return std::string(buf.begin(), buf.end());
+}
+
+/*
+ * The header lists the columns, and a single column of a chunk can be read
+ * with the help of the index at the end of the file.
+ */
+TEST(read_columns_via_index) {
+  const auto particles =
+      Test::create_particles(3, [] { return Test::smashon_random(); });
+  EventInfo event = Test::default_event_info(2.5, false);
+  const std::filesystem::path columnar_path =
+      testoutputpath / "particles_columnar.bin";
+  {
+    OutputParameters output_par = OutputParameters();
+    output_par.part_extended = true;
+    output_par.part_only_final = OutputOnlyFinal::No;
+    ColumnarOutput output(testoutputpath, "Particles", output_par);
+    output.at_eventstart(*particles, 0, event);
+    DensityParameters dens_par(Test::default_parameters());
+    event.current_time = 1.5;
+    output.at_intermediate_time(*particles, nullptr, dens_par, event);
+    particles->remove(particles->front());
+    event.current_time = 3.;
+    output.at_eventend(*particles, 0, event);
+  }
+  VERIFY(std::filesystem::exists(columnar_path));
+
+  FilePtr file = fopen(columnar_path.native(), "rb");
+  VERIFY(file.get());
+  char magic[4];
+  COMPARE(std::fread(magic, 1, 4, file.get()), 4u);
+  COMPARE(std::string(magic, 4), "SMCL");
+  COMPARE(read_binary<std::uint16_t>(file), ColumnarOutput::format_version);
+  COMPARE(read_string(file), SMASH_VERSION);
+  const std::uint32_t n_columns = read_binary<std::uint32_t>(file);
+  COMPARE(n_columns, 22u);
+  std::vector<std::string> names;
+  std::vector<char> types;
+  for (std::uint32_t i = 0; i < n_columns; i++) {
+    names.push_back(read_string(file));
+    types.push_back(read_binary<char>(file));
+  }
+  COMPARE(names[7], "py");
+  COMPARE(types[7], 'd');
+  COMPARE(names[9], "pdg");
+  COMPARE(types[9], 'i');
+  COMPARE(names.back(), "strangeness");
+
+  // index at the end of the file
+  std::fseek(file.get(), -16, SEEK_END);
+  const std::uint32_t n_chunks = read_binary<std::uint32_t>(file);
+  const std::uint64_t index_offset = read_binary<std::uint64_t>(file);
+  COMPARE(n_chunks, 3u);
+  std::fseek(file.get(), index_offset, SEEK_SET);
+  std::vector<std::uint64_t> offsets;
+  const std::string kinds = "imf";
+  const std::vector<double> times = {0., 1.5, 3.};
+  for (std::uint32_t i = 0; i < n_chunks; i++) {
+    offsets.push_back(read_binary<std::uint64_t>(file));
+    COMPARE(read_binary<char>(file), kinds[i]);
+    COMPARE(read_binary<std::int32_t>(file), 0);
+    COMPARE(read_binary<double>(file), times[i]);
+    COMPARE(read_binary<std::uint32_t>(file), i < 2 ? 3u : 2u);
+  }
+
+  // py and pdg of the final particles
+  const std::uint64_t chunk_header_size = 34;
+  const std::size_t n = particles->size();
+  const std::size_t column_size = n * sizeof(double);
+  std::fseek(file.get(), offsets[2] + chunk_header_size + 7 * column_size,
+             SEEK_SET);
+  for (const ParticleData &p : *particles) {
+    COMPARE(read_binary<double>(file), p.momentum().x2());
+  }
+  std::fseek(file.get(), column_size, SEEK_CUR);
+  for (const ParticleData &p : *particles) {
+    COMPARE(read_binary<std::int32_t>(file), p.pdgcode().get_decimal());
+  }
+
+  VERIFY(std::filesystem::remove(columnar_path));
+}
+
+/*
+ * In single precision, the columns of doubles are written as floats, while
+ * the integers and the chunk headers are unchanged.
+ */
+TEST(single_precision_columns) {
+  const auto particles =
+      Test::create_particles(2, [] { return Test::smashon_random(); });
+  const std::filesystem::path columnar_path =
+      testoutputpath / "particles_columnar.bin";
+  {
+    OutputParameters output_par = OutputParameters();
+    output_par.part_single_precision = true;
+    ColumnarOutput output(testoutputpath, "Particles", output_par);
+    output.at_eventend(*particles, 0, Test::default_event_info(2.5, false));
+  }
+
+  FilePtr file = fopen(columnar_path.native(), "rb");
+  VERIFY(file.get());
+  std::fseek(file.get(), 6, SEEK_SET);
+  read_string(file);
+  const std::uint32_t n_columns = read_binary<std::uint32_t>(file);
+  COMPARE(n_columns, 12u);
+  for (std::uint32_t i = 0; i < n_columns; i++) {
+    read_string(file);
+    COMPARE(read_binary<char>(file), i < 9 ? 'f' : 'i');
+  }
+
+  // px and pdg of the final particles
+  std::fseek(file.get(), -16, SEEK_END);
+  COMPARE(read_binary<std::uint32_t>(file), 1u);
+  std::fseek(file.get(), read_binary<std::uint64_t>(file), SEEK_SET);
+  const std::uint64_t offset = read_binary<std::uint64_t>(file);
+  const std::uint64_t chunk_header_size = 34;
+  const std::size_t column_size = particles->size() * sizeof(float);
+  std::fseek(file.get(), offset + chunk_header_size + 6 * column_size,
+             SEEK_SET);
+  for (const ParticleData &p : *particles) {
+    COMPARE(read_binary<float>(file), static_cast<float>(p.momentum().x1()));
+  }
+  std::fseek(file.get(), 2 * column_size, SEEK_CUR);
+  for (const ParticleData &p : *particles) {
+    COMPARE(read_binary<std::int32_t>(file), p.pdgcode().get_decimal());
+  }
+
+  VERIFY(std::filesystem::remove(columnar_path));
+}
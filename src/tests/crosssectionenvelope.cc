@@ -0,0 +1,112 @@
+/*
+ *
+ *    Copyright (c) 2024
+ *      SMASH Team
+ *
+ *    GNU General Public License (GPLv3 or later)
+ *
+ */
+
+#include "vir/test.h"  // This include has to be first
+
+#include "smash/crosssectionenvelope.h"
+
+#include <cmath>
+#include <limits>
+
+#include "setup.h"
+#include "smash/pdgcode.h"
+#include "smash/random.h"
+#include "smash/scatteraction.h"
+
+using namespace smash;
+
+namespace {
+/// Particles of the given types colliding at the given energy
+std::pair<ParticleData, ParticleData> colliding(PdgCode pdg_a, PdgCode pdg_b,
+                                                double sqrt_s) {
+  ParticleData a{ParticleType::find(pdg_a)}, b{ParticleType::find(pdg_b)};
+  const double p = pCM(sqrt_s, a.pole_mass(), b.pole_mass());
+  a.set_4momentum(a.pole_mass(), 0.3 * p, 0., 0.8 * p);
+  b.set_4momentum(b.pole_mass(), -0.3 * p, 0., -0.8 * p);
+  // Move the pair, the envelope only depends on the invariant mass
+  a.boost_momentum(ThreeVector(0., 0.4, 0.2));
+  b.boost_momentum(ThreeVector(0., 0.4, 0.2));
+  return {a, b};
+}
+
+constexpr double inf = std::numeric_limits<double>::infinity();
+}  // namespace
+
+TEST(init_particle_types) {
+  Test::create_actual_particletypes();
+  Test::create_actual_decaymodes();
+}
+
+TEST(bins_and_applicability) {
+  int evaluations = 0;
+  // A narrow peak at the pole mass of a resonance
+  const double pole = ParticleType::find(pdg::rho_z).mass();
+  CrossSectionEnvelope envelope(
+      [&](const ParticleData &a, const ParticleData &b) {
+        evaluations++;
+        const double sqrt_s = (a.momentum() + b.momentum()).abs();
+        return 10. + 1. / (std::abs(sqrt_s - pole) + 0.001);
+      });
+  const double threshold = 2 * ParticleType::find(pdg::pi_p).mass();
+  const auto at_peak = colliding(pdg::pi_p, pdg::pi_m, pole);
+  const double max_xs =
+      envelope.max_cross_section(at_peak.first, at_peak.second, pole);
+  VERIFY(max_xs >= 1010.);
+  VERIFY(max_xs < CrossSectionEnvelope::safety_factor * 1010. + 1.);
+  // The table is computed once
+  const int evaluated = evaluations;
+  VERIFY(evaluated > static_cast<int>(CrossSectionEnvelope::n_bins));
+  const auto above = colliding(pdg::pi_p, pdg::pi_m, 1.5);
+  VERIFY(envelope.max_cross_section(above.first, above.second, 1.5) < 20.);
+  COMPARE(evaluations, evaluated);
+
+  // Close to the threshold and far above there is no bound
+  const double close = threshold + 0.5 * CrossSectionEnvelope::bin_width;
+  COMPARE(envelope.max_cross_section(above.first, above.second, close), inf);
+  const double far =
+      threshold +
+      (CrossSectionEnvelope::n_bins + 1) * CrossSectionEnvelope::bin_width;
+  COMPARE(envelope.max_cross_section(above.first, above.second, far), inf);
+
+  // Neither for unstable or off-shell particles
+  const auto rho = colliding(pdg::rho_z, pdg::pi_m, 1.5);
+  COMPARE(envelope.max_cross_section(rho.first, rho.second, 1.5), inf);
+  ParticleData off_shell = above.first;
+  off_shell.set_4momentum(1.01 * off_shell.pole_mass(),
+                          off_shell.momentum().threevec());
+  COMPARE(envelope.max_cross_section(off_shell, above.second, 1.5), inf);
+}
+
+TEST(bound_of_total_cross_section) {
+  const ScatterActionsFinderParameters finder_parameters =
+      Test::default_finder_parameters(-1., NNbarTreatment::NoAnnihilation,
+                                      Test::all_reactions_included(), false);
+  auto exact = [&](const ParticleData &a, const ParticleData &b) {
+    ScatterAction act(a, b, 0.);
+    act.add_all_scatterings(finder_parameters);
+    return act.cross_section();
+  };
+  CrossSectionEnvelope envelope(exact);
+  random::set_seed(3);
+  for (const auto &pair :
+       {std::make_pair(pdg::pi_p, pdg::p), std::make_pair(pdg::pi_m, pdg::p),
+        std::make_pair(pdg::p, pdg::n), std::make_pair(pdg::K_m, pdg::p),
+        std::make_pair(pdg::pi_p, pdg::pi_m)}) {
+    const double threshold = ParticleType::find(pair.first).mass() +
+                             ParticleType::find(pair.second).mass();
+    for (int i = 0; i < 200; i++) {
+      const double sqrt_s = threshold + random::uniform(0.03, 4.9);
+      const auto particles = colliding(pair.first, pair.second, sqrt_s);
+      const double xs = exact(particles.first, particles.second);
+      VERIFY(xs <= envelope.max_cross_section(particles.first,
+                                              particles.second, sqrt_s))
+          << pair.first << " " << pair.second << " at " << sqrt_s;
+    }
+  }
+}
@@ -0,0 +1,104 @@
+/*
+ *
+ *    Copyright (c) 2024
+ *      SMASH Team
+ *
+ *    GNU General Public License (GPLv3 or later)
+ *
+ */
+
+#include "vir/test.h"  // This include has to be first
+
+#include "smash/crosssectiontable.h"
+
+#include "setup.h"
+#include "smash/kinematics.h"
+#include "smash/pdgcode.h"
+
+using namespace smash;
+
+namespace {
+/// Particles of the given types colliding at the given energy
+std::pair<ParticleData, ParticleData> colliding(PdgCode pdg_a, PdgCode pdg_b,
+                                                double sqrt_s) {
+  ParticleData a{ParticleType::find(pdg_a)}, b{ParticleType::find(pdg_b)};
+  const double p = pCM(sqrt_s, a.pole_mass(), b.pole_mass());
+  a.set_4momentum(a.pole_mass(), 0.6 * p, 0., 0.8 * p);
+  b.set_4momentum(b.pole_mass(), -0.6 * p, 0., -0.8 * p);
+  return {a, b};
+}
+
+/// Energy above which the inelastic channel of the test opens [GeV]
+constexpr double inelastic_threshold = 1.2001;
+}  // namespace
+
+TEST(init_particle_types) { Test::create_actual_particletypes(); }
+
+TEST(interpolation) {
+  int evaluations = 0;
+  const ParticleType &pi_z = ParticleType::find(pdg::pi_z);
+  // A linear elastic and an inelastic cross section, which opens at 1.2 GeV
+  CrossSectionTable table([&](const ParticleData &a, const ParticleData &b) {
+    evaluations++;
+    const double sqrt_s = (a.momentum() + b.momentum()).abs();
+    CollisionBranchList branches;
+    branches.push_back(std::make_unique<CollisionBranch>(
+        a.type(), b.type(), 10. + 2. * sqrt_s, ProcessType::Elastic));
+    if (sqrt_s > inelastic_threshold) {
+      branches.push_back(std::make_unique<CollisionBranch>(
+          pi_z, pi_z, 5., ProcessType::TwoToTwo));
+    }
+    return branches;
+  });
+
+  const auto pair = colliding(pdg::pi_p, pdg::pi_m, 1.0);
+  const auto branches = table.collision_list(pair.first, pair.second, 1.0);
+  VERIFY(branches.has_value());
+  COMPARE(branches->size(), 1u);
+  FUZZY_COMPARE((*branches)[0]->weight(), 12.);
+  COMPARE((*branches)[0]->get_type(), ProcessType::Elastic);
+  COMPARE(evaluations, 2);
+  // The grid points are kept
+  table.collision_list(pair.first, pair.second, 1.0);
+  COMPARE(evaluations, 2);
+
+  // The inelastic channel is neglected until the next grid point
+  const auto opening = colliding(pdg::pi_p, pdg::pi_m, inelastic_threshold);
+  const auto below = table.collision_list(opening.first, opening.second,
+                                          inelastic_threshold);
+  COMPARE(below->size(), 1u);
+  const double above = inelastic_threshold + CrossSectionTable::grid_spacing;
+  const auto both = table.collision_list(opening.first, opening.second, above);
+  COMPARE(both->size(), 2u);
+  COMPARE((*both)[1]->particle_types().size(), 2u);
+  COMPARE((*both)[1]->particle_types()[0], &pi_z);
+  VERIFY((*both)[1]->weight() > 0.);
+  VERIFY((*both)[1]->weight() <= 5.);
+}
+
+TEST(not_tabulated) {
+  CrossSectionTable table([](const ParticleData &, const ParticleData &) {
+    return CollisionBranchList{};
+  });
+  const double threshold = 2 * ParticleType::find(pdg::pi_p).mass();
+  const auto pair = colliding(pdg::pi_p, pdg::pi_m, 1.0);
+  // Close to the threshold and far above
+  VERIFY(!table.collision_list(
+      pair.first, pair.second,
+      threshold + 0.5 * CrossSectionTable::grid_spacing));
+  VERIFY(!table.collision_list(
+      pair.first, pair.second,
+      threshold +
+          (CrossSectionTable::n_points + 1) * CrossSectionTable::grid_spacing));
+  // Resonances and off-shell particles
+  const auto rho = colliding(pdg::rho_z, pdg::pi_m, 1.5);
+  VERIFY(!table.collision_list(rho.first, rho.second, 1.5));
+  ParticleData off_shell = pair.first;
+  off_shell.set_4momentum(1.01 * off_shell.pole_mass(),
+                          off_shell.momentum().threevec());
+  VERIFY(!table.collision_list(off_shell, pair.second, 1.0));
+  // Tabulated pairs without any branch
+  const auto empty = table.collision_list(pair.first, pair.second, 1.0);
+  VERIFY(empty.has_value());
+  VERIFY(empty->empty());
+}
@@ -1,6 +1,6 @@
 /*
  *
- *    Copyright (c) 2014-2023
+ *    Copyright (c) 2014-2024
  *      SMASH Team
  *
  *    GNU General Public License (GPLv3 or later)
@@ -20,7 +20,9 @@
 #include "smash/experiment.h"
 #include "smash/modusdefault.h"
 #include "smash/nucleus.h"
+#include "smash/random.h"
 #include "smash/thermodynamicoutput.h"
+#include "smash/threadpool.h"
 
 using namespace smash;
 
@@ -179,6 +181,336 @@ TEST(smearing_factor_normalization) {
   COMPARE_RELATIVE_ERROR(int_rho_r_d3r, 1.0, 3.e-6);
 }
 
+TEST(parallel_lattice_update) {
+  // The lattice has to be large enough for several slabs of the smearing range
+  const double L = 30.;
+  const std::array<double, 3> l = {L, L, L};
+  const std::array<int, 3> n = {20, 20, 60};
+  const std::array<double, 3> origin = {0., 0., 0.};
+  Configuration conf{R"(
+    Box:
+      Initial_Condition: "thermal momenta"
+      Temperature: 0.2
+      Start_Time: 0.0
+  )"};
+  conf.set_value({"Box", "Init_Multiplicities", "2212"}, 500);
+  conf.set_value({"Box", "Length"}, L);
+  ExperimentParameters par = smash::Test::default_parameters();
+  par.box_length = L;
+  const DensityParameters dens_par = DensityParameters(par);
+  std::unique_ptr<BoxModus> b =
+      std::make_unique<BoxModus>(std::move(conf), par);
+  std::vector<Particles> ensembles(1);
+  b->initial_conditions(&ensembles[0], par);
+
+  for (const int n_threads : {2, 4}) {
+    ThreadPool pool(n_threads);
+    for (const bool periodicity : {true, false}) {
+      auto serial = std::make_unique<DensityLattice>(
+          l, n, origin, periodicity, LatticeUpdate::EveryTimestep);
+      auto parallel = std::make_unique<DensityLattice>(
+          l, n, origin, periodicity, LatticeUpdate::EveryTimestep);
+      update_lattice(serial.get(), LatticeUpdate::EveryTimestep,
+                     DensityType::Baryon, dens_par, ensembles, false);
+      update_lattice(parallel.get(), LatticeUpdate::EveryTimestep,
+                     DensityType::Baryon, dens_par, ensembles, false, &pool);
+      // The contributions are summed in the same order
+      for (std::size_t i = 0; i < serial->size(); i++) {
+        COMPARE((*parallel)[i].rho(), (*serial)[i].rho())
+            << "threads: " << n_threads << ", periodic: " << periodicity
+            << ", node " << i;
+      }
+    }
+  }
+}
+
+TEST(fused_lattice_update) {
+  const std::array<double, 3> l = {10., 10., 10.};
+  const std::array<int, 3> n = {20, 20, 20};
+  const std::array<double, 3> origin = {0., 0., 0.};
+  Configuration conf{R"(
+    Box:
+      Initial_Condition: "thermal momenta"
+      Temperature: 0.2
+      Start_Time: 0.0
+  )"};
+  conf.set_value({"Box", "Init_Multiplicities", "2212"}, 50);
+  conf.set_value({"Box", "Init_Multiplicities", "2112"}, 50);
+  conf.set_value({"Box", "Length"}, 10.);
+  ExperimentParameters par = smash::Test::default_parameters();
+  par.box_length = 10.;
+  const DensityParameters dens_par = DensityParameters(par);
+  std::unique_ptr<BoxModus> b =
+      std::make_unique<BoxModus>(std::move(conf), par);
+  std::vector<Particles> ensembles(1);
+  b->initial_conditions(&ensembles[0], par);
+  const ParticlesSoA particles(ensembles);
+
+  auto make_lattice = [&]() {
+    return std::make_unique<DensityLattice>(l, n, origin, true,
+                                            LatticeUpdate::EveryTimestep);
+  };
+  auto baryon = make_lattice(), charge = make_lattice();
+  auto fused_baryon = make_lattice(), fused_charge = make_lattice();
+  auto tmn = std::make_unique<RectangularLattice<EnergyMomentumTensor>>(
+      l, n, origin, true, LatticeUpdate::EveryTimestep);
+  auto fused_tmn = std::make_unique<RectangularLattice<EnergyMomentumTensor>>(
+      l, n, origin, true, LatticeUpdate::EveryTimestep);
+  update_lattice(baryon.get(), LatticeUpdate::EveryTimestep,
+                 DensityType::Baryon, dens_par, particles, true);
+  update_lattice(charge.get(), LatticeUpdate::EveryTimestep,
+                 DensityType::Charge, dens_par, particles, true);
+  update_lattice(tmn.get(), LatticeUpdate::EveryTimestep, DensityType::Hadron,
+                 dens_par, particles, true);
+  // Lattices, which do not exist or need no update, are skipped
+  update_lattices(
+      LatticeUpdate::EveryTimestep, dens_par, particles, true, nullptr,
+      DensityTarget<DensityOnLattice>{fused_baryon.get(), DensityType::Baryon},
+      DensityTarget<DensityOnLattice>{nullptr, DensityType::Pion},
+      DensityTarget<DensityOnLattice>{fused_charge.get(), DensityType::Charge},
+      DensityTarget<EnergyMomentumTensor>{fused_tmn.get(),
+                                          DensityType::Hadron});
+
+  // The same weights are added in the same order
+  for (std::size_t i = 0; i < baryon->size(); i++) {
+    COMPARE((*fused_baryon)[i].jmu_net(), (*baryon)[i].jmu_net());
+    COMPARE((*fused_baryon)[i].grad_j0(), (*baryon)[i].grad_j0());
+    COMPARE((*fused_charge)[i].jmu_net(), (*charge)[i].jmu_net());
+    for (int k = 0; k < 10; k++) {
+      COMPARE((*fused_tmn)[i][k], (*tmn)[i][k]);
+    }
+  }
+}
+
+TEST(sparse_lattice_update) {
+  const std::array<double, 3> l = {20., 20., 20.};
+  const std::array<int, 3> n = {40, 40, 40};
+  const std::array<double, 3> origin = {-5., -5., -5.};
+  Configuration conf{R"(
+    Box:
+      Initial_Condition: "thermal momenta"
+      Temperature: 0.2
+      Start_Time: 0.0
+  )"};
+  conf.set_value({"Box", "Init_Multiplicities", "2212"}, 100);
+  conf.set_value({"Box", "Length"}, 4.);
+  ExperimentParameters par = smash::Test::default_parameters();
+  par.box_length = 4.;
+  const DensityParameters dens_par = DensityParameters(par);
+  std::unique_ptr<BoxModus> b =
+      std::make_unique<BoxModus>(std::move(conf), par);
+  std::vector<Particles> ensembles(1);
+  b->initial_conditions(&ensembles[0], par);
+
+  for (const bool periodicity : {true, false}) {
+    auto sparse = std::make_unique<DensityLattice>(
+        l, n, origin, periodicity, LatticeUpdate::EveryTimestep);
+    auto dense = std::make_unique<DensityLattice>(
+        l, n, origin, periodicity, LatticeUpdate::EveryTimestep);
+    sparse->set_sparse(true);
+    update_lattice(sparse.get(), LatticeUpdate::EveryTimestep,
+                   DensityType::Baryon, dens_par, ensembles, true);
+    // Move the particles to the edge, such that periodic lattices wrap
+    for (ParticleData &p : ensembles[0]) {
+      p.set_4position(p.position() + FourVector(0., 10., 0., 0.));
+    }
+    update_lattice(sparse.get(), LatticeUpdate::EveryTimestep,
+                   DensityType::Baryon, dens_par, ensembles, true);
+    update_lattice(dense.get(), LatticeUpdate::EveryTimestep,
+                   DensityType::Baryon, dens_par, ensembles, true);
+    // The nodes of the old positions are cleared
+    for (std::size_t i = 0; i < dense->size(); i++) {
+      COMPARE((*sparse)[i].jmu_net(), (*dense)[i].jmu_net())
+          << "periodic: " << periodicity << ", node " << i;
+      COMPARE((*sparse)[i].grad_j0(), (*dense)[i].grad_j0());
+    }
+    for (ParticleData &p : ensembles[0]) {
+      p.set_4position(p.position() - FourVector(0., 10., 0., 0.));
+    }
+  }
+}
+
+/**
+ * Parameters for the smearing by Fourier transforms, which are the default
+ * ones except for the smearing and finite difference derivatives.
+ */
+static ExperimentParameters fft_smearing_parameters(SmearingMode smearing,
+                                                    bool fft_smearing) {
+  ExperimentParameters def = smash::Test::default_parameters();
+  return ExperimentParameters{std::move(def.labclock),
+                              std::move(def.outputclock),
+                              def.n_ensembles,
+                              def.testparticles,
+                              DerivativesMode::FiniteDifference,
+                              def.rho_derivatives_mode,
+                              def.field_derivatives_mode,
+                              smearing,
+                              def.gaussian_sigma,
+                              def.gauss_cutoff_in_sigma,
+                              def.discrete_weight,
+                              def.triangular_range,
+                              fft_smearing,
+                              def.coll_crit,
+                              def.two_to_one,
+                              def.included_2to2,
+                              def.included_multi,
+                              def.strings_switch,
+                              def.res_lifetime_factor,
+                              def.nnbar_treatment,
+                              def.low_snn_cut,
+                              def.potential_affect_threshold,
+                              def.box_length,
+                              def.maximum_cross_section,
+                              def.fixed_min_cell_length,
+                              def.scale_xs,
+                              def.only_participants,
+                              def.do_weak_decays,
+                              def.decay_initial_particles,
+                              def.use_monash_tune_default};
+}
+
+/**
+ * Protons and antiprotons with random momenta, or at rest, sitting on random
+ * nodes of a lattice, which the deposit onto the nodes does not spread.
+ */
+static std::vector<Particles> particles_on_nodes(
+    const RectangularLattice<DensityOnLattice> &lat, bool at_rest) {
+  std::vector<Particles> ensembles(1);
+  for (int k = 0; k < 60; k++) {
+    ParticleData p = k % 4 == 0 ? create_antiproton() : create_proton();
+    const ThreeVector r = lat.cell_center(
+        random::uniform_int(0, lat.n_cells()[0] - 1),
+        random::uniform_int(0, lat.n_cells()[1] - 1),
+        random::uniform_int(0, lat.n_cells()[2] - 1));
+    p.set_4position(FourVector(0., r));
+    if (at_rest) {
+      p.set_4momentum(p.pole_mass(), 0., 0., 0.);
+    } else {
+      p.set_4momentum(p.pole_mass(), random::uniform(-0.5, 0.5),
+                      random::uniform(-0.5, 0.5), random::uniform(-0.5, 0.5));
+    }
+    ensembles[0].insert(p);
+  }
+  return ensembles;
+}
+
+TEST(fft_smearing_of_particles_on_nodes) {
+  random::set_seed(11);
+  // no node lies at the cut-off distance of the Gaussian from another one
+  const std::array<double, 3> l = {5.5, 4.4, 6.6};
+  const std::array<int, 3> n = {10, 8, 12};
+  const std::array<double, 3> origin = {-2.5, -2., -3.};
+  for (const SmearingMode smearing :
+       {SmearingMode::Triangular, SmearingMode::CovariantGaussian}) {
+    const DensityParameters per_particle(
+        fft_smearing_parameters(smearing, false));
+    const DensityParameters fft(fft_smearing_parameters(smearing, true));
+    for (const bool periodicity : {true, false}) {
+      DensityLattice direct(l, n, origin, periodicity,
+                            LatticeUpdate::EveryTimestep);
+      DensityLattice convolved(l, n, origin, periodicity,
+                               LatticeUpdate::EveryTimestep);
+      // the Gaussian smearing is only the same for particles at rest
+      const std::vector<Particles> ensembles = particles_on_nodes(
+          direct, smearing == SmearingMode::CovariantGaussian);
+      update_lattice(&direct, LatticeUpdate::EveryTimestep,
+                     DensityType::Baryon, per_particle, ensembles, false);
+      update_lattice(&convolved, LatticeUpdate::EveryTimestep,
+                     DensityType::Baryon, fft, ensembles, false);
+      for (std::size_t i = 0; i < direct.size(); i++) {
+        const FourVector diff = convolved[i].jmu_net() - direct[i].jmu_net();
+        for (int mu = 0; mu < 4; mu++) {
+          COMPARE_ABSOLUTE_ERROR(diff[mu], 0., 1.e-12)
+              << "periodic: " << periodicity << ", node " << i;
+        }
+        COMPARE_ABSOLUTE_ERROR(convolved[i].rho(), direct[i].rho(), 1.e-12);
+      }
+    }
+  }
+}
+
+TEST(fft_smearing_conserves_particles) {
+  random::set_seed(12);
+  const std::array<double, 3> l = {5., 4., 6.};
+  const std::array<int, 3> n = {10, 8, 12};
+  const std::array<double, 3> origin = {0., 0., 0.};
+  const DensityParameters fft(
+      fft_smearing_parameters(SmearingMode::Triangular, true));
+  DensityLattice lat(l, n, origin, true, LatticeUpdate::EveryTimestep);
+  std::vector<Particles> ensembles(1);
+  for (int k = 0; k < 100; k++) {
+    ParticleData p = create_proton();
+    // also outside of the periodic lattice
+    p.set_4position(FourVector(0., random::uniform(-5., 10.),
+                               random::uniform(-4., 8.),
+                               random::uniform(-6., 12.)));
+    p.set_4momentum(p.pole_mass(), random::uniform(-1., 1.),
+                    random::uniform(-1., 1.), random::uniform(-1., 1.));
+    ensembles[0].insert(p);
+  }
+  update_lattice(&lat, LatticeUpdate::EveryTimestep, DensityType::Baryon, fft,
+                 ensembles, false);
+  double n_baryons = 0.;
+  for (DensityOnLattice &node : lat) {
+    n_baryons += node.jmu_net().x0() * lat.cell_sizes()[0] *
+                 lat.cell_sizes()[1] * lat.cell_sizes()[2];
+  }
+  COMPARE_RELATIVE_ERROR(n_baryons, 100., 1.e-12);
+}
+
+TEST(fft_smearing_gradients) {
+  random::set_seed(13);
+  const std::array<double, 3> l = {5., 4., 6.};
+  const std::array<int, 3> n = {10, 8, 12};
+  const std::array<double, 3> origin = {-2.5, -2., -3.};
+  const double time_step = 0.1;
+  const DensityParameters per_particle(
+      fft_smearing_parameters(SmearingMode::Triangular, false));
+  const DensityParameters fft(
+      fft_smearing_parameters(SmearingMode::Triangular, true));
+  for (const bool periodicity : {true, false}) {
+    DensityLattice direct(l, n, origin, periodicity,
+                          LatticeUpdate::EveryTimestep);
+    DensityLattice convolved(l, n, origin, periodicity,
+                             LatticeUpdate::EveryTimestep);
+    RectangularLattice<FourVector> old_jmu(l, n, origin, periodicity,
+                                           LatticeUpdate::EveryTimestep);
+    RectangularLattice<FourVector> new_jmu(l, n, origin, periodicity,
+                                           LatticeUpdate::EveryTimestep);
+    RectangularLattice<std::array<FourVector, 4>> four_grad(
+        l, n, origin, periodicity, LatticeUpdate::EveryTimestep);
+    const std::vector<Particles> ensembles = particles_on_nodes(direct, false);
+    update_lattice(&direct, &old_jmu, &new_jmu, &four_grad,
+                   LatticeUpdate::EveryTimestep, DensityType::Baryon,
+                   per_particle, ensembles, time_step, true);
+    update_lattice(&convolved, &old_jmu, &new_jmu, &four_grad,
+                   LatticeUpdate::EveryTimestep, DensityType::Baryon, fft,
+                   ensembles, time_step, true);
+    for (int iz = 0; iz < n[2]; iz++) {
+      for (int iy = 0; iy < n[1]; iy++) {
+        for (int ix = 0; ix < n[0]; ix++) {
+          // the finite differences are one-sided on non-periodic boundaries
+          const bool boundary = ix == 0 || ix == n[0] - 1 || iy == 0 ||
+                                iy == n[1] - 1 || iz == 0 || iz == n[2] - 1;
+          if (!periodicity && boundary) {
+            continue;
+          }
+          const int i = direct.index1d(ix, iy, iz);
+          const std::array<FourVector, 4> expected = direct[i].djmu_dxnu();
+          const std::array<FourVector, 4> computed = convolved[i].djmu_dxnu();
+          for (int nu = 0; nu < 4; nu++) {
+            for (int mu = 0; mu < 4; mu++) {
+              COMPARE_ABSOLUTE_ERROR(computed[nu][mu], expected[nu][mu],
+                                     1.e-10)
+                  << "periodic: " << periodicity << ", node " << i;
+            }
+          }
+        }
+      }
+    }
+  }
+}
+
 TEST(smearing_factor_rcut_correction) {
   FUZZY_COMPARE(smearing_factor_rcut_correction(3.0), 0.97070911346511177);
   FUZZY_COMPARE(smearing_factor_rcut_correction(4.0), 0.99886601571021467);
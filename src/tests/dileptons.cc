@@ -1,5 +1,5 @@
 /*
- *    Copyright (c) 2016-2020,2022
+ *    Copyright (c) 2016-2020,2022,2024
  *      SMASH Team
  *
  *    GNU General Public License (GPLv3 or later)
@@ -9,6 +9,8 @@
 
 #include "setup.h"
 #include "smash/decayactiondilepton.h"
+#include "smash/decayactionsfinderdilepton.h"
+#include "smash/particles.h"
 
 using namespace smash;
 
@@ -108,3 +110,25 @@ TEST(eta_decay) {
   // (to an accuracy of five percent)
   COMPARE_RELATIVE_ERROR(weight_sum / N_samples, 0.0069, 0.05);
 }
+
+TEST(final_shining) {
+  // two π⁰, three π⁺ and one η at rest
+  Particles particles;
+  particles.create(2, 0x111);
+  particles.create(3, 0x211);
+  particles.create(1, 0x221);
+  for (ParticleData &p : particles) {
+    p.set_4momentum(p.pole_mass(), ThreeVector(0., 0., 0.));
+  }
+  const DecayActionsFinderDilepton finder;
+  // only the Dalitz decays of the π⁰ and the η are found
+  const ActionList actions = finder.final_shining_actions(particles);
+  COMPARE(actions.size(), 3u);
+  for (const ActionPtr &act : actions) {
+    VERIFY(act->incoming_particles()[0].pdgcode() != 0x211);
+    COMPARE(act->outgoing_particles().size(), 3u);
+    VERIFY(act->get_total_weight() > 0.);
+  }
+  // the stable particles do not shine during the evolution
+  COMPARE(finder.shining_actions(particles, 1.).size(), 0u);
+}
@@ -0,0 +1,88 @@
+/*
+ *
+ *    Copyright (c) 2024
+ *      SMASH Team
+ *
+ *    GNU General Public License (GPLv3 or later)
+ *
+ */
+
+#include "vir/test.h"  // This include has to be first
+
+#include "smash/emfieldsolver.h"
+
+#include "setup.h"
+#include "smash/potentials.h"
+#include "smash/random.h"
+
+using namespace smash;
+
+TEST(init_particle_types) {
+  ParticleType::create_type_list(
+      "# NAME MASS[GEV] WIDTH[GEV] PARITY PDG\n"
+      "N+ 0.938 0.0 + 2212\n"
+      "π⁺ 0.138 0.0 -  211\n"
+      "π⁻ 0.138 0.0 - -211\n");
+}
+
+/**
+ * Fill a lattice with the currents of moving charges in every node and
+ * compare the fields from the Fourier transforms with the ones from
+ * integrating over the cube around every node.
+ */
+static void compare_with_integration(bool periodic, double r_cut) {
+  random::set_seed(3);
+  const std::array<int, 3> n = {7, 5, 6};
+  RectangularLattice<DensityOnLattice> jmu_el(
+      {7., 6., 4.8}, n, {-3., -2., -2.}, periodic,
+      LatticeUpdate::EveryTimestep);
+  ForceLattice em_lat(jmu_el.lattice_sizes(), n, jmu_el.origin(), periodic,
+                      LatticeUpdate::EveryTimestep);
+  // the fields may be stored in single precision, see LatticePrecision
+  constexpr double tolerance =
+      std::is_same_v<ForceLattice::stored_type,
+                     std::pair<ThreeVector, ThreeVector>>
+          ? 1.e-10
+          : 1.e-5;
+  for (DensityOnLattice &node : jmu_el) {
+    for (const PdgCode pdg : {0x2212, 0x211, -0x211}) {
+      ParticleData p{ParticleType::find(pdg)};
+      p.set_4momentum(p.pole_mass(), random::uniform(-1., 1.),
+                      random::uniform(-1., 1.), random::uniform(-1., 1.));
+      node.add_particle(p, random::uniform(0., 1.) * pdg.charge());
+    }
+  }
+
+  EMFieldSolver solver(jmu_el, r_cut);
+  solver.compute(jmu_el, em_lat);
+  for (std::size_t i = 0; i < jmu_el.size(); i++) {
+    const ThreeVector position = jmu_el.cell_center(i);
+    ThreeVector electric_field = {0., 0., 0.};
+    jmu_el.integrate_volume(electric_field, Potentials::E_field_integrand,
+                            r_cut, position);
+    ThreeVector magnetic_field = {0., 0., 0.};
+    jmu_el.integrate_volume(magnetic_field, Potentials::B_field_integrand,
+                            r_cut, position);
+    const std::pair<ThreeVector, ThreeVector> fields = em_lat.get(i);
+    for (int k = 0; k < 3; k++) {
+      COMPARE_ABSOLUTE_ERROR(fields.first[k], electric_field[k], tolerance)
+          << "periodic " << periodic << ", r_cut " << r_cut << ", node " << i;
+      COMPARE_ABSOLUTE_ERROR(fields.second[k], magnetic_field[k], tolerance)
+          << "periodic " << periodic << ", r_cut " << r_cut << ", node " << i;
+    }
+  }
+}
+
+TEST(fields_non_periodic) {
+  // integration cubes within the lattice, on the cell boundary and beyond it
+  for (const double r_cut : {1.3, 2.0, 9.0}) {
+    compare_with_integration(false, r_cut);
+  }
+}
+
+TEST(fields_periodic) {
+  // the integration cube of 9 fm wraps around the lattice
+  for (const double r_cut : {1.3, 2.0, 9.0}) {
+    compare_with_integration(true, r_cut);
+  }
+}
@@ -106,6 +106,20 @@ TEST(add_particle) {
   }
 }
 
+TEST(add_weighted) {
+  using se = smash::EnergyMomentumTensor;
+  EnergyMomentumTensor T;
+  const FourVector p = FourVector(1.0, 0.1, 0.2, 0.3);
+  const se::tmn_type contribution = se::particle_contribution(p);
+  T.add_weighted(contribution, 0.5);
+  T.add_weighted(contribution, 1.5);
+  for (std::int8_t i = 0; i < 4; i++) {
+    for (std::int8_t j = 0; j < 4; j++) {
+      FUZZY_COMPARE(T[se::tmn_index(i, j)], 2. * p[i] * p[j] / p[0]);
+    }
+  }
+}
+
 TEST(Landau_frame) {
   const FourVector p1 = FourVector(1.0, 0.1, 0.2, 0.3);
   EnergyMomentumTensor T1, T3;
@@ -0,0 +1,75 @@
+/*
+ *
+ *    Copyright (c) 2024
+ *      SMASH Team
+ *
+ *    GNU General Public License (GPLv3 or later)
+ *
+ */
+
+#include "vir/test.h"  // This include has to be first
+
+#include "smash/equilibrationmonitor.h"
+
+#include <cmath>
+#include <stdexcept>
+#include <vector>
+
+#include "setup.h"
+
+using namespace smash;
+
+namespace {
+/// One ensemble of \p n smashons with momentum \p p along x
+std::vector<Particles> smashons(int n, double p) {
+  const double m = Test::smashon_mass;
+  std::vector<Particles> ensembles(1);
+  for (int i = 0; i < n; i++) {
+    ensembles[0].insert(
+        Test::smashon(Test::Momentum{std::sqrt(m * m + p * p), p, 0., 0.}));
+  }
+  return ensembles;
+}
+}  // namespace
+
+TEST(init_particle_types) { Test::create_smashon_particletypes(); }
+
+TEST(stationary) {
+  EquilibrationMonitor monitor({4., 0.1, 0.});
+  const std::vector<Particles> ensembles = smashons(20, 0.5);
+  for (int t = 0; t < 4; t++) {
+    VERIFY(!monitor.add(t, ensembles));
+  }
+  VERIFY(monitor.add(4., ensembles));
+  VERIFY(monitor.add(5., ensembles));
+  // A new event needs a full window again
+  monitor.reset();
+  VERIFY(!monitor.add(6., ensembles));
+}
+
+TEST(drifting) {
+  EquilibrationMonitor monitor({4., 0.1, 0.});
+  for (int t = 0; t <= 10; t++) {
+    VERIFY(!monitor.add(t, smashons(20, 0.5 + 0.1 * t)));
+  }
+  for (int t = 0; t <= 10; t++) {
+    VERIFY(!monitor.add(11. + t, smashons(20 + 2 * t, 0.5)));
+  }
+}
+
+TEST(rare_species_are_ignored) {
+  EquilibrationMonitor monitor({4., 0.1, 0.});
+  bool stationary = false;
+  for (int t = 0; t <= 4; t++) {
+    stationary = monitor.add(t, smashons(2 + t, 0.5 + 0.1 * t));
+  }
+  VERIFY(stationary);
+}
+
+TEST_CATCH(no_window, std::invalid_argument) {
+  EquilibrationMonitor monitor({0., 0.1, 0.});
+}
+
+TEST_CATCH(negative_measurement_time, std::invalid_argument) {
+  EquilibrationMonitor monitor({10., 0.1, -1.});
+}
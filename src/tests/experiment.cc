@@ -193,6 +193,39 @@ TEST(add_and_remove_particles) {
   VERIFY(exp->first_ensemble()->size() == 1);
 }
 
+TEST(remove_many_particles) {
+  auto config = get_collider_configuration();
+  auto exp = std::make_unique<Experiment<ColliderModus>>(config, ".");
+  ParticleList pions;
+  for (int i = 0; i < 100; i++) {
+    ParticleData pion{ParticleType::find(pdg::pi_p)};
+    // Pairs of pions with the same energy, far apart from each other
+    pion.set_4momentum(pion.pole_mass(), 0.01 * (i / 2), 0.0, 0.0);
+    pion.set_4position(FourVector(0.0, 0.0, 5.0 * i, 0.0));
+    pions.push_back(pion);
+  }
+  exp->run_time_evolution(1., std::move(pions), ParticleList{});
+  COMPARE(exp->first_ensemble()->size(), 100u);
+
+  /* Remove two of every three particles, the valid copies by their slots and
+   * the others by their momenta and positions. */
+  ParticleList to_remove;
+  int i = 0;
+  for (const ParticleData &p : *exp->first_ensemble()) {
+    if (i % 3 == 0) {
+      to_remove.push_back(p);
+    } else if (i % 3 == 1) {
+      ParticleData copy{p.type()};
+      copy.set_4momentum(p.momentum());
+      copy.set_4position(p.position());
+      to_remove.push_back(copy);
+    }
+    i++;
+  }
+  exp->run_time_evolution(1., ParticleList{}, std::move(to_remove));
+  COMPARE(exp->first_ensemble()->size(), 33u);
+}
+
 TEST_CATCH(remove_particle_twice, std::logic_error) {
   // Set up collider experiment without setting up initial state (no Au-Au)
   auto config = get_collider_configuration();
@@ -207,3 +240,38 @@ TEST_CATCH(remove_particle_twice, std::logic_error) {
   // Try to remove the eta twice
   exp->run_time_evolution(1., ParticleList{}, ParticleList{eta, eta});
 }
+
+TEST_CATCH(freeze_out_in_box, std::invalid_argument) {
+  auto config = get_common_configuration();
+  config.set_value({"General", "Modus"}, "Box");
+  config.set_value({"General", "Freeze_Out_Window"}, 1.0);
+  config.merge_yaml(R"(
+    Modi:
+      Box:
+        Initial_Condition: "peaked momenta"
+        Length: 10.0
+        Temperature: 0.2
+        Start_Time: 0.0
+        Init_Multiplicities:
+          661: 724
+  )");
+  Test::experiment(std::move(config));
+}
+
+TEST(freeze_out) {
+  auto config = get_collider_configuration();
+  config.set_value({"General", "Freeze_Out_Window"}, 1.0);
+  auto exp = std::make_unique<Experiment<ColliderModus>>(config, ".");
+  // Two pions colliding head-on, which stream freely afterwards
+  ParticleData pion_a{ParticleType::find(pdg::pi_p)};
+  ParticleData pion_b{ParticleType::find(pdg::pi_p)};
+  pion_a.set_4momentum(pion_a.pole_mass(), 0.5, 0.0, 0.0);
+  pion_a.set_4position(FourVector(0.0, -1.0, 0.0, 0.0));
+  pion_b.set_4momentum(pion_b.pole_mass(), -0.5, 0.0, 0.0);
+  pion_b.set_4position(FourVector(0.0, 1.0, 0.0, 0.0));
+  exp->run_time_evolution(20., ParticleList{pion_a, pion_b}, ParticleList{});
+  COMPARE(exp->first_ensemble()->size(), 2u);
+  for (const ParticleData& p : *exp->first_ensemble()) {
+    COMPARE_ABSOLUTE_ERROR(p.position().x0(), 20., very_small_double);
+  }
+}
@@ -0,0 +1,200 @@
+/*
+ *
+ *    Copyright (c) 2024
+ *      SMASH Team
+ *
+ *    GNU General Public License (GPLv3 or later)
+ *
+ */
+
+#include "vir/test.h"  // This include has to be first
+
+#include "smash/frozenspectators.h"
+
+#include <cmath>
+
+#include "setup.h"
+#include "smash/grid.h"
+#include "smash/particles.h"
+
+using namespace smash;
+
+// Stable, such that the particles of separated nuclei cannot decay
+TEST(init_particle_types) { Test::create_stable_smashon_particletypes(); }
+
+/// Create a particle at the given z coordinate belonging to \p label.
+static ParticleData nucleon(double z, BelongsTo label) {
+  ParticleData p = Test::smashon(Test::Position{0., 0., 0., z});
+  p.set_belongs_to(label);
+  return p;
+}
+
+/*
+ * Two nuclei far apart are frozen completely. Their spectators are released
+ * when a particle, which already interacted, comes into reach.
+ */
+TEST(freeze_distant_nuclei) {
+  Test::ParticlesPtr particles = Test::create_particles(
+      {nucleon(-12., BelongsTo::Projectile),
+       nucleon(-10., BelongsTo::Projectile), nucleon(10., BelongsTo::Target),
+       nucleon(12., BelongsTo::Target)});
+  FrozenSpectators frozen(false);
+  frozen.update(*particles, 3.);
+  COMPARE(frozen.n_frozen(), 4);
+  for (const ParticleData &p : *particles) {
+    VERIFY(frozen.is_frozen(p));
+  }
+
+  // the nuclei approach each other
+  frozen.update(*particles, 20.5);
+  COMPARE(frozen.n_frozen(), 2);
+  for (const ParticleData &p : *particles) {
+    VERIFY(frozen.is_frozen(p) == (std::abs(p.position().x3()) > 11.)) << p;
+  }
+
+  // a produced particle releases the spectators close to it
+  ParticleData produced = Test::smashon(Test::Position{0., 0., 0., -9.5});
+  const ParticleData &inserted = particles->insert(produced);
+  frozen.update(*particles, 3.);
+  COMPARE(frozen.n_frozen(), 2);
+  VERIFY(!frozen.is_frozen(inserted));
+  for (const ParticleData &p : *particles) {
+    VERIFY(frozen.is_frozen(p) == (p.position().x3() > 0.)) << p;
+  }
+}
+
+/*
+ * Nucleons which collided already are no spectators, and spectators of the
+ * same nucleus are possible partners, if they are allowed to collide.
+ */
+TEST(partners) {
+  Test::ParticlesPtr particles = Test::create_particles(
+      {nucleon(-10., BelongsTo::Projectile), nucleon(10., BelongsTo::Target)});
+  ParticleData collided = nucleon(13., BelongsTo::Target);
+  collided.set_history(1, 1, ProcessType::Elastic, 0., {});
+  particles->insert(collided);
+  FrozenSpectators frozen(false);
+  frozen.update(*particles, 5.);
+  COMPARE(frozen.n_frozen(), 1);
+  for (const ParticleData &p : *particles) {
+    VERIFY(frozen.is_frozen(p) == (p.belongs_to() == BelongsTo::Projectile));
+  }
+
+  FrozenSpectators within_nucleus(true);
+  within_nucleus.update(*particles, 5.);
+  COMPARE(within_nucleus.n_frozen(), 0);
+}
+
+/// Frozen spectators are left out of the cells of the grid.
+TEST(skip_on_grid) {
+  Test::ParticlesPtr particles = Test::create_particles(
+      {nucleon(-10., BelongsTo::Projectile), nucleon(10., BelongsTo::Target),
+       Test::smashon(Test::Position{0., 0., 0., 9.})});
+  FrozenSpectators frozen(false);
+  frozen.update(*particles, 3.);
+  COMPARE(frozen.n_frozen(), 1);
+  Grid<GridOptions::Normal> grid(*particles, 1., 1.,
+                                 CellNumberLimitation::None);
+  const bool updated = grid.update(
+      *particles, 1., 1.,
+      [&frozen](const ParticleData &p) { return frozen.is_frozen(p); });
+  VERIFY(updated);
+  int n_on_grid = 0;
+  grid.iterate_cells(
+      [&](const ParticleSpan &search) {
+        for (const ParticleData &p : search) {
+          VERIFY(!frozen.is_frozen(p));
+          n_on_grid++;
+        }
+      },
+      [](const ParticleSpan &, const ParticleSpan &) {});
+  COMPARE(n_on_grid, 2);
+}
+
+/// Create a particle at the given position, which last interacted at \p t.
+static ParticleData interacted(double x, double z, double t) {
+  ParticleData p = Test::smashon(Test::Position{t, x, 0., z});
+  p.set_history(1, 1, ProcessType::Elastic, t, {});
+  return p;
+}
+
+/*
+ * Particles far from the core of recently interacting particles escaped,
+ * unless another particle is close to them.
+ */
+TEST(escaped_particles) {
+  Test::ParticlesPtr particles = Test::create_particles(
+      {interacted(0., 0., 5.), interacted(0., 1., 5.), interacted(10., 0., 1.),
+       interacted(-10., 0., 1.), interacted(-10.5, 0., 1.),
+       interacted(0., 3., 1.)});
+  EscapedParticles escaped;
+  escaped.update(*particles, 3., 4.);
+  COMPARE(escaped.n_escaped(), 1);
+  for (const ParticleData &p : *particles) {
+    VERIFY(escaped.is_escaped(p) == (p.position().x1() > 5.)) << p;
+  }
+  COMPARE(escaped.particles()[0].position().x1(), 10.);
+
+  // Without a core, only the distance to the other particles counts
+  escaped.update(*particles, 3., 6.);
+  COMPARE(escaped.n_escaped(), 1);
+  escaped.update(*particles, 11., 6.);
+  COMPARE(escaped.n_escaped(), 0);
+}
+
+/*
+ * Nuclei which passed or missed each other cannot interact anymore, unless a
+ * particle of the trailing nucleus is faster or a particle interacted.
+ */
+TEST(separated_nuclei) {
+  auto moving = [](double x, double z, double vz, BelongsTo label) {
+    const double m = Test::smashon_mass;
+    const double gamma = 1. / std::sqrt(1. - vz * vz);
+    ParticleData p =
+        Test::smashon(Test::Position{0., x, 0., z},
+                      Test::Momentum{gamma * m, 0., 0., gamma * vz * m});
+    p.set_belongs_to(label);
+    return p;
+  };
+  const std::vector<FourVector> no_beam_momentum;
+
+  // approaching along the beam
+  Test::ParticlesPtr particles =
+      Test::create_particles({moving(0., -5., 0.5, BelongsTo::Projectile),
+                              moving(0., 5., -0.5, BelongsTo::Target)});
+  VERIFY(!nuclei_separate_without_interaction(*particles, 2., false,
+                                              no_beam_momentum));
+  // passed each other
+  particles = Test::create_particles(
+      {moving(0., 5., 0.5, BelongsTo::Projectile),
+       moving(0., 3., 0.4, BelongsTo::Projectile),
+       moving(0., -5., -0.5, BelongsTo::Target)});
+  VERIFY(nuclei_separate_without_interaction(*particles, 2., false,
+                                             no_beam_momentum));
+  VERIFY(!nuclei_separate_without_interaction(*particles, 10., false,
+                                              no_beam_momentum));
+  VERIFY(!nuclei_separate_without_interaction(*particles, 2., true,
+                                              no_beam_momentum));
+  // a particle of the trailing nucleus catches up
+  particles->insert(moving(0., -4., 0.6, BelongsTo::Target));
+  VERIFY(!nuclei_separate_without_interaction(*particles, 2., false,
+                                              no_beam_momentum));
+  // unless the nucleons move with the beam momenta
+  const std::vector<FourVector> beam_momentum(
+      4, FourVector(Test::smashon_mass, 0., 0., 0.));
+  VERIFY(nuclei_separate_without_interaction(*particles, 2., false,
+                                             beam_momentum));
+
+  // missing each other at a large impact parameter
+  particles = Test::create_particles(
+      {moving(-8., -5., 0.5, BelongsTo::Projectile),
+       moving(8., 5., -0.5, BelongsTo::Target)});
+  VERIFY(nuclei_separate_without_interaction(*particles, 2., false,
+                                             no_beam_momentum));
+  // but not after an interaction
+  ParticleData collided = moving(8., 4., -0.5, BelongsTo::Target);
+  collided.set_history(1, 1, ProcessType::Elastic, 0., {});
+  particles->insert(collided);
+  VERIFY(!nuclei_separate_without_interaction(*particles, 2., false,
+                                              no_beam_momentum));
+}
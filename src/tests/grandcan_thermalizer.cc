@@ -1,6 +1,6 @@
 /*
  *
- *    Copyright (c) 2016-2020,2022-2023
+ *    Copyright (c) 2016-2020,2022-2024
  *      SMASH Team
  *
  *    GNU General Public License (GPLv3 or later)
@@ -14,6 +14,7 @@
 #include "smash/boxmodus.h"
 #include "smash/logging.h"
 #include "smash/thermalizationaction.h"
+#include "smash/threadpool.h"
 
 using namespace smash;
 
@@ -86,10 +87,49 @@ TEST(rest_frame_transformation) {
       node.nq(), eos.net_charge_density(T, mub, mus, muq) * gamma, tolerance);
 }
 
+// Computing many nodes at once gives the same result as one by one.
+TEST(batch_rest_frame_quantities) {
+  Particles P;
+  ExperimentParameters par = smash::Test::default_parameters();
+  par.box_length = 10.0;
+  BoxModus b = create_box_for_tests(par);
+  b.initial_conditions(&P, par);
+
+  // Nodes with different subsets of the particles
+  std::vector<ThermLatticeNode> single(6), batch;
+  int i = 0;
+  for (const auto& part : P) {
+    for (std::size_t k = 0; k < single.size(); k++) {
+      if (i % (k + 1) == 0) {
+        single[k].add_particle(part, 0.01);
+      }
+    }
+    i++;
+  }
+  batch = single;
+
+  HadronGasEos eos = HadronGasEos(false, false);
+  std::vector<ThermLatticeNode*> nodes;
+  for (std::size_t k = 0; k < single.size(); k++) {
+    single[k].compute_rest_frame_quantities(eos);
+    nodes.push_back(&batch[k]);
+  }
+  ThreadPool pool(3);
+  ThermLatticeNode::compute_rest_frame_quantities(nodes, eos, &pool);
+  for (std::size_t k = 0; k < single.size(); k++) {
+    FUZZY_COMPARE(batch[k].T(), single[k].T());
+    FUZZY_COMPARE(batch[k].mub(), single[k].mub());
+    FUZZY_COMPARE(batch[k].mus(), single[k].mus());
+    FUZZY_COMPARE(batch[k].muq(), single[k].muq());
+    FUZZY_COMPARE(batch[k].p(), single[k].p());
+    FUZZY_COMPARE(batch[k].e(), single[k].e());
+  }
+}
+
 // Disabled because runtime exceeds maximum test runtime.
 // It can however be executed if the hadron gas EoS table is pre-compiled. To do
 // so, run SMASH once enabling the grandcanonical thermalizer (instructions can
-// be found in the user guide). This produces the file 'hadrongas_eos.dat' in
+// be found in the user guide). This produces the file 'hadgas_eos.bin' in
 // the build directory. From now on, the EoS is read from this specific file
 // whenever the thermalizer is used. You can execute all tests normally,
 // including the `thermalization_action` test below, once the hadron gas file
@@ -1,6 +1,6 @@
 /*
  *
- *    Copyright (c) 2015,2017-2022
+ *    Copyright (c) 2015,2017-2022,2024
  *      SMASH Team
  *
  *    GNU General Public License (GPLv3 or later)
@@ -11,6 +11,8 @@
 
 #include "smash/grid.h"
 
+#include <algorithm>
+#include <map>
 #include <set>
 #include <unordered_set>
 
@@ -158,7 +160,7 @@ TEST(grid_construction) {
       auto idsIt = param.ids.begin();
       auto neighbors = param.neighbors;
       grid.iterate_cells(
-          [&](const ParticleList &search) {
+          [&](const ParticleSpan &search) {
             auto ids = *idsIt++;
             for (const auto &p : search) {
               COMPARE(ids.erase(p.id()), 1u)
@@ -166,7 +168,7 @@ TEST(grid_construction) {
             }
             COMPARE(ids.size(), 0u);
           },
-          [&](const ParticleList &search, const ParticleList &n) {
+          [&](const ParticleSpan &search, const ParticleSpan &n) {
             for (const auto &p : search) {
               for (const auto &p2 : n) {
                 COMPARE(neighbors.erase({std::min(p.id(), p2.id()),
@@ -223,7 +225,7 @@ TEST(periodic_grid) {
       std::vector<std::pair<ParticleData, ParticleData>> neighbor_pairs;
 
       grid.iterate_cells(
-          [&](const ParticleList &search) {
+          [&](const ParticleSpan &search) {
             for (const ParticleData &p : search) {
               {
                 const auto it = find(list, p);
@@ -244,13 +246,13 @@ TEST(periodic_grid) {
                   const auto it = find(neighbor_pairs, pair);
                   COMPARE(it, neighbor_pairs.end())
                       << "\np: " << p << "\nq: " << q << '\n'
-                      << detailed(search);
+                      << detailed(search.copy_to_vector());
                   neighbor_pairs.emplace_back(std::move(pair));
                 }
               }
             }
           },
-          [&](const ParticleList &search, const ParticleList &neighbors) {
+          [&](const ParticleSpan &search, const ParticleSpan &neighbors) {
             // for each particle in neighbors, find the same particle in list
             for (const ParticleData &p : neighbors) {
               const auto it = find(list, p);
@@ -289,8 +291,8 @@ TEST(periodic_grid) {
             for (const ParticleData &p : search) {
               for (const ParticleData &q : neighbors) {
                 VERIFY(!(p == q)) << "\np: " << p << "\nq: " << q << '\n'
-                                  << search << '\n'
-                                  << neighbors;
+                                  << search.copy_to_vector() << '\n'
+                                  << neighbors.copy_to_vector();
                 const auto sqrDistance =
                     (p.position().threevec() - q.position().threevec()).sqr();
                 if (sqrDistance <= min_cell_length * min_cell_length) {
@@ -469,3 +471,215 @@ TEST(max_positions_normal_grid) {
   Grid<GridOptions::Normal> grid2(list, testparticles, 1.0,
                                   CellNumberLimitation::None);
 }
+
+TEST(cells_refer_to_particles) {
+  const double min_cell_length = minimal_cell_length(1);
+  Particles list;
+  for (int i = 0; i < 64; i++) {
+    list.insert(Test::smashon(Test::Position{0., 1.5 * min_cell_length * (i % 4),
+                                             1.5 * min_cell_length * (i / 4 % 4),
+                                             1.5 * min_cell_length * (i / 16)}));
+  }
+  for (const auto strategy :
+       {CellSizeStrategy::Optimal, CellSizeStrategy::Largest}) {
+    Grid<GridOptions::Normal> grid(list, min_cell_length, timestep,
+                                   CellNumberLimitation::None, false, strategy);
+    std::set<const ParticleData *> seen;
+    grid.iterate_cells(
+        [&](const ParticleSpan &search) {
+          int previous_id = -1;
+          for (const ParticleData &p : search) {
+            // the particles are not copied and keep their order
+            VERIFY(seen.insert(&p).second);
+            VERIFY(&p == &list.lookup(p));
+            VERIFY(p.id() > previous_id);
+            previous_id = p.id();
+          }
+        },
+        [](const ParticleSpan &, const ParticleSpan &) {});
+    COMPARE(seen.size(), list.size());
+  }
+}
+
+namespace {
+/// \return the ids of the particles in every cell of the grid
+template <GridOptions O>
+std::vector<std::vector<int>> ids_in_cells(const Grid<O> &grid) {
+  std::vector<std::vector<int>> ids;
+  grid.iterate_cells(
+      [&](const ParticleSpan &search) {
+        ids.emplace_back();
+        for (const ParticleData &p : search) {
+          ids.back().push_back(p.id());
+        }
+      },
+      [](const ParticleSpan &, const ParticleSpan &) {});
+  return ids;
+}
+}  // namespace
+
+TEST(update_grid) {
+  constexpr double length = 10;
+  const double min_cell_length = minimal_cell_length(1);
+  const auto box = make_pair(std::array<double, 3>{0, 0, 0},
+                             std::array<double, 3>{length, length, length});
+  Particles list;
+  for (int i = 0; i < 27; i++) {
+    list.insert(Test::smashon(
+        Test::Position{0., 3.5 * (i % 3) + 1., 3.5 * (i / 3 % 3) + 1.,
+                       3.5 * (i / 9) + 1.}));
+  }
+  Grid<GridOptions::PeriodicBoundaries> grid(box, list, min_cell_length,
+                                             timestep,
+                                             CellNumberLimitation::None);
+  const auto initial_ids = ids_in_cells(grid);
+
+  // Moving within the cells keeps them
+  for (ParticleData &p : list) {
+    p.set_4position(p.position() + FourVector(0., 0.1, 0.1, 0.1));
+  }
+  VERIFY(grid.update(list, min_cell_length, timestep));
+  COMPARE(ids_in_cells(grid), initial_ids);
+
+  // Particles crossing cells, inserted and removed ones end up where a new
+  // grid would put them
+  list.front().set_4position(FourVector(0., 9., 9., 9.));
+  list.remove(list.back());
+  list.insert(Test::smashon(Test::Position{0., 5., 5., 5.}));
+  VERIFY(grid.update(list, min_cell_length, timestep));
+  const auto updated_ids = ids_in_cells(grid);
+  VERIFY(updated_ids != initial_ids);
+  Grid<GridOptions::PeriodicBoundaries> new_grid(box, list, min_cell_length,
+                                                 timestep,
+                                                 CellNumberLimitation::None);
+  COMPARE(updated_ids, ids_in_cells(new_grid));
+
+  // A different cell length requires a new grid
+  VERIFY(!grid.update(list, 2 * min_cell_length, timestep));
+  // as well as a particle outside of the grid, which leaves it unchanged
+  list.front().set_4position(FourVector(0., 11., 9., 9.));
+  VERIFY(!grid.update(list, min_cell_length, timestep));
+  COMPARE(ids_in_cells(grid), updated_ids);
+}
+
+namespace {
+/**
+ * \return the ids of the particles passed by every call of iterate_cells,
+ *         either for all layers at once or one layer after the other
+ */
+template <GridOptions O>
+std::vector<std::vector<int>> ids_in_calls(const Grid<O> &grid,
+                                           bool by_layers) {
+  std::vector<std::vector<int>> ids;
+  auto search = [&](const ParticleSpan &cell) {
+    ids.emplace_back();
+    for (const ParticleData &p : cell) {
+      ids.back().push_back(p.id());
+    }
+  };
+  auto neighbors = [&](const ParticleSpan &cell,
+                       const ParticleSpan &neighbor) {
+    search(cell);
+    for (const ParticleData &p : neighbor) {
+      ids.back().push_back(-p.id());
+    }
+  };
+  if (!by_layers) {
+    grid.iterate_cells(search, neighbors);
+    return ids;
+  }
+  for (int layer = 0; layer < grid.number_of_layers(); layer++) {
+    grid.iterate_cells(search, neighbors, layer, layer + 1);
+  }
+  return ids;
+}
+}  // namespace
+
+TEST(iterate_layers) {
+  const auto box = make_pair(std::array<double, 3>{0, 0, 0},
+                             std::array<double, 3>{10., 10., 10.});
+  Particles list;
+  for (int i = 0; i < 64; i++) {
+    list.insert(Test::smashon(Test::Position{
+        0., 2.5 * (i % 4) + 1., 2.5 * (i / 4 % 4) + 1., 2.5 * (i / 16) + 1.}));
+  }
+  Grid<GridOptions::PeriodicBoundaries> periodic(
+      box, list, 2.5, timestep, CellNumberLimitation::None);
+  COMPARE(periodic.number_of_layers(), 4);
+  COMPARE(ids_in_calls(periodic, true), ids_in_calls(periodic, false));
+  Grid<GridOptions::Normal> normal(list, 2.5, timestep,
+                                   CellNumberLimitation::None);
+  VERIFY(normal.number_of_layers() > 1);
+  COMPARE(ids_in_calls(normal, true), ids_in_calls(normal, false));
+}
+
+TEST(min_and_length_with_margin) {
+  Particles list;
+  list.insert(Test::smashon(Test::Position{0., 0., 0., 0.}));
+  list.insert(Test::smashon(Test::Position{0., 10., 1., 0.}));
+  const auto exact = GridBase::find_min_and_length(list);
+  COMPARE(exact.first, (std::array<double, 3>{0., 0., 0.}));
+  COMPARE(exact.second, (std::array<double, 3>{10., 1., 0.}));
+  const auto extended = GridBase::find_min_and_length(list, 0.1, 0.5);
+  COMPARE(extended.first, (std::array<double, 3>{-1., -0.5, -0.5}));
+  COMPARE(extended.second, (std::array<double, 3>{12., 2., 1.}));
+}
+
+TEST(refined_cells) {
+  const auto box = make_pair(std::array<double, 3>{0, 0, 0},
+                             std::array<double, 3>{10., 10., 10.});
+  Particles list;
+  // 27 particles in the corner of the first of 2x2x2 cells and one far away
+  for (int i = 0; i < 27; i++) {
+    list.insert(Test::smashon(Test::Position{0., 0.5 + 1.5 * (i % 3),
+                                             0.5 + 1.5 * (i / 3 % 3),
+                                             0.5 + 1.5 * (i / 9)}));
+  }
+  list.insert(Test::smashon(Test::Position{0., 7., 7., 7.}));
+  Grid<GridOptions::PeriodicBoundaries> grid(box, list, 5., timestep,
+                                             CellNumberLimitation::None);
+  COMPARE(grid.cell_volume(), 125.);
+
+  // id -> volume of the cell and number of particles in it
+  std::map<int, std::pair<double, std::size_t>> cells;
+  grid.iterate_refined_cells(
+      4, 1., [&](const ParticleSpan &search, double volume) {
+        for (const ParticleData &p : search) {
+          VERIFY(cells.find(p.id()) == cells.end());
+          cells[p.id()] = {volume, search.size()};
+        }
+      });
+  COMPARE(cells.size(), 28u);
+  // The dilute cell is kept
+  COMPARE(cells[27], std::make_pair(125., std::size_t(1)));
+  // The octant at the origin holds 8 particles and is divided once more
+  COMPARE(cells[0], std::make_pair(1.25 * 1.25 * 1.25, std::size_t(1)));
+  // The others hold at most 4 particles
+  COMPARE(cells[2], std::make_pair(2.5 * 2.5 * 2.5, std::size_t(4)));
+  COMPARE(cells[26], std::make_pair(2.5 * 2.5 * 2.5, std::size_t(1)));
+
+  // Octants shorter than the minimal length are not made
+  grid.iterate_refined_cells(
+      4, 2., [&](const ParticleSpan &search, double volume) {
+        for (const ParticleData &p : search) {
+          cells[p.id()] = {volume, search.size()};
+        }
+      });
+  COMPARE(cells[0], std::make_pair(2.5 * 2.5 * 2.5, std::size_t(8)));
+
+  // Without crowded cells, the cells are the same as for iterate_cells
+  std::vector<std::vector<int>> ids;
+  grid.iterate_refined_cells(
+      100, 1., [&](const ParticleSpan &search, double volume) {
+        COMPARE(volume, 125.);
+        ids.emplace_back();
+        for (const ParticleData &p : search) {
+          ids.back().push_back(p.id());
+        }
+      });
+  std::vector<std::vector<int>> all_ids = ids_in_cells(grid);
+  all_ids.erase(std::remove_if(all_ids.begin(), all_ids.end(),
+                               [](const auto &v) { return v.empty(); }),
+                all_ids.end());
+  COMPARE(ids, all_ids);
+}
@@ -1,6 +1,6 @@
 /*
  *
- *    Copyright (c) 2016-2020,2022
+ *    Copyright (c) 2016-2020,2022,2024
  *      SMASH Team
  *
  *    GNU General Public License (GPLv3 or later)
@@ -11,6 +11,8 @@
 
 #include "smash/hadgas_eos.h"
 
+#include <filesystem>
+
 #include "setup.h"
 #include "smash/constants.h"
 
@@ -70,7 +72,7 @@ TEST(EoS_table) {
   // make a small table of EoS
   HadronGasEos eos = HadronGasEos(false, false);
   EosTable table = EosTable(0.1, 0.05, 0.05, 5, 5, 5);
-  table.compile_table(eos, "small_test_table_eos.dat");
+  table.compile_table(eos, "small_test_table_eos.bin");
   EosTable::table_element x;
   const double my_e = 0.39, my_nb = 0.09, my_nq = 0.06;
   table.get(x, my_e, my_nb, my_nq);
@@ -81,7 +83,35 @@ TEST(EoS_table) {
       HadronGasEos::net_baryon_density(x.T, x.mub, x.mus, x.muq), my_nb, 1.e-2);
   COMPARE_ABSOLUTE_ERROR(
       HadronGasEos::net_charge_density(x.T, x.mub, x.mus, x.muq), my_nq, 1.e-2);
-  remove("small_test_table_eos.dat");
+  remove("small_test_table_eos.bin");
+}
+
+TEST(EoS_table_file) {
+  const std::filesystem::path path = "small_test_table_eos.bin";
+  HadronGasEos eos = HadronGasEos(false, false);
+  EosTable table = EosTable(0.1, 0.05, 0.05, 5, 5, 5);
+  table.compile_table(eos, path.string());
+  COMPARE(std::filesystem::file_size(path),
+          sizeof(EosTable::magic) + sizeof(EosTable::version) +
+              sizeof(sha256::Hash) + 125 * sizeof(EosTable::table_element));
+  VERIFY(table.hash(false) != table.hash(true));
+  VERIFY(table.hash(false) !=
+         EosTable(0.1, 0.05, 0.05, 5, 5, 6).hash(false));
+
+  // The saved table is read back for the same hash
+  EosTable read_table = EosTable(0.1, 0.05, 0.05, 5, 5, 5);
+  read_table.compile_table(eos, path.string());
+  EosTable::table_element x, y;
+  for (double e : {0.15, 0.25, 0.35}) {
+    table.get(x, e, 0.07, 0.03);
+    read_table.get(y, e, 0.07, 0.03);
+    COMPARE(x.p, y.p);
+    COMPARE(x.T, y.T);
+    COMPARE(x.mub, y.mub);
+    COMPARE(x.mus, y.mus);
+    COMPARE(x.muq, y.muq);
+  }
+  std::filesystem::remove(path);
 }
 
 /*
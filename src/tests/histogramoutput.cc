@@ -0,0 +1,202 @@
+/*
+ *
+ *    Copyright (c) 2024
+ *      SMASH Team
+ *
+ *    GNU General Public License (GPLv3 or later)
+ *
+ */
+
+#include "vir/test.h"  // This include has to be first
+
+#include "smash/histogramoutput.h"
+
+#include <cmath>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+
+#include "setup.h"
+#include "smash/wallcrossingaction.h"
+
+using namespace smash;
+
+static const std::filesystem::path testoutputpath =
+    std::filesystem::absolute(SMASH_TEST_OUTPUT_PATH);
+
+namespace {
+/// A smashon with the given momentum
+ParticleData smashon(double px, double py, double pz) {
+  const double m = Test::smashon_mass;
+  return Test::smashon(Test::Momentum{
+      std::sqrt(m * m + px * px + py * py + pz * pz), px, py, pz});
+}
+}  // namespace
+
+TEST(directory_is_created) {
+  std::filesystem::create_directories(testoutputpath);
+  VERIFY(std::filesystem::exists(testoutputpath));
+}
+
+TEST(init_particle_types) { Test::create_smashon_particletypes(); }
+
+TEST(axis) {
+  const HistogramAxis axis(4, {-1., 1.});
+  COMPARE(axis.n_bins(), 4);
+  COMPARE(axis.bin(-1.5), -1);
+  COMPARE(axis.bin(-1.), 0);
+  COMPARE(axis.bin(-0.1), 1);
+  COMPARE(axis.bin(0.), 2);
+  COMPARE(axis.bin(0.99), 3);
+  COMPARE(axis.bin(1.), 4);
+  FUZZY_COMPARE(axis.low_edge(1), -0.5);
+  FUZZY_COMPARE(axis.high_edge(3), 1.);
+}
+
+TEST_CATCH(empty_axis, std::invalid_argument) {
+  const HistogramAxis axis(4, {1., 1.});
+}
+
+TEST_CATCH(axis_without_bins, std::invalid_argument) {
+  const HistogramAxis axis(0, {0., 1.});
+}
+
+TEST(histogram1d) {
+  Histogram1D histogram(HistogramAxis(2, {0., 2.}));
+  histogram.fill(0.5);
+  histogram.fill(1.5, 0., 2.);
+  histogram.fill(1.7, 0., 2.);
+  histogram.fill(-1.);
+  histogram.fill(3.);
+  COMPARE(histogram.bin(0).sumw, 1.);
+  COMPARE(histogram.bin(1).sumw, 4.);
+  COMPARE(histogram.bin(1).sumw2, 8.);
+  COMPARE(histogram.bin(1).entries, 2.);
+  FUZZY_COMPARE(histogram.bin(1).sumwx, 6.4);
+  COMPARE(histogram.underflow().entries, 1.);
+  COMPARE(histogram.overflow().entries, 1.);
+  COMPARE(histogram.total().entries, 5.);
+  COMPARE(histogram.total().sumw, 7.);
+}
+
+TEST(profile) {
+  Histogram1D profile(HistogramAxis(1, {0., 1.}));
+  profile.fill(0.5, 1.);
+  profile.fill(0.5, -0.5);
+  FUZZY_COMPARE(profile.bin(0).sumwy / profile.bin(0).sumw, 0.25);
+  FUZZY_COMPARE(profile.bin(0).sumwy2, 1.25);
+}
+
+TEST(histogram2d) {
+  Histogram2D histogram(HistogramAxis(2, {0., 2.}), HistogramAxis(3, {0., 3.}));
+  histogram.fill(1.5, 0.5);
+  histogram.fill(1.5, 2.5, 3.);
+  histogram.fill(5., 0.5);
+  COMPARE(histogram.bin(1, 0).sumw, 1.);
+  COMPARE(histogram.bin(1, 2).sumw, 3.);
+  COMPARE(histogram.bin(0, 0).entries, 0.);
+  COMPARE(histogram.total().entries, 3.);
+}
+
+TEST(yoda_format) {
+  Histogram1D histogram(HistogramAxis(2, {0., 2.}));
+  histogram.fill(0.5);
+  histogram.fill(1.5);
+  std::ostringstream out;
+  write_yoda_histo1d(out, "/SMASH/test", "test", histogram, 0.5);
+  const std::string text = out.str();
+  VERIFY(text.rfind("BEGIN YODA_HISTO1D_V2 /SMASH/test\n", 0) == 0);
+  VERIFY(text.find("ScaledBy: 0.5\n") != std::string::npos);
+  VERIFY(text.find("# Area: 1\n") != std::string::npos);
+  VERIFY(text.find("Total   \tTotal   \t1\t0.5\t1\t1.25\t2\n") !=
+         std::string::npos);
+  VERIFY(text.find("0\t1\t0.5\t0.25\t0.25\t0.125\t1\n") != std::string::npos);
+  VERIFY(text.find("END YODA_HISTO1D_V2\n") != std::string::npos);
+
+  std::ostringstream profile;
+  write_yoda_profile1d(profile, "/SMASH/v2", "v2", histogram);
+  VERIFY(profile.str().rfind("BEGIN YODA_PROFILE1D_V2 /SMASH/v2\n", 0) == 0);
+
+  Histogram2D histogram2d(HistogramAxis(1, {0., 1.}),
+                          HistogramAxis(1, {0., 1.}));
+  histogram2d.fill(0.5, 0.5);
+  std::ostringstream out2d;
+  write_yoda_histo2d(out2d, "/SMASH/2d", "2d", histogram2d, 1.);
+  VERIFY(out2d.str().find("# Mean: (0.5, 0.5)\n") != std::string::npos);
+}
+
+TEST_CATCH(unknown_quantity, std::invalid_argument) {
+  OutputParameters out_par;
+  out_par.histogram_parameters.quantities = {"Rapidity", "Temperature"};
+  HistogramOutput output(testoutputpath, "Histograms", out_par);
+}
+
+TEST(written_per_event) {
+  OutputParameters out_par;
+  out_par.histogram_parameters.quantities = {"Rapidity", "Elliptic_Flow",
+                                             "Interaction_Rate"};
+  out_par.histogram_parameters.rapidity_bins = 2;
+  out_par.histogram_parameters.rapidity_range = {-1., 1.};
+  out_par.histogram_parameters.transverse_momentum_bins = 1;
+  out_par.histogram_parameters.time_bins = 1;
+  HistogramOutput output(testoutputpath, "Histograms", out_par);
+
+  Particles particles;
+  const ParticleData along_x = particles.insert(smashon(0.5, 0., 0.));
+  particles.insert(smashon(0.5, 0., 0.));
+  particles.insert(smashon(0., 0.5, 0.));
+  particles.insert(smashon(0.5, 0., 10.));
+  for (int event = 0; event < 2; event++) {
+    output.at_eventend(particles, event, Test::default_event_info());
+  }
+  // Crossing the walls of the box is not an interaction
+  output.at_interaction(WallcrossingAction(along_x, along_x), 0.);
+  output.at_runend();
+
+  const std::filesystem::path filename = testoutputpath / "Histograms.yoda";
+  VERIFY(std::filesystem::exists(filename));
+  std::ifstream file(filename);
+  std::stringstream content;
+  content << file.rdbuf();
+  const std::string text = content.str();
+  VERIFY(text.find("BEGIN YODA_HISTO1D_V2 /SMASH/dN_dy\n") !=
+         std::string::npos);
+  // The particle beyond the rapidity range counts as overflow
+  VERIFY(text.find("# Area: 4.000000e+00\n") != std::string::npos);
+  // Within the rapidity range, cos 2phi is 1, 1 and -1 in every event
+  VERIFY(text.find("BEGIN YODA_PROFILE1D_V2 /SMASH/v2_pT\n") !=
+         std::string::npos);
+  VERIFY(text.find("Total   \tTotal   \t6.000000e+00\t6.000000e+00\t"
+                   "3.000000e+00\t1.500000e+00\t2.000000e+00\t"
+                   "6.000000e+00\t6.000000e+00\n") != std::string::npos);
+  VERIFY(text.find("BEGIN YODA_HISTO1D_V2 /SMASH/dN_int_dt\n") !=
+         std::string::npos);
+  VERIFY(text.find("# Area: 0.000000e+00\n") != std::string::npos);
+}
+
+TEST(weighted_events) {
+  OutputParameters out_par;
+  out_par.histogram_parameters.quantities = {"Rapidity"};
+  out_par.histogram_parameters.rapidity_bins = 1;
+  out_par.histogram_parameters.rapidity_range = {-1., 1.};
+  HistogramOutput output(testoutputpath, "WeightedHistograms", out_par);
+
+  Particles particles;
+  particles.insert(smashon(0.5, 0., 0.));
+  EventInfo event = Test::default_event_info();
+  for (const double weight : {3., 1.}) {
+    event.event_weight = weight;
+    output.at_eventstart(particles, 0, event);
+    output.at_eventend(particles, 0, event);
+  }
+  output.at_runend();
+
+  std::ifstream file(testoutputpath / "WeightedHistograms.yoda");
+  std::stringstream content;
+  content << file.rdbuf();
+  // One particle per event with any weights
+  VERIFY(content.str().find("# Area: 1.000000e+00\n") != std::string::npos);
+  VERIFY(content.str().find("ScaledBy: 2.500000e-01\n") != std::string::npos);
+}
@@ -60,6 +60,8 @@ TEST(hypersurface_crossing_action) {
   // the hypersurface in the given time step
   // Implicit test of HyperSurfaceCrossActionsFinder::crosses_hypersurface
   COMPARE(actions.size(), 1u);
+  // The pass over all particles finds the same crossing
+  COMPARE(finder.find_crossings(particles, time_step, beam_mom).size(), 1u);
 
   for (auto &action : actions) {
     // perform action
@@ -1,6 +1,6 @@
 /*
  *
- *    Copyright (c) 2014-2020,2022-2023
+ *    Copyright (c) 2014-2020,2022-2024
  *      SMASH Team
  *
  *    GNU General Public License (GPLv3 or later)
@@ -13,6 +13,7 @@
 #include "smash/boxmodus.h"
 #include "smash/collidermodus.h"
 #include "smash/modusdefault.h"
+#include "smash/random.h"
 #include "smash/spheremodus.h"
 
 using namespace smash;
@@ -87,6 +88,100 @@ TEST(initialize_collider_normal) {
   // all other things can only be tested with statistics.
 }
 
+/*
+ * Initial states generated in advance only depend on the event seed, also
+ * when the generation starts over for an unexpected seed.
+ */
+TEST(initialize_collider_pregenerated) {
+  auto make_collider = [](int pregenerated_events) {
+    return std::make_unique<ColliderModus>(
+        Configuration(("Collider:\n"
+                       "  Sqrtsnn: 1.6\n"
+                       "  Pregenerated_Events: " +
+                       std::to_string(pregenerated_events) +
+                       "\n"
+                       "  Projectile:\n"
+                       "    Particles: {661: 8}\n"
+                       "  Target:\n"
+                       "    Particles: {661: 8}\n"
+                       "  Impact:\n"
+                       "    Max: 5\n")
+                          .c_str()),
+        Test::default_parameters());
+  };
+  auto sample = [](ColliderModus &collider, int64_t seed) {
+    collider.prepare_event(seed, 2);
+    collider.sample_impact();
+    std::vector<Particles> ensembles(2);
+    for (Particles &particles : ensembles) {
+      collider.initial_conditions(&particles, Test::default_parameters());
+    }
+    return ensembles;
+  };
+  auto one = make_collider(1);
+  auto three = make_collider(3);
+  const std::vector<Particles> expected = sample(*one, 42);
+  COMPARE(expected[0].size(), 16u);
+  sample(*three, 7);
+  const std::vector<Particles> restarted = sample(*three, 42);
+  COMPARE(one->impact_parameter(), three->impact_parameter());
+  for (int i = 0; i < 2; i++) {
+    COMPARE(restarted[i].size(), expected[i].size());
+    auto p = restarted[i].begin();
+    for (const ParticleData &q : expected[i]) {
+      COMPARE(p->position(), q.position());
+      COMPARE(p->momentum(), q.momentum());
+      ++p;
+    }
+  }
+  VERIFY(expected[0].front().position() != expected[1].front().position());
+}
+
+/*
+ * Uniformly sampled impact parameters, weighted to the minimum bias
+ * distribution dP(b) ~ b db, have the weight b / 5 fm on [0, 10] fm.
+ */
+TEST(weighted_impact_parameter) {
+  ColliderModus collider(Configuration("Collider:\n"
+                                       "  Sqrtsnn: 1.6\n"
+                                       "  Projectile:\n"
+                                       "    Particles: {661: 8}\n"
+                                       "  Target:\n"
+                                       "    Particles: {661: 8}\n"
+                                       "  Impact:\n"
+                                       "    Sample: \"custom\"\n"
+                                       "    Values: [0, 5, 10]\n"
+                                       "    Yields: [1, 1, 1]\n"
+                                       "    Weighted: True\n"),
+                         Test::default_parameters());
+  random::set_seed(13);
+  constexpr int n_events = 100000;
+  double sum_w = 0., sum_wb = 0.;
+  for (int i = 0; i < n_events; i++) {
+    collider.sample_impact();
+    const double b = collider.impact_parameter();
+    COMPARE_RELATIVE_ERROR(collider.event_weight(), b / 5., 1e-12);
+    sum_w += collider.event_weight();
+    sum_wb += collider.event_weight() * b;
+  }
+  COMPARE_ABSOLUTE_ERROR(sum_w / n_events, 1., 0.01);
+  // Mean of the minimum bias distribution, 2/3 b_max
+  COMPARE_ABSOLUTE_ERROR(sum_wb / sum_w, 20. / 3., 0.05);
+}
+
+TEST_CATCH(weighted_fixed_impact_parameter, std::domain_error) {
+  ColliderModus collider(Configuration("Collider:\n"
+                                       "  Sqrtsnn: 1.6\n"
+                                       "  Projectile:\n"
+                                       "    Particles: {661: 8}\n"
+                                       "  Target:\n"
+                                       "    Particles: {661: 8}\n"
+                                       "  Impact:\n"
+                                       "    Sample: \"uniform\"\n"
+                                       "    Weighted: True\n"),
+                         Test::default_parameters());
+}
+
 TEST_CATCH(initialize_collider_low_energy, ModusDefault::InvalidEnergy) {
   ColliderModus n(Configuration("Collider:\n"
                                 "  Sqrtsnn: 0.5\n"
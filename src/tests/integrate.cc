@@ -1,6 +1,6 @@
 /*
  *
- *    Copyright (c) 2015,2017-2018,2020,2022
+ *    Copyright (c) 2015,2017-2018,2020,2022,2024
  *      SMASH Team
  *
  *    GNU General Public License (GPLv3 or later)
@@ -53,6 +53,31 @@ TEST(one_dim_result_conversion_to_value) {
   }
 }
 
+TEST(gauss_legendre) {
+  for (std::size_t order : {1, 2, 5, 16, 64}) {
+    const smash::GaussLegendre integrate(order);
+    COMPARE(integrate.order(), order);
+    // Polynomials up to degree 2 * order - 1 are integrated exactly
+    const int degree = 2 * order - 1;
+    const double result =
+        integrate(-1., 2., [degree](double x) { return std::pow(x, degree); });
+    const double expected = (std::pow(2., degree + 1) - 1.) / (degree + 1);
+    COMPARE_RELATIVE_ERROR(result, expected, 1e-12) << "order " << order;
+    const double all_nodes = integrate.integrate_all_nodes(
+        -1., 2., [degree](const double *x, std::size_t n, double *y) {
+          for (std::size_t i = 0; i < n; i++) {
+            y[i] = std::pow(x[i], degree);
+          }
+        });
+    COMPARE(all_nodes, result);
+  }
+  const smash::GaussLegendre integrate(32);
+  COMPARE_ABSOLUTE_ERROR(
+      integrate(0., 2. * M_PI,
+                [](double x) { return std::exp(std::cos(2. * x)); }),
+      2. * M_PI * std::cyl_bessel_i(0., 1.), 1e-8);
+}
+
 // test two-dimensional Monte-Carlo integration
 TEST(two_dim) {
   smash::Integrator2d integrate;
@@ -1,6 +1,6 @@
 /*
  *
- *    Copyright (c) 2015-2018,2020,2022
+ *    Copyright (c) 2015-2018,2020,2022,2024
  *      SMASH Team
  *
  *    GNU General Public License (GPLv3 or later)
@@ -91,3 +91,52 @@ TEST(interpolate_data_spline_unsorted) {
   COMPARE(f(0), 1.0);
   COMPARE(f(10), 9.0);
 }
+
+TEST(evaluate_several_arguments) {
+  const std::vector<double> x = {1, 2, 4, 5, 7, 8};
+  const std::vector<double> y = {3, 1, 4, 1, 5, 9};
+  const InterpolateDataLinear<double> linear(x, y);
+  const InterpolateDataSpline spline(x, y);
+  // Ascending, repeated and descending arguments, also outside of the data
+  const std::vector<double> args = {0,   1,   1.5, 2, 2,   3.9, 4.1, 7.5,
+                                    9,   8.5, 6,   2, 0.5, 4,   4,   5};
+  std::vector<double> results(args.size());
+  linear.evaluate(args.data(), args.size(), results.data());
+  for (std::size_t i = 0; i < args.size(); i++) {
+    COMPARE(results[i], linear(args[i])) << args[i];
+  }
+  spline.evaluate(args.data(), args.size(), results.data());
+  for (std::size_t i = 0; i < args.size(); i++) {
+    COMPARE(results[i], spline(args[i])) << args[i];
+  }
+}
+
+TEST(equally_spaced_and_hinted) {
+  const std::vector<double> x_uniform = {0.5, 0.7, 0.9, 1.1, 1.3, 1.5, 1.7};
+  const std::vector<double> x_other = {0.5, 0.6, 0.9, 1.0, 1.3, 1.6, 1.7};
+  const std::vector<double> y = {3, 1, 4, 1, 5, 9, 2};
+  for (const auto &x : {x_uniform, x_other}) {
+    const InterpolateDataLinear<double> linear(x, y);
+    const InterpolateDataSpline spline(x, y);
+    gsl_spline *reference = gsl_spline_alloc(gsl_interp_cspline, x.size());
+    gsl_spline_init(reference, x.data(), y.data(), x.size());
+    std::size_t linear_hint = 0, spline_hint = 0;
+    for (double xi = 0.4; xi < 1.8; xi += 0.01) {
+      // The samples themselves are hit as well
+      for (double arg : {xi, x[static_cast<int>(xi * 10) % x.size()]}) {
+        const std::size_t i = std::min(find_index(x, arg), x.size() - 2);
+        const double expected_linear =
+            y[i] + (y[i + 1] - y[i]) / (x[i + 1] - x[i]) * (arg - x[i]);
+        FUZZY_COMPARE(linear(arg), expected_linear) << arg;
+        COMPARE(linear(arg, linear_hint), linear(arg)) << arg;
+        const double expected_spline =
+            arg < x.front()  ? y.front()
+            : arg > x.back() ? y.back()
+                             : gsl_spline_eval(reference, arg, nullptr);
+        COMPARE(spline(arg), expected_spline) << arg;
+        COMPARE(spline(arg, spline_hint), expected_spline) << arg;
+      }
+    }
+    gsl_spline_free(reference);
+  }
+}
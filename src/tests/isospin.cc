@@ -31,9 +31,7 @@ TEST(init_particle_types) {
       "Δ          \n"
       "1.  1  N π \n");
   ParticleType::check_consistency();
-  sha256::Hash hash;
-  hash.fill(0);
-  IsoParticleType::tabulate_integrals(hash, "");
+  IsoParticleType::tabulate_integrals();
 }
 
 static ScatterAction *set_up_action(const ParticleData &proj,
@@ -1,6 +1,6 @@
 /*
  *
- *    Copyright (c) 2015-2018,2020-2022
+ *    Copyright (c) 2015-2018,2020-2022,2024
  *      SMASH Team
  *
  *    GNU General Public License (GPLv3 or later)
@@ -11,10 +11,46 @@
 
 #include "smash/lattice.h"
 
+#include <sstream>
+#include <utility>
+#include <vector>
+
+#include "smash/ensemblecommunicator.h"
 #include "smash/fourvector.h"
+#include "smash/threadpool.h"
 
 using namespace smash;
 
+namespace {
+/**
+ * Pretends a second process with the same values on its lattice, whose
+ * occupied tiles are given.
+ */
+class TwoProcesses : public EnsembleCommunicator {
+ public:
+  explicit TwoProcesses(std::vector<char> other_tiles)
+      : other_tiles_(std::move(other_tiles)) {}
+  int rank() const override { return 0; }
+  int size() const override { return 2; }
+  void sum(double *values, std::size_t n) override {
+    n_summed += n;
+    for (std::size_t i = 0; i < n; i++) {
+      values[i] *= 2.;
+    }
+  }
+  void combine_or(char *flags, std::size_t n) override {
+    for (std::size_t i = 0; i < n; i++) {
+      flags[i] = flags[i] || other_tiles_[i];
+    }
+  }
+  /// Number of values summed so far
+  std::size_t n_summed = 0;
+
+ private:
+  std::vector<char> other_tiles_;
+};
+}  // namespace
+
 static std::unique_ptr<RectangularLattice<FourVector>> create_lattice(bool p) {
   const std::array<double, 3> l = {10., 6., 2.};
   const std::array<int, 3> n = {4, 8, 3};
@@ -50,6 +86,103 @@ TEST(reset) {
   }
 }
 
+TEST(sparse_reset) {
+  for (const bool periodicity : {true, false}) {
+    RectangularLattice<double> lat({10., 10., 10.}, {20, 20, 20},
+                                   {0., 0., 0.}, periodicity,
+                                   LatticeUpdate::EveryTimestep);
+    lat.set_sparse(true);
+    VERIFY(lat.sparse());
+    // Initially, everything is considered occupied
+    for (auto &node : lat) {
+      node = 1.;
+    }
+    lat.reset();
+    for (const auto &node : lat) {
+      COMPARE(node, 0.);
+    }
+    // Fill a box beyond the upper edges, which wraps for periodic lattices
+    const std::array<int, 3> lower = {15, 3, 18}, upper = {23, 5, 21};
+    lat.mark_occupied(lower, upper);
+    lat.iterate_sublattice_indices(
+        lower, upper, [&](int index, int ix, int iy, int iz) {
+          if (!lat.out_of_bounds(ix, iy, iz)) {
+            lat[index] += 1.;
+          }
+        });
+    int n_filled = 0;
+    lat.iterate_occupied_indices([&](int index) {
+      if (lat[index] != 0.) {
+        n_filled++;
+      }
+    });
+    // Non-periodic lattices are clipped: 5 * 2 * 2 instead of 8 * 2 * 3
+    COMPARE(n_filled, periodicity ? 48 : 20);
+    lat.reset();
+    for (const auto &node : lat) {
+      COMPARE(node, 0.);
+    }
+  }
+}
+
+TEST(occupied_like) {
+  // 2 x 1 x 1 tiles of 8^3 cells
+  RectangularLattice<double> density({16., 8., 8.}, {16, 8, 8}, {0., 0., 0.},
+                                     false, LatticeUpdate::EveryTimestep);
+  RectangularLattice<FourVector> potential({16., 8., 8.}, {16, 8, 8},
+                                           {0., 0., 0.}, false,
+                                           LatticeUpdate::EveryTimestep);
+  density.set_sparse(true);
+  potential.set_sparse(true);
+  density.reset();
+  potential.reset();
+  density.mark_occupied({9, 0, 0}, {10, 1, 1});
+  potential.mark_occupied_like(density);
+  int n_occupied = 0;
+  potential.iterate_occupied_indices([&](int index) {
+    VERIFY(index % 16 >= 8);
+    n_occupied++;
+  });
+  COMPARE(n_occupied, 8 * 8 * 8);
+  // A dense lattice occupies everything
+  density.set_sparse(false);
+  potential.mark_occupied_like(density);
+  n_occupied = 0;
+  potential.iterate_occupied_indices([&](int) { n_occupied++; });
+  COMPARE(n_occupied, 16 * 8 * 8);
+}
+
+TEST(sum_over_processes) {
+  // 2 x 1 x 1 tiles of 8^3 cells
+  RectangularLattice<FourVector> lat({16., 8., 8.}, {16, 8, 8}, {0., 0., 0.},
+                                     false, LatticeUpdate::EveryTimestep);
+  TwoProcesses dense_processes({});
+  lat[5] = FourVector(1., 2., 3., 4.);
+  lat.sum_over(dense_processes);
+  COMPARE(lat[5], FourVector(2., 4., 6., 8.));
+  COMPARE(dense_processes.n_summed, 4 * lat.size());
+
+  lat.set_sparse(true);
+  lat.reset();
+  // This process fills the first tile, the other one only the second
+  lat.mark_occupied({0, 0, 0}, {1, 1, 1});
+  lat[0] = FourVector(1., 0., 0., 0.);
+  TwoProcesses sparse_processes({0, 1});
+  lat.sum_over(sparse_processes);
+  COMPARE(lat[0], FourVector(2., 0., 0., 0.));
+  COMPARE(sparse_processes.n_summed, 4 * lat.size());
+  int n_occupied = 0;
+  lat.iterate_occupied_indices([&](int) { n_occupied++; });
+  COMPARE(n_occupied, 1024);
+
+  // Tiles empty in all processes are not communicated
+  lat.reset();
+  lat.mark_occupied({9, 0, 0}, {10, 1, 1});
+  TwoProcesses one_tile({0, 0});
+  lat.sum_over(one_tile);
+  COMPARE(one_tile.n_summed, 4u * 512u);
+}
+
 TEST(out_of_bounds) {
   auto lattice1 = create_lattice(true);
   // For periodic lattice nothing is out of bounds
@@ -86,6 +219,21 @@ TEST(cell_center) {
   VERIFY(r1 == r2);
 }
 
+TEST(index_at) {
+  for (bool periodic : {true, false}) {
+    auto lattice = create_lattice(periodic);
+    for (std::size_t i = 0; i < lattice->size(); i++) {
+      COMPARE(lattice->index_at(lattice->cell_center(i)), static_cast<int>(i));
+    }
+  }
+  const ThreeVector outside(11., 1., 1.);
+  COMPARE(create_lattice(false)->index_at(outside), -1);
+  // periodic lattices wrap the position around
+  auto lattice = create_lattice(true);
+  COMPARE(lattice->index_at(outside), lattice->index_at({1., 1., 1.}));
+  COMPARE(lattice->index_at({-1., -1., -1.}), lattice->index_at({9., 5., 1.}));
+}
+
 TEST(iterators) {
   auto lattice = create_lattice(false);
   // 1) Check that lattice size is as expected
@@ -391,6 +539,170 @@ TEST(gradient_periodic) {
       });
 }
 
+/*
+ * The gradient of a sparse lattice is computed only around the occupied
+ * tiles, but agrees with the one of the dense lattice.
+ */
+TEST(gradient_sparse) {
+  const std::array<double, 3> l = {9.0, 7.0, 13.0};
+  const std::array<int, 3> n = {30, 20, 40};
+  const std::array<double, 3> origin = {-5.2, -4.3, -6.7};
+  for (const bool periodicity : {true, false}) {
+    RectangularLattice<double> dense(l, n, origin, periodicity,
+                                     LatticeUpdate::EveryTimestep);
+    RectangularLattice<double> sparse(l, n, origin, periodicity,
+                                      LatticeUpdate::EveryTimestep);
+    sparse.set_sparse(true);
+    sparse.reset();
+    // A bump across the lower edges and one in the middle
+    for (const std::array<int, 3> lower :
+         {std::array<int, 3>{-2, -1, -3}, std::array<int, 3>{14, 9, 20}}) {
+      const std::array<int, 3> upper = {lower[0] + 4, lower[1] + 3,
+                                        lower[2] + 5};
+      sparse.mark_occupied(lower, upper);
+      for (RectangularLattice<double>* lat : {&dense, &sparse}) {
+        lat->iterate_indices_in_rectangle(
+            lat->cell_center(lower[0] + 2, lower[1] + 1, lower[2] + 2),
+            {0.8, 0.4, 0.8}, [&](int index, int ix, int iy, int iz) {
+              (*lat)[index] += 1. + ix + 2 * iy + 3 * iz;
+            });
+      }
+    }
+    RectangularLattice<ThreeVector> dense_grad(l, n, origin, periodicity,
+                                               LatticeUpdate::EveryTimestep);
+    RectangularLattice<ThreeVector> sparse_grad(l, n, origin, periodicity,
+                                                LatticeUpdate::EveryTimestep);
+    sparse_grad.set_sparse(true);
+    // Stale values from before are cleared
+    for (auto& node : sparse_grad) {
+      node = ThreeVector(1., 2., 3.);
+    }
+    dense.compute_gradient_lattice(dense_grad);
+    sparse.compute_gradient_lattice(sparse_grad);
+    for (std::size_t i = 0; i < dense.size(); i++) {
+      COMPARE(sparse[i], dense[i]);
+      COMPARE(sparse_grad[i], dense_grad[i]) << "node " << i;
+    }
+  }
+}
+
+/*
+ * The gradients computed by several threads agree exactly with the ones of a
+ * single thread and with central differences, which are one-sided on the
+ * boundaries of non-periodic lattices.
+ */
+TEST(gradients_with_threads) {
+  const std::array<double, 3> l = {9.0, 7.0, 13.0};
+  const std::array<int, 3> n = {7, 5, 23};
+  const std::array<double, 3> origin = {-5.2, -4.3, -6.7};
+  ThreadPool pool(3);
+  for (const bool periodicity : {true, false}) {
+    RectangularLattice<FourVector> old_lat(l, n, origin, periodicity,
+                                           LatticeUpdate::EveryTimestep);
+    RectangularLattice<FourVector> new_lat(l, n, origin, periodicity,
+                                           LatticeUpdate::EveryTimestep);
+    new_lat.iterate_sublattice({0, 0, 0}, n,
+                               [&](FourVector& node, int ix, int iy, int iz) {
+                                 node = FourVector(ix * iy, iz * iz, ix + iz,
+                                                   iy * iy * iz);
+                               });
+    old_lat.reset();
+    const double time_step = 0.2;
+    RectangularLattice<std::array<FourVector, 4>> grad_lat(
+        l, n, origin, periodicity, LatticeUpdate::EveryTimestep);
+    RectangularLattice<std::array<FourVector, 4>> threaded_grad_lat(
+        l, n, origin, periodicity, LatticeUpdate::EveryTimestep);
+    new_lat.compute_four_gradient_lattice(old_lat, time_step, grad_lat);
+    new_lat.compute_four_gradient_lattice(old_lat, time_step,
+                                          threaded_grad_lat, &pool);
+
+    const std::array<double, 3> dx = new_lat.cell_sizes();
+    grad_lat.iterate_sublattice(
+        {0, 0, 0}, n,
+        [&](std::array<FourVector, 4>& grad, int ix, int iy, int iz) {
+          const int index = grad_lat.index1d(ix, iy, iz);
+          COMPARE(threaded_grad_lat[index], grad);
+          COMPARE(grad[0], new_lat[index] / time_step);
+          const std::array<int, 3> i = {ix, iy, iz};
+          for (int axis = 0; axis < 3; axis++) {
+            std::array<int, 3> ahead = i, behind = i;
+            ahead[axis]++;
+            behind[axis]--;
+            double distance = 2 * dx[axis];
+            if (!periodicity && i[axis] == 0) {
+              behind = i;
+              distance = dx[axis];
+            } else if (!periodicity && i[axis] == n[axis] - 1) {
+              ahead = i;
+              distance = dx[axis];
+            }
+            const FourVector expected =
+                (new_lat.node(ahead[0], ahead[1], ahead[2]) -
+                 new_lat.node(behind[0], behind[1], behind[2])) /
+                distance;
+            for (int mu = 0; mu < 4; mu++) {
+              COMPARE_ABSOLUTE_ERROR(grad[axis + 1][mu], expected[mu], 1e-12)
+                  << "axis " << axis << ", node (" << ix << ", " << iy
+                  << ", " << iz << ")";
+            }
+          }
+        });
+
+    RectangularLattice<double> lat(l, n, origin, periodicity,
+                                   LatticeUpdate::EveryTimestep);
+    lat.iterate_sublattice({0, 0, 0}, n,
+                           [&](double& node, int ix, int iy, int iz) {
+                             node = ix * iy + iz * iz * iy;
+                           });
+    RectangularLattice<ThreeVector> grad(l, n, origin, periodicity,
+                                         LatticeUpdate::EveryTimestep);
+    RectangularLattice<ThreeVector> threaded_grad(
+        l, n, origin, periodicity, LatticeUpdate::EveryTimestep);
+    lat.compute_gradient_lattice(grad);
+    lat.compute_gradient_lattice(threaded_grad, &pool);
+    for (std::size_t k = 0; k < lat.size(); k++) {
+      COMPARE(threaded_grad[k], grad[k]) << "node " << k;
+    }
+  }
+}
+
+/*
+ * Lattices with long rows are swept in blocks of a few rows, which cover every
+ * node exactly once, with or without threads.
+ */
+TEST(gradient_in_blocks) {
+  const std::array<double, 3> l = {400.0, 9.0, 4.0};
+  const std::array<int, 3> n = {2000, 9, 4};
+  const std::array<double, 3> origin = {0., 0., 0.};
+  ThreadPool pool(3);
+  for (const bool periodicity : {true, false}) {
+    RectangularLattice<double> lat(l, n, origin, periodicity,
+                                   LatticeUpdate::EveryTimestep);
+    lat.iterate_sublattice({0, 0, 0}, n,
+                           [&](double& node, int ix, int iy, int iz) {
+                             node = ix + 2 * iy * iy + 3 * iz;
+                           });
+    RectangularLattice<ThreeVector> grad(l, n, origin, periodicity,
+                                         LatticeUpdate::EveryTimestep);
+    RectangularLattice<ThreeVector> threaded_grad(
+        l, n, origin, periodicity, LatticeUpdate::EveryTimestep);
+    lat.compute_gradient_lattice(grad);
+    lat.compute_gradient_lattice(threaded_grad, &pool);
+    const std::array<double, 3> dx = lat.cell_sizes();
+    // Away from the boundaries, the central differences are exact
+    grad.iterate_sublattice({1, 1, 1}, {n[0] - 1, n[1] - 1, n[2] - 1},
+                            [&](ThreeVector& g, int, int iy, int) {
+                              COMPARE_ABSOLUTE_ERROR(g.x1(), 1. / dx[0], 1e-9);
+                              COMPARE_ABSOLUTE_ERROR(g.x2(), 4. * iy / dx[1],
+                                                     1e-9);
+                              COMPARE_ABSOLUTE_ERROR(g.x3(), 3. / dx[2], 1e-9);
+                            });
+    for (std::size_t k = 0; k < lat.size(); k++) {
+      COMPARE(threaded_grad[k], grad[k]) << "node " << k;
+    }
+  }
+}
+
 /*
  * Test gradient for 2x2x2 lattice. The test is that it doesn't segfault.
  */
@@ -1050,3 +1362,114 @@ TEST(integrate_volume) {
   lattice.integrate_volume(integral, integrand, radius, r0);
   COMPARE_RELATIVE_ERROR(integral, 2 * M_PI * std::pow(radius, 4), 0.03);
 }
+
+/*
+ * Without interpolation, the value of the cell is taken as by value_at. With
+ * interpolation, linear fields are reproduced between the nodes, and lattices
+ * of the same geometry share the stencils.
+ */
+TEST(gather_interpolated) {
+  const std::array<double, 3> l = {4., 6., 8.};
+  const std::array<int, 3> n = {4, 3, 4};
+  const std::array<double, 3> origin = {-2., -3., 0.};
+  RectangularLattice<double> lat(l, n, origin, false,
+                                 LatticeUpdate::EveryTimestep);
+  RectangularLattice<std::pair<ThreeVector, ThreeVector>> pair_lat(
+      l, n, origin, false, LatticeUpdate::EveryTimestep);
+  auto field = [](const ThreeVector &r) {
+    return 1. + 2. * r.x1() - r.x2() + 0.5 * r.x3();
+  };
+  for (std::size_t i = 0; i < lat.size(); i++) {
+    const ThreeVector r = lat.cell_center(i);
+    lat[i] = field(r);
+    pair_lat[i] = std::make_pair(r, -2. * r);
+  }
+  const ThreeVector r(0.3, -0.4, 3.9);
+  double nearest = 0., value = 0.;
+  lat.value_at(r, nearest);
+  VERIFY(lat.gather_at(r, value));
+  COMPARE(value, nearest);
+
+  lat.set_interpolated(true);
+  VERIFY(!lat.shares_stencils(&pair_lat));
+  pair_lat.set_interpolated(true);
+  VERIFY(lat.shares_stencils(&pair_lat));
+  GatherStencil stencil;
+  VERIFY(lat.gather_stencil(r, stencil));
+  COMPARE(stencil.size, 8);
+  VERIFY(lat.gather(stencil, value));
+  COMPARE_ABSOLUTE_ERROR(value, field(r), 1e-12);
+  std::pair<ThreeVector, ThreeVector> pair_value;
+  VERIFY(pair_lat.gather(stencil, pair_value));
+  for (int d = 0; d < 3; d++) {
+    COMPARE_ABSOLUTE_ERROR(pair_value.first[d], r[d], 1e-12);
+    COMPARE_ABSOLUTE_ERROR(pair_value.second[d], -2. * r[d], 1e-12);
+  }
+
+  // beyond the outermost nodes, the value of the boundary node is kept
+  VERIFY(lat.gather_at(ThreeVector(1.9, -2.5, 1.), value));
+  COMPARE_ABSOLUTE_ERROR(value, field(ThreeVector(1.5, -2., 1.)), 1e-12);
+  VERIFY(!lat.gather_at(ThreeVector(2.1, 0., 1.), value));
+  COMPARE(value, 0.);
+}
+
+/// Interpolation on a periodic lattice wraps around between the boundaries.
+TEST(gather_interpolated_periodic) {
+  RectangularLattice<double> lat({4., 4., 4.}, {4, 4, 4}, {0., 0., 0.}, true,
+                                 LatticeUpdate::EveryTimestep);
+  lat.set_interpolated(true);
+  for (std::size_t i = 0; i < lat.size(); i++) {
+    lat[i] = lat.cell_center(i).x1() < 1. ? 1. : 0.;
+  }
+  double value = 0.;
+  VERIFY(lat.gather_at(ThreeVector(4., 2., 2.), value));
+  COMPARE_ABSOLUTE_ERROR(value, 0.5, 1e-12);
+  VERIFY(lat.gather_at(ThreeVector(-0.25, 2., 2.), value));
+  COMPARE_ABSOLUTE_ERROR(value, 0.25, 1e-12);
+}
+
+/*
+ * A lattice stored in single precision holds the values rounded to floats in
+ * half of the memory, and interpolates between them in double precision.
+ */
+TEST(single_precision_lattice) {
+  using Pair = std::pair<ThreeVector, ThreeVector>;
+  const std::array<double, 3> l = {4., 6., 8.};
+  const std::array<int, 3> n = {4, 3, 4};
+  const std::array<double, 3> origin = {-2., -3., 0.};
+  RectangularLattice<Pair> double_lat(l, n, origin, false,
+                                      LatticeUpdate::EveryTimestep);
+  RectangularLattice<Pair, SinglePrecision<Pair>> lat(
+      l, n, origin, false, LatticeUpdate::EveryTimestep);
+  COMPARE(2 * lat.memory_usage(), double_lat.memory_usage());
+  for (std::size_t i = 0; i < lat.size(); i++) {
+    const ThreeVector r = lat.cell_center(i);
+    lat.set(i, std::make_pair(r, ThreeVector(1. / 3., 0., r.x3())));
+    double_lat.set(i, lat.get(i));
+  }
+  COMPARE(lat.get(5).second.x1(), static_cast<double>(1.f / 3.f));
+  COMPARE(lat[5].second[0], 1.f / 3.f);
+
+  lat.set_interpolated(true);
+  double_lat.set_interpolated(true);
+  VERIFY(lat.shares_stencils(&double_lat));
+  const ThreeVector r(0.3, -0.4, 3.9);
+  Pair value, expected;
+  VERIFY(lat.gather_at(r, value));
+  VERIFY(double_lat.gather_at(r, expected));
+  for (int d = 0; d < 3; d++) {
+    COMPARE(value.first[d], expected.first[d]);
+    COMPARE(value.second[d], expected.second[d]);
+  }
+  VERIFY(lat.value_at(r, value));
+  VERIFY(double_lat.value_at(r, expected));
+  COMPARE(value.first, expected.first);
+
+  std::stringstream checkpoint;
+  lat.write_checkpoint(checkpoint);
+  lat.reset();
+  COMPARE(lat.get(5).first, ThreeVector());
+  lat.read_checkpoint(checkpoint);
+  COMPARE(lat.get(5).first, double_lat.get(5).first);
+  COMPARE(lat.get(5).second, double_lat.get(5).second);
+}
@@ -1,6 +1,6 @@
 /*
  *
- *    Copyright (c) 2017-2020,2022-2023
+ *    Copyright (c) 2017-2020,2022-2024
  *      SMASH Team
  *
  *    GNU General Public License (GPLv3 or later)
@@ -15,6 +15,7 @@
 #include <string>
 
 #include "setup.h"
+#include "smash/binaryoutput.h"
 #include "smash/oscaroutput.h"
 #include "smash/particles.h"
 
@@ -121,13 +122,15 @@ static ListBoxModus create_list_box_modus_for_test() {
   return ListBoxModus(std::move(config), parameters);
 }
 
-static ListModus create_list_modus_with_single_file_for_test() {
+static ListModus create_list_modus_with_single_file_for_test(
+    bool prefetch = false) {
   Configuration config{R"(
     List:
       File_Directory: ToBeSet
       Filename: event0
     )"};
   config.set_value({"List", "File_Directory"}, testoutputpath.string());
+  config.set_value({"List", "Prefetch"}, prefetch);
   return ListModus(std::move(config), parameters);
 }
 
@@ -459,6 +462,74 @@ TEST(multiple_events_in_file) {
   }
 }
 
+TEST(prefetched_events_in_file) {
+  OutputParameters out_par = OutputParameters();
+  out_par.part_only_final = OutputOnlyFinal::Yes;
+  out_par.part_extended = false;
+  constexpr int max_events = 5;
+  std::vector<ParticleList> init_particles;
+  create_particlefile(out_par, 0, init_particles, 3, max_events);
+  ListModus list_modus = create_list_modus_with_single_file_for_test(true);
+
+  for (int cur_event = 0; cur_event < max_events; cur_event++) {
+    Particles particles_read;
+    list_modus.initial_conditions(&particles_read, parameters);
+    const ParticleList p_init = init_particles[cur_event];
+    const ParticleList p_fin = particles_read.copy_to_vector();
+    COMPARE(p_fin.size(), p_init.size());
+    for (size_t i = 0; i < p_fin.size(); i++) {
+      compare_fourvector(p_init[i].momentum(), p_fin[i].momentum());
+      COMPARE(p_init[i].pdgcode(), p_fin[i].pdgcode());
+    }
+  }
+  // there are no further events in the file
+  bool further_event_read = true;
+  try {
+    Particles particles_read;
+    list_modus.initial_conditions(&particles_read, parameters);
+  } catch (const std::runtime_error &) {
+    further_event_read = false;
+  }
+  VERIFY(!further_event_read);
+}
+
+TEST(binary_input) {
+  OutputParameters out_par = OutputParameters();
+  out_par.part_only_final = OutputOnlyFinal::No;
+  out_par.part_extended = true;
+  constexpr int max_events = 2;
+  std::vector<ParticleList> final_particles;
+  {
+    BinaryOutputParticles output(testoutputpath, "Particles", out_par);
+    const EventInfo event = Test::default_event_info();
+    for (int event_number = 0; event_number < max_events; event_number++) {
+      const auto particles =
+          Test::create_particles(4, [] { return Test::smashon_random(); });
+      output.at_eventstart(*particles, event_number, event);
+      // only the particles at the end of the event are read
+      particles->remove(particles->front());
+      output.at_eventend(*particles, event_number, event);
+      final_particles.push_back(particles->copy_to_vector());
+    }
+  }
+  std::filesystem::rename(testoutputpath / "particles_binary.bin",
+                          testoutputpath / "event0");
+  ListModus list_modus = create_list_modus_with_single_file_for_test();
+
+  for (int cur_event = 0; cur_event < max_events; cur_event++) {
+    Particles particles_read;
+    list_modus.initial_conditions(&particles_read, parameters);
+    const ParticleList &p_init = final_particles[cur_event];
+    const ParticleList p_fin = particles_read.copy_to_vector();
+    COMPARE(p_fin.size(), p_init.size());
+    for (size_t i = 0; i < p_fin.size(); i++) {
+      // the three-momenta are read without loss
+      COMPARE(p_fin[i].momentum().threevec(), p_init[i].momentum().threevec());
+      COMPARE(p_fin[i].pdgcode(), p_init[i].pdgcode());
+    }
+  }
+}
+
 TEST(try_create_particle_func) {
   ListModus list_modus = create_list_modus_for_test();
   Particles particles;
@@ -0,0 +1,49 @@
+/*
+ *
+ *    Copyright (c) 2024
+ *      SMASH Team
+ *
+ *    GNU General Public License (GPLv3 or later)
+ *
+ */
+
+#include "vir/test.h"  // This include has to be first
+
+#include "smash/logging.h"
+
+#include <thread>
+#include <vector>
+
+using namespace smash;
+
+static constexpr int LMain = LogArea::Main::id;
+
+TEST(rate_limited_warning) {
+  RateLimitedWarning warning(LMain, "Test warning", 2);
+  VERIFY(warning.count());
+  warning.warn("Written");
+  VERIFY(!warning.count());
+  warning.warn("Only counted");
+  COMPARE(warning.occurrences(), 4u);
+  summarize_rate_limited_warnings();
+  COMPARE(warning.occurrences(), 0u);
+  VERIFY(warning.count());
+}
+
+TEST(rate_limited_warning_in_threads) {
+  RateLimitedWarning warning(LMain, "Test warning", 0);
+  std::vector<std::thread> threads;
+  for (int i = 0; i < 4; i++) {
+    threads.emplace_back([&warning] {
+      for (int j = 0; j < 1000; j++) {
+        warning.warn("Never written");
+      }
+    });
+  }
+  for (std::thread &thread : threads) {
+    thread.join();
+  }
+  COMPARE(warning.occurrences(), 4000u);
+  warning.summarize();
+  COMPARE(warning.occurrences(), 0u);
+}
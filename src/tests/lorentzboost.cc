@@ -1,5 +1,5 @@
 /*
- *    Copyright (c) 2014-2015,2017-2022
+ *    Copyright (c) 2014-2015,2017-2022,2024
  *      SMASH Team
  *
  *    GNU General Public License (GPLv3 or later)
@@ -89,3 +89,16 @@ TEST(back_and_forth) {
     }
   }
 }
+
+// The boost with precomputed factors gives the same vectors
+TEST(boost_many_vectors) {
+  for (int i = 0; i < 1000; i++) {
+    const ThreeVector velocity = random_velocity();
+    const LorentzBoost boost(velocity);
+    for (int j = 0; j < 100; j++) {
+      const FourVector a(cos_like(), cos_like(), cos_like(), cos_like());
+      COMPARE(boost(a).x0(), a.lorentz_boost(velocity).x0());
+      COMPARE(boost(a).threevec(), a.lorentz_boost(velocity).threevec());
+    }
+  }
+}
@@ -0,0 +1,57 @@
+/*
+ *
+ *    Copyright (c) 2024
+ *      SMASH Team
+ *
+ *    GNU General Public License (GPLv3 or later)
+ *
+ */
+
+#include "vir/test.h"  // This include has to be first
+
+#include "smash/memoryusage.h"
+
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+using namespace smash;
+
+TEST(peak) {
+  MemoryUsage usage;
+  usage.set(MemoryUsage::Subsystem::Grids, 3 << 20);
+  usage.set(MemoryUsage::Subsystem::Grids, 1 << 20);
+  usage.set_pythia_instances(2);
+  const std::string report = usage.report();
+  // The grid line shows the current and the peak usage in MiB
+  VERIFY(report.find("Grids") != std::string::npos) << report;
+  VERIFY(report.find("1.0          3.0") != std::string::npos) << report;
+  VERIFY(report.find("2 PYTHIA objects") != std::string::npos) << report;
+}
+
+TEST(resident_set_size) {
+  const std::size_t before = MemoryUsage::resident_set_size();
+  VERIFY(before > 0);
+  // Touch 64 MiB, which has to show up in the resident set size
+  std::vector<char> memory(64 << 20, 1);
+  const std::size_t after = MemoryUsage::resident_set_size();
+  VERIFY(after >= before + (60 << 20)) << before << " " << after;
+  VERIFY(MemoryUsage::peak_resident_set_size() >= after);
+  COMPARE(memory[12345], 1);
+}
+
+TEST(limit) {
+  MemoryUsage unlimited;
+  unlimited.check_limit();
+  MemoryUsage limited(1);
+  bool thrown = false;
+  try {
+    limited.check_limit();
+  } catch (const std::runtime_error &error) {
+    thrown = true;
+    const std::string message = error.what();
+    VERIFY(message.find("memory limit") != std::string::npos) << message;
+    VERIFY(message.find("Particles") != std::string::npos) << message;
+  }
+  VERIFY(thrown);
+}
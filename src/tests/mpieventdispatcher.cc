@@ -0,0 +1,101 @@
+/*
+ *
+ *    Copyright (c) 2024
+ *      SMASH Team
+ *
+ *    GNU General Public License (GPLv3 or later)
+ *
+ */
+
+#include "vir/test.h"  // This include has to be first
+
+#include "smash/mpieventdispatcher.h"
+
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+
+using namespace smash;
+
+static const std::filesystem::path testoutputpath =
+    std::filesystem::absolute(SMASH_TEST_OUTPUT_PATH);
+
+/**
+ * Initializes MPI before the first and finalizes it after the last test. The
+ * tests expect to be run by a single process.
+ */
+static const struct MpiEnvironment {
+  MpiEnvironment() { MPI_Init(nullptr, nullptr); }
+  ~MpiEnvironment() { MPI_Finalize(); }
+} mpi_environment;
+
+/// \return Content of the file
+static std::string read_file(const std::filesystem::path &path) {
+  std::ifstream in(path);
+  std::stringstream content;
+  content << in.rdbuf();
+  return content.str();
+}
+
+TEST(single_process) {
+  int size = 0;
+  MPI_Comm_size(MPI_COMM_WORLD, &size);
+  COMPARE(size, 1);
+}
+
+TEST(take_event) {
+  MpiEventDispatcher dispatcher(MPI_COMM_WORLD);
+  COMPARE(dispatcher.rank(), 0);
+  int nonempty_total = -1;
+  COMPARE(dispatcher.take_event(2, nonempty_total), 0);
+  COMPARE(nonempty_total, 2);
+  COMPARE(dispatcher.take_event(0, nonempty_total), 1);
+  COMPARE(nonempty_total, 2);
+  COMPARE(dispatcher.take_event(3, nonempty_total), 2);
+  COMPARE(nonempty_total, 5);
+}
+
+TEST(counters_start_anew) {
+  {
+    MpiEventDispatcher dispatcher(MPI_COMM_WORLD);
+    int nonempty_total = 0;
+    dispatcher.take_event(4, nonempty_total);
+  }
+  MpiEventDispatcher dispatcher(MPI_COMM_WORLD);
+  int nonempty_total = -1;
+  COMPARE(dispatcher.take_event(1, nonempty_total), 0);
+  COMPARE(nonempty_total, 1);
+}
+
+TEST(directory) {
+  COMPARE(MpiEventDispatcher::directory(0), "rank_0");
+  COMPARE(MpiEventDispatcher::directory(12), "rank_12");
+}
+
+TEST(write_event_index) {
+  std::filesystem::create_directories(testoutputpath);
+  const std::filesystem::path path = testoutputpath / "event_index.txt";
+  const MpiEventDispatcher dispatcher(MPI_COMM_WORLD);
+  dispatcher.write_event_index(path, {2, 0, 3, 1});
+  COMPARE(read_file(path),
+          "# event directory\n"
+          "0 rank_0\n"
+          "1 rank_0\n"
+          "2 rank_0\n"
+          "3 rank_0\n");
+}
+
+TEST(write_empty_event_index) {
+  std::filesystem::create_directories(testoutputpath);
+  const std::filesystem::path path = testoutputpath / "empty_event_index.txt";
+  const MpiEventDispatcher dispatcher(MPI_COMM_WORLD);
+  dispatcher.write_event_index(path, {});
+  COMPARE(read_file(path), "# event directory\n");
+}
+
+TEST_CATCH(write_event_index_fails, std::runtime_error) {
+  const MpiEventDispatcher dispatcher(MPI_COMM_WORLD);
+  dispatcher.write_event_index(testoutputpath / "missing" / "index.txt", {0});
+}
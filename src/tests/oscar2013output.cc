@@ -1,6 +1,6 @@
 /*
  *
- *    Copyright (c) 2014-2020,2022-2023
+ *    Copyright (c) 2014-2020,2022-2024
  *      SMASH Team
  *
  *    GNU General Public License (GPLv3 or later)
@@ -10,6 +10,7 @@
 #include "vir/test.h"  // This include has to be first
 
 #include <array>
+#include <cstdio>
 #include <filesystem>
 #include <map>
 #include <string>
@@ -298,6 +299,46 @@ TEST(final2013_format) {
   VERIFY(std::filesystem::remove(outputfilepath));
 }
 
+/*
+ * The particle lines are formatted exactly like by std::printf with the "%g"
+ * and "%.9g" conversions.
+ */
+TEST(particle_lines_as_printf) {
+  Particles particles;
+  for (int i = 0; i < 10; i++) {
+    particles.insert(Test::smashon_random());
+  }
+  const std::filesystem::path outputfilepath =
+      testoutputpath / "particle_lists.oscar";
+  {
+    OutputParameters out_par = OutputParameters();
+    out_par.part_only_final = OutputOnlyFinal::Yes;
+    std::unique_ptr<OutputInterface> output =
+        create_oscar_output("Oscar2013", "Particles", testoutputpath, out_par);
+    output->at_eventend(particles, 0, Test::default_event_info());
+  }
+  std::ifstream outputfile(outputfilepath);
+  std::string line;
+  for (int i = 0; i < 4; i++) {
+    std::getline(outputfile, line);
+  }
+  for (const ParticleData &data : particles) {
+    const FourVector pos = data.position();
+    const FourVector mom = data.momentum();
+    char expected[256];
+    std::snprintf(expected, sizeof(expected),
+                  "%g %g %g %g %g %.9g %.9g %.9g %.9g %s %i %i", pos.x0(),
+                  pos.x1(), pos.x2(), pos.x3(), data.effective_mass(),
+                  mom.x0(), mom.x1(), mom.x2(), mom.x3(),
+                  data.pdgcode().string().c_str(), data.id(),
+                  data.type().charge());
+    std::getline(outputfile, line);
+    COMPARE(line, expected);
+  }
+  outputfile.close();
+  VERIFY(std::filesystem::remove(outputfilepath));
+}
+
 TEST(full_extended_oscar) {
   const std::filesystem::path outputfilename = "full_event_history.oscar";
   const std::filesystem::path outputfilepath = testoutputpath / outputfilename;
@@ -0,0 +1,145 @@
+/*
+ *
+ *    Copyright (c) 2024
+ *      SMASH Team
+ *
+ *    GNU General Public License (GPLv3 or later)
+ *
+ */
+
+#include "vir/test.h"  // This include has to be first
+
+#include "smash/outputfilter.h"
+
+#include <cmath>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "setup.h"
+#include "smash/configuration.h"
+#include "smash/wallcrossingaction.h"
+
+using namespace smash;
+
+namespace {
+/// Output which only remembers what it was asked to write
+class LoggingOutput : public OutputInterface {
+ public:
+  explicit LoggingOutput(std::vector<std::string> *log)
+      : OutputInterface("Particles"), log_(log) {}
+  void at_eventstart(const Particles &particles, const int event_number,
+                     const EventInfo &) override {
+    log_->push_back("start " + std::to_string(event_number) + " " +
+                    std::to_string(particles.size()));
+  }
+  void at_eventend(const std::vector<Particles> &ensembles,
+                   const int event_number) override {
+    log_->push_back("end " + std::to_string(event_number) + " " +
+                    std::to_string(ensembles.size()));
+  }
+  void at_interaction(const Action &action, const double) override {
+    log_->push_back("interaction " +
+                    std::to_string(action.incoming_particles()[0].id()));
+  }
+
+ private:
+  std::vector<std::string> *log_;
+};
+
+/// A smashon with the given momentum
+ParticleData smashon(double px, double pz) {
+  const double m = Test::smashon_mass;
+  return Test::smashon(Test::Momentum{std::sqrt(m * m + px * px + pz * pz),
+                                      px, 0., pz});
+}
+}  // namespace
+
+TEST(init_particle_types) { Test::create_smashon_particletypes(); }
+
+TEST(everything_by_default) {
+  const OutputFilter filter;
+  VERIFY(!filter.is_active());
+  VERIFY(filter.selects(smashon(0.3, 5.)));
+  VERIFY(filter.selects_event(7));
+  VERIFY(filter.selects_ensemble(3));
+  VERIFY(!OutputFilter(Configuration{"Every_Nth_Event: 1"}).is_active());
+}
+
+TEST(particles) {
+  const OutputFilter filter(Configuration{R"(
+    PDG: [661]
+    Rapidity: [-0.5, 0.5]
+    Transverse_Momentum: [0.1, 1.0]
+  )"});
+  VERIFY(filter.is_active());
+  VERIFY(filter.filters_particles());
+  VERIFY(filter.selects(smashon(0.3, 0.)));
+  VERIFY(filter.selects(smashon(0.3, 0.1)));
+  VERIFY(!filter.selects(smashon(0.3, 5.)));
+  VERIFY(!filter.selects(smashon(0.05, 0.)));
+  VERIFY(!filter.selects(smashon(2., 0.)));
+
+  const OutputFilter other_species(Configuration{"PDG: [211]"});
+  VERIFY(!other_species.selects(smashon(0.3, 0.)));
+
+  const OutputFilter eta(Configuration{"Pseudorapidity: [-1, 1]"});
+  // p_z = p_T sinh(eta)
+  VERIFY(eta.selects(smashon(0.3, 0.3 * std::sinh(0.9))));
+  VERIFY(!eta.selects(smashon(0.3, 0.3 * std::sinh(1.1))));
+  VERIFY(!eta.selects(smashon(0., 0.1)));
+  VERIFY(eta.selects(smashon(0., 0.)));
+}
+
+TEST(interactions) {
+  const ParticleData slow = smashon(0.01, 0.), fast = smashon(0.5, 0.);
+  const WallcrossingAction wall(slow, slow);
+  const OutputFilter walls(Configuration{"Process_Types: [6, 1]"});
+  VERIFY(walls.selects(wall));
+  const OutputFilter elastic(Configuration{"Process_Types: [1]"});
+  VERIFY(!elastic.selects(wall));
+  const OutputFilter fast_ones(Configuration{"Transverse_Momentum: [0.1, 1]"});
+  VERIFY(!fast_ones.selects(wall));
+  VERIFY(fast_ones.selects(WallcrossingAction(slow, fast)));
+}
+
+TEST_CATCH(empty_range, std::invalid_argument) {
+  const OutputFilter filter(Configuration{"Rapidity: [1, -1]"});
+}
+
+TEST_CATCH(no_events, std::invalid_argument) {
+  const OutputFilter filter(Configuration{"Every_Nth_Event: 0"});
+}
+
+TEST(filtered_output) {
+  std::vector<std::string> log;
+  FilteredOutput output(std::make_unique<LoggingOutput>(&log),
+                        OutputFilter(Configuration{R"(
+                          Every_Nth_Event: 2
+                          Ensembles: [1]
+                          Transverse_Momentum: [0.1, 1]
+                        )"}),
+                        2);
+  std::vector<Particles> ensembles(2);
+  for (Particles &particles : ensembles) {
+    particles.insert(smashon(0.01, 0.));
+    particles.insert(smashon(0.5, 0.));
+  }
+  const int fast_id = ensembles[1].back().id();
+  for (int event = 0; event < 3; event++) {
+    for (int i = 0; i < 2; i++) {
+      output.at_eventstart(ensembles[i], 2 * event + i,
+                           Test::default_event_info());
+    }
+    output.at_interaction(
+        WallcrossingAction(ensembles[1].front(), ensembles[1].front()), 0.);
+    output.at_interaction(
+        WallcrossingAction(ensembles[1].back(), ensembles[1].back()), 0.);
+    output.at_eventend(ensembles, event);
+  }
+  const std::string interaction = "interaction " + std::to_string(fast_id);
+  const std::vector<std::string> expected = {
+      "start 1 1", interaction, "end 0 1", "start 5 1", interaction, "end 2 1"};
+  COMPARE(log, expected);
+}
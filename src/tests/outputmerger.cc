@@ -0,0 +1,148 @@
+/*
+ *
+ *    Copyright (c) 2024
+ *      SMASH Team
+ *
+ *    GNU General Public License (GPLv3 or later)
+ *
+ */
+
+#include "vir/test.h"  // This include has to be first
+
+#include "smash/outputmerger.h"
+
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "setup.h"
+#include "smash/particles.h"
+#include "smash/wallcrossingaction.h"
+
+using namespace smash;
+
+namespace {
+/// Output which only remembers what it was asked to write
+class LoggingOutput : public OutputInterface {
+ public:
+  explicit LoggingOutput(std::vector<std::string> *log,
+                         std::string name = "Particles")
+      : OutputInterface(name), log_(log) {}
+  void at_eventstart(const Particles &particles, const int event_number,
+                     const EventInfo &) override {
+    log_->push_back("start " + std::to_string(event_number) + " " +
+                    std::to_string(particles.size()));
+  }
+  void at_eventend(const Particles &particles, const int event_number,
+                   const EventInfo &) override {
+    log_->push_back("end " + std::to_string(event_number) + " " +
+                    std::to_string(particles.front().id()));
+  }
+  void at_interaction(const Action &action, const double) override {
+    log_->push_back("interaction " + std::to_string(action.get_type() ==
+                                                    ProcessType::Wall) +
+                    " " + std::to_string(action.incoming_particles().size()));
+  }
+
+ private:
+  std::vector<std::string> *log_;
+};
+
+/// Write one event with one particle of the given id
+void write_event(OutputInterface &output, int event, int id) {
+  Particles particles;
+  for (int i = 0; i <= id; i++) {
+    particles.insert(Test::smashon());
+  }
+  for (int i = 0; i < id; i++) {
+    particles.remove(particles.front());
+  }
+  output.at_eventstart(particles, event, Test::default_event_info());
+  output.at_interaction(
+      WallcrossingAction(particles.front(), particles.front()), 0.);
+  output.at_eventend(particles, event, Test::default_event_info());
+}
+}  // namespace
+
+TEST(init_particle_types) { Test::create_smashon_particletypes(); }
+
+TEST(deferred_output_keeps_kind) {
+  std::vector<std::string> log;
+  const LoggingOutput dileptons(&log, "Dileptons"), photons(&log, "Photons"),
+      ic(&log, "SMASH_IC"), particles(&log);
+  VERIFY(DeferredOutput(dileptons).is_dilepton_output());
+  VERIFY(DeferredOutput(photons).is_photon_output());
+  VERIFY(DeferredOutput(ic).is_IC_output());
+  const DeferredOutput deferred(particles);
+  VERIFY(!deferred.is_dilepton_output() && !deferred.is_photon_output() &&
+         !deferred.is_IC_output());
+}
+
+TEST(deferred_output_copies_arguments) {
+  std::vector<std::string> log;
+  LoggingOutput target(&log);
+  DeferredOutput deferred(target);
+  Particles particles;
+  particles.insert(Test::smashon());
+  deferred.at_eventstart(particles, 3, Test::default_event_info());
+  particles.insert(Test::smashon());
+  deferred.at_eventstart(particles, 4, Test::default_event_info());
+  VERIFY(log.empty());
+  for (const auto &call : deferred.take_calls()) {
+    call(target);
+  }
+  COMPARE(log, std::vector<std::string>({"start 3 1", "start 4 2"}));
+  VERIFY(deferred.take_calls().empty());
+}
+
+TEST(events_are_written_in_order) {
+  std::vector<std::string> log;
+  OutputsList outputs;
+  outputs.emplace_back(std::make_unique<LoggingOutput>(&log));
+  OutputMerger merger(std::move(outputs));
+  OutputsList worker_a = merger.make_deferred_outputs();
+  OutputsList worker_b = merger.make_deferred_outputs();
+  COMPARE(worker_a.size(), 1u);
+
+  write_event(*worker_a[0], 1, 11);
+  merger.submit(1, worker_a);
+  VERIFY(log.empty());
+  COMPARE(merger.written_events(), 0);
+  write_event(*worker_b[0], 0, 10);
+  merger.submit(0, worker_b);
+  COMPARE(merger.written_events(), 2);
+  COMPARE(log, std::vector<std::string>({"start 0 1", "interaction 1 1",
+                                         "end 0 10", "start 1 1",
+                                         "interaction 1 1", "end 1 11"}));
+}
+
+TEST(last_event) {
+  std::vector<std::string> log;
+  OutputsList outputs;
+  outputs.emplace_back(std::make_unique<LoggingOutput>(&log));
+  OutputMerger merger(std::move(outputs));
+  OutputsList deferred = merger.make_deferred_outputs();
+  std::vector<int> bookkept;
+  auto bookkeeping = [&](int event) {
+    return [&, event]() {
+      bookkept.push_back(event);
+      if (event == 1) {
+        merger.set_last_event(event);
+      }
+    };
+  };
+  for (int event : {2, 1, 3}) {
+    write_event(*deferred[0], event, event);
+    merger.submit(event, deferred, bookkeeping(event));
+  }
+  VERIFY(merger.accepts(3));
+  write_event(*deferred[0], 0, 0);
+  merger.submit(0, deferred, bookkeeping(0));
+  // Event 1 stopped the output, the events after it are dropped
+  COMPARE(bookkept, std::vector<int>({0, 1}));
+  COMPARE(merger.written_events(), 2);
+  VERIFY(merger.accepts(1));
+  VERIFY(!merger.accepts(2));
+  COMPARE(log.size(), 6u);
+  COMPARE(log.back(), "end 1 1");
+}
@@ -11,8 +11,12 @@
 
 #include "smash/parametrizations.h"
 
+#include <vector>
+
 #include "setup.h"
 #include "smash/clebschgordan.h"
+#include "smash/constants.h"
+#include "smash/kinematics.h"
 
 using namespace smash;
 
@@ -30,3 +34,60 @@ TEST(clebsch_kaon_charge_exchange) {
   // We assume they are same in crosssections.cc.
   COMPARE_ABSOLUTE_ERROR(cg1, cg2, tolerance);
 }
+
+TEST(tables_of_parametrizations) {
+  const ParametrizationTables& tables = ParametrizationTables::get();
+  COMPARE(&tables, &ParametrizationTables::get());
+  std::vector<double> p_lab, mandelstam_s;
+  for (double p = 0.2; p < 8.; p += 0.05) {
+    p_lab.push_back(p);
+    mandelstam_s.push_back(s_from_plab(p, kaon_mass, nucleon_mass));
+  }
+  std::vector<double> total(p_lab.size());
+  tables.kminusp_total.evaluate(p_lab.data(), p_lab.size(), total.data());
+  for (std::size_t i = 0; i < p_lab.size(); i++) {
+    COMPARE_RELATIVE_ERROR(total[i], kminusp_total(mandelstam_s[i]), 1e-12)
+        << p_lab[i];
+    COMPARE_RELATIVE_ERROR(
+        tables.kplusp_total(p_lab[i]) -
+            kplusp_elastic_background(mandelstam_s[i]),
+        kplusp_inelastic_background(mandelstam_s[i]), 1e-12)
+        << p_lab[i];
+  }
+}
+
+TEST(batch_parametrizations) {
+  std::vector<double> sqrts, mandelstam_s;
+  for (double x = 1.9; x < 200.; x *= 1.01) {
+    sqrts.push_back(x);
+    mandelstam_s.push_back(x * x);
+  }
+  const std::size_t n = sqrts.size();
+  std::vector<double> xs(n);
+  using Batch = void (*)(const double*, std::size_t, double*);
+  using Scalar = double (*)(double);
+  auto compare = [&](Batch batch, Scalar scalar,
+                     const std::vector<double>& x) {
+    batch(x.data(), n, xs.data());
+    for (std::size_t i = 0; i < n; i++) {
+      COMPARE_RELATIVE_ERROR(xs[i], scalar(x[i]), 1e-12) << x[i];
+    }
+  };
+  compare(pp_elastic, pp_elastic, mandelstam_s);
+  compare(pp_total, pp_total, mandelstam_s);
+  compare(np_elastic, np_elastic, mandelstam_s);
+  compare(np_total, np_total, mandelstam_s);
+  compare(ppbar_elastic, ppbar_elastic, mandelstam_s);
+  compare(ppbar_total, ppbar_total, mandelstam_s);
+  compare(piplusp_elastic, piplusp_elastic, mandelstam_s);
+  compare(piminusp_elastic, piminusp_elastic, mandelstam_s);
+  compare(piminusp_high_energy, piminusp_high_energy, mandelstam_s);
+  compare(piplusp_total, piplusp_total, sqrts);
+  compare(piminusp_total, piminusp_total, sqrts);
+  compare(pipluspiminus_total, pipluspiminus_total, sqrts);
+  compare(pizeropizero_total, pizeropizero_total, sqrts);
+  compare(kplusp_total, kplusp_total, mandelstam_s);
+  compare(kplusn_total, kplusn_total, mandelstam_s);
+  compare(kminusp_total, kminusp_total, mandelstam_s);
+  compare(kminusn_total, kminusn_total, mandelstam_s);
+}
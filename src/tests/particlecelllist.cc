@@ -0,0 +1,102 @@
+/*
+ *
+ *    Copyright (c) 2024
+ *      SMASH Team
+ *
+ *    GNU General Public License (GPLv3 or later)
+ *
+ */
+
+#include "vir/test.h"  // This include has to be first
+
+#include "smash/particlecelllist.h"
+
+#include <vector>
+
+#include "setup.h"
+#include "smash/density.h"
+#include "smash/particledata.h"
+#include "smash/random.h"
+
+using namespace smash;
+
+TEST(init_particle_types) {
+  ParticleType::create_type_list(
+      "# NAME MASS[GEV] WIDTH[GEV] PARITY PDG\n"
+      "N+ 0.938 0.0 + 2212\n"
+      "N0 0.938 0.0 + 2112\n"
+      "π⁺ 0.138 0.0 -  211\n");
+}
+
+/// Particles in a flat slab, like a Lorentz-contracted nucleus
+static ParticleList create_slab(int n) {
+  random::set_seed(7);
+  ParticleList plist;
+  for (int i = 0; i < n; i++) {
+    const PdgCode pdg = i % 3 == 0 ? 0x211 : i % 3 == 1 ? 0x2212 : 0x2112;
+    ParticleData p{ParticleType::find(pdg)};
+    p.set_4position(FourVector(0., random::uniform(-6., 6.),
+                               random::uniform(-6., 6.),
+                               random::uniform(-0.5, 0.5)));
+    p.set_4momentum(p.pole_mass(), random::uniform(-0.5, 0.5),
+                    random::uniform(-0.5, 0.5), random::uniform(-3., 3.));
+    plist.push_back(p);
+  }
+  return plist;
+}
+
+TEST(neighbors_within_r_cut) {
+  const ParticleList plist = create_slab(500);
+  const double r_cut = 2.2;
+  const ParticleCellList cells(plist, r_cut);
+  std::vector<const ParticleData *> neighbors;
+  for (int k = 0; k < 100; k++) {
+    const ThreeVector r(random::uniform(-9., 9.), random::uniform(-9., 9.),
+                        random::uniform(-3., 3.));
+    cells.find_neighbors(r, neighbors);
+    // The neighbors are in the order of the list
+    for (std::size_t i = 1; i < neighbors.size(); i++) {
+      VERIFY(neighbors[i - 1] < neighbors[i]);
+    }
+    std::size_t next = 0;
+    for (const ParticleData &p : plist) {
+      if (next < neighbors.size() && neighbors[next] == &p) {
+        next++;
+      } else {
+        VERIFY((p.position().threevec() - r).abs() > r_cut) << r;
+      }
+    }
+    COMPARE(next, neighbors.size());
+  }
+  // Far away from all particles
+  cells.find_neighbors(ThreeVector(100., 0., 0.), neighbors);
+  VERIFY(neighbors.empty());
+}
+
+TEST(current_equals_sum_over_all_particles) {
+  const ParticleList plist = create_slab(300);
+  const DensityParameters par(Test::default_parameters());
+  const ParticleCellList cells(plist, par.r_cut());
+  for (int k = 0; k < 50; k++) {
+    const ThreeVector r(random::uniform(-7., 7.), random::uniform(-7., 7.),
+                        random::uniform(-2., 2.));
+    for (const DensityType type : {DensityType::Baryon, DensityType::Pion}) {
+      const auto all = current_eckart(r, plist, par, type, true, true);
+      const auto near = current_eckart(r, cells, par, type, true, true);
+      // The same particles are summed in the same order
+      COMPARE(std::get<0>(near), std::get<0>(all));
+      COMPARE(std::get<1>(near), std::get<1>(all));
+      COMPARE(std::get<2>(near), std::get<2>(all));
+      COMPARE(std::get<3>(near), std::get<3>(all));
+      COMPARE(std::get<4>(near), std::get<4>(all));
+    }
+  }
+}
+
+TEST(empty_list) {
+  const ParticleList plist;
+  const ParticleCellList cells(plist, 2.);
+  std::vector<const ParticleData *> neighbors;
+  cells.find_neighbors(ThreeVector(0., 0., 0.), neighbors);
+  VERIFY(neighbors.empty());
+}
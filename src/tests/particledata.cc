@@ -1,6 +1,6 @@
 /*
  *
- *    Copyright (c) 2014-2018,2020,2022-2023
+ *    Copyright (c) 2014-2018,2020,2022-2024
  *      SMASH Team
  *
  *    GNU General Public License (GPLv3 or later)
@@ -9,6 +9,8 @@
 
 #include "vir/test.h"  // This include has to be first
 
+#include <cmath>
+
 #include "setup.h"
 #include "smash/pdgcode.h"
 
@@ -134,6 +136,22 @@ TEST(set_get2) {
   COMPARE_RELATIVE_ERROR(p.inverse_gamma(), 1., 1e-15);
 }
 
+TEST(decay_time) {
+  ParticleData p = Test::smashon();
+  VERIFY(std::isnan(p.decay_time()));
+  p.set_decay_time(3.5);
+  COMPARE(p.decay_time(), 3.5);
+  // the decay time is kept by copies ...
+  const ParticleData q = p;
+  COMPARE(q.decay_time(), 3.5);
+  // ... but not when the momentum changes
+  p.set_4momentum(1.0, ThreeVector(0.1, 0.2, 0.3));
+  VERIFY(std::isnan(p.decay_time()));
+  p.set_decay_time(3.5);
+  p.set_3momentum(ThreeVector(0.1, 0.2, 0.3));
+  VERIFY(std::isnan(p.decay_time()));
+}
+
 TEST(comparisons) {
   ParticleData p = Test::smashon(1);
   ParticleData q = Test::smashon(2);
@@ -153,6 +171,24 @@ TEST(translation) {
   COMPARE(p.translated({1, 2, 3}).position(), FourVector(0, 1, 2, 3));
 }
 
+TEST(slow_formation) {
+  const double saved_power = ParticleData::formation_power_;
+  ParticleData p = Test::smashon(Test::Position{0, 0, 0, 0});
+  p.set_cross_section_scaling_factor(0.2);
+  p.set_slow_formation_times(1., 3.);
+  COMPARE(p.xsec_scaling_factor(0.5), 0.2);
+  COMPARE(p.xsec_scaling_factor(3.5), 1.);
+  for (double power : {0.5, 1., 1.5, 2., 3., 0.7, 2.3, 20.}) {
+    ParticleData::formation_power_ = power;
+    for (double t : {1.1, 1.5, 2., 2.9}) {
+      const double expected = 0.2 + 0.8 * std::pow((t - 1.) / 2., power);
+      FUZZY_COMPARE(p.xsec_scaling_factor(t), expected)
+          << "power " << power << " at t = " << t;
+    }
+  }
+  ParticleData::formation_power_ = saved_power;
+}
+
 TEST(parity) {
   const auto p = Parity::Pos;
   const auto n = Parity::Neg;
@@ -1,6 +1,6 @@
 /*
  *
- *    Copyright (c) 2013-2018,2020,2022-2023
+ *    Copyright (c) 2013-2018,2020,2022-2024
  *      SMASH Team
  *
  *    GNU General Public License (GPLv3 or later)
@@ -11,6 +11,11 @@
 
 #include "smash/particles.h"
 
+#include <cstdint>
+#include <set>
+#include <sstream>
+#include <vector>
+
 #include "setup.h"
 #include "smash/particledata.h"
 #include "smash/pdgcode.h"
@@ -222,6 +227,36 @@ TEST(erase_particle) {
   }
 }
 
+TEST(compact) {
+  Particles p;
+  p.create(10, 0x661);
+  const ParticleList before = p.copy_to_vector();
+  p.remove(before[1]);
+  p.remove(before[3]);
+  p.remove(before[8]);
+  COMPARE(p.size(), 7u);
+  COMPARE(p.hole_fraction(), 0.3);
+
+  p.compact();
+  COMPARE(p.size(), 7u);
+  COMPARE(p.hole_fraction(), 0.);
+  std::set<int> ids;
+  for (auto &&x : p) {
+    VERIFY(p.is_valid(x));
+    ids.insert(x.id());
+  }
+  const std::set<int> expected = {0, 2, 4, 5, 6, 7, 9};
+  VERIFY(ids == expected);
+  // the last particle moved, the first one stayed
+  VERIFY(!p.is_valid(before[9]));
+  VERIFY(p.is_valid(before[0]));
+
+  // new particles are appended
+  const ParticleData &added = p.insert(before[0]);
+  COMPARE(added.id(), 10);
+  COMPARE(p.size(), 8u);
+}
+
 TEST(id_process) {
   Particles p;
   p.create(1000, Test::smashon().pdgcode());
@@ -279,6 +314,57 @@ TEST(reset) {
   }
 }
 
+TEST(copy_from) {
+  Particles p;
+  for (int i = 0; i < 10; ++i) {
+    p.insert(Test::smashon(Test::Position{0., 0., 0., 1. * i}));
+  }
+  p.remove(p.front());
+  Particles copy;
+  copy.insert(Test::smashon());
+  copy.copy_from(p);
+  COMPARE(copy.size(), 9u);
+  auto it = p.begin();
+  for (const ParticleData &pd : copy) {
+    COMPARE(pd.id(), it->id());
+    COMPARE(pd.position(), it->position());
+    ++it;
+  }
+  // New particles continue with the ids of the original
+  COMPARE(copy.insert(Test::smashon()).id(), 10);
+}
+
+TEST(checkpoint) {
+  Particles p;
+  for (int i = 0; i < 10; ++i) {
+    p.insert(Test::smashon(Test::Position{0., 0., 0., 1. * i}));
+  }
+  p.remove(p.front());
+  std::stringstream stream;
+  p.write_checkpoint(stream);
+  Particles restored;
+  restored.insert(Test::smashon());
+  restored.read_checkpoint(stream);
+  COMPARE(restored.size(), 9u);
+  auto it = p.begin();
+  for (const ParticleData &pd : restored) {
+    COMPARE(pd.id(), it->id());
+    COMPARE(pd.position(), it->position());
+    ++it;
+  }
+  COMPARE(restored.insert(Test::smashon()).id(), 10);
+  // A truncated checkpoint is detected
+  std::stringstream truncated(stream.str().substr(0, 20));
+  Particles broken;
+  bool thrown = false;
+  try {
+    broken.read_checkpoint(truncated);
+  } catch (std::runtime_error &) {
+    thrown = true;
+  }
+  VERIFY(thrown);
+}
+
 TEST(copy_to_vector) {
   Particles p;
   p.create(100, 0x661);
@@ -340,3 +426,83 @@ TEST(update) {
   COMPARE(p.front().position(), FourVector(3, 3, 3, 3));
   COMPARE(p.front().id_process(), 2u);
 }
+
+TEST(sort) {
+  Particles p;
+  for (double x : {3., 1., 4., 1., 5.}) {
+    p.insert(Test::smashon(Test::Position{0, x, 0, 0}));
+  }
+  p.remove(p.front());
+  p.sort([](const ParticleData &data) {
+    return static_cast<std::uint64_t>(data.position().x1());
+  });
+  COMPARE(p.size(), 4u);
+  COMPARE(p.hole_fraction(), 0.);
+  const std::vector<double> xs = {1., 1., 4., 5.};
+  const std::vector<int> ids = {1, 3, 2, 4};
+  int n = 0;
+  for (const ParticleData &data : p) {
+    COMPARE(data.position().x1(), xs[n]);
+    COMPARE(data.id(), ids[n]);
+    ++n;
+  }
+  // The particles know their new place in the storage
+  p.remove(p.front());
+  COMPARE(p.front().id(), 3);
+  COMPARE(p.size(), 3u);
+}
+
+TEST(relocate) {
+  Particles p;
+  for (int i = 0; i < 4; i++) {
+    p.insert(Test::smashon(Test::Position{0, 1. * i, 0, 0}));
+  }
+  p.remove(p.front());
+  p.relocate();
+  COMPARE(p.size(), 3u);
+  double x = 1.;
+  for (const ParticleData &data : p) {
+    COMPARE(data.position().x1(), x);
+    COMPARE(data.id(), static_cast<int>(x));
+    x += 1.;
+  }
+  p.insert(Test::smashon());
+  COMPARE(p.size(), 4u);
+  COMPARE(p.back().id(), 4);
+}
+
+TEST(snapshot) {
+  Particles p, other;
+  for (int i = 0; i < 3; i++) {
+    p.insert(Test::smashon(Test::Position{0, 1. * i, 0, 0}));
+  }
+  other.insert(Test::smashon());
+  VERIFY(p.epoch() != other.epoch());
+
+  // Shared while the particles are not modified
+  const std::uint64_t epoch = p.epoch();
+  const Particles &const_p = p;
+  std::shared_ptr<const Particles> first = p.snapshot();
+  COMPARE(const_p.front().id(), 0);
+  COMPARE(p.epoch(), epoch);
+  VERIFY(p.snapshot() == first);
+  COMPARE(first->size(), 3u);
+
+  // Iterating mutably ends the epoch, the first copy is kept unchanged
+  for (ParticleData &data : p) {
+    data.set_4position(FourVector(1., 0., 0., 0.));
+  }
+  VERIFY(p.epoch() != epoch);
+  std::shared_ptr<const Particles> second = p.snapshot();
+  VERIFY(second != first);
+  COMPARE(first->back().position().x1(), 2.);
+  COMPARE(second->back().position().x1(), 0.);
+
+  // Without readers, the copy is released
+  std::weak_ptr<const Particles> released = second;
+  first.reset();
+  second.reset();
+  VERIFY(released.expired());
+  p.remove(p.front());
+  COMPARE(p.snapshot()->size(), 2u);
+}
@@ -0,0 +1,62 @@
+/*
+ *
+ *    Copyright (c) 2024
+ *      SMASH Team
+ *
+ *    GNU General Public License (GPLv3 or later)
+ *
+ */
+
+#include "vir/test.h"  // This include has to be first
+
+#include "smash/particlessoa.h"
+
+#include <vector>
+
+#include "setup.h"
+#include "smash/particles.h"
+
+using namespace smash;
+
+TEST(init_particle_types) { Test::create_smashon_particletypes(); }
+
+TEST(assign_skips_holes) {
+  Particles particles;
+  for (int i = 0; i < 4; i++) {
+    ParticleData p = Test::smashon(Test::Position{0.5 * i, 1. * i, 2., 3.},
+                                   Test::Momentum{2., 0.1 * i, 0.2, 0.3});
+    particles.insert(p);
+  }
+  particles.remove(particles.copy_to_vector()[1]);
+
+  ParticlesSoA soa;
+  soa.assign(particles);
+  COMPARE(soa.size(), 3u);
+  std::size_t i = 0;
+  for (const ParticleData &p : particles) {
+    COMPARE(soa.particle[i], &p);
+    VERIFY(soa.type[i] == &p.type());
+    COMPARE(FourVector(soa.t[i], soa.x[i], soa.y[i], soa.z[i]), p.position());
+    COMPARE(FourVector(soa.e[i], soa.px[i], soa.py[i], soa.pz[i]),
+            p.momentum());
+    i++;
+  }
+}
+
+TEST(assign_ensembles_in_order) {
+  std::vector<Particles> ensembles(3);
+  ensembles[0].insert(Test::smashon(Test::Position{0., 1., 0., 0.}));
+  ensembles[2].insert(Test::smashon(Test::Position{0., 2., 0., 0.}));
+  ensembles[2].insert(Test::smashon(Test::Position{0., 3., 0., 0.}));
+
+  ParticlesSoA soa(ensembles);
+  COMPARE(soa.size(), 3u);
+  COMPARE(soa.x, std::vector<double>({1., 2., 3.}));
+  COMPARE(soa.particle[0], &ensembles[0].front());
+  COMPARE(soa.particle[2], &ensembles[2].back());
+
+  // Assigning again replaces the previous particles
+  soa.assign(ensembles[2]);
+  COMPARE(soa.size(), 2u);
+  COMPARE(soa.x, std::vector<double>({2., 3.}));
+}
@@ -0,0 +1,82 @@
+/*
+ *
+ *    Copyright (c) 2024
+ *      SMASH Team
+ *
+ *    GNU General Public License (GPLv3 or later)
+ *
+ */
+
+#include "vir/test.h"  // This include has to be first
+
+#include "smash/particletablesnapshot.h"
+
+#include <filesystem>
+
+#include "setup.h"
+#include "smash/decaymodes.h"
+
+using namespace smash;
+
+static std::filesystem::path snapshot_path() {
+  const std::filesystem::path testoutputpath =
+      std::filesystem::absolute(SMASH_TEST_OUTPUT_PATH);
+  std::filesystem::create_directories(testoutputpath);
+  return testoutputpath / "particles_test.bin";
+}
+
+TEST(init_particle_types_and_decaymodes) {
+  Test::create_actual_particletypes();
+  Test::create_actual_decaymodes();
+}
+
+TEST(missing_file) {
+  std::filesystem::remove(snapshot_path());
+  VERIFY(!ParticleTableSnapshot::read(snapshot_path(), sha256::Hash{})
+              .has_value());
+}
+
+TEST(write_and_read) {
+  sha256::Hash hash, other_hash;
+  hash.fill(1);
+  other_hash.fill(2);
+  ParticleTableSnapshot::take().write(snapshot_path(), hash);
+  VERIFY(!ParticleTableSnapshot::read(snapshot_path(), other_hash).has_value());
+  const auto snapshot = ParticleTableSnapshot::read(snapshot_path(), hash);
+  VERIFY(snapshot.has_value());
+
+  const ParticleTypeList &list = ParticleType::list_all();
+  COMPARE(snapshot->types().size(), list.size());
+  COMPARE(snapshot->branches().size(), list.size());
+  for (std::size_t i = 0; i < list.size(); i++) {
+    const ParticleTableSnapshot::Type &type = snapshot->types()[i];
+    COMPARE(type.name, list[i].name());
+    COMPARE(type.mass, list[i].mass());
+    COMPARE(type.width, list[i].width_at_pole());
+    COMPARE(type.parity, list[i].parity());
+    COMPARE(type.pdgcode, list[i].pdgcode());
+    const DecayBranchList &modes = list[i].decay_modes().decay_mode_list();
+    const auto &branches = snapshot->branches()[i];
+    COMPARE(branches.size(), modes.size());
+    for (std::size_t j = 0; j < modes.size(); j++) {
+      COMPARE(branches[j].weight, modes[j]->weight());
+      COMPARE(branches[j].angular_momentum, modes[j]->angular_momentum());
+      const ParticleTypePtrList &daughters = modes[j]->particle_types();
+      COMPARE(branches[j].daughters.size(), daughters.size());
+      for (std::size_t k = 0; k < daughters.size(); k++) {
+        COMPARE(list[branches[j].daughters[k]].pdgcode(),
+                daughters[k]->pdgcode());
+      }
+    }
+  }
+}
+
+TEST(truncated_file) {
+  sha256::Hash hash;
+  hash.fill(1);
+  ParticleTableSnapshot::take().write(snapshot_path(), hash);
+  std::filesystem::resize_file(snapshot_path(),
+                               std::filesystem::file_size(snapshot_path()) / 2);
+  VERIFY(!ParticleTableSnapshot::read(snapshot_path(), hash).has_value());
+  std::filesystem::remove(snapshot_path());
+}
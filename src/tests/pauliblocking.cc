@@ -113,3 +113,121 @@ TEST(phase_space_density_nucleus) {
     std::cout << 0.5 / 100 * i << "  " << f << std::endl;
   }
 }
+
+TEST(phase_space_density_index) {
+  std::map<PdgCode, int> list = {{0x2212, 79}, {0x2112, 118}};
+  const int Ntest = 10;
+  Nucleus Au(list, Ntest);
+  Au.set_parameters_automatic();
+  Au.arrange_nucleons();
+  Au.generate_fermi_momenta();
+  std::vector<Particles> ensembles(2);
+  Au.copy_particles(&ensembles[0]);
+  Au.copy_particles(&ensembles[1]);
+
+  ExperimentParameters param = smash::Test::default_parameters(Ntest);
+  param.n_ensembles = 2;
+  PauliBlocker pb(get_pauli_blocking_conf(), param);
+  const ParticleList disregard = {*ensembles[0].begin()};
+  auto compare_densities = [&]() {
+    for (int i = 0; i < 200; i++) {
+      const ThreeVector r(random::uniform(-7., 7.), random::uniform(-7., 7.),
+                          random::uniform(-7., 7.));
+      const ThreeVector p(random::uniform(-0.3, 0.3),
+                          random::uniform(-0.3, 0.3),
+                          random::uniform(-0.3, 0.3));
+      for (const PdgCode pdg : {PdgCode(0x2212), PdgCode(0x2112)}) {
+        pb.clear_index();
+        const double f_all =
+            pb.phasespace_dens(r, p, ensembles, pdg, disregard);
+        pb.build_index(ensembles, 1.0);
+        const double f_index =
+            pb.phasespace_dens(r, p, ensembles, pdg, disregard);
+        COMPARE_ABSOLUTE_ERROR(f_index, f_all, 1.e-12) << r << p;
+      }
+    }
+  };
+  compare_densities();
+
+  // Particles move, are removed and added while the index is used
+  pb.build_index(ensembles, 1.0);
+  ParticleList removed, added;
+  for (const ParticleData &part : ensembles[1]) {
+    if (part.id() % 3 == 0) {
+      removed.push_back(part);
+    }
+  }
+  for (const ParticleData &part : removed) {
+    ensembles[1].remove(part);
+    ParticleData moved{part.type()};
+    moved.set_4position(part.position() + FourVector(0., 0.5, 0., 0.));
+    moved.set_4momentum(part.momentum());
+    added.push_back(ensembles[1].insert(moved));
+  }
+  pb.update_index(1, removed, added);
+  for (const ParticleData &part : ensembles[0]) {
+    ParticleData new_state = part;
+    new_state.set_4position(part.position() +
+                            FourVector(0.9, 0., 0., random::uniform(-.9, .9)));
+    ensembles[0].update_particle(part, new_state);
+  }
+  std::vector<std::pair<ThreeVector, ThreeVector>> points;
+  std::vector<double> f_index;
+  for (int i = 0; i < 200; i++) {
+    const ThreeVector r(random::uniform(-7., 7.), random::uniform(-7., 7.),
+                        random::uniform(-7., 7.));
+    const ThreeVector p(random::uniform(-0.3, 0.3), random::uniform(-0.3, 0.3),
+                        random::uniform(-0.3, 0.3));
+    points.emplace_back(r, p);
+    f_index.push_back(
+        pb.phasespace_dens(r, p, ensembles, 0x2112, disregard));
+  }
+  pb.clear_index();
+  for (std::size_t i = 0; i < points.size(); i++) {
+    const auto &[r, p] = points[i];
+    const double f_all = pb.phasespace_dens(r, p, ensembles, 0x2112, disregard);
+    COMPARE_ABSOLUTE_ERROR(f_index[i], f_all, 1.e-12) << r << p;
+  }
+}
+
+TEST(phase_space_density_lattice) {
+  std::map<PdgCode, int> list = {{0x2212, 79}, {0x2112, 118}};
+  const int Ntest = 20;
+  Nucleus Au(list, Ntest);
+  Au.set_parameters_automatic();
+  Au.arrange_nucleons();
+  Au.generate_fermi_momenta();
+  std::vector<Particles> ensembles(1);
+  Au.copy_particles(&ensembles[0]);
+
+  ExperimentParameters param = smash::Test::default_parameters(Ntest);
+  Configuration conf = get_pauli_blocking_conf();
+  conf.set_value({"Use_Lattice"}, true);
+  PauliBlocker pb(std::move(conf), param);
+  VERIFY(pb.uses_lattice());
+  pb.create_lattice({20., 20., 20.}, {40, 40, 40}, {-10., -10., -10.}, false);
+  const ParticleList disregard = {*ensembles[0].begin()};
+  const double rp = 0.08;
+  // At the centres of the cells, the densities are the same as without it
+  for (int i = 0; i < 200; i++) {
+    const ThreeVector r(-9.75 + 0.5 * random::uniform_int(0, 39),
+                        -9.75 + 0.5 * random::uniform_int(0, 39),
+                        -9.75 + 0.5 * random::uniform_int(0, 39));
+    const ThreeVector p(rp * (random::uniform_int(-4, 3) + 0.5),
+                        rp * (random::uniform_int(-4, 3) + 0.5),
+                        rp * (random::uniform_int(-4, 3) + 0.5));
+    const ParticleList disregard_none;
+    for (const ParticleList *d : {&disregard, &disregard_none}) {
+      pb.clear_index();
+      const double f_all = pb.phasespace_dens(r, p, ensembles, 0x2212, *d);
+      pb.build_index(ensembles, 0.);
+      const double f_lattice =
+          pb.phasespace_dens(r, p, ensembles, 0x2212, *d);
+      COMPARE_ABSOLUTE_ERROR(f_lattice, f_all, 1.e-10) << r << p;
+    }
+  }
+  // Outside of the lattice
+  COMPARE(pb.phasespace_dens(ThreeVector(11., 0., 0.), ThreeVector(0., 0., 0.),
+                             ensembles, 0x2212, disregard),
+          0.);
+}
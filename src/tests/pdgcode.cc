@@ -1,6 +1,6 @@
 /*
  *
- *    Copyright (c) 2014-2023
+ *    Copyright (c) 2014-2024
  *      SMASH Team
  *
  *    GNU General Public License (GPLv3 or later)
@@ -671,6 +671,20 @@ TEST(from_decimal) {
   COMPARE(antideutron, PdgCode::from_decimal(-1000010020));
 }
 
+TEST(to_chars) {
+  char buffer[PdgCode::max_chars];
+  COMPARE(std::string(buffer, Kminus.to_chars(buffer)), "-321");
+  COMPARE(std::string(buffer, antixi.to_chars(buffer)), "-103312");
+  COMPARE(std::string(buffer, antideutron.to_chars(buffer)), "-1000010020");
+  COMPARE(pion.string(), "211");
+}
+
+TEST(from_chars) {
+  const std::string line = "0.5 -321 1000010020";
+  COMPARE(PdgCode::from_chars(&line[4], &line[8]), Kminus);
+  COMPARE(PdgCode::from_chars(&line[9], &line[19]), deuteron);
+}
+
 TEST(decimal_from_decimal_consistency) {
   Test::create_actual_particletypes();
   for (const ParticleType& t : ParticleType::list_all()) {
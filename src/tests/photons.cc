@@ -1,5 +1,5 @@
 /*
- *    Copyright (c) 2016-2020,2022
+ *    Copyright (c) 2016-2020,2022,2024
  *      SMASH Team
  *
  *    GNU General Public License (GPLv3 or later)
@@ -7,10 +7,14 @@
 
 #include "vir/test.h"  // This include has to be first
 
+#include <filesystem>
+
 #include "setup.h"
 #include "smash/bremsstrahlungaction.h"
 #include "smash/crosssectionsphoton.h"
+#include "smash/photonchannels.h"
 #include "smash/scatteractionphoton.h"
+#include "smash/tabulation.h"
 
 using namespace smash;
 using smash::Test::Momentum;
@@ -252,6 +256,62 @@ TEST(binary_scatterings_diff_cross_sections) {
   COMPARE_ABSOLUTE_ERROR(diff_cross4, 0.6907271, 1e-5);
 }
 
+TEST(binary_scatterings_lookup_cross_sections) {
+  using Analytic = CrosssectionsPhoton<ComputationMethod::Analytic>;
+  using Lookup = CrosssectionsPhoton<ComputationMethod::Lookup>;
+  // Without tables, the analytic formulas are evaluated
+  VERIFY(!Lookup::is_tabulated());
+  COMPARE(Lookup::xs_pi_rho0_pi(1.224, 0.776),
+          Analytic::xs_pi_rho0_pi(1.224, 0.776));
+
+  const std::filesystem::path testoutputpath =
+      std::filesystem::absolute(SMASH_TEST_OUTPUT_PATH);
+  std::filesystem::create_directories(testoutputpath);
+  {
+    TabulationCache cache(testoutputpath, sha256::Hash{});
+    Lookup::tabulate();
+  }
+  VERIFY(Lookup::is_tabulated());
+  VERIFY(std::filesystem::exists(testoutputpath / "tabulations.bin"));
+  VERIFY(!std::filesystem::exists(testoutputpath / "tabulations.lock"));
+
+  // Same points as above
+  const double cross1 = Lookup::xs_pi_pi_rho0(0.996, 0.776);
+  COMPARE_RELATIVE_ERROR(cross1, Analytic::xs_pi_pi_rho0(0.996, 0.776), 1e-2);
+  COMPARE_RELATIVE_ERROR(Lookup::xs_pi_pi0_rho(1.12, 0.9),
+                         Analytic::xs_pi_pi0_rho(1.12, 0.9), 1e-2);
+  COMPARE_RELATIVE_ERROR(Lookup::xs_pi_rho0_pi(1.224, 0.776),
+                         Analytic::xs_pi_rho0_pi(1.224, 0.776), 1e-2);
+  COMPARE_RELATIVE_ERROR(Lookup::xs_pi0_rho0_pi0(2.979, 0.776),
+                         Analytic::xs_pi0_rho0_pi0(2.979, 0.776), 1e-2);
+  COMPARE_RELATIVE_ERROR(Lookup::xs_pi0_rho_pi(1.103, 0.776),
+                         Analytic::xs_pi0_rho_pi(1.103, 0.776), 1e-2);
+  COMPARE_RELATIVE_ERROR(Lookup::xs_pi_rho_pi0(1.351, 0.9),
+                         Analytic::xs_pi_rho_pi0(1.351, 0.9), 1e-2);
+  COMPARE_RELATIVE_ERROR(Lookup::xs_diff_pi_pi_rho0(1.0, -0.367612, 0.6),
+                         Analytic::xs_diff_pi_pi_rho0(1.0, -0.367612, 0.6),
+                         2e-2);
+  COMPARE_RELATIVE_ERROR(Lookup::xs_diff_pi_pi0_rho(1., -0.07066, 0.9),
+                         Analytic::xs_diff_pi_pi0_rho(1., -0.07066, 0.9),
+                         2e-2);
+  COMPARE_RELATIVE_ERROR(Lookup::xs_diff_pi_rho0_pi(1., -0.316209, 0.776),
+                         Analytic::xs_diff_pi_rho0_pi(1., -0.316209, 0.776),
+                         2e-2);
+  COMPARE_RELATIVE_ERROR(
+      Lookup::xs_diff_pi0_rho0_pi0(1., -0.248786, 0.776),
+      Analytic::xs_diff_pi0_rho0_pi0(1., -0.248786, 0.776), 2e-2);
+
+  // Outside of the tables, the analytic formulas are evaluated
+  COMPARE(Lookup::xs_pi_rho0_pi(16., 0.776),
+          Analytic::xs_pi_rho0_pi(16., 0.776));
+  COMPARE(Lookup::xs_pi_rho0_pi(4., 1.6), Analytic::xs_pi_rho0_pi(4., 1.6));
+
+  // The cached tables are read again
+  TabulationCache cache(testoutputpath, sha256::Hash{});
+  Lookup::tabulate();
+  COMPARE(Lookup::xs_pi_pi_rho0(0.996, 0.776), cross1);
+}
+
 ////
 // Test photon production in Bremsstrahlung processes
 ////
@@ -314,3 +374,18 @@ TEST(bremsstrahlung_reaction_type_function) {
   VERIFY(BremsstrahlungAction::bremsstrahlung_reaction_type(l8) ==
          BremsstrahlungAction::ReactionType::no_reaction);
 }
+
+TEST(photon_channels) {
+  const PhotonChannels channels;
+  for (const ParticleType &a : ParticleType::list_all()) {
+    for (const ParticleType &b : ParticleType::list_all()) {
+      const ParticleList in{ParticleData(a), ParticleData(b)};
+      COMPARE(channels.is_photon_reaction(in),
+              ScatterActionPhoton::is_photon_reaction(in))
+          << a.name() << " " << b.name();
+      COMPARE(channels.is_bremsstrahlung_reaction(in),
+              BremsstrahlungAction::is_bremsstrahlung_reaction(in))
+          << a.name() << " " << b.name();
+    }
+  }
+}
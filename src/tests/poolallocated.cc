@@ -0,0 +1,69 @@
+/*
+ *
+ *    Copyright (c) 2024
+ *      SMASH Team
+ *
+ *    GNU General Public License (GPLv3 or later)
+ *
+ */
+
+#include "vir/test.h"  // This include has to be first
+
+#include "smash/poolallocated.h"
+
+#include <memory>
+#include <thread>
+
+using namespace smash;
+
+namespace {
+/// Pooled object of a given size
+template <std::size_t N>
+struct Pooled : public PoolAllocated {
+  virtual ~Pooled() = default;
+  /// Content making up the size
+  char content[N];
+};
+}  // namespace
+
+TEST(reuse_freed_memory) {
+  auto first = std::make_unique<Pooled<40>>();
+  const void *address = first.get();
+  first.reset();
+  // An object of the same size class obtains the freed block
+  auto second = std::make_unique<Pooled<36>>();
+  COMPARE(static_cast<const void *>(second.get()), address);
+  // Other sizes do not
+  auto third = std::make_unique<Pooled<200>>();
+  VERIFY(static_cast<const void *>(third.get()) != address);
+}
+
+TEST(delete_through_base) {
+  struct Base : public PoolAllocated {
+    virtual ~Base() = default;
+  };
+  struct Derived : public Base {
+    double values[20] = {};
+  };
+  std::unique_ptr<Base> object = std::make_unique<Derived>();
+  const void *address = object.get();
+  object.reset();
+  // The block is found under the size of the derived class
+  auto reused = std::make_unique<Derived>();
+  COMPARE(static_cast<const void *>(reused.get()), address);
+}
+
+TEST(large_objects) {
+  auto large = std::make_unique<Pooled<PoolAllocated::max_pooled_size + 1>>();
+  large->content[PoolAllocated::max_pooled_size] = 1;
+  COMPARE(large->content[PoolAllocated::max_pooled_size], 1);
+}
+
+TEST(delete_in_other_thread) {
+  auto object = std::make_unique<Pooled<64>>();
+  std::thread other([&]() { object.reset(); });
+  other.join();
+  VERIFY(!object);
+  auto created = std::make_unique<Pooled<64>>();
+  VERIFY(created != nullptr);
+}
@@ -1,6 +1,6 @@
 /*
  *
- *    Copyright (c) 2014-2023
+ *    Copyright (c) 2014-2024
  *      SMASH Team
  *
  *    GNU General Public License (GPLv3 or later)
@@ -28,6 +28,7 @@
 #include "smash/propagation.h"
 #include "smash/quantumsampling.h"
 #include "smash/spheremodus.h"
+#include "smash/threadpool.h"
 
 using namespace smash;
 
@@ -153,6 +154,60 @@ TEST(nucleus_potential_profile) {
   }
 }
 
+TEST(parallel_momentum_update) {
+  Configuration conf{R"(
+    Modi:
+      Collider:
+        Calculation_Frame: "fixed target"
+        E_Kin: 1.23
+        Projectile:
+          Particles:
+            211: 1
+        Target:
+          Particles:
+            2212: 29
+            2112: 34
+    Potentials:
+      Skyrme:
+        Skyrme_A: -209.2
+        Skyrme_B: 156.4
+        Skyrme_Tau: 1.35
+  )"};
+  conf.validate();
+  ExperimentParameters param = smash::Test::default_parameters();
+  ColliderModus c(conf.extract_sub_configuration({"Modi"}), param);
+  std::vector<Particles> P(2);
+  c.initial_conditions(&(P[0]), param);
+  c.initial_conditions(&(P[1]), param);
+  Potentials pot =
+      Potentials(conf.extract_sub_configuration({"Potentials"}), param);
+  const double dt = param.labclock->timestep_duration();
+
+  // Without lattices, the forces are calculated from the particles
+  std::vector<FourVector> initial, serial;
+  for (const Particles& particles : P) {
+    for (const ParticleData& data : particles) {
+      initial.push_back(data.momentum());
+    }
+  }
+  update_momenta(P, dt, pot, nullptr, nullptr, nullptr, nullptr);
+  std::size_t i = 0;
+  for (Particles& particles : P) {
+    for (ParticleData& data : particles) {
+      serial.push_back(data.momentum());
+      data.set_4momentum(initial[i++]);
+    }
+  }
+  ThreadPool pool(4);
+  update_momenta(P, dt, pot, nullptr, nullptr, nullptr, nullptr, &pool);
+  i = 0;
+  for (const Particles& particles : P) {
+    for (const ParticleData& data : particles) {
+      COMPARE(data.momentum(), serial[i++]);
+    }
+  }
+}
+
 TEST(propagation_in_test_potential) {
   /* Two dummy potentials are created:
    * One has only the time component: U(x) = U_0/(1 + exp(x/d))
@@ -172,7 +227,7 @@ TEST(propagation_in_test_potential) {
         : Potentials(Configuration{""}, param), U0_(U0), d_(d), B0_(B0) {}
 
     std::tuple<ThreeVector, ThreeVector, ThreeVector, ThreeVector> all_forces(
-        const ThreeVector& r, const ParticleList&) const override {
+        const ThreeVector& r, const ParticleCellList&) const override {
       const double tmp = std::exp(r.x1() / d_);
       return std::make_tuple(
           ThreeVector(U0_ / d_ * tmp / ((1.0 + tmp) * (1.0 + tmp)), 0.0, 0.0),
@@ -440,6 +495,7 @@ static ExperimentParameters default_parameters_vdf(
       4.0,                                  // Gaussian smearing cut-off
       0.333333,                             // discrete smearing weight
       triangular_smearing_range,            // triangular smearing range
+      false,                                // smearing by FFT
       CollisionCriterion::Geometric,
       false,  // two_to_one
       false, Test::no_multiparticle_reactions(),
@@ -458,6 +514,82 @@ static ExperimentParameters default_parameters_vdf(
   };
 }
 
+/*
+ * The VDF potential and force are evaluated with one logarithm per density,
+ * which agrees with the sums of powers in their definition.
+ */
+TEST(vdf_factors) {
+  Configuration conf{R"(
+    VDF:
+      Sat_rhoB: 0.168
+      Powers: [2.0, 2.35, 3.7, 8.1]
+      Coeffs: [-209.2, 156.5, 12.3, -0.7]
+  )"};
+  ExperimentParameters param = default_parameters_vdf();
+  Potentials pot(std::move(conf), param);
+  const double rho_0 = pot.saturation_density();
+  const FourVector jmu(1.2, 0.3, -0.4, 0.5);
+  for (const double rhoB : {1e-6, 0.03, 0.168, 0.5, -0.2}) {
+    const int sgn = rhoB > 0 ? 1 : -1;
+    const double abs_rhoB = std::abs(rhoB);
+    double F_1 = 0.0, F_2 = 0.0;
+    for (int i = 0; i < pot.number_of_terms(); i++) {
+      const double b = pot.powers()[i];
+      F_1 += sgn * pot.coeffs()[i] * (b - 2.0) * std::pow(abs_rhoB, b - 3.0) /
+             std::pow(rho_0, b - 1.0);
+      F_2 += sgn * pot.coeffs()[i] * std::pow(abs_rhoB, b - 2.0) /
+             std::pow(rho_0, b - 1.0);
+    }
+    const std::pair<double, double> factors = pot.vdf_factors(rhoB);
+    COMPARE_RELATIVE_ERROR(factors.first, F_1, 1e-12) << rhoB;
+    COMPARE_RELATIVE_ERROR(factors.second, F_2, 1e-12) << rhoB;
+    const FourVector U = pot.vdf_pot(rhoB, jmu);
+    for (int mu = 0; mu < 4; mu++) {
+      COMPARE_RELATIVE_ERROR(U[mu], F_2 * jmu[mu], 1e-12) << rhoB;
+    }
+  }
+}
+
+/*
+ * In the rest frame, the derivatives of the mean-field energy densities with
+ * respect to the density are the potentials.
+ */
+TEST(mean_field_energy_density) {
+  Configuration conf_skyrme{R"(
+    Skyrme:
+        Skyrme_A: -209.2
+        Skyrme_B: 156.4
+        Skyrme_Tau: 1.35
+  )"};
+  Configuration conf_vdf{R"(
+    VDF:
+      Sat_rhoB: 0.168
+      Powers: [2.0, 2.35]
+      Coeffs: [-209.2, 156.5]
+  )"};
+  ExperimentParameters param = default_parameters_vdf();
+  Potentials skyrme(std::move(conf_skyrme), param),
+      vdf(std::move(conf_vdf), param);
+  COMPARE(skyrme.skyrme_energy_density(0.), 0.);
+  const double h = 1e-6;
+  for (const double rhoB : {0.03, 0.168, 0.5}) {
+    const double skyrme_derivative =
+        (skyrme.skyrme_energy_density(rhoB + h) -
+         skyrme.skyrme_energy_density(rhoB - h)) /
+        (2 * h);
+    COMPARE_RELATIVE_ERROR(skyrme_derivative, skyrme.skyrme_pot(rhoB), 1e-6)
+        << rhoB;
+    const double vdf_derivative =
+        (vdf.vdf_energy_density(rhoB + h, rhoB + h) -
+         vdf.vdf_energy_density(rhoB - h, rhoB - h)) /
+        (2 * h);
+    COMPARE_RELATIVE_ERROR(vdf_derivative,
+                           vdf.vdf_pot(rhoB, FourVector(rhoB, 0., 0., 0.)).x0(),
+                           1e-6)
+        << rhoB;
+  }
+}
+
 /*
  * Testing the values of the vdf forces for two ways of calculating gradients of
  * the vector field: with chain rule derivatives and with field derivatives. The
@@ -982,10 +1114,8 @@ TEST(spinodal_dilute) {
   std::unique_ptr<RectangularLattice<FourVector>> UB_lat_df =
       std::make_unique<RectangularLattice<FourVector>>(
           l, n, origin, periodic, LatticeUpdate::EveryTimestep);
-  std::unique_ptr<RectangularLattice<std::pair<ThreeVector, ThreeVector>>>
-      FB_lat_df = std::make_unique<
-          RectangularLattice<std::pair<ThreeVector, ThreeVector>>>(
-          l, n, origin, periodic, LatticeUpdate::EveryTimestep);
+  std::unique_ptr<ForceLattice> FB_lat_df = std::make_unique<ForceLattice>(
+      l, n, origin, periodic, LatticeUpdate::EveryTimestep);
 
   // the mean field energy at the beginning and end of the evolution
   double E_init, E_final;
@@ -1020,10 +1150,12 @@ TEST(spinodal_dilute) {
     for (size_t j = 0; j < UBlattice_size_df; j++) {
       auto jB_df = (*jmu_B_lat_df)[j];
       (*UB_lat_df)[j] = pot.vdf_pot(jB_df.rho(), jB_df.jmu_net());
-      (*FB_lat_df)[j] = pot.vdf_force(
-          jB_df.rho(), jB_df.drho_dxnu().x0(), jB_df.drho_dxnu().threevec(),
-          jB_df.grad_rho_cross_vecj(), jB_df.jmu_net().x0(), jB_df.grad_j0(),
-          jB_df.jmu_net().threevec(), jB_df.dvecj_dt(), jB_df.curl_vecj());
+      FB_lat_df->set(
+          j, pot.vdf_force(jB_df.rho(), jB_df.drho_dxnu().x0(),
+                           jB_df.drho_dxnu().threevec(),
+                           jB_df.grad_rho_cross_vecj(), jB_df.jmu_net().x0(),
+                           jB_df.grad_j0(), jB_df.jmu_net().threevec(),
+                           jB_df.dvecj_dt(), jB_df.curl_vecj()));
     }
     update_momenta(P, dt, pot, FB_lat_df.get(), nullptr, nullptr, nullptr);
   }
@@ -0,0 +1,188 @@
+/*
+ *
+ *    Copyright (c) 2024
+ *      SMASH Team
+ *
+ *    GNU General Public License (GPLv3 or later)
+ *
+ */
+
+#include "vir/test.h"  // This include has to be first
+
+#include "smash/potentialsrefresh.h"
+
+#include <sstream>
+#include <stdexcept>
+
+#include "smash/constants.h"
+
+using namespace smash;
+
+static DensityLattice make_density_lattice() {
+  return DensityLattice({4., 4., 4.}, {4, 4, 4}, {0., 0., 0.}, false,
+                        LatticeUpdate::EveryTimestep);
+}
+
+/// Set the density on all nodes, in units of the nuclear ground state density.
+static void set_density(DensityLattice &lat, double rho) {
+  lat.reset();
+  for (DensityOnLattice &node : lat) {
+    node.add_to_jmu_pos(FourVector(rho * nuclear_density, 0., 0., 0.));
+  }
+}
+
+TEST_CATCH(zero_interval, std::invalid_argument) { PotentialsRefresh(0, 0.1); }
+
+TEST_CATCH(negative_threshold, std::invalid_argument) {
+  PotentialsRefresh(4, -0.1);
+}
+
+/*
+ * The updates are postponed further and further while the density changes
+ * slowly, up to the largest interval, and happen in every time step again
+ * once it changes quickly.
+ */
+TEST(interval_follows_density_change) {
+  DensityLattice lat = make_density_lattice();
+  PotentialsRefresh refresh(8, 0.01);
+  double rho = 1.;
+  auto timestep = [&](double change) {
+    rho += change;
+    const bool update = refresh.next_timestep();
+    if (update) {
+      set_density(lat, rho);
+      refresh.refreshed(lat);
+    }
+    return update;
+  };
+  // the first two time steps are always updated
+  VERIFY(timestep(0.001));
+  VERIFY(timestep(0.001));
+  // intervals of 2, 4 and then 8 time steps
+  for (const int interval : {2, 4, 8, 8}) {
+    for (int step = 1; step < interval; step++) {
+      VERIFY(!timestep(0.001)) << interval << " " << step;
+    }
+    VERIFY(timestep(0.001)) << interval;
+  }
+  // a fast change is only noticed at the next update
+  for (int step = 1; step < 8; step++) {
+    VERIFY(!timestep(0.05));
+  }
+  VERIFY(timestep(0.05));
+  VERIFY(timestep(0.05));
+  VERIFY(timestep(0.05));
+  // the interval is chosen such that the change stays below the threshold
+  VERIFY(timestep(0.004));
+  for (int i = 0; i < 3; i++) {
+    VERIFY(!timestep(0.004));
+    VERIFY(timestep(0.004));
+  }
+
+  refresh.reset();
+  VERIFY(timestep(0.));
+  VERIFY(timestep(0.));
+}
+
+TEST(report) {
+  DensityLattice lat = make_density_lattice();
+  set_density(lat, 1.);
+  PotentialsRefresh refresh(3, 0.1);
+  for (int step = 0; step < 5; step++) {
+    if (refresh.next_timestep()) {
+      refresh.refreshed(lat);
+    }
+  }
+  refresh.add_deviation(0.002);
+  refresh.add_deviation(0.001);
+  COMPARE(refresh.report(),
+          "Potentials updated in 3 of 5 time steps, largest deviation of the "
+          "extrapolated potentials: 2 MeV");
+}
+
+/*
+ * Values changing linearly in time are extrapolated exactly, a single record
+ * is kept constant.
+ */
+TEST(extrapolate_history) {
+  RectangularLattice<FourVector> lat({4., 4., 4.}, {2, 2, 2}, {0., 0., 0.},
+                                     false, LatticeUpdate::EveryTimestep);
+  RectangularLattice<std::pair<ThreeVector, ThreeVector>> pair_lat(
+      {4., 4., 4.}, {2, 2, 2}, {0., 0., 0.}, false,
+      LatticeUpdate::EveryTimestep);
+  auto fill = [&](double time) {
+    for (std::size_t i = 0; i < lat.size(); i++) {
+      lat[i] = FourVector(i + time, 2. * time, -time, 1.);
+      pair_lat[i] = std::make_pair(ThreeVector(i, time, 0.),
+                                   ThreeVector(0., -3. * time, 1.));
+    }
+  };
+  LatticeHistory<FourVector> history;
+  LatticeHistory<std::pair<ThreeVector, ThreeVector>> pair_history;
+
+  // nothing recorded, nothing changed
+  fill(1.);
+  fill(0.5);
+  history.extrapolate(lat, 1.);
+  COMPARE(lat[3], FourVector(3.5, 1., -0.5, 1.));
+
+  fill(0.5);
+  history.record(lat, 0.5);
+  pair_history.record(pair_lat, 0.5);
+  fill(7.);
+  history.extrapolate(lat, 1.);
+  COMPARE(lat[3], FourVector(3.5, 1., -0.5, 1.));
+
+  fill(1.);
+  history.record(lat, 1.);
+  pair_history.record(pair_lat, 1.);
+  history.extrapolate(lat, 1.75);
+  pair_history.extrapolate(pair_lat, 1.75);
+  for (std::size_t i = 0; i < lat.size(); i++) {
+    COMPARE(lat[i], FourVector(i + 1.75, 3.5, -1.75, 1.));
+    COMPARE(pair_lat[i].first, ThreeVector(i, 1.75, 0.));
+    COMPARE(pair_lat[i].second, ThreeVector(0., -5.25, 1.));
+    COMPARE(history.predict(i, 1.75), lat[i]);
+  }
+
+  history.clear();
+  fill(2.);
+  history.extrapolate(lat, 3.);
+  COMPARE(lat[0], FourVector(2., 4., -2., 1.));
+}
+
+/*
+ * Histories in single precision extrapolate the values rounded to floats,
+ * and their checkpoints can be restored in double precision.
+ */
+TEST(single_precision_history) {
+  RectangularLattice<FourVector> lat({4., 4., 4.}, {2, 2, 2}, {0., 0., 0.},
+                                     false, LatticeUpdate::EveryTimestep);
+  auto fill = [&](double time) {
+    for (std::size_t i = 0; i < lat.size(); i++) {
+      lat[i] = FourVector(0.1 * i + time, 1. / 3. * time, -time, 1.);
+    }
+  };
+  LatticeHistory<FourVector> history(true);
+  VERIFY(history.single_precision());
+  VERIFY(!LatticeHistory<FourVector>().single_precision());
+  fill(0.5);
+  history.record(lat, 0.5);
+  fill(1.);
+  history.record(lat, 1.);
+  history.extrapolate(lat, 1.75);
+  for (std::size_t i = 0; i < lat.size(); i++) {
+    const FourVector expected(0.1 * i + 1.75, 1.75 / 3., -1.75, 1.);
+    for (int k = 0; k < 4; k++) {
+      COMPARE_RELATIVE_ERROR(lat[i][k], expected[k], 1e-6);
+    }
+  }
+
+  std::stringstream checkpoint;
+  history.write_checkpoint(checkpoint);
+  LatticeHistory<FourVector> restored;
+  restored.read_checkpoint(checkpoint);
+  for (std::size_t i = 0; i < lat.size(); i++) {
+    COMPARE(restored.predict(i, 1.75), history.predict(i, 1.75));
+  }
+}
@@ -65,7 +65,7 @@ TEST(lists) {
 }
 
 TEST(add_particle) {
-  std::vector<ParticleTypePtr> list = {
+  ParticleTypePtrList list = {
       &ParticleType::find(PdgCode("9876542")),
       &ParticleType::find(PdgCode("1234568")),
       &ParticleType::find(PdgCode("-1234568")),
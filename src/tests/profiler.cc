@@ -0,0 +1,173 @@
+/*
+ *
+ *    Copyright (c) 2024
+ *      SMASH Team
+ *
+ *    GNU General Public License (GPLv3 or later)
+ *
+ */
+
+#include "vir/test.h"  // This include has to be first
+
+#include "smash/profiler.h"
+
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <thread>
+
+using namespace smash;
+
+namespace {
+void sleep_ms(int ms) {
+  std::this_thread::sleep_for(std::chrono::milliseconds(ms));
+}
+
+/// Reads the whole file at the given path
+std::string read_file(const std::filesystem::path &path) {
+  std::ifstream file(path);
+  std::stringstream content;
+  content << file.rdbuf();
+  return content.str();
+}
+}  // namespace
+
+TEST(names) {
+  COMPARE(std::string(Profiler::name(Profiler::Phase::Grid)), "Grid");
+  COMPARE(std::string(Profiler::name(Profiler::Phase::FinalDecays)),
+          "Final decays");
+}
+
+TEST(disabled_timer) {
+  // Without a profiler, nothing is measured and nothing crashes
+  const Profiler::ScopedTimer timer(nullptr, Profiler::Phase::Grid);
+  const Profiler::ScopedTimer inner(nullptr, Profiler::Phase::Output);
+}
+
+// The time of an inner timer is not counted for the outer one.
+TEST(nested_timers_are_exclusive) {
+  const auto path = std::filesystem::temp_directory_path() / "profile.json";
+  Profiler profiler(path);
+  profiler.start_event(3);
+  {
+    const Profiler::ScopedTimer outer(&profiler, Profiler::Phase::Grid);
+    sleep_ms(20);
+    {
+      const Profiler::ScopedTimer inner(&profiler,
+                                        Profiler::Phase::ActionFinding);
+      sleep_ms(60);
+    }
+    sleep_ms(20);
+  }
+  const std::string table = profiler.end_event(3);
+  VERIFY(table.find("Profile of event 3") != std::string::npos) << table;
+  profiler.write_json();
+  const std::string json = read_file(path);
+  std::filesystem::remove(path);
+  VERIFY(json.find("\"total\"") != std::string::npos) << json;
+  VERIFY(json.find("\"event\": 3") != std::string::npos) << json;
+
+  // Parse the times back from the entries of the first (total) record
+  auto time_of = [&](const std::string &phase) {
+    const std::size_t pos = json.find("\"" + phase + "\": ");
+    VERIFY(pos != std::string::npos) << phase;
+    return std::stod(json.substr(pos + phase.size() + 4));
+  };
+  const double grid = time_of("Grid");
+  const double finding = time_of("Action finding");
+  const double wall = time_of("wall_time");
+  // Including the inner phase, it would be at least 0.1 s
+  VERIFY(grid >= 0.039 && grid < 0.09) << grid;
+  VERIFY(finding >= 0.059) << finding;
+  VERIFY(wall >= grid + finding) << wall;
+  COMPARE(time_of("Output"), 0.);
+}
+
+TEST(merge_sorts_events) {
+  Profiler a("a.json"), b("b.json");
+  for (int event : {0, 2}) {
+    a.start_event(event);
+    a.end_event(event);
+  }
+  b.start_event(1);
+  b.end_event(1);
+  a.merge(b);
+  const std::string table = a.run_table();
+  VERIFY(table.find("Profile of 3 events") != std::string::npos) << table;
+  const auto path = std::filesystem::temp_directory_path() / "merged.json";
+  Profiler c(path);
+  c.merge(a);
+  c.write_json();
+  const std::string json = read_file(path);
+  std::filesystem::remove(path);
+  const std::size_t first = json.find("\"event\": 0");
+  const std::size_t second = json.find("\"event\": 1");
+  const std::size_t third = json.find("\"event\": 2");
+  VERIFY(first < second && second < third) << json;
+}
+
+TEST(trace) {
+  const auto path = std::filesystem::temp_directory_path() / "trace.json";
+  Profiler profiler("profile.json");
+  profiler.enable_trace(path, 1, 3);
+  VERIFY(profiler.is_tracing());
+  for (int event : {0, 1}) {
+    profiler.start_event(event);
+    {
+      const Profiler::ScopedSpan step(&profiler, "Time step");
+      const Profiler::ScopedTimer grid(&profiler, Profiler::Phase::Grid, 2);
+    }
+    profiler.end_event(event);
+  }
+  profiler.start_event(0);
+  for (int i = 0; i < 5; i++) {
+    const Profiler::ScopedSpan span(&profiler, "String");
+  }
+  profiler.end_event(0);
+  profiler.write_trace();
+  const std::string trace = read_file(path);
+  std::filesystem::remove(path);
+  VERIFY(trace.find("\"traceEvents\"") != std::string::npos) << trace;
+  VERIFY(trace.find("\"name\": \"Time step\"") != std::string::npos) << trace;
+  VERIFY(trace.find("\"name\": \"Grid\"") != std::string::npos) << trace;
+  VERIFY(trace.find("\"ensemble\": 2") != std::string::npos) << trace;
+  // Event 1 is not traced
+  VERIFY(trace.find("\"pid\": 1") == std::string::npos) << trace;
+  // Only 3 of the 5 string spans of the second run of event 0 are kept
+  VERIFY(trace.find("\"dropped_spans\": 2") != std::string::npos) << trace;
+}
+
+TEST(hardware_counters) {
+  const auto path = std::filesystem::temp_directory_path() / "counters.json";
+  Profiler profiler(path);
+  // Depending on the kernel, the counters are not necessarily available
+  const bool counting = profiler.enable_counters();
+  COMPARE(profiler.is_counting(), counting);
+  profiler.start_event(0);
+  {
+    const Profiler::ScopedTimer timer(&profiler, Profiler::Phase::Propagation);
+    volatile double sum = 0.;
+    for (int i = 0; i < 1000000; i++) {
+      sum = sum + i;
+    }
+  }
+  profiler.end_event(0, 100);
+  profiler.write_json();
+  const std::string json = read_file(path);
+  std::filesystem::remove(path);
+  if (!counting) {
+    VERIFY(json.find("\"counters\"") == std::string::npos) << json;
+    return;
+  }
+  VERIFY(json.find("\"particles\": 100") != std::string::npos) << json;
+  const std::size_t pos = json.find("\"Propagation\": {\"cycles\": ");
+  VERIFY(pos != std::string::npos) << json;
+  const std::string counters = json.substr(pos);
+  const std::size_t instructions = counters.find("\"instructions\": ");
+  // The loop takes at least a few instructions per iteration
+  VERIFY(std::stod(counters.substr(instructions + 16)) > 1e6) << json;
+  VERIFY(counters.find("\"instructions_per_cycle\": ") != std::string::npos);
+  VERIFY(counters.find("\"llc_misses_per_particle\": ") != std::string::npos);
+}
@@ -1,6 +1,6 @@
 /*
  *
- *    Copyright (c) 2014-2015,2017-2020,2022
+ *    Copyright (c) 2014-2015,2017-2020,2022,2024
  *      SMASH Team
  *
  *    GNU General Public License (GPLv3 or later)
@@ -12,6 +12,7 @@
 #include "setup.h"
 #include "smash/boxmodus.h"
 #include "smash/collidermodus.h"
+#include "smash/grid.h"
 #include "smash/modusdefault.h"
 #include "smash/potentials.h"
 #include "smash/propagation.h"
@@ -76,6 +77,17 @@ TEST(propagate_default_no_potentials) {
           FourVector(1.0, 0.2 - 0.3 / 0.51, 0.0, 4.8 + 0.4 / 0.51));
 }
 
+TEST(extent_found_while_propagating) {
+  auto particles = create_box_particles();
+  GridBase::MinAndLength extent;
+  propagate_straight_line(particles.get(), 1.0, {}, &extent);
+  // The box is the same as searching the propagated particles once more
+  const GridBase::MinAndLength expected =
+      GridBase::find_min_and_length(*particles);
+  COMPARE(extent.first, expected.first);
+  COMPARE(extent.second, expected.second);
+}
+
 TEST(hubble) {
   // setting up some exeplary metrics with simple b_ for
   // easy analytic values. All ExpansionModes are tested.
@@ -1,6 +1,6 @@
 /*
  *
- *    Copyright (c) 2014-2020,2022
+ *    Copyright (c) 2014-2020,2022,2024
  *      SMASH Team
  *
  *    GNU General Public License (GPLv3 or later)
@@ -11,12 +11,83 @@
 
 #include "smash/random.h"
 
+#include <array>
 #include <cinttypes>
+#include <vector>
 
 #include "histogram.h"
 
 using namespace smash;
 
+TEST(philox_known_answers) {
+  // Reference values of the Random123 library for Philox4x64-10
+  using Block = std::array<uint64_t, 4>;
+  using Key = std::array<uint64_t, 2>;
+  COMPARE(random::Philox4x64::bijection({0, 0, 0, 0}, {0, 0}),
+          Block({0x16554d9eca36314c, 0xdb20fe9d672d0fdc, 0xd7e772cee186176b,
+                 0x7e68b68aec7ba23b}));
+  constexpr uint64_t ones = ~uint64_t(0);
+  COMPARE(random::Philox4x64::bijection({ones, ones, ones, ones}, {ones, ones}),
+          Block({0x87b092c3013fe90b, 0x438c3c67be8d0224, 0x9cc7d7c69cd777b6,
+                 0xa09caebf594f0ba0}));
+  COMPARE(random::Philox4x64::bijection(
+              Block({0x243f6a8885a308d3, 0x13198a2e03707344,
+                     0xa4093822299f31d0, 0x082efa98ec4e6c89}),
+              Key({0x452821e638d01377, 0xbe5466cf34e90c6c})),
+          Block({0xa528f45403e61d95, 0x38c72dbd566e9788, 0xa5a1610e72fd18b5,
+                 0x57bd43b5e52b7fe6}));
+}
+
+TEST(philox_seek) {
+  random::Philox4x64 sequential(42, 3);
+  std::vector<uint64_t> numbers;
+  for (int i = 0; i < 11; i++) {
+    numbers.push_back(sequential());
+  }
+  COMPARE(sequential.position(), 11u);
+  for (uint64_t skip = 0; skip < numbers.size(); skip++) {
+    random::Philox4x64 seeking(42, 3);
+    seeking.discard(skip);
+    COMPARE(seeking.position(), skip);
+    COMPARE(seeking(), numbers[skip]) << "skip = " << skip;
+  }
+  random::Philox4x64 copy(42, 3);
+  copy.set_position(11);
+  VERIFY(copy == sequential);
+  COMPARE(copy(), sequential());
+}
+
+TEST(philox_streams) {
+  random::Philox4x64 a(7, 0), b(7, 1), c(8, 0);
+  VERIFY(a != b);
+  int equal_ab = 0, equal_ac = 0;
+  for (int i = 0; i < 100; i++) {
+    const uint64_t x = a();
+    equal_ab += (x == b());
+    equal_ac += (x == c());
+  }
+  COMPARE(equal_ab, 0);
+  COMPARE(equal_ac, 0);
+  // Reseeding restarts the stream
+  b.seed(7, 0);
+  a.seed(7, 0);
+  COMPARE(a(), b());
+}
+
+TEST(engine_guard) {
+  random::set_seed(1234);
+  random::Engine reference(1234);
+  random::Engine stream(99, 5);
+  random::Engine stream_reference(99, 5);
+  {
+    random::EngineGuard guard(stream);
+    COMPARE(random::advance(), stream_reference());
+  }
+  // The stream advanced and the main engine is untouched
+  COMPARE(stream(), stream_reference());
+  COMPARE(random::advance(), reference());
+}
+
 TEST(set_random_seed) {
   std::random_device rd;
   int64_t seed = rd();
@@ -125,3 +196,71 @@ TEST(beta_a0) {
       N_TEST, 0.001, [&]() { return random::beta_a0(xmin, b); },
       [&](double x) { return std::pow(1.0 - x, b) / x; });
 }
+
+TEST(alias) {
+  const std::vector<double> weights = {1.0, 0.0, 3.0, 2.0, 0.5};
+  const random::alias_dist dist(weights);
+  const int n = 1000000;
+  std::vector<int> counts(weights.size(), 0);
+  for (int i = 0; i < n; i++) {
+    counts[dist()]++;
+  }
+  COMPARE(counts[1], 0);
+  for (std::size_t i = 0; i < weights.size(); i++) {
+    COMPARE_ABSOLUTE_ERROR(static_cast<double>(counts[i]) / n,
+                           weights[i] / 6.5, 0.002);
+  }
+  // The default distribution always draws 0
+  const random::alias_dist zero;
+  COMPARE(zero(), 0);
+}
+
+TEST(bessel_sampler_cache) {
+  const auto sampler = random::BesselSampler::cached(2.0, 3.0, 4);
+  // The same up to the precision of the cache, and for swapped means
+  VERIFY(random::BesselSampler::cached(2.0, 3.0 * (1.0 + 1.e-7), 4) ==
+         sampler);
+  VERIFY(random::BesselSampler::cached(3.0, 2.0, 4) == sampler);
+  // Different otherwise
+  VERIFY(random::BesselSampler::cached(2.0, 3.0, -4) != sampler);
+  VERIFY(random::BesselSampler::cached(2.0, 3.5, 4) != sampler);
+  for (int i = 0; i < 100; i++) {
+    const auto N1_N2 = sampler->sample();
+    COMPARE(N1_N2.first - N1_N2.second, 4);
+    VERIFY(N1_N2.second >= 0);
+  }
+}
+
+TEST(piecewise_constant) {
+  const random::piecewise_constant_dist dist(
+      0.5, 2.5, 4000, [](double x) { return x * x * std::exp(-x); });
+  test_distribution(
+      N_TEST, 0.01, [&]() { return dist(); },
+      [](double x) { return x * x * std::exp(-x); });
+}
+
+TEST(piecewise_constant_inverse_cdf) {
+  // Bins without weight are never sampled
+  const random::piecewise_constant_dist dist(
+      0., 4., 4, [](double x) { return x < 1. || x > 3. ? 0. : 1.; });
+  COMPARE(dist.integral(), 2.);
+  COMPARE(dist.inverse_cdf(0.), 1.);
+  FUZZY_COMPARE(dist.inverse_cdf(0.25), 1.5);
+  FUZZY_COMPARE(dist.inverse_cdf(0.5), 2.);
+  FUZZY_COMPARE(dist.inverse_cdf(0.75), 2.5);
+  COMPARE(dist.inverse_cdf(1.), 3.);
+}
+
+TEST(piecewise_constant_cdf) {
+  const random::piecewise_constant_dist dist(0., 4., {0., 1., 3., 0.});
+  COMPARE(dist.cdf(-1.), 0.);
+  COMPARE(dist.cdf(1.), 0.);
+  FUZZY_COMPARE(dist.cdf(1.5), 0.125);
+  FUZZY_COMPARE(dist.cdf(2.5), 0.625);
+  COMPARE(dist.cdf(3.), 1.);
+  COMPARE(dist.cdf(5.), 1.);
+  // The cumulative distribution is inverted by inverse_cdf
+  for (double x : {1.2, 1.7, 2.1, 2.9}) {
+    FUZZY_COMPARE(dist.inverse_cdf(dist.cdf(x)), x);
+  }
+}
@@ -1,6 +1,6 @@
 /*
  *
- *    Copyright (c) 2015-2023
+ *    Copyright (c) 2015-2024
  *      SMASH Team
  *
  *    GNU General Public License (GPLv3 or later)
@@ -12,6 +12,7 @@
 #include "smash/scatteraction.h"
 
 #include <algorithm>
+#include <thread>
 
 #include "Pythia8/Pythia.h"
 
@@ -28,9 +29,7 @@ TEST(init_particle_types) {
   Test::create_actual_particletypes();
   Test::create_actual_decaymodes();
   ParticleType::check_consistency();
-  sha256::Hash hash;
-  hash.fill(0);
-  IsoParticleType::tabulate_integrals(hash, "");
+  IsoParticleType::tabulate_integrals();
 }
 
 constexpr double r_x = 0.1;
@@ -305,6 +304,111 @@ TEST(pythia_running) {
   VERIFY(outgoing_particles[0].id() > p2_copy.id());
 }
 
+TEST(prefragmented_string) {
+  ParticleData p1{ParticleType::find(0x2212)};
+  ParticleData p2{ParticleType::find(0x2212)};
+  p1.set_4position(pos_a);
+  p2.set_4position(pos_b);
+  constexpr double p_x = 3.0;
+  p1.set_4momentum(p1.pole_mass(), p_x, 0., 0.);
+  p2.set_4momentum(p2.pole_mass(), -p_x, 0., 0.);
+  Particles particles;
+  particles.insert(p1);
+  particles.insert(p2);
+  ParticleList plist = particles.copy_to_vector();
+
+  auto string_process_interface = Test::default_string_process_interface();
+  ReactionsBitSet included_2to2 = ReactionsBitSet();
+  auto make_action = [&]() {
+    auto act =
+        std::make_unique<ScatterAction>(plist[0], plist[1], 0.2, false, 1.0);
+    act->set_string_interface(string_process_interface.get());
+    act->add_all_scatterings(Test::default_finder_parameters(
+        0., NNbarTreatment::NoAnnihilation, included_2to2, true, false,
+        false));
+    act->set_random_stream(42, 0);
+    return act;
+  };
+  ScatterActionPtr direct = make_action();
+  ScatterActionPtr ahead = make_action();
+  VERIFY(ahead->has_string_channel());
+
+  // Fragment ahead in another thread, which uses its own string process
+  bool fragmented = false;
+  std::thread thread([&]() { fragmented = ahead->prefragment_string(); });
+  thread.join();
+  VERIFY(fragmented);
+
+  direct->generate_final_state();
+  ahead->generate_final_state();
+  COMPARE(ahead->get_type(), direct->get_type());
+  const ParticleList &expected = direct->outgoing_particles();
+  const ParticleList &outgoing = ahead->outgoing_particles();
+  COMPARE(outgoing.size(), expected.size());
+  for (std::size_t i = 0; i < outgoing.size(); i++) {
+    COMPARE(outgoing[i].pdgcode(), expected[i].pdgcode());
+    COMPARE(outgoing[i].momentum(), expected[i].momentum());
+    COMPARE(outgoing[i].position(), expected[i].position());
+  }
+}
+
+TEST(prepared_final_state) {
+  ParticleData p1{ParticleType::find(0x2212)};
+  ParticleData p2{ParticleType::find(0x2212)};
+  p1.set_4position(pos_a);
+  p2.set_4position(pos_b);
+  constexpr double p_x = 1.0;
+  p1.set_4momentum(p1.pole_mass(), p_x, 0., 0.);
+  p2.set_4momentum(p2.pole_mass(), -p_x, 0., 0.);
+  Particles particles;
+  particles.insert(p1);
+  particles.insert(p2);
+  ParticleList plist = particles.copy_to_vector();
+
+  auto string_process_interface = Test::default_string_process_interface();
+  ReactionsBitSet included_2to2 = ReactionsBitSet().set();
+  auto make_action = [&](int stream) {
+    auto act =
+        std::make_unique<ScatterAction>(plist[0], plist[1], 0.2, false, 1.0);
+    act->set_string_interface(string_process_interface.get());
+    act->add_all_scatterings(Test::default_finder_parameters(
+        0., NNbarTreatment::NoAnnihilation, included_2to2, true, false,
+        false));
+    act->set_random_stream(42, stream);
+    return act;
+  };
+  for (ParticleData &p : particles) {
+    // Straight to the collision, before the final states are generated
+    p.set_4position(p.position() + FourVector(0.1, p.velocity() * 0.1));
+  }
+  // Different streams choose different channels, including elastic ones
+  for (int stream = 0; stream < 20; stream++) {
+    ScatterActionPtr direct = make_action(stream);
+    ScatterActionPtr ahead = make_action(stream);
+    VERIFY(!ahead->has_prepared_final_state());
+    bool prepared = false;
+    std::thread thread([&]() { prepared = ahead->prepare_final_state(); });
+    thread.join();
+    VERIFY(prepared);
+    VERIFY(ahead->has_prepared_final_state());
+
+    for (ScatterAction *act : {direct.get(), ahead.get()}) {
+      act->update_incoming(particles);
+      act->generate_final_state();
+    }
+    VERIFY(!ahead->has_prepared_final_state());
+    COMPARE(ahead->get_type(), direct->get_type());
+    const ParticleList &expected = direct->outgoing_particles();
+    const ParticleList &outgoing = ahead->outgoing_particles();
+    COMPARE(outgoing.size(), expected.size());
+    for (std::size_t i = 0; i < outgoing.size(); i++) {
+      COMPARE(outgoing[i].pdgcode(), expected[i].pdgcode());
+      COMPARE(outgoing[i].momentum(), expected[i].momentum());
+      COMPARE(outgoing[i].position(), expected[i].position());
+    }
+  }
+}
+
 TEST(no_strings) {
   const auto& proton = ParticleType::find(pdg::p);
   const auto& pi_z = ParticleType::find(pdg::pi_z);
@@ -551,3 +655,35 @@ TEST(top_down_sum_matches_parametrization) {
     }
   }
 }
+
+TEST(bottom_up_sum_matches_branches) {
+  const auto& all_types = ParticleType::list_all();
+  int ntypes = all_types.size();
+  int64_t seed = random::generate_63bit_seed();
+  random::set_seed(seed);
+  auto string_process_interface = Test::default_string_process_interface();
+  const auto finder_parameters = Test::default_finder_parameters(
+      -1., NNbarTreatment::Strings, Test::all_reactions_included(), true);
+  for (int i = 0; i < 100; i++) {
+    // create a random pair of particles
+    ParticleData p1{ParticleType::find(
+        all_types[random::uniform_int(0, ntypes - 1)].pdgcode())};
+    ParticleData p2{ParticleType::find(
+        all_types[random::uniform_int(0, ntypes - 1)].pdgcode())};
+    p1.set_4position(pos_a);
+    p2.set_4position(pos_b);
+    const double p_x = random::uniform(0., 0.5);
+    p1.set_4momentum(p1.pole_mass(), p_x, 0., 0.);
+    p2.set_4momentum(p2.pole_mass(), -p_x, 0., 0.);
+
+    ScatterAction act(p1, p2, 0.1, false, 1.0);
+    act.set_string_interface(string_process_interface.get());
+    // The sum is known before the branches are set up
+    const double sum = act.sum_of_all_scatterings(finder_parameters);
+    VERIFY(act.collision_channels().empty());
+    act.add_all_scatterings(finder_parameters);
+    COMPARE_RELATIVE_ERROR(sum, act.cross_section(), 1e-12)
+        << "Colliding " << p1.pdgcode() << " with " << p2.pdgcode()
+        << "\nRandom seed used for test: " << seed;
+  }
+}
@@ -51,9 +51,7 @@ TEST(init_decay_modes) {
       "d'\n"
       "1.      1   N N\n");
   ParticleType::check_consistency();
-  sha256::Hash hash;
-  hash.fill(0);
-  IsoParticleType::tabulate_integrals(hash, "");
+  IsoParticleType::tabulate_integrals();
 }
 
 TEST(three_meson_to_one) {
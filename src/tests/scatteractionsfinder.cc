@@ -1,6 +1,6 @@
 /*
  *
- *    Copyright (c) 2015-2020,2022
+ *    Copyright (c) 2015-2020,2022,2024
  *      SMASH Team
  *
  *    GNU General Public License (GPLv3 or later)
@@ -191,6 +191,64 @@ TEST(scatter_particle_pair_only_once) {
   }
 }
 
+TEST(statistics) {
+  // two particles colliding head-on and one far away
+  Particles p;
+  p.insert(Test::smashon(Test::Momentum{0.11, 0., .1, 0.},
+                         Test::Position{0., 1., .9, 1.}));
+  p.insert(Test::smashon(Test::Momentum{0.11, 0., -.1, 0.},
+                         Test::Position{0., 1., 1.1, 1.}));
+  p.insert(Test::smashon(Test::Momentum{0.11, 0., 0., 0.},
+                         Test::Position{0., 5., 5., 5.}));
+  const double radius = 0.11;                                        // in fm
+  const double elastic_parameter = radius * radius * M_PI / fm2_mb;  // in mb
+  ExperimentParameters exp_par = Test::default_parameters();
+  Configuration config = create_configuration_for_tests(elastic_parameter);
+  ScatterActionsFinder finder(config, exp_par);
+  ParticleList search_list = p.copy_to_vector();
+
+  const auto actions = finder.find_actions_in_cell(search_list, 0.9, 0.0, {});
+  COMPARE(actions.size(), 1u);
+  const CollisionFinderStatistics counts = finder.take_statistics();
+  COMPARE(counts.pairs_in_cells, 3u);
+  COMPARE(counts.pairs_with_neighbors, 0u);
+  COMPARE(counts.actions_found, 1u);
+  VERIFY(counts.actions_created >= 1u);
+  // Every pair is either rejected at one stage or found
+  COMPARE(counts.prefiltered + counts.rejected_types +
+              counts.rejected_nucleus + counts.rejected_time +
+              counts.rejected_distance + counts.rejected_cross_section +
+              counts.rejected_probability + counts.rejected_repeated +
+              counts.actions_found,
+          3u);
+  // The counts are reset
+  COMPARE(finder.take_statistics().pairs_in_cells, 0u);
+
+  const ParticleList first = {search_list[0]}, last = {search_list[2]};
+  finder.find_actions_with_neighbors(first, last, 0.9, {});
+  COMPARE(finder.take_statistics().pairs_with_neighbors, 1u);
+}
+
+TEST(reject_types_without_processes) {
+  // two particles colliding head-on
+  Particles p;
+  p.insert(Test::smashon(Test::Momentum{0.11, 0., .1, 0.},
+                         Test::Position{0., 1., .9, 1.}));
+  p.insert(Test::smashon(Test::Momentum{0.11, 0., -.1, 0.},
+                         Test::Position{0., 1., 1.1, 1.}));
+  ExperimentParameters exp_par = Test::default_parameters();
+  // Smashons have neither an elastic cross section nor resonances
+  Configuration config = create_configuration_for_tests(0.);
+  ScatterActionsFinder finder(config, exp_par);
+  const ParticleList search_list = p.copy_to_vector();
+
+  const auto actions = finder.find_actions_in_cell(search_list, 0.9, 0.0, {});
+  COMPARE(actions.size(), 0u);
+  const CollisionFinderStatistics counts = finder.take_statistics();
+  COMPARE(counts.rejected_types, 1u);
+  COMPARE(counts.actions_created, 0u);
+}
+
 TEST(find_next_action) {
   // let two particles collide head-on
 
@@ -333,3 +391,43 @@ TEST(check_stochastic_collision) {
   // compare probability to the probability of finding an action
   COMPARE_RELATIVE_ERROR(ratio_found, prob, 0.05);
 }
+
+TEST(sampled_stochastic_collision) {
+  Particles p;
+  p.insert(Test::smashon(Test::Momentum{0.11, 0., .1, 0.},
+                         Test::Position{0., 1., .9, 1.}));
+  p.insert(Test::smashon(Test::Momentum{0.11, 0., -.1, 0.},
+                         Test::Position{0., 1., 1.1, 1.}));
+  const double grid_cell_vol = 8.0;
+  const double dt = 0.1;
+  const double elastic_parameter = 10.0;  // in mb
+  ExperimentParameters exp_par =
+      Test::default_parameters(1, dt, CollisionCriterion::Stochastic);
+  Configuration config{R"(
+    Collision_Term:
+      Elastic_Cross_Section: 10.0
+      Sample_Pairs: true
+  )"};
+  ScatterActionsFinder finder(config, exp_par);
+  ParticleList search_list = p.copy_to_vector();
+  const double m = search_list[0].effective_mass();
+  const FourVector mom = search_list[0].momentum() + search_list[1].momentum();
+  const double v_rel =
+      std::sqrt(Action::lambda_tilde(mom.sqr(), m * m, m * m)) /
+      (2. * search_list[0].momentum().x0() * search_list[1].momentum().x0());
+
+  const int N_samples = 1E6;
+  int found_actions = 0;
+  for (int i = 0; i < N_samples; i++) {
+    found_actions +=
+        finder.find_actions_in_cell(search_list, dt, grid_cell_vol, {}).size();
+  }
+  // The pair is only a candidate with the majorant of 200 mb and v_rel = 2
+  const double majorant = 2. * 200. * fm2_mb * dt / grid_cell_vol;
+  const CollisionFinderStatistics counts = finder.take_statistics();
+  COMPARE_RELATIVE_ERROR(static_cast<double>(counts.pairs_in_cells),
+                         majorant * N_samples, 0.05);
+  const double prob = elastic_parameter * fm2_mb * v_rel * dt / grid_cell_vol;
+  COMPARE_RELATIVE_ERROR(static_cast<double>(found_actions) / N_samples, prob,
+                         0.05);
+}
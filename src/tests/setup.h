@@ -238,6 +238,7 @@ inline ExperimentParameters default_parameters(
       4.0,                                   // Gaussian smearing cut-off
       0.333333,                              // discrete smearing weight
       2.0,                                   // triangular smearing range
+      false,                                 // smearing by FFT
       crit,
       true,  // two_to_one
       all_reactions_included(),
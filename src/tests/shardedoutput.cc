@@ -0,0 +1,172 @@
+/*
+ *
+ *    Copyright (c) 2024
+ *      SMASH Team
+ *
+ *    GNU General Public License (GPLv3 or later)
+ *
+ */
+
+#include "vir/test.h"  // This include has to be first
+
+#include "smash/shardedoutput.h"
+
+#include <filesystem>
+#include <fstream>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "setup.h"
+#include "smash/binaryoutput.h"
+#include "smash/binaryreader.h"
+#include "smash/clock.h"
+#include "smash/config.h"
+#include "smash/particles.h"
+
+using namespace smash;
+
+static const std::filesystem::path testoutputpath =
+    std::filesystem::absolute(SMASH_TEST_OUTPUT_PATH);
+
+namespace {
+/// Output which remembers which particle lists it was asked to write
+class LogOutput : public OutputInterface {
+ public:
+  LogOutput(std::vector<std::string> *log, std::mutex *mutex, int shard)
+      : OutputInterface("Particles"), log_(log), mutex_(mutex), shard_(shard) {}
+  void at_eventstart(const Particles &, const int event_number,
+                     const EventInfo &) override {
+    add("start " + std::to_string(event_number));
+  }
+  void at_eventend(const Particles &particles, const int event_number,
+                   const EventInfo &) override {
+    add("end " + std::to_string(event_number) + " " +
+        std::to_string(particles.size()));
+  }
+  void at_intermediate_time(const Particles &particles,
+                            const std::unique_ptr<Clock> &,
+                            const DensityParameters &,
+                            const EventInfo &) override {
+    add("intermediate " + std::to_string(particles.size()));
+  }
+
+ private:
+  void add(const std::string &entry) {
+    std::lock_guard<std::mutex> lock(*mutex_);
+    log_->push_back("shard " + std::to_string(shard_) + ": " + entry);
+  }
+  std::vector<std::string> *log_;
+  std::mutex *mutex_;
+  const int shard_;
+};
+}  // namespace
+
+TEST(directory_is_created) {
+  std::filesystem::create_directories(testoutputpath);
+  VERIFY(std::filesystem::exists(testoutputpath));
+}
+
+TEST(init_particle_types) { Test::create_smashon_particletypes(); }
+
+TEST_CATCH(no_shards, std::invalid_argument) {
+  ShardedOutput output(testoutputpath, {}, {});
+}
+
+/*
+ * Every ensemble goes to the shard of its event number, also at the
+ * intermediate times, which do not tell the ensemble.
+ */
+TEST(ensembles_go_to_their_shards) {
+  std::vector<std::string> log;
+  std::mutex mutex;
+  {
+    OutputsList shards;
+    std::vector<std::filesystem::path> directories;
+    for (int i = 0; i < 2; i++) {
+      shards.emplace_back(std::make_unique<LogOutput>(&log, &mutex, i));
+      directories.push_back(testoutputpath / ("Log_" + std::to_string(i)));
+      std::filesystem::create_directories(directories.back());
+    }
+    ShardedOutput output(testoutputpath, std::move(shards),
+                         std::move(directories));
+    std::vector<Particles> ensembles(3);
+    for (int i = 0; i < 3; i++) {
+      ensembles[i].create(i + 1, PdgCode(Test::smashon_pdg_string));
+    }
+    const EventInfo info = Test::default_event_info();
+    const std::unique_ptr<Clock> clock =
+        std::make_unique<UniformClock>(0., 1., 10.);
+    const DensityParameters dens_param(Test::default_parameters());
+    for (int i = 0; i < 3; i++) {
+      output.at_eventstart(ensembles[i], 3 + i, info);
+    }
+    output.at_eventstart(ensembles, 1);
+    for (int i = 0; i < 3; i++) {
+      output.at_intermediate_time(ensembles[i], clock, dens_param, info);
+    }
+    output.at_intermediate_time(ensembles, clock, dens_param);
+    for (int i = 0; i < 3; i++) {
+      output.at_eventend(ensembles[i], 3 + i, info);
+    }
+    output.at_eventend(ensembles, 1);
+    COMPARE(log.size(), 9u);
+  }
+  // Within a shard, the calls are in order
+  std::vector<std::string> shard0, shard1;
+  for (const std::string &entry : log) {
+    (entry.rfind("shard 0", 0) == 0 ? shard0 : shard1).push_back(entry);
+  }
+  const std::vector<std::string> expected0 = {
+      "shard 0: start 4", "shard 0: intermediate 2", "shard 0: end 4 2"};
+  const std::vector<std::string> expected1 = {
+      "shard 1: start 3",        "shard 1: start 5",
+      "shard 1: intermediate 1", "shard 1: intermediate 3",
+      "shard 1: end 3 1",        "shard 1: end 5 3"};
+  COMPARE(shard0, expected0);
+  COMPARE(shard1, expected1);
+}
+
+/*
+ * The binary files of the shards are read as a single file via their
+ * manifest.
+ */
+TEST(binary_shards_read_as_one_file) {
+  OutputParameters output_par = OutputParameters();
+  output_par.binary_event_index = true;
+  const int n_ensembles = 4;
+  {
+    OutputsList shards;
+    std::vector<std::filesystem::path> directories;
+    for (int i = 0; i < 2; i++) {
+      directories.push_back(testoutputpath / "Shards" /
+                            ("Binary_" + std::to_string(i)));
+      std::filesystem::create_directories(directories.back());
+      shards.emplace_back(std::make_unique<BinaryOutputParticles>(
+          directories.back(), "Particles", output_par));
+    }
+    ShardedOutput output(testoutputpath, std::move(shards),
+                         std::move(directories));
+    std::vector<Particles> ensembles(n_ensembles);
+    const EventInfo info = Test::default_event_info();
+    for (int i = 0; i < n_ensembles; i++) {
+      ensembles[i].create(i + 1, PdgCode(Test::smashon_pdg_string));
+      output.at_eventend(ensembles[i], i, info);
+    }
+    output.at_eventend(ensembles, 0);
+    output.at_runend();
+  }
+
+  const std::filesystem::path manifest =
+      testoutputpath / "particles_binary.bin.shards";
+  VERIFY(std::filesystem::exists(manifest));
+  BinaryReader reader(manifest);
+  COMPARE(reader.smash_version(), SMASH_VERSION);
+  COMPARE(reader.index().size(), static_cast<std::size_t>(n_ensembles));
+  for (int i = 0; i < n_ensembles; i++) {
+    COMPARE(reader.index()[i].event_number, i);
+    COMPARE(reader.index()[i].shard, static_cast<std::uint32_t>(i % 2));
+    COMPARE(reader.particles(i).size(), static_cast<std::size_t>(i + 1));
+  }
+}
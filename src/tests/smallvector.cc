@@ -0,0 +1,83 @@
+/*
+ *
+ *    Copyright (c) 2024
+ *      SMASH Team
+ *
+ *    GNU General Public License (GPLv3 or later)
+ *
+ */
+
+#include "vir/test.h"  // This include has to be first
+
+#include "smash/smallvector.h"
+
+#include <utility>
+#include <vector>
+
+using namespace smash;
+
+TEST(inline_storage) {
+  SmallVector<int, 4> v = {1, 2, 3};
+  COMPARE(v.size(), 3u);
+  COMPARE(v.capacity(), 4u);
+  // the elements are stored within the object
+  const void *object = &v;
+  VERIFY(static_cast<const void *>(v.data()) >= object);
+  VERIFY(static_cast<const void *>(v.data()) <
+         static_cast<const void *>(&v + 1));
+  v.push_back(4);
+  COMPARE(v.capacity(), 4u);
+  COMPARE(v.back(), 4);
+}
+
+TEST(heap_storage) {
+  SmallVector<int, 2> v;
+  for (int i = 0; i < 10; i++) {
+    v.push_back(i);
+  }
+  COMPARE(v.size(), 10u);
+  VERIFY(v.capacity() >= 10u);
+  for (int i = 0; i < 10; i++) {
+    COMPARE(v[i], i);
+  }
+  // the moved-from vector is empty, the elements are kept
+  SmallVector<int, 2> w = std::move(v);
+  COMPARE(w.size(), 10u);
+  COMPARE(w[9], 9);
+  VERIFY(v.empty());
+}
+
+TEST(copy_and_compare) {
+  const SmallVector<int, 2> a = {1, 2, 3};
+  SmallVector<int, 2> b = a;
+  VERIFY(a == b);
+  b[2] = 4;
+  VERIFY(a != b);
+  VERIFY(a < b);
+  b = {1, 2};
+  COMPARE(b.size(), 2u);
+  VERIFY(b < a);
+}
+
+TEST(insert_and_erase) {
+  SmallVector<int, 4> v = {1, 3};
+  v.insert(v.begin() + 1, 2);
+  const std::vector<int> tail = {4, 5, 6};
+  v.insert(v.end(), tail.begin(), tail.end());
+  const std::vector<int> expected = {1, 2, 3, 4, 5, 6};
+  VERIFY(std::equal(v.begin(), v.end(), expected.begin(), expected.end()));
+  v.erase(v.begin());
+  v.erase(v.begin() + 1, v.begin() + 3);
+  const std::vector<int> remaining = {2, 5, 6};
+  VERIFY(std::equal(v.begin(), v.end(), remaining.begin(), remaining.end()));
+}
+
+TEST(swap) {
+  SmallVector<int, 2> a = {1};
+  SmallVector<int, 2> b = {2, 3, 4};
+  a.swap(b);
+  COMPARE(a.size(), 3u);
+  COMPARE(b.size(), 1u);
+  COMPARE(a[2], 4);
+  COMPARE(b[0], 1);
+}
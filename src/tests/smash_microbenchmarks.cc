@@ -0,0 +1,351 @@
+/*
+ *
+ *    Copyright (c) 2024
+ *      SMASH Team
+ *
+ *    GNU General Public License (GPLv3 or later)
+ *
+ */
+
+/*
+ * Microbenchmarks of the hot kernels of SMASH, based on Google Benchmark.
+ * They are meant to compare a change of one kernel in isolation, e.g.
+ *
+ *   ./smash_microbenchmarks --benchmark_filter=Grid
+ *
+ * before and after the change. Like the unit tests, they use the particles and
+ * decay modes shipped with SMASH.
+ */
+
+#include <benchmark/benchmark.h>
+
+#include <filesystem>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "setup.h"
+#include "smash/binaryoutput.h"
+#include "smash/columnaroutput.h"
+#include "smash/crosssections.h"
+#include "smash/density.h"
+#include "smash/grid.h"
+#include "smash/lattice.h"
+#include "smash/oscaroutput.h"
+#include "smash/particlessoa.h"
+#include "smash/scatteractionsfinder.h"
+#include "smash/stringprocess.h"
+#include "smash/tabulation.h"
+#include "smash/vtkoutput.h"
+#ifdef SMASH_USE_ROOT
+#include "smash/rootoutput.h"
+#endif
+
+using namespace smash;
+
+namespace {
+
+const std::filesystem::path output_path =
+    std::filesystem::absolute(SMASH_TEST_OUTPUT_PATH);
+
+/**
+ * Pions and nucleons with thermal-like momenta, distributed uniformly in a
+ * cube.
+ *
+ * \param[out] particles Particles to add to
+ * \param[in] n Number of particles
+ * \param[in] length Edge length of the cube [fm]
+ */
+void add_random_particles(Particles *particles, int n, double length) {
+  random::set_seed(1);
+  const ParticleType &pion = ParticleType::find(0x211);
+  const ParticleType &proton = ParticleType::find(0x2212);
+  for (int i = 0; i < n; i++) {
+    ParticleData p{i % 4 == 0 ? proton : pion};
+    p.set_4position(FourVector(0., random::uniform(0., length),
+                               random::uniform(0., length),
+                               random::uniform(0., length)));
+    p.set_4momentum(p.pole_mass(), random::uniform(-0.5, 0.5),
+                    random::uniform(-0.5, 0.5), random::uniform(-0.5, 0.5));
+    particles->insert(p);
+  }
+}
+
+/**
+ * The default parameters of the tests with another smearing mode.
+ *
+ * \param[in] smearing Smearing mode
+ * \return The parameters
+ */
+ExperimentParameters parameters_with_smearing(SmearingMode smearing) {
+  ExperimentParameters def = Test::default_parameters();
+  return ExperimentParameters{std::move(def.labclock),
+                              std::move(def.outputclock),
+                              def.n_ensembles,
+                              def.testparticles,
+                              def.derivatives_mode,
+                              def.rho_derivatives_mode,
+                              def.field_derivatives_mode,
+                              smearing,
+                              def.gaussian_sigma,
+                              def.gauss_cutoff_in_sigma,
+                              def.discrete_weight,
+                              def.triangular_range,
+                              def.fft_smearing,
+                              def.coll_crit,
+                              def.two_to_one,
+                              def.included_2to2,
+                              def.included_multi,
+                              def.strings_switch,
+                              def.res_lifetime_factor,
+                              def.nnbar_treatment,
+                              def.low_snn_cut,
+                              def.potential_affect_threshold,
+                              def.box_length,
+                              def.maximum_cross_section,
+                              def.fixed_min_cell_length,
+                              def.scale_xs,
+                              def.only_participants,
+                              def.do_weak_decays,
+                              def.decay_initial_particles,
+                              def.use_monash_tune_default};
+}
+
+}  // namespace
+
+/* The grid benchmarks fill a cube of 10 fm with the given number of particles
+ * per 100 fm^3. */
+
+// Construction of the collision-finding grid at various densities
+void BM_GridConstruction(benchmark::State &state) {
+  const double length = 10.;
+  const int n = state.range(0) * length * length * length / 100;
+  Particles particles;
+  add_random_particles(&particles, n, length);
+  for (auto _ : state) {
+    Grid<GridOptions::Normal> grid(particles, 2.5, 0.1,
+                                   CellNumberLimitation::ParticleNumber);
+    benchmark::DoNotOptimize(grid);
+  }
+  state.SetItemsProcessed(state.iterations() * n);
+}
+BENCHMARK(BM_GridConstruction)->Arg(1)->Arg(10)->Arg(100);
+
+// Iteration over the cells and their neighbors at various densities
+void BM_GridIterateCells(benchmark::State &state) {
+  const double length = 10.;
+  const int n = state.range(0) * length * length * length / 100;
+  Particles particles;
+  add_random_particles(&particles, n, length);
+  const Grid<GridOptions::Normal> grid(particles, 2.5, 0.1,
+                                       CellNumberLimitation::ParticleNumber);
+  for (auto _ : state) {
+    std::size_t pairs = 0;
+    grid.iterate_cells(
+        [&](const ParticleSpan &search) {
+          pairs += search.size() * (search.size() - 1) / 2;
+        },
+        [&](const ParticleSpan &search, const ParticleSpan &neighbors) {
+          pairs += search.size() * neighbors.size();
+        });
+    benchmark::DoNotOptimize(pairs);
+  }
+  state.SetItemsProcessed(state.iterations() * n);
+}
+BENCHMARK(BM_GridIterateCells)->Arg(1)->Arg(10)->Arg(100);
+
+/* The collision check of one pair per criterion. It is private to the finder
+ * and measured by searching a cell with only this pair. */
+void BM_CollisionCheck(benchmark::State &state) {
+  const auto criterion = static_cast<CollisionCriterion>(state.range(0));
+  const ExperimentParameters parameters =
+      Test::default_parameters(1, 0.1, criterion);
+  Configuration config{""};
+  ScatterActionsFinder finder(config, parameters);
+  ParticleData a{ParticleType::find(0x2212), 0};
+  ParticleData b{ParticleType::find(0x211), 1};
+  a.set_4position(FourVector(0., 0., 0., 0.));
+  b.set_4position(FourVector(0., 0.05, 0.3, 0.));
+  a.set_4momentum(a.pole_mass(), 0.3, 0., 0.);
+  b.set_4momentum(b.pole_mass(), -0.3, 0., 0.);
+  const ParticleList pair = {a, b};
+  random::set_seed(2);
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(finder.find_actions_in_cell(pair, 0.1, 8., {}));
+  }
+  state.SetLabel(criterion == CollisionCriterion::Geometric ? "Geometric"
+                 : criterion == CollisionCriterion::Stochastic
+                     ? "Stochastic"
+                     : "Covariant");
+}
+BENCHMARK(BM_CollisionCheck)
+    ->Arg(static_cast<int>(CollisionCriterion::Geometric))
+    ->Arg(static_cast<int>(CollisionCriterion::Stochastic))
+    ->Arg(static_cast<int>(CollisionCriterion::Covariant));
+
+/// Pairs of the cross section benchmark and their c.m. energy [GeV]
+const std::vector<std::pair<std::pair<int, int>, double>> pairs = {
+    {{0x2212, 0x2212}, 2.5},  // NN at low energies
+    {{0x211, 0x2212}, 1.4},   // piN in the Delta region
+    {{0x211, -0x211}, 0.8},   // pipi in the rho region
+    {{0x321, 0x2212}, 2.0},   // KN
+    {{0x2212, 0x2212}, 7.7},  // NN with strings
+};
+
+// Setting up all collision branches of representative pairs
+void BM_GenerateCollisionList(benchmark::State &state) {
+  const auto &[pdgs, sqrt_s] = pairs[state.range(0)];
+  ParticleData a{ParticleType::find(pdgs.first)};
+  ParticleData b{ParticleType::find(pdgs.second)};
+  const double p = pCM(sqrt_s, a.pole_mass(), b.pole_mass());
+  a.set_4momentum(a.pole_mass(), 0., 0., p);
+  b.set_4momentum(b.pole_mass(), 0., 0., -p);
+  const ScatterActionsFinderParameters finder_parameters =
+      Test::default_finder_parameters(-1.);
+  static const std::unique_ptr<StringProcess> string_process =
+      Test::default_string_process_interface();
+  const CrossSections xs({a, b}, sqrt_s, {FourVector(), FourVector()});
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(
+        xs.generate_collision_list(finder_parameters, string_process.get()));
+  }
+  state.SetLabel(a.type().name() + b.type().name() + " at " +
+                 std::to_string(sqrt_s) + " GeV");
+}
+BENCHMARK(BM_GenerateCollisionList)->DenseRange(0, pairs.size() - 1);
+
+// Density on the lattice per smearing mode
+void BM_UpdateLattice(benchmark::State &state) {
+  const auto smearing = static_cast<SmearingMode>(state.range(0));
+  const DensityParameters density_parameters(
+      parameters_with_smearing(smearing));
+  std::vector<Particles> ensembles(1);
+  add_random_particles(&ensembles[0], 1000, 10.);
+  const ParticlesSoA particles(ensembles);
+  DensityLattice lattice({20., 20., 20.}, {40, 40, 40}, {-5., -5., -5.}, false,
+                         LatticeUpdate::EveryTimestep);
+  for (auto _ : state) {
+    update_lattice(&lattice, LatticeUpdate::EveryTimestep, DensityType::Baryon,
+                   density_parameters, particles, true);
+    benchmark::ClobberMemory();
+  }
+  state.SetItemsProcessed(state.iterations() * particles.size());
+  state.SetLabel(smearing == SmearingMode::CovariantGaussian ? "Gaussian"
+                 : smearing == SmearingMode::Discrete        ? "Discrete"
+                                                             : "Triangular");
+}
+BENCHMARK(BM_UpdateLattice)
+    ->Arg(static_cast<int>(SmearingMode::CovariantGaussian))
+    ->Arg(static_cast<int>(SmearingMode::Discrete))
+    ->Arg(static_cast<int>(SmearingMode::Triangular));
+
+// Linear interpolation of a tabulated function at random points
+void BM_TabulationLinear(benchmark::State &state) {
+  const Tabulation table(0., 10., 1000, [](double x) { return x * x; });
+  random::set_seed(3);
+  std::vector<double> x(4096);
+  for (double &xi : x) {
+    xi = random::uniform(0., 11.);
+  }
+  for (auto _ : state) {
+    double sum = 0.;
+    for (double xi : x) {
+      sum += table.get_value_linear(xi);
+    }
+    benchmark::DoNotOptimize(sum);
+  }
+  state.SetItemsProcessed(state.iterations() * x.size());
+}
+BENCHMARK(BM_TabulationLinear);
+
+// Soft non-diffractive string process of two nucleons, including its setup
+void BM_NonDiffractiveSoftString(benchmark::State &state) {
+  const std::unique_ptr<StringProcess> string_process =
+      Test::default_string_process_interface();
+  ParticleData a{ParticleType::find(0x2212)};
+  ParticleData b{ParticleType::find(0x2212)};
+  const double sqrt_s = state.range(0);
+  const double p = pCM(sqrt_s, a.pole_mass(), b.pole_mass());
+  a.set_4momentum(a.pole_mass(), 0., 0., p);
+  b.set_4momentum(b.pole_mass(), 0., 0., -p);
+  random::set_seed(4);
+  for (auto _ : state) {
+    string_process->init({a, b}, 0.);
+    benchmark::DoNotOptimize(string_process->next_NDiffSoft());
+  }
+}
+BENCHMARK(BM_NonDiffractiveSoftString)->Arg(5)->Arg(20);
+
+// Mass of a resonance produced together with a stable particle
+void BM_SampleResonanceMass(benchmark::State &state) {
+  const bool delta = state.range(0) == 0;
+  const ParticleType &resonance = ParticleType::find(delta ? 0x2224 : 0x113);
+  const double mass_stable = delta ? 0.938 : 0.138;
+  const double sqrt_s = delta ? 2.5 : 1.2;
+  random::set_seed(5);
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(
+        resonance.sample_resonance_mass(mass_stable, sqrt_s));
+  }
+  state.SetLabel(delta ? "Delta N" : "rho pi");
+}
+BENCHMARK(BM_SampleResonanceMass)->Arg(0)->Arg(1);
+
+/// Formats of the writer benchmark
+const std::vector<std::string> formats = {
+    "Oscar1999", "Oscar2013", "Binary", "Columnar", "VTK", "VTK_XML",
+#ifdef SMASH_USE_ROOT
+    "Root",
+#endif
+};
+
+// Writing the particles at the start and end of events per output format
+void BM_ParticlesOutput(benchmark::State &state) {
+  const std::string &format = formats[state.range(0)];
+  const std::filesystem::path path = output_path / format;
+  std::filesystem::create_directories(path);
+  OutputParameters out_par;
+  std::unique_ptr<OutputInterface> output;
+  if (format == "Binary") {
+    output =
+        std::make_unique<BinaryOutputParticles>(path, "Particles", out_par);
+  } else if (format == "Columnar") {
+    output = std::make_unique<ColumnarOutput>(path, "Particles", out_par);
+  } else if (format == "VTK" || format == "VTK_XML") {
+    output = std::make_unique<VtkOutput>(path, "Particles", out_par,
+                                         format == "VTK_XML");
+#ifdef SMASH_USE_ROOT
+  } else if (format == "Root") {
+    output = std::make_unique<RootOutput>(path, "Particles", out_par);
+#endif
+  } else {
+    output = create_oscar_output(format, "Particles", path, out_par);
+  }
+  Particles particles;
+  add_random_particles(&particles, 10000, 20.);
+  const EventInfo event = Test::default_event_info();
+  int event_number = 0;
+  for (auto _ : state) {
+    output->at_eventstart(particles, event_number, event);
+    output->at_eventend(particles, event_number, event);
+    event_number++;
+  }
+  output.reset();
+  std::filesystem::remove_all(path);
+  state.SetItemsProcessed(state.iterations() * 2 * particles.size());
+  state.SetLabel(format);
+}
+BENCHMARK(BM_ParticlesOutput)->DenseRange(0, formats.size() - 1);
+
+int main(int argc, char **argv) {
+  Test::create_actual_particletypes();
+  Test::create_actual_decaymodes();
+  ParticleType::initialize_lazy_members();
+  benchmark::Initialize(&argc, argv);
+  if (benchmark::ReportUnrecognizedArguments(argc, argv)) {
+    return 1;
+  }
+  benchmark::RunSpecifiedBenchmarks();
+  return 0;
+}
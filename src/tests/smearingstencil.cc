@@ -0,0 +1,88 @@
+/*
+ *
+ *    Copyright (c) 2024
+ *      SMASH Team
+ *
+ *    GNU General Public License (GPLv3 or later)
+ *
+ */
+
+#include "vir/test.h"  // This include has to be first
+
+#include "smash/smearingstencil.h"
+
+#include <array>
+#include <cmath>
+
+#include "setup.h"
+#include "smash/density.h"
+#include "smash/lattice.h"
+#include "smash/random.h"
+
+using namespace smash;
+
+TEST(covariant_gaussian_matches_smearing_factor) {
+  random::set_seed(5);
+  const DensityParameters par(Test::default_parameters());
+  const RectangularLattice<double> lat({20., 20., 20.}, {40, 40, 40},
+                                       {-10., -10., -10.}, false,
+                                       LatticeUpdate::EveryTimestep);
+  SmearingStencil stencil;
+  for (const double p_max : {0.1, 2., 20.}) {
+    const double mass = 0.938;
+    const ThreeVector pos(random::uniform(-3., 3.), random::uniform(-3., 3.),
+                          random::uniform(-3., 3.));
+    const ThreeVector mom(random::uniform(-p_max, p_max),
+                          random::uniform(-p_max, p_max),
+                          random::uniform(-p_max, p_max));
+    const FourVector p(std::sqrt(mass * mass + mom.sqr()), mom);
+    const double r_cut = par.r_cut();
+    std::array<int, 3> l_bounds, u_bounds;
+    lat.rectangle_bounds(pos, {r_cut, r_cut, r_cut}, l_bounds, u_bounds);
+    stencil.covariant_gaussian(l_bounds, u_bounds, lat.origin(),
+                               lat.cell_sizes(), pos, p / mass, par.r_cut_sqr(),
+                               par.two_sig_sqr_inv(), true);
+    for (int iz = l_bounds[2]; iz < u_bounds[2]; iz++) {
+      for (int iy = l_bounds[1]; iy < u_bounds[1]; iy++) {
+        for (int ix = l_bounds[0]; ix < u_bounds[0]; ix++) {
+          const auto sf = unnormalized_smearing_factor(
+              pos - lat.cell_center(ix, iy, iz), p, 1. / mass, par, true);
+          const std::size_t k = stencil.index(ix, iy, iz);
+          COMPARE_RELATIVE_ERROR(stencil.weights()[k], sf.first, 1.e-12)
+              << ix << " " << iy << " " << iz;
+          for (int i = 0; i < 3; i++) {
+            COMPARE_ABSOLUTE_ERROR(stencil.gradients()[k][i], sf.second[i],
+                                   1.e-12 * sf.second.abs());
+          }
+        }
+      }
+    }
+  }
+}
+
+TEST(triangular_weights) {
+  const RectangularLattice<double> lat({10., 10., 10.}, {10, 20, 40},
+                                       {0., 0., 0.}, true,
+                                       LatticeUpdate::EveryTimestep);
+  const ThreeVector pos(0.3, 9.8, 5.05);
+  const std::array<double, 3> radius = {2., 1., 0.5};
+  std::array<int, 3> l_bounds, u_bounds;
+  lat.rectangle_bounds(pos, radius, l_bounds, u_bounds);
+  SmearingStencil stencil;
+  stencil.triangular(l_bounds, u_bounds, lat.origin(), lat.cell_sizes(), pos,
+                     radius);
+  for (int iz = l_bounds[2]; iz < u_bounds[2]; iz++) {
+    for (int iy = l_bounds[1]; iy < u_bounds[1]; iy++) {
+      for (int ix = l_bounds[0]; ix < u_bounds[0]; ix++) {
+        const ThreeVector center = lat.cell_center(ix, iy, iz);
+        COMPARE(stencil.triangular_weight(0, ix),
+                radius[0] - std::abs(center[0] - pos[0]));
+        COMPARE(stencil.triangular_weight(1, iy),
+                radius[1] - std::abs(center[1] - pos[1]));
+        COMPARE(stencil.triangular_weight(2, iz),
+                radius[2] - std::abs(center[2] - pos[2]));
+        VERIFY(stencil.triangular_weight(0, ix) >= 0.);
+      }
+    }
+  }
+}
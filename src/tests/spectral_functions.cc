@@ -1,6 +1,6 @@
 /*
  *
- *    Copyright (c) 2015-2018,2020,2022
+ *    Copyright (c) 2015-2018,2020,2022,2024
  *      SMASH Team
  *
  *    GNU General Public License (GPLv3 or later)
@@ -89,3 +89,26 @@ TEST(mass_sampling) {
     return res.spectral_function(m) * pcm * bw;
   });
 }
+
+TEST(mass_sampling_two_resonances) {
+  const ParticleType &delta = ParticleType::find(0x2224);
+  const ParticleType &rho = ParticleType::find(0x113);
+  // Dummy reaction with Δ ρ in the final state at sqrt(s) = 2.5 GeV
+  const double sqrts = 2.5;
+  const int L = 1;
+  Histogram1d hist(0.01);
+  hist.populate(1000000, [&]() {
+    return delta.sample_resonance_masses(rho, sqrts, L).first;
+  });
+  // The Δ mass follows the distribution integrated over the ρ mass
+  Integrator integrate;
+  hist.test([&](double m) {
+    const double integral =
+        integrate(rho.min_mass_spectral(), sqrts - m, [&](double m_rho) {
+          const double pcm = pCM(sqrts, m, m_rho);
+          return rho.spectral_function(m_rho) * pcm *
+                 blatt_weisskopf_sqr(pcm, L);
+        });
+    return delta.spectral_function(m) * integral;
+  });
+}
@@ -1,6 +1,6 @@
 /*
  *
- *    Copyright (c) 2020,2022
+ *    Copyright (c) 2020,2022,2024
  *      SMASH Team
  *
  *    GNU General Public License (GPLv3 or later)
@@ -10,6 +10,7 @@
 #include "vir/test.h"  // This include has to be first
 
 #include <iostream>
+#include <thread>
 
 #include "Pythia8/Pythia.h"
 
@@ -386,6 +387,15 @@ TEST(string_zlund) {
       [](double x) { return 1 / x * (1. - x) * exp(-1. / x); });
 }
 
+TEST(string_zlund_small_transverse_mass) {
+  // A leading baryon parameter and a light hadron, peaked at small z
+  test_distribution(
+      1e6, 0.001, []() { return StringProcess::sample_zLund(0.2, 0.36, 0.3); },
+      [](double x) {
+        return 1 / x * std::pow(1. - x, 0.2) * exp(-0.0324 / x);
+      });
+}
+
 TEST(string_incoming_lightcone_momenta) {
   std::unique_ptr<StringProcess> sp = std::make_unique<StringProcess>(
       1.0, 1.0, .0, 0.001, .0, .0, 1., 1., .0, .0, .5, .0, .0, .0, .0, true,
@@ -775,3 +785,137 @@ TEST(string_scaling_factors) {
   COMPARE(outgoing[3].initial_xsec_scaling_factor(), coherence_factor / 3.);
   VERIFY(outgoing[3] == c);
 }
+
+/**
+ * Run hard non-diffractive processes with PYTHIA objects which were
+ * initialized in the background, optionally shared between beams A.
+ */
+static void test_prewarmed_hard_strings(bool share) {
+  std::unique_ptr<StringProcess> sp = std::make_unique<StringProcess>(
+      1.0, 1.0, 0.5, 0.001, 2.0, 7.0, 0.16, 0.036, 0.42, 0.2, 2.0, 2.0, 0.55,
+      0.5, 1.0, false, 1. / 3., true, 0.15, false);
+  sp->set_share_hard_pythia(share);
+  sp->prewarm_hard_pythia({{PdgCode(pdg::p), PdgCode(pdg::p)},
+                           {PdgCode(pdg::pi_m), PdgCode(pdg::p)}},
+                          100.);
+  for (PdgCode pdg_a : {PdgCode(pdg::p), PdgCode(pdg::pi_m)}) {
+    ParticleData a{ParticleType::find(pdg_a)};
+    a.set_4momentum(a.pole_mass(), 0., 0., 50.);
+    ParticleData b{ParticleType::find(pdg::p)};
+    b.set_4momentum(b.pole_mass(), 0., 0., -50.);
+    sp->init({a, b}, 0.);
+    bool success = false;
+    for (int attempt = 0; attempt < 10 && !success; attempt++) {
+      success = sp->next_NDiffHard();
+    }
+    VERIFY(success) << pdg_a;
+    VERIFY(!sp->get_final_state().empty()) << pdg_a;
+  }
+}
+
+TEST(hard_string_prewarmed) { test_prewarmed_hard_strings(false); }
+
+TEST(hard_string_shared_pythia) { test_prewarmed_hard_strings(true); }
+
+TEST(string_process_per_thread) {
+  std::unique_ptr<StringProcess> sp = std::make_unique<StringProcess>(
+      1.0, 1.0, 0.5, 0.001, 2.0, 7.0, 0.16, 0.036, 0.42, 0.2, 2.0, 2.0, 0.55,
+      0.5, 1.0, false, 1. / 3., true, 0.15, false);
+  COMPARE(&sp->for_this_thread(), sp.get());
+  StringProcess *first = nullptr, *second = nullptr;
+  std::thread thread([&]() {
+    first = &sp->for_this_thread();
+    second = &sp->for_this_thread();
+  });
+  thread.join();
+  VERIFY(first != sp.get());
+  COMPARE(first, second);
+
+  // The clone computes the same cross sections
+  const std::array<double, 3> xs =
+      sp->cross_sections_diffractive(2212, 2212, 10.);
+  const std::array<double, 3> xs_clone =
+      first->cross_sections_diffractive(2212, 2212, 10.);
+  for (int i = 0; i < 3; i++) {
+    COMPARE(xs_clone[i], xs[i]);
+  }
+}
+
+TEST(take_final_state) {
+  std::unique_ptr<StringProcess> sp = std::make_unique<StringProcess>(
+      1.0, 1.0, 0.5, 0.001, 2.0, 7.0, 0.16, 0.036, 0.42, 0.2, 2.0, 2.0, 0.55,
+      0.5, 1.0, false, 1. / 3., true, 0.15, false);
+  ParticleData a{ParticleType::find(pdg::p)};
+  a.set_4momentum(a.pole_mass(), 0., 0., 5.);
+  ParticleData b{ParticleType::find(pdg::p)};
+  b.set_4momentum(b.pole_mass(), 0., 0., -5.);
+  // The scratch buffers are reused by consecutive string processes
+  for (int i = 0; i < 3; i++) {
+    sp->init({a, b}, 0.);
+    bool success = false;
+    for (int attempt = 0; attempt < 10 && !success; attempt++) {
+      success = sp->next_DDiff();
+    }
+    VERIFY(success);
+    const ParticleList expected = sp->get_final_state();
+    ParticleList final_state;
+    sp->take_final_state(final_state);
+    VERIFY(sp->get_final_state().empty());
+    COMPARE(final_state.size(), expected.size());
+    for (std::size_t j = 0; j < final_state.size(); j++) {
+      COMPARE(final_state[j].pdgcode(), expected[j].pdgcode());
+      COMPARE(final_state[j].momentum(), expected[j].momentum());
+    }
+  }
+}
+
+TEST(tabulated_diffractive_cross_sections) {
+  std::unique_ptr<StringProcess> sp = std::make_unique<StringProcess>(
+      1.0, 1.0, 0.5, 0.001, 2.0, 7.0, 0.16, 0.036, 0.42, 0.2, 2.0, 2.0, 0.55,
+      0.5, 1.0, false, 1. / 3., true, 0.15, false);
+  std::unique_ptr<StringProcess> tabulated = sp->clone();
+  tabulated->set_tabulate_diffractive(true);
+  for (const std::pair<int, int> &beams :
+       {std::make_pair(2212, 2212), std::make_pair(-211, 2112),
+        std::make_pair(-2212, 2212)}) {
+    for (double sqrt_s : {1., 4., 10., 17.3, 200., 5020., 2.e5}) {
+      const std::array<double, 3> exact =
+          sp->cross_sections_diffractive(beams.first, beams.second, sqrt_s);
+      const std::array<double, 3> xs = tabulated->cross_sections_diffractive(
+          beams.first, beams.second, sqrt_s);
+      for (int i = 0; i < 3; i++) {
+        COMPARE_RELATIVE_ERROR(xs[i], exact[i], 1.e-2)
+            << beams.first << " " << beams.second << " " << sqrt_s;
+      }
+    }
+  }
+}
+
+TEST(subprocess_statistics) {
+  std::unique_ptr<StringProcess> sp = std::make_unique<StringProcess>(
+      1.0, 1.0, 0.5, 0.001, 2.0, 7.0, 0.16, 0.036, 0.42, 0.2, 2.0, 2.0, 0.55,
+      0.5, 1.0, false, 1. / 3., true, 0.15, false);
+  using Subprocess = StringProcess::Subprocess;
+  COMPARE(sp->timed(Subprocess::Annihilation, []() { return false; }), false);
+  COMPARE(sp->timed(Subprocess::Annihilation, []() { return true; }), true);
+
+  ParticleData a{ParticleType::find(pdg::p)};
+  a.set_4momentum(a.pole_mass(), 0., 0., 5.);
+  ParticleData b{ParticleType::find(pdg::p)};
+  b.set_4momentum(b.pole_mass(), 0., 0., -5.);
+  sp->init({a, b}, 0.);
+  sp->timed(Subprocess::DoubleDiffractive, [&]() { return sp->next_DDiff(); });
+
+  const auto statistics = sp->statistics();
+  const auto &annihilation =
+      statistics[static_cast<std::size_t>(Subprocess::Annihilation)];
+  COMPARE(annihilation.calls, 2u);
+  COMPARE(annihilation.failures, 1u);
+  VERIFY(annihilation.failed_time <= annihilation.time);
+  COMPARE(statistics[static_cast<std::size_t>(Subprocess::DoubleDiffractive)]
+              .calls,
+          1u);
+  COMPARE(statistics[static_cast<std::size_t>(Subprocess::NonDiffractiveHard)]
+              .calls,
+          0u);
+}
@@ -0,0 +1,106 @@
+/*
+ *
+ *    Copyright (c) 2024
+ *      SMASH Team
+ *
+ *    GNU General Public License (GPLv3 or later)
+ *
+ */
+
+#include "vir/test.h"  // This include has to be first
+
+#include "smash/sweepandprune.h"
+
+#include <cmath>
+#include <set>
+#include <utility>
+
+#include "setup.h"
+#include "smash/particles.h"
+#include "smash/random.h"
+
+using namespace smash;
+
+TEST(init_particle_types) { Test::create_smashon_particletypes(); }
+
+/*
+ * Particles spread along x are sorted along x, and every pair within reach
+ * along x is searched exactly once, while every particle is in one block.
+ */
+TEST(pairs_within_reach) {
+  Particles particles;
+  random::set_seed(7);
+  for (int i = 0; i < 100; i++) {
+    particles.insert(Test::smashon(Test::Position{
+        0., random::uniform(-20., 20.), random::uniform(-2., 2.),
+        random::uniform(-0.5, 0.5)}));
+  }
+  constexpr double reach = 2.;
+  SweepAndPrune sweep;
+  sweep.update(particles, reach, 0.1, false);
+  COMPARE(sweep.axis(), 0);
+
+  std::multiset<int> searched;
+  std::multiset<std::pair<int, int>> pairs;
+  const auto add_pair = [&](const ParticleData &a, const ParticleData &b) {
+    pairs.insert(std::minmax(a.id(), b.id()));
+  };
+  sweep.iterate_cells(
+      [&](const ParticleSpan &block) {
+        VERIFY(block.size() <= SweepAndPrune::block_size);
+        for (std::size_t i = 0; i < block.size(); i++) {
+          searched.insert(block[i].id());
+          for (std::size_t j = i + 1; j < block.size(); j++) {
+            add_pair(block[i], block[j]);
+          }
+        }
+      },
+      [&](const ParticleSpan &block, const ParticleSpan &neighbors) {
+        for (const ParticleData &a : block) {
+          for (const ParticleData &b : neighbors) {
+            add_pair(a, b);
+          }
+        }
+      });
+
+  COMPARE(searched.size(), particles.size());
+  for (const ParticleData &p : particles) {
+    COMPARE(searched.count(p.id()), 1u);
+  }
+  for (const ParticleData &a : particles) {
+    for (const ParticleData &b : particles) {
+      if (a.id() < b.id() &&
+          std::abs(a.position().x1() - b.position().x1()) <= reach) {
+        COMPARE(pairs.count({a.id(), b.id()}), 1u) << a.id() << " " << b.id();
+      }
+    }
+  }
+  // No pair is searched twice
+  const std::set<std::pair<int, int>> unique_pairs(pairs.begin(), pairs.end());
+  COMPARE(unique_pairs.size(), pairs.size());
+}
+
+/// Skipped particles are left out and the axis follows the spread.
+TEST(skip_particles) {
+  Particles particles;
+  for (int i = 0; i < 10; i++) {
+    particles.insert(Test::smashon(Test::Position{0., 0., 0., 3. * i}));
+  }
+  SweepAndPrune sweep;
+  sweep.update(particles, 1., 0.1, false, [](const ParticleData &p) {
+    return p.id() % 2 == 1;
+  });
+  COMPARE(sweep.axis(), 2);
+  int n_searched = 0, n_neighbors = 0;
+  sweep.iterate_cells(
+      [&](const ParticleSpan &block) {
+        for (const ParticleData &p : block) {
+          COMPARE(p.id() % 2, 0);
+          n_searched++;
+        }
+      },
+      [&](const ParticleSpan &, const ParticleSpan &) { n_neighbors++; });
+  COMPARE(n_searched, 5);
+  // All particles are in one block
+  COMPARE(n_neighbors, 0);
+}
@@ -9,6 +9,9 @@
 
 #include "vir/test.h"  // This include has to be first
 
+#include <cmath>
+#include <filesystem>
+
 #include "smash/tabulation.h"
 
 using namespace smash;
@@ -89,3 +92,144 @@ TEST(quadratic) {
   // check extrapolated values
   COMPARE_ABSOLUTE_ERROR(tab.get_value_linear(3.), 7.8, error);
 }
+
+TEST(cache) {
+  const std::filesystem::path testoutputpath =
+      std::filesystem::absolute(SMASH_TEST_OUTPUT_PATH);
+  std::filesystem::create_directories(testoutputpath);
+  std::filesystem::remove(testoutputpath / "tabulations.bin");
+  sha256::Hash hash;
+  hash.fill(1);
+  int n_computed = 0;
+  auto compute = [&]() {
+    n_computed++;
+    return Tabulation(0., 10., 10, [](double x) { return x * x; });
+  };
+
+  // Without a cache, the tabulation is always computed
+  TabulationCache::get("cache_test", compute);
+  COMPARE(n_computed, 1);
+  VERIFY(!std::filesystem::exists(testoutputpath / "tabulations.bin"));
+  {
+    TabulationCache cache(testoutputpath, hash);
+    VERIFY(std::filesystem::exists(testoutputpath / "tabulations.lock"));
+    TabulationCache::get("cache_test", compute);
+    COMPARE(n_computed, 2);
+  }
+  // The archive is written when the cache is destroyed
+  VERIFY(std::filesystem::exists(testoutputpath / "tabulations.bin"));
+  VERIFY(!std::filesystem::exists(testoutputpath / "tabulations.lock"));
+
+  // The cached tabulation is read
+  {
+    TabulationCache cache(testoutputpath, hash);
+    const Tabulation tab = TabulationCache::get("cache_test", compute);
+    COMPARE(n_computed, 2);
+    FUZZY_COMPARE(tab.get_value_linear(3.), 9.);
+  }
+  // but not for another hash
+  hash.fill(2);
+  {
+    TabulationCache cache(testoutputpath, hash);
+    TabulationCache::get("cache_test", compute);
+    COMPARE(n_computed, 3);
+  }
+
+  // Sets of tabulations are only valid for the same parameters
+  auto compute_set = [&]() {
+    n_computed++;
+    return std::vector<Tabulation>(3, compute());
+  };
+  {
+    TabulationCache cache(testoutputpath, hash);
+    COMPARE(TabulationCache::get("cache_test_set", "a", compute_set).size(),
+            3u);
+    COMPARE(n_computed, 5);
+    COMPARE(TabulationCache::get("cache_test_set", "a", compute_set).size(),
+            3u);
+    COMPARE(n_computed, 5);
+    TabulationCache::get("cache_test_set", "b", compute_set);
+    COMPARE(n_computed, 7);
+  }
+
+  // Both sets end up in the same archive
+  TabulationCache cache(testoutputpath, hash);
+  const Tabulation tab = TabulationCache::get("cache_test", compute);
+  FUZZY_COMPARE(tab.get_value_linear(4.), 16.);
+  COMPARE(TabulationCache::get("cache_test_set", "b", compute_set).size(),
+          3u);
+  COMPARE(n_computed, 7);
+}
+
+TEST(adaptive_linear) {
+  // A linear function needs no refinement
+  const AdaptiveTabulation tab(0., 10., [](double x) { return 2. * x + 1.; },
+                               1e-6);
+  COMPARE(tab.n_knots(), 11u);
+  FUZZY_COMPARE(tab.get_value(-1.), 0.);
+  FUZZY_COMPARE(tab.get_value(0.), 1.);
+  FUZZY_COMPARE(tab.get_value(3.3), 7.6);
+  FUZZY_COMPARE(tab.get_value(10.), 21.);
+  // extrapolation
+  FUZZY_COMPARE(tab.get_value(12.), 25.);
+  FUZZY_COMPARE(tab.get_value(12., Extrapolation::Const), 21.);
+  FUZZY_COMPARE(tab.get_value(12., Extrapolation::Zero), 0.);
+}
+
+TEST(adaptive_resonance) {
+  // threshold behavior and a narrow peak, similar to a resonance integral
+  auto f = [](double x) {
+    return x <= 1. ? 0.
+                   : std::pow(x - 1., 1.5) / ((x - 1.5) * (x - 1.5) + 0.0025);
+  };
+  const double tolerance = 1e-4;
+  const AdaptiveTabulation tab(1., 4., f, tolerance);
+  // a uniform tabulation needs about ten times as many points for this
+  VERIFY(tab.n_knots() < 300u);
+  for (double x = 1.; x <= 4.; x += 1e-3) {
+    const double allowed = 3. * tolerance * std::max(f(x), 4.);
+    COMPARE_ABSOLUTE_ERROR(tab.get_value(x), f(x), allowed) << "x = " << x;
+  }
+}
+
+TEST(adaptive_monotone) {
+  // a steep step is interpolated without overshooting
+  const AdaptiveTabulation tab(
+      0., 2., [](double x) { return std::tanh(50. * (x - 1.)); }, 1e-4);
+  double previous = tab.get_value(0.);
+  for (double x = 0.; x <= 2.; x += 1e-4) {
+    const double value = tab.get_value(x);
+    VERIFY(value >= previous) << "x = " << x;
+    VERIFY(std::abs(value) <= 1.) << "x = " << x;
+    previous = value;
+  }
+}
+
+TEST(adaptive_cache) {
+  const std::filesystem::path testoutputpath =
+      std::filesystem::absolute(SMASH_TEST_OUTPUT_PATH);
+  std::filesystem::create_directories(testoutputpath);
+  std::filesystem::remove(testoutputpath / "tabulations.bin");
+  sha256::Hash hash;
+  hash.fill(3);
+  int n_computed = 0;
+  auto compute = [&]() {
+    n_computed++;
+    return AdaptiveTabulation(0., 2., [](double x) { return std::exp(x); },
+                              1e-4);
+  };
+  {
+    TabulationCache cache(testoutputpath, hash);
+    TabulationCache::get("adaptive_test", compute);
+  }
+  TabulationCache cache(testoutputpath, hash);
+  const AdaptiveTabulation tab = TabulationCache::get("adaptive_test", compute);
+  COMPARE(n_computed, 1);
+  COMPARE(tab.n_knots(), compute().n_knots());
+  COMPARE_RELATIVE_ERROR(tab.get_value(1.), std::exp(1.), 1e-4);
+}
+
+TEST_CATCH(only_one_cache, std::logic_error) {
+  TabulationCache cache1("", sha256::Hash{});
+  TabulationCache cache2("", sha256::Hash{});
+}
@@ -0,0 +1,90 @@
+/*
+ *
+ *    Copyright (c) 2024
+ *      SMASH Team
+ *
+ *    GNU General Public License (GPLv3 or later)
+ *
+ */
+
+#include "vir/test.h"  // This include has to be first
+
+#include "smash/tabulationarchive.h"
+
+#include <filesystem>
+#include <fstream>
+
+using namespace smash;
+
+static std::filesystem::path archive_path() {
+  const std::filesystem::path testoutputpath =
+      std::filesystem::absolute(SMASH_TEST_OUTPUT_PATH);
+  std::filesystem::create_directories(testoutputpath);
+  return testoutputpath / "archive_test.bin";
+}
+
+TEST(missing_file) {
+  std::filesystem::remove(archive_path());
+  const TabulationArchive archive = TabulationArchive::open(archive_path());
+  COMPARE(archive.size(), 0u);
+  VERIFY(archive.find("square", sha256::Hash{}).empty());
+}
+
+TEST(write_and_read) {
+  sha256::Hash hash1, hash2;
+  hash1.fill(1);
+  hash2.fill(2);
+  std::vector<TabulationArchive::Entry> entries;
+  entries.push_back(
+      {"square",
+       hash1,
+       {Tabulation(0., 10., 10, [](double x) { return x * x; })}});
+  entries.push_back(
+      {"linear_and_cube",
+       hash2,
+       {Tabulation(0., 2., 20, [](double x) { return x; }),
+        Tabulation(1., 3., 30, [](double x) { return x * x * x; })}});
+  TabulationArchive::write(archive_path(), entries);
+  VERIFY(!std::filesystem::exists(archive_path().string() + ".tmp"));
+
+  const TabulationArchive archive = TabulationArchive::open(archive_path());
+  COMPARE(archive.size(), 2u);
+  // Entries are identified by both name and hash
+  VERIFY(archive.find("square", hash2).empty());
+  VERIFY(archive.find("cube", hash2).empty());
+
+  const std::vector<Tabulation> square = archive.find("square", hash1);
+  COMPARE(square.size(), 1u);
+  FUZZY_COMPARE(square[0].get_value_linear(3.), 9.);
+  FUZZY_COMPARE(square[0].get_value_linear(12., Extrapolation::Const), 100.);
+
+  const std::vector<Tabulation> two = archive.find("linear_and_cube", hash2);
+  COMPARE(two.size(), 2u);
+  FUZZY_COMPARE(two[0].get_value_linear(1.5), 1.5);
+  FUZZY_COMPARE(two[1].get_value_linear(2.), 8.);
+  COMPARE(archive.entries().size(), 2u);
+}
+
+TEST(views_outlive_archive) {
+  std::vector<Tabulation> square;
+  {
+    const TabulationArchive archive = TabulationArchive::open(archive_path());
+    sha256::Hash hash;
+    hash.fill(1);
+    square = archive.find("square", hash);
+  }
+  // Replacing the file does not affect the mapped tabulations
+  TabulationArchive::write(archive_path(), {});
+  COMPARE(TabulationArchive::open(archive_path()).size(), 0u);
+  COMPARE(square.size(), 1u);
+  FUZZY_COMPARE(square[0].get_value_linear(5.), 25.);
+}
+
+TEST(invalid_file) {
+  {
+    std::ofstream file(archive_path(), std::ios::binary);
+    file << "SMASHTAB but not really an archive";
+  }
+  COMPARE(TabulationArchive::open(archive_path()).size(), 0u);
+  std::filesystem::remove(archive_path());
+}
@@ -0,0 +1,93 @@
+/*
+ *
+ *    Copyright (c) 2024
+ *      SMASH Team
+ *
+ *    GNU General Public License (GPLv3 or later)
+ *
+ */
+
+#include "vir/test.h"  // This include has to be first
+
+#include "smash/thermalsampling.h"
+
+#include <cmath>
+
+#include "gsl/gsl_sf_bessel.h"
+
+#include "setup.h"
+#include "smash/hadgas_eos.h"
+#include "smash/particles.h"
+#include "smash/threadpool.h"
+
+using namespace smash;
+
+TEST(init_particle_types_and_decaymodes) {
+  Test::create_actual_particletypes();
+  Test::create_actual_decaymodes();
+}
+
+// The mean energy follows <E> = 3 T + m K_1(m/T) / K_2(m/T).
+TEST(mean_energy) {
+  const double T = 0.15;
+  const ParticleType &pion = ParticleType::find(0x211);
+  const double m = pion.mass();
+  Particles particles;
+  particles.create(100000, pion.pdgcode());
+  random::set_seed(1);
+  ThermalSampling(T, false).sample(&particles);
+  double mean_energy = 0.;
+  ThreeVector mean_momentum;
+  for (const ParticleData &p : particles) {
+    FUZZY_COMPARE(p.effective_mass(), m);
+    mean_energy += p.momentum().x0() / particles.size();
+    mean_momentum += p.momentum().threevec() / particles.size();
+  }
+  const double expected =
+      3. * T + m * gsl_sf_bessel_K1(m / T) / gsl_sf_bessel_Kn(2, m / T);
+  VERIFY(std::abs(mean_energy - expected) < 0.003)
+      << mean_energy << " vs. " << expected;
+  VERIFY(mean_momentum.abs() < 0.005) << mean_momentum;
+}
+
+// The masses follow the distribution of HadronGasEos::sample_mass_thermal.
+TEST(mean_resonance_mass) {
+  const double T = 0.15;
+  const ParticleType &rho = ParticleType::find(0x113);
+  const int n = 10000;
+  Particles particles;
+  particles.create(n, rho.pdgcode());
+  random::set_seed(2);
+  ThermalSampling(T, true).sample(&particles);
+  double mean_mass = 0., expected = 0.;
+  for (const ParticleData &p : particles) {
+    const double m = p.effective_mass();
+    VERIFY(m >= rho.min_mass_spectral() && m <= 5.) << m;
+    mean_mass += m / n;
+    expected += HadronGasEos::sample_mass_thermal(rho, 1. / T) / n;
+  }
+  VERIFY(std::abs(mean_mass - expected) < 0.005)
+      << mean_mass << " vs. " << expected;
+}
+
+// Sampling the species concurrently does not change the result.
+TEST(independent_of_threads) {
+  Particles serial, parallel;
+  for (Particles *particles : {&serial, &parallel}) {
+    particles->create(100, 0x211);
+    particles->create(100, 0x321);
+    particles->create(100, 0x2212);
+    particles->create(100, 0x113);
+  }
+  ThermalSampling sampling(0.15, true);
+  random::set_seed(3);
+  sampling.sample(&serial);
+  ThreadPool pool(4);
+  random::set_seed(3);
+  sampling.sample(&parallel, &pool);
+  auto it = parallel.begin();
+  for (const ParticleData &p : serial) {
+    COMPARE(p.momentum(), it->momentum());
+    ++it;
+  }
+}
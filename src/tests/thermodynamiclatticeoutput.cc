@@ -0,0 +1,184 @@
+/*
+ *
+ *    Copyright (c) 2024
+ *      SMASH Team
+ *
+ *    GNU General Public License (GPLv3 or later)
+ *
+ */
+
+#include "vir/test.h"  // This include has to be first
+
+#include "smash/thermodynamiclatticeoutput.h"
+
+#include <array>
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "setup.h"
+#include "smash/energymomentumtensor.h"
+#include "smash/file.h"
+#include "smash/lattice.h"
+
+using namespace smash;
+
+static const std::filesystem::path testoutputpath =
+    std::filesystem::absolute(SMASH_TEST_OUTPUT_PATH);
+
+TEST(directory_is_created) {
+  std::filesystem::create_directories(testoutputpath);
+  VERIFY(std::filesystem::exists(testoutputpath));
+}
+
+/// Read a value of the given type from the file.
+template <typename T>
+static T read_binary(const FilePtr &file) {
+  T value{};
+  COMPARE(std::fread(&value, sizeof(T), 1, file.get()), 1u);
+  return value;
+}
+
+/// Lower and upper corner of the box of a time slice
+using Box = std::array<std::int32_t, 6>;
+
+/// Read a time slice and return the corners of its box.
+static Box read_slice(const FilePtr &file, double time) {
+  COMPARE(read_binary<double>(file), time);
+  Box box;
+  for (std::int32_t &corner : box) {
+    corner = read_binary<std::int32_t>(file);
+  }
+  const std::uint64_t size = read_binary<std::uint64_t>(file);
+  const std::uint64_t n_nodes =
+      (box[3] - box[0]) * (box[4] - box[1]) * (box[5] - box[2]);
+  COMPARE(size, n_nodes * 10 * sizeof(float));
+  std::fseek(file.get(), size, SEEK_CUR);
+  return box;
+}
+
+/*
+ * Every time slice of the chunked format only contains the box of the nodes,
+ * which changed since the previous slice.
+ */
+TEST(chunked_slices_contain_changed_nodes) {
+  OutputParameters out_par = OutputParameters();
+  out_par.td_tmn = true;
+  out_par.td_single_precision = true;
+  ThreadPool pool(2);
+  out_par.thread_pool = &pool;
+  RectangularLattice<EnergyMomentumTensor> lattice(
+      {4., 3., 2.}, {4, 3, 2}, {0., 0., 0.}, false, LatticeUpdate::AtOutput);
+  {
+    ThermodynamicLatticeOutput output(testoutputpath, "Thermodynamics",
+                                      out_par, false, false, true);
+    output.at_eventstart(0, ThermodynamicQuantity::Tmn, DensityType::Baryon,
+                         lattice);
+    EnergyMomentumTensor::tmn_type tmn{};
+    tmn.fill(1.);
+    lattice[1 + 4 * 1] = EnergyMomentumTensor(tmn);
+    lattice[2 + 4 * (2 + 3 * 1)] = EnergyMomentumTensor(tmn);
+    output.thermodynamics_lattice_output(ThermodynamicQuantity::Tmn, lattice,
+                                         1.);
+    output.thermodynamics_lattice_output(ThermodynamicQuantity::Tmn, lattice,
+                                         2.);
+    lattice[0] = EnergyMomentumTensor(tmn);
+    output.thermodynamics_lattice_output(ThermodynamicQuantity::Tmn, lattice,
+                                         3.);
+    output.at_eventend(ThermodynamicQuantity::Tmn);
+  }
+
+  const std::filesystem::path path =
+      testoutputpath / "net_baryon_tmn_0000000.lat";
+  FilePtr file = fopen(path, "rb");
+  VERIFY(file.get());
+  char magic[4];
+  COMPARE(std::fread(magic, 1, 4, file.get()), 4u);
+  COMPARE(std::string(magic, 4), "SMLC");
+  COMPARE(read_binary<std::uint16_t>(file),
+          ThermodynamicLatticeOutput::chunked_version);
+  COMPARE(read_binary<std::int32_t>(file), 1);
+  COMPARE(read_binary<std::int32_t>(file), 10);
+  COMPARE(read_binary<std::uint8_t>(file), sizeof(float));
+  COMPARE(read_binary<std::uint8_t>(file), 0);
+  std::fseek(file.get(), 3 * sizeof(int) + 6 * sizeof(double), SEEK_CUR);
+
+  COMPARE(read_slice(file, 1.), (Box{1, 1, 0, 3, 3, 2}));
+  COMPARE(read_slice(file, 2.), (Box{0, 0, 0, 0, 0, 0}));
+  COMPARE(read_slice(file, 3.), (Box{0, 0, 0, 1, 1, 1}));
+  VERIFY(std::fgetc(file.get()) == EOF);
+
+  file.reset();
+  VERIFY(std::filesystem::remove(path));
+}
+
+/// Read the values of the first time slice of an averaged file.
+static std::vector<double> read_averaged(const std::filesystem::path &path,
+                                         int expected_events) {
+  std::ifstream file(path);
+  VERIFY(file.good()) << path;
+  std::string line;
+  int n_events = -1;
+  while (file.peek() == '#' && std::getline(file, line)) {
+    if (line.rfind("#Events: ", 0) == 0) {
+      n_events = std::stoi(line.substr(9));
+    }
+  }
+  COMPARE(n_events, expected_events);
+  double time;
+  file >> time;
+  COMPARE(time, 1.);
+  std::vector<double> values;
+  double value;
+  while (file >> value) {
+    values.push_back(value);
+  }
+  return values;
+}
+
+/*
+ * The averaged format sums the lattice over the events and only writes the
+ * average and the variance at the end of the run.
+ */
+TEST(averaged_lattice_over_events) {
+  OutputParameters out_par = OutputParameters();
+  out_par.td_tmn = true;
+  out_par.td_variance = true;
+  RectangularLattice<EnergyMomentumTensor> lattice(
+      {2., 2., 2.}, {2, 2, 2}, {0., 0., 0.}, false, LatticeUpdate::AtOutput);
+  ThermodynamicLatticeOutput output(testoutputpath, "Thermodynamics", out_par,
+                                    false, false, false, true);
+  for (int event = 0; event < 2; event++) {
+    output.at_eventstart(event, ThermodynamicQuantity::Tmn,
+                         DensityType::Baryon, lattice);
+    EnergyMomentumTensor::tmn_type tmn{};
+    tmn.fill(1. + 2. * event);
+    for (auto &node : lattice) {
+      node = EnergyMomentumTensor(tmn);
+    }
+    output.thermodynamics_lattice_output(ThermodynamicQuantity::Tmn, lattice,
+                                         1.);
+    output.at_eventend(ThermodynamicQuantity::Tmn);
+  }
+  const std::filesystem::path average_path =
+      testoutputpath / "net_baryon_tmn_average.dat";
+  const std::filesystem::path variance_path =
+      testoutputpath / "net_baryon_tmn_variance.dat";
+  VERIFY(!std::filesystem::exists(average_path));
+  output.at_runend();
+
+  const std::vector<double> average = read_averaged(average_path, 2);
+  COMPARE(average.size(), 8u * 10u);
+  for (double value : average) {
+    COMPARE(value, 2.);
+  }
+  const std::vector<double> variance = read_averaged(variance_path, 2);
+  COMPARE(variance.size(), 8u * 10u);
+  for (double value : variance) {
+    COMPARE(value, 2.);
+  }
+  VERIFY(std::filesystem::remove(average_path));
+  VERIFY(std::filesystem::remove(variance_path));
+}
@@ -0,0 +1,118 @@
+/*
+ *
+ *    Copyright (c) 2024
+ *      SMASH Team
+ *
+ *    GNU General Public License (GPLv3 or later)
+ *
+ */
+
+#include "vir/test.h"  // This include has to be first
+
+#include "smash/threadpool.h"
+
+#include <atomic>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+using namespace smash;
+
+TEST_CATCH(no_threads, std::invalid_argument) { ThreadPool pool(0); }
+
+TEST(size) {
+  ThreadPool single(1);
+  COMPARE(single.size(), 1);
+  ThreadPool several(4);
+  COMPARE(several.size(), 4);
+}
+
+TEST(sequential_order_with_one_thread) {
+  ThreadPool pool(1);
+  std::vector<int> order;
+  pool.parallel_for(5, [&](int i) { order.push_back(i); });
+  COMPARE(order, std::vector<int>({0, 1, 2, 3, 4}));
+}
+
+TEST(every_task_once) {
+  ThreadPool pool(4);
+  // Reuse the same pool for several batches of different sizes
+  for (int n_tasks : {0, 1, 3, 4, 17, 1000}) {
+    std::vector<std::atomic<int>> counts(n_tasks);
+    pool.parallel_for(n_tasks, [&](int i) { counts[i]++; });
+    for (int i = 0; i < n_tasks; i++) {
+      COMPARE(counts[i].load(), 1) << "task " << i << " of " << n_tasks;
+    }
+  }
+}
+
+TEST(exception_is_rethrown) {
+  ThreadPool pool(3);
+  std::atomic<int> processed{0};
+  bool caught = false;
+  try {
+    pool.parallel_for(20, [&](int i) {
+      processed++;
+      if (i == 7) {
+        throw std::runtime_error("task failed");
+      }
+    });
+  } catch (std::runtime_error &) {
+    caught = true;
+  }
+  VERIFY(caught);
+  // The other tasks are still processed
+  COMPARE(processed.load(), 20);
+  // and the pool remains usable.
+  processed = 0;
+  pool.parallel_for(10, [&](int) { processed++; });
+  COMPARE(processed.load(), 10);
+}
+
+TEST(pinned_round_robin) {
+  ThreadPool pool(3, true);
+  VERIFY(pool.pinned());
+  for (int batch = 0; batch < 3; batch++) {
+    std::vector<std::thread::id> threads(10);
+    pool.parallel_for(10,
+                      [&](int i) { threads[i] = std::this_thread::get_id(); });
+    // The calling thread processes the first task of every round
+    COMPARE(threads[0], std::this_thread::get_id());
+    for (int i = 3; i < 10; i++) {
+      COMPARE(threads[i], threads[i % 3]) << "task " << i;
+    }
+  }
+}
+
+#ifdef __linux__
+TEST(caller_is_unpinned_afterwards) {
+  cpu_set_t before;
+  COMPARE(pthread_getaffinity_np(pthread_self(), sizeof(before), &before), 0);
+  ThreadPool pool(2, true);
+  pool.parallel_for(4, [](int) {});
+  cpu_set_t after;
+  COMPARE(pthread_getaffinity_np(pthread_self(), sizeof(after), &after), 0);
+  VERIFY(CPU_EQUAL(&before, &after));
+}
+#endif
+
+TEST(nested_and_concurrent_calls) {
+  ThreadPool pool(3);
+  std::vector<std::atomic<int>> counts(40);
+  std::thread other([&]() {
+    pool.parallel_for(20, [&](int i) { counts[20 + i]++; });
+  });
+  // A task calling the pool again processes the inner tasks itself
+  pool.parallel_for(4, [&](int i) {
+    pool.parallel_for(5, [&](int j) { counts[5 * i + j]++; });
+  });
+  other.join();
+  for (int i = 0; i < 40; i++) {
+    COMPARE(counts[i].load(), 1) << "task " << i;
+  }
+}
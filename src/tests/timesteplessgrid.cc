@@ -0,0 +1,75 @@
+/*
+ *
+ *    Copyright (c) 2024
+ *      SMASH Team
+ *
+ *    GNU General Public License (GPLv3 or later)
+ *
+ */
+
+#include "vir/test.h"  // This include has to be first
+
+#include "smash/timesteplessgrid.h"
+
+#include <algorithm>
+#include <vector>
+
+#include "setup.h"
+#include "smash/particles.h"
+#include "smash/random.h"
+
+using namespace smash;
+
+TEST(init_particle_types) { Test::create_smashon_particletypes(); }
+
+/*
+ * All current particles within reach of a produced particle are candidates,
+ * in the order of the particles, while removed particles and the produced
+ * particle itself are not. The reach grows with the time passed since the
+ * cells were built.
+ */
+TEST(candidates_within_reach) {
+  Particles particles;
+  random::set_seed(11);
+  for (int i = 0; i < 200; i++) {
+    particles.insert(Test::smashon(Test::Position{
+        0., random::uniform(-10., 10.), random::uniform(-10., 10.),
+        random::uniform(-10., 10.)}));
+  }
+  TimesteplessGrid grid;
+  VERIFY(!grid.is_built());
+  grid.build(particles, 1.);
+  VERIFY(grid.is_built());
+
+  const ParticleData removed = particles.front();
+  particles.remove(removed);
+  const ParticleList produced = {
+      particles.insert(Test::smashon(Test::Position{2., 1., 1., 1.}))};
+  grid.insert(produced);
+
+  std::vector<const ParticleData *> candidates;
+  constexpr double reach = 1.;
+  grid.find_candidates(produced, reach, particles, candidates);
+  VERIFY(std::is_sorted(candidates.begin(), candidates.end()));
+  const auto is_candidate = [&candidates](const ParticleData &p) {
+    return std::any_of(
+        candidates.begin(), candidates.end(),
+        [&p](const ParticleData *c) { return c->id() == p.id(); });
+  };
+  VERIFY(!is_candidate(removed));
+  VERIFY(!is_candidate(produced[0]));
+  // Two fm passed since the build
+  const double total_reach = reach + 2.;
+  for (const ParticleData &p : particles) {
+    if (p.id() != produced[0].id() &&
+        (p.position().threevec() - produced[0].position().threevec()).abs() <=
+            total_reach) {
+      VERIFY(is_candidate(p)) << p.id();
+    }
+  }
+
+  grid.clear();
+  VERIFY(!grid.is_built());
+  grid.find_candidates(produced, reach, particles, candidates);
+  VERIFY(candidates.empty());
+}
@@ -1,6 +1,6 @@
 /*
  *
- *    Copyright (c) 2017-2020,2022
+ *    Copyright (c) 2017-2020,2022,2024
  *      SMASH Team
  *
  *    GNU General Public License (GPLv3 or later)
@@ -37,9 +37,7 @@ TEST(init_decay_channels) {
       "1.0\t1\tN π\n");
   DecayModes::load_decaymodes(decays_input);
   ParticleType::check_consistency();
-  sha256::Hash hash;
-  hash.fill(0);
-  IsoParticleType::tabulate_integrals(hash, "");
+  IsoParticleType::tabulate_integrals();
 }
 
 TEST(pp_DeltaDelta_integral) {
@@ -151,3 +149,27 @@ TEST(f2_width) {
        Integralf2[m]/Integralf2[m0f2]
    */
 }
+
+TEST(integrals_tabulated_when_needed) {
+  const ParticleType &delta_plus = ParticleType::find(0x2214);
+  const ParticleType &rho = ParticleType::find(0x113);
+  const double eager_DeltaR =
+      delta_plus.iso_multiplet()->get_integral_RR(delta_plus.iso_multiplet(),
+                                                  3.162);
+  const double eager_rhoR =
+      rho.iso_multiplet()->get_integral_RR(rho.iso_multiplet(), 2.0);
+  COMPARE(IsoParticleType::tabulate_integrals({false, false, false, false,
+                                               false}),
+          0u);
+  COMPARE(delta_plus.iso_multiplet()->get_integral_RR(
+              delta_plus.iso_multiplet(), 3.162),
+          eager_DeltaR);
+  COMPARE(rho.iso_multiplet()->get_integral_rhoR(2.0), eager_rhoR);
+  // The antimultiplet shares the integral
+  COMPARE(ParticleType::find(-0x2214).iso_multiplet()->get_integral_NR(3.),
+          delta_plus.iso_multiplet()->get_integral_NR(3.));
+  // The Δ is the only baryon resonance
+  COMPARE(IsoParticleType::tabulate_integrals({false, true, false, false,
+                                               false}),
+          1u);
+}
@@ -1,6 +1,6 @@
 /*
  *
- *    Copyright (c) 2014-2020,2022
+ *    Copyright (c) 2014-2020,2022,2024
  *      SMASH Team
  *
  *    GNU General Public License (GPLv3 or later)
@@ -12,8 +12,12 @@
 #include "smash/vtkoutput.h"
 
 #include <array>
+#include <cstdint>
+#include <cstring>
 #include <filesystem>
+#include <fstream>
 #include <iostream>
+#include <iterator>
 #include <vector>
 
 #include "setup.h"
@@ -295,3 +299,66 @@ TEST(vtkoutputfile) {
   VERIFY(std::filesystem::remove(outputfilepath));
   VERIFY(std::filesystem::remove(outputfile2path));
 }
+
+TEST(vtk_xml_outputfile) {
+  Particles particles;
+  const int number_of_particles = 5;
+  for (int i = 0; i < number_of_particles; i++) {
+    particles.insert(Test::smashon_random());
+  }
+  OutputParameters out_par = OutputParameters();
+  out_par.compress_files = false;
+  {
+    VtkOutput vtkop(testoutputpath, "Particles", out_par, true);
+    EventInfo event = Test::default_event_info();
+    vtkop.at_eventstart(particles, 0, event);
+    DensityParameters dens_par(Test::default_parameters());
+    event.current_time = 1.5;
+    vtkop.at_intermediate_time(particles, nullptr, dens_par, event);
+    vtkop.at_eventend(particles, 0, event);
+  }
+  const std::filesystem::path outputfilepath =
+      testoutputpath / "pos_ev00000_tstep00000.vtu";
+  const std::filesystem::path outputfile2path =
+      testoutputpath / "pos_ev00000_tstep00001.vtu";
+  const std::filesystem::path seriespath = testoutputpath / "pos_ev00000.pvd";
+  VERIFY(std::filesystem::exists(outputfile2path));
+
+  std::ifstream outputfile(outputfilepath, std::ios::binary);
+  const std::string content((std::istreambuf_iterator<char>(outputfile)),
+                            std::istreambuf_iterator<char>());
+  COMPARE(content.substr(0, 5), "<?xml");
+  VERIFY(content.find(R"(<VTKFile type="UnstructuredGrid")") !=
+         std::string::npos);
+  // the masses are found in the appended data via the offset of their array
+  const std::size_t mass_array = content.find(R"(Name="mass")");
+  VERIFY(mass_array != std::string::npos);
+  const std::size_t offset_begin =
+      content.find("offset=\"", mass_array) + std::strlen("offset=\"");
+  const std::size_t offset = std::stoul(content.substr(offset_begin));
+  const std::size_t appended =
+      content.find("_", content.find("<AppendedData")) + 1;
+  std::uint64_t size;
+  std::memcpy(&size, content.data() + appended + offset, sizeof(size));
+  COMPARE(size, number_of_particles * sizeof(double));
+  for (int i = 0; i < number_of_particles; i++) {
+    double mass;
+    std::memcpy(&mass,
+                content.data() + appended + offset + sizeof(size) +
+                    i * sizeof(double),
+                sizeof(mass));
+    COMPARE(mass, 0.123);
+  }
+
+  std::ifstream seriesfile(seriespath);
+  const std::string series((std::istreambuf_iterator<char>(seriesfile)),
+                           std::istreambuf_iterator<char>());
+  VERIFY(series.find(R"(timestep="0" file="pos_ev00000_tstep00000.vtu")") !=
+         std::string::npos);
+  VERIFY(series.find(R"(timestep="1.5" file="pos_ev00000_tstep00001.vtu")") !=
+         std::string::npos);
+
+  VERIFY(std::filesystem::remove(outputfilepath));
+  VERIFY(std::filesystem::remove(outputfile2path));
+  VERIFY(std::filesystem::remove(seriespath));
+}
@@ -1,6 +1,6 @@
 /*
  *
- *    Copyright (c) 2016-2020,2022
+ *    Copyright (c) 2016-2020,2022,2024
  *      SMASH Team
  *
  *    GNU General Public License (GPLv3 or later)
@@ -9,6 +9,10 @@
 
 #include "vir/test.h"  // This include has to be first
 
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
 #include "setup.h"
 #include "smash/integrate.h"
 
@@ -53,6 +57,29 @@ TEST(width_Roper) {
   }
 }
 
+// The interpolated widths agree with the sum of the partial widths.
+TEST(tabulated_width) {
+  for (const int pdg : {0x2214, 0x12212, 0x113, 0x223}) {
+    const ParticleType &t = ParticleType::find(pdg);
+    const double m0 = t.mass(), width = t.width_at_pole();
+    const double x_min = std::atan((t.min_mass_kinematic() - m0) / width);
+    for (int i = 0; i < 100; i++) {
+      // from just above the threshold up to m0 + 14 Γ0
+      const double x = x_min + 0.05 + i * (1.5 - x_min - 0.05) / 99;
+      const double m = m0 + width * std::tan(x);
+      for (WhichDecaymodes wh :
+           {WhichDecaymodes::All, WhichDecaymodes::Hadronic,
+            WhichDecaymodes::Dileptons}) {
+        const double w = total_weight<DecayBranch>(t.get_partial_widths(
+            FourVector(m, 0., 0., 0.), ThreeVector(), wh));
+        const double w_tab = t.tabulated_width(m, wh);
+        VERIFY(std::abs(w_tab - w) <= 0.01 * w + 1e-6)
+            << t.name() << " at m = " << m << ": " << w_tab << " vs. " << w;
+      }
+    }
+  }
+}
+
 /* Compare the out-width vs the integrated in-width,
  * according to equ. (2.60) in Effenberger's thesis,
  * for a given resonance type, decay branch and resonance mass. */
@@ -136,3 +163,73 @@ TEST(photon_widths) {
   COMPARE_ABSOLUTE_ERROR(phi.get_partial_width(phi.mass(), {&pi0, &photon}),
                          5.4068538571729e-6, err);
 }
+
+TEST(resonance_formations) {
+  // The precomputed formations agree with the decay modes of all resonances
+  const std::vector<std::pair<PdgCode, PdgCode>> pairs = {
+      {0x211, 0x2212}, {-0x211, 0x2212}, {0x111, 0x111},
+      {-0x321, 0x2212}, {0x2212, 0x2212}, {0x211, 0x2214}};
+  for (const auto &pdgs : pairs) {
+    const ParticleType &a = ParticleType::find(pdgs.first);
+    const ParticleType &b = ParticleType::find(pdgs.second);
+    ParticleData data_a(a), data_b(b);
+    data_a.set_4momentum(a.mass(), 0., 0., 0.);
+    data_b.set_4momentum(b.mass(), 0., 0., 0.);
+    const ResonanceFormationSpan formations = resonance_formations(a, b);
+    // The order of the incoming particles does not matter
+    COMPARE(resonance_formations(b, a).begin(), formations.begin());
+    COMPARE(resonance_formations(b, a).size(), formations.size());
+
+    ParticleTypePtrList expected;
+    for (const ParticleType &resonance : ParticleType::list_all()) {
+      if (resonance.is_stable() || resonance.pdgcode() == a.pdgcode() ||
+          resonance.pdgcode() == b.pdgcode()) {
+        continue;
+      }
+      for (const auto &mode : resonance.decay_modes().decay_mode_list()) {
+        if (mode->type().has_particles({&a, &b})) {
+          expected.push_back(&resonance);
+          break;
+        }
+      }
+    }
+    COMPARE(list_possible_resonances(&a, &b), expected);
+
+    // The lookup by mass agrees with a search through the list
+    for (double mass : {0., 1.2, 1.5, 1.7, 2.1, 2.5, 3.5}) {
+      auto closer = [mass](ParticleTypePtr x, ParticleTypePtr y) {
+        return std::abs(x->mass() - mass) < std::abs(y->mass() - mass);
+      };
+      const ParticleTypePtr closest =
+          expected.empty()
+              ? ParticleTypePtr{}
+              : *std::min_element(expected.begin(), expected.end(), closer);
+      COMPARE(possible_resonance_by_mass(a, b, mass), closest);
+    }
+    const ParticleTypePtr heaviest =
+        expected.empty()
+            ? ParticleTypePtr{}
+            : *std::max_element(expected.begin(), expected.end(),
+                                [](ParticleTypePtr x, ParticleTypePtr y) {
+                                  return x->mass() < y->mass();
+                                });
+    COMPARE(possible_resonance_by_mass(
+                a, b, std::numeric_limits<double>::infinity()),
+            heaviest);
+
+    for (const ResonanceFormation &formation : formations) {
+      const ParticleType &resonance = *formation.resonance;
+      COMPARE(formation.threshold,
+              a.min_mass_kinematic() + b.min_mass_kinematic());
+      const double m = std::max(resonance.mass(), formation.threshold + 0.1);
+      double width = 0.;
+      for (std::size_t i = 0; i < formation.n_channels; i++) {
+        const FormationChannel &channel = formation.channels[i];
+        width += channel.type->in_width(resonance.mass(), channel.width_at_pole,
+                                        m, a.mass(), b.mass());
+      }
+      FUZZY_COMPARE(width, resonance.get_partial_in_width(m, data_a, data_b))
+          << resonance.name();
+    }
+  }
+}
@@ -0,0 +1,136 @@
+/*
+ *
+ *    Copyright (c) 2024
+ *      SMASH Team
+ *
+ *    GNU General Public License (GPLv3 or later)
+ *
+ */
+
+#include "smash/thermalsampling.h"
+
+#include <cmath>
+#include <functional>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "gsl/gsl_sf_bessel.h"
+
+#include "smash/angles.h"
+#include "smash/distributions.h"
+#include "smash/fpenvironment.h"
+#include "smash/particles.h"
+#include "smash/threadpool.h"
+
+namespace smash {
+
+namespace {
+/// Upper end of the tabulated masses, as in HadronGasEos::sample_mass_thermal
+constexpr double max_mass = 5.0;
+/// Number of bins of the mass distributions
+constexpr std::size_t n_mass_bins = 1000;
+/// Number of bins of the momentum distributions
+constexpr std::size_t n_momentum_bins = 2000;
+/// Largest tabulated kinetic energy in units of the temperature
+constexpr double max_kinetic_energy_over_T = 40.;
+}  // namespace
+
+ThermalSampling::ThermalSampling(double temperature,
+                                 bool account_for_resonance_widths)
+    : temperature_(temperature),
+      account_for_resonance_widths_(account_for_resonance_widths) {}
+
+ThermalSampling::Species ThermalSampling::tabulate(
+    const ParticleType &type) const {
+  // Allow underflows in exponentials
+  DisableFloatTraps guard(FE_DIVBYZERO | FE_INVALID | FE_OVERFLOW);
+  const double T = temperature_;
+  const double m0 = type.mass();
+  Species species;
+  if (account_for_resonance_widths_ && !type.is_stable()) {
+    const double half_width = 0.5 * type.width_at_pole();
+    const double m_min = type.min_mass_spectral();
+    // A(m) m^2 K_2(m/T) dm/du, relative to the threshold to avoid underflows
+    auto density = [&](double u) {
+      const double t = std::tan(u);
+      const double m = m0 + half_width * t;
+      return type.spectral_function(m) * m * m * std::exp(-(m - m_min) / T) *
+             gsl_sf_bessel_Kn_scaled(2, m / T) * half_width * (1. + t * t);
+    };
+    species.mass = random::piecewise_constant_dist(
+        std::atan((m_min - m0) / half_width),
+        std::atan((max_mass - m0) / half_width), n_mass_bins, density);
+  }
+  const double kinetic_energy_max = max_kinetic_energy_over_T * T;
+  const double p_max =
+      std::sqrt(kinetic_energy_max * (kinetic_energy_max + 2. * m0));
+  species.momentum = random::piecewise_constant_dist(
+      0., p_max, n_momentum_bins, [&](double p) {
+        return p * p * std::exp(-(std::sqrt(p * p + m0 * m0) - m0) / T);
+      });
+  return species;
+}
+
+double ThermalSampling::sample_mass(const ParticleType &type,
+                                    const Species &species) {
+  if (species.mass.empty()) {
+    return type.mass();
+  }
+  return type.mass() + 0.5 * type.width_at_pole() * std::tan(species.mass());
+}
+
+void ThermalSampling::sample(Particles *particles, ThreadPool *thread_pool) {
+  auto for_each = [thread_pool](int n, const std::function<void(int)> &f) {
+    if (!thread_pool) {
+      for (int i = 0; i < n; i++) {
+        f(i);
+      }
+      return;
+    }
+    thread_pool->parallel_for(n, f);
+  };
+
+  // Group the particles by species, in the order of the species
+  std::map<const ParticleType *, std::vector<ParticleData *>> by_species;
+  for (ParticleData &data : *particles) {
+    by_species[std::addressof(data.type())].push_back(&data);
+  }
+  std::vector<std::pair<const ParticleType *, std::vector<ParticleData *>>>
+      groups(by_species.begin(), by_species.end());
+
+  // Tabulate the species which are sampled for the first time
+  std::vector<std::pair<const ParticleType *, Species *>> new_species;
+  for (const auto &group : groups) {
+    auto inserted = species_.try_emplace(group.first);
+    if (inserted.second) {
+      new_species.emplace_back(group.first, &inserted.first->second);
+    }
+  }
+  for_each(static_cast<int>(new_species.size()), [&](int i) {
+    *new_species[i].second = tabulate(*new_species[i].first);
+  });
+
+  /* Every species has its own stream, numbered by the position in the list
+   * of all species, such that the result does not depend on the threads. */
+  const random::Engine::result_type seed = random::advance();
+  const ParticleType *first_type = std::addressof(ParticleType::list_all()[0]);
+  for_each(static_cast<int>(groups.size()), [&](int i) {
+    const ParticleType &type = *groups[i].first;
+    const Species &species = species_.at(std::addressof(type));
+    random::Engine engine(seed, std::addressof(type) - first_type + 1);
+    random::EngineGuard guard(engine);
+    for (ParticleData *data : groups[i].second) {
+      const double mass = sample_mass(type, species);
+      const double momentum_radial =
+          species.mass.empty()
+              ? species.momentum()
+              : sample_momenta_from_thermal(temperature_, mass);
+      Angles phitheta;
+      phitheta.distribute_isotropically();
+      data->set_4momentum(mass, phitheta.threevec() * momentum_radial);
+    }
+  });
+}
+
+}  // namespace smash
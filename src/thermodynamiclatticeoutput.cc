@@ -1,6 +1,6 @@
 /*
  *
- *    Copyright (c) 2014-2022
+ *    Copyright (c) 2014-2022,2024
  *      SMASH Team
  *
  *    GNU General Public License (GPLv3 or later)
@@ -9,10 +9,18 @@
 
 #include "smash/thermodynamiclatticeoutput.h"
 
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
 #include <filesystem>
 #include <fstream>
 #include <memory>
 
+#ifdef SMASH_USE_ZLIB
+#include <zlib.h>
+#endif
+
 #include "smash/clock.h"
 #include "smash/config.h"
 #include "smash/density.h"
@@ -42,6 +50,8 @@ namespace smash {
  * It is possible to print the output in:
  * - ASCII format (option "Lattice_ASCII")
  * - Binary format (option "Lattice_Binary")
+ * - Chunked binary format (option "Lattice_Chunked"), see below
+ * - Averaged ASCII format (option "Lattice_Averaged"), see below
  *
  * For example:
  *\verbatim
@@ -174,6 +184,56 @@ namespace smash {
    "number of charges"; multiply the electric current by the
    elementary charge \f$\sqrt{4 \pi \alpha_{EM}} \f$ for charge units.
  *
+ * **Chunked binary format**
+ *
+ * The "Lattice_Chunked" format stores the same quantities in files ending on
+ * ".lat", which are much smaller if most nodes of the lattice are empty or
+ * do not change between the output times. Every time slice only contains the
+ * smallest box of nodes enclosing all nodes whose values changed since the
+ * previous slice of the event, the values before the first slice being zero.
+ * A reader therefore starts from a lattice of zeros and overwrites the box of
+ * every slice in turn. The values are stored as single precision floats if
+ * \key Single_Precision is set in the \key Thermodynamics section, and every
+ * slice is compressed with zlib if \key Compress_Files is set.
+ *
+ * The header consists of
+ * - the magic number "SMLC" (4 chars) and the format version (uint16)
+ * - the thermodynamic quantity (int32, numbers as above)
+ * - the number of components at every node (int32), which is 1 for densities,
+ *   10 for energy-momentum tensors, 3 for the Landau velocity and 12 for the
+ *   currents
+ * - the size of a value in bytes, 4 or 8 (uint8)
+ * - whether the slices are compressed (uint8)
+ * - nx, ny, nz (3 ints), x0, y0, z0 (3 doubles) and dx, dy, dz (3 doubles)
+ *   as in the binary format
+ *
+ * Every time slice consists of
+ * - the output time (double)
+ * - the lower corner of the box, i.e. the indices of its first node along x,
+ *   y and z (3 int32)
+ * - the upper corner of the box, i.e. the indices behind its last node
+ *   (3 int32); the box is empty if the lower and upper corners coincide
+ * - the size of the following data in bytes (uint64)
+ * - the values of the nodes in the box, with x running fastest and the
+ *   components of a node being adjacent; the components of the
+ *   energy-momentum tensor follow the order of the binary format
+ *
+ * **Averaged format**
+ *
+ * The "Lattice_Averaged" format keeps the sums of the values over all events
+ * in memory instead of writing a file per event. At the end of the run, the
+ * averages are written to one file per quantity ending on "_average.dat", in
+ * the layout of the ASCII format, with an additional header line
+ * "#Events: " followed by the number of events. The values of every event are
+ * those written to the other formats, i.e. the lattice is already averaged
+ * over the ensembles, and the Landau frame quantities are averaged as they
+ * are instead of being computed from the averaged energy-momentum tensor.
+ * If \key Variance is set in the \key Thermodynamics section, the variances
+ * of the values over the events are written to files ending on
+ * "_variance.dat" in the same layout. The sums are not stored in checkpoints,
+ * hence the averages of a resumed run only include the events after the
+ * restart.
+ *
  * Please, have a look also at \ref input_output_thermodynamics_ for additional
  * information about the computation of the various Thermodynamics quantities.
  */
@@ -181,16 +241,24 @@ namespace smash {
 /* initialization of the static member version */
 const double_t ThermodynamicLatticeOutput::version = 1.0;
 
+const std::uint16_t ThermodynamicLatticeOutput::chunked_version = 1;
+
 ThermodynamicLatticeOutput::ThermodynamicLatticeOutput(
     const std::filesystem::path &path, const std::string &name,
     const OutputParameters &out_par, const bool enable_ascii,
-    const bool enable_binary)
+    const bool enable_binary, const bool enable_chunked,
+    const bool enable_averaged)
     : OutputInterface(name),
       out_par_(out_par),
       base_path_(std::move(path)),
+      pool_(out_par.thread_pool),
       enable_ascii_(enable_ascii),
-      enable_binary_(enable_binary) {
-  if (enable_ascii_ || enable_binary_) {
+      enable_binary_(enable_binary),
+      enable_chunked_(enable_chunked),
+      enable_averaged_(enable_averaged),
+      compress_chunks_(out_par.compress_files &&
+                       RenamingFilePtr::compression_supported()) {
+  if (enable_ascii_ || enable_binary_ || enable_chunked_ || enable_averaged_) {
     enable_output_ = true;
   } else {
     enable_output_ = false;
@@ -261,73 +329,7 @@ void ThermodynamicLatticeOutput::at_eventstart(
     sizes_[l] = cs[l];
     origin_[l] = orig[l];
   }
-  std::shared_ptr<std::ofstream> fp(nullptr);
-  std::string varname;
-  std::string filename;
-  varname = make_varname(tq, dens_type);
-  if (tq == ThermodynamicQuantity::EckartDensity) {
-    if (enable_ascii_) {
-      filename = make_filename(varname, event_number, 'a');
-      try {
-        output_ascii_files_[ThermodynamicQuantity::EckartDensity]->open(
-            filename, std::ios::out);
-      } catch (std::ofstream::failure &e) {
-        logg[LogArea::Main::id].fatal()
-            << "Error in opening " << filename << std::endl;
-        throw std::runtime_error(
-            "Not possible to write thermodynamic "
-            "lattice output to file.");
-      }
-      fp = output_ascii_files_[ThermodynamicQuantity::EckartDensity];
-      write_therm_lattice_ascii_header(fp, tq);
-    }
-    if (enable_binary_) {
-      filename = make_filename(varname, event_number, 'b');
-      try {
-        output_binary_files_[ThermodynamicQuantity::EckartDensity]->open(
-            filename, std::ios::out | std::ios::binary);
-      } catch (std::ofstream::failure &e) {
-        logg[LogArea::Main::id].fatal()
-            << "Error in opening " << filename << std::endl;
-        throw std::runtime_error(
-            "Not possible to write thermodynamic "
-            "lattice output to file.");
-      }
-      fp = output_binary_files_[ThermodynamicQuantity::EckartDensity];
-      write_therm_lattice_binary_header(fp, tq);
-    }
-  } else {
-    if (enable_ascii_) {
-      filename = make_filename(varname, event_number, 'a');
-      try {
-        output_ascii_files_[ThermodynamicQuantity::j_QBS]->open(filename,
-                                                                std::ios::out);
-      } catch (std::ofstream::failure &e) {
-        logg[LogArea::Main::id].fatal()
-            << "Error in opening " << filename << std::endl;
-        throw std::runtime_error(
-            "Not possible to write thermodynamic "
-            "lattice output to file.");
-      }
-      fp = output_ascii_files_[ThermodynamicQuantity::j_QBS];
-      write_therm_lattice_ascii_header(fp, tq);
-    }
-    if (enable_binary_) {
-      filename = make_filename(varname, event_number, 'b');
-      try {
-        output_binary_files_[ThermodynamicQuantity::j_QBS]->open(
-            filename, std::ios::out | std::ios::binary);
-      } catch (std::ofstream::failure &e) {
-        logg[LogArea::Main::id].fatal()
-            << "Error in opening " << filename << std::endl;
-        throw std::runtime_error(
-            "Not possible to write thermodynamic "
-            "lattice output to file.");
-      }
-      fp = output_binary_files_[ThermodynamicQuantity::j_QBS];
-      write_therm_lattice_binary_header(fp, tq);
-    }
-  }
+  open_files(event_number, tq, dens_type);
 }
 
 void ThermodynamicLatticeOutput::at_eventstart(
@@ -345,196 +347,144 @@ void ThermodynamicLatticeOutput::at_eventstart(
     sizes_[l] = cs[l];
     origin_[l] = orig[l];
   }
-  std::shared_ptr<std::ofstream> fp(nullptr);
-  std::string varname;
-  std::string filename;
-  varname = make_varname(tq, dens_type);
-  if (enable_ascii_) {
-    filename = make_filename(varname, event_number, 'a');
-    if (tq == ThermodynamicQuantity::TmnLandau) {
-      try {
-        output_ascii_files_[ThermodynamicQuantity::TmnLandau]->open(
-            filename, std::ios::out);
-      } catch (std::ofstream::failure &e) {
-        logg[LogArea::Main::id].fatal()
-            << "Error in opening " << filename << std::endl;
-        throw std::runtime_error(
-            "Not possible to write thermodynamic "
-            "lattice output to file.");
-      }
-      fp = output_ascii_files_[ThermodynamicQuantity::TmnLandau];
-    } else if (tq == ThermodynamicQuantity::Tmn) {
-      try {
-        output_ascii_files_[ThermodynamicQuantity::Tmn]->open(filename,
-                                                              std::ios::out);
-      } catch (std::ofstream::failure &e) {
-        logg[LogArea::Main::id].fatal()
-            << "Error in opening " << filename << std::endl;
-        throw std::runtime_error(
-            "Not possible to write thermodynamic "
-            "lattice output to file.");
-      }
-      fp = output_ascii_files_[ThermodynamicQuantity::Tmn];
-    } else if (tq == ThermodynamicQuantity::LandauVelocity) {
-      try {
-        output_ascii_files_[ThermodynamicQuantity::LandauVelocity]->open(
-            filename, std::ios::out);
-      } catch (std::ofstream::failure &e) {
-        logg[LogArea::Main::id].fatal()
-            << "Error in opening " << filename << std::endl;
-        throw std::runtime_error(
-            "Not possible to write thermodynamic "
-            "lattice output to file.");
-      }
-      fp = output_ascii_files_[ThermodynamicQuantity::LandauVelocity];
-    } else {
-      try {
-        output_ascii_files_[ThermodynamicQuantity::j_QBS]->open(filename,
-                                                                std::ios::out);
-      } catch (std::ofstream::failure &e) {
-        logg[LogArea::Main::id].fatal()
-            << "Error in opening " << filename << std::endl;
-        throw std::runtime_error(
-            "Not possible to write thermodynamic "
-            "lattice output to file.");
-      }
+  open_files(event_number, tq, dens_type);
+}
+
+void ThermodynamicLatticeOutput::open_files(const int event_number,
+                                            const ThermodynamicQuantity tq,
+                                            const DensityType dens_type) {
+  const std::string varname = make_varname(tq, dens_type);
+  auto open = [&](std::ofstream &file, const char type,
+                  const std::ios::openmode mode) {
+    const std::string filename = make_filename(varname, event_number, type);
+    try {
+      file.open(filename, mode);
+    } catch (std::ofstream::failure &e) {
+      logg[LogArea::Main::id].fatal()
+          << "Error in opening " << filename << std::endl;
+      throw std::runtime_error(
+          "Not possible to write thermodynamic "
+          "lattice output to file.");
     }
+  };
+  if (enable_ascii_) {
+    std::shared_ptr<std::ofstream> fp = output_ascii_files_[tq];
+    open(*fp, 'a', std::ios::out);
     write_therm_lattice_ascii_header(fp, tq);
   }
   if (enable_binary_) {
-    filename = make_filename(varname, event_number, 'b');
-    if (tq == ThermodynamicQuantity::TmnLandau) {
-      try {
-        output_binary_files_[ThermodynamicQuantity::TmnLandau]->open(
-            filename, std::ios::out | std::ios::binary);
-      } catch (std::ofstream::failure &e) {
-        logg[LogArea::Main::id].fatal()
-            << "Error in opening " << filename << std::endl;
-        throw std::runtime_error(
-            "Not possible to write thermodynamic "
-            "lattice output to file.");
-      }
-      fp = output_binary_files_[ThermodynamicQuantity::TmnLandau];
-    } else if (tq == ThermodynamicQuantity::Tmn) {
-      try {
-        output_binary_files_[ThermodynamicQuantity::Tmn]->open(
-            filename, std::ios::out | std::ios::binary);
-      } catch (std::ofstream::failure &e) {
-        logg[LogArea::Main::id].fatal()
-            << "Error in opening " << filename << std::endl;
-        throw std::runtime_error(
-            "Not possible to write thermodynamic "
-            "lattice output to file.");
-      }
-      fp = output_binary_files_[ThermodynamicQuantity::Tmn];
-    } else if (tq == ThermodynamicQuantity::LandauVelocity) {
-      try {
-        output_binary_files_[ThermodynamicQuantity::LandauVelocity]->open(
-            filename, std::ios::out | std::ios::binary);
-      } catch (std::ofstream::failure &e) {
-        logg[LogArea::Main::id].fatal()
-            << "Error in opening " << filename << std::endl;
-        throw std::runtime_error(
-            "Not possible to write thermodynamic "
-            "lattice output to file.");
-      }
-      fp = output_binary_files_[ThermodynamicQuantity::LandauVelocity];
-    } else {
-      try {
-        output_binary_files_[ThermodynamicQuantity::j_QBS]->open(filename,
-                                                                 std::ios::out);
-      } catch (std::ofstream::failure &e) {
-        logg[LogArea::Main::id].fatal()
-            << "Error in opening " << filename << std::endl;
-        throw std::runtime_error(
-            "Not possible to write thermodynamic "
-            "lattice output to file.");
-      }
-    }
+    std::shared_ptr<std::ofstream> fp = output_binary_files_[tq];
+    open(*fp, 'b', std::ios::out | std::ios::binary);
     write_therm_lattice_binary_header(fp, tq);
   }
+  if (enable_chunked_) {
+    ChunkedFile &chunked = output_chunked_files_[tq];
+    open(chunked.file, 'c', std::ios::out | std::ios::binary);
+    write_therm_lattice_chunked_header(chunked.file, tq);
+    chunked.previous.assign(static_cast<std::size_t>(nodes_[0]) * nodes_[1] *
+                                nodes_[2] * n_components(tq),
+                            0.0);
+  }
+  if (enable_averaged_) {
+    AveragedQuantity &averaged = averaged_quantities_[tq];
+    averaged.varname = varname;
+    averaged.next_slice = 0;
+  }
 }
 
 void ThermodynamicLatticeOutput::at_eventend(const ThermodynamicQuantity tq) {
   if (!enable_output_) {
     return;
   }
-  if (tq == ThermodynamicQuantity::EckartDensity) {
-    if (enable_ascii_) {
-      output_ascii_files_[ThermodynamicQuantity::EckartDensity]->close();
-    }
-    if (enable_binary_) {
-      output_binary_files_[ThermodynamicQuantity::EckartDensity]->close();
-    }
-    return;
+  if (enable_ascii_) {
+    output_ascii_files_[tq]->close();
   }
-  if (tq == ThermodynamicQuantity::Tmn) {
-    if (enable_ascii_) {
-      output_ascii_files_[ThermodynamicQuantity::Tmn]->close();
-    }
-    if (enable_binary_) {
-      output_binary_files_[ThermodynamicQuantity::Tmn]->close();
-    }
-    return;
+  if (enable_binary_) {
+    output_binary_files_[tq]->close();
   }
-  if (tq == ThermodynamicQuantity::TmnLandau) {
-    if (enable_ascii_) {
-      output_ascii_files_[ThermodynamicQuantity::TmnLandau]->close();
-    }
-    if (enable_binary_) {
-      output_binary_files_[ThermodynamicQuantity::TmnLandau]->close();
-    }
-    return;
+  if (enable_chunked_) {
+    output_chunked_files_[tq].file.close();
   }
-  if (tq == ThermodynamicQuantity::LandauVelocity) {
-    if (enable_ascii_) {
-      output_ascii_files_[ThermodynamicQuantity::LandauVelocity]->close();
-    }
-    if (enable_binary_) {
-      output_binary_files_[ThermodynamicQuantity::LandauVelocity]->close();
+}
+
+void ThermodynamicLatticeOutput::at_runend() {
+  for (const auto &entry : averaged_quantities_) {
+    const ThermodynamicQuantity tq = entry.first;
+    const AveragedQuantity &averaged = entry.second;
+    if (averaged.times.empty()) {
+      continue;
+    }
+    auto write = [&](const std::string &suffix, bool variance) {
+      const std::string filename =
+          base_path_.string() + "/" + averaged.varname + suffix;
+      auto file = std::make_shared<std::ofstream>(filename, std::ios::out);
+      if (!*file) {
+        logg[LogArea::Main::id].fatal()
+            << "Error in opening " << filename << std::endl;
+        throw std::runtime_error(
+            "Not possible to write thermodynamic "
+            "lattice output to file.");
+      }
+      write_therm_lattice_ascii_header(file, tq);
+      *file << "#Events: " << averaged.n_events.front() << std::endl;
+      for (std::size_t slice = 0; slice < averaged.times.size(); slice++) {
+        const double n = averaged.n_events[slice];
+        const std::vector<double> &sum = averaged.sums[slice];
+        const std::vector<double> &sum_sqr = averaged.sums_sqr[slice];
+        std::vector<double> values(sum.size());
+        for (std::size_t k = 0; k < values.size(); k++) {
+          const double mean = sum[k] / n;
+          if (!variance) {
+            values[k] = mean;
+          } else if (n > 1) {
+            // the sample variance, rounding must not make it negative
+            values[k] = std::max(0., (sum_sqr[k] - n * mean * mean) / (n - 1));
+          } else {
+            values[k] = 0.;
+          }
+        }
+        write_ascii_values(*file, tq, averaged.times[slice], values);
+      }
+    };
+    write("_average.dat", false);
+    if (out_par_.td_variance) {
+      write("_variance.dat", true);
     }
-    return;
   }
-  if (tq == ThermodynamicQuantity::j_QBS) {
-    if (enable_ascii_) {
-      output_ascii_files_[ThermodynamicQuantity::j_QBS]->close();
-    }
-    if (enable_binary_) {
-      output_binary_files_[ThermodynamicQuantity::j_QBS]->close();
-    }
-    return;
+}
+
+template <typename F>
+std::vector<double> ThermodynamicLatticeOutput::lattice_values(
+    int n_components, F &&compute) {
+  const int n_nodes = nodes_[0] * nodes_[1] * nodes_[2];
+  std::vector<double> values(static_cast<std::size_t>(n_nodes) * n_components);
+  auto compute_range = [&](int begin, int end) {
+    for (int i = begin; i < end; i++) {
+      compute(i, &values[static_cast<std::size_t>(i) * n_components]);
+    }
+  };
+  if (!pool_ || n_nodes < 2) {
+    compute_range(0, n_nodes);
+    return values;
   }
+  // a few chunks per thread even out their different costs
+  const int n_chunks = std::min(n_nodes, 4 * pool_->size());
+  const int chunk_size = (n_nodes + n_chunks - 1) / n_chunks;
+  pool_->parallel_for(n_chunks, [&](int chunk) {
+    compute_range(std::min(n_nodes, chunk * chunk_size),
+                  std::min(n_nodes, (chunk + 1) * chunk_size));
+  });
+  return values;
 }
 
 void ThermodynamicLatticeOutput::thermodynamics_lattice_output(
     RectangularLattice<DensityOnLattice> &lattice, double ctime) {
-  double result;
-  const auto dim = lattice.n_cells();
-  std::shared_ptr<std::ofstream> fp(nullptr);
-  if (enable_ascii_) {
-    fp = output_ascii_files_[ThermodynamicQuantity::EckartDensity];
-    *fp << std::setprecision(14);
-    *fp << std::scientific;
-    *fp << ctime << std::endl;
+  if (!enable_output_) {
+    return;
   }
-  if (enable_binary_) {
-    fp = output_binary_files_[ThermodynamicQuantity::EckartDensity];
-    assert(sizeof(ctime) == sizeof(double));
-    fp->write(reinterpret_cast<char *>(&ctime), sizeof(ctime));
-  }
-  lattice.iterate_sublattice(
-      {0, 0, 0}, dim, [&](DensityOnLattice &node, int ix, int, int) {
-        if (enable_ascii_) {
-          *fp << node.rho() << " ";
-          if (ix == dim[0] - 1) {
-            *fp << "\n";
-          }
-        }
-        if (enable_binary_) {
-          result = node.rho();
-          fp->write(reinterpret_cast<char *>(&result), sizeof(double));
-        }
-      });
+  const std::vector<double> values = lattice_values(
+      1, [&](int i, double *value) { *value = lattice[i].rho(); });
+  write_values(ThermodynamicQuantity::EckartDensity, ctime, values);
 }
 
 void ThermodynamicLatticeOutput::thermodynamics_lattice_output(
@@ -544,28 +494,11 @@ void ThermodynamicLatticeOutput::thermodynamics_lattice_output(
   if (!enable_output_) {
     return;
   }
-  double result;
-  const auto dim = lattice.n_cells();
-  std::shared_ptr<std::ofstream> fp(nullptr);
-  FourVector jQ = FourVector(), jB = FourVector(), jS = FourVector();
   constexpr bool compute_gradient = false;
-  if (enable_ascii_) {
-    fp = output_ascii_files_[ThermodynamicQuantity::j_QBS];
-    *fp << std::setprecision(14);
-    *fp << std::scientific;
-    *fp << ctime << std::endl;
-  }
-  if (enable_binary_) {
-    fp = output_binary_files_[ThermodynamicQuantity::j_QBS];
-    assert(sizeof(ctime) == sizeof(double));
-    fp->write(reinterpret_cast<char *>(&ctime), sizeof(ctime));
-  }
-  lattice.iterate_sublattice(
-      {0, 0, 0}, dim, [&](DensityOnLattice &, int ix, int iy, int iz) {
-        const ThreeVector position = lattice.cell_center(ix, iy, iz);
-        jQ.reset();
-        jB.reset();
-        jS.reset();
+  const std::vector<double> values = lattice_values(
+      n_components(ThermodynamicQuantity::j_QBS), [&](int i, double *value) {
+        const ThreeVector position = lattice.cell_center(i);
+        FourVector jQ = FourVector(), jB = FourVector(), jS = FourVector();
         for (const Particles &particles : ensembles) {
           jQ += std::get<1>(current_eckart(
               position, particles, dens_param, DensityType::Charge,
@@ -577,34 +510,13 @@ void ThermodynamicLatticeOutput::thermodynamics_lattice_output(
               position, particles, dens_param, DensityType::Strangeness,
               compute_gradient, out_par_.td_smearing));
         }
-        if (enable_ascii_) {
-          *fp << jQ[0];
-          for (int l = 1; l < 4; l++) {
-            *fp << " " << jQ[l];
-          }
-          for (int l = 0; l < 4; l++) {
-            *fp << " " << jB[l];
-          }
-          for (int l = 0; l < 4; l++) {
-            *fp << " " << jS[l];
-          }
-          *fp << "\n";
-        }
-        if (enable_binary_) {
-          for (int l = 0; l < 4; l++) {
-            result = jQ[l];
-            fp->write(reinterpret_cast<char *>(&result), sizeof(double));
-          }
-          for (int l = 0; l < 4; l++) {
-            result = jB[l];
-            fp->write(reinterpret_cast<char *>(&result), sizeof(double));
-          }
-          for (int l = 0; l < 4; l++) {
-            result = jS[l];
-            fp->write(reinterpret_cast<char *>(&result), sizeof(double));
-          }
+        for (int l = 0; l < 4; l++) {
+          value[l] = jQ[l];
+          value[4 + l] = jB[l];
+          value[8 + l] = jS[l];
         }
       });
+  write_values(ThermodynamicQuantity::j_QBS, ctime, values);
 }
 
 void ThermodynamicLatticeOutput::thermodynamics_lattice_output(
@@ -613,106 +525,229 @@ void ThermodynamicLatticeOutput::thermodynamics_lattice_output(
   if (!enable_output_) {
     return;
   }
-  double result;
-  const auto dim = lattice.n_cells();
-  std::shared_ptr<std::ofstream> fp(nullptr);
-  if (enable_ascii_) {
-    switch (tq) {
-      case ThermodynamicQuantity::Tmn:
-        fp = output_ascii_files_[ThermodynamicQuantity::Tmn];
-        break;
-      case ThermodynamicQuantity::TmnLandau:
-        fp = output_ascii_files_[ThermodynamicQuantity::TmnLandau];
-        break;
-      case ThermodynamicQuantity::LandauVelocity:
-        fp = output_ascii_files_[ThermodynamicQuantity::LandauVelocity];
-        break;
-      default:
-        return;
+  // the independent components in the order of the output
+  auto tensor_components = [](const EnergyMomentumTensor &T, double *value) {
+    for (int i = 0; i < 4; i++) {
+      for (int j = i; j < 4; j++) {
+        *value++ = T[EnergyMomentumTensor::tmn_index(i, j)];
+      }
     }
-    *fp << std::setprecision(14);
-    *fp << std::scientific;
-    *fp << ctime << std::endl;
+  };
+  std::vector<double> values;
+  switch (tq) {
+    case ThermodynamicQuantity::Tmn:
+      values = lattice_values(n_components(tq), [&](int i, double *value) {
+        tensor_components(lattice[i], value);
+      });
+      break;
+    case ThermodynamicQuantity::TmnLandau:
+      values = lattice_values(n_components(tq), [&](int i, double *value) {
+        const FourVector u = lattice[i].landau_frame_4velocity();
+        tensor_components(lattice[i].boosted(u), value);
+      });
+      break;
+    case ThermodynamicQuantity::LandauVelocity:
+      values = lattice_values(n_components(tq), [&](int i, double *value) {
+        const FourVector u = lattice[i].landau_frame_4velocity();
+        const ThreeVector v = -u.velocity();
+        value[0] = v.x1();
+        value[1] = v.x2();
+        value[2] = v.x3();
+      });
+      break;
+    default:
+      return;
+  }
+  write_values(tq, ctime, values);
+}
+
+void ThermodynamicLatticeOutput::write_values(
+    const ThermodynamicQuantity tq, double ctime,
+    const std::vector<double> &values) {
+  const int n_comp = n_components(tq);
+  const std::size_t n_nodes = values.size() / n_comp;
+  /* Velocities and currents are written node by node, all other quantities
+   * component by component. */
+  const bool by_node = tq == ThermodynamicQuantity::LandauVelocity ||
+                       tq == ThermodynamicQuantity::j_QBS;
+  if (enable_ascii_) {
+    write_ascii_values(*output_ascii_files_[tq], tq, ctime, values);
   }
   if (enable_binary_) {
-    switch (tq) {
-      case ThermodynamicQuantity::Tmn:
-        fp = output_binary_files_[ThermodynamicQuantity::Tmn];
-        break;
-      case ThermodynamicQuantity::TmnLandau:
-        fp = output_binary_files_[ThermodynamicQuantity::TmnLandau];
-        break;
-      case ThermodynamicQuantity::LandauVelocity:
-        fp = output_binary_files_[ThermodynamicQuantity::LandauVelocity];
-        break;
-      default:
-        return;
+    std::ofstream &file = *output_binary_files_[tq];
+    file.write(reinterpret_cast<char *>(&ctime), sizeof(ctime));
+    if (by_node || n_comp == 1) {
+      file.write(reinterpret_cast<const char *>(values.data()),
+                 values.size() * sizeof(double));
+    } else {
+      std::vector<double> by_component(values.size());
+      for (int c = 0; c < n_comp; c++) {
+        for (std::size_t i = 0; i < n_nodes; i++) {
+          by_component[c * n_nodes + i] = values[i * n_comp + c];
+        }
+      }
+      file.write(reinterpret_cast<const char *>(by_component.data()),
+                 by_component.size() * sizeof(double));
     }
-    assert(sizeof(ctime) == sizeof(double));
-    fp->write(reinterpret_cast<char *>(&ctime), sizeof(double));
   }
-  switch (tq) {
-    case ThermodynamicQuantity::Tmn:
-      for (int i = 0; i < 4; i++) {
-        for (int j = i; j < 4; j++) {
-          lattice.iterate_sublattice(
-              {0, 0, 0}, dim,
-              [&](EnergyMomentumTensor &node, int ix, int, int) {
-                if (enable_ascii_) {
-                  *fp << node[EnergyMomentumTensor::tmn_index(i, j)] << " ";
-                  if (ix == dim[0] - 1) {
-                    *fp << "\n";
-                  }
-                }
-                if (enable_binary_) {
-                  result = node[EnergyMomentumTensor::tmn_index(i, j)];
-                  fp->write(reinterpret_cast<char *>(&result), sizeof(double));
-                }
-              });
+  if (enable_chunked_) {
+    write_chunk(tq, ctime, values);
+  }
+  if (enable_averaged_) {
+    accumulate(tq, ctime, values);
+  }
+}
+
+void ThermodynamicLatticeOutput::write_ascii_values(
+    std::ofstream &file, const ThermodynamicQuantity tq, double ctime,
+    const std::vector<double> &values) {
+  const int n_comp = n_components(tq);
+  const std::size_t n_nodes = values.size() / n_comp;
+  // as in write_values
+  const bool by_node = tq == ThermodynamicQuantity::LandauVelocity ||
+                       tq == ThermodynamicQuantity::j_QBS;
+  file << std::setprecision(14);
+  file << std::scientific;
+  file << ctime << std::endl;
+  if (by_node) {
+    for (std::size_t i = 0; i < n_nodes; i++) {
+      file << values[i * n_comp];
+      for (int c = 1; c < n_comp; c++) {
+        file << " " << values[i * n_comp + c];
+      }
+      file << "\n";
+    }
+  } else {
+    for (int c = 0; c < n_comp; c++) {
+      for (std::size_t i = 0; i < n_nodes; i++) {
+        file << values[i * n_comp + c] << " ";
+        if ((i + 1) % nodes_[0] == 0) {
+          file << "\n";
         }
       }
-      break;
-    case ThermodynamicQuantity::TmnLandau:
-      for (int i = 0; i < 4; i++) {
-        for (int j = i; j < 4; j++) {
-          lattice.iterate_sublattice(
-              {0, 0, 0}, dim,
-              [&](EnergyMomentumTensor &node, int ix, int, int) {
-                if (enable_ascii_) {
-                  const FourVector u = node.landau_frame_4velocity();
-                  const EnergyMomentumTensor Tmn_L = node.boosted(u);
-                  *fp << Tmn_L[EnergyMomentumTensor::tmn_index(i, j)] << " ";
-                  if (ix == dim[0] - 1) {
-                    *fp << "\n";
-                  }
-                }
-                if (enable_binary_) {
-                  const FourVector u = node.landau_frame_4velocity();
-                  const EnergyMomentumTensor Tmn_L = node.boosted(u);
-                  result = Tmn_L[EnergyMomentumTensor::tmn_index(i, j)];
-                  fp->write(reinterpret_cast<char *>(&result), sizeof(double));
-                }
-              });
+    }
+  }
+}
+
+void ThermodynamicLatticeOutput::accumulate(const ThermodynamicQuantity tq,
+                                            double ctime,
+                                            const std::vector<double> &values) {
+  AveragedQuantity &averaged = averaged_quantities_[tq];
+  const std::size_t slice = averaged.next_slice++;
+  if (slice == averaged.times.size()) {
+    // the first event reaching this output time
+    averaged.times.push_back(ctime);
+    averaged.n_events.push_back(0);
+    averaged.sums.emplace_back(values.size(), 0.0);
+    averaged.sums_sqr.emplace_back(values.size(), 0.0);
+  }
+  averaged.n_events[slice]++;
+  std::vector<double> &sum = averaged.sums[slice];
+  std::vector<double> &sum_sqr = averaged.sums_sqr[slice];
+  for (std::size_t k = 0; k < values.size(); k++) {
+    sum[k] += values[k];
+    sum_sqr[k] += values[k] * values[k];
+  }
+}
+
+void ThermodynamicLatticeOutput::write_chunk(
+    const ThermodynamicQuantity tq, double ctime,
+    const std::vector<double> &values) {
+  ChunkedFile &chunked = output_chunked_files_[tq];
+  const int n_comp = n_components(tq);
+  const bool single_precision = out_par_.td_single_precision;
+  // the values are compared as they are stored
+  auto stored = [single_precision](double value) {
+    return single_precision ? static_cast<double>(static_cast<float>(value))
+                            : value;
+  };
+  auto unchanged = [](double a, double b) {
+    return a == b || (std::isnan(a) && std::isnan(b));
+  };
+
+  // bounding box of the changed nodes, the upper bounds are excluded
+  std::array<std::int32_t, 3> lower = {nodes_[0], nodes_[1], nodes_[2]};
+  std::array<std::int32_t, 3> upper = {0, 0, 0};
+  std::size_t node = 0;
+  for (int iz = 0; iz < nodes_[2]; iz++) {
+    for (int iy = 0; iy < nodes_[1]; iy++) {
+      for (int ix = 0; ix < nodes_[0]; ix++, node++) {
+        for (int c = 0; c < n_comp; c++) {
+          const std::size_t k = node * n_comp + c;
+          if (!unchanged(stored(values[k]), chunked.previous[k])) {
+            const std::array<int, 3> index = {ix, iy, iz};
+            for (int l = 0; l < 3; l++) {
+              lower[l] = std::min(lower[l], index[l]);
+              upper[l] = std::max(upper[l], index[l] + 1);
+            }
+            break;
+          }
         }
       }
-      break;
+    }
+  }
+  if (upper[0] == 0) {
+    // nothing changed, the box is empty
+    lower = {0, 0, 0};
+  }
+
+  std::vector<char> data;
+  auto append = [&data](const auto value) {
+    const char *bytes = reinterpret_cast<const char *>(&value);
+    data.insert(data.end(), bytes, bytes + sizeof(value));
+  };
+  for (int iz = lower[2]; iz < upper[2]; iz++) {
+    for (int iy = lower[1]; iy < upper[1]; iy++) {
+      for (int ix = lower[0]; ix < upper[0]; ix++) {
+        const std::size_t first =
+            (ix + nodes_[0] * (iy + static_cast<std::size_t>(nodes_[1]) * iz)) *
+            n_comp;
+        for (std::size_t k = first; k < first + n_comp; k++) {
+          chunked.previous[k] = stored(values[k]);
+          if (single_precision) {
+            append(static_cast<float>(values[k]));
+          } else {
+            append(values[k]);
+          }
+        }
+      }
+    }
+  }
+#ifdef SMASH_USE_ZLIB
+  if (compress_chunks_ && !data.empty()) {
+    uLongf compressed_size = compressBound(data.size());
+    std::vector<char> compressed(compressed_size);
+    ::compress(reinterpret_cast<Bytef *>(compressed.data()), &compressed_size,
+               reinterpret_cast<const Bytef *>(data.data()), data.size());
+    compressed.resize(compressed_size);
+    data = std::move(compressed);
+  }
+#endif
+
+  std::ofstream &file = chunked.file;
+  const std::uint64_t size = data.size();
+  file.write(reinterpret_cast<char *>(&ctime), sizeof(ctime));
+  file.write(reinterpret_cast<const char *>(lower.data()), sizeof(lower));
+  file.write(reinterpret_cast<const char *>(upper.data()), sizeof(upper));
+  file.write(reinterpret_cast<const char *>(&size), sizeof(size));
+  file.write(data.data(), data.size());
+}
+
+int ThermodynamicLatticeOutput::n_components(const ThermodynamicQuantity tq) {
+  switch (tq) {
+    case ThermodynamicQuantity::EckartDensity:
+      return 1;
+    case ThermodynamicQuantity::Tmn:
+    case ThermodynamicQuantity::TmnLandau:
+      return 10;
     case ThermodynamicQuantity::LandauVelocity:
-      lattice.iterate_sublattice(
-          {0, 0, 0}, dim, [&](EnergyMomentumTensor &node, int, int, int) {
-            if (enable_ascii_) {
-              const FourVector u = node.landau_frame_4velocity();
-              const ThreeVector v = -u.velocity();
-              *fp << v.x1() << " " << v.x2() << " " << v.x3() << "\n";
-            }
-            if (enable_binary_) {
-              const FourVector u = node.landau_frame_4velocity();
-              ThreeVector v = -u.velocity();
-              fp->write(reinterpret_cast<char *>(&v), 3 * sizeof(double));
-            }
-          });
-      break;
+      return 3;
+    case ThermodynamicQuantity::j_QBS:
+      return 12;
     default:
-      return;
+      throw std::runtime_error(
+          "Error when counting the components of a thermodynamic quantity, "
+          "unknown quantity.");
   }
 }
 
@@ -739,9 +774,11 @@ std::string ThermodynamicLatticeOutput::make_filename(const std::string &descr,
                                                       const int event_number,
                                                       const char type) {
   char suffix[13];
-  assert((type == 'a') || (type == 'b'));
+  assert((type == 'a') || (type == 'b') || (type == 'c'));
   if (type == 'a') {
     snprintf(suffix, sizeof(suffix), "_%07i.dat", event_number);
+  } else if (type == 'c') {
+    snprintf(suffix, sizeof(suffix), "_%07i.lat", event_number);
   } else {
     snprintf(suffix, sizeof(suffix), "_%07i.bin", event_number);
   }
@@ -782,4 +819,23 @@ void ThermodynamicLatticeOutput::write_therm_lattice_binary_header(
   fp->write(reinterpret_cast<char *>(&sizes_), sizeof(sizes_));
   fp->write(reinterpret_cast<char *>(&origin_), sizeof(origin_));
 }
+
+void ThermodynamicLatticeOutput::write_therm_lattice_chunked_header(
+    std::ofstream &file, const ThermodynamicQuantity &tq) {
+  const std::int32_t variable_id = to_int(tq);
+  const std::int32_t n_comp = n_components(tq);
+  const std::uint8_t value_size =
+      out_par_.td_single_precision ? sizeof(float) : sizeof(double);
+  const std::uint8_t compressed = compress_chunks_;
+  file.write("SMLC", 4);
+  file.write(reinterpret_cast<const char *>(&chunked_version),
+             sizeof(chunked_version));
+  file.write(reinterpret_cast<const char *>(&variable_id), sizeof(variable_id));
+  file.write(reinterpret_cast<const char *>(&n_comp), sizeof(n_comp));
+  file.write(reinterpret_cast<const char *>(&value_size), sizeof(value_size));
+  file.write(reinterpret_cast<const char *>(&compressed), sizeof(compressed));
+  file.write(reinterpret_cast<char *>(&nodes_), sizeof(nodes_));
+  file.write(reinterpret_cast<char *>(&sizes_), sizeof(sizes_));
+  file.write(reinterpret_cast<char *>(&origin_), sizeof(origin_));
+}
 }  // namespace smash
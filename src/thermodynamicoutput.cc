@@ -1,6 +1,6 @@
 /*
  *
- *    Copyright (c) 2014-2022
+ *    Copyright (c) 2014-2022,2024
  *      SMASH Team
  *
  *    GNU General Public License (GPLv3 or later)
@@ -12,12 +12,15 @@
 #include <filesystem>
 #include <fstream>
 #include <memory>
+#include <vector>
 
 #include "smash/clock.h"
 #include "smash/config.h"
 #include "smash/density.h"
 #include "smash/energymomentumtensor.h"
 #include "smash/experimentparameters.h"
+#include "smash/particlecelllist.h"
+#include "smash/threadpool.h"
 #include "smash/vtkoutput.h"
 
 namespace smash {
@@ -184,19 +187,33 @@ void ThermodynamicOutput::at_intermediate_time(
     const std::unique_ptr<Clock> &clock, const DensityParameters &dens_param) {
   std::fprintf(file_.get(), "%6.2f ", clock->current_time());
   constexpr bool compute_gradient = false;
+  /* With smearing, only the particles closer than the cut-off radius
+   * contribute. They are selected once per ensemble for all quantities, in
+   * the order of the particles, such that the sums do not change. */
+  std::vector<std::vector<const ParticleData *>> nearby(ensembles.size());
+  for (std::size_t i = 0; i < ensembles.size(); i++) {
+    for (const ParticleData &p : ensembles[i]) {
+      if (!out_par_.td_smearing ||
+          (p.position().threevec() - out_par_.td_position).sqr() <=
+              dens_param.r_cut_sqr()) {
+        nearby[i].push_back(&p);
+      }
+    }
+  }
   if (out_par_.td_rho_eckart) {
     FourVector jmu = FourVector();
-    for (const Particles &particles : ensembles) {
+    for (const auto &plist : nearby) {
       jmu += std::get<1>(current_eckart(
-          out_par_.td_position, particles, dens_param, out_par_.td_dens_type,
+          out_par_.td_position, plist, dens_param, out_par_.td_dens_type,
           compute_gradient, out_par_.td_smearing));
     }
     std::fprintf(file_.get(), "%15.12f ", jmu.abs());
   }
   if (out_par_.td_tmn || out_par_.td_tmn_landau || out_par_.td_v_landau) {
     EnergyMomentumTensor Tmn;
-    for (const Particles &particles : ensembles) {
-      for (const auto &p : particles) {
+    for (const auto &plist : nearby) {
+      for (const ParticleData *entry : plist) {
+        const ParticleData &p = *entry;
         if (dens_param.only_participants()) {
           // if this condition holds, the hadron is a spectator and we skip it
           if (p.get_history().collisions_per_particle == 0) {
@@ -242,15 +259,15 @@ void ThermodynamicOutput::at_intermediate_time(
   }
   if (out_par_.td_jQBS) {
     FourVector jQ = FourVector(), jB = FourVector(), jS = FourVector();
-    for (const Particles &particles : ensembles) {
-      jQ += std::get<1>(current_eckart(out_par_.td_position, particles,
-                                       dens_param, DensityType::Charge,
-                                       compute_gradient, out_par_.td_smearing));
-      jB += std::get<1>(current_eckart(out_par_.td_position, particles,
-                                       dens_param, DensityType::Baryon,
-                                       compute_gradient, out_par_.td_smearing));
-      jS += std::get<1>(current_eckart(out_par_.td_position, particles,
-                                       dens_param, DensityType::Strangeness,
+    for (const auto &plist : nearby) {
+      jQ += std::get<1>(current_eckart(out_par_.td_position, plist, dens_param,
+                                       DensityType::Charge, compute_gradient,
+                                       out_par_.td_smearing));
+      jB += std::get<1>(current_eckart(out_par_.td_position, plist, dens_param,
+                                       DensityType::Baryon, compute_gradient,
+                                       out_par_.td_smearing));
+      jS += std::get<1>(current_eckart(out_par_.td_position, plist, dens_param,
+                                       DensityType::Strangeness,
                                        compute_gradient, out_par_.td_smearing));
     }
     std::fprintf(file_.get(), "%15.12f %15.12f %15.12f %15.12f ", jQ[0], jQ[1],
@@ -266,18 +283,33 @@ void ThermodynamicOutput::at_intermediate_time(
 void ThermodynamicOutput::density_along_line(
     const char *file_name, const ParticleList &plist,
     const DensityParameters &param, DensityType dens_type,
-    const ThreeVector &line_start, const ThreeVector &line_end, int n_points) {
-  ThreeVector r;
-  std::ofstream a_file;
-  a_file.open(file_name, std::ios::out);
+    const ThreeVector &line_start, const ThreeVector &line_end, int n_points,
+    ThreadPool *pool) {
   const bool compute_gradient = false;
   const bool smearing = true;
+  // Only the particles in the cells around a point contribute to its density
+  const ParticleCellList cells(plist, param.r_cut());
+  auto point = [&](int i) {
+    return line_start + (line_end - line_start) * (1.0 * i / n_points);
+  };
+  std::vector<double> rho_eck(n_points + 1);
+  auto density_at_point = [&](int i) {
+    rho_eck[i] = std::get<0>(current_eckart(point(i), cells, param, dens_type,
+                                            compute_gradient, smearing));
+  };
+  if (pool) {
+    pool->parallel_for(n_points + 1, density_at_point);
+  } else {
+    for (int i = 0; i <= n_points; i++) {
+      density_at_point(i);
+    }
+  }
 
+  std::ofstream a_file;
+  a_file.open(file_name, std::ios::out);
   for (int i = 0; i <= n_points; i++) {
-    r = line_start + (line_end - line_start) * (1.0 * i / n_points);
-    double rho_eck = std::get<0>(
-        current_eckart(r, plist, param, dens_type, compute_gradient, smearing));
-    a_file << r.x1() << " " << r.x2() << " " << r.x3() << " " << rho_eck
+    const ThreeVector r = point(i);
+    a_file << r.x1() << " " << r.x2() << " " << r.x3() << " " << rho_eck[i]
            << "\n";
   }
 }
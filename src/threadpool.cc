@@ -0,0 +1,194 @@
+/*
+ *
+ *    Copyright (c) 2024
+ *      SMASH Team
+ *
+ *    GNU General Public License (GPLv3 or later)
+ *
+ */
+
+#include "smash/threadpool.h"
+
+#include <stdexcept>
+#include <string>
+
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+namespace smash {
+
+/**
+ * Bind a thread to one CPU, modulo the number of CPUs, if this is supported.
+ *
+ * \param[in] thread Native handle of the thread
+ * \param[in] cpu Number of the CPU
+ */
+static void pin_to_cpu([[maybe_unused]] std::thread::native_handle_type thread,
+                       [[maybe_unused]] int cpu) {
+#ifdef __linux__
+  const unsigned n_cpus = std::thread::hardware_concurrency();
+  cpu_set_t cpus;
+  CPU_ZERO(&cpus);
+  CPU_SET(n_cpus > 0 ? cpu % n_cpus : cpu, &cpus);
+  pthread_setaffinity_np(thread, sizeof(cpus), &cpus);
+#endif
+}
+
+namespace {
+/**
+ * Binds the calling thread to a CPU while it exists and restores the CPUs,
+ * on which the thread was allowed to run before, afterwards.
+ */
+class ScopedPinning {
+ public:
+  /**
+   * \param[in] pinned Whether the thread is bound at all
+   * \param[in] cpu Number of the CPU, see pin_to_cpu
+   */
+  ScopedPinning([[maybe_unused]] bool pinned, [[maybe_unused]] int cpu) {
+#ifdef __linux__
+    active_ = pinned && pthread_getaffinity_np(pthread_self(), sizeof(saved_),
+                                               &saved_) == 0;
+    if (active_) {
+      pin_to_cpu(pthread_self(), cpu);
+    }
+#endif
+  }
+
+  /// Restore the CPUs of the thread.
+  ~ScopedPinning() {
+#ifdef __linux__
+    if (active_) {
+      pthread_setaffinity_np(pthread_self(), sizeof(saved_), &saved_);
+    }
+#endif
+  }
+
+  /// Cannot be copied
+  ScopedPinning(const ScopedPinning &) = delete;
+  /// Cannot be copied
+  ScopedPinning &operator=(const ScopedPinning &) = delete;
+
+ private:
+#ifdef __linux__
+  /// CPUs of the thread before it was bound
+  cpu_set_t saved_;
+  /// Whether the thread was bound and has to be restored
+  bool active_ = false;
+#endif
+};
+}  // namespace
+
+ThreadPool::ThreadPool(int n_threads, bool pinned) : pinned_(pinned) {
+  if (n_threads < 1) {
+    throw std::invalid_argument("A thread pool needs at least one thread, " +
+                                std::to_string(n_threads) + " requested.");
+  }
+  workers_.reserve(n_threads - 1);
+  for (int i = 1; i < n_threads; i++) {
+    workers_.emplace_back([this, i]() { work(i); });
+  }
+  if (pinned_) {
+    // The calling thread is only bound while it processes tasks
+    for (int i = 1; i < n_threads; i++) {
+      pin_to_cpu(workers_[i - 1].native_handle(), i);
+    }
+  }
+}
+
+ThreadPool::~ThreadPool() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stop_ = true;
+  }
+  batch_started_.notify_all();
+  for (std::thread &worker : workers_) {
+    worker.join();
+  }
+}
+
+void ThreadPool::parallel_for(int n_tasks,
+                              const std::function<void(int)> &task) {
+  if (n_tasks <= 0) {
+    return;
+  }
+  bool idle = false;
+  if (workers_.empty() || n_tasks == 1 ||
+      !running_.compare_exchange_strong(idle, true)) {
+    for (int i = 0; i < n_tasks; i++) {
+      task(i);
+    }
+    return;
+  }
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    task_ = &task;
+    n_tasks_ = n_tasks;
+    next_task_ = 0;
+    exception_ = nullptr;
+    busy_workers_ = static_cast<int>(workers_.size());
+    batch_++;
+  }
+  batch_started_.notify_all();
+  {
+    const ScopedPinning pinning(pinned_, 0);
+    process_tasks(0);
+  }
+
+  std::unique_lock<std::mutex> lock(mutex_);
+  batch_finished_.wait(lock, [this]() { return busy_workers_ == 0; });
+  task_ = nullptr;
+  running_ = false;
+  if (exception_) {
+    std::exception_ptr e = exception_;
+    exception_ = nullptr;
+    std::rethrow_exception(e);
+  }
+}
+
+void ThreadPool::process_tasks(int thread) {
+  auto process = [this](int i) {
+    try {
+      (*task_)(i);
+    } catch (...) {
+      std::lock_guard<std::mutex> lock(mutex_);
+      if (!exception_) {
+        exception_ = std::current_exception();
+      }
+    }
+  };
+  if (pinned_) {
+    for (int i = thread; i < n_tasks_; i += size()) {
+      process(i);
+    }
+    return;
+  }
+  for (int i = next_task_++; i < n_tasks_; i = next_task_++) {
+    process(i);
+  }
+}
+
+void ThreadPool::work(int thread) {
+  uint64_t last_batch = 0;
+  while (true) {
+    {
+      std::unique_lock<std::mutex> lock(mutex_);
+      batch_started_.wait(
+          lock, [&]() { return stop_ || batch_ != last_batch; });
+      if (stop_) {
+        return;
+      }
+      last_batch = batch_;
+    }
+    process_tasks(thread);
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      busy_workers_--;
+    }
+    batch_finished_.notify_one();
+  }
+}
+
+}  // namespace smash
@@ -0,0 +1,147 @@
+/*
+ *
+ *    Copyright (c) 2024
+ *      SMASH Team
+ *
+ *    GNU General Public License (GPLv3 or later)
+ *
+ */
+
+#include "smash/timesteplessgrid.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#include "smash/particles.h"
+
+namespace smash {
+
+void TimesteplessGrid::build(const Particles &particles,
+                             double min_cell_length) {
+  constexpr double inf = std::numeric_limits<double>::infinity();
+  std::array<double, 3> max_position = {-inf, -inf, -inf};
+  min_position_ = {inf, inf, inf};
+  reference_time_ = inf;
+  for (const ParticleData &p : particles) {
+    const FourVector &x = p.position();
+    for (int i = 0; i < 3; i++) {
+      min_position_[i] = std::min(min_position_[i], x[i + 1]);
+      max_position[i] = std::max(max_position[i], x[i + 1]);
+    }
+    reference_time_ = std::min(reference_time_, x.x0());
+  }
+  if (particles.size() == 0) {
+    min_position_ = max_position = {0., 0., 0.};
+    reference_time_ = 0.;
+  }
+
+  // Limit the number of cells to the number of particles
+  double volume = 1.;
+  for (int i = 0; i < 3; i++) {
+    volume *= std::max(max_position[i] - min_position_[i], min_cell_length);
+  }
+  const double n_particles = std::max<std::size_t>(particles.size(), 1);
+  cell_length_ = std::max(min_cell_length, std::cbrt(volume / n_particles));
+  if (!(cell_length_ > 0.)) {
+    cell_length_ = 1.;
+  }
+  std::size_t n_cells = 1;
+  for (int i = 0; i < 3; i++) {
+    number_of_cells_[i] = std::max(
+        1, static_cast<int>((max_position[i] - min_position_[i]) /
+                            cell_length_));
+    n_cells *= number_of_cells_[i];
+  }
+
+  // The cells keep their memory from the last build
+  cells_.resize(n_cells);
+  for (std::vector<ParticleData> &cell : cells_) {
+    cell.clear();
+  }
+  for (const ParticleData &p : particles) {
+    cell_of(p.position()).push_back(p);
+  }
+  built_ = true;
+}
+
+void TimesteplessGrid::insert(const ParticleList &new_particles) {
+  if (!built_) {
+    return;
+  }
+  for (const ParticleData &p : new_particles) {
+    cell_of(p.position()).push_back(p);
+  }
+}
+
+void TimesteplessGrid::find_candidates(
+    const ParticleList &search_list, double reach, const Particles &particles,
+    std::vector<const ParticleData *> &candidates) const {
+  candidates.clear();
+  if (!built_) {
+    return;
+  }
+  for (const ParticleData &p : search_list) {
+    const FourVector &x = p.position();
+    // The particles moved at most by the time passed since the build
+    const double total_reach = reach + std::max(0., x.x0() - reference_time_);
+    std::array<int, 3> first, last;
+    for (int i = 0; i < 3; i++) {
+      first[i] = cell_coordinate(x[i + 1] - total_reach, i);
+      last[i] = cell_coordinate(x[i + 1] + total_reach, i);
+    }
+    for (int iz = first[2]; iz <= last[2]; iz++) {
+      for (int iy = first[1]; iy <= last[1]; iy++) {
+        for (int ix = first[0]; ix <= last[0]; ix++) {
+          const std::size_t index =
+              (iz * number_of_cells_[1] + iy) * number_of_cells_[0] + ix;
+          for (const ParticleData &copy : cells_[index]) {
+            if ((copy.position().threevec() - x.threevec()).sqr() >
+                    total_reach * total_reach ||
+                !particles.is_valid(copy)) {
+              continue;
+            }
+            const bool searched = std::any_of(
+                search_list.begin(), search_list.end(),
+                [&copy](const ParticleData &s) { return s.id() == copy.id(); });
+            if (!searched) {
+              candidates.push_back(&particles.lookup(copy));
+            }
+          }
+        }
+      }
+    }
+  }
+  // The particles of overlapping search regions are only taken once
+  std::sort(candidates.begin(), candidates.end());
+  candidates.erase(std::unique(candidates.begin(), candidates.end()),
+                   candidates.end());
+}
+
+std::size_t TimesteplessGrid::memory_usage() const {
+  std::size_t bytes = cells_.capacity() * sizeof(std::vector<ParticleData>);
+  for (const std::vector<ParticleData> &cell : cells_) {
+    bytes += cell.capacity() * sizeof(ParticleData);
+  }
+  return bytes;
+}
+
+int TimesteplessGrid::cell_coordinate(double x, int i) const {
+  const double index = std::floor((x - min_position_[i]) / cell_length_);
+  if (index < 0.) {
+    return 0;
+  }
+  return std::min(number_of_cells_[i] - 1,
+                  static_cast<int>(std::min(index, 1e9)));
+}
+
+std::vector<ParticleData> &TimesteplessGrid::cell_of(const FourVector &x) {
+  const std::size_t index =
+      (cell_coordinate(x.x3(), 2) * number_of_cells_[1] +
+       cell_coordinate(x.x2(), 1)) *
+          number_of_cells_[0] +
+      cell_coordinate(x.x1(), 0);
+  return cells_[index];
+}
+
+}  // namespace smash
@@ -1,6 +1,6 @@
 /*
  *
- *    Copyright (c) 2014-2022
+ *    Copyright (c) 2014-2022,2024
  *      SMASH Team
  *
  *    GNU General Public License (GPLv3 or later)
@@ -9,10 +9,16 @@
 
 #include "smash/vtkoutput.h"
 
+#include <cstdint>
+#include <cstring>
 #include <fstream>
 #include <memory>
 #include <utility>
 
+#ifdef SMASH_USE_ZLIB
+#include <zlib.h>
+#endif
+
 #include "smash/clock.h"
 #include "smash/config.h"
 #include "smash/file.h"
@@ -22,11 +28,13 @@
 namespace smash {
 
 VtkOutput::VtkOutput(const std::filesystem::path &path, const std::string &name,
-                     const OutputParameters &out_par)
+                     const OutputParameters &out_par, bool xml)
     : OutputInterface(name),
       base_path_(std::move(path)),
       is_thermodynamics_output_(name == "Thermodynamics"),
-      is_fields_output_(name == "Fields") {
+      is_fields_output_(name == "Fields"),
+      xml_(xml),
+      compressed_(xml && out_par.compress_files) {
   if (out_par.part_extended) {
     logg[LOutput].warn()
         << "Creating VTK output: There is no extended VTK format.";
@@ -57,10 +65,22 @@ VtkOutput::~VtkOutput() {}
  *
  * There is also a possibility to print a lattice with thermodynamical
  * quantities to vtk files, see \ref doxypage_output_vtk_lattice.
+ *
+ * VTK XML format
+ * --------------
+ * With the format \c "VTK_XML" instead of \c "VTK", the same quantities are
+ * written in the VTK XML format for unstructured grids to files named
+ * pos_ev<event>_tstep<output_number>.vtu. The values are appended to the XML
+ * description as raw binary data, so that they are written and read much
+ * faster than text and without loss of precision. With the \key
+ * Compress_Files option, every data array is compressed with zlib as
+ * supported by the VTK readers. At the end of every event, a file
+ * pos_ev<event>.pvd is written in addition, which lists the files of the event
+ * with their times, such that paraview opens them as time series.
  **/
 
 void VtkOutput::at_eventstart(const Particles &particles,
-                              const int event_number, const EventInfo &) {
+                              const int event_number, const EventInfo &event) {
   vtk_output_counter_ = 0;
   vtk_density_output_counter_ = 0;
   vtk_tmn_output_counter_ = 0;
@@ -69,6 +89,7 @@ void VtkOutput::at_eventstart(const Particles &particles,
   vtk_fluidization_counter_ = 0;
 
   current_event_ = event_number;
+  current_time_ = event.current_time;
   if (!is_thermodynamics_output_ && !is_fields_output_) {
     write(particles);
     vtk_output_counter_++;
@@ -76,12 +97,29 @@ void VtkOutput::at_eventstart(const Particles &particles,
 }
 
 void VtkOutput::at_eventend(const Particles & /*particles*/,
-                            const int /*event_number*/, const EventInfo &) {}
+                            const int /*event_number*/, const EventInfo &) {
+  // the time series of the XML files are collected in .pvd files
+  for (const auto &[series, files] : series_) {
+    FilePtr file{
+        std::fopen((base_path_ / (series + ".pvd")).native().c_str(), "w")};
+    std::fprintf(file.get(),
+                 "<?xml version=\"1.0\"?>\n"
+                 "<VTKFile type=\"Collection\" version=\"1.0\">\n"
+                 "  <Collection>\n");
+    for (const auto &[time, filename] : files) {
+      std::fprintf(file.get(), "    <DataSet timestep=\"%.9g\" file=\"%s\"/>\n",
+                   time, filename.c_str());
+    }
+    std::fprintf(file.get(), "  </Collection>\n</VTKFile>\n");
+  }
+  series_.clear();
+}
 
 void VtkOutput::at_intermediate_time(const Particles &particles,
                                      const std::unique_ptr<Clock> &,
                                      const DensityParameters &,
-                                     const EventInfo &) {
+                                     const EventInfo &event) {
+  current_time_ = event.current_time;
   if (!is_thermodynamics_output_ && !is_fields_output_) {
     write(particles);
     vtk_output_counter_++;
@@ -89,6 +127,10 @@ void VtkOutput::at_intermediate_time(const Particles &particles,
 }
 
 void VtkOutput::write(const Particles &particles) {
+  if (xml_) {
+    write_xml(particles);
+    return;
+  }
   char filename[32];
   snprintf(filename, sizeof(filename), "pos_ev%05i_tstep%05i.vtk",
            current_event_, vtk_output_counter_);
@@ -120,7 +162,7 @@ void VtkOutput::write(const Particles &particles) {
   std::fprintf(file_.get(), "SCALARS pdg_codes int 1\n");
   std::fprintf(file_.get(), "LOOKUP_TABLE default\n");
   for (const auto &p : particles) {
-    std::fprintf(file_.get(), "%s\n", p.pdgcode().string().c_str());
+    std::fprintf(file_.get(), "%s\n", p.type().pdgcode_string().c_str());
   }
   std::fprintf(file_.get(), "SCALARS is_formed int 1\n");
   std::fprintf(file_.get(), "LOOKUP_TABLE default\n");
@@ -166,6 +208,196 @@ void VtkOutput::write(const Particles &particles) {
   }
 }
 
+namespace {
+/**
+ * Append a value to raw binary data.
+ *
+ * \param[inout] data Data, to which the value is appended
+ * \param[in] value Value to be appended
+ */
+template <typename T>
+void append_raw(std::vector<char> &data, const T &value) {
+  const std::size_t size = data.size();
+  data.resize(size + sizeof(T));
+  std::memcpy(data.data() + size, &value, sizeof(T));
+}
+
+}  // namespace
+
+void VtkOutput::write_xml(const Particles &particles) {
+  const double current_time = particles.time();
+  // collect a quantity of all particles as data array
+  auto array = [&](const char *attributes, auto &&append_value) {
+    XmlDataArray data_array{attributes, {}};
+    for (const ParticleData &p : particles) {
+      append_value(p, data_array.data);
+    }
+    return data_array;
+  };
+  auto three_vector = [](const FourVector &v, std::vector<char> &data) {
+    append_raw(data, v.x1());
+    append_raw(data, v.x2());
+    append_raw(data, v.x3());
+  };
+  std::vector<XmlDataArray> points, cells, point_data;
+  points.push_back(array(
+      R"(type="Float64" NumberOfComponents="3")",
+      [&](const ParticleData &p, std::vector<char> &data) {
+        three_vector(p.position(), data);
+      }));
+  // every particle is a cell of type VTK_VERTEX
+  XmlDataArray connectivity{R"(type="Int64" Name="connectivity")", {}};
+  XmlDataArray offsets{R"(type="Int64" Name="offsets")", {}};
+  XmlDataArray types{R"(type="UInt8" Name="types")", {}};
+  for (std::int64_t i = 0; i < static_cast<std::int64_t>(particles.size());
+       i++) {
+    append_raw(connectivity.data, i);
+    append_raw<std::int64_t>(offsets.data, i + 1);
+    append_raw<std::uint8_t>(types.data, 1);
+  }
+  cells.push_back(std::move(connectivity));
+  cells.push_back(std::move(offsets));
+  cells.push_back(std::move(types));
+  point_data.push_back(array(
+      R"(type="Int32" Name="pdg_codes")",
+      [](const ParticleData &p, std::vector<char> &data) {
+        append_raw<std::int32_t>(data, p.pdgcode().get_decimal());
+      }));
+  point_data.push_back(array(
+      R"(type="Int32" Name="is_formed")",
+      [&](const ParticleData &p, std::vector<char> &data) {
+        append_raw<std::int32_t>(data, p.formation_time() <= current_time);
+      }));
+  point_data.push_back(array(
+      R"(type="Float64" Name="cross_section_scaling_factor")",
+      [](const ParticleData &p, std::vector<char> &data) {
+        append_raw(data, p.xsec_scaling_factor());
+      }));
+  point_data.push_back(
+      array(R"(type="Float64" Name="mass")",
+            [](const ParticleData &p, std::vector<char> &data) {
+              append_raw(data, p.effective_mass());
+            }));
+  point_data.push_back(array(
+      R"(type="Int32" Name="N_coll")",
+      [](const ParticleData &p, std::vector<char> &data) {
+        append_raw<std::int32_t>(data, p.get_history().collisions_per_particle);
+      }));
+  point_data.push_back(
+      array(R"(type="Int32" Name="particle_ID")",
+            [](const ParticleData &p, std::vector<char> &data) {
+              append_raw<std::int32_t>(data, p.id());
+            }));
+  point_data.push_back(array(
+      R"(type="Int32" Name="baryon_number")",
+      [](const ParticleData &p, std::vector<char> &data) {
+        append_raw<std::int32_t>(data, p.pdgcode().baryon_number());
+      }));
+  point_data.push_back(array(
+      R"(type="Int32" Name="strangeness")",
+      [](const ParticleData &p, std::vector<char> &data) {
+        append_raw<std::int32_t>(data, p.pdgcode().strangeness());
+      }));
+  point_data.push_back(array(
+      R"(type="Float64" Name="momentum" NumberOfComponents="3")",
+      [&](const ParticleData &p, std::vector<char> &data) {
+        three_vector(p.momentum(), data);
+      }));
+
+  char series[16];
+  snprintf(series, sizeof(series), "pos_ev%05i", current_event_);
+  char filename[32];
+  snprintf(filename, sizeof(filename), "%s_tstep%05i.vtu", series,
+           vtk_output_counter_);
+  const std::string n = std::to_string(particles.size());
+  write_xml_file(filename, "UnstructuredGrid", "",
+                 "NumberOfPoints=\"" + n + "\" NumberOfCells=\"" + n + "\"",
+                 {{"Points", std::move(points)},
+                  {"Cells", std::move(cells)},
+                  {"PointData", std::move(point_data)}});
+  series_[series].emplace_back(current_time_, filename);
+}
+
+void VtkOutput::write_xml_file(
+    const std::string &filename, const std::string &type,
+    const std::string &dataset_attributes, const std::string &piece_attributes,
+    const std::vector<std::pair<std::string, std::vector<XmlDataArray>>>
+        &sections) {
+  /* Every array is appended as block, which starts with its size in bytes.
+   * For compressed arrays, the size is given as number of zlib blocks, which
+   * is always one here, the uncompressed size of the blocks, the size of the
+   * last block if it is smaller, and the compressed size of each block. */
+  std::vector<std::vector<char>> blocks;
+  for (const auto &section : sections) {
+    for (const XmlDataArray &array : section.second) {
+      std::vector<char> block;
+      const std::uint64_t size = array.data.size();
+#ifdef SMASH_USE_ZLIB
+      if (compressed_) {
+        uLongf compressed_size = compressBound(size);
+        std::vector<char> compressed(compressed_size);
+        ::compress(reinterpret_cast<Bytef *>(compressed.data()),
+                   &compressed_size,
+                   reinterpret_cast<const Bytef *>(array.data.data()), size);
+        append_raw<std::uint64_t>(block, size > 0 ? 1 : 0);
+        append_raw(block, size);
+        append_raw<std::uint64_t>(block, 0);
+        if (size > 0) {
+          append_raw<std::uint64_t>(block, compressed_size);
+          block.insert(block.end(), compressed.begin(),
+                       compressed.begin() + compressed_size);
+        }
+        blocks.push_back(std::move(block));
+        continue;
+      }
+#endif
+      append_raw(block, size);
+      block.insert(block.end(), array.data.begin(), array.data.end());
+      blocks.push_back(std::move(block));
+    }
+  }
+
+  FilePtr file{std::fopen((base_path_ / filename).native().c_str(), "wb")};
+  std::fprintf(file.get(),
+               "<?xml version=\"1.0\"?>\n"
+               "<VTKFile type=\"%s\" version=\"1.0\" byte_order=\"%s\" "
+               "header_type=\"UInt64\"%s>\n"
+               "  <%s%s>\n"
+               "    <Piece %s>\n",
+               type.c_str(),
+#ifdef LITTLE_ENDIAN_ARCHITECTURE
+               "LittleEndian",
+#else
+               "BigEndian",
+#endif
+               compressed_ ? " compressor=\"vtkZLibDataCompressor\"" : "",
+               type.c_str(), dataset_attributes.c_str(),
+               piece_attributes.c_str());
+  std::size_t offset = 0;
+  auto block = blocks.begin();
+  for (const auto &[element, arrays] : sections) {
+    std::fprintf(file.get(), "      <%s>\n", element.c_str());
+    for (const XmlDataArray &array : arrays) {
+      std::fprintf(file.get(),
+                   "        <DataArray %s format=\"appended\" "
+                   "offset=\"%zu\"/>\n",
+                   array.attributes.c_str(), offset);
+      offset += (block++)->size();
+    }
+    std::fprintf(file.get(), "      </%s>\n", element.c_str());
+  }
+  std::fprintf(file.get(),
+               "    </Piece>\n"
+               "  </%s>\n"
+               "  <AppendedData encoding=\"raw\">\n"
+               "   _",
+               type.c_str());
+  for (const std::vector<char> &data : blocks) {
+    std::fwrite(data.data(), 1, data.size(), file.get());
+  }
+  std::fprintf(file.get(), "\n  </AppendedData>\n</VTKFile>\n");
+}
+
 /*!\Userguide
  * \page doxypage_output_vtk_lattice
  * Density on the lattice can be printed out in the VTK format of
@@ -175,13 +407,73 @@ void VtkOutput::write(const Particles &particles) {
  * Files can be opened directly with ParaView (http://paraview.org).
  */
 
-template <typename T>
-void VtkOutput::write_vtk_header(std::ofstream &file,
-                                 RectangularLattice<T> &lattice,
-                                 const std::string &description) {
+template <typename T, typename F>
+VtkOutput::LatticeQuantity VtkOutput::lattice_scalar(
+    RectangularLattice<T> &lattice, const std::string &varname,
+    F &&get_quantity) {
+  LatticeQuantity quantity{varname, 1, {}};
+  quantity.values.reserve(lattice.size());
+  const auto dim = lattice.n_cells();
+  lattice.iterate_sublattice({0, 0, 0}, dim, [&](T &node, int, int, int) {
+    quantity.values.push_back(get_quantity(node));
+  });
+  return quantity;
+}
+
+template <typename T, typename P, typename F>
+VtkOutput::LatticeQuantity VtkOutput::lattice_vector(
+    RectangularLattice<T, P> &lattice, const std::string &varname,
+    F &&get_quantity) {
+  LatticeQuantity quantity{varname, 3, {}};
+  quantity.values.reserve(3 * lattice.size());
+  const auto dim = lattice.n_cells();
+  lattice.iterate_sublattice({0, 0, 0}, dim, [&](auto &node, int, int, int) {
+    const ThreeVector v = get_quantity(P::unpack(node));
+    quantity.values.insert(quantity.values.end(), {v.x1(), v.x2(), v.x3()});
+  });
+  return quantity;
+}
+
+template <typename T, typename P>
+void VtkOutput::write_lattice(const std::string &description, int counter,
+                              RectangularLattice<T, P> &lattice,
+                              const std::vector<LatticeQuantity> &quantities) {
   const auto dim = lattice.n_cells();
   const auto cs = lattice.cell_sizes();
   const auto orig = lattice.origin();
+  if (xml_) {
+    char series[64];
+    snprintf(series, sizeof(series), "%s_%05i", description.c_str(),
+             current_event_);
+    char filename[96];
+    snprintf(filename, sizeof(filename), "%s_tstep%05i.vti", series, counter);
+    char extent[128];
+    snprintf(extent, sizeof(extent), "0 %i 0 %i 0 %i", dim[0] - 1, dim[1] - 1,
+             dim[2] - 1);
+    char geometry[256];
+    snprintf(geometry, sizeof(geometry),
+             " WholeExtent=\"%s\" Origin=\"%.9g %.9g %.9g\" "
+             "Spacing=\"%.9g %.9g %.9g\"",
+             extent, orig[0], orig[1], orig[2], cs[0], cs[1], cs[2]);
+    std::vector<XmlDataArray> arrays;
+    for (const LatticeQuantity &quantity : quantities) {
+      XmlDataArray array{"type=\"Float64\" Name=\"" + quantity.name +
+                             "\" NumberOfComponents=\"" +
+                             std::to_string(quantity.n_components) + "\"",
+                         {}};
+      array.data.resize(quantity.values.size() * sizeof(double));
+      std::memcpy(array.data.data(), quantity.values.data(),
+                  array.data.size());
+      arrays.push_back(std::move(array));
+    }
+    write_xml_file(filename, "ImageData", geometry,
+                   "Extent=\"" + std::string(extent) + "\"",
+                   {{"PointData", std::move(arrays)}});
+    series_[series].emplace_back(current_time_, filename);
+    return;
+  }
+
+  std::ofstream file(make_filename(description, counter), std::ios::out);
   file << "# vtk DataFile Version 2.0\n"
        << description << "\n"
        << "ASCII\n"
@@ -190,38 +482,27 @@ void VtkOutput::write_vtk_header(std::ofstream &file,
        << "SPACING " << cs[0] << " " << cs[1] << " " << cs[2] << "\n"
        << "ORIGIN " << orig[0] << " " << orig[1] << " " << orig[2] << "\n"
        << "POINT_DATA " << lattice.size() << "\n";
-}
-
-template <typename T, typename F>
-void VtkOutput::write_vtk_scalar(std::ofstream &file,
-                                 RectangularLattice<T> &lattice,
-                                 const std::string &varname, F &&get_quantity) {
-  file << "SCALARS " << varname << " double 1\n"
-       << "LOOKUP_TABLE default\n";
-  file << std::setprecision(3);
-  file << std::fixed;
-  const auto dim = lattice.n_cells();
-  lattice.iterate_sublattice({0, 0, 0}, dim, [&](T &node, int ix, int, int) {
-    const double f_from_node = get_quantity(node);
-    file << f_from_node << " ";
-    if (ix == dim[0] - 1) {
-      file << "\n";
+  for (const LatticeQuantity &quantity : quantities) {
+    if (quantity.n_components == 1) {
+      file << "SCALARS " << quantity.name << " double 1\n"
+           << "LOOKUP_TABLE default\n";
+    } else {
+      file << "VECTORS " << quantity.name << " double\n";
     }
-  });
-}
-
-template <typename T, typename F>
-void VtkOutput::write_vtk_vector(std::ofstream &file,
-                                 RectangularLattice<T> &lattice,
-                                 const std::string &varname, F &&get_quantity) {
-  file << "VECTORS " << varname << " double\n";
-  file << std::setprecision(3);
-  file << std::fixed;
-  const auto dim = lattice.n_cells();
-  lattice.iterate_sublattice({0, 0, 0}, dim, [&](T &node, int, int, int) {
-    const ThreeVector v = get_quantity(node);
-    file << v.x1() << " " << v.x2() << " " << v.x3() << "\n";
-  });
+    file << std::setprecision(3);
+    file << std::fixed;
+    for (std::size_t i = 0; i < quantity.values.size(); i++) {
+      if (quantity.n_components == 1) {
+        // the nodes of a row along x are written in one line
+        file << quantity.values[i] << " ";
+        if (i % dim[0] == static_cast<std::size_t>(dim[0] - 1)) {
+          file << "\n";
+        }
+      } else {
+        file << quantity.values[i] << (i % 3 == 2 ? "\n" : " ");
+      }
+    }
+  }
 }
 
 std::string VtkOutput::make_filename(const std::string &descr, int counter) {
@@ -243,12 +524,11 @@ void VtkOutput::thermodynamics_output(
   if (!is_thermodynamics_output_) {
     return;
   }
-  std::ofstream file;
   const std::string varname = make_varname(tq, dens_type);
-  file.open(make_filename(varname, vtk_density_output_counter_), std::ios::out);
-  write_vtk_header(file, lattice, varname);
-  write_vtk_scalar(file, lattice, varname,
-                   [&](DensityOnLattice &node) { return node.rho(); });
+  write_lattice(varname, vtk_density_output_counter_, lattice,
+                {lattice_scalar(lattice, varname, [&](DensityOnLattice &node) {
+                  return node.rho();
+                })});
   vtk_density_output_counter_++;
 }
 
@@ -274,66 +554,65 @@ void VtkOutput::thermodynamics_output(
   if (!is_thermodynamics_output_) {
     return;
   }
-  std::ofstream file;
   const std::string varname = make_varname(tq, dens_type);
 
   if (tq == ThermodynamicQuantity::Tmn) {
-    file.open(make_filename(varname, vtk_tmn_output_counter_++), std::ios::out);
-    write_vtk_header(file, Tmn_lattice, varname);
+    std::vector<LatticeQuantity> quantities;
     for (int i = 0; i < 4; i++) {
       for (int j = i; j < 4; j++) {
-        write_vtk_scalar(file, Tmn_lattice,
-                         varname + std::to_string(i) + std::to_string(j),
-                         [&](EnergyMomentumTensor &node) {
-                           return node[EnergyMomentumTensor::tmn_index(i, j)];
-                         });
+        quantities.push_back(lattice_scalar(
+            Tmn_lattice, varname + std::to_string(i) + std::to_string(j),
+            [&](EnergyMomentumTensor &node) {
+              return node[EnergyMomentumTensor::tmn_index(i, j)];
+            }));
       }
     }
+    write_lattice(varname, vtk_tmn_output_counter_++, Tmn_lattice, quantities);
   } else if (tq == ThermodynamicQuantity::TmnLandau) {
-    file.open(make_filename(varname, vtk_tmn_landau_output_counter_++),
-              std::ios::out);
-    write_vtk_header(file, Tmn_lattice, varname);
+    // The tensors are boosted once for all of their components
+    std::vector<EnergyMomentumTensor> Tmn_L(Tmn_lattice.size());
+    for (std::size_t n = 0; n < Tmn_lattice.size(); n++) {
+      const EnergyMomentumTensor &node = Tmn_lattice[n];
+      Tmn_L[n] = node.boosted(node.landau_frame_4velocity());
+    }
+    std::vector<LatticeQuantity> quantities;
     for (int i = 0; i < 4; i++) {
       for (int j = i; j < 4; j++) {
-        write_vtk_scalar(file, Tmn_lattice,
-                         varname + std::to_string(i) + std::to_string(j),
-                         [&](EnergyMomentumTensor &node) {
-                           const FourVector u = node.landau_frame_4velocity();
-                           const EnergyMomentumTensor Tmn_L = node.boosted(u);
-                           return Tmn_L[EnergyMomentumTensor::tmn_index(i, j)];
-                         });
+        quantities.push_back(lattice_scalar(
+            Tmn_lattice, varname + std::to_string(i) + std::to_string(j),
+            [&](EnergyMomentumTensor &node) {
+              return Tmn_L[&node - &Tmn_lattice[0]]
+                          [EnergyMomentumTensor::tmn_index(i, j)];
+            }));
       }
     }
+    write_lattice(varname, vtk_tmn_landau_output_counter_++, Tmn_lattice,
+                  quantities);
   } else {
-    file.open(make_filename(varname, vtk_v_landau_output_counter_++),
-              std::ios::out);
-    write_vtk_header(file, Tmn_lattice, varname);
-    write_vtk_vector(file, Tmn_lattice, varname,
-                     [&](EnergyMomentumTensor &node) {
-                       const FourVector u = node.landau_frame_4velocity();
-                       return -u.velocity();
-                     });
+    write_lattice(varname, vtk_v_landau_output_counter_++, Tmn_lattice,
+                  {lattice_vector(Tmn_lattice, varname,
+                                  [&](const EnergyMomentumTensor &node) {
+                                    const FourVector u =
+                                        node.landau_frame_4velocity();
+                                    return -u.velocity();
+                                  })});
   }
 }
 
 void VtkOutput::fields_output(
     const std::string name1, const std::string name2,
-    RectangularLattice<std::pair<ThreeVector, ThreeVector>> &lat) {
+    ForceLattice &lat) {
   if (!is_fields_output_) {
     return;
   }
-  std::ofstream file1;
-  file1.open(make_filename(name1, vtk_fields_output_counter_), std::ios::out);
-  write_vtk_header(file1, lat, name1);
-  write_vtk_vector(
-      file1, lat, name1,
-      [&](std::pair<ThreeVector, ThreeVector> &node) { return node.first; });
-  std::ofstream file2;
-  file2.open(make_filename(name2, vtk_fields_output_counter_), std::ios::out);
-  write_vtk_header(file2, lat, name2);
-  write_vtk_vector(
-      file2, lat, name2,
-      [&](std::pair<ThreeVector, ThreeVector> &node) { return node.second; });
+  using Node = std::pair<ThreeVector, ThreeVector>;
+  write_lattice(name1, vtk_fields_output_counter_, lat,
+                {lattice_vector(lat, name1,
+                                [&](const Node &node) { return node.first; })});
+  write_lattice(name2, vtk_fields_output_counter_, lat,
+                {lattice_vector(lat, name2, [&](const Node &node) {
+                  return node.second;
+                })});
   vtk_fields_output_counter_++;
 }
 
@@ -341,22 +620,21 @@ void VtkOutput::thermodynamics_output(const GrandCanThermalizer &gct) {
   if (!is_thermodynamics_output_) {
     return;
   }
-  std::ofstream file;
-  file.open(make_filename("fluidization_td", vtk_fluidization_counter_++),
-            std::ios::out);
-  write_vtk_header(file, gct.lattice(), "fluidization_td");
-  write_vtk_scalar(file, gct.lattice(), "e",
-                   [&](ThermLatticeNode &node) { return node.e(); });
-  write_vtk_scalar(file, gct.lattice(), "p",
-                   [&](ThermLatticeNode &node) { return node.p(); });
-  write_vtk_vector(file, gct.lattice(), "v",
-                   [&](ThermLatticeNode &node) { return node.v(); });
-  write_vtk_scalar(file, gct.lattice(), "T",
-                   [&](ThermLatticeNode &node) { return node.T(); });
-  write_vtk_scalar(file, gct.lattice(), "mub",
-                   [&](ThermLatticeNode &node) { return node.mub(); });
-  write_vtk_scalar(file, gct.lattice(), "mus",
-                   [&](ThermLatticeNode &node) { return node.mus(); });
+  auto &lattice = gct.lattice();
+  write_lattice(
+      "fluidization_td", vtk_fluidization_counter_++, lattice,
+      {lattice_scalar(lattice, "e",
+                      [&](ThermLatticeNode &node) { return node.e(); }),
+       lattice_scalar(lattice, "p",
+                      [&](ThermLatticeNode &node) { return node.p(); }),
+       lattice_vector(lattice, "v",
+                      [&](const ThermLatticeNode &node) { return node.v(); }),
+       lattice_scalar(lattice, "T",
+                      [&](ThermLatticeNode &node) { return node.T(); }),
+       lattice_scalar(lattice, "mub",
+                      [&](ThermLatticeNode &node) { return node.mub(); }),
+       lattice_scalar(lattice, "mus",
+                      [&](ThermLatticeNode &node) { return node.mus(); })});
 }
 
 }  // namespace smash
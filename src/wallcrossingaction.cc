@@ -12,7 +12,7 @@
 namespace smash {
 
 ActionList WallCrossActionsFinder::find_actions_in_cell(
-    const ParticleList& plist, double t_max, const double,
+    const ParticleSpan& plist, double t_max, const double,
     const std::vector<FourVector>&) const {
   std::vector<ActionPtr> actions;
   for (const ParticleData& p : plist) {